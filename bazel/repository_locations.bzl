@@ -365,6 +365,39 @@ REPOSITORY_LOCATIONS_SPEC = dict(
         release_date = "2019-04-14",
         cpe = "cpe:2.3:a:gnu:zlib:*",
     ),
+    org_brotli = dict(
+        project_name = "brotli",
+        project_desc = "brotli compression library",
+        project_url = "https://brotli.org",
+        # Use a commit of the dev branch, as the Bazel build of the 1.0.9 release is broken.
+        version = "0cd2e3926e95e7e2930f57ae3f4885508d462a25",
+        sha256 = "93810780e60304b51f2c9645fe313a6e4640711063ed0b860cfa60999dd256c5",
+        strip_prefix = "brotli-{version}",
+        urls = ["https://github.com/google/brotli/archive/{version}.tar.gz"],
+        use_category = ["dataplane_ext"],
+        extensions = [
+            "envoy.compression.brotli.compressor",
+            "envoy.compression.brotli.decompressor",
+        ],
+        release_date = "2020-09-08",
+        cpe = "cpe:2.3:a:google:brotli:*",
+    ),
+    com_github_facebook_zstd = dict(
+        project_name = "zstd",
+        project_desc = "zstd compression library",
+        project_url = "https://facebook.github.io/zstd",
+        version = "1.4.5",
+        sha256 = "98e91c7c6bf162bf90e4e70fdbc41a8188b9fa8de5ad840c401198014406ce9e",
+        strip_prefix = "zstd-{version}",
+        urls = ["https://github.com/facebook/zstd/releases/download/v{version}/zstd-{version}.tar.gz"],
+        use_category = ["dataplane_ext"],
+        extensions = [
+            "envoy.compression.zstd.compressor",
+            "envoy.compression.zstd.decompressor",
+        ],
+        release_date = "2020-05-22",
+        cpe = "N/A",
+    ),
     com_github_zlib_ng_zlib_ng = dict(
         project_name = "zlib-ng",
         project_desc = "zlib fork (higher performance)",
@@ -72,6 +72,46 @@ public:
 
 using SliceDataPtr = std::unique_ptr<SliceData>;
 
+/**
+ * An account of the buffer memory of a downstream stream. The buffers of the stream are bound to
+ * the account, and their slices are charged to it for as long as they live, even once they moved
+ * to the buffers of other streams or connections.
+ */
+class BufferMemoryAccount {
+public:
+  virtual ~BufferMemoryAccount() = default;
+
+  /**
+   * @return the number of bytes charged to the account.
+   */
+  virtual uint64_t balance() const PURE;
+
+  /**
+   * Charges the account for the storage of a slice.
+   * @param amount supplies the number of bytes of the storage.
+   */
+  virtual void charge(uint64_t amount) PURE;
+
+  /**
+   * Credits the account for the storage of a slice which was freed.
+   * @param amount supplies the number of bytes of the storage.
+   */
+  virtual void credit(uint64_t amount) PURE;
+
+  /**
+   * Resets the stream of the account, to reclaim its buffer memory.
+   */
+  virtual void resetDownstream() PURE;
+
+  /**
+   * Detaches the account from its stream, which is being destroyed while slices charged to the
+   * account may still live on.
+   */
+  virtual void clearDownstream() PURE;
+};
+
+using BufferMemoryAccountSharedPtr = std::shared_ptr<BufferMemoryAccount>;
+
 /**
  * A basic buffer abstraction.
  */
@@ -88,6 +128,13 @@ public:
    */
   virtual void addDrainTracker(std::function<void()> drain_tracker) PURE;
 
+  /**
+   * Binds the buffer to an account, which the slices allocated by the buffer afterwards, or moved
+   * into it without an account, are charged to. Must be called while the buffer is empty.
+   * @param account supplies the account.
+   */
+  virtual void bindAccount(BufferMemoryAccountSharedPtr account) PURE;
+
   /**
    * Copy data into the buffer (deprecated, use absl::string_view variant
    * instead).
@@ -436,6 +483,28 @@ public:
   virtual InstancePtr create(std::function<void()> below_low_watermark,
                              std::function<void()> above_high_watermark,
                              std::function<void()> above_overflow_watermark) PURE;
+
+  /**
+   * Starts tracking the buffer memory of the downstream streams, for resetAccountsGivenPressure()
+   * to reset the streams holding the most memory.
+   */
+  virtual void trackAccounts() PURE;
+
+  /**
+   * Creates an account for the buffers of a downstream stream, if the buffer memory of the streams
+   * is tracked.
+   * @param reset_stream supplies the function which resets the stream.
+   * @return the account, or nullptr if the buffer memory of the streams is not tracked.
+   */
+  virtual BufferMemoryAccountSharedPtr createAccount(std::function<void()> reset_stream) PURE;
+
+  /**
+   * Resets the streams of the accounts holding the most buffer memory, the more of them the
+   * higher the pressure.
+   * @param pressure supplies the memory pressure, between 0 and 1.
+   * @return the number of streams reset.
+   */
+  virtual uint64_t resetAccountsGivenPressure(float pressure) PURE;
 };
 
 using WatermarkFactoryPtr = std::unique_ptr<WatermarkFactory>;
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "envoy/common/matchers.h"
 
@@ -24,5 +26,26 @@ public:
 
 using CompiledMatcherPtr = std::unique_ptr<const CompiledMatcher>;
 
+/**
+ * A set of compiled regexes matched against a value in a single scan, rather than one scan per
+ * regex.
+ */
+class CompiledMatcherSet {
+public:
+  virtual ~CompiledMatcherSet() = default;
+
+  /**
+   * @return whether any regex of the set matches the whole value.
+   */
+  virtual bool matchAny(absl::string_view value) const PURE;
+
+  /**
+   * @return the indices of the regexes of the set matching the whole value, in ascending order.
+   */
+  virtual std::vector<uint32_t> matches(absl::string_view value) const PURE;
+};
+
+using CompiledMatcherSetPtr = std::unique_ptr<const CompiledMatcherSet>;
+
 } // namespace Regex
 } // namespace Envoy
@@ -5,6 +5,7 @@
 #include "envoy/common/exception.h"
 #include "envoy/common/pure.h"
 #include "envoy/config/subscription.h"
+#include "envoy/service/discovery/v3/discovery.pb.h"
 #include "envoy/stats/stats_macros.h"
 
 #include "common/common/cleanup.h"
@@ -17,10 +18,11 @@ using ScopedResume = std::unique_ptr<Cleanup>;
 /**
  * All control plane related stats. @see stats_macros.h
  */
-#define ALL_CONTROL_PLANE_STATS(COUNTER, GAUGE, TEXT_READOUT)                                      \
+#define ALL_CONTROL_PLANE_STATS(COUNTER, GAUGE, HISTOGRAM, TEXT_READOUT)                           \
   COUNTER(rate_limit_enforced)                                                                     \
   GAUGE(connected_state, NeverImport)                                                              \
   GAUGE(pending_requests, Accumulate)                                                              \
+  HISTOGRAM(response_arena_bytes, Bytes)                                                           \
   TEXT_READOUT(identifier)
 
 /**
@@ -28,7 +30,7 @@ using ScopedResume = std::unique_ptr<Cleanup>;
  */
 struct ControlPlaneStats {
   ALL_CONTROL_PLANE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT,
-                          GENERATE_TEXT_READOUT_STRUCT)
+                          GENERATE_HISTOGRAM_STRUCT, GENERATE_TEXT_READOUT_STRUCT)
 };
 
 /**
@@ -108,6 +110,22 @@ public:
   virtual void requestOnDemandUpdate(const std::string& type_url,
                                      const std::set<std::string>& for_update) PURE;
 
+  /**
+   * @return the last accepted state of the world update of each type, to be handed to the process
+   *         that replaces this one on hot restart. Empty unless the mux was configured to keep
+   *         them.
+   */
+  virtual std::vector<envoy::service::discovery::v3::DiscoveryResponse> handoffResponses() PURE;
+
+  /**
+   * Applies the updates handed over by the parent process on hot restart, each once its type is
+   * subscribed to, unless the management server has updated the type already.
+   * @param responses supplies the last accepted update of each type of the parent process.
+   */
+  virtual void
+  applyHandoffResponses(std::vector<envoy::service::discovery::v3::DiscoveryResponse>&& responses)
+      PURE;
+
   using TypeUrlMap = absl::flat_hash_map<std::string, std::string>;
   static TypeUrlMap& typeUrlMap() { MUTABLE_CONSTRUCT_ON_FIRST_USE(TypeUrlMap, {}); }
 };
@@ -136,9 +154,10 @@ public:
   virtual void onEstablishmentFailure() PURE;
 
   /**
-   * For the GrpcStream to pass received protos to the context.
+   * For the GrpcStream to pass received protos to the context. The proto is only valid for the
+   * duration of the call, as it may be allocated on an arena that is freed when it returns.
    */
-  virtual void onDiscoveryResponse(ResponseProtoPtr<ResponseProto>&& message,
+  virtual void onDiscoveryResponse(const ResponseProto& message,
                                    ControlPlaneStats& control_plane_stats) PURE;
 
   /**
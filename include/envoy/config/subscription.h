@@ -75,6 +75,23 @@ public:
    */
   virtual ProtobufTypes::MessagePtr decodeResource(const ProtobufWkt::Any& resource) PURE;
 
+  /**
+   * Decodes a resource like decodeResource(), except for the checks that may only run on the main
+   * thread, which finishDecodeResource() runs. Unlike decodeResource(), this may be called from
+   * any thread, and does not throw.
+   * @param resource some opaque resource (ProtobufWkt::Any).
+   * @return ProtobufTypes::MessagePtr the decoded protobuf message, or nullptr if the resource is
+   *         left to decodeResource(), e.g. when it is of an earlier version or invalid.
+   */
+  virtual ProtobufTypes::MessagePtr predecodeResource(const ProtobufWkt::Any& resource) PURE;
+
+  /**
+   * Runs the checks of decodeResource() that predecodeResource() leaves to the main thread.
+   * @param resource supplies a message returned by predecodeResource().
+   * @throw EnvoyException if the resource is rejected.
+   */
+  virtual void finishDecodeResource(const Protobuf::Message& resource) PURE;
+
   /**
    * @param resource some opaque resource (Protobuf::Message).
    * @return std::String the resource name in a Protobuf::Message returned by decodeResource(), e.g.
@@ -31,7 +31,12 @@ namespace Event {
 /**
  * All dispatcher stats. @see stats_macros.h
  */
-#define ALL_DISPATCHER_STATS(HISTOGRAM)                                                            \
+#define ALL_DISPATCHER_STATS(COUNTER, HISTOGRAM)                                                   \
+  COUNTER(busy_poll_blocks)                                                                        \
+  COUNTER(busy_poll_spin_hits)                                                                     \
+  COUNTER(busy_poll_spins)                                                                         \
+  HISTOGRAM(deferred_delete_queue_size, Unspecified)                                               \
+  HISTOGRAM(deferred_delete_us, Microseconds)                                                      \
   HISTOGRAM(loop_duration_us, Microseconds)                                                        \
   HISTOGRAM(poll_delay_us, Microseconds)
 
@@ -39,7 +44,7 @@ namespace Event {
  * Struct definition for all dispatcher stats. @see stats_macros.h
  */
 struct DispatcherStats {
-  ALL_DISPATCHER_STATS(GENERATE_HISTOGRAM_STRUCT)
+  ALL_DISPATCHER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
 using DispatcherStatsPtr = std::unique_ptr<DispatcherStats>;
@@ -128,6 +133,14 @@ public:
   virtual void registerWatchdog(const Server::WatchDogSharedPtr& watchdog,
                                 std::chrono::milliseconds min_touch_interval) PURE;
 
+  /**
+   * Makes run() poll for events without blocking, for up to the spin budget after the last event,
+   * before it blocks until the next event. This trades the CPU of the thread, which spins while it
+   * is idle, for the latency of waking it up. Must be called before run().
+   * @param spin_budget supplies how long to spin after the last event. Zero disables spinning.
+   */
+  virtual void setSpinBudget(std::chrono::microseconds spin_budget) PURE;
+
   /**
    * Returns a time-source to use with this dispatcher.
    */
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <limits>
 #include <memory>
@@ -352,6 +353,13 @@ public:
    * small window updates as satisfying the idle timeout as this is a potential DoS vector.
    */
   virtual void setFlushTimeout(std::chrono::milliseconds timeout) PURE;
+
+  /**
+   * Binds the buffers of the stream to the buffer memory account of its downstream stream. The
+   * codecs which buffer the data of a single stream per connection need not account for it.
+   * @param account supplies the account.
+   */
+  virtual void setAccount(Buffer::BufferMemoryAccountSharedPtr) {}
 };
 
 /**
@@ -405,6 +413,14 @@ struct Http1Settings {
   // - if true, the HTTP/1.1 connection is left open (where possible)
   // - if false, the HTTP/1.1 connection is terminated
   bool stream_error_on_invalid_http_message_{false};
+
+  // Coalesce the response output encoded while dispatching the requests read from a downstream
+  // connection into a single connection write, up to max_coalesced_response_bytes_.
+  bool coalesce_response_writes_{false};
+  uint32_t max_coalesced_response_bytes_{64 * 1024};
+  // If coalescing, how long the headers of a response are held for its first body data. Zero
+  // means they are not held.
+  std::chrono::milliseconds response_headers_hold_time_{};
 };
 
 /**
@@ -536,6 +536,12 @@ public:
    */
   virtual void
   requestRouteConfigUpdate(RouteConfigUpdatedCallbackSharedPtr route_config_updated_cb) PURE;
+
+  /**
+   * @return the buffer memory account of the stream, which the buffers created on behalf of the
+   *         stream, such as those of its upstream requests, are bound to. May be nullptr.
+   */
+  virtual Buffer::BufferMemoryAccountSharedPtr account() const PURE;
 };
 
 /**
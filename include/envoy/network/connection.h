@@ -342,6 +342,20 @@ public:
    *  returned.
    */
   virtual absl::optional<std::chrono::milliseconds> lastRoundTripTime() const PURE;
+
+  /**
+   * Move data between this connection and peer inside the kernel, in both directions, for as long
+   * as both connections stay open. Data is only spliced while the receiving connection has
+   * nothing buffered for writing and the sending connection has nothing buffered for reading;
+   * otherwise it flows through the read buffer and filter chains as usual. Spliced data is not
+   * seen by the read filter of the connection it arrives on, so this must only be used when that
+   * filter is the single read filter and would forward the data to peer unmodified. Byte
+   * statistics and bytes sent callbacks are updated as if the data had been read and written.
+   * @param peer supplies the connection to splice with. It must use the same dispatcher.
+   * @return bool whether splicing was enabled. It is not if either connection's transport socket
+   *         processes the data it carries, or if splicing is not supported on this platform.
+   */
+  virtual bool enableSplicing(Connection& peer) PURE;
 };
 
 using ConnectionPtr = std::unique_ptr<Connection>;
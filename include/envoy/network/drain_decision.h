@@ -1,10 +1,34 @@
 #pragma once
 
+#include <functional>
+#include <memory>
+
 #include "envoy/common/pure.h"
+#include "envoy/event/dispatcher.h"
 
 namespace Envoy {
 namespace Network {
 
+/**
+ * Registration of a connection for paced draining. Destroying the handle unregisters the
+ * connection; it must be destroyed on the thread of the connection.
+ */
+class DrainCloseHandle {
+public:
+  virtual ~DrainCloseHandle() = default;
+};
+
+using DrainCloseHandlePtr = std::unique_ptr<DrainCloseHandle>;
+
+/**
+ * Called on the thread of a connection when a paced drain selects the connection for draining. The
+ * callback must not destroy the handle of its registration.
+ * @param idle_only supplies whether the connection should only drain if it is idle, without any
+ *        request in progress.
+ * @return whether the connection started draining, or was already draining.
+ */
+using DrainCloseCb = std::function<bool(bool idle_only)>;
+
 class DrainDecision {
 public:
   virtual ~DrainDecision() = default;
@@ -14,6 +38,17 @@ public:
    *         filters to determine when this should be called for the least impact possible.
    */
   virtual bool drainClose() const PURE;
+
+  /**
+   * Registers a connection to be told when to drain, for the drain sequences which pace the
+   * draining of the connections rather than leaving it to drainClose() on request completion.
+   * @param dispatcher supplies the dispatcher of the connection, on which the callback is run.
+   * @param cb supplies the callback to run when the connection is selected for draining.
+   * @return DrainCloseHandlePtr the registration, or nullptr if the connections are not drained
+   *         at a paced rate.
+   */
+  virtual DrainCloseHandlePtr addOnDrainCloseCb(Event::Dispatcher& dispatcher,
+                                                DrainCloseCb cb) const PURE;
 };
 
 } // namespace Network
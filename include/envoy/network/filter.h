@@ -2,6 +2,7 @@
 
 #include <memory>
 
+#include "envoy/api/io_error.h"
 #include "envoy/buffer/buffer.h"
 #include "envoy/network/listen_socket.h"
 #include "envoy/network/transport_socket.h"
@@ -9,6 +10,8 @@
 
 #include "common/protobuf/protobuf.h"
 
+#include "absl/strings/string_view.h"
+
 namespace Envoy {
 
 namespace Event {
@@ -250,6 +253,35 @@ public:
  */
 using FilterFactoryCb = std::function<void(FilterManager& filter_manager)>;
 
+/**
+ * The bytes peeked from an accepted socket by its listener filters. The bytes are kept in the
+ * socket for the connection, and the bytes peeked by a listener filter are handed to the next
+ * filters of the chain so that they do not read the socket again unless they need more bytes.
+ */
+class ListenerFilterBuffer {
+public:
+  virtual ~ListenerFilterBuffer() = default;
+
+  /**
+   * Peek at the bytes received on the socket, with MSG_PEEK, which returns all of them again.
+   * Reads that fail leave the peeked bytes as they are.
+   * @param max_length supplies the maximum number of bytes to peek.
+   * @return the result of the read, whose return code is the number of bytes peeked.
+   */
+  virtual Api::IoCallUint64Result peek(uint64_t max_length) PURE;
+
+  /**
+   * @return the bytes peeked so far, which are empty until a filter peeks at the socket.
+   */
+  virtual absl::string_view data() const PURE;
+
+  /**
+   * Drop the peeked bytes. Filters that consume bytes from the socket call this so that the next
+   * filters peek at the socket again.
+   */
+  virtual void clear() PURE;
+};
+
 /**
  * Callbacks used by individual listener filter instances to communicate with the listener filter
  * manager.
@@ -268,6 +300,11 @@ public:
    */
   virtual Event::Dispatcher& dispatcher() PURE;
 
+  /**
+   * @return the buffer of the bytes peeked from the socket, shared by the listener filters.
+   */
+  virtual ListenerFilterBuffer& listenerFilterBuffer() PURE;
+
   /**
    * If a filter stopped filter iteration by returning FilterStatus::StopIteration,
    * the filter should call continueFilterChain(true) when complete to continue the filter chain,
@@ -349,6 +386,8 @@ public:
  */
 using ListenerFilterFactoryCb = std::function<void(ListenerFilterManager& filter_manager)>;
 
+class OnDemandFilterChain;
+
 /**
  * Interface representing a single filter chain.
  */
@@ -373,10 +412,40 @@ public:
    * const std::vector<FilterFactoryCb>& a list of filters to be used by the new connection.
    */
   virtual const std::vector<FilterFactoryCb>& networkFilterFactories() const PURE;
+
+  /**
+   * @return const OnDemandFilterChain* the filter chain as an on-demand filter chain, or nullptr if
+   * it is built with its listener. The other methods may only be called once it is built.
+   */
+  virtual const OnDemandFilterChain* onDemandFilterChain() const PURE;
 };
 
 using FilterChainSharedPtr = std::shared_ptr<FilterChain>;
 
+/**
+ * A filter chain that is built on the main thread the first time a connection matches it, rather
+ * than with its listener. The connections that match it wait for it to be built.
+ */
+class OnDemandFilterChain {
+public:
+  virtual ~OnDemandFilterChain() = default;
+
+  /**
+   * @return bool whether the filter chain is built. Thread safe.
+   */
+  virtual bool built() const PURE;
+
+  /**
+   * Builds the filter chain on the main thread unless it is built or being built already. Building
+   * it fails if it throws, or if its dependencies are not ready before the rebuild timeout, in
+   * which case the next call builds it again. Thread safe.
+   * @param dispatcher supplies the dispatcher of the calling thread.
+   * @param cb supplies the callback posted to the dispatcher once the filter chain is built, or
+   *        once building it has failed.
+   */
+  virtual void build(Event::Dispatcher& dispatcher, std::function<void()> cb) const PURE;
+};
+
 /**
  * A filter chain that can be drained.
  */
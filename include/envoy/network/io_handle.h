@@ -190,6 +190,12 @@ public:
    */
   virtual bool supportsUdpGro() const PURE;
 
+  /**
+   * return true if data can be moved to and from the handle with splice(2) on the descriptor
+   * returned by fdDoNotUse(), i.e. the handle does not buffer received data itself.
+   */
+  virtual bool supportsSplice() const PURE;
+
   /**
    * Bind to address. The handle should have been created with a call to socket()
    * @param address address to bind to.
@@ -153,6 +153,13 @@ public:
    * @return boolean indicating if the transport socket was able to start secure transport.
    */
   virtual bool startSecureTransport() PURE;
+
+  /**
+   * @return bool whether data may currently bypass doRead()/doWrite() and be moved directly
+   *         between the socket's IoHandle and another socket. This is only true of sockets that
+   *         pass bytes through unmodified and hold no data of their own.
+   */
+  virtual bool canSplice() const PURE;
 };
 
 using TransportSocketPtr = std::unique_ptr<TransportSocket>;
@@ -493,7 +493,7 @@ public:
 };
 
 class RateLimitPolicy;
-class Config;
+class CommonConfig;
 
 /**
  * All route specific config returned by the method at
@@ -529,9 +529,11 @@ public:
   virtual const RateLimitPolicy& rateLimitPolicy() const PURE;
 
   /**
-   * @return const Config& the RouteConfiguration that owns this virtual host.
+   * @return const CommonConfig& the settings of the RouteConfiguration that owns this virtual
+   *         host. Virtual hosts may be shared by several versions of a RouteConfiguration whose
+   *         settings are the same, so this is not the Config that routed the request.
    */
-  virtual const Config& routeConfig() const PURE;
+  virtual const CommonConfig& routeConfig() const PURE;
 
   /**
    * @return const RouteSpecificFilterConfig* the per-filter config pre-processed object for
@@ -569,6 +571,35 @@ public:
   virtual uint32_t retryShadowBufferLimit() const PURE;
 };
 
+/**
+ * The state that the adaptive hedging of a route is based on: its recent response times and how
+ * many of its recent requests were hedged. It is shared by all workers.
+ */
+class AdaptiveHedge {
+public:
+  virtual ~AdaptiveHedge() = default;
+
+  /**
+   * Counts a request towards the hedge budget.
+   * @return the delay after which the request should be hedged, or absl::nullopt if too few
+   *         responses have been observed to estimate it.
+   */
+  virtual absl::optional<std::chrono::milliseconds> onRequest() PURE;
+
+  /**
+   * Counts a hedge towards the hedge budget if the budget allows it.
+   * @return bool whether the hedge may be sent.
+   */
+  virtual bool tryHedge() PURE;
+
+  /**
+   * Records the response time of a request.
+   * @param response_time supplies the time from the end of the downstream request to the end of
+   *        the response.
+   */
+  virtual void onResponse(std::chrono::milliseconds response_time) PURE;
+};
+
 /**
  * Route level hedging policy.
  */
@@ -593,6 +624,12 @@ public:
    * will be canceled immediately.
    */
   virtual bool hedgeOnPerTryTimeout() const PURE;
+
+  /**
+   * @return AdaptiveHedge* the adaptive hedging state of the route, or nullptr if requests are not
+   * hedged based on the response times of the route.
+   */
+  virtual AdaptiveHedge* adaptiveHedge() const PURE;
 };
 
 class MetadataMatchCriterion {
@@ -1045,6 +1082,14 @@ public:
   template <class Derived> const Derived* perFilterConfigTyped(const std::string& name) const {
     return dynamic_cast<const Derived*>(perFilterConfig(name));
   }
+
+  /**
+   * @return const RouteSpecificFilterConfig* the most specific per-filter config for the given
+   *  filter name: that of the route entry if there is one, else that of the route, else that of
+   *  the virtual host of the route entry. nullptr is returned if none of them has one.
+   */
+  virtual const RouteSpecificFilterConfig*
+  mostSpecificPerFilterConfig(const std::string& name) const PURE;
 };
 
 using RouteConstSharedPtr = std::shared_ptr<const Route>;
@@ -1087,12 +1132,42 @@ enum class RouteEvalStatus {
  */
 using RouteCallback = std::function<RouteMatchStatus(RouteConstSharedPtr, RouteEvalStatus)>;
 
+/**
+ * The settings of a router configuration that apply to all of its virtual hosts.
+ */
+class CommonConfig {
+public:
+  virtual ~CommonConfig() = default;
+
+  /**
+   * Return a list of headers that will be cleaned from any requests that are not from an internal
+   * (RFC1918) source.
+   */
+  virtual const std::list<Http::LowerCaseString>& internalOnlyHeaders() const PURE;
+
+  /**
+   * @return const std::string the RouteConfiguration name.
+   */
+  virtual const std::string& name() const PURE;
+
+  /**
+   * @return whether router configuration uses VHDS.
+   */
+  virtual bool usesVhds() const PURE;
+
+  /**
+   * @return bool whether most specific header mutations should take precedence. The default
+   * evaluation order is route level, then virtual host level and finally global connection
+   * manager level.
+   */
+  virtual bool mostSpecificHeaderMutationsWins() const PURE;
+};
+
 /**
  * The router configuration.
  */
-class Config {
+class Config : public CommonConfig {
 public:
-  virtual ~Config() = default;
 
   /**
    * Based on the incoming HTTP request headers, determine the target route (containing either a
@@ -1124,29 +1199,6 @@ public:
   virtual RouteConstSharedPtr route(const RouteCallback& cb, const Http::RequestHeaderMap& headers,
                                     const StreamInfo::StreamInfo& stream_info,
                                     uint64_t random_value) const PURE;
-
-  /**
-   * Return a list of headers that will be cleaned from any requests that are not from an internal
-   * (RFC1918) source.
-   */
-  virtual const std::list<Http::LowerCaseString>& internalOnlyHeaders() const PURE;
-
-  /**
-   * @return const std::string the RouteConfiguration name.
-   */
-  virtual const std::string& name() const PURE;
-
-  /**
-   * @return whether router configuration uses VHDS.
-   */
-  virtual bool usesVhds() const PURE;
-
-  /**
-   * @return bool whether most specific header mutations should take precedence. The default
-   * evaluation order is route level, then virtual host level and finally global connection
-   * manager level.
-   */
-  virtual bool mostSpecificHeaderMutationsWins() const PURE;
 };
 
 using ConfigConstSharedPtr = std::shared_ptr<const Config>;
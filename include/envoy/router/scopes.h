@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstring>
 #include <memory>
 
 #include "envoy/config/config_provider.h"
@@ -50,14 +51,22 @@ public:
   bool operator!=(const ScopeKey& other) const;
   bool operator==(const ScopeKey& other) const;
 
+  /**
+   * @return the hash of a key after a fragment is added to it.
+   * @param key_hash the hash of the key before the fragment is added.
+   * @param fragment_hash the hash of the fragment.
+   */
+  static uint64_t combineHash(uint64_t key_hash, uint64_t fragment_hash) {
+    char buffer[sizeof(key_hash) + sizeof(fragment_hash)];
+    memcpy(buffer, &key_hash, sizeof(key_hash));
+    memcpy(buffer + sizeof(key_hash), &fragment_hash, sizeof(fragment_hash));
+    return HashUtil::xxHash64(absl::string_view(buffer, sizeof(buffer)));
+  }
+
 private:
   // Update the key's hash with the new fragment hash.
   void updateHash(const ScopeKeyFragmentBase& fragment) {
-    std::stringbuf buffer;
-    buffer.sputn(reinterpret_cast<const char*>(&hash_), sizeof(hash_));
-    const auto& fragment_hash = fragment.hash();
-    buffer.sputn(reinterpret_cast<const char*>(&fragment_hash), sizeof(fragment_hash));
-    hash_ = HashUtil::xxHash64(buffer.str());
+    hash_ = combineHash(hash_, fragment.hash());
   }
 
   uint64_t hash_{0};
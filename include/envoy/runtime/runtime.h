@@ -61,7 +61,7 @@ public:
     virtual const std::string& name() const PURE;
   };
 
-  using OverrideLayerConstPtr = std::unique_ptr<const OverrideLayer>;
+  using OverrideLayerConstSharedPtr = std::shared_ptr<const OverrideLayer>;
 
   /**
    * Returns true if a deprecated feature is allowed.
@@ -205,10 +205,11 @@ public:
    * Fetch the OverrideLayers that provide values in this snapshot. Layers are ordered from bottom
    * to top; for instance, the second layer's entries override the first layer's entries, and so on.
    * Any layer can add a key in addition to overriding keys in layers below. The layer vector is
-   * safe only for the lifetime of the Snapshot.
-   * @return const std::vector<OverrideLayerConstPtr>& the raw map of loaded values.
+   * safe only for the lifetime of the Snapshot. Successive snapshots may share the layers that did
+   * not change between them.
+   * @return const std::vector<OverrideLayerConstSharedPtr>& the raw map of loaded values.
    */
-  virtual const std::vector<OverrideLayerConstPtr>& getLayers() const PURE;
+  virtual const std::vector<OverrideLayerConstSharedPtr>& getLayers() const PURE;
 };
 
 using SnapshotConstSharedPtr = std::shared_ptr<const Snapshot>;
@@ -55,6 +55,15 @@ public:
    * absl::nullopt.
    */
   virtual Http::Http1StreamEncoderOptionsOptRef http1StreamEncoderOptions() PURE;
+
+  /**
+   * Streams the rest of the response body after the response filled in by the handler, one chunk
+   * at a time, so that large responses are neither built in memory at once nor encoded in a single
+   * event loop iteration. The chunks are encoded as the downstream connection drains them.
+   * @param next_chunk called to append the next chunk of the response body to the buffer. It
+   *        returns whether there are more chunks.
+   */
+  virtual void streamRemainingResponse(std::function<bool(Buffer::Instance&)> next_chunk) PURE;
 };
 
 /**
@@ -57,6 +57,12 @@ public:
    */
   virtual double multiKillThreshold() const PURE;
 
+  /**
+   * @return std::chrono::milliseconds the time interval after which we capture the stack of a
+   *         nonresponsive thread and record the stall. Zero disables the capture.
+   */
+  virtual std::chrono::milliseconds stallCaptureTimeout() const PURE;
+
   /**
    * @return Protobuf::RepeatedPtrField<envoy::config::bootstrap::v3::Watchdog::WatchdogAction>
    *         the WatchDog Actions that trigger on WatchDog Events.
@@ -5,6 +5,7 @@
 
 #include "envoy/common/pure.h"
 #include "envoy/event/dispatcher.h"
+#include "envoy/service/discovery/v3/discovery.pb.h"
 #include "envoy/stats/allocator.h"
 #include "envoy/stats/store.h"
 #include "envoy/thread/thread.h"
@@ -74,6 +75,14 @@ public:
    */
   virtual ServerStatsFromParent mergeParentStatsIfAny(Stats::StoreRoot& stats_store) PURE;
 
+  /**
+   * Retrieve the last accepted state of the world update of each type that our parent process
+   * received on its ADS stream, so that they are applied before the management server sends them.
+   * @return the updates, or an empty vector if there is no parent or it did not keep them.
+   */
+  virtual std::vector<envoy::service::discovery::v3::DiscoveryResponse>
+  getParentXdsResources() PURE;
+
   /**
    * Shutdown the half of our hot restarter that acts as a parent.
    */
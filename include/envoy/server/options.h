@@ -58,6 +58,13 @@ enum class DrainStrategy {
    * drainClose() will return true as soon as the drain sequence is initiated.
    */
   Immediate,
+
+  /**
+   * The connections which register with addOnDrainCloseCb() are told to drain at a paced rate
+   * per worker over the duration of the drain period, the idle ones first. drainClose() only
+   * returns true once the drain period is over.
+   */
+  Paced,
 };
 
 using CommandLineOptionsPtr = std::unique_ptr<envoy::admin::v3::CommandLineOptions>;
@@ -188,6 +195,12 @@ public:
    */
   virtual const std::string& logPath() const PURE;
 
+  /**
+   * @return uint32_t the size in bytes of the ring buffer of each thread for asynchronous
+   * application logging, or 0 to log synchronously.
+   */
+  virtual uint32_t logAsyncBufferSize() const PURE;
+
   /**
    * @return the restart epoch. 0 indicates the first server start, 1 the second, and so on.
    */
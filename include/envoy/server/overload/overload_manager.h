@@ -33,6 +33,9 @@ public:
 
   // Overload action to reduce some subset of configured timeouts.
   const std::string ReduceTimeouts = "envoy.overload_actions.reduce_timeouts";
+
+  // Overload action to reset the streams holding the most buffer memory.
+  const std::string ResetStreams = "envoy.overload_actions.reset_high_memory_stream";
 };
 
 using OverloadActionNames = ConstSingleton<OverloadActionNameValues>;
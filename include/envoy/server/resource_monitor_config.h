@@ -6,6 +6,7 @@
 #include "envoy/event/dispatcher.h"
 #include "envoy/protobuf/message_validator.h"
 #include "envoy/server/resource_monitor.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "common/protobuf/protobuf.h"
 
@@ -28,6 +29,12 @@ public:
    */
   virtual Api::Api& api() PURE;
 
+  /**
+   * @return ThreadLocal::SlotAllocator& the thread local storage, which reaches the workers once
+   *         the overload manager has started.
+   */
+  virtual ThreadLocal::SlotAllocator& threadLocal() PURE;
+
   /**
    * @return ProtobufMessage::ValidationVisitor& validation visitor for filter configuration
    *         messages.
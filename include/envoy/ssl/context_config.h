@@ -100,10 +100,21 @@ public:
   virtual bool allowRenegotiation() const PURE;
 
   /**
-   * @return The maximum number of session keys to store.
+   * @return The maximum number of session keys to store for each upstream server.
    */
   virtual size_t maxSessionKeys() const PURE;
 
+  /**
+   * @return the maximum number of upstream servers, told apart by SNI and address, whose session
+   * keys are stored. If not set, the keys of up to 1024 servers are stored.
+   */
+  virtual absl::optional<uint32_t> maxSessionCacheSize() const PURE;
+
+  /**
+   * @return true if the connections that resume a session send TLS 1.3 early data.
+   */
+  virtual bool earlyDataEnabled() const PURE;
+
   /**
    * @return const std::string& with the signature algorithms for the context.
    *         This is a :-delimited list of algorithms, see
@@ -129,6 +140,13 @@ public:
     MustStaple,
   };
 
+  struct DynamicRecordSizing {
+    // The maximum size of the first record, and by how much each following record can grow.
+    uint32_t initial_record_size_;
+    // How long a connection is idle for before its records start small again.
+    std::chrono::milliseconds idle_timeout_;
+  };
+
   /**
    * @return True if client certificate is required, false otherwise.
    */
@@ -157,6 +175,18 @@ public:
    * @return True if stateless TLS session resumption is disabled, false otherwise.
    */
   virtual bool disableStatelessSessionResumption() const PURE;
+
+  /**
+   * @return the maximum number of sessions kept in the cache of sessions resumed by session ID,
+   * which the workers share. If not set, the sessions are cached by BoringSSL.
+   */
+  virtual absl::optional<uint32_t> maxSessionCacheSize() const PURE;
+
+  /**
+   * @return how the records written on the connections are sized to lower the time to the first
+   * byte. If not set, the records are up to 16KiB long.
+   */
+  virtual absl::optional<DynamicRecordSizing> dynamicRecordSizing() const PURE;
 };
 
 using ServerContextConfigPtr = std::unique_ptr<ServerContextConfig>;
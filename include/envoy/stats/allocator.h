@@ -58,6 +58,14 @@ public:
   virtual const SymbolTable& constSymbolTable() const PURE;
   virtual SymbolTable& symbolTable() PURE;
 
+  /**
+   * Sets whether the counters made from now on spread their increments across per-thread shards,
+   * which are summed when the counters are read. Sharded counters take more memory, and are only
+   * worth it for counters that many threads increment concurrently.
+   * @param shard_counters supplies whether to shard the counters made from now on.
+   */
+  virtual void setCounterSharding(bool shard_counters) PURE;
+
   // TODO(jmarantz): create a parallel mechanism to instantiate histograms. At
   // the moment, histograms don't fit the same pattern of counters and gauges
   // as they are not actually created in the context of a stats allocator.
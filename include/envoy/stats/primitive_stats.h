@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <string>
 
 #include "common/common/assert.h"
@@ -60,5 +63,65 @@ private:
 
 using PrimitiveGaugeReference = std::reference_wrapper<const PrimitiveGauge>;
 
+/**
+ * Primitive gauge that is sharded across cache lines, for gauges that are updated by all the
+ * workers on the hot path. Each thread updates its own shard, so updates from different workers do
+ * not contend on the same cache line, while value() sums the shards. As a thread may decrement the
+ * gauge incremented by another, a shard may be negative, but the sum of the shards is not.
+ */
+class ShardedPrimitiveGauge : NonCopyable {
+public:
+  static constexpr uint32_t NumShards = 8;
+
+  ShardedPrimitiveGauge() = default;
+
+  uint64_t value() const {
+    int64_t value = 0;
+    for (const Shard& shard : shards_) {
+      value += shard.value_.load(std::memory_order_relaxed);
+    }
+    return std::max<int64_t>(value, 0);
+  }
+
+  /**
+   * @return the share of the gauge of the shard of the calling thread, i.e. the increments less
+   *         the decrements of the threads that share the shard. Threads are assigned shards round
+   *         robin, so with at most NumShards threads that update the gauge this is the share of the
+   *         calling thread.
+   */
+  uint64_t localValue() const {
+    return std::max<int64_t>(shards_[threadShard()].value_.load(std::memory_order_relaxed), 0);
+  }
+
+  void add(uint64_t amount) {
+    shards_[threadShard()].value_.fetch_add(amount, std::memory_order_relaxed);
+  }
+  void dec() { sub(1); }
+  void inc() { add(1); }
+  // Sets the gauge from the calling thread, e.g. in tests.
+  void set(uint64_t value) {
+    for (Shard& shard : shards_) {
+      shard.value_.store(0, std::memory_order_relaxed);
+    }
+    shards_[threadShard()].value_.store(value, std::memory_order_relaxed);
+  }
+  void sub(uint64_t amount) {
+    shards_[threadShard()].value_.fetch_sub(amount, std::memory_order_relaxed);
+  }
+
+private:
+  struct alignas(64) Shard {
+    std::atomic<int64_t> value_{0};
+  };
+
+  static uint32_t threadShard() {
+    static std::atomic<uint32_t> next_shard{0};
+    static thread_local const uint32_t shard = next_shard++ % NumShards;
+    return shard;
+  }
+
+  std::array<Shard, NumShards> shards_;
+};
+
 } // namespace Stats
 } // namespace Envoy
@@ -47,6 +47,9 @@ namespace Envoy {
 #define PRIMITIVE_COUNTER_NAME_AND_REFERENCE(X) {absl::string_view(#X), std::ref(X##_)},
 #define PRIMITIVE_GAUGE_NAME_AND_REFERENCE(X) {absl::string_view(#X), std::ref(X##_)},
 
+// Name and gauge value pair used to construct map of gauges that are not all PrimitiveGauges.
+#define PRIMITIVE_GAUGE_NAME_AND_VALUE(X) {absl::string_view(#X), X##_.value()},
+
 // Ignore a counter or gauge.
 #define IGNORE_PRIMITIVE_COUNTER(X)
 #define IGNORE_PRIMITIVE_GAUGE(X)
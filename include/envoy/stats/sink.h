@@ -23,22 +23,26 @@ public:
   virtual ~MetricSnapshot() = default;
 
   /**
-   * @return a snapshot of all counters with pre-latched deltas.
+   * @return a snapshot of all counters with pre-latched deltas. If all the sinks flush changed
+   *         metrics only, the counters with a delta of 0 are left out.
    */
   virtual const std::vector<CounterSnapshot>& counters() PURE;
 
   /**
-   * @return a snapshot of all gauges.
+   * @return a snapshot of all gauges. If all the sinks flush changed metrics only, the gauges that
+   *         did not change since the previous flush are left out.
    */
   virtual const std::vector<std::reference_wrapper<const Gauge>>& gauges() PURE;
 
   /**
-   * @return a snapshot of all histograms.
+   * @return a snapshot of all histograms. If all the sinks flush changed metrics only, the
+   *         histograms without samples since the previous flush are left out.
    */
   virtual const std::vector<std::reference_wrapper<const ParentHistogram>>& histograms() PURE;
 
   /**
-   * @return a snapshot of all text readouts.
+   * @return a snapshot of all text readouts. If all the sinks flush changed metrics only, the text
+   *         readouts that did not change since the previous flush are left out.
    */
   virtual const std::vector<std::reference_wrapper<const TextReadout>>& textReadouts() PURE;
 
@@ -68,6 +72,13 @@ public:
    * @param value the value of the sample.
    */
   virtual void onHistogramComplete(const Histogram& histogram, uint64_t value) PURE;
+
+  /**
+   * @return whether the sink only needs the metrics that changed since the previous flush. When
+   *         all the sinks do, the snapshot of each flush only holds those, which saves copying
+   *         the references to all the metrics of large stores.
+   */
+  virtual bool flushChangedMetricsOnly() const { return false; }
 };
 
 using SinkPtr = std::unique_ptr<Sink>;
@@ -92,6 +92,7 @@ public:
     static const uint8_t Used = 0x01;
     static const uint8_t LogicAccumulate = 0x02;
     static const uint8_t NeverImport = 0x04;
+    static const uint8_t Changed = 0x08;
   };
   virtual SymbolTable& symbolTable() PURE;
   virtual const SymbolTable& constSymbolTable() const PURE;
@@ -159,6 +160,12 @@ public:
    * @param import_mode the new import mode.
    */
   virtual void mergeImportMode(ImportMode import_mode) PURE;
+
+  /**
+   * @return whether the gauge was updated since the previous call, which clears the changed state.
+   *         Stat flushes call it once per flush to only flush the changed gauges.
+   */
+  virtual bool latchChanged() PURE;
 };
 
 using GaugeSharedPtr = RefcountPtr<Gauge>;
@@ -186,6 +193,12 @@ public:
    * @return the copy of this TextReadout value.
    */
   virtual std::string value() const PURE;
+
+  /**
+   * @return whether this TextReadout was set since the previous call, which clears the changed
+   *         state. @see Gauge::latchChanged()
+   */
+  virtual bool latchChanged() PURE;
 };
 
 using TextReadoutSharedPtr = RefcountPtr<TextReadout>;
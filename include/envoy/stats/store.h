@@ -10,6 +10,8 @@
 #include "envoy/stats/stats_matcher.h"
 #include "envoy/stats/tag_producer.h"
 
+#include "absl/strings/string_view.h"
+
 namespace Envoy {
 namespace Event {
 
@@ -24,6 +26,15 @@ namespace Stats {
 
 class Sink;
 
+/**
+ * The counters, gauges and text readouts selected by Store::selectStats().
+ */
+struct SelectedStats {
+  std::vector<CounterSharedPtr> counters_;
+  std::vector<GaugeSharedPtr> gauges_;
+  std::vector<TextReadoutSharedPtr> text_readouts_;
+};
+
 /**
  * A store for all known counters, gauges, and timers.
  */
@@ -48,6 +59,15 @@ public:
    * @return a list of all known histograms.
    */
   virtual std::vector<ParentHistogramSharedPtr> histograms() const PURE;
+
+  /**
+   * Selects the counters, gauges and text readouts whose names start with a prefix, e.g. the stats
+   * of a cluster. The store may answer this without visiting the stats that cannot match.
+   * @param prefix the prefix of the names of the stats. An empty prefix selects all the stats.
+   * @param used_only whether to leave out the stats that were never used.
+   * @return the selected stats.
+   */
+  virtual SelectedStats selectStats(absl::string_view prefix, bool used_only) const PURE;
 };
 
 using StorePtr = std::unique_ptr<Store>;
@@ -85,6 +105,12 @@ public:
    */
   virtual void setHistogramSettings(HistogramSettingsConstPtr&& histogram_settings) PURE;
 
+  /**
+   * Sets whether the counters created from now on are sharded across threads.
+   * @see Allocator::setCounterSharding()
+   */
+  virtual void setCounterSharding(bool shard_counters) PURE;
+
   /**
    * Initialize the store for threading. This will be called once after all worker threads have
    * been initialized. At this point the store can initialize itself for multi-threaded operation.
@@ -102,6 +102,14 @@ public:
    */
   virtual Tcp::ConnectionPool::ConnectionData*
   onDownstreamEvent(Network::ConnectionEvent event) PURE;
+
+  /**
+   * Attempt to forward data between the downstream connection and this upstream inside the
+   * kernel. See Network::Connection::enableSplicing().
+   * @param downstream supplies the downstream connection.
+   * @return bool whether data will be spliced.
+   */
+  virtual bool enableSplicing(Network::Connection& downstream) PURE;
 };
 
 using GenericConnPoolPtr = std::unique_ptr<GenericConnPool>;
@@ -10,6 +10,7 @@
 #include "envoy/thread_local/thread_local_object.h"
 
 #include "common/common/assert.h"
+#include "common/common/cleanup.h"
 
 namespace Envoy {
 namespace ThreadLocal {
@@ -197,6 +198,11 @@ template <class T = ThreadLocalObject> using TypedSlotPtr = std::unique_ptr<Type
 /**
  * Interface for getting and setting thread local data as well as registering a thread
  */
+/**
+ * RAII handle of a batch of slot updates, see Instance::startBatch().
+ */
+using ScopedBatch = std::unique_ptr<Cleanup>;
+
 class Instance : public SlotAllocator {
 public:
   /**
@@ -226,6 +232,17 @@ public:
    * @return Event::Dispatcher& the thread local dispatcher.
    */
   virtual Event::Dispatcher& dispatcher() PURE;
+
+  /**
+   * Starts a batch of slot updates on the main thread, which ends when the returned handle is
+   * destroyed. During a batch, set() and runOnAllThreads() still run on the main thread
+   * immediately, but the updates of the workers are queued and posted to each worker in a single
+   * callback when the outermost batch ends, instead of one post per update and worker. A set() of
+   * a slot drops the queued set() of the same slot, if nothing else was queued for the slot since,
+   * as the workers would overwrite its data anyway. Batches may be nested.
+   * @return ScopedBatch the handle that ends the batch on destruction.
+   */
+  virtual ScopedBatch startBatch() PURE;
 };
 
 } // namespace ThreadLocal
@@ -12,6 +12,7 @@
 #include "envoy/stats/stats_macros.h"
 #include "envoy/upstream/health_check_host_monitor.h"
 #include "envoy/upstream/outlier_detection.h"
+#include "envoy/upstream/response_time_monitor.h"
 
 #include "absl/strings/string_view.h"
 
@@ -34,23 +35,26 @@ using MetadataConstSharedPtr = std::shared_ptr<const envoy::config::core::v3::Me
   COUNTER(rq_success)                                                                              \
   COUNTER(rq_timeout)                                                                              \
   COUNTER(rq_total)                                                                                \
-  GAUGE(cx_active)                                                                                 \
-  GAUGE(rq_active)
+  GAUGE(cx_active)
 
 /**
  * All per host stats defined. @see stats_macros.h
  */
 struct HostStats {
   ALL_HOST_STATS(GENERATE_PRIMITIVE_COUNTER_STRUCT, GENERATE_PRIMITIVE_GAUGE_STRUCT);
+  // Updated by all the workers for each request, and read by the load balancers of all the workers
+  // for each pick, so it is sharded to keep the workers from contending on its cache line.
+  Stats::ShardedPrimitiveGauge rq_active_;
 
   // Provide access to name,counter pairs.
   std::vector<std::pair<absl::string_view, Stats::PrimitiveCounterReference>> counters() const {
     return {ALL_HOST_STATS(PRIMITIVE_COUNTER_NAME_AND_REFERENCE, IGNORE_PRIMITIVE_GAUGE)};
   }
 
-  // Provide access to name,gauge pairs.
-  std::vector<std::pair<absl::string_view, Stats::PrimitiveGaugeReference>> gauges() const {
-    return {ALL_HOST_STATS(IGNORE_PRIMITIVE_COUNTER, PRIMITIVE_GAUGE_NAME_AND_REFERENCE)};
+  // Provide access to name,gauge value pairs.
+  std::vector<std::pair<absl::string_view, uint64_t>> gauges() const {
+    return {ALL_HOST_STATS(IGNORE_PRIMITIVE_COUNTER, PRIMITIVE_GAUGE_NAME_AND_VALUE)
+                PRIMITIVE_GAUGE_NAME_AND_VALUE(rq_active)};
   }
 };
 
@@ -98,6 +102,12 @@ public:
    */
   virtual HealthCheckHostMonitor& healthChecker() const PURE;
 
+  /**
+   * @return the response time monitor of the host, which is a null monitor unless the load
+   *         balancer of the cluster compares the response times of the hosts.
+   */
+  virtual ResponseTimeMonitor& responseTimeMonitor() const PURE;
+
   /**
    * @return The hostname used as the host header for health checking.
    */
@@ -107,6 +107,18 @@ public:
    * elements in a list value defined in endpoint metadata.
    */
   virtual bool listAsAny() const PURE;
+
+  /*
+   * @return bool whether the load balancers of subsets are only created for the first request
+   * routed to the subsets.
+   */
+  virtual bool lazySubsets() const PURE;
+
+  /*
+   * @return uint32_t the number of requests after which the load balancers of lazy subsets that
+   * received none of the requests are destroyed, or 0 if they are never destroyed.
+   */
+  virtual uint32_t lazySubsetIdleRequests() const PURE;
 };
 
 } // namespace Upstream
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * A monitor of the response times of a host, which latency aware load balancers use to compare
+ * hosts. Response times are put and read on every thread.
+ */
+class ResponseTimeMonitor {
+public:
+  virtual ~ResponseTimeMonitor() = default;
+
+  /**
+   * Records the response time of a request to the host.
+   * @param response_time the time from the end of the request to the end of the response.
+   */
+  virtual void putResponseTime(std::chrono::milliseconds response_time) PURE;
+
+  /**
+   * @return the peak EWMA of the response times of the host in milliseconds, as seen by the calling
+   *         thread, or 0 if the calling thread has not recorded a response time yet.
+   */
+  virtual double peakEwma() const PURE;
+};
+
+using ResponseTimeMonitorPtr = std::unique_ptr<ResponseTimeMonitor>;
+
+} // namespace Upstream
+} // namespace Envoy
@@ -113,10 +113,9 @@ public:
                               const envoy::config::core::v3::Metadata* metadata) const PURE;
 
   /**
-   * @return host specific gauges.
+   * @return the values of host specific gauges.
    */
-  virtual std::vector<std::pair<absl::string_view, Stats::PrimitiveGaugeReference>>
-  gauges() const PURE;
+  virtual std::vector<std::pair<absl::string_view, uint64_t>> gauges() const PURE;
 
   /**
    * Atomically clear a health flag for a host. Flags are specified in HealthFlags.
@@ -553,11 +552,15 @@ public:
   COUNTER(upstream_cx_destroy_with_active_rq)                                                      \
   COUNTER(upstream_cx_http1_total)                                                                 \
   COUNTER(upstream_cx_http2_total)                                                                 \
+  COUNTER(upstream_cx_http3_total)                                                                 \
+  COUNTER(upstream_cx_idle_evicted)                                                                \
   COUNTER(upstream_cx_idle_timeout)                                                                \
   COUNTER(upstream_cx_max_requests)                                                                \
   COUNTER(upstream_cx_none_healthy)                                                                \
   COUNTER(upstream_cx_overflow)                                                                    \
   COUNTER(upstream_cx_pool_overflow)                                                               \
+  COUNTER(upstream_cx_preconnect_unused)                                                           \
+  COUNTER(upstream_cx_preconnect_used)                                                             \
   COUNTER(upstream_cx_protocol_error)                                                              \
   COUNTER(upstream_cx_rx_bytes_total)                                                              \
   COUNTER(upstream_cx_total)                                                                       \
@@ -720,6 +723,8 @@ public:
     // If USE_ALPN and HTTP2 are true, the upstream protocol will be negotiated using ALPN.
     // If ALPN is attempted but not supported by the upstream HTTP/1.1 is used.
     static const uint64_t USE_ALPN = 0x8;
+    // Whether the upstream supports HTTP3. This is used when creating connection pools.
+    static const uint64_t HTTP3 = 0x10;
   };
 
   virtual ~ClusterInfo() = default;
@@ -750,6 +755,12 @@ public:
    */
   virtual float peekaheadRatio() const PURE;
 
+  /**
+   * @return how many idle connections each connection pool should keep established to its
+   *         upstream ahead of demand.
+   */
+  virtual uint32_t perUpstreamMinIdleConnections() const PURE;
+
   /**
    * @return soft limit on size of the cluster's connections read and write buffers.
    */
@@ -773,6 +784,13 @@ public:
    */
   virtual const envoy::config::core::v3::Http2ProtocolOptions& http2Options() const PURE;
 
+  /**
+   * @return const envoy::config::core::v3::Http3ProtocolOptions& for HTTP/3 connections
+   * created on behalf of this cluster.
+   *         @see envoy::config::core::v3::Http3ProtocolOptions.
+   */
+  virtual const envoy::config::core::v3::Http3ProtocolOptions& http3Options() const PURE;
+
   /**
    * @return const envoy::config::core::v3::HttpProtocolOptions for all of HTTP versions.
    */
@@ -81,8 +81,9 @@ AccessLogFileImpl::~AccessLogFileImpl() {
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
   if (file_->isOpen()) {
-    if (flush_buffer_.length() > 0) {
-      doWrite(flush_buffer_);
+    drainWriteShards(about_to_write_buffer_);
+    if (about_to_write_buffer_.length() > 0) {
+      doWrite(about_to_write_buffer_);
     }
 
     const Api::IoCallBoolResult result = file_->close();
@@ -128,9 +129,9 @@ void AccessLogFileImpl::flushThreadFunc() {
     {
       Thread::LockGuard write_lock(write_lock_);
 
-      // flush_event_ can be woken up either by large enough flush_buffer or by timer.
-      // In case it was timer, flush_buffer_ can be empty.
-      while (flush_buffer_.length() == 0 && !flush_thread_exit_ && !reopen_file_) {
+      // flush_event_ can be woken up either by large enough write shards or by timer.
+      // In case it was timer, the write shards can be empty.
+      while (buffered_bytes_ == 0 && !flush_thread_exit_ && !reopen_file_) {
         // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
         flush_event_.wait(write_lock_);
       }
@@ -140,8 +141,7 @@ void AccessLogFileImpl::flushThreadFunc() {
       }
 
       flush_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-      about_to_write_buffer_.move(flush_buffer_);
-      ASSERT(flush_buffer_.length() == 0);
+      drainWriteShards(about_to_write_buffer_);
     }
 
     // if we failed to open file before, then simply ignore
@@ -171,40 +171,67 @@ void AccessLogFileImpl::flush() {
 
     // flush_lock_ must be held while checking this or else it is
     // possible that flushThreadFunc() has already moved data from
-    // flush_buffer_ to about_to_write_buffer_, has unlocked write_lock_,
+    // the write shards to about_to_write_buffer_, has unlocked write_lock_,
     // but has not yet completed doWrite(). This would allow flush() to
     // return before the pending data has actually been written to disk.
     flush_buffer_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
 
-    if (flush_buffer_.length() == 0) {
+    drainWriteShards(about_to_write_buffer_);
+    if (about_to_write_buffer_.length() == 0) {
       return;
     }
-
-    about_to_write_buffer_.move(flush_buffer_);
-    ASSERT(flush_buffer_.length() == 0);
   }
 
   doWrite(about_to_write_buffer_);
 }
 
 void AccessLogFileImpl::write(absl::string_view data) {
-  Thread::LockGuard lock(write_lock_);
+  if (!flush_thread_started_) {
+    Thread::LockGuard lock(write_lock_);
+    if (flush_thread_ == nullptr) {
+      // The data is buffered before write_lock_ is released, so that the flush thread flushes it
+      // on its first loop.
+      createFlushStructures();
+      if (bufferWrite(data)) {
+        flush_event_.notifyOne();
+      }
+      return;
+    }
+  }
 
-  if (flush_thread_ == nullptr) {
-    createFlushStructures();
+  if (bufferWrite(data)) {
+    Thread::LockGuard lock(write_lock_);
+    flush_event_.notifyOne();
   }
+}
 
+bool AccessLogFileImpl::bufferWrite(absl::string_view data) {
+  WriteShard& shard =
+      write_shards_[static_cast<uint64_t>(thread_factory_.currentThreadId().getId()) %
+                    WRITE_SHARDS];
+  uint64_t buffered;
+  {
+    Thread::LockGuard lock(shard.lock_);
+    shard.buffer_.add(data.data(), data.size());
+    buffered = buffered_bytes_ += data.size();
+  }
   stats_.write_buffered_.inc();
   stats_.write_total_buffered_.add(data.length());
-  flush_buffer_.add(data.data(), data.size());
-  if (flush_buffer_.length() > MIN_FLUSH_SIZE) {
-    flush_event_.notifyOne();
+  return buffered > MIN_FLUSH_SIZE && buffered - data.size() <= MIN_FLUSH_SIZE;
+}
+
+void AccessLogFileImpl::drainWriteShards(Buffer::Instance& buffer) {
+  for (WriteShard& shard : write_shards_) {
+    Thread::LockGuard lock(shard.lock_);
+    buffered_bytes_ -= shard.buffer_.length();
+    buffer.move(shard.buffer_);
   }
 }
 
 void AccessLogFileImpl::createFlushStructures() {
   flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); },
                                                Thread::Options{"AccessLogFlush"});
+  flush_thread_started_ = true;
   flush_timer_->enableTimer(flush_interval_msec_);
 }
 
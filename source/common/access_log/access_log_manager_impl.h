@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <string>
 
 #include "envoy/access_log/access_log.h"
@@ -82,6 +84,17 @@ public:
   void flush() override;
 
 private:
+  // A buffer filled by the threads whose ids map to it, so that the workers writing at the same
+  // time do not contend on a single lock.
+  struct WriteShard {
+    Thread::MutexBasicLockable lock_;
+    Buffer::OwnedImpl buffer_ ABSL_GUARDED_BY(lock_);
+  };
+
+  // Returns whether the write brought the buffered data over MIN_FLUSH_SIZE.
+  bool bufferWrite(absl::string_view data);
+  // Moves the data of all the write shards to the end of buffer.
+  void drainWriteShards(Buffer::Instance& buffer);
   void doWrite(Buffer::Instance& buffer);
   void flushThreadFunc();
   void open();
@@ -92,13 +105,16 @@ private:
 
   // Minimum size before the flush thread will be told to flush.
   static const uint64_t MIN_FLUSH_SIZE = 1024 * 64;
+  // The number of write shards. Threads share a shard only if their ids collide modulo this.
+  static const size_t WRITE_SHARDS = 16;
 
   Filesystem::FilePtr file_;
 
   // These locks are always acquired in the following order if multiple locks are held:
   //    1) write_lock_
   //    2) flush_lock_
-  //    3) file_lock_
+  //    3) the lock of a write shard
+  //    4) file_lock_
   Thread::BasicLockable& file_lock_;      // This lock is used only by the flush thread when writing
                                           // to disk. This is used to make sure that file blocks do
                                           // not get interleaved by multiple processes writing to
@@ -109,23 +125,25 @@ private:
                                           // and all other data used during flushing and file
                                           // re-opening.
   Thread::MutexBasicLockable
-      write_lock_; // The lock is used when filling the flush buffer. It allows
-                   // multiple threads to write to the same file at relatively
-                   // high performance. It is always local to the process.
+      write_lock_; // The lock guards the start of the flush thread and its wake ups. Writes only
+                   // take it to start the thread, or when they bring the buffered data over
+                   // MIN_FLUSH_SIZE. It is always local to the process.
   Thread::ThreadPtr flush_thread_;
+  std::atomic<bool> flush_thread_started_{};
   Thread::CondVar flush_event_;
   std::atomic<bool> flush_thread_exit_{};
   std::atomic<bool> reopen_file_{};
-  Buffer::OwnedImpl
-      flush_buffer_ ABSL_GUARDED_BY(write_lock_); // This buffer is used by multiple threads. It
-                                                  // gets filled and then flushed either when max
-                                                  // size is reached or when a timer fires.
+  // These buffers are filled by the writing threads, and flushed either when MIN_FLUSH_SIZE is
+  // reached or when a timer fires.
+  std::array<WriteShard, WRITE_SHARDS> write_shards_;
+  // The data buffered in all the write shards, only changed under the lock of a shard.
+  std::atomic<uint64_t> buffered_bytes_{};
   // TODO(jmarantz): this should be ABSL_GUARDED_BY(flush_lock_) but the analysis cannot poke
   // through the std::make_unique assignment. I do not believe it's possible to annotate this
   // properly now due to limitations in the clang thread annotation analysis.
   Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only by the flush thread. Data
-                                            // is moved from flush_buffer_ under lock, and then
-                                            // the lock is released so that flush_buffer_ can
+                                            // is moved from the write shards under lock, and
+                                            // then the lock is released so that the shards can
                                             // continue to fill. This buffer is then used for the
                                             // final write to disk.
   Event::TimerPtr flush_timer_;
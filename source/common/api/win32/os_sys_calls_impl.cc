@@ -172,6 +172,11 @@ SysCallIntResult OsSysCallsImpl::recvmmsg(os_fd_t sockfd, struct mmsghdr* msgvec
   NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
 }
 
+SysCallIntResult OsSysCallsImpl::sendmmsg(os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                          int flags) {
+  NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+}
+
 bool OsSysCallsImpl::supportsMmsg() const {
   // Windows doesn't support it.
   return false;
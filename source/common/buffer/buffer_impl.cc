@@ -1,5 +1,6 @@
 #include "common/buffer/buffer_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 
@@ -16,6 +17,24 @@ namespace {
 // TODO(yanavlasov): This may not be optimal for all hardware configurations or traffic patterns and
 // may need to be configurable in the future.
 constexpr uint64_t CopyThreshold = 512;
+
+/**
+ * A fragment of a shared chunk, which holds a reference to the chunk until it is drained.
+ */
+class SharedChunkFragment : public BufferFragment {
+public:
+  SharedChunkFragment(std::shared_ptr<const OwnedImpl> chunk, const RawSlice& slice)
+      : chunk_(std::move(chunk)), slice_(slice) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return slice_.mem_; }
+  size_t size() const override { return slice_.len_; }
+  void done() override { delete this; }
+
+private:
+  const std::shared_ptr<const OwnedImpl> chunk_;
+  const RawSlice slice_;
+};
 } // namespace
 
 void OwnedImpl::addImpl(const void* data, uint64_t size) {
@@ -23,7 +42,7 @@ void OwnedImpl::addImpl(const void* data, uint64_t size) {
   bool new_slice_needed = slices_.empty();
   while (size != 0) {
     if (new_slice_needed) {
-      slices_.emplace_back(size);
+      slices_.emplace_back(Slice(size, account_));
     }
     uint64_t copy_size = slices_.back().append(src, size);
     src += copy_size;
@@ -38,6 +57,11 @@ void OwnedImpl::addDrainTracker(std::function<void()> drain_tracker) {
   slices_.back().addDrainTracker(std::move(drain_tracker));
 }
 
+void OwnedImpl::bindAccount(BufferMemoryAccountSharedPtr account) {
+  ASSERT(slices_.empty());
+  account_ = std::move(account);
+}
+
 void OwnedImpl::add(const void* data, uint64_t size) { addImpl(data, size); }
 
 void OwnedImpl::addBufferFragment(BufferFragment& fragment) {
@@ -59,7 +83,7 @@ void OwnedImpl::prepend(absl::string_view data) {
   bool new_slice_needed = slices_.empty();
   while (size != 0) {
     if (new_slice_needed) {
-      slices_.emplace_front(size);
+      slices_.emplace_front(Slice(size, account_));
     }
     uint64_t copy_size = slices_.front().prepend(data.data(), size);
     size -= copy_size;
@@ -74,6 +98,7 @@ void OwnedImpl::prepend(Instance& data) {
   while (!other.slices_.empty()) {
     uint64_t slice_size = other.slices_.back().dataSize();
     length_ += slice_size;
+    other.slices_.back().maybeChargeAccount(account_);
     slices_.emplace_front(std::move(other.slices_.back()));
     other.slices_.pop_back();
     other.length_ -= slice_size;
@@ -260,7 +285,7 @@ void* OwnedImpl::linearize(uint32_t size) {
     return nullptr;
   }
   if (slices_[0].dataSize() < size) {
-    Slice new_slice{size};
+    Slice new_slice{size, account_};
     Slice::Reservation reservation = new_slice.reserve(size);
     ASSERT(reservation.mem_ != nullptr);
     ASSERT(reservation.len_ == size);
@@ -293,6 +318,7 @@ void OwnedImpl::coalesceOrAddSlice(Slice&& other_slice) {
     other_slice.transferDrainTrackersTo(slices_.back());
   } else {
     // Take ownership of the slice.
+    other_slice.maybeChargeAccount(account_);
     slices_.emplace_back(std::move(other_slice));
     length_ += slice_size;
   }
@@ -378,7 +404,7 @@ uint64_t OwnedImpl::reserve(uint64_t length, RawSlice* iovecs, uint64_t num_iove
 
   // If needed, allocate one more slice at the end to provide the remainder of the reservation.
   if (bytes_remaining != 0) {
-    slices_.emplace_back(bytes_remaining);
+    slices_.emplace_back(Slice(bytes_remaining, account_));
     iovecs[num_slices_used] = slices_.back().reserve(bytes_remaining);
     bytes_remaining -= iovecs[num_slices_used].len_;
     num_slices_used++;
@@ -454,11 +480,16 @@ ssize_t OwnedImpl::search(const void* data, uint64_t size, size_t start, size_t
           match_end = match_next + match_slice.dataSize();
           continue;
         }
-        left_to_search--;
-        if (*match_next++ != needle[i]) {
+        // Compare as much of the remainder of the needle as this slice holds at once; memcmp()
+        // is vectorized by the C library.
+        const size_t to_compare = std::min(
+            {size - i, static_cast<size_t>(match_end - match_next), left_to_search});
+        if (memcmp(match_next, needle + i, to_compare) != 0) {
           break;
         }
-        i++;
+        match_next += to_compare;
+        left_to_search -= to_compare;
+        i += to_compare;
       }
       if (i == size) {
         // Successful match of the entire needle.
@@ -474,6 +505,30 @@ ssize_t OwnedImpl::search(const void* data, uint64_t size, size_t start, size_t
   return -1;
 }
 
+ssize_t OwnedImpl::searchAnyOf(absl::string_view bytes, size_t start) const {
+  if (bytes.empty()) {
+    return -1;
+  }
+  ssize_t offset = 0;
+  for (const auto& slice : slices_) {
+    const uint64_t slice_size = slice.dataSize();
+    if (slice_size <= start) {
+      start -= slice_size;
+      offset += slice_size;
+      continue;
+    }
+    // find_first_of() uses memchr() for a single byte and a lookup table otherwise.
+    const absl::string_view haystack(reinterpret_cast<const char*>(slice.data()), slice_size);
+    const size_t found = haystack.find_first_of(bytes, start);
+    if (found != absl::string_view::npos) {
+      return offset + found;
+    }
+    start = 0;
+    offset += slice_size;
+  }
+  return -1;
+}
+
 bool OwnedImpl::startsWith(absl::string_view data) const {
   if (length() < data.length()) {
     // Buffer is too short to contain data.
@@ -530,7 +585,7 @@ std::string OwnedImpl::toString() const {
 void OwnedImpl::postProcess() {}
 
 void OwnedImpl::appendSliceForTest(const void* data, uint64_t size) {
-  slices_.emplace_back(size);
+  slices_.emplace_back(Slice(size, account_));
   slices_.back().append(data, size);
   length_ += size;
 }
@@ -547,5 +602,21 @@ std::vector<Slice::SliceRepresentation> OwnedImpl::describeSlicesForTest() const
   return slices;
 }
 
+size_t SharedChunks::append(Instance& data) {
+  auto chunk = std::make_shared<OwnedImpl>();
+  chunk->move(data);
+  length_ += chunk->length();
+  chunks_.push_back(std::move(chunk));
+  return chunks_.size() - 1;
+}
+
+void SharedChunks::addTo(Instance& buffer, size_t first_chunk) const {
+  for (size_t i = first_chunk; i < chunks_.size(); ++i) {
+    for (const RawSlice& slice : chunks_[i]->getRawSlices()) {
+      buffer.addBufferFragment(*new SharedChunkFragment(chunks_[i], slice));
+    }
+  }
+}
+
 } // namespace Buffer
 } // namespace Envoy
@@ -3,14 +3,18 @@
 #include <algorithm>
 #include <cstdint>
 #include <deque>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/buffer/buffer.h"
 
+#include "common/buffer/slice_allocator.h"
 #include "common/common/assert.h"
 #include "common/common/non_copyable.h"
 #include "common/common/utility.h"
 #include "common/event/libevent.h"
+#include "common/memory/accounting.h"
 
 namespace Envoy {
 namespace Buffer {
@@ -42,18 +46,23 @@ public:
   /**
    * Create an empty mutable Slice that owns its storage.
    * @param min_capacity number of bytes of space the slice should have. Actual capacity is rounded
-   * up to the next multiple of 4kb.
+   * up to the next multiple of 4kb. Storage is obtained from the calling thread's SliceAllocator
+   * pool.
+   * @param account supplies the account to charge the storage to, if any.
    */
-  Slice(uint64_t min_capacity)
-      : capacity_(sliceSize(min_capacity)), storage_(new uint8_t[capacity_]), base_(storage_.get()),
-        data_(0), reservable_(0) {}
+  Slice(uint64_t min_capacity, const BufferMemoryAccountSharedPtr& account = nullptr)
+      : capacity_(sliceSize(min_capacity)), storage_(capacity_), base_(storage_.get()), data_(0),
+        reservable_(0) {
+    Memory::Accounting::allocate(Memory::Accounting::Account::BufferSlices, capacity_);
+    maybeChargeAccount(account);
+  }
 
   /**
    * Create an immutable Slice that refers to an external buffer fragment.
    * @param fragment provides externally owned immutable data.
    */
   Slice(BufferFragment& fragment)
-      : capacity_(fragment.size()), storage_(nullptr),
+      : capacity_(fragment.size()),
         base_(static_cast<uint8_t*>(const_cast<void*>(fragment.data()))), data_(0),
         reservable_(fragment.size()) {
     addDrainTracker([&fragment]() { fragment.done(); });
@@ -61,6 +70,7 @@ public:
 
   Slice(Slice&& rhs) noexcept {
     storage_ = std::move(rhs.storage_);
+    account_ = std::move(rhs.account_);
     drain_trackers_ = std::move(rhs.drain_trackers_);
     base_ = rhs.base_;
     data_ = rhs.data_;
@@ -76,8 +86,10 @@ public:
   Slice& operator=(Slice&& rhs) noexcept {
     if (this != &rhs) {
       callAndClearDrainTrackers();
+      freeStorageAccount();
 
       storage_ = std::move(rhs.storage_);
+      account_ = std::move(rhs.account_);
       drain_trackers_ = std::move(rhs.drain_trackers_);
       base_ = rhs.base_;
       data_ = rhs.data_;
@@ -93,7 +105,23 @@ public:
     return *this;
   }
 
-  ~Slice() { callAndClearDrainTrackers(); }
+  ~Slice() {
+    callAndClearDrainTrackers();
+    freeStorageAccount();
+  }
+
+  /**
+   * Charges the storage the slice owns to an account, unless the slice is charged to an account
+   * already.
+   * @param account supplies the account, or nullptr.
+   */
+  void maybeChargeAccount(const BufferMemoryAccountSharedPtr& account) {
+    if (account == nullptr || account_ != nullptr || storage_ == nullptr) {
+      return;
+    }
+    account->charge(capacity_);
+    account_ = account;
+  }
 
   /**
    * @return true if the data in the slice is mutable
@@ -292,18 +320,35 @@ protected:
    * @return a recommended slice size, in bytes.
    */
   static uint64_t sliceSize(uint64_t data_size) {
-    static constexpr uint64_t PageSize = 4096;
+    static constexpr uint64_t PageSize = SliceAllocator::PageSize;
     const uint64_t num_pages = (data_size + PageSize - 1) / PageSize;
     return num_pages * PageSize;
   }
 
+  /**
+   * Removes the storage the slice owns, if any, from the memory accounting, and credits the
+   * account it was charged to.
+   */
+  void freeStorageAccount() {
+    if (storage_ != nullptr) {
+      Memory::Accounting::free(Memory::Accounting::Account::BufferSlices, capacity_);
+    }
+    if (account_ != nullptr) {
+      account_->credit(capacity_);
+      account_.reset();
+    }
+  }
+
   /** Length of the byte array that base_ points to. This is also the offset in bytes from the start
    * of the slice to the end of the Reservable section. */
   uint64_t capacity_;
 
   /** Backing storage for mutable slices which own their own storage. This storage should never be
    * accessed directly; access base_ instead. */
-  std::unique_ptr<uint8_t[]> storage_;
+  SliceStorage storage_;
+
+  /** The account the storage is charged to, if any. */
+  BufferMemoryAccountSharedPtr account_;
 
   /** Start of the slice. Points to storage_ iff the slice owns its own storage. */
   uint8_t* base_{nullptr};
@@ -567,6 +612,7 @@ public:
 
   // Buffer::Instance
   void addDrainTracker(std::function<void()> drain_tracker) override;
+  void bindAccount(BufferMemoryAccountSharedPtr account) override;
   void add(const void* data, uint64_t size) override;
   void addBufferFragment(BufferFragment& fragment) override;
   void add(absl::string_view data) override;
@@ -604,6 +650,15 @@ public:
    */
   virtual void appendSliceForTest(absl::string_view data);
 
+  /**
+   * Search for the first occurrence of any of a set of bytes, e.g. delimiters, within the buffer,
+   * without linearizing it.
+   * @param bytes supplies the bytes to search for.
+   * @param start supplies the starting index to search from.
+   * @return the index of the first byte found or -1 if none of the bytes occur.
+   */
+  ssize_t searchAnyOf(absl::string_view bytes, size_t start) const;
+
   // Does not implement watermarking.
   // TODO(antoniovicente) Implement watermarks by merging the OwnedImpl and WatermarkBuffer
   // implementations. Also, make high-watermark config a constructor argument.
@@ -641,6 +696,9 @@ private:
 
   /** Sum of the dataSize of all slices. */
   OverflowDetectingUInt64 length_;
+
+  /** The account the slices are charged to, if any. */
+  BufferMemoryAccountSharedPtr account_;
 };
 
 using BufferFragmentPtr = std::unique_ptr<BufferFragment>;
@@ -684,5 +742,35 @@ private:
 
 using OwnedBufferFragmentImplPtr = std::unique_ptr<OwnedBufferFragmentImpl>;
 
+/**
+ * Immutable chunks of data that buffers reference rather than copy. Each chunk is freed once it has
+ * been drained from all the buffers it was added to and the SharedChunks is destroyed.
+ */
+class SharedChunks : NonCopyable {
+public:
+  /**
+   * Moves the content of a buffer into a new chunk.
+   * @param data supplies the buffer to move the content of. It is empty on return.
+   * @return the index of the new chunk.
+   */
+  size_t append(Instance& data);
+
+  /**
+   * Adds immutable slices that reference the chunks to a buffer.
+   * @param buffer supplies the buffer to add the slices to.
+   * @param first_chunk supplies the index of the first chunk to add.
+   */
+  void addTo(Instance& buffer, size_t first_chunk = 0) const;
+
+  /**
+   * @return the total length of the chunks.
+   */
+  uint64_t length() const { return length_; }
+
+private:
+  std::vector<std::shared_ptr<const OwnedImpl>> chunks_;
+  uint64_t length_{0};
+};
+
 } // namespace Buffer
 } // namespace Envoy
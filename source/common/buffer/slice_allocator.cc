@@ -0,0 +1,294 @@
+#include "common/buffer/slice_allocator.h"
+
+#include <array>
+#include <atomic>
+#include <new>
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+#include "common/common/thread_annotations.h"
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+std::atomic<uint64_t> max_retained_bytes_per_thread{
+    SliceAllocator::DefaultMaxRetainedBytesPerThread};
+
+// Free storage is linked through its own first bytes; slice storage is always at least one page.
+struct FreeBlock {
+  FreeBlock* next_;
+};
+
+uint64_t sizeClassBytes(uint64_t size_class) { return (size_class + 1) * SliceAllocator::PageSize; }
+
+uint8_t* heapAllocate(uint64_t capacity) { return static_cast<uint8_t*>(::operator new(capacity)); }
+void heapFree(void* storage) { ::operator delete(storage); }
+
+class ThreadPool;
+
+// Registry of live pools, used to aggregate stats. Counters of pools whose thread has exited are
+// folded into retired_stats.
+struct Registry {
+  absl::Mutex mutex_;
+  absl::flat_hash_set<ThreadPool*> pools_ ABSL_GUARDED_BY(mutex_);
+  SliceAllocatorStats retired_stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+Registry& registry() { MUTABLE_CONSTRUCT_ON_FIRST_USE(Registry); }
+
+/**
+ * The free lists of one thread. The pool is reference counted by its thread and by every block of
+ * storage it has handed out, so that storage outliving the thread (e.g. a buffer moved to another
+ * worker) can still be freed safely.
+ */
+class alignas(8) ThreadPool {
+public:
+  static constexpr uintptr_t SizeClassMask = 0x7;
+  static_assert(SliceAllocator::NumSizeClasses <= SizeClassMask + 1);
+
+  ThreadPool() {
+    Registry& reg = registry();
+    absl::MutexLock lock(&reg.mutex_);
+    reg.pools_.insert(this);
+  }
+
+  uintptr_t tag(uint64_t size_class) const {
+    return reinterpret_cast<uintptr_t>(this) | static_cast<uintptr_t>(size_class);
+  }
+
+  static ThreadPool* fromTag(uintptr_t tag) {
+    return reinterpret_cast<ThreadPool*>(tag & ~SizeClassMask);
+  }
+
+  // Called only from the owning thread.
+  uint8_t* allocate(uint64_t size_class) {
+    refs_.fetch_add(1, std::memory_order_relaxed);
+    if (has_remote_.load(std::memory_order_acquire)) {
+      reclaimRemote();
+    }
+    FreeBlock* block = free_lists_[size_class];
+    if (block != nullptr) {
+      free_lists_[size_class] = block->next_;
+      local_retained_bytes_.fetch_sub(sizeClassBytes(size_class), std::memory_order_relaxed);
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      return reinterpret_cast<uint8_t*>(block);
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return heapAllocate(sizeClassBytes(size_class));
+  }
+
+  // Called only from the owning thread.
+  void freeLocal(uint8_t* storage, uint64_t size_class) {
+    const uint64_t bytes = sizeClassBytes(size_class);
+    if (local_retained_bytes_.load(std::memory_order_relaxed) + bytes >
+        max_retained_bytes_per_thread.load(std::memory_order_relaxed)) {
+      heapFree(storage);
+    } else {
+      pushFront(free_lists_[size_class], storage);
+      local_retained_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    unref();
+  }
+
+  // Called from any thread other than the owner.
+  void freeRemote(uint8_t* storage, uint64_t size_class) {
+    const uint64_t bytes = sizeClassBytes(size_class);
+    remote_frees_.fetch_add(1, std::memory_order_relaxed);
+    {
+      absl::MutexLock lock(&remote_mutex_);
+      if (retired_ || local_retained_bytes_.load(std::memory_order_relaxed) +
+                              remote_retained_bytes_ + bytes >
+                          max_retained_bytes_per_thread.load(std::memory_order_relaxed)) {
+        heapFree(storage);
+      } else {
+        pushFront(remote_lists_[size_class], storage);
+        remote_retained_bytes_ += bytes;
+        has_remote_.store(true, std::memory_order_release);
+      }
+    }
+    unref();
+  }
+
+  // Called only from the owning thread.
+  void releaseFreeStorage() {
+    reclaimRemote();
+    for (FreeBlock*& head : free_lists_) {
+      freeAll(head);
+    }
+    local_retained_bytes_.store(0, std::memory_order_relaxed);
+  }
+
+  // Called from the owning thread when it exits. Storage still outstanding will be returned
+  // directly to the heap when freed.
+  void retire() {
+    {
+      absl::MutexLock lock(&remote_mutex_);
+      retired_ = true;
+      for (FreeBlock*& head : remote_lists_) {
+        freeAll(head);
+      }
+      remote_retained_bytes_ = 0;
+      has_remote_.store(false, std::memory_order_relaxed);
+    }
+    for (FreeBlock*& head : free_lists_) {
+      freeAll(head);
+    }
+    local_retained_bytes_.store(0, std::memory_order_relaxed);
+    {
+      Registry& reg = registry();
+      absl::MutexLock lock(&reg.mutex_);
+      reg.pools_.erase(this);
+      addStatsTo(reg.retired_stats_);
+    }
+    unref();
+  }
+
+  void addStatsTo(SliceAllocatorStats& stats) {
+    stats.hits_ += hits_.load(std::memory_order_relaxed);
+    stats.misses_ += misses_.load(std::memory_order_relaxed);
+    stats.remote_frees_ += remote_frees_.load(std::memory_order_relaxed);
+    stats.retained_bytes_ += local_retained_bytes_.load(std::memory_order_relaxed);
+    absl::MutexLock lock(&remote_mutex_);
+    stats.retained_bytes_ += remote_retained_bytes_;
+  }
+
+private:
+  static void pushFront(FreeBlock*& head, uint8_t* storage) {
+    FreeBlock* block = reinterpret_cast<FreeBlock*>(storage);
+    block->next_ = head;
+    head = block;
+  }
+
+  static void freeAll(FreeBlock*& head) {
+    while (head != nullptr) {
+      FreeBlock* next = head->next_;
+      heapFree(head);
+      head = next;
+    }
+  }
+
+  void reclaimRemote() {
+    absl::MutexLock lock(&remote_mutex_);
+    for (uint64_t i = 0; i < SliceAllocator::NumSizeClasses; i++) {
+      while (remote_lists_[i] != nullptr) {
+        FreeBlock* next = remote_lists_[i]->next_;
+        remote_lists_[i]->next_ = free_lists_[i];
+        free_lists_[i] = remote_lists_[i];
+        remote_lists_[i] = next;
+      }
+    }
+    local_retained_bytes_.fetch_add(remote_retained_bytes_, std::memory_order_relaxed);
+    remote_retained_bytes_ = 0;
+    has_remote_.store(false, std::memory_order_relaxed);
+  }
+
+  void unref() {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+  // One reference for the owning thread; one for each block handed out and not yet freed.
+  std::atomic<uint64_t> refs_{1};
+
+  // Owner-thread state. The counters are atomic only so that stats() may read them.
+  std::array<FreeBlock*, SliceAllocator::NumSizeClasses> free_lists_{};
+  std::atomic<uint64_t> local_retained_bytes_{0};
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> remote_frees_{0};
+
+  // Cheap check that lets the owner skip taking remote_mutex_ when nothing was freed remotely.
+  std::atomic<bool> has_remote_{false};
+  absl::Mutex remote_mutex_;
+  std::array<FreeBlock*, SliceAllocator::NumSizeClasses>
+      remote_lists_ ABSL_GUARDED_BY(remote_mutex_){};
+  uint64_t remote_retained_bytes_ ABSL_GUARDED_BY(remote_mutex_){0};
+  bool retired_ ABSL_GUARDED_BY(remote_mutex_){false};
+};
+
+// The calling thread's pool. Null before first use and after the thread's pool has been retired.
+thread_local ThreadPool* current_pool = nullptr;
+thread_local bool current_pool_retired = false;
+
+struct ThreadPoolHolder {
+  ThreadPoolHolder() { current_pool = new ThreadPool(); }
+  ~ThreadPoolHolder() {
+    ThreadPool* pool = current_pool;
+    current_pool = nullptr;
+    current_pool_retired = true;
+    pool->retire();
+  }
+};
+
+ThreadPool* localPool() {
+  if (current_pool == nullptr && !current_pool_retired) {
+    static thread_local ThreadPoolHolder holder;
+  }
+  return current_pool;
+}
+
+} // namespace
+
+SliceStorage::SliceStorage(uint64_t capacity) {
+  ASSERT(capacity % SliceAllocator::PageSize == 0);
+  ThreadPool* pool =
+      capacity > 0 && capacity <= SliceAllocator::MaxPooledSize ? localPool() : nullptr;
+  if (pool == nullptr) {
+    data_ = heapAllocate(capacity);
+    return;
+  }
+  const uint64_t size_class = capacity / SliceAllocator::PageSize - 1;
+  data_ = pool->allocate(size_class);
+  pool_tag_ = pool->tag(size_class);
+}
+
+void SliceStorage::reset() {
+  if (data_ == nullptr) {
+    return;
+  }
+  if (pool_tag_ == 0) {
+    heapFree(data_);
+  } else {
+    ThreadPool* owner = ThreadPool::fromTag(pool_tag_);
+    const uint64_t size_class = pool_tag_ & ThreadPool::SizeClassMask;
+    if (owner == current_pool) {
+      owner->freeLocal(data_, size_class);
+    } else {
+      owner->freeRemote(data_, size_class);
+    }
+  }
+  data_ = nullptr;
+  pool_tag_ = 0;
+}
+
+SliceAllocatorStats SliceAllocator::stats() {
+  Registry& reg = registry();
+  absl::MutexLock lock(&reg.mutex_);
+  SliceAllocatorStats stats = reg.retired_stats_;
+  for (ThreadPool* pool : reg.pools_) {
+    pool->addStatsTo(stats);
+  }
+  return stats;
+}
+
+void SliceAllocator::setMaxRetainedBytesPerThread(uint64_t max_retained_bytes) {
+  max_retained_bytes_per_thread.store(max_retained_bytes, std::memory_order_relaxed);
+}
+
+uint64_t SliceAllocator::maxRetainedBytesPerThread() {
+  return max_retained_bytes_per_thread.load(std::memory_order_relaxed);
+}
+
+void SliceAllocator::releaseFreeStorageForThread() {
+  if (current_pool != nullptr) {
+    current_pool->releaseFreeStorage();
+  }
+}
+
+} // namespace Buffer
+} // namespace Envoy
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * Aggregate counters for the slice storage pool, summed over all threads that have ever
+ * allocated slice storage.
+ */
+struct SliceAllocatorStats {
+  // Allocations served from a thread-local free list.
+  uint64_t hits_{0};
+  // Allocations that had to go to the heap, either because the free list for the size class was
+  // empty or because the requested size is larger than the largest pooled size class.
+  uint64_t misses_{0};
+  // Frees performed on a thread other than the one that allocated the storage.
+  uint64_t remote_frees_{0};
+  // Bytes of free storage currently retained by the pools, including storage waiting on
+  // remote-free lists.
+  uint64_t retained_bytes_{0};
+};
+
+/**
+ * Per-thread, size-classed free-list pool for the backing storage of Buffer::Slice.
+ *
+ * Slice capacities are always a multiple of PageSize. Capacities up to MaxPooledSize (which covers
+ * the default 16KiB socket read size) are recycled through free lists owned by the allocating
+ * thread; larger capacities always go to the heap. Storage freed on a thread other than the one
+ * that allocated it is pushed onto the owning thread's remote-free list, which the owner reclaims
+ * on its next allocation. The amount of free storage retained by each thread is capped by
+ * maxRetainedBytesPerThread(); storage freed beyond the cap is returned to the heap.
+ */
+class SliceAllocator {
+public:
+  static constexpr uint64_t PageSize = 4096;
+  static constexpr uint64_t NumSizeClasses = 4;
+  static constexpr uint64_t MaxPooledSize = NumSizeClasses * PageSize;
+  static constexpr uint64_t DefaultMaxRetainedBytesPerThread = 1024 * 1024;
+
+  /**
+   * @return a snapshot of the counters aggregated over all threads.
+   */
+  static SliceAllocatorStats stats();
+
+  /**
+   * Set the maximum number of free bytes each thread keeps in its pool. Setting this to 0
+   * disables recycling. Takes effect on subsequent frees.
+   */
+  static void setMaxRetainedBytesPerThread(uint64_t max_retained_bytes);
+  static uint64_t maxRetainedBytesPerThread();
+
+  /**
+   * Return all free storage held by the calling thread's pool to the heap.
+   */
+  static void releaseFreeStorageForThread();
+};
+
+/**
+ * Owning handle to slice storage obtained from the SliceAllocator. Movable, not copyable.
+ */
+class SliceStorage {
+public:
+  SliceStorage() = default;
+
+  /**
+   * Allocate storage.
+   * @param capacity the number of usable bytes. Must be a multiple of SliceAllocator::PageSize.
+   *        Zero-sized storage is still allocated (from the heap) so that the handle is non-null.
+   */
+  explicit SliceStorage(uint64_t capacity);
+
+  SliceStorage(SliceStorage&& rhs) noexcept : data_(rhs.data_), pool_tag_(rhs.pool_tag_) {
+    rhs.data_ = nullptr;
+    rhs.pool_tag_ = 0;
+  }
+
+  SliceStorage& operator=(SliceStorage&& rhs) noexcept {
+    if (this != &rhs) {
+      reset();
+      data_ = rhs.data_;
+      pool_tag_ = rhs.pool_tag_;
+      rhs.data_ = nullptr;
+      rhs.pool_tag_ = 0;
+    }
+    return *this;
+  }
+
+  SliceStorage(const SliceStorage&) = delete;
+  SliceStorage& operator=(const SliceStorage&) = delete;
+
+  ~SliceStorage() { reset(); }
+
+  uint8_t* get() const { return data_; }
+  bool operator==(std::nullptr_t) const { return data_ == nullptr; }
+  bool operator!=(std::nullptr_t) const { return data_ != nullptr; }
+
+  /**
+   * Release the storage back to its pool (or the heap) and leave this handle empty.
+   */
+  void reset();
+
+private:
+  uint8_t* data_{nullptr};
+  // Owning pool pointer with the size class packed into the low bits, or 0 if the storage came
+  // directly from the heap. Packing keeps the handle at two pointers, as SliceDeque keeps several
+  // Slices inline.
+  uintptr_t pool_tag_{0};
+};
+
+} // namespace Buffer
+} // namespace Envoy
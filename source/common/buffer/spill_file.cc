@@ -0,0 +1,158 @@
+#include "common/buffer/spill_file.h"
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include "envoy/api/os_sys_calls.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Buffer {
+
+struct SpillFile::Segment {
+  explicit Segment(uint8_t* base) : base_(base) {}
+  ~Segment() {
+#ifndef WIN32
+    munmap(base_, SegmentSize);
+#endif
+  }
+
+  uint8_t* const base_;
+};
+
+SpillFile::~SpillFile() {
+  // The segments still holding spilled data stay mapped after the file is closed.
+  Api::OsSysCallsSingleton::get().close(fd_);
+}
+
+SpillFilePtr SpillFile::create(const std::string& directory) {
+#ifdef WIN32
+  UNREFERENCED_PARAMETER(directory);
+  errno = ENOTSUP;
+  return nullptr;
+#else
+  int fd;
+#ifdef O_TMPFILE
+  // The file is anonymous from the start, where the file system supports it.
+  fd = ::open(directory.c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+  if (fd != -1) {
+    return SpillFilePtr{new SpillFile(fd)};
+  }
+#endif
+  std::string path = directory + "/envoy_spill_XXXXXX";
+  fd = ::mkstemp(&path[0]);
+  if (fd == -1) {
+    return nullptr;
+  }
+  ::unlink(path.c_str());
+  return SpillFilePtr{new SpillFile(fd)};
+#endif
+}
+
+SpillFile::SegmentSharedPtr SpillFile::grow() {
+#ifdef WIN32
+  return nullptr;
+#else
+  // The blocks of the segment are allocated up front: writing to a mapped page of a sparse file
+  // on a full disk would raise a SIGBUS.
+#ifdef __linux__
+  const int rc = ::posix_fallocate(fd_, size_, SegmentSize);
+  if (rc != 0) {
+    errno = rc;
+    return nullptr;
+  }
+#else
+  if (Api::OsSysCallsSingleton::get().ftruncate(fd_, size_ + SegmentSize).rc_ == -1) {
+    return nullptr;
+  }
+#endif
+  const Api::SysCallPtrResult result = Api::OsSysCallsSingleton::get().mmap(
+      nullptr, SegmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, size_);
+  if (result.rc_ == MAP_FAILED) {
+    errno = result.errno_;
+    return nullptr;
+  }
+  size_ += SegmentSize;
+  return std::make_shared<Segment>(static_cast<uint8_t*>(result.rc_));
+#endif
+}
+
+bool SpillFile::spill(Instance& data) {
+  const uint64_t length = data.length();
+  if (length == 0) {
+    return true;
+  }
+
+  // All the segments the data needs are mapped before any of it is copied, so that it is either
+  // spilled whole or left in memory.
+  std::vector<SegmentSharedPtr> segments;
+  const uint64_t size = size_;
+  for (uint64_t available = SegmentSize - offset_; available < length;
+       available += SegmentSize) {
+    SegmentSharedPtr segment = grow();
+    if (segment == nullptr) {
+      const int error = errno;
+      segments.clear();
+      Api::OsSysCallsSingleton::get().ftruncate(fd_, size);
+      size_ = size;
+      errno = error;
+      return false;
+    }
+    segments.push_back(std::move(segment));
+  }
+
+  struct Range {
+    SegmentSharedPtr segment_;
+    uint64_t offset_;
+    uint64_t length_;
+  };
+  std::vector<Range> ranges;
+  auto next_segment = segments.begin();
+  for (const RawSlice& slice : data.getRawSlices()) {
+    const uint8_t* mem = static_cast<const uint8_t*>(slice.mem_);
+    uint64_t remaining = slice.len_;
+    while (remaining > 0) {
+      if (offset_ == SegmentSize) {
+        ASSERT(next_segment != segments.end());
+        segment_ = std::move(*next_segment++);
+        offset_ = 0;
+      }
+      if (ranges.empty() || ranges.back().segment_ != segment_) {
+        ranges.push_back({segment_, offset_, 0});
+      }
+      const uint64_t copied = std::min(remaining, SegmentSize - offset_);
+      memcpy(segment_->base_ + offset_, mem, copied);
+      ranges.back().length_ += copied;
+      offset_ += copied;
+      mem += copied;
+      remaining -= copied;
+    }
+  }
+
+  data.drain(length);
+  for (Range& range : ranges) {
+    // Each fragment holds a reference on its segment, which is unmapped with its last fragment.
+    data.addBufferFragment(*new BufferFragmentImpl(
+        range.segment_->base_ + range.offset_, range.length_,
+        [segment = std::move(range.segment_)](const void*, size_t,
+                                              const BufferFragmentImpl* fragment) {
+          delete fragment;
+        }));
+  }
+  spilled_bytes_ += length;
+  return true;
+}
+
+} // namespace Buffer
+} // namespace Envoy
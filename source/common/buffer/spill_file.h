@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/buffer/buffer.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Buffer {
+
+class SpillFile;
+using SpillFilePtr = std::unique_ptr<SpillFile>;
+
+/**
+ * A temporary file buffers spill their data to, to keep large bodies out of memory. The file is
+ * unlinked as soon as it is created, and grows in segments mapped in memory: the data spilled is
+ * copied into the mapped pages, which the kernel writes back to the file and evicts from memory as
+ * it needs to. The data is read back from the mapped pages as it is sent, with no read calls.
+ *
+ * Each segment stays mapped until the last fragment of spilled data it holds is released, so the
+ * spilled data can outlive the file, and is freed with its last segment.
+ */
+class SpillFile : NonCopyable {
+public:
+  static constexpr uint64_t SegmentSize = 1024 * 1024;
+
+  ~SpillFile();
+
+  /**
+   * Creates a spill file.
+   * @param directory supplies the directory the file is created in.
+   * @return the file, or nullptr if it cannot be created, the errno being set.
+   */
+  static SpillFilePtr create(const std::string& directory);
+
+  /**
+   * Spills data to the file, replacing it with fragments of the mapped file.
+   * @param data supplies the data to spill.
+   * @return whether the data was spilled. If the file cannot grow, the data is left in memory.
+   */
+  bool spill(Instance& data);
+
+  /**
+   * @return the number of bytes spilled to the file.
+   */
+  uint64_t spilledBytes() const { return spilled_bytes_; }
+
+private:
+  struct Segment;
+  using SegmentSharedPtr = std::shared_ptr<Segment>;
+
+  explicit SpillFile(int fd) : fd_(fd) {}
+
+  // Maps a new segment at the end of the file.
+  SegmentSharedPtr grow();
+
+  const int fd_;
+  uint64_t size_{};
+  SegmentSharedPtr segment_;
+  // The offset in the current segment where the next data is spilled.
+  uint64_t offset_{SegmentSize};
+  uint64_t spilled_bytes_{};
+};
+
+} // namespace Buffer
+} // namespace Envoy
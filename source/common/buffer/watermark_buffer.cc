@@ -1,5 +1,9 @@
 #include "common/buffer/watermark_buffer.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "common/common/assert.h"
 #include "common/runtime/runtime_features.h"
 
@@ -119,5 +123,109 @@ void WatermarkBuffer::checkHighAndOverflowWatermarks() {
   }
 }
 
+BufferMemoryAccountImpl::~BufferMemoryAccountImpl() { clearDownstream(); }
+
+void BufferMemoryAccountImpl::charge(uint64_t amount) {
+  balance_ += amount;
+  updateSizeClass();
+}
+
+void BufferMemoryAccountImpl::credit(uint64_t amount) {
+  ASSERT(balance_ >= amount);
+  balance_ -= amount;
+  updateSizeClass();
+}
+
+void BufferMemoryAccountImpl::resetDownstream() {
+  if (reset_stream_ == nullptr) {
+    return;
+  }
+  // The stream is only reset once, and its account is no longer filed as the stream goes away.
+  std::function<void()> reset_stream = std::move(reset_stream_);
+  clearDownstream();
+  reset_stream();
+}
+
+void BufferMemoryAccountImpl::clearDownstream() {
+  if (factory_ != nullptr) {
+    factory_->updateAccountClass(*this, size_class_, -1);
+    factory_ = nullptr;
+  }
+  reset_stream_ = nullptr;
+  size_class_ = -1;
+}
+
+int BufferMemoryAccountImpl::sizeClass(uint64_t balance) {
+  if (balance < MinimumBalanceToTrack) {
+    return -1;
+  }
+  int size_class = 0;
+  for (uint64_t bound = MinimumBalanceToTrack * 2;
+       balance >= bound && size_class < static_cast<int>(NumSizeClasses) - 1; bound *= 2) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+void BufferMemoryAccountImpl::updateSizeClass() {
+  if (factory_ == nullptr) {
+    return;
+  }
+  const int size_class = sizeClass(balance_);
+  if (size_class != size_class_) {
+    factory_->updateAccountClass(*this, size_class_, size_class);
+    size_class_ = size_class;
+  }
+}
+
+WatermarkBufferFactory::~WatermarkBufferFactory() {
+  for (const auto& size_class : size_classes_) {
+    ASSERT(size_class.empty(), "the streams must be destroyed before their buffer factory");
+  }
+}
+
+BufferMemoryAccountSharedPtr
+WatermarkBufferFactory::createAccount(std::function<void()> reset_stream) {
+  if (!track_accounts_) {
+    return nullptr;
+  }
+  return std::make_shared<BufferMemoryAccountImpl>(*this, std::move(reset_stream));
+}
+
+uint64_t WatermarkBufferFactory::resetAccountsGivenPressure(float pressure) {
+  // The higher the pressure, the more size classes are reset, from the largest balances down.
+  pressure = std::min(std::max(pressure, 0.0f), 1.0f);
+  const uint32_t classes_to_reset =
+      std::min<uint32_t>(std::floor(pressure * BufferMemoryAccountImpl::NumSizeClasses) + 1,
+                         BufferMemoryAccountImpl::NumSizeClasses);
+
+  // Resetting a stream removes its account from its size class, so the accounts to reset are
+  // collected first.
+  std::vector<BufferMemoryAccountImpl*> accounts;
+  for (uint32_t i = 0; i < classes_to_reset && accounts.size() < MaxStreamsResetPerCall; ++i) {
+    for (BufferMemoryAccountImpl* account :
+         size_classes_[BufferMemoryAccountImpl::NumSizeClasses - 1 - i]) {
+      if (accounts.size() == MaxStreamsResetPerCall) {
+        break;
+      }
+      accounts.push_back(account);
+    }
+  }
+  for (BufferMemoryAccountImpl* account : accounts) {
+    account->resetDownstream();
+  }
+  return accounts.size();
+}
+
+void WatermarkBufferFactory::updateAccountClass(BufferMemoryAccountImpl& account, int from_class,
+                                                int to_class) {
+  if (from_class >= 0) {
+    size_classes_[from_class].erase(&account);
+  }
+  if (to_class >= 0) {
+    size_classes_[to_class].insert(&account);
+  }
+}
+
 } // namespace Buffer
 } // namespace Envoy
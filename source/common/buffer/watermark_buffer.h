@@ -1,10 +1,13 @@
 #pragma once
 
+#include <array>
 #include <functional>
 #include <string>
 
 #include "common/buffer/buffer_impl.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Buffer {
 
@@ -70,8 +73,53 @@ private:
 
 using WatermarkBufferPtr = std::unique_ptr<WatermarkBuffer>;
 
+class WatermarkBufferFactory;
+
+// The account of the buffer memory of a downstream stream. Once its balance is large enough to be
+// worth resetting the stream for, its factory files it under the size class of its balance, for
+// the streams holding the most memory to be reset first. The accounts of a factory are only used
+// on the thread of its dispatcher.
+class BufferMemoryAccountImpl : public BufferMemoryAccount {
+public:
+  // The accounts with a lower balance are not filed under a size class.
+  static constexpr uint64_t MinimumBalanceToTrack = 1024 * 1024;
+  // The number of size classes, each class holding the balances twice as large as the previous
+  // one, and the last one all the larger balances.
+  static constexpr uint32_t NumSizeClasses = 8;
+
+  BufferMemoryAccountImpl(WatermarkBufferFactory& factory, std::function<void()> reset_stream)
+      : factory_(&factory), reset_stream_(std::move(reset_stream)) {}
+  ~BufferMemoryAccountImpl() override;
+
+  // Buffer::BufferMemoryAccount
+  uint64_t balance() const override { return balance_; }
+  void charge(uint64_t amount) override;
+  void credit(uint64_t amount) override;
+  void resetDownstream() override;
+  void clearDownstream() override;
+
+  /**
+   * @return the size class of a balance, or -1 if the balance is too low to be filed.
+   */
+  static int sizeClass(uint64_t balance);
+
+private:
+  void updateSizeClass();
+
+  // The factory of the account, until its stream is reset or destroyed.
+  WatermarkBufferFactory* factory_;
+  std::function<void()> reset_stream_;
+  uint64_t balance_{0};
+  int size_class_{-1};
+};
+
 class WatermarkBufferFactory : public WatermarkFactory {
 public:
+  // The maximum number of streams reset per call to resetAccountsGivenPressure().
+  static constexpr uint32_t MaxStreamsResetPerCall = 50;
+
+  ~WatermarkBufferFactory() override;
+
   // Buffer::WatermarkFactory
   InstancePtr create(std::function<void()> below_low_watermark,
                      std::function<void()> above_high_watermark,
@@ -79,6 +127,22 @@ public:
     return std::make_unique<WatermarkBuffer>(below_low_watermark, above_high_watermark,
                                              above_overflow_watermark);
   }
+  void trackAccounts() override { track_accounts_ = true; }
+  BufferMemoryAccountSharedPtr createAccount(std::function<void()> reset_stream) override;
+  uint64_t resetAccountsGivenPressure(float pressure) override;
+
+  /**
+   * Moves an account from a size class to another.
+   * @param account supplies the account.
+   * @param from_class supplies the size class the account is filed under, or -1 if none.
+   * @param to_class supplies the size class to file the account under, or -1 if none.
+   */
+  void updateAccountClass(BufferMemoryAccountImpl& account, int from_class, int to_class);
+
+private:
+  bool track_accounts_{false};
+  std::array<absl::flat_hash_set<BufferMemoryAccountImpl*>, BufferMemoryAccountImpl::NumSizeClasses>
+      size_classes_;
 };
 
 } // namespace Buffer
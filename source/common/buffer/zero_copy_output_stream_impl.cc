@@ -0,0 +1,46 @@
+#include "common/buffer/zero_copy_output_stream_impl.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Buffer {
+
+ZeroCopyOutputStreamImpl::~ZeroCopyOutputStreamImpl() { commit(); }
+
+bool ZeroCopyOutputStreamImpl::Next(void** data, int* size) {
+  commit();
+
+  // Reserve the rest of the expected bytes, and full reservations once they are written.
+  const uint64_t remaining = size_hint_ > byte_count_ ? size_hint_ - byte_count_ : 0;
+  const uint64_t length = remaining > 0 ? std::min(remaining, MaxReservationSize)
+                                        : MaxReservationSize;
+  const uint64_t num_slices = buffer_.reserve(length, &reservation_, 1);
+  ASSERT(num_slices == 1 && reservation_.len_ == length);
+  reserved_ = true;
+
+  *data = reservation_.mem_;
+  *size = static_cast<int>(reservation_.len_);
+  byte_count_ += reservation_.len_;
+  return true;
+}
+
+void ZeroCopyOutputStreamImpl::BackUp(int count) {
+  ASSERT(count >= 0);
+  ASSERT(reserved_ && static_cast<uint64_t>(count) <= reservation_.len_);
+
+  // The bytes backed up are not committed with the rest of the reservation.
+  reservation_.len_ -= count;
+  byte_count_ -= count;
+}
+
+void ZeroCopyOutputStreamImpl::commit() {
+  if (reserved_) {
+    buffer_.commit(&reservation_, 1);
+    reserved_ = false;
+  }
+}
+
+} // namespace Buffer
+} // namespace Envoy
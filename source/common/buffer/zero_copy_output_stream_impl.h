@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/buffer/buffer.h"
+
+#include "common/protobuf/protobuf.h"
+
+namespace Envoy {
+
+namespace Buffer {
+
+/**
+ * An output stream writing into reservations of a buffer, so that protobuf messages are serialized
+ * in place into the slices of the buffer, without a contiguous allocation of their whole size. The
+ * bytes written are committed to the buffer when the stream is destroyed.
+ */
+class ZeroCopyOutputStreamImpl : public Protobuf::io::ZeroCopyOutputStream {
+public:
+  // The largest reservation, so that a large message is spread over several slices.
+  static constexpr uint64_t MaxReservationSize = 16384;
+
+  /**
+   * @param buffer supplies the buffer to write into.
+   * @param size_hint supplies the number of bytes expected to be written, which sizes the
+   *        reservations so that a small message takes a single small slice.
+   */
+  ZeroCopyOutputStreamImpl(Buffer::Instance& buffer, uint64_t size_hint)
+      : buffer_(buffer), size_hint_(size_hint) {}
+  ~ZeroCopyOutputStreamImpl() override;
+
+  // Protobuf::io::ZeroCopyOutputStream
+  // See
+  // https://developers.google.com/protocol-buffers/docs/reference/cpp/google.protobuf.io.zero_copy_stream#ZeroCopyOutputStream
+  // for each method details.
+  bool Next(void** data, int* size) override;
+  void BackUp(int count) override;
+  ProtobufTypes::Int64 ByteCount() const override { return byte_count_; }
+
+private:
+  void commit();
+
+  Buffer::Instance& buffer_;
+  const uint64_t size_hint_;
+  RawSlice reservation_{};
+  bool reserved_{false};
+  uint64_t byte_count_{0};
+};
+
+} // namespace Buffer
+} // namespace Envoy
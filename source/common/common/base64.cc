@@ -1,10 +1,20 @@
 #include "common/common/base64.h"
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define ENVOY_BASE64_AVX2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define ENVOY_BASE64_NEON 1
+#endif
+
+#include <algorithm>
 #include <cstdint>
 #include <string>
 
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
+#include "common/common/macros.h"
 
 #include "absl/container/fixed_array.h"
 
@@ -140,6 +150,219 @@ inline void encodeLast(uint64_t pos, uint8_t last_char, std::string& ret,
   }
 }
 
+#ifdef ENVOY_BASE64_AVX2
+bool cpuHasAvx2() {
+  static const bool has_avx2 = []() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+  }();
+  return has_avx2;
+}
+
+// Encodes 24 bytes into 32 characters per iteration, with the method of
+// http://0x80.pl/notesen/2016-01-12-sse-base64-encoding.html. Each 128 bit lane is loaded with 16
+// bytes of which it encodes 12, so that the input must have 4 bytes more than those encoded.
+__attribute__((target("avx2"))) uint64_t encodeBlocksAvx2(const uint8_t* input, uint64_t length,
+                                                          std::string& ret,
+                                                          const char* const char_table) {
+  const uint64_t blocks = length >= 28 ? (length - 4) / 24 : 0;
+  if (blocks == 0) {
+    return 0;
+  }
+  ret.resize(ret.size() + blocks * 32);
+  char* out = &ret[ret.size() - blocks * 32];
+
+  const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+  // The offsets from the 6 bit values to their characters, indexed by the range of the values.
+  const __m256i offsets = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, char_table[62] - 62, char_table[63] - 63, 'A', 0, 0));
+  for (uint64_t block = 0; block < blocks; ++block, input += 24, out += 32) {
+    __m256i in = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 12)), 1);
+    // Split each 3 bytes into 4 bytes holding 6 bits each.
+    in = _mm256_shuffle_epi8(in, shuffle);
+    const __m256i values = _mm256_or_si256(
+        _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)),
+                           _mm256_set1_epi32(0x04000040)),
+        _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)),
+                           _mm256_set1_epi32(0x01000010)));
+    // 0-25 map to 13, 26-51 to 0, 52-61 to 1-10, 62 to 11 and 63 to 12.
+    __m256i range = _mm256_subs_epu8(values, _mm256_set1_epi8(51));
+    range = _mm256_or_si256(range, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), values),
+                                                    _mm256_set1_epi8(13)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out),
+                        _mm256_add_epi8(values, _mm256_shuffle_epi8(offsets, range)));
+  }
+  return blocks * 24;
+}
+
+// Returns the mask of the characters from first to last.
+__attribute__((target("avx2"))) inline __m256i inRangeAvx2(__m256i in, char first, char last) {
+  return _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8(first - 1)),
+                          _mm256_cmpgt_epi8(_mm256_set1_epi8(last + 1), in));
+}
+
+// Decodes 32 characters into 24 bytes per iteration. Returns false if a character is invalid.
+__attribute__((target("avx2"))) bool decodeBlocksAvx2(const char* input, uint64_t length,
+                                                      uint64_t& decoded, std::string& ret,
+                                                      const char* const char_table) {
+  const uint64_t blocks = length / 32;
+  decoded = blocks * 32;
+  if (blocks == 0) {
+    return true;
+  }
+  ret.resize(ret.size() + blocks * 24);
+  char* out = &ret[ret.size() - blocks * 24];
+
+  const __m256i pack = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+  for (uint64_t block = 0; block < blocks; ++block, input += 32, out += 24) {
+    const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input));
+    // The bytes above 0x7f compare as negative, and are in none of the ranges.
+    const __m256i upper = inRangeAvx2(in, 'A', 'Z');
+    const __m256i lower = inRangeAvx2(in, 'a', 'z');
+    const __m256i digit = inRangeAvx2(in, '0', '9');
+    const __m256i char62 = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(char_table[62]));
+    const __m256i char63 = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(char_table[63]));
+    const __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower),
+                                          _mm256_or_si256(digit, _mm256_or_si256(char62, char63)));
+    if (_mm256_movemask_epi8(valid) != -1) {
+      return false;
+    }
+    __m256i offset = _mm256_and_si256(upper, _mm256_set1_epi8(-'A'));
+    offset = _mm256_or_si256(offset, _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+    offset = _mm256_or_si256(offset, _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+    offset = _mm256_or_si256(offset,
+                             _mm256_and_si256(char62, _mm256_set1_epi8(62 - char_table[62])));
+    offset = _mm256_or_si256(offset,
+                             _mm256_and_si256(char63, _mm256_set1_epi8(63 - char_table[63])));
+    const __m256i values = _mm256_add_epi8(in, offset);
+    // Merge each 4 values of 6 bits into 3 bytes, at the bottom of 32 bits in reverse order.
+    __m256i bytes = _mm256_madd_epi16(_mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140)),
+                                      _mm256_set1_epi32(0x00011000));
+    bytes = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(bytes, pack),
+                                        _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(bytes));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 16), _mm256_extracti128_si256(bytes, 1));
+  }
+  return true;
+}
+#endif
+
+#ifdef ENVOY_BASE64_NEON
+uint8x16x4_t loadTable(const unsigned char* table) {
+  return {vld1q_u8(table), vld1q_u8(table + 16), vld1q_u8(table + 32), vld1q_u8(table + 48)};
+}
+
+// Encodes 48 bytes into 64 characters per iteration, the loads and stores interleaving the bytes.
+uint64_t encodeBlocksNeon(const uint8_t* input, uint64_t length, std::string& ret,
+                          const char* const char_table) {
+  const uint64_t blocks = length / 48;
+  if (blocks == 0) {
+    return 0;
+  }
+  ret.resize(ret.size() + blocks * 64);
+  uint8_t* out = reinterpret_cast<uint8_t*>(&ret[ret.size() - blocks * 64]);
+
+  const uint8x16x4_t table = loadTable(reinterpret_cast<const unsigned char*>(char_table));
+  for (uint64_t block = 0; block < blocks; ++block, input += 48, out += 64) {
+    const uint8x16x3_t in = vld3q_u8(input);
+    uint8x16x4_t chars;
+    chars.val[0] = vqtbl4q_u8(table, vshrq_n_u8(in.val[0], 2));
+    chars.val[1] = vqtbl4q_u8(table, vorrq_u8(vshlq_n_u8(vandq_u8(in.val[0], vdupq_n_u8(0x03)), 4),
+                                              vshrq_n_u8(in.val[1], 4)));
+    chars.val[2] = vqtbl4q_u8(table, vorrq_u8(vshlq_n_u8(vandq_u8(in.val[1], vdupq_n_u8(0x0f)), 2),
+                                              vshrq_n_u8(in.val[2], 6)));
+    chars.val[3] = vqtbl4q_u8(table, vandq_u8(in.val[2], vdupq_n_u8(0x3f)));
+    vst4q_u8(out, chars);
+  }
+  return blocks * 48;
+}
+
+// Decodes 64 characters into 48 bytes per iteration. Returns false if a character is invalid.
+bool decodeBlocksNeon(const char* input, uint64_t length, uint64_t& decoded, std::string& ret,
+                      const unsigned char* const reverse_lookup_table) {
+  const uint64_t blocks = length / 64;
+  decoded = blocks * 64;
+  if (blocks == 0) {
+    return true;
+  }
+  ret.resize(ret.size() + blocks * 48);
+  uint8_t* out = reinterpret_cast<uint8_t*>(&ret[ret.size() - blocks * 48]);
+
+  // The lookups of the indices out of a table return 0, so that each character is looked up in
+  // both halves of the ASCII table, and the characters above 0x7f are invalid.
+  const uint8x16x4_t low_table = loadTable(reverse_lookup_table);
+  const uint8x16x4_t high_table = loadTable(reverse_lookup_table + 64);
+  const auto lookup = [&](uint8x16_t in) {
+    return vorrq_u8(vorrq_u8(vqtbl4q_u8(low_table, in),
+                             vqtbl4q_u8(high_table, vsubq_u8(in, vdupq_n_u8(64)))),
+                    vcgeq_u8(in, vdupq_n_u8(0x80)));
+  };
+  for (uint64_t block = 0; block < blocks; ++block, input += 64, out += 48) {
+    const uint8x16x4_t in = vld4q_u8(reinterpret_cast<const uint8_t*>(input));
+    const uint8x16_t a = lookup(in.val[0]);
+    const uint8x16_t b = lookup(in.val[1]);
+    const uint8x16_t c = lookup(in.val[2]);
+    const uint8x16_t d = lookup(in.val[3]);
+    // The invalid characters look up 64 or above.
+    if (vmaxvq_u8(vorrq_u8(vorrq_u8(a, b), vorrq_u8(c, d))) >= 64) {
+      return false;
+    }
+    uint8x16x3_t bytes;
+    bytes.val[0] = vorrq_u8(vshlq_n_u8(a, 2), vshrq_n_u8(b, 4));
+    bytes.val[1] = vorrq_u8(vshlq_n_u8(b, 4), vshrq_n_u8(c, 2));
+    bytes.val[2] = vorrq_u8(vshlq_n_u8(c, 6), d);
+    vst3q_u8(out, bytes);
+  }
+  return true;
+}
+#endif
+
+// Encodes the longest prefix of the input which the vector instructions encode at once, appending
+// its characters to ret. Returns the length of the prefix, a multiple of 3.
+uint64_t encodeBlocks(const uint8_t* input, uint64_t length, std::string& ret,
+                      const char* const char_table) {
+#if defined(ENVOY_BASE64_AVX2)
+  return cpuHasAvx2() ? encodeBlocksAvx2(input, length, ret, char_table) : 0;
+#elif defined(ENVOY_BASE64_NEON)
+  return encodeBlocksNeon(input, length, ret, char_table);
+#else
+  UNREFERENCED_PARAMETER(input);
+  UNREFERENCED_PARAMETER(length);
+  UNREFERENCED_PARAMETER(ret);
+  UNREFERENCED_PARAMETER(char_table);
+  return 0;
+#endif
+}
+
+// Decodes the longest prefix of the input which the vector instructions decode at once, appending
+// its bytes to ret and setting decoded to its length, a multiple of 4. Returns false if a
+// character of the prefix is invalid.
+bool decodeBlocks(const char* input, uint64_t length, uint64_t& decoded, std::string& ret,
+                  const char* const char_table, const unsigned char* const reverse_lookup_table) {
+#if defined(ENVOY_BASE64_AVX2)
+  UNREFERENCED_PARAMETER(reverse_lookup_table);
+  if (cpuHasAvx2()) {
+    return decodeBlocksAvx2(input, length, decoded, ret, char_table);
+  }
+#elif defined(ENVOY_BASE64_NEON)
+  UNREFERENCED_PARAMETER(char_table);
+  return decodeBlocksNeon(input, length, decoded, ret, reverse_lookup_table);
+#else
+  UNREFERENCED_PARAMETER(input);
+  UNREFERENCED_PARAMETER(length);
+  UNREFERENCED_PARAMETER(ret);
+  UNREFERENCED_PARAMETER(char_table);
+  UNREFERENCED_PARAMETER(reverse_lookup_table);
+#endif
+  decoded = 0;
+  return true;
+}
+
 } // namespace
 
 std::string Base64::decode(const std::string& input) {
@@ -175,7 +398,11 @@ std::string Base64::decodeWithoutPadding(absl::string_view input) {
 
   std::string ret;
   ret.reserve(max_length);
-  for (uint64_t i = 0; i < last; ++i) {
+  uint64_t decoded;
+  if (!decodeBlocks(input.data(), last, decoded, ret, CHAR_TABLE, REVERSE_LOOKUP_TABLE)) {
+    return EMPTY_STRING;
+  }
+  for (uint64_t i = decoded; i < last; ++i) {
     if (!decodeBase(input[i], i, ret, REVERSE_LOOKUP_TABLE)) {
       return EMPTY_STRING;
     }
@@ -199,7 +426,19 @@ std::string Base64::encode(const Buffer::Instance& buffer, uint64_t length) {
   for (const Buffer::RawSlice& slice : buffer.getRawSlices()) {
     const uint8_t* slice_mem = static_cast<const uint8_t*>(slice.mem_);
 
-    for (uint64_t i = 0; i < slice.len_ && j < length; ++i, ++j) {
+    uint64_t i = 0;
+    // The bytes of a group of 3 may span slices, so that the vector encoding starts at the first
+    // group starting in the slice.
+    for (; i < slice.len_ && j < length && j % 3 != 0; ++i, ++j) {
+      encodeBase(slice_mem[i], j, next_c, ret, CHAR_TABLE);
+    }
+    if (j % 3 == 0) {
+      const uint64_t encoded =
+          encodeBlocks(slice_mem + i, std::min(slice.len_ - i, length - j), ret, CHAR_TABLE);
+      i += encoded;
+      j += encoded;
+    }
+    for (; i < slice.len_ && j < length; ++i, ++j) {
       encodeBase(slice_mem[i], j, next_c, ret, CHAR_TABLE);
     }
 
@@ -222,10 +461,10 @@ std::string Base64::encode(const char* input, uint64_t length, bool add_padding)
   std::string ret;
   ret.reserve(output_length);
 
-  uint64_t pos = 0;
+  uint64_t pos = encodeBlocks(reinterpret_cast<const uint8_t*>(input), length, ret, CHAR_TABLE);
   uint8_t next_c = 0;
 
-  for (uint64_t i = 0; i < length; ++i) {
+  for (uint64_t i = pos; i < length; ++i) {
     encodeBase(input[i], pos++, next_c, ret, CHAR_TABLE);
   }
 
@@ -243,7 +482,11 @@ std::string Base64Url::decode(const std::string& input) {
   ret.reserve(input.length() / 4 * 3 + 3);
 
   uint64_t last = input.length() - 1;
-  for (uint64_t i = 0; i < last; ++i) {
+  uint64_t decoded;
+  if (!decodeBlocks(input.data(), last, decoded, ret, URL_CHAR_TABLE, URL_REVERSE_LOOKUP_TABLE)) {
+    return EMPTY_STRING;
+  }
+  for (uint64_t i = decoded; i < last; ++i) {
     if (!decodeBase(input[i], i, ret, URL_REVERSE_LOOKUP_TABLE)) {
       return EMPTY_STRING;
     }
@@ -261,10 +504,11 @@ std::string Base64Url::encode(const char* input, uint64_t length) {
   std::string ret;
   ret.reserve(output_length);
 
-  uint64_t pos = 0;
+  uint64_t pos =
+      encodeBlocks(reinterpret_cast<const uint8_t*>(input), length, ret, URL_CHAR_TABLE);
   uint8_t next_c = 0;
 
-  for (uint64_t i = 0; i < length; ++i) {
+  for (uint64_t i = pos; i < length; ++i) {
     encodeBase(input[i], pos++, next_c, ret, URL_CHAR_TABLE);
   }
 
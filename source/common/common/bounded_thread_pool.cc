@@ -0,0 +1,65 @@
+#include "common/common/bounded_thread_pool.h"
+
+#include "common/common/fmt.h"
+#include "common/common/lock_guard.h"
+
+namespace Envoy {
+
+BoundedThreadPool::BoundedThreadPool(Thread::ThreadFactory& thread_factory,
+                                     const std::string& name, uint32_t thread_count,
+                                     uint32_t max_queue_size)
+    : max_queue_size_(max_queue_size) {
+  threads_.reserve(thread_count);
+  for (uint32_t i = 0; i < thread_count; ++i) {
+    threads_.push_back(thread_factory.createThread(
+        [this]() { run(); }, Thread::Options{fmt::format("{}:{}", name, i)}));
+  }
+}
+
+BoundedThreadPool::~BoundedThreadPool() {
+  {
+    Thread::LockGuard guard(mutex_);
+    shutdown_ = true;
+  }
+  queue_not_empty_.notifyAll();
+  for (Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+}
+
+bool BoundedThreadPool::post(std::function<void()> task) {
+  {
+    Thread::LockGuard guard(mutex_);
+    if (queue_.size() >= max_queue_size_) {
+      return false;
+    }
+    queue_.push_back(std::move(task));
+  }
+  queue_not_empty_.notifyOne();
+  return true;
+}
+
+double BoundedThreadPool::pressure() {
+  Thread::LockGuard guard(mutex_);
+  return static_cast<double>(queue_.size()) / max_queue_size_;
+}
+
+void BoundedThreadPool::run() {
+  while (true) {
+    std::function<void()> task;
+    {
+      Thread::LockGuard guard(mutex_);
+      while (queue_.empty() && !shutdown_) {
+        queue_not_empty_.wait(mutex_);
+      }
+      if (shutdown_) {
+        return;
+      }
+      task = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    task();
+  }
+}
+
+} // namespace Envoy
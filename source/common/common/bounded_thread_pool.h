@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "envoy/thread/thread.h"
+
+#include "common/common/non_copyable.h"
+#include "common/common/thread.h"
+
+namespace Envoy {
+
+/**
+ * A fixed number of threads that run the tasks posted to them, with a bounded queue of the tasks
+ * waiting for a thread. A task that does not fit in the queue is rejected rather than queued, so
+ * that the caller can fall back to running it itself.
+ */
+class BoundedThreadPool : NonCopyable {
+public:
+  /**
+   * @param thread_factory supplies the factory of the threads.
+   * @param name supplies the prefix of the names of the threads, which are suffixed with their
+   *        index.
+   * @param thread_count supplies the number of threads.
+   * @param max_queue_size supplies the number of tasks that may wait for a thread.
+   */
+  BoundedThreadPool(Thread::ThreadFactory& thread_factory, const std::string& name,
+                    uint32_t thread_count, uint32_t max_queue_size);
+  // Joins the threads, dropping the tasks that have not started.
+  ~BoundedThreadPool();
+
+  /**
+   * Queues a task for a thread of the pool.
+   * @return bool whether the task was queued, false if the queue is full.
+   */
+  bool post(std::function<void()> task);
+
+  /**
+   * @return double the number of queued tasks divided by the size of the queue.
+   */
+  double pressure();
+
+private:
+  void run();
+
+  const uint32_t max_queue_size_;
+  Thread::MutexBasicLockable mutex_;
+  Thread::CondVar queue_not_empty_;
+  std::deque<std::function<void()>> queue_ ABSL_GUARDED_BY(mutex_);
+  bool shutdown_ ABSL_GUARDED_BY(mutex_){};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+} // namespace Envoy
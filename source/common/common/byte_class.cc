@@ -0,0 +1,85 @@
+#include "common/common/byte_class.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define ENVOY_BYTE_CLASS_SSE42_SCAN 1
+#endif
+
+#include <cstring>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+
+namespace {
+
+#ifdef ENVOY_BYTE_CLASS_SSE42_SCAN
+bool cpuHasSse42() {
+  static const bool has_sse42 = []() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2") != 0;
+  }();
+  return has_sse42;
+}
+#endif
+
+} // namespace
+
+ByteClass::ByteClass(absl::string_view ranges, absl::string_view exceptions) {
+  ASSERT(ranges.size() % 2 == 0 && ranges.size() <= ranges_.size());
+  std::memcpy(ranges_.data(), ranges.data(), ranges.size());
+  ranges_size_ = ranges.size();
+  for (size_t i = 0; i < ranges.size(); i += 2) {
+    for (uint32_t c = static_cast<uint8_t>(ranges[i]); c <= static_cast<uint8_t>(ranges[i + 1]);
+         ++c) {
+      stops_[c] = true;
+    }
+  }
+  for (const char c : exceptions) {
+    stops_[static_cast<uint8_t>(c)] = false;
+  }
+}
+
+const char* ByteClass::find(const char* p, const char* end) const {
+#ifdef ENVOY_BYTE_CLASS_SSE42_SCAN
+  if (cpuHasSse42()) {
+    return findSse42(p, end);
+  }
+#endif
+  return findScalar(p, end);
+}
+
+const char* ByteClass::findScalar(const char* p, const char* end) const {
+  while (p < end && !stops(*p)) {
+    ++p;
+  }
+  return p;
+}
+
+#ifdef ENVOY_BYTE_CLASS_SSE42_SCAN
+__attribute__((target("sse4.2"))) const char* ByteClass::findSse42(const char* p,
+                                                                   const char* end) const {
+  const __m128i ranges = _mm_load_si128(reinterpret_cast<const __m128i*>(ranges_.data()));
+  while (end - p >= 16) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const int index = _mm_cmpestri(ranges, ranges_size_, block, 16,
+                                   _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+    if (index == 16) {
+      p += 16;
+      continue;
+    }
+    p += index;
+    if (stops(*p)) {
+      return p;
+    }
+    ++p;
+  }
+  return findScalar(p, end);
+}
+#else
+const char* ByteClass::findSse42(const char* p, const char* end) const {
+  return findScalar(p, end);
+}
+#endif
+
+} // namespace Envoy
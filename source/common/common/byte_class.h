@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+
+/**
+ * A set of bytes that end a scan, described both as up to eight inclusive byte ranges for
+ * PCMPESTRI and as a lookup table for the scalar scan. Bytes listed as exceptions lie within the
+ * ranges but do not end a scan, which lets a class that needs more than eight ranges use a
+ * superset for the vector scan and confirm each candidate with the table.
+ */
+class ByteClass {
+public:
+  ByteClass(absl::string_view ranges, absl::string_view exceptions);
+
+  /**
+   * @return whether c is in the class.
+   */
+  bool stops(char c) const { return stops_[static_cast<uint8_t>(c)]; }
+
+  /**
+   * Scans for the first byte in the class, 16 bytes at a time when the CPU supports SSE4.2.
+   * @param p supplies the first byte to scan.
+   * @param end supplies the end of the bytes to scan.
+   * @return the first byte in [p, end) that is in the class, or end.
+   */
+  const char* find(const char* p, const char* end) const;
+
+private:
+  const char* findScalar(const char* p, const char* end) const;
+  const char* findSse42(const char* p, const char* end) const;
+
+  alignas(16) std::array<char, 16> ranges_{};
+  int ranges_size_;
+  std::array<bool, 256> stops_{};
+};
+
+} // namespace Envoy
@@ -17,8 +17,8 @@ namespace LinkedList {
  * @param item supplies the item to move in.
  * @param list supplies the list to move the item into.
  */
-template <typename T, typename U>
-void moveIntoList(std::unique_ptr<T>&& item, std::list<std::unique_ptr<U>>& list) {
+template <typename T, typename U, typename A>
+void moveIntoList(std::unique_ptr<T>&& item, std::list<std::unique_ptr<U>, A>& list) {
   ASSERT(!item->inserted_);
   item->inserted_ = true;
   auto position = list.emplace(list.begin(), std::move(item));
@@ -30,8 +30,8 @@ void moveIntoList(std::unique_ptr<T>&& item, std::list<std::unique_ptr<U>>& list
  * @param item supplies the item to move in.
  * @param list supplies the list to move the item into.
  */
-template <typename T, typename U>
-void moveIntoListBack(std::unique_ptr<T>&& item, std::list<std::unique_ptr<U>>& list) {
+template <typename T, typename U, typename A>
+void moveIntoListBack(std::unique_ptr<T>&& item, std::list<std::unique_ptr<U>, A>& list) {
   ASSERT(!item->inserted_);
   item->inserted_ = true;
   auto position = list.emplace(list.end(), std::move(item));
@@ -42,11 +42,11 @@ void moveIntoListBack(std::unique_ptr<T>&& item, std::list<std::unique_ptr<U>>&
 
 /**
  * Mixin class that allows an object contained in a unique pointer to be easily linked and unlinked
- * from lists.
+ * from lists. The allocator is the allocator of the lists that the object is placed in.
  */
-template <class T> class LinkedObject {
+template <class T, class Allocator = std::allocator<std::unique_ptr<T>>> class LinkedObject {
 public:
-  using ListType = std::list<std::unique_ptr<T>>;
+  using ListType = std::list<std::unique_ptr<T>, Allocator>;
 
   /**
    * @return the list iterator for the object.
@@ -91,10 +91,11 @@ protected:
   LinkedObject() = default;
 
 private:
-  template <typename U, typename V>
-  friend void LinkedList::moveIntoList(std::unique_ptr<U>&&, std::list<std::unique_ptr<V>>&);
-  template <typename U, typename V>
-  friend void LinkedList::moveIntoListBack(std::unique_ptr<U>&&, std::list<std::unique_ptr<V>>&);
+  template <typename U, typename V, typename A>
+  friend void LinkedList::moveIntoList(std::unique_ptr<U>&&, std::list<std::unique_ptr<V>, A>&);
+  template <typename U, typename V, typename A>
+  friend void LinkedList::moveIntoListBack(std::unique_ptr<U>&&,
+                                           std::list<std::unique_ptr<V>, A>&);
 
   typename ListType::iterator entry_;
   bool inserted_{false}; // iterators do not have any "invalid" value so we need this boolean for
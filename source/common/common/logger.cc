@@ -59,23 +59,61 @@ void StderrSinkDelegate::flush() {
   std::cerr << std::flush;
 }
 
+namespace {
+
+// Each thread formats its log lines with a clone of the formatter of its own, as formatting under
+// the format mutex serializes the threads which log. The clone is freed when the thread exits,
+// after which the thread formats under the format mutex. These are trivially destructible, so
+// that they may be read while the thread exits.
+thread_local spdlog::formatter* thread_formatter = nullptr;
+thread_local uint64_t thread_formatter_generation = 0;
+thread_local bool thread_formatter_retired = false;
+
+struct ThreadFormatterHolder {
+  ~ThreadFormatterHolder() {
+    delete thread_formatter;
+    thread_formatter = nullptr;
+    thread_formatter_retired = true;
+  }
+};
+
+// The generations of the formatters of all the sinks, so that a thread which logs to several
+// sinks clones the formatter of each sink as needed.
+std::atomic<uint64_t> next_formatter_generation{1};
+
+} // namespace
+
 void DelegatingLogSink::set_formatter(std::unique_ptr<spdlog::formatter> formatter) {
   absl::MutexLock lock(&format_mutex_);
   formatter_ = std::move(formatter);
+  formatter_generation_.store(next_formatter_generation++, std::memory_order_release);
 }
 
 void DelegatingLogSink::log(const spdlog::details::log_msg& msg) {
-  absl::ReleasableMutexLock lock(&format_mutex_);
   absl::string_view msg_view = absl::string_view(msg.payload.data(), msg.payload.size());
 
   // This memory buffer must exist in the scope of the entire function,
   // otherwise the string_view will refer to memory that is already free.
   spdlog::memory_buf_t formatted;
-  if (formatter_) {
-    formatter_->format(msg, formatted);
-    msg_view = absl::string_view(formatted.data(), formatted.size());
+  if (!thread_formatter_retired) {
+    if (thread_formatter_generation != formatter_generation_.load(std::memory_order_acquire)) {
+      static thread_local ThreadFormatterHolder holder;
+      absl::MutexLock lock(&format_mutex_);
+      delete thread_formatter;
+      thread_formatter = formatter_ ? formatter_->clone().release() : nullptr;
+      thread_formatter_generation = formatter_generation_.load(std::memory_order_relaxed);
+    }
+    if (thread_formatter != nullptr) {
+      thread_formatter->format(msg, formatted);
+      msg_view = absl::string_view(formatted.data(), formatted.size());
+    }
+  } else {
+    absl::MutexLock lock(&format_mutex_);
+    if (formatter_) {
+      formatter_->format(msg, formatted);
+      msg_view = absl::string_view(formatted.data(), formatted.size());
+    }
   }
-  lock.Release();
 
   // Hold the sink mutex while performing the actual logging. This prevents the sink from being
   // swapped during an individual log event.
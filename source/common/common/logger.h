@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <bitset>
 #include <chrono>
 #include <cstdint>
@@ -213,6 +214,8 @@ private:
   absl::Mutex sink_mutex_;
   std::unique_ptr<StderrSinkDelegate> stderr_sink_; // Builtin sink to use as a last resort.
   std::unique_ptr<spdlog::formatter> formatter_ ABSL_GUARDED_BY(format_mutex_);
+  // Changes with the formatter, so that the threads know to clone it again.
+  std::atomic<uint64_t> formatter_generation_{};
   absl::Mutex format_mutex_;
   bool should_escape_{false};
 };
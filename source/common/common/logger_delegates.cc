@@ -1,10 +1,15 @@
 #include "common/common/logger_delegates.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert> // use direct system-assert to avoid cyclic dependency.
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <string>
 
+#include "common/common/fmt.h"
+
 #include "spdlog/spdlog.h"
 
 namespace Envoy {
@@ -31,5 +36,227 @@ void FileSinkDelegate::flush() {
   log_file_->flush();
 }
 
+// A ring buffer of log lines, written by one thread and read by the drain thread. Each line is
+// stored as its size followed by its bytes, which wrap around at the end of the buffer. The
+// positions only grow, and the writer publishes the lines with a release store of the tail which
+// the reader acquires, and the reader frees the space with a release store of the head.
+struct AsyncLogRing {
+  explicit AsyncLogRing(uint32_t size) : buffer_(new char[size]), size_(size) {}
+
+  // Queues a line, or counts it as dropped when it does not fit.
+  // @return whether the ring got over half full, so that the drain thread should be woken up.
+  bool write(absl::string_view line) {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    const uint64_t used = tail - head_.load(std::memory_order_acquire);
+    const uint64_t needed = sizeof(uint32_t) + line.size();
+    if (needed > size_ - used) {
+      // Only this thread writes the count, so that it needs no read-modify-write.
+      dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return false;
+    }
+    const uint32_t line_size = line.size();
+    copyIn(tail, &line_size, sizeof(line_size));
+    copyIn(tail + sizeof(line_size), line.data(), line.size());
+    tail_.store(tail + needed, std::memory_order_release);
+    return used <= size_ / 2 && used + needed > size_ / 2;
+  }
+
+  // Calls the callback with each queued line, and frees their space.
+  template <class Callback> void read(Callback callback) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    const uint64_t tail = tail_.load(std::memory_order_acquire);
+    while (head < tail) {
+      uint32_t line_size;
+      copyOut(head, &line_size, sizeof(line_size));
+      line_.resize(line_size);
+      copyOut(head + sizeof(line_size), &line_[0], line_size);
+      head += sizeof(line_size) + line_size;
+      callback(line_);
+    }
+    head_.store(head, std::memory_order_release);
+  }
+
+  void copyIn(uint64_t position, const void* data, size_t size) {
+    const size_t offset = position % size_;
+    const size_t first = std::min<size_t>(size, size_ - offset);
+    memcpy(buffer_.get() + offset, data, first);
+    memcpy(buffer_.get(), static_cast<const char*>(data) + first, size - first);
+  }
+
+  void copyOut(uint64_t position, void* data, size_t size) const {
+    const size_t offset = position % size_;
+    const size_t first = std::min<size_t>(size, size_ - offset);
+    memcpy(data, buffer_.get() + offset, first);
+    memcpy(static_cast<char*>(data) + first, buffer_.get(), size - first);
+  }
+
+  const std::unique_ptr<char[]> buffer_;
+  const uint32_t size_;
+  // Written by the thread of the ring.
+  std::atomic<uint64_t> tail_{};
+  std::atomic<uint64_t> dropped_{};
+  std::atomic<bool> abandoned_{};
+  // Written by the drain thread.
+  std::atomic<uint64_t> head_{};
+  uint64_t reported_dropped_{};
+  std::string line_;
+};
+
+namespace {
+
+std::atomic<uint64_t> next_async_sink_id{1};
+
+// The ring of the calling thread, for the AsyncSinkDelegate of the id. The ring is abandoned when
+// the thread exits, or logs to another AsyncSinkDelegate, and freed once it was drained.
+struct ThreadAsyncLogRing {
+  ~ThreadAsyncLogRing() { abandon(); }
+
+  void abandon() {
+    if (ring_ != nullptr) {
+      ring_->abandoned_.store(true, std::memory_order_release);
+      ring_.reset();
+    }
+  }
+
+  uint64_t sink_id_{};
+  AsyncLogRingSharedPtr ring_;
+};
+
+thread_local ThreadAsyncLogRing thread_async_log_ring;
+
+} // namespace
+
+AsyncSinkDelegate::AsyncSinkDelegate(Thread::ThreadFactory& thread_factory, uint32_t buffer_size,
+                                     DelegatingLogSinkSharedPtr log_sink)
+    : SinkDelegate(log_sink), id_(next_async_sink_id++), buffer_size_(buffer_size) {
+  // The thread is started before any line may be queued, so that a failure to start it does not
+  // leave the lines, and a flush, waiting for it.
+  drain_thread_ = thread_factory.createThread([this]() { drainLoop(); },
+                                              Thread::Options{"async-log"});
+  setDelegate();
+  absl::MutexLock lock(&mutex_);
+  sink_ = previousDelegate();
+}
+
+AsyncSinkDelegate::~AsyncSinkDelegate() {
+  // Restoring the previous delegate waits for the lines being logged, so that no line is queued
+  // once the rings are drained for the last time.
+  restoreDelegate();
+  {
+    absl::MutexLock lock(&mutex_);
+    stopping_ = true;
+    wakeup_ = true;
+  }
+  drain_thread_->join();
+}
+
+AsyncLogRing& AsyncSinkDelegate::localRing() {
+  ThreadAsyncLogRing& local = thread_async_log_ring;
+  if (local.sink_id_ != id_) {
+    local.abandon();
+    local.sink_id_ = id_;
+    local.ring_ = std::make_shared<AsyncLogRing>(buffer_size_);
+    absl::MutexLock lock(&mutex_);
+    rings_.push_back(local.ring_);
+  }
+  return *local.ring_;
+}
+
+void AsyncSinkDelegate::log(absl::string_view msg) {
+  if (localRing().write(msg)) {
+    wakeup();
+  }
+}
+
+void AsyncSinkDelegate::flush() {
+  absl::MutexLock lock(&mutex_);
+  const uint64_t flush = ++flushes_requested_;
+  wakeup_ = true;
+  const auto flushed = [this, flush]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return flushes_done_ >= flush;
+  };
+  mutex_.Await(absl::Condition(&flushed));
+}
+
+uint64_t AsyncSinkDelegate::droppedLines() {
+  absl::MutexLock lock(&mutex_);
+  uint64_t dropped = retired_dropped_lines_;
+  for (const AsyncLogRingSharedPtr& ring : rings_) {
+    dropped += ring->dropped_.load(std::memory_order_relaxed);
+  }
+  return dropped;
+}
+
+void AsyncSinkDelegate::wakeup() {
+  absl::MutexLock lock(&mutex_);
+  wakeup_ = true;
+}
+
+void AsyncSinkDelegate::drainLoop() {
+  while (true) {
+    SinkDelegate* sink;
+    uint64_t flushes_requested;
+    bool flush;
+    bool stopping;
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.AwaitWithTimeout(absl::Condition(&wakeup_), absl::FromChrono(DrainInterval));
+      wakeup_ = false;
+      sink = sink_;
+      flushes_requested = flushes_requested_;
+      flush = flushes_requested_ != flushes_done_;
+      stopping = stopping_;
+    }
+    // Nothing is queued before the previous delegate is known.
+    if (sink != nullptr) {
+      drain(*sink);
+      if (flush || stopping) {
+        sink->flush();
+      }
+    }
+    absl::MutexLock lock(&mutex_);
+    flushes_done_ = flushes_requested;
+    if (stopping) {
+      return;
+    }
+  }
+}
+
+void AsyncSinkDelegate::drain(SinkDelegate& sink) {
+  std::vector<AsyncLogRingSharedPtr> rings;
+  {
+    absl::MutexLock lock(&mutex_);
+    rings = rings_;
+  }
+  std::vector<AsyncLogRing*> retired;
+  for (const AsyncLogRingSharedPtr& ring : rings) {
+    // The abandoned flag is read before the lines, so that a ring is only freed once the lines
+    // written before its thread abandoned it were read.
+    const bool abandoned = ring->abandoned_.load(std::memory_order_acquire);
+    ring->read([&sink](absl::string_view line) { sink.log(line); });
+    const uint64_t dropped = ring->dropped_.load(std::memory_order_relaxed);
+    if (dropped != ring->reported_dropped_) {
+      sink.log(fmt::format("dropped {} log lines as the async log buffer of a thread was full\n",
+                           dropped - ring->reported_dropped_));
+      ring->reported_dropped_ = dropped;
+    }
+    if (abandoned) {
+      retired.push_back(ring.get());
+    }
+  }
+  if (!retired.empty()) {
+    absl::MutexLock lock(&mutex_);
+    for (AsyncLogRing* ring : retired) {
+      retired_dropped_lines_ += ring->dropped_.load(std::memory_order_relaxed);
+    }
+    rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                [&retired](const AsyncLogRingSharedPtr& ring) {
+                                  return std::find(retired.begin(), retired.end(), ring.get()) !=
+                                         retired.end();
+                                }),
+                 rings_.end());
+  }
+}
+
 } // namespace Logger
 } // namespace Envoy
@@ -1,15 +1,19 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/access_log/access_log.h"
+#include "envoy/thread/thread.h"
 
 #include "common/common/logger.h"
 #include "common/common/macros.h"
 
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Logger {
@@ -31,6 +35,60 @@ private:
   AccessLog::AccessLogFileSharedPtr log_file_;
 };
 
+struct AsyncLogRing;
+using AsyncLogRingSharedPtr = std::shared_ptr<AsyncLogRing>;
+
+/**
+ * SinkDelegate that queues the formatted log lines of each thread in a ring buffer of the thread,
+ * written without locks, and writes them to the previous delegate from a thread of its own. This
+ * takes the writing of the lines, and the lock of the previous delegate, off the threads which
+ * log. The lines which do not fit in the ring of their thread are dropped and counted.
+ */
+class AsyncSinkDelegate : public SinkDelegate {
+public:
+  /**
+   * @param thread_factory supplies the factory of the thread which writes the lines.
+   * @param buffer_size supplies the size in bytes of the ring buffer of each thread.
+   * @param log_sink supplies the sink to delegate from.
+   */
+  AsyncSinkDelegate(Thread::ThreadFactory& thread_factory, uint32_t buffer_size,
+                    DelegatingLogSinkSharedPtr log_sink);
+  ~AsyncSinkDelegate() override;
+
+  // SinkDelegate
+  void log(absl::string_view msg) override;
+  // Waits for the lines queued before the call to be written, and flushes the previous delegate.
+  void flush() override;
+
+  /**
+   * @return the number of lines dropped as the ring buffer of their thread was full.
+   */
+  uint64_t droppedLines();
+
+  // How often the queued lines are written when no ring buffer fills up or flush is called.
+  static constexpr std::chrono::milliseconds DrainInterval{10};
+
+private:
+  AsyncLogRing& localRing();
+  void wakeup();
+  void drainLoop();
+  void drain(SinkDelegate& sink);
+
+  const uint64_t id_;
+  const uint32_t buffer_size_;
+  absl::Mutex mutex_;
+  // The delegate the lines are written to, by the drain thread.
+  SinkDelegate* sink_ ABSL_GUARDED_BY(mutex_){};
+  std::vector<AsyncLogRingSharedPtr> rings_ ABSL_GUARDED_BY(mutex_);
+  bool wakeup_ ABSL_GUARDED_BY(mutex_){};
+  bool stopping_ ABSL_GUARDED_BY(mutex_){};
+  uint64_t flushes_requested_ ABSL_GUARDED_BY(mutex_){};
+  uint64_t flushes_done_ ABSL_GUARDED_BY(mutex_){};
+  // The lines dropped by the threads whose rings were freed.
+  uint64_t retired_dropped_lines_ ABSL_GUARDED_BY(mutex_){};
+  Thread::ThreadPtr drain_thread_;
+};
+
 } // namespace Logger
 
 } // namespace Envoy
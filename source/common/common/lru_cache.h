@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <utility>
+
+#include "common/common/non_copyable.h"
+
+#include "absl/container/node_hash_map.h"
+
+namespace Envoy {
+
+/**
+ * A map that evicts its least recently used entries once the total cost of its entries exceeds its
+ * capacity. Each entry has a cost, 1 unless the caller says otherwise, so that the capacity may be
+ * a number of entries or a number of bytes. Looking up or inserting an entry makes it the most
+ * recently used one. The cache is not thread safe.
+ */
+template <class K, class V> class LruCache : NonCopyable {
+public:
+  /**
+   * @param capacity supplies the maximum total cost of the entries.
+   */
+  explicit LruCache(uint64_t capacity) : capacity_(capacity) {}
+
+  /**
+   * Looks up an entry, and marks it as the most recently used one.
+   * @param key supplies the key of the entry.
+   * @return a pointer to the value of the entry, valid until the entry is erased or evicted, or
+   *         nullptr if there is none.
+   */
+  V* find(const K& key) {
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      return nullptr;
+    }
+    order_.splice(order_.begin(), order_, it->second.position_);
+    return &it->second.value_;
+  }
+
+  /**
+   * Adds an entry, or replaces the entry of the key, as the most recently used one, evicting the
+   * least recently used entries until it fits.
+   * @param key supplies the key of the entry.
+   * @param value supplies the value of the entry.
+   * @param cost supplies the cost of the entry.
+   * @return bool whether the entry was inserted, false if its cost exceeds the capacity, in which
+   *         case the cache is left unchanged.
+   */
+  bool insert(K key, V value, uint64_t cost = 1) {
+    if (cost > capacity_) {
+      return false;
+    }
+    erase(key);
+    while (cost_ + cost > capacity_) {
+      erase(*order_.back());
+    }
+    auto it = entries_.emplace(std::move(key), Entry{std::move(value), cost, {}}).first;
+    // The keys of the node map stay in place, so the order refers to them.
+    order_.push_front(&it->first);
+    it->second.position_ = order_.begin();
+    cost_ += cost;
+    return true;
+  }
+
+  /**
+   * Removes the entry of a key, if any.
+   * @return bool whether there was an entry.
+   */
+  bool erase(const K& key) {
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      return false;
+    }
+    cost_ -= it->second.cost_;
+    order_.erase(it->second.position_);
+    entries_.erase(it);
+    return true;
+  }
+
+  /**
+   * Removes all the entries.
+   */
+  void clear() {
+    order_.clear();
+    entries_.clear();
+    cost_ = 0;
+  }
+
+  /**
+   * @return the number of entries.
+   */
+  size_t size() const { return entries_.size(); }
+
+  /**
+   * @return the total cost of the entries.
+   */
+  uint64_t cost() const { return cost_; }
+
+private:
+  struct Entry {
+    V value_;
+    uint64_t cost_;
+    typename std::list<const K*>::iterator position_;
+  };
+
+  const uint64_t capacity_;
+  absl::node_hash_map<K, Entry> entries_;
+  // The keys of the entries, from the most to the least recently used.
+  std::list<const K*> order_;
+  uint64_t cost_{0};
+};
+
+} // namespace Envoy
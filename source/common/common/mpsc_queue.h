@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+
+/**
+ * Unbounded multiple producer single consumer queue
+ * (http://www.1024cores.net/home/lock-free-algorithms/queues/intrusive-mpsc-node-based-queue).
+ * A push is an atomic exchange and a store, without any lock, so that producers never wait on
+ * each other or on the consumer. A pop by the consumer may miss an element whose push has not
+ * completed yet, which the producer can detect by other means, e.g. by signaling the consumer
+ * after the push. T must be default constructible and movable.
+ */
+template <class T> class MpscQueue : NonCopyable {
+public:
+  MpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+  ~MpscQueue() {
+    T value;
+    while (pop(value)) {
+    }
+    // pop() frees the previous head, the last popped node is the stub of the queue until now.
+    if (head_ != &stub_) {
+      delete head_;
+    }
+  }
+
+  /**
+   * Adds an element at the back of the queue. May be called from any thread.
+   * @param value supplies the element to add.
+   */
+  void push(T&& value) {
+    Node* node = new Node(std::move(value));
+    Node* prev = tail_.exchange(node, std::memory_order_acq_rel);
+    prev->next_.store(node, std::memory_order_release);
+  }
+
+  /**
+   * Removes the element at the front of the queue. Must only be called from the consumer thread.
+   * @param value supplies where to move the element.
+   * @return whether there was an element to remove.
+   */
+  bool pop(T& value) {
+    Node* head = head_;
+    Node* next = head->next_.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      return false;
+    }
+    // The next node becomes the stub of the queue once its element is moved out.
+    head_ = next;
+    value = std::move(next->value_);
+    if (head != &stub_) {
+      delete head;
+    }
+    return true;
+  }
+
+private:
+  struct Node {
+    Node() = default;
+    explicit Node(T&& value) : value_(std::move(value)) {}
+
+    std::atomic<Node*> next_{};
+    T value_;
+  };
+
+  // Only accessed by the consumer.
+  Node* head_;
+  Node stub_;
+  std::atomic<Node*> tail_;
+};
+
+} // namespace Envoy
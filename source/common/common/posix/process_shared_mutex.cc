@@ -0,0 +1,15 @@
+#include "common/common/process_shared_mutex.h"
+
+namespace Envoy {
+namespace Thread {
+
+void ProcessSharedMutex::initialize(pthread_mutex_t& mutex) {
+  pthread_mutexattr_t attribute;
+  pthread_mutexattr_init(&attribute);
+  pthread_mutexattr_setpshared(&attribute, PTHREAD_PROCESS_SHARED);
+  pthread_mutexattr_setrobust(&attribute, PTHREAD_MUTEX_ROBUST);
+  pthread_mutex_init(&mutex, &attribute);
+}
+
+} // namespace Thread
+} // namespace Envoy
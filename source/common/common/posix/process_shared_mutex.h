@@ -0,0 +1,62 @@
+#pragma once
+
+#include <pthread.h>
+
+#include <cerrno>
+
+#include "envoy/thread/thread.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Thread {
+
+/**
+ * Implementation of Thread::BasicLockable that operates on a process shared pthread mutex, which
+ * lives in memory shared between processes.
+ */
+class ProcessSharedMutex : public Thread::BasicLockable {
+public:
+  ProcessSharedMutex(pthread_mutex_t& mutex) : mutex_(mutex) {}
+
+  /**
+   * Initialize a pthread mutex for process shared locking.
+   */
+  static void initialize(pthread_mutex_t& mutex);
+
+  void lock() ABSL_EXCLUSIVE_LOCK_FUNCTION() override {
+    // Deal with robust handling here. If the other process dies without unlocking, we are going
+    // to die shortly but try to make sure that we can handle any signals, etc. that happen without
+    // getting into a further messed up state.
+    int rc = pthread_mutex_lock(&mutex_);
+    ASSERT(rc == 0 || rc == EOWNERDEAD);
+    if (rc == EOWNERDEAD) {
+      pthread_mutex_consistent(&mutex_);
+    }
+  }
+
+  bool tryLock() ABSL_EXCLUSIVE_TRYLOCK_FUNCTION(true) override {
+    int rc = pthread_mutex_trylock(&mutex_);
+    if (rc == EBUSY) {
+      return false;
+    }
+
+    ASSERT(rc == 0 || rc == EOWNERDEAD);
+    if (rc == EOWNERDEAD) {
+      pthread_mutex_consistent(&mutex_);
+    }
+
+    return true;
+  }
+
+  void unlock() ABSL_UNLOCK_FUNCTION() override {
+    int rc = pthread_mutex_unlock(&mutex_);
+    ASSERT(rc == 0);
+  }
+
+private:
+  pthread_mutex_t& mutex_;
+};
+
+} // namespace Thread
+} // namespace Envoy
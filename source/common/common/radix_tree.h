@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+
+/**
+ * A radix tree of byte strings, with a value at each node. The keys that share a prefix share the
+ * nodes of the prefix, and edges are labelled with the bytes up to the next branch, so that all
+ * the keys that are prefixes of a string are found in a single pass over the string.
+ *
+ * Value must be default constructible. The nodes that were only created to branch off keep a
+ * default constructed value.
+ */
+template <class Value> class RadixTree {
+public:
+  /**
+   * @param key supplies the key of a node.
+   * @return the value of the node of the key, creating the node if there is none.
+   */
+  Value& findOrCreate(absl::string_view key) {
+    Node* node = &root_;
+    while (!key.empty()) {
+      auto it =
+          std::lower_bound(node->children_.begin(), node->children_.end(), key[0], childBefore);
+      if (it == node->children_.end() || it->first != key[0]) {
+        auto child = std::make_unique<Node>();
+        child->label_ = std::string(key);
+        return node->children_.emplace(it, key[0], std::move(child))->second->value_;
+      }
+
+      Node* child = it->second.get();
+      size_t common = 0;
+      while (common < child->label_.size() && common < key.size() &&
+             child->label_[common] == key[common]) {
+        ++common;
+      }
+      if (common < child->label_.size()) {
+        // Split the edge, so that the key ends at or branches off from a node.
+        auto split = std::make_unique<Node>();
+        split->label_ = child->label_.substr(0, common);
+        child->label_.erase(0, common);
+        split->children_.emplace_back(child->label_[0], std::move(it->second));
+        it->second = std::move(split);
+        child = it->second.get();
+      }
+      node = child;
+      key.remove_prefix(common);
+    }
+    return node->value_;
+  }
+
+  /**
+   * Visits the nodes whose key is a prefix of a string, from the shortest key to the longest, the
+   * root included.
+   * @param size supplies the size of the string.
+   * @param byte_at supplies the byte of the string at a position, e.g. so that the string may be
+   *        walked in reverse or lower cased.
+   * @param visit supplies the function called with the value of each node and the size of its
+   *        key, which returns false to stop the walk.
+   */
+  template <class ByteAt, class Visit> void walk(size_t size, ByteAt byte_at, Visit visit) const {
+    const Node* node = &root_;
+    size_t position = 0;
+    while (visit(node->value_, position) && position < size) {
+      const Node* child = findChild(*node, byte_at(position));
+      if (child == nullptr || size - position < child->label_.size()) {
+        return;
+      }
+      for (const char c : child->label_) {
+        if (byte_at(position) != c) {
+          return;
+        }
+        ++position;
+      }
+      node = child;
+    }
+  }
+
+private:
+  struct Node;
+  using Child = std::pair<char, std::unique_ptr<Node>>;
+
+  struct Node {
+    // The bytes on the edge from the parent to this node.
+    std::string label_;
+    // The children of the node, keyed and sorted by the first byte of their label.
+    std::vector<Child> children_;
+    Value value_{};
+  };
+
+  static bool childBefore(const Child& child, char c) { return child.first < c; }
+
+  static const Node* findChild(const Node& node, char c) {
+    auto it = std::lower_bound(node.children_.begin(), node.children_.end(), c, childBefore);
+    if (it == node.children_.end() || it->first != c) {
+      return nullptr;
+    }
+    return it->second.get();
+  }
+
+  Node root_;
+};
+
+} // namespace Envoy
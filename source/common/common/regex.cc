@@ -1,5 +1,7 @@
 #include "common/common/regex.h"
 
+#include <algorithm>
+
 #include "envoy/common/exception.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/type/matcher/v3/regex.pb.h"
@@ -10,6 +12,7 @@
 #include "common/stats/symbol_table_impl.h"
 
 #include "re2/re2.h"
+#include "re2/set.h"
 
 namespace Envoy {
 namespace Regex {
@@ -119,6 +122,43 @@ private:
   const re2::RE2 regex_;
 };
 
+// Matches the regexes of the set with a single DFA, anchored at both ends as with FullMatch().
+class CompiledGoogleReMatcherSet : public CompiledMatcherSet {
+public:
+  CompiledGoogleReMatcherSet(
+      const std::vector<const envoy::type::matcher::v3::RegexMatcher*>& matchers)
+      : set_(re2::RE2::Quiet, re2::RE2::ANCHOR_BOTH) {
+    for (const auto* matcher : matchers) {
+      ASSERT(matcher->has_google_re2());
+      // Compiling each regex on its own checks its program size.
+      const CompiledGoogleReMatcher checked(*matcher);
+      std::string error;
+      if (set_.Add(matcher->regex(), &error) < 0) {
+        throw EnvoyException(error);
+      }
+    }
+    if (!set_.Compile()) {
+      throw EnvoyException("regex set failed to compile");
+    }
+  }
+
+  // CompiledMatcherSet
+  bool matchAny(absl::string_view value) const override {
+    return set_.Match(re2::StringPiece(value.data(), value.size()), nullptr);
+  }
+
+  // CompiledMatcherSet
+  std::vector<uint32_t> matches(absl::string_view value) const override {
+    std::vector<int> indices;
+    set_.Match(re2::StringPiece(value.data(), value.size()), &indices);
+    std::sort(indices.begin(), indices.end());
+    return {indices.begin(), indices.end()};
+  }
+
+private:
+  re2::RE2::Set set_;
+};
+
 } // namespace
 
 CompiledMatcherPtr Utility::parseRegex(const envoy::type::matcher::v3::RegexMatcher& matcher) {
@@ -127,6 +167,11 @@ CompiledMatcherPtr Utility::parseRegex(const envoy::type::matcher::v3::RegexMatc
   return std::make_unique<CompiledGoogleReMatcher>(matcher);
 }
 
+CompiledMatcherSetPtr Utility::parseRegexSet(
+    const std::vector<const envoy::type::matcher::v3::RegexMatcher*>& matchers) {
+  return std::make_unique<CompiledGoogleReMatcherSet>(matchers);
+}
+
 CompiledMatcherPtr Utility::parseStdRegexAsCompiledMatcher(const std::string& regex,
                                                            std::regex::flag_type flags) {
   return std::make_unique<CompiledStdMatcher>(parseStdRegex(regex, flags));
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <regex>
+#include <vector>
 
 #include "envoy/common/regex.h"
 #include "envoy/type/matcher/v3/regex.pb.h"
@@ -40,6 +41,15 @@ public:
    * Construct a compiled regex matcher from a match config.
    */
   static CompiledMatcherPtr parseRegex(const envoy::type::matcher::v3::RegexMatcher& matcher);
+
+  /**
+   * Construct a compiled regex matcher set from match configs, which matches all the regexes in a
+   * single scan of a value. Each regex is subject to the same checks as with parseRegex().
+   * @param matchers supplies the match configs, in the order of the indices of the set.
+   * @throw EnvoyException if a regex is invalid or the set fails to compile.
+   */
+  static CompiledMatcherSetPtr
+  parseRegexSet(const std::vector<const envoy::type::matcher::v3::RegexMatcher*>& matchers);
 };
 
 } // namespace Regex
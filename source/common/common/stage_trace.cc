@@ -0,0 +1,198 @@
+#include "common/common/stage_trace.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/lock_guard.h"
+#include "common/common/macros.h"
+#include "common/common/thread.h"
+#include "common/common/thread_annotations.h"
+#include "common/common/utility.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+namespace Envoy {
+namespace {
+
+// A record written by its thread and read by the admin thread while it may be rewritten. The
+// sequence is 0 while the record is written, and the index of the record plus 1 once it is, so
+// that a reader drops a record whose sequence changed while it read it. The fields are atomics,
+// accessed relaxed, only so that the reads racing with the writes are well defined.
+struct Record {
+  std::atomic<uint64_t> sequence_{};
+  std::atomic<int64_t> time_ns_{};
+  std::atomic<uint64_t> connection_id_{};
+  std::atomic<uint64_t> stream_id_{};
+  std::atomic<uint8_t> stage_{};
+};
+
+struct Ring {
+  Ring(std::string&& thread_name, uint32_t track)
+      : thread_name_(std::move(thread_name)), track_(track) {}
+
+  const std::string thread_name_;
+  // The Chrome trace thread id of the records.
+  const uint32_t track_;
+  // Only accessed by the thread of the ring.
+  uint64_t next_record_{};
+  Record records_[StageTrace::RingCapacity];
+};
+
+// The rings of the threads which recorded a stage. A ring is removed and freed when its thread
+// exits, under the lock held by the readers.
+struct Registry {
+  Thread::MutexBasicLockable mutex_;
+  std::vector<Ring*> rings_ ABSL_GUARDED_BY(mutex_);
+  uint32_t next_track_ ABSL_GUARDED_BY(mutex_){1};
+  // The records older than this are cleared.
+  std::atomic<int64_t> cleared_before_ns_{};
+};
+
+Registry& registry() { MUTABLE_CONSTRUCT_ON_FIRST_USE(Registry); }
+
+struct ThreadRing {
+  ~ThreadRing() {
+    if (ring_ != nullptr) {
+      Registry& rings = registry();
+      Thread::LockGuard guard(rings.mutex_);
+      rings.rings_.erase(std::find(rings.rings_.begin(), rings.rings_.end(), ring_.get()));
+    }
+  }
+
+  std::unique_ptr<Ring> ring_;
+};
+
+thread_local ThreadRing thread_ring;
+
+std::string currentThreadName() {
+#ifdef __linux__
+  char name[16];
+  if (pthread_getname_np(pthread_self(), name, sizeof(name)) == 0) {
+    return name;
+  }
+#endif
+  return "";
+}
+
+Ring& currentRing() {
+  if (thread_ring.ring_ == nullptr) {
+    Registry& rings = registry();
+    Thread::LockGuard guard(rings.mutex_);
+    thread_ring.ring_ = std::make_unique<Ring>(currentThreadName(), rings.next_track_++);
+    rings.rings_.push_back(thread_ring.ring_.get());
+  }
+  return *thread_ring.ring_;
+}
+
+int64_t nowNanoseconds() {
+  static RealTimeSource time_source;
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             time_source.monotonicTime().time_since_epoch())
+      .count();
+}
+
+std::string jsonString(absl::string_view value) {
+  std::string json = "\"";
+  for (const char c : value) {
+    if (c == '"' || c == '\\') {
+      json.push_back('\\');
+      json.push_back(c);
+    } else if (static_cast<unsigned char>(c) >= 0x20) {
+      json.push_back(c);
+    }
+  }
+  json.push_back('"');
+  return json;
+}
+
+} // namespace
+
+std::atomic<bool> StageTrace::enabled_{false};
+
+void StageTrace::setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+void StageTrace::record(Stage stage, uint64_t connection_id, uint64_t stream_id) {
+  Ring& ring = currentRing();
+  const uint64_t index = ring.next_record_++;
+  Record& record = ring.records_[index % RingCapacity];
+  record.sequence_.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  record.time_ns_.store(nowNanoseconds(), std::memory_order_relaxed);
+  record.connection_id_.store(connection_id, std::memory_order_relaxed);
+  record.stream_id_.store(stream_id, std::memory_order_relaxed);
+  record.stage_.store(static_cast<uint8_t>(stage), std::memory_order_relaxed);
+  record.sequence_.store(index + 1, std::memory_order_release);
+}
+
+void StageTrace::clear() {
+  registry().cleared_before_ns_.store(nowNanoseconds(), std::memory_order_relaxed);
+}
+
+std::string StageTrace::chromeTrace() {
+  Registry& rings = registry();
+  const int64_t cleared_before_ns = rings.cleared_before_ns_.load(std::memory_order_relaxed);
+  std::string trace = R"({"displayTimeUnit":"ns","traceEvents":[)";
+  bool first = true;
+  const auto append_event = [&trace, &first](absl::string_view event) {
+    if (!first) {
+      trace.push_back(',');
+    }
+    first = false;
+    trace.append(event.data(), event.size());
+  };
+
+  Thread::LockGuard guard(rings.mutex_);
+  for (const Ring* ring : rings.rings_) {
+    append_event(fmt::format(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},)"
+                             R"("args":{{"name":{}}}}})",
+                             ring->track_, jsonString(ring->thread_name_)));
+    for (const Record& record : ring->records_) {
+      const uint64_t sequence = record.sequence_.load(std::memory_order_acquire);
+      if (sequence == 0) {
+        continue;
+      }
+      const int64_t time_ns = record.time_ns_.load(std::memory_order_relaxed);
+      const uint64_t connection_id = record.connection_id_.load(std::memory_order_relaxed);
+      const uint64_t stream_id = record.stream_id_.load(std::memory_order_relaxed);
+      const auto stage = static_cast<Stage>(record.stage_.load(std::memory_order_relaxed));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (record.sequence_.load(std::memory_order_relaxed) != sequence ||
+          time_ns < cleared_before_ns) {
+        continue;
+      }
+      // The timestamps are in microseconds.
+      append_event(fmt::format(
+          R"({{"name":"{}","ph":"i","s":"t","ts":{}.{:03},"pid":1,"tid":{},)"
+          R"("args":{{"connection":{},"stream":{}}}}})",
+          stageName(stage), time_ns / 1000, time_ns % 1000, ring->track_, connection_id,
+          stream_id));
+    }
+  }
+  trace.append("]}");
+  return trace;
+}
+
+absl::string_view StageTrace::stageName(Stage stage) {
+  switch (stage) {
+  case Stage::Accept:
+    return "accept";
+  case Stage::TlsHandshake:
+    return "tls_handshake";
+  case Stage::HeadersDecoded:
+    return "headers_decoded";
+  case Stage::RouteSelected:
+    return "route_selected";
+  case Stage::UpstreamConnected:
+    return "upstream_connected";
+  case Stage::UpstreamFirstByte:
+    return "upstream_first_byte";
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+} // namespace Envoy
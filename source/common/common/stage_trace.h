@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "absl/strings/string_view.h"
+
+/**
+ * Records a stage of a connection or a request, if stage tracing is enabled. Unlike the
+ * PERF_OPERATION annotations, which are only compiled in with --define=perf_annotation=enabled,
+ * stage tracing is always compiled in, and costs a relaxed atomic load while it is disabled.
+ * @param stage supplies the StageTrace::Stage.
+ * @param connection_id supplies the id of the downstream connection.
+ * @param stream_id supplies the id of the downstream request, 0 for the stages of the connection.
+ */
+#define STAGE_TRACE(stage, connection_id, stream_id)                                               \
+  do {                                                                                             \
+    if (Envoy::StageTrace::enabled()) {                                                            \
+      Envoy::StageTrace::record(stage, connection_id, stream_id);                                  \
+    }                                                                                              \
+  } while (false)
+
+namespace Envoy {
+
+/**
+ * Process wide tracing of the time at which the connections and the requests reach their key
+ * stages, for diagnosing latency in production. Each thread records the stages it sees into a
+ * ring of its own, without locks, the oldest records being overwritten first, and the records of
+ * all the threads are exported in the Chrome trace event format, which Perfetto and
+ * chrome://tracing open.
+ */
+class StageTrace {
+public:
+  enum class Stage : uint8_t {
+    Accept,
+    TlsHandshake,
+    HeadersDecoded,
+    RouteSelected,
+    UpstreamConnected,
+    UpstreamFirstByte,
+  };
+
+  // The number of records kept per thread.
+  static constexpr uint32_t RingCapacity = 8192;
+
+  /**
+   * @return whether the stages are recorded.
+   */
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  /**
+   * Starts or stops recording the stages. The records are kept until they are cleared.
+   */
+  static void setEnabled(bool enabled);
+
+  /**
+   * Records a stage reached on the current thread. Use STAGE_TRACE() instead, which only calls
+   * this when stage tracing is enabled.
+   */
+  static void record(Stage stage, uint64_t connection_id, uint64_t stream_id);
+
+  /**
+   * Drops the records of all the threads.
+   */
+  static void clear();
+
+  /**
+   * @return the records of all the threads, as a JSON trace in the Chrome trace event format. Each
+   *         record is an instant event named after its stage, on the track of its thread, with
+   *         the connection and stream ids as arguments.
+   */
+  static std::string chromeTrace();
+
+  /**
+   * @return the name of a stage.
+   */
+  static absl::string_view stageName(Stage stage);
+
+private:
+  static std::atomic<bool> enabled_;
+};
+
+} // namespace Envoy
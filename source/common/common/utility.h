@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <ios>
@@ -646,6 +647,144 @@ template <class Value> struct TrieLookupTable {
   TrieEntry<Value> root_;
 };
 
+/**
+ * A lookup table for a fixed set of keys, built once and then read many times. The table is a
+ * perfect hash built with the hash and displace method: keys are grouped into buckets by their
+ * hash, and each bucket is assigned a displacement under which all of its keys land in free slots.
+ * A lookup is one hash of the key and at most one key comparison, regardless of how many keys
+ * share a prefix.
+ */
+template <class Value> class PerfectHashLookupTable {
+public:
+  /**
+   * Adds an entry to the table. May only be called before finalize().
+   * @param key the key used to add the entry. Must not be empty.
+   * @param value the value to be associated with the key, replacing any existing value.
+   */
+  void add(absl::string_view key, Value value) {
+    ASSERT(!finalized_);
+    ASSERT(!key.empty());
+    for (auto& entry : pending_) {
+      if (entry.first == key) {
+        entry.second = std::move(value);
+        return;
+      }
+    }
+    pending_.emplace_back(std::string(key), std::move(value));
+  }
+
+  /**
+   * Builds the table from the added entries. No further entries may be added after this point.
+   */
+  void finalize() {
+    ASSERT(!finalized_);
+    finalized_ = true;
+    // A table at least twice the number of keys almost always admits a displacement for every
+    // bucket. Grow it in the unlikely case that it does not.
+    uint64_t table_size = 1;
+    while (table_size < 2 * pending_.size()) {
+      table_size *= 2;
+    }
+    while (!tryBuild(table_size)) {
+      table_size *= 2;
+      RELEASE_ASSERT(table_size <= MaxTableSizePerKey * pending_.size(),
+                     "no perfect hash found for lookup table keys");
+    }
+    pending_.clear();
+    pending_.shrink_to_fit();
+  }
+
+  /**
+   * Finds the entry associated with the key. May only be called after finalize().
+   * @param key the key used to find.
+   * @return the value associated with the key, or a default constructed value if there is none.
+   */
+  const Value& find(absl::string_view key) const {
+    ASSERT(finalized_);
+    const uint64_t hash = HashUtil::xxHash64(key);
+    const Slot& slot = slots_[slotIndex(hash, displacements_[bucketIndex(hash)])];
+    if (slot.key_ == key) {
+      return slot.value_;
+    }
+    return empty_value_;
+  }
+
+private:
+  struct Slot {
+    std::string key_;
+    Value value_{};
+  };
+
+  uint64_t bucketIndex(uint64_t hash) const { return (hash >> 32) & (displacements_.size() - 1); }
+  uint64_t slotIndex(uint64_t hash, uint32_t displacement) const {
+    return ((hash & 0xffffffff) + displacement * ((hash >> 32) | 1)) & (slots_.size() - 1);
+  }
+
+  bool tryBuild(uint64_t table_size) {
+    // Aim for two keys per bucket.
+    uint64_t bucket_count = 1;
+    while (bucket_count * 2 < pending_.size()) {
+      bucket_count *= 2;
+    }
+    slots_ = std::vector<Slot>(table_size);
+    displacements_ = std::vector<uint32_t>(bucket_count);
+
+    std::vector<std::vector<std::pair<uint64_t, size_t>>> buckets(bucket_count);
+    for (size_t i = 0; i < pending_.size(); ++i) {
+      const uint64_t hash = HashUtil::xxHash64(pending_[i].first);
+      buckets[bucketIndex(hash)].emplace_back(hash, i);
+    }
+    // Place the largest buckets first, while the table is emptiest.
+    std::vector<size_t> order(bucket_count);
+    for (size_t i = 0; i < bucket_count; ++i) {
+      order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&buckets](size_t lhs, size_t rhs) {
+      return buckets[lhs].size() > buckets[rhs].size();
+    });
+
+    std::vector<bool> occupied(table_size);
+    std::vector<uint64_t> placed;
+    for (const size_t bucket : order) {
+      bool found = false;
+      for (uint32_t displacement = 0; !found && displacement < MaxDisplacement; ++displacement) {
+        placed.clear();
+        found = true;
+        for (const auto& key : buckets[bucket]) {
+          const uint64_t index = slotIndex(key.first, displacement);
+          if (occupied[index] || std::find(placed.begin(), placed.end(), index) != placed.end()) {
+            found = false;
+            break;
+          }
+          placed.push_back(index);
+        }
+        if (found) {
+          displacements_[bucket] = displacement;
+          for (size_t i = 0; i < placed.size(); ++i) {
+            occupied[placed[i]] = true;
+            slots_[placed[i]].key_ = pending_[buckets[bucket][i].second].first;
+            slots_[placed[i]].value_ = pending_[buckets[bucket][i].second].second;
+          }
+        }
+      }
+      if (!found) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static constexpr uint32_t MaxDisplacement = 4096;
+  static constexpr uint64_t MaxTableSizePerKey = 64;
+
+  std::vector<std::pair<std::string, Value>> pending_;
+  // An empty table has a single slot with an empty key, which no lookup matches.
+  std::vector<Slot> slots_ = std::vector<Slot>(1);
+  std::vector<uint32_t> displacements_ = std::vector<uint32_t>(1);
+  const Value empty_value_{};
+  bool finalized_{};
+};
+
 /**
  * A global utility class to take care of all the exception throwing behaviors in header files.
  * Its functions simply forward the throwing into .cc file.
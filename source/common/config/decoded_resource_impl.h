@@ -26,9 +26,14 @@ using DecodedResourceImplPtr = std::unique_ptr<DecodedResourceImpl>;
 
 class DecodedResourceImpl : public DecodedResource {
 public:
+  /**
+   * @param predecoded supplies the message that OpaqueResourceDecoder::predecodeResource() returned
+   *        for the resource, if any, which is only finished decoding.
+   */
   static DecodedResourceImplPtr fromResource(OpaqueResourceDecoder& resource_decoder,
                                              const ProtobufWkt::Any& resource,
-                                             const std::string& version) {
+                                             const std::string& version,
+                                             ProtobufTypes::MessagePtr predecoded = nullptr) {
     if (resource.Is<envoy::service::discovery::v3::Resource>()) {
       envoy::service::discovery::v3::Resource r;
       MessageUtil::unpackTo(resource, r);
@@ -40,23 +45,37 @@ public:
 
     return std::unique_ptr<DecodedResourceImpl>(new DecodedResourceImpl(
         resource_decoder, absl::nullopt, Protobuf::RepeatedPtrField<std::string>(), resource, true,
-        version, absl::nullopt));
+        version, absl::nullopt, std::move(predecoded)));
+  }
+
+  /**
+   * @param resource supplies the message decoded from an identical resource of an earlier update,
+   *        which is shared rather than decoded again.
+   */
+  static DecodedResourceImplPtr fromDecoded(OpaqueResourceDecoder& resource_decoder,
+                                            std::shared_ptr<const Protobuf::Message> resource,
+                                            const std::string& version) {
+    const std::string name = resource_decoder.resourceName(*resource);
+    return std::make_unique<DecodedResourceImpl>(std::move(resource), name,
+                                                 std::vector<std::string>(), version);
   }
 
   DecodedResourceImpl(OpaqueResourceDecoder& resource_decoder,
-                      const envoy::service::discovery::v3::Resource& resource)
+                      const envoy::service::discovery::v3::Resource& resource,
+                      ProtobufTypes::MessagePtr predecoded = nullptr)
       : DecodedResourceImpl(resource_decoder, resource.name(), resource.aliases(),
                             resource.resource(), resource.has_resource(), resource.version(),
                             resource.has_ttl()
                                 ? absl::make_optional(std::chrono::milliseconds(
                                       DurationUtil::durationToMilliseconds(resource.ttl())))
-                                : absl::nullopt) {}
+                                : absl::nullopt,
+                            std::move(predecoded)) {}
   DecodedResourceImpl(OpaqueResourceDecoder& resource_decoder,
                       const xds::core::v3::CollectionEntry::InlineEntry& inline_entry)
       : DecodedResourceImpl(resource_decoder, inline_entry.name(),
                             Protobuf::RepeatedPtrField<std::string>(), inline_entry.resource(),
-                            true, inline_entry.version(), absl::nullopt) {}
-  DecodedResourceImpl(ProtobufTypes::MessagePtr resource, const std::string& name,
+                            true, inline_entry.version(), absl::nullopt, nullptr) {}
+  DecodedResourceImpl(std::shared_ptr<const Protobuf::Message> resource, const std::string& name,
                       const std::vector<std::string>& aliases, const std::string& version)
       : resource_(std::move(resource)), has_resource_(true), name_(name), aliases_(aliases),
         version_(version), ttl_(absl::nullopt) {}
@@ -69,16 +88,33 @@ public:
   bool hasResource() const override { return has_resource_; }
   absl::optional<std::chrono::milliseconds> ttl() const override { return ttl_; }
 
+  /**
+   * @return the decoded message, which outlives the resource if it is kept.
+   */
+  const std::shared_ptr<const Protobuf::Message>& sharedResource() const { return resource_; }
+
 private:
   DecodedResourceImpl(OpaqueResourceDecoder& resource_decoder, absl::optional<std::string> name,
                       const Protobuf::RepeatedPtrField<std::string>& aliases,
                       const ProtobufWkt::Any& resource, bool has_resource,
-                      const std::string& version, absl::optional<std::chrono::milliseconds> ttl)
-      : resource_(resource_decoder.decodeResource(resource)), has_resource_(has_resource),
+                      const std::string& version, absl::optional<std::chrono::milliseconds> ttl,
+                      ProtobufTypes::MessagePtr predecoded)
+      : resource_(decode(resource_decoder, resource, std::move(predecoded))),
+        has_resource_(has_resource),
         name_(name ? *name : resource_decoder.resourceName(*resource_)),
         aliases_(repeatedPtrFieldToVector(aliases)), version_(version), ttl_(ttl) {}
 
-  const ProtobufTypes::MessagePtr resource_;
+  static ProtobufTypes::MessagePtr decode(OpaqueResourceDecoder& resource_decoder,
+                                          const ProtobufWkt::Any& resource,
+                                          ProtobufTypes::MessagePtr predecoded) {
+    if (predecoded == nullptr) {
+      return resource_decoder.decodeResource(resource);
+    }
+    resource_decoder.finishDecodeResource(*predecoded);
+    return predecoded;
+  }
+
+  const std::shared_ptr<const Protobuf::Message> resource_;
   const bool has_resource_;
   const std::string name_;
   const std::vector<std::string> aliases_;
@@ -26,7 +26,9 @@ GrpcMuxImpl::GrpcMuxImpl(const LocalInfo::LocalInfo& local_info,
       first_stream_request_(true), transport_api_version_(transport_api_version),
       dispatcher_(dispatcher),
       enable_type_url_downgrade_and_upgrade_(Runtime::runtimeFeatureEnabled(
-          "envoy.reloadable_features.enable_type_url_downgrade_and_upgrade")) {
+          "envoy.reloadable_features.enable_type_url_downgrade_and_upgrade")),
+      memoize_resource_decoding_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.memoize_sotw_resource_decoding")) {
   Config::Utility::checkLocalInfo("ads", local_info);
 }
 
@@ -87,6 +89,9 @@ GrpcMuxWatchPtr GrpcMuxImpl::addWatch(const std::string& type_url,
     if (enable_type_url_downgrade_and_upgrade_) {
       registerVersionedTypeUrl(type_url);
     }
+    if (snapshot_store_ != nullptr || handed_over_responses_.contains(type_url)) {
+      scheduleSnapshot(type_url);
+    }
   }
 
   // This will send an updated request on each subscription.
@@ -139,12 +144,12 @@ void GrpcMuxImpl::registerVersionedTypeUrl(const std::string& type_url) {
 }
 
 void GrpcMuxImpl::onDiscoveryResponse(
-    std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& message,
+    const envoy::service::discovery::v3::DiscoveryResponse& message,
     ControlPlaneStats& control_plane_stats) {
-  std::string type_url = message->type_url();
-  ENVOY_LOG(debug, "Received gRPC message for {} at version {}", type_url, message->version_info());
-  if (message->has_control_plane()) {
-    control_plane_stats.identifier_.set(message->control_plane().identifier());
+  std::string type_url = message.type_url();
+  ENVOY_LOG(debug, "Received gRPC message for {} at version {}", type_url, message.version_info());
+  if (message.has_control_plane()) {
+    control_plane_stats.identifier_.set(message.control_plane().identifier());
   }
   // If this type url is not watched(no subscriber or no watcher), try another version of type url.
   if (enable_type_url_downgrade_and_upgrade_ && api_state_.count(type_url) == 0) {
@@ -164,14 +169,14 @@ void GrpcMuxImpl::onDiscoveryResponse(
 
   if (apiStateFor(type_url).watches_.empty()) {
     // update the nonce as we are processing this response.
-    apiStateFor(type_url).request_.set_response_nonce(message->nonce());
-    if (message->resources().empty()) {
+    apiStateFor(type_url).request_.set_response_nonce(message.nonce());
+    if (message.resources().empty()) {
       // No watches and no resources. This can happen when envoy unregisters from a
       // resource that's removed from the server as well. For example, a deleted cluster
       // triggers un-watching the ClusterLoadAssignment watch, and at the same time the
       // xDS server sends an empty list of ClusterLoadAssignment resources. we'll accept
       // this update. no need to send a discovery request, as we don't watch for anything.
-      apiStateFor(type_url).request_.set_version_info(message->version_info());
+      apiStateFor(type_url).request_.set_version_info(message.version_info());
     } else {
       // No watches and we have resources - this should not happen. send a NACK (by not
       // updating the version).
@@ -180,6 +185,12 @@ void GrpcMuxImpl::onDiscoveryResponse(
     }
     return;
   }
+  applyResponse(type_url, message, false);
+}
+
+void GrpcMuxImpl::applyResponse(const std::string& type_url,
+                                const envoy::service::discovery::v3::DiscoveryResponse& message,
+                                bool from_snapshot) {
   ScopedResume same_type_resume;
   // We pause updates of the same type. This is necessary for SotW and GrpcMuxImpl, since unlike
   // delta and NewGRpcMuxImpl, independent watch additions/removals trigger updates regardless of
@@ -195,22 +206,61 @@ void GrpcMuxImpl::onDiscoveryResponse(
     std::vector<DecodedResourceImplPtr> resources;
     absl::btree_map<std::string, DecodedResourceRef> resource_ref_map;
     std::vector<DecodedResourceRef> all_resource_refs;
+    // The resources of the response by name, the heartbeats without their resource.
+    std::vector<std::pair<std::string, const ProtobufWkt::Any*>> updated;
     OpaqueResourceDecoder& resource_decoder =
         apiStateFor(type_url).watches_.front()->resource_decoder_;
 
     const auto scoped_ttl_update = apiStateFor(type_url).ttl_.scopedTtlUpdate();
 
-    for (const auto& resource : message->resources()) {
+    // The resources that the last accepted update had already are not decoded again.
+    ResourceDecodeCache& decode_cache = apiStateFor(type_url).decode_cache_;
+    std::vector<std::shared_ptr<const Protobuf::Message>> memoized(message.resources_size());
+    std::vector<int> undecoded;
+    undecoded.reserve(message.resources_size());
+    for (int i = 0; i < message.resources_size(); ++i) {
+      if (memoize_resource_decoding_) {
+        memoized[i] = decode_cache.find(message.resources(i));
+      }
+      if (memoized[i] == nullptr) {
+        undecoded.push_back(i);
+      }
+    }
+
+    std::vector<ProtobufTypes::MessagePtr> predecoded(message.resources_size());
+    if (parallel_decoder_ != nullptr) {
+      std::vector<const ProtobufWkt::Any*> predecoded_resources;
+      predecoded_resources.reserve(undecoded.size());
+      for (const int i : undecoded) {
+        predecoded_resources.push_back(&message.resources(i));
+      }
+      auto messages = parallel_decoder_->predecode(resource_decoder, predecoded_resources);
+      for (size_t j = 0; j < messages.size(); ++j) {
+        predecoded[undecoded[j]] = std::move(messages[j]);
+      }
+    }
+
+    for (int i = 0; i < message.resources_size(); ++i) {
+      const auto& resource = message.resources(i);
       // TODO(snowp): Check the underlying type when the resource is a Resource.
       if (!resource.Is<envoy::service::discovery::v3::Resource>() &&
-          message->type_url() != resource.type_url()) {
+          message.type_url() != resource.type_url()) {
         throw EnvoyException(
             fmt::format("{} does not match the message-wide type URL {} in DiscoveryResponse {}",
-                        resource.type_url(), message->type_url(), message->DebugString()));
+                        resource.type_url(), message.type_url(), message.DebugString()));
       }
 
-      auto decoded_resource =
-          DecodedResourceImpl::fromResource(resource_decoder, resource, message->version_info());
+      DecodedResourceImplPtr decoded_resource;
+      if (memoized[i] != nullptr) {
+        decoded_resource = DecodedResourceImpl::fromDecoded(
+            resource_decoder, std::move(memoized[i]), message.version_info());
+      } else {
+        decoded_resource = DecodedResourceImpl::fromResource(
+            resource_decoder, resource, message.version_info(), std::move(predecoded[i]));
+        if (memoize_resource_decoding_) {
+          decode_cache.insert(resource, decoded_resource->sharedResource());
+        }
+      }
 
       if (decoded_resource->ttl()) {
         apiStateFor(type_url).ttl_.add(*decoded_resource->ttl(), decoded_resource->name());
@@ -218,7 +268,11 @@ void GrpcMuxImpl::onDiscoveryResponse(
         apiStateFor(type_url).ttl_.clear(decoded_resource->name());
       }
 
-      if (!isHeartbeatResource(type_url, *decoded_resource)) {
+      const bool heartbeat = isHeartbeatResource(type_url, *decoded_resource);
+      if (retainsResources()) {
+        updated.emplace_back(decoded_resource->name(), heartbeat ? nullptr : &resource);
+      }
+      if (!heartbeat) {
         resources.emplace_back(std::move(decoded_resource));
         all_resource_refs.emplace_back(*resources.back());
         resource_ref_map.emplace(resources.back()->name(), *resources.back());
@@ -230,7 +284,7 @@ void GrpcMuxImpl::onDiscoveryResponse(
       // Listener) even if the message does not have resources so that update_empty stat
       // is properly incremented and state-of-the-world semantics are maintained.
       if (watch->resources_.empty()) {
-        watch->callbacks_.onConfigUpdate(all_resource_refs, message->version_info());
+        watch->callbacks_.onConfigUpdate(all_resource_refs, message.version_info());
         continue;
       }
       std::vector<DecodedResourceRef> found_resources;
@@ -244,14 +298,30 @@ void GrpcMuxImpl::onDiscoveryResponse(
       // onConfigUpdate should be called only on watches(clusters/routes) that have
       // updates in the message for EDS/RDS.
       if (!found_resources.empty()) {
-        watch->callbacks_.onConfigUpdate(found_resources, message->version_info());
+        watch->callbacks_.onConfigUpdate(found_resources, message.version_info());
       }
     }
     // TODO(mattklein123): In the future if we start tracking per-resource versions, we
     // would do that tracking here.
-    apiStateFor(type_url).request_.set_version_info(message->version_info());
+    apiStateFor(type_url).request_.set_version_info(message.version_info());
+    apiStateFor(type_url).decode_cache_.commit();
+    if (retainsResources()) {
+      RetainedResources& retained = retained_resources_[type_url];
+      retainResources(type_url, message, updated, retained);
+      // The snapshot holds the merged resources, as the response of named watches may only carry
+      // some of them.
+      if (snapshot_store_ != nullptr && !from_snapshot) {
+        snapshot_store_->save(type_url, retained.toResponse());
+      }
+    }
     Memory::Utils::tryShrinkHeap();
   } catch (const EnvoyException& e) {
+    apiStateFor(type_url).decode_cache_.abort();
+    if (from_snapshot) {
+      // The management server did not send the snapshot, so it is ignored rather than rejected.
+      ENVOY_LOG(warn, "Ignoring the snapshot of {}: {}", type_url, e.what());
+      return;
+    }
     for (auto watch : apiStateFor(type_url).watches_) {
       watch->callbacks_.onConfigUpdateFailed(
           Envoy::Config::ConfigUpdateFailureReason::UpdateRejected, &e);
@@ -260,11 +330,130 @@ void GrpcMuxImpl::onDiscoveryResponse(
     error_detail->set_code(Grpc::Status::WellKnownGrpcStatus::Internal);
     error_detail->set_message(Config::Utility::truncateGrpcStatusMessage(e.what()));
   }
-  apiStateFor(type_url).request_.set_response_nonce(message->nonce());
+  apiStateFor(type_url).request_.set_response_nonce(message.nonce());
   ASSERT(apiStateFor(type_url).paused());
   queueDiscoveryRequest(type_url);
 }
 
+void GrpcMuxImpl::enableSnapshots(Filesystem::Instance& file_system, const std::string& directory) {
+  snapshot_store_ = std::make_unique<ResourceSnapshotStore>(file_system, directory);
+}
+
+envoy::service::discovery::v3::DiscoveryResponse
+GrpcMuxImpl::RetainedResources::toResponse() const {
+  envoy::service::discovery::v3::DiscoveryResponse response;
+  response.set_type_url(type_url_);
+  response.set_version_info(version_info_);
+  for (const auto& resource : resources_) {
+    *response.add_resources() = resource.second;
+  }
+  return response;
+}
+
+void GrpcMuxImpl::retainResources(
+    const std::string& type_url, const envoy::service::discovery::v3::DiscoveryResponse& message,
+    const std::vector<std::pair<std::string, const ProtobufWkt::Any*>>& updated,
+    RetainedResources& retained) {
+  absl::node_hash_set<std::string> watched;
+  bool wildcard = false;
+  for (const auto* watch : apiStateFor(type_url).watches_) {
+    if (watch->resources_.empty()) {
+      wildcard = true;
+      break;
+    }
+    watched.insert(watch->resources_.begin(), watch->resources_.end());
+  }
+
+  // The response of a wildcard watch, e.g. LDS or CDS, carries every resource of the type. The
+  // response of named watches, e.g. EDS or RDS, may only carry some of the watched resources, so
+  // the retained ones that are still watched are kept.
+  absl::btree_map<std::string, ProtobufWkt::Any> resources;
+  if (!wildcard) {
+    for (auto& resource : retained.resources_) {
+      if (watched.contains(resource.first)) {
+        resources.emplace(resource.first, std::move(resource.second));
+      }
+    }
+  }
+  for (const auto& [name, resource] : updated) {
+    if (resource != nullptr) {
+      resources[name] = *resource;
+      continue;
+    }
+    // A heartbeat leaves the retained resource current.
+    auto it = retained.resources_.find(name);
+    if (it != retained.resources_.end() && !resources.contains(name)) {
+      resources.emplace(name, std::move(it->second));
+    }
+  }
+  retained.type_url_ = message.type_url();
+  retained.version_info_ = message.version_info();
+  retained.resources_ = std::move(resources);
+}
+
+std::vector<envoy::service::discovery::v3::DiscoveryResponse> GrpcMuxImpl::handoffResponses() {
+  std::vector<envoy::service::discovery::v3::DiscoveryResponse> responses;
+  if (!keep_handoff_responses_) {
+    return responses;
+  }
+  responses.reserve(retained_resources_.size());
+  for (const auto& retained : retained_resources_) {
+    responses.push_back(retained.second.toResponse());
+  }
+  return responses;
+}
+
+void GrpcMuxImpl::applyHandoffResponses(
+    std::vector<envoy::service::discovery::v3::DiscoveryResponse>&& responses) {
+  for (auto& response : responses) {
+    const std::string type_url = response.type_url();
+    handed_over_responses_[type_url] = std::move(response);
+    // The types subscribed to already are applied too.
+    auto it = api_state_.find(type_url);
+    if (it != api_state_.end() && it->second->subscribed_) {
+      scheduleSnapshot(type_url);
+    }
+  }
+}
+
+void GrpcMuxImpl::scheduleSnapshot(const std::string& type_url) {
+  if (apply_snapshots_ == nullptr) {
+    apply_snapshots_ = dispatcher_.createSchedulableCallback([this]() { applySnapshots(); });
+  }
+  snapshot_types_.push_back(type_url);
+  apply_snapshots_->scheduleCallbackCurrentIteration();
+}
+
+void GrpcMuxImpl::applySnapshots() {
+  // Applying the snapshot of a type may subscribe to other types, whose snapshots are applied in
+  // turn.
+  while (!snapshot_types_.empty()) {
+    const std::string type_url = snapshot_types_.front();
+    snapshot_types_.pop_front();
+    std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse> snapshot;
+    auto handed_over = handed_over_responses_.find(type_url);
+    if (handed_over != handed_over_responses_.end()) {
+      snapshot = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>(
+          std::move(handed_over->second));
+      handed_over_responses_.erase(handed_over);
+    }
+    ApiState& api_state = apiStateFor(type_url);
+    // The management server has updated the type already.
+    if (api_state.watches_.empty() || !api_state.request_.version_info().empty()) {
+      continue;
+    }
+    if (snapshot == nullptr && snapshot_store_ != nullptr) {
+      snapshot = snapshot_store_->load(type_url);
+    }
+    if (snapshot == nullptr) {
+      continue;
+    }
+    ENVOY_LOG(info, "Applying the snapshot of {} at version {}", type_url,
+              snapshot->version_info());
+    applyResponse(type_url, *snapshot, true);
+  }
+}
+
 void GrpcMuxImpl::onWriteable() { drainRequests(); }
 
 void GrpcMuxImpl::onStreamEstablished() {
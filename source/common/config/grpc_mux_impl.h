@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <list>
 #include <memory>
 #include <queue>
 
@@ -19,10 +20,14 @@
 #include "common/common/utility.h"
 #include "common/config/api_version.h"
 #include "common/config/grpc_stream.h"
+#include "common/config/parallel_resource_decoder.h"
+#include "common/config/resource_decode_cache.h"
+#include "common/config/resource_snapshot_store.h"
 #include "common/config/ttl.h"
 #include "common/config/utility.h"
 #include "common/runtime/runtime_features.h"
 
+#include "absl/container/btree_map.h"
 #include "absl/container/node_hash_map.h"
 
 namespace Envoy {
@@ -56,6 +61,36 @@ public:
     NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
   }
 
+  std::vector<envoy::service::discovery::v3::DiscoveryResponse> handoffResponses() override;
+  void applyHandoffResponses(
+      std::vector<envoy::service::discovery::v3::DiscoveryResponse>&& responses) override;
+
+  /**
+   * Predecodes the resources of large discovery responses on several threads before the main
+   * thread finishes decoding and applies them.
+   * @param thread_factory supplies the factory of the decoding threads.
+   */
+  void enableParallelDecoding(Thread::ThreadFactory& thread_factory) {
+    parallel_decoder_ = std::make_unique<ParallelResourceDecoder>(
+        thread_factory, ParallelResourceDecoder::defaultMaxThreads());
+  }
+
+  /**
+   * Persists the resources of each type that the accepted responses left current in a directory,
+   * and applies the persisted resources of each type once it is subscribed to, unless the
+   * management server has updated the type already. The management server is then told the version
+   * of the applied snapshot.
+   * @param file_system supplies the file system of the directory.
+   * @param directory supplies the directory of the snapshots.
+   */
+  void enableSnapshots(Filesystem::Instance& file_system, const std::string& directory);
+
+  /**
+   * Keeps the resources of each type that the accepted responses left current in memory, to be
+   * returned by handoffResponses().
+   */
+  void enableHandoff() { keep_handoff_responses_ = true; }
+
   void handleDiscoveryResponse(
       std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& message);
 
@@ -63,9 +98,8 @@ public:
   void onStreamEstablished() override;
   void onEstablishmentFailure() override;
   void registerVersionedTypeUrl(const std::string& type_url);
-  void
-  onDiscoveryResponse(std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& message,
-                      ControlPlaneStats& control_plane_stats) override;
+  void onDiscoveryResponse(const envoy::service::discovery::v3::DiscoveryResponse& message,
+                           ControlPlaneStats& control_plane_stats) override;
   void onWriteable() override;
 
   GrpcStream<envoy::service::discovery::v3::DiscoveryRequest,
@@ -135,13 +169,35 @@ private:
     // Has this API been tracked in subscriptions_?
     bool subscribed_{};
     TtlManager ttl_;
+    // The messages decoded from the resources of the last accepted update.
+    ResourceDecodeCache decode_cache_;
+  };
+
+  // The resources of a type that the accepted responses left current, by name.
+  struct RetainedResources {
+    envoy::service::discovery::v3::DiscoveryResponse toResponse() const;
+
+    std::string type_url_;
+    std::string version_info_;
+    absl::btree_map<std::string, ProtobufWkt::Any> resources_;
   };
 
+  bool retainsResources() const { return keep_handoff_responses_ || snapshot_store_ != nullptr; }
   bool isHeartbeatResource(const std::string& type_url, const DecodedResource& resource) {
     return !resource.hasResource() &&
            resource.version() == apiStateFor(type_url).request_.version_info();
   }
   void expiryCallback(const std::string& type_url, const std::vector<std::string>& expired);
+  void applyResponse(const std::string& type_url,
+                     const envoy::service::discovery::v3::DiscoveryResponse& message,
+                     bool from_snapshot);
+  // Merges the resources of an accepted response, by name, into the retained resources of its type.
+  void retainResources(const std::string& type_url,
+                       const envoy::service::discovery::v3::DiscoveryResponse& message,
+                       const std::vector<std::pair<std::string, const ProtobufWkt::Any*>>& updated,
+                       RetainedResources& retained);
+  void applySnapshots();
+  void scheduleSnapshot(const std::string& type_url);
   // Request queue management logic.
   void queueDiscoveryRequest(const std::string& queue_item);
 
@@ -168,6 +224,19 @@ private:
 
   Event::Dispatcher& dispatcher_;
   bool enable_type_url_downgrade_and_upgrade_;
+  const bool memoize_resource_decoding_;
+  ParallelResourceDecoderPtr parallel_decoder_;
+  ResourceSnapshotStorePtr snapshot_store_;
+  bool keep_handoff_responses_{};
+  // The retained resources of each type, kept when the handoff or the snapshots are enabled.
+  absl::node_hash_map<std::string, RetainedResources> retained_resources_;
+  // The responses handed over by the parent process, which are yet to be applied. They take
+  // precedence over the snapshots of the snapshot store.
+  absl::node_hash_map<std::string, envoy::service::discovery::v3::DiscoveryResponse>
+      handed_over_responses_;
+  // The types whose snapshots are yet to be applied, in the order they were subscribed to.
+  std::list<std::string> snapshot_types_;
+  Event::SchedulableCallbackPtr apply_snapshots_;
 };
 
 using GrpcMuxImplPtr = std::unique_ptr<GrpcMuxImpl>;
@@ -193,10 +262,16 @@ public:
     NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
   }
 
+  std::vector<envoy::service::discovery::v3::DiscoveryResponse> handoffResponses() override {
+    return {};
+  }
+  void applyHandoffResponses(
+      std::vector<envoy::service::discovery::v3::DiscoveryResponse>&&) override {}
+
   void onWriteable() override {}
   void onStreamEstablished() override {}
   void onEstablishmentFailure() override {}
-  void onDiscoveryResponse(std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&&,
+  void onDiscoveryResponse(const envoy::service::discovery::v3::DiscoveryResponse&,
                            ControlPlaneStats&) override {}
 };
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 
@@ -7,6 +8,7 @@
 #include "envoy/config/grpc_mux.h"
 #include "envoy/grpc/async_client.h"
 
+#include "common/buffer/zero_copy_input_stream_impl.h"
 #include "common/common/backoff_strategy.h"
 #include "common/common/token_bucket_impl.h"
 #include "common/config/utility.h"
@@ -83,13 +85,28 @@ public:
   }
 
   void onReceiveMessage(ResponseProtoPtr<ResponseProto>&& message) override {
-    // Reset here so that it starts with fresh backoff interval on next disconnect.
-    backoff_strategy_->reset();
-    // Sometimes during hot restarts this stat's value becomes inconsistent and will continue to
-    // have 0 until it is reconnected. Setting here ensures that it is consistent with the state of
-    // management server connection.
-    control_plane_stats_.connected_state_.set(1);
-    callbacks_->onDiscoveryResponse(std::move(message), control_plane_stats_);
+    handleResponse(*message);
+  }
+
+  // Grpc::RawAsyncStreamCallbacks
+  bool onReceiveMessageRaw(Buffer::InstancePtr&& response) override {
+    // The response and its many small messages are allocated on an arena that is freed at once
+    // when the response has been handled, as the muxes copy out the resources they keep while they
+    // decode them. Most of the arena is the copy of the wire bytes, so it starts as large.
+    Protobuf::ArenaOptions options;
+    options.start_block_size = std::max<size_t>(response->length(), MinArenaBlockSize);
+    options.max_block_size = std::max<size_t>(response->length(), options.max_block_size);
+    Protobuf::Arena arena(options);
+    auto* message = Protobuf::Arena::CreateMessage<ResponseProto>(&arena);
+    if (response->length() > 0) {
+      Buffer::ZeroCopyInputStreamImpl stream(std::move(response));
+      if (!message->ParseFromZeroCopyStream(&stream)) {
+        return false;
+      }
+    }
+    handleResponse(*message);
+    control_plane_stats_.response_arena_bytes_.recordValue(arena.SpaceAllocated());
+    return true;
   }
 
   void onReceiveTrailingMetadata(Http::ResponseTrailerMapPtr&& metadata) override {
@@ -132,6 +149,18 @@ public:
   }
 
 private:
+  static constexpr size_t MinArenaBlockSize = 256;
+
+  void handleResponse(const ResponseProto& message) {
+    // Reset here so that it starts with fresh backoff interval on next disconnect.
+    backoff_strategy_->reset();
+    // Sometimes during hot restarts this stat's value becomes inconsistent and will continue to
+    // have 0 until it is reconnected. Setting here ensures that it is consistent with the state of
+    // management server connection.
+    control_plane_stats_.connected_state_.set(1);
+    callbacks_->onDiscoveryResponse(message, control_plane_stats_);
+  }
+
   void setRetryTimer() {
     retry_timer_->enableTimer(std::chrono::milliseconds(backoff_strategy_->nextBackOffMs()));
   }
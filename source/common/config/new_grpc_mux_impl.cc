@@ -63,14 +63,13 @@ void NewGrpcMuxImpl::registerVersionedTypeUrl(const std::string& type_url) {
 }
 
 void NewGrpcMuxImpl::onDiscoveryResponse(
-    std::unique_ptr<envoy::service::discovery::v3::DeltaDiscoveryResponse>&& message,
-    ControlPlaneStats&) {
-  ENVOY_LOG(debug, "Received DeltaDiscoveryResponse for {} at version {}", message->type_url(),
-            message->system_version_info());
-  auto sub = subscriptions_.find(message->type_url());
+    const envoy::service::discovery::v3::DeltaDiscoveryResponse& message, ControlPlaneStats&) {
+  ENVOY_LOG(debug, "Received DeltaDiscoveryResponse for {} at version {}", message.type_url(),
+            message.system_version_info());
+  auto sub = subscriptions_.find(message.type_url());
   // If this type url is not watched, try another version type url.
   if (enable_type_url_downgrade_and_upgrade_ && sub == subscriptions_.end()) {
-    const std::string& type_url = message->type_url();
+    const std::string& type_url = message.type_url();
     registerVersionedTypeUrl(type_url);
     TypeUrlMap& type_url_map = typeUrlMap();
     if (type_url_map.find(type_url) != type_url_map.end()) {
@@ -81,11 +80,11 @@ void NewGrpcMuxImpl::onDiscoveryResponse(
     ENVOY_LOG(warn,
               "Dropping received DeltaDiscoveryResponse (with version {}) for non-existent "
               "subscription {}.",
-              message->system_version_info(), message->type_url());
+              message.system_version_info(), message.type_url());
     return;
   }
 
-  kickOffAck(sub->second->sub_state_.handleResponse(*message));
+  kickOffAck(sub->second->sub_state_.handleResponse(message));
   Memory::Utils::tryShrinkHeap();
 }
 
@@ -194,11 +193,21 @@ void NewGrpcMuxImpl::removeWatch(const std::string& type_url, Watch* watch) {
 
 void NewGrpcMuxImpl::addSubscription(const std::string& type_url,
                                      const bool use_namespace_matching) {
-  subscriptions_.emplace(type_url, std::make_unique<SubscriptionStuff>(
-                                       type_url, local_info_, use_namespace_matching, dispatcher_));
+  auto subscription = std::make_unique<SubscriptionStuff>(type_url, local_info_,
+                                                          use_namespace_matching, dispatcher_);
+  subscription->watch_map_.setParallelDecoder(parallel_decoder_.get());
+  subscriptions_.emplace(type_url, std::move(subscription));
   subscription_ordering_.emplace_back(type_url);
 }
 
+void NewGrpcMuxImpl::enableParallelDecoding(Thread::ThreadFactory& thread_factory) {
+  parallel_decoder_ = std::make_unique<ParallelResourceDecoder>(
+      thread_factory, ParallelResourceDecoder::defaultMaxThreads());
+  for (auto& [type_url, subscription] : subscriptions_) {
+    subscription->watch_map_.setParallelDecoder(parallel_decoder_.get());
+  }
+}
+
 void NewGrpcMuxImpl::trySendDiscoveryRequests() {
   while (true) {
     // Do any of our subscriptions even want to send a request?
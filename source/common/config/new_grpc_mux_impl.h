@@ -46,14 +46,27 @@ public:
   void requestOnDemandUpdate(const std::string& type_url,
                              const std::set<std::string>& for_update) override;
 
+  // Delta updates are not handed over on hot restart.
+  std::vector<envoy::service::discovery::v3::DiscoveryResponse> handoffResponses() override {
+    return {};
+  }
+  void applyHandoffResponses(
+      std::vector<envoy::service::discovery::v3::DiscoveryResponse>&&) override {}
+
   ScopedResume pause(const std::string& type_url) override;
   ScopedResume pause(const std::vector<std::string> type_urls) override;
 
   void registerVersionedTypeUrl(const std::string& type_url);
 
-  void onDiscoveryResponse(
-      std::unique_ptr<envoy::service::discovery::v3::DeltaDiscoveryResponse>&& message,
-      ControlPlaneStats& control_plane_stats) override;
+  /**
+   * Predecodes the added resources of large discovery responses on several threads before the main
+   * thread finishes decoding and applies them.
+   * @param thread_factory supplies the factory of the decoding threads.
+   */
+  void enableParallelDecoding(Thread::ThreadFactory& thread_factory);
+
+  void onDiscoveryResponse(const envoy::service::discovery::v3::DeltaDiscoveryResponse& message,
+                           ControlPlaneStats& control_plane_stats) override;
 
   void onStreamEstablished() override;
 
@@ -158,6 +171,7 @@ private:
   Event::Dispatcher& dispatcher_;
 
   const bool enable_type_url_downgrade_and_upgrade_;
+  ParallelResourceDecoderPtr parallel_decoder_;
 };
 
 using NewGrpcMuxImplPtr = std::unique_ptr<NewGrpcMuxImpl>;
@@ -2,6 +2,7 @@
 
 #include "envoy/config/subscription.h"
 
+#include "common/protobuf/type_util.h"
 #include "common/protobuf/utility.h"
 
 namespace Envoy {
@@ -24,6 +25,31 @@ public:
     return typed_message;
   }
 
+  ProtobufTypes::MessagePtr predecodeResource(const ProtobufWkt::Any& resource) override {
+    // Resources of an earlier version are upgraded by decodeResource(), which warns about them on
+    // the main thread.
+    if (TypeUtil::typeUrlToDescriptorFullName(resource.type_url()) !=
+        Current::descriptor()->full_name()) {
+      return nullptr;
+    }
+    auto typed_message = std::make_unique<Current>();
+    // Invalid resources are decoded again by decodeResource(), which throws the same exception as
+    // without predecoding.
+    std::string err;
+    if (!resource.UnpackTo(typed_message.get()) || !Validate(*typed_message, &err)) {
+      return nullptr;
+    }
+    return typed_message;
+  }
+
+  void finishDecodeResource(const Protobuf::Message& resource) override {
+    // The deprecated and unknown fields are reported through the validation visitor and checked
+    // against the runtime, which are only safe to use on the main thread.
+    if (!validation_visitor_.skipValidation()) {
+      MessageUtil::checkForUnexpectedFields(resource, validation_visitor_);
+    }
+  }
+
   std::string resourceName(const Protobuf::Message& resource) override {
     return MessageUtil::getStringField(resource, name_field_);
   }
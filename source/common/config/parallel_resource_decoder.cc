@@ -0,0 +1,49 @@
+#include "common/config/parallel_resource_decoder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace Envoy {
+namespace Config {
+
+ParallelResourceDecoder::ParallelResourceDecoder(Thread::ThreadFactory& thread_factory,
+                                                 uint32_t max_threads)
+    : thread_factory_(thread_factory), max_threads_(max_threads) {}
+
+uint32_t ParallelResourceDecoder::defaultMaxThreads() {
+  return std::clamp<uint32_t>(std::thread::hardware_concurrency(), 1, MaxThreads);
+}
+
+std::vector<ProtobufTypes::MessagePtr>
+ParallelResourceDecoder::predecode(OpaqueResourceDecoder& resource_decoder,
+                                   const std::vector<const ProtobufWkt::Any*>& resources) {
+  const uint32_t num_threads =
+      std::min<size_t>(max_threads_, resources.size() / MinResourcesPerThread);
+  if (num_threads < 2) {
+    return {};
+  }
+
+  std::vector<ProtobufTypes::MessagePtr> messages(resources.size());
+  std::atomic<size_t> next{0};
+  auto predecode_resources = [&resource_decoder, &resources, &messages, &next]() {
+    for (size_t i = next++; i < resources.size(); i = next++) {
+      messages[i] = resource_decoder.predecodeResource(*resources[i]);
+    }
+  };
+  // The calling thread predecodes resources too.
+  std::vector<Thread::ThreadPtr> threads;
+  threads.reserve(num_threads - 1);
+  for (uint32_t i = 1; i < num_threads; ++i) {
+    threads.push_back(
+        thread_factory_.createThread(predecode_resources, Thread::Options{"xds_decode"}));
+  }
+  predecode_resources();
+  for (const Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  return messages;
+}
+
+} // namespace Config
+} // namespace Envoy
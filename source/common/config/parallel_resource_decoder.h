@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "envoy/config/subscription.h"
+#include "envoy/thread/thread.h"
+
+#include "common/protobuf/protobuf.h"
+
+namespace Envoy {
+namespace Config {
+
+/**
+ * Predecodes the resources of large xDS updates on several threads with
+ * OpaqueResourceDecoder::predecodeResource(), so that the main thread only finishes decoding them
+ * before it applies them. The threads are started for each update and joined before predecode()
+ * returns, which keeps the order in which the updates are applied and rejected unchanged.
+ */
+class ParallelResourceDecoder {
+public:
+  // The minimum number of resources that each thread predecodes, as smaller updates are decoded
+  // faster than threads start.
+  static constexpr uint32_t MinResourcesPerThread = 128;
+  // The maximum number of threads that predecode an update.
+  static constexpr uint32_t MaxThreads = 8;
+
+  /**
+   * @param thread_factory supplies the factory of the decoding threads.
+   * @param max_threads supplies the maximum number of threads, including the calling thread, that
+   *        predecode an update.
+   */
+  ParallelResourceDecoder(Thread::ThreadFactory& thread_factory, uint32_t max_threads);
+
+  /**
+   * @return uint32_t the number of CPUs, up to MaxThreads.
+   */
+  static uint32_t defaultMaxThreads();
+
+  /**
+   * @param resource_decoder supplies the decoder of the resources.
+   * @param resources supplies the resources to predecode.
+   * @return std::vector<ProtobufTypes::MessagePtr> the predecoded message of each resource, or
+   *         nullptr for the resources that the main thread decodes with decodeResource(). Empty if
+   *         the resources are too few to be predecoded in parallel.
+   */
+  std::vector<ProtobufTypes::MessagePtr>
+  predecode(OpaqueResourceDecoder& resource_decoder,
+            const std::vector<const ProtobufWkt::Any*>& resources);
+
+private:
+  Thread::ThreadFactory& thread_factory_;
+  const uint32_t max_threads_;
+};
+
+using ParallelResourceDecoderPtr = std::unique_ptr<ParallelResourceDecoder>;
+
+} // namespace Config
+} // namespace Envoy
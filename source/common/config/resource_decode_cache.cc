@@ -0,0 +1,46 @@
+#include "common/config/resource_decode_cache.h"
+
+#include "envoy/service/discovery/v3/discovery.pb.h"
+
+#include "common/common/hash.h"
+
+namespace Envoy {
+namespace Config {
+
+uint64_t ResourceDecodeCache::hash(const ProtobufWkt::Any& resource) {
+  return HashUtil::xxHash64(resource.value(), HashUtil::xxHash64(resource.type_url()));
+}
+
+std::shared_ptr<const Protobuf::Message>
+ResourceDecodeCache::find(const ProtobufWkt::Any& resource) {
+  if (previous_.empty() || resource.Is<envoy::service::discovery::v3::Resource>()) {
+    return nullptr;
+  }
+  const uint64_t key = hash(resource);
+  const auto it = previous_.find(key);
+  // The bytes are compared, as a collision would otherwise apply the wrong resource.
+  if (it == previous_.end() || it->second->type_url_ != resource.type_url() ||
+      it->second->value_ != resource.value()) {
+    return nullptr;
+  }
+  current_.emplace(key, it->second);
+  return it->second->message_;
+}
+
+void ResourceDecodeCache::insert(const ProtobufWkt::Any& resource,
+                                 std::shared_ptr<const Protobuf::Message> message) {
+  if (resource.Is<envoy::service::discovery::v3::Resource>()) {
+    return;
+  }
+  // On a collision within the update the first resource is kept.
+  current_.emplace(hash(resource), std::make_shared<const Entry>(Entry{
+                                       resource.type_url(), resource.value(), std::move(message)}));
+}
+
+void ResourceDecodeCache::commit() {
+  previous_ = std::move(current_);
+  current_.clear();
+}
+
+} // namespace Config
+} // namespace Envoy
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/config/subscription.h"
+
+#include "common/protobuf/protobuf.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Config {
+
+/**
+ * Memoizes the messages decoded from the resources of the state of the world updates of an xDS
+ * type, keyed by the hash of their serialized bytes, so that the resources that an update resends
+ * unchanged are neither unpacked, upgraded nor validated again. The messages of the last accepted
+ * update are kept: the lookups and insertions of an update are committed once it is accepted, and
+ * aborted if it is rejected. Resources wrapped in a Resource are not memoized.
+ */
+class ResourceDecodeCache {
+public:
+  /**
+   * @param resource supplies the resource to look up.
+   * @return std::shared_ptr<const Protobuf::Message> the message decoded from the same bytes by the
+   *         last accepted update, or nullptr.
+   */
+  std::shared_ptr<const Protobuf::Message> find(const ProtobufWkt::Any& resource);
+
+  /**
+   * Memoizes the message decoded from a resource of the current update.
+   * @param resource supplies the resource.
+   * @param message supplies the message decoded from the resource.
+   */
+  void insert(const ProtobufWkt::Any& resource, std::shared_ptr<const Protobuf::Message> message);
+
+  /**
+   * Keeps the messages looked up and inserted since the last commit() or abort(), dropping the
+   * others.
+   */
+  void commit();
+
+  /**
+   * Drops the messages inserted since the last commit() or abort().
+   */
+  void abort() { current_.clear(); }
+
+  size_t size() const { return previous_.size(); }
+
+private:
+  struct Entry {
+    const std::string type_url_;
+    const std::string value_;
+    const std::shared_ptr<const Protobuf::Message> message_;
+  };
+  using EntrySharedPtr = std::shared_ptr<const Entry>;
+
+  static uint64_t hash(const ProtobufWkt::Any& resource);
+
+  // The entries of the last accepted update.
+  absl::flat_hash_map<uint64_t, EntrySharedPtr> previous_;
+  // The entries of the current update.
+  absl::flat_hash_map<uint64_t, EntrySharedPtr> current_;
+};
+
+} // namespace Config
+} // namespace Envoy
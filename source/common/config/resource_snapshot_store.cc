@@ -0,0 +1,103 @@
+#include "common/config/resource_snapshot_store.h"
+
+#include <cstdio>
+
+#include "envoy/common/exception.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/hash.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Config {
+
+ResourceSnapshotStore::ResourceSnapshotStore(Filesystem::Instance& file_system,
+                                             const std::string& directory)
+    : file_system_(file_system), directory_(directory) {}
+
+std::string ResourceSnapshotStore::path(const std::string& type_url) const {
+  std::string name = type_url;
+  for (char& c : name) {
+    if (!absl::ascii_isalnum(c) && c != '.') {
+      c = '_';
+    }
+  }
+  return absl::StrCat(directory_, "/", name, ".snapshot");
+}
+
+void ResourceSnapshotStore::save(const std::string& type_url,
+                                 const envoy::service::discovery::v3::DiscoveryResponse& response) {
+  envoy::service::discovery::v3::DiscoveryResponse snapshot;
+  snapshot.set_version_info(response.version_info());
+  snapshot.set_type_url(response.type_url());
+  *snapshot.mutable_resources() = response.resources();
+  const std::string payload = snapshot.SerializeAsString();
+
+  Buffer::OwnedImpl buffer;
+  buffer.writeLEInt<uint32_t>(MagicNumber);
+  buffer.writeLEInt<uint32_t>(FormatVersion);
+  buffer.writeLEInt<uint64_t>(HashUtil::xxHash64(payload));
+  buffer.add(payload);
+
+  const std::string snapshot_path = path(type_url);
+  const std::string temporary_path = snapshot_path + ".tmp";
+  std::remove(temporary_path.c_str());
+  static constexpr Filesystem::FlagSet flags{1 << Filesystem::File::Operation::Write |
+                                             1 << Filesystem::File::Operation::Create};
+  Filesystem::FilePtr file = file_system_.createFile(temporary_path);
+  const Api::IoCallBoolResult open_result = file->open(flags);
+  if (!open_result.rc_) {
+    ENVOY_LOG(warn, "Unable to open {} to save the snapshot of {}: {}", temporary_path, type_url,
+              open_result.err_->getErrorDetails());
+    return;
+  }
+  const std::string contents = buffer.toString();
+  const Api::IoCallSizeResult write_result = file->write(contents);
+  file->close();
+  if (write_result.rc_ != static_cast<ssize_t>(contents.size())) {
+    ENVOY_LOG(warn, "Unable to write the snapshot of {} to {}", type_url, temporary_path);
+    std::remove(temporary_path.c_str());
+    return;
+  }
+  if (std::rename(temporary_path.c_str(), snapshot_path.c_str()) != 0) {
+    ENVOY_LOG(warn, "Unable to rename {} to {}", temporary_path, snapshot_path);
+    std::remove(temporary_path.c_str());
+  }
+}
+
+std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>
+ResourceSnapshotStore::load(const std::string& type_url) {
+  const std::string snapshot_path = path(type_url);
+  if (!file_system_.fileExists(snapshot_path)) {
+    return nullptr;
+  }
+  std::string contents;
+  try {
+    contents = file_system_.fileReadToEnd(snapshot_path);
+  } catch (const EnvoyException& e) {
+    ENVOY_LOG(warn, "Unable to read the snapshot of {}: {}", type_url, e.what());
+    return nullptr;
+  }
+
+  Buffer::OwnedImpl buffer(contents);
+  if (buffer.length() < HeaderSize || buffer.peekLEInt<uint32_t>(0) != MagicNumber ||
+      buffer.peekLEInt<uint32_t>(4) != FormatVersion) {
+    ENVOY_LOG(warn, "Ignoring the snapshot of {} in {}, as its format is not supported", type_url,
+              snapshot_path);
+    return nullptr;
+  }
+  const absl::string_view payload = absl::string_view(contents).substr(HeaderSize);
+  auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+  if (buffer.peekLEInt<uint64_t>(8) != HashUtil::xxHash64(payload) ||
+      !response->ParseFromArray(payload.data(), payload.size())) {
+    ENVOY_LOG(warn, "Ignoring the snapshot of {} in {}, as it is corrupted", type_url,
+              snapshot_path);
+    return nullptr;
+  }
+  return response;
+}
+
+} // namespace Config
+} // namespace Envoy
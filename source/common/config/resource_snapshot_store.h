@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/filesystem/filesystem.h"
+#include "envoy/service/discovery/v3/discovery.pb.h"
+
+#include "common/common/logger.h"
+
+namespace Envoy {
+namespace Config {
+
+/**
+ * Persists the last accepted state of the world discovery response of each type in a directory,
+ * one file per type, so that a restarting server can apply them before the management server sends
+ * them again. Each file starts with a header of a magic number, the version of the format and the
+ * checksum of the serialized response that follows it, so that truncated, corrupted and
+ * incompatible files are ignored. Files are written to a temporary file that is then renamed, so
+ * that a crash while writing leaves the previous snapshot in place.
+ */
+class ResourceSnapshotStore : Logger::Loggable<Logger::Id::config> {
+public:
+  static constexpr uint32_t MagicNumber = 0x53445845; // "EXDS"
+  // Incremented on incompatible changes of the format.
+  static constexpr uint32_t FormatVersion = 1;
+  // The size of the magic number, format version and checksum.
+  static constexpr uint32_t HeaderSize = 16;
+
+  ResourceSnapshotStore(Filesystem::Instance& file_system, const std::string& directory);
+
+  /**
+   * Persists the resources and version of a response, replacing the snapshot of the type.
+   * Failures are logged.
+   * @param type_url supplies the type the response was accepted for.
+   * @param response supplies the accepted response.
+   */
+  void save(const std::string& type_url,
+            const envoy::service::discovery::v3::DiscoveryResponse& response);
+
+  /**
+   * @param type_url supplies the type to load the snapshot of.
+   * @return the response of the last snapshot of the type, or nullptr if there is none or it is
+   *         invalid.
+   */
+  std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>
+  load(const std::string& type_url);
+
+  /**
+   * @return std::string the path of the snapshot of a type.
+   */
+  std::string path(const std::string& type_url) const;
+
+private:
+  Filesystem::Instance& file_system_;
+  const std::string directory_;
+};
+
+using ResourceSnapshotStorePtr = std::unique_ptr<ResourceSnapshotStore>;
+
+} // namespace Config
+} // namespace Envoy
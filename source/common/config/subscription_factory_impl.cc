@@ -56,29 +56,32 @@ SubscriptionPtr SubscriptionFactoryImpl::subscriptionFromConfigSource(
           restMethod(type_url, transport_api_version), type_url, transport_api_version, callbacks,
           resource_decoder, stats, Utility::configSourceInitialFetchTimeout(config),
           validation_visitor_);
-    case envoy::config::core::v3::ApiConfigSource::GRPC:
+    case envoy::config::core::v3::ApiConfigSource::GRPC: {
+      auto grpc_mux = std::make_shared<Config::GrpcMuxImpl>(
+          local_info_,
+          Utility::factoryForGrpcApiConfigSource(cm_.grpcAsyncClientManager(), api_config_source,
+                                                 scope, true)
+              ->create(),
+          dispatcher_, sotwGrpcMethod(type_url, transport_api_version), transport_api_version,
+          api_.randomGenerator(), scope, Utility::parseRateLimitSettings(api_config_source),
+          api_config_source.set_node_on_first_message_only());
+      grpc_mux->enableParallelDecoding(api_.threadFactory());
       return std::make_unique<GrpcSubscriptionImpl>(
-          std::make_shared<Config::GrpcMuxImpl>(
-              local_info_,
-              Utility::factoryForGrpcApiConfigSource(cm_.grpcAsyncClientManager(),
-                                                     api_config_source, scope, true)
-                  ->create(),
-              dispatcher_, sotwGrpcMethod(type_url, transport_api_version), transport_api_version,
-              api_.randomGenerator(), scope, Utility::parseRateLimitSettings(api_config_source),
-              api_config_source.set_node_on_first_message_only()),
-          callbacks, resource_decoder, stats, type_url, dispatcher_,
+          std::move(grpc_mux), callbacks, resource_decoder, stats, type_url, dispatcher_,
           Utility::configSourceInitialFetchTimeout(config),
           /*is_aggregated*/ false);
+    }
     case envoy::config::core::v3::ApiConfigSource::DELTA_GRPC: {
+      auto grpc_mux = std::make_shared<Config::NewGrpcMuxImpl>(
+          Config::Utility::factoryForGrpcApiConfigSource(cm_.grpcAsyncClientManager(),
+                                                         api_config_source, scope, true)
+              ->create(),
+          dispatcher_, deltaGrpcMethod(type_url, transport_api_version), transport_api_version,
+          api_.randomGenerator(), scope, Utility::parseRateLimitSettings(api_config_source),
+          local_info_);
+      grpc_mux->enableParallelDecoding(api_.threadFactory());
       return std::make_unique<GrpcSubscriptionImpl>(
-          std::make_shared<Config::NewGrpcMuxImpl>(
-              Config::Utility::factoryForGrpcApiConfigSource(cm_.grpcAsyncClientManager(),
-                                                             api_config_source, scope, true)
-                  ->create(),
-              dispatcher_, deltaGrpcMethod(type_url, transport_api_version), transport_api_version,
-              api_.randomGenerator(), scope, Utility::parseRateLimitSettings(api_config_source),
-              local_info_),
-          callbacks, resource_decoder, stats, type_url, dispatcher_,
+          std::move(grpc_mux), callbacks, resource_decoder, stats, type_url, dispatcher_,
           Utility::configSourceInitialFetchTimeout(config), false);
     }
     default:
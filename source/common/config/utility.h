@@ -229,6 +229,7 @@ public:
     const std::string control_plane_prefix = "control_plane.";
     return {ALL_CONTROL_PLANE_STATS(POOL_COUNTER_PREFIX(scope, control_plane_prefix),
                                     POOL_GAUGE_PREFIX(scope, control_plane_prefix),
+                                    POOL_HISTOGRAM_PREFIX(scope, control_plane_prefix),
                                     POOL_TEXT_READOUT_PREFIX(scope, control_plane_prefix))};
   }
 
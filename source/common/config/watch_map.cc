@@ -148,7 +148,19 @@ void WatchMap::onConfigUpdate(
   // into the individual onConfigUpdate()s.
   std::vector<DecodedResourceImplPtr> decoded_resources;
   absl::flat_hash_map<Watch*, std::vector<DecodedResourceRef>> per_watch_added;
-  for (const auto& r : added_resources) {
+  std::vector<ProtobufTypes::MessagePtr> predecoded;
+  if (parallel_decoder_ != nullptr && !watches_.empty()) {
+    // All the watches are for the same resource type, so any of them decodes the resources.
+    std::vector<const ProtobufWkt::Any*> predecoded_resources;
+    predecoded_resources.reserve(added_resources.size());
+    for (const auto& r : added_resources) {
+      predecoded_resources.push_back(&r.resource());
+    }
+    predecoded =
+        parallel_decoder_->predecode((*watches_.begin())->resource_decoder_, predecoded_resources);
+  }
+  for (int i = 0; i < added_resources.size(); ++i) {
+    const auto& r = added_resources[i];
     const absl::flat_hash_set<Watch*>& interested_in_r = watchesInterestedIn(r.name());
     // If there are no watches, then we don't need to decode. If there are watches, they should all
     // be for the same resource type, so we can just use the callbacks of the first watch to decode.
@@ -156,7 +168,8 @@ void WatchMap::onConfigUpdate(
       continue;
     }
     decoded_resources.emplace_back(
-        new DecodedResourceImpl((*interested_in_r.begin())->resource_decoder_, r));
+        new DecodedResourceImpl((*interested_in_r.begin())->resource_decoder_, r,
+                                predecoded.empty() ? nullptr : std::move(predecoded[i])));
     for (const auto& interested_watch : interested_in_r) {
       per_watch_added[interested_watch].emplace_back(*decoded_resources.back());
     }
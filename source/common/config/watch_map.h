@@ -9,6 +9,7 @@
 
 #include "common/common/assert.h"
 #include "common/common/logger.h"
+#include "common/config/parallel_resource_decoder.h"
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
@@ -62,6 +63,11 @@ class WatchMap : public UntypedConfigUpdateCallbacks, public Logger::Loggable<Lo
 public:
   WatchMap(const bool use_namespace_matching) : use_namespace_matching_(use_namespace_matching) {}
 
+  // Predecodes the resources of large updates with the given decoder, if not null.
+  void setParallelDecoder(ParallelResourceDecoder* parallel_decoder) {
+    parallel_decoder_ = parallel_decoder;
+  }
+
   // Adds 'callbacks' to the WatchMap, with every possible resource being watched.
   // (Use updateWatchInterest() to narrow it down to some specific names).
   // Returns the newly added watch, to be used with updateWatchInterest and removeWatch.
@@ -123,6 +129,7 @@ private:
   absl::flat_hash_map<std::string, absl::flat_hash_set<Watch*>> watch_interest_;
 
   const bool use_namespace_matching_;
+  ParallelResourceDecoder* parallel_decoder_{};
 };
 
 } // namespace Config
@@ -57,16 +57,19 @@ public:
   TagNameValues();
 
   /**
-   * Represents a tag extraction. This structure may be extended to
-   * allow for an faster pattern-matching engine to be used as an
-   * alternative to regexes, on an individual tag basis. Some of the
-   * tags, such as "_rq_(\\d)xx$", will probably stay as regexes.
+   * Represents a tag extraction. Tags whose values are whole tokens at fixed
+   * positions of the stat names are matched on the dot-separated tokens of the
+   * stat names, which is faster than matching regexes. Some of the tags, such as
+   * "_rq_(\\d)xx$", will probably stay as regexes.
    */
   struct Descriptor {
     const std::string name_;
     const std::string regex_;
     const std::string substr_;
     const Regex::Type re_type_;
+    // If not empty, the pattern of tokens the tag is extracted with instead of the regex.
+    // @see Stats::TagExtractorTokensImpl
+    const std::string tokens_;
   };
 
   // Cluster name tag
@@ -131,6 +134,7 @@ public:
 private:
   void addRegex(const std::string& name, const std::string& regex, const std::string& substr = "");
   void addRe2(const std::string& name, const std::string& regex, const std::string& substr = "");
+  void addTokenized(const std::string& name, const std::string& tokens);
 
   // Collection of tag descriptors.
   std::vector<Descriptor> descriptor_vec_;
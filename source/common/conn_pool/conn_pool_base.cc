@@ -9,6 +9,14 @@
 namespace Envoy {
 namespace ConnectionPool {
 
+namespace {
+// The connections of the pools of the calling thread, from the least to the most recently used.
+std::list<ActiveClient*>& threadConnections() {
+  static thread_local std::list<ActiveClient*> connections;
+  return connections;
+}
+} // namespace
+
 ConnPoolImplBase::ConnPoolImplBase(
     Upstream::HostConstSharedPtr host, Upstream::ResourcePriority priority,
     Event::Dispatcher& dispatcher, const Network::ConnectionSocket::OptionsSharedPtr& options,
@@ -44,6 +52,14 @@ bool ConnPoolImplBase::shouldCreateNewConnection(float global_preconnect_ratio)
     return pending_streams_.size() > connecting_stream_capacity_;
   }
 
+  // Keep the configured number of idle connections established ahead of demand, unless the pool
+  // is draining.
+  const uint32_t min_idle_connections = host_->cluster().perUpstreamMinIdleConnections();
+  if (min_idle_connections > 0 && keep_idle_connections_ && pending_streams_.empty() &&
+      drained_callbacks_.empty() && idleConnections() < min_idle_connections) {
+    return true;
+  }
+
   // If global preconnecting is on, and this connection is within the global
   // preconnect limit, preconnect.
   // We may eventually want to track preconnect_attempts to allow more preconnecting for
@@ -73,6 +89,16 @@ float ConnPoolImplBase::perUpstreamPreconnectRatio() const {
   }
 }
 
+uint32_t ConnPoolImplBase::idleConnections() const {
+  uint32_t idle_connections = connecting_clients_.size();
+  for (const ActiveClientPtr& client : ready_clients_) {
+    if (client->numActiveStreams() == 0) {
+      ++idle_connections;
+    }
+  }
+  return idle_connections;
+}
+
 void ConnPoolImplBase::tryCreateNewConnections() {
   // Somewhat arbitrarily cap the number of connections preconnected due to new
   // incoming connections. The preconnect ratio is capped at 3, so in steady
@@ -103,12 +129,16 @@ bool ConnPoolImplBase::tryCreateNewConnection(float global_preconnect_ratio) {
   // prevent pending streams being queued to this upstream with no way to be processed.
   if (can_create_connection ||
       (ready_clients_.empty() && busy_clients_.empty() && connecting_clients_.empty())) {
+    closeIdleConnectionsOverBudget();
     ENVOY_LOG(debug, "creating a new connection");
     ActiveClientPtr client = instantiateActiveClient();
     ASSERT(client->state_ == ActiveClient::State::CONNECTING);
     ASSERT(std::numeric_limits<uint64_t>::max() - connecting_stream_capacity_ >=
            client->effectiveConcurrentStreamLimit());
     ASSERT(client->real_host_description_);
+    // If the connecting capacity already covers the queued streams, this connection is created
+    // ahead of demand.
+    client->preconnected_ = pending_streams_.size() <= connecting_stream_capacity_;
     // Increase the connecting capacity to reflect the streams this connection can serve.
     state_.incrConnectingStreamCapacity(client->effectiveConcurrentStreamLimit());
     connecting_stream_capacity_ += client->effectiveConcurrentStreamLimit();
@@ -117,6 +147,34 @@ bool ConnPoolImplBase::tryCreateNewConnection(float global_preconnect_ratio) {
   return can_create_connection;
 }
 
+void ConnPoolImplBase::closeIdleConnectionsOverBudget() {
+  const uint64_t budget = Runtime::getInteger("envoy.upstream.connection_budget_per_worker", 0);
+  std::list<ActiveClient*>& connections = threadConnections();
+  if (budget == 0 || connections.size() < budget) {
+    return;
+  }
+
+  // Create a separate list of connections to close to avoid mutate-while-iterating problems. The
+  // connections of this pool are not closed, as it is about to create one.
+  const uint64_t excess = connections.size() - budget + 1;
+  std::vector<ActiveClient*> to_close;
+  for (ActiveClient* client : connections) {
+    if (to_close.size() == excess) {
+      break;
+    }
+    if (&client->parent_ != this && client->state_ == ActiveClient::State::READY &&
+        client->numActiveStreams() == 0 && !client->parent_.hasPendingStreams()) {
+      to_close.push_back(client);
+    }
+  }
+
+  for (ActiveClient* client : to_close) {
+    ENVOY_CONN_LOG(debug, "closing idle connection over the per worker budget", *client);
+    client->parent_.host()->cluster().stats().upstream_cx_idle_evicted_.inc();
+    client->close();
+  }
+}
+
 void ConnPoolImplBase::attachStreamToClient(Envoy::ConnectionPool::ActiveClient& client,
                                             AttachContext& context) {
   ASSERT(client.state_ == Envoy::ConnectionPool::ActiveClient::State::READY);
@@ -129,6 +187,17 @@ void ConnPoolImplBase::attachStreamToClient(Envoy::ConnectionPool::ActiveClient&
   } else {
     ENVOY_CONN_LOG(debug, "creating stream", client);
 
+    if (client.preconnected_) {
+      host_->cluster().stats().upstream_cx_preconnect_used_.inc();
+      client.preconnected_ = false;
+      if (client.preconnect_idle_timer_) {
+        client.preconnect_idle_timer_->disableTimer();
+      }
+    }
+
+    std::list<ActiveClient*>& connections = threadConnections();
+    connections.splice(connections.end(), connections, client.thread_connections_entry_);
+
     client.remaining_streams_--;
     if (client.remaining_streams_ == 0) {
       ENVOY_CONN_LOG(debug, "maximum streams per connection, DRAINING", client);
@@ -185,6 +254,7 @@ void ConnPoolImplBase::onStreamClosed(Envoy::ConnectionPool::ActiveClient& clien
 }
 
 ConnectionPool::Cancellable* ConnPoolImplBase::newStream(AttachContext& context) {
+  keep_idle_connections_ = true;
   if (!ready_clients_.empty()) {
     ActiveClient& client = *ready_clients_.front();
     ENVOY_CONN_LOG(debug, "using existing connection", client);
@@ -228,6 +298,11 @@ void ConnPoolImplBase::onUpstreamReady() {
     state_.decrPendingStreams(1);
     pending_streams_.pop_back();
   }
+
+  // Replace the idle connections the pending streams took.
+  if (host_->cluster().perUpstreamMinIdleConnections() > 0) {
+    tryCreateNewConnections();
+  }
 }
 
 std::list<ActiveClientPtr>& ConnPoolImplBase::owningList(ActiveClient::State state) {
@@ -333,6 +408,9 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
     client.connect_timer_->disableTimer();
     client.connect_timer_.reset();
   }
+  if (client.preconnect_idle_timer_) {
+    client.preconnect_idle_timer_->disableTimer();
+  }
 
   if (event == Network::ConnectionEvent::RemoteClose ||
       event == Network::ConnectionEvent::LocalClose) {
@@ -342,6 +420,10 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
     // The client died.
     ENVOY_CONN_LOG(debug, "client disconnected, failure reason: {}", client, failure_reason);
 
+    if (client.preconnected_) {
+      host_->cluster().stats().upstream_cx_preconnect_unused_.inc();
+    }
+
     Envoy::Upstream::reportUpstreamCxDestroy(host_, event);
     const bool incomplete_stream = client.closingWithIncompleteStream();
     if (incomplete_stream) {
@@ -351,6 +433,7 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
     if (client.state_ == ActiveClient::State::CONNECTING) {
       host_->cluster().stats().upstream_cx_connect_fail_.inc();
       host_->stats().cx_connect_fail_.inc();
+      keep_idle_connections_ = false;
 
       ConnectionPool::PoolFailureReason reason;
       if (client.timed_out_) {
@@ -385,8 +468,12 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
 
     client.state_ = ActiveClient::State::CLOSED;
 
-    // If we have pending streams and we just lost a connection we should make a new one.
-    if (!pending_streams_.empty()) {
+    // If we have pending streams and we just lost a connection we should make a new one. An
+    // established connection closed by the upstream or for being idle is replaced as well, if
+    // idle connections are kept ahead of demand.
+    if (!pending_streams_.empty() ||
+        ((event == Network::ConnectionEvent::RemoteClose || client.idle_timed_out_) &&
+         host_->cluster().perUpstreamMinIdleConnections() > 0)) {
       tryCreateNewConnections();
     }
   } else if (event == Network::ConnectionEvent::Connected) {
@@ -394,6 +481,15 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
     client.conn_connect_ms_.reset();
     ASSERT(client.state_ == ActiveClient::State::CONNECTING);
     transitionActiveClientState(client, ActiveClient::State::READY);
+    keep_idle_connections_ = true;
+    // Close the connections created ahead of demand which stay unused, so that the upstream
+    // does not close them first while they are handed out.
+    const auto idle_timeout = host_->cluster().idleTimeout();
+    if (client.preconnected_ && idle_timeout.has_value()) {
+      client.preconnect_idle_timer_ =
+          dispatcher_.createTimer([&client]() -> void { client.onPreconnectIdleTimeout(); });
+      client.preconnect_idle_timer_->enableTimer(idle_timeout.value());
+    }
 
     // At this point, for the mixed ALPN pool, the client may be deleted. Do not
     // refer to client after this point.
@@ -495,6 +591,7 @@ ActiveClient::ActiveClient(ConnPoolImplBase& parent, uint32_t lifetime_stream_li
   parent_.host()->cluster().stats().upstream_cx_total_.inc();
   parent_.host()->cluster().stats().upstream_cx_active_.inc();
   parent_.host()->cluster().resourceManager(parent_.priority()).connections().inc();
+  thread_connections_entry_ = threadConnections().insert(threadConnections().end(), this);
 }
 
 ActiveClient::~ActiveClient() { releaseResources(); }
@@ -512,9 +609,17 @@ void ActiveClient::releaseResources() {
     parent_.host()->cluster().stats().upstream_cx_active_.dec();
     parent_.host()->stats().cx_active_.dec();
     parent_.host()->cluster().resourceManager(parent_.priority()).connections().dec();
+    threadConnections().erase(thread_connections_entry_);
   }
 }
 
+void ActiveClient::onPreconnectIdleTimeout() {
+  ENVOY_CONN_LOG(debug, "preconnected connection idle timeout", *this);
+  parent_.host()->cluster().stats().upstream_cx_idle_timeout_.inc();
+  idle_timed_out_ = true;
+  close();
+}
+
 void ActiveClient::onConnectTimeout() {
   ENVOY_CONN_LOG(debug, "connect timeout", *this);
   parent_.host()->cluster().stats().upstream_cx_connect_timeout_.inc();
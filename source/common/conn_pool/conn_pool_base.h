@@ -43,6 +43,9 @@ public:
   // Called if the connection does not complete within the cluster's connectTimeout()
   void onConnectTimeout();
 
+  // Called if a preconnected connection serves no stream within the cluster's idleTimeout().
+  void onPreconnectIdleTimeout();
+
   // Returns the concurrent stream limit, accounting for if the total stream limit
   // is less than the concurrent stream limit.
   uint32_t effectiveConcurrentStreamLimit() const {
@@ -81,8 +84,15 @@ public:
   Stats::TimespanPtr conn_connect_ms_;
   Stats::TimespanPtr conn_length_;
   Event::TimerPtr connect_timer_;
+  Event::TimerPtr preconnect_idle_timer_;
   bool resources_released_{false};
   bool timed_out_{false};
+  bool idle_timed_out_{false};
+  // True if the connection was created ahead of demand and has not served a stream yet.
+  bool preconnected_{false};
+  // The entry of the connection in the connections of the thread, which are ordered from the least
+  // to the most recently used.
+  std::list<ActiveClient*>::iterator thread_connections_entry_;
 };
 
 // PendingStream is the base class tracking streams for which a connection has been created but not
@@ -196,6 +206,10 @@ protected:
   // if this is called by maybePreconnect()
   bool tryCreateNewConnection(float global_preconnect_ratio = 0);
 
+  // Closes the least recently used idle connections of the other pools of the thread, if the
+  // connections of the thread are at the per worker connection budget, to make room for a new one.
+  void closeIdleConnectionsOverBudget();
+
   // A helper function which determines if a canceled pending connection should
   // be closed as excess or not.
   bool connectingConnectionIsExcess() const;
@@ -206,6 +220,9 @@ protected:
 
   float perUpstreamPreconnectRatio() const;
 
+  // The number of connections which serve no stream, connecting or ready.
+  uint32_t idleConnections() const;
+
   ConnectionPool::Cancellable*
   addPendingStream(Envoy::ConnectionPool::PendingStreamPtr&& pending_stream) {
     LinkedList::moveIntoList(std::move(pending_stream), pending_streams_);
@@ -260,6 +277,11 @@ private:
   // The number of streams currently attached to clients.
   uint32_t num_active_streams_{0};
 
+  // False after a connection failed to connect, so that the idle connections kept ahead of demand
+  // are not retried in a loop against an unreachable upstream until a stream or a connection
+  // succeeds.
+  bool keep_idle_connections_{true};
+
   void onUpstreamReady();
   Event::SchedulableCallbackPtr upstream_ready_cb_;
 };
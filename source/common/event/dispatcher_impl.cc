@@ -46,7 +46,7 @@ DispatcherImpl::DispatcherImpl(const std::string& name, Buffer::WatermarkFactory
     : name_(name), api_(api), buffer_factory_(std::move(factory)),
       scheduler_(time_system.createScheduler(base_scheduler_, base_scheduler_)),
       deferred_delete_cb_(base_scheduler_.createSchedulableCallback(
-          [this]() -> void { clearDeferredDeleteList(); })),
+          [this]() -> void { deleteDeferred(true); })),
       post_cb_(base_scheduler_.createSchedulableCallback([this]() -> void { runPostCallbacks(); })),
       current_to_delete_(&to_delete_1_) {
   ASSERT(!name_.empty());
@@ -72,29 +72,55 @@ void DispatcherImpl::initializeStats(Stats::Scope& scope,
   post([this, &scope, effective_prefix] {
     stats_prefix_ = effective_prefix + "dispatcher";
     stats_ = std::make_unique<DispatcherStats>(
-        DispatcherStats{ALL_DISPATCHER_STATS(POOL_HISTOGRAM_PREFIX(scope, stats_prefix_ + "."))});
+        DispatcherStats{ALL_DISPATCHER_STATS(POOL_COUNTER_PREFIX(scope, stats_prefix_ + "."),
+                                             POOL_HISTOGRAM_PREFIX(scope, stats_prefix_ + "."))});
     base_scheduler_.initializeStats(stats_.get());
     ENVOY_LOG(debug, "running {} on thread {}", stats_prefix_, run_tid_.debugString());
   });
 }
 
 void DispatcherImpl::clearDeferredDeleteList() {
-  ASSERT(isThreadSafe());
-  std::vector<DeferredDeletablePtr>* to_delete = current_to_delete_;
+  // The callers rely on the objects deferred deleted so far to be destroyed on return.
+  deleteDeferred(false);
+}
 
-  size_t num_to_delete = to_delete->size();
-  if (deferred_deleting_ || !num_to_delete) {
+void DispatcherImpl::deleteDeferred(bool budgeted) {
+  ASSERT(isThreadSafe());
+  if (deferred_deleting_) {
     return;
   }
 
-  ENVOY_LOG(trace, "clearing deferred deletion list (size={})", num_to_delete);
+  // The objects left over by a previous budgeted pass are in the vector that is not current, and
+  // are destroyed before the ones deferred deleted since.
+  std::vector<DeferredDeletablePtr>* to_delete =
+      current_to_delete_ == &to_delete_1_ ? &to_delete_2_ : &to_delete_1_;
+  const bool leftover = !to_delete->empty();
+  if (!leftover) {
+    to_delete = current_to_delete_;
+    if (to_delete->empty()) {
+      return;
+    }
+    // Swap the current deletion vector so that if we do deferred delete while we are deleting, we
+    // use the other vector. We will get another callback to delete that vector.
+    current_to_delete_ = to_delete == &to_delete_1_ ? &to_delete_2_ : &to_delete_1_;
+  }
+
+  ENVOY_LOG(trace, "clearing deferred deletion list (size={})",
+            to_delete->size() - deferred_delete_next_);
 
-  // Swap the current deletion vector so that if we do deferred delete while we are deleting, we
-  // use the other vector. We will get another callback to delete that vector.
-  if (current_to_delete_ == &to_delete_1_) {
-    current_to_delete_ = &to_delete_2_;
-  } else {
-    current_to_delete_ = &to_delete_1_;
+  uint64_t max_items = 0;
+  std::chrono::microseconds budget{0};
+  if (budgeted && Runtime::LoaderSingleton::getExisting() != nullptr) {
+    const auto snapshot = Runtime::LoaderSingleton::getExisting()->threadsafeSnapshot();
+    max_items = snapshot->getInteger("envoy.dispatcher.deferred_delete_max_items", 0);
+    budget = std::chrono::microseconds(
+        snapshot->getInteger("envoy.dispatcher.deferred_delete_budget_us", 0));
+  }
+  const bool timed = stats_ != nullptr || budget.count() > 0;
+  const MonotonicTime start = timed ? api_.timeSource().monotonicTime() : MonotonicTime();
+  if (stats_ != nullptr) {
+    stats_->deferred_delete_queue_size_.recordValue(to_delete->size() - deferred_delete_next_ +
+                                                    (leftover ? current_to_delete_->size() : 0));
   }
 
   touchWatchdog();
@@ -103,12 +129,45 @@ void DispatcherImpl::clearDeferredDeleteList() {
   // Calling clear() on the vector does not specify which order destructors run in. We want to
   // destroy in FIFO order so just do it manually. This required 2 passes over the vector which is
   // not optimal but can be cleaned up later if needed.
-  for (size_t i = 0; i < num_to_delete; i++) {
+  const size_t first = deferred_delete_next_;
+  size_t i = first;
+  for (; i < to_delete->size(); i++) {
+    // Reading the clock is not free, so the time budget is only checked every few objects.
+    if ((max_items > 0 && i - first >= max_items) ||
+        (budget.count() > 0 && i > first && (i - first) % 16 == 0 &&
+         api_.timeSource().monotonicTime() - start >= budget)) {
+      break;
+    }
     (*to_delete)[i].reset();
   }
 
-  to_delete->clear();
+  if (i < to_delete->size()) {
+    // Leave the rest to the next iteration of the event loop, so that the events in between are
+    // not delayed by a burst of deferred deletes.
+    deferred_delete_next_ = i;
+    deferred_delete_cb_->scheduleCallbackNextIteration();
+  } else {
+    to_delete->clear();
+    deferred_delete_next_ = 0;
+  }
   deferred_deleting_ = false;
+
+  if (stats_ != nullptr) {
+    stats_->deferred_delete_us_.recordValue(
+        std::chrono::duration_cast<std::chrono::microseconds>(api_.timeSource().monotonicTime() -
+                                                              start)
+            .count());
+  }
+
+  if (leftover && !current_to_delete_->empty()) {
+    // The objects deferred deleted after the leftover ones may have been added while this pass was
+    // already scheduled.
+    if (budgeted) {
+      deferred_delete_cb_->scheduleCallbackNextIteration();
+    } else {
+      deleteDeferred(false);
+    }
+  }
 }
 
 Network::ServerConnectionPtr
@@ -225,14 +284,10 @@ SignalEventPtr DispatcherImpl::listenForSignal(signal_t signal_num, SignalCb cb)
 }
 
 void DispatcherImpl::post(std::function<void()> callback) {
-  bool do_post;
-  {
-    Thread::LockGuard lock(post_lock_);
-    do_post = post_callbacks_.empty();
-    post_callbacks_.push_back(callback);
-  }
-
-  if (do_post) {
+  post_callbacks_.push(std::move(callback));
+  // The exchange happens after the push, so that the callback is in the queue when either this
+  // post or a later run of post_cb_ drains it.
+  if (!post_scheduled_.exchange(true, std::memory_order_acq_rel)) {
     post_cb_->scheduleCallbackCurrentIteration();
   }
 }
@@ -262,29 +317,27 @@ void DispatcherImpl::runPostCallbacks() {
   // Clear the deferred delete list before running post callbacks to reduce non-determinism in
   // callback processing, and more easily detect if a scheduled post callback refers to one of the
   // objects that is being deferred deleted.
-  clearDeferredDeleteList();
-
-  std::list<std::function<void()>> callbacks;
-  {
-    // Take ownership of the callbacks under the post_lock_. The lock must be released before
-    // callbacks execute. Callbacks added after this transfer will re-arm post_cb_ and will execute
-    // later in the event loop.
-    Thread::LockGuard lock(post_lock_);
-    callbacks = std::move(post_callbacks_);
-    // post_callbacks_ should be empty after the move.
-    ASSERT(post_callbacks_.empty());
+  deleteDeferred(true);
+
+  // Clear post_scheduled_ before taking the callbacks, so that the callbacks posted from now on,
+  // including the ones posted by the callbacks below, re-arm post_cb_ and execute later in the
+  // event loop. The exchange synchronizes with the posts that set it, which makes their callbacks
+  // visible to the pops below.
+  post_scheduled_.exchange(false, std::memory_order_acq_rel);
+  std::vector<std::function<void()>> callbacks;
+  std::function<void()> popped;
+  while (post_callbacks_.pop(popped)) {
+    callbacks.push_back(std::move(popped));
   }
-  // It is important that the execution and deletion of the callback happen while post_lock_ is not
-  // held. Either the invocation or destructor of the callback can call post() on this dispatcher.
-  while (!callbacks.empty()) {
+  // Either the invocation or destructor of the callback can call post() on this dispatcher.
+  for (auto& callback : callbacks) {
     // Touch the watchdog before executing the callback to avoid spurious watchdog miss events when
     // executing a long list of callbacks.
     touchWatchdog();
     // Run the callback.
-    callbacks.front()();
-    // Pop the front so that the destructor of the callback that just executed runs before the next
-    // callback executes.
-    callbacks.pop_front();
+    callback();
+    // Reset the callback so that its destructor runs before the next callback executes.
+    callback = nullptr;
   }
 }
 
@@ -1,8 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
-#include <list>
 #include <memory>
 #include <vector>
 
@@ -15,6 +15,7 @@
 #include "envoy/stats/scope.h"
 
 #include "common/common/logger.h"
+#include "common/common/mpsc_queue.h"
 #include "common/common/thread.h"
 #include "common/event/libevent.h"
 #include "common/event/libevent_scheduler.h"
@@ -44,6 +45,9 @@ public:
   const std::string& name() override { return name_; }
   void registerWatchdog(const Server::WatchDogSharedPtr& watchdog,
                         std::chrono::milliseconds min_touch_interval) override;
+  void setSpinBudget(std::chrono::microseconds spin_budget) override {
+    base_scheduler_.setSpinBudget(spin_budget, api_.timeSource());
+  }
   TimeSource& timeSource() override { return api_.timeSource(); }
   void initializeStats(Stats::Scope& scope, const absl::optional<std::string>& prefix) override;
   void clearDeferredDeleteList() override;
@@ -126,6 +130,8 @@ private:
   TimerPtr createTimerInternal(TimerCb cb);
   void updateApproximateMonotonicTimeInternal();
   void runPostCallbacks();
+  // Destroys the deferred deleted objects, within the budget set by the runtime if budgeted.
+  void deleteDeferred(bool budgeted);
   // Helper used to touch the watchdog after most schedulable, fd, and timer callbacks.
   void touchWatchdog();
 
@@ -149,8 +155,13 @@ private:
   std::vector<DeferredDeletablePtr> to_delete_1_;
   std::vector<DeferredDeletablePtr> to_delete_2_;
   std::vector<DeferredDeletablePtr>* current_to_delete_;
-  Thread::MutexBasicLockable post_lock_;
-  std::list<std::function<void()>> post_callbacks_ ABSL_GUARDED_BY(post_lock_);
+  // The index of the first object left to destroy in the vector that is not current, after a pass
+  // that ran out of budget.
+  size_t deferred_delete_next_{};
+  MpscQueue<std::function<void()>> post_callbacks_;
+  // Whether post_cb_ is scheduled to run the post callbacks, so that a batch of posts schedules it
+  // once.
+  std::atomic<bool> post_scheduled_{};
   const ScopeTrackedObject* current_object_{};
   bool deferred_deleting_{};
   MonotonicTime approximate_monotonic_time_;
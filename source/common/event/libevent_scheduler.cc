@@ -10,6 +10,9 @@ namespace Envoy {
 namespace Event {
 
 namespace {
+// The number of spins after which the spin stats are flushed while the loop keeps spinning.
+constexpr uint64_t SpinStatsBatch = 1000;
+
 void recordTimeval(Stats::Histogram& histogram, const timeval& tv) {
   histogram.recordValue(tv.tv_sec * 1000000 + tv.tv_usec);
 }
@@ -57,9 +60,56 @@ void LibeventScheduler::run(Dispatcher::RunType mode) {
     flag = EVLOOP_NO_EXIT_ON_EMPTY;
     break;
   }
+  if (spin_budget_.count() > 0 && mode != Dispatcher::RunType::NonBlock) {
+    runSpinning(flag);
+    return;
+  }
   event_base_loop(libevent_.get(), flag);
 }
 
+void LibeventScheduler::runSpinning(int flags) {
+  // Spins through the iterations of the loop without blocking for as long as events keep arriving
+  // within the spin budget, so that the events are polled for rather than woken up for, and blocks
+  // once the loop has been idle for the spin budget.
+  MonotonicTime last_event = spin_time_source_->monotonicTime();
+  while (true) {
+    const bool spin = spin_time_source_->monotonicTime() - last_event < spin_budget_;
+    polled_events_ = false;
+    const int result =
+        event_base_loop(libevent_.get(), flags | EVLOOP_ONCE | (spin ? EVLOOP_NONBLOCK : 0));
+    if (spin) {
+      ++spins_;
+      if (polled_events_) {
+        ++spin_hits_;
+        last_event = spin_time_source_->monotonicTime();
+      }
+    } else {
+      ++blocks_;
+      last_event = spin_time_source_->monotonicTime();
+    }
+    if (result != 0 || event_base_got_exit(libevent_.get()) ||
+        event_base_got_break(libevent_.get())) {
+      break;
+    }
+    // The stats are flushed after each block, and in batches while the loop keeps spinning.
+    if (spins_ >= SpinStatsBatch || !spin) {
+      flushSpinStats();
+    }
+  }
+  flushSpinStats();
+}
+
+void LibeventScheduler::flushSpinStats() {
+  if (stats_ != nullptr) {
+    stats_->busy_poll_spins_.add(spins_);
+    stats_->busy_poll_spin_hits_.add(spin_hits_);
+    stats_->busy_poll_blocks_.add(blocks_);
+  }
+  spins_ = 0;
+  spin_hits_ = 0;
+  blocks_ = 0;
+}
+
 void LibeventScheduler::loopExit() { event_base_loopexit(libevent_.get(), nullptr); }
 
 void LibeventScheduler::registerOnPrepareCallback(OnPrepareCallback&& callback) {
@@ -70,6 +120,15 @@ void LibeventScheduler::registerOnPrepareCallback(OnPrepareCallback&& callback)
   evwatch_prepare_new(libevent_.get(), &onPrepareForCallback, this);
 }
 
+void LibeventScheduler::setSpinBudget(std::chrono::microseconds spin_budget,
+                                      TimeSource& time_source) {
+  if (spin_time_source_ == nullptr) {
+    evwatch_check_new(libevent_.get(), &onCheckForSpin, this);
+  }
+  spin_budget_ = spin_budget;
+  spin_time_source_ = &time_source;
+}
+
 void LibeventScheduler::initializeStats(DispatcherStats* stats) {
   stats_ = stats;
   // These are thread safe.
@@ -127,5 +186,12 @@ void LibeventScheduler::onCheckForStats(evwatch*, const evwatch_check_cb_info*,
   }
 }
 
+void LibeventScheduler::onCheckForSpin(evwatch*, const evwatch_check_cb_info*, void* arg) {
+  // `self` is `this`, passed in from evwatch_check_new.
+  auto self = static_cast<LibeventScheduler*>(arg);
+  self->polled_events_ = event_base_get_num_events(self->libevent_.get(),
+                                                   EVENT_BASE_COUNT_ACTIVE) > 0;
+}
+
 } // namespace Event
 } // namespace Envoy
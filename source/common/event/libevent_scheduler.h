@@ -1,7 +1,9 @@
 #pragma once
 
+#include <chrono>
 #include <functional>
 
+#include "envoy/common/time.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/schedulable_cb.h"
 #include "envoy/event/timer.h"
@@ -95,6 +97,14 @@ public:
    */
   void registerOnPrepareCallback(OnPrepareCallback&& callback);
 
+  /**
+   * Makes run() poll for events without blocking, for up to the spin budget after the last event,
+   * before it blocks until the next event. @see Dispatcher::setSpinBudget().
+   * @param spin_budget supplies how long to spin after the last event. Zero disables spinning.
+   * @param time_source supplies the time source that the spin budget is measured with.
+   */
+  void setSpinBudget(std::chrono::microseconds spin_budget, TimeSource& time_source);
+
   /**
    * Start writing stats once thread-local storage is ready to receive them (see
    * ThreadLocalStoreImpl::initializeThreading).
@@ -105,6 +115,10 @@ private:
   static void onPrepareForCallback(evwatch*, const evwatch_prepare_cb_info* info, void* arg);
   static void onPrepareForStats(evwatch*, const evwatch_prepare_cb_info* info, void* arg);
   static void onCheckForStats(evwatch*, const evwatch_check_cb_info*, void* arg);
+  static void onCheckForSpin(evwatch*, const evwatch_check_cb_info*, void* arg);
+  // Runs the loop one iteration at a time, without blocking while within the spin budget.
+  void runSpinning(int flags);
+  void flushSpinStats();
 
   static constexpr int flagsBasedOnEventType() {
     if constexpr (Event::PlatformDefaultTriggerType == FileTriggerType::Level) {
@@ -123,6 +137,13 @@ private:
   timeval prepare_time_{};   // timestamp immediately before polling
   timeval check_time_{};     // timestamp immediately after polling
   OnPrepareCallback callback_; // callback to be called from onPrepareForCallback()
+  std::chrono::microseconds spin_budget_{};
+  TimeSource* spin_time_source_{};
+  bool polled_events_{}; // whether polling found events in the current event loop iteration
+  // The spins and blocks not yet added to the stats, which are added in batches.
+  uint64_t spins_{};
+  uint64_t spin_hits_{};
+  uint64_t blocks_{};
 };
 
 } // namespace Event
@@ -34,7 +34,8 @@ class ScaledRangeTimerManagerImpl::RangeTimerImpl final : public Timer {
 public:
   RangeTimerImpl(ScaledTimerMinimum minimum, TimerCb callback, ScaledRangeTimerManagerImpl& manager)
       : minimum_(minimum), manager_(manager), callback_(std::move(callback)),
-        min_duration_timer_(manager.dispatcher_.createTimer([this] { onMinTimerComplete(); })) {}
+        min_duration_timer_(
+            manager.timer_wheel_.createTimer([this] { onMinTimerComplete(); })) {}
 
   ~RangeTimerImpl() override { disableTimer(); }
 
@@ -138,7 +139,7 @@ private:
 };
 
 ScaledRangeTimerManagerImpl::ScaledRangeTimerManagerImpl(Dispatcher& dispatcher)
-    : dispatcher_(dispatcher), scale_factor_(1.0) {}
+    : dispatcher_(dispatcher), timer_wheel_(dispatcher), scale_factor_(1.0) {}
 
 ScaledRangeTimerManagerImpl::~ScaledRangeTimerManagerImpl() {
   // Scaled timers created by the manager shouldn't outlive it. This is
@@ -5,6 +5,8 @@
 #include "envoy/event/scaled_range_timer_manager.h"
 #include "envoy/event/timer.h"
 
+#include "common/event/timer_wheel_impl.h"
+
 #include "absl/container/flat_hash_map.h"
 
 namespace Envoy {
@@ -114,6 +116,9 @@ private:
   void onQueueTimerFired(Queue& queue);
 
   Dispatcher& dispatcher_;
+  // Backs the timers of the range timers until they reach their min duration, as they are mostly
+  // disabled or enabled again before, e.g. for the idle timeouts of connections and streams.
+  TimerWheel timer_wheel_;
   UnitFloat scale_factor_;
   absl::flat_hash_set<std::unique_ptr<Queue>, Hash, Eq> queues_;
 };
@@ -0,0 +1,244 @@
+#include "common/event/timer_wheel_impl.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+#include "common/common/scope_tracker.h"
+#include "common/common/utility.h"
+
+namespace Envoy {
+namespace Event {
+
+class TimerWheel::WheelTimer final : public Timer {
+public:
+  WheelTimer(TimerWheel& wheel, TimerCb cb) : wheel_(wheel), cb_(std::move(cb)) { ASSERT(cb_); }
+  ~WheelTimer() override { disableTimer(); }
+
+  // Timer
+  void disableTimer() override {
+    if (slot_ != nullptr) {
+      wheel_.remove(*this);
+    }
+    object_ = nullptr;
+  }
+  void enableTimer(std::chrono::milliseconds ms, const ScopeTrackedObject* object) override {
+    enableHRTimer(ms, object);
+  }
+  void enableHRTimer(std::chrono::microseconds us, const ScopeTrackedObject* object) override {
+    if (us.count() < 0) {
+      ExceptionUtil::throwEnvoyException(
+          fmt::format("Negative duration passed to enableHRTimer(): {}", us.count()));
+    }
+    disableTimer();
+    object_ = object;
+    deadline_ = wheel_.deadlineTick(us);
+    wheel_.add(*this);
+  }
+  bool enabled() override { return slot_ != nullptr; }
+
+  void fire() {
+    if (object_ == nullptr) {
+      cb_();
+      return;
+    }
+    ScopeTrackerScopeState scope(object_, wheel_.dispatcher_);
+    object_ = nullptr;
+    cb_();
+  }
+
+  TimerWheel& wheel_;
+  const TimerCb cb_;
+  const ScopeTrackedObject* object_{};
+  uint64_t deadline_{};
+  // The slot the timer is linked into, if enabled.
+  Slot* slot_{};
+  WheelTimer* prev_{};
+  WheelTimer* next_{};
+};
+
+TimerWheel::TimerWheel(Dispatcher& dispatcher)
+    : dispatcher_(dispatcher), start_(dispatcher.timeSource().monotonicTime()) {
+  for (Level& level : levels_) {
+    for (uint32_t i = 0; i < NumSlots; ++i) {
+      level.slots_[i].occupied_word_ = &level.occupied_[i / 64];
+      level.slots_[i].occupied_bit_ = uint64_t(1) << (i % 64);
+    }
+  }
+}
+
+TimerWheel::~TimerWheel() {
+  // The timers hold a reference to the wheel.
+  ASSERT(num_timers_ == 0);
+}
+
+TimerPtr TimerWheel::createTimer(TimerCb cb) { return std::make_unique<WheelTimer>(*this, cb); }
+
+uint64_t TimerWheel::nowTick() const {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             dispatcher_.timeSource().monotonicTime() - start_)
+      .count();
+}
+
+uint64_t TimerWheel::deadlineTick(std::chrono::microseconds duration) const {
+  const auto deadline = std::chrono::duration_cast<std::chrono::microseconds>(
+                            dispatcher_.timeSource().monotonicTime() - start_) +
+                        duration;
+  return (deadline.count() + 999) / 1000;
+}
+
+void TimerWheel::add(WheelTimer& timer) {
+  ASSERT(dispatcher_.isThreadSafe());
+  // The slot of current_tick_ has fired already.
+  timer.deadline_ = std::max(timer.deadline_, current_tick_ + 1);
+  const uint32_t level = place(timer);
+  ++num_timers_;
+
+  // The timer fires or moves to a lower level at the start of its slot.
+  const uint32_t shift = level * SlotBits;
+  const uint64_t event_tick = level < NumLevels ? (timer.deadline_ >> shift) << shift
+                                                : ((current_tick_ >> shift) + 1) << shift;
+  if (event_tick < scheduled_tick_) {
+    schedule(event_tick);
+  }
+}
+
+void TimerWheel::remove(WheelTimer& timer) {
+  ASSERT(dispatcher_.isThreadSafe());
+  Slot& slot = *timer.slot_;
+  if (timer.prev_ != nullptr) {
+    timer.prev_->next_ = timer.next_;
+  } else {
+    slot.head_ = timer.next_;
+  }
+  if (timer.next_ != nullptr) {
+    timer.next_->prev_ = timer.prev_;
+  }
+  if (slot.head_ == nullptr && slot.occupied_word_ != nullptr) {
+    *slot.occupied_word_ &= ~slot.occupied_bit_;
+  }
+  timer.slot_ = nullptr;
+  timer.prev_ = nullptr;
+  timer.next_ = nullptr;
+  // The libevent timer is left scheduled, as finding the next event is not worth it for timers
+  // that are mostly disabled before they fire.
+  --num_timers_;
+}
+
+uint32_t TimerWheel::place(WheelTimer& timer) {
+  uint32_t level = 0;
+  for (; level < NumLevels; ++level) {
+    const uint32_t shift = (level + 1) * SlotBits;
+    if ((timer.deadline_ >> shift) == (current_tick_ >> shift)) {
+      break;
+    }
+  }
+  Slot* slot =
+      level < NumLevels ? &levels_[level].slots_[digit(timer.deadline_, level)] : &overflow_;
+  timer.slot_ = slot;
+  timer.prev_ = nullptr;
+  timer.next_ = slot->head_;
+  if (slot->head_ != nullptr) {
+    slot->head_->prev_ = &timer;
+  } else if (slot->occupied_word_ != nullptr) {
+    *slot->occupied_word_ |= slot->occupied_bit_;
+  }
+  slot->head_ = &timer;
+  return level;
+}
+
+TimerWheel::WheelTimer* TimerWheel::unlinkHead(Slot& slot) {
+  WheelTimer* timer = slot.head_;
+  if (timer == nullptr) {
+    return nullptr;
+  }
+  slot.head_ = timer->next_;
+  if (slot.head_ != nullptr) {
+    slot.head_->prev_ = nullptr;
+  } else if (slot.occupied_word_ != nullptr) {
+    *slot.occupied_word_ &= ~slot.occupied_bit_;
+  }
+  timer->slot_ = nullptr;
+  timer->next_ = nullptr;
+  return timer;
+}
+
+uint64_t TimerWheel::nextEventTick() const {
+  uint64_t next = UINT64_MAX;
+  if (overflow_.head_ != nullptr) {
+    next = ((current_tick_ >> (NumLevels * SlotBits)) + 1) << (NumLevels * SlotBits);
+  }
+  for (uint32_t level = 0; level < NumLevels; ++level) {
+    // The timers of a level are in the slots after the digit of current_tick_, as the timers of
+    // its slot have moved to lower levels or fired already.
+    const Level& wheel_level = levels_[level];
+    for (uint32_t slot = digit(current_tick_, level) + 1; slot < NumSlots;) {
+      uint64_t word = wheel_level.occupied_[slot / 64] >> (slot % 64);
+      if (word == 0) {
+        slot = (slot / 64 + 1) * 64;
+        continue;
+      }
+      while ((word & 1) == 0) {
+        word >>= 1;
+        ++slot;
+      }
+      const uint32_t shift = (level + 1) * SlotBits;
+      const uint64_t tick =
+          ((current_tick_ >> shift) << shift) | (uint64_t(slot) << (level * SlotBits));
+      next = std::min(next, tick);
+      break;
+    }
+  }
+  return next;
+}
+
+void TimerWheel::onTimer() {
+  scheduled_tick_ = UINT64_MAX;
+  const uint64_t now = nowTick();
+  for (uint64_t tick = nextEventTick(); tick <= now; tick = nextEventTick()) {
+    current_tick_ = tick;
+    // Move the timers of the slots that start at the tick to lower levels, from the highest level
+    // down, as a timer may move more than one level at once.
+    if ((tick & ((uint64_t(1) << (NumLevels * SlotBits)) - 1)) == 0) {
+      // The timers that are still too far go back to overflow_, so take them out first.
+      Slot overflow;
+      std::swap(overflow.head_, overflow_.head_);
+      while (WheelTimer* timer = unlinkHead(overflow)) {
+        place(*timer);
+      }
+    }
+    for (uint32_t level = NumLevels - 1; level > 0; --level) {
+      if ((tick & ((uint64_t(1) << (level * SlotBits)) - 1)) == 0) {
+        Slot& slot = levels_[level].slots_[digit(tick, level)];
+        while (WheelTimer* timer = unlinkHead(slot)) {
+          place(*timer);
+        }
+      }
+    }
+    // The callbacks may enable and disable any timer of the wheel, including the ones of the slot.
+    Slot& slot = levels_[0].slots_[digit(tick, 0)];
+    while (WheelTimer* timer = unlinkHead(slot)) {
+      --num_timers_;
+      timer->fire();
+    }
+  }
+
+  const uint64_t next = nextEventTick();
+  if (next < scheduled_tick_) {
+    schedule(next);
+  }
+}
+
+void TimerWheel::schedule(uint64_t tick) {
+  if (timer_ == nullptr) {
+    timer_ = dispatcher_.createTimer([this]() { onTimer(); });
+  }
+  scheduled_tick_ = tick;
+  const auto delay = start_ + std::chrono::milliseconds(tick) -
+                     dispatcher_.timeSource().monotonicTime();
+  // Round up, so that the ticks up to the scheduled one have elapsed when timer_ fires.
+  timer_->enableHRTimer(std::max(std::chrono::ceil<std::chrono::microseconds>(delay),
+                                 std::chrono::microseconds::zero()));
+}
+
+} // namespace Event
+} // namespace Envoy
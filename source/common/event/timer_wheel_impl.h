@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * Hierarchical timing wheel (Varghese and Lauck, "Hashed and Hierarchical Timing Wheels") of
+ * millisecond ticks, for dispatchers with many timers that are enabled and disabled much more
+ * often than they fire, like idle timeouts. Enabling and disabling a timer of the wheel links and
+ * unlinks it from the list of a slot, instead of adding and removing it from the heap of libevent,
+ * and all the timers of a wheel share a single libevent timer that fires at the next slot with
+ * timers. Timers fire at millisecond resolution, so that they behave like the timers of the
+ * dispatcher except for microsecond durations of enableHRTimer(), which are rounded up to the
+ * millisecond.
+ *
+ * A timer is placed in the level of the wheel of the most significant 8 bit digit in which its
+ * deadline differs from the current tick, and in the slot of that digit of its deadline. When the
+ * current tick reaches the start of a slot of a higher level, the timers of the slot are moved to
+ * lower levels, until they reach the first level and fire.
+ */
+class TimerWheel : NonCopyable {
+public:
+  explicit TimerWheel(Dispatcher& dispatcher);
+  ~TimerWheel();
+
+  /**
+   * Creates a timer of the wheel. The timer must be destroyed before the wheel, and used on the
+   * thread of the dispatcher only.
+   */
+  TimerPtr createTimer(TimerCb cb);
+
+private:
+  class WheelTimer;
+
+  static constexpr uint32_t SlotBits = 8;
+  static constexpr uint32_t NumSlots = 1 << SlotBits;
+  static constexpr uint32_t NumLevels = 4;
+
+  // A doubly linked list of the timers of a slot, which the timers link themselves into.
+  struct Slot {
+    WheelTimer* head_{};
+    // The bit of the slot in the occupancy bitmap of its level, if any.
+    uint64_t* occupied_word_{};
+    uint64_t occupied_bit_{};
+  };
+
+  struct Level {
+    std::array<Slot, NumSlots> slots_;
+    // Bit i is set when slots_[i] has timers.
+    std::array<uint64_t, NumSlots / 64> occupied_{};
+  };
+
+  static uint32_t digit(uint64_t tick, uint32_t level) {
+    return (tick >> (level * SlotBits)) & (NumSlots - 1);
+  }
+
+  uint64_t nowTick() const;
+  // Returns the tick at which a deadline expires, rounded up to a millisecond.
+  uint64_t deadlineTick(std::chrono::microseconds duration) const;
+  void add(WheelTimer& timer);
+  void remove(WheelTimer& timer);
+  // Links the timer into the slot of its deadline relative to current_tick_, and returns the level
+  // of the slot, which is NumLevels for overflow_.
+  uint32_t place(WheelTimer& timer);
+  WheelTimer* unlinkHead(Slot& slot);
+  // Returns the first tick after current_tick_ at which timers fire or move to lower levels, or
+  // UINT64_MAX when the wheel has no timer.
+  uint64_t nextEventTick() const;
+  void onTimer();
+  void schedule(uint64_t tick);
+
+  Dispatcher& dispatcher_;
+  const MonotonicTime start_;
+  // The tick up to which the wheel has fired the timers.
+  uint64_t current_tick_{};
+  std::array<Level, NumLevels> levels_;
+  // The timers whose deadline is too far for the last level, which are placed again each time
+  // the last level wraps around.
+  Slot overflow_;
+  uint64_t num_timers_{};
+  // Created on the first enabled timer.
+  TimerPtr timer_;
+  // The tick at which timer_ is scheduled to fire, or UINT64_MAX.
+  uint64_t scheduled_tick_{UINT64_MAX};
+};
+
+} // namespace Event
+} // namespace Envoy
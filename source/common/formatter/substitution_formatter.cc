@@ -1,6 +1,7 @@
 #include "common/formatter/substitution_formatter.h"
 
 #include <climits>
+#include <cmath>
 #include <cstdint>
 #include <regex>
 #include <string>
@@ -52,6 +53,72 @@ const std::regex& getNewlinePattern() { CONSTRUCT_ON_FIRST_USE(std::regex, "\n")
 template <class... Ts> struct StructFormatMapVisitor : Ts... { using Ts::operator()...; };
 template <class... Ts> StructFormatMapVisitor(Ts...) -> StructFormatMapVisitor<Ts...>;
 
+// Appends a string as a JSON string, escaping only what JSON requires to be.
+void appendJsonString(absl::string_view value, std::string& output) {
+  output.push_back('"');
+  for (const char c : value) {
+    switch (c) {
+    case '"':
+      output.append("\\\"");
+      break;
+    case '\\':
+      output.append("\\\\");
+      break;
+    case '\b':
+      output.append("\\b");
+      break;
+    case '\f':
+      output.append("\\f");
+      break;
+    case '\n':
+      output.append("\\n");
+      break;
+    case '\r':
+      output.append("\\r");
+      break;
+    case '\t':
+      output.append("\\t");
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        output.append(fmt::format("\\u{:04x}", static_cast<unsigned char>(c)));
+      } else {
+        output.push_back(c);
+      }
+    }
+  }
+  output.push_back('"');
+}
+
+// Appends a value as protobuf would serialize it, leaving the rare struct and list values to it.
+void appendJsonValue(const ProtobufWkt::Value& value, std::string& output) {
+  switch (value.kind_case()) {
+  case ProtobufWkt::Value::kStringValue:
+    appendJsonString(value.string_value(), output);
+    break;
+  case ProtobufWkt::Value::kBoolValue:
+    output.append(value.bool_value() ? "true" : "false");
+    break;
+  case ProtobufWkt::Value::kNumberValue: {
+    const double number = value.number_value();
+    // Integral values, the most common ones, are written without a fraction as protobuf does.
+    if (std::isfinite(number) && std::abs(number) < 9007199254740992.0 &&
+        number == static_cast<double>(static_cast<int64_t>(number))) {
+      absl::StrAppend(&output, static_cast<int64_t>(number));
+    } else {
+      output.append(MessageUtil::getJsonStringFromMessage(value, false, true));
+    }
+    break;
+  }
+  case ProtobufWkt::Value::kStructValue:
+  case ProtobufWkt::Value::kListValue:
+    output.append(MessageUtil::getJsonStringFromMessage(value, false, true));
+    break;
+  default:
+    output.append("null");
+  }
+}
+
 } // namespace
 
 const std::string SubstitutionFormatUtils::DEFAULT_FORMAT =
@@ -124,7 +191,8 @@ std::string FormatterImpl::format(const Http::RequestHeaderMap& request_headers,
   for (const FormatterProviderPtr& provider : providers_) {
     const auto bit = provider->format(request_headers, response_headers, response_trailers,
                                       stream_info, local_reply_body);
-    log_line += bit.value_or(empty_value_string_);
+    // Unlike value_or(), this does not copy the value before appending it.
+    log_line.append(bit.has_value() ? bit.value() : empty_value_string_);
   }
 
   return log_line;
@@ -135,11 +203,12 @@ std::string JsonFormatterImpl::format(const Http::RequestHeaderMap& request_head
                                       const Http::ResponseTrailerMap& response_trailers,
                                       const StreamInfo::StreamInfo& stream_info,
                                       absl::string_view local_reply_body) const {
-  const auto output_struct = struct_formatter_.format(
-      request_headers, response_headers, response_trailers, stream_info, local_reply_body);
-
-  const std::string log_line = MessageUtil::getJsonStringFromMessage(output_struct, false, true);
-  return absl::StrCat(log_line, "\n");
+  std::string log_line;
+  log_line.reserve(512);
+  struct_formatter_.formatJson(request_headers, response_headers, response_trailers, stream_info,
+                               local_reply_body, log_line);
+  log_line.push_back('\n');
+  return log_line;
 }
 
 StructFormatter::StructFormatMapWrapper
@@ -193,7 +262,7 @@ ProtobufWkt::Struct StructFormatter::format(const Http::RequestHeaderMap& reques
         for (const auto& provider : providers) {
           const auto bit = provider->format(request_headers, response_headers, response_trailers,
                                             stream_info, local_reply_body);
-          str += bit.value_or(empty_value);
+          str.append(bit.has_value() ? bit.value() : empty_value);
         }
         return ValueUtil::stringValue(str);
       };
@@ -214,6 +283,77 @@ ProtobufWkt::Struct StructFormatter::format(const Http::RequestHeaderMap& reques
   return struct_format_map_callback(struct_output_format_).struct_value();
 }
 
+void StructFormatter::formatJson(const Http::RequestHeaderMap& request_headers,
+                                 const Http::ResponseHeaderMap& response_headers,
+                                 const Http::ResponseTrailerMap& response_trailers,
+                                 const StreamInfo::StreamInfo& stream_info,
+                                 absl::string_view local_reply_body, std::string& output) const {
+  const std::string& empty_value =
+      omit_empty_values_ ? EMPTY_STRING : DefaultUnspecifiedValueString;
+  // Writes the value of the providers of a field, and returns false if the field is omitted.
+  const std::function<bool(const std::vector<FormatterProviderPtr>&)> providers_callback =
+      [&](const std::vector<FormatterProviderPtr>& providers) {
+        ASSERT(!providers.empty());
+        if (providers.size() == 1) {
+          const auto& provider = providers.front();
+          if (preserve_types_) {
+            const ProtobufWkt::Value value = provider->formatValue(
+                request_headers, response_headers, response_trailers, stream_info,
+                local_reply_body);
+            if (omit_empty_values_ && value.kind_case() == ProtobufWkt::Value::kNullValue) {
+              return false;
+            }
+            appendJsonValue(value, output);
+            return true;
+          }
+
+          const auto str = provider->format(request_headers, response_headers, response_trailers,
+                                            stream_info, local_reply_body);
+          if (!str.has_value()) {
+            if (omit_empty_values_) {
+              return false;
+            }
+            appendJsonString(DefaultUnspecifiedValueString, output);
+            return true;
+          }
+          appendJsonString(str.value(), output);
+          return true;
+        }
+        // Multiple providers forces string output.
+        std::string str;
+        for (const auto& provider : providers) {
+          const auto bit = provider->format(request_headers, response_headers, response_trailers,
+                                            stream_info, local_reply_body);
+          str.append(bit.has_value() ? bit.value() : empty_value);
+        }
+        appendJsonString(str, output);
+        return true;
+      };
+  const std::function<bool(const StructFormatter::StructFormatMapWrapper&)>
+      struct_format_map_callback = [&](const StructFormatter::StructFormatMapWrapper& format) {
+        StructFormatMapVisitor visitor{struct_format_map_callback, providers_callback};
+        output.push_back('{');
+        bool empty = true;
+        for (const auto& pair : *format.value_) {
+          // An omitted field is written out, then truncated away.
+          const size_t field_start = output.size();
+          if (!empty) {
+            output.push_back(',');
+          }
+          appendJsonString(pair.first, output);
+          output.push_back(':');
+          if (absl::visit(visitor, pair.second)) {
+            empty = false;
+          } else {
+            output.resize(field_start);
+          }
+        }
+        output.push_back('}');
+        return true;
+      };
+  struct_format_map_callback(struct_output_format_);
+}
+
 void SubstitutionFormatParser::parseCommandHeader(const std::string& token, const size_t start,
                                                   std::string& main_header,
                                                   std::string& alternative_header,
@@ -124,6 +124,16 @@ public:
                              const StreamInfo::StreamInfo& stream_info,
                              absl::string_view local_reply_body) const;
 
+  /**
+   * Appends the JSON serialization of the struct format() returns to output, without building
+   * the struct.
+   */
+  void formatJson(const Http::RequestHeaderMap& request_headers,
+                  const Http::ResponseHeaderMap& response_headers,
+                  const Http::ResponseTrailerMap& response_trailers,
+                  const StreamInfo::StreamInfo& stream_info, absl::string_view local_reply_body,
+                  std::string& output) const;
+
 private:
   struct StructFormatMapWrapper;
   using StructFormatMapValue =
@@ -1,5 +1,6 @@
 #include "common/grpc/codec.h"
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <memory>
@@ -11,6 +12,32 @@
 
 namespace Envoy {
 namespace Grpc {
+namespace {
+
+bool validFlags(uint8_t flags) { return (flags & ~GRPC_FH_COMPRESSED) == 0; }
+
+// Walks the frame headers of a buffer, from the state of a decoder, to find whether they are valid
+// without decoding the frames.
+class FrameValidator : public FrameInspector {
+public:
+  FrameValidator(State state, uint32_t length) {
+    state_ = state;
+    length_ = length;
+  }
+
+  bool valid() const { return valid_; }
+
+protected:
+  bool frameStart(uint8_t flags) override {
+    valid_ = validFlags(flags);
+    return valid_;
+  }
+
+private:
+  bool valid_{true};
+};
+
+} // namespace
 
 Encoder::Encoder() = default;
 
@@ -33,7 +60,15 @@ void Encoder::prependFrameHeader(uint8_t flags, Buffer::Instance& buffer) {
 bool Decoder::decode(Buffer::Instance& input, std::vector<Frame>& output) {
   decoding_error_ = false;
   output_ = &output;
-  inspect(input);
+  // The payloads of valid frames are moved out of the input, slice by slice, rather than copied.
+  // On a decoding error the frames before it are copied out instead, to leave the input unchanged.
+  FrameValidator validator(state_, length_);
+  validator.inspect(input);
+  if (validator.valid()) {
+    moveFrames(input);
+  } else {
+    inspect(input);
+  }
   output_ = nullptr;
   if (decoding_error_) {
     return false;
@@ -42,9 +77,32 @@ bool Decoder::decode(Buffer::Instance& input, std::vector<Frame>& output) {
   return true;
 }
 
+void Decoder::moveFrames(Buffer::Instance& input) {
+  while (input.length() > 0) {
+    if (state_ == State::Data) {
+      const uint64_t length = std::min<uint64_t>(length_, input.length());
+      frame_.data_->move(input, length);
+      length_ -= length;
+      if (length_ == 0) {
+        frameDataEnd();
+        state_ = State::FhFlag;
+      }
+      continue;
+    }
+    // Inspect the rest of the frame header, which ends in the Data state, or in the FhFlag state
+    // for an empty frame.
+    std::array<uint8_t, GRPC_FRAME_HEADER_SIZE> header;
+    const uint64_t length = std::min<uint64_t>(
+        GRPC_FRAME_HEADER_SIZE - static_cast<uint64_t>(state_), input.length());
+    input.copyOut(0, length, header.data());
+    input.drain(length);
+    inspectSlice(header.data(), length);
+  }
+}
+
 bool Decoder::frameStart(uint8_t flags) {
   // Unsupported flags.
-  if (flags & ~GRPC_FH_COMPRESSED) {
+  if (!validFlags(flags)) {
     decoding_error_ = true;
     return false;
   }
@@ -69,73 +127,81 @@ void Decoder::frameDataEnd() {
 uint64_t FrameInspector::inspect(const Buffer::Instance& data) {
   uint64_t delta = 0;
   for (const Buffer::RawSlice& slice : data.getRawSlices()) {
-    uint8_t* mem = reinterpret_cast<uint8_t*>(slice.mem_);
-    for (uint64_t j = 0; j < slice.len_;) {
-      uint8_t c = *mem;
-      switch (state_) {
-      case State::FhFlag:
-        if (!frameStart(c)) {
-          return delta;
-        }
-        count_ += 1;
-        delta += 1;
-        state_ = State::FhLen0;
-        mem++;
-        j++;
-        break;
-      case State::FhLen0:
-        length_ = static_cast<uint32_t>(c) << 24;
-        state_ = State::FhLen1;
-        mem++;
-        j++;
-        break;
-      case State::FhLen1:
-        length_ |= static_cast<uint32_t>(c) << 16;
-        state_ = State::FhLen2;
-        mem++;
-        j++;
-        break;
-      case State::FhLen2:
-        length_ |= static_cast<uint32_t>(c) << 8;
-        state_ = State::FhLen3;
-        mem++;
-        j++;
-        break;
-      case State::FhLen3:
-        length_ |= static_cast<uint32_t>(c);
-        frameDataStart();
-        if (length_ == 0) {
-          frameDataEnd();
-          state_ = State::FhFlag;
-        } else {
-          state_ = State::Data;
-        }
-        mem++;
-        j++;
-        break;
-      case State::Data:
-        uint64_t remain_in_buffer = slice.len_ - j;
-        if (remain_in_buffer <= length_) {
-          frameData(mem, remain_in_buffer);
-          mem += remain_in_buffer;
-          j += remain_in_buffer;
-          length_ -= remain_in_buffer;
-        } else {
-          frameData(mem, length_);
-          mem += length_;
-          j += length_;
-          length_ = 0;
-        }
-        if (length_ == 0) {
-          frameDataEnd();
-          state_ = State::FhFlag;
-        }
-        break;
-      }
+    const uint64_t count = count_;
+    const bool more = inspectSlice(reinterpret_cast<uint8_t*>(slice.mem_), slice.len_);
+    delta += count_ - count;
+    if (!more) {
+      return delta;
     }
   }
   return delta;
 }
 
+bool FrameInspector::inspectSlice(uint8_t* mem, uint64_t len) {
+  for (uint64_t j = 0; j < len;) {
+    uint8_t c = *mem;
+    switch (state_) {
+    case State::FhFlag:
+      if (!frameStart(c)) {
+        return false;
+      }
+      count_ += 1;
+      state_ = State::FhLen0;
+      mem++;
+      j++;
+      break;
+    case State::FhLen0:
+      length_ = static_cast<uint32_t>(c) << 24;
+      state_ = State::FhLen1;
+      mem++;
+      j++;
+      break;
+    case State::FhLen1:
+      length_ |= static_cast<uint32_t>(c) << 16;
+      state_ = State::FhLen2;
+      mem++;
+      j++;
+      break;
+    case State::FhLen2:
+      length_ |= static_cast<uint32_t>(c) << 8;
+      state_ = State::FhLen3;
+      mem++;
+      j++;
+      break;
+    case State::FhLen3:
+      length_ |= static_cast<uint32_t>(c);
+      frameDataStart();
+      if (length_ == 0) {
+        frameDataEnd();
+        state_ = State::FhFlag;
+      } else {
+        state_ = State::Data;
+      }
+      mem++;
+      j++;
+      break;
+    case State::Data:
+      uint64_t remain_in_buffer = len - j;
+      if (remain_in_buffer <= length_) {
+        frameData(mem, remain_in_buffer);
+        mem += remain_in_buffer;
+        j += remain_in_buffer;
+        length_ -= remain_in_buffer;
+      } else {
+        frameData(mem, length_);
+        mem += length_;
+        j += length_;
+        length_ = 0;
+      }
+      if (length_ == 0) {
+        frameDataEnd();
+        state_ = State::FhFlag;
+      }
+      break;
+    }
+  }
+  return true;
+}
+
 } // namespace Grpc
 } // namespace Envoy
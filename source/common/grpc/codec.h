@@ -90,6 +90,9 @@ public:
   virtual ~FrameInspector() = default;
 
 protected:
+  // Inspects a contiguous part of the input. Returns false if the inspector aborted.
+  bool inspectSlice(uint8_t* mem, uint64_t len);
+
   virtual bool frameStart(uint8_t) { return true; }
   virtual void frameDataStart() {}
   virtual void frameData(uint8_t*, uint64_t) {}
@@ -126,6 +129,9 @@ protected:
   void frameDataEnd() override;
 
 private:
+  // Decodes valid frames, moving their payloads out of the input.
+  void moveFrames(Buffer::Instance& input);
+
   Frame frame_;
   std::vector<Frame>* output_{nullptr};
   bool decoding_error_{false};
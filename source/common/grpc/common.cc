@@ -7,6 +7,7 @@
 
 #include "common/buffer/buffer_impl.h"
 #include "common/buffer/zero_copy_input_stream_impl.h"
+#include "common/buffer/zero_copy_output_stream_impl.h"
 #include "common/common/assert.h"
 #include "common/common/base64.h"
 #include "common/common/empty_string.h"
@@ -125,40 +126,33 @@ Common::getGrpcStatusDetailsBin(const Http::HeaderMap& trailers) {
 
 Buffer::InstancePtr Common::serializeToGrpcFrame(const Protobuf::Message& message) {
   // http://www.grpc.io/docs/guides/wire.html
-  // Reserve enough space for the entire message and the 5 byte header.
+  // The frame header and the message are written in place into the reservations of the buffer, so
+  // that a small message takes a single slice and a large one is spread over several.
   // NB: we do not use prependGrpcFrameHeader because that would add another BufferFragment and this
-  // (using a single BufferFragment) is more efficient.
+  // is more efficient.
   Buffer::InstancePtr body(new Buffer::OwnedImpl());
   const uint32_t size = message.ByteSize();
-  const uint32_t alloc_size = size + 5;
-  Buffer::RawSlice iovec;
-  body->reserve(alloc_size, &iovec, 1);
-  ASSERT(iovec.len_ >= alloc_size);
-  iovec.len_ = alloc_size;
-  uint8_t* current = reinterpret_cast<uint8_t*>(iovec.mem_);
-  *current++ = 0; // flags
-  const uint32_t nsize = htonl(size);
-  std::memcpy(current, reinterpret_cast<const void*>(&nsize), sizeof(uint32_t));
-  current += sizeof(uint32_t);
-  Protobuf::io::ArrayOutputStream stream(current, size, -1);
-  Protobuf::io::CodedOutputStream codec_stream(&stream);
-  message.SerializeWithCachedSizes(&codec_stream);
-  body->commit(&iovec, 1);
+  {
+    Buffer::ZeroCopyOutputStreamImpl stream(*body, size + 5);
+    Protobuf::io::CodedOutputStream codec_stream(&stream);
+    uint8_t header[5];
+    header[0] = 0; // flags
+    const uint32_t nsize = htonl(size);
+    std::memcpy(&header[1], reinterpret_cast<const void*>(&nsize), sizeof(uint32_t));
+    codec_stream.WriteRaw(header, sizeof(header));
+    message.SerializeWithCachedSizes(&codec_stream);
+  }
   return body;
 }
 
 Buffer::InstancePtr Common::serializeMessage(const Protobuf::Message& message) {
   auto body = std::make_unique<Buffer::OwnedImpl>();
   const uint32_t size = message.ByteSize();
-  Buffer::RawSlice iovec;
-  body->reserve(size, &iovec, 1);
-  ASSERT(iovec.len_ >= size);
-  iovec.len_ = size;
-  uint8_t* current = reinterpret_cast<uint8_t*>(iovec.mem_);
-  Protobuf::io::ArrayOutputStream stream(current, size, -1);
-  Protobuf::io::CodedOutputStream codec_stream(&stream);
-  message.SerializeWithCachedSizes(&codec_stream);
-  body->commit(&iovec, 1);
+  if (size > 0) {
+    Buffer::ZeroCopyOutputStreamImpl stream(*body, size);
+    Protobuf::io::CodedOutputStream codec_stream(&stream);
+    message.SerializeWithCachedSizes(&codec_stream);
+  }
   return body;
 }
 
@@ -59,6 +59,11 @@ public:
   Stream* start(StreamCallbacks& callbacks, const AsyncClient::StreamOptions& options) override;
   Event::Dispatcher& dispatcher() override { return dispatcher_; }
 
+  /**
+   * @return whether the client has requests or streams in flight.
+   */
+  bool hasActiveStreams() const { return !active_streams_.empty(); }
+
 private:
   Upstream::ClusterInfoConstSharedPtr cluster_;
   Router::FilterConfig config_;
@@ -110,6 +115,7 @@ private:
       return additional_request_chance_;
     }
     bool hedgeOnPerTryTimeout() const override { return false; }
+    Router::AdaptiveHedge* adaptiveHedge() const override { return nullptr; }
 
     const envoy::type::v3::FractionalPercent additional_request_chance_;
   };
@@ -192,7 +198,7 @@ private:
     Stats::StatName statName() const override { return {}; }
     const Router::RateLimitPolicy& rateLimitPolicy() const override { return rate_limit_policy_; }
     const Router::CorsPolicy* corsPolicy() const override { return nullptr; }
-    const Router::Config& routeConfig() const override { return route_configuration_; }
+    const Router::CommonConfig& routeConfig() const override { return route_configuration_; }
     const Router::RouteSpecificFilterConfig* perFilterConfig(const std::string&) const override {
       return nullptr;
     }
@@ -335,6 +341,10 @@ private:
     const Router::RouteSpecificFilterConfig* perFilterConfig(const std::string&) const override {
       return nullptr;
     }
+    const Router::RouteSpecificFilterConfig*
+    mostSpecificPerFilterConfig(const std::string&) const override {
+      return nullptr;
+    }
 
     RouteEntryImpl route_entry_;
   };
@@ -416,6 +426,7 @@ private:
   const ScopeTrackedObject& scope() override { return *this; }
   void addUpstreamSocketOptions(const Network::Socket::OptionsSharedPtr&) override {}
   Network::Socket::OptionsSharedPtr getUpstreamSocketOptions() const override { return {}; }
+  Buffer::BufferMemoryAccountSharedPtr account() const override { return nullptr; }
 
   // ScopeTrackedObject
   void dumpState(std::ostream& os, int indent_level) const override {
@@ -34,6 +34,11 @@ public:
    */
   void remove(const AsyncClient::Request& request);
 
+  /**
+   * @return the number of known active requests.
+   */
+  size_t size() const { return active_requests_.size(); }
+
 private:
   // Track active async HTTP requests to be able to cancel them on destruction.
   absl::flat_hash_set<AsyncClient::Request*> active_requests_;
@@ -27,6 +27,7 @@
 #include "common/common/enum_to_int.h"
 #include "common/common/fmt.h"
 #include "common/common/scope_tracker.h"
+#include "common/common/stage_trace.h"
 #include "common/common/utility.h"
 #include "common/http/codes.h"
 #include "common/http/conn_manager_utility.h"
@@ -101,7 +102,9 @@ ConnectionManagerImpl::ConnectionManagerImpl(ConnectionManagerConfig& config,
           overload_state_.getState(Server::OverloadActionNames::get().StopAcceptingRequests)),
       overload_disable_keepalive_ref_(
           overload_state_.getState(Server::OverloadActionNames::get().DisableHttpKeepAlive)),
-      time_source_(time_source) {}
+      time_source_(time_source),
+      use_filter_chain_arena_(
+          Runtime::runtimeFeatureEnabled("envoy.reloadable_features.http_filter_chain_arena")) {}
 
 const ResponseHeaderMap& ConnectionManagerImpl::continueHeader() {
   static const auto headers = createHeaderMap<ResponseHeaderMapImpl>(
@@ -135,6 +138,10 @@ void ConnectionManagerImpl::initializeReadFilterCallbacks(Network::ReadFilterCal
 
   read_callbacks_->connection().setDelayedCloseTimeout(config_.delayedCloseTimeout());
 
+  drain_close_handle_ = drain_close_.addOnDrainCloseCb(
+      read_callbacks_->connection().dispatcher(),
+      [this](bool idle_only) -> bool { return onPacedDrain(idle_only); });
+
   read_callbacks_->connection().setConnectionStats(
       {stats_.named_.downstream_cx_rx_bytes_total_, stats_.named_.downstream_cx_rx_bytes_buffered_,
        stats_.named_.downstream_cx_tx_bytes_total_, stats_.named_.downstream_cx_tx_bytes_buffered_,
@@ -227,6 +234,10 @@ void ConnectionManagerImpl::doDeferredStreamDestroy(ActiveStream& stream) {
     stream.stream_idle_timer_ = nullptr;
   }
   stream.filter_manager_.disarmRequestTimeout();
+  if (stream.filter_manager_.account() != nullptr) {
+    // The slices charged to the account may outlive the stream.
+    stream.filter_manager_.account()->clearDownstream();
+  }
   if (stream.request_header_timer_ != nullptr) {
     stream.request_header_timer_->disableTimer();
     stream.request_header_timer_ = nullptr;
@@ -257,6 +268,9 @@ RequestDecoder& ConnectionManagerImpl::newStream(ResponseEncoder& response_encod
   new_stream->response_encoder_ = &response_encoder;
   new_stream->response_encoder_->getStream().addCallbacks(*new_stream);
   new_stream->response_encoder_->getStream().setFlushTimeout(new_stream->idle_timeout_ms_);
+  if (new_stream->filter_manager_.account() != nullptr) {
+    new_stream->response_encoder_->getStream().setAccount(new_stream->filter_manager_.account());
+  }
   // If the network connection is backed up, the stream should be made aware of it on creation.
   // Both HTTP/1.x and HTTP/2 codecs handle this in StreamCallbackHelper::addCallbacksHelper.
   ASSERT(read_callbacks_->connection().aboveHighWatermark() == false ||
@@ -483,6 +497,27 @@ void ConnectionManagerImpl::onConnectionDurationTimeout() {
   }
 }
 
+bool ConnectionManagerImpl::onPacedDrain(bool idle_only) {
+  if (idle_only && !streams_.empty()) {
+    return false;
+  }
+  if (drain_state_ != DrainState::NotDraining ||
+      read_callbacks_->connection().state() != Network::Connection::State::Open) {
+    return true;
+  }
+
+  ENVOY_CONN_LOG(debug, "paced drain closing connection", read_callbacks_->connection());
+  stats_.named_.downstream_cx_drain_close_.inc();
+  if (!codec_ || (streams_.empty() && codec_->protocol() < Protocol::Http2)) {
+    // There is no request to let complete, nor a GOAWAY to send.
+    doConnectionClose(Network::ConnectionCloseType::FlushWrite, absl::nullopt, "");
+  } else {
+    // For HTTP/1 the response of the request in progress closes the connection.
+    startDrainSequence();
+  }
+  return true;
+}
+
 void ConnectionManagerImpl::onDrainTimeout() {
   ASSERT(drain_state_ != DrainState::NotDraining);
   codec_->goAway();
@@ -577,7 +612,8 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
                       connection_manager_.config_.localReply(),
                       connection_manager_.codec_->protocol(), connection_manager_.timeSource(),
                       connection_manager_.read_callbacks_->connection().streamInfo().filterState(),
-                      StreamInfo::FilterState::LifeSpan::Connection),
+                      StreamInfo::FilterState::LifeSpan::Connection,
+                      connection_manager_.use_filter_chain_arena_),
       request_response_timespan_(new Stats::HistogramCompletableTimespanImpl(
           connection_manager_.stats_.named_.downstream_rq_time_,
           connection_manager_.timeSource())) {
@@ -594,6 +630,10 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
 
   filter_manager_.streamInfo().setRequestIDExtension(
       connection_manager.config_.requestIDExtension());
+  filter_manager_.setAccount(connection_manager_.read_callbacks_->connection()
+                                 .dispatcher()
+                                 .getWatermarkFactory()
+                                 .createAccount([this]() -> void { onBufferMemoryReset(); }));
 
   if (connection_manager_.config_.isRoutable() &&
       connection_manager.config_.routeConfigProvider() != nullptr) {
@@ -704,9 +744,13 @@ void ConnectionManagerImpl::ActiveStream::completeRequest() {
   }
 
   if (active_span_) {
-    Tracing::HttpTracerUtility::finalizeDownstreamSpan(
-        *active_span_, request_headers_.get(), response_headers_.get(), response_trailers_.get(),
-        filter_manager_.streamInfo(), *this);
+    if (state_.traced_) {
+      Tracing::HttpTracerUtility::finalizeDownstreamSpan(
+          *active_span_, request_headers_.get(), response_headers_.get(),
+          response_trailers_.get(), filter_manager_.streamInfo(), *this);
+    } else {
+      active_span_->finishSpan();
+    }
   }
   if (state_.successful_upgrade_) {
     connection_manager_.stats_.named_.downstream_cx_upgrades_active_.dec();
@@ -774,6 +818,14 @@ void ConnectionManagerImpl::ActiveStream::onStreamMaxDurationReached() {
   }
 }
 
+void ConnectionManagerImpl::ActiveStream::onBufferMemoryReset() {
+  ENVOY_STREAM_LOG(debug, "resetting the stream to reclaim its buffer memory", *this);
+  connection_manager_.stats_.named_.downstream_rq_overload_close_.inc();
+  filter_manager_.streamInfo().setResponseCodeDetails(
+      StreamInfo::ResponseCodeDetails::get().Overload);
+  connection_manager_.doEndStream(*this);
+}
+
 void ConnectionManagerImpl::ActiveStream::chargeStats(const ResponseHeaderMap& headers) {
   uint64_t response_code = Utility::getResponseStatus(headers);
   filter_manager_.streamInfo().response_code_ = response_code;
@@ -848,6 +900,8 @@ void ConnectionManagerImpl::ActiveStream::decodeHeaders(RequestHeaderMapPtr&& he
   ScopeTrackerScopeState scope(this,
                                connection_manager_.read_callbacks_->connection().dispatcher());
   request_headers_ = std::move(headers);
+  STAGE_TRACE(StageTrace::Stage::HeadersDecoded,
+              connection_manager_.read_callbacks_->connection().id(), stream_id_);
   filter_manager_.requestHeadersInitialized();
   if (request_header_timer_ != nullptr) {
     request_header_timer_->disableTimer();
@@ -1098,6 +1152,7 @@ void ConnectionManagerImpl::ActiveStream::traceRequest() {
   if (!active_span_) {
     return;
   }
+  state_.traced_ = tracing_decision.traced;
 
   // TODO: Need to investigate the following code based on the cached route, as may
   // be broken in the case a filter changes the route.
@@ -1291,6 +1346,10 @@ void ConnectionManagerImpl::ActiveStream::refreshCachedRoute(const Router::Route
     }
   }
   filter_manager_.streamInfo().route_entry_ = route ? route->routeEntry() : nullptr;
+  if (route != nullptr) {
+    STAGE_TRACE(StageTrace::Stage::RouteSelected,
+                connection_manager_.read_callbacks_->connection().id(), stream_id_);
+  }
   cached_route_ = std::move(route);
   if (nullptr == filter_manager_.streamInfo().route_entry_) {
     cached_cluster_info_ = nullptr;
@@ -296,7 +296,8 @@ private:
     struct State {
       State()
           : codec_saw_local_complete_(false), saw_connection_close_(false),
-            successful_upgrade_(false), is_internally_created_(false), decorated_propagate_(true) {}
+            successful_upgrade_(false), is_internally_created_(false), decorated_propagate_(true),
+            traced_(false) {}
 
       bool codec_saw_local_complete_ : 1; // This indicates that local is complete as written all
                                           // the way through to the codec.
@@ -308,6 +309,9 @@ private:
       bool is_internally_created_ : 1;
 
       bool decorated_propagate_ : 1;
+      // True if the active span is sampled. The spans which are not only carry the trace context
+      // and are finished without being tagged.
+      bool traced_ : 1;
     };
 
     // Per-stream idle timeout callback.
@@ -318,6 +322,8 @@ private:
     void onRequestHeaderTimeout();
     // Per-stream alive duration reached.
     void onStreamMaxDurationReached();
+    // Per-stream reset reclaiming the buffer memory of the stream under memory pressure.
+    void onBufferMemoryReset();
     bool hasCachedRoute() { return cached_route_.has_value() && cached_route_.value(); }
 
     // Return local port of the connection.
@@ -405,6 +411,7 @@ private:
   void onConnectionDurationTimeout();
   void onDrainTimeout();
   void startDrainSequence();
+  bool onPacedDrain(bool idle_only);
   Tracing::HttpTracer& tracer() { return *config_.tracer(); }
   void handleCodecError(absl::string_view error);
   void doConnectionClose(absl::optional<Network::ConnectionCloseType> close_type,
@@ -420,6 +427,8 @@ private:
   std::list<ActiveStreamPtr> streams_;
   Stats::TimespanPtr conn_length_;
   const Network::DrainDecision& drain_close_;
+  // The registration of the connection for paced draining, if the drain sequences are paced.
+  Network::DrainCloseHandlePtr drain_close_handle_;
   DrainState drain_state_{DrainState::NotDraining};
   UserAgent user_agent_;
   // An idle timer for the connection. This is only armed when there are no streams on the
@@ -442,6 +451,9 @@ private:
   const Server::OverloadActionState& overload_stop_accepting_requests_ref_;
   const Server::OverloadActionState& overload_disable_keepalive_ref_;
   TimeSource& time_source_;
+  // Whether the filter chains of the streams of this connection are allocated from a per-stream
+  // arena. Read once per connection rather than once per stream.
+  const bool use_filter_chain_arena_;
   bool remote_close_{};
 };
 
@@ -31,8 +31,7 @@ wrapTransportSocketOptions(Network::TransportSocketOptionsSharedPtr transport_so
       fallbacks.push_back(Http::Utility::AlpnNames::get().Http2);
       break;
     case Http::Protocol::Http3:
-      // TODO(snowp): Add once HTTP/3 upstream support is added.
-      NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+      // QUIC negotiates the ALPN of its connections itself, without the transport socket options.
       break;
     }
   }
@@ -94,5 +93,79 @@ void HttpConnPoolImplBase::onPoolReady(Envoy::ConnectionPool::ActiveClient& clie
                         http_client->codec_client_->protocol());
 }
 
+// All streams are 2^31. Client streams are half that, minus stream 0. Just to be on the safe
+// side we do 2^29.
+static const uint64_t DEFAULT_MAX_STREAMS = (1 << 29);
+
+static uint64_t maxStreamsPerConnection(uint64_t max_streams_config) {
+  return (max_streams_config != 0) ? max_streams_config : DEFAULT_MAX_STREAMS;
+}
+
+MultiplexedActiveClientBase::MultiplexedActiveClientBase(HttpConnPoolImplBase& parent,
+                                                         uint32_t max_concurrent_streams,
+                                                         Stats::Counter& cx_total)
+    : Envoy::Http::ActiveClient(
+          parent, maxStreamsPerConnection(parent.host()->cluster().maxRequestsPerConnection()),
+          max_concurrent_streams) {
+  codec_client_->setCodecClientCallbacks(*this);
+  codec_client_->setCodecConnectionCallbacks(*this);
+  cx_total.inc();
+}
+
+MultiplexedActiveClientBase::MultiplexedActiveClientBase(HttpConnPoolImplBase& parent,
+                                                         uint32_t max_concurrent_streams,
+                                                         Stats::Counter& cx_total,
+                                                         Upstream::Host::CreateConnectionData& data)
+    : Envoy::Http::ActiveClient(
+          parent, maxStreamsPerConnection(parent.host()->cluster().maxRequestsPerConnection()),
+          max_concurrent_streams, data) {
+  codec_client_->setCodecClientCallbacks(*this);
+  codec_client_->setCodecConnectionCallbacks(*this);
+  cx_total.inc();
+}
+
+void MultiplexedActiveClientBase::onGoAway(Http::GoAwayErrorCode) {
+  ENVOY_CONN_LOG(debug, "remote goaway", *codec_client_);
+  parent_.host()->cluster().stats().upstream_cx_close_notify_.inc();
+  if (state_ != ActiveClient::State::DRAINING) {
+    if (codec_client_->numActiveRequests() == 0) {
+      codec_client_->close();
+    } else {
+      parent_.transitionActiveClientState(*this, ActiveClient::State::DRAINING);
+    }
+  }
+}
+
+void MultiplexedActiveClientBase::onStreamDestroy() {
+  parent().onStreamClosed(*this, false);
+
+  // If we are destroying this stream because of a disconnect, do not check for drain here. We will
+  // wait until the connection has been fully drained of streams and then check in the connection
+  // event callback.
+  if (!closed_with_active_rq_) {
+    parent().checkForDrained();
+  }
+}
+
+void MultiplexedActiveClientBase::onStreamReset(Http::StreamResetReason reason) {
+  if (reason == StreamResetReason::ConnectionTermination ||
+      reason == StreamResetReason::ConnectionFailure) {
+    parent_.host()->cluster().stats().upstream_rq_pending_failure_eject_.inc();
+    closed_with_active_rq_ = true;
+  } else if (reason == StreamResetReason::LocalReset) {
+    parent_.host()->cluster().stats().upstream_rq_tx_reset_.inc();
+  } else if (reason == StreamResetReason::RemoteReset) {
+    parent_.host()->cluster().stats().upstream_rq_rx_reset_.inc();
+  }
+}
+
+bool MultiplexedActiveClientBase::closingWithIncompleteStream() const {
+  return closed_with_active_rq_;
+}
+
+RequestEncoder& MultiplexedActiveClientBase::newStreamEncoder(ResponseDecoder& response_decoder) {
+  return codec_client_->newStream(response_decoder);
+}
+
 } // namespace Http
 } // namespace Envoy
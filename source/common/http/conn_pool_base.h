@@ -133,6 +133,33 @@ public:
   Http::CodecClientPtr codec_client_;
 };
 
+/* An implementation of ActiveClient for the multiplexed protocols, HTTP/2 and HTTP/3, which share
+ * how a GOAWAY drains the connection and how the resets of the streams are accounted for.
+ */
+class MultiplexedActiveClientBase : public CodecClientCallbacks,
+                                    public Http::ConnectionCallbacks,
+                                    public ActiveClient {
+public:
+  MultiplexedActiveClientBase(HttpConnPoolImplBase& parent, uint32_t max_concurrent_streams,
+                              Stats::Counter& cx_total);
+  MultiplexedActiveClientBase(HttpConnPoolImplBase& parent, uint32_t max_concurrent_streams,
+                              Stats::Counter& cx_total, Upstream::Host::CreateConnectionData& data);
+  ~MultiplexedActiveClientBase() override = default;
+
+  // ConnPoolImpl::ActiveClient
+  bool closingWithIncompleteStream() const override;
+  RequestEncoder& newStreamEncoder(ResponseDecoder& response_decoder) override;
+
+  // CodecClientCallbacks
+  void onStreamDestroy() override;
+  void onStreamReset(Http::StreamResetReason reason) override;
+
+  // Http::ConnectionCallbacks
+  void onGoAway(Http::GoAwayErrorCode error_code) override;
+
+  bool closed_with_active_rq_{};
+};
+
 /* An implementation of Envoy::ConnectionPool::ConnPoolImplBase for HTTP/1 and HTTP/2
  */
 class FixedHttpConnPoolImpl : public HttpConnPoolImplBase {
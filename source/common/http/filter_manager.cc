@@ -275,6 +275,7 @@ Buffer::InstancePtr ActiveStreamDecoderFilter::createBuffer() {
       [this]() -> void { this->requestDataDrained(); },
       [this]() -> void { this->requestDataTooLarge(); },
       []() -> void { /* TODO(adisuissa): Handle overflow watermark */ });
+  buffer->bindAccount(parent_.account_);
   buffer->setWatermarks(parent_.buffer_limit_);
   return buffer;
 }
@@ -407,7 +408,7 @@ void ActiveStreamDecoderFilter::requestDataTooLarge() {
 void FilterManager::addStreamDecoderFilterWorker(
     StreamDecoderFilterSharedPtr filter, Matcher::MatchTreeSharedPtr<HttpMatchingData> matcher,
     HttpMatchingDataImplSharedPtr matching_data, bool dual_filter) {
-  ActiveStreamDecoderFilterPtr wrapper(new ActiveStreamDecoderFilter(
+  ActiveStreamDecoderFilterPtr wrapper(new (filter_arena_) ActiveStreamDecoderFilter(
       *this, filter, std::move(matcher), std::move(matching_data), dual_filter));
   filter->setDecoderFilterCallbacks(*wrapper);
   // Note: configured decoder filters are appended to decoder_filters_.
@@ -424,7 +425,7 @@ void FilterManager::addStreamDecoderFilterWorker(
 void FilterManager::addStreamEncoderFilterWorker(
     StreamEncoderFilterSharedPtr filter, Matcher::MatchTreeSharedPtr<HttpMatchingData> match_tree,
     HttpMatchingDataImplSharedPtr matching_data, bool dual_filter) {
-  ActiveStreamEncoderFilterPtr wrapper(new ActiveStreamEncoderFilter(
+  ActiveStreamEncoderFilterPtr wrapper(new (filter_arena_) ActiveStreamEncoderFilter(
       *this, filter, std::move(match_tree), std::move(matching_data), dual_filter));
   filter->setEncoderFilterCallbacks(*wrapper);
   // Note: configured encoder filters are prepended to encoder_filters_.
@@ -443,7 +444,7 @@ void FilterManager::addAccessLogHandler(AccessLog::InstanceSharedPtr handler) {
 }
 
 void FilterManager::maybeContinueDecoding(
-    const std::list<ActiveStreamDecoderFilterPtr>::iterator& continue_data_entry) {
+    const ActiveStreamDecoderFilterList::iterator& continue_data_entry) {
   if (continue_data_entry != decoder_filters_.end()) {
     // We use the continueDecoding() code since it will correctly handle not calling
     // decodeHeaders() again. Fake setting StopSingleIteration since the continueDecoding() code
@@ -458,9 +459,9 @@ void FilterManager::maybeContinueDecoding(
 void FilterManager::decodeHeaders(ActiveStreamDecoderFilter* filter, RequestHeaderMap& headers,
                                   bool end_stream) {
   // Headers filter iteration should always start with the next filter if available.
-  std::list<ActiveStreamDecoderFilterPtr>::iterator entry =
+  ActiveStreamDecoderFilterList::iterator entry =
       commonDecodePrefix(filter, FilterIterationStartState::AlwaysStartFromNext);
-  std::list<ActiveStreamDecoderFilterPtr>::iterator continue_data_entry = decoder_filters_.end();
+  ActiveStreamDecoderFilterList::iterator continue_data_entry = decoder_filters_.end();
 
   for (; entry != decoder_filters_.end(); entry++) {
     (*entry)->evaluateMatchTreeWithNewData(
@@ -541,7 +542,7 @@ void FilterManager::decodeData(ActiveStreamDecoderFilter* filter, Buffer::Instan
   auto trailers_added_entry = decoder_filters_.end();
   const bool trailers_exists_at_start = filter_manager_callbacks_.requestTrailers().has_value();
   // Filter iteration may start at the current filter.
-  std::list<ActiveStreamDecoderFilterPtr>::iterator entry =
+  ActiveStreamDecoderFilterList::iterator entry =
       commonDecodePrefix(filter, filter_iteration_start_state);
 
   for (; entry != decoder_filters_.end(); entry++) {
@@ -675,7 +676,7 @@ void FilterManager::decodeTrailers(ActiveStreamDecoderFilter* filter, RequestTra
   }
 
   // Filter iteration may start at the current filter.
-  std::list<ActiveStreamDecoderFilterPtr>::iterator entry =
+  ActiveStreamDecoderFilterList::iterator entry =
       commonDecodePrefix(filter, FilterIterationStartState::CanStartFromCurrent);
 
   for (; entry != decoder_filters_.end(); entry++) {
@@ -707,7 +708,7 @@ void FilterManager::decodeTrailers(ActiveStreamDecoderFilter* filter, RequestTra
 
 void FilterManager::decodeMetadata(ActiveStreamDecoderFilter* filter, MetadataMap& metadata_map) {
   // Filter iteration may start at the current filter.
-  std::list<ActiveStreamDecoderFilterPtr>::iterator entry =
+  ActiveStreamDecoderFilterList::iterator entry =
       commonDecodePrefix(filter, FilterIterationStartState::CanStartFromCurrent);
 
   for (; entry != decoder_filters_.end(); entry++) {
@@ -742,7 +743,7 @@ void FilterManager::maybeEndDecode(bool end_stream) {
 
 void FilterManager::disarmRequestTimeout() { filter_manager_callbacks_.disarmRequestTimeout(); }
 
-std::list<ActiveStreamEncoderFilterPtr>::iterator
+ActiveStreamEncoderFilterList::iterator
 FilterManager::commonEncodePrefix(ActiveStreamEncoderFilter* filter, bool end_stream,
                                   FilterIterationStartState filter_iteration_start_state) {
   // Only do base state setting on the initial call. Subsequent calls for filtering do not touch
@@ -762,7 +763,7 @@ FilterManager::commonEncodePrefix(ActiveStreamEncoderFilter* filter, bool end_st
   return std::next(filter->entry());
 }
 
-std::list<ActiveStreamDecoderFilterPtr>::iterator
+ActiveStreamDecoderFilterList::iterator
 FilterManager::commonDecodePrefix(ActiveStreamDecoderFilter* filter,
                                   FilterIterationStartState filter_iteration_start_state) {
   if (!filter) {
@@ -922,7 +923,7 @@ void FilterManager::encode100ContinueHeaders(ActiveStreamEncoderFilter* filter,
   // end-stream, and because there are normal headers coming there's no need for
   // complex continuation logic.
   // 100-continue filter iteration should always start with the next filter if available.
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry =
+  ActiveStreamEncoderFilterList::iterator entry =
       commonEncodePrefix(filter, false, FilterIterationStartState::AlwaysStartFromNext);
   for (; entry != encoder_filters_.end(); entry++) {
     if ((*entry)->skip_) {
@@ -944,7 +945,7 @@ void FilterManager::encode100ContinueHeaders(ActiveStreamEncoderFilter* filter,
 }
 
 void FilterManager::maybeContinueEncoding(
-    const std::list<ActiveStreamEncoderFilterPtr>::iterator& continue_data_entry) {
+    const ActiveStreamEncoderFilterList::iterator& continue_data_entry) {
   if (continue_data_entry != encoder_filters_.end()) {
     // We use the continueEncoding() code since it will correctly handle not calling
     // encodeHeaders() again. Fake setting StopSingleIteration since the continueEncoding() code
@@ -965,9 +966,9 @@ void FilterManager::encodeHeaders(ActiveStreamEncoderFilter* filter, ResponseHea
   disarmRequestTimeout();
 
   // Headers filter iteration should always start with the next filter if available.
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry =
+  ActiveStreamEncoderFilterList::iterator entry =
       commonEncodePrefix(filter, end_stream, FilterIterationStartState::AlwaysStartFromNext);
-  std::list<ActiveStreamEncoderFilterPtr>::iterator continue_data_entry = encoder_filters_.end();
+  ActiveStreamEncoderFilterList::iterator continue_data_entry = encoder_filters_.end();
 
   for (; entry != encoder_filters_.end(); entry++) {
     (*entry)->evaluateMatchTreeWithNewData(
@@ -1025,7 +1026,7 @@ void FilterManager::encodeMetadata(ActiveStreamEncoderFilter* filter,
                                    MetadataMapPtr&& metadata_map_ptr) {
   filter_manager_callbacks_.resetIdleTimer();
 
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry =
+  ActiveStreamEncoderFilterList::iterator entry =
       commonEncodePrefix(filter, false, FilterIterationStartState::CanStartFromCurrent);
 
   for (; entry != encoder_filters_.end(); entry++) {
@@ -1094,7 +1095,7 @@ void FilterManager::encodeData(ActiveStreamEncoderFilter* filter, Buffer::Instan
   filter_manager_callbacks_.resetIdleTimer();
 
   // Filter iteration may start at the current filter.
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry =
+  ActiveStreamEncoderFilterList::iterator entry =
       commonEncodePrefix(filter, end_stream, filter_iteration_start_state);
   auto trailers_added_entry = encoder_filters_.end();
 
@@ -1162,7 +1163,7 @@ void FilterManager::encodeTrailers(ActiveStreamEncoderFilter* filter,
   filter_manager_callbacks_.resetIdleTimer();
 
   // Filter iteration may start at the current filter.
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry =
+  ActiveStreamEncoderFilterList::iterator entry =
       commonEncodePrefix(filter, true, FilterIterationStartState::CanStartFromCurrent);
   for (; entry != encoder_filters_.end(); entry++) {
     // If the filter pointed by entry has stopped for all frame type, return now.
@@ -1333,7 +1334,7 @@ bool ActiveStreamDecoderFilter::recreateStream(const ResponseHeaderMap* headers)
     parent_.filter_manager_callbacks_.chargeStats(*headers);
   }
 
-  parent_.filter_manager_callbacks_.recreateStream(parent_.stream_info_.filter_state_);
+  parent_.filter_manager_callbacks_.recreateStream(parent_.stream_info_.filterState());
 
   return true;
 }
@@ -1348,6 +1349,10 @@ Network::Socket::OptionsSharedPtr ActiveStreamDecoderFilter::getUpstreamSocketOp
   return parent_.upstream_options_;
 }
 
+Buffer::BufferMemoryAccountSharedPtr ActiveStreamDecoderFilter::account() const {
+  return parent_.account_;
+}
+
 void ActiveStreamDecoderFilter::requestRouteConfigUpdate(
     Http::RouteConfigUpdatedCallbackSharedPtr route_config_updated_cb) {
   parent_.filter_manager_callbacks_.requestRouteConfigUpdate(std::move(route_config_updated_cb));
@@ -1362,6 +1367,7 @@ Buffer::InstancePtr ActiveStreamEncoderFilter::createBuffer() {
       [this]() -> void { this->responseDataDrained(); },
       [this]() -> void { this->responseDataTooLarge(); },
       []() -> void { /* TODO(adisuissa): Handle overflow watermark */ });
+  buffer->bindAccount(parent_.account_);
   buffer->setWatermarks(parent_.buffer_limit_);
   return buffer;
 }
@@ -12,6 +12,7 @@
 #include "common/common/linked_object.h"
 #include "common/common/logger.h"
 #include "common/grpc/common.h"
+#include "common/http/header_arena.h"
 #include "common/http/header_utility.h"
 #include "common/http/headers.h"
 #include "common/local_reply/local_reply.h"
@@ -124,6 +125,7 @@ class SkipAction : public Matcher::ActionBase<
  * memory overhead of unused fields) should apply.
  */
 struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
+                                public ArenaAllocated,
                                 Logger::Loggable<Logger::Id::http> {
   ActiveStreamFilterBase(FilterManager& parent, bool dual_filter,
                          Matcher::MatchTreeSharedPtr<HttpMatchingData> match_tree,
@@ -242,12 +244,19 @@ struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
   bool skip_ : 1;
 };
 
+struct ActiveStreamDecoderFilter;
+using ActiveStreamDecoderFilterPtr = std::unique_ptr<ActiveStreamDecoderFilter>;
+using ActiveStreamDecoderFilterAllocator = HeaderArenaAllocator<ActiveStreamDecoderFilterPtr>;
+using ActiveStreamDecoderFilterList =
+    std::list<ActiveStreamDecoderFilterPtr, ActiveStreamDecoderFilterAllocator>;
+
 /**
  * Wrapper for a stream decoder filter.
  */
-struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
-                                   public StreamDecoderFilterCallbacks,
-                                   LinkedObject<ActiveStreamDecoderFilter> {
+struct ActiveStreamDecoderFilter
+    : public ActiveStreamFilterBase,
+      public StreamDecoderFilterCallbacks,
+      LinkedObject<ActiveStreamDecoderFilter, ActiveStreamDecoderFilterAllocator> {
   ActiveStreamDecoderFilter(FilterManager& parent, StreamDecoderFilterSharedPtr filter,
                             Matcher::MatchTreeSharedPtr<HttpMatchingData> match_tree,
                             HttpMatchingDataImplSharedPtr matching_data, bool dual_filter)
@@ -308,6 +317,7 @@ struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
   void addUpstreamSocketOptions(const Network::Socket::OptionsSharedPtr& options) override;
 
   Network::Socket::OptionsSharedPtr getUpstreamSocketOptions() const override;
+  Buffer::BufferMemoryAccountSharedPtr account() const override;
 
   // Each decoder filter instance checks if the request passed to the filter is gRPC
   // so that we can issue gRPC local responses to gRPC requests. Filter's decodeHeaders()
@@ -329,14 +339,19 @@ struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
   bool is_grpc_request_{};
 };
 
-using ActiveStreamDecoderFilterPtr = std::unique_ptr<ActiveStreamDecoderFilter>;
+struct ActiveStreamEncoderFilter;
+using ActiveStreamEncoderFilterPtr = std::unique_ptr<ActiveStreamEncoderFilter>;
+using ActiveStreamEncoderFilterAllocator = HeaderArenaAllocator<ActiveStreamEncoderFilterPtr>;
+using ActiveStreamEncoderFilterList =
+    std::list<ActiveStreamEncoderFilterPtr, ActiveStreamEncoderFilterAllocator>;
 
 /**
  * Wrapper for a stream encoder filter.
  */
-struct ActiveStreamEncoderFilter : public ActiveStreamFilterBase,
-                                   public StreamEncoderFilterCallbacks,
-                                   LinkedObject<ActiveStreamEncoderFilter> {
+struct ActiveStreamEncoderFilter
+    : public ActiveStreamFilterBase,
+      public StreamEncoderFilterCallbacks,
+      LinkedObject<ActiveStreamEncoderFilter, ActiveStreamEncoderFilterAllocator> {
   ActiveStreamEncoderFilter(FilterManager& parent, StreamEncoderFilterSharedPtr filter,
                             Matcher::MatchTreeSharedPtr<HttpMatchingData> match_tree,
                             HttpMatchingDataImplSharedPtr matching_data, bool dual_filter)
@@ -388,8 +403,6 @@ struct ActiveStreamEncoderFilter : public ActiveStreamFilterBase,
   StreamEncoderFilterSharedPtr handle_;
 };
 
-using ActiveStreamEncoderFilterPtr = std::unique_ptr<ActiveStreamEncoderFilter>;
-
 /**
  * Callbacks invoked by the FilterManager to pass filter data/events back to the caller.
  */
@@ -614,9 +627,13 @@ public:
                 uint32_t buffer_limit, FilterChainFactory& filter_chain_factory,
                 const LocalReply::LocalReply& local_reply, Http::Protocol protocol,
                 TimeSource& time_source, StreamInfo::FilterStateSharedPtr parent_filter_state,
-                StreamInfo::FilterState::LifeSpan filter_state_life_span)
+                StreamInfo::FilterState::LifeSpan filter_state_life_span,
+                bool use_filter_arena = false)
       : filter_manager_callbacks_(filter_manager_callbacks), dispatcher_(dispatcher),
         connection_(connection), stream_id_(stream_id), proxy_100_continue_(proxy_100_continue),
+        filter_arena_(use_filter_arena ? std::make_shared<HeaderArena>() : nullptr),
+        decoder_filters_(ActiveStreamDecoderFilterAllocator(filter_arena_)),
+        encoder_filters_(ActiveStreamEncoderFilterAllocator(filter_arena_)),
         buffer_limit_(buffer_limit), filter_chain_factory_(filter_chain_factory),
         local_reply_(local_reply),
         stream_info_(protocol, time_source, parent_filter_state, filter_state_life_span) {}
@@ -864,16 +881,22 @@ public:
 
   uint64_t streamId() const { return stream_id_; }
 
+  /**
+   * Sets the buffer memory account of the stream, which the buffers of the filters are bound to.
+   */
+  void setAccount(Buffer::BufferMemoryAccountSharedPtr account) { account_ = std::move(account); }
+  const Buffer::BufferMemoryAccountSharedPtr& account() const { return account_; }
+
 private:
   // Indicates which filter to start the iteration with.
   enum class FilterIterationStartState { AlwaysStartFromNext, CanStartFromCurrent };
 
   // Returns the encoder filter to start iteration with.
-  std::list<ActiveStreamEncoderFilterPtr>::iterator
+  ActiveStreamEncoderFilterList::iterator
   commonEncodePrefix(ActiveStreamEncoderFilter* filter, bool end_stream,
                      FilterIterationStartState filter_iteration_start_state);
   // Returns the decoder filter to start iteration with.
-  std::list<ActiveStreamDecoderFilterPtr>::iterator
+  ActiveStreamDecoderFilterList::iterator
   commonDecodePrefix(ActiveStreamDecoderFilter* filter,
                      FilterIterationStartState filter_iteration_start_state);
   void addDecodedData(ActiveStreamDecoderFilter& filter, Buffer::Instance& data, bool streaming);
@@ -882,7 +905,7 @@ private:
   // Helper function for the case where we have a header only request, but a filter adds a body
   // to it.
   void maybeContinueDecoding(
-      const std::list<ActiveStreamDecoderFilterPtr>::iterator& maybe_continue_data_entry);
+      const ActiveStreamDecoderFilterList::iterator& maybe_continue_data_entry);
   void decodeHeaders(ActiveStreamDecoderFilter* filter, RequestHeaderMap& headers, bool end_stream);
   // Sends data through decoding filter chains. filter_iteration_start_state indicates which
   // filter to start the iteration with.
@@ -897,7 +920,7 @@ private:
   // filters before calling encodeHeadersInternal which does final header munging and passes the
   // headers to the encoder.
   void maybeContinueEncoding(
-      const std::list<ActiveStreamEncoderFilterPtr>::iterator& maybe_continue_data_entry);
+      const ActiveStreamEncoderFilterList::iterator& maybe_continue_data_entry);
   void encodeHeaders(ActiveStreamEncoderFilter* filter, ResponseHeaderMap& headers,
                      bool end_stream);
   // Sends data through encoding filter chains. filter_iteration_start_state indicates which
@@ -930,8 +953,11 @@ private:
   const uint64_t stream_id_;
   const bool proxy_100_continue_;
 
-  std::list<ActiveStreamDecoderFilterPtr> decoder_filters_;
-  std::list<ActiveStreamEncoderFilterPtr> encoder_filters_;
+  // If set, the filter wrappers and the nodes of the filter lists are allocated from this arena
+  // rather than individually from the heap.
+  const HeaderArenaSharedPtr filter_arena_;
+  ActiveStreamDecoderFilterList decoder_filters_;
+  ActiveStreamEncoderFilterList encoder_filters_;
   std::list<AccessLog::InstanceSharedPtr> access_log_handlers_;
 
   // Stores metadata added in the decoding filter that is being processed. Will be cleared before
@@ -945,6 +971,7 @@ private:
   std::list<DownstreamWatermarkCallbacks*> watermark_callbacks_;
   Network::Socket::OptionsSharedPtr upstream_options_ =
       std::make_shared<Network::Socket::Options>();
+  Buffer::BufferMemoryAccountSharedPtr account_;
 
   FilterChainFactory& filter_chain_factory_;
   const LocalReply::LocalReply& local_reply_;
@@ -0,0 +1,106 @@
+#include "common/http/header_arena.h"
+
+#include <new>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Http {
+
+namespace {
+
+// Round allocations up so that every allocation is aligned for any fundamental type.
+constexpr size_t alignedSize(size_t size) {
+  constexpr size_t alignment = alignof(std::max_align_t);
+  return (size + alignment - 1) & ~(alignment - 1);
+}
+
+// Stored in front of each ArenaAllocated object.
+struct ArenaAllocatedPrefix {
+  HeaderArenaSharedPtr arena_;
+  size_t size_;
+};
+
+constexpr size_t ArenaAllocatedPrefixSize = alignedSize(sizeof(ArenaAllocatedPrefix));
+
+} // namespace
+
+HeaderArena::~HeaderArena() = default;
+
+void* HeaderArena::allocate(size_t size) {
+  size = alignedSize(size);
+  if (size > MaxArenaAllocationSize) {
+    return ::operator new(size);
+  }
+
+  FreeEntry*& free_list = freeList(size);
+  if (free_list != nullptr) {
+    FreeEntry* entry = free_list;
+    free_list = entry->next_;
+    return entry;
+  }
+
+  if (remaining_ < size) {
+    // The unused tail of the previous block, if any, is abandoned.
+    blocks_.emplace_back(new char[BlockSize]);
+    next_ = blocks_.back().get();
+    remaining_ = BlockSize;
+  }
+  void* memory = next_;
+  next_ += size;
+  remaining_ -= size;
+  return memory;
+}
+
+void HeaderArena::deallocate(void* p, size_t size) {
+  size = alignedSize(size);
+  if (size > MaxArenaAllocationSize) {
+    ::operator delete(p);
+    return;
+  }
+
+  FreeEntry*& free_list = freeList(size);
+  FreeEntry* entry = static_cast<FreeEntry*>(p);
+  entry->next_ = free_list;
+  free_list = entry;
+}
+
+HeaderArena::FreeEntry*& HeaderArena::freeList(size_t size) {
+  ASSERT(size >= sizeof(FreeEntry));
+  for (auto& free_list : free_lists_) {
+    if (free_list.first == size) {
+      return free_list.second;
+    }
+  }
+  free_lists_.emplace_back(size, nullptr);
+  return free_lists_.back().second;
+}
+
+void* ArenaAllocated::operator new(size_t size, const HeaderArenaSharedPtr& arena) {
+  size += ArenaAllocatedPrefixSize;
+  char* memory =
+      static_cast<char*>(arena != nullptr ? arena->allocate(size) : ::operator new(size));
+  new (memory) ArenaAllocatedPrefix{arena, size};
+  return memory + ArenaAllocatedPrefixSize;
+}
+
+void ArenaAllocated::operator delete(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+  char* memory = static_cast<char*>(p) - ArenaAllocatedPrefixSize;
+  ArenaAllocatedPrefix* prefix = reinterpret_cast<ArenaAllocatedPrefix*>(memory);
+  // The object may hold the last reference to the arena, so it is released only after the memory
+  // has been returned to it.
+  HeaderArenaSharedPtr arena = std::move(prefix->arena_);
+  const size_t size = prefix->size_;
+  prefix->~ArenaAllocatedPrefix();
+  if (arena != nullptr) {
+    arena->deallocate(memory, size);
+  } else {
+    ::operator delete(memory);
+  }
+}
+
+} // namespace Http
+} // namespace Envoy
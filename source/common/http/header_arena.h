@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/common/non_copyable.h"
+
+#include "absl/container/inlined_vector.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * An arena for the header entries of the header maps decoded for a single stream, and for the
+ * filter chain objects of a single stream. Entries are carved out of fixed size blocks and entries
+ * released by a map are reused by later allocations, so decoding the headers and trailers of a
+ * stream performs a few block allocations rather than one allocation per header. All blocks are
+ * released at once when the last header map using the arena is destroyed.
+ *
+ * Each header map using the arena holds a reference to it, so a map that outlives its stream
+ * remains valid but keeps the whole arena alive. Code that retains headers well beyond the
+ * lifetime of the stream should copy them out with createHeaderMap<T>(const HeaderMap&), which
+ * allocates the copy from the heap.
+ *
+ * The arena is not thread safe. Like the header maps that use it, it must only be used by one
+ * thread at a time.
+ */
+class HeaderArena : NonCopyable {
+public:
+  ~HeaderArena();
+
+  /**
+   * Allocates memory from the arena.
+   * @param size supplies the number of bytes to allocate.
+   * @return memory aligned for any fundamental type.
+   */
+  void* allocate(size_t size);
+
+  /**
+   * Returns memory to the arena for reuse by later allocations of the same size.
+   * @param p supplies memory previously returned by allocate().
+   * @param size supplies the size passed to allocate().
+   */
+  void deallocate(void* p, size_t size);
+
+  /**
+   * @return the number of blocks allocated by the arena.
+   */
+  size_t blockCount() const { return blocks_.size(); }
+
+  // Allocations larger than this are passed through to the heap.
+  static constexpr size_t MaxArenaAllocationSize = 1024;
+
+private:
+  struct FreeEntry {
+    FreeEntry* next_;
+  };
+
+  static constexpr size_t BlockSize = 8192;
+
+  FreeEntry*& freeList(size_t size);
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  char* next_{};
+  size_t remaining_{};
+  // Header maps allocate entries of a single size, so there is typically one free list.
+  absl::InlinedVector<std::pair<size_t, FreeEntry*>, 1> free_lists_;
+};
+
+using HeaderArenaSharedPtr = std::shared_ptr<HeaderArena>;
+
+/**
+ * Standard allocator that allocates from a HeaderArena, or from the heap when constructed without
+ * one.
+ */
+template <class T> class HeaderArenaAllocator {
+public:
+  using value_type = T;
+
+  HeaderArenaAllocator() = default;
+  explicit HeaderArenaAllocator(HeaderArenaSharedPtr arena) : arena_(std::move(arena)) {}
+  template <class U>
+  HeaderArenaAllocator(const HeaderArenaAllocator<U>& other) : arena_(other.arena()) {}
+
+  T* allocate(size_t n) {
+    if (arena_ == nullptr) {
+      return std::allocator<T>().allocate(n);
+    }
+    return static_cast<T*>(arena_->allocate(n * sizeof(T)));
+  }
+  void deallocate(T* p, size_t n) {
+    if (arena_ == nullptr) {
+      std::allocator<T>().deallocate(p, n);
+      return;
+    }
+    arena_->deallocate(p, n * sizeof(T));
+  }
+
+  const HeaderArenaSharedPtr& arena() const { return arena_; }
+
+  template <class U> bool operator==(const HeaderArenaAllocator<U>& rhs) const {
+    return arena_ == rhs.arena();
+  }
+  template <class U> bool operator!=(const HeaderArenaAllocator<U>& rhs) const {
+    return arena_ != rhs.arena();
+  }
+
+private:
+  HeaderArenaSharedPtr arena_;
+};
+
+/**
+ * Base class for objects that are allocated from a HeaderArena with new (arena) T(...). Objects
+ * created with a plain new, or with a null arena, are allocated from the heap. Either way they are
+ * released with delete, so they can be owned by a std::unique_ptr. An object allocated from an
+ * arena holds a reference to it, so the arena outlives the object.
+ */
+class ArenaAllocated {
+public:
+  static void* operator new(size_t size) { return operator new(size, nullptr); }
+  static void* operator new(size_t size, const HeaderArenaSharedPtr& arena);
+  static void operator delete(void* p);
+  // Called if the constructor of an object created with new (arena) T(...) throws.
+  static void operator delete(void* p, const HeaderArenaSharedPtr&) { operator delete(p); }
+};
+
+} // namespace Http
+} // namespace Envoy
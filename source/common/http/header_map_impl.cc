@@ -10,6 +10,7 @@
 #include "common/common/assert.h"
 #include "common/common/dump_state_utils.h"
 #include "common/common/empty_string.h"
+#include "common/memory/accounting.h"
 #include "common/runtime/runtime_features.h"
 #include "common/singleton/const_singleton.h"
 
@@ -253,10 +254,13 @@ template <> HeaderMapImpl::StaticLookupTable<RequestHeaderMap>::StaticLookupTabl
   add(Headers::get().HostLegacy.get().c_str(), [handle](HeaderMapImpl& h) -> StaticLookupResponse {
     return {&h.inlineHeaders()[handle.value().it_->second], &handle.value().it_->first};
   });
+
+  finalize();
 }
 
 template <> HeaderMapImpl::StaticLookupTable<RequestTrailerMap>::StaticLookupTable() {
   finalizeTable();
+  finalize();
 }
 
 template <> HeaderMapImpl::StaticLookupTable<ResponseHeaderMap>::StaticLookupTable() {
@@ -268,6 +272,7 @@ template <> HeaderMapImpl::StaticLookupTable<ResponseHeaderMap>::StaticLookupTab
   INLINE_RESP_HEADERS_TRAILERS(REGISTER_RESPONSE_HEADER)
 
   finalizeTable();
+  finalize();
 }
 
 template <> HeaderMapImpl::StaticLookupTable<ResponseTrailerMap>::StaticLookupTable() {
@@ -277,6 +282,7 @@ template <> HeaderMapImpl::StaticLookupTable<ResponseTrailerMap>::StaticLookupTa
   INLINE_RESP_HEADERS_TRAILERS(REGISTER_RESPONSE_TRAILER)
 
   finalizeTable();
+  finalize();
 }
 
 uint64_t HeaderMapImpl::appendToHeader(HeaderString& header, absl::string_view data,
@@ -293,17 +299,31 @@ uint64_t HeaderMapImpl::appendToHeader(HeaderString& header, absl::string_view d
   return data.size() + byte_size;
 }
 
+HeaderMapImpl::HeaderMapImpl(HeaderArenaSharedPtr arena) : headers_(std::move(arena)) {
+  Memory::Accounting::allocate(Memory::Accounting::Account::HeaderMaps, 0);
+}
+
+HeaderMapImpl::~HeaderMapImpl() {
+  Memory::Accounting::free(Memory::Accounting::Account::HeaderMaps, cached_byte_size_);
+}
+
 void HeaderMapImpl::updateSize(uint64_t from_size, uint64_t to_size) {
   ASSERT(cached_byte_size_ >= from_size);
   cached_byte_size_ -= from_size;
   cached_byte_size_ += to_size;
+  Memory::Accounting::resize(Memory::Accounting::Account::HeaderMaps,
+                             static_cast<int64_t>(to_size) - static_cast<int64_t>(from_size));
 }
 
-void HeaderMapImpl::addSize(uint64_t size) { cached_byte_size_ += size; }
+void HeaderMapImpl::addSize(uint64_t size) {
+  cached_byte_size_ += size;
+  Memory::Accounting::resize(Memory::Accounting::Account::HeaderMaps, size);
+}
 
 void HeaderMapImpl::subtractSize(uint64_t size) {
   ASSERT(cached_byte_size_ >= size);
   cached_byte_size_ -= size;
+  Memory::Accounting::resize(Memory::Accounting::Account::HeaderMaps, -static_cast<int64_t>(size));
 }
 
 void HeaderMapImpl::copyFrom(HeaderMap& lhs, const HeaderMap& header_map) {
@@ -537,7 +557,10 @@ void HeaderMapImpl::iterateReverse(HeaderMap::ConstIterateCb cb) const {
 void HeaderMapImpl::clear() {
   clearInline();
   headers_.clear();
+  Memory::Accounting::resize(Memory::Accounting::Account::HeaderMaps,
+                             -static_cast<int64_t>(cached_byte_size_));
   cached_byte_size_ = 0;
+  raw_header_block_.reset();
 }
 
 size_t HeaderMapImpl::removeIf(const HeaderMap::HeaderMatchPredicate& predicate) {
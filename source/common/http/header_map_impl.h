@@ -11,7 +11,9 @@
 
 #include "common/common/non_copyable.h"
 #include "common/common/utility.h"
+#include "common/http/header_arena.h"
 #include "common/http/headers.h"
+#include "common/http/raw_header_block.h"
 #include "common/runtime/runtime_features.h"
 
 namespace Envoy {
@@ -47,7 +49,7 @@ public:
  */
 class HeaderMapImpl : NonCopyable {
 public:
-  virtual ~HeaderMapImpl() = default;
+  virtual ~HeaderMapImpl();
 
   // The following "constructors" call virtual functions during construction and must use the
   // static factory pattern.
@@ -97,7 +99,29 @@ public:
   bool empty() const { return headers_.empty(); }
   void dumpState(std::ostream& os, int indent_level = 0) const;
 
+  /**
+   * Attaches the header lines the map was decoded from, so that an HTTP/1 encoder can copy the
+   * lines of unmodified headers. See RawHeaderBlock.
+   */
+  void setRawHeaderBlock(RawHeaderBlockConstSharedPtr block) {
+    raw_header_block_ = std::move(block);
+  }
+  const RawHeaderBlock* rawHeaderBlock() const { return raw_header_block_.get(); }
+
+  /**
+   * @return the header lines attached to a header map, or nullptr if there are none or the map is
+   *         not a HeaderMapImpl.
+   */
+  static const RawHeaderBlock* rawHeaderBlock(const HeaderMap& headers) {
+    const auto* impl = dynamic_cast<const HeaderMapImpl*>(&headers);
+    return impl != nullptr ? impl->rawHeaderBlock() : nullptr;
+  }
+
 protected:
+  // The header entries are allocated from the arena if one is supplied, and from the heap
+  // otherwise.
+  explicit HeaderMapImpl(HeaderArenaSharedPtr arena);
+
   struct HeaderEntryImpl : public HeaderEntry, NonCopyable {
     HeaderEntryImpl(const LowerCaseString& key);
     HeaderEntryImpl(const LowerCaseString& key, HeaderString&& value);
@@ -113,13 +137,15 @@ protected:
 
     HeaderString key_;
     HeaderString value_;
-    std::list<HeaderEntryImpl>::iterator entry_;
+    std::list<HeaderEntryImpl, HeaderArenaAllocator<HeaderEntryImpl>>::iterator entry_;
   };
-  using HeaderNode = std::list<HeaderEntryImpl>::iterator;
+  using HeaderEntryList = std::list<HeaderEntryImpl, HeaderArenaAllocator<HeaderEntryImpl>>;
+  using HeaderNode = HeaderEntryList::iterator;
 
   /**
    * This is the static lookup table that is used to determine whether a header is one of the O(1)
-   * headers. This uses a trie for lookup time at most equal to the size of the incoming string.
+   * headers. This uses a perfect hash, so that a lookup costs one hash of the incoming string and
+   * at most one string comparison.
    */
   struct StaticLookupResponse {
     HeaderEntryImpl** entry_;
@@ -131,9 +157,12 @@ protected:
    */
   template <class Interface>
   struct StaticLookupTable
-      : public TrieLookupTable<std::function<StaticLookupResponse(HeaderMapImpl&)>> {
+      : public PerfectHashLookupTable<std::function<StaticLookupResponse(HeaderMapImpl&)>> {
     StaticLookupTable();
 
+    // Finalizes the registry and adds all registered headers, including custom headers registered
+    // at runtime, to the table. The constructor may add further aliases before building the table
+    // with finalize().
     void finalizeTable() {
       CustomInlineHeaderRegistry::finalize<Interface::header_map_type>();
       auto& headers = CustomInlineHeaderRegistry::headers<Interface::header_map_type>();
@@ -189,8 +218,9 @@ protected:
     using HeaderNodeVector = absl::InlinedVector<HeaderNode, 1>;
     using HeaderLazyMap = absl::flat_hash_map<absl::string_view, HeaderNodeVector>;
 
-    HeaderList()
-        : pseudo_headers_end_(headers_.end()),
+    explicit HeaderList(HeaderArenaSharedPtr arena)
+        : headers_(HeaderArenaAllocator<HeaderEntryImpl>(std::move(arena))),
+          pseudo_headers_end_(headers_.end()),
           lazy_map_min_size_(static_cast<uint32_t>(Runtime::getInteger(
               "envoy.http.headermap.lazy_map_min_size", std::numeric_limits<uint32_t>::max()))) {}
 
@@ -283,12 +313,12 @@ protected:
      */
     size_t remove(absl::string_view key);
 
-    std::list<HeaderEntryImpl>::iterator begin() { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::iterator end() { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_iterator begin() const { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::const_iterator end() const { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rend() const { return headers_.rend(); }
+    HeaderEntryList::iterator begin() { return headers_.begin(); }
+    HeaderEntryList::iterator end() { return headers_.end(); }
+    HeaderEntryList::const_iterator begin() const { return headers_.begin(); }
+    HeaderEntryList::const_iterator end() const { return headers_.end(); }
+    HeaderEntryList::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
+    HeaderEntryList::const_reverse_iterator rend() const { return headers_.rend(); }
     HeaderLazyMap::iterator mapFind(absl::string_view key) { return lazy_map_.find(key); }
     HeaderLazyMap::iterator mapEnd() { return lazy_map_.end(); }
     size_t size() const { return headers_.size(); }
@@ -300,7 +330,7 @@ protected:
     }
 
   private:
-    std::list<HeaderEntryImpl> headers_;
+    HeaderEntryList headers_;
     HeaderNode pseudo_headers_end_;
     // The number of headers threshold for lazy map usage.
     const uint32_t lazy_map_min_size_;
@@ -325,6 +355,7 @@ protected:
   HeaderList headers_;
   // This holds the internal byte size of the HeaderMap.
   uint64_t cached_byte_size_ = 0;
+  RawHeaderBlockConstSharedPtr raw_header_block_;
 };
 
 /**
@@ -430,6 +461,8 @@ public:
   }
 
 protected:
+  explicit TypedHeaderMapImpl(HeaderArenaSharedPtr arena) : HeaderMapImpl(std::move(arena)) {}
+
   absl::optional<StaticLookupResponse> staticLookup(absl::string_view key) override {
     return StaticLookupTable<Interface>::lookup(*this, key);
   }
@@ -447,8 +480,9 @@ protected:
 class RequestHeaderMapImpl final : public TypedHeaderMapImpl<RequestHeaderMap>,
                                    public InlineStorage {
 public:
-  static std::unique_ptr<RequestHeaderMapImpl> create() {
-    return std::unique_ptr<RequestHeaderMapImpl>(new (inlineHeadersSize()) RequestHeaderMapImpl());
+  static std::unique_ptr<RequestHeaderMapImpl> create(HeaderArenaSharedPtr arena = nullptr) {
+    return std::unique_ptr<RequestHeaderMapImpl>(new (inlineHeadersSize())
+                                                 RequestHeaderMapImpl(std::move(arena)));
   }
 
   INLINE_REQ_HEADERS(DEFINE_INLINE_HEADER_FUNCS)
@@ -471,7 +505,10 @@ private:
 
   using HeaderHandles = ConstSingleton<HeaderHandleValues>;
 
-  RequestHeaderMapImpl() { clearInline(); }
+  explicit RequestHeaderMapImpl(HeaderArenaSharedPtr arena)
+      : TypedHeaderMapImpl(std::move(arena)) {
+    clearInline();
+  }
 
   HeaderEntryImpl* inline_headers_[];
 };
@@ -483,9 +520,9 @@ private:
 class RequestTrailerMapImpl final : public TypedHeaderMapImpl<RequestTrailerMap>,
                                     public InlineStorage {
 public:
-  static std::unique_ptr<RequestTrailerMapImpl> create() {
+  static std::unique_ptr<RequestTrailerMapImpl> create(HeaderArenaSharedPtr arena = nullptr) {
     return std::unique_ptr<RequestTrailerMapImpl>(new (inlineHeadersSize())
-                                                      RequestTrailerMapImpl());
+                                                  RequestTrailerMapImpl(std::move(arena)));
   }
 
 protected:
@@ -495,7 +532,10 @@ protected:
   HeaderEntryImpl** inlineHeaders() override { return inline_headers_; }
 
 private:
-  RequestTrailerMapImpl() { clearInline(); }
+  explicit RequestTrailerMapImpl(HeaderArenaSharedPtr arena)
+      : TypedHeaderMapImpl(std::move(arena)) {
+    clearInline();
+  }
 
   HeaderEntryImpl* inline_headers_[];
 };
@@ -507,9 +547,9 @@ private:
 class ResponseHeaderMapImpl final : public TypedHeaderMapImpl<ResponseHeaderMap>,
                                     public InlineStorage {
 public:
-  static std::unique_ptr<ResponseHeaderMapImpl> create() {
+  static std::unique_ptr<ResponseHeaderMapImpl> create(HeaderArenaSharedPtr arena = nullptr) {
     return std::unique_ptr<ResponseHeaderMapImpl>(new (inlineHeadersSize())
-                                                      ResponseHeaderMapImpl());
+                                                  ResponseHeaderMapImpl(std::move(arena)));
   }
 
   INLINE_RESP_HEADERS(DEFINE_INLINE_HEADER_FUNCS)
@@ -531,7 +571,10 @@ private:
 
   using HeaderHandles = ConstSingleton<HeaderHandleValues>;
 
-  ResponseHeaderMapImpl() { clearInline(); }
+  explicit ResponseHeaderMapImpl(HeaderArenaSharedPtr arena)
+      : TypedHeaderMapImpl(std::move(arena)) {
+    clearInline();
+  }
 
   HeaderEntryImpl* inline_headers_[];
 };
@@ -543,9 +586,9 @@ private:
 class ResponseTrailerMapImpl final : public TypedHeaderMapImpl<ResponseTrailerMap>,
                                      public InlineStorage {
 public:
-  static std::unique_ptr<ResponseTrailerMapImpl> create() {
+  static std::unique_ptr<ResponseTrailerMapImpl> create(HeaderArenaSharedPtr arena = nullptr) {
     return std::unique_ptr<ResponseTrailerMapImpl>(new (inlineHeadersSize())
-                                                       ResponseTrailerMapImpl());
+                                                   ResponseTrailerMapImpl(std::move(arena)));
   }
 
   INLINE_RESP_HEADERS_TRAILERS(DEFINE_INLINE_HEADER_FUNCS)
@@ -563,7 +606,10 @@ private:
 
   using HeaderHandles = ConstSingleton<HeaderHandleValues>;
 
-  ResponseTrailerMapImpl() { clearInline(); }
+  explicit ResponseTrailerMapImpl(HeaderArenaSharedPtr arena)
+      : TypedHeaderMapImpl(std::move(arena)) {
+    clearInline();
+  }
 
   HeaderEntryImpl* inline_headers_[];
 };
@@ -96,7 +96,9 @@ public:
   } CacheControlValues;
 
   struct {
+    const std::string Brotli{"br"};
     const std::string Gzip{"gzip"};
+    const std::string Zstd{"zstd"};
   } ContentEncodingValues;
 
   struct {
@@ -1,6 +1,8 @@
 #include "common/http/http1/codec_impl.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
 
@@ -18,6 +20,9 @@
 #include "common/http/header_utility.h"
 #include "common/http/headers.h"
 #include "common/http/http1/header_formatter.h"
+#include "common/http/http1/legacy_parser_impl.h"
+#include "common/http/http1/simd_parser_impl.h"
+#include "common/http/interned_header_values.h"
 #include "common/http/utility.h"
 #include "common/runtime/runtime_features.h"
 
@@ -95,6 +100,30 @@ void StreamEncoderImpl::encodeHeader(const char* key, uint32_t key_size, const c
   connection_.copyToBuffer(value, value_size);
   connection_.addToBuffer(CRLF);
 }
+
+uint64_t StreamEncoderImpl::headerBlockSize(const HeaderMap& headers,
+                                            const RawHeaderBlock* raw_header_block) {
+  // Each header line adds ": " and CRLF to the key and value. Translating :authority to host and
+  // skipping other pseudo-headers only shrinks the block, and header key formatting preserves the
+  // length of the key. The encoder adds at most one of "content-length: 0" or
+  // "transfer-encoding: chunked".
+  static const uint64_t added_header_size =
+      std::max(Headers::get().ContentLength.get().size() + 1,
+               Headers::get().TransferEncoding.get().size() +
+                   Headers::get().TransferEncodingValues.Chunked.size()) +
+      2 * CRLF.size();
+  return headers.byteSize() + headers.size() * (2 + CRLF.size()) + added_header_size +
+         CRLF.size() + (raw_header_block != nullptr ? raw_header_block->paddingSize() : 0);
+}
+
+const RawHeaderBlock* StreamEncoderImpl::rawHeaderBlock(const HeaderMap& headers) const {
+  // Spliced lines keep the case of the header names as received, so they can only be used when
+  // the encoder sends header names as they are.
+  if (!connection_.rawHeaderPassthrough() || header_key_formatter_ != nullptr) {
+    return nullptr;
+  }
+  return HeaderMapImpl::rawHeaderBlock(headers);
+}
 void StreamEncoderImpl::encodeHeader(absl::string_view key, absl::string_view value) {
   this->encodeHeader(key.data(), key.size(), value.data(), value.size());
 }
@@ -113,9 +142,22 @@ void ResponseEncoderImpl::encode100ContinueHeaders(const ResponseHeaderMap& head
 }
 
 void StreamEncoderImpl::encodeHeadersBase(const RequestOrResponseHeaderMap& headers,
+                                          const RawHeaderBlock* raw_header_block,
                                           absl::optional<uint64_t> status, bool end_stream) {
   bool saw_content_length = false;
-  headers.iterate([this](const HeaderEntry& header) -> HeaderMap::Iterate {
+  // The run of consecutive lines of raw_header_block that match the headers encoded last, which is
+  // copied once a header does not extend it.
+  size_t next_line = 0;
+  size_t run_begin = 0;
+  size_t run_size = 0;
+  auto flush_run = [&]() {
+    if (run_size > 0) {
+      connection_.addToBuffer(raw_header_block->lines(run_begin, run_begin + run_size - 1));
+      connection_.addToBuffer(CRLF);
+      run_size = 0;
+    }
+  };
+  headers.iterate([&](const HeaderEntry& header) -> HeaderMap::Iterate {
     absl::string_view key_to_use = header.key().getStringView();
     uint32_t key_size_to_use = header.key().size();
     // Translate :authority -> host so that upper layers do not need to deal with this.
@@ -129,10 +171,28 @@ void StreamEncoderImpl::encodeHeadersBase(const RequestOrResponseHeaderMap& head
       return HeaderMap::Iterate::Continue;
     }
 
+    if (raw_header_block != nullptr) {
+      const size_t line =
+          raw_header_block->find(key_to_use, header.value().getStringView(), next_line);
+      if (line < raw_header_block->size()) {
+        if (run_size == 0 || line != run_begin + run_size) {
+          flush_run();
+          run_begin = line;
+        }
+        ++run_size;
+        next_line = line + 1;
+        return HeaderMap::Iterate::Continue;
+      }
+      flush_run();
+    }
+
     encodeFormattedHeader(key_to_use, header.value().getStringView());
 
     return HeaderMap::Iterate::Continue;
   });
+  if (raw_header_block != nullptr) {
+    flush_run();
+  }
 
   if (headers.ContentLength()) {
     saw_content_length = true;
@@ -199,6 +259,8 @@ void StreamEncoderImpl::encodeHeadersBase(const RequestOrResponseHeaderMap& head
 
   if (end_stream) {
     endEncode();
+  } else if (status && *status >= 200 && !is_response_to_connect_request_) {
+    connection_.flushHeaders();
   } else {
     connection_.flushOutput();
   }
@@ -234,15 +296,15 @@ void StreamEncoderImpl::encodeTrailersBase(const HeaderMap& trailers) {
   // https://tools.ietf.org/html/rfc7230#section-4.4
   if (chunk_encoding_) {
     // Finalize the body
-    connection_.buffer().add(LAST_CHUNK);
+    connection_.reserveBuffer(LAST_CHUNK.size() + headerBlockSize(trailers));
+    connection_.addToBuffer(LAST_CHUNK);
 
     trailers.iterate([this](const HeaderEntry& header) -> HeaderMap::Iterate {
       encodeFormattedHeader(header.key().getStringView(), header.value().getStringView());
       return HeaderMap::Iterate::Continue;
     });
 
-    connection_.flushOutput();
-    connection_.buffer().add(CRLF);
+    connection_.addToBuffer(CRLF);
   }
 
   connection_.flushOutput();
@@ -294,23 +356,82 @@ Status ServerConnectionImpl::doFloodProtectionChecks() const {
 }
 
 void ConnectionImpl::flushOutput(bool end_encode) {
+  commitReservation();
   if (end_encode) {
     // If this is an HTTP response in ServerConnectionImpl, track outbound responses for flood
     // protection
     maybeAddSentinelBufferFragment(*output_buffer_);
   }
+  if (header_hold_timer_ != nullptr) {
+    header_hold_timer_->disableTimer();
+  }
+  if (coalesce_output_ && dispatching_ &&
+      output_buffer_->length() < codec_settings_.max_coalesced_response_bytes_) {
+    // Written once the dispatch is over, see dispatch().
+    return;
+  }
+  writeOutput();
+}
+
+void ConnectionImpl::flushHeaders() {
+  commitReservation();
+  if (header_hold_timer_ == nullptr ||
+      output_buffer_->length() >= codec_settings_.max_coalesced_response_bytes_) {
+    flushOutput();
+    return;
+  }
+  // The output is held until the first body data of the response is encoded, or the timer fires.
+  if (!header_hold_timer_->enabled()) {
+    header_hold_timer_->enableTimer(codec_settings_.response_headers_hold_time_);
+  }
+}
+
+void ConnectionImpl::commitReservation() {
+  if (reserved_current_ != nullptr) {
+    reserved_iovec_.len_ = reserved_current_ - static_cast<char*>(reserved_iovec_.mem_);
+    output_buffer_->commit(&reserved_iovec_, 1);
+    reserved_current_ = nullptr;
+  }
+}
+
+void ConnectionImpl::writeOutput() {
+  if (header_hold_timer_ != nullptr) {
+    header_hold_timer_->disableTimer();
+  }
   connection().write(*output_buffer_, false);
   ASSERT(0UL == output_buffer_->length());
 }
 
-void ConnectionImpl::addToBuffer(absl::string_view data) { output_buffer_->add(data); }
+void ConnectionImpl::addToBuffer(absl::string_view data) { copyToBuffer(data.data(), data.size()); }
 
-void ConnectionImpl::addCharToBuffer(char c) { output_buffer_->add(&c, 1); }
+void ConnectionImpl::addCharToBuffer(char c) {
+  ASSERT(bufferRemainingSize() >= 1);
+  *reserved_current_++ = c;
+}
+
+void ConnectionImpl::addIntToBuffer(uint64_t i) {
+  ASSERT(bufferRemainingSize() >= StringUtil::MIN_ITOA_OUT_LEN);
+  reserved_current_ += StringUtil::itoa(reserved_current_, bufferRemainingSize(), i);
+}
 
-void ConnectionImpl::addIntToBuffer(uint64_t i) { output_buffer_->add(absl::StrCat(i)); }
+uint64_t ConnectionImpl::bufferRemainingSize() {
+  if (reserved_current_ == nullptr) {
+    return 0;
+  }
+  return reserved_iovec_.len_ - (reserved_current_ - static_cast<char*>(reserved_iovec_.mem_));
+}
 
 void ConnectionImpl::copyToBuffer(const char* data, uint64_t length) {
-  output_buffer_->add(data, length);
+  ASSERT(bufferRemainingSize() >= length);
+  memcpy(reserved_current_, data, length);
+  reserved_current_ += length;
+}
+
+void ConnectionImpl::reserveBuffer(uint64_t size) {
+  ASSERT(reserved_current_ == nullptr);
+  // A single slice is requested so that the whole header block is written with plain stores.
+  output_buffer_->reserve(size, &reserved_iovec_, 1);
+  reserved_current_ = static_cast<char*>(reserved_iovec_.mem_);
 }
 
 void StreamEncoderImpl::resetStream(StreamResetReason reason) {
@@ -344,7 +465,14 @@ void ResponseEncoderImpl::encodeHeaders(const ResponseHeaderMap& headers, bool e
   // The contract is that client codecs must ensure that :status is present.
   ASSERT(headers.Status() != nullptr);
   uint64_t numeric_status = Utility::getResponseStatus(headers);
+  const char* status_string = CodeUtility::toString(static_cast<Code>(numeric_status));
+  uint32_t status_string_len = strlen(status_string);
 
+  // Serialize the status line and the header block into a single reservation.
+  const RawHeaderBlock* raw_header_block = rawHeaderBlock(headers);
+  connection_.reserveBuffer(sizeof(RESPONSE_PREFIX) - 1 + StringUtil::MIN_ITOA_OUT_LEN + 1 +
+                            status_string_len + CRLF.size() +
+                            headerBlockSize(headers, raw_header_block));
   if (connection_.protocol() == Protocol::Http10 && connection_.supportsHttp10()) {
     connection_.copyToBuffer(HTTP_10_RESPONSE_PREFIX, sizeof(HTTP_10_RESPONSE_PREFIX) - 1);
   } else {
@@ -352,20 +480,16 @@ void ResponseEncoderImpl::encodeHeaders(const ResponseHeaderMap& headers, bool e
   }
   connection_.addIntToBuffer(numeric_status);
   connection_.addCharToBuffer(' ');
-
-  const char* status_string = CodeUtility::toString(static_cast<Code>(numeric_status));
-  uint32_t status_string_len = strlen(status_string);
   connection_.copyToBuffer(status_string, status_string_len);
-
-  connection_.addCharToBuffer('\r');
-  connection_.addCharToBuffer('\n');
+  connection_.addToBuffer(CRLF);
 
   if (numeric_status >= 300) {
     // Don't do special CONNECT logic if the CONNECT was rejected.
     is_response_to_connect_request_ = false;
   }
 
-  encodeHeadersBase(headers, absl::make_optional<uint64_t>(numeric_status), end_stream);
+  encodeHeadersBase(headers, raw_header_block, absl::make_optional<uint64_t>(numeric_status),
+                    end_stream);
 }
 
 static const char REQUEST_POSTFIX[] = " HTTP/1.1\r\n";
@@ -391,6 +515,12 @@ Status RequestEncoderImpl::encodeHeaders(const RequestHeaderMap& headers, bool e
     upgrade_request_ = true;
   }
 
+  // Serialize the request line and the header block into a single reservation.
+  const HeaderEntry* target = is_connect ? host : path;
+  const RawHeaderBlock* raw_header_block = rawHeaderBlock(headers);
+  connection_.reserveBuffer(method->value().size() + 1 + target->value().size() +
+                            sizeof(REQUEST_POSTFIX) - 1 +
+                            headerBlockSize(headers, raw_header_block));
   connection_.copyToBuffer(method->value().getStringView().data(), method->value().size());
   connection_.addCharToBuffer(' ');
   if (is_connect) {
@@ -400,76 +530,29 @@ Status RequestEncoderImpl::encodeHeaders(const RequestHeaderMap& headers, bool e
   }
   connection_.copyToBuffer(REQUEST_POSTFIX, sizeof(REQUEST_POSTFIX) - 1);
 
-  encodeHeadersBase(headers, absl::nullopt, end_stream);
+  encodeHeadersBase(headers, raw_header_block, absl::nullopt, end_stream);
   return okStatus();
 }
 
-int ConnectionImpl::setAndCheckCallbackStatus(Status&& status) {
+CallbackResult ConnectionImpl::setAndCheckCallbackStatus(Status&& status) {
   ASSERT(codec_status_.ok());
   codec_status_ = std::move(status);
-  return codec_status_.ok() ? enumToInt(HttpParserCode::Success) : enumToInt(HttpParserCode::Error);
+  return codec_status_.ok() ? CallbackResult::Success : CallbackResult::Error;
 }
 
-int ConnectionImpl::setAndCheckCallbackStatusOr(Envoy::StatusOr<int>&& statusor) {
+CallbackResult
+ConnectionImpl::setAndCheckCallbackStatusOr(Envoy::StatusOr<CallbackResult>&& statusor) {
   ASSERT(codec_status_.ok());
   if (statusor.ok()) {
     return statusor.value();
   } else {
     codec_status_ = std::move(statusor.status());
-    return enumToInt(HttpParserCode::Error);
-  }
-}
-
-http_parser_settings ConnectionImpl::settings_{
-    [](http_parser* parser) -> int {
-      auto* conn_impl = static_cast<ConnectionImpl*>(parser->data);
-      auto status = conn_impl->onMessageBeginBase();
-      return conn_impl->setAndCheckCallbackStatus(std::move(status));
-    },
-    [](http_parser* parser, const char* at, size_t length) -> int {
-      auto* conn_impl = static_cast<ConnectionImpl*>(parser->data);
-      auto status = conn_impl->onUrl(at, length);
-      return conn_impl->setAndCheckCallbackStatus(std::move(status));
-    },
-    nullptr, // on_status
-    [](http_parser* parser, const char* at, size_t length) -> int {
-      auto* conn_impl = static_cast<ConnectionImpl*>(parser->data);
-      auto status = conn_impl->onHeaderField(at, length);
-      return conn_impl->setAndCheckCallbackStatus(std::move(status));
-    },
-    [](http_parser* parser, const char* at, size_t length) -> int {
-      auto* conn_impl = static_cast<ConnectionImpl*>(parser->data);
-      auto status = conn_impl->onHeaderValue(at, length);
-      return conn_impl->setAndCheckCallbackStatus(std::move(status));
-    },
-    [](http_parser* parser) -> int {
-      auto* conn_impl = static_cast<ConnectionImpl*>(parser->data);
-      auto statusor = conn_impl->onHeadersCompleteBase();
-      return conn_impl->setAndCheckCallbackStatusOr(std::move(statusor));
-    },
-    [](http_parser* parser, const char* at, size_t length) -> int {
-      static_cast<ConnectionImpl*>(parser->data)->bufferBody(at, length);
-      return 0;
-    },
-    [](http_parser* parser) -> int {
-      auto* conn_impl = static_cast<ConnectionImpl*>(parser->data);
-      auto status = conn_impl->onMessageCompleteBase();
-      return conn_impl->setAndCheckCallbackStatus(std::move(status));
-    },
-    [](http_parser* parser) -> int {
-      // A 0-byte chunk header is used to signal the end of the chunked body.
-      // When this function is called, http-parser holds the size of the chunk in
-      // parser->content_length. See
-      // https://github.com/nodejs/http-parser/blob/v2.9.3/http_parser.h#L336
-      const bool is_final_chunk = (parser->content_length == 0);
-      static_cast<ConnectionImpl*>(parser->data)->onChunkHeader(is_final_chunk);
-      return 0;
-    },
-    nullptr // on_chunk_complete
-};
+    return CallbackResult::Error;
+  }
+}
 
 ConnectionImpl::ConnectionImpl(Network::Connection& connection, CodecStats& stats,
-                               const Http1Settings& settings, http_parser_type type,
+                               const Http1Settings& settings, MessageType type,
                                uint32_t max_headers_kb, const uint32_t max_headers_count,
                                HeaderKeyFormatterPtr&& header_key_formatter)
     : connection_(connection), stats_(stats), codec_settings_(settings),
@@ -477,15 +560,22 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, CodecStats& stat
       handling_upgrade_(false), reset_stream_called_(false), deferred_end_stream_headers_(false),
       strict_1xx_and_204_headers_(Runtime::runtimeFeatureEnabled(
           "envoy.reloadable_features.strict_1xx_and_204_response_headers")),
-      dispatching_(false), output_buffer_(connection.dispatcher().getWatermarkFactory().create(
-                               [&]() -> void { this->onBelowLowWatermark(); },
-                               [&]() -> void { this->onAboveHighWatermark(); },
-                               []() -> void { /* TODO(adisuissa): Handle overflow watermark */ })),
+      dispatching_(false),
+      use_header_arena_(
+          Runtime::runtimeFeatureEnabled("envoy.reloadable_features.http_header_map_arena")),
+      raw_header_passthrough_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.http1_raw_header_passthrough")),
+      output_buffer_(connection.dispatcher().getWatermarkFactory().create(
+          [&]() -> void { this->onBelowLowWatermark(); },
+          [&]() -> void { this->onAboveHighWatermark(); },
+          []() -> void { /* TODO(adisuissa): Handle overflow watermark */ })),
       max_headers_kb_(max_headers_kb), max_headers_count_(max_headers_count) {
   output_buffer_->setWatermarks(connection.bufferLimit());
-  http_parser_init(&parser_, type);
-  parser_.allow_chunked_length = 1;
-  parser_.data = this;
+  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.http1_use_simd_parser")) {
+    parser_ = std::make_unique<SimdHttpParserImpl>(type, this);
+  } else {
+    parser_ = std::make_unique<LegacyHttpParserImpl>(type, this);
+  }
 }
 
 Status ConnectionImpl::completeLastHeader() {
@@ -498,11 +588,20 @@ Status ConnectionImpl::completeLastHeader() {
   if (!current_header_field_.empty()) {
     current_header_field_.inlineTransform([](char c) { return absl::ascii_tolower(c); });
     // Strip trailing whitespace of the current header value if any. Leading whitespace was trimmed
-    // in ConnectionImpl::onHeaderValue. http_parser does not strip leading or trailing whitespace
-    // as the spec requires: https://tools.ietf.org/html/rfc7230#section-3.2.4
+    // in ConnectionImpl::onHeaderValueImpl. http_parser does not strip leading or trailing
+    // whitespace as the spec requires: https://tools.ietf.org/html/rfc7230#section-3.2.4
     current_header_value_.rtrim();
-    headers_or_trailers.addViaMove(std::move(current_header_field_),
-                                   std::move(current_header_value_));
+    const absl::string_view interned =
+        InternedValues::get().find(current_header_value_.getStringView());
+    if (!interned.empty()) {
+      // Reference the interned value, keeping the buffer of current_header_value_ for the next
+      // header.
+      headers_or_trailers.addViaMove(std::move(current_header_field_), HeaderString(interned));
+      current_header_value_.clear();
+    } else {
+      headers_or_trailers.addViaMove(std::move(current_header_field_),
+                                     std::move(current_header_value_));
+    }
   }
 
   // Check if the number of headers exceeds the limit.
@@ -520,6 +619,23 @@ Status ConnectionImpl::completeLastHeader() {
   return okStatus();
 }
 
+void ConnectionImpl::maybeAttachRawHeaderBlock() {
+  // The block can only be copied out of the slice if it was not split across slices, which is the
+  // common case of a header block received in one read.
+  if (raw_header_block_begin_ != nullptr && raw_header_block_end_ != nullptr &&
+      raw_header_block_slice_ == dispatched_slices_ &&
+      raw_header_block_end_ > raw_header_block_begin_) {
+    RawHeaderBlockConstSharedPtr block = RawHeaderBlock::create(absl::string_view(
+        raw_header_block_begin_, raw_header_block_end_ - raw_header_block_begin_));
+    auto* headers = dynamic_cast<HeaderMapImpl*>(&requestOrResponseHeaders());
+    if (block != nullptr && headers != nullptr) {
+      headers->setRawHeaderBlock(std::move(block));
+    }
+  }
+  raw_header_block_begin_ = nullptr;
+  raw_header_block_end_ = nullptr;
+}
+
 uint32_t ConnectionImpl::getHeadersSize() {
   return current_header_field_.size() + current_header_value_.size() +
          headersOrTrailers().byteSize();
@@ -553,8 +669,15 @@ Http::Status ConnectionImpl::dispatch(Buffer::Instance& data) {
   // TODO(#10878): Remove this wrapper when exception removal is complete. innerDispatch may either
   // throw an exception or return an error status. The utility wrapper catches exceptions and
   // converts them to error statuses.
-  return Utility::exceptionToStatus(
+  Http::Status status = Utility::exceptionToStatus(
       [&](Buffer::Instance& data) -> Http::Status { return innerDispatch(data); }, data);
+  // Write the output coalesced while dispatching. wantsToWrite() kept the connection manager from
+  // closing the connection before it is written.
+  if (coalesce_output_ && output_buffer_->length() > 0 && !holdingOutput() &&
+      connection_.state() != Network::Connection::State::Closed) {
+    writeOutput();
+  }
+  return status;
 }
 
 Http::Status ClientConnectionImpl::dispatch(Buffer::Instance& data) {
@@ -570,7 +693,7 @@ Http::Status ClientConnectionImpl::dispatch(Buffer::Instance& data) {
 Http::Status ConnectionImpl::innerDispatch(Buffer::Instance& data) {
   ENVOY_CONN_LOG(trace, "parsing {} bytes", connection_, data.length());
   // Make sure that dispatching_ is set to false after dispatching, even when
-  // http_parser exits early with an error code.
+  // the parser exits early with an error code.
   Cleanup cleanup([this]() { dispatching_ = false; });
   ASSERT(!dispatching_);
   ASSERT(codec_status_.ok());
@@ -582,7 +705,7 @@ Http::Status ConnectionImpl::innerDispatch(Buffer::Instance& data) {
   }
 
   // Always unpause before dispatch.
-  http_parser_pause(&parser_, 0);
+  parser_->resume();
 
   ssize_t total_parsed = 0;
   if (data.length() > 0) {
@@ -600,10 +723,10 @@ Http::Status ConnectionImpl::innerDispatch(Buffer::Instance& data) {
       }
 
       total_parsed += statusor_parsed.value();
-      if (HTTP_PARSER_ERRNO(&parser_) != HPE_OK) {
+      if (parser_->getStatus() != ParserStatus::Ok) {
         // Parse errors trigger an exception in dispatchSlice so we are guaranteed to be paused at
         // this point.
-        ASSERT(HTTP_PARSER_ERRNO(&parser_) == HPE_PAUSED);
+        ASSERT(parser_->getStatus() == ParserStatus::Paused);
         break;
       }
     }
@@ -627,23 +750,24 @@ Http::Status ConnectionImpl::innerDispatch(Buffer::Instance& data) {
 
 Envoy::StatusOr<size_t> ConnectionImpl::dispatchSlice(const char* slice, size_t len) {
   ASSERT(codec_status_.ok() && dispatching_);
-  ssize_t rc = http_parser_execute(&parser_, &settings_, slice, len);
+  ++dispatched_slices_;
+  const size_t rc = parser_->execute(slice, len);
   if (!codec_status_.ok()) {
     return codec_status_;
   }
-  if (HTTP_PARSER_ERRNO(&parser_) != HPE_OK && HTTP_PARSER_ERRNO(&parser_) != HPE_PAUSED) {
+  if (parser_->getStatus() == ParserStatus::Error) {
     RETURN_IF_ERROR(sendProtocolError(Http1ResponseCodeDetails::get().HttpCodecError));
     // Avoid overwriting the codec_status_ set in the callbacks.
     ASSERT(codec_status_.ok());
     codec_status_ = codecProtocolError(
-        absl::StrCat("http/1.1 protocol error: ", http_errno_name(HTTP_PARSER_ERRNO(&parser_))));
+        absl::StrCat("http/1.1 protocol error: ", parser_->errorMessage()));
     return codec_status_;
   }
 
   return rc;
 }
 
-Status ConnectionImpl::onHeaderField(const char* data, size_t length) {
+Status ConnectionImpl::onHeaderFieldImpl(const char* data, size_t length) {
   ASSERT(dispatching_);
   // We previously already finished up the headers, these headers are
   // now trailers.
@@ -659,13 +783,17 @@ Status ConnectionImpl::onHeaderField(const char* data, size_t length) {
   if (header_parsing_state_ == HeaderParsingState::Value) {
     RETURN_IF_ERROR(completeLastHeader());
   }
+  if (raw_header_passthrough_ && !processing_trailers_ && raw_header_block_begin_ == nullptr) {
+    raw_header_block_begin_ = data;
+    raw_header_block_slice_ = dispatched_slices_;
+  }
 
   current_header_field_.append(data, length);
 
   return checkMaxHeadersSize();
 }
 
-Status ConnectionImpl::onHeaderValue(const char* data, size_t length) {
+Status ConnectionImpl::onHeaderValueImpl(const char* data, size_t length) {
   ASSERT(dispatching_);
   if (header_parsing_state_ == HeaderParsingState::Done && !enableTrailers()) {
     // Ignore trailers.
@@ -681,6 +809,9 @@ Status ConnectionImpl::onHeaderValue(const char* data, size_t length) {
   }
 
   header_parsing_state_ = HeaderParsingState::Value;
+  if (raw_header_passthrough_ && !processing_trailers_) {
+    raw_header_block_end_ = data + length;
+  }
   if (current_header_value_.empty()) {
     // Strip leading whitespace if the current header value input contains the first bytes of the
     // encoded header value. Trailing whitespace is stripped once the full header value is known in
@@ -693,13 +824,16 @@ Status ConnectionImpl::onHeaderValue(const char* data, size_t length) {
   return checkMaxHeadersSize();
 }
 
-Envoy::StatusOr<int> ConnectionImpl::onHeadersCompleteBase() {
+Envoy::StatusOr<CallbackResult> ConnectionImpl::onHeadersCompleteBase() {
   ASSERT(!processing_trailers_);
   ASSERT(dispatching_);
   ENVOY_CONN_LOG(trace, "onHeadersCompleteBase", connection_);
   RETURN_IF_ERROR(completeLastHeader());
+  if (raw_header_passthrough_) {
+    maybeAttachRawHeaderBlock();
+  }
 
-  if (!(parser_.http_major == 1 && parser_.http_minor == 1)) {
+  if (!parser_->isHttp11()) {
     // This is not necessarily true, but it's good enough since higher layers only care if this is
     // HTTP/1.1 or not.
     protocol_ = Protocol::Http10;
@@ -728,7 +862,7 @@ Envoy::StatusOr<int> ConnectionImpl::onHeadersCompleteBase() {
       handling_upgrade_ = true;
     }
   }
-  if (parser_.method == HTTP_CONNECT) {
+  if (parser_->methodName() == Headers::get().MethodValues.Connect) {
     if (request_or_response_headers.ContentLength()) {
       if (request_or_response_headers.getContentLengthValue() == "0") {
         request_or_response_headers.removeContentLength();
@@ -756,8 +890,8 @@ Envoy::StatusOr<int> ConnectionImpl::onHeadersCompleteBase() {
   // Reject message with Http::Code::BadRequest if both Transfer-Encoding and Content-Length
   // headers are present or if allowed by http1 codec settings and 'Transfer-Encoding'
   // is chunked - remove Content-Length and serve request.
-  if (parser_.uses_transfer_encoding != 0 && request_or_response_headers.ContentLength()) {
-    if ((parser_.flags & F_CHUNKED) && codec_settings_.allow_chunked_length_) {
+  if (parser_->hasTransferEncoding() && request_or_response_headers.ContentLength()) {
+    if (parser_->isChunked() && codec_settings_.allow_chunked_length_) {
       request_or_response_headers.removeContentLength();
     } else {
       error_code_ = Http::Code::BadRequest;
@@ -774,22 +908,23 @@ Envoy::StatusOr<int> ConnectionImpl::onHeadersCompleteBase() {
   if (request_or_response_headers.TransferEncoding()) {
     const absl::string_view encoding = request_or_response_headers.getTransferEncodingValue();
     if (!absl::EqualsIgnoreCase(encoding, Headers::get().TransferEncodingValues.Chunked) ||
-        parser_.method == HTTP_CONNECT) {
+        parser_->methodName() == Headers::get().MethodValues.Connect) {
       error_code_ = Http::Code::NotImplemented;
       RETURN_IF_ERROR(sendProtocolError(Http1ResponseCodeDetails::get().InvalidTransferEncoding));
       return codecProtocolError("http/1.1 protocol error: unsupported transfer encoding");
     }
   }
 
-  auto statusor = onHeadersComplete();
+  auto statusor = onHeadersCompleteImpl();
   if (!statusor.ok()) {
     RETURN_IF_ERROR(statusor.status());
   }
 
   header_parsing_state_ = HeaderParsingState::Done;
 
-  // Returning 2 informs http_parser to not expect a body or further data on this connection.
-  return handling_upgrade_ ? 2 : statusor.value();
+  // Returning NoBodyData informs the parser to not expect a body or further data on this
+  // connection.
+  return handling_upgrade_ ? CallbackResult::NoBodyData : statusor.value();
 }
 
 void ConnectionImpl::bufferBody(const char* data, size_t length) {
@@ -803,7 +938,7 @@ void ConnectionImpl::bufferBody(const char* data, size_t length) {
 }
 
 void ConnectionImpl::dispatchBufferedBody() {
-  ASSERT(HTTP_PARSER_ERRNO(&parser_) == HPE_OK || HTTP_PARSER_ERRNO(&parser_) == HPE_PAUSED);
+  ASSERT(parser_->getStatus() != ParserStatus::Error);
   ASSERT(codec_status_.ok());
   if (buffered_body_.length() > 0) {
     onBody(buffered_body_);
@@ -829,7 +964,7 @@ Status ConnectionImpl::onMessageCompleteBase() {
     // upgrade payload will be treated as stream body.
     ASSERT(!deferred_end_stream_headers_);
     ENVOY_CONN_LOG(trace, "Pausing parser due to upgrade.", connection_);
-    http_parser_pause(&parser_, 1);
+    parser_->pause();
     return okStatus();
   }
 
@@ -839,7 +974,7 @@ Status ConnectionImpl::onMessageCompleteBase() {
     RETURN_IF_ERROR(completeLastHeader());
   }
 
-  onMessageComplete();
+  onMessageCompleteImpl();
   return okStatus();
 }
 
@@ -851,13 +986,19 @@ Status ConnectionImpl::onMessageBeginBase() {
   protocol_ = Protocol::Http11;
   processing_trailers_ = false;
   header_parsing_state_ = HeaderParsingState::Field;
+  raw_header_block_begin_ = nullptr;
+  raw_header_block_end_ = nullptr;
   allocHeaders();
-  return onMessageBegin();
+  return onMessageBeginImpl();
 }
 
 void ConnectionImpl::onResetStreamBase(StreamResetReason reason) {
   ASSERT(!reset_stream_called_);
   reset_stream_called_ = true;
+  // Write what was encoded before the reset, as it would have been without coalescing.
+  if (output_buffer_->length() > 0 && connection_.state() != Network::Connection::State::Closed) {
+    writeOutput();
+  }
   onResetStream(reason);
 }
 
@@ -867,7 +1008,7 @@ ServerConnectionImpl::ServerConnectionImpl(
     const uint32_t max_request_headers_count,
     envoy::config::core::v3::HttpProtocolOptions::HeadersWithUnderscoresAction
         headers_with_underscores_action)
-    : ConnectionImpl(connection, stats, settings, HTTP_REQUEST, max_request_headers_kb,
+    : ConnectionImpl(connection, stats, settings, MessageType::Request, max_request_headers_kb,
                      max_request_headers_count, formatter(settings)),
       callbacks_(callbacks),
       response_buffer_releasor_([this](const Buffer::OwnedBufferFragmentImpl* fragment) {
@@ -879,7 +1020,18 @@ ServerConnectionImpl::ServerConnectionImpl(
       // maintainer team as it will otherwise be removed entirely soon.
       max_outbound_responses_(
           Runtime::getInteger("envoy.do_not_use_going_away_max_http2_outbound_responses", 2)),
-      headers_with_underscores_action_(headers_with_underscores_action) {}
+      headers_with_underscores_action_(headers_with_underscores_action) {
+  if (codec_settings_.coalesce_response_writes_) {
+    coalesce_output_ = true;
+    if (codec_settings_.response_headers_hold_time_.count() > 0) {
+      header_hold_timer_ = connection.dispatcher().createTimer([this]() {
+        if (connection_.state() != Network::Connection::State::Closed) {
+          writeOutput();
+        }
+      });
+    }
+  }
+}
 
 uint32_t ServerConnectionImpl::getHeadersSize() {
   // Add in the size of the request URL if processing request headers.
@@ -898,16 +1050,17 @@ void ServerConnectionImpl::onEncodeComplete() {
   }
 }
 
-Status ServerConnectionImpl::handlePath(RequestHeaderMap& headers, unsigned int method) {
+Status ServerConnectionImpl::handlePath(RequestHeaderMap& headers, absl::string_view method) {
   HeaderString path(Headers::get().Path);
 
-  bool is_connect = (method == HTTP_CONNECT);
+  bool is_connect = (method == Headers::get().MethodValues.Connect);
 
   // The url is relative or a wildcard when the method is OPTIONS. Nothing to do here.
   auto& active_request = active_request_.value();
   if (!is_connect && !active_request.request_url_.getStringView().empty() &&
       (active_request.request_url_.getStringView()[0] == '/' ||
-       ((method == HTTP_OPTIONS) && active_request.request_url_.getStringView()[0] == '*'))) {
+       ((method == Headers::get().MethodValues.Options) &&
+        active_request.request_url_.getStringView()[0] == '*'))) {
     headers.addViaMove(std::move(path), std::move(active_request.request_url_));
     return okStatus();
   }
@@ -942,7 +1095,7 @@ Status ServerConnectionImpl::handlePath(RequestHeaderMap& headers, unsigned int
   return okStatus();
 }
 
-Envoy::StatusOr<int> ServerConnectionImpl::onHeadersComplete() {
+Envoy::StatusOr<CallbackResult> ServerConnectionImpl::onHeadersCompleteImpl() {
   // Handle the case where response happens prior to request complete. It's up to upper layer code
   // to disconnect the connection but we shouldn't fire any more events since it doesn't make
   // sense.
@@ -950,7 +1103,7 @@ Envoy::StatusOr<int> ServerConnectionImpl::onHeadersComplete() {
     auto& active_request = active_request_.value();
     auto& headers = absl::get<RequestHeaderMapPtr>(headers_or_trailers_);
     ENVOY_CONN_LOG(trace, "Server: onHeadersComplete size={}", connection_, headers->size());
-    const char* method_string = http_method_str(static_cast<http_method>(parser_.method));
+    const absl::string_view method_string = parser_->methodName();
 
     if (!handling_upgrade_ && headers->Connection()) {
       // If we fail to sanitize the request, return a 400 to the client
@@ -967,10 +1120,12 @@ Envoy::StatusOr<int> ServerConnectionImpl::onHeadersComplete() {
 
     // Inform the response encoder about any HEAD method, so it can set content
     // length and transfer encoding headers correctly.
-    active_request.response_encoder_.setIsResponseToHeadRequest(parser_.method == HTTP_HEAD);
-    active_request.response_encoder_.setIsResponseToConnectRequest(parser_.method == HTTP_CONNECT);
+    active_request.response_encoder_.setIsResponseToHeadRequest(
+        method_string == Headers::get().MethodValues.Head);
+    active_request.response_encoder_.setIsResponseToConnectRequest(
+        method_string == Headers::get().MethodValues.Connect);
 
-    RETURN_IF_ERROR(handlePath(*headers, parser_.method));
+    RETURN_IF_ERROR(handlePath(*headers, method_string));
     ASSERT(active_request.request_url_.empty());
 
     headers->setMethod(method_string);
@@ -989,24 +1144,25 @@ Envoy::StatusOr<int> ServerConnectionImpl::onHeadersComplete() {
     // with message complete. This allows upper layers to behave like HTTP/2 and prevents a proxy
     // scenario where the higher layers stream through and implicitly switch to chunked transfer
     // encoding because end stream with zero body length has not yet been indicated.
-    if (parser_.flags & F_CHUNKED ||
-        (parser_.content_length > 0 && parser_.content_length != ULLONG_MAX) || handling_upgrade_) {
+    if (parser_->isChunked() ||
+        (parser_->contentLength().has_value() && parser_->contentLength().value() > 0) ||
+        handling_upgrade_) {
       active_request.request_decoder_->decodeHeaders(std::move(headers), false);
 
       // If the connection has been closed (or is closing) after decoding headers, pause the parser
       // so we return control to the caller.
       if (connection_.state() != Network::Connection::State::Open) {
-        http_parser_pause(&parser_, 1);
+        parser_->pause();
       }
     } else {
       deferred_end_stream_headers_ = true;
     }
   }
 
-  return 0;
+  return CallbackResult::Success;
 }
 
-Status ServerConnectionImpl::onMessageBegin() {
+Status ServerConnectionImpl::onMessageBeginImpl() {
   if (!resetStreamCalled()) {
     ASSERT(!active_request_.has_value());
     active_request_.emplace(*this, header_key_formatter_.get());
@@ -1024,7 +1180,7 @@ Status ServerConnectionImpl::onMessageBegin() {
   return okStatus();
 }
 
-Status ServerConnectionImpl::onUrl(const char* data, size_t length) {
+Status ServerConnectionImpl::onUrlImpl(const char* data, size_t length) {
   if (active_request_.has_value()) {
     active_request_.value().request_url_.append(data, length);
 
@@ -1041,7 +1197,7 @@ void ServerConnectionImpl::onBody(Buffer::Instance& data) {
   }
 }
 
-void ServerConnectionImpl::onMessageComplete() {
+void ServerConnectionImpl::onMessageCompleteImpl() {
   ASSERT(!handling_upgrade_);
   if (active_request_.has_value()) {
     auto& active_request = active_request_.value();
@@ -1069,7 +1225,7 @@ void ServerConnectionImpl::onMessageComplete() {
   // Always pause the parser so that the calling code can process 1 request at a time and apply
   // back pressure. However this means that the calling code needs to detect if there is more data
   // in the buffer and dispatch it again.
-  http_parser_pause(&parser_, 1);
+  parser_->pause();
 }
 
 void ServerConnectionImpl::onResetStream(StreamResetReason reason) {
@@ -1091,7 +1247,9 @@ void ServerConnectionImpl::sendProtocolErrorOld(absl::string_view details) {
         absl::StrCat("HTTP/1.1 ", error_code_, " ", CodeUtility::toString(error_code_),
                      "\r\ncontent-length: 0\r\nconnection: close\r\n\r\n"));
 
-    connection_.write(bad_request_response, false);
+    // Goes through the output buffer to be written after any coalesced output.
+    buffer().move(bad_request_response);
+    flushOutput();
   }
 }
 
@@ -1166,16 +1324,16 @@ Status ServerConnectionImpl::checkHeaderNameForUnderscores() {
 ClientConnectionImpl::ClientConnectionImpl(Network::Connection& connection, CodecStats& stats,
                                            ConnectionCallbacks&, const Http1Settings& settings,
                                            const uint32_t max_response_headers_count)
-    : ConnectionImpl(connection, stats, settings, HTTP_RESPONSE, MAX_RESPONSE_HEADERS_KB,
+    : ConnectionImpl(connection, stats, settings, MessageType::Response, MAX_RESPONSE_HEADERS_KB,
                      max_response_headers_count, formatter(settings)) {}
 
 bool ClientConnectionImpl::cannotHaveBody() {
   if (pending_response_.has_value() && pending_response_.value().encoder_.headRequest()) {
     ASSERT(!pending_response_done_);
     return true;
-  } else if (parser_.status_code == 204 || parser_.status_code == 304 ||
-             (parser_.status_code >= 200 && parser_.content_length == 0 &&
-              !(parser_.flags & F_CHUNKED))) {
+  } else if (parser_->statusCode() == 204 || parser_->statusCode() == 304 ||
+             (parser_->statusCode() >= 200 && parser_->contentLength().has_value() &&
+              parser_->contentLength().value() == 0 && !parser_->isChunked())) {
     return true;
   } else {
     return false;
@@ -1194,21 +1352,21 @@ RequestEncoder& ClientConnectionImpl::newStream(ResponseDecoder& response_decode
   return pending_response_.value().encoder_;
 }
 
-Envoy::StatusOr<int> ClientConnectionImpl::onHeadersComplete() {
-  ENVOY_CONN_LOG(trace, "status_code {}", connection_, parser_.status_code);
+Envoy::StatusOr<CallbackResult> ClientConnectionImpl::onHeadersCompleteImpl() {
+  ENVOY_CONN_LOG(trace, "status_code {}", connection_, parser_->statusCode());
 
   // Handle the case where the client is closing a kept alive connection (by sending a 408
   // with a 'Connection: close' header). In this case we just let response flush out followed
   // by the remote close.
   if (!pending_response_.has_value() && !resetStreamCalled()) {
-    return prematureResponseError("", static_cast<Http::Code>(parser_.status_code));
+    return prematureResponseError("", static_cast<Http::Code>(parser_->statusCode()));
   } else if (pending_response_.has_value()) {
     ASSERT(!pending_response_done_);
     auto& headers = absl::get<ResponseHeaderMapPtr>(headers_or_trailers_);
     ENVOY_CONN_LOG(trace, "Client: onHeadersComplete size={}", connection_, headers->size());
-    headers->setStatus(parser_.status_code);
+    headers->setStatus(parser_->statusCode());
 
-    if (parser_.status_code >= 200 && parser_.status_code < 300 &&
+    if (parser_->statusCode() >= 200 && parser_->statusCode() < 300 &&
         pending_response_.value().encoder_.connectRequest()) {
       ENVOY_CONN_LOG(trace, "codec entering upgrade mode for CONNECT response.", connection_);
       handling_upgrade_ = true;
@@ -1223,7 +1381,8 @@ Envoy::StatusOr<int> ClientConnectionImpl::onHeadersComplete() {
       }
     }
 
-    if (strict_1xx_and_204_headers_ && (parser_.status_code < 200 || parser_.status_code == 204)) {
+    if (strict_1xx_and_204_headers_ &&
+        (parser_->statusCode() < 200 || parser_->statusCode() == 204)) {
       if (headers->TransferEncoding()) {
         RETURN_IF_ERROR(
             sendProtocolError(Http1ResponseCodeDetails::get().TransferEncodingNotAllowed));
@@ -1244,7 +1403,7 @@ Envoy::StatusOr<int> ClientConnectionImpl::onHeadersComplete() {
       }
     }
 
-    if (parser_.status_code == enumToInt(Http::Code::Continue)) {
+    if (parser_->statusCode() == enumToInt(Http::Code::Continue)) {
       pending_response_.value().decoder_->decode100ContinueHeaders(std::move(headers));
     } else if (cannotHaveBody() && !handling_upgrade_) {
       deferred_end_stream_headers_ = true;
@@ -1256,17 +1415,17 @@ Envoy::StatusOr<int> ClientConnectionImpl::onHeadersComplete() {
     // onMessageComplete and continue processing for purely informational headers.
     // 101-SwitchingProtocols is exempt as all data after the header is proxied through after
     // upgrading.
-    if (CodeUtility::is1xx(parser_.status_code) &&
-        parser_.status_code != enumToInt(Http::Code::SwitchingProtocols)) {
+    if (CodeUtility::is1xx(parser_->statusCode()) &&
+        parser_->statusCode() != enumToInt(Http::Code::SwitchingProtocols)) {
       ignore_message_complete_for_1xx_ = true;
       // Reset to ensure no information from the 1xx headers is used for the response headers.
       headers_or_trailers_.emplace<ResponseHeaderMapPtr>(nullptr);
     }
   }
 
-  // Here we deal with cases where the response cannot have a body by returning 1, but http_parser
-  // does not deal with it for us.
-  return cannotHaveBody() ? 1 : 0;
+  // Here we deal with cases where the response cannot have a body by returning NoBody, but the
+  // parser does not deal with it for us.
+  return cannotHaveBody() ? CallbackResult::NoBody : CallbackResult::Success;
 }
 
 bool ClientConnectionImpl::upgradeAllowed() const {
@@ -1284,7 +1443,7 @@ void ClientConnectionImpl::onBody(Buffer::Instance& data) {
   }
 }
 
-void ClientConnectionImpl::onMessageComplete() {
+void ClientConnectionImpl::onMessageCompleteImpl() {
   ENVOY_CONN_LOG(trace, "message complete", connection_);
   if (ignore_message_complete_for_1xx_) {
     ignore_message_complete_for_1xx_ = false;
@@ -1316,7 +1475,7 @@ void ClientConnectionImpl::onMessageComplete() {
   }
 
   // Pause the parser after a response is complete. Any remaining data indicates an error.
-  http_parser_pause(&parser_, 1);
+  parser_->pause();
 }
 
 void ClientConnectionImpl::onResetStream(StreamResetReason reason) {
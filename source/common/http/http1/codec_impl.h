@@ -1,7 +1,5 @@
 #pragma once
 
-#include <http_parser.h>
-
 #include <array>
 #include <cstdint>
 #include <list>
@@ -9,6 +7,7 @@
 #include <string>
 
 #include "envoy/config/core/v3/protocol.pb.h"
+#include "envoy/event/timer.h"
 #include "envoy/http/codec.h"
 #include "envoy/network/connection.h"
 
@@ -20,6 +19,8 @@
 #include "common/http/header_map_impl.h"
 #include "common/http/http1/codec_stats.h"
 #include "common/http/http1/header_formatter.h"
+#include "common/http/http1/parser.h"
+#include "common/http/raw_header_block.h"
 #include "common/http/status.h"
 
 namespace Envoy {
@@ -63,9 +64,10 @@ public:
   absl::string_view responseDetails() override { return details_; }
   const Network::Address::InstanceConstSharedPtr& connectionLocalAddress() override;
   void setFlushTimeout(std::chrono::milliseconds) override {
-    // HTTP/1 has one stream per connection, thus any data encoded is immediately written to the
-    // connection, invoking any watermarks as necessary. There is no internal buffering that would
-    // require a flush timeout not already covered by other timeouts.
+    // HTTP/1 has one stream per connection, thus any data encoded is written to the connection
+    // once encoded, or at the latest once the dispatch or the header hold time is over, invoking
+    // any watermarks as necessary. There is no internal buffering that would require a flush
+    // timeout not already covered by other timeouts.
   }
 
   void setIsResponseToHeadRequest(bool value) { is_response_to_head_request_ = value; }
@@ -76,7 +78,8 @@ public:
 
 protected:
   StreamEncoderImpl(ConnectionImpl& connection, HeaderKeyFormatter* header_key_formatter);
-  void encodeHeadersBase(const RequestOrResponseHeaderMap& headers, absl::optional<uint64_t> status,
+  void encodeHeadersBase(const RequestOrResponseHeaderMap& headers,
+                         const RawHeaderBlock* raw_header_block, absl::optional<uint64_t> status,
                          bool end_stream);
   void encodeTrailersBase(const HeaderMap& headers);
 
@@ -115,6 +118,19 @@ private:
 
   void encodeFormattedHeader(absl::string_view key, absl::string_view value);
 
+  /**
+   * @return uint64_t an upper bound on the serialized size of the header lines for headers, plus
+   *         any header the encoder may add and the blank line that ends the header block.
+   */
+  static uint64_t headerBlockSize(const HeaderMap& headers,
+                                  const RawHeaderBlock* raw_header_block = nullptr);
+
+  /**
+   * @return the header lines that headers were decoded from if they can be copied into the
+   *         encoded header block, or nullptr if every header must be formatted.
+   */
+  const RawHeaderBlock* rawHeaderBlock(const HeaderMap& headers) const;
+
   const HeaderKeyFormatter* const header_key_formatter_;
   absl::string_view details_;
 };
@@ -167,10 +183,12 @@ private:
 
 /**
  * Base class for HTTP/1.1 client and server connections.
- * Handles the callbacks of http_parser with its own base routine and then
+ * Handles the callbacks of the HTTP/1 parser with its own base routine and then
  * virtual dispatches to its subclasses.
  */
-class ConnectionImpl : public virtual Connection, protected Logger::Loggable<Logger::Id::http> {
+class ConnectionImpl : public virtual Connection,
+                       protected Logger::Loggable<Logger::Id::http>,
+                       public ParserCallbacks {
 public:
   /**
    * @return Network::Connection& the backing network connection.
@@ -194,13 +212,28 @@ public:
    */
   void flushOutput(bool end_encode = false);
 
+  /**
+   * Flush the pending output after encoding the headers of a response whose body follows. The
+   * output may be held until the first body data is encoded if the connection is configured to.
+   */
+  void flushHeaders();
+
+  // The following write into the space obtained by reserveBuffer(), which must be large enough
+  // to hold the data. The reservation is committed to the output buffer by flushOutput().
   void addToBuffer(absl::string_view data);
   void addCharToBuffer(char c);
   void addIntToBuffer(uint64_t i);
-  Buffer::Instance& buffer() { return *output_buffer_; }
   uint64_t bufferRemainingSize();
   void copyToBuffer(const char* data, uint64_t length);
+  /**
+   * Reserve contiguous space in the output buffer for at least size bytes of serialized headers.
+   * @param size supplies the number of bytes that will be written.
+   */
   void reserveBuffer(uint64_t size);
+  Buffer::Instance& buffer() {
+    ASSERT(reserved_current_ == nullptr);
+    return *output_buffer_;
+  }
   void readDisable(bool disable) {
     if (connection_.state() == Network::Connection::State::Open) {
       connection_.readDisable(disable);
@@ -218,42 +251,47 @@ public:
   void goAway() override {} // Called during connection manager drain flow
   Protocol protocol() override { return protocol_; }
   void shutdownNotice() override {} // Called during connection manager drain flow
-  bool wantsToWrite() override { return false; }
+  bool wantsToWrite() override { return output_buffer_->length() > 0; }
   void onUnderlyingConnectionAboveWriteBufferHighWatermark() override { onAboveHighWatermark(); }
   void onUnderlyingConnectionBelowWriteBufferLowWatermark() override { onBelowLowWatermark(); }
 
   bool strict1xxAnd204Headers() { return strict_1xx_and_204_headers_; }
+  bool rawHeaderPassthrough() const { return raw_header_passthrough_; }
+
+  CallbackResult setAndCheckCallbackStatus(Status&& status);
+  CallbackResult setAndCheckCallbackStatusOr(Envoy::StatusOr<CallbackResult>&& statusor);
 
-  int setAndCheckCallbackStatus(Status&& status);
-  int setAndCheckCallbackStatusOr(Envoy::StatusOr<int>&& statusor);
+  // Http1::ParserCallbacks
+  CallbackResult onMessageBegin() override {
+    return setAndCheckCallbackStatus(onMessageBeginBase());
+  }
+  CallbackResult onUrl(const char* data, size_t length) override {
+    return setAndCheckCallbackStatus(onUrlImpl(data, length));
+  }
+  CallbackResult onHeaderField(const char* data, size_t length) override {
+    return setAndCheckCallbackStatus(onHeaderFieldImpl(data, length));
+  }
+  CallbackResult onHeaderValue(const char* data, size_t length) override {
+    return setAndCheckCallbackStatus(onHeaderValueImpl(data, length));
+  }
+  CallbackResult onHeadersComplete() override {
+    return setAndCheckCallbackStatusOr(onHeadersCompleteBase());
+  }
+  void bufferBody(const char* data, size_t length) override;
+  CallbackResult onMessageComplete() override {
+    return setAndCheckCallbackStatus(onMessageCompleteBase());
+  }
+  void onChunkHeader(bool is_final_chunk) override;
 
-  // Codec errors found in callbacks are overridden within the http_parser library. This holds those
+  // Codec errors found in callbacks are overridden within the HTTP/1 parser. This holds those
   // errors to propagate them through to dispatch() where we can handle the error.
   Envoy::Http::Status codec_status_;
 
 protected:
   ConnectionImpl(Network::Connection& connection, CodecStats& stats, const Http1Settings& settings,
-                 http_parser_type type, uint32_t max_headers_kb, const uint32_t max_headers_count,
+                 MessageType type, uint32_t max_headers_kb, const uint32_t max_headers_count,
                  HeaderKeyFormatterPtr&& header_key_formatter);
 
-  // The following define special return values for http_parser callbacks. See:
-  // https://github.com/nodejs/http-parser/blob/5c5b3ac62662736de9e71640a8dc16da45b32503/http_parser.h#L72
-  // These codes do not overlap with standard HTTP Status codes. They are only used for user
-  // callbacks.
-  enum class HttpParserCode {
-    // Callbacks other than on_headers_complete should return a non-zero int to indicate an error
-    // and
-    // halt execution.
-    Error = -1,
-    Success = 0,
-    // Returning '1' from on_headers_complete will tell http_parser that it should not expect a
-    // body.
-    NoBody = 1,
-    // Returning '2' from on_headers_complete will tell http_parser that it should not expect a body
-    // nor any further data on the connection.
-    NoBodyData = 2,
-  };
-
   bool resetStreamCalled() { return reset_stream_called_; }
   Status onMessageBeginBase();
 
@@ -274,7 +312,7 @@ protected:
   Network::Connection& connection_;
   CodecStats& stats_;
   const Http1Settings codec_settings_;
-  http_parser parser_;
+  ParserPtr parser_;
   Buffer::Instance* current_dispatching_buffer_{};
   Http::Code error_code_{Http::Code::BadRequest};
   const HeaderKeyFormatterPtr header_key_formatter_;
@@ -290,6 +328,21 @@ protected:
   const bool strict_1xx_and_204_headers_ : 1;
   bool dispatching_ : 1;
   bool dispatching_slice_already_drained_ : 1;
+  const bool use_header_arena_ : 1;
+  // The arena for the header maps of the message being decoded, shared by its headers and trailers.
+  // Null if header maps are allocated from the heap.
+  HeaderArenaSharedPtr header_arena_;
+  const bool raw_header_passthrough_ : 1;
+  // The first byte of the first header name and the byte after the last header value of the
+  // message being decoded, if they were seen in dispatched slice number raw_header_block_slice_.
+  const char* raw_header_block_begin_{};
+  const char* raw_header_block_end_{};
+  uint64_t raw_header_block_slice_{};
+  uint64_t dispatched_slices_{};
+  // Whether the output encoded while dispatching is written once the dispatch is over, and the
+  // timer of the output held for the body of a response, if held. Set by server connections only.
+  bool coalesce_output_{};
+  Event::TimerPtr header_hold_timer_;
 
 private:
   enum class HeaderParsingState { Field, Value, Done };
@@ -305,6 +358,26 @@ private:
    */
   Status completeLastHeader();
 
+  /**
+   * Commits the outstanding reservation of the output buffer, if any.
+   */
+  void commitReservation();
+
+  /**
+   * Writes the pending output to the connection.
+   */
+  void writeOutput();
+
+  bool holdingOutput() const {
+    return header_hold_timer_ != nullptr && header_hold_timer_->enabled();
+  }
+
+  /**
+   * Attaches the header lines of the message to the decoded headers if they were all dispatched
+   * in a single slice.
+   */
+  void maybeAttachRawHeaderBlock();
+
   /**
    * Check if header name contains underscore character.
    * Underscore character is allowed in header names by the RFC-7230 and this check is implemented
@@ -333,13 +406,6 @@ private:
    */
   Envoy::StatusOr<size_t> dispatchSlice(const char* slice, size_t len);
 
-  /**
-   * Called by the http_parser when body data is received.
-   * @param data supplies the start address.
-   * @param length supplies the length.
-   */
-  void bufferBody(const char* data, size_t length);
-
   /**
    * Push the accumulated body through the filter pipeline.
    */
@@ -349,14 +415,14 @@ private:
    * Called when a request/response is beginning. A base routine happens first then a virtual
    * dispatch is invoked.
    */
-  virtual Status onMessageBegin() PURE;
+  virtual Status onMessageBeginImpl() PURE;
 
   /**
    * Called when URL data is received.
    * @param data supplies the start address.
    * @param length supplies the length.
    */
-  virtual Status onUrl(const char* data, size_t length) PURE;
+  virtual Status onUrlImpl(const char* data, size_t length) PURE;
 
   /**
    * Called when header field data is received.
@@ -364,7 +430,7 @@ private:
    * @param length supplies the length.
    * @return A status representing success.
    */
-  Status onHeaderField(const char* data, size_t length);
+  Status onHeaderFieldImpl(const char* data, size_t length);
 
   /**
    * Called when header value data is received.
@@ -372,16 +438,16 @@ private:
    * @param length supplies the length.
    * @return A status representing success.
    */
-  Status onHeaderValue(const char* data, size_t length);
+  Status onHeaderValueImpl(const char* data, size_t length);
 
   /**
    * Called when headers are complete. A base routine happens first then a virtual dispatch is
    * invoked. Note that this only applies to headers and NOT trailers. End of
    * trailers are signaled via onMessageCompleteBase().
-   * @return An error status or an integer representing 0 if no error, 1 if there should be no body.
+   * @return An error status or a CallbackResult indicating whether a body is expected.
    */
-  Envoy::StatusOr<int> onHeadersCompleteBase();
-  virtual Envoy::StatusOr<int> onHeadersComplete() PURE;
+  Envoy::StatusOr<CallbackResult> onHeadersCompleteBase();
+  virtual Envoy::StatusOr<CallbackResult> onHeadersCompleteImpl() PURE;
 
   /**
    * Called to see if upgrade transition is allowed.
@@ -405,12 +471,7 @@ private:
    * @return A status representing success.
    */
   Status onMessageCompleteBase();
-  virtual void onMessageComplete() PURE;
-
-  /**
-   * Called when accepting a chunk header.
-   */
-  void onChunkHeader(bool is_final_chunk);
+  virtual void onMessageCompleteImpl() PURE;
 
   /**
    * @see onResetStreamBase().
@@ -441,8 +502,6 @@ private:
    */
   virtual Status checkHeaderNameForUnderscores() { return okStatus(); }
 
-  static http_parser_settings settings_;
-
   HeaderParsingState header_parsing_state_{HeaderParsingState::Field};
   // Used to accumulate the HTTP message body during the current dispatch call. The accumulated body
   // is pushed through the filter pipeline either at the end of the current dispatch call, or when
@@ -451,6 +510,10 @@ private:
   // Buffer used to encode the HTTP message before moving it to the network connection's output
   // buffer. This buffer is always allocated, never nullptr.
   Buffer::InstancePtr output_buffer_;
+  // Space reserved in output_buffer_ for serializing a header block, and the write position within
+  // it. reserved_current_ is nullptr when there is no outstanding reservation.
+  Buffer::RawSlice reserved_iovec_;
+  char* reserved_current_{};
   Protocol protocol_{Protocol::Http11};
   const uint32_t max_headers_kb_;
   const uint32_t max_headers_count_;
@@ -484,7 +547,7 @@ protected:
   };
   absl::optional<ActiveRequest>& activeRequest() { return active_request_; }
   // ConnectionImpl
-  void onMessageComplete() override;
+  void onMessageCompleteImpl() override;
   // Add the size of the request_url to the reported header size when processing request headers.
   uint32_t getHeadersSize() override;
 
@@ -493,18 +556,18 @@ private:
    * Manipulate the request's first line, parsing the url and converting to a relative path if
    * necessary. Compute Host / :authority headers based on 7230#5.7 and 7230#6
    *
-   * @param is_connect true if the request has the CONNECT method
    * @param headers the request's headers
+   * @param method the request's method
    * @return Status representing success or failure. This will fail if there is an invalid url in
    * the request line.
    */
-  Status handlePath(RequestHeaderMap& headers, unsigned int method);
+  Status handlePath(RequestHeaderMap& headers, absl::string_view method);
 
   // ConnectionImpl
   void onEncodeComplete() override;
-  Status onMessageBegin() override;
-  Status onUrl(const char* data, size_t length) override;
-  Envoy::StatusOr<int> onHeadersComplete() override;
+  Status onMessageBeginImpl() override;
+  Status onUrlImpl(const char* data, size_t length) override;
+  Envoy::StatusOr<CallbackResult> onHeadersCompleteImpl() override;
   // If upgrade behavior is not allowed, the HCM will have sanitized the headers out.
   bool upgradeAllowed() const override { return true; }
   void onBody(Buffer::Instance& data) override;
@@ -525,12 +588,15 @@ private:
   void allocHeaders() override {
     ASSERT(nullptr == absl::get<RequestHeaderMapPtr>(headers_or_trailers_));
     ASSERT(!processing_trailers_);
-    headers_or_trailers_.emplace<RequestHeaderMapPtr>(RequestHeaderMapImpl::create());
+    header_arena_ = use_header_arena_ ? std::make_shared<HeaderArena>() : nullptr;
+    headers_or_trailers_.emplace<RequestHeaderMapPtr>(
+        RequestHeaderMapImpl::create(header_arena_));
   }
   void allocTrailers() override {
     ASSERT(processing_trailers_);
     if (!absl::holds_alternative<RequestTrailerMapPtr>(headers_or_trailers_)) {
-      headers_or_trailers_.emplace<RequestTrailerMapPtr>(RequestTrailerMapImpl::create());
+      headers_or_trailers_.emplace<RequestTrailerMapPtr>(
+          RequestTrailerMapImpl::create(header_arena_));
     }
   }
 
@@ -586,12 +652,12 @@ private:
   // ConnectionImpl
   Http::Status dispatch(Buffer::Instance& data) override;
   void onEncodeComplete() override {}
-  Status onMessageBegin() override { return okStatus(); }
-  Status onUrl(const char*, size_t) override { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
-  Envoy::StatusOr<int> onHeadersComplete() override;
+  Status onMessageBeginImpl() override { return okStatus(); }
+  Status onUrlImpl(const char*, size_t) override { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+  Envoy::StatusOr<CallbackResult> onHeadersCompleteImpl() override;
   bool upgradeAllowed() const override;
   void onBody(Buffer::Instance& data) override;
-  void onMessageComplete() override;
+  void onMessageCompleteImpl() override;
   void onResetStream(StreamResetReason reason) override;
   Status sendProtocolError(absl::string_view details) override;
   void onAboveHighWatermark() override;
@@ -609,12 +675,15 @@ private:
   void allocHeaders() override {
     ASSERT(nullptr == absl::get<ResponseHeaderMapPtr>(headers_or_trailers_));
     ASSERT(!processing_trailers_);
-    headers_or_trailers_.emplace<ResponseHeaderMapPtr>(ResponseHeaderMapImpl::create());
+    header_arena_ = use_header_arena_ ? std::make_shared<HeaderArena>() : nullptr;
+    headers_or_trailers_.emplace<ResponseHeaderMapPtr>(
+        ResponseHeaderMapImpl::create(header_arena_));
   }
   void allocTrailers() override {
     ASSERT(processing_trailers_);
     if (!absl::holds_alternative<ResponseTrailerMapPtr>(headers_or_trailers_)) {
-      headers_or_trailers_.emplace<ResponseTrailerMapPtr>(ResponseTrailerMapImpl::create());
+      headers_or_trailers_.emplace<ResponseTrailerMapPtr>(
+          ResponseTrailerMapImpl::create(header_arena_));
     }
   }
 
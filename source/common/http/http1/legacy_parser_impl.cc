@@ -0,0 +1,146 @@
+#include "common/http/http1/legacy_parser_impl.h"
+
+#include <http_parser.h>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+class LegacyHttpParserImpl::Impl {
+public:
+  Impl(http_parser_type type, ParserCallbacks* data) {
+    http_parser_init(&parser_, type);
+    parser_.allow_chunked_length = 1;
+    parser_.data = data;
+  }
+
+  size_t execute(const char* data, size_t length) {
+    return http_parser_execute(&parser_, &settings_, data, length);
+  }
+
+  void resume() { http_parser_pause(&parser_, 0); }
+
+  void pause() { http_parser_pause(&parser_, 1); }
+
+  ParserStatus getStatus() const {
+    switch (HTTP_PARSER_ERRNO(&parser_)) {
+    case HPE_OK:
+      return ParserStatus::Ok;
+    case HPE_PAUSED:
+      return ParserStatus::Paused;
+    default:
+      return ParserStatus::Error;
+    }
+  }
+
+  absl::string_view errorMessage() const {
+    return http_errno_name(static_cast<http_errno>(HTTP_PARSER_ERRNO(&parser_)));
+  }
+
+  uint16_t statusCode() const { return parser_.status_code; }
+
+  bool isHttp11() const { return parser_.http_major == 1 && parser_.http_minor == 1; }
+
+  absl::optional<uint64_t> contentLength() const {
+    // http_parser uses ULLONG_MAX to indicate that the content length is unknown.
+    if (parser_.content_length == ULLONG_MAX) {
+      return absl::nullopt;
+    }
+    return parser_.content_length;
+  }
+
+  bool isChunked() const { return parser_.flags & F_CHUNKED; }
+
+  bool hasTransferEncoding() const { return parser_.uses_transfer_encoding != 0; }
+
+  absl::string_view methodName() const {
+    // http_parser leaves the method unset when parsing responses.
+    if (parser_.type != HTTP_REQUEST) {
+      return {};
+    }
+    return http_method_str(static_cast<http_method>(parser_.method));
+  }
+
+private:
+  static ParserCallbacks* callbacks(http_parser* parser) {
+    return static_cast<ParserCallbacks*>(parser->data);
+  }
+
+  http_parser parser_;
+  static http_parser_settings settings_;
+};
+
+http_parser_settings LegacyHttpParserImpl::Impl::settings_{
+    [](http_parser* parser) -> int {
+      return static_cast<int>(callbacks(parser)->onMessageBegin());
+    },
+    [](http_parser* parser, const char* at, size_t length) -> int {
+      return static_cast<int>(callbacks(parser)->onUrl(at, length));
+    },
+    nullptr, // on_status
+    [](http_parser* parser, const char* at, size_t length) -> int {
+      return static_cast<int>(callbacks(parser)->onHeaderField(at, length));
+    },
+    [](http_parser* parser, const char* at, size_t length) -> int {
+      return static_cast<int>(callbacks(parser)->onHeaderValue(at, length));
+    },
+    [](http_parser* parser) -> int {
+      return static_cast<int>(callbacks(parser)->onHeadersComplete());
+    },
+    [](http_parser* parser, const char* at, size_t length) -> int {
+      callbacks(parser)->bufferBody(at, length);
+      return 0;
+    },
+    [](http_parser* parser) -> int {
+      return static_cast<int>(callbacks(parser)->onMessageComplete());
+    },
+    [](http_parser* parser) -> int {
+      // A 0-byte chunk header is used to signal the end of the chunked body.
+      // When this function is called, http-parser holds the size of the chunk in
+      // parser->content_length. See
+      // https://github.com/nodejs/http-parser/blob/v2.9.3/http_parser.h#L336
+      const bool is_final_chunk = (parser->content_length == 0);
+      callbacks(parser)->onChunkHeader(is_final_chunk);
+      return 0;
+    },
+    nullptr // on_chunk_complete
+};
+
+LegacyHttpParserImpl::LegacyHttpParserImpl(MessageType type, ParserCallbacks* data)
+    : impl_(std::make_unique<Impl>(type == MessageType::Request ? HTTP_REQUEST : HTTP_RESPONSE,
+                                   data)) {}
+
+// Because impl_ is a std::unique_ptr to an incomplete type, the destructor must be defined here.
+LegacyHttpParserImpl::~LegacyHttpParserImpl() = default;
+
+size_t LegacyHttpParserImpl::execute(const char* data, size_t length) {
+  return impl_->execute(data, length);
+}
+
+void LegacyHttpParserImpl::resume() { impl_->resume(); }
+
+void LegacyHttpParserImpl::pause() { impl_->pause(); }
+
+ParserStatus LegacyHttpParserImpl::getStatus() const { return impl_->getStatus(); }
+
+absl::string_view LegacyHttpParserImpl::errorMessage() const { return impl_->errorMessage(); }
+
+uint16_t LegacyHttpParserImpl::statusCode() const { return impl_->statusCode(); }
+
+bool LegacyHttpParserImpl::isHttp11() const { return impl_->isHttp11(); }
+
+absl::optional<uint64_t> LegacyHttpParserImpl::contentLength() const {
+  return impl_->contentLength();
+}
+
+bool LegacyHttpParserImpl::isChunked() const { return impl_->isChunked(); }
+
+bool LegacyHttpParserImpl::hasTransferEncoding() const { return impl_->hasTransferEncoding(); }
+
+absl::string_view LegacyHttpParserImpl::methodName() const { return impl_->methodName(); }
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
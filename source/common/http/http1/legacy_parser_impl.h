@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+
+#include "common/http/http1/parser.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * Parser implementation backed by the nodejs http_parser library.
+ */
+class LegacyHttpParserImpl : public Parser {
+public:
+  LegacyHttpParserImpl(MessageType type, ParserCallbacks* data);
+  ~LegacyHttpParserImpl() override;
+
+  // Http1::Parser
+  size_t execute(const char* data, size_t length) override;
+  void resume() override;
+  void pause() override;
+  ParserStatus getStatus() const override;
+  absl::string_view errorMessage() const override;
+  uint16_t statusCode() const override;
+  bool isHttp11() const override;
+  absl::optional<uint64_t> contentLength() const override;
+  bool isChunked() const override;
+  bool hasTransferEncoding() const override;
+  absl::string_view methodName() const override;
+
+private:
+  // The http_parser state is hidden behind a pimpl so that the http_parser header does not leak
+  // into the codec.
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/common/pure.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+enum class MessageType { Request, Response };
+
+// CallbackResult is used to tell the parser how to proceed after a callback. Callbacks other than
+// onHeadersComplete() only return Success or Error.
+enum class CallbackResult {
+  // An error has occurred. Parsing should stop.
+  Error = -1,
+  // Success. Proceed as normal.
+  Success = 0,
+  // Returned by onHeadersComplete() to indicate that the message has no body.
+  NoBody = 1,
+  // Returned by onHeadersComplete() to indicate that the message has no body and that no further
+  // data is expected on the connection.
+  NoBodyData = 2,
+};
+
+/**
+ * Callbacks invoked by a Parser as it makes progress through an HTTP/1 message. Span arguments
+ * point into the data passed to Parser::execute() and are only valid for the duration of the
+ * callback.
+ */
+class ParserCallbacks {
+public:
+  virtual ~ParserCallbacks() = default;
+
+  /**
+   * Called when a request/response is beginning.
+   * @return CallbackResult representing success or failure.
+   */
+  virtual CallbackResult onMessageBegin() PURE;
+
+  /**
+   * Called when URL data is received.
+   * @param data supplies the start address.
+   * @param length supplies the length.
+   * @return CallbackResult representing success or failure.
+   */
+  virtual CallbackResult onUrl(const char* data, size_t length) PURE;
+
+  /**
+   * Called when header field data is received. A header field may be delivered in several spans.
+   * @param data supplies the start address.
+   * @param length supplies the length.
+   * @return CallbackResult representing success or failure.
+   */
+  virtual CallbackResult onHeaderField(const char* data, size_t length) PURE;
+
+  /**
+   * Called when header value data is received. A header value may be delivered in several spans.
+   * @param data supplies the start address.
+   * @param length supplies the length.
+   * @return CallbackResult representing success or failure.
+   */
+  virtual CallbackResult onHeaderValue(const char* data, size_t length) PURE;
+
+  /**
+   * Called when headers are complete. This is not called for trailers, the end of which is
+   * signaled by onMessageComplete().
+   * @return CallbackResult representing success or failure, or whether a body is expected.
+   */
+  virtual CallbackResult onHeadersComplete() PURE;
+
+  /**
+   * Called when body data is received.
+   * @param data supplies the start address.
+   * @param length supplies the length.
+   */
+  virtual void bufferBody(const char* data, size_t length) PURE;
+
+  /**
+   * Called when the request/response is complete.
+   * @return CallbackResult representing success or failure.
+   */
+  virtual CallbackResult onMessageComplete() PURE;
+
+  /**
+   * Called when accepting a chunk header.
+   * @param is_final_chunk whether this is the zero length chunk terminating the body.
+   */
+  virtual void onChunkHeader(bool is_final_chunk) PURE;
+};
+
+enum class ParserStatus { Ok, Paused, Error };
+
+/**
+ * Incremental HTTP/1 message parser. The parser raises ParserCallbacks as it consumes data and
+ * exposes the properties of the message being parsed that the codec needs to interpret it.
+ */
+class Parser {
+public:
+  virtual ~Parser() = default;
+
+  /**
+   * Parses a span of data, raising callbacks for the elements found in it.
+   * @param data supplies the start address.
+   * @param length supplies the length. A zero length signals the end of the input.
+   * @return the number of bytes consumed. Parsing stops early if the parser is paused or fails.
+   */
+  virtual size_t execute(const char* data, size_t length) PURE;
+
+  /**
+   * Resumes parsing after a pause().
+   */
+  virtual void resume() PURE;
+
+  /**
+   * Pauses the parser. This may be called from within a callback, in which case execute() returns
+   * once the callback completes.
+   */
+  virtual void pause() PURE;
+
+  /**
+   * @return ParserStatus the status of the parser after the last execute().
+   */
+  virtual ParserStatus getStatus() const PURE;
+
+  /**
+   * @return absl::string_view a short description of the parse error, if any.
+   */
+  virtual absl::string_view errorMessage() const PURE;
+
+  /**
+   * @return uint16_t the status code of the response being parsed.
+   */
+  virtual uint16_t statusCode() const PURE;
+
+  /**
+   * @return bool whether the message being parsed is HTTP/1.1.
+   */
+  virtual bool isHttp11() const PURE;
+
+  /**
+   * @return absl::optional<uint64_t> the content length of the message being parsed, if known.
+   */
+  virtual absl::optional<uint64_t> contentLength() const PURE;
+
+  /**
+   * @return bool whether the message being parsed uses chunked transfer encoding.
+   */
+  virtual bool isChunked() const PURE;
+
+  /**
+   * @return bool whether the message being parsed has a Transfer-Encoding header.
+   */
+  virtual bool hasTransferEncoding() const PURE;
+
+  /**
+   * @return absl::string_view the method of the request being parsed, or an empty string when
+   *         parsing responses.
+   */
+  virtual absl::string_view methodName() const PURE;
+};
+
+using ParserPtr = std::unique_ptr<Parser>;
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
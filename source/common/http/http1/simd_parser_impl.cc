@@ -0,0 +1,726 @@
+#include "common/http/http1/simd_parser_impl.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "common/common/assert.h"
+#include "common/common/byte_class.h"
+#include "common/common/macros.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_split.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+// The methods accepted by http_parser.
+constexpr absl::string_view Methods[] = {
+    "DELETE", "GET", "HEAD", "POST", "PUT", "CONNECT", "OPTIONS", "TRACE", "COPY", "LOCK",
+    "MKCOL", "MOVE", "PROPFIND", "PROPPATCH", "SEARCH", "UNLOCK", "BIND", "REBIND", "UNBIND",
+    "ACL", "REPORT", "MKACTIVITY", "CHECKOUT", "MERGE", "M-SEARCH", "NOTIFY", "SUBSCRIBE",
+    "UNSUBSCRIBE", "PATCH", "PURGE", "MKCALENDAR", "LINK", "UNLINK", "SOURCE"};
+
+// Request targets end at SP; other control characters and DEL are invalid.
+const ByteClass& urlDelimiters() {
+  CONSTRUCT_ON_FIRST_USE(ByteClass, absl::string_view("\x00\x20\x7f\x7f", 4), "");
+}
+
+// Header names are RFC 7230 tokens. The last range also covers '|' and '~', which are tokens.
+const ByteClass& headerNameDelimiters() {
+  CONSTRUCT_ON_FIRST_USE(
+      ByteClass,
+      absl::string_view("\x00\x20\x22\x22\x28\x29\x2c\x2c\x2f\x2f\x3a\x40\x5b\x5d\x7b\xff", 16),
+      "|~");
+}
+
+// Header values, reason phrases and chunk extensions end at CR or LF. Other control characters
+// except HTAB are invalid in them.
+const ByteClass& headerValueDelimiters() {
+  CONSTRUCT_ON_FIRST_USE(ByteClass, absl::string_view("\x00\x08\x0a\x1f", 4), "");
+}
+
+int hexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  c = absl::ascii_tolower(c);
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+bool isLineEnd(char c) { return c == '\r' || c == '\n'; }
+
+} // namespace
+
+SimdHttpParserImpl::SimdHttpParserImpl(MessageType type, ParserCallbacks* callbacks)
+    : type_(type), callbacks_(callbacks) {}
+
+size_t SimdHttpParserImpl::execute(const char* data, size_t length) {
+  if (status_ != ParserStatus::Ok) {
+    return 0;
+  }
+  if (length == 0) {
+    onEof();
+    return 0;
+  }
+
+  upgraded_ = false;
+  const char* p = data;
+  const char* const end = data + length;
+  while (p < end && status_ == ParserStatus::Ok && !upgraded_) {
+    switch (state_) {
+    case State::MessageStart:
+      // Like http_parser, tolerate empty lines between messages.
+      if (isLineEnd(*p)) {
+        ++p;
+      } else {
+        startMessage();
+      }
+      break;
+    case State::Method:
+      p = parseMethod(p, end);
+      break;
+    case State::UrlStart:
+      if (*p == ' ') {
+        ++p;
+      } else if (isLineEnd(*p)) {
+        setError("HPE_INVALID_URL");
+      } else {
+        state_ = State::Url;
+      }
+      break;
+    case State::Url:
+      p = parseUrl(p, end);
+      break;
+    case State::RequestVersion:
+      p = parseRequestVersion(p, end);
+      break;
+    case State::ResponseVersion:
+      p = parseResponseVersion(p, end);
+      break;
+    case State::StatusCode:
+      p = parseStatusCode(p, end);
+      break;
+    case State::Reason:
+      p = parseReason(p, end);
+      break;
+    case State::LineFeed:
+      if (*p != '\n') {
+        setError("HPE_LF_EXPECTED");
+      } else {
+        ++p;
+        onLineEnd();
+      }
+      break;
+    case State::HeaderFieldStart:
+      if (isLineEnd(*p)) {
+        p = endLine(p, in_trailers_ ? LineKind::TrailersEnd : LineKind::HeadersEnd);
+      } else if (*p == ' ' || *p == '\t') {
+        // Obsolete line folding.
+        setError("HPE_INVALID_HEADER_TOKEN");
+      } else {
+        field_length_ = 0;
+        state_ = State::HeaderField;
+      }
+      break;
+    case State::HeaderField:
+      p = parseHeaderField(p, end);
+      break;
+    case State::HeaderValueStart:
+      if (*p == ' ' || *p == '\t') {
+        ++p;
+      } else {
+        state_ = State::HeaderValue;
+      }
+      break;
+    case State::HeaderValue:
+      p = parseHeaderValue(p, end);
+      break;
+    case State::HeadersDone:
+      // The parser was paused in onHeadersComplete().
+      onHeadersDone();
+      break;
+    case State::BodyIdentity:
+    case State::BodyIdentityEof:
+    case State::ChunkData:
+      p = parseBody(p, end);
+      break;
+    case State::ChunkSize:
+      p = parseChunkSize(p, end);
+      break;
+    case State::ChunkExtension:
+      p = parseChunkExtension(p, end);
+      break;
+    case State::ChunkDataEnd:
+      if (isLineEnd(*p)) {
+        p = endLine(p, LineKind::ChunkData);
+      } else {
+        setError("HPE_STRICT");
+      }
+      break;
+    case State::Dead:
+      if (isLineEnd(*p)) {
+        ++p;
+      } else {
+        setError("HPE_CLOSED_CONNECTION");
+      }
+      break;
+    }
+  }
+
+  return p - data;
+}
+
+void SimdHttpParserImpl::resume() {
+  if (status_ == ParserStatus::Paused) {
+    status_ = ParserStatus::Ok;
+    error_ = "HPE_OK";
+  }
+}
+
+void SimdHttpParserImpl::pause() {
+  if (status_ == ParserStatus::Ok) {
+    status_ = ParserStatus::Paused;
+    error_ = "HPE_PAUSED";
+  }
+}
+
+void SimdHttpParserImpl::startMessage() {
+  method_ = {};
+  status_code_ = 0;
+  status_digits_ = 0;
+  http_major_ = 0;
+  http_minor_ = 0;
+  content_length_.reset();
+  chunked_ = false;
+  has_transfer_encoding_ = false;
+  connection_close_ = false;
+  connection_keep_alive_ = false;
+  connection_upgrade_ = false;
+  has_upgrade_ = false;
+  upgrade_ = false;
+  skip_body_ = false;
+  in_trailers_ = false;
+  token_length_ = 0;
+
+  state_ = type_ == MessageType::Request ? State::Method : State::ResponseVersion;
+  checkCallback(callbacks_->onMessageBegin(), "HPE_CB_message_begin");
+}
+
+void SimdHttpParserImpl::completeMessage() {
+  state_ = shouldKeepAlive() ? State::MessageStart : State::Dead;
+  checkCallback(callbacks_->onMessageComplete(), "HPE_CB_message_complete");
+}
+
+void SimdHttpParserImpl::onEof() {
+  switch (state_) {
+  case State::MessageStart:
+  case State::Dead:
+    return;
+  case State::BodyIdentityEof:
+    completeMessage();
+    return;
+  default:
+    setError("HPE_INVALID_EOF_STATE");
+    return;
+  }
+}
+
+const char* SimdHttpParserImpl::endLine(const char* p, LineKind kind) {
+  ASSERT(isLineEnd(*p));
+  line_kind_ = kind;
+  if (*p == '\r') {
+    state_ = State::LineFeed;
+  } else {
+    onLineEnd();
+  }
+  return p + 1;
+}
+
+void SimdHttpParserImpl::onLineEnd() {
+  switch (line_kind_) {
+  case LineKind::StartLine:
+  case LineKind::HeaderLine:
+    state_ = State::HeaderFieldStart;
+    return;
+  case LineKind::HeadersEnd:
+    onHeadersComplete();
+    return;
+  case LineKind::TrailersEnd:
+    completeMessage();
+    return;
+  case LineKind::ChunkSize:
+    onChunkSizeDone();
+    return;
+  case LineKind::ChunkData:
+    chunk_size_ = 0;
+    chunk_size_digits_ = 0;
+    state_ = State::ChunkSize;
+    return;
+  }
+}
+
+void SimdHttpParserImpl::onHeadersComplete() {
+  if (has_transfer_encoding_ && content_length_.has_value() && !chunked_) {
+    setError("HPE_UNEXPECTED_CONTENT_LENGTH");
+    return;
+  }
+
+  const bool is_connect = method_ == "CONNECT";
+  upgrade_ = is_connect || (connection_upgrade_ && has_upgrade_ &&
+                            (type_ == MessageType::Request || status_code_ == 101));
+
+  state_ = State::HeadersDone;
+  switch (callbacks_->onHeadersComplete()) {
+  case CallbackResult::Error:
+    setError("HPE_CB_headers_complete");
+    return;
+  case CallbackResult::NoBody:
+    skip_body_ = true;
+    break;
+  case CallbackResult::NoBodyData:
+    upgrade_ = true;
+    skip_body_ = true;
+    break;
+  case CallbackResult::Success:
+    break;
+  }
+
+  // If the callback paused the parser the body is framed once parsing resumes.
+  if (status_ == ParserStatus::Ok) {
+    onHeadersDone();
+  }
+}
+
+void SimdHttpParserImpl::onHeadersDone() {
+  const bool has_body = chunked_ || (content_length_.has_value() && content_length_.value() > 0);
+  if (upgrade_ && (method_ == "CONNECT" || skip_body_ || !has_body)) {
+    // The rest of the data belongs to a different protocol.
+    upgraded_ = true;
+    completeMessage();
+    return;
+  }
+
+  if (skip_body_) {
+    completeMessage();
+  } else if (chunked_) {
+    chunk_size_ = 0;
+    chunk_size_digits_ = 0;
+    state_ = State::ChunkSize;
+  } else if (has_transfer_encoding_) {
+    // RFC 7230 3.3.3: a request whose final transfer coding is not chunked cannot be framed, while
+    // such a response is delimited by the connection closing.
+    if (type_ == MessageType::Request) {
+      setError("HPE_INVALID_TRANSFER_ENCODING");
+    } else {
+      state_ = State::BodyIdentityEof;
+    }
+  } else if (content_length_.has_value()) {
+    if (content_length_.value() == 0) {
+      completeMessage();
+    } else {
+      body_remaining_ = content_length_.value();
+      state_ = State::BodyIdentity;
+    }
+  } else if (messageNeedsEof()) {
+    state_ = State::BodyIdentityEof;
+  } else {
+    completeMessage();
+  }
+}
+
+void SimdHttpParserImpl::onChunkSizeDone() {
+  callbacks_->onChunkHeader(chunk_size_ == 0);
+  if (chunk_size_ == 0) {
+    in_trailers_ = true;
+    state_ = State::HeaderFieldStart;
+  } else {
+    body_remaining_ = chunk_size_;
+    state_ = State::ChunkData;
+  }
+}
+
+bool SimdHttpParserImpl::onHeaderValueDone() {
+  const absl::string_view value = absl::StripAsciiWhitespace(header_value_);
+  switch (header_kind_) {
+  case HeaderKind::Other:
+    break;
+  case HeaderKind::ContentLength: {
+    if (content_length_.has_value()) {
+      setError("HPE_UNEXPECTED_CONTENT_LENGTH");
+      return false;
+    }
+    if (value.empty()) {
+      setError("HPE_INVALID_CONTENT_LENGTH");
+      return false;
+    }
+    uint64_t content_length = 0;
+    for (const char c : value) {
+      if (!absl::ascii_isdigit(c) ||
+          content_length > (std::numeric_limits<uint64_t>::max() - (c - '0')) / 10) {
+        setError("HPE_INVALID_CONTENT_LENGTH");
+        return false;
+      }
+      content_length = content_length * 10 + (c - '0');
+    }
+    content_length_ = content_length;
+    break;
+  }
+  case HeaderKind::TransferEncoding: {
+    // Only the final transfer coding determines whether the body is chunked.
+    has_transfer_encoding_ = true;
+    const size_t last_comma = value.rfind(',');
+    const absl::string_view last_coding = absl::StripAsciiWhitespace(
+        last_comma == absl::string_view::npos ? value : value.substr(last_comma + 1));
+    chunked_ = absl::EqualsIgnoreCase(last_coding, "chunked");
+    break;
+  }
+  case HeaderKind::Connection:
+    for (const absl::string_view option : absl::StrSplit(value, ',')) {
+      const absl::string_view token = absl::StripAsciiWhitespace(option);
+      if (absl::EqualsIgnoreCase(token, "close")) {
+        connection_close_ = true;
+      } else if (absl::EqualsIgnoreCase(token, "keep-alive")) {
+        connection_keep_alive_ = true;
+      } else if (absl::EqualsIgnoreCase(token, "upgrade")) {
+        connection_upgrade_ = true;
+      }
+    }
+    break;
+  case HeaderKind::Upgrade:
+    has_upgrade_ = true;
+    break;
+  }
+  return true;
+}
+
+bool SimdHttpParserImpl::messageNeedsEof() const {
+  if (type_ == MessageType::Request) {
+    return false;
+  }
+  if (status_code_ / 100 == 1 || status_code_ == 204 || status_code_ == 304 || skip_body_) {
+    return false;
+  }
+  if (has_transfer_encoding_ && !chunked_) {
+    return true;
+  }
+  return !chunked_ && !content_length_.has_value();
+}
+
+bool SimdHttpParserImpl::shouldKeepAlive() const {
+  if (http_major_ > 0 && http_minor_ > 0) {
+    if (connection_close_) {
+      return false;
+    }
+  } else if (!connection_keep_alive_) {
+    return false;
+  }
+  return !messageNeedsEof();
+}
+
+bool SimdHttpParserImpl::parseVersion() {
+  const absl::string_view version(token_.data(), token_length_);
+  if (version.size() != 8 || !absl::StartsWith(version, "HTTP/") ||
+      !absl::ascii_isdigit(version[5]) || version[6] != '.' || !absl::ascii_isdigit(version[7])) {
+    return false;
+  }
+  http_major_ = version[5] - '0';
+  http_minor_ = version[7] - '0';
+  token_length_ = 0;
+  return true;
+}
+
+bool SimdHttpParserImpl::appendToken(char c) {
+  if (token_length_ == token_.size()) {
+    return false;
+  }
+  token_[token_length_++] = c;
+  return true;
+}
+
+void SimdHttpParserImpl::recordFieldName(const char* begin, const char* end) {
+  for (; begin < end && field_length_ < field_name_.size(); ++begin) {
+    field_name_[field_length_++] = absl::ascii_tolower(*begin);
+  }
+  field_length_ += end - begin;
+}
+
+SimdHttpParserImpl::HeaderKind SimdHttpParserImpl::classifyFieldName() const {
+  if (field_length_ > field_name_.size()) {
+    return HeaderKind::Other;
+  }
+  const absl::string_view name(field_name_.data(), field_length_);
+  if (name == "content-length") {
+    return HeaderKind::ContentLength;
+  } else if (name == "transfer-encoding") {
+    return HeaderKind::TransferEncoding;
+  } else if (name == "connection") {
+    return HeaderKind::Connection;
+  } else if (name == "upgrade") {
+    return HeaderKind::Upgrade;
+  }
+  return HeaderKind::Other;
+}
+
+bool SimdHttpParserImpl::checkCallback(CallbackResult result, absl::string_view error) {
+  if (result == CallbackResult::Error) {
+    setError(error);
+    return false;
+  }
+  return status_ == ParserStatus::Ok;
+}
+
+void SimdHttpParserImpl::setError(absl::string_view error) {
+  status_ = ParserStatus::Error;
+  error_ = error;
+}
+
+const char* SimdHttpParserImpl::parseMethod(const char* p, const char* end) {
+  for (; p < end; ++p) {
+    const char c = *p;
+    if (c == ' ') {
+      const absl::string_view method(token_.data(), token_length_);
+      for (const absl::string_view known : Methods) {
+        if (method == known) {
+          method_ = known;
+          break;
+        }
+      }
+      if (method_.empty()) {
+        setError("HPE_INVALID_METHOD");
+        return p;
+      }
+      token_length_ = 0;
+      state_ = State::UrlStart;
+      return p + 1;
+    }
+    if (!(absl::ascii_isupper(c) || c == '-') || !appendToken(c)) {
+      setError("HPE_INVALID_METHOD");
+      return p;
+    }
+  }
+  return p;
+}
+
+const char* SimdHttpParserImpl::parseUrl(const char* p, const char* end) {
+  const char* delimiter = urlDelimiters().find(p, end);
+  if (delimiter != p && !checkCallback(callbacks_->onUrl(p, delimiter - p), "HPE_CB_url")) {
+    return delimiter;
+  }
+  if (delimiter == end) {
+    return end;
+  }
+  if (*delimiter == ' ') {
+    state_ = State::RequestVersion;
+    return delimiter + 1;
+  }
+  // A request line without a version is an HTTP/0.9 request, which is not supported.
+  setError(isLineEnd(*delimiter) ? "HPE_INVALID_VERSION" : "HPE_INVALID_URL");
+  return delimiter;
+}
+
+const char* SimdHttpParserImpl::parseRequestVersion(const char* p, const char* end) {
+  for (; p < end; ++p) {
+    const char c = *p;
+    if (isLineEnd(c)) {
+      if (!parseVersion()) {
+        setError("HPE_INVALID_VERSION");
+        return p;
+      }
+      return endLine(p, LineKind::StartLine);
+    }
+    if (c == ' ' && token_length_ == 0) {
+      continue;
+    }
+    if (!appendToken(c)) {
+      setError("HPE_INVALID_VERSION");
+      return p;
+    }
+  }
+  return p;
+}
+
+const char* SimdHttpParserImpl::parseResponseVersion(const char* p, const char* end) {
+  for (; p < end; ++p) {
+    const char c = *p;
+    if (c == ' ') {
+      if (!parseVersion()) {
+        setError("HPE_INVALID_VERSION");
+        return p;
+      }
+      state_ = State::StatusCode;
+      return p + 1;
+    }
+    if (!appendToken(c)) {
+      setError("HPE_INVALID_VERSION");
+      return p;
+    }
+  }
+  return p;
+}
+
+const char* SimdHttpParserImpl::parseStatusCode(const char* p, const char* end) {
+  for (; p < end; ++p) {
+    const char c = *p;
+    if (absl::ascii_isdigit(c) && status_digits_ < 3) {
+      status_code_ = status_code_ * 10 + (c - '0');
+      ++status_digits_;
+      continue;
+    }
+    if (c == ' ' && status_digits_ == 0) {
+      continue;
+    }
+    if (status_digits_ == 0 || !(c == ' ' || isLineEnd(c))) {
+      setError("HPE_INVALID_STATUS");
+      return p;
+    }
+    if (c == ' ') {
+      state_ = State::Reason;
+      return p + 1;
+    }
+    return endLine(p, LineKind::StartLine);
+  }
+  return p;
+}
+
+const char* SimdHttpParserImpl::parseReason(const char* p, const char* end) {
+  // The reason phrase is not reported. Stray control characters in it are tolerated.
+  while (p < end) {
+    p = headerValueDelimiters().find(p, end);
+    if (p < end && isLineEnd(*p)) {
+      return endLine(p, LineKind::StartLine);
+    }
+    if (p < end) {
+      ++p;
+    }
+  }
+  return p;
+}
+
+const char* SimdHttpParserImpl::parseHeaderField(const char* p, const char* end) {
+  const char* delimiter = headerNameDelimiters().find(p, end);
+  if (delimiter != p) {
+    recordFieldName(p, delimiter);
+    if (!checkCallback(callbacks_->onHeaderField(p, delimiter - p), "HPE_CB_header_field")) {
+      return delimiter;
+    }
+  }
+  if (delimiter == end) {
+    return end;
+  }
+  if (*delimiter != ':' || field_length_ == 0) {
+    setError("HPE_INVALID_HEADER_TOKEN");
+    return delimiter;
+  }
+
+  // Trailers do not affect framing.
+  header_kind_ = in_trailers_ ? HeaderKind::Other : classifyFieldName();
+  header_value_.clear();
+  value_delivered_ = false;
+  state_ = State::HeaderValueStart;
+  return delimiter + 1;
+}
+
+const char* SimdHttpParserImpl::parseHeaderValue(const char* p, const char* end) {
+  const char* delimiter = headerValueDelimiters().find(p, end);
+  if (delimiter != p) {
+    if (header_kind_ != HeaderKind::Other) {
+      header_value_.append(p, delimiter - p);
+    }
+    value_delivered_ = true;
+    if (!checkCallback(callbacks_->onHeaderValue(p, delimiter - p), "HPE_CB_header_value")) {
+      return delimiter;
+    }
+  }
+  if (delimiter == end) {
+    return end;
+  }
+  if (!isLineEnd(*delimiter)) {
+    setError("HPE_INVALID_HEADER_TOKEN");
+    return delimiter;
+  }
+
+  // The codec relies on every header name being followed by a value, even an empty one.
+  if (!value_delivered_) {
+    value_delivered_ = true;
+    if (!checkCallback(callbacks_->onHeaderValue(delimiter, 0), "HPE_CB_header_value")) {
+      return delimiter;
+    }
+  }
+  if (!onHeaderValueDone()) {
+    return delimiter;
+  }
+  return endLine(delimiter, LineKind::HeaderLine);
+}
+
+const char* SimdHttpParserImpl::parseBody(const char* p, const char* end) {
+  if (state_ == State::BodyIdentityEof) {
+    callbacks_->bufferBody(p, end - p);
+    return end;
+  }
+
+  const size_t length = std::min<uint64_t>(body_remaining_, end - p);
+  callbacks_->bufferBody(p, length);
+  body_remaining_ -= length;
+  p += length;
+  if (body_remaining_ == 0) {
+    if (state_ == State::ChunkData) {
+      state_ = State::ChunkDataEnd;
+    } else {
+      completeMessage();
+    }
+  }
+  return p;
+}
+
+const char* SimdHttpParserImpl::parseChunkSize(const char* p, const char* end) {
+  for (; p < end; ++p) {
+    const char c = *p;
+    const int digit = hexValue(c);
+    if (digit >= 0) {
+      if (chunk_size_ > (std::numeric_limits<uint64_t>::max() >> 4)) {
+        setError("HPE_INVALID_CHUNK_SIZE");
+        return p;
+      }
+      chunk_size_ = (chunk_size_ << 4) | digit;
+      ++chunk_size_digits_;
+      continue;
+    }
+    if (chunk_size_digits_ == 0) {
+      setError("HPE_INVALID_CHUNK_SIZE");
+      return p;
+    }
+    if (c == ';' || c == ' ' || c == '\t') {
+      state_ = State::ChunkExtension;
+      return p + 1;
+    }
+    if (isLineEnd(c)) {
+      return endLine(p, LineKind::ChunkSize);
+    }
+    setError("HPE_INVALID_CHUNK_SIZE");
+    return p;
+  }
+  return p;
+}
+
+const char* SimdHttpParserImpl::parseChunkExtension(const char* p, const char* end) {
+  // Chunk extensions are ignored.
+  const char* delimiter = headerValueDelimiters().find(p, end);
+  if (delimiter == end) {
+    return end;
+  }
+  if (!isLineEnd(*delimiter)) {
+    setError("HPE_INVALID_CHUNK_SIZE");
+    return delimiter;
+  }
+  return endLine(delimiter, LineKind::ChunkSize);
+}
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
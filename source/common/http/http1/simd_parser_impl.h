@@ -0,0 +1,156 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "common/http/http1/parser.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * Parser implementation that scans runs of URL, header name and header value bytes a block at a
+ * time rather than byte by byte. On x86-64 CPUs with SSE4.2 the scans use PCMPESTRI to find the
+ * next delimiter 16 bytes per instruction, falling back to a table driven scan elsewhere. Each run
+ * is delivered to the ParserCallbacks as a single span, so a header block held in one contiguous
+ * slice is parsed in one pass with one callback per header name and value.
+ *
+ * The parser follows the framing rules of http_parser, including its error names, with two
+ * deliberate differences: obsolete line folding and HTTP/0.9 request lines are rejected, as
+ * RFC 7230 permits.
+ */
+class SimdHttpParserImpl : public Parser {
+public:
+  SimdHttpParserImpl(MessageType type, ParserCallbacks* callbacks);
+
+  // Http1::Parser
+  size_t execute(const char* data, size_t length) override;
+  void resume() override;
+  void pause() override;
+  ParserStatus getStatus() const override { return status_; }
+  absl::string_view errorMessage() const override { return error_; }
+  uint16_t statusCode() const override { return status_code_; }
+  bool isHttp11() const override { return http_major_ == 1 && http_minor_ == 1; }
+  absl::optional<uint64_t> contentLength() const override { return content_length_; }
+  bool isChunked() const override { return chunked_; }
+  bool hasTransferEncoding() const override { return has_transfer_encoding_; }
+  absl::string_view methodName() const override { return method_; }
+
+private:
+  enum class State {
+    MessageStart,
+    Method,
+    UrlStart,
+    Url,
+    RequestVersion,
+    ResponseVersion,
+    StatusCode,
+    Reason,
+    LineFeed,
+    HeaderFieldStart,
+    HeaderField,
+    HeaderValueStart,
+    HeaderValue,
+    HeadersDone,
+    BodyIdentity,
+    BodyIdentityEof,
+    ChunkSize,
+    ChunkExtension,
+    ChunkData,
+    ChunkDataEnd,
+    Dead,
+  };
+
+  // The kind of line being terminated when a line feed is consumed.
+  enum class LineKind { StartLine, HeaderLine, HeadersEnd, TrailersEnd, ChunkSize, ChunkData };
+
+  // Headers whose values determine the framing of the message.
+  enum class HeaderKind { Other, ContentLength, TransferEncoding, Connection, Upgrade };
+
+  void startMessage();
+  void completeMessage();
+  void onEof();
+  void onLineEnd();
+  void onHeadersComplete();
+  void onHeadersDone();
+  void onChunkSizeDone();
+  bool onHeaderValueDone();
+  bool messageNeedsEof() const;
+  bool shouldKeepAlive() const;
+  bool parseVersion();
+  bool appendToken(char c);
+  void recordFieldName(const char* begin, const char* end);
+  HeaderKind classifyFieldName() const;
+  bool checkCallback(CallbackResult result, absl::string_view error);
+  void setError(absl::string_view error);
+
+  const char* endLine(const char* p, LineKind kind);
+  const char* parseMethod(const char* p, const char* end);
+  const char* parseUrl(const char* p, const char* end);
+  const char* parseRequestVersion(const char* p, const char* end);
+  const char* parseResponseVersion(const char* p, const char* end);
+  const char* parseStatusCode(const char* p, const char* end);
+  const char* parseReason(const char* p, const char* end);
+  const char* parseHeaderField(const char* p, const char* end);
+  const char* parseHeaderValue(const char* p, const char* end);
+  const char* parseBody(const char* p, const char* end);
+  const char* parseChunkSize(const char* p, const char* end);
+  const char* parseChunkExtension(const char* p, const char* end);
+
+  // Enough for the longest method (PROPPATCH, MKACTIVITY, UNSUBSCRIBE) and for "HTTP/x.y".
+  static constexpr size_t MaxTokenLength = 16;
+  // Enough for the longest header that affects framing, "transfer-encoding".
+  static constexpr size_t MaxRecordedFieldLength = 17;
+
+  const MessageType type_;
+  ParserCallbacks* const callbacks_;
+  State state_{State::MessageStart};
+  LineKind line_kind_{LineKind::StartLine};
+  ParserStatus status_{ParserStatus::Ok};
+  absl::string_view error_{"HPE_OK"};
+  // Set when the message is followed by data of a different protocol, which stops execute().
+  bool upgraded_{};
+
+  // Accumulates the method, version and status code, which are short and may span executions.
+  std::array<char, MaxTokenLength> token_;
+  size_t token_length_{};
+
+  // The lowercased prefix of the header name being parsed, used to recognize framing headers.
+  std::array<char, MaxRecordedFieldLength> field_name_;
+  size_t field_length_{};
+  HeaderKind header_kind_{HeaderKind::Other};
+  // The value of a framing header. Its size is bounded by the codec's header size limits, which
+  // are enforced as each span is delivered.
+  std::string header_value_;
+  bool value_delivered_{};
+
+  // Properties of the message being parsed.
+  absl::string_view method_;
+  uint16_t status_code_{};
+  uint32_t status_digits_{};
+  uint8_t http_major_{};
+  uint8_t http_minor_{};
+  absl::optional<uint64_t> content_length_;
+  bool chunked_{};
+  bool has_transfer_encoding_{};
+  bool connection_close_{};
+  bool connection_keep_alive_{};
+  bool connection_upgrade_{};
+  bool has_upgrade_{};
+  bool upgrade_{};
+  bool skip_body_{};
+  bool in_trailers_{};
+
+  uint64_t body_remaining_{};
+  uint64_t chunk_size_{};
+  uint32_t chunk_size_digits_{};
+};
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
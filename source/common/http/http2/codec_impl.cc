@@ -1,6 +1,8 @@
 #include "common/http/http2/codec_impl.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -19,6 +21,7 @@
 #include "common/http/header_utility.h"
 #include "common/http/headers.h"
 #include "common/http/http2/codec_stats.h"
+#include "common/http/interned_header_values.h"
 #include "common/http/utility.h"
 #include "common/runtime/runtime_features.h"
 
@@ -28,6 +31,12 @@ namespace Envoy {
 namespace Http {
 namespace Http2 {
 
+namespace {
+// The payload of the PINGs measuring the bandwidth-delay product. The keepalive PINGs carry the
+// time they were sent at in milliseconds, which never takes this value.
+constexpr uint64_t BandwidthDelayProductPingPayload = std::numeric_limits<uint64_t>::max();
+} // namespace
+
 // Changes or additions to details should be reflected in
 // docs/root/configuration/http/http_conn_man/response_code_details_details.rst
 class Http2ResponseCodeDetailValues {
@@ -116,7 +125,9 @@ template <typename T> static T* removeConst(const void* object) {
 }
 
 ConnectionImpl::StreamImpl::StreamImpl(ConnectionImpl& parent, uint32_t buffer_limit)
-    : parent_(parent), local_end_stream_sent_(false), remote_end_stream_(false),
+    : parent_(parent),
+      header_arena_(parent.use_header_arena_ ? std::make_shared<HeaderArena>() : nullptr),
+      local_end_stream_sent_(false), remote_end_stream_(false),
       data_deferred_(false), received_noninformational_headers_(false),
       pending_receive_buffer_high_watermark_called_(false),
       pending_send_buffer_high_watermark_called_(false), reset_due_to_messaging_error_(false) {
@@ -401,7 +412,8 @@ ssize_t ConnectionImpl::StreamImpl::onDataSourceRead(uint64_t length, uint32_t*
     return NGHTTP2_ERR_DEFERRED;
   } else {
     *data_flags |= NGHTTP2_DATA_FLAG_NO_COPY;
-    if (local_end_stream_ && pending_send_data_.length() <= length) {
+    const uint64_t send_length = dataFrameLength(length);
+    if (local_end_stream_ && send_length == pending_send_data_.length()) {
       *data_flags |= NGHTTP2_DATA_FLAG_EOF;
       if (pending_trailers_to_encode_) {
         // We need to tell the library to not set end stream so that we can emit the trailers.
@@ -411,10 +423,31 @@ ssize_t ConnectionImpl::StreamImpl::onDataSourceRead(uint64_t length, uint32_t*
       }
     }
 
-    return std::min(length, pending_send_data_.length());
+    return send_length;
   }
 }
 
+uint64_t ConnectionImpl::StreamImpl::dataFrameLength(uint64_t max_length) const {
+  if (pending_send_data_.length() <= max_length) {
+    return pending_send_data_.length();
+  }
+
+  // onDataSourceSend() moves the frame payload out of pending_send_data_. Whole slices are moved
+  // without copying, but a slice that is split across frames has its head copied. End the frame at
+  // the last slice boundary that fits, unless the first slice alone exceeds the frame, in which
+  // case the copy is unavoidable. Only the first few slices are considered, which bounds the cost
+  // of a frame when a large body is queued.
+  static constexpr uint64_t MaxSlicesPerDataFrame = 16;
+  uint64_t length = 0;
+  for (const Buffer::RawSlice& slice : pending_send_data_.getRawSlices(MaxSlicesPerDataFrame)) {
+    if (length + slice.len_ > max_length) {
+      break;
+    }
+    length += slice.len_;
+  }
+  return length > 0 ? length : max_length;
+}
+
 void ConnectionImpl::StreamImpl::onDataSourceSend(const uint8_t* framehd, size_t length) {
   // In this callback we are writing out a raw DATA frame without copying. nghttp2 assumes that we
   // "just know" that the frame header is 9 bytes.
@@ -568,8 +601,16 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, CodecStats& stat
       protocol_constraints_(stats, http2_options),
       skip_encoding_empty_trailers_(Runtime::runtimeFeatureEnabled(
           "envoy.reloadable_features.http2_skip_encoding_empty_trailers")),
+      use_header_arena_(
+          Runtime::runtimeFeatureEnabled("envoy.reloadable_features.http_header_map_arena")),
       dispatching_(false), raised_goaway_(false), pending_deferred_reset_(false),
-      random_(random_generator) {
+      random_(random_generator), window_auto_tuning_(http2_options.has_window_auto_tuning()),
+      min_window_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(http2_options.window_auto_tuning(),
+                                                       initial_window_size,
+                                                       NGHTTP2_INITIAL_WINDOW_SIZE)),
+      max_stream_window_size_(http2_options.initial_stream_window_size().value()),
+      max_connection_window_size_(http2_options.initial_connection_window_size().value()),
+      window_size_(min_window_size_) {
   if (http2_options.has_connection_keepalive()) {
     keepalive_interval_ = std::chrono::milliseconds(
         PROTOBUF_GET_MS_REQUIRED(http2_options.connection_keepalive(), interval));
@@ -632,6 +673,58 @@ void ConnectionImpl::onKeepaliveResponseTimeout() {
   connection_.close(Network::ConnectionCloseType::NoFlush);
 }
 
+void ConnectionImpl::sampleBandwidthDelayProduct(size_t len) {
+  if (!bdp_ping_in_flight_) {
+    // As gRPC does, the bytes received until the PING is acknowledged estimate the bytes in flight
+    // on the connection, i.e. its bandwidth-delay product. The PING is sent once the frames
+    // received are processed.
+    uint64_t payload = BandwidthDelayProductPingPayload;
+    int rc = nghttp2_submit_ping(session_, 0 /*flags*/, reinterpret_cast<uint8_t*>(&payload));
+    ASSERT(rc == 0);
+    bdp_ping_in_flight_ = true;
+    bdp_bytes_ = 0;
+    bdp_ping_sent_at_ = connection_.dispatcher().timeSource().monotonicTime();
+  }
+  bdp_bytes_ += len;
+}
+
+void ConnectionImpl::onBandwidthDelayProductPingAck() {
+  bdp_ping_in_flight_ = false;
+  const auto rtt = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      connection_.dispatcher().timeSource().monotonicTime() - bdp_ping_sent_at_);
+  const double bandwidth = bdp_bytes_ * 1e9 / std::max<int64_t>(rtt.count(), 1);
+  ENVOY_CONN_LOG(trace, "bandwidth-delay product {} bytes, round-trip time {}ns", connection_,
+                 bdp_bytes_, rtt.count());
+
+  // The windows grow when the bytes in flight neared the window, which may then have limited
+  // them, as long as the larger windows let the bandwidth grow.
+  if (3 * bdp_bytes_ < 2 * static_cast<uint64_t>(window_size_) || bandwidth <= max_bandwidth_) {
+    return;
+  }
+  max_bandwidth_ = bandwidth;
+  const uint32_t window_size = std::min<uint64_t>(
+      2 * bdp_bytes_, std::max(max_stream_window_size_, max_connection_window_size_));
+  if (window_size > window_size_) {
+    stats_.window_auto_tuning_grow_.inc();
+    setWindowSize(window_size);
+  }
+}
+
+void ConnectionImpl::setWindowSize(uint32_t window_size) {
+  ENVOY_CONN_LOG(debug, "tuning flow-control windows from {} to {}", connection_, window_size_,
+                 window_size);
+  window_size_ = window_size;
+  // The streams, including the open ones, take the new window size once the peer acknowledges the
+  // SETTINGS.
+  const nghttp2_settings_entry stream_window{NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE,
+                                             std::min(window_size, max_stream_window_size_)};
+  int rc = nghttp2_submit_settings(session_, NGHTTP2_FLAG_NONE, &stream_window, 1);
+  ASSERT(rc == 0);
+  rc = nghttp2_session_set_local_window_size(session_, NGHTTP2_FLAG_NONE, 0,
+                                             std::min(window_size, max_connection_window_size_));
+  ASSERT(rc == 0);
+}
+
 Http::Status ConnectionImpl::dispatch(Buffer::Instance& data) {
   // TODO(#10878): Remove this wrapper when exception removal is complete. innerDispatch may either
   // throw an exception or return an error status. The utility wrapper catches exceptions and
@@ -690,6 +783,16 @@ int ConnectionImpl::onData(int32_t stream_id, const uint8_t* data, size_t len) {
     nghttp2_session_consume(session_, stream_id, len);
   } else {
     stream->unconsumed_bytes_ += len;
+    // The data is received faster than it is passed on, so that larger windows would only make
+    // Envoy buffer more of it.
+    if (window_auto_tuning_ && window_size_ > min_window_size_) {
+      stats_.window_auto_tuning_shrink_.inc();
+      max_bandwidth_ = 0;
+      setWindowSize(min_window_size_);
+    }
+  }
+  if (window_auto_tuning_) {
+    sampleBandwidthDelayProduct(len);
   }
   return 0;
 }
@@ -758,6 +861,12 @@ Status ConnectionImpl::onFrameReceived(const nghttp2_frame* frame) {
     memcpy(&data, frame->ping.opaque_data, sizeof(data));
     ENVOY_CONN_LOG(trace, "recv PING ACK {}", connection_, data);
 
+    if (data == BandwidthDelayProductPingPayload) {
+      if (bdp_ping_in_flight_) {
+        onBandwidthDelayProductPingAck();
+      }
+      return okStatus();
+    }
     onKeepaliveResponse();
     return okStatus();
   }
@@ -1160,13 +1269,21 @@ void ConnectionImpl::sendSettings(
                    it.identifier().value(), it.value().value());
   }
 
+  // With auto-tuning, the windows start small and grow up to the configured sizes.
+  uint32_t initial_stream_window_size = http2_options.initial_stream_window_size().value();
+  uint32_t initial_connection_window_size = http2_options.initial_connection_window_size().value();
+  if (window_auto_tuning_) {
+    initial_stream_window_size = std::min(window_size_, initial_stream_window_size);
+    initial_connection_window_size = std::min(window_size_, initial_connection_window_size);
+  }
+
   // Insert named parameters.
   settings.insert(
       settings.end(),
       {{NGHTTP2_SETTINGS_HEADER_TABLE_SIZE, http2_options.hpack_table_size().value()},
        {NGHTTP2_SETTINGS_ENABLE_CONNECT_PROTOCOL, http2_options.allow_connect()},
        {NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS, http2_options.max_concurrent_streams().value()},
-       {NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE, http2_options.initial_stream_window_size().value()}});
+       {NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE, initial_stream_window_size}});
   if (!settings.empty()) {
     int rc = nghttp2_submit_settings(session_, NGHTTP2_FLAG_NONE, settings.data(), settings.size());
     ASSERT(rc == 0);
@@ -1176,8 +1293,6 @@ void ConnectionImpl::sendSettings(
     ASSERT(rc == 0);
   }
 
-  const uint32_t initial_connection_window_size =
-      http2_options.initial_connection_window_size().value();
   // Increase connection window size up to our default size.
   if (initial_connection_window_size != NGHTTP2_INITIAL_CONNECTION_WINDOW_SIZE) {
     ENVOY_CONN_LOG(debug, "updating connection-level initial window size to {}", connection_,
@@ -1234,15 +1349,30 @@ ConnectionImpl::Http2Callbacks::Http2Callbacks() {
             std::move(status));
       });
 
-  nghttp2_session_callbacks_set_on_header_callback(
-      callbacks_,
-      [](nghttp2_session*, const nghttp2_frame* frame, const uint8_t* raw_name, size_t name_length,
-         const uint8_t* raw_value, size_t value_length, uint8_t, void* user_data) -> int {
-        // TODO PERF: Can reference count here to avoid copies.
+  nghttp2_session_callbacks_set_on_header_callback2(
+      callbacks_, [](nghttp2_session*, const nghttp2_frame* frame, nghttp2_rcbuf* name_buf,
+                     nghttp2_rcbuf* value_buf, uint8_t, void* user_data) -> int {
+        // The names and values of the HPACK static table live as long as the process, so that they
+        // are referenced rather than copied. The other buffers belong to the session, which the
+        // header maps may outlive, so that they are copied.
+        const nghttp2_vec raw_name = nghttp2_rcbuf_get_buf(name_buf);
+        const absl::string_view name_view(reinterpret_cast<const char*>(raw_name.base),
+                                          raw_name.len);
         HeaderString name;
-        name.setCopy(reinterpret_cast<const char*>(raw_name), name_length);
+        if (nghttp2_rcbuf_is_static(name_buf)) {
+          name.setReference(name_view);
+        } else {
+          name.setCopy(name_view);
+        }
+        const nghttp2_vec raw_value = nghttp2_rcbuf_get_buf(value_buf);
+        const absl::string_view value_view(reinterpret_cast<const char*>(raw_value.base),
+                                           raw_value.len);
         HeaderString value;
-        value.setCopy(reinterpret_cast<const char*>(raw_value), value_length);
+        if (nghttp2_rcbuf_is_static(value_buf)) {
+          value.setReference(value_view);
+        } else {
+          InternedValues::get().setValue(value, value_view);
+        }
         return static_cast<ConnectionImpl*>(user_data)->onHeader(frame, std::move(name),
                                                                  std::move(value));
       });
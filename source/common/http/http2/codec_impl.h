@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "envoy/common/random_generator.h"
+#include "envoy/common/time.h"
 #include "envoy/config/core/v3/protocol.pb.h"
 #include "envoy/event/deferred_deletable.h"
 #include "envoy/http/codec.h"
@@ -189,6 +190,8 @@ protected:
 
     StreamImpl* base() { return this; }
     ssize_t onDataSourceRead(uint64_t length, uint32_t* data_flags);
+    // Returns the payload length of the next DATA frame, which is at most max_length.
+    uint64_t dataFrameLength(uint64_t max_length) const;
     void onDataSourceSend(const uint8_t* framehd, size_t length);
     void resetStreamWorker(StreamResetReason reason);
     static void buildHeaders(std::vector<nghttp2_nv>& final_headers, const HeaderMap& headers);
@@ -225,6 +228,10 @@ protected:
     void setFlushTimeout(std::chrono::milliseconds timeout) override {
       stream_idle_timeout_ = timeout;
     }
+    void setAccount(Buffer::BufferMemoryAccountSharedPtr account) override {
+      pending_recv_data_.bindAccount(account);
+      pending_send_data_.bindAccount(std::move(account));
+    }
 
     // This code assumes that details is a static string, so that we
     // can avoid copying it.
@@ -296,6 +303,9 @@ protected:
     std::unique_ptr<MetadataEncoder> metadata_encoder_;
     absl::optional<StreamResetReason> deferred_reset_;
     HeaderString cookies_;
+    // The arena for the header maps decoded for this stream, or null if header maps are allocated
+    // from the heap.
+    const HeaderArenaSharedPtr header_arena_;
     bool local_end_stream_sent_ : 1;
     bool remote_end_stream_ : 1;
     bool data_deferred_ : 1;
@@ -318,7 +328,7 @@ protected:
     ClientStreamImpl(ConnectionImpl& parent, uint32_t buffer_limit,
                      ResponseDecoder& response_decoder)
         : StreamImpl(parent, buffer_limit), response_decoder_(response_decoder),
-          headers_or_trailers_(ResponseHeaderMapImpl::create()) {}
+          headers_or_trailers_(ResponseHeaderMapImpl::create(header_arena_)) {}
 
     // StreamImpl
     void submitHeaders(const std::vector<nghttp2_nv>& final_headers,
@@ -337,9 +347,11 @@ protected:
       // If we are waiting for informational headers, make a new response header map, otherwise
       // we are about to receive trailers. The codec makes sure this is the only valid sequence.
       if (received_noninformational_headers_) {
-        headers_or_trailers_.emplace<ResponseTrailerMapPtr>(ResponseTrailerMapImpl::create());
+        headers_or_trailers_.emplace<ResponseTrailerMapPtr>(
+            ResponseTrailerMapImpl::create(header_arena_));
       } else {
-        headers_or_trailers_.emplace<ResponseHeaderMapPtr>(ResponseHeaderMapImpl::create());
+        headers_or_trailers_.emplace<ResponseHeaderMapPtr>(
+            ResponseHeaderMapImpl::create(header_arena_));
       }
     }
     HeaderMapPtr cloneTrailers(const HeaderMap& trailers) override {
@@ -368,7 +380,8 @@ protected:
    */
   struct ServerStreamImpl : public StreamImpl, public ResponseEncoder {
     ServerStreamImpl(ConnectionImpl& parent, uint32_t buffer_limit)
-        : StreamImpl(parent, buffer_limit), headers_or_trailers_(RequestHeaderMapImpl::create()) {}
+        : StreamImpl(parent, buffer_limit),
+          headers_or_trailers_(RequestHeaderMapImpl::create(header_arena_)) {}
 
     // StreamImpl
     void submitHeaders(const std::vector<nghttp2_nv>& final_headers,
@@ -384,7 +397,8 @@ protected:
       }
     }
     void allocTrailers() override {
-      headers_or_trailers_.emplace<RequestTrailerMapPtr>(RequestTrailerMapImpl::create());
+      headers_or_trailers_.emplace<RequestTrailerMapPtr>(
+          RequestTrailerMapImpl::create(header_arena_));
     }
     HeaderMapPtr cloneTrailers(const HeaderMap& trailers) override {
       return createHeaderMap<ResponseTrailerMapImpl>(trailers);
@@ -503,6 +517,8 @@ protected:
   // controlled by "envoy.reloadable_features.http2_skip_encoding_empty_trailers" runtime feature
   // flag.
   const bool skip_encoding_empty_trailers_;
+  // Whether the header maps decoded for each stream are allocated from a per-stream HeaderArena.
+  const bool use_header_arena_;
 
 private:
   virtual ConnectionCallbacks& callbacks() PURE;
@@ -528,6 +544,9 @@ private:
   void sendKeepalive();
   void onKeepaliveResponse();
   void onKeepaliveResponseTimeout();
+  void sampleBandwidthDelayProduct(size_t len);
+  void onBandwidthDelayProductPingAck();
+  void setWindowSize(uint32_t window_size);
 
   bool dispatching_ : 1;
   bool raised_goaway_ : 1;
@@ -539,6 +558,21 @@ private:
   std::chrono::milliseconds keepalive_interval_;
   std::chrono::milliseconds keepalive_timeout_;
   uint32_t keepalive_interval_jitter_percent_;
+
+  // Auto-tuning of the flow-control windows from the bandwidth-delay product, see
+  // FlowControlWindowAutoTuning. The stream and connection windows are both window_size_, capped by
+  // the configured window sizes.
+  const bool window_auto_tuning_;
+  const uint32_t min_window_size_;
+  const uint32_t max_stream_window_size_;
+  const uint32_t max_connection_window_size_;
+  uint32_t window_size_;
+  // The bytes received since the last bandwidth-delay product PING was sent, while it is in flight.
+  bool bdp_ping_in_flight_{};
+  uint64_t bdp_bytes_{};
+  MonotonicTime bdp_ping_sent_at_;
+  // The highest bandwidth measured, in bytes per second.
+  double max_bandwidth_{};
 };
 
 /**
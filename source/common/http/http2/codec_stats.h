@@ -28,6 +28,8 @@ namespace Http2 {
   COUNTER(tx_flush_timeout)                                                                        \
   COUNTER(tx_reset)                                                                                \
   COUNTER(keepalive_timeout)                                                                       \
+  COUNTER(window_auto_tuning_grow)                                                                 \
+  COUNTER(window_auto_tuning_shrink)                                                               \
   GAUGE(streams_active, Accumulate)                                                                \
   GAUGE(pending_send_bytes, Accumulate)
 
@@ -14,27 +14,11 @@ namespace Http2 {
 /**
  * Implementation of an active client for HTTP/2
  */
-class ActiveClient : public CodecClientCallbacks,
-                     public Http::ConnectionCallbacks,
-                     public Envoy::Http::ActiveClient {
+class ActiveClient : public MultiplexedActiveClientBase {
 public:
   ActiveClient(HttpConnPoolImplBase& parent);
   ActiveClient(Envoy::Http::HttpConnPoolImplBase& parent,
                Upstream::Host::CreateConnectionData& data);
-  ~ActiveClient() override = default;
-
-  // ConnPoolImpl::ActiveClient
-  bool closingWithIncompleteStream() const override;
-  RequestEncoder& newStreamEncoder(ResponseDecoder& response_decoder) override;
-
-  // CodecClientCallbacks
-  void onStreamDestroy() override;
-  void onStreamReset(Http::StreamResetReason reason) override;
-
-  // Http::ConnectionCallbacks
-  void onGoAway(Http::GoAwayErrorCode error_code) override;
-
-  bool closed_with_active_rq_{};
 };
 
 ConnectionPool::InstancePtr
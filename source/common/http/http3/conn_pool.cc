@@ -0,0 +1,74 @@
+#include "common/http/http3/conn_pool.h"
+
+#include <cstdint>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/upstream/upstream.h"
+
+#include "common/config/utility.h"
+#include "common/http/http3/well_known_names.h"
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http3 {
+
+// The default of the max_concurrent_streams of the HTTP/3 protocol options.
+static constexpr uint32_t DEFAULT_MAX_CONCURRENT_STREAMS = 100;
+
+ActiveClient::ActiveClient(Envoy::Http::HttpConnPoolImplBase& parent,
+                           Upstream::Host::CreateConnectionData& data)
+    : MultiplexedActiveClientBase(
+          parent,
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(parent.host()->cluster().http3Options(),
+                                          max_concurrent_streams, DEFAULT_MAX_CONCURRENT_STREAMS),
+          parent.host()->cluster().stats().upstream_cx_http3_total_, data) {}
+
+Http3ConnPoolImpl::Http3ConnPoolImpl(
+    Upstream::HostConstSharedPtr host, Upstream::ResourcePriority priority,
+    Event::Dispatcher& dispatcher, const Network::ConnectionSocket::OptionsSharedPtr& options,
+    const Network::TransportSocketOptionsSharedPtr& transport_socket_options,
+    Random::RandomGenerator& random_generator, Upstream::ClusterConnectivityState& state,
+    CreateClientFn client_fn, CreateCodecFn codec_fn, std::vector<Http::Protocol> protocol)
+    : FixedHttpConnPoolImpl(host, priority, dispatcher, options, transport_socket_options,
+                            random_generator, state, client_fn, codec_fn, protocol),
+      quic_connection_factory_(
+          Config::Utility::getAndCheckFactoryByName<QuicClientConnectionFactory>(
+              QuicCodecNames::get().Quiche)),
+      quic_info_(quic_connection_factory_.createNetworkConnectionInfo(
+          dispatcher, host->transportSocketFactory(), host->cluster().statsScope(),
+          dispatcher.timeSource(), host->address(),
+          host->cluster().perConnectionBufferLimitBytes(),
+          host->cluster().http3Options().allow_early_data())) {}
+
+Upstream::Host::CreateConnectionData Http3ConnPoolImpl::createConnection() {
+  return {quic_connection_factory_.createQuicNetworkConnection(
+              *quic_info_, dispatcher(), host()->address(), host()->cluster().sourceAddress()),
+          host()};
+}
+
+ConnectionPool::InstancePtr
+allocateConnPool(Event::Dispatcher& dispatcher, Random::RandomGenerator& random_generator,
+                 Upstream::HostConstSharedPtr host, Upstream::ResourcePriority priority,
+                 const Network::ConnectionSocket::OptionsSharedPtr& options,
+                 const Network::TransportSocketOptionsSharedPtr& transport_socket_options,
+                 Upstream::ClusterConnectivityState& state) {
+  return std::make_unique<Http3ConnPoolImpl>(
+      host, priority, dispatcher, options, transport_socket_options, random_generator, state,
+      [](HttpConnPoolImplBase* pool) {
+        Upstream::Host::CreateConnectionData data =
+            static_cast<Http3ConnPoolImpl*>(pool)->createConnection();
+        return std::make_unique<ActiveClient>(*pool, data);
+      },
+      [](Upstream::Host::CreateConnectionData& data, HttpConnPoolImplBase* pool) {
+        CodecClientPtr codec{new CodecClientProd(
+            CodecClient::Type::HTTP3, std::move(data.connection_), data.host_description_,
+            pool->dispatcher(), pool->randomGenerator())};
+        return codec;
+      },
+      std::vector<Protocol>{Protocol::Http3});
+}
+
+} // namespace Http3
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/upstream/upstream.h"
+
+#include "common/http/codec_client.h"
+#include "common/http/conn_pool_base.h"
+#include "common/http/http3/quic_client_connection_factory.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http3 {
+
+/**
+ * Implementation of an active client for HTTP/3
+ */
+class ActiveClient : public MultiplexedActiveClientBase {
+public:
+  ActiveClient(Envoy::Http::HttpConnPoolImplBase& parent,
+               Upstream::Host::CreateConnectionData& data);
+};
+
+/**
+ * An HTTP/3 connection pool. Its connections share the crypto config of the host, so that a new
+ * connection resumes the session of a previous one with 0-RTT.
+ */
+class Http3ConnPoolImpl : public FixedHttpConnPoolImpl {
+public:
+  Http3ConnPoolImpl(Upstream::HostConstSharedPtr host, Upstream::ResourcePriority priority,
+                    Event::Dispatcher& dispatcher,
+                    const Network::ConnectionSocket::OptionsSharedPtr& options,
+                    const Network::TransportSocketOptionsSharedPtr& transport_socket_options,
+                    Random::RandomGenerator& random_generator,
+                    Upstream::ClusterConnectivityState& state, CreateClientFn client_fn,
+                    CreateCodecFn codec_fn, std::vector<Http::Protocol> protocol);
+
+  // Creates a QUIC connection to the host, which is connected by the active client.
+  Upstream::Host::CreateConnectionData createConnection();
+
+private:
+  QuicClientConnectionFactory& quic_connection_factory_;
+  PersistentQuicInfoPtr quic_info_;
+};
+
+ConnectionPool::InstancePtr
+allocateConnPool(Event::Dispatcher& dispatcher, Random::RandomGenerator& random_generator,
+                 Upstream::HostConstSharedPtr host, Upstream::ResourcePriority priority,
+                 const Network::ConnectionSocket::OptionsSharedPtr& options,
+                 const Network::TransportSocketOptionsSharedPtr& transport_socket_options,
+                 Upstream::ClusterConnectivityState& state);
+
+} // namespace Http3
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/config/typed_config.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/network/address.h"
+#include "envoy/network/connection.h"
+#include "envoy/network/transport_socket.h"
+#include "envoy/stats/scope.h"
+
+namespace Envoy {
+namespace Http {
+
+// What the QUIC connections to an upstream server share, such as the crypto config which caches
+// the session tickets of the server, so that new connections to it resume with 0-RTT.
+struct PersistentQuicInfo {
+  virtual ~PersistentQuicInfo() = default;
+};
+
+using PersistentQuicInfoPtr = std::unique_ptr<PersistentQuicInfo>;
+
+// A factory to create the upstream QUIC connections, which are Network::ClientConnection instances
+// to be handed to an HTTP/3 codec client.
+class QuicClientConnectionFactory : public Config::UntypedFactory {
+public:
+  ~QuicClientConnectionFactory() override = default;
+
+  /**
+   * Creates what the connections to an upstream server share.
+   * @param dispatcher supplies the dispatcher of the connections.
+   * @param transport_socket_factory supplies the QUIC transport socket factory of the cluster,
+   *        which provides the TLS context of the connections.
+   * @param stats_scope supplies the scope of the stats of the TLS context.
+   * @param time_source supplies the time source to validate certificates and tickets with.
+   * @param server_addr supplies the address of the server.
+   * @param buffer_limit supplies the send buffer limit of the connections.
+   * @param allow_early_data supplies whether the connections that resume a session send their
+   *        requests as 0-RTT early data, which may be replayed, before the handshake is complete.
+   */
+  virtual PersistentQuicInfoPtr
+  createNetworkConnectionInfo(Event::Dispatcher& dispatcher,
+                              Network::TransportSocketFactory& transport_socket_factory,
+                              Stats::Scope& stats_scope, TimeSource& time_source,
+                              Network::Address::InstanceConstSharedPtr server_addr,
+                              uint32_t buffer_limit, bool allow_early_data) PURE;
+
+  /**
+   * Creates a connection to a server, which starts its handshake on connect().
+   * @param info supplies what the connections to the server share, created by
+   *        createNetworkConnectionInfo(). It must outlive the connection.
+   * @param dispatcher supplies the dispatcher of the connection.
+   * @param server_addr supplies the address of the server.
+   * @param local_addr supplies the address to bind the connection to, which may be nullptr.
+   */
+  virtual Network::ClientConnectionPtr
+  createQuicNetworkConnection(PersistentQuicInfo& info, Event::Dispatcher& dispatcher,
+                              Network::Address::InstanceConstSharedPtr server_addr,
+                              Network::Address::InstanceConstSharedPtr local_addr) PURE;
+
+  std::string category() const override { return "envoy.quic_client_connection"; }
+};
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,57 @@
+#include "common/http/interned_header_values.h"
+
+#include <algorithm>
+
+#include "common/http/headers.h"
+
+namespace Envoy {
+namespace Http {
+
+InternedHeaderValues::InternedHeaderValues() : integers_(MaxInternedInteger) {
+  for (uint64_t i = 0; i < MaxInternedInteger; i++) {
+    integers_[i] = std::to_string(i);
+    add(integers_[i]);
+  }
+
+  const auto& custom_headers = CustomHeaders::get();
+  for (const std::string* value :
+       {&custom_headers.AcceptEncodingValues.Gzip, &custom_headers.AcceptEncodingValues.Identity,
+        &custom_headers.AcceptEncodingValues.Wildcard, &custom_headers.CacheControlValues.NoCache,
+        &custom_headers.CacheControlValues.NoCacheMaxAge0,
+        &custom_headers.CacheControlValues.NoTransform, &custom_headers.CacheControlValues.Private,
+        &custom_headers.CORSValues.True, &custom_headers.VaryValues.AcceptEncoding}) {
+    add(*value);
+  }
+
+  const auto& headers = Headers::get();
+  for (const std::string* value :
+       {&headers.ConnectionValues.Close, &headers.ConnectionValues.KeepAlive,
+        &headers.ConnectionValues.Upgrade, &headers.UpgradeValues.H2c,
+        &headers.UpgradeValues.WebSocket, &headers.ContentTypeValues.Text,
+        &headers.ContentTypeValues.TextEventStream, &headers.ContentTypeValues.TextUtf8,
+        &headers.ContentTypeValues.Html, &headers.ContentTypeValues.Grpc,
+        &headers.ContentTypeValues.GrpcWeb, &headers.ContentTypeValues.GrpcWebProto,
+        &headers.ContentTypeValues.GrpcWebText, &headers.ContentTypeValues.GrpcWebTextProto,
+        &headers.ContentTypeValues.Json, &headers.ContentTypeValues.Protobuf,
+        &headers.ContentTypeValues.FormUrlEncoded, &headers.ExpectValues._100Continue,
+        &headers.MethodValues.Connect, &headers.MethodValues.Delete, &headers.MethodValues.Get,
+        &headers.MethodValues.Head, &headers.MethodValues.Options, &headers.MethodValues.Patch,
+        &headers.MethodValues.Post, &headers.MethodValues.Put, &headers.MethodValues.Trace,
+        &headers.SchemeValues.Http, &headers.SchemeValues.Https,
+        &headers.TransferEncodingValues.Brotli, &headers.TransferEncodingValues.Chunked,
+        &headers.TransferEncodingValues.Deflate, &headers.TransferEncodingValues.Gzip,
+        &headers.TransferEncodingValues.Identity, &headers.TEValues.Trailers,
+        &headers.XContentTypeOptionValues.Nosniff}) {
+    add(*value);
+  }
+
+  values_.finalize();
+}
+
+void InternedHeaderValues::add(absl::string_view value) {
+  values_.add(value, value);
+  max_value_length_ = std::max(max_value_length_, value.size());
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/http/header_map.h"
+
+#include "common/common/utility.h"
+#include "common/singleton/const_singleton.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * Values that recur across requests and responses, such as ":status: 200",
+ * "content-type: application/json" and small "content-length" values. Codecs reference the
+ * interned copy of a decoded value rather than copying it into each HeaderString. The values are
+ * drawn from the Http::Headers constants, plus the integers below MaxInternedInteger, and live for
+ * the lifetime of the process.
+ */
+class InternedHeaderValues {
+public:
+  InternedHeaderValues();
+
+  /**
+   * @param value supplies the value to look up.
+   * @return a view of the interned copy of value, or an empty view if value is not interned.
+   */
+  absl::string_view find(absl::string_view value) const {
+    if (value.size() > max_value_length_ || value.empty()) {
+      return {};
+    }
+    return values_.find(value);
+  }
+
+  /**
+   * Sets a decoded header value, referencing the interned copy of the value if there is one and
+   * copying it otherwise.
+   * @param header supplies the header string to set.
+   * @param value supplies the decoded value.
+   */
+  void setValue(HeaderString& header, absl::string_view value) const {
+    const absl::string_view interned = find(value);
+    if (!interned.empty()) {
+      header.setReference(interned);
+    } else {
+      header.setCopy(value);
+    }
+  }
+
+  // Covers status codes and small content lengths.
+  static constexpr uint64_t MaxInternedInteger = 1024;
+
+private:
+  void add(absl::string_view value);
+
+  // Backing storage for the interned integers. Sized on construction and never resized, so views
+  // of its strings remain valid.
+  std::vector<std::string> integers_;
+  PerfectHashLookupTable<absl::string_view> values_;
+  size_t max_value_length_{};
+};
+
+using InternedValues = ConstSingleton<InternedHeaderValues>;
+
+} // namespace Http
+} // namespace Envoy
@@ -2,7 +2,9 @@
 
 #include "common/chromium_url/url_canon.h"
 #include "common/chromium_url/url_canon_stdstring.h"
+#include "common/common/byte_class.h"
 #include "common/common/logger.h"
+#include "common/common/macros.h"
 
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
@@ -12,6 +14,36 @@ namespace Envoy {
 namespace Http {
 
 namespace {
+
+// The bytes that the canonicalizer may rewrite: control characters and the other characters it
+// escapes, '%' escape sequences, backslashes, and dots, which may start a "." or ".." segment.
+// '=', ']' and '~' lie within the ranges but are copied as they are.
+const ByteClass& pathRewriteCandidates() {
+  CONSTRUCT_ON_FIRST_USE(
+      ByteClass,
+      absl::string_view("\x00\x20\x22\x23\x25\x25\x2e\x2e\x3c\x3e\x5c\x5e\x60\x60\x7b\xff", 16),
+      "=]~");
+}
+
+// Returns true if canonicalizePath() would return the path unchanged. Most paths are already
+// canonical, and this avoids building a copy of them.
+bool isCanonicalPath(absl::string_view path) {
+  if (path.empty() || path[0] != '/') {
+    return false;
+  }
+  const ByteClass& candidates = pathRewriteCandidates();
+  const char* end = path.data() + path.size();
+  for (const char* p = candidates.find(path.data(), end); p != end;
+       p = candidates.find(p + 1, end)) {
+    // A dot that does not start a segment is part of a name. The first byte is a slash, so p[-1]
+    // is within the path.
+    if (*p != '.' || p[-1] == '/') {
+      return false;
+    }
+  }
+  return true;
+}
+
 absl::optional<std::string> canonicalizePath(absl::string_view original_path) {
   std::string canonical_path;
   chromium_url::Component in_component(0, original_path.size());
@@ -33,6 +65,9 @@ bool PathUtil::canonicalPath(RequestHeaderMap& headers) {
   const auto original_path = headers.getPathValue();
   // canonicalPath is supposed to apply on path component in URL instead of :path header
   const auto query_pos = original_path.find('?');
+  if (isCanonicalPath(original_path.substr(0, query_pos))) {
+    return true;
+  }
   auto normalized_path_opt = canonicalizePath(
       query_pos == original_path.npos
           ? original_path
@@ -0,0 +1,90 @@
+#include "common/http/raw_header_block.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Http {
+
+namespace {
+
+bool isOptionalWhitespace(char c) { return c == ' ' || c == '\t'; }
+
+} // namespace
+
+RawHeaderBlockConstSharedPtr RawHeaderBlock::create(absl::string_view block) {
+  if (block.empty() || block.size() > std::numeric_limits<uint32_t>::max()) {
+    return nullptr;
+  }
+
+  auto raw_block = std::make_shared<RawHeaderBlock>();
+  raw_block->data_ = std::string(block);
+  std::string& data = raw_block->data_;
+
+  size_t begin = 0;
+  while (begin < data.size()) {
+    size_t end = data.find('\n', begin);
+    if (end == std::string::npos) {
+      end = data.size();
+    } else if (end == begin || data[end - 1] != '\r') {
+      // Lines terminated by a bare LF are not forwarded verbatim.
+      return nullptr;
+    }
+    const size_t line_end = end == data.size() ? end : end - 1;
+    if (std::find(data.begin() + begin, data.begin() + line_end, '\r') != data.begin() + line_end) {
+      return nullptr;
+    }
+
+    // A line starting with whitespace continues the previous one (obsolete line folding), and a
+    // name followed by whitespace is malformed. Neither is accepted by the parser, but the block
+    // must not depend on that.
+    const size_t colon = data.find(':', begin);
+    if (colon >= line_end || colon == begin ||
+        std::any_of(data.begin() + begin, data.begin() + colon, isOptionalWhitespace)) {
+      return nullptr;
+    }
+    std::transform(data.begin() + begin, data.begin() + colon, data.begin() + begin,
+                   absl::ascii_tolower);
+
+    size_t value_begin = colon + 1;
+    while (value_begin < line_end && isOptionalWhitespace(data[value_begin])) {
+      ++value_begin;
+    }
+    size_t value_end = line_end;
+    while (value_end > value_begin && isOptionalWhitespace(data[value_end - 1])) {
+      --value_end;
+    }
+
+    const uint32_t key_size = colon - begin;
+    const uint32_t value_size = value_end - value_begin;
+    raw_block->lines_.push_back({static_cast<uint32_t>(begin), static_cast<uint32_t>(line_end),
+                                 key_size, static_cast<uint32_t>(value_begin), value_size});
+    // Formatting the header takes the key, ": " and the value.
+    const uint64_t line_size = line_end - begin;
+    if (line_size > key_size + 2 + value_size) {
+      raw_block->padding_size_ += line_size - (key_size + 2 + value_size);
+    }
+
+    begin = end + 1;
+  }
+  return raw_block;
+}
+
+size_t RawHeaderBlock::find(absl::string_view key, absl::string_view value,
+                            size_t first_line) const {
+  const size_t last_line = std::min(lines_.size(), first_line + MaxLineSearch);
+  for (size_t i = first_line; i < last_line; ++i) {
+    const Line& line = lines_[i];
+    if (line.key_size_ == key.size() && line.value_size_ == value.size() &&
+        absl::string_view(data_.data() + line.begin_, line.key_size_) == key &&
+        absl::string_view(data_.data() + line.value_begin_, line.value_size_) == value) {
+      return i;
+    }
+  }
+  return lines_.size();
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Http {
+
+class RawHeaderBlock;
+using RawHeaderBlockConstSharedPtr = std::shared_ptr<const RawHeaderBlock>;
+
+/**
+ * A copy of the header lines of an HTTP/1 message as they were received, with the header names
+ * lower cased. When a decoded header map is forwarded over another HTTP/1 connection, the encoder
+ * copies runs of lines whose header is still present in the map, unmodified and in the same order,
+ * in one piece rather than formatting each header. Headers that were added or modified since the
+ * message was decoded are formatted as usual, and lines of removed headers are skipped.
+ *
+ * A line is only copied when its name and value match the header being encoded, so a stale block
+ * never changes what is sent. Spliced lines keep the optional whitespace around the value that the
+ * peer sent.
+ */
+class RawHeaderBlock {
+public:
+  struct Line {
+    // The offset of the first byte of the header name, and of the first byte after the value and
+    // any trailing whitespace.
+    uint32_t begin_;
+    uint32_t end_;
+    uint32_t key_size_;
+    // The offset and the size of the value, excluding surrounding whitespace.
+    uint32_t value_begin_;
+    uint32_t value_size_;
+  };
+
+  /**
+   * Copies and indexes a block of header lines.
+   * @param block supplies the header lines from the first byte of the first header name to the last
+   *        byte of the last header value. Lines must be terminated by CRLF.
+   * @return the indexed block, or nullptr if the block contains lines that cannot be spliced, such
+   *         as obsolete line folding or lines terminated by a bare LF.
+   */
+  static RawHeaderBlockConstSharedPtr create(absl::string_view block);
+
+  /**
+   * Finds the line of a header, searching forward from a line.
+   * @param key supplies the name of the header.
+   * @param value supplies the value of the header.
+   * @param first_line supplies the index of the first line to consider.
+   * @return the index of the matching line, or size() if none of the next MaxLineSearch lines
+   *         match.
+   */
+  size_t find(absl::string_view key, absl::string_view value, size_t first_line) const;
+
+  /**
+   * @return the bytes from the start of line first to the end of line last, inclusive. Lines in
+   *         between are included with their CRLF terminators.
+   */
+  absl::string_view lines(size_t first, size_t last) const {
+    return absl::string_view(data_).substr(lines_[first].begin_,
+                                           lines_[last].end_ - lines_[first].begin_);
+  }
+
+  /**
+   * @return the number of lines in the block.
+   */
+  size_t size() const { return lines_.size(); }
+
+  /**
+   * @return an upper bound on how many more bytes spliced lines take than formatting the same
+   *         headers as "key: value".
+   */
+  uint64_t paddingSize() const { return padding_size_; }
+
+  // How many lines find() looks at, so that a header that is missing from the block does not cost a
+  // scan of the whole block.
+  static constexpr size_t MaxLineSearch = 4;
+
+private:
+  std::string data_;
+  absl::InlinedVector<Line, 16> lines_;
+  uint64_t padding_size_{};
+};
+
+} // namespace Http
+} // namespace Envoy
@@ -482,6 +482,15 @@ Utility::parseHttp1Settings(const envoy::config::core::v3::Http1ProtocolOptions&
     ret.header_key_format_ = Http1Settings::HeaderKeyFormat::Default;
   }
 
+  if (config.has_response_write_coalescing()) {
+    const auto& coalescing = config.response_write_coalescing();
+    ret.coalesce_response_writes_ = true;
+    ret.max_coalesced_response_bytes_ =
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(coalescing, max_coalesced_bytes, 64 * 1024);
+    ret.response_headers_hold_time_ =
+        std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(coalescing, headers_hold_time, 0));
+  }
+
   return ret;
 }
 
@@ -532,8 +541,9 @@ void Utility::sendLocalReply(const bool& is_reset, const EncodeFunctions& encode
   std::string body_text(local_reply_data.body_text_);
   absl::string_view content_type(Headers::get().ContentTypeValues.Text);
 
-  ResponseHeaderMapPtr response_headers{createHeaderMap<ResponseHeaderMapImpl>(
-      {{Headers::get().Status, std::to_string(enumToInt(response_code))}})};
+  // The status is set as an integer, which is formatted in place in the inline header.
+  ResponseHeaderMapPtr response_headers{ResponseHeaderMapImpl::create()};
+  response_headers->setStatus(enumToInt(response_code));
 
   if (encode_functions.modify_headers_) {
     encode_functions.modify_headers_(*response_headers);
@@ -544,12 +554,12 @@ void Utility::sendLocalReply(const bool& is_reset, const EncodeFunctions& encode
 
   // Respond with a gRPC trailers-only response if the request is gRPC
   if (local_reply_data.is_grpc_) {
-    response_headers->setStatus(std::to_string(enumToInt(Code::OK)));
+    response_headers->setStatus(enumToInt(Code::OK));
     response_headers->setReferenceContentType(Headers::get().ContentTypeValues.Grpc);
     response_headers->setGrpcStatus(
-        std::to_string(enumToInt(local_reply_data.grpc_status_
-                                     ? local_reply_data.grpc_status_.value()
-                                     : Grpc::Utility::httpToGrpcStatus(enumToInt(response_code)))));
+        enumToInt(local_reply_data.grpc_status_
+                      ? local_reply_data.grpc_status_.value()
+                      : Grpc::Utility::httpToGrpcStatus(enumToInt(response_code))));
     if (!body_text.empty() && !local_reply_data.is_head_request_) {
       // TODO(dio): Probably it is worth to consider caching the encoded message based on gRPC
       // status.
@@ -903,13 +913,7 @@ void Utility::transformUpgradeResponseFromH2toH1(ResponseHeaderMap& headers,
 const Router::RouteSpecificFilterConfig*
 Utility::resolveMostSpecificPerFilterConfigGeneric(const std::string& filter_name,
                                                    const Router::RouteConstSharedPtr& route) {
-
-  const Router::RouteSpecificFilterConfig* maybe_filter_config{};
-  traversePerFilterConfigGeneric(
-      filter_name, route, [&maybe_filter_config](const Router::RouteSpecificFilterConfig& cfg) {
-        maybe_filter_config = &cfg;
-      });
-  return maybe_filter_config;
+  return route ? route->mostSpecificPerFilterConfig(filter_name) : nullptr;
 }
 
 void Utility::traversePerFilterConfigGeneric(
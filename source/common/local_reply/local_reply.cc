@@ -13,38 +13,156 @@
 #include "common/http/header_map_impl.h"
 #include "common/router/header_parser.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
 namespace Envoy {
 namespace LocalReply {
 
+namespace {
+
+constexpr absl::string_view LocalReplyBodyCommand = "%LOCAL_REPLY_BODY%";
+
+// Whether the commands of a format are all among those which only depend on the body and the
+// response code of the local reply.
+bool usesOnlyReplyCommands(absl::string_view format) {
+  size_t pos = 0;
+  while ((pos = format.find('%', pos)) != absl::string_view::npos) {
+    const size_t end = format.find('%', pos + 1);
+    if (end == absl::string_view::npos) {
+      return false;
+    }
+    const absl::string_view command = format.substr(pos + 1, end - pos - 1);
+    if (command != "LOCAL_REPLY_BODY" && command != "RESPONSE_CODE") {
+      return false;
+    }
+    pos = end + 1;
+  }
+  return true;
+}
+
+bool usesOnlyReplyCommands(const ProtobufWkt::Struct& format);
+
+bool usesOnlyReplyCommands(const ProtobufWkt::Value& value) {
+  switch (value.kind_case()) {
+  case ProtobufWkt::Value::kStringValue:
+    return usesOnlyReplyCommands(value.string_value());
+  case ProtobufWkt::Value::kStructValue:
+    return usesOnlyReplyCommands(value.struct_value());
+  case ProtobufWkt::Value::kListValue:
+    for (const auto& element : value.list_value().values()) {
+      if (!usesOnlyReplyCommands(element)) {
+        return false;
+      }
+    }
+    return true;
+  default:
+    return true;
+  }
+}
+
+bool usesOnlyReplyCommands(const ProtobufWkt::Struct& format) {
+  for (const auto& field : format.fields()) {
+    if (!usesOnlyReplyCommands(field.second)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
 class BodyFormatter {
 public:
-  BodyFormatter()
-      : formatter_(std::make_unique<Envoy::Formatter::FormatterImpl>("%LOCAL_REPLY_BODY%")),
-        content_type_(Http::Headers::get().ContentTypeValues.Text) {}
+  BodyFormatter() : content_type_(Http::Headers::get().ContentTypeValues.Text) {}
 
   BodyFormatter(const envoy::config::core::v3::SubstitutionFormatString& config, Api::Api& api)
-      : formatter_(Formatter::SubstitutionFormatStringUtils::fromProtoConfig(config, api)),
-        content_type_(
+      : content_type_(
             !config.content_type().empty()
                 ? config.content_type()
                 : config.format_case() ==
                           envoy::config::core::v3::SubstitutionFormatString::FormatCase::kJsonFormat
                       ? Http::Headers::get().ContentTypeValues.Json
-                      : Http::Headers::get().ContentTypeValues.Text) {}
+                      : Http::Headers::get().ContentTypeValues.Text) {
+    switch (config.format_case()) {
+    case envoy::config::core::v3::SubstitutionFormatString::FormatCase::kTextFormat:
+      initTextFormat(config.text_format(), config.omit_empty_values());
+      break;
+    case envoy::config::core::v3::SubstitutionFormatString::FormatCase::kTextFormatSource:
+      initTextFormat(Config::DataSource::read(config.text_format_source(), true, api), false);
+      break;
+    default:
+      formatter_ = Formatter::SubstitutionFormatStringUtils::fromProtoConfig(config, api);
+      prerender_ = usesOnlyReplyCommands(config.json_format());
+      break;
+    }
+  }
 
   void format(const Http::RequestHeaderMap& request_headers,
               const Http::ResponseHeaderMap& response_headers,
               const Http::ResponseTrailerMap& response_trailers,
               const StreamInfo::StreamInfo& stream_info, std::string& body,
               absl::string_view& content_type) const {
-    body =
-        formatter_->format(request_headers, response_headers, response_trailers, stream_info, body);
     content_type = content_type_;
+    if (formatter_ == nullptr) {
+      // The format is %LOCAL_REPLY_BODY%, which renders the body as is.
+      return;
+    }
+    if (!prerender_) {
+      body = formatter_->format(request_headers, response_headers, response_trailers, stream_info,
+                                body);
+      return;
+    }
+
+    const uint32_t code = stream_info.responseCode().value_or(0);
+    {
+      absl::ReaderMutexLock lock(&mutex_);
+      const auto code_it = rendered_bodies_.find(code);
+      if (code_it != rendered_bodies_.end()) {
+        const auto it = code_it->second.find(body);
+        if (it != code_it->second.end()) {
+          body = it->second;
+          return;
+        }
+      }
+    }
+    std::string rendered =
+        formatter_->format(request_headers, response_headers, response_trailers, stream_info, body);
+    {
+      absl::MutexLock lock(&mutex_);
+      if (rendered_body_count_ < MaxRenderedBodies &&
+          rendered_bodies_[code].emplace(body, rendered).second) {
+        ++rendered_body_count_;
+      }
+    }
+    body = std::move(rendered);
   }
 
 private:
-  const Formatter::FormatterPtr formatter_;
+  // The number of bodies kept rendered. The bodies of local replies mostly come from a small set
+  // of response code details, so this is only reached by bodies which vary with the request.
+  static constexpr size_t MaxRenderedBodies = 1024;
+
+  // Mirrors SubstitutionFormatStringUtils::fromProtoConfig(), which only honors
+  // omit_empty_values for text_format.
+  void initTextFormat(const std::string& format, bool omit_empty_values) {
+    if (format == LocalReplyBodyCommand) {
+      return;
+    }
+    formatter_ = std::make_unique<Formatter::FormatterImpl>(format, omit_empty_values);
+    prerender_ = usesOnlyReplyCommands(format);
+  }
+
+  // Null if the body is rendered as is.
+  Formatter::FormatterPtr formatter_;
   const std::string content_type_;
+  // Whether the format only depends on the body and the response code, so that the rendered
+  // bodies are kept for the next local replies with the same body and response code, by code.
+  bool prerender_{};
+  mutable absl::Mutex mutex_;
+  mutable absl::flat_hash_map<uint32_t, absl::flat_hash_map<std::string, std::string>>
+      rendered_bodies_ ABSL_GUARDED_BY(mutex_);
+  mutable size_t rendered_body_count_ ABSL_GUARDED_BY(mutex_) = 0;
 };
 
 using BodyFormatterPtr = std::unique_ptr<BodyFormatter>;
@@ -92,7 +210,7 @@ public:
 
     if (status_code_.has_value() && code != status_code_.value()) {
       code = status_code_.value();
-      response_headers.setStatus(std::to_string(enumToInt(code)));
+      response_headers.setStatus(enumToInt(code));
       stream_info.setResponseCode(static_cast<uint32_t>(code));
     }
 
@@ -135,7 +253,7 @@ public:
     // Set response code to stream_info and response_headers due to:
     // 1) StatusCode filter is using response_code from stream_info,
     // 2) %RESP(:status)% is from Status() in response_headers.
-    response_headers.setStatus(std::to_string(enumToInt(code)));
+    response_headers.setStatus(enumToInt(code));
     stream_info.setResponseCode(static_cast<uint32_t>(code));
 
     if (request_headers == nullptr) {
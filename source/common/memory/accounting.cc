@@ -0,0 +1,127 @@
+#include "common/memory/accounting.h"
+
+#include <array>
+#include <atomic>
+
+#include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+#include "common/common/macros.h"
+#include "common/common/thread.h"
+#include "common/common/thread_annotations.h"
+
+#include "absl/container/flat_hash_set.h"
+
+namespace Envoy {
+namespace Memory {
+namespace {
+
+// The counts of a thread, only written by the thread. They are atomics, written with a relaxed
+// load and store rather than a read-modify-write, only so that the readers may read them. The
+// counts are signed, as a thread may free what another thread allocated.
+struct ThreadCounts {
+  std::array<std::atomic<int64_t>, Accounting::NumAccounts> bytes_{};
+  std::array<std::atomic<int64_t>, Accounting::NumAccounts> objects_{};
+};
+
+struct Registry {
+  Thread::MutexBasicLockable mutex_;
+  absl::flat_hash_set<ThreadCounts*> threads_ ABSL_GUARDED_BY(mutex_);
+  // The counts of the threads which exited, and of the accounting done on a thread once its
+  // counts were retired.
+  std::array<std::atomic<int64_t>, Accounting::NumAccounts> retired_bytes_{};
+  std::array<std::atomic<int64_t>, Accounting::NumAccounts> retired_objects_{};
+};
+
+Registry& registry() { MUTABLE_CONSTRUCT_ON_FIRST_USE(Registry); }
+
+// The counts of the calling thread. Null before first use and after the counts were retired.
+thread_local ThreadCounts* current_counts = nullptr;
+thread_local bool current_counts_retired = false;
+
+struct ThreadCountsHolder {
+  ThreadCountsHolder() {
+    current_counts = new ThreadCounts();
+    Registry& reg = registry();
+    Thread::LockGuard guard(reg.mutex_);
+    reg.threads_.insert(current_counts);
+  }
+  ~ThreadCountsHolder() {
+    ThreadCounts* counts = current_counts;
+    current_counts = nullptr;
+    current_counts_retired = true;
+    Registry& reg = registry();
+    {
+      Thread::LockGuard guard(reg.mutex_);
+      reg.threads_.erase(counts);
+      for (uint32_t i = 0; i < Accounting::NumAccounts; ++i) {
+        reg.retired_bytes_[i].fetch_add(counts->bytes_[i].load(), std::memory_order_relaxed);
+        reg.retired_objects_[i].fetch_add(counts->objects_[i].load(), std::memory_order_relaxed);
+      }
+    }
+    delete counts;
+  }
+};
+
+ThreadCounts* localCounts() {
+  if (current_counts == nullptr && !current_counts_retired) {
+    static thread_local ThreadCountsHolder holder;
+  }
+  return current_counts;
+}
+
+void addRelaxed(std::atomic<int64_t>& count, int64_t delta) {
+  count.store(count.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+} // namespace
+
+void Accounting::add(Account account, int64_t bytes, int64_t objects) {
+  const auto index = static_cast<uint32_t>(account);
+  ThreadCounts* counts = localCounts();
+  if (counts == nullptr) {
+    // The thread is exiting, and its counts were retired already.
+    Registry& reg = registry();
+    reg.retired_bytes_[index].fetch_add(bytes, std::memory_order_relaxed);
+    reg.retired_objects_[index].fetch_add(objects, std::memory_order_relaxed);
+    return;
+  }
+  addRelaxed(counts->bytes_[index], bytes);
+  addRelaxed(counts->objects_[index], objects);
+}
+
+Accounting::Usage Accounting::usage(Account account) {
+  const auto index = static_cast<uint32_t>(account);
+  Registry& reg = registry();
+  Thread::LockGuard guard(reg.mutex_);
+  int64_t bytes = reg.retired_bytes_[index].load(std::memory_order_relaxed);
+  int64_t objects = reg.retired_objects_[index].load(std::memory_order_relaxed);
+  for (const ThreadCounts* counts : reg.threads_) {
+    bytes += counts->bytes_[index].load(std::memory_order_relaxed);
+    objects += counts->objects_[index].load(std::memory_order_relaxed);
+  }
+  // The counts of the threads are read at slightly different times, so that a free may be seen
+  // without the allocation.
+  Usage usage;
+  usage.bytes_ = bytes > 0 ? bytes : 0;
+  usage.objects_ = objects > 0 ? objects : 0;
+  return usage;
+}
+
+absl::string_view Accounting::accountName(Account account) {
+  switch (account) {
+  case Account::BufferSlices:
+    return "buffer_slices";
+  case Account::HeaderMaps:
+    return "header_maps";
+  case Account::SymbolTable:
+    return "symbol_table";
+  case Account::Clusters:
+    return "clusters";
+  case Account::TlsContexts:
+    return "tls_contexts";
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+} // namespace Memory
+} // namespace Envoy
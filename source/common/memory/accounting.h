@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Memory {
+
+/**
+ * Accounting of the memory of the main consumers of memory, cheap enough to stay on in
+ * production. The subsystems report the bytes and the objects they allocate and free to their
+ * account, which each thread counts on its own, without atomic read-modify-writes, and reading an
+ * account sums the counts of all the threads.
+ *
+ * The accounts cover the bulk of the memory of each subsystem rather than every allocation, so
+ * that they are an estimate of how the heap is used, which does not add up to the heap size.
+ */
+class Accounting {
+public:
+  enum class Account : uint8_t {
+    // The storage of the buffer slices.
+    BufferSlices,
+    // The keys and values of the HTTP header maps.
+    HeaderMaps,
+    // The names of the symbols of the stats symbol tables.
+    SymbolTable,
+    // The upstream clusters, by the size of their ClusterInfoImpl.
+    Clusters,
+    // The TLS contexts, by the size of their ContextImpl.
+    TlsContexts,
+  };
+
+  static constexpr uint32_t NumAccounts = static_cast<uint32_t>(Account::TlsContexts) + 1;
+
+  struct Usage {
+    uint64_t bytes_{};
+    uint64_t objects_{};
+  };
+
+  /**
+   * Accounts for an object allocated.
+   * @param account supplies the account of the object.
+   * @param bytes supplies the size of the object.
+   */
+  static void allocate(Account account, uint64_t bytes) { add(account, bytes, 1); }
+
+  /**
+   * Accounts for an object freed, which may have been allocated on another thread.
+   * @param account supplies the account of the object.
+   * @param bytes supplies the size of the object, as last accounted for.
+   */
+  static void free(Account account, uint64_t bytes) {
+    add(account, -static_cast<int64_t>(bytes), -1);
+  }
+
+  /**
+   * Accounts for an object which grew or shrank.
+   * @param account supplies the account of the object.
+   * @param delta supplies the change of the size of the object.
+   */
+  static void resize(Account account, int64_t delta) { add(account, delta, 0); }
+
+  /**
+   * @return the memory accounted to an account, summed over all the threads.
+   */
+  static Usage usage(Account account);
+
+  /**
+   * @return the name of an account.
+   */
+  static absl::string_view accountName(Account account);
+
+private:
+  static void add(Account account, int64_t bytes, int64_t objects);
+};
+
+} // namespace Memory
+} // namespace Envoy
@@ -13,11 +13,11 @@ constexpr std::chrono::milliseconds kTimerInterval = std::chrono::milliseconds(1
 
 HeapShrinker::HeapShrinker(Event::Dispatcher& dispatcher, Server::OverloadManager& overload_manager,
                            Stats::Scope& stats)
-    : active_(false) {
+    : state_(Server::OverloadActionState::inactive()) {
   const auto action_name = Server::OverloadActionNames::get().ShrinkHeap;
   if (overload_manager.registerForAction(
           action_name, dispatcher,
-          [this](Server::OverloadActionState state) { active_ = state.isSaturated(); })) {
+          [this](Server::OverloadActionState state) { state_ = state; })) {
     Envoy::Stats::StatNameManagedStorage stat_name(
         absl::StrCat("overload.", action_name, ".shrink_count"), stats.symbolTable());
     shrink_counter_ = &stats.counterFromStatName(stat_name.statName());
@@ -30,9 +30,12 @@ HeapShrinker::HeapShrinker(Event::Dispatcher& dispatcher, Server::OverloadManage
 }
 
 void HeapShrinker::shrinkHeap() {
-  if (active_) {
+  if (state_.isSaturated()) {
     Utils::releaseFreeMemory();
     shrink_counter_->inc();
+  } else if (state_.value() > 0) {
+    Utils::releaseFreeMemory(state_.value());
+    shrink_counter_->inc();
   }
 }
 
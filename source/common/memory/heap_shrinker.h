@@ -11,6 +11,9 @@ namespace Memory {
 /**
  * A utility class to periodically attempt to shrink the heap by releasing free memory
  * to the system if the "shrink heap" overload action has been configured and triggered.
+ * The memory released is in proportion to the value of the action: all the free memory when it
+ * is saturated, and the same fraction of the free pages of the page heap otherwise, so that a
+ * scaled trigger keeps most of the heap warm while the pressure is low.
  */
 class HeapShrinker {
 public:
@@ -20,7 +23,7 @@ public:
 private:
   void shrinkHeap();
 
-  bool active_;
+  Server::OverloadActionState state_;
   Envoy::Stats::Counter* shrink_counter_;
   Envoy::Event::TimerPtr timer_;
 };
@@ -1,6 +1,7 @@
 #include "common/memory/utils.h"
 
 #include "common/common/assert.h"
+#include "common/common/macros.h"
 #include "common/memory/stats.h"
 
 #if defined(TCMALLOC)
@@ -27,6 +28,23 @@ void Utils::releaseFreeMemory() {
 #endif
 }
 
+void Utils::releaseFreeMemory(double fraction) {
+  ASSERT(fraction >= 0 && fraction <= 1);
+#if defined(TCMALLOC) || defined(GPERFTOOLS_TCMALLOC)
+  const size_t bytes = static_cast<size_t>(fraction * Stats::totalPageHeapFree());
+  if (bytes == 0) {
+    return;
+  }
+#if defined(TCMALLOC)
+  tcmalloc::MallocExtension::ReleaseMemoryToSystem(bytes);
+#else
+  MallocExtension::instance()->ReleaseToSystem(bytes);
+#endif
+#else
+  UNREFERENCED_PARAMETER(fraction);
+#endif
+}
+
 /*
   The purpose of this function is to release the cache introduced by tcmalloc,
   mainly in xDS config updates, admin handler, and so on. all work on the main thread,
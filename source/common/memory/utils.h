@@ -6,6 +6,8 @@ namespace Memory {
 class Utils {
 public:
   static void releaseFreeMemory();
+  // Releases the given fraction, between 0 and 1, of the free pages of the page heap.
+  static void releaseFreeMemory(double fraction);
   static void tryShrinkHeap();
 };
 
@@ -9,6 +9,7 @@
 
 #include "common/common/assert.h"
 #include "common/common/fmt.h"
+#include "common/common/hash.h"
 #include "common/common/utility.h"
 #include "common/network/socket_interface.h"
 
@@ -20,21 +21,21 @@ namespace {
 
 // Validate that IPv4 is supported on this platform, raise an exception for the
 // given address if not.
-void validateIpv4Supported(const std::string& address) {
+void validateIpv4Supported(const Instance& address) {
   static const bool supported = SocketInterfaceSingleton::get().ipFamilySupported(AF_INET);
   if (!supported) {
     throw EnvoyException(
-        fmt::format("IPv4 addresses are not supported on this machine: {}", address));
+        fmt::format("IPv4 addresses are not supported on this machine: {}", address.asString()));
   }
 }
 
 // Validate that IPv6 is supported on this platform, raise an exception for the
 // given address if not.
-void validateIpv6Supported(const std::string& address) {
+void validateIpv6Supported(const Instance& address) {
   static const bool supported = SocketInterfaceSingleton::get().ipFamilySupported(AF_INET6);
   if (!supported) {
     throw EnvoyException(
-        fmt::format("IPv6 addresses are not supported on this machine: {}", address));
+        fmt::format("IPv6 addresses are not supported on this machine: {}", address.asString()));
   }
 }
 
@@ -49,6 +50,14 @@ const SocketInterface* sockInterfaceOrDefault(const SocketInterface* sock_interf
   return sock_interface == nullptr ? &SocketInterfaceSingleton::get() : sock_interface;
 }
 
+size_t roundUpToPowerOfTwo(uint32_t size) {
+  size_t rounded = 1;
+  while (rounded < size) {
+    rounded <<= 1;
+  }
+  return rounded;
+}
+
 } // namespace
 
 Address::InstanceConstSharedPtr addressFromSockAddr(const sockaddr_storage& ss, socklen_t ss_len,
@@ -99,15 +108,7 @@ Ipv4Instance::Ipv4Instance(const sockaddr_in* address, const SocketInterface* so
     : InstanceBase(Type::Ip, sockInterfaceOrDefault(sock_interface)) {
   memset(&ip_.ipv4_.address_, 0, sizeof(ip_.ipv4_.address_));
   ip_.ipv4_.address_ = *address;
-  ip_.friendly_address_ = sockaddrToString(*address);
-
-  // Based on benchmark testing, this reserve+append implementation runs faster than absl::StrCat.
-  fmt::format_int port(ntohs(address->sin_port));
-  friendly_name_.reserve(ip_.friendly_address_.size() + 1 + port.size());
-  friendly_name_.append(ip_.friendly_address_);
-  friendly_name_.push_back(':');
-  friendly_name_.append(port.data(), port.size());
-  validateIpv4Supported(friendly_name_);
+  validateIpv4Supported(*this);
 }
 
 Ipv4Instance::Ipv4Instance(const std::string& address, const SocketInterface* sock_interface)
@@ -123,10 +124,7 @@ Ipv4Instance::Ipv4Instance(const std::string& address, uint32_t port,
   if (1 != rc) {
     throw EnvoyException(fmt::format("invalid ipv4 address '{}'", address));
   }
-
-  friendly_name_ = absl::StrCat(address, ":", port);
-  validateIpv4Supported(friendly_name_);
-  ip_.friendly_address_ = address;
+  validateIpv4Supported(*this);
 }
 
 Ipv4Instance::Ipv4Instance(uint32_t port, const SocketInterface* sock_interface)
@@ -135,9 +133,18 @@ Ipv4Instance::Ipv4Instance(uint32_t port, const SocketInterface* sock_interface)
   ip_.ipv4_.address_.sin_family = AF_INET;
   ip_.ipv4_.address_.sin_port = htons(port);
   ip_.ipv4_.address_.sin_addr.s_addr = INADDR_ANY;
-  friendly_name_ = absl::StrCat("0.0.0.0:", port);
-  validateIpv4Supported(friendly_name_);
-  ip_.friendly_address_ = "0.0.0.0";
+  validateIpv4Supported(*this);
+}
+
+void Ipv4Instance::IpHelper::format() const {
+  friendly_address_ = sockaddrToString(ipv4_.address_);
+
+  // Based on benchmark testing, this reserve+append implementation runs faster than absl::StrCat.
+  fmt::format_int port(ntohs(ipv4_.address_.sin_port));
+  friendly_name_.reserve(friendly_address_.size() + 1 + port.size());
+  friendly_name_.append(friendly_address_);
+  friendly_name_.push_back(':');
+  friendly_name_.append(port.data(), port.size());
 }
 
 bool Ipv4Instance::operator==(const Instance& rhs) const {
@@ -195,10 +202,8 @@ Ipv6Instance::Ipv6Instance(const sockaddr_in6& address, bool v6only,
                            const SocketInterface* sock_interface)
     : InstanceBase(Type::Ip, sockInterfaceOrDefault(sock_interface)) {
   ip_.ipv6_.address_ = address;
-  ip_.friendly_address_ = ip_.ipv6_.makeFriendlyAddress();
   ip_.ipv6_.v6only_ = v6only;
-  friendly_name_ = fmt::format("[{}]:{}", ip_.friendly_address_, ip_.port());
-  validateIpv6Supported(friendly_name_);
+  validateIpv6Supported(*this);
 }
 
 Ipv6Instance::Ipv6Instance(const std::string& address, const SocketInterface* sock_interface)
@@ -216,15 +221,18 @@ Ipv6Instance::Ipv6Instance(const std::string& address, uint32_t port,
   } else {
     ip_.ipv6_.address_.sin6_addr = in6addr_any;
   }
-  // Just in case address is in a non-canonical format, format from network address.
-  ip_.friendly_address_ = ip_.ipv6_.makeFriendlyAddress();
-  friendly_name_ = fmt::format("[{}]:{}", ip_.friendly_address_, ip_.port());
-  validateIpv6Supported(friendly_name_);
+  validateIpv6Supported(*this);
 }
 
 Ipv6Instance::Ipv6Instance(uint32_t port, const SocketInterface* sock_interface)
     : Ipv6Instance("", port, sockInterfaceOrDefault(sock_interface)) {}
 
+void Ipv6Instance::IpHelper::format() const {
+  // Format from the network address, in case the address was given in a non-canonical format.
+  friendly_address_ = ipv6_.makeFriendlyAddress();
+  friendly_name_ = fmt::format("[{}]:{}", friendly_address_, port());
+}
+
 bool Ipv6Instance::operator==(const Instance& rhs) const {
   const auto* rhs_casted = dynamic_cast<const Ipv6Instance*>(&rhs);
   return (rhs_casted && (ip_.ipv6_.address() == rhs_casted->ip_.ipv6_.address()) &&
@@ -311,6 +319,39 @@ bool EnvoyInternalInstance::operator==(const Instance& rhs) const {
   return rhs.type() == Type::EnvoyInternal && asString() == rhs.asString();
 }
 
+InstanceCache::InstanceCache(uint32_t size) : entries_(roundUpToPowerOfTwo(size)),
+                                              mask_(entries_.size() - 1) {}
+
+InstanceConstSharedPtr InstanceCache::get(const sockaddr_storage& ss, socklen_t len, bool v6only) {
+  socklen_t key_len;
+  switch (ss.ss_family) {
+  case AF_INET:
+    key_len = sizeof(sockaddr_in);
+    break;
+  case AF_INET6:
+    key_len = sizeof(sockaddr_in6);
+    break;
+  default:
+    return addressFromSockAddr(ss, len, v6only);
+  }
+  // Leave the validation of the length to addressFromSockAddr() on a miss.
+  if (len != 0 && len != key_len) {
+    return addressFromSockAddr(ss, len, v6only);
+  }
+
+  const absl::string_view key(reinterpret_cast<const char*>(&ss), key_len);
+  Entry& entry = entries_[(HashUtil::xxHash64(key) + v6only) & mask_];
+  if (entry.address_ != nullptr && entry.key_len_ == key_len && entry.v6only_ == v6only &&
+      memcmp(entry.key_.data(), key.data(), key_len) == 0) {
+    return entry.address_;
+  }
+  entry.address_ = addressFromSockAddr(ss, len, v6only);
+  memcpy(entry.key_.data(), key.data(), key_len);
+  entry.key_len_ = key_len;
+  entry.v6only_ = v6only;
+  return entry.address_;
+}
+
 } // namespace Address
 } // namespace Network
 } // namespace Envoy
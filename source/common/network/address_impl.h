@@ -5,6 +5,7 @@
 #include <array>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "envoy/common/platform.h"
 #include "envoy/network/address.h"
@@ -12,6 +13,8 @@
 
 #include "common/common/assert.h"
 
+#include "absl/base/call_once.h"
+
 namespace Envoy {
 namespace Network {
 namespace Address {
@@ -83,6 +86,8 @@ public:
   explicit Ipv4Instance(uint32_t port, const SocketInterface* sock_interface = nullptr);
 
   // Network::Address::Instance
+  const std::string& asString() const override { return ip_.friendlyName(); }
+  absl::string_view asStringView() const override { return ip_.friendlyName(); }
   bool operator==(const Instance& rhs) const override;
   const Ip* ip() const override { return &ip_; }
   const Pipe* pipe() const override { return nullptr; }
@@ -107,8 +112,13 @@ private:
     sockaddr_in address_;
   };
 
+  // The names of an address made from a socket address, e.g. of an accepted connection, are only
+  // formatted when first asked for, as many connections never log or forward their addresses.
   struct IpHelper : public Ip {
-    const std::string& addressAsString() const override { return friendly_address_; }
+    const std::string& addressAsString() const override {
+      absl::call_once(formatted_, &IpHelper::format, this);
+      return friendly_address_;
+    }
     bool isAnyAddress() const override { return ipv4_.address_.sin_addr.s_addr == INADDR_ANY; }
     bool isUnicastAddress() const override {
       return !isAnyAddress() && (ipv4_.address_.sin_addr.s_addr != INADDR_BROADCAST) &&
@@ -120,8 +130,16 @@ private:
     uint32_t port() const override { return ntohs(ipv4_.address_.sin_port); }
     IpVersion version() const override { return IpVersion::v4; }
 
+    const std::string& friendlyName() const {
+      absl::call_once(formatted_, &IpHelper::format, this);
+      return friendly_name_;
+    }
+    void format() const;
+
     Ipv4Helper ipv4_;
-    std::string friendly_address_;
+    mutable absl::once_flag formatted_;
+    mutable std::string friendly_address_;
+    mutable std::string friendly_name_;
   };
 
   IpHelper ip_;
@@ -157,6 +175,8 @@ public:
   explicit Ipv6Instance(uint32_t port, const SocketInterface* sock_interface = nullptr);
 
   // Network::Address::Instance
+  const std::string& asString() const override { return ip_.friendlyName(); }
+  absl::string_view asStringView() const override { return ip_.friendlyName(); }
   bool operator==(const Instance& rhs) const override;
   const Ip* ip() const override { return &ip_; }
   const Pipe* pipe() const override { return nullptr; }
@@ -182,8 +202,12 @@ private:
     bool v6only_{true};
   };
 
+  // The names are formatted when first asked for, as for IPv4.
   struct IpHelper : public Ip {
-    const std::string& addressAsString() const override { return friendly_address_; }
+    const std::string& addressAsString() const override {
+      absl::call_once(formatted_, &IpHelper::format, this);
+      return friendly_address_;
+    }
     bool isAnyAddress() const override {
       return 0 == memcmp(&ipv6_.address_.sin6_addr, &in6addr_any, sizeof(struct in6_addr));
     }
@@ -195,8 +219,16 @@ private:
     uint32_t port() const override { return ipv6_.port(); }
     IpVersion version() const override { return IpVersion::v6; }
 
+    const std::string& friendlyName() const {
+      absl::call_once(formatted_, &IpHelper::format, this);
+      return friendly_name_;
+    }
+    void format() const;
+
     Ipv6Helper ipv6_;
-    std::string friendly_address_;
+    mutable absl::once_flag formatted_;
+    mutable std::string friendly_address_;
+    mutable std::string friendly_name_;
   };
 
   IpHelper ip_;
@@ -277,6 +309,41 @@ private:
   EnvoyInternalAddressImpl internal_address_;
 };
 
+/**
+ * A cache of the IP addresses made from socket addresses, owned by a single thread, so that the
+ * connections of a worker from the same peers, or to the same local addresses, share the address
+ * objects instead of each allocating and formatting their own. The cache is direct mapped: a
+ * socket address only goes in the slot selected by its hash, which is overwritten on a miss, so
+ * that a lookup is a hash and a compare and the cache never grows.
+ */
+class InstanceCache {
+public:
+  /**
+   * @param size supplies the number of addresses the cache holds, rounded up to a power of 2.
+   */
+  explicit InstanceCache(uint32_t size);
+
+  /**
+   * Same as addressFromSockAddr(), but returns the address of the previous lookup of the same
+   * socket address while it is in the cache. The addresses which are not IP addresses are not
+   * cached.
+   */
+  InstanceConstSharedPtr get(const sockaddr_storage& ss, socklen_t len, bool v6only = true);
+
+private:
+  struct Entry {
+    // The socket address the address was made from, which is not the socket address of the
+    // address for an IPv4-mapped IPv6 address made with v6only false.
+    std::array<uint8_t, sizeof(sockaddr_in6)> key_;
+    socklen_t key_len_{};
+    bool v6only_{};
+    InstanceConstSharedPtr address_;
+  };
+
+  std::vector<Entry> entries_;
+  const size_t mask_;
+};
+
 } // namespace Address
 } // namespace Network
 } // namespace Envoy
@@ -0,0 +1,159 @@
+#include "common/network/caching_dns_resolver.h"
+
+#include <algorithm>
+
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Network {
+
+SINGLETON_MANAGER_REGISTRATION(caching_dns_resolver);
+
+CachingDnsResolver::CachingDnsResolver(
+    DnsResolverSharedPtr resolver, TimeSource& time_source, Stats::Scope& scope,
+    const envoy::config::bootstrap::v3::Bootstrap::DnsResolutionCache& config)
+    : resolver_(std::move(resolver)), time_source_(time_source),
+      stats_{ALL_CACHING_DNS_RESOLVER_STATS(POOL_COUNTER_PREFIX(scope, "dns_cache."),
+                                            POOL_GAUGE_PREFIX(scope, "dns_cache."))},
+      max_ttl_(PROTOBUF_GET_MS_OR_DEFAULT(config, max_ttl, 300000)),
+      negative_ttl_(PROTOBUF_GET_MS_OR_DEFAULT(config, negative_ttl, 5000)),
+      max_stale_(PROTOBUF_GET_MS_OR_DEFAULT(config, max_stale, 300000)) {}
+
+CachingDnsResolverSharedPtr CachingDnsResolver::create(
+    Singleton::Manager& singleton_manager, DnsResolverSharedPtr resolver, TimeSource& time_source,
+    Stats::Scope& scope, const envoy::config::bootstrap::v3::Bootstrap::DnsResolutionCache& config) {
+  return singleton_manager.getTyped<CachingDnsResolver>(
+      SINGLETON_MANAGER_REGISTERED_NAME(caching_dns_resolver), [&] {
+        return std::make_shared<CachingDnsResolver>(std::move(resolver), time_source, scope,
+                                                    config);
+      });
+}
+
+CachingDnsResolverSharedPtr CachingDnsResolver::get(Singleton::Manager& singleton_manager) {
+  return singleton_manager.getTyped<CachingDnsResolver>(
+      SINGLETON_MANAGER_REGISTERED_NAME(caching_dns_resolver), [] { return nullptr; });
+}
+
+CachingDnsResolver::~CachingDnsResolver() {
+  for (auto& entry : entries_) {
+    if (entry.second->active_query_ != nullptr) {
+      entry.second->active_query_->cancel();
+    }
+  }
+  stats_.num_entries_.set(0);
+}
+
+ActiveDnsQuery* CachingDnsResolver::resolve(const std::string& dns_name,
+                                            DnsLookupFamily dns_lookup_family,
+                                            ResolveCb callback) {
+  const MonotonicTime now = time_source_.monotonicTime();
+  auto& entry_ptr = entries_[Key(dns_name, dns_lookup_family)];
+  if (entry_ptr == nullptr) {
+    entry_ptr = std::make_unique<Entry>(dns_name, dns_lookup_family);
+    stats_.num_entries_.set(entries_.size());
+  }
+  Entry& entry = *entry_ptr;
+
+  if (entry.fresh(now)) {
+    stats_.cache_hit_.inc();
+    // Refresh a resolution in use before it expires, so that its users do not wait for it.
+    if (!entry.resolving_ && entry.expiry_time_ - now < entry.ttl_ / 10) {
+      stats_.prefetch_.inc();
+      startResolution(entry);
+    }
+    std::list<DnsResponse> response(entry.response_);
+    callback(entry.status_, std::move(response));
+    sweepEntries(now);
+    return nullptr;
+  }
+
+  stats_.cache_miss_.inc();
+  auto pending_query = std::make_unique<PendingQuery>(entry, std::move(callback));
+  PendingQuery* query = pending_query.get();
+  pending_query->moveIntoList(std::move(pending_query), entry.pending_queries_);
+  if (!entry.resolving_) {
+    startResolution(entry);
+  }
+  // The resolution of the query may have completed inline, which deleted the query.
+  const bool pending = std::any_of(entry.pending_queries_.begin(), entry.pending_queries_.end(),
+                                   [query](const PendingQueryPtr& other) {
+                                     return other.get() == query;
+                                   });
+  sweepEntries(now);
+  return pending ? query : nullptr;
+}
+
+void CachingDnsResolver::startResolution(Entry& entry) {
+  ASSERT(!entry.resolving_);
+  entry.resolving_ = true;
+  ActiveDnsQuery* active_query = resolver_->resolve(
+      entry.dns_name_, entry.dns_lookup_family_,
+      [this, &entry](ResolutionStatus status, std::list<DnsResponse>&& response) {
+        onResolution(entry, status, std::move(response));
+      });
+  // A resolution that completed inline has already been delivered.
+  if (entry.resolving_) {
+    entry.active_query_ = active_query;
+  }
+}
+
+void CachingDnsResolver::onResolution(Entry& entry, ResolutionStatus status,
+                                      std::list<DnsResponse>&& response) {
+  const MonotonicTime now = time_source_.monotonicTime();
+  entry.resolving_ = false;
+  entry.active_query_ = nullptr;
+
+  if (status == ResolutionStatus::Success && !response.empty()) {
+    std::chrono::milliseconds ttl = max_ttl_;
+    for (const auto& record : response) {
+      ttl = std::min<std::chrono::milliseconds>(ttl, record.ttl_);
+    }
+    entry.status_ = status;
+    entry.response_ = std::move(response);
+    entry.ttl_ = ttl;
+    entry.expiry_time_ = now + ttl;
+    entry.stale_time_ = entry.expiry_time_ + max_stale_;
+  } else if (entry.resolved_ && !entry.response_.empty() && now < entry.stale_time_) {
+    ENVOY_LOG(debug, "failed to resolve {}, serving the stale resolution", entry.dns_name_);
+    stats_.stale_response_.inc();
+    entry.ttl_ = negative_ttl_;
+    entry.expiry_time_ = now + negative_ttl_;
+  } else {
+    entry.status_ = status;
+    entry.response_ = std::move(response);
+    entry.ttl_ = negative_ttl_;
+    entry.expiry_time_ = now + negative_ttl_;
+  }
+  entry.resolved_ = true;
+
+  // The callbacks may resolve names, which may sweep this entry, so the queries to complete are
+  // moved out of it first.
+  std::list<PendingQueryPtr> pending_queries;
+  pending_queries.swap(entry.pending_queries_);
+  const ResolutionStatus resolved_status = entry.status_;
+  const std::list<DnsResponse> resolved_response = entry.response_;
+  for (const auto& query : pending_queries) {
+    std::list<DnsResponse> copy(resolved_response);
+    query->callback_(resolved_status, std::move(copy));
+  }
+}
+
+void CachingDnsResolver::sweepEntries(MonotonicTime now) {
+  if (entries_.size() < 2 * std::max<size_t>(swept_size_, 64)) {
+    return;
+  }
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    const Entry& entry = *it->second;
+    const bool servable = entry.fresh(now) || (!entry.response_.empty() && now < entry.stale_time_);
+    if (!entry.resolving_ && entry.pending_queries_.empty() && !servable) {
+      entries_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  swept_size_ = entries_.size();
+  stats_.num_entries_.set(entries_.size());
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+#include "envoy/network/dns.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/singleton/manager.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/common/linked_object.h"
+#include "common/common/logger.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * All DNS resolution cache stats. @see stats_macros.h
+ */
+#define ALL_CACHING_DNS_RESOLVER_STATS(COUNTER, GAUGE)                                            \
+  COUNTER(cache_hit)                                                                               \
+  COUNTER(cache_miss)                                                                              \
+  COUNTER(prefetch)                                                                                \
+  COUNTER(stale_response)                                                                          \
+  GAUGE(num_entries, NeverImport)
+
+/**
+ * Struct definition for all DNS resolution cache stats. @see stats_macros.h
+ */
+struct CachingDnsResolverStats {
+  ALL_CACHING_DNS_RESOLVER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * A DNS resolver that caches the resolutions of another resolver, so that the users of a resolver
+ * that resolve the same names share the resolutions:
+ * - A successful resolution is cached for the lowest TTL of its records, up to max_ttl.
+ * - A failed resolution, or one without records, is cached for negative_ttl.
+ * - Concurrent resolutions of a name wait for a single query.
+ * - A resolution that is used in the last tenth of its TTL is refreshed in the background.
+ * - If resolving a name fails within max_stale of the expiry of its last successful resolution,
+ *   that resolution is served instead, and the name is resolved again after negative_ttl.
+ * Cached resolutions are delivered inline, which the DnsResolver interface allows. As the
+ * underlying resolver, all calls and callbacks happen on the thread of the dispatcher of the
+ * underlying resolver.
+ */
+class CachingDnsResolver : public DnsResolver,
+                           public Singleton::Instance,
+                           Logger::Loggable<Logger::Id::upstream> {
+public:
+  CachingDnsResolver(DnsResolverSharedPtr resolver, TimeSource& time_source, Stats::Scope& scope,
+                     const envoy::config::bootstrap::v3::Bootstrap::DnsResolutionCache& config);
+  ~CachingDnsResolver() override;
+
+  /**
+   * Creates the DNS resolution cache of the server, which get() returns while the server holds it.
+   * @param singleton_manager the singleton manager of the server.
+   * @param resolver the resolver of the names that are not cached.
+   * @return the cache.
+   */
+  static std::shared_ptr<CachingDnsResolver>
+  create(Singleton::Manager& singleton_manager, DnsResolverSharedPtr resolver,
+         TimeSource& time_source, Stats::Scope& scope,
+         const envoy::config::bootstrap::v3::Bootstrap::DnsResolutionCache& config);
+
+  /**
+   * @param singleton_manager the singleton manager of the server.
+   * @return the DNS resolution cache of the server, or nullptr if it has none.
+   */
+  static std::shared_ptr<CachingDnsResolver> get(Singleton::Manager& singleton_manager);
+
+  // Network::DnsResolver
+  ActiveDnsQuery* resolve(const std::string& dns_name, DnsLookupFamily dns_lookup_family,
+                          ResolveCb callback) override;
+
+private:
+  struct Entry;
+
+  struct PendingQuery : public ActiveDnsQuery, public LinkedObject<PendingQuery> {
+    PendingQuery(Entry& entry, ResolveCb callback)
+        : entry_(entry), callback_(std::move(callback)) {}
+
+    // Network::ActiveDnsQuery
+    void cancel() override { removeFromList(entry_.pending_queries_); }
+
+    Entry& entry_;
+    const ResolveCb callback_;
+  };
+  using PendingQueryPtr = std::unique_ptr<PendingQuery>;
+
+  struct Entry {
+    Entry(const std::string& dns_name, DnsLookupFamily dns_lookup_family)
+        : dns_name_(dns_name), dns_lookup_family_(dns_lookup_family) {}
+
+    bool fresh(MonotonicTime now) const { return resolved_ && now < expiry_time_; }
+
+    const std::string dns_name_;
+    const DnsLookupFamily dns_lookup_family_;
+    // The cached resolution, valid if resolved_.
+    bool resolved_{};
+    ResolutionStatus status_{ResolutionStatus::Failure};
+    std::list<DnsResponse> response_;
+    std::chrono::milliseconds ttl_{};
+    MonotonicTime expiry_time_;
+    // The time until which response_ is served if resolving the name fails, if it has records.
+    MonotonicTime stale_time_;
+    // The query of the underlying resolver, valid if resolving_.
+    bool resolving_{};
+    ActiveDnsQuery* active_query_{};
+    std::list<PendingQueryPtr> pending_queries_;
+  };
+  using EntryPtr = std::unique_ptr<Entry>;
+  using Key = std::pair<std::string, DnsLookupFamily>;
+
+  void startResolution(Entry& entry);
+  void onResolution(Entry& entry, ResolutionStatus status, std::list<DnsResponse>&& response);
+  // Erases the entries that are neither resolving nor servable, once the number of entries has
+  // doubled since the last sweep, so that names which are no longer resolved do not accumulate.
+  void sweepEntries(MonotonicTime now);
+
+  const DnsResolverSharedPtr resolver_;
+  TimeSource& time_source_;
+  CachingDnsResolverStats stats_;
+  const std::chrono::milliseconds max_ttl_;
+  const std::chrono::milliseconds negative_ttl_;
+  const std::chrono::milliseconds max_stale_;
+  absl::flat_hash_map<Key, EntryPtr> entries_;
+  size_t swept_size_{};
+};
+
+using CachingDnsResolverSharedPtr = std::shared_ptr<CachingDnsResolver>;
+
+} // namespace Network
+} // namespace Envoy
@@ -34,5 +34,35 @@ ExactConnectionBalancerImpl::pickTargetHandler(BalancedConnectionHandler&) {
   return *min_connection_handler;
 }
 
+void TwoChoiceConnectionBalancerImpl::registerHandler(BalancedConnectionHandler& handler) {
+  absl::MutexLock lock(&lock_);
+  handlers_.push_back(&handler);
+}
+
+void TwoChoiceConnectionBalancerImpl::unregisterHandler(BalancedConnectionHandler& handler) {
+  absl::MutexLock lock(&lock_);
+  handlers_.erase(std::find(handlers_.begin(), handlers_.end(), &handler));
+}
+
+BalancedConnectionHandler&
+TwoChoiceConnectionBalancerImpl::pickTargetHandler(BalancedConnectionHandler& current_handler) {
+  BalancedConnectionHandler* target_handler = &current_handler;
+  {
+    // The reader lock only keeps the handlers from being unregistered while one is picked.
+    absl::ReaderMutexLock lock(&lock_);
+    if (handlers_.size() > 1) {
+      BalancedConnectionHandler* other_handler = handlers_[random_.random() % handlers_.size()];
+      // Ties keep the connection on the current handler, which saves a cross-thread post.
+      if (other_handler->numConnections() < current_handler.numConnections()) {
+        target_handler = other_handler;
+      }
+    }
+
+    target_handler->incNumConnections();
+  }
+
+  return *target_handler;
+}
+
 } // namespace Network
 } // namespace Envoy
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "envoy/common/random_generator.h"
 #include "envoy/network/connection_balancer.h"
 
 #include "absl/synchronization/mutex.h"
@@ -27,6 +28,28 @@ private:
   std::vector<BalancedConnectionHandler*> handlers_ ABSL_GUARDED_BY(lock_);
 };
 
+/**
+ * Implementation of connection balancer that compares the number of connections of the current
+ * handler with those of another handler picked at random, and moves the connection to the other
+ * handler when it has fewer connections. This is the "power of two choices", which keeps the
+ * connection counts of the handlers close without comparing all of them. Picks only share a reader
+ * lock on the handlers, so that accepts on different handlers do not wait on each other.
+ */
+class TwoChoiceConnectionBalancerImpl : public ConnectionBalancer {
+public:
+  explicit TwoChoiceConnectionBalancerImpl(Random::RandomGenerator& random) : random_(random) {}
+
+  // ConnectionBalancer
+  void registerHandler(BalancedConnectionHandler& handler) override;
+  void unregisterHandler(BalancedConnectionHandler& handler) override;
+  BalancedConnectionHandler& pickTargetHandler(BalancedConnectionHandler& current_handler) override;
+
+private:
+  Random::RandomGenerator& random_;
+  absl::Mutex lock_;
+  std::vector<BalancedConnectionHandler*> handlers_ ABSL_GUARDED_BY(lock_);
+};
+
 /**
  * A NOP connection balancer implementation that always continues execution after incrementing
  * the handler's connection count.
@@ -26,6 +26,9 @@ namespace {
 constexpr absl::string_view kTransportSocketConnectTimeoutTerminationDetails =
     "transport socket timeout was reached";
 
+// Upper bound on the bytes spliced in a single read event before yielding to other connections.
+constexpr uint64_t MaxSplicedBytesPerReadEvent = 1024 * 1024;
+
 }
 
 void ConnectionImplUtility::updateBufferStats(uint64_t delta, uint64_t new_total,
@@ -225,6 +228,7 @@ void ConnectionImpl::closeSocket(ConnectionEvent close_type) {
   }
 
   ENVOY_CONN_LOG(debug, "closing socket: {}", *this, static_cast<uint32_t>(close_type));
+  disableSplicing();
   transport_socket_->closeSocket(close_type);
 
   // Drain input and output buffers.
@@ -594,7 +598,12 @@ void ConnectionImpl::onReadReady() {
   // reading from the transport if the read buffer is above high watermark at the start of the
   // method.
   transport_wants_read_ = false;
-  IoResult result = transport_socket_->doRead(*read_buffer_);
+  const bool splicing = canSpliceToPeer();
+  IoResult result = splicing ? spliceToPeer() : transport_socket_->doRead(*read_buffer_);
+  if (splicing && !ioHandle().isOpen()) {
+    // A bytes sent callback of the peer closed this connection.
+    return;
+  }
   uint64_t new_buffer_size = read_buffer_->length();
   updateReadBufferStats(result.bytes_processed_, new_buffer_size);
 
@@ -695,23 +704,128 @@ void ConnectionImpl::onWriteReady() {
       delayed_close_timer_->enableTimer(delayed_close_timeout_);
     }
     if (result.bytes_processed_ > 0) {
-      auto it = bytes_sent_callbacks_.begin();
-      while (it != bytes_sent_callbacks_.end()) {
-        if ((*it)(result.bytes_processed_)) {
-          // move to the next callback.
-          it++;
-        } else {
-          // remove the current callback.
-          it = bytes_sent_callbacks_.erase(it);
-        }
-
-        // If a callback closes the socket, stop iterating.
-        if (!ioHandle().isOpen()) {
-          return;
-        }
+      runBytesSentCallbacks(result.bytes_processed_);
+    }
+  }
+}
+
+void ConnectionImpl::runBytesSentCallbacks(uint64_t bytes_sent) {
+  auto it = bytes_sent_callbacks_.begin();
+  while (it != bytes_sent_callbacks_.end()) {
+    if ((*it)(bytes_sent)) {
+      // move to the next callback.
+      it++;
+    } else {
+      // remove the current callback.
+      it = bytes_sent_callbacks_.erase(it);
+    }
+
+    // If a callback closes the socket, stop iterating.
+    if (!ioHandle().isOpen()) {
+      return;
+    }
+  }
+}
+
+bool ConnectionImpl::enableSplicing(Connection& peer) {
+  auto* peer_impl = dynamic_cast<ConnectionImpl*>(&peer);
+  if (peer_impl == nullptr || peer_impl == this || &peer_impl->dispatcher_ != &dispatcher_ ||
+      splice_peer_ != nullptr || peer_impl->splice_peer_ != nullptr ||
+      !transport_socket_->canSplice() || !peer_impl->transport_socket_->canSplice()) {
+    return false;
+  }
+  SplicePipePtr pipe = SplicePipe::create();
+  SplicePipePtr peer_pipe = pipe != nullptr ? SplicePipe::create() : nullptr;
+  if (peer_pipe == nullptr) {
+    return false;
+  }
+
+  ENVOY_CONN_LOG(debug, "splicing with connection {}", *this, peer_impl->id());
+  splice_peer_ = peer_impl;
+  splice_pipe_ = std::move(pipe);
+  peer_impl->splice_peer_ = this;
+  peer_impl->splice_pipe_ = std::move(peer_pipe);
+  return true;
+}
+
+void ConnectionImpl::disableSplicing() {
+  if (splice_peer_ == nullptr) {
+    return;
+  }
+  // Pipes are always emptied before control returns to the event loop.
+  ASSERT(splice_pipe_->length() == 0 && splice_peer_->splice_pipe_->length() == 0);
+  splice_peer_->splice_peer_ = nullptr;
+  splice_peer_->splice_pipe_.reset();
+  splice_peer_ = nullptr;
+  splice_pipe_.reset();
+}
+
+bool ConnectionImpl::canSpliceToPeer() const {
+  // Data already in the read buffer must be delivered first, and only the single read filter may
+  // be skipped.
+  return splice_peer_ != nullptr && read_buffer_->length() == 0 &&
+         transport_socket_->canSplice() && filter_manager_.hasSingleReadFilter() &&
+         splice_peer_->canAcceptSplicedData();
+}
+
+bool ConnectionImpl::canAcceptSplicedData() const {
+  return state() == State::Open && !connecting_ && !inDelayedClose() && !write_end_stream_ &&
+         write_buffer_->length() == 0 && transport_socket_->canSplice() &&
+         !filter_manager_.hasWriteFilters();
+}
+
+IoResult ConnectionImpl::spliceToPeer() {
+  uint64_t bytes_read = 0;
+  while (canSpliceToPeer()) {
+    if (bytes_read >= MaxSplicedBytesPerReadEvent) {
+      setTransportSocketIsReadable();
+      return {PostIoAction::KeepOpen, bytes_read, false};
+    }
+    const Api::SysCallSizeResult filled = splice_pipe_->fill(ioHandle().fdDoNotUse());
+    if (filled.rc_ < 0) {
+      if (filled.errno_ == SOCKET_ERROR_INTR) {
+        continue;
+      }
+      if (filled.errno_ == SOCKET_ERROR_AGAIN) {
+        return {PostIoAction::KeepOpen, bytes_read, false};
+      }
+      ENVOY_CONN_LOG(trace, "splice read error: {}", *this, filled.errno_);
+      return {PostIoAction::Close, bytes_read, false};
+    }
+    if (filled.rc_ == 0) {
+      // End of stream; let the transport socket observe it.
+      break;
+    }
+    bytes_read += filled.rc_;
+
+    const Api::SysCallSizeResult drained =
+        splice_pipe_->drain(splice_peer_->ioHandle().fdDoNotUse());
+    const uint64_t bytes_spliced = drained.rc_ > 0 ? drained.rc_ : 0;
+    if (splice_pipe_->length() > 0) {
+      // The peer cannot take more data right now, or failed. The remainder goes through the
+      // filter chain into the peer's write buffer, which flow controls this connection as usual.
+      splice_pipe_->moveTo(*read_buffer_);
+    }
+    if (bytes_spliced > 0) {
+      ENVOY_CONN_LOG(trace, "spliced {} bytes to connection {}", *this, bytes_spliced,
+                     splice_peer_->id());
+      stream_info_.addBytesReceived(bytes_spliced);
+      splice_peer_->onSplicedWrite(bytes_spliced);
+      if (!ioHandle().isOpen()) {
+        return {PostIoAction::KeepOpen, bytes_read, false};
       }
     }
   }
+
+  IoResult result = transport_socket_->doRead(*read_buffer_);
+  result.bytes_processed_ += bytes_read;
+  return result;
+}
+
+void ConnectionImpl::onSplicedWrite(uint64_t bytes_written) {
+  stream_info_.addBytesSent(bytes_written);
+  updateWriteBufferStats(bytes_written, write_buffer_->length());
+  runBytesSentCallbacks(bytes_written);
 }
 
 void ConnectionImpl::updateReadBufferStats(uint64_t num_read, uint64_t new_size) {
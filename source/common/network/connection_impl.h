@@ -11,6 +11,7 @@
 #include "common/buffer/watermark_buffer.h"
 #include "common/event/libevent.h"
 #include "common/network/connection_impl_base.h"
+#include "common/network/splice_pipe.h"
 #include "common/stream_info/stream_info_impl.h"
 
 #include "absl/types/optional.h"
@@ -95,6 +96,7 @@ public:
   absl::string_view transportFailureReason() const override;
   bool startSecureTransport() override { return transport_socket_->startSecureTransport(); }
   absl::optional<std::chrono::milliseconds> lastRoundTripTime() const override;
+  bool enableSplicing(Connection& peer) override;
 
   // Network::FilterManagerConnection
   void rawWrite(Buffer::Instance& data, bool end_stream) override;
@@ -182,9 +184,27 @@ private:
   // Returns true iff end of stream has been both written and read.
   bool bothSidesHalfClosed();
 
+  void runBytesSentCallbacks(uint64_t bytes_sent);
+
+  // Returns true if data read from the socket may currently be spliced to splice_peer_.
+  bool canSpliceToPeer() const;
+  // Returns true if data may currently be spliced into the socket, bypassing the write buffer.
+  bool canAcceptSplicedData() const;
+  // Reads from the socket like the transport socket's doRead(), moving as much data as possible
+  // to splice_peer_ in the kernel. Data the peer cannot accept is appended to the read buffer.
+  IoResult spliceToPeer();
+  // Accounts for data written to the socket by splice_peer_.
+  void onSplicedWrite(uint64_t bytes_written);
+  void disableSplicing();
+
   static std::atomic<uint64_t> next_global_id_;
 
   std::list<BytesSentCb> bytes_sent_callbacks_;
+  // The connection this one splices data with, and the pipe used for data read from this
+  // connection. Set in both connections by enableSplicing() and cleared in both when either one
+  // closes.
+  ConnectionImpl* splice_peer_{};
+  SplicePipePtr splice_pipe_;
   // Tracks the number of times reads have been disabled. If N different components call
   // readDisabled(true) this allows the connection to only resume reads when readDisabled(false)
   // has been called N times.
@@ -0,0 +1,153 @@
+#include "common/network/cpu_steering_socket_option_impl.h"
+
+#include "common/common/lock_guard.h"
+#include "common/common/macros.h"
+#include "common/common/utility.h"
+
+#if defined(__linux__)
+#include <linux/bpf.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <sys/sysinfo.h>
+#include <unistd.h>
+#endif
+
+namespace Envoy {
+namespace Network {
+
+#if defined(__linux__)
+namespace {
+
+// The values of the kernel ABI introduced in Linux 4.19, which older kernel headers lack.
+constexpr uint32_t BpfMapTypeReuseportSockarray = 20;
+constexpr uint32_t BpfProgTypeSkReuseport = 21;
+constexpr int32_t BpfFuncGetSmpProcessorId = 8;
+constexpr int32_t BpfFuncSkSelectReuseport = 82;
+constexpr int32_t SkPass = 1;
+#ifdef SO_ATTACH_REUSEPORT_EBPF
+constexpr int SoAttachReuseportEbpf = SO_ATTACH_REUSEPORT_EBPF;
+#else
+constexpr int SoAttachReuseportEbpf = 52;
+#endif
+
+int bpf(int cmd, bpf_attr& attr) { return ::syscall(__NR_bpf, cmd, &attr, sizeof(attr)); }
+
+bpf_insn insn(uint8_t code, uint8_t dst_reg, uint8_t src_reg, int16_t off, int32_t imm) {
+  bpf_insn insn{};
+  insn.code = code;
+  insn.dst_reg = dst_reg;
+  insn.src_reg = src_reg;
+  insn.off = off;
+  insn.imm = imm;
+  return insn;
+}
+
+} // namespace
+#endif
+
+CpuSteeringSocketOptionImpl::~CpuSteeringSocketOptionImpl() {
+#if defined(__linux__)
+  // The program stays attached to the group of the sockets, and keeps the socket array alive.
+  Thread::LockGuard lock(lock_);
+  if (prog_fd_ >= 0) {
+    ::close(prog_fd_);
+  }
+  if (map_fd_ >= 0) {
+    ::close(map_fd_);
+  }
+#endif
+}
+
+bool CpuSteeringSocketOptionImpl::setOption(
+    Socket& socket, envoy::config::core::v3::SocketOption::SocketState state) const {
+  if (state != envoy::config::core::v3::SocketOption::STATE_LISTENING) {
+    return true;
+  }
+#if defined(__linux__)
+  // The worker threads are pinned, so the CPU the option is applied on is the CPU of the worker.
+  const int cpu = ::sched_getcpu();
+  Thread::LockGuard lock(lock_);
+  if (cpu < 0 || !loadProgram()) {
+    return true;
+  }
+
+  uint32_t key = cpu;
+  uint32_t fd = socket.ioHandle().fdDoNotUse();
+  bpf_attr attr{};
+  attr.map_fd = map_fd_;
+  attr.key = reinterpret_cast<uint64_t>(&key);
+  attr.value = reinterpret_cast<uint64_t>(&fd);
+  attr.flags = BPF_ANY;
+  if (bpf(BPF_MAP_UPDATE_ELEM, attr) != 0) {
+    ENVOY_LOG(warn, "Registering listen socket for CPU {} failed: {}", cpu, errorDetails(errno));
+    return true;
+  }
+  const Api::SysCallIntResult result =
+      socket.setSocketOption(SOL_SOCKET, SoAttachReuseportEbpf, &prog_fd_, sizeof(prog_fd_));
+  if (result.rc_ != 0) {
+    ENVOY_LOG(warn, "Attaching reuse port steering program failed: {}",
+              errorDetails(result.errno_));
+  }
+#else
+  UNREFERENCED_PARAMETER(socket);
+  ENVOY_LOG(warn, "Steering connections to the CPUs of the workers is only supported on Linux");
+#endif
+  return true;
+}
+
+bool CpuSteeringSocketOptionImpl::loadProgram() const {
+#if defined(__linux__)
+  if (prog_fd_ >= 0 || load_failed_) {
+    return prog_fd_ >= 0;
+  }
+  load_failed_ = true;
+
+  bpf_attr map_attr{};
+  map_attr.map_type = BpfMapTypeReuseportSockarray;
+  map_attr.key_size = sizeof(uint32_t);
+  map_attr.value_size = sizeof(uint32_t);
+  map_attr.max_entries = ::get_nprocs_conf();
+  map_fd_ = bpf(BPF_MAP_CREATE, map_attr);
+  if (map_fd_ < 0) {
+    ENVOY_LOG(warn, "Creating reuse port socket array failed: {}", errorDetails(errno));
+    return false;
+  }
+
+  // key = bpf_get_smp_processor_id();
+  // bpf_sk_select_reuseport(ctx, map, &key, 0);
+  // return SK_PASS;
+  // When no socket is registered for the CPU, the kernel selects a socket by hash.
+  const bpf_insn program[] = {
+      insn(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_6, BPF_REG_1, 0, 0),
+      insn(BPF_JMP | BPF_CALL, 0, 0, 0, BpfFuncGetSmpProcessorId),
+      insn(BPF_STX | BPF_MEM | BPF_W, BPF_REG_10, BPF_REG_0, -4, 0),
+      insn(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_1, BPF_REG_6, 0, 0),
+      insn(BPF_LD | BPF_DW | BPF_IMM, BPF_REG_2, BPF_PSEUDO_MAP_FD, 0, map_fd_),
+      insn(0, 0, 0, 0, 0),
+      insn(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_3, BPF_REG_10, 0, 0),
+      insn(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_3, 0, 0, -4),
+      insn(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_4, 0, 0, 0),
+      insn(BPF_JMP | BPF_CALL, 0, 0, 0, BpfFuncSkSelectReuseport),
+      insn(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0, 0, 0, SkPass),
+      insn(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+  };
+  static const char license[] = "Apache-2.0";
+  bpf_attr prog_attr{};
+  prog_attr.prog_type = BpfProgTypeSkReuseport;
+  prog_attr.insn_cnt = sizeof(program) / sizeof(program[0]);
+  prog_attr.insns = reinterpret_cast<uint64_t>(program);
+  prog_attr.license = reinterpret_cast<uint64_t>(license);
+  prog_fd_ = bpf(BPF_PROG_LOAD, prog_attr);
+  if (prog_fd_ < 0) {
+    ENVOY_LOG(warn, "Loading reuse port steering program failed: {}", errorDetails(errno));
+    return false;
+  }
+  load_failed_ = false;
+  return true;
+#else
+  return false;
+#endif
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "envoy/config/core/v3/base.pb.h"
+#include "envoy/network/listen_socket.h"
+
+#include "common/common/logger.h"
+#include "common/common/thread.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * A socket option that steers the connections received by a SO_REUSEPORT group of TCP listen
+ * sockets to the socket of the worker thread pinned on the CPU that received them, so that the
+ * softirq, the worker and the memory of each connection share a CPU. The option registers each
+ * socket, once it listens, for the CPU of the worker thread that applies it, and attaches an eBPF
+ * program selecting the socket registered for the current CPU to the group.
+ *
+ * Steering is best effort: it is only supported on Linux 4.19 and later, loading the program
+ * requires CAP_BPF or CAP_SYS_ADMIN, and the kernel keeps distributing the connections received
+ * on the CPUs without a registered socket by hash.
+ */
+class CpuSteeringSocketOptionImpl : public Socket::Option,
+                                    Logger::Loggable<Logger::Id::connection> {
+public:
+  ~CpuSteeringSocketOptionImpl() override;
+
+  // Socket::Option
+  bool setOption(Socket& socket,
+                 envoy::config::core::v3::SocketOption::SocketState state) const override;
+  void hashKey(std::vector<uint8_t>&) const override {}
+  absl::optional<Details>
+  getOptionDetails(const Socket&,
+                   envoy::config::core::v3::SocketOption::SocketState) const override {
+    return absl::nullopt;
+  }
+
+private:
+  // Creates the socket array and loads the program on first use.
+  bool loadProgram() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // The option is applied by all the workers of the listener.
+  mutable Thread::MutexBasicLockable lock_;
+  mutable int map_fd_ ABSL_GUARDED_BY(lock_){-1};
+  mutable int prog_fd_ ABSL_GUARDED_BY(lock_){-1};
+  mutable bool load_failed_ ABSL_GUARDED_BY(lock_){};
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -88,6 +88,19 @@ void FilterManagerImpl::onRead() {
   onContinueReading(nullptr, connection_);
 }
 
+bool FilterManagerImpl::hasSingleReadFilter() const {
+  uint32_t num_filters = 0;
+  for (const auto& filter : upstream_filters_) {
+    if (filter->filter_ == nullptr) {
+      continue;
+    }
+    if (!filter->initialized_ || ++num_filters > 1) {
+      return false;
+    }
+  }
+  return num_filters == 1;
+}
+
 FilterStatus FilterManagerImpl::onWrite() { return onWrite(nullptr, connection_); }
 
 FilterStatus FilterManagerImpl::onWrite(ActiveWriteFilter* filter,
@@ -110,6 +110,17 @@ public:
   void onRead();
   FilterStatus onWrite();
 
+  /**
+   * @return whether exactly one read filter is installed and it has been initialized, i.e. it is
+   *         the only filter that data read from the connection is delivered to.
+   */
+  bool hasSingleReadFilter() const;
+
+  /**
+   * @return whether any write filter is installed.
+   */
+  bool hasWriteFilters() const { return !downstream_filters_.empty(); }
+
 private:
   struct ActiveReadFilter : public ReadFilterCallbacks, LinkedObject<ActiveReadFilter> {
     ActiveReadFilter(FilterManagerImpl& parent, ReadFilterSharedPtr filter)
@@ -543,6 +543,14 @@ bool IoSocketHandleImpl::supportsUdpGro() const {
   return Api::OsSysCallsSingleton::get().supportsUdpGro();
 }
 
+bool IoSocketHandleImpl::supportsSplice() const {
+#if defined(__linux__)
+  return true;
+#else
+  return false;
+#endif
+}
+
 Api::SysCallIntResult IoSocketHandleImpl::bind(Address::InstanceConstSharedPtr address) {
   return Api::OsSysCallsSingleton::get().bind(fd_, address->sockAddr(), address->sockAddrLen());
 }
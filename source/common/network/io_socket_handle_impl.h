@@ -52,6 +52,7 @@ public:
 
   bool supportsMmsg() const override;
   bool supportsUdpGro() const override;
+  bool supportsSplice() const override;
 
   Api::SysCallIntResult bind(Address::InstanceConstSharedPtr address) override;
   Api::SysCallIntResult listen(int backlog) override;
@@ -2,6 +2,8 @@
 
 #include <algorithm>
 #include <climits>
+#include <iterator>
+#include <utility>
 #include <vector>
 
 #include "envoy/common/exception.h"
@@ -14,7 +16,7 @@
 #include "common/network/cidr_range.h"
 #include "common/network/utility.h"
 
-#include "absl/container/node_hash_set.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/numeric/int128.h"
 #include "fmt/format.h"
 
@@ -23,11 +25,10 @@ namespace Network {
 namespace LcTrie {
 
 /**
- * Maximum number of nodes an LC trie can hold.
- * @note If the size of LcTrieInternal::LcNode::address_ ever changes, this constant
- *       should be changed to match.
+ * Maximum number of nodes an LC trie can hold, which bounds its memory to 512MiB. The 32-bit
+ * LcTrieInternal::LcNode::address_ could address more nodes.
  */
-constexpr size_t MaxLcTrieNodes = (1 << 20);
+constexpr size_t MaxLcTrieNodes = (1 << 26);
 
 /**
  * Level Compressed Trie for associating data with CIDR ranges. Both IPv4 and IPv6 addresses are
@@ -58,11 +59,10 @@ public:
   LcTrie(const std::vector<std::pair<T, std::vector<Address::CidrRange>>>& data,
          bool exclusive = false, double fill_factor = 0.5, uint32_t root_branching_factor = 0) {
 
-    // The LcTrie implementation uses 20-bit "pointers" in its compact internal representation,
-    // so it cannot hold more than 2^20 nodes. But the number of nodes can be greater than the
-    // number of supported prefixes. Given N prefixes in the data input list, step 2 below can
-    // produce a new list of up to 2*N prefixes to insert in the LC trie. And the LC trie can
-    // use up to 2*N/fill_factor nodes.
+    // The LcTrie cannot hold more than MaxLcTrieNodes nodes. But the number of nodes can be
+    // greater than the number of supported prefixes. Given N prefixes in the data input list,
+    // step 2 below can produce a new list of up to 2*N prefixes to insert in the LC trie. And the
+    // LC trie can use up to 2*N/fill_factor nodes.
     size_t num_prefixes = 0;
     for (const auto& pair_data : data) {
       num_prefixes += pair_data.second.size();
@@ -76,8 +76,9 @@ public:
                       num_prefixes, max_prefixes));
     }
 
-    // Step 1: separate the provided prefixes by protocol (IPv4 vs IPv6),
-    // and build a Binary Trie per protocol.
+    // Step 1: separate the provided prefixes by protocol (IPv4 vs IPv6). The prefixes of each
+    // protocol form a Binary Trie, which is not built: its nodes are visited in order by sorting
+    // the prefixes.
     //
     // For example, if the input prefixes are
     //   A: 0.0.0.0/0
@@ -101,18 +102,18 @@ public:
     // algorithm does not support nested prefixes. The next step will solve that
     // problem.
 
-    BinaryTrie<Ipv4> ipv4_temp(exclusive);
-    BinaryTrie<Ipv6> ipv6_temp(exclusive);
+    DataSetsBuilder data_sets(data_sets_);
+    std::vector<IpPrefix<Ipv4>> ipv4_temp;
+    std::vector<IpPrefix<Ipv6>> ipv6_temp;
     for (const auto& pair_data : data) {
+      const uint32_t data_set = data_sets.intern({pair_data.first});
       for (const auto& cidr_range : pair_data.second) {
         if (cidr_range.ip()->version() == Address::IpVersion::v4) {
-          IpPrefix<Ipv4> ip_prefix(ntohl(cidr_range.ip()->ipv4()->address()), cidr_range.length(),
-                                   pair_data.first);
-          ipv4_temp.insert(ip_prefix);
+          ipv4_temp.emplace_back(ntohl(cidr_range.ip()->ipv4()->address()), cidr_range.length(),
+                                 data_set);
         } else {
-          IpPrefix<Ipv6> ip_prefix(Utility::Ip6ntohl(cidr_range.ip()->ipv6()->address()),
-                                   cidr_range.length(), pair_data.first);
-          ipv6_temp.insert(ip_prefix);
+          ipv6_temp.emplace_back(Utility::Ip6ntohl(cidr_range.ip()->ipv6()->address()),
+                                 cidr_range.length(), data_set);
         }
       }
     }
@@ -137,8 +138,8 @@ public:
     // step 1. But it has a useful new property: now that all the prefixes
     // are at the leaves, they are disjoint: no prefix is nested under another.
 
-    std::vector<IpPrefix<Ipv4>> ipv4_prefixes = ipv4_temp.push_leaves();
-    std::vector<IpPrefix<Ipv6>> ipv6_prefixes = ipv6_temp.push_leaves();
+    std::vector<IpPrefix<Ipv4>> ipv4_prefixes = pushLeaves(ipv4_temp, exclusive, data_sets);
+    std::vector<IpPrefix<Ipv6>> ipv6_prefixes = pushLeaves(ipv6_temp, exclusive, data_sets);
 
     // Step 3: take the disjoint prefixes from the leaves of each Binary Trie
     // and use them to construct an LC Trie.
@@ -182,13 +183,13 @@ public:
    * empty vector is returned if no prefix contains 'ip_address' or there is no data for the IP
    * version of the ip_address.
    */
-  std::vector<T> getData(const Network::Address::InstanceConstSharedPtr& ip_address) const {
+  const std::vector<T>& getData(const Network::Address::InstanceConstSharedPtr& ip_address) const {
     if (ip_address->ip()->version() == Address::IpVersion::v4) {
       Ipv4 ip = ntohl(ip_address->ip()->ipv4()->address());
-      return ipv4_trie_->getData(ip);
+      return data_sets_[ipv4_trie_->getData(ip)];
     } else {
       Ipv6 ip = Utility::Ip6ntohl(ip_address->ip()->ipv6()->address());
-      return ipv6_trie_->getData(ip);
+      return data_sets_[ipv6_trie_->getData(ip)];
     }
   }
 
@@ -232,21 +233,72 @@ private:
   using Ipv4 = uint32_t;
   using Ipv6 = absl::uint128;
 
-  using DataSet = absl::node_hash_set<T>;
-  using DataSetSharedPtr = std::shared_ptr<DataSet>;
+  /**
+   * Interns the distinct data sets of the prefixes into a vector, in which the prefixes refer to
+   * them by index, so that the many prefixes with the same data share it. Each set is sorted, and
+   * the set at index 0 is empty.
+   */
+  class DataSetsBuilder {
+  public:
+    DataSetsBuilder(std::vector<std::vector<T>>& data_sets) : data_sets_(data_sets) {
+      data_sets_.emplace_back();
+      indices_.emplace(std::vector<T>(), 0);
+    }
+
+    /**
+     * @return the index of a set.
+     */
+    uint32_t intern(std::vector<T>&& data_set) {
+      std::sort(data_set.begin(), data_set.end());
+      data_set.erase(std::unique(data_set.begin(), data_set.end()), data_set.end());
+      const auto it = indices_.find(data_set);
+      if (it != indices_.end()) {
+        return it->second;
+      }
+      const uint32_t index = data_sets_.size();
+      data_sets_.push_back(data_set);
+      indices_.emplace(std::move(data_set), index);
+      return index;
+    }
+
+    /**
+     * @return the index of the union of two sets.
+     */
+    uint32_t merge(uint32_t first, uint32_t second) {
+      if (first == second || second == 0) {
+        return first;
+      }
+      if (first == 0) {
+        return second;
+      }
+      const auto key = std::make_pair(std::min(first, second), std::max(first, second));
+      const auto it = merged_.find(key);
+      if (it != merged_.end()) {
+        return it->second;
+      }
+      std::vector<T> data_set;
+      std::set_union(data_sets_[first].begin(), data_sets_[first].end(),
+                     data_sets_[second].begin(), data_sets_[second].end(),
+                     std::back_inserter(data_set));
+      const uint32_t index = intern(std::move(data_set));
+      merged_.emplace(key, index);
+      return index;
+    }
+
+  private:
+    std::vector<std::vector<T>>& data_sets_;
+    absl::flat_hash_map<std::vector<T>, uint32_t> indices_;
+    absl::flat_hash_map<std::pair<uint32_t, uint32_t>, uint32_t> merged_;
+  };
 
   /**
-   * Structure to hold a CIDR range and the data associated with it.
+   * Structure to hold a CIDR range and the index of the data associated with it.
    */
   template <class IpType, uint32_t address_size = CHAR_BIT * sizeof(IpType)> struct IpPrefix {
 
     IpPrefix() = default;
 
-    IpPrefix(const IpType& ip, uint32_t length, const T& data) : ip_(ip), length_(length) {
-      data_.insert(data);
-    }
-
-    IpPrefix(const IpType& ip, int length, const DataSet& data)
+    IpPrefix(const IpType& ip, uint32_t length, uint32_t data)
         : ip_(ip), length_(length), data_(data) {}
 
     /**
@@ -273,13 +325,6 @@ private:
 
     bool operator!=(const IpPrefix& other) const { return (this->compare(other) != 0); }
 
-    /**
-     * @return true if other is a prefix of this.
-     */
-    bool isPrefix(const IpPrefix& other) {
-      return (length_ == 0 || (length_ <= other.length_ && contains(other.ip_)));
-    }
-
     /**
      * @param address supplies an IP address to check against this prefix.
      * @return bool true if this prefix contains the address.
@@ -289,115 +334,118 @@ private:
               extractBits<IpType, address_size>(0, length_, address));
     }
 
+    /**
+     * @return the last address of the prefix.
+     */
+    IpType last() const { return length_ == address_size ? ip_ : ip_ | (~IpType(0) >> length_); }
+
     std::string asString() { return fmt::format("{}/{}", toString(ip_), length_); }
 
     // The address represented either in Ipv4(uint32_t) or Ipv6(absl::uint128).
     IpType ip_{0};
     // Length of the cidr range.
     uint32_t length_{0};
-    // Data for this entry.
-    DataSet data_;
+    // Index of the data for this entry in the data sets.
+    uint32_t data_{0};
   };
 
   /**
-   * Binary trie used to simplify the construction of Level Compressed Tries.
-   * This data type supports two operations:
-   *   1. Add a prefix to the trie.
-   *   2. Push the prefixes to the leaves of the trie.
-   * That second operation produces a new set of prefixes that yield the same
-   * match results as the original set of prefixes from which the BinaryTrie
-   * was constructed, but with an important difference: the new prefixes are
-   * guaranteed not to be nested within each other. That allows the use of the
-   * classic LC Trie construction algorithm, which is fast and (relatively)
-   * simple but does not work properly with nested prefixes.
+   * Appends the prefixes covering the addresses from first to last, the fewest aligned CIDR
+   * ranges, with a data set.
    */
-  template <class IpType, uint32_t address_size = CHAR_BIT * sizeof(IpType)> class BinaryTrie {
-  public:
-    BinaryTrie(bool exclusive) : root_(std::make_unique<Node>()), exclusive_(exclusive) {}
-
-    /**
-     * Add a CIDR prefix and associated data to the binary trie. If an entry already
-     * exists for the prefix, merge the data into the existing entry.
-     */
-    void insert(const IpPrefix<IpType>& prefix) {
-      Node* node = root_.get();
-      for (uint32_t i = 0; i < prefix.length_; i++) {
-        auto bit = static_cast<uint32_t>(extractBits(i, 1, prefix.ip_));
-        NodePtr& next_node = node->children[bit];
-        if (next_node == nullptr) {
-          next_node = std::make_unique<Node>();
-        }
-        node = next_node.get();
+  template <class IpType, uint32_t address_size = CHAR_BIT * sizeof(IpType)>
+  static void appendRange(IpType first, IpType last, uint32_t data,
+                          std::vector<IpPrefix<IpType>>& prefixes) {
+    while (true) {
+      // Grow the range at first while it stays aligned and within last.
+      const IpType span = last - first;
+      uint32_t bits = 0;
+      while (bits < address_size && ((first >> bits) & IpType(1)) == IpType(0) &&
+             (bits + 1 == address_size ? span == ~IpType(0)
+                                       : ((IpType(1) << (bits + 1)) - IpType(1)) <= span)) {
+        ++bits;
+      }
+      prefixes.emplace_back(first, address_size - bits, data);
+      if (bits == address_size) {
+        return;
       }
-      if (node->data == nullptr) {
-        node->data = std::make_shared<DataSet>();
+      const IpType range_last = first + ((IpType(1) << bits) - IpType(1));
+      if (range_last == last) {
+        return;
       }
-      node->data->insert(prefix.data_.begin(), prefix.data_.end());
+      first = range_last + IpType(1);
     }
+  }
 
-    /**
-     * Update each node in the trie to inherit/override its ancestors' data,
-     * and then push the prefixes in the binary trie to the leaves so that:
-     *  1) each leaf contains a prefix, and
-     *  2) given the set of prefixes now located at the leaves, a useful
-     *     new property applies: no prefix in that set is nested under any
-     *     other prefix in the set (since, by definition, no leaf of the
-     *     trie can be nested under another leaf)
-     * @return the prefixes associated with the leaf nodes.
-     */
-    std::vector<IpPrefix<IpType>> push_leaves() {
-      std::vector<IpPrefix<IpType>> prefixes;
-      std::function<void(Node*, DataSetSharedPtr, unsigned, IpType)> visit =
-          [&](Node* node, DataSetSharedPtr data, unsigned depth, IpType prefix) {
-            // Inherit any data set by ancestor nodes.
-            if (data != nullptr) {
-              if (node->data == nullptr) {
-                node->data = data;
-              } else if (!exclusive_) {
-                node->data->insert(data->begin(), data->end());
-              }
-            }
-            // If a node has exactly one child, create a second child node
-            // that inherits the union of all data set by any ancestor nodes.
-            // This gives the trie an important new property: all the configured
-            // prefixes end up at the leaves of the trie. As no leaf is nested
-            // under another leaf (or one of them would not be a leaf!), the
-            // leaves of the trie upon completion of this leaf-push operation
-            // will form a set of disjoint prefixes (no nesting) that can be
-            // used to build an LC trie.
-            if (node->children[0] != nullptr && node->children[1] == nullptr) {
-              node->children[1] = std::make_unique<Node>();
-            } else if (node->children[0] == nullptr && node->children[1] != nullptr) {
-              node->children[0] = std::make_unique<Node>();
-            }
-            if (node->children[0] != nullptr) {
-              visit(node->children[0].get(), node->data, depth + 1, (prefix << 1) + IpType(0));
-              visit(node->children[1].get(), node->data, depth + 1, (prefix << 1) + IpType(1));
-            } else {
-              if (node->data != nullptr) {
-                // Compute the CIDR prefix from the path we've taken to get to this point in the
-                // tree.
-                IpType ip = prefix;
-                if (depth != 0) {
-                  ip <<= (address_size - depth);
-                }
-                prefixes.emplace_back(IpPrefix<IpType>(ip, depth, *node->data));
-              }
-            }
-          };
-      visit(root_.get(), nullptr, 0, IpType(0));
-      return prefixes;
+  /**
+   * Pushes the prefixes to the leaves of the Binary Trie they form, so that:
+   *  1) each leaf contains a prefix, inheriting (or, if exclusive, overriding) the data of its
+   *     ancestors, and
+   *  2) given the set of prefixes now located at the leaves, a useful new property applies: no
+   *     prefix in that set is nested under any other prefix in the set.
+   * The leaves are computed from the sorted prefixes rather than from the nodes of the trie: the
+   * leaves under a prefix are the prefixes nested in it and the fewest CIDR ranges covering the
+   * rest of its addresses.
+   * @return the prefixes associated with the leaves.
+   */
+  template <class IpType, uint32_t address_size = CHAR_BIT * sizeof(IpType)>
+  static std::vector<IpPrefix<IpType>> pushLeaves(std::vector<IpPrefix<IpType>>& prefixes,
+                                                  bool exclusive, DataSetsBuilder& data_sets) {
+    // Only the first length_ bits of a prefix count.
+    for (auto& prefix : prefixes) {
+      prefix.ip_ = prefix.length_ == 0 ? IpType(0)
+                                       : prefix.ip_ >> (address_size - prefix.length_)
+                                                        << (address_size - prefix.length_);
     }
-
-  private:
-    struct Node {
-      std::unique_ptr<Node> children[2];
-      DataSetSharedPtr data;
+    // The nested prefixes follow the prefixes they are nested in.
+    std::sort(prefixes.begin(), prefixes.end());
+
+    // The prefixes which the current prefix is nested in, each with the first of its addresses
+    // that no leaf covers yet.
+    struct Ancestor {
+      IpPrefix<IpType> prefix_;
+      IpType next_;
+      bool done_;
     };
-    using NodePtr = std::unique_ptr<Node>;
-    NodePtr root_;
-    bool exclusive_;
-  };
+    std::vector<Ancestor> ancestors;
+    std::vector<IpPrefix<IpType>> leaves;
+    const auto close_ancestor = [&ancestors, &leaves]() {
+      const Ancestor& ancestor = ancestors.back();
+      if (!ancestor.done_) {
+        appendRange<IpType, address_size>(ancestor.next_, ancestor.prefix_.last(),
+                                          ancestor.prefix_.data_, leaves);
+      }
+      ancestors.pop_back();
+    };
+
+    for (size_t i = 0; i < prefixes.size(); ++i) {
+      IpPrefix<IpType> prefix = prefixes[i];
+      // Merge the data of the duplicate prefixes.
+      while (i + 1 < prefixes.size() && !(prefixes[i + 1] != prefix)) {
+        prefix.data_ = data_sets.merge(prefix.data_, prefixes[++i].data_);
+      }
+      while (!ancestors.empty() && !ancestors.back().prefix_.contains(prefix.ip_)) {
+        close_ancestor();
+      }
+      if (!ancestors.empty()) {
+        Ancestor& parent = ancestors.back();
+        if (parent.next_ != prefix.ip_) {
+          appendRange<IpType, address_size>(parent.next_, prefix.ip_ - IpType(1),
+                                            parent.prefix_.data_, leaves);
+        }
+        parent.next_ = prefix.last() + IpType(1);
+        parent.done_ = prefix.last() == parent.prefix_.last();
+        if (!exclusive) {
+          prefix.data_ = data_sets.merge(prefix.data_, parent.prefix_.data_);
+        }
+      }
+      ancestors.push_back(Ancestor{prefix, prefix.ip_, false});
+    }
+    while (!ancestors.empty()) {
+      close_ancestor();
+    }
+    return leaves;
+  }
 
   /**
    * Level Compressed Trie (LC-Trie) that contains CIDR ranges and its corresponding data.
@@ -409,7 +457,7 @@ private:
    * 'http://www.csc.kth.se/~snilsson/software/router/C/' were used as reference during
    * implementation.
    *
-   * Note: The trie can only support up 524288(2^19) prefixes with a fill_factor of 1 and
+   * Note: The trie can only support up to 2^25 prefixes with a fill_factor of 1 and
    * root_branching_factor not set. Refer to LcTrieInternal::build() method for more details.
    */
   template <class IpType, uint32_t address_size = CHAR_BIT * sizeof(IpType)> class LcTrieInternal {
@@ -429,10 +477,10 @@ private:
     /**
      * Retrieve the data associated with the CIDR range that contains `ip_address`.
      * @param  ip_address supplies the IP address in host byte order.
-     * @return a vector of data from the CIDR ranges and IP addresses that encompasses the input.
-     * An empty vector is returned if the LC Trie is empty.
+     * @return the index of the data set of the CIDR range that encompasses the input, 0 (the
+     * empty set) if there is none.
      */
-    std::vector<T> getData(const IpType& ip_address) const;
+    uint32_t getData(const IpType& ip_address) const;
 
   private:
     /**
@@ -444,7 +492,7 @@ private:
         return;
       }
 
-      ip_prefixes_ = data;
+      ip_prefixes_ = std::move(data);
       std::sort(ip_prefixes_.begin(), ip_prefixes_.end());
 
       // Build the trie_.
@@ -658,26 +706,22 @@ private:
     }
 
     /**
-     * LcNode is a uint32_t. A wrapper is provided to simplify getting/setting the branch, the
+     * LcNode is 8 bytes. A wrapper is provided to simplify getting/setting the branch, the
      * skip and the address values held within the structure.
      *
      * The LcNode has three parts to it
-     * - Branch: the first 5 bits represent the branching factor. The branching factor is used to
-     * determine the number of descendants for the current node. The number represents a power of
-     * 2, so there can be at most 2^31 descendant nodes.
-     * - Skip: the next 7 bits represent the number of bits to skip when looking at an IP address.
-     * This value can be between 0 and 127, so IPv6 is supported.
-     * - Address: the remaining 20 bits represent an index either into the trie_ or the
-     * ip_prefixes_. If branch_ != 0, the index is for the trie_. If branch == zero, the index is
-     * for the ip_prefixes_.
-     *
-     * Note: If more than 2^19-1 CIDR ranges are to be stored in trie_, uint64_t should be used
-     * instead.
+     * - Branch: the branching factor, at most 31. The branching factor is used to determine the
+     * number of descendants for the current node. The number represents a power of 2, so there
+     * can be at most 2^31 descendant nodes.
+     * - Skip: the number of bits to skip when looking at an IP address. This value can be between
+     * 0 and 127, so IPv6 is supported.
+     * - Address: an index either into the trie_ or the ip_prefixes_. If branch_ != 0, the index
+     * is for the trie_. If branch == zero, the index is for the ip_prefixes_.
      */
     struct LcNode {
-      uint32_t branch_ : 5;
-      uint32_t skip_ : 7;
-      uint32_t address_ : 20; // If this 20-bit size changes, please change MaxLcTrieNodes too.
+      uint32_t address_;
+      uint8_t branch_;
+      uint8_t skip_;
     };
 
     // The CIDR range and data needs to be maintained separately from the LC-Trie. A LC-Trie skips
@@ -694,6 +738,8 @@ private:
     const uint32_t root_branching_factor_;
   };
 
+  // The distinct data sets of the prefixes, referenced by index from the tries.
+  std::vector<std::vector<T>> data_sets_;
   std::unique_ptr<LcTrieInternal<Ipv4>> ipv4_trie_;
   std::unique_ptr<LcTrieInternal<Ipv6>> ipv6_trie_;
 };
@@ -709,11 +755,9 @@ LcTrie<T>::LcTrieInternal<IpType, address_size>::LcTrieInternal(std::vector<IpPr
 
 template <class T>
 template <class IpType, uint32_t address_size>
-std::vector<T>
-LcTrie<T>::LcTrieInternal<IpType, address_size>::getData(const IpType& ip_address) const {
-  std::vector<T> return_vector;
+uint32_t LcTrie<T>::LcTrieInternal<IpType, address_size>::getData(const IpType& ip_address) const {
   if (trie_.empty()) {
-    return return_vector;
+    return 0;
   }
 
   LcNode node = trie_[0];
@@ -737,9 +781,9 @@ LcTrie<T>::LcTrieInternal<IpType, address_size>::getData(const IpType& ip_addres
   // ip_address.
   const auto& prefix = ip_prefixes_[address];
   if (prefix.contains(ip_address)) {
-    return std::vector<T>(prefix.data_.begin(), prefix.data_.end());
+    return prefix.data_;
   }
-  return std::vector<T>();
+  return 0;
 }
 
 } // namespace LcTrie
@@ -0,0 +1,23 @@
+#include "common/network/listener_filter_buffer_impl.h"
+
+#include "envoy/common/platform.h"
+
+namespace Envoy {
+namespace Network {
+
+Api::IoCallUint64Result ListenerFilterBufferImpl::peek(uint64_t max_length) {
+  if (max_length > capacity_) {
+    // MSG_PEEK returns the bytes seen before again, so they do not need to be kept.
+    buffer_ = std::make_unique<uint8_t[]>(max_length);
+    capacity_ = max_length;
+    length_ = 0;
+  }
+  Api::IoCallUint64Result result = io_handle_.recv(buffer_.get(), max_length, MSG_PEEK);
+  if (result.ok()) {
+    length_ = result.rc_;
+  }
+  return result;
+}
+
+} // namespace Network
+} // namespace Envoy
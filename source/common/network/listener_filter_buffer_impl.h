@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/network/filter.h"
+#include "envoy/network/io_handle.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * The bytes peeked from a socket by its listener filters. The buffer grows to the largest peek
+ * and is only allocated once a filter peeks, as most accepted sockets have no listener filters
+ * that read them.
+ */
+class ListenerFilterBufferImpl : public ListenerFilterBuffer, NonCopyable {
+public:
+  explicit ListenerFilterBufferImpl(IoHandle& io_handle) : io_handle_(io_handle) {}
+
+  // Network::ListenerFilterBuffer
+  Api::IoCallUint64Result peek(uint64_t max_length) override;
+  absl::string_view data() const override {
+    return {reinterpret_cast<const char*>(buffer_.get()), length_};
+  }
+  void clear() override { length_ = 0; }
+
+private:
+  IoHandle& io_handle_;
+  std::unique_ptr<uint8_t[]> buffer_;
+  uint64_t capacity_{0};
+  uint64_t length_{0};
+};
+
+} // namespace Network
+} // namespace Envoy
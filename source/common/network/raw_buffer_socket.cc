@@ -3,11 +3,92 @@
 #include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
+#include "common/common/utility.h"
 #include "common/http/headers.h"
 
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+#include <linux/errqueue.h>
+#define ENVOY_ZERO_COPY_SEND 1
+#endif
+
 namespace Envoy {
 namespace Network {
 
+void ZeroCopySendTracker::onSend(uint64_t bytes, bool zero_copy) {
+  ASSERT(bytes > 0);
+  sends_.push_back({bytes, zero_copy ? next_id_++ : 0, zero_copy, !zero_copy});
+  pinned_bytes_ += bytes;
+  if (zero_copy) {
+    pending_zero_copy_sends_++;
+  }
+}
+
+void ZeroCopySendTracker::onCompleted(uint32_t first, uint32_t last) {
+  const uint32_t range = last - first;
+  for (Send& send : sends_) {
+    if (send.zero_copy_ && !send.completed_ && send.id_ - first <= range) {
+      send.completed_ = true;
+      pending_zero_copy_sends_--;
+    }
+  }
+}
+
+uint64_t ZeroCopySendTracker::releaseCompleted() {
+  uint64_t released = 0;
+  while (!sends_.empty() && sends_.front().completed_) {
+    released += sends_.front().bytes_;
+    sends_.pop_front();
+  }
+  pinned_bytes_ -= released;
+  return released;
+}
+
+AdaptiveReadConfig::AdaptiveReadConfig(uint32_t min_read_size, uint32_t max_read_size,
+                                       Stats::Scope& scope)
+    : min_read_size_(min_read_size), max_read_size_(max_read_size),
+      stats_{ALL_RAW_BUFFER_SOCKET_STATS(POOL_GAUGE_PREFIX(scope, "raw_buffer."))} {
+  ASSERT(min_read_size_ > 0 && min_read_size_ <= max_read_size_);
+}
+
+AdaptiveReadSize::AdaptiveReadSize(AdaptiveReadConfigSharedPtr config)
+    : config_(std::move(config)), read_size_(config_->min_read_size_) {
+  config_->stats_.read_reservation_bytes_.add(read_size_);
+}
+
+AdaptiveReadSize::~AdaptiveReadSize() { config_->stats_.read_reservation_bytes_.sub(read_size_); }
+
+void AdaptiveReadSize::onRead(uint64_t bytes_read) {
+  if (bytes_read >= read_size_) {
+    // The peer may have more data queued than a read can take.
+    small_reads_ = 0;
+    setReadSize(std::min<uint64_t>(2 * read_size_, config_->max_read_size_));
+  } else if (bytes_read <= read_size_ / SmallReadFraction) {
+    if (++small_reads_ == ShrinkAfterSmallReads) {
+      small_reads_ = 0;
+      setReadSize(std::max<uint64_t>(read_size_ / 2, config_->min_read_size_));
+    }
+  } else {
+    small_reads_ = 0;
+  }
+}
+
+void AdaptiveReadSize::setReadSize(uint64_t read_size) {
+  if (read_size > read_size_) {
+    config_->stats_.read_reservation_bytes_.add(read_size - read_size_);
+  } else {
+    config_->stats_.read_reservation_bytes_.sub(read_size_ - read_size);
+  }
+  read_size_ = read_size;
+}
+
+RawBufferSocket::RawBufferSocket(uint32_t zero_copy_send_threshold,
+                                 AdaptiveReadConfigSharedPtr adaptive_read)
+    : zero_copy_send_threshold_(zero_copy_send_threshold) {
+  if (adaptive_read != nullptr) {
+    adaptive_read_size_ = std::make_unique<AdaptiveReadSize>(std::move(adaptive_read));
+  }
+}
+
 void RawBufferSocket::setTransportSocketCallbacks(TransportSocketCallbacks& callbacks) {
   ASSERT(!callbacks_);
   callbacks_ = &callbacks;
@@ -18,8 +99,10 @@ IoResult RawBufferSocket::doRead(Buffer::Instance& buffer) {
   uint64_t bytes_read = 0;
   bool end_stream = false;
   do {
-    // 16K read is arbitrary. TODO(mattklein123) PERF: Tune the read size.
-    Api::IoCallUint64Result result = callbacks_->ioHandle().read(buffer, 16384);
+    // Unless it adapts, 16K read is arbitrary. TODO(mattklein123) PERF: Tune the read size.
+    const uint64_t read_size =
+        adaptive_read_size_ != nullptr ? adaptive_read_size_->readSize() : 16384;
+    Api::IoCallUint64Result result = callbacks_->ioHandle().read(buffer, read_size);
 
     if (result.ok()) {
       ENVOY_CONN_LOG(trace, "read returns: {}", callbacks_->connection(), result.rc_);
@@ -29,6 +112,9 @@ IoResult RawBufferSocket::doRead(Buffer::Instance& buffer) {
         break;
       }
       bytes_read += result.rc_;
+      if (adaptive_read_size_ != nullptr) {
+        adaptive_read_size_->onRead(result.rc_);
+      }
       if (callbacks_->shouldDrainReadBuffer()) {
         callbacks_->setTransportSocketIsReadable();
         break;
@@ -50,9 +136,16 @@ IoResult RawBufferSocket::doRead(Buffer::Instance& buffer) {
 IoResult RawBufferSocket::doWrite(Buffer::Instance& buffer, bool end_stream) {
   PostIoAction action;
   uint64_t bytes_written = 0;
-  ASSERT(!shutdown_ || buffer.length() == 0);
+  if (zero_copy_sends_.pinnedBytes() > 0) {
+    // Completion notifications wake the connection up through the error condition on the socket,
+    // which is reported as writable.
+    processZeroCopyCompletions();
+    buffer.drain(zero_copy_sends_.releaseCompleted());
+  }
+  ASSERT(!shutdown_ || buffer.length() == zero_copy_sends_.pinnedBytes());
   do {
-    if (buffer.length() == 0) {
+    const uint64_t pinned_bytes = zero_copy_sends_.pinnedBytes();
+    if (buffer.length() == pinned_bytes) {
       if (end_stream && !shutdown_) {
         // Ignore the result. This can only fail if the connection failed. In that case, the
         // error will be detected on the next read, and dealt with appropriately.
@@ -62,6 +155,31 @@ IoResult RawBufferSocket::doWrite(Buffer::Instance& buffer, bool end_stream) {
       action = PostIoAction::KeepOpen;
       break;
     }
+
+    if (pinned_bytes > 0 || shouldZeroCopy(buffer.length())) {
+      // The front of the buffer may still be in use by the kernel, so send the unsent bytes
+      // without draining anything; they are drained once every send before them has completed.
+      bool zero_copy = shouldZeroCopy(buffer.length() - pinned_bytes);
+      Api::SysCallSizeResult result = sendUnsent(buffer, zero_copy);
+      if (result.rc_ < 0 && zero_copy && result.errno_ == ENOBUFS) {
+        // The socket is over its limit of memory for notifications; copy this write instead.
+        zero_copy = false;
+        result = sendUnsent(buffer, zero_copy);
+      }
+      if (result.rc_ > 0) {
+        ENVOY_CONN_LOG(trace, "write returns: {}{}", callbacks_->connection(), result.rc_,
+                       zero_copy ? " (zero copy)" : "");
+        bytes_written += result.rc_;
+        zero_copy_sends_.onSend(result.rc_, zero_copy);
+        buffer.drain(zero_copy_sends_.releaseCompleted());
+        continue;
+      }
+      ENVOY_CONN_LOG(trace, "write error: {}", callbacks_->connection(),
+                     errorDetails(result.errno_));
+      action = result.errno_ == SOCKET_ERROR_AGAIN ? PostIoAction::KeepOpen : PostIoAction::Close;
+      break;
+    }
+
     Api::IoCallUint64Result result = callbacks_->ioHandle().write(buffer);
 
     if (result.ok()) {
@@ -82,6 +200,110 @@ IoResult RawBufferSocket::doWrite(Buffer::Instance& buffer, bool end_stream) {
   return {action, bytes_written, false};
 }
 
+bool RawBufferSocket::shouldZeroCopy(uint64_t unsent_bytes) {
+#ifdef ENVOY_ZERO_COPY_SEND
+  if (zero_copy_send_threshold_ == 0 || unsent_bytes < zero_copy_send_threshold_ ||
+      zero_copy_unavailable_) {
+    return false;
+  }
+  if (!zero_copy_enabled_) {
+    const int enable = 1;
+    if (callbacks_->ioHandle().setOption(SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)).rc_ !=
+        0) {
+      ENVOY_CONN_LOG(debug, "unable to enable zero copy sends", callbacks_->connection());
+      zero_copy_unavailable_ = true;
+      return false;
+    }
+    zero_copy_enabled_ = true;
+  }
+  return true;
+#else
+  UNREFERENCED_PARAMETER(unsent_bytes);
+  return false;
+#endif
+}
+
+Api::SysCallSizeResult RawBufferSocket::sendUnsent(const Buffer::Instance& buffer,
+                                                   bool zero_copy) {
+  constexpr uint64_t MaxSlices = 16;
+  iovec iov[MaxSlices];
+  uint64_t num_iov = 0;
+  uint64_t skip = zero_copy_sends_.pinnedBytes();
+  for (const Buffer::RawSlice& slice : buffer.getRawSlices()) {
+    if (skip >= slice.len_) {
+      skip -= slice.len_;
+      continue;
+    }
+    iov[num_iov].iov_base = static_cast<uint8_t*>(slice.mem_) + skip;
+    iov[num_iov].iov_len = slice.len_ - skip;
+    skip = 0;
+    if (++num_iov == MaxSlices) {
+      break;
+    }
+  }
+  msghdr message{};
+  message.msg_iov = iov;
+  message.msg_iovlen = num_iov;
+  int flags = 0;
+#ifdef ENVOY_ZERO_COPY_SEND
+  if (zero_copy) {
+    flags |= MSG_ZEROCOPY;
+  }
+#else
+  ASSERT(!zero_copy);
+#endif
+  return Api::OsSysCallsSingleton::get().sendmsg(callbacks_->ioHandle().fdDoNotUse(), &message,
+                                                 flags);
+}
+
+void RawBufferSocket::processZeroCopyCompletions() {
+#ifdef ENVOY_ZERO_COPY_SEND
+  if (!zero_copy_sends_.hasPendingZeroCopySends()) {
+    return;
+  }
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  while (true) {
+    char control[CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))];
+    msghdr message{};
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    const Api::SysCallSizeResult result =
+        os_sys_calls.recvmsg(callbacks_->ioHandle().fdDoNotUse(), &message, MSG_ERRQUEUE);
+    if (result.rc_ < 0) {
+      break;
+    }
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&message, cmsg)) {
+      if (!((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+            (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))) {
+        continue;
+      }
+      const auto* err = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(cmsg));
+      if (err->ee_errno != 0 || err->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+        continue;
+      }
+      zero_copy_sends_.onCompleted(err->ee_info, err->ee_data);
+      if (err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+        // The kernel fell back to copying, e.g. on loopback or a device without scatter-gather
+        // support. Zero copy only adds overhead in that case.
+        ENVOY_CONN_LOG(debug, "zero copy sends were copied; disabling", callbacks_->connection());
+        zero_copy_unavailable_ = true;
+      }
+    }
+  }
+#endif
+}
+
+void RawBufferSocket::closeSocket(Network::ConnectionEvent) {
+  processZeroCopyCompletions();
+  if (zero_copy_sends_.hasPendingZeroCopySends()) {
+    // The write buffer is freed right after the socket is closed. Reset the connection so that the
+    // kernel drops the queued data rather than sending it from freed memory.
+    const struct linger reset = {1, 0};
+    callbacks_->ioHandle().setOption(SOL_SOCKET, SO_LINGER, &reset, sizeof(reset));
+  }
+}
+
 std::string RawBufferSocket::protocol() const { return EMPTY_STRING; }
 absl::string_view RawBufferSocket::failureReason() const { return EMPTY_STRING; }
 
@@ -89,7 +311,7 @@ void RawBufferSocket::onConnected() { callbacks_->raiseEvent(ConnectionEvent::Co
 
 TransportSocketPtr
 RawBufferSocketFactory::createTransportSocket(TransportSocketOptionsSharedPtr) const {
-  return std::make_unique<RawBufferSocket>();
+  return std::make_unique<RawBufferSocket>(zero_copy_send_threshold_, adaptive_read_);
 }
 
 bool RawBufferSocketFactory::implementsSecureTransport() const { return false; }
@@ -1,39 +1,185 @@
 #pragma once
 
+#include <deque>
+#include <memory>
+
+#include "envoy/api/os_sys_calls_common.h"
 #include "envoy/buffer/buffer.h"
 #include "envoy/network/connection.h"
 #include "envoy/network/transport_socket.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 
 #include "common/common/logger.h"
 
 namespace Envoy {
 namespace Network {
 
+/**
+ * Bookkeeping for the front of a write buffer that has been handed to the kernel but may not be
+ * drained yet: zero copy sends are transmitted from the buffer's memory, so it must stay intact
+ * until the kernel reports the send as completed. Sends are released in order; a plain send that
+ * follows a pending zero copy send is held back along with it.
+ */
+class ZeroCopySendTracker {
+public:
+  /**
+   * Record a send of the given number of bytes. Zero copy sends are numbered in order, matching
+   * the ids the kernel reports their completion with.
+   */
+  void onSend(uint64_t bytes, bool zero_copy);
+
+  /**
+   * Mark the zero copy sends with ids in the inclusive, possibly wrapping range [first, last] as
+   * completed.
+   */
+  void onCompleted(uint32_t first, uint32_t last);
+
+  /**
+   * @return the number of bytes at the front of the buffer that may now be drained. They are no
+   *         longer tracked after this call.
+   */
+  uint64_t releaseCompleted();
+
+  /**
+   * @return the number of sent bytes at the front of the buffer that are not released yet.
+   */
+  uint64_t pinnedBytes() const { return pinned_bytes_; }
+
+  /**
+   * @return whether the kernel may still be reading from the buffer.
+   */
+  bool hasPendingZeroCopySends() const { return pending_zero_copy_sends_ > 0; }
+
+private:
+  struct Send {
+    uint64_t bytes_;
+    uint32_t id_;
+    bool zero_copy_;
+    bool completed_;
+  };
+
+  std::deque<Send> sends_;
+  uint32_t next_id_{0};
+  uint64_t pinned_bytes_{0};
+  uint64_t pending_zero_copy_sends_{0};
+};
+
+/**
+ * All raw buffer socket stats. @see stats_macros.h
+ */
+#define ALL_RAW_BUFFER_SOCKET_STATS(GAUGE) GAUGE(read_reservation_bytes, Accumulate)
+
+/**
+ * Struct definition for all raw buffer socket stats. @see stats_macros.h
+ */
+struct RawBufferSocketStats {
+  ALL_RAW_BUFFER_SOCKET_STATS(GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * Bounds of the read size of connections whose reads adapt to the amount of data the peer sends.
+ */
+struct AdaptiveReadConfig {
+  AdaptiveReadConfig(uint32_t min_read_size, uint32_t max_read_size, Stats::Scope& scope);
+
+  const uint32_t min_read_size_;
+  const uint32_t max_read_size_;
+  RawBufferSocketStats stats_;
+};
+
+using AdaptiveReadConfigSharedPtr = std::shared_ptr<const AdaptiveReadConfig>;
+
+/**
+ * Per connection read size that starts at the configured minimum, doubles after each read that
+ * fills the whole reservation and halves after a run of reads that use a small fraction of it.
+ * The current size of every live instance is accounted for in the read_reservation_bytes gauge.
+ */
+class AdaptiveReadSize {
+public:
+  // The number of consecutive small reads after which the read size shrinks, and what counts as
+  // a small read: one that uses at most 1/SmallReadFraction of the requested size.
+  static constexpr uint32_t ShrinkAfterSmallReads = 4;
+  static constexpr uint32_t SmallReadFraction = 4;
+
+  explicit AdaptiveReadSize(AdaptiveReadConfigSharedPtr config);
+  ~AdaptiveReadSize();
+
+  /**
+   * @return the number of bytes to request from the next read.
+   */
+  uint64_t readSize() const { return read_size_; }
+
+  /**
+   * Adjust the read size after a read of readSize() bytes returned bytes_read bytes of data.
+   */
+  void onRead(uint64_t bytes_read);
+
+private:
+  void setReadSize(uint64_t read_size);
+
+  const AdaptiveReadConfigSharedPtr config_;
+  uint64_t read_size_;
+  uint32_t small_reads_{0};
+};
+
 class RawBufferSocket : public TransportSocket, protected Logger::Loggable<Logger::Id::connection> {
 public:
+  /**
+   * @param zero_copy_send_threshold if non-zero, writes of at least this many bytes are sent with
+   *        MSG_ZEROCOPY where the platform supports it.
+   * @param adaptive_read if set, the size of reads adapts to the amount of data the peer sends
+   *        within its bounds. Otherwise reads are of a fixed size.
+   */
+  explicit RawBufferSocket(uint32_t zero_copy_send_threshold = 0,
+                           AdaptiveReadConfigSharedPtr adaptive_read = nullptr);
+
   // Network::TransportSocket
   void setTransportSocketCallbacks(TransportSocketCallbacks& callbacks) override;
   std::string protocol() const override;
   absl::string_view failureReason() const override;
   bool canFlushClose() override { return true; }
-  void closeSocket(Network::ConnectionEvent) override {}
+  void closeSocket(Network::ConnectionEvent) override;
   void onConnected() override;
   IoResult doRead(Buffer::Instance& buffer) override;
   IoResult doWrite(Buffer::Instance& buffer, bool end_stream) override;
   Ssl::ConnectionInfoConstSharedPtr ssl() const override { return nullptr; }
   bool startSecureTransport() override { return false; }
+  bool canSplice() const override {
+    return callbacks_ != nullptr && callbacks_->ioHandle().supportsSplice();
+  }
 
 private:
+  bool shouldZeroCopy(uint64_t unsent_bytes);
+  void processZeroCopyCompletions();
+  Api::SysCallSizeResult sendUnsent(const Buffer::Instance& buffer, bool zero_copy);
+
   TransportSocketCallbacks* callbacks_{};
   bool shutdown_{};
+  const uint32_t zero_copy_send_threshold_;
+  // SO_ZEROCOPY has been set on the socket.
+  bool zero_copy_enabled_{false};
+  // The socket cannot use, or does not benefit from, zero copy sends.
+  bool zero_copy_unavailable_{false};
+  ZeroCopySendTracker zero_copy_sends_;
+  std::unique_ptr<AdaptiveReadSize> adaptive_read_size_;
 };
 
 class RawBufferSocketFactory : public TransportSocketFactory {
 public:
+  explicit RawBufferSocketFactory(uint32_t zero_copy_send_threshold = 0,
+                                  AdaptiveReadConfigSharedPtr adaptive_read = nullptr)
+      : zero_copy_send_threshold_(zero_copy_send_threshold),
+        adaptive_read_(std::move(adaptive_read)) {}
+
   // Network::TransportSocketFactory
   TransportSocketPtr createTransportSocket(TransportSocketOptionsSharedPtr options) const override;
   bool implementsSecureTransport() const override;
   bool usesProxyProtocolOptions() const override { return false; }
+
+private:
+  const uint32_t zero_copy_send_threshold_;
+  const AdaptiveReadConfigSharedPtr adaptive_read_;
 };
 
 } // namespace Network
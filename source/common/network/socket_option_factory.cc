@@ -4,6 +4,7 @@
 
 #include "common/common/fmt.h"
 #include "common/network/addr_family_aware_socket_option_impl.h"
+#include "common/network/cpu_steering_socket_option_impl.h"
 #include "common/network/socket_option_impl.h"
 
 namespace Envoy {
@@ -132,6 +133,25 @@ std::unique_ptr<Socket::Options> SocketOptionFactory::buildReusePortOptions() {
   return options;
 }
 
+std::unique_ptr<Socket::Options> SocketOptionFactory::buildReusePortCpuSteeringOptions() {
+  std::unique_ptr<Socket::Options> options = std::make_unique<Socket::Options>();
+  options->push_back(std::make_shared<CpuSteeringSocketOptionImpl>());
+  return options;
+}
+
+std::unique_ptr<Socket::Options> SocketOptionFactory::buildBusyPollOptions(uint32_t busy_poll_us,
+                                                                           bool prefer_busy_poll) {
+  std::unique_ptr<Socket::Options> options = std::make_unique<Socket::Options>();
+  options->push_back(std::make_shared<Network::SocketOptionImpl>(
+      envoy::config::core::v3::SocketOption::STATE_PREBIND, ENVOY_SOCKET_SO_BUSY_POLL,
+      busy_poll_us));
+  if (prefer_busy_poll) {
+    options->push_back(std::make_shared<Network::SocketOptionImpl>(
+        envoy::config::core::v3::SocketOption::STATE_PREBIND, ENVOY_SOCKET_SO_PREFER_BUSY_POLL, 1));
+  }
+  return options;
+}
+
 std::unique_ptr<Socket::Options> SocketOptionFactory::buildUdpGroOptions() {
   std::unique_ptr<Socket::Options> options = std::make_unique<Socket::Options>();
   options->push_back(std::make_shared<SocketOptionImpl>(
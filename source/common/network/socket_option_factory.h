@@ -33,6 +33,9 @@ public:
   static std::unique_ptr<Socket::Options> buildIpPacketInfoOptions();
   static std::unique_ptr<Socket::Options> buildRxQueueOverFlowOptions();
   static std::unique_ptr<Socket::Options> buildReusePortOptions();
+  static std::unique_ptr<Socket::Options> buildReusePortCpuSteeringOptions();
+  static std::unique_ptr<Socket::Options> buildBusyPollOptions(uint32_t busy_poll_us,
+                                                               bool prefer_busy_poll);
   static std::unique_ptr<Socket::Options> buildUdpGroOptions();
 };
 } // namespace Network
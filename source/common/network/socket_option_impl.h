@@ -59,6 +59,19 @@ namespace Network {
 #define ENVOY_SOCKET_SO_REUSEPORT Network::SocketOptionName()
 #endif
 
+#ifdef SO_BUSY_POLL
+#define ENVOY_SOCKET_SO_BUSY_POLL ENVOY_MAKE_SOCKET_OPTION_NAME(SOL_SOCKET, SO_BUSY_POLL)
+#else
+#define ENVOY_SOCKET_SO_BUSY_POLL Network::SocketOptionName()
+#endif
+
+#ifdef SO_PREFER_BUSY_POLL
+#define ENVOY_SOCKET_SO_PREFER_BUSY_POLL                                                           \
+  ENVOY_MAKE_SOCKET_OPTION_NAME(SOL_SOCKET, SO_PREFER_BUSY_POLL)
+#else
+#define ENVOY_SOCKET_SO_PREFER_BUSY_POLL Network::SocketOptionName()
+#endif
+
 #ifdef UDP_GRO
 #define ENVOY_SOCKET_UDP_GRO ENVOY_MAKE_SOCKET_OPTION_NAME(SOL_UDP, UDP_GRO)
 #else
@@ -0,0 +1,103 @@
+#include "common/network/splice_pipe.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Network {
+
+#if defined(__linux__)
+
+SplicePipe::SplicePipe(os_fd_t read_fd, os_fd_t write_fd, uint64_t capacity)
+    : read_fd_(read_fd), write_fd_(write_fd), capacity_(capacity) {}
+
+SplicePipe::~SplicePipe() {
+  ::close(read_fd_);
+  ::close(write_fd_);
+}
+
+SplicePipePtr SplicePipe::create() {
+  int fds[2];
+  if (::pipe2(fds, O_NONBLOCK | O_CLOEXEC) != 0) {
+    return nullptr;
+  }
+  const int capacity = ::fcntl(fds[1], F_GETPIPE_SZ);
+  if (capacity <= 0) {
+    ::close(fds[0]);
+    ::close(fds[1]);
+    return nullptr;
+  }
+  return SplicePipePtr{new SplicePipe(fds[0], fds[1], capacity)};
+}
+
+Api::SysCallSizeResult SplicePipe::fill(os_fd_t fd) {
+  ASSERT(length_ < capacity_);
+  const ssize_t rc = ::splice(fd, nullptr, write_fd_, nullptr, capacity_ - length_,
+                              SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+  if (rc < 0) {
+    return {rc, errno};
+  }
+  length_ += rc;
+  return {rc, 0};
+}
+
+Api::SysCallSizeResult SplicePipe::drain(os_fd_t fd) {
+  const ssize_t rc =
+      ::splice(read_fd_, nullptr, fd, nullptr, length_, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+  if (rc < 0) {
+    return {rc, errno};
+  }
+  ASSERT(static_cast<uint64_t>(rc) <= length_);
+  length_ -= rc;
+  return {rc, 0};
+}
+
+void SplicePipe::moveTo(Buffer::Instance& buffer) {
+  while (length_ > 0) {
+    constexpr uint64_t MaxSlices = 2;
+    Buffer::RawSlice slices[MaxSlices];
+    const uint64_t num_slices = buffer.reserve(length_, slices, MaxSlices);
+    struct iovec iov[MaxSlices];
+    for (uint64_t i = 0; i < num_slices; i++) {
+      iov[i].iov_base = slices[i].mem_;
+      iov[i].iov_len = slices[i].len_;
+    }
+    ssize_t rc = ::readv(read_fd_, iov, num_slices);
+    // The bytes are already in the pipe, so the read can only fail if interrupted.
+    RELEASE_ASSERT(rc > 0 || errno == EINTR, "unable to read from splice pipe");
+    uint64_t bytes_to_commit = rc > 0 ? rc : 0;
+    length_ -= bytes_to_commit;
+    for (uint64_t i = 0; i < num_slices; i++) {
+      slices[i].len_ = std::min(slices[i].len_, static_cast<size_t>(bytes_to_commit));
+      bytes_to_commit -= slices[i].len_;
+    }
+    buffer.commit(slices, num_slices);
+  }
+}
+
+#else
+
+SplicePipe::SplicePipe(os_fd_t read_fd, os_fd_t write_fd, uint64_t capacity)
+    : read_fd_(read_fd), write_fd_(write_fd), capacity_(capacity) {}
+
+SplicePipe::~SplicePipe() = default;
+
+SplicePipePtr SplicePipe::create() { return nullptr; }
+
+Api::SysCallSizeResult SplicePipe::fill(os_fd_t) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+Api::SysCallSizeResult SplicePipe::drain(os_fd_t) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+void SplicePipe::moveTo(Buffer::Instance&) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+#endif
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/api/os_sys_calls_common.h"
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/platform.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Network {
+
+class SplicePipe;
+using SplicePipePtr = std::unique_ptr<SplicePipe>;
+
+/**
+ * A non-blocking pipe used to move bytes from one socket to another with splice(2), without
+ * copying them through user space.
+ */
+class SplicePipe : NonCopyable {
+public:
+  ~SplicePipe();
+
+  /**
+   * @return a new pipe, or nullptr if splice(2) is not available on this platform or the pipe
+   *         could not be created.
+   */
+  static SplicePipePtr create();
+
+  /**
+   * Move bytes from a socket into the pipe, up to the free capacity of the pipe.
+   * @param fd supplies the socket to read from.
+   * @return the splice(2) result. A return code of 0 indicates end of stream on the socket.
+   */
+  Api::SysCallSizeResult fill(os_fd_t fd);
+
+  /**
+   * Move as many of the bytes held by the pipe as possible into a socket.
+   * @param fd supplies the socket to write to.
+   * @return the splice(2) result.
+   */
+  Api::SysCallSizeResult drain(os_fd_t fd);
+
+  /**
+   * Read all bytes held by the pipe into a buffer. This is used when the destination socket
+   * cannot accept more data, so that the bytes can be delivered through the regular write path.
+   * @param buffer supplies the buffer to append to.
+   */
+  void moveTo(Buffer::Instance& buffer);
+
+  /**
+   * @return the number of bytes held by the pipe.
+   */
+  uint64_t length() const { return length_; }
+
+private:
+  SplicePipe(os_fd_t read_fd, os_fd_t write_fd, uint64_t capacity);
+
+  const os_fd_t read_fd_;
+  const os_fd_t write_fd_;
+  const uint64_t capacity_;
+  uint64_t length_{0};
+};
+
+} // namespace Network
+} // namespace Envoy
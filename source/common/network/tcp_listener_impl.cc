@@ -5,6 +5,7 @@
 #include "envoy/config/core/v3/base.pb.h"
 #include "envoy/network/exception.h"
 
+#include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/common/fmt.h"
@@ -13,6 +14,7 @@
 #include "common/event/file_event_impl.h"
 #include "common/network/address_impl.h"
 #include "common/network/io_socket_handle_impl.h"
+#include "common/runtime/runtime_features.h"
 
 namespace Envoy {
 namespace Network {
@@ -73,7 +75,7 @@ void TcpListenerImpl::onSocketEvent(short flags) {
     // Get the local address from the new socket if the listener is listening on IP ANY
     // (e.g., 0.0.0.0 for IPv4) (local_address_ is nullptr in this case).
     const Address::InstanceConstSharedPtr& local_address =
-        local_address_ ? local_address_ : io_handle->localAddress();
+        local_address_ ? local_address_ : acceptedLocalAddress(*io_handle);
 
     // The accept() call that filled in remote_addr doesn't fill in more than the sa_family field
     // for Unix domain sockets; apparently there isn't a mechanism in the kernel to get the
@@ -82,18 +84,35 @@ void TcpListenerImpl::onSocketEvent(short flags) {
     // Pass the 'v6only' parameter as true if the local_address is an IPv6 address. This has no
     // effect if the socket is a v4 socket, but for v6 sockets this will create an IPv4 remote
     // address if an IPv4 local_address was created from an IPv6 mapped IPv4 address.
-    const Address::InstanceConstSharedPtr& remote_address =
-        (remote_addr.ss_family == AF_UNIX)
-            ? io_handle->peerAddress()
-            : Address::addressFromSockAddr(remote_addr, remote_addr_len,
-                                           local_address->ip()->version() ==
-                                               Address::IpVersion::v6);
+    Address::InstanceConstSharedPtr remote_address;
+    if (remote_addr.ss_family == AF_UNIX) {
+      remote_address = io_handle->peerAddress();
+    } else {
+      const bool v6only = local_address->ip()->version() == Address::IpVersion::v6;
+      remote_address = address_cache_ != nullptr
+                           ? address_cache_->get(remote_addr, remote_addr_len, v6only)
+                           : Address::addressFromSockAddr(remote_addr, remote_addr_len, v6only);
+    }
 
     cb_.onAccept(
         std::make_unique<AcceptedSocketImpl>(std::move(io_handle), local_address, remote_address));
   }
 }
 
+Address::InstanceConstSharedPtr TcpListenerImpl::acceptedLocalAddress(IoHandle& io_handle) {
+  if (address_cache_ != nullptr) {
+    sockaddr_storage ss;
+    socklen_t ss_len = sizeof(ss);
+    if (Api::OsSysCallsSingleton::get()
+            .getsockname(io_handle.fdDoNotUse(), reinterpret_cast<sockaddr*>(&ss), &ss_len)
+            .rc_ == 0) {
+      return address_cache_->get(ss, ss_len, local_v6only_);
+    }
+  }
+  // Throws the error of getsockname().
+  return io_handle.localAddress();
+}
+
 void TcpListenerImpl::setupServerSocket(Event::DispatcherImpl& dispatcher, Socket& socket) {
   socket.ioHandle().listen(backlog_size_);
 
@@ -118,6 +137,14 @@ TcpListenerImpl::TcpListenerImpl(Event::DispatcherImpl& dispatcher, Random::Rand
   if (bind_to_port) {
     setupServerSocket(dispatcher, *socket_);
   }
+  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.listener_address_cache")) {
+    // Large enough for the peers of a worker which reconnect often, small enough to stay cheap for
+    // the listeners which see few connections.
+    address_cache_ = std::make_unique<Address::InstanceCache>(1024);
+    const Address::Ip* ip = socket_->localAddress()->ip();
+    local_v6only_ =
+        ip == nullptr || ip->version() != Address::IpVersion::v6 || ip->ipv6()->v6only();
+  }
 }
 
 void TcpListenerImpl::enable() { socket_->ioHandle().enableFileEvents(Event::FileReadyType::Read); }
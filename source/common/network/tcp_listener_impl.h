@@ -3,6 +3,8 @@
 #include "envoy/common/random_generator.h"
 #include "envoy/runtime/runtime.h"
 
+#include "common/network/address_impl.h"
+
 #include "absl/strings/string_view.h"
 #include "base_listener_impl.h"
 
@@ -32,6 +34,7 @@ protected:
 
 private:
   void onSocketEvent(short flags);
+  Address::InstanceConstSharedPtr acceptedLocalAddress(IoHandle& io_handle);
 
   // Returns true if global connection limit has been reached and the accepted socket should be
   // rejected/closed. If the accepted socket is to be admitted, false is returned.
@@ -39,6 +42,12 @@ private:
 
   Random::RandomGenerator& random_;
   float reject_fraction_;
+  // The addresses of the accepted connections, shared by the connections from the same peers and
+  // to the same local addresses. Null unless the envoy.reloadable_features.listener_address_cache
+  // runtime feature is enabled.
+  std::unique_ptr<Address::InstanceCache> address_cache_;
+  // The v6only of the local addresses of the accepted connections.
+  bool local_v6only_{true};
 };
 
 } // namespace Network
@@ -0,0 +1,249 @@
+#include "common/network/udp_batch_writer.h"
+
+#include <cstring>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+#include "common/common/utility.h"
+#include "common/network/address_impl.h"
+#include "common/network/io_socket_error_impl.h"
+
+#include "absl/container/fixed_array.h"
+
+namespace Envoy {
+namespace Network {
+
+namespace {
+
+// The largest UDP payload that fits in an IPv4 datagram, and the most segments the kernel accepts
+// in a single GSO send.
+constexpr uint64_t MaxUdpPayloadSize = 65507;
+constexpr uint32_t MaxGsoSegments = 64;
+
+// Room for the source address and the segment size of one message.
+constexpr size_t ControlSpace = CMSG_SPACE(sizeof(in6_pktinfo)) + CMSG_SPACE(sizeof(uint16_t));
+
+struct MessageControl {
+  char buffer_[ControlSpace];
+};
+
+Api::IoCallUint64Result ioResultAgain() {
+  return Api::IoCallUint64Result(
+      /*rc=*/0, Api::IoErrorPtr(IoSocketError::getIoSocketEagainInstance(),
+                                IoSocketError::deleteIoError));
+}
+
+// Fills in the ancillary data carrying the source address and, if segment_size is set, the GSO
+// segment size of a message.
+void setMessageControl(msghdr& message, MessageControl& control,
+                       const absl::optional<Address::IpVersion>& local_ip_version,
+                       const absl::uint128& local_ip, uint16_t segment_size) {
+  memset(control.buffer_, 0, sizeof(control.buffer_));
+  message.msg_control = control.buffer_;
+  message.msg_controllen = sizeof(control.buffer_);
+  size_t control_length = 0;
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  if (local_ip_version.has_value()) {
+    if (local_ip_version.value() == Address::IpVersion::v4) {
+      cmsg->cmsg_level = IPPROTO_IP;
+#ifndef IP_SENDSRCADDR
+      cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
+      cmsg->cmsg_type = IP_PKTINFO;
+      auto pktinfo = reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg));
+      pktinfo->ipi_ifindex = 0;
+#ifdef WIN32
+      pktinfo->ipi_addr.s_addr = absl::Uint128Low64(local_ip);
+#else
+      pktinfo->ipi_spec_dst.s_addr = absl::Uint128Low64(local_ip);
+#endif
+      control_length += CMSG_SPACE(sizeof(in_pktinfo));
+#else
+      cmsg->cmsg_type = IP_SENDSRCADDR;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(in_addr));
+      reinterpret_cast<in_addr*>(CMSG_DATA(cmsg))->s_addr = absl::Uint128Low64(local_ip);
+      control_length += CMSG_SPACE(sizeof(in_addr));
+#endif
+    } else {
+      cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
+      cmsg->cmsg_level = IPPROTO_IPV6;
+      cmsg->cmsg_type = IPV6_PKTINFO;
+      auto pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
+      pktinfo->ipi6_ifindex = 0;
+      memcpy(pktinfo->ipi6_addr.s6_addr, &local_ip, sizeof(local_ip));
+      control_length += CMSG_SPACE(sizeof(in6_pktinfo));
+    }
+    cmsg = CMSG_NXTHDR(&message, cmsg);
+  }
+#ifdef UDP_SEGMENT
+  if (segment_size != 0) {
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+    control_length += CMSG_SPACE(sizeof(uint16_t));
+  }
+#else
+  UNREFERENCED_PARAMETER(segment_size);
+#endif
+  message.msg_controllen = control_length;
+  if (control_length == 0) {
+    message.msg_control = nullptr;
+  }
+}
+
+} // namespace
+
+UdpBatchWriter::UdpBatchWriter(IoHandle& io_handle)
+    : io_handle_(io_handle), gso_supported_(Api::OsSysCallsSingleton::get().supportsUdpGso()) {
+  packets_.reserve(MaxBatchPackets);
+}
+
+Api::IoCallUint64Result UdpBatchWriter::writePacket(const Buffer::Instance& buffer,
+                                                    const Address::Ip* local_ip,
+                                                    const Address::Instance& peer_address) {
+  const auto* address_base = dynamic_cast<const Address::InstanceBase*>(&peer_address);
+  const sockaddr* sock_addr = address_base != nullptr ? address_base->sockAddr() : nullptr;
+  if (sock_addr == nullptr) {
+    // Unlikely to happen unless the wrong peer address is passed.
+    return IoSocketError::ioResultSocketInvalidAddress();
+  }
+
+  const uint64_t length = buffer.length();
+  if (!write_blocked_ &&
+      (packets_.size() == MaxBatchPackets || payloads_.size() + length > MaxBatchBytes)) {
+    flush();
+  }
+  if (write_blocked_) {
+    return ioResultAgain();
+  }
+
+  QueuedPacket& packet = packets_.emplace_back();
+  packet.offset_ = payloads_.size();
+  packet.length_ = length;
+  packet.peer_address_length_ = address_base->sockAddrLen();
+  memcpy(&packet.peer_address_, sock_addr, packet.peer_address_length_);
+  if (local_ip != nullptr) {
+    packet.local_ip_version_ = local_ip->version();
+    packet.local_ip_ = local_ip->version() == Address::IpVersion::v4
+                           ? absl::uint128(local_ip->ipv4()->address())
+                           : local_ip->ipv6()->address();
+  }
+  payloads_.resize(packet.offset_ + length);
+  buffer.copyOut(0, length, payloads_.data() + packet.offset_);
+
+  return Api::IoCallUint64Result(length, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
+}
+
+Api::IoCallUint64Result UdpBatchWriter::flush() {
+  if (write_blocked_) {
+    return ioResultAgain();
+  }
+  if (packets_.empty()) {
+    return Api::IoCallUint64Result(0, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
+  }
+
+  // Build one message per run of datagrams that can be sent together.
+  const uint32_t num_packets = packets_.size();
+  absl::FixedArray<mmsghdr> messages(num_packets);
+  absl::FixedArray<iovec> iov(num_packets);
+  absl::FixedArray<MessageControl> control(num_packets);
+  absl::FixedArray<uint32_t> packets_per_message(num_packets);
+  uint32_t num_messages = 0;
+  for (uint32_t first = 0; first < num_packets;) {
+    const QueuedPacket& head = packets_[first];
+    uint32_t last = first + 1;
+    uint64_t bytes = head.length_;
+    if (gso_supported_ && head.length_ > 0 && head.length_ <= UdpMaxOutgoingPacketSize) {
+      // All segments but the last one must have the size of the first.
+      while (last < num_packets && last - first < MaxGsoSegments &&
+             packets_[last - 1].length_ == head.length_) {
+        const QueuedPacket& packet = packets_[last];
+        if (packet.length_ == 0 || packet.length_ > head.length_ ||
+            bytes + packet.length_ > MaxUdpPayloadSize ||
+            packet.peer_address_length_ != head.peer_address_length_ ||
+            memcmp(&packet.peer_address_, &head.peer_address_, head.peer_address_length_) != 0 ||
+            packet.local_ip_version_ != head.local_ip_version_ ||
+            (head.local_ip_version_.has_value() && packet.local_ip_ != head.local_ip_)) {
+          break;
+        }
+        bytes += packet.length_;
+        last++;
+      }
+    }
+
+    // Payloads are stored back to back, so a run of datagrams is contiguous.
+    iov[num_messages].iov_base = payloads_.data() + head.offset_;
+    iov[num_messages].iov_len = bytes;
+    msghdr& message = messages[num_messages].msg_hdr;
+    memset(&message, 0, sizeof(message));
+    message.msg_name = const_cast<sockaddr_storage*>(&head.peer_address_);
+    message.msg_namelen = head.peer_address_length_;
+    message.msg_iov = &iov[num_messages];
+    message.msg_iovlen = 1;
+    setMessageControl(message, control[num_messages], head.local_ip_version_, head.local_ip_,
+                      last - first > 1 ? head.length_ : 0);
+    messages[num_messages].msg_len = 0;
+    packets_per_message[num_messages] = last - first;
+    num_messages++;
+    first = last;
+  }
+
+  auto& os_syscalls = Api::OsSysCallsSingleton::get();
+  uint32_t sent_messages = 0;
+  uint32_t sent_packets = 0;
+  uint64_t sent_bytes = 0;
+  int send_errno = 0;
+  while (sent_messages < num_messages) {
+    const Api::SysCallIntResult result =
+        os_syscalls.sendmmsg(io_handle_.fdDoNotUse(), &messages[sent_messages],
+                             num_messages - sent_messages, 0);
+    if (result.rc_ > 0) {
+      for (int i = 0; i < result.rc_; i++) {
+        sent_packets += packets_per_message[sent_messages];
+        sent_bytes += messages[sent_messages].msg_len;
+        sent_messages++;
+      }
+    } else if (result.errno_ == SOCKET_ERROR_AGAIN) {
+      write_blocked_ = true;
+      break;
+    } else {
+      // The first message cannot be sent, e.g. because its destination is unreachable. Drop it and
+      // carry on with the rest, as sending the datagrams one by one would have.
+      ENVOY_LOG(debug, "sendmmsg failed to send {} datagrams: {}",
+                packets_per_message[sent_messages], errorDetails(result.errno_));
+      send_errno = result.errno_;
+      sent_packets += packets_per_message[sent_messages];
+      sent_messages++;
+    }
+  }
+  dequeue(sent_packets);
+
+  ENVOY_LOG(trace, "flushed {} bytes in {} messages, {} datagrams still queued", sent_bytes,
+            sent_messages, packets_.size());
+  if (write_blocked_) {
+    return ioResultAgain();
+  }
+  if (send_errno != 0) {
+    return Api::IoCallUint64Result(
+        sent_bytes, Api::IoErrorPtr(new IoSocketError(send_errno), IoSocketError::deleteIoError));
+  }
+  return Api::IoCallUint64Result(sent_bytes,
+                                 Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
+}
+
+void UdpBatchWriter::dequeue(uint32_t num_packets) {
+  if (num_packets == packets_.size()) {
+    packets_.clear();
+    payloads_.clear();
+    return;
+  }
+  const uint64_t offset = packets_[num_packets].offset_;
+  payloads_.erase(payloads_.begin(), payloads_.begin() + offset);
+  packets_.erase(packets_.begin(), packets_.begin() + num_packets);
+  for (QueuedPacket& packet : packets_) {
+    packet.offset_ -= offset;
+  }
+}
+
+} // namespace Network
+} // namespace Envoy
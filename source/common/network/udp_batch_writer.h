@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "envoy/common/platform.h"
+#include "envoy/network/io_handle.h"
+#include "envoy/network/udp_packet_writer_handler.h"
+
+#include "common/common/logger.h"
+
+#include "absl/numeric/int128.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * UdpPacketWriter that queues the datagrams written to it and sends them with as few
+ * sendmmsg(2) calls as possible when flushed. Consecutive datagrams of the same size going from
+ * the same local IP to the same peer are coalesced into a single message sent with UDP generic
+ * segmentation offload (GSO) where the platform supports it.
+ *
+ * The writer does not flush by itself until its queue is full. Callers are expected to flush it
+ * once they are done writing, typically at the end of the current dispatcher loop iteration.
+ */
+class UdpBatchWriter : public UdpPacketWriter, Logger::Loggable<Logger::Id::udp> {
+public:
+  // The maximum number of datagrams and bytes queued before the writer flushes by itself.
+  static constexpr uint32_t MaxBatchPackets = 64;
+  static constexpr uint64_t MaxBatchBytes = 64 * 1024;
+
+  UdpBatchWriter(IoHandle& io_handle);
+
+  // Network::UdpPacketWriter
+  Api::IoCallUint64Result writePacket(const Buffer::Instance& buffer, const Address::Ip* local_ip,
+                                      const Address::Instance& peer_address) override;
+  bool isWriteBlocked() const override { return write_blocked_; }
+  void setWritable() override { write_blocked_ = false; }
+  uint64_t getMaxPacketSize(const Address::Instance& /*peer_address*/) const override {
+    return UdpMaxOutgoingPacketSize;
+  }
+  bool isBatchMode() const override { return true; }
+  UdpPacketWriterBuffer getNextWriteLocation(const Address::Ip* /*local_ip*/,
+                                             const Address::Instance& /*peer_address*/) override {
+    return {nullptr, 0, nullptr};
+  }
+  Api::IoCallUint64Result flush() override;
+
+  /**
+   * @return the number of datagrams waiting to be flushed.
+   */
+  uint32_t queuedPackets() const { return packets_.size(); }
+
+private:
+  struct QueuedPacket {
+    uint64_t offset_;
+    uint64_t length_;
+    sockaddr_storage peer_address_;
+    socklen_t peer_address_length_;
+    // Only set if a local IP was supplied to writePacket().
+    absl::optional<Address::IpVersion> local_ip_version_;
+    absl::uint128 local_ip_;
+  };
+
+  // Drops the first num_packets packets from the queue.
+  void dequeue(uint32_t num_packets);
+
+  IoHandle& io_handle_;
+  const bool gso_supported_;
+  bool write_blocked_{false};
+  // Datagram payloads, back to back in the order they were written.
+  std::vector<uint8_t> payloads_;
+  std::vector<QueuedPacket> packets_;
+};
+
+} // namespace Network
+} // namespace Envoy
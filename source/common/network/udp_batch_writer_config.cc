@@ -0,0 +1,37 @@
+#include "common/network/udp_batch_writer_config.h"
+
+#include <memory>
+#include <string>
+
+#include "envoy/config/listener/v3/udp_batch_writer_config.pb.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/network/udp_batch_writer.h"
+#include "common/network/udp_packet_writer_handler_impl.h"
+
+namespace Envoy {
+namespace Network {
+
+UdpPacketWriterPtr UdpBatchWriterFactory::createUdpPacketWriter(Network::IoHandle& io_handle,
+                                                                Stats::Scope& /*scope*/) {
+  if (!Api::OsSysCallsSingleton::get().supportsMmsg()) {
+    return std::make_unique<UdpDefaultWriter>(io_handle);
+  }
+  return std::make_unique<UdpBatchWriter>(io_handle);
+}
+
+ProtobufTypes::MessagePtr UdpBatchWriterConfigFactory::createEmptyConfigProto() {
+  return std::make_unique<envoy::config::listener::v3::UdpBatchWriterOptions>();
+}
+
+UdpPacketWriterFactoryPtr
+UdpBatchWriterConfigFactory::createUdpPacketWriterFactory(const Protobuf::Message& /*message*/) {
+  return std::make_unique<UdpBatchWriterFactory>();
+}
+
+std::string UdpBatchWriterConfigFactory::name() const { return "udp_batch_writer"; }
+
+REGISTER_FACTORY(UdpBatchWriterConfigFactory, Network::UdpPacketWriterConfigFactory);
+
+} // namespace Network
+} // namespace Envoy
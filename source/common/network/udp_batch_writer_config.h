@@ -0,0 +1,32 @@
+#pragma once
+
+#include "envoy/network/udp_packet_writer_config.h"
+#include "envoy/network/udp_packet_writer_handler.h"
+#include "envoy/registry/registry.h"
+
+namespace Envoy {
+namespace Network {
+
+// Creates UdpBatchWriter, or UdpDefaultWriter on platforms without sendmmsg().
+class UdpBatchWriterFactory : public Network::UdpPacketWriterFactory {
+public:
+  Network::UdpPacketWriterPtr createUdpPacketWriter(Network::IoHandle& io_handle,
+                                                    Stats::Scope& scope) override;
+};
+
+// UdpPacketWriterConfigFactory to create UdpBatchWriterFactory based on given protobuf.
+class UdpBatchWriterConfigFactory : public UdpPacketWriterConfigFactory {
+public:
+  // UdpPacketWriterConfigFactory
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override;
+
+  Network::UdpPacketWriterFactoryPtr
+  createUdpPacketWriterFactory(const Protobuf::Message&) override;
+
+  std::string name() const override;
+};
+
+DECLARE_FACTORY(UdpBatchWriterConfigFactory);
+
+} // namespace Network
+} // namespace Envoy
@@ -106,8 +106,19 @@ Api::IoCallUint64Result UdpListenerImpl::send(const UdpSendData& send_data) {
   ENVOY_UDP_LOG(trace, "send");
   Buffer::Instance& buffer = send_data.buffer_;
 
+  UdpPacketWriter& writer = cb_.udpPacketWriter();
   Api::IoCallUint64Result send_result =
-      cb_.udpPacketWriter().writePacket(buffer, send_data.local_ip_, send_data.peer_address_);
+      writer.writePacket(buffer, send_data.local_ip_, send_data.peer_address_);
+  if (writer.isBatchMode()) {
+    // Datagrams sent while handling this loop iteration's events go out together once they have
+    // all been written.
+    if (flush_cb_ == nullptr) {
+      flush_cb_ = dispatcher_.createSchedulableCallback([this]() { flush(); });
+    }
+    if (!flush_cb_->enabled()) {
+      flush_cb_->scheduleCallbackCurrentIteration();
+    }
+  }
 
   // The send_result normalizes the rc_ value to 0 in error conditions.
   // The drain call is hence 'safe' in success and failure cases.
@@ -3,6 +3,7 @@
 #include <atomic>
 
 #include "envoy/common/time.h"
+#include "envoy/event/schedulable_cb.h"
 
 #include "common/buffer/buffer_impl.h"
 #include "common/event/event_impl_base.h"
@@ -60,6 +61,8 @@ private:
   void disableEvent();
 
   TimeSource& time_source_;
+  // Flushes a batching packet writer at the end of the loop iteration; created on first use.
+  Event::SchedulableCallbackPtr flush_cb_;
 };
 
 class UdpListenerWorkerRouterImpl : public UdpListenerWorkerRouter {
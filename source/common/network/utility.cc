@@ -119,6 +119,26 @@ Api::IoCallUint64Result receiveMessage(uint64_t max_packet_size, Buffer::Instanc
   return result;
 }
 
+/**
+ * One datagram of a read coalesced by UDP GRO. The datagrams reference the memory of the read,
+ * which is freed once the last of them has been released.
+ */
+class GroDatagramFragment : public Buffer::BufferFragment {
+public:
+  GroDatagramFragment(std::shared_ptr<uint8_t[]> storage, uint64_t offset, uint64_t size)
+      : storage_(std::move(storage)), data_(storage_.get() + offset), size_(size) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return data_; }
+  size_t size() const override { return size_; }
+  void done() override { delete this; }
+
+private:
+  const std::shared_ptr<uint8_t[]> storage_;
+  const uint8_t* const data_;
+  const size_t size_;
+};
+
 } // namespace
 
 std::string Utility::hostFromTcpUrl(const std::string& url) {
@@ -582,14 +602,15 @@ Api::IoCallUint64Result Utility::readFromSocket(IoHandle& handle,
                                                 uint32_t* packets_dropped) {
 
   if (handle.supportsUdpGro()) {
-    Buffer::InstancePtr buffer = std::make_unique<Buffer::OwnedImpl>();
     IoHandle::RecvMsgOutput output(1, packets_dropped);
 
     // TODO(yugant): Avoid allocating 24k for each read by getting memory from UdpPacketProcessor
     const uint64_t max_packet_size_with_gro = 16 * udp_packet_processor.maxPacketSize();
+    std::shared_ptr<uint8_t[]> storage(new uint8_t[max_packet_size_with_gro]);
+    Buffer::RawSlice slice{storage.get(), max_packet_size_with_gro};
 
     Api::IoCallUint64Result result =
-        receiveMessage(max_packet_size_with_gro, buffer, output, handle, local_address);
+        handle.recvmsg(&slice, 1, local_address.ip()->port(), output);
 
     if (!result.ok()) {
       return result;
@@ -598,22 +619,23 @@ Api::IoCallUint64Result Utility::readFromSocket(IoHandle& handle,
     const uint64_t gso_size = output.msg_[0].gso_size_;
     ENVOY_LOG_MISC(trace, "recvmsg bytes {} with gso_size as {}", result.rc_, gso_size);
 
-    // Skip gso segmentation and proceed as a single payload.
-    if (gso_size == 0u) {
-      passPayloadToProcessor(result.rc_, std::move(buffer), std::move(output.msg_[0].peer_address_),
-                             std::move(output.msg_[0].local_address_), udp_packet_processor,
-                             receive_time);
-      return result;
-    }
-
-    // Segment the buffer read by the recvmsg syscall into gso_sized sub buffers.
-    while (buffer->length() > 0) {
-      const uint64_t bytes_to_copy = std::min(buffer->length(), gso_size);
-      Buffer::InstancePtr sub_buffer = std::make_unique<Buffer::OwnedImpl>();
-      sub_buffer->move(*buffer, bytes_to_copy);
-      passPayloadToProcessor(bytes_to_copy, std::move(sub_buffer), output.msg_[0].peer_address_,
+    // Without gso segmentation the read is a single payload.
+    const uint64_t bytes_read = std::min<uint64_t>(result.rc_, max_packet_size_with_gro);
+    const uint64_t segment_size = gso_size == 0u ? bytes_read : gso_size;
+
+    // Hand out each gso_sized segment of the read as a buffer referencing its memory, rather than
+    // copying it out.
+    uint64_t offset = 0;
+    do {
+      const uint64_t segment_length = std::min(bytes_read - offset, segment_size);
+      Buffer::InstancePtr buffer = std::make_unique<Buffer::OwnedImpl>();
+      if (segment_length > 0) {
+        buffer->addBufferFragment(*new GroDatagramFragment(storage, offset, segment_length));
+      }
+      offset += segment_length;
+      passPayloadToProcessor(segment_length, std::move(buffer), output.msg_[0].peer_address_,
                              output.msg_[0].local_address_, udp_packet_processor, receive_time);
-    }
+    } while (offset < bytes_read);
 
     return result;
   }
@@ -0,0 +1,258 @@
+#include "common/profiler/sampling_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/lock_guard.h"
+#include "common/common/macros.h"
+#include "common/common/thread.h"
+#include "common/profiler/profiler.h"
+#include "common/profiler/signal_stack_sampler.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+
+#ifdef __linux__
+#include <sys/prctl.h>
+#include <sys/time.h>
+#endif
+
+namespace Envoy {
+namespace Profiler {
+namespace {
+
+// A sample written by the SIGPROF handler, which any thread may run, and read by the admin thread
+// while the handler may be rewriting it. The sequence is 0 while the sample is written, and the
+// index of the sample plus 1 once it is, so that a reader drops a sample whose sequence changed
+// while it read it. The fields are atomics, accessed relaxed, only so that the reads racing with
+// the writes are well defined.
+struct Sample {
+  std::atomic<uint64_t> sequence_{};
+  std::atomic<int64_t> time_ns_{};
+  // The name of the thread, as the 16 bytes of prctl(PR_GET_NAME).
+  std::atomic<uint64_t> thread_name_[2]{};
+  std::atomic<uint32_t> depth_{};
+  std::atomic<void*> frames_[SamplingProfiler::MaxStackDepth]{};
+};
+
+// The samples are allocated on the first start and never freed, as a handler may still be running
+// on another thread when sampling stops.
+std::atomic<Sample*> samples{};
+std::atomic<uint64_t> next_sample{};
+std::atomic<bool> sampling{};
+std::atomic<uint32_t> sampling_frequency{};
+
+#ifdef __linux__
+Thread::MutexBasicLockable& controlMutex() {
+  MUTABLE_CONSTRUCT_ON_FIRST_USE(Thread::MutexBasicLockable);
+}
+
+int64_t monotonicNanoseconds() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+// Only calls async-signal-safe functions.
+void sampleStack(void* const* frames, int depth) {
+  if (!sampling.load(std::memory_order_acquire)) {
+    return;
+  }
+  depth = std::min<int>(depth, SamplingProfiler::MaxStackDepth);
+  const uint64_t index = next_sample.fetch_add(1, std::memory_order_relaxed);
+  Sample& sample = samples.load(std::memory_order_acquire)[index % SamplingProfiler::Capacity];
+  sample.sequence_.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  sample.time_ns_.store(monotonicNanoseconds(), std::memory_order_relaxed);
+  uint64_t thread_name[2]{};
+  prctl(PR_GET_NAME, reinterpret_cast<char*>(thread_name));
+  sample.thread_name_[0].store(thread_name[0], std::memory_order_relaxed);
+  sample.thread_name_[1].store(thread_name[1], std::memory_order_relaxed);
+  sample.depth_.store(depth, std::memory_order_relaxed);
+  for (int i = 0; i < depth; ++i) {
+    sample.frames_[i].store(frames[i], std::memory_order_relaxed);
+  }
+  sample.sequence_.store(index + 1, std::memory_order_release);
+}
+
+bool setTimer(uint32_t frequency) {
+  struct itimerval timer {};
+  if (frequency > 0) {
+    timer.it_interval.tv_usec = 1000000 / frequency;
+    timer.it_value = timer.it_interval;
+  }
+  return setitimer(ITIMER_PROF, &timer, nullptr) == 0;
+}
+
+std::string memoryMappings() {
+  std::ifstream maps("/proc/self/maps");
+  std::stringstream mappings;
+  mappings << maps.rdbuf();
+  return mappings.str();
+}
+#endif
+
+} // namespace
+
+bool SamplingProfiler::start(uint32_t frequency) {
+#ifdef __linux__
+  Thread::LockGuard guard(controlMutex());
+  if (frequency == 0 || frequency > MaxFrequency || sampling.load() || Cpu::profilerEnabled()) {
+    return false;
+  }
+  if (samples.load() == nullptr) {
+    samples.store(new Sample[Capacity]);
+  }
+  Sample* ring = samples.load();
+  for (uint32_t i = 0; i < Capacity; ++i) {
+    ring[i].sequence_.store(0);
+  }
+  next_sample.store(0);
+
+  // The handler is installed on every start, as the gperftools CPU profiler replaces it.
+  if (!SignalStackSampler::install(SIGPROF, sampleStack)) {
+    return false;
+  }
+  sampling.store(true);
+  sampling_frequency.store(frequency);
+  if (!setTimer(frequency)) {
+    sampling.store(false);
+    return false;
+  }
+  return true;
+#else
+  UNREFERENCED_PARAMETER(frequency);
+  return false;
+#endif
+}
+
+void SamplingProfiler::stop() {
+#ifdef __linux__
+  Thread::LockGuard guard(controlMutex());
+  if (!sampling.load()) {
+    return;
+  }
+  setTimer(0);
+  // The handler stays installed, ignoring the signals still pending, since the default action of
+  // SIGPROF terminates the process.
+  sampling.store(false);
+#endif
+}
+
+bool SamplingProfiler::running() { return sampling.load(); }
+
+uint32_t SamplingProfiler::frequency() { return sampling_frequency.load(); }
+
+std::vector<SamplingProfiler::Stack> SamplingProfiler::stacks(std::chrono::milliseconds window,
+                                                              const std::string& thread_name) {
+  std::vector<Stack> stacks;
+#ifdef __linux__
+  const Sample* ring = samples.load(std::memory_order_acquire);
+  if (ring == nullptr) {
+    return stacks;
+  }
+  const int64_t since =
+      window.count() > 0
+          ? monotonicNanoseconds() - std::chrono::nanoseconds(window).count()
+          : std::numeric_limits<int64_t>::min();
+
+  absl::flat_hash_map<std::pair<std::string, std::vector<void*>>, uint64_t> counts;
+  std::vector<void*> frames;
+  for (uint32_t i = 0; i < Capacity; ++i) {
+    const Sample& sample = ring[i];
+    const uint64_t sequence = sample.sequence_.load(std::memory_order_acquire);
+    if (sequence == 0) {
+      continue;
+    }
+    const int64_t time_ns = sample.time_ns_.load(std::memory_order_relaxed);
+    const uint64_t name[2] = {sample.thread_name_[0].load(std::memory_order_relaxed),
+                              sample.thread_name_[1].load(std::memory_order_relaxed)};
+    const uint32_t depth = std::min(sample.depth_.load(std::memory_order_relaxed), MaxStackDepth);
+    frames.resize(depth);
+    for (uint32_t j = 0; j < depth; ++j) {
+      frames[j] = sample.frames_[j].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sample.sequence_.load(std::memory_order_relaxed) != sequence || time_ns < since) {
+      continue;
+    }
+
+    // The name is at most 15 bytes, followed by a null byte.
+    std::string sample_thread_name(reinterpret_cast<const char*>(name),
+                                   strnlen(reinterpret_cast<const char*>(name), sizeof(name)));
+    if (!thread_name.empty() && sample_thread_name != thread_name) {
+      continue;
+    }
+    ++counts[std::make_pair(std::move(sample_thread_name), frames)];
+  }
+
+  stacks.reserve(counts.size());
+  for (auto& count : counts) {
+    stacks.push_back({count.first.first, count.first.second, count.second});
+  }
+#else
+  UNREFERENCED_PARAMETER(window);
+  UNREFERENCED_PARAMETER(thread_name);
+#endif
+  return stacks;
+}
+
+std::string SamplingProfiler::collapsed(const std::vector<Stack>& stacks) {
+  absl::flat_hash_map<void*, std::string> symbols;
+  std::string output;
+  for (const Stack& stack : stacks) {
+    absl::StrAppend(&output, stack.thread_name_);
+    for (auto frame = stack.frames_.rbegin(); frame != stack.frames_.rend(); ++frame) {
+      auto symbol = symbols.find(*frame);
+      if (symbol == symbols.end()) {
+        symbol = symbols
+                     .emplace(*frame, SignalStackSampler::symbolize(*frame).value_or(
+                                          fmt::format("[{}]", *frame)))
+                     .first;
+      }
+      absl::StrAppend(&output, ";", symbol->second);
+    }
+    absl::StrAppend(&output, " ", stack.count_, "\n");
+  }
+  return output;
+}
+
+std::string SamplingProfiler::pprof(const std::vector<Stack>& stacks, uint32_t frequency) {
+  std::string output;
+  const auto append_word = [&output](uintptr_t word) {
+    output.append(reinterpret_cast<const char*>(&word), sizeof(word));
+  };
+  // The header: the header count, the number of header words, the format version, the sampling
+  // period in microseconds and padding.
+  append_word(0);
+  append_word(3);
+  append_word(0);
+  append_word(frequency > 0 ? 1000000 / frequency : 0);
+  append_word(0);
+  for (const Stack& stack : stacks) {
+    append_word(stack.count_);
+    append_word(stack.frames_.size());
+    for (void* frame : stack.frames_) {
+      append_word(reinterpret_cast<uintptr_t>(frame));
+    }
+  }
+  // The trailer, followed by the memory mappings which pprof symbolizes the addresses with.
+  append_word(0);
+  append_word(1);
+  append_word(0);
+#ifdef __linux__
+  output.append(memoryMappings());
+#endif
+  return output;
+}
+
+} // namespace Profiler
+} // namespace Envoy
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Envoy {
+namespace Profiler {
+
+/**
+ * Process wide continuous CPU profiling, cheap enough to be left on in production. A SIGPROF timer
+ * fires every 1/frequency seconds of CPU time used by the process, and its handler records the
+ * stack of the thread it interrupts, along with the thread, into a fixed ring of samples. The ring
+ * keeps the most recent samples only, so that the stacks of a rolling window of the load can be
+ * aggregated at any time. SIGPROF is also used by the gperftools CPU profiler, so the two are never
+ * running at the same time. Sampling is only supported on Linux.
+ */
+class SamplingProfiler {
+public:
+  // The number of samples kept, the oldest ones being overwritten first.
+  static constexpr uint32_t Capacity = 16384;
+  static constexpr uint32_t MaxStackDepth = 32;
+  static constexpr uint32_t DefaultFrequency = 19;
+  static constexpr uint32_t MaxFrequency = 1000;
+
+  // The samples of a stack on a thread.
+  struct Stack {
+    std::string thread_name_;
+    // The frames, innermost first.
+    std::vector<void*> frames_;
+    uint64_t count_;
+  };
+
+  /**
+   * Starts sampling, dropping the samples of the previous run.
+   * @param frequency supplies the number of samples per second of CPU time, between 1 and
+   *        MaxFrequency.
+   * @return bool whether sampling started, false if it is already running, if the gperftools CPU
+   *         profiler is running or if sampling is not supported.
+   */
+  static bool start(uint32_t frequency);
+
+  /**
+   * Stops sampling. The samples are kept until the next start.
+   */
+  static void stop();
+
+  /**
+   * @return whether sampling is running.
+   */
+  static bool running();
+
+  /**
+   * @return the frequency of the last run, or 0 if sampling never ran.
+   */
+  static uint32_t frequency();
+
+  /**
+   * Aggregates the samples of a window.
+   * @param window supplies how far back to aggregate the samples, all of the samples kept if 0.
+   * @param thread_name supplies the thread whose samples are aggregated, all threads if empty.
+   * @return the stacks sampled in the window, with their number of samples.
+   */
+  static std::vector<Stack> stacks(std::chrono::milliseconds window,
+                                   const std::string& thread_name);
+
+  /**
+   * @return the stacks in the collapsed format of flamegraph.pl, one stack per line with the
+   *         thread name as the outermost frame and the number of samples at the end.
+   */
+  static std::string collapsed(const std::vector<Stack>& stacks);
+
+  /**
+   * @return the stacks in the legacy binary CPU profile format of gperftools, which pprof reads.
+   */
+  static std::string pprof(const std::vector<Stack>& stacks, uint32_t frequency);
+};
+
+} // namespace Profiler
+} // namespace Envoy
@@ -0,0 +1,87 @@
+#include "common/profiler/signal_stack_sampler.h"
+
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+
+#include "absl/debugging/stacktrace.h"
+#include "absl/debugging/symbolize.h"
+
+#ifdef __linux__
+#include <ucontext.h>
+#endif
+
+namespace Envoy {
+namespace Profiler {
+namespace {
+
+#ifdef __linux__
+std::atomic<SignalStackSampler::Callback> callbacks[NSIG];
+
+// Returns the program counter at which the signal interrupted the thread, which
+// absl::GetStackTraceWithContext() leaves out as it only walks the frames of the callers.
+void* interruptedPc(const void* context) {
+  const auto* ucontext = static_cast<const ucontext_t*>(context);
+#if defined(__x86_64__)
+  return reinterpret_cast<void*>(ucontext->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__aarch64__)
+  return reinterpret_cast<void*>(ucontext->uc_mcontext.pc);
+#else
+  UNREFERENCED_PARAMETER(ucontext);
+  return nullptr;
+#endif
+}
+
+// Only calls async-signal-safe functions.
+void signalHandler(int signal, siginfo_t*, void* context) {
+  const SignalStackSampler::Callback callback = callbacks[signal].load(std::memory_order_acquire);
+  if (callback == nullptr) {
+    return;
+  }
+  const int saved_errno = errno;
+  void* frames[SignalStackSampler::MaxStackDepth];
+  int depth = 0;
+  void* pc = interruptedPc(context);
+  if (pc != nullptr) {
+    frames[depth++] = pc;
+  }
+  // Skips the frame of the handler.
+  depth += absl::GetStackTraceWithContext(frames + depth, SignalStackSampler::MaxStackDepth - depth,
+                                          /* skip_count = */ 1, context,
+                                          /* min_dropped_frames = */ nullptr);
+  callback(frames, depth);
+  errno = saved_errno;
+}
+#endif
+
+} // namespace
+
+bool SignalStackSampler::install(int signal, Callback callback) {
+#ifdef __linux__
+  ASSERT(signal > 0 && signal < NSIG);
+  callbacks[signal].store(callback, std::memory_order_release);
+  struct sigaction action {};
+  action.sa_sigaction = signalHandler;
+  action.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  return sigaction(signal, &action, nullptr) == 0;
+#else
+  UNREFERENCED_PARAMETER(signal);
+  UNREFERENCED_PARAMETER(callback);
+  return false;
+#endif
+}
+
+absl::optional<std::string> SignalStackSampler::symbolize(void* frame) {
+  char symbol[1024];
+  if (!absl::Symbolize(frame, symbol, sizeof(symbol))) {
+    return absl::nullopt;
+  }
+  return std::string(symbol);
+}
+
+} // namespace Profiler
+} // namespace Envoy
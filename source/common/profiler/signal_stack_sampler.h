@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Profiler {
+
+/**
+ * Captures the stack of the threads that a signal interrupts, for the profilers that sample stacks
+ * from a signal handler. The handler of the signal captures the stack of the interrupted thread,
+ * starting with the instruction it was interrupted at, and hands it over to the callback of the
+ * signal on that thread. Capturing stacks is only supported on Linux.
+ */
+class SignalStackSampler {
+public:
+  // The number of frames captured at most.
+  static constexpr int MaxStackDepth = 64;
+
+  /**
+   * Receives the stack of the interrupted thread, on that thread, from the signal handler. It may
+   * only call async-signal-safe functions, and the frames are only valid until it returns.
+   * @param frames supplies the frames, innermost first.
+   * @param depth supplies the number of frames.
+   */
+  using Callback = void (*)(void* const* frames, int depth);
+
+  /**
+   * Installs the handler of a signal, replacing the handler installed by anyone else, and sets the
+   * callback that the stacks are handed over to.
+   * @param signal supplies the signal to handle.
+   * @param callback supplies the callback of the signal.
+   * @return bool whether the handler was installed, false if capturing stacks is not supported.
+   */
+  static bool install(int signal, Callback callback);
+
+  /**
+   * Symbolizes a frame out of the signal handler, as symbolizing may allocate.
+   * @param frame supplies a frame captured by the handler.
+   * @return the name of the function of the frame, or absl::nullopt if it is unknown.
+   */
+  static absl::optional<std::string> symbolize(void* frame);
+};
+
+} // namespace Profiler
+} // namespace Envoy
@@ -0,0 +1,101 @@
+#include "common/router/adaptive_hedge.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Router {
+
+AdaptiveHedgeImpl::AdaptiveHedgeImpl(
+    const envoy::config::route::v3::HedgePolicy::AdaptiveHedge& adaptive_hedge)
+    : percentile_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(adaptive_hedge, percentile, 95.0)),
+      hedge_budget_(PROTOBUF_PERCENT_TO_DOUBLE_OR_DEFAULT(adaptive_hedge, hedge_budget, 10.0) /
+                    100.0) {}
+
+uint32_t AdaptiveHedgeImpl::bucket(uint64_t response_time_ms) {
+  if (response_time_ms < 4) {
+    return response_time_ms;
+  }
+  uint32_t log2 = 2;
+  while (log2 < 63 && (response_time_ms >> (log2 + 1)) != 0) {
+    ++log2;
+  }
+  // The two bits below the highest set bit select one of the four buckets of the power of two.
+  const uint32_t sub_bucket = (response_time_ms >> (log2 - 2)) & 3;
+  return std::min(4 * (log2 - 1) + sub_bucket, NumBuckets - 1);
+}
+
+uint64_t AdaptiveHedgeImpl::bucketUpperBound(uint32_t bucket) {
+  if (bucket < 4) {
+    return bucket;
+  }
+  const uint32_t log2 = bucket / 4 + 1;
+  const uint64_t lower_bound = static_cast<uint64_t>(4 + bucket % 4) << (log2 - 2);
+  return lower_bound + (uint64_t(1) << (log2 - 2)) - 1;
+}
+
+absl::optional<std::chrono::milliseconds> AdaptiveHedgeImpl::onRequest() {
+  requests_.fetch_add(1, std::memory_order_relaxed);
+  const uint64_t hedge_delay_ms = hedge_delay_ms_.load(std::memory_order_relaxed);
+  if (hedge_delay_ms == 0) {
+    return absl::nullopt;
+  }
+  return std::chrono::milliseconds(hedge_delay_ms);
+}
+
+bool AdaptiveHedgeImpl::tryHedge() {
+  const double budget =
+      hedge_budget_ * (requests_.load(std::memory_order_relaxed) +
+                       previous_requests_.load(std::memory_order_relaxed));
+  const uint64_t previous_hedges = previous_hedges_.load(std::memory_order_relaxed);
+  uint64_t hedges = hedges_.load(std::memory_order_relaxed);
+  // The hedge is only counted if no other worker took the last of the budget in the meantime.
+  do {
+    if (hedges + previous_hedges + 1 > budget) {
+      return false;
+    }
+  } while (!hedges_.compare_exchange_weak(hedges, hedges + 1, std::memory_order_relaxed));
+  return true;
+}
+
+void AdaptiveHedgeImpl::onResponse(std::chrono::milliseconds response_time) {
+  buckets_[bucket(std::max<int64_t>(response_time.count(), 0))].fetch_add(
+      1, std::memory_order_relaxed);
+  // Only the response that completes the window rotates it.
+  if (samples_.fetch_add(1, std::memory_order_relaxed) + 1 == SampleWindow) {
+    rotateWindow();
+  }
+}
+
+void AdaptiveHedgeImpl::rotateWindow() {
+  // The buckets are cleared as they are read, so the responses that land meanwhile are counted in
+  // the next window.
+  std::array<uint32_t, NumBuckets> buckets;
+  uint64_t samples = 0;
+  for (uint32_t i = 0; i < NumBuckets; ++i) {
+    buckets[i] = buckets_[i].exchange(0, std::memory_order_relaxed);
+    samples += buckets[i];
+  }
+  samples_.fetch_sub(SampleWindow, std::memory_order_relaxed);
+
+  const uint64_t rank = std::ceil(samples * percentile_ / 100.0);
+  uint64_t count = 0;
+  for (uint32_t i = 0; i < NumBuckets; ++i) {
+    count += buckets[i];
+    if (count >= rank) {
+      // A delay of 0 would hedge every request at once, and marks an unknown percentile.
+      hedge_delay_ms_.store(std::max<uint64_t>(bucketUpperBound(i), 1), std::memory_order_relaxed);
+      break;
+    }
+  }
+
+  previous_requests_.store(requests_.exchange(0, std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+  previous_hedges_.store(hedges_.exchange(0, std::memory_order_relaxed),
+                         std::memory_order_relaxed);
+}
+
+} // namespace Router
+} // namespace Envoy
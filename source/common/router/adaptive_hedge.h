@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "envoy/config/route/v3/route_components.pb.h"
+#include "envoy/router/router.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Estimates a percentile of the recent response times of a route, and keeps the share of its
+ * recent requests that were hedged within a budget.
+ *
+ * Response times are counted in log-linear buckets: each power of two is split into four buckets,
+ * so the estimate exceeds the true percentile by at most a quarter. The estimate is recomputed
+ * each time a window of responses is complete, and the budget covers the requests of the current
+ * and the previous window.
+ *
+ * The counters are atomic, since every request of the route updates them from its worker. A
+ * response that lands while a window is rotated may be counted in either window.
+ */
+class AdaptiveHedgeImpl : public AdaptiveHedge {
+public:
+  explicit AdaptiveHedgeImpl(
+      const envoy::config::route::v3::HedgePolicy::AdaptiveHedge& adaptive_hedge);
+
+  // Router::AdaptiveHedge
+  absl::optional<std::chrono::milliseconds> onRequest() override;
+  bool tryHedge() override;
+  void onResponse(std::chrono::milliseconds response_time) override;
+
+  // The number of responses the percentile is estimated from.
+  static constexpr uint32_t SampleWindow = 1000;
+  static constexpr uint32_t NumBuckets = 128;
+
+  /**
+   * @return the bucket that counts a response time.
+   */
+  static uint32_t bucket(uint64_t response_time_ms);
+
+  /**
+   * @return the largest response time counted by a bucket.
+   */
+  static uint64_t bucketUpperBound(uint32_t bucket);
+
+private:
+  void rotateWindow();
+
+  const double percentile_;
+  const double hedge_budget_;
+
+  std::array<std::atomic<uint32_t>, NumBuckets> buckets_{};
+  std::atomic<uint32_t> samples_{0};
+  std::atomic<uint64_t> requests_{0};
+  std::atomic<uint64_t> hedges_{0};
+  std::atomic<uint64_t> previous_requests_{0};
+  std::atomic<uint64_t> previous_hedges_{0};
+  // The estimated percentile in milliseconds, or 0 until the first window is complete.
+  std::atomic<uint64_t> hedge_delay_ms_{0};
+};
+
+using AdaptiveHedgeImplSharedPtr = std::shared_ptr<AdaptiveHedgeImpl>;
+
+} // namespace Router
+} // namespace Envoy
@@ -58,7 +58,10 @@ std::string SslRedirector::newPath(const Http::RequestHeaderMap& headers) const
 HedgePolicyImpl::HedgePolicyImpl(const envoy::config::route::v3::HedgePolicy& hedge_policy)
     : initial_requests_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(hedge_policy, initial_requests, 1)),
       additional_request_chance_(hedge_policy.additional_request_chance()),
-      hedge_on_per_try_timeout_(hedge_policy.hedge_on_per_try_timeout()) {}
+      hedge_on_per_try_timeout_(hedge_policy.hedge_on_per_try_timeout()),
+      adaptive_hedge_(hedge_policy.has_adaptive_hedge()
+                          ? std::make_shared<AdaptiveHedgeImpl>(hedge_policy.adaptive_hedge())
+                          : nullptr) {}
 
 HedgePolicyImpl::HedgePolicyImpl() : initial_requests_(1), hedge_on_per_try_timeout_(false) {}
 
@@ -360,6 +363,11 @@ RouteEntryImplBase::RouteEntryImplBase(const VirtualHostImpl& vhost,
       per_filter_configs_(route.typed_per_filter_config(),
                           route.hidden_envoy_deprecated_per_filter_config(), factory_context,
                           validator),
+      // Filters only resolve the configs of virtual hosts for routes with a route entry.
+      most_specific_per_filter_configs_(
+          isDirectResponse()
+              ? per_filter_configs_
+              : PerFilterConfigs::merge(per_filter_configs_, vhost.perFilterConfigs())),
       route_name_(route.name()), time_source_(factory_context.dispatcher().timeSource()) {
   if (route.route().has_metadata_match()) {
     const auto filter_it = route.route().metadata_match().filter_metadata().find(
@@ -536,6 +544,18 @@ bool RouteEntryImplBase::matchRoute(const Http::RequestHeaderMap& headers,
   return matches;
 }
 
+bool RouteEntryImplBase::matchDependsOnPathAndMethodOnly() const {
+  // Weighted clusters are picked with the random value, and cluster headers are read from the
+  // request.
+  return !runtime_.has_value() && !match_grpc_ && config_query_parameters_.empty() &&
+         tls_context_match_criteria_ == nullptr && weighted_clusters_.empty() &&
+         cluster_header_name_.get().empty() &&
+         std::all_of(config_headers_.begin(), config_headers_.end(),
+                     [](const Http::HeaderUtility::HeaderDataPtr& header_data) {
+                       return header_data->name_ == Http::Headers::get().Method;
+                     });
+}
+
 const std::string& RouteEntryImplBase::clusterName() const { return cluster_name_; }
 
 void RouteEntryImplBase::finalizeRequestHeaders(Http::RequestHeaderMap& headers,
@@ -980,7 +1000,9 @@ RouteEntryImplBase::WeightedClusterEntry::WeightedClusterEntry(
                                                        cluster.response_headers_to_remove())),
       per_filter_configs_(cluster.typed_per_filter_config(),
                           cluster.hidden_envoy_deprecated_per_filter_config(), factory_context,
-                          validator) {
+                          validator),
+      most_specific_per_filter_configs_(
+          PerFilterConfigs::merge(per_filter_configs_, parent->most_specific_per_filter_configs_)) {
   if (cluster.has_metadata_match()) {
     const auto filter_it = cluster.metadata_match().filter_metadata().find(
         Envoy::Config::MetadataFilters::get().ENVOY_LB);
@@ -1111,7 +1133,7 @@ RouteConstSharedPtr ConnectRouteEntryImpl::matches(const Http::RequestHeaderMap&
 
 VirtualHostImpl::VirtualHostImpl(
     const envoy::config::route::v3::VirtualHost& virtual_host,
-    const ConfigImpl& global_route_config,
+    const CommonConfigImplSharedPtr& global_route_config,
     Server::Configuration::ServerFactoryContext& factory_context, Stats::Scope& scope,
     ProtobufMessage::ValidationVisitor& validator,
     const absl::optional<Upstream::ClusterManager::ClusterInfoMaps>& validation_clusters)
@@ -1189,6 +1211,46 @@ VirtualHostImpl::VirtualHostImpl(
     }
   }
 
+  const size_t indexable_routes = std::count_if(
+      virtual_host.routes().begin(), virtual_host.routes().end(),
+      [](const envoy::config::route::v3::Route& route) {
+        using PathSpecifierCase = envoy::config::route::v3::RouteMatch::PathSpecifierCase;
+        const PathSpecifierCase path_specifier = route.match().path_specifier_case();
+        return path_specifier == PathSpecifierCase::kPrefix ||
+               path_specifier == PathSpecifierCase::kPath ||
+               path_specifier == PathSpecifierCase::kSafeRegex;
+      });
+  if (indexable_routes >= MinRoutesForPathIndex) {
+    auto path_route_index = std::make_unique<PathRouteIndex>();
+    for (uint32_t i = 0; i < routes_.size(); ++i) {
+      const envoy::config::route::v3::RouteMatch& match = virtual_host.routes()[i].match();
+      switch (match.path_specifier_case()) {
+      case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPrefix:
+        path_route_index->addPrefix(routes_[i]->matcher(), i);
+        break;
+      case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPath:
+        path_route_index->addPath(routes_[i]->matcher(), i);
+        break;
+      case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kSafeRegex:
+        if (!path_route_index->addRegex(match.safe_regex().regex(), i)) {
+          unindexed_routes_.push_back(i);
+        }
+        break;
+      default:
+        unindexed_routes_.push_back(i);
+        break;
+      }
+    }
+    path_route_index->compile();
+    path_route_index_ = std::move(path_route_index);
+  }
+
+  route_depends_on_path_and_method_only_ =
+      ssl_requirements_ == SslRequirements::None &&
+      std::all_of(routes_.begin(), routes_.end(), [](const RouteEntryImplBaseConstSharedPtr& route) {
+        return route->matchDependsOnPathAndMethodOnly();
+      });
+
   for (const auto& virtual_cluster : virtual_host.virtual_clusters()) {
     virtual_clusters_.push_back(
         VirtualClusterEntry(virtual_cluster, stat_name_pool_, *vcluster_scope_));
@@ -1230,47 +1292,45 @@ VirtualHostImpl::VirtualClusterEntry::VirtualClusterEntry(
   }
 }
 
-const Config& VirtualHostImpl::routeConfig() const { return global_route_config_; }
+const CommonConfig& VirtualHostImpl::routeConfig() const { return *global_route_config_; }
 
 const RouteSpecificFilterConfig* VirtualHostImpl::perFilterConfig(const std::string& name) const {
   return per_filter_configs_.get(name);
 }
 
-const VirtualHostImpl* RouteMatcher::findWildcardVirtualHost(
-    const std::string& host, const RouteMatcher::WildcardVirtualHosts& wildcard_virtual_hosts,
-    RouteMatcher::SubstringFunction substring_function) const {
-  // We do a longest wildcard match against the host that's passed in
-  // (e.g. "foo-bar.baz.com" should match "*-bar.baz.com" before matching "*.baz.com" for suffix
-  // wildcards). This is done by scanning the length => wildcards map looking for every wildcard
-  // whose size is < length.
-  for (const auto& iter : wildcard_virtual_hosts) {
-    const uint32_t wildcard_length = iter.first;
-    const auto& wildcard_map = iter.second;
-    // >= because *.foo.com shouldn't match .foo.com.
-    if (wildcard_length >= host.size()) {
-      continue;
-    }
-    const auto& match = wildcard_map.find(substring_function(host, wildcard_length));
-    if (match != wildcard_map.end()) {
-      return match->second.get();
-    }
-  }
-  return nullptr;
-}
-
 RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& route_config,
-                           const ConfigImpl& global_route_config,
+                           const CommonConfigImplSharedPtr& global_route_config,
                            Server::Configuration::ServerFactoryContext& factory_context,
-                           ProtobufMessage::ValidationVisitor& validator, bool validate_clusters)
+                           ProtobufMessage::ValidationVisitor& validator, bool validate_clusters,
+                           bool reuse_virtual_hosts, const RouteMatcher* previous)
     : vhost_scope_(factory_context.scope().createScope("vhost")) {
   absl::optional<Upstream::ClusterManager::ClusterInfoMaps> validation_clusters;
   if (validate_clusters) {
     validation_clusters = factory_context.clusterManager().clusters();
   }
+  uint32_t reused_virtual_hosts = 0;
   for (const auto& virtual_host_config : route_config.virtual_hosts()) {
-    VirtualHostSharedPtr virtual_host(new VirtualHostImpl(virtual_host_config, global_route_config,
-                                                          factory_context, *vhost_scope_, validator,
-                                                          validation_clusters));
+    VirtualHostSharedPtr virtual_host;
+    if (reuse_virtual_hosts) {
+      const uint64_t hash = MessageUtil::hash(virtual_host_config);
+      if (previous != nullptr) {
+        auto it = previous->virtual_hosts_by_hash_.find(hash);
+        if (it != previous->virtual_hosts_by_hash_.end()) {
+          virtual_host = it->second;
+          ++reused_virtual_hosts;
+        }
+      }
+      if (virtual_host == nullptr) {
+        virtual_host = std::make_shared<VirtualHostImpl>(virtual_host_config, global_route_config,
+                                                         factory_context, *vhost_scope_, validator,
+                                                         validation_clusters);
+      }
+      virtual_hosts_by_hash_.emplace(hash, virtual_host);
+    } else {
+      virtual_host = std::make_shared<VirtualHostImpl>(virtual_host_config, global_route_config,
+                                                       factory_context, *vhost_scope_, validator,
+                                                       validation_clusters);
+    }
     for (const std::string& domain_name : virtual_host_config.domains()) {
       const std::string domain = Http::LowerCaseString(domain_name).get();
       bool duplicate_found = false;
@@ -1281,13 +1341,11 @@ RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& r
         }
         default_virtual_host_ = virtual_host;
       } else if (!domain.empty() && '*' == domain[0]) {
-        duplicate_found = !wildcard_virtual_host_suffixes_[domain.size() - 1]
-                               .emplace(domain.substr(1), virtual_host)
-                               .second;
+        duplicate_found =
+            !wildcard_virtual_host_suffixes_.add(absl::string_view(domain).substr(1), virtual_host);
       } else if (!domain.empty() && '*' == domain[domain.size() - 1]) {
-        duplicate_found = !wildcard_virtual_host_prefixes_[domain.size() - 1]
-                               .emplace(domain.substr(0, domain.size() - 1), virtual_host)
-                               .second;
+        duplicate_found = !wildcard_virtual_host_prefixes_.add(
+            absl::string_view(domain).substr(0, domain.size() - 1), virtual_host);
       } else {
         duplicate_found = !virtual_hosts_.emplace(domain, virtual_host).second;
       }
@@ -1298,6 +1356,17 @@ RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& r
       }
     }
   }
+
+  if (previous != nullptr) {
+    ENVOY_LOG_MISC(debug, "route config {}: reused {} of {} virtual hosts", route_config.name(),
+                   reused_virtual_hosts, route_config.virtual_hosts_size());
+  }
+
+  if (route_config.has_route_cache_max_entries()) {
+    route_cache_ = std::make_unique<RouteCache>(
+        route_config.route_cache_max_entries().value(), factory_context.scope(),
+        fmt::format("route_config.{}.route_cache", route_config.name()));
+  }
 }
 
 RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb,
@@ -1320,36 +1389,68 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb
     return SSL_REDIRECT_ROUTE;
   }
 
-  // Check for a route that matches the request.
-  for (auto route = routes_.begin(); route != routes_.end(); ++route) {
-    if (!headers.Path() && !(*route)->supportsPathlessHeaders()) {
-      continue;
+  RouteConstSharedPtr selected_route;
+  if (path_route_index_ == nullptr || headers.Path() == nullptr) {
+    // Check for a route that matches the request.
+    for (size_t i = 0; i < routes_.size(); ++i) {
+      if (evaluateRoute(i, cb, headers, stream_info, random_value, selected_route)) {
+        return selected_route;
+      }
     }
+    return nullptr;
+  }
 
-    RouteConstSharedPtr route_entry = (*route)->matches(headers, stream_info, random_value);
-    if (nullptr == route_entry) {
-      continue;
+  // Only the prefix, path and regex routes that the index returns can match the path. Evaluate them
+  // together with the routes that are not indexed, in the order of the routes.
+  PathRouteIndex::Routes candidates;
+  path_route_index_->find(Http::PathUtil::removeQueryAndFragment(headers.getPathValue()),
+                          candidates);
+  auto candidate = candidates.begin();
+  auto unindexed = unindexed_routes_.begin();
+  while (candidate != candidates.end() || unindexed != unindexed_routes_.end()) {
+    size_t index;
+    if (unindexed == unindexed_routes_.end() ||
+        (candidate != candidates.end() && *candidate < *unindexed)) {
+      index = *candidate++;
+    } else {
+      index = *unindexed++;
     }
-
-    if (cb) {
-      RouteEvalStatus eval_status = (std::next(route) == routes_.end())
-                                        ? RouteEvalStatus::NoMoreRoutes
-                                        : RouteEvalStatus::HasMoreRoutes;
-      RouteMatchStatus match_status = cb(route_entry, eval_status);
-      if (match_status == RouteMatchStatus::Accept) {
-        return route_entry;
-      }
-      if (match_status == RouteMatchStatus::Continue &&
-          eval_status == RouteEvalStatus::NoMoreRoutes) {
-        return nullptr;
-      }
-      continue;
+    if (evaluateRoute(index, cb, headers, stream_info, random_value, selected_route)) {
+      return selected_route;
     }
+  }
+  return nullptr;
+}
 
-    return route_entry;
+bool VirtualHostImpl::evaluateRoute(size_t index, const RouteCallback& cb,
+                                    const Http::RequestHeaderMap& headers,
+                                    const StreamInfo::StreamInfo& stream_info,
+                                    uint64_t random_value,
+                                    RouteConstSharedPtr& selected_route) const {
+  const RouteEntryImplBaseConstSharedPtr& route = routes_[index];
+  if (!headers.Path() && !route->supportsPathlessHeaders()) {
+    return false;
   }
 
-  return nullptr;
+  RouteConstSharedPtr route_entry = route->matches(headers, stream_info, random_value);
+  if (nullptr == route_entry) {
+    return false;
+  }
+
+  if (cb) {
+    RouteEvalStatus eval_status = (index + 1 == routes_.size()) ? RouteEvalStatus::NoMoreRoutes
+                                                                : RouteEvalStatus::HasMoreRoutes;
+    RouteMatchStatus match_status = cb(route_entry, eval_status);
+    if (match_status == RouteMatchStatus::Accept) {
+      selected_route = std::move(route_entry);
+      return true;
+    }
+    return match_status == RouteMatchStatus::Continue &&
+           eval_status == RouteEvalStatus::NoMoreRoutes;
+  }
+
+  selected_route = std::move(route_entry);
+  return true;
 }
 
 const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::RequestHeaderMap& headers) const {
@@ -1372,20 +1473,18 @@ const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::RequestHeaderMa
   if (iter != virtual_hosts_.end()) {
     return iter->second.get();
   }
+  // Longest wildcard match against the host (e.g. "foo-bar.baz.com" matches "*-bar.baz.com"
+  // before "*.baz.com"). Suffix wildcards take precedence over prefix wildcards.
   if (!wildcard_virtual_host_suffixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_suffixes_,
-        [](const std::string& h, int l) -> std::string { return h.substr(h.size() - l); });
+    const VirtualHostSharedPtr* vhost = wildcard_virtual_host_suffixes_.find(host);
     if (vhost != nullptr) {
-      return vhost;
+      return vhost->get();
     }
   }
   if (!wildcard_virtual_host_prefixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_prefixes_,
-        [](const std::string& h, int l) -> std::string { return h.substr(0, l); });
+    const VirtualHostSharedPtr* vhost = wildcard_virtual_host_prefixes_.find(host);
     if (vhost != nullptr) {
-      return vhost;
+      return vhost->get();
     }
   }
   return default_virtual_host_.get();
@@ -1396,9 +1495,28 @@ RouteConstSharedPtr RouteMatcher::route(const RouteCallback& cb,
                                         const StreamInfo::StreamInfo& stream_info,
                                         uint64_t random_value) const {
 
+  // Callbacks may reject routes, and requests without these headers are resolved differently.
+  const bool use_route_cache = route_cache_ != nullptr && !cb && headers.Host() != nullptr &&
+                               headers.Path() != nullptr && headers.ForwardedProto() != nullptr;
+  std::string route_cache_key;
+  if (use_route_cache) {
+    route_cache_key =
+        RouteCache::key(headers.getHostValue(), headers.getMethodValue(),
+                        Http::PathUtil::removeQueryAndFragment(headers.getPathValue()));
+    RouteConstSharedPtr route;
+    if (route_cache_->lookup(route_cache_key, route)) {
+      return route;
+    }
+  }
+
   const VirtualHostImpl* virtual_host = findVirtualHost(headers);
   if (virtual_host) {
-    return virtual_host->getRouteFromEntries(cb, headers, stream_info, random_value);
+    RouteConstSharedPtr route =
+        virtual_host->getRouteFromEntries(cb, headers, stream_info, random_value);
+    if (use_route_cache && virtual_host->routeDependsOnPathAndMethodOnly()) {
+      route_cache_->insert(std::move(route_cache_key), route);
+    }
+    return route;
   } else {
     return nullptr;
   }
@@ -1423,17 +1541,10 @@ VirtualHostImpl::virtualClusterFromEntries(const Http::HeaderMap& headers) const
   return nullptr;
 }
 
-ConfigImpl::ConfigImpl(const envoy::config::route::v3::RouteConfiguration& config,
-                       Server::Configuration::ServerFactoryContext& factory_context,
-                       ProtobufMessage::ValidationVisitor& validator,
-                       bool validate_clusters_default)
-    : name_(config.name()), symbol_table_(factory_context.scope().symbolTable()),
-      uses_vhds_(config.has_vhds()),
-      most_specific_header_mutations_wins_(config.most_specific_header_mutations_wins()) {
-  route_matcher_ = std::make_unique<RouteMatcher>(
-      config, *this, factory_context, validator,
-      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, validate_clusters, validate_clusters_default));
-
+CommonConfigImpl::CommonConfigImpl(const envoy::config::route::v3::RouteConfiguration& config)
+    : name_(config.name()), uses_vhds_(config.has_vhds()),
+      most_specific_header_mutations_wins_(config.most_specific_header_mutations_wins()),
+      hash_(hash(config)) {
   for (const std::string& header : config.internal_only_headers()) {
     internal_only_headers_.push_back(Http::LowerCaseString(header));
   }
@@ -1444,6 +1555,49 @@ ConfigImpl::ConfigImpl(const envoy::config::route::v3::RouteConfiguration& confi
                                                      config.response_headers_to_remove());
 }
 
+uint64_t CommonConfigImpl::hash(const envoy::config::route::v3::RouteConfiguration& config) {
+  // Copy the fields that the constructor reads, rather than the whole configuration with its
+  // virtual hosts.
+  envoy::config::route::v3::RouteConfiguration common_config;
+  common_config.set_name(config.name());
+  *common_config.mutable_internal_only_headers() = config.internal_only_headers();
+  *common_config.mutable_request_headers_to_add() = config.request_headers_to_add();
+  *common_config.mutable_request_headers_to_remove() = config.request_headers_to_remove();
+  *common_config.mutable_response_headers_to_add() = config.response_headers_to_add();
+  *common_config.mutable_response_headers_to_remove() = config.response_headers_to_remove();
+  common_config.set_most_specific_header_mutations_wins(
+      config.most_specific_header_mutations_wins());
+  if (config.has_vhds()) {
+    *common_config.mutable_vhds() = config.vhds();
+  }
+  return MessageUtil::hash(common_config);
+}
+
+ConfigImpl::ConfigImpl(const envoy::config::route::v3::RouteConfiguration& config,
+                       Server::Configuration::ServerFactoryContext& factory_context,
+                       ProtobufMessage::ValidationVisitor& validator,
+                       bool validate_clusters_default, const ConfigImpl* previous_config)
+    : shared_config_(std::make_shared<CommonConfigImpl>(config)) {
+  const bool validate_clusters =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, validate_clusters, validate_clusters_default);
+  // Clusters are validated when a virtual host is built, so virtual hosts are not reused if the
+  // clusters must be validated against the current ones.
+  const bool reuse_virtual_hosts =
+      !validate_clusters &&
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.rds_reuse_virtual_hosts");
+  // Virtual hosts refer to the common config they were built with, so they can only be reused if
+  // it did not change. The previous common config is then shared too.
+  const RouteMatcher* previous_route_matcher = nullptr;
+  if (reuse_virtual_hosts && previous_config != nullptr &&
+      previous_config->shared_config_->hash() == shared_config_->hash()) {
+    shared_config_ = previous_config->shared_config_;
+    previous_route_matcher = previous_config->route_matcher_.get();
+  }
+  route_matcher_ = std::make_unique<RouteMatcher>(config, shared_config_, factory_context,
+                                                  validator, validate_clusters,
+                                                  reuse_virtual_hosts, previous_route_matcher);
+}
+
 RouteConstSharedPtr ConfigImpl::route(const RouteCallback& cb,
                                       const Http::RequestHeaderMap& headers,
                                       const StreamInfo::StreamInfo& stream_info,
@@ -1506,5 +1660,15 @@ const RouteSpecificFilterConfig* PerFilterConfigs::get(const std::string& name)
   return it == configs_.end() ? nullptr : it->second.get();
 }
 
+PerFilterConfigs PerFilterConfigs::merge(const PerFilterConfigs& more_specific,
+                                         const PerFilterConfigs& less_specific) {
+  PerFilterConfigs merged;
+  merged.configs_ = more_specific.configs_;
+  for (const auto& [name, config] : less_specific.configs_) {
+    merged.configs_.try_emplace(name, config);
+  }
+  return merged;
+}
+
 } // namespace Router
 } // namespace Envoy
@@ -23,14 +23,19 @@
 #include "common/config/metadata.h"
 #include "common/http/hash_policy.h"
 #include "common/http/header_utility.h"
+#include "common/router/adaptive_hedge.h"
 #include "common/router/config_utility.h"
 #include "common/router/header_formatter.h"
 #include "common/router/header_parser.h"
 #include "common/router/metadatamatchcriteria_impl.h"
+#include "common/router/path_route_index.h"
+#include "common/router/route_cache.h"
 #include "common/router/router_ratelimit.h"
 #include "common/router/tls_context_match_criteria_impl.h"
+#include "common/router/wildcard_domain_table.h"
 #include "common/stats/symbol_table_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/types/optional.h"
 
@@ -68,8 +73,18 @@ public:
 
   const RouteSpecificFilterConfig* get(const std::string& name) const;
 
+  /**
+   * @return the configs of both sets, preferring those of more_specific for the filters that
+   *         both have configs for. Routes pre-merge their configs with this at load, so that
+   *         resolving the most specific config of a filter takes a single lookup.
+   */
+  static PerFilterConfigs merge(const PerFilterConfigs& more_specific,
+                                const PerFilterConfigs& less_specific);
+
 private:
-  absl::node_hash_map<std::string, RouteSpecificFilterConfigConstSharedPtr> configs_;
+  PerFilterConfigs() = default;
+
+  absl::flat_hash_map<std::string, RouteSpecificFilterConfigConstSharedPtr> configs_;
 };
 
 class RouteEntryImplBase;
@@ -103,6 +118,9 @@ public:
   const RouteSpecificFilterConfig* perFilterConfig(const std::string&) const override {
     return nullptr;
   }
+  const RouteSpecificFilterConfig* mostSpecificPerFilterConfig(const std::string&) const override {
+    return nullptr;
+  }
 
 private:
   static const SslRedirector SSL_REDIRECTOR;
@@ -153,7 +171,49 @@ private:
   const bool legacy_enabled_;
 };
 
-class ConfigImpl;
+/**
+ * Implementation of CommonConfig. It is shared by the virtual hosts of a route configuration, and
+ * by later versions of the configuration that reuse them.
+ */
+class CommonConfigImpl : public CommonConfig {
+public:
+  explicit CommonConfigImpl(const envoy::config::route::v3::RouteConfiguration& config);
+
+  /**
+   * @return a hash of the fields of a route configuration that CommonConfigImpl is built from.
+   */
+  static uint64_t hash(const envoy::config::route::v3::RouteConfiguration& config);
+
+  /**
+   * @return the hash of the route configuration that the object was built from.
+   */
+  uint64_t hash() const { return hash_; }
+
+  const HeaderParser& requestHeaderParser() const { return *request_headers_parser_; };
+  const HeaderParser& responseHeaderParser() const { return *response_headers_parser_; };
+
+  // Router::CommonConfig
+  const std::list<Http::LowerCaseString>& internalOnlyHeaders() const override {
+    return internal_only_headers_;
+  }
+  const std::string& name() const override { return name_; }
+  bool usesVhds() const override { return uses_vhds_; }
+  bool mostSpecificHeaderMutationsWins() const override {
+    return most_specific_header_mutations_wins_;
+  }
+
+private:
+  std::list<Http::LowerCaseString> internal_only_headers_;
+  HeaderParserPtr request_headers_parser_;
+  HeaderParserPtr response_headers_parser_;
+  const std::string name_;
+  const bool uses_vhds_;
+  const bool most_specific_header_mutations_wins_;
+  const uint64_t hash_;
+};
+
+using CommonConfigImplSharedPtr = std::shared_ptr<const CommonConfigImpl>;
+
 /**
  * Holds all routing configuration for an entire virtual host.
  */
@@ -161,7 +221,7 @@ class VirtualHostImpl : public VirtualHost {
 public:
   VirtualHostImpl(
       const envoy::config::route::v3::VirtualHost& virtual_host,
-      const ConfigImpl& global_route_config,
+      const CommonConfigImplSharedPtr& global_route_config,
       Server::Configuration::ServerFactoryContext& factory_context, Stats::Scope& scope,
       ProtobufMessage::ValidationVisitor& validator,
       const absl::optional<Upstream::ClusterManager::ClusterInfoMaps>& validation_clusters);
@@ -171,7 +231,10 @@ public:
                                           const StreamInfo::StreamInfo& stream_info,
                                           uint64_t random_value) const;
   const VirtualCluster* virtualClusterFromEntries(const Http::HeaderMap& headers) const;
-  const ConfigImpl& globalRouteConfig() const { return global_route_config_; }
+  // Whether getRouteFromEntries() without a callback only depends on the path and the method of
+  // requests that have a path and an x-forwarded-proto header.
+  bool routeDependsOnPathAndMethodOnly() const { return route_depends_on_path_and_method_only_; }
+  const CommonConfigImpl& globalRouteConfig() const { return *global_route_config_; }
   const HeaderParser& requestHeaderParser() const { return *request_headers_parser_; }
   const HeaderParser& responseHeaderParser() const { return *response_headers_parser_; }
 
@@ -179,8 +242,10 @@ public:
   const CorsPolicy* corsPolicy() const override { return cors_policy_.get(); }
   Stats::StatName statName() const override { return stat_name_; }
   const RateLimitPolicy& rateLimitPolicy() const override { return rate_limit_policy_; }
-  const Config& routeConfig() const override;
+  const CommonConfig& routeConfig() const override;
   const RouteSpecificFilterConfig* perFilterConfig(const std::string&) const override;
+
+  const PerFilterConfigs& perFilterConfigs() const { return per_filter_configs_; }
   bool includeAttemptCountInRequest() const override { return include_attempt_count_in_request_; }
   bool includeAttemptCountInResponse() const override { return include_attempt_count_in_response_; }
   const absl::optional<envoy::config::route::v3::RetryPolicy>& retryPolicy() const {
@@ -223,16 +288,31 @@ private:
 
   static const std::shared_ptr<const SslRedirectRoute> SSL_REDIRECT_ROUTE;
 
+  // Virtual hosts with at least this many prefix, path and safe regex routes index them by path.
+  static constexpr size_t MinRoutesForPathIndex = 16;
+
+  // Evaluates routes_[index] for getRouteFromEntries(). Returns true if route selection ends at
+  // this route, with the selected route, if any, in selected_route.
+  bool evaluateRoute(size_t index, const RouteCallback& cb, const Http::RequestHeaderMap& headers,
+                     const StreamInfo::StreamInfo& stream_info, uint64_t random_value,
+                     RouteConstSharedPtr& selected_route) const;
+
   Stats::StatNamePool stat_name_pool_;
   const Stats::StatName stat_name_;
   Stats::ScopePtr vcluster_scope_;
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
+  // If set, the indexes of the prefix, path and regex routes by path, and of the other routes in
+  // order.
+  std::unique_ptr<const PathRouteIndex> path_route_index_;
+  std::vector<uint32_t> unindexed_routes_;
+  bool route_depends_on_path_and_method_only_{};
   std::vector<VirtualClusterEntry> virtual_clusters_;
   SslRequirements ssl_requirements_;
   const RateLimitPolicyImpl rate_limit_policy_;
   std::unique_ptr<const CorsPolicyImpl> cors_policy_;
-  const ConfigImpl& global_route_config_; // See note in RouteEntryImplBase::clusterEntry() on why
-                                          // raw ref to the top level config is currently safe.
+  // Shared, rather than a reference to the ConfigImpl, so that the virtual host can outlive the
+  // configuration that built it when later versions reuse it.
+  const CommonConfigImplSharedPtr global_route_config_;
   HeaderParserPtr request_headers_parser_;
   HeaderParserPtr response_headers_parser_;
   PerFilterConfigs per_filter_configs_;
@@ -341,11 +421,14 @@ public:
     return additional_request_chance_;
   }
   bool hedgeOnPerTryTimeout() const override { return hedge_on_per_try_timeout_; }
+  AdaptiveHedge* adaptiveHedge() const override { return adaptive_hedge_.get(); }
 
 private:
   const uint32_t initial_requests_;
   const envoy::type::v3::FractionalPercent additional_request_chance_;
   const bool hedge_on_per_try_timeout_;
+  // Shared by the copies of the policy, and by all workers.
+  const AdaptiveHedgeImplSharedPtr adaptive_hedge_;
 };
 
 /**
@@ -464,6 +547,9 @@ public:
 
   bool matchRoute(const Http::RequestHeaderMap& headers, const StreamInfo::StreamInfo& stream_info,
                   uint64_t random_value) const;
+  // Whether the route matches a request, and the route that matches() returns, only depend on the
+  // path and the method of the request.
+  bool matchDependsOnPathAndMethodOnly() const;
   void validateClusters(const Upstream::ClusterManager::ClusterInfoMaps& cluster_info_maps) const;
 
   // Router::RouteEntry
@@ -549,6 +635,10 @@ public:
   const Decorator* decorator() const override { return decorator_.get(); }
   const RouteTracing* tracingConfig() const override { return route_tracing_.get(); }
   const RouteSpecificFilterConfig* perFilterConfig(const std::string&) const override;
+  const RouteSpecificFilterConfig*
+  mostSpecificPerFilterConfig(const std::string& name) const override {
+    return most_specific_per_filter_configs_.get(name);
+  }
 
 protected:
   const bool case_sensitive_;
@@ -685,6 +775,10 @@ private:
     const RouteSpecificFilterConfig* perFilterConfig(const std::string& name) const override {
       return parent_->perFilterConfig(name);
     };
+    const RouteSpecificFilterConfig*
+    mostSpecificPerFilterConfig(const std::string& name) const override {
+      return parent_->mostSpecificPerFilterConfig(name);
+    }
 
   private:
     const RouteEntryImplBase* parent_;
@@ -728,6 +822,10 @@ private:
     }
 
     const RouteSpecificFilterConfig* perFilterConfig(const std::string& name) const override;
+    const RouteSpecificFilterConfig*
+    mostSpecificPerFilterConfig(const std::string& name) const override {
+      return most_specific_per_filter_configs_.get(name);
+    }
 
   private:
     const std::string runtime_key_;
@@ -737,6 +835,8 @@ private:
     HeaderParserPtr request_headers_parser_;
     HeaderParserPtr response_headers_parser_;
     PerFilterConfigs per_filter_configs_;
+    // The configs of the cluster, then of the route, then of the virtual host.
+    const PerFilterConfigs most_specific_per_filter_configs_;
   };
 
   using WeightedClusterEntrySharedPtr = std::shared_ptr<WeightedClusterEntry>;
@@ -829,6 +929,8 @@ private:
   const absl::optional<Http::Code> direct_response_code_;
   std::string direct_response_body_;
   PerFilterConfigs per_filter_configs_;
+  // The configs of the route, then of the virtual host.
+  const PerFilterConfigs most_specific_per_filter_configs_;
   const std::string route_name_;
   TimeSource& time_source_;
 };
@@ -943,10 +1045,18 @@ public:
  */
 class RouteMatcher {
 public:
+  /**
+   * @param reuse_virtual_hosts supplies whether later versions of the configuration may reuse the
+   *        virtual hosts.
+   * @param previous supplies the matcher of the previous version of the configuration, if its
+   *        virtual hosts may be reused. Virtual hosts whose configuration did not change are then
+   *        shared with it rather than rebuilt.
+   */
   RouteMatcher(const envoy::config::route::v3::RouteConfiguration& config,
-               const ConfigImpl& global_http_config,
+               const CommonConfigImplSharedPtr& global_route_config,
                Server::Configuration::ServerFactoryContext& factory_context,
-               ProtobufMessage::ValidationVisitor& validator, bool validate_clusters);
+               ProtobufMessage::ValidationVisitor& validator, bool validate_clusters,
+               bool reuse_virtual_hosts, const RouteMatcher* previous);
 
   RouteConstSharedPtr route(const RouteCallback& cb, const Http::RequestHeaderMap& headers,
                             const StreamInfo::StreamInfo& stream_info, uint64_t random_value) const;
@@ -954,28 +1064,20 @@ public:
   const VirtualHostImpl* findVirtualHost(const Http::RequestHeaderMap& headers) const;
 
 private:
-  using WildcardVirtualHosts =
-      std::map<int64_t, absl::node_hash_map<std::string, VirtualHostSharedPtr>, std::greater<>>;
-  using SubstringFunction = std::function<std::string(const std::string&, int)>;
-  const VirtualHostImpl* findWildcardVirtualHost(const std::string& host,
-                                                 const WildcardVirtualHosts& wildcard_virtual_hosts,
-                                                 SubstringFunction substring_function) const;
+  using WildcardVirtualHosts = WildcardDomainTable<VirtualHostSharedPtr>;
 
   Stats::ScopePtr vhost_scope_;
   absl::node_hash_map<std::string, VirtualHostSharedPtr> virtual_hosts_;
-  // std::greater as a minor optimization to iterate from more to less specific
-  //
-  // A note on using an unordered_map versus a vector of (string, VirtualHostSharedPtr) pairs:
-  //
-  // Based on local benchmarks, each vector entry costs around 20ns for recall and (string)
-  // comparison with a fixed cost of about 25ns. For unordered_map, the empty map costs about 65ns
-  // and climbs to about 110ns once there are any entries.
-  //
-  // The break-even is 4 entries.
-  WildcardVirtualHosts wildcard_virtual_host_suffixes_;
-  WildcardVirtualHosts wildcard_virtual_host_prefixes_;
+  // The longest matching suffix or prefix wildcard is found in one pass over the host.
+  WildcardVirtualHosts wildcard_virtual_host_suffixes_{WildcardVirtualHosts::Type::Suffix};
+  WildcardVirtualHosts wildcard_virtual_host_prefixes_{WildcardVirtualHosts::Type::Prefix};
 
   VirtualHostSharedPtr default_virtual_host_;
+  // If set, the decisions for requests whose virtual host only matches routes by path and method.
+  RouteCachePtr route_cache_;
+  // If virtual hosts may be reused by later versions of the configuration, the virtual hosts by
+  // the hash of their configuration.
+  absl::flat_hash_map<uint64_t, VirtualHostSharedPtr> virtual_hosts_by_hash_;
 };
 
 /**
@@ -983,12 +1085,20 @@ private:
  */
 class ConfigImpl : public Config {
 public:
+  /**
+   * @param previous_config supplies the previous version of the configuration, if any. When
+   *        envoy.reloadable_features.rds_reuse_virtual_hosts is enabled, the virtual hosts whose
+   *        configuration did not change are shared with it rather than rebuilt.
+   */
   ConfigImpl(const envoy::config::route::v3::RouteConfiguration& config,
              Server::Configuration::ServerFactoryContext& factory_context,
-             ProtobufMessage::ValidationVisitor& validator, bool validate_clusters_default);
+             ProtobufMessage::ValidationVisitor& validator, bool validate_clusters_default,
+             const ConfigImpl* previous_config = nullptr);
 
-  const HeaderParser& requestHeaderParser() const { return *request_headers_parser_; };
-  const HeaderParser& responseHeaderParser() const { return *response_headers_parser_; };
+  const HeaderParser& requestHeaderParser() const { return shared_config_->requestHeaderParser(); };
+  const HeaderParser& responseHeaderParser() const {
+    return shared_config_->responseHeaderParser();
+  };
 
   bool virtualHostExists(const Http::RequestHeaderMap& headers) const {
     return route_matcher_->findVirtualHost(headers) != nullptr;
@@ -1006,26 +1116,20 @@ public:
                             uint64_t random_value) const override;
 
   const std::list<Http::LowerCaseString>& internalOnlyHeaders() const override {
-    return internal_only_headers_;
+    return shared_config_->internalOnlyHeaders();
   }
 
-  const std::string& name() const override { return name_; }
+  const std::string& name() const override { return shared_config_->name(); }
 
-  bool usesVhds() const override { return uses_vhds_; }
+  bool usesVhds() const override { return shared_config_->usesVhds(); }
 
   bool mostSpecificHeaderMutationsWins() const override {
-    return most_specific_header_mutations_wins_;
+    return shared_config_->mostSpecificHeaderMutationsWins();
   }
 
 private:
+  CommonConfigImplSharedPtr shared_config_;
   std::unique_ptr<RouteMatcher> route_matcher_;
-  std::list<Http::LowerCaseString> internal_only_headers_;
-  HeaderParserPtr request_headers_parser_;
-  HeaderParserPtr response_headers_parser_;
-  const std::string name_;
-  Stats::SymbolTable& symbol_table_;
-  const bool uses_vhds_;
-  const bool most_specific_header_mutations_wins_;
 };
 
 /**
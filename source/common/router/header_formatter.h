@@ -26,6 +26,12 @@ public:
    *              headers or replace any existing values for the header
    */
   virtual bool append() const PURE;
+
+  /**
+   * @return const std::string* the value of the formatter if it does not depend on the stream,
+   *         or nullptr if it must be formatted for each stream.
+   */
+  virtual const std::string* constantValue() const PURE;
 };
 
 using HeaderFormatterPtr = std::unique_ptr<HeaderFormatter>;
@@ -40,6 +46,7 @@ public:
   // HeaderFormatter::format
   const std::string format(const Envoy::StreamInfo::StreamInfo& stream_info) const override;
   bool append() const override { return append_; }
+  const std::string* constantValue() const override { return nullptr; }
 
   using FieldExtractor = std::function<std::string(const Envoy::StreamInfo::StreamInfo&)>;
 
@@ -63,6 +70,7 @@ public:
     return static_value_;
   };
   bool append() const override { return append_; }
+  const std::string* constantValue() const override { return &static_value_; }
 
 private:
   const std::string static_value_;
@@ -75,21 +83,38 @@ private:
 class CompoundHeaderFormatter : public HeaderFormatter {
 public:
   CompoundHeaderFormatter(std::vector<HeaderFormatterPtr>&& formatters, bool append)
-      : formatters_(std::move(formatters)), append_(append) {}
+      : formatters_(std::move(formatters)), append_(append) {
+    for (const auto& formatter : formatters_) {
+      const std::string* constant_value = formatter->constantValue();
+      reserved_size_ += constant_value != nullptr ? constant_value->size() : DynamicSizeHint;
+    }
+  }
 
   // HeaderFormatter::format
   const std::string format(const Envoy::StreamInfo::StreamInfo& stream_info) const override {
     std::string buf;
+    buf.reserve(reserved_size_);
     for (const auto& formatter : formatters_) {
-      buf += formatter->format(stream_info);
+      // Constant parts are appended in place rather than copied out of their formatter first.
+      const std::string* constant_value = formatter->constantValue();
+      if (constant_value != nullptr) {
+        buf.append(*constant_value);
+      } else {
+        buf.append(formatter->format(stream_info));
+      }
     }
     return buf;
   };
   bool append() const override { return append_; }
+  const std::string* constantValue() const override { return nullptr; }
 
 private:
+  // The bytes reserved for each dynamic part, enough for an IPv6 address and port.
+  static constexpr size_t DynamicSizeHint = 48;
+
   const std::vector<HeaderFormatterPtr> formatters_;
   const bool append_;
+  size_t reserved_size_{0};
 };
 
 } // namespace Router
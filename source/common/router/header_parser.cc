@@ -281,8 +281,20 @@ void HeaderParser::evaluateHeaders(Http::HeaderMap& headers,
   }
 
   for (const auto& [key, entry] : headers_to_add_) {
-    const std::string value =
-        stream_info != nullptr ? entry.formatter_->format(*stream_info) : entry.original_value_;
+    // Constant values are copied straight from the formatter into the header map, so only values
+    // that depend on the stream are formatted into a temporary string.
+    const std::string* constant_value = entry.formatter_->constantValue();
+    const std::string formatted_value = stream_info != nullptr && constant_value == nullptr
+                                            ? entry.formatter_->format(*stream_info)
+                                            : std::string();
+    absl::string_view value;
+    if (stream_info == nullptr) {
+      value = entry.original_value_;
+    } else if (constant_value != nullptr) {
+      value = *constant_value;
+    } else {
+      value = formatted_value;
+    }
     if (!value.empty()) {
       if (entry.formatter_->append()) {
         headers.addReferenceKey(key, value);
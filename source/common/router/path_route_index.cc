@@ -0,0 +1,60 @@
+#include "common/router/path_route_index.h"
+
+#include <algorithm>
+
+#include "absl/strings/ascii.h"
+#include "re2/re2.h"
+
+namespace Envoy {
+namespace Router {
+
+PathRouteIndex::NodeRoutes& PathRouteIndex::findOrCreate(absl::string_view key) {
+  return tree_.findOrCreate(absl::AsciiStrToLower(key));
+}
+
+bool PathRouteIndex::addRegex(absl::string_view regex, uint32_t route) {
+  if (regex_set_ == nullptr) {
+    regex_set_ = std::make_unique<re2::RE2::Set>(re2::RE2::Options(re2::RE2::Quiet),
+                                                 re2::RE2::ANCHOR_BOTH);
+  }
+  if (regex_set_->Add(re2::StringPiece(regex.data(), regex.size()), nullptr) < 0) {
+    return false;
+  }
+  regex_routes_.push_back(route);
+  return true;
+}
+
+void PathRouteIndex::compile() {
+  regex_set_compiled_ = regex_set_ != nullptr && regex_set_->Compile();
+}
+
+void PathRouteIndex::find(absl::string_view path, Routes& routes) const {
+  const size_t first_route = routes.size();
+  tree_.walk(
+      path.size(), [path](size_t position) { return absl::ascii_tolower(path[position]); },
+      [&routes, path](const NodeRoutes& node, size_t matched) {
+        routes.insert(routes.end(), node.prefix_routes_.begin(), node.prefix_routes_.end());
+        if (matched == path.size()) {
+          routes.insert(routes.end(), node.path_routes_.begin(), node.path_routes_.end());
+        }
+        return true;
+      });
+
+  if (!regex_routes_.empty()) {
+    std::vector<int> matches;
+    re2::RE2::Set::ErrorInfo error_info;
+    if (regex_set_compiled_ &&
+        (regex_set_->Match(re2::StringPiece(path.data(), path.size()), &matches, &error_info) ||
+         error_info.kind == re2::RE2::Set::kNoError)) {
+      for (const int match : matches) {
+        routes.push_back(regex_routes_[match]);
+      }
+    } else {
+      routes.insert(routes.end(), regex_routes_.begin(), regex_routes_.end());
+    }
+  }
+  std::sort(routes.begin() + first_route, routes.end());
+}
+
+} // namespace Router
+} // namespace Envoy
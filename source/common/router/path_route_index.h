@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/common/radix_tree.h"
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+#include "re2/set.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * A radix tree over the prefixes and exact paths of the routes of a virtual host, and a set of the
+ * regular expressions of its regex routes. Given the path of a request, it returns the routes whose
+ * path matcher may match the path, so that the other indexed routes need not be evaluated. The
+ * regular expressions are matched together in one scan of the path.
+ *
+ * Paths are compared ignoring case, so the result is a superset of the routes that match: routes
+ * with case sensitive matchers, and routes with further conditions such as header matchers, must
+ * still be evaluated against the request.
+ */
+class PathRouteIndex {
+public:
+  using Routes = absl::InlinedVector<uint32_t, 16>;
+
+  /**
+   * Adds a route matching the paths that start with a prefix.
+   * @param prefix supplies the prefix of the route.
+   * @param route supplies the index of the route.
+   */
+  void addPrefix(absl::string_view prefix, uint32_t route) {
+    findOrCreate(prefix).prefix_routes_.push_back(route);
+  }
+
+  /**
+   * Adds a route matching a path exactly.
+   * @param path supplies the path of the route.
+   * @param route supplies the index of the route.
+   */
+  void addPath(absl::string_view path, uint32_t route) {
+    findOrCreate(path).path_routes_.push_back(route);
+  }
+
+  /**
+   * Adds a route matching the paths that a RE2 regular expression matches in full.
+   * @param regex supplies the regular expression of the route.
+   * @param route supplies the index of the route.
+   * @return false if the regular expression cannot be indexed, in which case the route must be
+   *         evaluated for every path.
+   */
+  bool addRegex(absl::string_view regex, uint32_t route);
+
+  /**
+   * Compiles the regular expressions added with addRegex(). Must be called once after the routes
+   * have been added and before find().
+   */
+  void compile();
+
+  /**
+   * Finds the routes that may match a path.
+   * @param path supplies the path without query string and fragment.
+   * @param routes supplies the vector that the indexes of the routes are appended to, in
+   *        ascending order.
+   */
+  void find(absl::string_view path, Routes& routes) const;
+
+private:
+  // The routes of a prefix or path.
+  struct NodeRoutes {
+    std::vector<uint32_t> prefix_routes_;
+    std::vector<uint32_t> path_routes_;
+  };
+
+  // Returns the routes of a prefix or path, which are keyed lower cased.
+  NodeRoutes& findOrCreate(absl::string_view key);
+
+  RadixTree<NodeRoutes> tree_;
+  std::unique_ptr<re2::RE2::Set> regex_set_;
+  // The routes of the regular expressions in regex_set_, by the index of the expression.
+  std::vector<uint32_t> regex_routes_;
+  // If the set could not be compiled, or runs out of memory while matching, all regex routes are
+  // returned.
+  bool regex_set_compiled_{};
+};
+
+} // namespace Router
+} // namespace Envoy
@@ -231,8 +231,9 @@ RdsRouteConfigProviderImpl::RdsRouteConfigProviderImpl(
       tls_(factory_context.threadLocal()) {
   ConfigConstSharedPtr initial_config;
   if (config_update_info_->configInfo().has_value()) {
-    initial_config = std::make_shared<ConfigImpl>(config_update_info_->routeConfiguration(),
-                                                  factory_context_, validator_, false);
+    config_ = std::make_shared<ConfigImpl>(config_update_info_->routeConfiguration(),
+                                           factory_context_, validator_, false);
+    initial_config = config_;
   } else {
     initial_config = std::make_shared<NullConfigImpl>();
   }
@@ -253,8 +254,10 @@ RdsRouteConfigProviderImpl::~RdsRouteConfigProviderImpl() {
 Router::ConfigConstSharedPtr RdsRouteConfigProviderImpl::config() { return tls_->config_; }
 
 void RdsRouteConfigProviderImpl::onConfigUpdate() {
-  ConfigConstSharedPtr new_config(new ConfigImpl(config_update_info_->routeConfiguration(),
-                                                 factory_context_, validator_, false));
+  auto new_config = std::make_shared<const ConfigImpl>(config_update_info_->routeConfiguration(),
+                                                       factory_context_, validator_, false,
+                                                       config_.get());
+  config_ = new_config;
   tls_.runOnAllThreads([new_config](OptRef<ThreadLocalConfig> tls) { tls->config_ = new_config; });
 
   const auto aliases = config_update_info_->resourceIdsInLastVhdsUpdate();
@@ -263,7 +266,6 @@ void RdsRouteConfigProviderImpl::onConfigUpdate() {
     return;
   }
 
-  const auto config = std::static_pointer_cast<const ConfigImpl>(new_config);
   // Notifies connections that RouteConfiguration update has been propagated.
   // Callbacks processing is performed in FIFO order. The callback is skipped if alias used in
   // the VHDS update request do not match the aliases in the update response
@@ -273,7 +275,7 @@ void RdsRouteConfigProviderImpl::onConfigUpdate() {
       // TODO(dmitri-d) HeaderMapImpl is expensive, need to profile this
       auto host_header = Http::RequestHeaderMapImpl::create();
       host_header->setHost(VhdsSubscription::aliasToDomainName(it->alias_));
-      const bool host_exists = config->virtualHostExists(*host_header);
+      const bool host_exists = new_config->virtualHostExists(*host_header);
       std::weak_ptr<Http::RouteConfigUpdatedCallback> current_cb(it->cb_);
       it->thread_local_dispatcher_.post([current_cb, host_exists] {
         if (auto cb = current_cb.lock()) {
@@ -290,7 +292,7 @@ void RdsRouteConfigProviderImpl::onConfigUpdate() {
 void RdsRouteConfigProviderImpl::validateConfig(
     const envoy::config::route::v3::RouteConfiguration& config) const {
   // TODO(lizan): consider cache the config here until onConfigUpdate.
-  ConfigImpl validation_config(config, factory_context_, validator_, false);
+  ConfigImpl validation_config(config, factory_context_, validator_, false, config_.get());
 }
 
 // Schedules a VHDS request on the main thread and queues up the callback to use when the VHDS
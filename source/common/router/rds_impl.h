@@ -225,6 +225,8 @@ private:
   Server::Configuration::ServerFactoryContext& factory_context_;
   ProtobufMessage::ValidationVisitor& validator_;
   ThreadLocal::TypedSlot<ThreadLocalConfig> tls_;
+  // The latest configuration, whose unchanged virtual hosts the next one may reuse.
+  std::shared_ptr<const ConfigImpl> config_;
   std::list<UpdateOnDemandCallback> config_update_callbacks_;
   // A flag used to determine if this instance of RdsRouteConfigProviderImpl hasn't been
   // deallocated. Please also see a comment in requestVirtualHostsUpdate() method implementation.
@@ -0,0 +1,54 @@
+#include "common/router/route_cache.h"
+
+#include <atomic>
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Router {
+
+RouteCache::RouteCache(uint32_t max_entries, Stats::Scope& scope, const std::string& prefix)
+    : stats_{ALL_ROUTE_CACHE_STATS(POOL_COUNTER_PREFIX(scope, prefix))} {
+  shards_.reserve(NumShards);
+  for (uint32_t i = 0; i < NumShards; ++i) {
+    shards_.push_back(std::make_unique<Shard>(max_entries));
+  }
+}
+
+std::string RouteCache::key(absl::string_view host, absl::string_view method,
+                            absl::string_view path) {
+  // Header values cannot contain line feeds, so they delimit the parts of the key.
+  return absl::StrCat(host, "\n", method, "\n", path);
+}
+
+bool RouteCache::lookup(const std::string& key, RouteConstSharedPtr& route) {
+  Shard& shard = threadShard();
+  absl::MutexLock lock(&shard.mutex_);
+  const RouteConstSharedPtr* decision = shard.decisions_.find(key);
+  if (decision == nullptr) {
+    stats_.miss_.inc();
+    return false;
+  }
+  route = *decision;
+  stats_.hit_.inc();
+  return true;
+}
+
+void RouteCache::insert(std::string&& key, RouteConstSharedPtr route) {
+  Shard& shard = threadShard();
+  absl::MutexLock lock(&shard.mutex_);
+  if (shard.decisions_.find(key) != nullptr) {
+    // Another thread that shares the shard resolved the same request.
+    return;
+  }
+  shard.decisions_.insert(std::move(key), std::move(route));
+}
+
+RouteCache::Shard& RouteCache::threadShard() {
+  static std::atomic<uint32_t> next_shard{0};
+  static thread_local const uint32_t shard = next_shard++ % NumShards;
+  return *shards_[shard];
+}
+
+} // namespace Router
+} // namespace Envoy
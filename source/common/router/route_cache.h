@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/router/router.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/common/lru_cache.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * All route cache stats. @see stats_macros.h
+ */
+#define ALL_ROUTE_CACHE_STATS(COUNTER)                                                             \
+  COUNTER(hit)                                                                                     \
+  COUNTER(miss)
+
+/**
+ * Struct definition for all route cache stats. @see stats_macros.h
+ */
+struct RouteCacheStats {
+  ALL_ROUTE_CACHE_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * A least recently used cache of route decisions, keyed by the authority, method and path of a
+ * request. It belongs to a route configuration, so that it is dropped with it when the
+ * configuration is updated.
+ *
+ * The cache is split into shards, each holding up to max_entries decisions, and every thread uses
+ * one shard. Unless there are more threads than shards, workers do not share entries or contend on
+ * the lock of a shard. The shards are not thread local slots because the configuration may be
+ * destroyed on a worker.
+ */
+class RouteCache {
+public:
+  RouteCache(uint32_t max_entries, Stats::Scope& scope, const std::string& prefix);
+
+  /**
+   * @return the key of the decision for a request.
+   * @param host supplies the host header.
+   * @param method supplies the method.
+   * @param path supplies the path without query string and fragment.
+   */
+  static std::string key(absl::string_view host, absl::string_view method, absl::string_view path);
+
+  /**
+   * Looks up a decision, and marks it as the most recently used one of the shard.
+   * @param key supplies the key of the decision.
+   * @param route supplies the route to set to the cached decision on a hit. The decision may be
+   *        that no route matches.
+   * @return true on a hit.
+   */
+  bool lookup(const std::string& key, RouteConstSharedPtr& route);
+
+  /**
+   * Adds a decision, evicting the least recently used decision of the shard if it is full.
+   * @param key supplies the key of the decision.
+   * @param route supplies the route that was selected, or nullptr if no route matches.
+   */
+  void insert(std::string&& key, RouteConstSharedPtr route);
+
+  // The number of shards. Threads are assigned shards round robin.
+  static constexpr uint32_t NumShards = 64;
+
+private:
+  struct Shard {
+    explicit Shard(uint32_t max_entries) : decisions_(max_entries) {}
+
+    absl::Mutex mutex_;
+    LruCache<std::string, RouteConstSharedPtr> decisions_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  Shard& threadShard();
+
+  RouteCacheStats stats_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+using RouteCachePtr = std::unique_ptr<RouteCache>;
+
+} // namespace Router
+} // namespace Envoy
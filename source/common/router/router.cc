@@ -531,6 +531,18 @@ Http::FilterHeadersStatus Filter::decodeHeaders(Http::RequestHeaderMap& headers,
                                          grpc_request_, hedging_params_.hedge_on_per_try_timeout_,
                                          config_.respect_expected_rq_timeout_);
 
+  // Once the response times of the route are known, requests that take longer than most of them
+  // are hedged, unless a shorter per try timeout applies.
+  adaptive_hedge_ = route_entry_->hedgePolicy().adaptiveHedge();
+  if (adaptive_hedge_ != nullptr) {
+    const absl::optional<std::chrono::milliseconds> hedge_delay = adaptive_hedge_->onRequest();
+    if (hedge_delay.has_value() && (timeout_.per_try_timeout_.count() == 0 ||
+                                    hedge_delay.value() < timeout_.per_try_timeout_)) {
+      timeout_.per_try_timeout_ = hedge_delay.value();
+      hedging_params_.hedge_on_per_try_timeout_ = true;
+    }
+  }
+
   // If this header is set with any value, use an alternate response code on timeout
   if (headers.EnvoyUpstreamRequestTimeoutAltResponse()) {
     timeout_response_code_ = Http::Code::NoContent;
@@ -655,10 +667,14 @@ Http::FilterDataStatus Filter::decodeData(Buffer::Instance& data, bool end_strea
   ASSERT(buffering || !upstream_requests_.empty());
 
   if (buffering) {
-    // If we are going to buffer for retries or shadowing, we need to make a copy before encoding
-    // since it's all moves from here on.
+    // If we are going to buffer for retries or shadowing, the data is retained once, and the
+    // upstream request, the decoding buffer, retries and shadows all get slices that reference it
+    // rather than copies of it, since it's all moves from here on.
+    const size_t chunk = retained_body_.append(data);
+    retained_body_.addTo(data, chunk);
     if (!upstream_requests_.empty()) {
-      Buffer::OwnedImpl copy(data);
+      Buffer::OwnedImpl copy;
+      retained_body_.addTo(copy, chunk);
       upstream_requests_.front()->encodeData(copy, end_stream);
     }
 
@@ -738,7 +754,7 @@ void Filter::maybeDoShadowing() {
     Http::RequestMessagePtr request(new Http::RequestMessageImpl(
         Http::createHeaderMap<Http::RequestHeaderMapImpl>(*downstream_headers_)));
     if (callbacks_->decodingBuffer()) {
-      request->body().add(*callbacks_->decodingBuffer());
+      retained_body_.addTo(request->body());
     }
     if (downstream_trailers_) {
       request->trailers(Http::createHeaderMap<Http::RequestTrailerMapImpl>(*downstream_trailers_));
@@ -841,7 +857,9 @@ void Filter::onSoftPerTryTimeout(UpstreamRequest& upstream_request) {
                          absl::optional<uint64_t>(enumToInt(timeout_response_code_)));
   upstream_request.outlierDetectionTimeoutRecorded(true);
 
-  if (!downstream_response_started_ && retry_state_) {
+  // Hedges are charged to the hedge budget of the route before the retry policy is consulted.
+  if (!downstream_response_started_ && retry_state_ &&
+      (adaptive_hedge_ == nullptr || adaptive_hedge_->tryHedge())) {
     RetryStatus retry_status =
         retry_state_->shouldHedgeRetryPerTryTimeout([this]() -> void { doRetry(); });
 
@@ -1355,6 +1373,14 @@ void Filter::onUpstreamComplete(UpstreamRequest& upstream_request) {
   std::chrono::milliseconds response_time = std::chrono::duration_cast<std::chrono::milliseconds>(
       dispatcher.timeSource().monotonicTime() - downstream_request_complete_time_);
 
+  if (adaptive_hedge_ != nullptr && DateUtil::timePointValid(downstream_request_complete_time_)) {
+    adaptive_hedge_->onResponse(response_time);
+  }
+
+  if (DateUtil::timePointValid(downstream_request_complete_time_)) {
+    upstream_request.upstreamHost()->responseTimeMonitor().putResponseTime(response_time);
+  }
+
   Upstream::ClusterTimeoutBudgetStatsOptRef tb_stats = cluster()->timeoutBudgetStats();
   if (tb_stats.has_value()) {
     tb_stats->get().upstream_rq_timeout_budget_percent_used_.recordValue(
@@ -1563,8 +1589,9 @@ void Filter::doRetry() {
   // sure we don't encodeData on the wrong request.
   if (!upstream_requests_.empty() && (upstream_requests_.front().get() == upstream_request_tmp)) {
     if (callbacks_->decodingBuffer()) {
-      // If we are doing a retry we need to make a copy.
-      Buffer::OwnedImpl copy(*callbacks_->decodingBuffer());
+      // If we are doing a retry we need a buffer that references the retained body.
+      Buffer::OwnedImpl copy;
+      retained_body_.addTo(copy);
       upstream_requests_.front()->encodeData(copy, !downstream_trailers_ && downstream_end_stream_);
     }
 
@@ -20,6 +20,7 @@
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/access_log/access_log_impl.h"
+#include "common/buffer/buffer_impl.h"
 #include "common/buffer/watermark_buffer.h"
 #include "common/common/cleanup.h"
 #include "common/common/hash.h"
@@ -512,6 +513,7 @@ private:
   Event::TimerPtr response_timeout_;
   FilterUtility::TimeoutData timeout_;
   FilterUtility::HedgingParams hedging_params_;
+  AdaptiveHedge* adaptive_hedge_{};
   Http::Code timeout_response_code_ = Http::Code::GatewayTimeout;
   std::list<UpstreamRequestPtr> upstream_requests_;
   // Tracks which upstream request "wins" and will have the corresponding
@@ -525,6 +527,8 @@ private:
   MetadataMatchCriteriaConstPtr metadata_match_;
   std::function<void(Http::ResponseHeaderMap&)> modify_headers_;
   std::vector<std::reference_wrapper<const ShadowPolicy>> active_shadow_policies_{};
+  // The request body buffered for retries and shadows, which they reference rather than copy.
+  Buffer::SharedChunks retained_body_;
 
   // list of cookies to add to upstream headers
   std::vector<std::string> downstream_set_cookies_;
@@ -1,10 +1,49 @@
 #include "common/router/scoped_config_impl.h"
 
+#include <array>
+
 #include "envoy/config/route/v3/scoped_route.pb.h"
 #include "envoy/extensions/filters/network/http_connection_manager/v3/http_connection_manager.pb.h"
 
+#include "absl/strings/str_split.h"
+
 namespace Envoy {
 namespace Router {
+namespace {
+
+// Extracts the value of a fragment from the elements of a header value, which are split lazily so
+// that no element is copied.
+template <class Elements>
+absl::optional<absl::string_view> extractFragmentValue(
+    const ScopedRoutes::ScopeKeyBuilder::FragmentBuilder::HeaderValueExtractor& config,
+    const Elements& elements) {
+  switch (config.extract_type_case()) {
+  case ScopedRoutes::ScopeKeyBuilder::FragmentBuilder::HeaderValueExtractor::kElement:
+    for (const absl::string_view element : elements) {
+      const std::pair<absl::string_view, absl::string_view> key_value =
+          absl::StrSplit(element, absl::MaxSplits(config.element().separator(), 1));
+      if (key_value.first == config.element().key()) {
+        return key_value.second;
+      }
+    }
+    break;
+  case ScopedRoutes::ScopeKeyBuilder::FragmentBuilder::HeaderValueExtractor::kIndex: {
+    uint32_t index = 0;
+    for (const absl::string_view element : elements) {
+      if (index++ == config.index()) {
+        return element;
+      }
+    }
+    break;
+  }
+  default:                       // EXTRACT_TYPE_NOT_SET
+    NOT_REACHED_GCOVR_EXCL_LINE; // Caught in constructor already.
+  }
+
+  return absl::nullopt;
+}
+
+} // namespace
 
 bool ScopeKey::operator!=(const ScopeKey& other) const { return !(*this == other); }
 
@@ -19,7 +58,8 @@ bool ScopeKey::operator==(const ScopeKey& other) const {
 HeaderValueExtractorImpl::HeaderValueExtractorImpl(
     ScopedRoutes::ScopeKeyBuilder::FragmentBuilder&& config)
     : FragmentBuilderBase(std::move(config)),
-      header_value_extractor_config_(config_.header_value_extractor()) {
+      header_value_extractor_config_(config_.header_value_extractor()),
+      header_name_(header_value_extractor_config_.name()) {
   ASSERT(config_.type_case() ==
              ScopedRoutes::ScopeKeyBuilder::FragmentBuilder::kHeaderValueExtractor,
          "header_value_extractor is not set.");
@@ -40,39 +80,40 @@ HeaderValueExtractorImpl::HeaderValueExtractorImpl(
 
 std::unique_ptr<ScopeKeyFragmentBase>
 HeaderValueExtractorImpl::computeFragment(const Http::HeaderMap& headers) const {
-  const auto header_entry =
-      headers.get(Envoy::Http::LowerCaseString(header_value_extractor_config_.name()));
-  if (header_entry.empty()) {
+  const absl::optional<absl::string_view> value = computeFragmentValue(headers);
+  if (!value.has_value()) {
     return nullptr;
   }
+  return std::make_unique<StringKeyFragment>(value.value());
+}
 
-  // This is an implicitly untrusted header, so per the API documentation only the first
-  // value is used.
-  std::vector<absl::string_view> elements{header_entry[0]->value().getStringView()};
-  if (header_value_extractor_config_.element_separator().length() > 0) {
-    elements = absl::StrSplit(header_entry[0]->value().getStringView(),
-                              header_value_extractor_config_.element_separator());
+absl::optional<uint64_t>
+HeaderValueExtractorImpl::computeFragmentHash(const Http::HeaderMap& headers) const {
+  const absl::optional<absl::string_view> value = computeFragmentValue(headers);
+  if (!value.has_value()) {
+    return absl::nullopt;
   }
-  switch (header_value_extractor_config_.extract_type_case()) {
-  case ScopedRoutes::ScopeKeyBuilder::FragmentBuilder::HeaderValueExtractor::kElement:
-    for (const auto& element : elements) {
-      std::pair<absl::string_view, absl::string_view> key_value = absl::StrSplit(
-          element, absl::MaxSplits(header_value_extractor_config_.element().separator(), 1));
-      if (key_value.first == header_value_extractor_config_.element().key()) {
-        return std::make_unique<StringKeyFragment>(key_value.second);
-      }
-    }
-    break;
-  case ScopedRoutes::ScopeKeyBuilder::FragmentBuilder::HeaderValueExtractor::kIndex:
-    if (header_value_extractor_config_.index() < elements.size()) {
-      return std::make_unique<StringKeyFragment>(elements[header_value_extractor_config_.index()]);
-    }
-    break;
-  default:                       // EXTRACT_TYPE_NOT_SET
-    NOT_REACHED_GCOVR_EXCL_LINE; // Caught in constructor already.
+  // The hash of the StringKeyFragment of the value.
+  return HashUtil::xxHash64(value.value());
+}
+
+absl::optional<absl::string_view>
+HeaderValueExtractorImpl::computeFragmentValue(const Http::HeaderMap& headers) const {
+  const auto header_entry = headers.get(header_name_);
+  if (header_entry.empty()) {
+    return absl::nullopt;
   }
 
-  return nullptr;
+  // This is an implicitly untrusted header, so per the API documentation only the first
+  // value is used.
+  const absl::string_view header_value = header_entry[0]->value().getStringView();
+  if (header_value_extractor_config_.element_separator().empty()) {
+    return extractFragmentValue(header_value_extractor_config_,
+                                std::array<absl::string_view, 1>{header_value});
+  }
+  return extractFragmentValue(
+      header_value_extractor_config_,
+      absl::StrSplit(header_value, header_value_extractor_config_.element_separator()));
 }
 
 ScopedRouteInfo::ScopedRouteInfo(envoy::config::route::v3::ScopedRouteConfiguration&& config_proto,
@@ -118,6 +159,19 @@ ScopeKeyPtr ScopeKeyBuilderImpl::computeScopeKey(const Http::HeaderMap& headers)
   return std::make_unique<ScopeKey>(std::move(key));
 }
 
+absl::optional<uint64_t>
+ScopeKeyBuilderImpl::computeScopeKeyHash(const Http::HeaderMap& headers) const {
+  uint64_t hash = 0;
+  for (const auto& builder : fragment_builders_) {
+    const absl::optional<uint64_t> fragment_hash = builder->computeFragmentHash(headers);
+    if (!fragment_hash.has_value()) {
+      return absl::nullopt;
+    }
+    hash = ScopeKey::combineHash(hash, fragment_hash.value());
+  }
+  return hash;
+}
+
 void ScopedConfigImpl::addOrUpdateRoutingScopes(
     const std::vector<ScopedRouteInfoConstSharedPtr>& scoped_route_infos) {
   for (auto& scoped_route_info : scoped_route_infos) {
@@ -144,11 +198,12 @@ void ScopedConfigImpl::removeRoutingScopes(const std::vector<std::string>& scope
 
 Router::ConfigConstSharedPtr
 ScopedConfigImpl::getRouteConfig(const Http::HeaderMap& headers) const {
-  ScopeKeyPtr scope_key = scope_key_builder_.computeScopeKey(headers);
-  if (scope_key == nullptr) {
+  // Only the hash of the key is needed to find the scope, so the key itself is not built.
+  const absl::optional<uint64_t> scope_key_hash = scope_key_builder_.computeScopeKeyHash(headers);
+  if (!scope_key_hash.has_value()) {
     return nullptr;
   }
-  auto iter = scoped_route_info_by_key_.find(scope_key->hash());
+  auto iter = scoped_route_info_by_key_.find(scope_key_hash.value());
   if (iter != scoped_route_info_by_key_.end()) {
     return iter->second->routeConfig();
   }
@@ -16,6 +16,7 @@
 
 #include "absl/numeric/int128.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Router {
@@ -36,6 +37,10 @@ public:
   virtual std::unique_ptr<ScopeKeyFragmentBase>
   computeFragment(const Http::HeaderMap& headers) const PURE;
 
+  // Returns the hash of the fragment computeFragment() would return without building it, or
+  // absl::nullopt if no fragment could be generated from the headers.
+  virtual absl::optional<uint64_t> computeFragmentHash(const Http::HeaderMap& headers) const PURE;
+
 protected:
   const ScopedRoutes::ScopeKeyBuilder::FragmentBuilder config_;
 };
@@ -46,10 +51,15 @@ public:
 
   std::unique_ptr<ScopeKeyFragmentBase>
   computeFragment(const Http::HeaderMap& headers) const override;
+  absl::optional<uint64_t> computeFragmentHash(const Http::HeaderMap& headers) const override;
 
 private:
+  // Returns the value of the fragment as a view into the headers.
+  absl::optional<absl::string_view> computeFragmentValue(const Http::HeaderMap& headers) const;
+
   const ScopedRoutes::ScopeKeyBuilder::FragmentBuilder::HeaderValueExtractor&
       header_value_extractor_config_;
+  const Http::LowerCaseString header_name_;
 };
 
 /**
@@ -64,6 +74,10 @@ public:
   // Computes scope key for given headers, returns nullptr if a key can't be computed.
   virtual ScopeKeyPtr computeScopeKey(const Http::HeaderMap& headers) const PURE;
 
+  // Computes the hash of the scope key for given headers without allocating the key, returns
+  // absl::nullopt if a key can't be computed.
+  virtual absl::optional<uint64_t> computeScopeKeyHash(const Http::HeaderMap& headers) const PURE;
+
 protected:
   const ScopedRoutes::ScopeKeyBuilder config_;
 };
@@ -73,6 +87,7 @@ public:
   explicit ScopeKeyBuilderImpl(ScopedRoutes::ScopeKeyBuilder&& config);
 
   ScopeKeyPtr computeScopeKey(const Http::HeaderMap& headers) const override;
+  absl::optional<uint64_t> computeScopeKeyHash(const Http::HeaderMap& headers) const override;
 
 private:
   std::vector<std::unique_ptr<FragmentBuilderBase>> fragment_builders_;
@@ -18,6 +18,7 @@
 #include "common/common/empty_string.h"
 #include "common/common/enum_to_int.h"
 #include "common/common/scope_tracker.h"
+#include "common/common/stage_trace.h"
 #include "common/common/utility.h"
 #include "common/grpc/common.h"
 #include "common/http/codes.h"
@@ -136,6 +137,8 @@ void UpstreamRequest::decodeHeaders(Http::ResponseHeaderMapPtr&& headers, bool e
   // TODO(rodaine): This is actually measuring after the headers are parsed and not the first
   // byte.
   upstream_timing_.onFirstUpstreamRxByteReceived(parent_.callbacks()->dispatcher().timeSource());
+  STAGE_TRACE(StageTrace::Stage::UpstreamFirstByte, downstreamConnectionId(),
+              parent_.callbacks()->streamId());
   maybeEndDecode(end_stream);
 
   awaiting_headers_ = false;
@@ -171,6 +174,12 @@ void UpstreamRequest::decodeTrailers(Http::ResponseTrailerMapPtr&& trailers) {
 }
 const RouteEntry& UpstreamRequest::routeEntry() const { return *parent_.routeEntry(); }
 
+uint64_t UpstreamRequest::downstreamConnectionId() const {
+  // The requests of the async clients have no downstream connection.
+  const Network::Connection* connection = parent_.callbacks()->connection();
+  return connection != nullptr ? connection->id() : 0;
+}
+
 const Network::Connection& UpstreamRequest::connection() const {
   return *parent_.callbacks()->connection();
 }
@@ -211,6 +220,7 @@ void UpstreamRequest::encodeData(Buffer::Instance& data, bool end_stream) {
           [this]() -> void { this->enableDataFromDownstreamForFlowControl(); },
           [this]() -> void { this->disableDataFromDownstreamForFlowControl(); },
           []() -> void { /* TODO(adisuissa): Handle overflow watermark */ });
+      buffered_request_body_->bindAccount(parent_.callbacks()->account());
       buffered_request_body_->setWatermarks(parent_.callbacks()->decoderBufferLimit());
     }
 
@@ -352,6 +362,8 @@ void UpstreamRequest::onPoolReady(
   // This may be called under an existing ScopeTrackerScopeState but it will unwind correctly.
   ScopeTrackerScopeState scope(&parent_.callbacks()->scope(), parent_.callbacks()->dispatcher());
   ENVOY_STREAM_LOG(debug, "pool ready", *parent_.callbacks());
+  STAGE_TRACE(StageTrace::Stage::UpstreamConnected, downstreamConnectionId(),
+              parent_.callbacks()->streamId());
   upstream_ = std::move(upstream);
 
   if (parent_.requestVcluster()) {
@@ -125,6 +125,7 @@ private:
     return encode_complete_ && !buffered_request_body_ && !encode_trailers_ &&
            downstream_metadata_map_vector_.empty();
   }
+  uint64_t downstreamConnectionId() const;
 
   RouterFilterInterface& parent_;
   std::unique_ptr<GenericConnPool> conn_pool_;
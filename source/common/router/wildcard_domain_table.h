@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include "common/common/radix_tree.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * A radix tree over the wildcard domains of the virtual hosts of a route configuration. Suffix
+ * wildcards such as "*.example.com" are stored by their reversed suffix, so that the longest
+ * wildcard matching a host is found in a single pass over the host, however many wildcards of
+ * different lengths there are.
+ *
+ * Domains and hosts are compared byte by byte, so both must be lower cased. Value must be a pointer
+ * type, and values must not be null.
+ */
+template <class Value> class WildcardDomainTable {
+public:
+  enum class Type {
+    // Domains such as "*.example.com", stored without the leading '*'.
+    Suffix,
+    // Domains such as "example.*", stored without the trailing '*'.
+    Prefix
+  };
+
+  explicit WildcardDomainTable(Type type) : type_(type) {}
+
+  /**
+   * Adds a wildcard domain.
+   * @param domain supplies the domain without the '*'.
+   * @param value supplies the value associated with the domain.
+   * @return false if the domain was already added.
+   */
+  bool add(absl::string_view domain, Value value) {
+    const std::string key = type_ == Type::Suffix ? std::string(domain.rbegin(), domain.rend())
+                                                  : std::string(domain);
+    Value& node_value = tree_.findOrCreate(key);
+    if (node_value) {
+      return false;
+    }
+    node_value = std::move(value);
+    empty_ = false;
+    return true;
+  }
+
+  /**
+   * Finds the longest wildcard domain matching a host. The wildcard must match at least one byte,
+   * so "*.example.com" does not match ".example.com".
+   * @param host supplies the lower cased host.
+   * @return the value of the longest matching domain, or nullptr if none match.
+   */
+  const Value* find(absl::string_view host) const {
+    const Value* result = nullptr;
+    tree_.walk(
+        host.size(), [this, host](size_t position) { return at(host, position); },
+        [&result, host](const Value& value, size_t matched) {
+          // The wildcard must match at least one byte.
+          if (matched == host.size()) {
+            return false;
+          }
+          if (value) {
+            result = &value;
+          }
+          return true;
+        });
+    return result;
+  }
+
+  /**
+   * @return true if no domains were added.
+   */
+  bool empty() const { return empty_; }
+
+private:
+  // The byte of the host at a position in the order that keys are stored in.
+  char at(absl::string_view host, size_t position) const {
+    return type_ == Type::Suffix ? host[host.size() - 1 - position] : host[position];
+  }
+
+  const Type type_;
+  RadixTree<Value> tree_;
+  bool empty_{true};
+};
+
+} // namespace Router
+} // namespace Envoy
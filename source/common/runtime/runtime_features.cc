@@ -106,8 +106,30 @@ constexpr const char* disabled_runtime_features[] = {
     "envoy.reloadable_features.enable_type_url_downgrade_and_upgrade",
     // TODO(alyssawilk) flip true after the release.
     "envoy.reloadable_features.new_tcp_connection_pool",
+    // Opt-in while the vectorized HTTP/1 parser gains production experience.
+    "envoy.reloadable_features.http1_use_simd_parser",
+    // Opt-in while per-stream header map arenas gain production experience.
+    "envoy.reloadable_features.http_header_map_arena",
+    // Opt-in while splicing of received HTTP/1 header lines gains production experience.
+    "envoy.reloadable_features.http1_raw_header_passthrough",
+    // Opt-in while per-stream filter chain arenas gain production experience.
+    "envoy.reloadable_features.http_filter_chain_arena",
+    // Opt-in as it keeps the resources of the last accepted state of the world xDS update of each
+    // type in memory, and unchanged resources skip the deprecated field checks of later updates.
+    "envoy.reloadable_features.memoize_sotw_resource_decoding",
+    // Opt-in as it keeps the recent peer addresses of each listener of each worker in memory.
+    "envoy.reloadable_features.listener_address_cache",
+    // Opt-in while sharing unchanged virtual hosts between RDS updates gains production experience.
+    "envoy.reloadable_features.rds_reuse_virtual_hosts",
     // TODO(yanavlasov) flip true after all tests for upstream flood checks are implemented
     "envoy.reloadable_features.upstream_http2_flood_checks",
+    // Opt-in while the splice() fast path of the TCP proxy gains production experience.
+    "envoy.reloadable_features.tcp_proxy_splice",
+    // Opt-in as it depends on the tls module of the host kernel.
+    "envoy.reloadable_features.tls_kernel_offload",
+    // Opt-in as host weight changes that do not update the host set only apply to the stride
+    // schedules of weighted load balancers on the next host set update.
+    "envoy.reloadable_features.weighted_lb_stride_scheduler",
     // Sentinel and test flag.
     "envoy.reloadable_features.test_feature_false",
 };
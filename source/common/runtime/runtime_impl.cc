@@ -97,7 +97,7 @@ Snapshot::ConstStringOptRef SnapshotImpl::get(absl::string_view key) const {
   if (entry == values_.end()) {
     return absl::nullopt;
   } else {
-    return entry->second.raw_string_value_;
+    return entry->second->raw_string_value_;
   }
 }
 
@@ -110,25 +110,27 @@ bool SnapshotImpl::featureEnabled(absl::string_view key,
                                   const envoy::type::v3::FractionalPercent& default_value,
                                   uint64_t random_value) const {
   const auto& entry = key.empty() ? values_.end() : values_.find(key);
-  envoy::type::v3::FractionalPercent percent;
-  if (entry != values_.end() && entry->second.fractional_percent_value_.has_value()) {
-    percent = entry->second.fractional_percent_value_.value();
-  } else if (entry != values_.end() && entry->second.uint_value_.has_value()) {
+  envoy::type::v3::FractionalPercent uint_percent;
+  // The parsed value of the entry is used in place rather than copied.
+  const envoy::type::v3::FractionalPercent* percent_ptr = &default_value;
+  if (entry != values_.end() && entry->second->fractional_percent_value_.has_value()) {
+    percent_ptr = &entry->second->fractional_percent_value_.value();
+  } else if (entry != values_.end() && entry->second->uint_value_.has_value()) {
     // Check for > 100 because the runtime value is assumed to be specified as
     // an integer, and it also ensures that truncating the uint64_t runtime
     // value into a uint32_t percent numerator later is safe
-    if (entry->second.uint_value_.value() > 100) {
+    if (entry->second->uint_value_.value() > 100) {
       return true;
     }
 
     // The runtime value was specified as an integer rather than a fractional
     // percent proto. To preserve legacy semantics, we treat it as a percentage
     // (i.e. denominator of 100).
-    percent.set_numerator(entry->second.uint_value_.value());
-    percent.set_denominator(envoy::type::v3::FractionalPercent::HUNDRED);
-  } else {
-    percent = default_value;
+    uint_percent.set_numerator(entry->second->uint_value_.value());
+    uint_percent.set_denominator(envoy::type::v3::FractionalPercent::HUNDRED);
+    percent_ptr = &uint_percent;
   }
+  const envoy::type::v3::FractionalPercent& percent = *percent_ptr;
 
   // When numerator > denominator condition is always evaluates to TRUE
   // It becomes hard to debug why configuration does not work in case of wrong numerator.
@@ -148,43 +150,42 @@ bool SnapshotImpl::featureEnabled(absl::string_view key,
 uint64_t SnapshotImpl::getInteger(absl::string_view key, uint64_t default_value) const {
   ASSERT(!isRuntimeFeature(key));
   const auto& entry = key.empty() ? values_.end() : values_.find(key);
-  if (entry == values_.end() || !entry->second.uint_value_) {
+  if (entry == values_.end() || !entry->second->uint_value_) {
     return default_value;
   } else {
-    return entry->second.uint_value_.value();
+    return entry->second->uint_value_.value();
   }
 }
 
 double SnapshotImpl::getDouble(absl::string_view key, double default_value) const {
   ASSERT(!isRuntimeFeature(key)); // Make sure runtime guarding is only used for getBoolean
   const auto& entry = key.empty() ? values_.end() : values_.find(key);
-  if (entry == values_.end() || !entry->second.double_value_) {
+  if (entry == values_.end() || !entry->second->double_value_) {
     return default_value;
   } else {
-    return entry->second.double_value_.value();
+    return entry->second->double_value_.value();
   }
 }
 
 bool SnapshotImpl::getBoolean(absl::string_view key, bool default_value) const {
   const auto& entry = key.empty() ? values_.end() : values_.find(key);
-  if (entry == values_.end() || !entry->second.bool_value_.has_value()) {
+  if (entry == values_.end() || !entry->second->bool_value_.has_value()) {
     return default_value;
   } else {
-    return entry->second.bool_value_.value();
+    return entry->second->bool_value_.value();
   }
 }
 
-const std::vector<Snapshot::OverrideLayerConstPtr>& SnapshotImpl::getLayers() const {
+const std::vector<Snapshot::OverrideLayerConstSharedPtr>& SnapshotImpl::getLayers() const {
   return layers_;
 }
 
 SnapshotImpl::SnapshotImpl(Random::RandomGenerator& generator, RuntimeStats& stats,
-                           std::vector<OverrideLayerConstPtr>&& layers)
+                           std::vector<OverrideLayerConstSharedPtr>&& layers)
     : layers_{std::move(layers)}, generator_{generator}, stats_{stats} {
   for (const auto& layer : layers_) {
     for (const auto& kv : layer->values()) {
-      values_.erase(kv.first);
-      values_.emplace(kv.first, kv.second);
+      values_.insert_or_assign(absl::string_view(kv.first), &kv.second);
     }
   }
   stats.num_keys_.set(values_.size());
@@ -386,7 +387,7 @@ LoaderImpl::LoaderImpl(Event::Dispatcher& dispatcher, ThreadLocal::SlotAllocator
         throw EnvoyException(
             "Too many admin layers specified in LayeredRuntime, at most one may be specified");
       }
-      admin_layer_ = std::make_unique<AdminLayer>(layer.name(), stats_);
+      admin_layer_ = std::make_shared<const AdminLayer>(layer.name(), stats_);
       break;
     case envoy::config::bootstrap::v3::RuntimeLayer::LayerSpecifierCase::kDiskLayer:
       if (watcher_ == nullptr) {
@@ -453,6 +454,7 @@ void RtdsSubscription::onConfigUpdate(const std::vector<Config::DecodedResourceR
   }
   ENVOY_LOG(debug, "Reloading RTDS snapshot for onConfigUpdate");
   proto_.CopyFrom(runtime.layer());
+  layer_.reset();
   parent_.loadNewSnapshot();
   init_target_.ready();
 }
@@ -500,6 +502,7 @@ void RtdsSubscription::onConfigRemoved(
   }
   ENVOY_LOG(debug, "Clear RTDS snapshot for onConfigUpdate");
   proto_.Clear();
+  layer_.reset();
   parent_.loadNewSnapshot();
   init_target_.ready();
 }
@@ -537,7 +540,10 @@ void LoaderImpl::mergeValues(const absl::node_hash_map<std::string, std::string>
   if (admin_layer_ == nullptr) {
     throw EnvoyException("No admin layer specified");
   }
-  admin_layer_->mergeValues(values);
+  // The snapshots share the current admin layer, so the values are merged into a copy of it.
+  auto admin_layer = std::make_shared<AdminLayer>(*admin_layer_);
+  admin_layer->mergeValues(values);
+  admin_layer_ = std::move(admin_layer);
   loadNewSnapshot();
 }
 
@@ -553,14 +559,19 @@ RuntimeStats LoaderImpl::generateStats(Stats::Store& store) {
 }
 
 SnapshotImplPtr LoaderImpl::createNewSnapshot() {
-  std::vector<Snapshot::OverrideLayerConstPtr> layers;
+  std::vector<Snapshot::OverrideLayerConstSharedPtr> layers;
   uint32_t disk_layers = 0;
   uint32_t error_layers = 0;
+  uint32_t static_layer = 0;
   uint32_t rtds_layer = 0;
   for (const auto& layer : config_.layers()) {
     switch (layer.layer_specifier_case()) {
     case envoy::config::bootstrap::v3::RuntimeLayer::LayerSpecifierCase::kStaticLayer:
-      layers.emplace_back(std::make_unique<const ProtoLayer>(layer.name(), layer.static_layer()));
+      if (static_layer == static_layers_.size()) {
+        static_layers_.emplace_back(
+            std::make_shared<const ProtoLayer>(layer.name(), layer.static_layer()));
+      }
+      layers.push_back(static_layers_[static_layer++]);
       break;
     case envoy::config::bootstrap::v3::RuntimeLayer::LayerSpecifierCase::kDiskLayer: {
       std::string path =
@@ -570,7 +581,9 @@ SnapshotImplPtr LoaderImpl::createNewSnapshot() {
       }
       if (api_.fileSystem().directoryExists(path)) {
         try {
-          layers.emplace_back(std::make_unique<DiskLayer>(layer.name(), path, api_));
+          // The disk layers are read again for every snapshot, as the counters of the loads
+          // account for them.
+          layers.emplace_back(std::make_shared<const DiskLayer>(layer.name(), path, api_));
           ++disk_layers;
         } catch (EnvoyException& e) {
           // TODO(htuch): Consider latching here, rather than ignoring the
@@ -583,11 +596,15 @@ SnapshotImplPtr LoaderImpl::createNewSnapshot() {
       break;
     }
     case envoy::config::bootstrap::v3::RuntimeLayer::LayerSpecifierCase::kAdminLayer:
-      layers.push_back(std::make_unique<AdminLayer>(*admin_layer_));
+      layers.push_back(admin_layer_);
       break;
     case envoy::config::bootstrap::v3::RuntimeLayer::LayerSpecifierCase::kRtdsLayer: {
       auto* subscription = subscriptions_[rtds_layer++].get();
-      layers.emplace_back(std::make_unique<const ProtoLayer>(layer.name(), subscription->proto_));
+      if (subscription->layer_ == nullptr) {
+        subscription->layer_ =
+            std::make_shared<const ProtoLayer>(layer.name(), subscription->proto_);
+      }
+      layers.push_back(subscription->layer_);
       break;
     }
     default:
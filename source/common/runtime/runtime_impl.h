@@ -29,6 +29,7 @@
 #include "common/init/target_impl.h"
 #include "common/singleton/threadsafe_singleton.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 #include "spdlog/spdlog.h"
 
@@ -59,12 +60,14 @@ struct RuntimeStats {
 };
 
 /**
- * Implementation of Snapshot whose source is the vector of layers passed to the constructor.
+ * Implementation of Snapshot whose source is the vector of layers passed to the constructor. The
+ * layers are immutable, so the entries are not copied out of them and successive snapshots share
+ * the layers that did not change.
  */
 class SnapshotImpl : public Snapshot, Logger::Loggable<Logger::Id::runtime> {
 public:
   SnapshotImpl(Random::RandomGenerator& generator, RuntimeStats& stats,
-               std::vector<OverrideLayerConstPtr>&& layers);
+               std::vector<OverrideLayerConstSharedPtr>&& layers);
 
   // Runtime::Snapshot
   bool deprecatedFeatureEnabled(absl::string_view key, bool default_value) const override;
@@ -83,7 +86,7 @@ public:
   uint64_t getInteger(absl::string_view key, uint64_t default_value) const override;
   double getDouble(absl::string_view key, double default_value) const override;
   bool getBoolean(absl::string_view key, bool value) const override;
-  const std::vector<OverrideLayerConstPtr>& getLayers() const override;
+  const std::vector<OverrideLayerConstSharedPtr>& getLayers() const override;
 
   static Entry createEntry(const std::string& value);
   static Entry createEntry(const ProtobufWkt::Value& value);
@@ -110,8 +113,10 @@ private:
   static bool parseEntryDoubleValue(Entry& entry);
   static void parseEntryFractionalPercentValue(Entry& entry);
 
-  const std::vector<OverrideLayerConstPtr> layers_;
-  EntryMap values_;
+  const std::vector<OverrideLayerConstSharedPtr> layers_;
+  // The entry of each key in the topmost layer that has it. The keys and entries are owned by the
+  // layers.
+  absl::flat_hash_map<absl::string_view, const Entry*> values_;
   Random::RandomGenerator& generator_;
   RuntimeStats& stats_;
 };
@@ -158,7 +163,7 @@ private:
   RuntimeStats& stats_;
 };
 
-using AdminLayerPtr = std::unique_ptr<AdminLayer>;
+using AdminLayerConstSharedPtr = std::shared_ptr<const AdminLayer>;
 
 /**
  * Extension of OverrideLayerImpl that loads values from the file system upon construction.
@@ -217,6 +222,9 @@ struct RtdsSubscription : Envoy::Config::SubscriptionBase<envoy::service::runtim
   std::string resource_name_;
   Init::TargetImpl init_target_;
   ProtobufWkt::Struct proto_;
+  // The layer of the snapshots, built from proto_ when the next snapshot is created after it
+  // changes.
+  Snapshot::OverrideLayerConstSharedPtr layer_;
 };
 
 using RtdsSubscriptionPtr = std::unique_ptr<RtdsSubscription>;
@@ -256,7 +264,10 @@ private:
 
   Random::RandomGenerator& generator_;
   RuntimeStats stats_;
-  AdminLayerPtr admin_layer_;
+  // Copied on write, as the snapshots share it.
+  AdminLayerConstSharedPtr admin_layer_;
+  // The static layers never change, so they are built once.
+  std::vector<Snapshot::OverrideLayerConstSharedPtr> static_layers_;
   ThreadLocal::SlotPtr tls_;
   const envoy::config::bootstrap::v3::LayeredRuntime config_;
   const std::string service_cluster_;
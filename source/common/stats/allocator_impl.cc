@@ -1,5 +1,7 @@
 #include "common/stats/allocator_impl.h"
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 
 #include "envoy/stats/stats.h"
@@ -144,6 +146,67 @@ private:
   std::atomic<uint64_t> pending_increment_{0};
 };
 
+// A counter whose increments go to per-thread shards, so that the threads incrementing a hot
+// counter do not contend on the cache line of its value. The shards are summed when the counter is
+// read or latched, which the main thread does at flush time and for the admin endpoints.
+class ShardedCounterImpl : public StatsSharedImpl<Counter> {
+public:
+  ShardedCounterImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
+                     const StatNameTagVector& stat_name_tags)
+      : StatsSharedImpl(name, alloc, tag_extracted_name, stat_name_tags) {}
+
+  void removeFromSetLockHeld() ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc_.mutex_) override {
+    const size_t count = alloc_.counters_.erase(statName());
+    ASSERT(count == 1);
+  }
+
+  // Stats::Counter
+  void add(uint64_t amount) override {
+    // A thread owns its shard unless there are more threads than shards, so the relaxed increment
+    // does not move the cache line between cores.
+    shards_[threadShard()].value_.fetch_add(amount, std::memory_order_relaxed);
+    // Only write the shared flags the first time, as the write would contend like the increment.
+    if (!(flags_.load(std::memory_order_relaxed) & Flags::Used)) {
+      flags_ |= Flags::Used;
+    }
+  }
+  void inc() override { add(1); }
+  uint64_t latch() override {
+    const uint64_t value = this->value();
+    const uint64_t latched_value = latched_value_.exchange(value);
+    // The counter was reset since the last latch.
+    return value >= latched_value ? value - latched_value : value;
+  }
+  void reset() override {
+    for (auto& shard : shards_) {
+      shard.value_ = 0;
+    }
+  }
+  uint64_t value() const override {
+    uint64_t value = 0;
+    for (const auto& shard : shards_) {
+      value += shard.value_.load(std::memory_order_relaxed);
+    }
+    return value;
+  }
+
+private:
+  static constexpr uint32_t NumShards = 8;
+
+  static uint32_t threadShard() {
+    static std::atomic<uint32_t> next_shard{0};
+    static thread_local const uint32_t shard = next_shard++ % NumShards;
+    return shard;
+  }
+
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> value_{0};
+  };
+
+  std::array<Shard, NumShards> shards_;
+  std::atomic<uint64_t> latched_value_{0};
+};
+
 class GaugeImpl : public StatsSharedImpl<Gauge> {
 public:
   GaugeImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
@@ -173,18 +236,19 @@ public:
   // Stats::Gauge
   void add(uint64_t amount) override {
     child_value_ += amount;
-    flags_ |= Flags::Used;
+    flags_ |= Flags::Used | Flags::Changed;
   }
   void dec() override { sub(1); }
   void inc() override { add(1); }
   void set(uint64_t value) override {
     child_value_ = value;
-    flags_ |= Flags::Used;
+    flags_ |= Flags::Used | Flags::Changed;
   }
   void sub(uint64_t amount) override {
     ASSERT(child_value_ >= amount);
     ASSERT(used() || amount == 0);
     child_value_ -= amount;
+    flags_ |= Flags::Changed;
   }
   uint64_t value() const override { return child_value_ + parent_value_; }
 
@@ -219,12 +283,16 @@ public:
       // we clear the accumulated value.
       parent_value_ = 0;
       flags_ &= ~Flags::Used;
-      flags_ |= Flags::NeverImport;
+      flags_ |= Flags::NeverImport | Flags::Changed;
       break;
     }
   }
 
-  void setParentValue(uint64_t value) override { parent_value_ = value; }
+  void setParentValue(uint64_t value) override {
+    parent_value_ = value;
+    flags_ |= Flags::Changed;
+  }
+  bool latchChanged() override { return flags_.fetch_and(~Flags::Changed) & Flags::Changed; }
 
 private:
   std::atomic<uint64_t> parent_value_{0};
@@ -247,11 +315,13 @@ public:
     std::string value_copy(value);
     absl::MutexLock lock(&mutex_);
     value_ = std::move(value_copy);
+    flags_ |= Flags::Changed;
   }
   std::string value() const override {
     absl::MutexLock lock(&mutex_);
     return value_;
   }
+  bool latchChanged() override { return flags_.fetch_and(~Flags::Changed) & Flags::Changed; }
 
 private:
   mutable absl::Mutex mutex_;
@@ -313,6 +383,9 @@ bool AllocatorImpl::isMutexLockedForTest() {
 
 Counter* AllocatorImpl::makeCounterInternal(StatName name, StatName tag_extracted_name,
                                             const StatNameTagVector& stat_name_tags) {
+  if (shard_counters_) {
+    return new ShardedCounterImpl(name, *this, tag_extracted_name, stat_name_tags);
+  }
   return new CounterImpl(name, *this, tag_extracted_name, stat_name_tags);
 }
 
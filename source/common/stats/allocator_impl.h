@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <vector>
 
 #include "envoy/stats/allocator.h"
@@ -32,6 +33,7 @@ public:
                                        const StatNameTagVector& stat_name_tags) override;
   SymbolTable& symbolTable() override { return symbol_table_; }
   const SymbolTable& constSymbolTable() const override { return symbol_table_; }
+  void setCounterSharding(bool shard_counters) override { shard_counters_ = shard_counters; }
 
 #ifndef ENVOY_CONFIG_COVERAGE
   void debugPrint();
@@ -54,6 +56,7 @@ protected:
 private:
   template <class BaseClass> friend class StatsSharedImpl;
   friend class CounterImpl;
+  friend class ShardedCounterImpl;
   friend class GaugeImpl;
   friend class TextReadoutImpl;
   friend class NotifyingAllocatorImpl;
@@ -75,6 +78,8 @@ private:
   Thread::MutexBasicLockable mutex_;
 
   Thread::ThreadSynchronizer sync_;
+
+  std::atomic<bool> shard_counters_{false};
 };
 
 } // namespace Stats
@@ -9,6 +9,8 @@
 #include "common/stats/scope_prefixer.h"
 #include "common/stats/utility.h"
 
+#include "absl/strings/match.h"
+
 namespace Envoy {
 namespace Stats {
 
@@ -36,6 +38,31 @@ IsolatedStoreImpl::IsolatedStoreImpl(SymbolTable& symbol_table)
       null_counter_(new NullCounterImpl(symbol_table)),
       null_gauge_(new NullGaugeImpl(symbol_table)) {}
 
+namespace {
+
+template <class StatType>
+std::vector<RefcountPtr<StatType>> selectFrom(std::vector<RefcountPtr<StatType>>&& stats,
+                                              absl::string_view prefix, bool used_only) {
+  stats.erase(std::remove_if(stats.begin(), stats.end(),
+                             [prefix, used_only](const RefcountPtr<StatType>& stat) {
+                               return (used_only && !stat->used()) ||
+                                      (!prefix.empty() && !absl::StartsWith(stat->name(), prefix));
+                             }),
+              stats.end());
+  return std::move(stats);
+}
+
+} // namespace
+
+SelectedStats IsolatedStoreImpl::selectStats(absl::string_view prefix, bool used_only) const {
+  // Isolated stores are small, so the stats are simply filtered by name.
+  SelectedStats selected;
+  selected.counters_ = selectFrom(counters(), prefix, used_only);
+  selected.gauges_ = selectFrom(gauges(), prefix, used_only);
+  selected.text_readouts_ = selectFrom(textReadouts(), prefix, used_only);
+  return selected;
+}
+
 ScopePtr IsolatedStoreImpl::createScope(const std::string& name) {
   return std::make_unique<ScopePrefixer>(name, *this);
 }
@@ -186,6 +186,7 @@ public:
   std::vector<TextReadoutSharedPtr> textReadouts() const override {
     return text_readouts_.toVector();
   }
+  SelectedStats selectStats(absl::string_view prefix, bool used_only) const override;
 
   Counter& counterFromString(const std::string& name) override {
     StatNameManagedStorage storage(name, symbolTable());
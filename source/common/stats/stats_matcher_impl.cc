@@ -5,6 +5,7 @@
 
 #include "envoy/config/metrics/v3/stats.pb.h"
 
+#include "common/common/regex.h"
 #include "common/common/utility.h"
 
 namespace Envoy {
@@ -20,16 +21,12 @@ StatsMatcherImpl::StatsMatcherImpl(const envoy::config::metrics::v3::StatsConfig
     break;
   case envoy::config::metrics::v3::StatsMatcher::StatsMatcherCase::kInclusionList:
     // If we have an inclusion list, we are being default-exclusive.
-    for (const auto& stats_matcher : config.stats_matcher().inclusion_list().patterns()) {
-      matchers_.push_back(Matchers::StringMatcherImpl(stats_matcher));
-    }
+    addMatchers(config.stats_matcher().inclusion_list().patterns());
     is_inclusive_ = false;
     break;
   case envoy::config::metrics::v3::StatsMatcher::StatsMatcherCase::kExclusionList:
     // If we have an exclusion list, we are being default-inclusive.
-    for (const auto& stats_matcher : config.stats_matcher().exclusion_list().patterns()) {
-      matchers_.push_back(Matchers::StringMatcherImpl(stats_matcher));
-    }
+    addMatchers(config.stats_matcher().exclusion_list().patterns());
     FALLTHRU;
   default:
     // No matcher was supplied, so we default to inclusion.
@@ -38,6 +35,22 @@ StatsMatcherImpl::StatsMatcherImpl(const envoy::config::metrics::v3::StatsConfig
   }
 }
 
+void StatsMatcherImpl::addMatchers(
+    const Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher>& patterns) {
+  std::vector<const envoy::type::matcher::v3::RegexMatcher*> regexes;
+  for (const auto& stats_matcher : patterns) {
+    // StringMatcherImpl rejects the safe regexes with ignore_case.
+    if (stats_matcher.has_safe_regex() && !stats_matcher.ignore_case()) {
+      regexes.push_back(&stats_matcher.safe_regex());
+    } else {
+      matchers_.push_back(Matchers::StringMatcherImpl(stats_matcher));
+    }
+  }
+  if (!regexes.empty()) {
+    regex_set_ = Regex::Utility::parseRegexSet(regexes);
+  }
+}
+
 bool StatsMatcherImpl::rejects(const std::string& name) const {
   //
   //  is_inclusive_ | match | return
@@ -49,8 +62,10 @@ bool StatsMatcherImpl::rejects(const std::string& name) const {
   //
   // This is an XNOR, which can be evaluated by checking for equality.
 
-  return (is_inclusive_ == std::any_of(matchers_.begin(), matchers_.end(),
-                                       [&name](auto& matcher) { return matcher.match(name); }));
+  return (is_inclusive_ ==
+          (std::any_of(matchers_.begin(), matchers_.end(),
+                       [&name](auto& matcher) { return matcher.match(name); }) ||
+           (regex_set_ != nullptr && regex_set_->matchAny(name))));
 }
 
 } // namespace Stats
@@ -2,6 +2,7 @@
 
 #include <string>
 
+#include "envoy/common/regex.h"
 #include "envoy/config/metrics/v3/stats.pb.h"
 #include "envoy/stats/stats_matcher.h"
 
@@ -25,15 +26,24 @@ public:
 
   // StatsMatcher
   bool rejects(const std::string& name) const override;
-  bool acceptsAll() const override { return is_inclusive_ && matchers_.empty(); }
-  bool rejectsAll() const override { return !is_inclusive_ && matchers_.empty(); }
+  bool acceptsAll() const override {
+    return is_inclusive_ && matchers_.empty() && regex_set_ == nullptr;
+  }
+  bool rejectsAll() const override {
+    return !is_inclusive_ && matchers_.empty() && regex_set_ == nullptr;
+  }
 
 private:
+  void addMatchers(const Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher>&
+                       patterns);
+
   // Bool indicating whether or not the StatsMatcher is including or excluding stats by default. See
   // StatsMatcherImpl::rejects() for much more detail.
   bool is_inclusive_{true};
 
   std::vector<Matchers::StringMatcherImpl> matchers_;
+  // The safe regex patterns, matched in a single scan of the names.
+  Regex::CompiledMatcherSetPtr regex_set_;
 };
 
 } // namespace Stats
@@ -8,6 +8,7 @@
 #include "common/common/assert.h"
 #include "common/common/logger.h"
 #include "common/common/utility.h"
+#include "common/memory/accounting.h"
 
 #include "absl/strings/str_cat.h"
 
@@ -157,7 +158,7 @@ void SymbolTableImpl::Encoding::decodeTokens(
 std::vector<absl::string_view> SymbolTableImpl::decodeStrings(const SymbolTable::Storage array,
                                                               size_t size) const {
   std::vector<absl::string_view> strings;
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   Encoding::decodeTokens(
       array, size,
       [this, &strings](Symbol symbol)
@@ -192,6 +193,10 @@ SymbolTableImpl::~SymbolTableImpl() {
   // is needed in production. But it would be good to ensure clean up during
   // tests.
   ASSERT(numSymbols() == 0);
+  for (const auto& decode : decode_map_) {
+    Memory::Accounting::free(Memory::Accounting::Account::SymbolTable,
+                             decode.second->toStringView().size());
+  }
 }
 
 // TODO(ambuc): There is a possible performance optimization here for avoiding
@@ -211,7 +216,7 @@ void SymbolTableImpl::addTokensToEncoding(const absl::string_view name, Encoding
   // Now take the lock and populate the Symbol objects, which involves bumping
   // ref-counts in this.
   {
-    Thread::LockGuard lock(lock_);
+    absl::MutexLock lock(&lock_);
     recent_lookups_.lookup(name);
     for (auto& token : tokens) {
       // TODO(jmarantz): consider using StatNameDynamicStorage for tokens with
@@ -227,7 +232,7 @@ void SymbolTableImpl::addTokensToEncoding(const absl::string_view name, Encoding
 }
 
 uint64_t SymbolTableImpl::numSymbols() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   ASSERT(encode_map_.size() == decode_map_.size());
   return encode_map_.size();
 }
@@ -240,7 +245,8 @@ void SymbolTableImpl::incRefCount(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name.data(), stat_name.dataSize());
 
-  Thread::LockGuard lock(lock_);
+  // The symbols of a live stat name exist, so only their ref-counts are updated.
+  absl::ReaderMutexLock lock(&lock_);
   for (Symbol symbol : symbols) {
     auto decode_search = decode_map_.find(symbol);
 
@@ -254,7 +260,7 @@ void SymbolTableImpl::incRefCount(const StatName& stat_name) {
            "https://github.com/envoyproxy/envoy/blob/master/source/docs/stats.md#"
            "debugging-symbol-table-asserts");
 
-    ++encode_search->second.ref_count_;
+    encode_search->second.ref_count_.fetch_add(1, std::memory_order_relaxed);
   }
 }
 
@@ -262,21 +268,41 @@ void SymbolTableImpl::free(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name.data(), stat_name.dataSize());
 
-  Thread::LockGuard lock(lock_);
-  for (Symbol symbol : symbols) {
-    auto decode_search = decode_map_.find(symbol);
-    ASSERT(decode_search != decode_map_.end());
+  // The ref-counts are decremented with the lock held shared, and only the symbols that are no
+  // longer referenced are removed with the lock held exclusively.
+  SymbolVec unreferenced_symbols;
+  {
+    absl::ReaderMutexLock lock(&lock_);
+    for (Symbol symbol : symbols) {
+      auto decode_search = decode_map_.find(symbol);
+      ASSERT(decode_search != decode_map_.end());
 
+      auto encode_search = encode_map_.find(decode_search->second->toStringView());
+      ASSERT(encode_search != encode_map_.end());
+
+      if (encode_search->second.ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        unreferenced_symbols.push_back(symbol);
+      }
+    }
+  }
+  if (unreferenced_symbols.empty()) {
+    return;
+  }
+
+  absl::MutexLock lock(&lock_);
+  for (Symbol symbol : unreferenced_symbols) {
+    // Between the two critical sections, the symbol may have been encoded again, and may even
+    // have been freed again and removed by another thread, so it is only removed if it still
+    // exists and is not referenced.
+    auto decode_search = decode_map_.find(symbol);
+    if (decode_search == decode_map_.end()) {
+      continue;
+    }
     auto encode_search = encode_map_.find(decode_search->second->toStringView());
     ASSERT(encode_search != encode_map_.end());
-
-    // If that was the last remaining client usage of the symbol, erase the
-    // current mappings and add the now-unused symbol to the reuse pool.
-    //
-    // The "if (--EXPR.ref_count_)" pattern speeds up BM_CreateRace by 20% in
-    // symbol_table_speed_test.cc, relative to breaking out the decrement into a
-    // separate step, likely due to the non-trivial dereferences in EXPR.
-    if (--encode_search->second.ref_count_ == 0) {
+    if (encode_search->second.ref_count_.load(std::memory_order_relaxed) == 0) {
+      Memory::Accounting::free(Memory::Accounting::Account::SymbolTable,
+                               decode_search->second->toStringView().size());
       decode_map_.erase(decode_search);
       encode_map_.erase(encode_search);
       pool_.push(symbol);
@@ -291,7 +317,7 @@ uint64_t SymbolTableImpl::getRecentLookups(const RecentLookupsFn& iter) const {
   // We don't want to hold lock_ while calling the iterator, but we need it to
   // access recent_lookups_, so we buffer in name_count_map.
   {
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(&lock_);
     recent_lookups_.forEach(
         [&name_count_map](absl::string_view str, uint64_t count)
             ABSL_NO_THREAD_SAFETY_ANALYSIS { name_count_map[std::string(str)] += count; });
@@ -341,17 +367,17 @@ DynamicSpans SymbolTableImpl::getDynamicSpans(StatName stat_name) const {
 }
 
 void SymbolTableImpl::setRecentLookupCapacity(uint64_t capacity) {
-  Thread::LockGuard lock(lock_);
+  absl::MutexLock lock(&lock_);
   recent_lookups_.setCapacity(capacity);
 }
 
 void SymbolTableImpl::clearRecentLookups() {
-  Thread::LockGuard lock(lock_);
+  absl::MutexLock lock(&lock_);
   recent_lookups_.clear();
 }
 
 uint64_t SymbolTableImpl::recentLookupCapacity() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   return recent_lookups_.capacity();
 }
 
@@ -371,6 +397,7 @@ Symbol SymbolTableImpl::toSymbol(absl::string_view sv) {
     // store the string once. We use unique_ptr so copies are not made as
     // flat_hash_map moves values around.
     InlineStringPtr str = InlineString::create(sv);
+    Memory::Accounting::allocate(Memory::Accounting::Account::SymbolTable, sv.size());
     auto encode_insert = encode_map_.insert({str->toStringView(), SharedSymbol(next_symbol_)});
     ASSERT(encode_insert.second);
     auto decode_insert = decode_map_.insert({next_symbol_, std::move(str)});
@@ -382,13 +409,13 @@ Symbol SymbolTableImpl::toSymbol(absl::string_view sv) {
     // If the insertion didn't take place, return the actual value at that location and up the
     // refcount at that location
     result = encode_find->second.symbol_;
-    ++(encode_find->second.ref_count_);
+    encode_find->second.ref_count_.fetch_add(1, std::memory_order_relaxed);
   }
   return result;
 }
 
 absl::string_view SymbolTableImpl::fromSymbol(const Symbol symbol) const
-    ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    ABSL_SHARED_LOCKS_REQUIRED(lock_) {
   auto search = decode_map_.find(symbol);
   RELEASE_ASSERT(search != decode_map_.end(), "no such symbol");
   return search->second->toStringView();
@@ -424,7 +451,7 @@ bool SymbolTableImpl::lessThan(const StatName& a, const StatName& b) const {
 
 #ifndef ENVOY_CONFIG_COVERAGE
 void SymbolTableImpl::debugPrint() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   std::vector<Symbol> symbols;
   for (const auto& p : decode_map_) {
     symbols.push_back(p.first);
@@ -433,7 +460,8 @@ void SymbolTableImpl::debugPrint() const {
   for (Symbol symbol : symbols) {
     const InlineString& token = *decode_map_.find(symbol)->second;
     const SharedSymbol& shared_symbol = encode_map_.find(token.toStringView())->second;
-    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(), shared_symbol.ref_count_);
+    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(),
+                   shared_symbol.ref_count_.load());
   }
 }
 #endif
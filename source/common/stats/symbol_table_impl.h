@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <memory>
 #include <stack>
@@ -23,6 +24,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Stats {
@@ -205,13 +207,18 @@ private:
 
   struct SharedSymbol {
     SharedSymbol(Symbol symbol) : symbol_(symbol), ref_count_(1) {}
+    // The encode map only moves its values when it is modified, which holds lock_ exclusively.
+    SharedSymbol(SharedSymbol&& src) noexcept
+        : symbol_(src.symbol_), ref_count_(src.ref_count_.load(std::memory_order_relaxed)) {}
 
     Symbol symbol_;
-    uint32_t ref_count_;
+    // Atomic so that the ref-counts of existing symbols are updated with lock_ held shared.
+    std::atomic<uint32_t> ref_count_;
   };
 
-  // This must be held during both encode() and free().
-  mutable Thread::MutexBasicLockable lock_;
+  // This is held exclusively to add and remove symbols, and shared to decode symbols and to
+  // update the ref-counts of existing symbols, which are the most frequent operations.
+  mutable absl::Mutex lock_;
 
   /**
    * Decodes a uint8_t array into an array of period-delimited strings. Note
@@ -242,7 +249,7 @@ private:
    * @param symbol the individual symbol to be decoded.
    * @return absl::string_view the decoded string.
    */
-  absl::string_view fromSymbol(Symbol symbol) const ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  absl::string_view fromSymbol(Symbol symbol) const ABSL_SHARED_LOCKS_REQUIRED(lock_);
 
   /**
    * Stages a new symbol for use. To be called after a successful insertion.
@@ -259,7 +266,7 @@ private:
   void addTokensToEncoding(absl::string_view name, Encoding& encoding);
 
   Symbol monotonicCounter() {
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(&lock_);
     return monotonic_counter_;
   }
 
@@ -12,6 +12,7 @@
 
 #include "absl/strings/ascii.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_split.h"
 
 namespace Envoy {
 namespace Stats {
@@ -161,5 +162,70 @@ bool TagExtractorRe2Impl::extractTag(absl::string_view stat_name, std::vector<Ta
   return false;
 }
 
+TagExtractorTokensImpl::TagExtractorTokensImpl(absl::string_view name, absl::string_view tokens)
+    : TagExtractorImplBase(name, "") {
+  for (absl::string_view token : absl::StrSplit(tokens, '.')) {
+    tokens_.emplace_back(token);
+  }
+  bool found_value = false;
+  for (uint32_t i = 0; i < tokens_.size(); ++i) {
+    if (tokens_[i] == "$") {
+      if (found_value) {
+        throw EnvoyException(fmt::format("More than one '$' in tag pattern '{}'", tokens));
+      }
+      found_value = true;
+      value_index_ = i;
+    } else if (tokens_[i] == "**" && i != tokens_.size() - 1) {
+      throw EnvoyException(fmt::format("'**' is not the last token of tag pattern '{}'", tokens));
+    }
+  }
+  if (!found_value) {
+    throw EnvoyException(fmt::format("No '$' in tag pattern '{}'", tokens));
+  }
+  if (tokens_.size() == 1) {
+    throw EnvoyException(fmt::format("No token besides '$' in tag pattern '{}'", tokens));
+  }
+  if (tokens_.back() == "**") {
+    match_remaining_tokens_ = true;
+    tokens_.pop_back();
+  }
+  if (value_index_ > 0 && tokens_[0] != "*") {
+    prefix_ = tokens_[0];
+  }
+}
+
+bool TagExtractorTokensImpl::extractTag(absl::string_view stat_name, std::vector<Tag>& tags,
+                                        IntervalSet<size_t>& remove_characters) const {
+  PERF_OPERATION(perf);
+
+  const std::vector<absl::string_view> stat_tokens = absl::StrSplit(stat_name, '.');
+  if (match_remaining_tokens_ ? stat_tokens.size() <= tokens_.size()
+                              : stat_tokens.size() != tokens_.size()) {
+    PERF_RECORD(perf, "tokens-miss", name_);
+    return false;
+  }
+  for (uint32_t i = 0; i < tokens_.size(); ++i) {
+    if (i != value_index_ && tokens_[i] != "*" && tokens_[i] != stat_tokens[i]) {
+      PERF_RECORD(perf, "tokens-miss", name_);
+      return false;
+    }
+  }
+
+  const absl::string_view value = stat_tokens[value_index_];
+  addTag(tags) = std::string(value);
+
+  // Determines which characters to remove from stat_name to elide the value and a dot next to it.
+  std::string::size_type start = value.data() - stat_name.data();
+  std::string::size_type end = start + value.size();
+  if (value_index_ + 1 < stat_tokens.size()) {
+    ++end;
+  } else {
+    --start;
+  }
+  remove_characters.insert(start, end);
+  PERF_RECORD(perf, "tokens-match", name_);
+  return true;
+}
+
 } // namespace Stats
 } // namespace Envoy
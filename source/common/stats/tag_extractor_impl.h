@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <regex>
 #include <string>
+#include <vector>
 
 #include "envoy/stats/tag_extractor.h"
 
@@ -60,7 +61,8 @@ protected:
   std::string& addTag(std::vector<Tag>& tags) const;
 
   const std::string name_;
-  const std::string prefix_;
+  // Not const, as TagExtractorTokensImpl takes it from its tokens rather than from a regex.
+  std::string prefix_;
   const std::string substr_;
 };
 
@@ -88,5 +90,34 @@ private:
   const re2::RE2 regex_;
 };
 
+/**
+ * Extracts a tag whose value is a whole token of the stat names, by matching the dot-separated
+ * tokens of the stat names against a pattern of tokens rather than with a regex. In the pattern,
+ * "$" matches the token that is the tag value, "*" matches any token, "**" as the last token
+ * matches one or more tokens, and other tokens match themselves. The tag value is removed from the
+ * tag-extracted name along with the dot that follows it, or the one that precedes it if it is the
+ * last token.
+ *
+ * For example, "cluster.$.**" extracts "foo" from "cluster.foo.upstream_rq_total", like the regex
+ * "^cluster\\.(([^\\.]+)\\.).*" does.
+ */
+class TagExtractorTokensImpl : public TagExtractorImplBase {
+public:
+  /**
+   * @param name name for tag extractor.
+   * @param tokens the pattern of tokens, which must have exactly one "$" token, and other tokens.
+   */
+  TagExtractorTokensImpl(absl::string_view name, absl::string_view tokens);
+
+  bool extractTag(absl::string_view tag_extracted_name, std::vector<Tag>& tags,
+                  IntervalSet<size_t>& remove_characters) const override;
+
+private:
+  std::vector<std::string> tokens_;
+  // Whether the last token of the pattern is "**", which is not in tokens_.
+  bool match_remaining_tokens_{};
+  uint32_t value_index_{};
+};
+
 } // namespace Stats
 } // namespace Envoy
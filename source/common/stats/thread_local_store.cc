@@ -1,10 +1,13 @@
 #include "common/stats/thread_local_store.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/stats/allocator.h"
 #include "envoy/stats/histogram.h"
@@ -17,6 +20,7 @@
 #include "common/stats/tag_producer_impl.h"
 #include "common/stats/tag_utility.h"
 
+#include "absl/strings/match.h"
 #include "absl/strings/str_join.h"
 
 namespace Envoy {
@@ -129,8 +133,10 @@ std::vector<CounterSharedPtr> ThreadLocalStoreImpl::counters() const {
 
 ScopePtr ThreadLocalStoreImpl::createScope(const std::string& name) {
   auto new_scope = std::make_unique<ScopeImpl>(*this, name);
+  std::string prefix = constSymbolTable().toString(new_scope->prefix_.statName());
   Thread::LockGuard lock(lock_);
   scopes_.emplace(new_scope.get());
+  scopes_by_prefix_.emplace(std::move(prefix), new_scope.get());
   return new_scope;
 }
 
@@ -168,6 +174,67 @@ std::vector<TextReadoutSharedPtr> ThreadLocalStoreImpl::textReadouts() const {
   return ret;
 }
 
+namespace {
+
+template <class StatType>
+void selectFrom(const StatNameHashMap<RefcountPtr<StatType>>& stats, absl::string_view prefix,
+                bool check_names, bool used_only, StatNameHashSet& names,
+                std::vector<RefcountPtr<StatType>>& selected) {
+  for (const auto& stat : stats) {
+    if ((!used_only || stat.second->used()) &&
+        (!check_names || absl::StartsWith(stat.second->name(), prefix)) &&
+        names.insert(stat.first).second) {
+      selected.push_back(stat.second);
+    }
+  }
+}
+
+} // namespace
+
+SelectedStats ThreadLocalStoreImpl::selectStats(absl::string_view prefix, bool used_only) const {
+  SelectedStats selected;
+  // Handle de-dup due to overlapping scopes.
+  StatNameHashSet counter_names;
+  StatNameHashSet gauge_names;
+  StatNameHashSet text_readout_names;
+  const auto select_from_scope = [&](const ScopeImpl& scope, bool check_names) {
+    const CentralCacheEntry& central_cache = *scope.central_cache_;
+    selectFrom(central_cache.counters_, prefix, check_names, used_only, counter_names,
+               selected.counters_);
+    selectFrom(central_cache.text_readouts_, prefix, check_names, used_only, text_readout_names,
+               selected.text_readouts_);
+    for (const auto& gauge : central_cache.gauges_) {
+      if (gauge.second->importMode() != Gauge::ImportMode::Uninitialized &&
+          (!used_only || gauge.second->used()) &&
+          (!check_names || absl::StartsWith(gauge.second->name(), prefix)) &&
+          gauge_names.insert(gauge.first).second) {
+        selected.gauges_.push_back(gauge.second);
+      }
+    }
+  };
+
+  Thread::LockGuard lock(lock_);
+  // The names of the stats of a scope start with the prefix of the scope, so all the stats of the
+  // scopes whose prefixes start with the selected prefix are selected.
+  for (auto it = scopes_by_prefix_.lower_bound(prefix);
+       it != scopes_by_prefix_.end() && absl::StartsWith(it->first, prefix); ++it) {
+    select_from_scope(*it->second, false);
+  }
+  if (prefix.empty()) {
+    return selected;
+  }
+  // The scopes whose prefixes are dot-separated prefixes of the selected prefix, including the
+  // default scope, may also hold stats whose names start with it. Those are checked by name,
+  // except when the selected prefix is the prefix of the scope followed by a dot.
+  for (size_t end = 0; end != absl::string_view::npos; end = prefix.find('.', end + 1)) {
+    const auto range = scopes_by_prefix_.equal_range(std::string(prefix.substr(0, end)));
+    for (auto it = range.first; it != range.second; ++it) {
+      select_from_scope(*it->second, end == 0 || end + 1 != prefix.size());
+    }
+  }
+  return selected;
+}
+
 std::vector<ParentHistogramSharedPtr> ThreadLocalStoreImpl::histograms() const {
   std::vector<ParentHistogramSharedPtr> ret;
   Thread::LockGuard lock(hist_mutex_);
@@ -220,11 +287,44 @@ void ThreadLocalStoreImpl::mergeHistograms(PostMergeCb merge_complete_cb) {
 
 void ThreadLocalStoreImpl::mergeInternal(PostMergeCb merge_complete_cb) {
   if (!shutting_down_) {
-    for (const ParentHistogramSharedPtr& histogram : histograms()) {
-      histogram->merge();
+    // The TLS histograms are merged in parallel by all the threads, which take batches of
+    // histograms in turn. The statistics, which the main thread reads, are refreshed on the main
+    // thread once all the histograms are merged.
+    struct MergeState {
+      std::vector<ParentHistogramImplSharedPtr> histograms_;
+      std::atomic<size_t> next_{0};
+    };
+    auto state = std::make_shared<MergeState>();
+    {
+      Thread::LockGuard lock(hist_mutex_);
+      state->histograms_.reserve(histogram_set_.size());
+      for (ParentHistogramImpl* histogram : histogram_set_) {
+        state->histograms_.emplace_back(histogram);
+      }
     }
-    merge_complete_cb();
-    merge_in_progress_ = false;
+    tls_cache_->runOnAllThreads(
+        [state](OptRef<TlsCache>) {
+          const size_t size = state->histograms_.size();
+          for (size_t begin = state->next_.fetch_add(MergeBatchSize); begin < size;
+               begin = state->next_.fetch_add(MergeBatchSize)) {
+            const size_t end = std::min(begin + MergeBatchSize, size);
+            for (size_t i = begin; i < end; ++i) {
+              state->histograms_[i]->mergeTlsHistograms();
+            }
+          }
+        },
+        [this, state, merge_complete_cb]() -> void {
+          if (!shutting_down_) {
+            for (const ParentHistogramImplSharedPtr& histogram : state->histograms_) {
+              histogram->refreshStatistics();
+            }
+            merge_complete_cb();
+            merge_in_progress_ = false;
+          }
+          // Release the histograms on the main thread rather than on the last worker holding the
+          // state.
+          state->histograms_.clear();
+        });
   }
 }
 
@@ -238,9 +338,17 @@ ThreadLocalStoreImpl::CentralCacheEntry::~CentralCacheEntry() {
 }
 
 void ThreadLocalStoreImpl::releaseScopeCrossThread(ScopeImpl* scope) {
+  const std::string prefix = constSymbolTable().toString(scope->prefix_.statName());
   Thread::ReleasableLockGuard lock(lock_);
   ASSERT(scopes_.count(scope) == 1);
   scopes_.erase(scope);
+  const auto range = scopes_by_prefix_.equal_range(prefix);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == scope) {
+      scopes_by_prefix_.erase(it);
+      break;
+    }
+  }
 
   // This method is called directly from the ScopeImpl destructor, but we can't
   // destroy scope->central_cache_ until all the TLS caches are be destroyed, as
@@ -829,7 +937,13 @@ bool ParentHistogramImpl::used() const {
 }
 
 void ParentHistogramImpl::merge() {
-  Thread::ReleasableLockGuard lock(merge_lock_);
+  mergeTlsHistograms();
+  refreshStatistics();
+}
+
+void ParentHistogramImpl::mergeTlsHistograms() {
+  Thread::LockGuard lock(merge_lock_);
+  // merged_ is only written by refreshStatistics(), which does not run concurrently.
   if (merged_ || usedLockHeld()) {
     hist_clear(interval_histogram_);
     // Here we could copy all the pointers to TLS histograms in the tls_histogram_ list,
@@ -839,13 +953,22 @@ void ParentHistogramImpl::merge() {
     for (const TlsHistogramSharedPtr& tls_histogram : tls_histograms_) {
       tls_histogram->merge(interval_histogram_);
     }
-    // Since TLS merge is done, we can release the lock here.
-    lock.release();
     hist_accumulate(cumulative_histogram_, &interval_histogram_, 1);
-    cumulative_statistics_.refresh(cumulative_histogram_);
-    interval_statistics_.refresh(interval_histogram_);
-    merged_ = true;
+    pending_refresh_ = true;
+  }
+}
+
+void ParentHistogramImpl::refreshStatistics() {
+  {
+    Thread::LockGuard lock(merge_lock_);
+    if (!pending_refresh_) {
+      return;
+    }
+    pending_refresh_ = false;
   }
+  cumulative_statistics_.refresh(cumulative_histogram_);
+  interval_statistics_.refresh(interval_histogram_);
+  merged_ = true;
 }
 
 const std::string ParentHistogramImpl::quantileSummary() const {
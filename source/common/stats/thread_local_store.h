@@ -4,6 +4,7 @@
 #include <chrono>
 #include <cstdint>
 #include <list>
+#include <map>
 #include <memory>
 #include <string>
 
@@ -100,6 +101,18 @@ public:
    */
   void merge() override;
 
+  /**
+   * The first step of merge(), which merges the TLS histograms into the interval and cumulative
+   * histograms. It may be called on any thread, while no other thread merges this histogram.
+   */
+  void mergeTlsHistograms();
+
+  /**
+   * The second step of merge(), which refreshes the statistics of the histograms merged by
+   * mergeTlsHistograms(). It must be called on the main thread, which reads the statistics.
+   */
+  void refreshStatistics();
+
   const HistogramStatistics& intervalStatistics() const override { return interval_statistics_; }
   const HistogramStatistics& cumulativeStatistics() const override {
     return cumulative_statistics_;
@@ -131,6 +144,8 @@ private:
   HistogramStatisticsImpl cumulative_statistics_;
   mutable Thread::MutexBasicLockable merge_lock_;
   std::list<TlsHistogramSharedPtr> tls_histograms_ ABSL_GUARDED_BY(merge_lock_);
+  // Whether the histograms were merged since the statistics were last refreshed.
+  bool pending_refresh_ ABSL_GUARDED_BY(merge_lock_){false};
   bool merged_;
   std::atomic<bool> shutting_down_{false};
   std::atomic<uint32_t> ref_count_{0};
@@ -242,6 +257,7 @@ public:
   std::vector<GaugeSharedPtr> gauges() const override;
   std::vector<TextReadoutSharedPtr> textReadouts() const override;
   std::vector<ParentHistogramSharedPtr> histograms() const override;
+  SelectedStats selectStats(absl::string_view prefix, bool used_only) const override;
 
   // Stats::StoreRoot
   void addSink(Sink& sink) override { timer_sinks_.push_back(sink); }
@@ -250,6 +266,9 @@ public:
   }
   void setStatsMatcher(StatsMatcherPtr&& stats_matcher) override;
   void setHistogramSettings(HistogramSettingsConstPtr&& histogram_settings) override;
+  void setCounterSharding(bool shard_counters) override {
+    alloc_.setCounterSharding(shard_counters);
+  }
   void initializeThreading(Event::Dispatcher& main_thread_dispatcher,
                            ThreadLocal::Instance& tls) override;
   void shutdownThreading() override;
@@ -471,6 +490,8 @@ private:
   void clearHistogramFromCaches(uint64_t histogram_id);
   void releaseScopeCrossThread(ScopeImpl* scope);
   void mergeInternal(PostMergeCb merge_cb);
+  // The number of histograms that a thread takes in turn when merging the histograms in parallel.
+  static constexpr size_t MergeBatchSize = 64;
   bool rejects(StatName name) const;
   bool rejectsAll() const { return stats_matcher_->rejectsAll(); }
   template <class StatMapClass, class StatListClass>
@@ -485,6 +506,9 @@ private:
   ThreadLocal::TypedSlotPtr<TlsCache> tls_cache_;
   mutable Thread::MutexBasicLockable lock_;
   absl::flat_hash_set<ScopeImpl*> scopes_ ABSL_GUARDED_BY(lock_);
+  // The scopes ordered by the names of their prefixes, so that selectStats() only visits the
+  // scopes that may hold stats with a given name prefix, e.g. the scope of a cluster.
+  std::multimap<std::string, const ScopeImpl*> scopes_by_prefix_ ABSL_GUARDED_BY(lock_);
   ScopePtr default_scope_;
   std::list<std::reference_wrapper<Sink>> timer_sinks_;
   TagProducerPtr tag_producer_;
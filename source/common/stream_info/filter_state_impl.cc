@@ -25,20 +25,19 @@ void FilterStateImpl::setData(absl::string_view data_name, std::shared_ptr<Objec
     // We have another object with same data_name. Check for mutability
     // violations namely: readonly data cannot be overwritten. mutable data
     // cannot be overwritten by readonly data.
-    const FilterStateImpl::FilterObject* current = it->second.get();
-    if (current->state_type_ == FilterState::StateType::ReadOnly) {
+    const FilterStateImpl::FilterObject& current = it->second;
+    if (current.state_type_ == FilterState::StateType::ReadOnly) {
       throw EnvoyException("FilterState::setData<T> called twice on same ReadOnly state.");
     }
 
-    if (current->state_type_ != state_type) {
+    if (current.state_type_ != state_type) {
       throw EnvoyException("FilterState::setData<T> called twice with different state types.");
     }
   }
 
-  std::unique_ptr<FilterStateImpl::FilterObject> filter_object(new FilterStateImpl::FilterObject());
-  filter_object->data_ = data;
-  filter_object->state_type_ = state_type;
-  data_storage_[data_name] = std::move(filter_object);
+  FilterStateImpl::FilterObject& filter_object = data_storage_[data_name];
+  filter_object.data_ = std::move(data);
+  filter_object.state_type_ = state_type;
 }
 
 bool FilterStateImpl::hasDataWithName(absl::string_view data_name) const {
@@ -56,8 +55,7 @@ FilterStateImpl::getDataReadOnlyGeneric(absl::string_view data_name) const {
     throw EnvoyException("FilterState::getDataReadOnly<T> called for unknown data name.");
   }
 
-  const FilterStateImpl::FilterObject* current = it->second.get();
-  return current->data_.get();
+  return it->second.data_.get();
 }
 
 FilterState::Object* FilterStateImpl::getDataMutableGeneric(absl::string_view data_name) {
@@ -70,13 +68,13 @@ FilterState::Object* FilterStateImpl::getDataMutableGeneric(absl::string_view da
     throw EnvoyException("FilterState::getDataMutable<T> called for unknown data name.");
   }
 
-  FilterStateImpl::FilterObject* current = it->second.get();
-  if (current->state_type_ == FilterState::StateType::ReadOnly) {
+  FilterStateImpl::FilterObject& current = it->second;
+  if (current.state_type_ == FilterState::StateType::ReadOnly) {
     throw EnvoyException(
         "FilterState::getDataMutable<T> tried to access immutable data as mutable.");
   }
 
-  return current->data_.get();
+  return current.data_.get();
 }
 
 bool FilterStateImpl::hasDataAtOrAboveLifeSpan(FilterState::LifeSpan life_span) const {
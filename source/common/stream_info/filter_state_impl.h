@@ -65,7 +65,9 @@ private:
   absl::variant<FilterStateSharedPtr, LazyCreateAncestor> ancestor_;
   FilterStateSharedPtr parent_;
   const FilterState::LifeSpan life_span_;
-  absl::flat_hash_map<std::string, std::unique_ptr<FilterObject>> data_storage_;
+  // The objects are held by value, as their data is already behind a pointer, to save an
+  // allocation per object.
+  absl::flat_hash_map<std::string, FilterObject> data_storage_;
 };
 
 } // namespace StreamInfo
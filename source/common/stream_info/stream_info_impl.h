@@ -1,7 +1,9 @@
 #pragma once
 
+#include <array>
 #include <chrono>
 #include <cstdint>
+#include <memory>
 
 #include "envoy/common/time.h"
 #include "envoy/config/core/v3/base.pb.h"
@@ -11,6 +13,8 @@
 
 #include "common/common/assert.h"
 #include "common/common/dump_state_utils.h"
+#include "common/common/empty_string.h"
+#include "common/common/macros.h"
 #include "common/http/request_id_extension_impl.h"
 #include "common/stream_info/filter_state_impl.h"
 
@@ -34,19 +38,17 @@ const ReplacementMap& emptySpaceReplacement() {
 struct StreamInfoImpl : public StreamInfo {
   StreamInfoImpl(TimeSource& time_source,
                  FilterState::LifeSpan life_span = FilterState::LifeSpan::FilterChain)
-      : StreamInfoImpl(absl::nullopt, time_source, std::make_shared<FilterStateImpl>(life_span)) {}
+      : StreamInfoImpl(absl::nullopt, time_source, absl::nullopt, life_span) {}
 
   StreamInfoImpl(Http::Protocol protocol, TimeSource& time_source)
-      : StreamInfoImpl(protocol, time_source,
-                       std::make_shared<FilterStateImpl>(FilterState::LifeSpan::FilterChain)) {}
+      : StreamInfoImpl(protocol, time_source, absl::nullopt, FilterState::LifeSpan::FilterChain) {}
 
   StreamInfoImpl(Http::Protocol protocol, TimeSource& time_source,
                  FilterStateSharedPtr parent_filter_state, FilterState::LifeSpan life_span)
       : StreamInfoImpl(
             protocol, time_source,
-            std::make_shared<FilterStateImpl>(
-                FilterStateImpl::LazyCreateAncestor(std::move(parent_filter_state), life_span),
-                FilterState::LifeSpan::FilterChain)) {}
+            FilterStateImpl::LazyCreateAncestor(std::move(parent_filter_state), life_span),
+            FilterState::LifeSpan::FilterChain) {}
 
   SystemTime startTime() const override { return start_time_; }
 
@@ -62,12 +64,11 @@ struct StreamInfoImpl : public StreamInfo {
   }
 
   absl::optional<std::chrono::nanoseconds> lastDownstreamRxByteReceived() const override {
-    return duration(last_downstream_rx_byte_received);
+    return duration(DownstreamTiming::LastRxByteReceived);
   }
 
   void onLastDownstreamRxByteReceived() override {
-    ASSERT(!last_downstream_rx_byte_received);
-    last_downstream_rx_byte_received = time_source_.monotonicTime();
+    setDownstreamTiming(DownstreamTiming::LastRxByteReceived);
   }
 
   void setUpstreamTiming(const UpstreamTiming& upstream_timing) override {
@@ -91,31 +92,26 @@ struct StreamInfoImpl : public StreamInfo {
   }
 
   absl::optional<std::chrono::nanoseconds> firstDownstreamTxByteSent() const override {
-    return duration(first_downstream_tx_byte_sent_);
+    return duration(DownstreamTiming::FirstTxByteSent);
   }
 
   void onFirstDownstreamTxByteSent() override {
-    ASSERT(!first_downstream_tx_byte_sent_);
-    first_downstream_tx_byte_sent_ = time_source_.monotonicTime();
+    setDownstreamTiming(DownstreamTiming::FirstTxByteSent);
   }
 
   absl::optional<std::chrono::nanoseconds> lastDownstreamTxByteSent() const override {
-    return duration(last_downstream_tx_byte_sent_);
+    return duration(DownstreamTiming::LastTxByteSent);
   }
 
   void onLastDownstreamTxByteSent() override {
-    ASSERT(!last_downstream_tx_byte_sent_);
-    last_downstream_tx_byte_sent_ = time_source_.monotonicTime();
+    setDownstreamTiming(DownstreamTiming::LastTxByteSent);
   }
 
   absl::optional<std::chrono::nanoseconds> requestComplete() const override {
-    return duration(final_time_);
+    return duration(DownstreamTiming::RequestComplete);
   }
 
-  void onRequestComplete() override {
-    ASSERT(!final_time_);
-    final_time_ = time_source_.monotonicTime();
-  }
+  void onRequestComplete() override { setDownstreamTiming(DownstreamTiming::RequestComplete); }
 
   void addBytesReceived(uint64_t bytes_received) override { bytes_received_ += bytes_received; }
 
@@ -138,11 +134,14 @@ struct StreamInfoImpl : public StreamInfo {
   }
 
   const absl::optional<std::string>& connectionTerminationDetails() const override {
-    return connection_termination_details_;
+    if (rare_fields_ == nullptr) {
+      CONSTRUCT_ON_FIRST_USE(absl::optional<std::string>);
+    }
+    return rare_fields_->connection_termination_details_;
   }
 
   void setConnectionTerminationDetails(absl::string_view connection_termination_details) override {
-    connection_termination_details_.emplace(connection_termination_details);
+    rareFields().connection_termination_details_.emplace(connection_termination_details);
   }
 
   void addBytesSent(uint64_t bytes_sent) override { bytes_sent_ += bytes_sent; }
@@ -232,15 +231,20 @@ struct StreamInfoImpl : public StreamInfo {
 
   const Router::RouteEntry* routeEntry() const override { return route_entry_; }
 
-  envoy::config::core::v3::Metadata& dynamicMetadata() override { return metadata_; };
-  const envoy::config::core::v3::Metadata& dynamicMetadata() const override { return metadata_; };
+  envoy::config::core::v3::Metadata& dynamicMetadata() override {
+    return rareFields().metadata_;
+  };
+  const envoy::config::core::v3::Metadata& dynamicMetadata() const override {
+    return rare_fields_ != nullptr ? rare_fields_->metadata_
+                                   : envoy::config::core::v3::Metadata::default_instance();
+  };
 
   void setDynamicMetadata(const std::string& name, const ProtobufWkt::Struct& value) override {
-    (*metadata_.mutable_filter_metadata())[name].MergeFrom(value);
+    (*rareFields().metadata_.mutable_filter_metadata())[name].MergeFrom(value);
   };
 
-  const FilterStateSharedPtr& filterState() override { return filter_state_; }
-  const FilterState& filterState() const override { return *filter_state_; }
+  const FilterStateSharedPtr& filterState() override { return lazyFilterState(); }
+  const FilterState& filterState() const override { return *lazyFilterState(); }
 
   const FilterStateSharedPtr& upstreamFilterState() const override {
     return upstream_filter_state_;
@@ -256,11 +260,12 @@ struct StreamInfoImpl : public StreamInfo {
   const std::string& requestedServerName() const override { return requested_server_name_; }
 
   void setUpstreamTransportFailureReason(absl::string_view failure_reason) override {
-    upstream_transport_failure_reason_ = std::string(failure_reason);
+    rareFields().upstream_transport_failure_reason_ = std::string(failure_reason);
   }
 
   const std::string& upstreamTransportFailureReason() const override {
-    return upstream_transport_failure_reason_;
+    return rare_fields_ != nullptr ? rare_fields_->upstream_transport_failure_reason_
+                                   : EMPTY_STRING;
   }
 
   void setRequestHeaders(const Http::RequestHeaderMap& headers) override {
@@ -300,31 +305,78 @@ struct StreamInfoImpl : public StreamInfo {
   const SystemTime start_time_;
   const MonotonicTime start_time_monotonic_;
 
-  absl::optional<MonotonicTime> last_downstream_rx_byte_received;
-  absl::optional<MonotonicTime> first_downstream_tx_byte_sent_;
-  absl::optional<MonotonicTime> last_downstream_tx_byte_sent_;
-  absl::optional<MonotonicTime> final_time_;
-
   absl::optional<Http::Protocol> protocol_;
   absl::optional<uint32_t> response_code_;
   absl::optional<std::string> response_code_details_;
-  absl::optional<std::string> connection_termination_details_;
   uint64_t response_flags_{};
   Upstream::HostDescriptionConstSharedPtr upstream_host_{};
   bool health_check_request_{};
   const Router::RouteEntry* route_entry_{};
-  envoy::config::core::v3::Metadata metadata_{};
-  FilterStateSharedPtr filter_state_;
   FilterStateSharedPtr upstream_filter_state_;
   std::string route_name_;
 
 private:
+  // The downstream timings, which are set once each, in a single array rather than as optionals.
+  enum class DownstreamTiming : uint8_t {
+    LastRxByteReceived,
+    FirstTxByteSent,
+    LastTxByteSent,
+    RequestComplete,
+  };
+  static constexpr size_t NumDownstreamTimings =
+      static_cast<size_t>(DownstreamTiming::RequestComplete) + 1;
+
+  // The fields which few streams set, allocated with the first of them.
+  struct RareFields {
+    absl::optional<std::string> connection_termination_details_;
+    std::string upstream_transport_failure_reason_;
+    envoy::config::core::v3::Metadata metadata_;
+  };
+
   StreamInfoImpl(absl::optional<Http::Protocol> protocol, TimeSource& time_source,
-                 FilterStateSharedPtr filter_state)
+                 absl::optional<FilterStateImpl::LazyCreateAncestor> filter_state_ancestor,
+                 FilterState::LifeSpan filter_state_life_span)
       : time_source_(time_source), start_time_(time_source.systemTime()),
         start_time_monotonic_(time_source.monotonicTime()), protocol_(protocol),
-        filter_state_(std::move(filter_state)),
-        request_id_extension_(Http::RequestIDExtensionFactory::noopInstance()) {}
+        request_id_extension_(Http::RequestIDExtensionFactory::noopInstance()),
+        filter_state_ancestor_(std::move(filter_state_ancestor)),
+        filter_state_life_span_(filter_state_life_span) {}
+
+  absl::optional<std::chrono::nanoseconds> duration(DownstreamTiming timing) const {
+    const auto index = static_cast<size_t>(timing);
+    if (!(downstream_timings_set_ & (1 << index))) {
+      return {};
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(downstream_timings_[index] -
+                                                                start_time_monotonic_);
+  }
+
+  void setDownstreamTiming(DownstreamTiming timing) {
+    const auto index = static_cast<size_t>(timing);
+    ASSERT(!(downstream_timings_set_ & (1 << index)));
+    downstream_timings_[index] = time_source_.monotonicTime();
+    downstream_timings_set_ |= 1 << index;
+  }
+
+  RareFields& rareFields() {
+    if (rare_fields_ == nullptr) {
+      rare_fields_ = std::make_unique<RareFields>();
+    }
+    return *rare_fields_;
+  }
+
+  // The filter state is created on first use, which does not change how it behaves as its
+  // ancestor is held until then.
+  const FilterStateSharedPtr& lazyFilterState() const {
+    if (filter_state_ == nullptr) {
+      filter_state_ = filter_state_ancestor_.has_value()
+                          ? std::make_shared<FilterStateImpl>(std::move(*filter_state_ancestor_),
+                                                              filter_state_life_span_)
+                          : std::make_shared<FilterStateImpl>(filter_state_life_span_);
+      filter_state_ancestor_.reset();
+    }
+    return filter_state_;
+  }
 
   uint64_t bytes_received_{};
   uint64_t bytes_sent_{};
@@ -338,9 +390,14 @@ private:
   const Http::RequestHeaderMap* request_headers_{};
   Http::RequestIDExtensionSharedPtr request_id_extension_;
   UpstreamTiming upstream_timing_;
-  std::string upstream_transport_failure_reason_;
   absl::optional<Upstream::ClusterInfoConstSharedPtr> upstream_cluster_info_;
   absl::optional<uint64_t> connection_id_;
+  std::array<MonotonicTime, NumDownstreamTimings> downstream_timings_;
+  uint8_t downstream_timings_set_{};
+  std::unique_ptr<RareFields> rare_fields_;
+  mutable absl::optional<FilterStateImpl::LazyCreateAncestor> filter_state_ancestor_;
+  const FilterState::LifeSpan filter_state_life_span_;
+  mutable FilterStateSharedPtr filter_state_;
 };
 
 } // namespace StreamInfo
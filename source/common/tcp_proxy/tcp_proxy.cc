@@ -27,6 +27,7 @@
 #include "common/network/transport_socket_options_impl.h"
 #include "common/network/upstream_server_name.h"
 #include "common/router/metadatamatchcriteria_impl.h"
+#include "common/runtime/runtime_features.h"
 
 namespace Envoy {
 namespace TcpProxy {
@@ -635,6 +636,13 @@ void Filter::onUpstreamConnection() {
   ENVOY_CONN_LOG(debug, "TCP:onUpstreamEvent(), requestedServerName: {}",
                  read_callbacks_->connection(), getStreamInfo().requestedServerName());
 
+  // When nothing else inspects the bytes, let the kernel move them between the two sockets. The
+  // connections fall back to the regular path on their own whenever data has to be buffered.
+  if (upstream_ && Runtime::runtimeFeatureEnabled("envoy.reloadable_features.tcp_proxy_splice") &&
+      upstream_->enableSplicing(read_callbacks_->connection())) {
+    ENVOY_CONN_LOG(debug, "splicing data with upstream", read_callbacks_->connection());
+  }
+
   if (config_->idleTimeout()) {
     // The idle_timer_ can be moved to a Drainer, so related callbacks call into
     // the UpstreamCallbacks, which has the same lifetime as the timer, and can dispatch
@@ -84,6 +84,7 @@ public:
   void encodeData(Buffer::Instance& data, bool end_stream) override;
   void addBytesSentCallback(Network::Connection::BytesSentCb cb) override;
   Tcp::ConnectionPool::ConnectionData* onDownstreamEvent(Network::ConnectionEvent event) override;
+  bool enableSplicing(Network::Connection& downstream) override;
 
 private:
   Tcp::ConnectionPool::ConnectionDataPtr upstream_conn_data_;
@@ -104,6 +105,8 @@ public:
   void encodeData(Buffer::Instance& data, bool end_stream) override;
   void addBytesSentCallback(Network::Connection::BytesSentCb cb) override;
   Tcp::ConnectionPool::ConnectionData* onDownstreamEvent(Network::ConnectionEvent event) override;
+  // Data is framed by the HTTP codec, so it cannot be spliced.
+  bool enableSplicing(Network::Connection&) override { return false; }
 
   // Http::StreamCallbacks
   void onResetStream(Http::StreamResetReason reason,
@@ -8,6 +8,7 @@
 #include "envoy/event/dispatcher.h"
 
 #include "common/common/assert.h"
+#include "common/common/cleanup.h"
 #include "common/common/stl_helpers.h"
 
 namespace Envoy {
@@ -83,21 +84,33 @@ Event::PostCb InstanceImpl::SlotImpl::dataCallback(const UpdateCb& cb) {
 }
 
 void InstanceImpl::SlotImpl::runOnAllThreads(const UpdateCb& cb, const Event::PostCb& complete_cb) {
-  parent_.runOnAllThreads(dataCallback(cb), complete_cb);
+  parent_.runOnAllThreads(index_, dataCallback(cb), complete_cb);
 }
 
 void InstanceImpl::SlotImpl::runOnAllThreads(const UpdateCb& cb) {
-  parent_.runOnAllThreads(dataCallback(cb));
+  parent_.runOnAllThreads(index_, dataCallback(cb));
 }
 
 void InstanceImpl::SlotImpl::set(InitializeCb cb) {
   ASSERT(std::this_thread::get_id() == parent_.main_thread_id_);
   ASSERT(!parent_.shutdown_);
 
-  for (Event::Dispatcher& dispatcher : parent_.registered_threads_) {
-    // See the header file comments for still_alive_guard_ for why we capture index_.
-    dispatcher.post(wrapCallback(
-        [index = index_, cb, &dispatcher]() -> void { setThreadLocal(index, cb(dispatcher)); }));
+  if (parent_.batch_depth_ > 0) {
+    parent_.addToBatch(
+        index_,
+        [still_alive_guard = std::weak_ptr<bool>(still_alive_guard_), index = index_,
+         cb](Event::Dispatcher& dispatcher) {
+          if (!still_alive_guard.expired()) {
+            setThreadLocal(index, cb(dispatcher));
+          }
+        },
+        true);
+  } else {
+    for (Event::Dispatcher& dispatcher : parent_.registered_threads_) {
+      // See the header file comments for still_alive_guard_ for why we capture index_.
+      dispatcher.post(wrapCallback(
+          [index = index_, cb, &dispatcher]() -> void { setThreadLocal(index, cb(dispatcher)); }));
+    }
   }
 
   // Handle main thread.
@@ -134,7 +147,7 @@ void InstanceImpl::removeSlot(uint32_t slot) {
              free_slot_indexes_.end(),
          fmt::format("slot index {} already in free slot set!", slot));
   free_slot_indexes_.push_back(slot);
-  runOnAllThreads([slot]() -> void {
+  runOnAllThreads(slot, [slot]() -> void {
     // This runs on each thread and clears the slot, making it available for a new allocations.
     // This is safe even if a new allocation comes in, because everything happens with post() and
     // will be sequenced after this removal. It is also safe if there are callbacks pending on
@@ -145,19 +158,25 @@ void InstanceImpl::removeSlot(uint32_t slot) {
   });
 }
 
-void InstanceImpl::runOnAllThreads(Event::PostCb cb) {
+void InstanceImpl::runOnAllThreads(uint32_t slot, Event::PostCb cb) {
   ASSERT(std::this_thread::get_id() == main_thread_id_);
   ASSERT(!shutdown_);
 
-  for (Event::Dispatcher& dispatcher : registered_threads_) {
-    dispatcher.post(cb);
+  if (batch_depth_ > 0) {
+    addToBatch(
+        slot, [cb](Event::Dispatcher&) { cb(); }, false);
+  } else {
+    for (Event::Dispatcher& dispatcher : registered_threads_) {
+      dispatcher.post(cb);
+    }
   }
 
   // Handle main thread.
   cb();
 }
 
-void InstanceImpl::runOnAllThreads(Event::PostCb cb, Event::PostCb all_threads_complete_cb) {
+void InstanceImpl::runOnAllThreads(uint32_t slot, Event::PostCb cb,
+                                   Event::PostCb all_threads_complete_cb) {
   ASSERT(std::this_thread::get_id() == main_thread_id_);
   ASSERT(!shutdown_);
   // Handle main thread first so that when the last worker thread wins, we could just call the
@@ -171,8 +190,63 @@ void InstanceImpl::runOnAllThreads(Event::PostCb cb, Event::PostCb all_threads_c
                                     delete cb;
                                   });
 
+  if (batch_depth_ > 0) {
+    // The guard is released, and all_threads_complete_cb posted, once every worker has run the
+    // batch.
+    addToBatch(
+        slot, [cb_guard](Event::Dispatcher&) { (*cb_guard)(); }, false);
+  } else {
+    for (Event::Dispatcher& dispatcher : registered_threads_) {
+      dispatcher.post([cb_guard]() -> void { (*cb_guard)(); });
+    }
+  }
+}
+
+ScopedBatch InstanceImpl::startBatch() {
+  ASSERT(std::this_thread::get_id() == main_thread_id_);
+  ++batch_depth_;
+  return std::make_unique<Cleanup>([this]() { endBatch(); });
+}
+
+void InstanceImpl::addToBatch(uint32_t slot, BatchedCb cb, bool replace_set) {
+  if (replace_set) {
+    auto it = batched_sets_.find(slot);
+    if (it != batched_sets_.end()) {
+      // The workers would overwrite the data of the slot right after, so skip the earlier set().
+      batched_cbs_[it->second] = nullptr;
+    }
+    batched_sets_[slot] = batched_cbs_.size();
+  } else {
+    batched_sets_.erase(slot);
+  }
+  batched_cbs_.push_back(std::move(cb));
+}
+
+void InstanceImpl::endBatch() {
+  ASSERT(std::this_thread::get_id() == main_thread_id_);
+  ASSERT(batch_depth_ > 0);
+  if (--batch_depth_ > 0) {
+    return;
+  }
+
+  batched_sets_.clear();
+  if (batched_cbs_.empty()) {
+    return;
+  }
+  // Shared by the workers, which only read it, and destroyed once the last of them has run it.
+  auto batch = std::make_shared<const std::vector<BatchedCb>>(std::move(batched_cbs_));
+  batched_cbs_.clear();
+  if (shutdown_) {
+    return;
+  }
   for (Event::Dispatcher& dispatcher : registered_threads_) {
-    dispatcher.post([cb_guard]() -> void { (*cb_guard)(); });
+    dispatcher.post([batch, &dispatcher]() -> void {
+      for (const BatchedCb& cb : *batch) {
+        if (cb != nullptr) {
+          cb(dispatcher);
+        }
+      }
+    });
   }
 }
 
@@ -11,6 +11,8 @@
 #include "common/common/logger.h"
 #include "common/common/non_copyable.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace ThreadLocal {
 
@@ -28,6 +30,7 @@ public:
   void shutdownGlobalThreading() override;
   void shutdownThread() override;
   Event::Dispatcher& dispatcher() override;
+  ScopedBatch startBatch() override;
 
 private:
   // On destruction returns the slot index to the deferred delete queue (detaches it). This allows
@@ -70,9 +73,16 @@ private:
     std::vector<ThreadLocalObjectSharedPtr> data_;
   };
 
+  // An update of the workers, queued during a batch.
+  using BatchedCb = std::function<void(Event::Dispatcher& dispatcher)>;
+
   void removeSlot(uint32_t slot);
-  void runOnAllThreads(Event::PostCb cb);
-  void runOnAllThreads(Event::PostCb cb, Event::PostCb main_callback);
+  void runOnAllThreads(uint32_t slot, Event::PostCb cb);
+  void runOnAllThreads(uint32_t slot, Event::PostCb cb, Event::PostCb main_callback);
+  // Queues an update of the workers for a slot. When replace_set is true, the update replaces the
+  // queued set() of the slot if it is the last update queued for the slot.
+  void addToBatch(uint32_t slot, BatchedCb cb, bool replace_set);
+  void endBatch();
   static void setThreadLocal(uint32_t index, ThreadLocalObjectSharedPtr object);
 
   static thread_local ThreadLocalData thread_local_data_;
@@ -84,6 +94,11 @@ private:
   std::thread::id main_thread_id_;
   Event::Dispatcher* main_thread_dispatcher_{};
   std::atomic<bool> shutdown_{};
+  // The number of batches in progress, see startBatch().
+  uint32_t batch_depth_{};
+  std::vector<BatchedCb> batched_cbs_;
+  // The index in batched_cbs_ of the set() of a slot, while it is the last update queued for it.
+  absl::flat_hash_map<uint32_t, size_t> batched_sets_;
 
   // Test only.
   friend class ThreadLocalInstanceImplTest;
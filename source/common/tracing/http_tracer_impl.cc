@@ -290,8 +290,9 @@ SpanPtr HttpTracerImpl::startSpan(const Config& config, Http::RequestHeaderMap&
   SpanPtr active_span = driver_->startSpan(config, request_headers, span_name,
                                            stream_info.startTime(), tracing_decision);
 
-  // Set tags related to the local environment
-  if (active_span) {
+  // Set tags related to the local environment. A span which is not sampled is never reported, so it
+  // is left untagged.
+  if (active_span && tracing_decision.traced) {
     active_span->setTag(Tracing::Tags::get().NodeId, local_info_.nodeName());
     active_span->setTag(Tracing::Tags::get().Zone, local_info_.zoneName());
   }
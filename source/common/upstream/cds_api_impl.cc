@@ -21,16 +21,18 @@ namespace Envoy {
 namespace Upstream {
 
 CdsApiPtr CdsApiImpl::create(const envoy::config::core::v3::ConfigSource& cds_config,
-                             ClusterManager& cm, Stats::Scope& scope,
+                             ClusterManager& cm, ThreadLocal::Instance& tls,
+                             Stats::Scope& scope,
                              ProtobufMessage::ValidationVisitor& validation_visitor) {
-  return CdsApiPtr{new CdsApiImpl(cds_config, cm, scope, validation_visitor)};
+  return CdsApiPtr{new CdsApiImpl(cds_config, cm, tls, scope, validation_visitor)};
 }
 
 CdsApiImpl::CdsApiImpl(const envoy::config::core::v3::ConfigSource& cds_config, ClusterManager& cm,
-                       Stats::Scope& scope, ProtobufMessage::ValidationVisitor& validation_visitor)
+                       ThreadLocal::Instance& tls, Stats::Scope& scope,
+                       ProtobufMessage::ValidationVisitor& validation_visitor)
     : Envoy::Config::SubscriptionBase<envoy::config::cluster::v3::Cluster>(
           cds_config.resource_api_version(), validation_visitor, "name"),
-      cm_(cm), scope_(scope.createScope("cluster_manager.cds.")) {
+      cm_(cm), tls_(tls), scope_(scope.createScope("cluster_manager.cds.")) {
   const auto resource_name = getResourceName();
   subscription_ = cm_.subscriptionFactory().subscriptionFromConfigSource(
       cds_config, Grpc::Common::typeUrl(resource_name), *scope_, *this, resource_decoder_);
@@ -66,6 +68,9 @@ void CdsApiImpl::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& a
         Config::getAllVersionTypeUrls<envoy::config::endpoint::v3::ClusterLoadAssignment>();
     maybe_resume_eds = cm_.adsMux()->pause(type_urls);
   }
+  // Post the thread local updates of all the clusters to each worker at once, when the batch is
+  // destroyed, before EDS is resumed.
+  ThreadLocal::ScopedBatch batch = tls_.startBatch();
 
   ENVOY_LOG(info, "cds: add {} cluster(s), remove {} cluster(s)", added_resources.size(),
             removed_resources.size());
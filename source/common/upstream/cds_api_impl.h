@@ -11,6 +11,7 @@
 #include "envoy/local_info/local_info.h"
 #include "envoy/service/discovery/v3/discovery.pb.h"
 #include "envoy/stats/scope.h"
+#include "envoy/thread_local/thread_local.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/common/logger.h"
@@ -27,7 +28,7 @@ class CdsApiImpl : public CdsApi,
                    Logger::Loggable<Logger::Id::upstream> {
 public:
   static CdsApiPtr create(const envoy::config::core::v3::ConfigSource& cds_config,
-                          ClusterManager& cm, Stats::Scope& scope,
+                          ClusterManager& cm, ThreadLocal::Instance& tls, Stats::Scope& scope,
                           ProtobufMessage::ValidationVisitor& validation_visitor);
 
   // Upstream::CdsApi
@@ -47,10 +48,12 @@ private:
   void onConfigUpdateFailed(Envoy::Config::ConfigUpdateFailureReason reason,
                             const EnvoyException* e) override;
   CdsApiImpl(const envoy::config::core::v3::ConfigSource& cds_config, ClusterManager& cm,
-             Stats::Scope& scope, ProtobufMessage::ValidationVisitor& validation_visitor);
+             ThreadLocal::Instance& tls, Stats::Scope& scope,
+             ProtobufMessage::ValidationVisitor& validation_visitor);
   void runInitializeCallbackIfAny();
 
   ClusterManager& cm_;
+  ThreadLocal::Instance& tls_;
   Config::SubscriptionPtr subscription_;
   std::string system_version_info_;
   std::function<void()> initialize_callback_;
@@ -1,6 +1,7 @@
 #include "common/upstream/cluster_factory_impl.h"
 
 #include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/singleton/manager.h"
 
 #include "common/http/utility.h"
 #include "common/network/address_impl.h"
@@ -13,6 +14,8 @@
 namespace Envoy {
 namespace Upstream {
 
+SINGLETON_MANAGER_REGISTRATION(health_check_session_registry);
+
 namespace {
 
 Stats::ScopePtr generateStatsScope(const envoy::config::cluster::v3::Cluster& config,
@@ -118,10 +121,16 @@ ClusterFactoryImplBase::create(const envoy::config::cluster::v3::Cluster& cluste
     if (cluster.health_checks().size() != 1) {
       throw EnvoyException("Multiple health checks not supported");
     } else {
+      HealthCheckSessionRegistrySharedPtr session_registry;
+      if (cluster.health_checks()[0].share_sessions_across_clusters()) {
+        session_registry = context.singletonManager().getTyped<HealthCheckSessionRegistry>(
+            SINGLETON_MANAGER_REGISTERED_NAME(health_check_session_registry),
+            [] { return std::make_shared<HealthCheckSessionRegistry>(); });
+      }
       new_cluster_pair.first->setHealthChecker(HealthCheckerFactory::create(
           cluster.health_checks()[0], *new_cluster_pair.first, context.runtime(),
           context.dispatcher(), context.logManager(), context.messageValidationVisitor(),
-          context.api()));
+          context.api(), std::move(session_registry)));
     }
   }
 
@@ -28,6 +28,7 @@
 #include "common/http/async_client_impl.h"
 #include "common/http/http1/conn_pool.h"
 #include "common/http/http2/conn_pool.h"
+#include "common/http/http3/conn_pool.h"
 #include "common/http/mixed_conn_pool.h"
 #include "common/network/resolver_impl.h"
 #include "common/network/utility.h"
@@ -76,14 +77,19 @@ void ClusterManagerInitHelper::addCluster(ClusterManagerCluster& cm_cluster) {
     ASSERT(cluster.initializePhase() == Cluster::InitializePhase::Secondary);
     // Remove the previous cluster before the cluster object is destroyed.
     secondary_init_clusters_.remove_if(
-        [name_to_remove = cluster.info()->name()](ClusterManagerCluster* cluster_iter) {
-          return cluster_iter->cluster().info()->name() == name_to_remove;
+        [this, name_to_remove = cluster.info()->name()](ClusterManagerCluster* cluster_iter) {
+          if (cluster_iter->cluster().info()->name() != name_to_remove) {
+            return false;
+          }
+          initializing_secondary_clusters_.erase(cluster_iter);
+          return true;
         });
     secondary_init_clusters_.push_back(&cm_cluster);
     if (started_secondary_initialize_) {
       // This can happen if we get a second CDS update that adds new clusters after we have
-      // already started secondary init. In this case, just immediately initialize.
-      cluster.initialize(initialize_cb);
+      // already started secondary init. In this case, initialize it as soon as the limit of
+      // concurrently initializing secondary clusters allows it.
+      initializeSecondaryClusters();
     }
   }
 
@@ -115,6 +121,7 @@ void ClusterManagerInitHelper::removeCluster(ClusterManagerCluster& cluster) {
   // It is possible that the cluster we are removing has already been initialized, and is not
   // present in the initializer list. If so, this is fine.
   cluster_list->remove(&cluster);
+  initializing_secondary_clusters_.erase(&cluster);
   ENVOY_LOG(debug, "cm init: init complete: cluster={} primary={} secondary={}",
             cluster.cluster().info()->name(), primary_init_clusters_.size(),
             secondary_init_clusters_.size());
@@ -123,15 +130,30 @@ void ClusterManagerInitHelper::removeCluster(ClusterManagerCluster& cluster) {
 
 void ClusterManagerInitHelper::initializeSecondaryClusters() {
   started_secondary_initialize_ = true;
+  if (initializing_secondary_) {
+    // A cluster completed its initialization synchronously, the loop below already goes on with
+    // the next clusters.
+    return;
+  }
+  initializing_secondary_ = true;
   // Cluster::initialize() method can modify the list of secondary_init_clusters_ to remove
   // the item currently being initialized, so we eschew range-based-for and do this complicated
   // dance to increment the iterator before calling initialize.
   for (auto iter = secondary_init_clusters_.begin(); iter != secondary_init_clusters_.end();) {
+    if (max_concurrent_secondary_init_ != 0 &&
+        initializing_secondary_clusters_.size() >= max_concurrent_secondary_init_) {
+      // The remaining clusters are initialized as the initializing ones complete.
+      break;
+    }
     ClusterManagerCluster* cluster = *iter;
     ++iter;
+    if (!initializing_secondary_clusters_.insert(cluster).second) {
+      continue;
+    }
     ENVOY_LOG(debug, "initializing secondary cluster {}", cluster->cluster().info()->name());
     cluster->cluster().initialize([cluster, this] { onClusterInit(*cluster); });
   }
+  initializing_secondary_ = false;
 }
 
 void ClusterManagerInitHelper::maybeFinishInitialize() {
@@ -159,7 +181,8 @@ void ClusterManagerInitHelper::maybeFinishInitialize() {
   }
 
   // If we are still waiting for secondary clusters to initialize, see if we need to first call
-  // initialize on them. This is only done once.
+  // initialize on them. This is only done once, unless the number of concurrently initializing
+  // secondary clusters is limited, in which case the next waiting clusters are initialized.
   ENVOY_LOG(debug, "maybe finish initialize secondary init clusters empty: {}",
             secondary_init_clusters_.empty());
   if (!secondary_init_clusters_.empty()) {
@@ -175,6 +198,8 @@ void ClusterManagerInitHelper::maybeFinishInitialize() {
         maybe_resume_eds = cm_.adsMux()->pause(type_urls);
       }
       initializeSecondaryClusters();
+    } else if (max_concurrent_secondary_init_ != 0) {
+      initializeSecondaryClusters();
     }
     return;
   }
@@ -253,9 +278,17 @@ ClusterManagerImpl::ClusterManagerImpl(
     Http::Context& http_context, Grpc::Context& grpc_context, Router::Context& router_context)
     : factory_(factory), runtime_(runtime), stats_(stats), tls_(tls),
       random_(api.randomGenerator()),
-      bind_config_(bootstrap.cluster_manager().upstream_bind_config()), local_info_(local_info),
+      max_concurrent_warming_clusters_(
+          bootstrap.cluster_manager().max_concurrent_warming_clusters()),
+      bind_config_(bootstrap.cluster_manager().upstream_bind_config()),
+      lazy_thread_local_clusters_(bootstrap.cluster_manager().has_lazy_thread_local_clusters()),
+      lazy_cluster_idle_timeout_(PROTOBUF_GET_MS_OR_DEFAULT(
+          bootstrap.cluster_manager().lazy_thread_local_clusters(), idle_timeout, 0)),
+      local_info_(local_info),
       cm_stats_(generateStats(stats)),
-      init_helper_(*this, [this](ClusterManagerCluster& cluster) { onClusterInit(cluster); }),
+      init_helper_(
+          *this, [this](ClusterManagerCluster& cluster) { onClusterInit(cluster); },
+          bootstrap.cluster_manager().max_concurrent_warming_clusters()),
       config_tracker_entry_(
           admin.getConfigTracker().add("clusters", [this] { return dumpClusterConfigs(); })),
       time_source_(main_thread_dispatcher.timeSource()), dispatcher_(main_thread_dispatcher),
@@ -320,7 +353,13 @@ ClusterManagerImpl::ClusterManagerImpl(
   if (dyn_resources.has_ads_config()) {
     if (dyn_resources.ads_config().api_type() ==
         envoy::config::core::v3::ApiConfigSource::DELTA_GRPC) {
-      ads_mux_ = std::make_shared<Config::NewGrpcMuxImpl>(
+      if (!dyn_resources.ads_snapshot_directory().empty()) {
+        throw EnvoyException("ads_snapshot_directory is only supported with api_type GRPC");
+      }
+      if (dyn_resources.ads_hot_restart_handoff()) {
+        throw EnvoyException("ads_hot_restart_handoff is only supported with api_type GRPC");
+      }
+      auto ads_mux = std::make_shared<Config::NewGrpcMuxImpl>(
           Config::Utility::factoryForGrpcApiConfigSource(*async_client_manager_,
                                                          dyn_resources.ads_config(), stats, false)
               ->create(),
@@ -335,8 +374,10 @@ ClusterManagerImpl::ClusterManagerImpl(
                     "DeltaAggregatedResources"),
           Config::Utility::getAndCheckTransportVersion(dyn_resources.ads_config()), random_, stats_,
           Envoy::Config::Utility::parseRateLimitSettings(dyn_resources.ads_config()), local_info);
+      ads_mux->enableParallelDecoding(api.threadFactory());
+      ads_mux_ = std::move(ads_mux);
     } else {
-      ads_mux_ = std::make_shared<Config::GrpcMuxImpl>(
+      auto ads_mux = std::make_shared<Config::GrpcMuxImpl>(
           local_info,
           Config::Utility::factoryForGrpcApiConfigSource(*async_client_manager_,
                                                          dyn_resources.ads_config(), stats, false)
@@ -354,6 +395,18 @@ ClusterManagerImpl::ClusterManagerImpl(
           Config::Utility::getAndCheckTransportVersion(dyn_resources.ads_config()), random_, stats_,
           Envoy::Config::Utility::parseRateLimitSettings(dyn_resources.ads_config()),
           bootstrap.dynamic_resources().ads_config().set_node_on_first_message_only());
+      ads_mux->enableParallelDecoding(api.threadFactory());
+      if (!dyn_resources.ads_snapshot_directory().empty()) {
+        if (!api.fileSystem().directoryExists(dyn_resources.ads_snapshot_directory())) {
+          throw EnvoyException(fmt::format("ads_snapshot_directory {} does not exist",
+                                           dyn_resources.ads_snapshot_directory()));
+        }
+        ads_mux->enableSnapshots(api.fileSystem(), dyn_resources.ads_snapshot_directory());
+      }
+      if (dyn_resources.ads_hot_restart_handoff()) {
+        ads_mux->enableHandoff();
+      }
+      ads_mux_ = std::move(ads_mux);
     }
   } else {
     ads_mux_ = std::make_unique<Config::NullGrpcMuxImpl>();
@@ -655,18 +708,52 @@ bool ClusterManagerImpl::addOrUpdateCluster(const envoy::config::cluster::v3::Cl
   if (!all_clusters_initialized) {
     ENVOY_LOG(debug, "add/update cluster {} during init", cluster_name);
     init_helper_.addCluster(*cluster_entry);
+  } else if (max_concurrent_warming_clusters_ == 0 ||
+             warming_in_progress_.contains(cluster_name) ||
+             warming_in_progress_.size() < max_concurrent_warming_clusters_) {
+    // An update of a cluster which is warming takes over the warming slot of the previous cluster.
+    startWarming(cluster_name);
   } else {
-    ENVOY_LOG(debug, "add/update cluster {} starting warming", cluster_name);
-    cluster_entry->cluster_->initialize([this, cluster_name] {
-      ENVOY_LOG(debug, "warming cluster {} complete", cluster_name);
-      auto state_changed_cluster_entry = warming_clusters_.find(cluster_name);
-      onClusterInit(*state_changed_cluster_entry->second);
-    });
+    ENVOY_LOG(debug, "add/update cluster {} waiting to start warming", cluster_name);
+    pending_warming_.push_back(cluster_name);
   }
 
   return true;
 }
 
+void ClusterManagerImpl::startWarming(const std::string& cluster_name) {
+  ENVOY_LOG(debug, "add/update cluster {} starting warming", cluster_name);
+  warming_in_progress_.insert(cluster_name);
+  warming_clusters_.at(cluster_name)->cluster_->initialize([this, cluster_name] {
+    ENVOY_LOG(debug, "warming cluster {} complete", cluster_name);
+    warming_in_progress_.erase(cluster_name);
+    auto state_changed_cluster_entry = warming_clusters_.find(cluster_name);
+    onClusterInit(*state_changed_cluster_entry->second);
+    startPendingWarming();
+  });
+}
+
+void ClusterManagerImpl::startPendingWarming() {
+  if (starting_pending_warming_) {
+    // A cluster completed its warming synchronously, the loop below already goes on with the
+    // next clusters.
+    return;
+  }
+  starting_pending_warming_ = true;
+  while (!pending_warming_.empty() &&
+         warming_in_progress_.size() < max_concurrent_warming_clusters_) {
+    const std::string cluster_name = std::move(pending_warming_.front());
+    pending_warming_.pop_front();
+    // The cluster may have been removed, or updated again and already started, since it was
+    // queued.
+    if (warming_clusters_.count(cluster_name) > 0 &&
+        !warming_in_progress_.contains(cluster_name)) {
+      startWarming(cluster_name);
+    }
+  }
+  starting_pending_warming_ = false;
+}
+
 void ClusterManagerImpl::clusterWarmingToActive(const std::string& cluster_name) {
   auto warming_it = warming_clusters_.find(cluster_name);
   ASSERT(warming_it != warming_clusters_.end());
@@ -690,6 +777,11 @@ bool ClusterManagerImpl::removeCluster(const std::string& cluster_name) {
 
     ENVOY_LOG(info, "removing cluster {}", cluster_name);
     tls_.runOnAllThreads([cluster_name](OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
+      if (cluster_manager->lazy_clusters_.erase(cluster_name) > 0 &&
+          cluster_manager->thread_local_clusters_.count(cluster_name) == 0) {
+        // The thread never instantiated the lazy cluster, so nothing saw it.
+        return;
+      }
       ASSERT(cluster_manager->thread_local_clusters_.count(cluster_name) == 1);
       ENVOY_LOG(debug, "removing TLS cluster {}", cluster_name);
       for (auto& cb : cluster_manager->update_callbacks_) {
@@ -706,6 +798,9 @@ bool ClusterManagerImpl::removeCluster(const std::string& cluster_name) {
     init_helper_.removeCluster(*existing_warming_cluster->second);
     warming_clusters_.erase(existing_warming_cluster);
     ENVOY_LOG(info, "removing warming cluster {}", cluster_name);
+    if (warming_in_progress_.erase(cluster_name) > 0) {
+      startPendingWarming();
+    }
   }
 
   if (removed) {
@@ -835,13 +930,7 @@ void ClusterManagerImpl::updateClusterCounts() {
 
 ThreadLocalCluster* ClusterManagerImpl::getThreadLocalCluster(absl::string_view cluster) {
   ThreadLocalClusterManagerImpl& cluster_manager = *tls_;
-
-  auto entry = cluster_manager.thread_local_clusters_.find(cluster);
-  if (entry != cluster_manager.thread_local_clusters_.end()) {
-    return entry->second.get();
-  } else {
-    return nullptr;
-  }
+  return cluster_manager.getCluster(cluster);
 }
 
 void ClusterManagerImpl::maybePreconnect(
@@ -939,6 +1028,11 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(ClusterManagerCluster& cm_
   tls_.runOnAllThreads(
       [info = cm_cluster.cluster().info(), params = std::move(params), add_or_update_cluster,
        load_balancer_factory](OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
+        if (cluster_manager->updateLazyCluster(info, load_balancer_factory, add_or_update_cluster,
+                                               params)) {
+          return;
+        }
+
         ThreadLocalClusterManagerImpl::ClusterEntry* new_cluster = nullptr;
         if (add_or_update_cluster) {
           if (cluster_manager->thread_local_clusters_.count(info->name()) > 0) {
@@ -1049,6 +1143,14 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ThreadLocalClusterManagerImpl
         *this, local_cluster_params->info_, local_cluster_params->load_balancer_factory_);
     local_priority_set_ = &thread_local_clusters_[local_cluster_name]->priority_set_;
   }
+
+  if (parent_.lazy_thread_local_clusters_ && parent_.lazy_cluster_idle_timeout_.count() > 0) {
+    lazy_cluster_idle_timer_ = dispatcher.createTimer([this]() -> void {
+      releaseIdleLazyClusters();
+      lazy_cluster_idle_timer_->enableTimer(parent_.lazy_cluster_idle_timeout_);
+    });
+    lazy_cluster_idle_timer_->enableTimer(parent_.lazy_cluster_idle_timeout_);
+  }
 }
 
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::~ThreadLocalClusterManagerImpl() {
@@ -1181,14 +1283,14 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::removeTcpConn(
 
 void ClusterManagerImpl::ThreadLocalClusterManagerImpl::removeHosts(
     const std::string& name, const HostVector& hosts_removed) {
-  ASSERT(thread_local_clusters_.find(name) != thread_local_clusters_.end());
-  const auto& cluster_entry = thread_local_clusters_[name];
+  ASSERT(thread_local_clusters_.find(name) != thread_local_clusters_.end() ||
+         lazy_clusters_.find(name) != lazy_clusters_.end());
   ENVOY_LOG(debug, "removing hosts for TLS cluster {} removed {}", name, hosts_removed.size());
 
   // We need to go through and purge any connection pools for hosts that got deleted.
   // Even if two hosts actually point to the same address this will be safe, since if a
   // host is readded it will be a different physical HostSharedPtr.
-  cluster_entry->parent_.drainConnPools(hosts_removed);
+  drainConnPools(hosts_removed);
 }
 
 void ClusterManagerImpl::ThreadLocalClusterManagerImpl::updateClusterMembership(
@@ -1270,6 +1372,88 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::onHostHealthFailure(
   }
 }
 
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry*
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::getCluster(absl::string_view name) {
+  auto entry = thread_local_clusters_.find(name);
+  if (entry != thread_local_clusters_.end()) {
+    entry->second->used_ = true;
+    return entry->second.get();
+  }
+
+  auto lazy_cluster = lazy_clusters_.find(name);
+  if (lazy_cluster == lazy_clusters_.end()) {
+    return nullptr;
+  }
+  const LazyCluster& cluster = lazy_cluster->second;
+  ENVOY_LOG(debug, "instantiating lazy TLS cluster {}", cluster.info_->name());
+  auto* new_cluster = new ClusterEntry(*this, cluster.info_, cluster.lb_factory_);
+  thread_local_clusters_[cluster.info_->name()].reset(new_cluster);
+  new_cluster->used_ = true;
+  for (const auto& membership : cluster.membership_) {
+    updateClusterMembership(cluster.info_->name(), membership.first,
+                            membership.second.update_hosts_params_,
+                            membership.second.locality_weights_,
+                            *membership.second.update_hosts_params_.hosts, HostVector{},
+                            membership.second.overprovisioning_factor_);
+  }
+  for (auto& cb : update_callbacks_) {
+    cb->onClusterAddOrUpdate(*new_cluster);
+  }
+  return new_cluster;
+}
+
+bool ClusterManagerImpl::ThreadLocalClusterManagerImpl::updateLazyCluster(
+    const ClusterInfoConstSharedPtr& info, const LoadBalancerFactorySharedPtr& lb_factory,
+    bool add_or_update_cluster, const ThreadLocalClusterUpdateParams& params) {
+  auto lazy_cluster = lazy_clusters_.find(info->name());
+  if (add_or_update_cluster) {
+    if (!parent_.lazy_thread_local_clusters_) {
+      return false;
+    }
+    if (lazy_cluster == lazy_clusters_.end()) {
+      lazy_cluster = lazy_clusters_.emplace(info->name(), LazyCluster()).first;
+    }
+    lazy_cluster->second.info_ = info;
+    lazy_cluster->second.lb_factory_ = lb_factory;
+    lazy_cluster->second.membership_.clear();
+  } else if (lazy_cluster == lazy_clusters_.end()) {
+    return false;
+  }
+
+  // The update params hold the full membership of the updated priorities.
+  for (const auto& per_priority : params.per_priority_update_params_) {
+    lazy_cluster->second.membership_.insert_or_assign(
+        per_priority.priority_,
+        LazyCluster::Membership{per_priority.update_hosts_params_, per_priority.locality_weights_,
+                                per_priority.overprovisioning_factor_});
+  }
+  // An instantiated thread local cluster is updated as usual.
+  return thread_local_clusters_.find(info->name()) == thread_local_clusters_.end();
+}
+
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::releaseIdleLazyClusters() {
+  std::vector<std::string> idle_clusters;
+  for (auto& cluster : thread_local_clusters_) {
+    if (lazy_clusters_.find(cluster.first) == lazy_clusters_.end()) {
+      continue;
+    }
+    // A cluster with in flight async client streams is not released, as they would be reset.
+    if (cluster.second->used_ || cluster.second->http_async_client_.hasActiveStreams()) {
+      cluster.second->used_ = false;
+      continue;
+    }
+    idle_clusters.push_back(cluster.first);
+  }
+
+  for (const std::string& name : idle_clusters) {
+    ENVOY_LOG(debug, "releasing idle lazy TLS cluster {}", name);
+    for (auto& cb : update_callbacks_) {
+      cb->onClusterRemoval(name);
+    }
+    thread_local_clusters_.erase(name);
+  }
+}
+
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ConnPoolsContainer*
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::getHttpConnPoolsContainer(
     const HostConstSharedPtr& host, bool allocate) {
@@ -1493,6 +1677,10 @@ Http::ConnectionPool::InstancePtr ProdClusterManagerFactory::allocateConnPool(
     return Http::Http2::allocateConnPool(dispatcher, api_.randomGenerator(), host, priority,
                                          options, transport_socket_options, state);
   }
+  if (protocols.size() == 1 && protocols[0] == Http::Protocol::Http3) {
+    return Http::Http3::allocateConnPool(dispatcher, api_.randomGenerator(), host, priority,
+                                         options, transport_socket_options, state);
+  }
   ASSERT(protocols.size() == 1 && protocols[0] == Http::Protocol::Http11);
   return Http::Http1::allocateConnPool(dispatcher, api_.randomGenerator(), host, priority, options,
                                        transport_socket_options, state);
@@ -1528,7 +1716,8 @@ CdsApiPtr
 ProdClusterManagerFactory::createCds(const envoy::config::core::v3::ConfigSource& cds_config,
                                      ClusterManager& cm) {
   // TODO(htuch): Differentiate static vs. dynamic validation visitors.
-  return CdsApiImpl::create(cds_config, cm, stats_, validation_context_.dynamicValidationVisitor());
+  return CdsApiImpl::create(cds_config, cm, tls_, stats_,
+                            validation_context_.dynamicValidationVisitor());
 }
 
 } // namespace Upstream
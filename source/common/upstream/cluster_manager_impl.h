@@ -33,6 +33,8 @@
 #include "common/upstream/priority_conn_pool_map.h"
 #include "common/upstream/upstream_impl.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -130,11 +132,15 @@ public:
   /**
    * @param per_cluster_init_callback supplies the callback to call when a cluster has itself
    *        initialized. The cluster manager can use this for post-init processing.
+   * @param max_concurrent_secondary_init supplies the maximum number of secondary clusters which
+   *        initialize at the same time, or 0 if there is no limit.
    */
   ClusterManagerInitHelper(
       ClusterManager& cm,
-      const std::function<void(ClusterManagerCluster&)>& per_cluster_init_callback)
-      : cm_(cm), per_cluster_init_callback_(per_cluster_init_callback) {}
+      const std::function<void(ClusterManagerCluster&)>& per_cluster_init_callback,
+      uint32_t max_concurrent_secondary_init = 0)
+      : cm_(cm), per_cluster_init_callback_(per_cluster_init_callback),
+        max_concurrent_secondary_init_(max_concurrent_secondary_init) {}
 
   enum class State {
     // Initial state. During this state all static clusters are loaded. Any primary clusters
@@ -185,8 +191,12 @@ private:
   ClusterManager::InitializationCompleteCallback initialized_callback_;
   std::list<ClusterManagerCluster*> primary_init_clusters_;
   std::list<ClusterManagerCluster*> secondary_init_clusters_;
+  const uint32_t max_concurrent_secondary_init_;
+  // The secondary clusters whose initialization has started and not completed yet.
+  absl::flat_hash_set<ClusterManagerCluster*> initializing_secondary_clusters_;
   State state_{State::Loading};
   bool started_secondary_initialize_{};
+  bool initializing_secondary_{};
 };
 
 /**
@@ -416,10 +426,26 @@ private:
       LoadBalancerPtr lb_;
       ClusterInfoConstSharedPtr cluster_info_;
       Http::AsyncClientImpl http_async_client_;
+      // Whether the cluster was looked up since the previous check for idle lazy clusters.
+      bool used_{};
     };
 
     using ClusterEntryPtr = std::unique_ptr<ClusterEntry>;
 
+    // The definition and the current membership of a cluster whose thread local cluster is only
+    // instantiated when the thread first uses it.
+    struct LazyCluster {
+      struct Membership {
+        PrioritySet::UpdateHostsParams update_hosts_params_;
+        LocalityWeightsConstSharedPtr locality_weights_;
+        uint32_t overprovisioning_factor_;
+      };
+
+      ClusterInfoConstSharedPtr info_;
+      LoadBalancerFactorySharedPtr lb_factory_;
+      std::map<uint32_t, Membership> membership_;
+    };
+
     struct LocalClusterParams {
       LoadBalancerFactorySharedPtr load_balancer_factory_;
       ClusterInfoConstSharedPtr info_;
@@ -440,6 +466,15 @@ private:
                                  const HostVector& hosts_added, const HostVector& hosts_removed,
                                  uint64_t overprovisioning_factor);
     void onHostHealthFailure(const HostSharedPtr& host);
+    // Returns the thread local cluster of a cluster, instantiating it if the cluster is lazy.
+    ClusterEntry* getCluster(absl::string_view name);
+    // Records the update of a lazy cluster. Returns true if the thread local cluster of the
+    // cluster is not instantiated, in which case there is nothing else to update.
+    bool updateLazyCluster(const ClusterInfoConstSharedPtr& info,
+                           const LoadBalancerFactorySharedPtr& lb_factory,
+                           bool add_or_update_cluster,
+                           const ThreadLocalClusterUpdateParams& params);
+    void releaseIdleLazyClusters();
 
     ConnPoolsContainer* getHttpConnPoolsContainer(const HostConstSharedPtr& host,
                                                   bool allocate = false);
@@ -447,6 +482,8 @@ private:
     ClusterManagerImpl& parent_;
     Event::Dispatcher& thread_local_dispatcher_;
     absl::flat_hash_map<std::string, ClusterEntryPtr> thread_local_clusters_;
+    absl::flat_hash_map<std::string, LazyCluster> lazy_clusters_;
+    Event::TimerPtr lazy_cluster_idle_timer_;
 
     ClusterConnectivityState cluster_manager_state_;
 
@@ -562,6 +599,8 @@ private:
   void postThreadLocalHealthFailure(const HostSharedPtr& host);
   void updateClusterCounts();
   void clusterWarmingToActive(const std::string& cluster_name);
+  void startWarming(const std::string& cluster_name);
+  void startPendingWarming();
   static void maybePreconnect(ThreadLocalClusterManagerImpl::ClusterEntry& cluster_entry,
                               std::function<ConnectionPool::Instance*()> preconnect_pool);
 
@@ -576,7 +615,17 @@ protected:
 
 private:
   ClusterMap warming_clusters_;
+  // The maximum number of clusters added or updated after initialization which warm at the same
+  // time, or 0 if there is no limit.
+  const uint32_t max_concurrent_warming_clusters_;
+  // The warming clusters whose warming has started.
+  absl::flat_hash_set<std::string> warming_in_progress_;
+  // The warming clusters waiting for a warming slot, in the order they were added or updated.
+  std::list<std::string> pending_warming_;
+  bool starting_pending_warming_{};
   envoy::config::core::v3::BindConfig bind_config_;
+  const bool lazy_thread_local_clusters_;
+  const std::chrono::milliseconds lazy_cluster_idle_timeout_;
   Outlier::EventLoggerSharedPtr outlier_event_logger_;
   const LocalInfo::LocalInfo& local_info_;
   CdsApiPtr cds_api_;
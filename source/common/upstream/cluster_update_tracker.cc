@@ -4,7 +4,7 @@ namespace Envoy {
 namespace Upstream {
 
 ClusterUpdateTracker::ClusterUpdateTracker(ClusterManager& cm, const std::string& cluster_name)
-    : cluster_name_(cluster_name),
+    : cm_(cm), cluster_name_(cluster_name),
       cluster_update_callbacks_handle_(cm.addThreadLocalClusterUpdateCallbacks(*this)) {
   Upstream::ThreadLocalCluster* cluster = cm.getThreadLocalCluster(cluster_name_);
   if (cluster != nullptr) {
@@ -12,6 +12,17 @@ ClusterUpdateTracker::ClusterUpdateTracker(ClusterManager& cm, const std::string
   }
 }
 
+ThreadLocalClusterOptRef ClusterUpdateTracker::threadLocalCluster() {
+  if (!thread_local_cluster_.has_value()) {
+    // The thread local cluster of a lazy cluster is only instantiated when it is looked up.
+    Upstream::ThreadLocalCluster* cluster = cm_.getThreadLocalCluster(cluster_name_);
+    if (cluster != nullptr) {
+      thread_local_cluster_ = *cluster;
+    }
+  }
+  return thread_local_cluster_;
+}
+
 void ClusterUpdateTracker::onClusterAddOrUpdate(ThreadLocalCluster& cluster) {
   if (cluster.info()->name() != cluster_name_) {
     return;
@@ -14,13 +14,14 @@ namespace Upstream {
 class ClusterUpdateTracker : public ClusterUpdateCallbacks {
 public:
   ClusterUpdateTracker(ClusterManager& cm, const std::string& cluster_name);
-  ThreadLocalClusterOptRef threadLocalCluster() { return thread_local_cluster_; };
+  ThreadLocalClusterOptRef threadLocalCluster();
 
   // ClusterUpdateCallbacks
   void onClusterAddOrUpdate(ThreadLocalCluster& cluster) override;
   void onClusterRemoval(const std::string& cluster) override;
 
 private:
+  ClusterManager& cm_;
   const std::string cluster_name_;
   const ClusterUpdateCallbacksHandlePtr cluster_update_callbacks_handle_;
 
@@ -7,6 +7,7 @@
 #include "envoy/service/discovery/v3/discovery.pb.h"
 
 #include "common/common/assert.h"
+#include "common/common/hash.h"
 #include "common/common/utility.h"
 #include "common/config/api_version.h"
 #include "common/config/decoded_resource_impl.h"
@@ -14,6 +15,24 @@
 
 namespace Envoy {
 namespace Upstream {
+namespace {
+
+// Hashes the configuration of an endpoint, seeded with the hash of the locality and priority it is
+// listed in. The buffer is reused across the endpoints of an update.
+uint64_t endpointHash(const envoy::config::endpoint::v3::LbEndpoint& lb_endpoint,
+                      uint64_t locality_hash, std::string& buffer) {
+  buffer.clear();
+  {
+    // Metadata is made of maps, so the serialization must be deterministic.
+    Protobuf::io::StringOutputStream string_stream(&buffer);
+    Protobuf::io::CodedOutputStream coded_stream(&string_stream);
+    coded_stream.SetSerializationDeterministic(true);
+    lb_endpoint.SerializeToCodedStream(&coded_stream);
+  }
+  return HashUtil::xxHash64(buffer, locality_hash);
+}
+
+} // namespace
 
 EdsClusterImpl::EdsClusterImpl(
     const envoy::config::cluster::v3::Cluster& cluster, Runtime::Loader& runtime,
@@ -49,16 +68,29 @@ void EdsClusterImpl::startPreInit() { subscription_->start({cluster_name_}); }
 void EdsClusterImpl::BatchUpdateHelper::batchUpdate(PrioritySet::HostUpdateCb& host_update_cb) {
   absl::node_hash_map<std::string, HostSharedPtr> updated_hosts;
   PriorityStateManager priority_state_manager(parent_, parent_.local_info_, &host_update_cb);
+  std::vector<std::pair<uint64_t, HostSharedPtr>> endpoint_hosts;
+  std::string buffer;
   for (const auto& locality_lb_endpoint : cluster_load_assignment_.endpoints()) {
     parent_.validateEndpointsForZoneAwareRouting(locality_lb_endpoint);
 
     priority_state_manager.initializePriorityFor(locality_lb_endpoint);
+    const uint32_t priority = locality_lb_endpoint.priority();
+    const uint64_t locality_hash = HashUtil::xxHash64(
+        absl::StrCat(priority), MessageUtil::hash(locality_lb_endpoint.locality()));
 
     for (const auto& lb_endpoint : locality_lb_endpoint.lb_endpoints()) {
-      priority_state_manager.registerHostForPriority(
-          lb_endpoint.endpoint().hostname(),
-          parent_.resolveProtoAddress(lb_endpoint.endpoint().address()), locality_lb_endpoint,
-          lb_endpoint, parent_.time_source_);
+      const uint64_t endpoint_hash = endpointHash(lb_endpoint, locality_hash, buffer);
+      HostSharedPtr host = parent_.findUnchangedHost(endpoint_hash);
+      if (host != nullptr) {
+        priority_state_manager.registerHostForPriority(host, locality_lb_endpoint);
+      } else {
+        priority_state_manager.registerHostForPriority(
+            lb_endpoint.endpoint().hostname(),
+            parent_.resolveProtoAddress(lb_endpoint.endpoint().address()), locality_lb_endpoint,
+            lb_endpoint, parent_.time_source_);
+        host = priority_state_manager.priorityState()[priority].first->back();
+      }
+      endpoint_hosts.emplace_back(endpoint_hash, std::move(host));
     }
   }
 
@@ -103,6 +135,23 @@ void EdsClusterImpl::BatchUpdateHelper::batchUpdate(PrioritySet::HostUpdateCb& h
 
   parent_.all_hosts_ = std::move(updated_hosts);
 
+  // The endpoints are matched to hosts by address, so the endpoints that list the same address
+  // share the host of one of them. Only hosts that reflect a single endpoint can be reused.
+  absl::flat_hash_map<const Host*, uint32_t> endpoints_per_host;
+  for (auto& endpoint_host : endpoint_hosts) {
+    const auto host = parent_.all_hosts_.find(endpoint_host.second->address()->asString());
+    ASSERT(host != parent_.all_hosts_.end());
+    endpoint_host.second = host->second;
+    ++endpoints_per_host[endpoint_host.second.get()];
+  }
+  parent_.hosts_by_endpoint_hash_.clear();
+  for (auto& endpoint_host : endpoint_hosts) {
+    if (endpoints_per_host[endpoint_host.second.get()] == 1) {
+      parent_.hosts_by_endpoint_hash_.emplace(endpoint_host.first,
+                                              std::move(endpoint_host.second));
+    }
+  }
+
   if (!cluster_rebuilt) {
     parent_.info_->stats().update_no_rebuild_.inc();
   }
@@ -112,6 +161,19 @@ void EdsClusterImpl::BatchUpdateHelper::batchUpdate(PrioritySet::HostUpdateCb& h
   parent_.onPreInitComplete();
 }
 
+HostSharedPtr EdsClusterImpl::findUnchangedHost(uint64_t endpoint_hash) const {
+  const auto host = hosts_by_endpoint_hash_.find(endpoint_hash);
+  if (host == hosts_by_endpoint_hash_.end()) {
+    return nullptr;
+  }
+  // The host may have been removed since the last update after failing active health checking.
+  const auto existing_host = all_hosts_.find(host->second->address()->asString());
+  if (existing_host == all_hosts_.end() || existing_host->second != host->second) {
+    return nullptr;
+  }
+  return host->second;
+}
+
 void EdsClusterImpl::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& resources,
                                     const std::string&) {
   if (!validateUpdateSize(resources.size())) {
@@ -21,6 +21,8 @@
 
 #include "extensions/clusters/well_known_names.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -60,6 +62,7 @@ private:
   void reloadHealthyHostsHelper(const HostSharedPtr& host) override;
   void startPreInit() override;
   void onAssignmentTimeout();
+  HostSharedPtr findUnchangedHost(uint64_t endpoint_hash) const;
 
   class BatchUpdateHelper : public PrioritySet::BatchUpdateCb {
   public:
@@ -81,6 +84,10 @@ private:
   const std::string cluster_name_;
   std::vector<LocalityWeightsMap> locality_weights_map_;
   HostMap all_hosts_;
+  // The hosts of the endpoints of the last update, keyed by a hash of the configuration of their
+  // endpoint. Endpoints whose configuration did not change reuse their host instead of resolving
+  // their address and building a new host that updateDynamicHostList() would throw away.
+  absl::flat_hash_map<uint64_t, HostSharedPtr> hosts_by_endpoint_hash_;
   Event::TimerPtr assignment_timeout_;
   InitializePhase initialize_phase_;
 };
@@ -1,5 +1,7 @@
 #include "common/upstream/health_checker_base_impl.h"
 
+#include <algorithm>
+
 #include "envoy/config/core/v3/address.pb.h"
 #include "envoy/config/core/v3/health_check.pb.h"
 #include "envoy/data/core/v3/health_check_event.pb.h"
@@ -8,6 +10,8 @@
 #include "common/network/utility.h"
 #include "common/router/router.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -38,7 +42,8 @@ HealthCheckerImplBase::HealthCheckerImplBase(const Cluster& cluster,
       healthy_edge_interval_(
           PROTOBUF_GET_MS_OR_DEFAULT(config, healthy_edge_interval, interval_.count())),
       transport_socket_options_(initTransportSocketOptions(config)),
-      transport_socket_match_metadata_(initTransportSocketMatchMetadata(config)) {
+      transport_socket_match_metadata_(initTransportSocketMatchMetadata(config)),
+      config_hash_(MessageUtil::hash(config)) {
   cluster_.prioritySet().addMemberUpdateCb(
       [this](const HostVector& hosts_added, const HostVector& hosts_removed) -> void {
         onClusterMemberUpdate(hosts_added, hosts_removed);
@@ -80,6 +85,67 @@ HealthCheckerImplBase::~HealthCheckerImplBase() {
   }
 }
 
+bool HealthCheckSessionRegistry::add(const std::string& key, SharedHealthCheckSession& session) {
+  auto& sessions = sessions_[key];
+  sessions.push_back(&session);
+  return sessions.size() == 1;
+}
+
+void HealthCheckSessionRegistry::remove(const std::string& key,
+                                        SharedHealthCheckSession& session) {
+  auto it = sessions_.find(key);
+  ASSERT(it != sessions_.end());
+  const bool probing = it->second.front() == &session;
+  it->second.remove(&session);
+  if (it->second.empty()) {
+    sessions_.erase(it);
+  } else if (probing) {
+    it->second.front()->onSharedProbeStart();
+  }
+}
+
+void HealthCheckSessionRegistry::onSuccess(const std::string& key,
+                                           const SharedHealthCheckSession& session,
+                                           bool degraded) {
+  for (SharedHealthCheckSession* other : others(key, session)) {
+    if (contains(key, *other)) {
+      other->onSharedSuccess(degraded);
+    }
+  }
+}
+
+void HealthCheckSessionRegistry::onFailure(const std::string& key,
+                                           const SharedHealthCheckSession& session,
+                                           envoy::data::core::v3::HealthCheckFailureType type) {
+  for (SharedHealthCheckSession* other : others(key, session)) {
+    if (contains(key, *other)) {
+      other->onSharedFailure(type);
+    }
+  }
+}
+
+std::vector<SharedHealthCheckSession*>
+HealthCheckSessionRegistry::others(const std::string& key,
+                                   const SharedHealthCheckSession& session) const {
+  std::vector<SharedHealthCheckSession*> others;
+  const auto it = sessions_.find(key);
+  if (it != sessions_.end()) {
+    for (SharedHealthCheckSession* other : it->second) {
+      if (other != &session) {
+        others.push_back(other);
+      }
+    }
+  }
+  return others;
+}
+
+bool HealthCheckSessionRegistry::contains(const std::string& key,
+                                          const SharedHealthCheckSession& session) const {
+  const auto it = sessions_.find(key);
+  return it != sessions_.end() &&
+         std::find(it->second.begin(), it->second.end(), &session) != it->second.end();
+}
+
 void HealthCheckerImplBase::decHealthy() { stats_.healthy_.sub(1); }
 
 void HealthCheckerImplBase::decDegraded() { stats_.degraded_.sub(1); }
@@ -243,11 +309,32 @@ HealthCheckerImplBase::ActiveHealthCheckSession::~ActiveHealthCheckSession() {
   ASSERT(interval_timer_ == nullptr && timeout_timer_ == nullptr);
 }
 
+void HealthCheckerImplBase::ActiveHealthCheckSession::start() {
+  if (parent_.session_registry_ != nullptr) {
+    // The sessions of the hosts of the endpoint in other clusters share the probes of the first
+    // one, so that the endpoint is probed once per interval.
+    shared_key_ = absl::StrCat(host_->healthCheckAddress()->asString(), "|",
+                               host_->hostnameForHealthChecks(), "|", parent_.config_hash_);
+    if (!parent_.session_registry_->add(shared_key_, *this)) {
+      return;
+    }
+  }
+  onInitialInterval();
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::onSharedProbeStart() {
+  interval_timer_->enableTimer(parent_.intervalWithJitter(0, parent_.initial_jitter_));
+}
+
 void HealthCheckerImplBase::ActiveHealthCheckSession::onDeferredDeleteBase() {
   // The session is about to be deferred deleted. Make sure all timers are gone and any
   // implementation specific state is destroyed.
   interval_timer_.reset();
   timeout_timer_.reset();
+  if (!shared_key_.empty()) {
+    parent_.session_registry_->remove(shared_key_, *this);
+    shared_key_.clear();
+  }
   if (!host_->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)) {
     parent_.decHealthy();
   }
@@ -258,6 +345,17 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::onDeferredDeleteBase() {
 }
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::handleSuccess(bool degraded) {
+  const HealthTransition changed_state = setHealthy(degraded);
+
+  timeout_timer_->disableTimer();
+  interval_timer_->enableTimer(parent_.interval(HealthState::Healthy, changed_state));
+
+  if (!shared_key_.empty()) {
+    parent_.session_registry_->onSuccess(shared_key_, *this, degraded);
+  }
+}
+
+HealthTransition HealthCheckerImplBase::ActiveHealthCheckSession::setHealthy(bool degraded) {
   // If we are healthy, reset the # of unhealthy to zero.
   num_unhealthy_ = 0;
 
@@ -305,9 +403,7 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::handleSuccess(bool degrade
   parent_.stats_.success_.inc();
   first_check_ = false;
   parent_.runCallbacks(host_, changed_state);
-
-  timeout_timer_->disableTimer();
-  interval_timer_->enableTimer(parent_.interval(HealthState::Healthy, changed_state));
+  return changed_state;
 }
 
 HealthTransition HealthCheckerImplBase::ActiveHealthCheckSession::setUnhealthy(
@@ -350,6 +446,8 @@ HealthTransition HealthCheckerImplBase::ActiveHealthCheckSession::setUnhealthy(
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::handleFailure(
     envoy::data::core::v3::HealthCheckFailureType type) {
+  // The key is cleared if the session is deferred deleted by the call below.
+  const std::string shared_key = shared_key_;
   HealthTransition changed_state = setUnhealthy(type);
   // It's possible that the previous call caused this session to be deferred deleted.
   if (timeout_timer_ != nullptr) {
@@ -359,6 +457,10 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::handleFailure(
   if (interval_timer_ != nullptr) {
     interval_timer_->enableTimer(parent_.interval(HealthState::Unhealthy, changed_state));
   }
+
+  if (!shared_key.empty()) {
+    parent_.session_registry_->onFailure(shared_key, *this, type);
+  }
 }
 
 HealthTransition
@@ -1,11 +1,16 @@
 #pragma once
 
+#include <list>
+#include <string>
+#include <vector>
+
 #include "envoy/access_log/access_log.h"
 #include "envoy/common/random_generator.h"
 #include "envoy/config/core/v3/health_check.pb.h"
 #include "envoy/data/core/v3/health_check_event.pb.h"
 #include "envoy/event/timer.h"
 #include "envoy/runtime/runtime.h"
+#include "envoy/singleton/instance.h"
 #include "envoy/stats/scope.h"
 #include "envoy/type/matcher/string.pb.h"
 #include "envoy/upstream/health_checker.h"
@@ -14,6 +19,8 @@
 #include "common/common/matchers.h"
 #include "common/network/transport_socket_options_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -54,6 +61,64 @@ struct HealthCheckerEqualTo {
   }
 };
 
+/**
+ * A health check session that may share the probes of an endpoint with the sessions of other
+ * health checkers.
+ */
+class SharedHealthCheckSession {
+public:
+  virtual ~SharedHealthCheckSession() = default;
+
+  /**
+   * Called with the result of a probe of another session of the endpoint.
+   */
+  virtual void onSharedSuccess(bool degraded) PURE;
+  virtual void onSharedFailure(envoy::data::core::v3::HealthCheckFailureType type) PURE;
+
+  /**
+   * Called when the session becomes the one that probes the endpoint, because the session that
+   * probed it is gone.
+   */
+  virtual void onSharedProbeStart() PURE;
+};
+
+/**
+ * Registry of the health check sessions that share probes, keyed by the endpoint and health check
+ * config. The first session of a key probes the endpoint and fans its results out to the others.
+ * The registry is only used on the main thread.
+ */
+class HealthCheckSessionRegistry : public Singleton::Instance {
+public:
+  /**
+   * Adds a session.
+   * @return true if the session is the first of its key, and so probes the endpoint.
+   */
+  bool add(const std::string& key, SharedHealthCheckSession& session);
+
+  /**
+   * Removes a session. If the session probed the endpoint, the next session of its key does.
+   */
+  void remove(const std::string& key, SharedHealthCheckSession& session);
+
+  /**
+   * Fans the result of a probe out to the other sessions of a key.
+   */
+  void onSuccess(const std::string& key, const SharedHealthCheckSession& session, bool degraded);
+  void onFailure(const std::string& key, const SharedHealthCheckSession& session,
+                 envoy::data::core::v3::HealthCheckFailureType type);
+
+private:
+  // Returns the sessions of a key other than the given one. The results are fanned out to a copy,
+  // as the callbacks of a result can remove sessions.
+  std::vector<SharedHealthCheckSession*> others(const std::string& key,
+                                                const SharedHealthCheckSession& session) const;
+  bool contains(const std::string& key, const SharedHealthCheckSession& session) const;
+
+  absl::flat_hash_map<std::string, std::list<SharedHealthCheckSession*>> sessions_;
+};
+
+using HealthCheckSessionRegistrySharedPtr = std::shared_ptr<HealthCheckSessionRegistry>;
+
 /**
  * Base implementation for all health checkers.
  */
@@ -71,13 +136,22 @@ public:
     return transport_socket_match_metadata_;
   }
 
+  /**
+   * Shares the probes of the endpoints of the hosts with the health checkers of other clusters
+   * that have the same config. Must be called before start().
+   */
+  void setSessionRegistry(HealthCheckSessionRegistrySharedPtr session_registry) {
+    session_registry_ = std::move(session_registry);
+  }
+
 protected:
-  class ActiveHealthCheckSession : public Event::DeferredDeletable {
+  class ActiveHealthCheckSession : public Event::DeferredDeletable,
+                                   public SharedHealthCheckSession {
   public:
     ~ActiveHealthCheckSession() override;
     HealthTransition setUnhealthy(envoy::data::core::v3::HealthCheckFailureType type);
     void onDeferredDeleteBase();
-    void start() { onInitialInterval(); }
+    void start();
 
   protected:
     ActiveHealthCheckSession(HealthCheckerImplBase& parent, HostSharedPtr host);
@@ -93,6 +167,14 @@ protected:
     // been health checked.
     // Returns the changed state to use following the flag update.
     HealthTransition clearPendingFlag(HealthTransition changed_state);
+    // Updates the host with a successful check, and returns the transition of its health.
+    HealthTransition setHealthy(bool degraded);
+    // Upstream::SharedHealthCheckSession
+    void onSharedSuccess(bool degraded) override { setHealthy(degraded); }
+    void onSharedFailure(envoy::data::core::v3::HealthCheckFailureType type) override {
+      setUnhealthy(type);
+    }
+    void onSharedProbeStart() override;
     virtual void onInterval() PURE;
     void onIntervalBase();
     virtual void onTimeout() PURE;
@@ -106,6 +188,8 @@ protected:
     uint32_t num_unhealthy_{};
     uint32_t num_healthy_{};
     bool first_check_{true};
+    // The key of the session in the session registry, if the health checker shares probes.
+    std::string shared_key_;
   };
 
   using ActiveHealthCheckSessionPtr = std::unique_ptr<ActiveHealthCheckSession>;
@@ -175,6 +259,8 @@ private:
   absl::node_hash_map<HostSharedPtr, ActiveHealthCheckSessionPtr> active_sessions_;
   const std::shared_ptr<const Network::TransportSocketOptionsImpl> transport_socket_options_;
   const MetadataConstSharedPtr transport_socket_match_metadata_;
+  const uint64_t config_hash_;
+  HealthCheckSessionRegistrySharedPtr session_registry_;
 };
 
 class HealthCheckEventLoggerImpl : public HealthCheckEventLogger {
@@ -35,13 +35,16 @@ public:
    * @param log_manager supplies the log_manager.
    * @param validation_visitor message validation visitor instance.
    * @param api reference to the Api object
+   * @param session_registry supplies the registry of the sessions that share probes across
+   *        clusters, used if the health check config shares sessions.
    * @return a health checker.
    */
   static HealthCheckerSharedPtr
   create(const envoy::config::core::v3::HealthCheck& health_check_config,
          Upstream::Cluster& cluster, Runtime::Loader& runtime, Event::Dispatcher& dispatcher,
          AccessLog::AccessLogManager& log_manager,
-         ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api);
+         ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api,
+         HealthCheckSessionRegistrySharedPtr session_registry = nullptr);
 };
 
 /**
@@ -1,5 +1,6 @@
 #include "common/upstream/load_balancer_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -11,6 +12,7 @@
 
 #include "common/common/assert.h"
 #include "common/protobuf/utility.h"
+#include "common/runtime/runtime_features.h"
 
 #include "absl/container/fixed_array.h"
 
@@ -21,6 +23,9 @@ namespace {
 static const std::string RuntimeZoneEnabled = "upstream.zone_routing.enabled";
 static const std::string RuntimeMinClusterSize = "upstream.zone_routing.min_cluster_size";
 static const std::string RuntimePanicThreshold = "upstream.healthy_panic_threshold";
+// The longest period of a stride schedule, which takes 4 bytes per pick. Host sources with a longer
+// period use the EDF scheduler.
+constexpr uint64_t MaxStrideSchedulePicks = 64 * 1024;
 
 // Distributes load between priorities based on the per priority availability and the normalized
 // total availability. Load is assigned to each priority according to how available each priority is
@@ -73,9 +78,8 @@ LoadBalancerBase::choosePriority(uint64_t hash, const HealthyLoad& healthy_per_p
                                  const DegradedLoad& degraded_per_priority_load) {
   hash = hash % 100 + 1; // 1-100
   uint32_t aggregate_percentage_load = 0;
-  // As with tryChooseLocalLocalityHosts, this can be refactored for efficiency
-  // but O(N) is good enough for now given the expected number of priorities is
-  // small.
+  // This can be refactored for efficiency but O(N) is good enough for now given the expected
+  // number of priorities is small.
 
   // We first attempt to select a priority based on healthy availability.
   for (size_t priority = 0; priority < healthy_per_priority_load.get().size(); ++priority) {
@@ -445,8 +449,8 @@ void ZoneAwareLoadBalancerBase::regenerateLocalityRoutingStructures() {
   // bucket sizes (residual capacity). For simplicity of finding where specific
   // sampled value is, we accumulate values in residual capacity. This is what it will look like:
   // residual_capacity: 0 10000 15000
-  // Now to find a locality to route (bucket) we could simply iterate over residual_capacity
-  // searching where sampled value is placed.
+  // Now to find a locality to route (bucket) we can binary search residual_capacity for where the
+  // sampled value is placed.
   state.residual_capacity_.resize(num_localities);
 
   // Local locality (index 0) does not have residual capacity as we have routed all we could.
@@ -593,16 +597,13 @@ uint32_t ZoneAwareLoadBalancerBase::tryChooseLocalLocalityHosts(const HostSet& h
   // capacity in localities.
   uint64_t threshold = random_.random() % state.residual_capacity_[number_of_localities - 1];
 
-  // This potentially can be optimized to be O(log(N)) where N is the number of localities.
-  // Linear scan should be faster for smaller N, in most of the scenarios N will be small.
+  // The locality is the first one whose accumulated residual capacity reaches the threshold, which
+  // a binary search finds in O(log(N)) where N is the number of localities.
   // TODO(htuch): is there a bug here when threshold == 0? Seems like we pick
-  // local locality in that situation. Probably should start iterating at 1.
-  int i = 0;
-  while (threshold > state.residual_capacity_[i]) {
-    i++;
-  }
-
-  return i;
+  // local locality in that situation. Probably should start searching at 1.
+  return std::lower_bound(state.residual_capacity_.begin(), state.residual_capacity_.end(),
+                          threshold) -
+         state.residual_capacity_.begin();
 }
 
 absl::optional<ZoneAwareLoadBalancerBase::HostsSource>
@@ -702,18 +703,43 @@ EdfLoadBalancerBase::EdfLoadBalancerBase(
   // The downside of a full recompute is that time complexity is O(n * log n),
   // so we will need to do better at delta tracking to scale (see
   // https://github.com/envoyproxy/envoy/issues/2874).
-  priority_set.addPriorityUpdateCb(
-      [this](uint32_t priority, const HostVector&, const HostVector&) { refresh(priority); });
+  // The schedulers are only recomputed on the first pick after the membership change. The stale
+  // ones are dropped right away so that they don't hold on to removed hosts.
+  priority_set.addPriorityUpdateCb([this](uint32_t priority, const HostVector&, const HostVector&) {
+    for (auto it = scheduler_.begin(); it != scheduler_.end();) {
+      if (it->first.priority_ == priority) {
+        scheduler_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+    if (std::find(stale_priorities_.begin(), stale_priorities_.end(), priority) ==
+        stale_priorities_.end()) {
+      stale_priorities_.push_back(priority);
+    }
+  });
 }
 
 void EdfLoadBalancerBase::initialize() {
+  stale_priorities_.clear();
   for (uint32_t priority = 0; priority < priority_set_.hostSetsPerPriority().size(); ++priority) {
+    stale_priorities_.push_back(priority);
+  }
+}
+
+void EdfLoadBalancerBase::refreshStalePriorities() {
+  for (const uint32_t priority : stale_priorities_) {
     refresh(priority);
   }
+  stale_priorities_.clear();
 }
 
 void EdfLoadBalancerBase::refresh(uint32_t priority) {
-  const auto add_hosts_source = [this](HostsSource source, const HostVector& hosts) {
+  const bool use_stride_scheduler =
+      !hostWeightDependsOnLoad() &&
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.weighted_lb_stride_scheduler");
+  const auto add_hosts_source = [this, use_stride_scheduler](HostsSource source,
+                                                             const HostVector& hosts) {
     // Nuke existing scheduler if it exists.
     auto& scheduler = scheduler_[source] = Scheduler{};
     refreshHostSource(source);
@@ -726,6 +752,23 @@ void EdfLoadBalancerBase::refresh(uint32_t priority) {
       return;
     }
 
+    // The weights are fixed until the next refresh, so the schedule can be computed up front unless
+    // a period of it would take too much memory.
+    if (use_stride_scheduler) {
+      std::vector<uint32_t> weights;
+      weights.reserve(hosts.size());
+      for (const auto& host : hosts) {
+        weights.push_back(host->weight());
+      }
+      scheduler.stride_ = StrideScheduler<const Host>::create({hosts.begin(), hosts.end()},
+                                                              weights, MaxStrideSchedulePicks);
+      if (scheduler.stride_ != nullptr) {
+        // Start at the same offset as the EDF schedule below.
+        scheduler.stride_->advance(seed_ % hosts.size());
+        return;
+      }
+    }
+
     scheduler.edf_ = std::make_unique<EdfScheduler<const Host>>();
 
     // Populate scheduler with host list.
@@ -774,6 +817,9 @@ void EdfLoadBalancerBase::refresh(uint32_t priority) {
 }
 
 HostConstSharedPtr EdfLoadBalancerBase::peekAnotherHost(LoadBalancerContext* context) {
+  if (!stale_priorities_.empty()) {
+    refreshStalePriorities();
+  }
   const absl::optional<HostsSource> hosts_source = hostSourceToUse(context, random(true));
   if (!hosts_source) {
     return nullptr;
@@ -787,9 +833,11 @@ HostConstSharedPtr EdfLoadBalancerBase::peekAnotherHost(LoadBalancerContext* con
 
   // As has been commented in both EdfLoadBalancerBase::refresh and
   // BaseDynamicClusterImpl::updateDynamicHostList, we must do a runtime pivot here to determine
-  // whether to use EDF or do unweighted (fast) selection. EDF is non-null iff the original weights
-  // of 2 or more hosts differ.
-  if (scheduler.edf_ != nullptr) {
+  // whether to use EDF or do unweighted (fast) selection. EDF or stride is non-null iff the
+  // original weights of 2 or more hosts differ.
+  if (scheduler.stride_ != nullptr) {
+    return scheduler.stride_->peekAgain();
+  } else if (scheduler.edf_ != nullptr) {
     return scheduler.edf_->peekAgain([this](const Host& host) { return hostWeight(host); });
   } else {
     const HostVector& hosts_to_use = hostSourceToHosts(*hosts_source);
@@ -801,6 +849,9 @@ HostConstSharedPtr EdfLoadBalancerBase::peekAnotherHost(LoadBalancerContext* con
 }
 
 HostConstSharedPtr EdfLoadBalancerBase::chooseHostOnce(LoadBalancerContext* context) {
+  if (!stale_priorities_.empty()) {
+    refreshStalePriorities();
+  }
   const absl::optional<HostsSource> hosts_source = hostSourceToUse(context, random(false));
   if (!hosts_source) {
     return nullptr;
@@ -813,9 +864,11 @@ HostConstSharedPtr EdfLoadBalancerBase::chooseHostOnce(LoadBalancerContext* cont
 
   // As has been commented in both EdfLoadBalancerBase::refresh and
   // BaseDynamicClusterImpl::updateDynamicHostList, we must do a runtime pivot here to determine
-  // whether to use EDF or do unweighted (fast) selection. EDF is non-null iff the original weights
-  // of 2 or more hosts differ.
-  if (scheduler.edf_ != nullptr) {
+  // whether to use EDF or do unweighted (fast) selection. EDF or stride is non-null iff the
+  // original weights of 2 or more hosts differ.
+  if (scheduler.stride_ != nullptr) {
+    return scheduler.stride_->pick();
+  } else if (scheduler.edf_ != nullptr) {
     auto host = scheduler.edf_->pickAndAdd([this](const Host& host) { return hostWeight(host); });
     return host;
   } else {
@@ -838,6 +891,7 @@ HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPeek(const HostVector
 HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector& hosts_to_use,
                                                                 const HostsSource&) {
   HostSharedPtr candidate_host = nullptr;
+  double candidate_cost = 0;
   for (uint32_t choice_idx = 0; choice_idx < choice_count_; ++choice_idx) {
     const int rand_idx = random_.random() % hosts_to_use.size();
     HostSharedPtr sampled_host = hosts_to_use[rand_idx];
@@ -845,11 +899,23 @@ HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector
     if (candidate_host == nullptr) {
       // Make a first choice to start the comparisons.
       candidate_host = sampled_host;
+      if (peak_ewma_) {
+        candidate_cost = cost(*candidate_host);
+      }
+      continue;
+    }
+
+    if (peak_ewma_) {
+      const double sampled_cost = cost(*sampled_host);
+      if (sampled_cost < candidate_cost) {
+        candidate_host = sampled_host;
+        candidate_cost = sampled_cost;
+      }
       continue;
     }
 
-    const auto candidate_active_rq = candidate_host->stats().rq_active_.value();
-    const auto sampled_active_rq = sampled_host->stats().rq_active_.value();
+    const auto candidate_active_rq = activeRequests(*candidate_host);
+    const auto sampled_active_rq = activeRequests(*sampled_host);
     if (sampled_active_rq < candidate_active_rq) {
       candidate_host = sampled_host;
     }
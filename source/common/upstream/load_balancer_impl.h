@@ -16,6 +16,7 @@
 #include "common/protobuf/utility.h"
 #include "common/runtime/runtime_protos.h"
 #include "common/upstream/edf_scheduler.h"
+#include "common/upstream/stride_scheduler.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -384,12 +385,19 @@ protected:
     // host weights of 2 or more hosts differ. When not present, the
     // implementation of chooseHostOnce falls back to unweightedHostPick.
     std::unique_ptr<EdfScheduler<const Host>> edf_;
+    // StrideScheduler for weighted LB, created instead of edf_ when the runtime feature
+    // envoy.reloadable_features.weighted_lb_stride_scheduler is enabled, the host weights do not
+    // depend on the load of the hosts, and a period of the schedule is short enough.
+    std::unique_ptr<StrideScheduler<const Host>> stride_;
   };
 
   void initialize();
 
   virtual void refresh(uint32_t priority);
 
+  // Refreshes the priorities that were updated since the last pick.
+  void refreshStalePriorities();
+
   // Seed to allow us to desynchronize load balancers across a fleet. If we don't
   // do this, multiple Envoys that receive an update at the same time (or even
   // multiple load balancers on the same host) will send requests to
@@ -400,6 +408,8 @@ protected:
 private:
   virtual void refreshHostSource(const HostsSource& source) PURE;
   virtual double hostWeight(const Host& host) PURE;
+  // Whether hostWeight() depends on the load of the host rather than only on its weight.
+  virtual bool hostWeightDependsOnLoad() const PURE;
   virtual HostConstSharedPtr unweightedHostPeek(const HostVector& hosts_to_use,
                                                 const HostsSource& source) PURE;
   virtual HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
@@ -407,6 +417,10 @@ private:
 
   // Scheduler for each valid HostsSource.
   absl::node_hash_map<HostsSource, Scheduler, HostsSourceHash> scheduler_;
+  // Priorities whose schedulers are rebuilt before the next pick. Membership updates only mark
+  // their priority, so that the updates between two picks rebuild the schedulers once, and the
+  // schedulers of a cluster that is not picked from are not rebuilt at all.
+  std::vector<uint32_t> stale_priorities_;
 };
 
 /**
@@ -435,6 +449,7 @@ private:
     peekahead_index_ = 0;
   }
   double hostWeight(const Host& host) override { return host.weight(); }
+  bool hostWeightDependsOnLoad() const override { return false; }
   HostConstSharedPtr unweightedHostPeek(const HostVector& hosts_to_use,
                                         const HostsSource& source) override {
     auto i = rr_indexes_.find(source);
@@ -476,6 +491,11 @@ private:
  * 2) Use a weighted Maglev table, and perform P2C on two random hosts selected from the table.
  *    The benefit of the Maglev table is at the expense of resolution, memory usage is capped.
  *    Additionally, the Maglev table can be shared amongst all threads.
+ *
+ * With peak EWMA configured, hosts are compared by the peak EWMA of their response times times
+ * their active requests plus one, as in Finagle's P2C-EWMA, so that a host that is slow but does
+ * not fail receives fewer requests. The averages are kept per worker by the response time monitors
+ * of the hosts. @see PeakEwmaResponseTimeMonitor
  */
 class LeastRequestLoadBalancer : public EdfLoadBalancerBase,
                                  Logger::Loggable<Logger::Id::upstream> {
@@ -496,7 +516,11 @@ public:
             least_request_config.has_value() && least_request_config->has_active_request_bias()
                 ? std::make_unique<Runtime::Double>(least_request_config->active_request_bias(),
                                                     runtime)
-                : nullptr) {
+                : nullptr),
+        worker_local_active_requests_(least_request_config.has_value() &&
+                                      least_request_config->worker_local_active_requests()),
+        peak_ewma_(least_request_config.has_value() &&
+                   least_request_config->has_peak_ewma_decay_time()) {
     initialize();
   }
 
@@ -534,16 +558,36 @@ private:
     //
     // It might be possible to do better by picking two hosts off of the schedule, and selecting the
     // one with fewer active requests at the time of selection.
+    //
+    // With peak EWMA, the weight is divided by the cost of the host instead.
+    if (peak_ewma_) {
+      return host.weight() / cost(host);
+    }
+
     if (active_request_bias_ == 0.0) {
       return host.weight();
     }
 
     if (active_request_bias_ == 1.0) {
-      return static_cast<double>(host.weight()) / (host.stats().rq_active_.value() + 1);
+      return static_cast<double>(host.weight()) / (activeRequests(host) + 1);
     }
 
     return static_cast<double>(host.weight()) /
-           std::pow(host.stats().rq_active_.value() + 1, active_request_bias_);
+           std::pow(activeRequests(host) + 1, active_request_bias_);
+  }
+  uint64_t activeRequests(const Host& host) const {
+    return worker_local_active_requests_ ? host.stats().rq_active_.localValue()
+                                         : host.stats().rq_active_.value();
+  }
+  // The peak EWMA of the response times of the host, in milliseconds, times its active requests
+  // plus one. 1 is added to the average so that hosts whose responses take less than a
+  // millisecond, or whose response times this worker has not recorded yet, are compared by their
+  // active requests.
+  double cost(const Host& host) const {
+    return (host.responseTimeMonitor().peakEwma() + 1) * (activeRequests(host) + 1);
+  }
+  bool hostWeightDependsOnLoad() const override {
+    return peak_ewma_ || active_request_bias_ != 0.0;
   }
   HostConstSharedPtr unweightedHostPeek(const HostVector& hosts_to_use,
                                         const HostsSource& source) override;
@@ -558,6 +602,10 @@ private:
   double active_request_bias_{};
 
   const std::unique_ptr<Runtime::Double> active_request_bias_runtime_;
+  // Whether to compare the active requests of the hosts sent by this worker only.
+  const bool worker_local_active_requests_;
+  // Whether to compare the costs of the hosts rather than their active requests.
+  const bool peak_ewma_;
 };
 
 /**
@@ -620,7 +668,9 @@ public:
         default_subset_(subset_config.default_subset()),
         locality_weight_aware_(subset_config.locality_weight_aware()),
         scale_locality_weight_(subset_config.scale_locality_weight()),
-        panic_mode_any_(subset_config.panic_mode_any()), list_as_any_(subset_config.list_as_any()) {
+        panic_mode_any_(subset_config.panic_mode_any()), list_as_any_(subset_config.list_as_any()),
+        lazy_subsets_(subset_config.lazy_subsets()),
+        lazy_subset_idle_requests_(subset_config.lazy_subset_idle_requests()) {
     for (const auto& subset : subset_config.subset_selectors()) {
       if (!subset.keys().empty()) {
         subset_selectors_.emplace_back(std::make_shared<SubsetSelectorImpl>(
@@ -644,6 +694,8 @@ public:
   bool scaleLocalityWeight() const override { return scale_locality_weight_; }
   bool panicModeAny() const override { return panic_mode_any_; }
   bool listAsAny() const override { return list_as_any_; }
+  bool lazySubsets() const override { return lazy_subsets_; }
+  uint32_t lazySubsetIdleRequests() const override { return lazy_subset_idle_requests_; }
 
 private:
   const bool enabled_;
@@ -655,6 +707,8 @@ private:
   const bool scale_locality_weight_;
   const bool panic_mode_any_;
   const bool list_as_any_;
+  const bool lazy_subsets_;
+  const uint32_t lazy_subset_idle_requests_;
 };
 
 } // namespace Upstream
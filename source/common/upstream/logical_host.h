@@ -89,6 +89,9 @@ public:
   Outlier::DetectorHostMonitor& outlierDetector() const override {
     return logical_host_->outlierDetector();
   }
+  ResponseTimeMonitor& responseTimeMonitor() const override {
+    return logical_host_->responseTimeMonitor();
+  }
   HostStats& stats() const override { return logical_host_->stats(); }
   const std::string& hostnameForHealthChecks() const override {
     return logical_host_->hostnameForHealthChecks();
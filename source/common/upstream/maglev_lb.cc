@@ -17,22 +17,55 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
   // Implementation of pseudocode listing 1 in the paper (see header file for more info).
   std::vector<TableBuildEntry> table_build_entries;
   table_build_entries.reserve(normalized_host_weights.size());
+  hosts_.reserve(normalized_host_weights.size());
   for (const auto& host_weight : normalized_host_weights) {
     const auto& host = host_weight.first;
     const std::string& address =
         use_hostname_for_hashing ? host->hostname() : host->address()->asString();
     ASSERT(!address.empty());
-    table_build_entries.emplace_back(host, HashUtil::xxHash64(address) % table_size_,
+    hosts_.push_back(host);
+    table_build_entries.emplace_back(HashUtil::xxHash64(address) % table_size_,
                                      (HashUtil::xxHash64(address, 1) % (table_size_ - 1)) + 1,
                                      host_weight.second);
   }
 
-  table_.resize(table_size_);
+  if (hosts_.size() < std::numeric_limits<uint16_t>::max()) {
+    buildTable(small_table_, table_build_entries, max_normalized_weight);
+  } else {
+    buildTable(table_, table_build_entries, max_normalized_weight);
+  }
+
+  uint64_t min_entries_per_host = table_size_;
+  uint64_t max_entries_per_host = 0;
+  for (const auto& entry : table_build_entries) {
+    min_entries_per_host = std::min(entry.count_, min_entries_per_host);
+    max_entries_per_host = std::max(entry.count_, max_entries_per_host);
+  }
+  stats_.min_entries_per_host_.set(min_entries_per_host);
+  stats_.max_entries_per_host_.set(max_entries_per_host);
+
+  if (ENVOY_LOG_CHECK_LEVEL(trace)) {
+    for (uint64_t i = 0; i < table_size_; i++) {
+      const HostConstSharedPtr& host =
+          hosts_[small_table_.empty() ? table_[i] : small_table_[i]];
+      ENVOY_LOG(trace, "maglev: i={} host={}", i,
+                use_hostname_for_hashing ? host->hostname() : host->address()->asString());
+    }
+  }
+}
+
+template <class IndexType>
+void MaglevTable::buildTable(std::vector<IndexType>& table,
+                             std::vector<TableBuildEntry>& table_build_entries,
+                             double max_normalized_weight) {
+  const IndexType empty = std::numeric_limits<IndexType>::max();
+  ASSERT(table_build_entries.size() < empty);
+  table.assign(table_size_, empty);
 
   // Iterate through the table build entries as many times as it takes to fill up the table.
   uint64_t table_index = 0;
   for (uint32_t iteration = 1; table_index < table_size_; ++iteration) {
-    for (uint64_t i = 0; i < table_build_entries.size() && table_index < table_size; i++) {
+    for (uint64_t i = 0; i < table_build_entries.size() && table_index < table_size_; i++) {
       TableBuildEntry& entry = table_build_entries[i];
       // To understand how target_weight_ and weight_ are used below, consider a host with weight
       // equal to max_normalized_weight. This would be picked on every single iteration. If it had
@@ -42,39 +75,20 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
         continue;
       }
       entry.target_weight_ += max_normalized_weight;
-      uint64_t c = permutation(entry);
-      while (table_[c] != nullptr) {
-        entry.next_++;
-        c = permutation(entry);
+      while (table[entry.permutation_] != empty) {
+        nextPermutation(entry);
       }
 
-      table_[c] = entry.host_;
-      entry.next_++;
+      table[entry.permutation_] = static_cast<IndexType>(i);
+      nextPermutation(entry);
       entry.count_++;
       table_index++;
     }
   }
-
-  uint64_t min_entries_per_host = table_size_;
-  uint64_t max_entries_per_host = 0;
-  for (const auto& entry : table_build_entries) {
-    min_entries_per_host = std::min(entry.count_, min_entries_per_host);
-    max_entries_per_host = std::max(entry.count_, max_entries_per_host);
-  }
-  stats_.min_entries_per_host_.set(min_entries_per_host);
-  stats_.max_entries_per_host_.set(max_entries_per_host);
-
-  if (ENVOY_LOG_CHECK_LEVEL(trace)) {
-    for (uint64_t i = 0; i < table_.size(); i++) {
-      ENVOY_LOG(trace, "maglev: i={} host={}", i,
-                use_hostname_for_hashing ? table_[i]->hostname()
-                                         : table_[i]->address()->asString());
-    }
-  }
 }
 
 HostConstSharedPtr MaglevTable::chooseHost(uint64_t hash, uint32_t attempt) const {
-  if (table_.empty()) {
+  if (hosts_.empty()) {
     return nullptr;
   }
 
@@ -85,11 +99,17 @@ HostConstSharedPtr MaglevTable::chooseHost(uint64_t hash, uint32_t attempt) cons
     hash ^= ~0ULL - attempt + 1;
   }
 
-  return table_[hash % table_size_];
+  const uint64_t index = hash % table_size_;
+  return hosts_[small_table_.empty() ? table_[index] : small_table_[index]];
 }
 
-uint64_t MaglevTable::permutation(const TableBuildEntry& entry) {
-  return (entry.offset_ + (entry.skip_ * entry.next_)) % table_size_;
+void MaglevTable::nextPermutation(TableBuildEntry& entry) const {
+  // Both the current entry and the skip are less than the table size, so a subtraction replaces
+  // the modulo.
+  entry.permutation_ += entry.skip_;
+  if (entry.permutation_ >= table_size_) {
+    entry.permutation_ -= table_size_;
+  }
 }
 
 MaglevLoadBalancer::MaglevLoadBalancer(
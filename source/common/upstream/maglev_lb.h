@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstdint>
+#include <limits>
+#include <vector>
+
 #include "envoy/common/random_generator.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/stats/scope.h"
@@ -29,7 +33,12 @@ struct MaglevLoadBalancerStats {
  * This is an implementation of Maglev consistent hashing as described in:
  * https://static.googleusercontent.com/media/research.google.com/en//pubs/archive/44824.pdf
  * section 3.4. Specifically, the algorithm shown in pseudocode listing 1 is implemented with a
- * fixed table size of 65537. This is the recommended table size in section 5.3.
+ * default table size of 65537. This is the recommended table size in section 5.3.
+ *
+ * The table entries are indexes into the vector of the hosts of the table rather than host
+ * pointers, so that the build does not update the reference count of a host for each entry, and
+ * so that a table takes 2 bytes per entry for up to 65535 hosts, or 4 bytes per entry otherwise.
+ * This keeps large tables, which balance many hosts better, affordable.
  */
 class MaglevTable : public ThreadAwareLoadBalancerBase::HashingLoadBalancer,
                     Logger::Loggable<Logger::Id::upstream> {
@@ -46,22 +55,31 @@ public:
 
 private:
   struct TableBuildEntry {
-    TableBuildEntry(const HostConstSharedPtr& host, uint64_t offset, uint64_t skip, double weight)
-        : host_(host), offset_(offset), skip_(skip), weight_(weight) {}
+    TableBuildEntry(uint64_t offset, uint64_t skip, double weight)
+        : skip_(skip), weight_(weight), permutation_(offset) {}
 
-    HostConstSharedPtr host_;
-    const uint64_t offset_;
     const uint64_t skip_;
     const double weight_;
     double target_weight_{};
-    uint64_t next_{};
+    // The current entry of the permutation of the host, i.e. (offset + skip * next) % table_size
+    // where next is the number of entries of the permutation that the build has gone through.
+    uint64_t permutation_;
     uint64_t count_{};
   };
 
-  uint64_t permutation(const TableBuildEntry& entry);
+  // Fills the table with the indexes of the hosts of the table build entries.
+  template <class IndexType>
+  void buildTable(std::vector<IndexType>& table, std::vector<TableBuildEntry>& table_build_entries,
+                  double max_normalized_weight);
+  void nextPermutation(TableBuildEntry& entry) const;
 
+  // The hosts of the table, in the order of the normalized host weights.
+  std::vector<HostConstSharedPtr> hosts_;
   const uint64_t table_size_;
-  std::vector<HostConstSharedPtr> table_;
+  // The table is small_table_ if there are fewer than 65535 hosts, and table_ otherwise. The
+  // largest index marks the empty entries during the build.
+  std::vector<uint16_t> small_table_;
+  std::vector<uint32_t> table_;
   MaglevLoadBalancerStats& stats_;
 };
 
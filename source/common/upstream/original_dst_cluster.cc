@@ -17,9 +17,61 @@
 #include "common/protobuf/protobuf.h"
 #include "common/protobuf/utility.h"
 
+#include "absl/hash/hash.h"
+
 namespace Envoy {
 namespace Upstream {
 
+ShardedHostMap::ShardedHostMap() {
+  const auto empty_shard = std::make_shared<HostMap>();
+  shards_.fill(empty_shard);
+}
+
+HostSharedPtr ShardedHostMap::find(const std::string& address) const {
+  const HostMap& shard = *shards_[shardIndex(address)];
+  auto it = shard.find(address);
+  return it != shard.end() ? it->second : nullptr;
+}
+
+bool ShardedHostMap::add(const HostSharedPtr& host) {
+  const std::string address = host->address()->asString();
+  if (find(address) != nullptr) {
+    return false;
+  }
+  mutableShard(address).emplace(address, host);
+  ++size_;
+  return true;
+}
+
+void ShardedHostMap::remove(const std::string& address) {
+  if (find(address) != nullptr) {
+    mutableShard(address).erase(address);
+    --size_;
+  }
+}
+
+void ShardedHostMap::iterate(
+    const std::function<void(const std::string&, const HostSharedPtr&)>& cb) const {
+  for (const auto& shard : shards_) {
+    for (const auto& [address, host] : *shard) {
+      cb(address, host);
+    }
+  }
+}
+
+HostMap& ShardedHostMap::mutableShard(const std::string& address) {
+  const uint32_t index = shardIndex(address);
+  if (!owned_shards_[index]) {
+    shards_[index] = std::make_shared<HostMap>(*shards_[index]);
+    owned_shards_[index] = true;
+  }
+  return *shards_[index];
+}
+
+uint32_t ShardedHostMap::shardIndex(const std::string& address) {
+  return absl::Hash<std::string>()(address) % NumShards;
+}
+
 HostConstSharedPtr OriginalDstCluster::LoadBalancer::chooseHost(LoadBalancerContext* context) {
   if (context) {
     // Check if override host header is present, if yes use it otherwise check local address.
@@ -39,9 +91,8 @@ HostConstSharedPtr OriginalDstCluster::LoadBalancer::chooseHost(LoadBalancerCont
     if (dst_host) {
       const Network::Address::Instance& dst_addr = *dst_host.get();
       // Check if a host with the destination address is already in the host set.
-      auto it = host_map_->find(dst_addr.asString());
-      if (it != host_map_->end()) {
-        HostSharedPtr host(it->second); // takes a reference
+      HostSharedPtr host = findHost(dst_addr.asString());
+      if (host != nullptr) {
         ENVOY_LOG(debug, "Using existing host {}.", host->address()->asString());
         host->used(true); // Mark as used.
         return host;
@@ -53,22 +104,26 @@ HostConstSharedPtr OriginalDstCluster::LoadBalancer::chooseHost(LoadBalancerCont
             Network::Utility::copyInternetAddressAndPort(*dst_ip));
         // Create a host we can use immediately.
         auto info = parent_->info();
-        HostSharedPtr host(std::make_shared<HostImpl>(
+        host = std::make_shared<HostImpl>(
             info, info->name() + dst_addr.asString(), std::move(host_ip_port), nullptr, 1,
             envoy::config::core::v3::Locality().default_instance(),
             envoy::config::endpoint::v3::Endpoint::HealthCheckConfig().default_instance(), 0,
-            envoy::config::core::v3::UNKNOWN, parent_->time_source_));
+            envoy::config::core::v3::UNKNOWN, parent_->time_source_);
         ENVOY_LOG(debug, "Created host {}.", host->address()->asString());
+        created_hosts_.emplace(dst_addr.asString(), host);
 
-        // Tell the cluster about the new host
-        // lambda cannot capture a member by value.
-        std::weak_ptr<OriginalDstCluster> post_parent = parent_;
-        parent_->dispatcher_.post([post_parent, host]() mutable {
-          // The main cluster may have disappeared while this post was queued.
-          if (std::shared_ptr<OriginalDstCluster> parent = post_parent.lock()) {
-            parent->addHost(host);
-          }
-        });
+        // Tell the cluster about the new host. The hosts queued before the main thread gets to
+        // them are added together.
+        if (parent_->queueHost(host)) {
+          // lambda cannot capture a member by value.
+          std::weak_ptr<OriginalDstCluster> post_parent = parent_;
+          parent_->dispatcher_.post([post_parent]() {
+            // The main cluster may have disappeared while this post was queued.
+            if (std::shared_ptr<OriginalDstCluster> parent = post_parent.lock()) {
+              parent->addPendingHosts();
+            }
+          });
+        }
         return host;
       } else {
         ENVOY_LOG(debug, "Failed to create host for {}.", dst_addr.asString());
@@ -80,6 +135,25 @@ HostConstSharedPtr OriginalDstCluster::LoadBalancer::chooseHost(LoadBalancerCont
   return nullptr;
 }
 
+HostSharedPtr OriginalDstCluster::LoadBalancer::findHost(const std::string& address) {
+  HostSharedPtr host = host_map_->find(address);
+  if (host != nullptr) {
+    return host;
+  }
+  auto it = created_hosts_.find(address);
+  if (it != created_hosts_.end()) {
+    return it->second;
+  }
+  // The cluster may have added the host since this load balancer was created, e.g. for another
+  // worker. A host is looked up in the current map once per worker, before it is created.
+  HostMapConstSharedPtr current_host_map = parent_->getCurrentHostMap();
+  if (current_host_map != host_map_) {
+    host_map_ = std::move(current_host_map);
+    return host_map_->find(address);
+  }
+  return nullptr;
+}
+
 Network::Address::InstanceConstSharedPtr
 OriginalDstCluster::LoadBalancer::requestOverrideHost(LoadBalancerContext* context) {
   Network::Address::InstanceConstSharedPtr request_host;
@@ -116,7 +190,7 @@ OriginalDstCluster::OriginalDstCluster(
       use_http_header_(info_->lbOriginalDstConfig()
                            ? info_->lbOriginalDstConfig().value().use_http_header()
                            : false),
-      host_map_(std::make_shared<HostMap>()) {
+      host_map_(std::make_shared<ShardedHostMap>()) {
   // TODO(dio): Remove hosts check once the hosts field is removed.
   if (config.has_load_assignment() || !config.hidden_envoy_deprecated_hosts().empty()) {
     throw EnvoyException("ORIGINAL_DST clusters must have no load assignment or hosts configured");
@@ -124,22 +198,39 @@ OriginalDstCluster::OriginalDstCluster(
   cleanup_timer_->enableTimer(cleanup_interval_ms_);
 }
 
-void OriginalDstCluster::addHost(HostSharedPtr& host) {
-  HostMapSharedPtr new_host_map = std::make_shared<HostMap>(*getCurrentHostMap());
-  auto pair = new_host_map->emplace(host->address()->asString(), host);
-  bool added = pair.second;
-  if (added) {
-    ENVOY_LOG(debug, "addHost() adding {}", host->address()->asString());
-    setHostMap(new_host_map);
-    // Given the current config, only EDS clusters support multiple priorities.
-    ASSERT(priority_set_.hostSetsPerPriority().size() == 1);
-    const auto& first_host_set = priority_set_.getOrCreateHostSet(0);
-    HostVectorSharedPtr all_hosts(new HostVector(first_host_set.hosts()));
-    all_hosts->emplace_back(host);
-    priority_set_.updateHosts(0,
-                              HostSetImpl::partitionHosts(all_hosts, HostsPerLocalityImpl::empty()),
-                              {}, {std::move(host)}, {}, absl::nullopt);
+bool OriginalDstCluster::queueHost(HostSharedPtr host) {
+  absl::MutexLock lock(&pending_hosts_lock_);
+  pending_hosts_.emplace_back(std::move(host));
+  return pending_hosts_.size() == 1;
+}
+
+void OriginalDstCluster::addPendingHosts() {
+  HostVector pending_hosts;
+  {
+    absl::MutexLock lock(&pending_hosts_lock_);
+    pending_hosts.swap(pending_hosts_);
+  }
+  HostMapSharedPtr new_host_map = std::make_shared<ShardedHostMap>(*getCurrentHostMap());
+  HostVector hosts_added;
+  for (HostSharedPtr& host : pending_hosts) {
+    if (new_host_map->add(host)) {
+      ENVOY_LOG(debug, "addHost() adding {}", host->address()->asString());
+      hosts_added.emplace_back(std::move(host));
+    }
+  }
+  if (hosts_added.empty()) {
+    return;
   }
+
+  setHostMap(new_host_map);
+  // Given the current config, only EDS clusters support multiple priorities.
+  ASSERT(priority_set_.hostSetsPerPriority().size() == 1);
+  const auto& first_host_set = priority_set_.getOrCreateHostSet(0);
+  HostVectorSharedPtr all_hosts(new HostVector(first_host_set.hosts()));
+  all_hosts->insert(all_hosts->end(), hosts_added.begin(), hosts_added.end());
+  priority_set_.updateHosts(0,
+                            HostSetImpl::partitionHosts(all_hosts, HostsPerLocalityImpl::empty()),
+                            {}, hosts_added, {}, absl::nullopt);
 }
 
 void OriginalDstCluster::cleanup() {
@@ -149,9 +240,7 @@ void OriginalDstCluster::cleanup() {
   auto host_map = getCurrentHostMap();
   if (!host_map->empty()) {
     ENVOY_LOG(trace, "Cleaning up stale original dst hosts.");
-    for (const auto& pair : *host_map) {
-      const std::string& addr = pair.first;
-      const HostSharedPtr& host = pair.second;
+    host_map->iterate([&](const std::string& addr, const HostSharedPtr& host) {
       if (host->used()) {
         ENVOY_LOG(trace, "Keeping active host {}.", addr);
         keeping_hosts->emplace_back(host);
@@ -160,13 +249,13 @@ void OriginalDstCluster::cleanup() {
         ENVOY_LOG(trace, "Removing stale host {}.", addr);
         to_be_removed.emplace_back(host);
       }
-    }
+    });
   }
 
   if (!to_be_removed.empty()) {
-    HostMapSharedPtr new_host_map = std::make_shared<HostMap>(*host_map);
+    HostMapSharedPtr new_host_map = std::make_shared<ShardedHostMap>(*host_map);
     for (const HostSharedPtr& host : to_be_removed) {
-      new_host_map->erase(host->address()->asString());
+      new_host_map->remove(host->address()->asString());
     }
     setHostMap(new_host_map);
     priority_set_.updateHosts(
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <array>
+#include <bitset>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
 
 #include "envoy/config/cluster/v3/cluster.pb.h"
@@ -17,11 +20,61 @@
 
 #include "extensions/clusters/well_known_names.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
-using HostMapSharedPtr = std::shared_ptr<HostMap>;
-using HostMapConstSharedPtr = std::shared_ptr<const HostMap>;
+/**
+ * The hosts of an OriginalDstCluster by address. The hosts are split into shards by the hash of
+ * their address, and a copy shares its shards with the original until it changes them, so that
+ * adding or removing hosts copies the shards of the changed hosts rather than all the hosts.
+ */
+class ShardedHostMap {
+public:
+  static constexpr uint32_t NumShards = 64;
+
+  ShardedHostMap();
+  ShardedHostMap(const ShardedHostMap& other) : shards_(other.shards_), size_(other.size_) {}
+  ShardedHostMap& operator=(const ShardedHostMap&) = delete;
+
+  /**
+   * @return the host with the address, or nullptr if there is none.
+   */
+  HostSharedPtr find(const std::string& address) const;
+
+  /**
+   * Adds a host unless there is a host with the same address.
+   * @return whether the host was added.
+   */
+  bool add(const HostSharedPtr& host);
+
+  /**
+   * Removes the host with the address, if any.
+   */
+  void remove(const std::string& address);
+
+  /**
+   * Calls a function for each host, with the address of the host.
+   */
+  void iterate(const std::function<void(const std::string&, const HostSharedPtr&)>& cb) const;
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+private:
+  // @return the shard of the address, copied first if it is shared with another map.
+  HostMap& mutableShard(const std::string& address);
+  static uint32_t shardIndex(const std::string& address);
+
+  std::array<std::shared_ptr<HostMap>, NumShards> shards_;
+  // The shards that this map has copied, and that no other map shares.
+  std::bitset<NumShards> owned_shards_;
+  size_t size_{};
+};
+
+using HostMapSharedPtr = std::shared_ptr<ShardedHostMap>;
+using HostMapConstSharedPtr = std::shared_ptr<const ShardedHostMap>;
 
 /**
  * The OriginalDstCluster is a dynamic cluster that automatically adds hosts as needed based on the
@@ -45,9 +98,13 @@ public:
    * Original Dst cluster has a Host for the original destination. Normally load balancers can't
    * modify clusters, but in this case we access a singleton OriginalDstCluster that we can ask to
    * add hosts on demand. Additions are synced with all other threads so that the host set in the
-   * cluster remains (eventually) consistent. If multiple threads add a host to the same upstream
-   * address then two distinct HostSharedPtr's (with the same upstream IP address) will be added,
-   * and both of them will eventually time out.
+   * cluster remains (eventually) consistent. If multiple threads create a host for the same
+   * upstream address, the cluster keeps the first one, and the others are only used by the
+   * requests they were created for.
+   *
+   * The hosts that a worker creates are cached by its load balancer until the cluster adds them,
+   * so that the requests of the worker to a new destination share a host. The cluster adds the
+   * hosts that the workers create in batches, with one membership update per batch.
    */
   class LoadBalancer : public Upstream::LoadBalancer {
   public:
@@ -62,8 +119,12 @@ public:
   private:
     Network::Address::InstanceConstSharedPtr requestOverrideHost(LoadBalancerContext* context);
 
+    HostSharedPtr findHost(const std::string& address);
+
     const std::shared_ptr<OriginalDstCluster> parent_;
     HostMapConstSharedPtr host_map_;
+    // The hosts this worker created that were not in host_map_ yet.
+    absl::flat_hash_map<std::string, HostSharedPtr> created_hosts_;
   };
 
 private:
@@ -99,7 +160,12 @@ private:
     host_map_ = new_host_map;
   }
 
-  void addHost(HostSharedPtr&);
+  /**
+   * Queues a host that a worker created, to be added by addPendingHosts() on the main thread.
+   * @return whether the caller must post addPendingHosts(), i.e. whether the queue was empty.
+   */
+  bool queueHost(HostSharedPtr host);
+  void addPendingHosts();
   void cleanup();
 
   // ClusterImplBase
@@ -113,6 +179,9 @@ private:
   absl::Mutex host_map_lock_;
   HostMapConstSharedPtr host_map_ ABSL_GUARDED_BY(host_map_lock_);
 
+  absl::Mutex pending_hosts_lock_;
+  HostVector pending_hosts_ ABSL_GUARDED_BY(pending_hosts_lock_);
+
   friend class OriginalDstClusterFactory;
 };
 
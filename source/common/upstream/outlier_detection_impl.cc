@@ -79,7 +79,7 @@ void DetectorHostMonitorImpl::putHttpResponseCode(uint64_t response_code) {
         detector->onConsecutiveGatewayFailure(host_.lock());
       }
     } else {
-      consecutive_gateway_failure_ = 0;
+      resetConsecutiveGatewayFailure();
     }
 
     if (++consecutive_5xx_ == detector->runtime().snapshot().getInteger(
@@ -88,8 +88,8 @@ void DetectorHostMonitorImpl::putHttpResponseCode(uint64_t response_code) {
     }
   } else {
     external_origin_sr_monitor_.incSuccessReqCounter();
-    consecutive_5xx_ = 0;
-    consecutive_gateway_failure_ = 0;
+    resetConsecutive5xx();
+    resetConsecutiveGatewayFailure();
   }
 }
 
@@ -194,12 +194,8 @@ void DetectorHostMonitorImpl::localOriginFailure() {
 }
 
 void DetectorHostMonitorImpl::localOriginNoFailure() {
-  std::shared_ptr<DetectorImpl> detector = detector_.lock();
-  if (!detector) {
-    // It's possible for the cluster/detector to go away while we still have a host in use.
-    return;
-  }
-
+  // The detector is not locked, as a success only updates the counters of the host, and locking
+  // it would write to the reference count that the workers share for every request.
   local_origin_sr_monitor_.incTotalReqCounter();
   local_origin_sr_monitor_.incSuccessReqCounter();
 
@@ -796,25 +792,23 @@ void EventLoggerImpl::setCommonEventParams(
   TimestampUtil::systemClockToTimestamp(time_source_.systemTime(), *event.mutable_timestamp());
 }
 
-SuccessRateAccumulatorBucket* SuccessRateAccumulator::updateCurrentWriter() {
-  // Right now current is being written to and backup is not. Flush the backup and swap.
-  backup_success_rate_bucket_->success_request_counter_ = 0;
-  backup_success_rate_bucket_->total_request_counter_ = 0;
-
-  current_success_rate_bucket_.swap(backup_success_rate_bucket_);
-
-  return current_success_rate_bucket_.get();
+void SuccessRateAccumulator::updateCurrentWriter() {
+  success_request_counter_ = 0;
+  total_request_counter_ = 0;
+  for (Shard& shard : shards_) {
+    success_request_counter_ += shard.success_request_counter_.exchange(0);
+    total_request_counter_ += shard.total_request_counter_.exchange(0);
+  }
 }
 
 absl::optional<std::pair<double, uint64_t>> SuccessRateAccumulator::getSuccessRateAndVolume() {
-  if (!backup_success_rate_bucket_->total_request_counter_) {
+  if (!total_request_counter_) {
     return absl::nullopt;
   }
 
-  double success_rate = backup_success_rate_bucket_->success_request_counter_ * 100.0 /
-                        backup_success_rate_bucket_->total_request_counter_;
+  double success_rate = success_request_counter_ * 100.0 / total_request_counter_;
 
-  return {{success_rate, backup_success_rate_bucket_->total_request_counter_}};
+  return {{success_rate, total_request_counter_}};
 }
 
 } // namespace Outlier
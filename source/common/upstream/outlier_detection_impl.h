@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
@@ -66,27 +67,29 @@ struct HostSuccessRatePair {
   double success_rate_;
 };
 
-struct SuccessRateAccumulatorBucket {
-  std::atomic<uint64_t> success_request_counter_;
-  std::atomic<uint64_t> total_request_counter_;
-};
-
 /**
- * The SuccessRateAccumulator uses the SuccessRateAccumulatorBucket to get per host success rate
- * stats. This implementation has a fixed window size of time, and thus only needs a
- * bucket to write to, and a bucket to accumulate/run stats over.
+ * The SuccessRateAccumulator counts the requests to a host to get its success rate over a fixed
+ * window of time. Workers count the requests of the current window in per thread shards on
+ * separate cache lines, so that the requests that all the workers route to the host do not contend
+ * on a single cache line. The shards are summed into the window that the success rate is computed
+ * over when the window is rotated on the main thread.
  */
 class SuccessRateAccumulator {
 public:
-  SuccessRateAccumulator()
-      : current_success_rate_bucket_(new SuccessRateAccumulatorBucket()),
-        backup_success_rate_bucket_(new SuccessRateAccumulatorBucket()) {}
+  static constexpr uint32_t NumShards = 8;
+
+  void incTotalReqCounter() {
+    shards_[threadShard()].total_request_counter_.fetch_add(1, std::memory_order_relaxed);
+  }
+  void incSuccessReqCounter() {
+    shards_[threadShard()].success_request_counter_.fetch_add(1, std::memory_order_relaxed);
+  }
 
   /**
-   * This function updates the bucket to write data to.
-   * @return a pointer to the SuccessRateAccumulatorBucket.
+   * This function ends the current window: the requests counted since it was last called become
+   * the window that getSuccessRateAndVolume() computes the success rate over.
    */
-  SuccessRateAccumulatorBucket* updateCurrentWriter();
+  void updateCurrentWriter();
   /**
    * This function returns the success rate of a host over a window of time if the request volume is
    * high enough. The underlying window of time could be dynamically adjusted. In the current
@@ -99,27 +102,33 @@ public:
   absl::optional<std::pair<double, uint64_t>> getSuccessRateAndVolume();
 
 private:
-  std::unique_ptr<SuccessRateAccumulatorBucket> current_success_rate_bucket_;
-  std::unique_ptr<SuccessRateAccumulatorBucket> backup_success_rate_bucket_;
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> success_request_counter_{0};
+    std::atomic<uint64_t> total_request_counter_{0};
+  };
+
+  static uint32_t threadShard() {
+    static std::atomic<uint32_t> next_shard{0};
+    static thread_local const uint32_t shard = next_shard++ % NumShards;
+    return shard;
+  }
+
+  std::array<Shard, NumShards> shards_;
+  // The counts of the last complete window.
+  uint64_t success_request_counter_{};
+  uint64_t total_request_counter_{};
 };
 
 class SuccessRateMonitor {
 public:
   SuccessRateMonitor(envoy::data::cluster::v2alpha::OutlierEjectionType ejection_type)
-      : ejection_type_(ejection_type), success_rate_(-1) {
-    // Point the success_rate_accumulator_bucket_ pointer to a bucket.
-    updateCurrentSuccessRateBucket();
-  }
+      : ejection_type_(ejection_type), success_rate_(-1) {}
   double getSuccessRate() const { return success_rate_; }
   SuccessRateAccumulator& successRateAccumulator() { return success_rate_accumulator_; }
   void setSuccessRate(double new_success_rate) { success_rate_ = new_success_rate; }
-  void updateCurrentSuccessRateBucket() {
-    success_rate_accumulator_bucket_.store(success_rate_accumulator_.updateCurrentWriter());
-  }
-  void incTotalReqCounter() { success_rate_accumulator_bucket_.load()->total_request_counter_++; }
-  void incSuccessReqCounter() {
-    success_rate_accumulator_bucket_.load()->success_request_counter_++;
-  }
+  void updateCurrentSuccessRateBucket() { success_rate_accumulator_.updateCurrentWriter(); }
+  void incTotalReqCounter() { success_rate_accumulator_.incTotalReqCounter(); }
+  void incSuccessReqCounter() { success_rate_accumulator_.incSuccessReqCounter(); }
 
   envoy::data::cluster::v2alpha::OutlierEjectionType getEjectionType() const {
     return ejection_type_;
@@ -127,7 +136,6 @@ public:
 
 private:
   SuccessRateAccumulator success_rate_accumulator_;
-  std::atomic<SuccessRateAccumulatorBucket*> success_rate_accumulator_bucket_;
   envoy::data::cluster::v2alpha::OutlierEjectionType ejection_type_;
   double success_rate_;
 };
@@ -146,9 +154,9 @@ public:
 
   uint32_t& ejectTimeBackoff() { return eject_time_backoff_; }
 
-  void resetConsecutive5xx() { consecutive_5xx_ = 0; }
-  void resetConsecutiveGatewayFailure() { consecutive_gateway_failure_ = 0; }
-  void resetConsecutiveLocalOriginFailure() { consecutive_local_origin_failure_ = 0; }
+  void resetConsecutive5xx() { resetConsecutive(consecutive_5xx_); }
+  void resetConsecutiveGatewayFailure() { resetConsecutive(consecutive_gateway_failure_); }
+  void resetConsecutiveLocalOriginFailure() { resetConsecutive(consecutive_local_origin_failure_); }
   static absl::optional<Http::Code> resultToHttpCode(Result result);
 
   // Upstream::Outlier::DetectorHostMonitor
@@ -210,6 +218,13 @@ private:
   SuccessRateMonitor external_origin_sr_monitor_;
   SuccessRateMonitor local_origin_sr_monitor_;
 
+  // Resets a consecutive failure counter. The counter is only written if it is not zero, so that
+  // the successes that all the workers report do not write to the cache line of the counters.
+  static void resetConsecutive(std::atomic<uint32_t>& counter) {
+    if (counter.load(std::memory_order_relaxed) != 0) {
+      counter.store(0, std::memory_order_relaxed);
+    }
+  }
   void putResultNoLocalExternalSplit(Result result, absl::optional<uint64_t> code);
   void putResultWithLocalExternalSplit(Result result, absl::optional<uint64_t> code);
   std::function<void(DetectorHostMonitorImpl*, Result, absl::optional<uint64_t> code)>
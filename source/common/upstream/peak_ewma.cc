@@ -0,0 +1,54 @@
+#include "common/upstream/peak_ewma.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Envoy {
+namespace Upstream {
+
+PeakEwmaResponseTimeMonitor::PeakEwmaResponseTimeMonitor(TimeSource& time_source,
+                                                         std::chrono::milliseconds decay_time)
+    : time_source_(time_source),
+      decay_time_ns_(std::chrono::duration_cast<std::chrono::nanoseconds>(decay_time).count()) {}
+
+void PeakEwmaResponseTimeMonitor::putResponseTime(std::chrono::milliseconds response_time) {
+  Shard& shard = shards_[threadShard()];
+  const int64_t now_ns = nowNs();
+  const double sample = response_time.count();
+  const double ewma = shard.ewma_.load(std::memory_order_relaxed);
+  if (sample > ewma) {
+    shard.ewma_.store(sample, std::memory_order_relaxed);
+  } else {
+    const double weight = decay(shard.update_time_ns_.load(std::memory_order_relaxed), now_ns);
+    shard.ewma_.store(ewma * weight + sample * (1 - weight), std::memory_order_relaxed);
+  }
+  shard.update_time_ns_.store(now_ns, std::memory_order_relaxed);
+}
+
+double PeakEwmaResponseTimeMonitor::peakEwma() const {
+  const Shard& shard = shards_[threadShard()];
+  const double ewma = shard.ewma_.load(std::memory_order_relaxed);
+  if (ewma == 0) {
+    return 0;
+  }
+  return ewma * decay(shard.update_time_ns_.load(std::memory_order_relaxed), nowNs());
+}
+
+uint32_t PeakEwmaResponseTimeMonitor::threadShard() {
+  static std::atomic<uint32_t> next_shard{0};
+  static thread_local const uint32_t shard = next_shard++ % NumShards;
+  return shard;
+}
+
+int64_t PeakEwmaResponseTimeMonitor::nowNs() const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             time_source_.monotonicTime().time_since_epoch())
+      .count();
+}
+
+double PeakEwmaResponseTimeMonitor::decay(int64_t update_time_ns, int64_t now_ns) const {
+  return std::exp(-std::max<int64_t>(now_ns - update_time_ns, 0) / decay_time_ns_);
+}
+
+} // namespace Upstream
+} // namespace Envoy
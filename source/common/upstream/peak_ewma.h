@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/common/time.h"
+#include "envoy/upstream/response_time_monitor.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * Peak EWMA of the response times of a host, as used by Finagle's P2C-EWMA load balancer. A
+ * response time above the average replaces it, so that a host that slows down is avoided at once,
+ * while the average of a host that speeds up decays towards its response times. The weight of the
+ * average decays exponentially with the time since it was last updated, with a time constant of
+ * decay_time, so the average of a host that is not sent requests decays towards 0 and the host is
+ * tried again.
+ *
+ * Each thread updates and reads its own average, on its own cache line, so that the workers do not
+ * contend on the hosts they send requests to. Threads are assigned one of NumShards averages round
+ * robin, so with more than NumShards workers, workers share an average, and may lose each other's
+ * updates of it.
+ */
+class PeakEwmaResponseTimeMonitor : public ResponseTimeMonitor {
+public:
+  static constexpr uint32_t NumShards = 8;
+
+  PeakEwmaResponseTimeMonitor(TimeSource& time_source, std::chrono::milliseconds decay_time);
+
+  // Upstream::ResponseTimeMonitor
+  void putResponseTime(std::chrono::milliseconds response_time) override;
+  double peakEwma() const override;
+
+private:
+  struct alignas(64) Shard {
+    // The average in milliseconds, and the monotonic time of its last update in nanoseconds.
+    std::atomic<double> ewma_{0};
+    std::atomic<int64_t> update_time_ns_{0};
+  };
+
+  static uint32_t threadShard();
+  int64_t nowNs() const;
+  // @return the weight of an average that was last updated at update_time_ns.
+  double decay(int64_t update_time_ns, int64_t now_ns) const;
+
+  TimeSource& time_source_;
+  const double decay_time_ns_;
+  std::array<Shard, NumShards> shards_;
+};
+
+/**
+ * Null implementation of ResponseTimeMonitor.
+ */
+class ResponseTimeMonitorNullImpl : public ResponseTimeMonitor {
+public:
+  // Upstream::ResponseTimeMonitor
+  void putResponseTime(std::chrono::milliseconds) override {}
+  double peakEwma() const override { return 0; }
+};
+
+} // namespace Upstream
+} // namespace Envoy
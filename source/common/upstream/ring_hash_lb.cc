@@ -50,52 +50,34 @@ RingHashLoadBalancerStats RingHashLoadBalancer::generateStats(Stats::Scope& scop
 }
 
 HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h, uint32_t attempt) const {
-  if (ring_.empty()) {
+  if (hashes_.empty()) {
     return nullptr;
   }
 
-  // Ported from https://github.com/RJ/ketama/blob/master/libketama/ketama.c (ketama_get_server)
-  // I've generally kept the variable names to make the code easier to compare.
-  // NOTE: The algorithm depends on using signed integers for lowp, midp, and highp. Do not
-  //       change them!
-  int64_t lowp = 0;
-  int64_t highp = ring_.size();
-  int64_t midp = 0;
-  while (true) {
-    midp = (lowp + highp) / 2;
-
-    if (midp == static_cast<int64_t>(ring_.size())) {
-      midp = 0;
-      break;
-    }
-
-    uint64_t midval = ring_[midp].hash_;
-    uint64_t midval1 = midp == 0 ? 0 : ring_[midp - 1].hash_;
-
-    if (h <= midval && h > midval1) {
-      break;
-    }
-
-    if (midval < h) {
-      lowp = midp + 1;
-    } else {
-      highp = midp - 1;
-    }
-
-    if (lowp > highp) {
-      midp = 0;
-      break;
-    }
+  // Like ketama (https://github.com/RJ/ketama/blob/master/libketama/ketama.c), choose the first
+  // entry whose hash is greater than or equal to h, wrapping around to the first entry of the ring.
+  // The search halves the range without branching on the comparisons, which are unpredictable, so
+  // that the compiler can use conditional moves.
+  const uint64_t* first = hashes_.data();
+  size_t length = hashes_.size();
+  while (length > 1) {
+    const size_t half = length / 2;
+    first += first[half] < h ? half : 0;
+    length -= half;
+  }
+  size_t index = (first - hashes_.data()) + (*first < h);
+  if (index == hashes_.size()) {
+    index = 0;
   }
 
   // If a retry host predicate is being applied, behave as if this host was not in the ring.
-  // Note that this does not guarantee a different host: e.g., attempt == ring_.size() or
+  // Note that this does not guarantee a different host: e.g., attempt == hashes_.size() or
   // when the offset causes us to select the same host at another location in the ring.
   if (attempt > 0) {
-    midp = (midp + attempt) % ring_.size();
+    index = (index + attempt) % hashes_.size();
   }
 
-  return ring_[midp].host_;
+  return hosts_[host_indexes_[index]];
 }
 
 using HashFunction = envoy::config::cluster::v3::Cluster::RingHashLbConfig::HashFunction;
@@ -122,7 +104,13 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
 
   // Reserve memory for the entire ring up front.
   const uint64_t ring_size = std::ceil(scale);
-  ring_.reserve(ring_size);
+  struct RingEntry {
+    uint64_t hash_;
+    uint32_t host_index_;
+  };
+  std::vector<RingEntry> ring;
+  ring.reserve(ring_size);
+  hosts_.reserve(normalized_host_weights.size());
 
   // Populate the hash ring by walking through the (host, weight) pairs in
   // normalized_host_weights, and generating (scale * weight) hashes for each host. Since these
@@ -152,6 +140,8 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
     const std::string& address_string =
         use_hostname_for_hashing ? host->hostname() : host->address()->asString();
     ASSERT(!address_string.empty());
+    const uint32_t host_index = hosts_.size();
+    hosts_.push_back(host);
 
     hash_key_buffer.assign(address_string.begin(), address_string.end());
     hash_key_buffer.emplace_back('_');
@@ -174,7 +164,7 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
               : HashUtil::xxHash64(hash_key);
 
       ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", hash_key.data(), hash);
-      ring_.push_back({hash, host});
+      ring.push_back({hash, host_index});
       ++i;
       ++current_hashes;
       hash_key_buffer.erase(offset_start, hash_key_buffer.end());
@@ -183,14 +173,20 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
     max_hashes_per_host = std::max(i, max_hashes_per_host);
   }
 
-  std::sort(ring_.begin(), ring_.end(), [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
+  std::sort(ring.begin(), ring.end(), [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
     return lhs.hash_ < rhs.hash_;
   });
+  hashes_.reserve(ring.size());
+  host_indexes_.reserve(ring.size());
+  for (const auto& entry : ring) {
+    hashes_.push_back(entry.hash_);
+    host_indexes_.push_back(entry.host_index_);
+  }
   if (ENVOY_LOG_CHECK_LEVEL(trace)) {
-    for (const auto& entry : ring_) {
+    for (const auto& entry : ring) {
+      const HostConstSharedPtr& host = hosts_[entry.host_index_];
       ENVOY_LOG(trace, "ring hash: host={} hash={}",
-                use_hostname_for_hashing ? entry.host_->hostname()
-                                         : entry.host_->address()->asString(),
+                use_hostname_for_hashing ? host->hostname() : host->address()->asString(),
                 entry.hash_);
     }
   }
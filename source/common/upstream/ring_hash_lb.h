@@ -51,11 +51,6 @@ public:
 private:
   using HashFunction = envoy::config::cluster::v3::Cluster::RingHashLbConfig::HashFunction;
 
-  struct RingEntry {
-    uint64_t hash_;
-    HostConstSharedPtr host_;
-  };
-
   struct Ring : public HashingLoadBalancer {
     Ring(const NormalizedHostWeightVector& normalized_host_weights, double min_normalized_weight,
          uint64_t min_ring_size, uint64_t max_ring_size, HashFunction hash_function,
@@ -64,7 +59,12 @@ private:
     // ThreadAwareLoadBalancerBase::HashingLoadBalancer
     HostConstSharedPtr chooseHost(uint64_t hash, uint32_t attempt) const override;
 
-    std::vector<RingEntry> ring_;
+    // The ring is split into the sorted hashes of the ring entries and the indexes into hosts_ of
+    // the hosts of the entries, so that the search for a hash only touches packed hashes, and the
+    // ring does not keep a host pointer per entry.
+    std::vector<uint64_t> hashes_;
+    std::vector<uint32_t> host_indexes_;
+    std::vector<HostConstSharedPtr> hosts_;
 
     RingHashLoadBalancerStats& stats_;
   };
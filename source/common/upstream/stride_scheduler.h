@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Upstream {
+
+// Stride scheduler (https://en.wikipedia.org/wiki/Stride_scheduling) used for weighted round robin
+// when the weights of the entries are fixed. A period of the schedule, in which each entry is
+// picked as many times as its weight, is computed up front, so that a pick is an O(1) index into
+// the period instead of a pop and push of a priority queue. Within a period the entries are picked
+// in the order of their pass values k / weight, which is the order in which EdfScheduler picks
+// entries whose weights do not change.
+template <class C> class StrideScheduler {
+public:
+  /**
+   * Computes the schedule of entries with integer weights.
+   * @param entries the entries to schedule.
+   * @param weights the weight of each entry. Weights must be positive.
+   * @param max_size the maximum number of picks in a period of the schedule.
+   * @return the scheduler, or nullptr if there is no entry or a period of the schedule would be
+   *         longer than max_size picks.
+   */
+  static std::unique_ptr<StrideScheduler> create(std::vector<std::shared_ptr<C>> entries,
+                                                 const std::vector<uint32_t>& weights,
+                                                 uint64_t max_size) {
+    ASSERT(entries.size() == weights.size());
+    // Weights with a common divisor schedule the same as the weights divided by it.
+    uint32_t divisor = 0;
+    for (const uint32_t weight : weights) {
+      ASSERT(weight > 0);
+      divisor = std::gcd(divisor, weight);
+    }
+    uint64_t size = 0;
+    for (const uint32_t weight : weights) {
+      size += weight / divisor;
+    }
+    if (size == 0 || size > max_size) {
+      return nullptr;
+    }
+
+    struct Pass {
+      uint32_t pass_;
+      uint32_t weight_;
+      uint32_t index_;
+    };
+    std::vector<Pass> passes;
+    passes.reserve(size);
+    for (uint32_t index = 0; index < weights.size(); ++index) {
+      const uint32_t weight = weights[index] / divisor;
+      for (uint32_t pass = 1; pass <= weight; ++pass) {
+        passes.push_back({pass, weight, index});
+      }
+    }
+    // Ties are broken by the order of the entries.
+    std::sort(passes.begin(), passes.end(), [](const Pass& a, const Pass& b) {
+      const uint64_t a_time = static_cast<uint64_t>(a.pass_) * b.weight_;
+      const uint64_t b_time = static_cast<uint64_t>(b.pass_) * a.weight_;
+      return a_time < b_time || (a_time == b_time && a.index_ < b.index_);
+    });
+
+    std::unique_ptr<StrideScheduler> scheduler(new StrideScheduler(std::move(entries)));
+    scheduler->schedule_.reserve(size);
+    for (const Pass& pass : passes) {
+      scheduler->schedule_.push_back(pass.index_);
+    }
+    return scheduler;
+  }
+
+  /**
+   * @return the entry of the next pick.
+   */
+  const std::shared_ptr<C>& pick() {
+    if (peekahead_ > 0) {
+      --peekahead_;
+    }
+    const uint32_t index = schedule_[next_];
+    if (++next_ == schedule_.size()) {
+      next_ = 0;
+    }
+    return entries_[index];
+  }
+
+  /**
+   * Each time peekAgain is called, it returns the entry of the pick after the one it returned
+   * last, starting from the next pick. Picks shrink the window of peeked entries.
+   * @return the entry of a subsequent pick.
+   */
+  const std::shared_ptr<C>& peekAgain() {
+    return entries_[schedule_[(next_ + peekahead_++) % schedule_.size()]];
+  }
+
+  /**
+   * Skips picks, e.g. to start the schedule at a different offset.
+   * @param picks the number of picks to skip.
+   */
+  void advance(uint64_t picks) { next_ = (next_ + picks) % schedule_.size(); }
+
+  /**
+   * @return the number of picks in a period of the schedule.
+   */
+  size_t size() const { return schedule_.size(); }
+
+private:
+  explicit StrideScheduler(std::vector<std::shared_ptr<C>>&& entries)
+      : entries_(std::move(entries)) {}
+
+  const std::vector<std::shared_ptr<C>> entries_;
+  // The indexes of the entries of the picks of a period.
+  std::vector<uint32_t> schedule_;
+  uint32_t next_{};
+  uint64_t peekahead_{};
+};
+
+} // namespace Upstream
+} // namespace Envoy
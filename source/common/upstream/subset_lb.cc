@@ -38,7 +38,9 @@ SubsetLoadBalancer::SubsetLoadBalancer(
       subset_selectors_(subsets.subsetSelectors()), original_priority_set_(priority_set),
       original_local_priority_set_(local_priority_set),
       locality_weight_aware_(subsets.localityWeightAware()),
-      scale_locality_weight_(subsets.scaleLocalityWeight()), list_as_any_(subsets.listAsAny()) {
+      scale_locality_weight_(subsets.scaleLocalityWeight()), list_as_any_(subsets.listAsAny()),
+      lazy_subsets_(subsets.lazySubsets()),
+      lazy_subset_idle_requests_(subsets.lazySubsets() ? subsets.lazySubsetIdleRequests() : 0) {
   ASSERT(subsets.isEnabled());
 
   if (fallback_policy_ != envoy::config::cluster::v3::Cluster::LbSubsetConfig::NO_FALLBACK) {
@@ -274,6 +276,10 @@ void SubsetLoadBalancer::initSelectorFallbackSubset(
 }
 
 HostConstSharedPtr SubsetLoadBalancer::chooseHost(LoadBalancerContext* context) {
+  if (lazy_subset_idle_requests_ > 0 && ++requests_since_eviction_ >= lazy_subset_idle_requests_) {
+    evictIdleSubsets();
+  }
+
   if (context) {
     bool host_chosen;
     HostConstSharedPtr host = tryChooseHostFromContext(context, host_chosen);
@@ -383,6 +389,9 @@ HostConstSharedPtr SubsetLoadBalancer::tryChooseHostFromContext(LoadBalancerCont
 
   // Route has metadata match criteria defined, see if we have a matching subset.
   LbSubsetEntryPtr entry = findSubset(match_criteria->metadataMatchCriteria());
+  if (entry != nullptr && lazy_subsets_) {
+    initLazySubset(*entry);
+  }
   if (entry == nullptr || !entry->active()) {
     // No matching subset or subset not active: use fallback policy.
     return nullptr;
@@ -529,6 +538,10 @@ void SubsetLoadBalancer::update(uint32_t priority, const HostVector& hosts_added
         entry->priority_subset_->update(priority, hosts_added, hosts_removed);
       },
       [&](LbSubsetEntryPtr entry, HostPredicate predicate, const SubsetMetadata& kvs) {
+        if (lazy_subsets_) {
+          // The entry is initialized for the first request routed to it.
+          return;
+        }
         ENVOY_LOG(debug, "subset lb: creating load balancer for {}", describeMetadata(kvs));
 
         // Initialize new entry with hosts and update stats. (An uninitialized entry
@@ -539,6 +552,57 @@ void SubsetLoadBalancer::update(uint32_t priority, const HostVector& hosts_added
         stats_.lb_subsets_active_.inc();
         stats_.lb_subsets_created_.inc();
       });
+
+  if (lazy_subsets_) {
+    countLazySubsetHosts();
+  }
+}
+
+void SubsetLoadBalancer::countLazySubsetHosts() {
+  forEachSubset(subsets_, [](LbSubsetEntryPtr entry) { entry->matching_hosts_ = 0; });
+
+  for (const auto& host_set : original_priority_set_.hostSetsPerPriority()) {
+    for (const auto& host : host_set->hosts()) {
+      for (const auto& subset_selector : subset_selectors_) {
+        for (const auto& kvs : extractSubsetMetadata(subset_selector->selectorKeys(), *host)) {
+          LbSubsetEntryPtr entry = findOrCreateSubset(subsets_, kvs, 0);
+          if (entry->matching_hosts_++ == 0) {
+            entry->metadata_ = kvs;
+          }
+        }
+      }
+    }
+  }
+}
+
+void SubsetLoadBalancer::initLazySubset(LbSubsetEntry& entry) {
+  entry.used_ = true;
+  if (entry.initialized() || entry.matching_hosts_ == 0) {
+    return;
+  }
+
+  ENVOY_LOG(debug, "subset lb: creating load balancer for {}", describeMetadata(entry.metadata_));
+  HostPredicate predicate = [this, kvs = entry.metadata_](const Host& host) -> bool {
+    return hostMatches(kvs, host);
+  };
+  entry.priority_subset_ = std::make_shared<PrioritySubsetImpl>(
+      *this, predicate, locality_weight_aware_, scale_locality_weight_);
+  stats_.lb_subsets_active_.inc();
+  stats_.lb_subsets_created_.inc();
+}
+
+void SubsetLoadBalancer::evictIdleSubsets() {
+  requests_since_eviction_ = 0;
+  forEachSubset(subsets_, [this](LbSubsetEntryPtr entry) {
+    if (entry->initialized() && !entry->used_) {
+      ENVOY_LOG(debug, "subset lb: destroying idle load balancer for {}",
+                describeMetadata(entry->metadata_));
+      entry->priority_subset_.reset();
+      stats_.lb_subsets_active_.dec();
+      stats_.lb_subsets_removed_.inc();
+    }
+    entry->used_ = false;
+  });
 }
 
 bool SubsetLoadBalancer::hostMatches(const SubsetMetadata& kvs, const Host& host) {
@@ -692,7 +756,7 @@ void SubsetLoadBalancer::purgeEmptySubsets(LbSubsetMap& subsets) {
 
       purgeEmptySubsets(entry->children_);
 
-      if (entry->active() || entry->hasChildren()) {
+      if (entry->active() || entry->hasChildren() || entry->matching_hosts_ > 0) {
         it++;
         continue;
       }
@@ -191,6 +191,13 @@ private:
 
     // Only initialized if a match exists at this level.
     PrioritySubsetImplPtr priority_subset_;
+
+    // Only used with lazy subsets. The metadata of the subset and the number of hosts that match
+    // it, so that the subset can be initialized for the first request routed to it, and whether a
+    // request was routed to the subset since idle subsets were last evicted.
+    SubsetMetadata metadata_;
+    uint32_t matching_hosts_{};
+    bool used_{};
   };
 
   // Create filtered default subset (if necessary) and other subsets based on current hosts.
@@ -203,6 +210,14 @@ private:
   // Rebuild the map for single_host_per_subset mode.
   void rebuildSingle();
 
+  // Count the hosts that match each subset for lazy subsets, creating entries as necessary.
+  void countLazySubsetHosts();
+  // Initialize the load balancer of a lazy subset if it has hosts.
+  void initLazySubset(LbSubsetEntry& entry);
+  // Destroy the load balancers of the lazy subsets that no request was routed to since the last
+  // eviction.
+  void evictIdleSubsets();
+
   void updateFallbackSubset(uint32_t priority, const HostVector& hosts_added,
                             const HostVector& hosts_removed);
   void
@@ -271,6 +286,9 @@ private:
   const bool locality_weight_aware_;
   const bool scale_locality_weight_;
   const bool list_as_any_;
+  const bool lazy_subsets_;
+  const uint32_t lazy_subset_idle_requests_;
+  uint32_t requests_since_eviction_{};
 
   friend class SubsetLoadBalancerDescribeMetadataTester;
 };
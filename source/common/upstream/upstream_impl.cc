@@ -29,11 +29,13 @@
 
 #include "common/common/enum_to_int.h"
 #include "common/common/fmt.h"
+#include "common/common/hash.h"
 #include "common/common/utility.h"
 #include "common/config/utility.h"
 #include "common/http/http1/codec_stats.h"
 #include "common/http/http2/codec_stats.h"
 #include "common/http/utility.h"
+#include "common/memory/accounting.h"
 #include "common/network/address_impl.h"
 #include "common/network/resolver_impl.h"
 #include "common/network/socket_option_factory.h"
@@ -58,6 +60,9 @@
 
 namespace Envoy {
 namespace Upstream {
+
+SINGLETON_MANAGER_REGISTRATION(protocol_options_shared_pool);
+
 namespace {
 
 const Network::Address::InstanceConstSharedPtr
@@ -86,6 +91,9 @@ parseFeatures(const envoy::config::cluster::v3::Cluster& config,
     if (options->use_http2_) {
       features |= ClusterInfoImpl::Features::HTTP2;
     }
+    if (options->use_http3_) {
+      features |= ClusterInfoImpl::Features::HTTP3;
+    }
     if (options->use_downstream_protocol_) {
       features |= ClusterInfoImpl::Features::USE_DOWNSTREAM_PROTOCOL;
     }
@@ -139,6 +147,14 @@ parseClusterSocketOptions(const envoy::config::cluster::v3::Cluster& config,
         cluster_options,
         Network::SocketOptionFactory::buildTcpKeepaliveOptions(parseTcpKeepaliveConfig(config)));
   }
+  if (config.upstream_connection_options().has_busy_poll()) {
+    const auto& busy_poll = config.upstream_connection_options().busy_poll();
+    Network::Socket::appendOptions(
+        cluster_options,
+        Network::SocketOptionFactory::buildBusyPollOptions(
+            Protobuf::util::TimeUtil::DurationToMicroseconds(busy_poll.busy_poll()),
+            busy_poll.prefer_busy_poll()));
+  }
   // Cluster socket_options trump cluster manager wide.
   if (bind_config.socket_options().size() + config.upstream_bind_config().socket_options().size() >
       0) {
@@ -154,6 +170,13 @@ parseClusterSocketOptions(const envoy::config::cluster::v3::Cluster& config,
   return cluster_options;
 }
 
+ProtocolOptionsSharedPoolSharedPtr getProtocolOptionsSharedPool(
+    Server::Configuration::ProtocolOptionsFactoryContext& factory_context) {
+  return factory_context.singletonManager().getTyped<ProtocolOptionsSharedPool>(
+      SINGLETON_MANAGER_REGISTERED_NAME(protocol_options_shared_pool),
+      [] { return std::make_shared<ProtocolOptionsSharedPool>(); });
+}
+
 ProtocolOptionsConfigConstSharedPtr
 createProtocolOptionsConfig(const std::string& name, const ProtobufWkt::Any& typed_config,
                             const ProtobufWkt::Struct& config,
@@ -198,6 +221,7 @@ absl::flat_hash_map<std::string, ProtocolOptionsConfigConstSharedPtr> parseExten
   }
 
   absl::flat_hash_map<std::string, ProtocolOptionsConfigConstSharedPtr> options;
+  ProtocolOptionsSharedPoolSharedPtr pool = getProtocolOptionsSharedPool(factory_context);
 
   for (const auto& it : config.typed_extension_protocol_options()) {
     // TODO(zuercher): canonicalization may be removed when deprecated filter names are removed
@@ -205,8 +229,10 @@ absl::flat_hash_map<std::string, ProtocolOptionsConfigConstSharedPtr> parseExten
     // protocol options.
     auto& name = Extensions::NetworkFilters::Common::FilterNameUtil::canonicalFilterName(it.first);
 
-    auto object = createProtocolOptionsConfig(
-        name, it.second, ProtobufWkt::Struct::default_instance(), factory_context);
+    auto object = pool->getOrCreate(HashUtil::xxHash64(name, MessageUtil::hash(it.second)), [&] {
+      return createProtocolOptionsConfig(name, it.second, ProtobufWkt::Struct::default_instance(),
+                                         factory_context);
+    });
     if (object != nullptr) {
       options[name] = std::move(object);
     }
@@ -218,8 +244,10 @@ absl::flat_hash_map<std::string, ProtocolOptionsConfigConstSharedPtr> parseExten
     // protocol options.
     auto& name = Extensions::NetworkFilters::Common::FilterNameUtil::canonicalFilterName(it.first);
 
-    auto object = createProtocolOptionsConfig(name, ProtobufWkt::Any::default_instance(), it.second,
-                                              factory_context);
+    auto object = pool->getOrCreate(HashUtil::xxHash64(name, MessageUtil::hash(it.second)), [&] {
+      return createProtocolOptionsConfig(name, ProtobufWkt::Any::default_instance(), it.second,
+                                         factory_context);
+    });
     if (object != nullptr) {
       options[name] = std::move(object);
     }
@@ -298,6 +326,14 @@ HostDescriptionImpl::HostDescriptionImpl(
       health_check_config.port_value() == 0
           ? dest_address
           : Network::Utility::getAddressWithPort(*dest_address, health_check_config.port_value());
+  // Only the hosts of clusters whose load balancer compares response times record them.
+  if (cluster->lbType() == LoadBalancerType::LeastRequest &&
+      cluster->lbLeastRequestConfig().has_value() &&
+      cluster->lbLeastRequestConfig()->has_peak_ewma_decay_time()) {
+    response_time_monitor_ = std::make_unique<PeakEwmaResponseTimeMonitor>(
+        time_source, std::chrono::milliseconds(DurationUtil::durationToMilliseconds(
+                         cluster->lbLeastRequestConfig()->peak_ewma_decay_time())));
+  }
 }
 
 Network::TransportSocketFactory& HostDescriptionImpl::resolveTransportSocketFactory(
@@ -701,7 +737,8 @@ private:
 
 std::shared_ptr<const ClusterInfoImpl::HttpProtocolOptionsConfigImpl>
 createOptions(const envoy::config::cluster::v3::Cluster& config,
-              std::shared_ptr<const ClusterInfoImpl::HttpProtocolOptionsConfigImpl>&& options) {
+              std::shared_ptr<const ClusterInfoImpl::HttpProtocolOptionsConfigImpl>&& options,
+              Server::Configuration::ProtocolOptionsFactoryContext& factory_context) {
   if (options) {
     return std::move(options);
   }
@@ -714,15 +751,38 @@ createOptions(const envoy::config::cluster::v3::Cluster& config,
     }
   }
 
-  return std::make_shared<ClusterInfoImpl::HttpProtocolOptionsConfigImpl>(
-      config.http_protocol_options(), config.http2_protocol_options(),
-      config.common_http_protocol_options(),
-      (config.has_upstream_http_protocol_options()
-           ? absl::make_optional<envoy::config::core::v3::UpstreamHttpProtocolOptions>(
-                 config.upstream_http_protocol_options())
-           : absl::nullopt),
-      config.protocol_selection() == envoy::config::cluster::v3::Cluster::USE_DOWNSTREAM_PROTOCOL,
-      config.has_http2_protocol_options());
+  // The options are keyed by the hash of a cluster config with only the fields they are built from.
+  envoy::config::cluster::v3::Cluster options_config;
+  if (config.has_http_protocol_options()) {
+    *options_config.mutable_http_protocol_options() = config.http_protocol_options();
+  }
+  if (config.has_http2_protocol_options()) {
+    *options_config.mutable_http2_protocol_options() = config.http2_protocol_options();
+  }
+  if (config.has_common_http_protocol_options()) {
+    *options_config.mutable_common_http_protocol_options() = config.common_http_protocol_options();
+  }
+  if (config.has_upstream_http_protocol_options()) {
+    *options_config.mutable_upstream_http_protocol_options() =
+        config.upstream_http_protocol_options();
+  }
+  options_config.set_protocol_selection(config.protocol_selection());
+  const uint64_t hash =
+      HashUtil::xxHash64("cluster_http_protocol_options", MessageUtil::hash(options_config));
+
+  return std::dynamic_pointer_cast<const ClusterInfoImpl::HttpProtocolOptionsConfigImpl>(
+      getProtocolOptionsSharedPool(factory_context)->getOrCreate(hash, [&config] {
+        return std::make_shared<ClusterInfoImpl::HttpProtocolOptionsConfigImpl>(
+            config.http_protocol_options(), config.http2_protocol_options(),
+            config.common_http_protocol_options(),
+            (config.has_upstream_http_protocol_options()
+                 ? absl::make_optional<envoy::config::core::v3::UpstreamHttpProtocolOptions>(
+                       config.upstream_http_protocol_options())
+                 : absl::nullopt),
+            config.protocol_selection() ==
+                envoy::config::cluster::v3::Cluster::USE_DOWNSTREAM_PROTOCOL,
+            config.has_http2_protocol_options());
+      }));
 }
 
 ClusterInfoImpl::ClusterInfoImpl(
@@ -733,8 +793,10 @@ ClusterInfoImpl::ClusterInfoImpl(
     : runtime_(runtime), name_(config.name()), type_(config.type()),
       extension_protocol_options_(parseExtensionProtocolOptions(config, factory_context)),
       http_protocol_options_(
-          createOptions(config, extensionProtocolOptionsTyped<HttpProtocolOptionsConfigImpl>(
-                                    "envoy.extensions.upstreams.http.v3.HttpProtocolOptions"))),
+          createOptions(config,
+                        extensionProtocolOptionsTyped<HttpProtocolOptionsConfigImpl>(
+                            "envoy.extensions.upstreams.http.v3.HttpProtocolOptions"),
+                        factory_context)),
       max_requests_per_connection_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_requests_per_connection, 0)),
       max_response_headers_count_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
@@ -747,13 +809,13 @@ ClusterInfoImpl::ClusterInfoImpl(
           config.preconnect_policy(), per_upstream_preconnect_ratio, 1.0)),
       peekahead_ratio_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.preconnect_policy(),
                                                        predictive_preconnect_ratio, 0)),
+      per_upstream_min_idle_connections_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          config.preconnect_policy(), per_upstream_min_idle_connections, 0)),
       per_connection_buffer_limit_bytes_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, per_connection_buffer_limit_bytes, 1024 * 1024)),
       socket_matcher_(std::move(socket_matcher)), stats_scope_(std::move(stats_scope)),
       stats_(generateStats(*stats_scope_, factory_context.clusterManager().clusterStatNames())),
-      load_report_stats_store_(stats_scope_->symbolTable()),
-      load_report_stats_(generateLoadReportStats(
-          load_report_stats_store_, factory_context.clusterManager().clusterLoadReportStatNames())),
+      load_report_stat_names_(factory_context.clusterManager().clusterLoadReportStatNames()),
       optional_cluster_stats_((config.has_track_cluster_stats() || config.track_timeout_budgets())
                                   ? std::make_unique<OptionalClusterStats>(
                                         config, *stats_scope_, factory_context.clusterManager())
@@ -877,6 +939,12 @@ ClusterInfoImpl::ClusterInfoImpl(
         factory.createFilterFactoryFromProto(*message, *factory_context_);
     filter_factories_.push_back(callback);
   }
+
+  Memory::Accounting::allocate(Memory::Accounting::Account::Clusters, sizeof(ClusterInfoImpl));
+}
+
+ClusterInfoImpl::~ClusterInfoImpl() {
+  Memory::Accounting::free(Memory::Accounting::Account::Clusters, sizeof(ClusterInfoImpl));
 }
 
 ProtocolOptionsConfigConstSharedPtr
@@ -913,6 +981,28 @@ Network::TransportSocketFactoryPtr createTransportSocketFactory(
   return config_factory.createTransportSocketFactory(*message, factory_context);
 }
 
+ProtocolOptionsConfigConstSharedPtr ProtocolOptionsSharedPool::getOrCreate(
+    uint64_t hash, const std::function<ProtocolOptionsConfigConstSharedPtr()>& create) {
+  ProtocolOptionsConfigConstSharedPtr options = options_[hash].lock();
+  if (options == nullptr) {
+    options = create();
+    options_[hash] = options;
+  }
+
+  // Forget the options of removed clusters whenever the number of options doubles.
+  if (options_.size() > 2 * swept_size_) {
+    for (auto it = options_.begin(); it != options_.end();) {
+      if (it->second.expired()) {
+        options_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+    swept_size_ = options_.size();
+  }
+  return options;
+}
+
 void ClusterInfoImpl::createNetworkFilterChain(Network::Connection& connection) const {
   for (const auto& factory : filter_factories_) {
     factory(connection);
@@ -926,6 +1016,8 @@ ClusterInfoImpl::upstreamHttpProtocol(absl::optional<Http::Protocol> downstream_
     return {downstream_protocol.value()};
   } else if (features_ & Upstream::ClusterInfo::Features::USE_ALPN) {
     return {Http::Protocol::Http2, Http::Protocol::Http11};
+  } else if (features_ & Upstream::ClusterInfo::Features::HTTP3) {
+    return {Http::Protocol::Http3};
   } else {
     return {(features_ & Upstream::ClusterInfo::Features::HTTP2) ? Http::Protocol::Http2
                                                                  : Http::Protocol::Http11};
@@ -960,6 +1052,14 @@ ClusterImplBase::ClusterImplBase(
                     cluster.name(), cluster.DebugString()));
   }
 
+  if ((info_->features() & ClusterInfoImpl::Features::HTTP3) &&
+      cluster.transport_socket().name() !=
+          Extensions::TransportSockets::TransportSocketNames::get().Quic) {
+    throw EnvoyException(
+        fmt::format("HTTP/3 configured for cluster {} which has a non-QUIC transport socket: {}",
+                    cluster.name(), cluster.DebugString()));
+  }
+
   // Create the default (empty) priority set before registering callbacks to
   // avoid getting an update the first time it is accessed.
   priority_set_.getOrCreateHostSet(0);
@@ -1025,8 +1125,15 @@ bool ClusterInfoImpl::maintenanceMode() const {
 }
 
 ResourceManager& ClusterInfoImpl::resourceManager(ResourcePriority priority) const {
-  ASSERT(enumToInt(priority) < resource_managers_.managers_.size());
-  return *resource_managers_.managers_[enumToInt(priority)];
+  return resource_managers_.get(priority);
+}
+
+ClusterLoadReportStats& ClusterInfoImpl::loadReportStats() const {
+  return load_report_stats_
+      .get([this]() -> LoadReportStats* {
+        return new LoadReportStats(stats_scope_->symbolTable(), load_report_stat_names_);
+      })
+      ->stats_;
 }
 
 void ClusterImplBase::initialize(std::function<void()> callback) {
@@ -1178,11 +1285,17 @@ ClusterInfoImpl::ResourceManagers::ResourceManagers(
     const envoy::config::cluster::v3::Cluster& config, Runtime::Loader& runtime,
     const std::string& cluster_name, Stats::Scope& stats_scope,
     const ClusterCircuitBreakersStatNames& circuit_breakers_stat_names)
-    : circuit_breakers_stat_names_(circuit_breakers_stat_names) {
-  managers_[enumToInt(ResourcePriority::Default)] =
-      load(config, runtime, cluster_name, stats_scope, envoy::config::core::v3::DEFAULT);
-  managers_[enumToInt(ResourcePriority::High)] =
-      load(config, runtime, cluster_name, stats_scope, envoy::config::core::v3::HIGH);
+    : runtime_(runtime), cluster_name_(cluster_name), stats_scope_(stats_scope),
+      circuit_breakers_stat_names_(circuit_breakers_stat_names) {
+  thresholds_[enumToInt(ResourcePriority::Default)] =
+      loadThresholds(config, envoy::config::core::v3::DEFAULT);
+  thresholds_[enumToInt(ResourcePriority::High)] =
+      loadThresholds(config, envoy::config::core::v3::HIGH);
+}
+
+ResourceManagerImpl& ClusterInfoImpl::ResourceManagers::get(ResourcePriority priority) {
+  ASSERT(enumToInt(priority) < NumResourcePriorities);
+  return *managers_.get(enumToInt(priority), [this, priority]() { return load(priority); });
 }
 
 ClusterCircuitBreakersStats
@@ -1221,75 +1334,59 @@ Http::Http2::CodecStats& ClusterInfoImpl::http2CodecStats() const {
   return Http::Http2::CodecStats::atomicGet(http2_codec_stats_, *stats_scope_);
 }
 
-ResourceManagerImplPtr
-ClusterInfoImpl::ResourceManagers::load(const envoy::config::cluster::v3::Cluster& config,
-                                        Runtime::Loader& runtime, const std::string& cluster_name,
-                                        Stats::Scope& stats_scope,
-                                        const envoy::config::core::v3::RoutingPriority& priority) {
-  uint64_t max_connections = 1024;
-  uint64_t max_pending_requests = 1024;
-  uint64_t max_requests = 1024;
-  uint64_t max_retries = 3;
-  uint64_t max_connection_pools = std::numeric_limits<uint64_t>::max();
-
-  bool track_remaining = false;
-
-  Stats::StatName priority_stat_name;
-  std::string priority_name;
-  switch (priority) {
-  case envoy::config::core::v3::DEFAULT:
-    priority_stat_name = circuit_breakers_stat_names_.default_;
-    priority_name = "default";
-    break;
-  case envoy::config::core::v3::HIGH:
-    priority_stat_name = circuit_breakers_stat_names_.high_;
-    priority_name = "high";
-    break;
-  default:
-    NOT_REACHED_GCOVR_EXCL_LINE;
-  }
-
-  const std::string runtime_prefix =
-      fmt::format("circuit_breakers.{}.{}.", cluster_name, priority_name);
-
+ClusterInfoImpl::ResourceManagers::Thresholds ClusterInfoImpl::ResourceManagers::loadThresholds(
+    const envoy::config::cluster::v3::Cluster& config,
+    envoy::config::core::v3::RoutingPriority priority) {
+  Thresholds result;
   const auto& thresholds = config.circuit_breakers().thresholds();
   const auto it = std::find_if(
       thresholds.cbegin(), thresholds.cend(),
       [priority](const envoy::config::cluster::v3::CircuitBreakers::Thresholds& threshold) {
         return threshold.priority() == priority;
       });
-
-  absl::optional<double> budget_percent;
-  absl::optional<uint32_t> min_retry_concurrency;
-  if (it != thresholds.cend()) {
-    max_connections = PROTOBUF_GET_WRAPPED_OR_DEFAULT(*it, max_connections, max_connections);
-    max_pending_requests =
-        PROTOBUF_GET_WRAPPED_OR_DEFAULT(*it, max_pending_requests, max_pending_requests);
-    max_requests = PROTOBUF_GET_WRAPPED_OR_DEFAULT(*it, max_requests, max_requests);
-    max_retries = PROTOBUF_GET_WRAPPED_OR_DEFAULT(*it, max_retries, max_retries);
-    track_remaining = it->track_remaining();
-    max_connection_pools =
-        PROTOBUF_GET_WRAPPED_OR_DEFAULT(*it, max_connection_pools, max_connection_pools);
-    if (it->has_retry_budget()) {
-      // The budget_percent and min_retry_concurrency values do not set defaults like the other
-      // members of the 'threshold' message, because the behavior of the retry circuit breaker
-      // changes depending on whether it has been configured. Therefore, it's necessary to manually
-      // check if the threshold message has a retry budget configured and only set the values if so.
-      budget_percent = it->retry_budget().has_budget_percent()
-                           ? PROTOBUF_GET_WRAPPED_REQUIRED(it->retry_budget(), budget_percent)
-                           : budget_percent;
-      min_retry_concurrency =
-          it->retry_budget().has_min_retry_concurrency()
-              ? PROTOBUF_GET_WRAPPED_REQUIRED(it->retry_budget(), min_retry_concurrency)
-              : min_retry_concurrency;
+  if (it == thresholds.cend()) {
+    return result;
+  }
+
+  result.max_connections_ =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(*it, max_connections, result.max_connections_);
+  result.max_pending_requests_ =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(*it, max_pending_requests, result.max_pending_requests_);
+  result.max_requests_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(*it, max_requests, result.max_requests_);
+  result.max_retries_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(*it, max_retries, result.max_retries_);
+  result.track_remaining_ = it->track_remaining();
+  result.max_connection_pools_ =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(*it, max_connection_pools, result.max_connection_pools_);
+  if (it->has_retry_budget()) {
+    // The budget_percent and min_retry_concurrency values do not set defaults like the other
+    // members of the 'threshold' message, because the behavior of the retry circuit breaker
+    // changes depending on whether it has been configured. Therefore, it's necessary to manually
+    // check if the threshold message has a retry budget configured and only set the values if so.
+    if (it->retry_budget().has_budget_percent()) {
+      result.budget_percent_ = PROTOBUF_GET_WRAPPED_REQUIRED(it->retry_budget(), budget_percent);
+    }
+    if (it->retry_budget().has_min_retry_concurrency()) {
+      result.min_retry_concurrency_ =
+          PROTOBUF_GET_WRAPPED_REQUIRED(it->retry_budget(), min_retry_concurrency);
     }
   }
-  return std::make_unique<ResourceManagerImpl>(
-      runtime, runtime_prefix, max_connections, max_pending_requests, max_requests, max_retries,
-      max_connection_pools,
-      ClusterInfoImpl::generateCircuitBreakersStats(stats_scope, priority_stat_name,
-                                                    track_remaining, circuit_breakers_stat_names_),
-      budget_percent, min_retry_concurrency);
+  return result;
+}
+
+ResourceManagerImpl* ClusterInfoImpl::ResourceManagers::load(ResourcePriority priority) {
+  const bool high = priority == ResourcePriority::High;
+  const Stats::StatName priority_stat_name =
+      high ? circuit_breakers_stat_names_.high_ : circuit_breakers_stat_names_.default_;
+  const std::string runtime_prefix =
+      fmt::format("circuit_breakers.{}.{}.", cluster_name_, high ? "high" : "default");
+  const Thresholds& thresholds = thresholds_[enumToInt(priority)];
+  return new ResourceManagerImpl(
+      runtime_, runtime_prefix, thresholds.max_connections_, thresholds.max_pending_requests_,
+      thresholds.max_requests_, thresholds.max_retries_, thresholds.max_connection_pools_,
+      ClusterInfoImpl::generateCircuitBreakersStats(stats_scope_, priority_stat_name,
+                                                    thresholds.track_remaining_,
+                                                    circuit_breakers_stat_names_),
+      thresholds.budget_percent_, thresholds.min_retry_concurrency_);
 }
 
 PriorityStateManager::PriorityStateManager(ClusterImplBase& cluster,
@@ -1481,32 +1578,36 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(const HostVector& new_hosts,
         max_host_weight = host->weight();
       }
 
-      hosts_changed |=
-          updateHealthFlag(*host, *existing_host->second, Host::HealthFlag::FAILED_EDS_HEALTH);
-      hosts_changed |=
-          updateHealthFlag(*host, *existing_host->second, Host::HealthFlag::DEGRADED_EDS_HEALTH);
-
-      // Did metadata change?
-      bool metadata_changed = true;
-      if (host->metadata() && existing_host->second->metadata()) {
-        metadata_changed = !Protobuf::util::MessageDifferencer::Equivalent(
-            *host->metadata(), *existing_host->second->metadata());
-      } else if (!host->metadata() && !existing_host->second->metadata()) {
-        metadata_changed = false;
-      }
+      // Service discovery may pass the existing host itself when its endpoint did not change, in
+      // which case there is nothing to compare.
+      if (host != existing_host->second) {
+        hosts_changed |=
+            updateHealthFlag(*host, *existing_host->second, Host::HealthFlag::FAILED_EDS_HEALTH);
+        hosts_changed |=
+            updateHealthFlag(*host, *existing_host->second, Host::HealthFlag::DEGRADED_EDS_HEALTH);
+
+        // Did metadata change?
+        bool metadata_changed = true;
+        if (host->metadata() && existing_host->second->metadata()) {
+          metadata_changed = !Protobuf::util::MessageDifferencer::Equivalent(
+              *host->metadata(), *existing_host->second->metadata());
+        } else if (!host->metadata() && !existing_host->second->metadata()) {
+          metadata_changed = false;
+        }
 
-      if (metadata_changed) {
-        // First, update the entire metadata for the endpoint.
-        existing_host->second->metadata(host->metadata());
+        if (metadata_changed) {
+          // First, update the entire metadata for the endpoint.
+          existing_host->second->metadata(host->metadata());
 
-        // Also, given that the canary attribute of an endpoint is derived from its metadata
-        // (e.g.: from envoy.lb/canary), we do a blind update here since it's cheaper than testing
-        // to see if it actually changed. We must update this besides just updating the metadata,
-        // because it'll be used by the router filter to compute upstream stats.
-        existing_host->second->canary(host->canary());
+          // Also, given that the canary attribute of an endpoint is derived from its metadata
+          // (e.g.: from envoy.lb/canary), we do a blind update here since it's cheaper than testing
+          // to see if it actually changed. We must update this besides just updating the metadata,
+          // because it'll be used by the router filter to compute upstream stats.
+          existing_host->second->canary(host->canary());
 
-        // If metadata changed, we need to rebuild. See github issue #3810.
-        hosts_changed = true;
+          // If metadata changed, we need to rebuild. See github issue #3810.
+          hosts_changed = true;
+        }
       }
 
       // Did the priority change?
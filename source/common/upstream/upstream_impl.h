@@ -5,6 +5,7 @@
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <list>
 #include <memory>
 #include <string>
@@ -50,6 +51,7 @@
 #include "common/stats/isolated_store_impl.h"
 #include "common/upstream/load_balancer_impl.h"
 #include "common/upstream/outlier_detection_impl.h"
+#include "common/upstream/peak_ewma.h"
 #include "common/upstream/resource_manager_impl.h"
 #include "common/upstream/transport_socket_match_impl.h"
 
@@ -126,6 +128,15 @@ public:
       return *null_outlier_detector;
     }
   }
+  ResponseTimeMonitor& responseTimeMonitor() const override {
+    if (response_time_monitor_) {
+      return *response_time_monitor_;
+    } else {
+      static ResponseTimeMonitorNullImpl* null_response_time_monitor =
+          new ResponseTimeMonitorNullImpl();
+      return *null_response_time_monitor;
+    }
+  }
   HostStats& stats() const override { return stats_; }
   const std::string& hostnameForHealthChecks() const override { return health_checks_hostname_; }
   const std::string& hostname() const override { return hostname_; }
@@ -158,6 +169,7 @@ protected:
   mutable HostStats stats_;
   Outlier::DetectorHostMonitorPtr outlier_detector_;
   HealthCheckHostMonitorPtr health_checker_;
+  ResponseTimeMonitorPtr response_time_monitor_;
   std::atomic<uint32_t> priority_;
   Network::TransportSocketFactory& socket_factory_;
   const MonotonicTime creation_time_;
@@ -196,8 +208,7 @@ public:
                               Network::TransportSocketOptionsSharedPtr transport_socket_options,
                               const envoy::config::core::v3::Metadata* metadata) const override;
 
-  std::vector<std::pair<absl::string_view, Stats::PrimitiveGaugeReference>>
-  gauges() const override {
+  std::vector<std::pair<absl::string_view, uint64_t>> gauges() const override {
     return stats_.gauges();
   }
   void healthFlagClear(HealthFlag flag) override { health_flags_ &= ~enumToInt(flag); }
@@ -514,6 +525,32 @@ private:
   };
 };
 
+/**
+ * Shares the protocol options of clusters with identical protocol options config, such as the
+ * clusters generated from a template, so that the options are built once. Options are keyed by
+ * the hash of their config, and live as long as a cluster references them. Only used on the main
+ * thread, where clusters are built.
+ */
+class ProtocolOptionsSharedPool : public Singleton::Instance {
+public:
+  /**
+   * @param hash the hash of the config of the options.
+   * @param create builds the options if no cluster references options with the same config.
+   * @return the options.
+   */
+  ProtocolOptionsConfigConstSharedPtr
+  getOrCreate(uint64_t hash, const std::function<ProtocolOptionsConfigConstSharedPtr()>& create);
+
+  size_t size() const { return options_.size(); }
+
+private:
+  absl::flat_hash_map<uint64_t, std::weak_ptr<const ProtocolOptionsConfig>> options_;
+  // The number of options after the last removal of the options that are no longer referenced.
+  size_t swept_size_{};
+};
+
+using ProtocolOptionsSharedPoolSharedPtr = std::shared_ptr<ProtocolOptionsSharedPool>;
+
 /**
  * Implementation of ClusterInfo that reads from JSON.
  */
@@ -525,6 +562,7 @@ public:
                   const envoy::config::core::v3::BindConfig& bind_config, Runtime::Loader& runtime,
                   TransportSocketMatcherPtr&& socket_matcher, Stats::ScopePtr&& stats_scope,
                   bool added_via_api, Server::Configuration::TransportSocketFactoryContext&);
+  ~ClusterInfoImpl() override;
 
   static ClusterStats generateStats(Stats::Scope& scope,
                                     const ClusterStatNames& cluster_stat_names);
@@ -550,6 +588,9 @@ public:
   }
   float perUpstreamPreconnectRatio() const override { return per_upstream_preconnect_ratio_; }
   float peekaheadRatio() const override { return peekahead_ratio_; }
+  uint32_t perUpstreamMinIdleConnections() const override {
+    return per_upstream_min_idle_connections_;
+  }
   uint32_t perConnectionBufferLimitBytes() const override {
     return per_connection_buffer_limit_bytes_;
   }
@@ -560,6 +601,9 @@ public:
   const envoy::config::core::v3::Http2ProtocolOptions& http2Options() const override {
     return http_protocol_options_->http2_options_;
   }
+  const envoy::config::core::v3::Http3ProtocolOptions& http3Options() const override {
+    return http_protocol_options_->http3_options_;
+  }
   const envoy::config::core::v3::HttpProtocolOptions& commonHttpProtocolOptions() const override {
     return http_protocol_options_->common_http_protocol_options_;
   }
@@ -609,7 +653,7 @@ public:
     return std::ref(*(optional_cluster_stats_->request_response_size_stats_));
   }
 
-  ClusterLoadReportStats& loadReportStats() const override { return load_report_stats_; }
+  ClusterLoadReportStats& loadReportStats() const override;
 
   ClusterTimeoutBudgetStatsOptRef timeoutBudgetStats() const override {
     if (optional_cluster_stats_ == nullptr ||
@@ -651,21 +695,52 @@ public:
   Http::Http2::CodecStats& http2CodecStats() const override;
 
 private:
+  // The resource managers of the priorities, and their circuit breaker stats, are instantiated on
+  // first use, so that clusters that never receive traffic do not allocate them.
   struct ResourceManagers {
     ResourceManagers(const envoy::config::cluster::v3::Cluster& config, Runtime::Loader& runtime,
                      const std::string& cluster_name, Stats::Scope& stats_scope,
                      const ClusterCircuitBreakersStatNames& circuit_breakers_stat_names);
-    ResourceManagerImplPtr load(const envoy::config::cluster::v3::Cluster& config,
-                                Runtime::Loader& runtime, const std::string& cluster_name,
-                                Stats::Scope& stats_scope,
-                                const envoy::config::core::v3::RoutingPriority& priority);
-
-    using Managers = std::array<ResourceManagerImplPtr, NumResourcePriorities>;
-
+    ResourceManagerImpl& get(ResourcePriority priority);
+
+    // The circuit breaker settings of a priority.
+    struct Thresholds {
+      uint64_t max_connections_{1024};
+      uint64_t max_pending_requests_{1024};
+      uint64_t max_requests_{1024};
+      uint64_t max_retries_{3};
+      uint64_t max_connection_pools_{std::numeric_limits<uint64_t>::max()};
+      bool track_remaining_{};
+      absl::optional<double> budget_percent_;
+      absl::optional<uint32_t> min_retry_concurrency_;
+    };
+    static Thresholds loadThresholds(const envoy::config::cluster::v3::Cluster& config,
+                                     envoy::config::core::v3::RoutingPriority priority);
+    ResourceManagerImpl* load(ResourcePriority priority);
+
+    using Managers = Thread::AtomicPtrArray<ResourceManagerImpl, NumResourcePriorities,
+                                            Thread::AtomicPtrAllocMode::DeleteOnDestruct>;
+
+    Runtime::Loader& runtime_;
+    const std::string& cluster_name_;
+    Stats::Scope& stats_scope_;
+    std::array<Thresholds, NumResourcePriorities> thresholds_;
     Managers managers_;
     const ClusterCircuitBreakersStatNames& circuit_breakers_stat_names_;
   };
 
+  // The load report stats live in a store of their own, which is only allocated once the cluster
+  // drops a request or its load is reported.
+  struct LoadReportStats {
+    LoadReportStats(Stats::SymbolTable& symbol_table, const ClusterLoadReportStatNames& stat_names)
+        : store_(symbol_table), stats_(generateLoadReportStats(store_, stat_names)) {}
+
+    Stats::IsolatedStoreImpl store_;
+    ClusterLoadReportStats stats_;
+  };
+  using LoadReportStatsAtomicPtr =
+      Thread::AtomicPtr<LoadReportStats, Thread::AtomicPtrAllocMode::DeleteOnDestruct>;
+
   struct OptionalClusterStats {
     OptionalClusterStats(const envoy::config::cluster::v3::Cluster& config,
                          Stats::Scope& stats_scope, const ClusterManager& manager);
@@ -685,12 +760,13 @@ private:
   absl::optional<std::chrono::milliseconds> idle_timeout_;
   const float per_upstream_preconnect_ratio_;
   const float peekahead_ratio_;
+  const uint32_t per_upstream_min_idle_connections_;
   const uint32_t per_connection_buffer_limit_bytes_;
   TransportSocketMatcherPtr socket_matcher_;
   Stats::ScopePtr stats_scope_;
   mutable ClusterStats stats_;
-  Stats::IsolatedStoreImpl load_report_stats_store_;
-  mutable ClusterLoadReportStats load_report_stats_;
+  const ClusterLoadReportStatNames& load_report_stat_names_;
+  mutable LoadReportStatsAtomicPtr load_report_stats_;
   const std::unique_ptr<OptionalClusterStats> optional_cluster_stats_;
   const uint64_t features_;
   mutable ResourceManagers resource_managers_;
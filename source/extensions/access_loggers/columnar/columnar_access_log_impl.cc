@@ -0,0 +1,259 @@
+#include "extensions/access_loggers/columnar/columnar_access_log_impl.h"
+
+#include "envoy/upstream/upstream.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+#include "common/http/header_utility.h"
+#include "common/http/utility.h"
+#include "common/protobuf/utility.h"
+#include "common/stream_info/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Columnar {
+
+namespace {
+
+constexpr absl::string_view BatchMagic = "EALB";
+constexpr uint8_t Int64Type = 0;
+constexpr uint8_t StringType = 1;
+
+ColumnConfig::Source sourceOf(const ColumnarAccessLogConfig::Column& config) {
+  switch (config.value_case()) {
+  case ColumnarAccessLogConfig::Column::ValueCase::kRequestHeader:
+    return ColumnConfig::Source::RequestHeader;
+  case ColumnarAccessLogConfig::Column::ValueCase::kResponseHeader:
+    return ColumnConfig::Source::ResponseHeader;
+  default:
+    return ColumnConfig::Source::Field;
+  }
+}
+
+absl::optional<int64_t> int64Value(ColumnarAccessLogConfig::Field field,
+                                   const StreamInfo::StreamInfo& stream_info) {
+  switch (field) {
+  case ColumnarAccessLogConfig::START_TIME:
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               stream_info.startTime().time_since_epoch())
+        .count();
+  case ColumnarAccessLogConfig::DURATION: {
+    const auto duration = stream_info.requestComplete();
+    if (!duration.has_value()) {
+      return absl::nullopt;
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration.value()).count();
+  }
+  case ColumnarAccessLogConfig::RESPONSE_CODE: {
+    const auto code = stream_info.responseCode();
+    if (!code.has_value()) {
+      return absl::nullopt;
+    }
+    return code.value();
+  }
+  case ColumnarAccessLogConfig::BYTES_RECEIVED:
+    return stream_info.bytesReceived();
+  case ColumnarAccessLogConfig::BYTES_SENT:
+    return stream_info.bytesSent();
+  default:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+}
+
+// Returns a view of the value of a string field, which may be kept in storage.
+absl::optional<absl::string_view> stringValue(ColumnarAccessLogConfig::Field field,
+                                              const StreamInfo::StreamInfo& stream_info,
+                                              std::string& storage) {
+  switch (field) {
+  case ColumnarAccessLogConfig::DOWNSTREAM_REMOTE_ADDRESS:
+    if (stream_info.downstreamRemoteAddress() == nullptr) {
+      return absl::nullopt;
+    }
+    return stream_info.downstreamRemoteAddress()->asStringView();
+  case ColumnarAccessLogConfig::UPSTREAM_HOST:
+    if (stream_info.upstreamHost() == nullptr || stream_info.upstreamHost()->address() == nullptr) {
+      return absl::nullopt;
+    }
+    return stream_info.upstreamHost()->address()->asStringView();
+  case ColumnarAccessLogConfig::UPSTREAM_CLUSTER: {
+    const auto cluster_info = stream_info.upstreamClusterInfo();
+    if (!cluster_info.has_value() || cluster_info.value() == nullptr) {
+      return absl::nullopt;
+    }
+    return cluster_info.value()->name();
+  }
+  case ColumnarAccessLogConfig::PROTOCOL:
+    if (!stream_info.protocol().has_value()) {
+      return absl::nullopt;
+    }
+    return Http::Utility::getProtocolString(stream_info.protocol().value());
+  case ColumnarAccessLogConfig::RESPONSE_FLAGS:
+    storage = StreamInfo::ResponseFlagUtils::toShortString(stream_info);
+    return storage;
+  default:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+}
+
+} // namespace
+
+ColumnConfig::ColumnConfig(const ColumnarAccessLogConfig::Column& config)
+    : name_(config.name()), source_(sourceOf(config)), field_(config.field()),
+      header_(source_ == Source::RequestHeader ? config.request_header()
+                                               : config.response_header()) {}
+
+RecordBatch::RecordBatch(ColumnConfigsConstSharedPtr configs)
+    : configs_(std::move(configs)), columns_(configs_->size()) {}
+
+void RecordBatch::addRow(const Http::RequestHeaderMap& request_headers,
+                         const Http::ResponseHeaderMap& response_headers,
+                         const StreamInfo::StreamInfo& stream_info) {
+  std::string storage;
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    const ColumnConfig& config = (*configs_)[i];
+    switch (config.source_) {
+    case ColumnConfig::Source::Field:
+      if (config.isInt64()) {
+        addInt64(columns_[i], int64Value(config.field_, stream_info));
+      } else {
+        addString(columns_[i], stringValue(config.field_, stream_info, storage));
+      }
+      break;
+    case ColumnConfig::Source::RequestHeader:
+    case ColumnConfig::Source::ResponseHeader: {
+      const Http::HeaderMap& headers = config.source_ == ColumnConfig::Source::RequestHeader
+                                           ? static_cast<const Http::HeaderMap&>(request_headers)
+                                           : response_headers;
+      const auto header = Http::HeaderUtility::getAllOfHeaderAsString(headers, config.header_);
+      addString(columns_[i], header.result());
+      break;
+    }
+    }
+  }
+  ++rows_;
+}
+
+void RecordBatch::addInt64(Column& column, absl::optional<int64_t> value) {
+  if (rows_ % 8 == 0) {
+    column.validity_.push_back(0);
+  }
+  if (value.has_value()) {
+    column.validity_.back() |= 1 << (rows_ % 8);
+  }
+  column.values_.push_back(value.value_or(0));
+}
+
+void RecordBatch::addString(Column& column, absl::optional<absl::string_view> value) {
+  if (!value.has_value()) {
+    column.indexes_.push_back(NoValue);
+    return;
+  }
+  // The index of a new value is the size of the dictionary before it is added.
+  const uint32_t index =
+      column.dictionary_.try_emplace(value.value(), column.dictionary_.size()).first->second;
+  column.indexes_.push_back(index);
+}
+
+void RecordBatch::encode(Buffer::Instance& output) {
+  output.add(BatchMagic);
+  output.writeLEInt<uint32_t>(rows_);
+  output.writeLEInt<uint32_t>(columns_.size());
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    const ColumnConfig& config = (*configs_)[i];
+    Column& column = columns_[i];
+    output.writeLEInt<uint16_t>(config.name_.size());
+    output.add(config.name_);
+    if (config.isInt64()) {
+      output.writeLEInt<uint8_t>(Int64Type);
+      output.add(column.validity_.data(), column.validity_.size());
+      for (const int64_t value : column.values_) {
+        output.writeLEInt<int64_t>(value);
+      }
+    } else {
+      output.writeLEInt<uint8_t>(StringType);
+      std::vector<absl::string_view> entries(column.dictionary_.size());
+      for (const auto& entry : column.dictionary_) {
+        entries[entry.second] = entry.first;
+      }
+      output.writeLEInt<uint32_t>(entries.size());
+      for (const absl::string_view entry : entries) {
+        output.writeLEInt<uint32_t>(entry.size());
+        output.add(entry);
+      }
+      for (const uint32_t index : column.indexes_) {
+        output.writeLEInt<uint32_t>(index);
+      }
+    }
+    column.values_.clear();
+    column.validity_.clear();
+    column.dictionary_.clear();
+    column.indexes_.clear();
+  }
+  rows_ = 0;
+}
+
+ColumnarAccessLog::ColumnarAccessLog(const ColumnarAccessLogConfig& config,
+                                     AccessLog::FilterPtr&& filter,
+                                     AccessLog::AccessLogManager& log_manager,
+                                     ThreadLocal::SlotAllocator& tls)
+    : ImplBase(std::move(filter)), tls_slot_(tls.allocateSlot()) {
+  auto configs = std::make_shared<ColumnConfigs>();
+  for (const auto& column : config.columns()) {
+    configs->emplace_back(column);
+  }
+  const uint32_t max_rows = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_batch_rows, 1024);
+  const std::chrono::milliseconds flush_interval(
+      PROTOBUF_GET_MS_OR_DEFAULT(config, batch_flush_interval, 1000));
+  AccessLog::AccessLogFileSharedPtr log_file = log_manager.createAccessLog(config.path());
+  tls_slot_->set([configs = ColumnConfigsConstSharedPtr(std::move(configs)), max_rows,
+                  flush_interval, log_file](Event::Dispatcher& dispatcher) {
+    return std::make_shared<ThreadLocalBatch>(configs, max_rows, flush_interval, log_file,
+                                              dispatcher);
+  });
+}
+
+void ColumnarAccessLog::emitLog(const Http::RequestHeaderMap& request_headers,
+                                const Http::ResponseHeaderMap& response_headers,
+                                const Http::ResponseTrailerMap&,
+                                const StreamInfo::StreamInfo& stream_info) {
+  tls_slot_->getTyped<ThreadLocalBatch>().log(request_headers, response_headers, stream_info);
+}
+
+ColumnarAccessLog::ThreadLocalBatch::ThreadLocalBatch(ColumnConfigsConstSharedPtr configs,
+                                                      uint32_t max_rows,
+                                                      std::chrono::milliseconds flush_interval,
+                                                      AccessLog::AccessLogFileSharedPtr log_file,
+                                                      Event::Dispatcher& dispatcher)
+    : batch_(std::move(configs)), max_rows_(max_rows), flush_interval_(flush_interval),
+      log_file_(std::move(log_file)), flush_timer_(dispatcher.createTimer([this]() {
+        flush();
+        flush_timer_->enableTimer(flush_interval_);
+      })) {
+  flush_timer_->enableTimer(flush_interval_);
+}
+
+ColumnarAccessLog::ThreadLocalBatch::~ThreadLocalBatch() { flush(); }
+
+void ColumnarAccessLog::ThreadLocalBatch::log(const Http::RequestHeaderMap& request_headers,
+                                              const Http::ResponseHeaderMap& response_headers,
+                                              const StreamInfo::StreamInfo& stream_info) {
+  batch_.addRow(request_headers, response_headers, stream_info);
+  if (batch_.rows() >= max_rows_) {
+    flush();
+  }
+}
+
+void ColumnarAccessLog::ThreadLocalBatch::flush() {
+  if (batch_.rows() == 0) {
+    return;
+  }
+  Buffer::OwnedImpl output;
+  batch_.encode(output);
+  log_file_->write(output.toString());
+}
+
+} // namespace Columnar
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
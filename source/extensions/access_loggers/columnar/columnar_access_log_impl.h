@@ -0,0 +1,144 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/access_log/access_log.h"
+#include "envoy/buffer/buffer.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/extensions/access_loggers/columnar/v3/columnar.pb.h"
+#include "envoy/http/header_map.h"
+#include "envoy/stream_info/stream_info.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "extensions/access_loggers/common/access_log_base.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Columnar {
+
+using ColumnarAccessLogConfig = envoy::extensions::access_loggers::columnar::v3::ColumnarAccessLog;
+
+/**
+ * The configuration of a column of the batches.
+ */
+struct ColumnConfig {
+  enum class Source { Field, RequestHeader, ResponseHeader };
+
+  explicit ColumnConfig(const ColumnarAccessLogConfig::Column& config);
+
+  /**
+   * @return whether the values of the column are integers, rather than strings.
+   */
+  bool isInt64() const {
+    return source_ == Source::Field && field_ <= ColumnarAccessLogConfig::BYTES_SENT;
+  }
+
+  const std::string name_;
+  const Source source_;
+  const ColumnarAccessLogConfig::Field field_;
+  const Http::LowerCaseString header_;
+};
+
+using ColumnConfigs = std::vector<ColumnConfig>;
+using ColumnConfigsConstSharedPtr = std::shared_ptr<const ColumnConfigs>;
+
+/**
+ * The rows logged by a worker, stored column by column until they are encoded as a batch.
+ * @see ColumnarAccessLogConfig for the encoding.
+ */
+class RecordBatch {
+public:
+  explicit RecordBatch(ColumnConfigsConstSharedPtr configs);
+
+  /**
+   * Adds the row of a request.
+   */
+  void addRow(const Http::RequestHeaderMap& request_headers,
+              const Http::ResponseHeaderMap& response_headers,
+              const StreamInfo::StreamInfo& stream_info);
+
+  /**
+   * @return the number of rows of the batch.
+   */
+  uint32_t rows() const { return rows_; }
+
+  /**
+   * Encodes the rows as a batch, and clears them.
+   * @param output supplies the buffer to append the batch to.
+   */
+  void encode(Buffer::Instance& output);
+
+  // The index of the rows without a value in the string columns.
+  static constexpr uint32_t NoValue = 0xffffffff;
+
+private:
+  struct Column {
+    // The values and the validity bitmap of an int64 column.
+    std::vector<int64_t> values_;
+    std::vector<uint8_t> validity_;
+    // The dictionary and the indexes of a string column.
+    absl::flat_hash_map<std::string, uint32_t> dictionary_;
+    std::vector<uint32_t> indexes_;
+  };
+
+  void addInt64(Column& column, absl::optional<int64_t> value);
+  void addString(Column& column, absl::optional<absl::string_view> value);
+
+  const ColumnConfigsConstSharedPtr configs_;
+  std::vector<Column> columns_;
+  uint32_t rows_{};
+};
+
+/**
+ * Access log Instance that writes batches of rows to a file, each worker filling its own batch.
+ */
+class ColumnarAccessLog : public Common::ImplBase {
+public:
+  ColumnarAccessLog(const ColumnarAccessLogConfig& config, AccessLog::FilterPtr&& filter,
+                    AccessLog::AccessLogManager& log_manager, ThreadLocal::SlotAllocator& tls);
+
+private:
+  // The batch of a worker.
+  class ThreadLocalBatch : public ThreadLocal::ThreadLocalObject {
+  public:
+    ThreadLocalBatch(ColumnConfigsConstSharedPtr configs, uint32_t max_rows,
+                     std::chrono::milliseconds flush_interval,
+                     AccessLog::AccessLogFileSharedPtr log_file, Event::Dispatcher& dispatcher);
+    ~ThreadLocalBatch() override;
+
+    void log(const Http::RequestHeaderMap& request_headers,
+             const Http::ResponseHeaderMap& response_headers,
+             const StreamInfo::StreamInfo& stream_info);
+
+  private:
+    void flush();
+
+    RecordBatch batch_;
+    const uint32_t max_rows_;
+    const std::chrono::milliseconds flush_interval_;
+    const AccessLog::AccessLogFileSharedPtr log_file_;
+    const Event::TimerPtr flush_timer_;
+  };
+
+  // Common::ImplBase
+  void emitLog(const Http::RequestHeaderMap& request_headers,
+               const Http::ResponseHeaderMap& response_headers,
+               const Http::ResponseTrailerMap& response_trailers,
+               const StreamInfo::StreamInfo& stream_info) override;
+
+  ThreadLocal::SlotPtr tls_slot_;
+};
+
+} // namespace Columnar
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,42 @@
+#include "extensions/access_loggers/columnar/config.h"
+
+#include "envoy/extensions/access_loggers/columnar/v3/columnar.pb.h"
+#include "envoy/extensions/access_loggers/columnar/v3/columnar.pb.validate.h"
+#include "envoy/registry/registry.h"
+#include "envoy/server/filter_config.h"
+
+#include "common/protobuf/protobuf.h"
+
+#include "extensions/access_loggers/columnar/columnar_access_log_impl.h"
+#include "extensions/access_loggers/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Columnar {
+
+AccessLog::InstanceSharedPtr
+ColumnarAccessLogFactory::createAccessLogInstance(const Protobuf::Message& config,
+                                                  AccessLog::FilterPtr&& filter,
+                                                  Server::Configuration::FactoryContext& context) {
+  const auto& proto_config = MessageUtil::downcastAndValidate<const ColumnarAccessLogConfig&>(
+      config, context.messageValidationVisitor());
+  return std::make_shared<ColumnarAccessLog>(proto_config, std::move(filter),
+                                             context.accessLogManager(), context.threadLocal());
+}
+
+ProtobufTypes::MessagePtr ColumnarAccessLogFactory::createEmptyConfigProto() {
+  return std::make_unique<ColumnarAccessLogConfig>();
+}
+
+std::string ColumnarAccessLogFactory::name() const { return AccessLogNames::get().Columnar; }
+
+/**
+ * Static registration for the columnar access log. @see RegisterFactory.
+ */
+REGISTER_FACTORY(ColumnarAccessLogFactory, Server::Configuration::AccessLogInstanceFactory);
+
+} // namespace Columnar
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
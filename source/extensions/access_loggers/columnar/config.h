@@ -0,0 +1,27 @@
+#pragma once
+
+#include "envoy/server/access_log_config.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Columnar {
+
+/**
+ * Config registration for the columnar access log. @see AccessLogInstanceFactory.
+ */
+class ColumnarAccessLogFactory : public Server::Configuration::AccessLogInstanceFactory {
+public:
+  AccessLog::InstanceSharedPtr
+  createAccessLogInstance(const Protobuf::Message& config, AccessLog::FilterPtr&& filter,
+                          Server::Configuration::FactoryContext& context) override;
+
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override;
+
+  std::string name() const override;
+};
+
+} // namespace Columnar
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
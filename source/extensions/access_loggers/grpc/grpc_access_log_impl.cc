@@ -67,6 +67,9 @@ void GrpcAccessLoggerImpl::log(envoy::data::accesslog::v3::HTTPAccessLogEntry&&
 }
 
 void GrpcAccessLoggerImpl::log(envoy::data::accesslog::v3::TCPAccessLogEntry&& entry) {
+  if (!canLogMore()) {
+    return;
+  }
   approximate_message_size_bytes_ += entry.ByteSizeLong();
   message_.mutable_tcp_logs()->mutable_log_entry()->Add(std::move(entry));
   if (approximate_message_size_bytes_ >= max_buffer_size_bytes_) {
@@ -75,7 +78,7 @@ void GrpcAccessLoggerImpl::log(envoy::data::accesslog::v3::TCPAccessLogEntry&& e
 }
 
 void GrpcAccessLoggerImpl::flush() {
-  if (!message_.has_http_logs() && !message_.has_tcp_logs()) {
+  if (message_.http_logs().log_entry().empty() && message_.tcp_logs().log_entry().empty()) {
     // Nothing to flush.
     return;
   }
@@ -89,7 +92,15 @@ void GrpcAccessLoggerImpl::flush() {
   if (client_.log(message_)) {
     // Clear the message regardless of the success.
     approximate_message_size_bytes_ = 0;
-    message_.Clear();
+    // The entries are cleared rather than the whole message: the repeated field keeps the cleared
+    // entries, and the entries of the next batch are moved into them instead of being allocated.
+    message_.clear_identifier();
+    if (message_.has_http_logs()) {
+      message_.mutable_http_logs()->mutable_log_entry()->Clear();
+    }
+    if (message_.has_tcp_logs()) {
+      message_.mutable_tcp_logs()->mutable_log_entry()->Clear();
+    }
   }
 }
 
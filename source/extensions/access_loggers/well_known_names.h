@@ -14,6 +14,8 @@ namespace AccessLoggers {
  */
 class AccessLogNameValues {
 public:
+  // Columnar access log
+  const std::string Columnar = "envoy.access_loggers.columnar";
   // File access log
   const std::string File = "envoy.access_loggers.file";
   // HTTP gRPC access log
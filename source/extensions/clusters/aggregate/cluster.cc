@@ -38,23 +38,47 @@ AggregateClusterLoadBalancer::AggregateClusterLoadBalancer(
     }
 
     // Add callback for clusters initialized before aggregate cluster.
-    addMemberUpdateCallbackForCluster(*tlc);
+    addPriorityUpdateCallbackForCluster(cluster, *tlc);
   }
   refresh();
   handle_ = cluster_manager_.addThreadLocalClusterUpdateCallbacks(*this);
 }
 
-void AggregateClusterLoadBalancer::addMemberUpdateCallbackForCluster(
-    Upstream::ThreadLocalCluster& thread_local_cluster) {
-  thread_local_cluster.prioritySet().addMemberUpdateCb(
-      [this, target_cluster_info = thread_local_cluster.info()](const Upstream::HostVector&,
-                                                                const Upstream::HostVector&) {
-        ENVOY_LOG(debug, "member update for cluster '{}' in aggregate cluster '{}'",
-                  target_cluster_info->name(), parent_info_->name());
-        refresh();
+void AggregateClusterLoadBalancer::addPriorityUpdateCallbackForCluster(
+    const std::string& cluster_name, Upstream::ThreadLocalCluster& thread_local_cluster) {
+  thread_local_cluster.prioritySet().addPriorityUpdateCb(
+      [this, cluster_name, &thread_local_cluster](uint32_t priority,
+                                                  const Upstream::HostVector& hosts_added,
+                                                  const Upstream::HostVector& hosts_removed) {
+        onPriorityUpdate(cluster_name, thread_local_cluster, priority, hosts_added, hosts_removed);
       });
 }
 
+void AggregateClusterLoadBalancer::onPriorityUpdate(
+    const std::string& cluster_name, Upstream::ThreadLocalCluster& thread_local_cluster,
+    uint32_t priority, const Upstream::HostVector& hosts_added,
+    const Upstream::HostVector& hosts_removed) {
+  ENVOY_LOG(debug, "priority {} update for cluster '{}' in aggregate cluster '{}'", priority,
+            cluster_name, parent_info_->name());
+  const Upstream::HostSet& host_set =
+      *thread_local_cluster.prioritySet().hostSetsPerPriority()[priority];
+  const auto& linearized_priorities =
+      priority_context_->cluster_and_priority_to_linearized_priority_;
+  const auto it = linearized_priorities.find(std::make_pair(cluster_name, priority));
+  // While the priority stays non-empty, or empty, the other linearized priorities are unchanged.
+  if (it != linearized_priorities.end() && !host_set.hosts().empty()) {
+    // The load balancer recalculates the load of the updated priority.
+    priority_context_->priority_set_.updateHosts(
+        it->second, Upstream::HostSetImpl::updateHostsParams(host_set), host_set.localityWeights(),
+        hosts_added, hosts_removed, host_set.overprovisioningFactor());
+    return;
+  }
+  if (it == linearized_priorities.end() && host_set.hosts().empty()) {
+    return;
+  }
+  refresh();
+}
+
 PriorityContextPtr
 AggregateClusterLoadBalancer::linearizePrioritySet(OptRef<const std::string> excluded_cluster) {
   PriorityContextPtr priority_context = std::make_unique<PriorityContext>();
@@ -119,7 +143,7 @@ void AggregateClusterLoadBalancer::onClusterAddOrUpdate(Upstream::ThreadLocalClu
     ENVOY_LOG(debug, "adding or updating cluster '{}' for aggregate cluster '{}'",
               cluster.info()->name(), parent_info_->name());
     refresh();
-    addMemberUpdateCallbackForCluster(cluster);
+    addPriorityUpdateCallbackForCluster(cluster.info()->name(), cluster);
   }
 }
 
@@ -61,8 +61,9 @@ private:
   void startPreInit() override { onPreInitComplete(); }
 };
 
-// Load balancer used by each worker thread. It will be refreshed when clusters, hosts or priorities
-// are updated.
+// Load balancer used by each worker thread. It is rebuilt when clusters are added or removed, or
+// when a priority of a cluster becomes empty or non-empty. Other updates of the hosts of a priority
+// are applied in place to the linearized priority which it maps to.
 class AggregateClusterLoadBalancer : public Upstream::LoadBalancer,
                                      Upstream::ClusterUpdateCallbacks,
                                      Logger::Loggable<Logger::Id::upstream> {
@@ -115,7 +116,12 @@ private:
 
   using LoadBalancerImplPtr = std::unique_ptr<LoadBalancerImpl>;
 
-  void addMemberUpdateCallbackForCluster(Upstream::ThreadLocalCluster& thread_local_cluster);
+  void addPriorityUpdateCallbackForCluster(const std::string& cluster_name,
+                                           Upstream::ThreadLocalCluster& thread_local_cluster);
+  void onPriorityUpdate(const std::string& cluster_name,
+                        Upstream::ThreadLocalCluster& thread_local_cluster, uint32_t priority,
+                        const Upstream::HostVector& hosts_added,
+                        const Upstream::HostVector& hosts_removed);
   PriorityContextPtr linearizePrioritySet(OptRef<const std::string> excluded_cluster);
   void refresh(OptRef<const std::string> excluded_cluster = OptRef<const std::string>());
 
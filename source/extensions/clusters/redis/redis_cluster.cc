@@ -56,7 +56,7 @@ RedisCluster::RedisCluster(
       registration_handle_(refresh_manager_->registerCluster(
           cluster_name_, redirect_refresh_interval_, redirect_refresh_threshold_,
           failure_refresh_threshold_, host_degraded_refresh_threshold_, [&]() {
-            redis_discovery_session_.resolve_timer_->enableTimer(std::chrono::milliseconds(0));
+            redis_discovery_session_.triggerRefresh();
           })) {
   const auto& locality_lb_endpoints = load_assignment_.endpoints();
   for (const auto& locality_lb_endpoint : locality_lb_endpoints) {
@@ -353,14 +353,14 @@ void RedisCluster::RedisDiscoverySession::onResponse(
   }
 
   parent_.onClusterSlotUpdate(std::move(slots));
-  resolve_timer_->enableTimer(parent_.cluster_refresh_rate_);
+  scheduleRefresh();
 }
 
 void RedisCluster::RedisDiscoverySession::onUnexpectedResponse(
     const NetworkFilters::Common::Redis::RespValuePtr& value) {
   ENVOY_LOG(warn, "Unexpected response to cluster slot command: {}", value->toString());
   this->parent_.info_->stats().update_failure_.inc();
-  resolve_timer_->enableTimer(parent_.cluster_refresh_rate_);
+  scheduleRefresh();
 }
 
 void RedisCluster::RedisDiscoverySession::onFailure() {
@@ -370,7 +370,22 @@ void RedisCluster::RedisDiscoverySession::onFailure() {
     client_to_delete->second->client_->close();
   }
   parent_.info()->stats().update_failure_.inc();
-  resolve_timer_->enableTimer(parent_.cluster_refresh_rate_);
+  scheduleRefresh();
+}
+
+void RedisCluster::RedisDiscoverySession::triggerRefresh() {
+  if (current_request_) {
+    refresh_pending_ = true;
+    return;
+  }
+  resolve_timer_->enableTimer(std::chrono::milliseconds(0));
+}
+
+void RedisCluster::RedisDiscoverySession::scheduleRefresh() {
+  // The slots returned by a discovery sent before a refresh was triggered may be out of date.
+  resolve_timer_->enableTimer(refresh_pending_ ? std::chrono::milliseconds(0)
+                                               : parent_.cluster_refresh_rate_);
+  refresh_pending_ = false;
 }
 
 RedisCluster::ClusterSlotsRequest RedisCluster::ClusterSlotsRequest::instance_;
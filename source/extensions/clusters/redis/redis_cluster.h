@@ -215,6 +215,13 @@ private:
     // Start discovery against a random host from existing hosts
     void startResolveRedis();
 
+    // Refresh the slots now, or right after the discovery in flight. The refreshes triggered
+    // while a discovery is in flight are coalesced into a single one.
+    void triggerRefresh();
+
+    // Schedule the next discovery.
+    void scheduleRefresh();
+
     // Extensions::NetworkFilters::Common::Redis::Client::Config
     bool disableOutlierEvents() const override { return true; }
     std::chrono::milliseconds opTimeout() const override {
@@ -252,6 +259,7 @@ private:
     Event::Dispatcher& dispatcher_;
     std::string current_host_address_;
     Extensions::NetworkFilters::Common::Redis::Client::PoolRequest* current_request_{};
+    bool refresh_pending_{};
     absl::node_hash_map<std::string, RedisDiscoveryClientPtr> client_map_;
 
     std::list<Network::Address::InstanceConstSharedPtr> discovery_address_list_;
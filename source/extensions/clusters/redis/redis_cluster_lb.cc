@@ -24,38 +24,123 @@ bool RedisClusterLoadBalancerFactory::onClusterSlotUpdate(ClusterSlotsPtr&& slot
     return false;
   }
 
-  auto updated_slots = std::make_shared<SlotArray>();
-  auto shard_vector = std::make_shared<std::vector<RedisShardSharedPtr>>();
-  absl::flat_hash_map<std::string, uint64_t> shards;
+  SlotArraySharedPtr current_slot_array;
+  ShardVectorSharedPtr current_shard_vector;
+  {
+    absl::ReaderMutexLock lock(&mutex_);
+    current_slot_array = slot_array_;
+    current_shard_vector = shard_vector_;
+  }
+
+  // The index of the shard of each current primary.
+  absl::flat_hash_map<std::string, uint64_t> current_shards;
+  if (current_shard_vector) {
+    for (uint64_t i = 0; i < current_shard_vector->size(); ++i) {
+      current_shards.emplace((*current_shard_vector)[i]->primary()->address()->asString(), i);
+    }
+  }
 
+  // The primaries keep the index of their shard where it is still in range, so that the slot
+  // ranges which did not move keep their entries in the slot array, and the other primaries take
+  // the free indexes in the order they first appear in.
+  absl::flat_hash_map<std::string, uint64_t> shards;
+  std::vector<const ClusterSlot*> first_slots;
   for (const ClusterSlot& slot : *slots) {
+    if (shards.try_emplace(slot.primary()->asString(), 0).second) {
+      first_slots.push_back(&slot);
+    }
+  }
+  const uint64_t shard_count = first_slots.size();
+  std::vector<bool> taken(shard_count, false);
+  for (auto& shard : shards) {
+    const auto current = current_shards.find(shard.first);
+    if (current != current_shards.end() && current->second < shard_count) {
+      shard.second = current->second;
+      taken[current->second] = true;
+    } else {
+      shard.second = shard_count;
+    }
+  }
+  uint64_t next_free_index = 0;
+  for (const ClusterSlot* slot : first_slots) {
+    uint64_t& index = shards[slot->primary()->asString()];
+    if (index == shard_count) {
+      while (taken[next_free_index]) {
+        ++next_free_index;
+      }
+      index = next_free_index;
+      taken[index] = true;
+    }
+  }
+
+  auto shard_vector = std::make_shared<std::vector<RedisShardSharedPtr>>(shard_count);
+  for (const ClusterSlot* slot : first_slots) {
     // look in the updated map
-    const std::string primary_address = slot.primary()->asString();
+    const std::string primary_address = slot->primary()->asString();
+    auto primary_host = all_hosts.find(primary_address);
+    ASSERT(primary_host != all_hosts.end(),
+           "we expect all address to be found in the updated_hosts");
+
+    Upstream::HostVectorSharedPtr primary_and_replicas = std::make_shared<Upstream::HostVector>();
+    Upstream::HostVectorSharedPtr replicas = std::make_shared<Upstream::HostVector>();
+    primary_and_replicas->push_back(primary_host->second);
 
-    auto result = shards.try_emplace(primary_address, shard_vector->size());
-    if (result.second) {
-      auto primary_host = all_hosts.find(primary_address);
-      ASSERT(primary_host != all_hosts.end(),
+    for (auto const& replica : slot->replicas()) {
+      auto replica_host = all_hosts.find(replica->asString());
+      ASSERT(replica_host != all_hosts.end(),
              "we expect all address to be found in the updated_hosts");
+      replicas->push_back(replica_host->second);
+      primary_and_replicas->push_back(replica_host->second);
+    }
 
-      Upstream::HostVectorSharedPtr primary_and_replicas = std::make_shared<Upstream::HostVector>();
-      Upstream::HostVectorSharedPtr replicas = std::make_shared<Upstream::HostVector>();
-      primary_and_replicas->push_back(primary_host->second);
+    // A shard whose hosts did not change is kept, rather than rebuilding its host sets.
+    RedisShardSharedPtr& shard = (*shard_vector)[shards[primary_address]];
+    const auto current = current_shards.find(primary_address);
+    if (current != current_shards.end() &&
+        sameHosts(*(*current_shard_vector)[current->second], primary_host->second, *replicas)) {
+      shard = (*current_shard_vector)[current->second];
+    } else {
+      shard = std::make_shared<RedisShard>(primary_host->second, replicas, primary_and_replicas);
+    }
+  }
 
-      for (auto const& replica : slot.replicas()) {
-        auto replica_host = all_hosts.find(replica->asString());
-        ASSERT(replica_host != all_hosts.end(),
-               "we expect all address to be found in the updated_hosts");
-        replicas->push_back(replica_host->second);
-        primary_and_replicas->push_back(replica_host->second);
+  // Only the slot ranges which changed, or moved to another index, are written over a copy of the
+  // current slot array. The slots no longer served by any range are reset to the first shard.
+  absl::flat_hash_set<std::pair<int64_t, int64_t>> unchanged_ranges;
+  if (current_cluster_slot_ != nullptr && current_slot_array != nullptr) {
+    absl::flat_hash_map<std::pair<int64_t, int64_t>, std::string> current_ranges;
+    for (const ClusterSlot& slot : *current_cluster_slot_) {
+      current_ranges.emplace(std::make_pair(slot.start(), slot.end()), slot.primary()->asString());
+    }
+    for (const ClusterSlot& slot : *slots) {
+      const auto range = std::make_pair(slot.start(), slot.end());
+      const auto current = current_ranges.find(range);
+      const std::string primary_address = slot.primary()->asString();
+      if (current != current_ranges.end() && current->second == primary_address &&
+          current_slot_array->at(slot.start()) == shards[primary_address]) {
+        unchanged_ranges.insert(range);
       }
-
-      shard_vector->emplace_back(
-          std::make_shared<RedisShard>(primary_host->second, replicas, primary_and_replicas));
     }
+  }
 
-    for (auto i = slot.start(); i <= slot.end(); ++i) {
-      updated_slots->at(i) = result.first->second;
+  auto updated_slots = current_slot_array != nullptr
+                           ? std::make_shared<SlotArray>(*current_slot_array)
+                           : std::make_shared<SlotArray>();
+  if (current_cluster_slot_ != nullptr && current_slot_array != nullptr) {
+    for (const ClusterSlot& slot : *current_cluster_slot_) {
+      if (!unchanged_ranges.contains(std::make_pair(slot.start(), slot.end()))) {
+        for (auto i = slot.start(); i <= slot.end(); ++i) {
+          updated_slots->at(i) = 0;
+        }
+      }
+    }
+  }
+  for (const ClusterSlot& slot : *slots) {
+    if (!unchanged_ranges.contains(std::make_pair(slot.start(), slot.end()))) {
+      const uint64_t index = shards[slot.primary()->asString()];
+      for (auto i = slot.start(); i <= slot.end(); ++i) {
+        updated_slots->at(i) = index;
+      }
     }
   }
 
@@ -68,6 +153,18 @@ bool RedisClusterLoadBalancerFactory::onClusterSlotUpdate(ClusterSlotsPtr&& slot
   return true;
 }
 
+bool RedisClusterLoadBalancerFactory::sameHosts(const RedisShard& shard,
+                                                const Upstream::HostSharedPtr& primary,
+                                                const Upstream::HostVector& replicas) {
+  if (shard.primary() != primary || shard.replicas().hosts().size() != replicas.size()) {
+    return false;
+  }
+  const Upstream::HostVector& shard_replicas = shard.replicas().hosts();
+  return std::all_of(replicas.begin(), replicas.end(), [&](const Upstream::HostSharedPtr& host) {
+    return std::find(shard_replicas.begin(), shard_replicas.end(), host) != shard_replicas.end();
+  });
+}
+
 void RedisClusterLoadBalancerFactory::onHostHealthUpdate() {
   ShardVectorSharedPtr current_shard_vector;
   {
@@ -199,6 +199,10 @@ private:
     Random::RandomGenerator& random_;
   };
 
+  // Whether a shard has the given primary and replica hosts.
+  static bool sameHosts(const RedisShard& shard, const Upstream::HostSharedPtr& primary,
+                        const Upstream::HostVector& replicas);
+
   absl::Mutex mutex_;
   SlotArraySharedPtr slot_array_ ABSL_GUARDED_BY(mutex_);
   ClusterSlotsSharedPtr current_cluster_slot_;
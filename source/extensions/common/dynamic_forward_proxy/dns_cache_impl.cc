@@ -17,10 +17,14 @@ namespace DynamicForwardProxy {
 DnsCacheImpl::DnsCacheImpl(
     Event::Dispatcher& main_thread_dispatcher, ThreadLocal::SlotAllocator& tls,
     Random::RandomGenerator& random, Runtime::Loader& loader, Stats::Scope& root_scope,
-    const envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig& config)
+    const envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig& config,
+    Network::DnsResolverSharedPtr shared_resolver)
     : main_thread_dispatcher_(main_thread_dispatcher),
       dns_lookup_family_(Upstream::getDnsLookupFamilyFromEnum(config.dns_lookup_family())),
-      resolver_(main_thread_dispatcher.createDnsResolver({}, config.use_tcp_for_dns_lookups())),
+      resolver_(shared_resolver != nullptr && !config.use_tcp_for_dns_lookups()
+                    ? std::move(shared_resolver)
+                    : main_thread_dispatcher.createDnsResolver({},
+                                                               config.use_tcp_for_dns_lookups())),
       tls_slot_(tls), scope_(root_scope.createScope(fmt::format("dns_cache.{}.", config.name()))),
       stats_(generateDnsCacheStats(*scope_)),
       resource_manager_(*scope_, loader, config.name(), config.dns_cache_circuit_breaker()),
@@ -30,14 +34,18 @@ DnsCacheImpl::DnsCacheImpl(
               envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig>(
               config, refresh_interval_.count(), random)),
       host_ttl_(PROTOBUF_GET_MS_OR_DEFAULT(config, host_ttl, 300000)),
-      max_hosts_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_hosts, 1024)) {
+      max_hosts_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_hosts, 1024)),
+      evict_least_recently_used_hosts_(config.evict_least_recently_used_hosts()) {
   tls_slot_.set([&](Event::Dispatcher&) { return std::make_shared<ThreadLocalHostInfo>(*this); });
 }
 
 DnsCacheImpl::~DnsCacheImpl() {
-  for (const auto& primary_host : primary_hosts_) {
-    if (primary_host.second->active_query_ != nullptr) {
-      primary_host.second->active_query_->cancel();
+  for (auto& shard : host_shards_) {
+    absl::ReaderMutexLock reader_lock{&shard.lock_};
+    for (const auto& primary_host : shard.hosts_) {
+      if (primary_host.second->active_query_ != nullptr) {
+        primary_host.second->active_query_->cancel();
+      }
     }
   }
 
@@ -58,11 +66,13 @@ DnsCacheImpl::loadDnsCacheEntry(absl::string_view host, uint16_t default_port,
 
   auto [cache_hit, is_overflow] = [&]() {
     // TODO(chradcliffe): Consider returning the looked-up host
-    absl::ReaderMutexLock read_lock{&primary_hosts_lock_};
-    auto tls_host = primary_hosts_.find(host);
+    HostShard& shard = hostShard(host);
+    absl::ReaderMutexLock read_lock{&shard.lock_};
+    auto tls_host = shard.hosts_.find(host);
     bool cache_hit =
-        tls_host != primary_hosts_.end() && tls_host->second->host_info_->firstResolveComplete();
-    bool is_overflow = primary_hosts_.size() >= max_hosts_;
+        tls_host != shard.hosts_.end() && tls_host->second->host_info_->firstResolveComplete();
+    // A full cache that evicts hosts makes room for the host in the main thread.
+    bool is_overflow = !evict_least_recently_used_hosts_ && num_primary_hosts_ >= max_hosts_;
     return std::make_tuple(cache_hit, is_overflow);
   }();
 
@@ -98,11 +108,13 @@ DnsCacheImpl::canCreateDnsRequest(ResourceLimitOptRef pending_requests) {
 }
 
 void DnsCacheImpl::iterateHostMap(IterateHostMapCb iterate_callback) {
-  absl::ReaderMutexLock reader_lock{&primary_hosts_lock_};
-  for (const auto& host : primary_hosts_) {
-    // Only include hosts that have ever resolved to an address.
-    if (host.second->host_info_->address() != nullptr) {
-      iterate_callback(host.first, host.second->host_info_);
+  for (auto& shard : host_shards_) {
+    absl::ReaderMutexLock reader_lock{&shard.lock_};
+    for (const auto& host : shard.hosts_) {
+      // Only include hosts that have ever resolved to an address.
+      if (host.second->host_info_->address() != nullptr) {
+        iterate_callback(host.first, host.second->host_info_);
+      }
     }
   }
 }
@@ -110,9 +122,10 @@ void DnsCacheImpl::iterateHostMap(IterateHostMapCb iterate_callback) {
 absl::optional<const DnsHostInfoSharedPtr> DnsCacheImpl::getHost(absl::string_view host_name) {
   // Find a host with the given name.
   const auto host_info = [&]() -> const DnsHostInfoSharedPtr {
-    absl::ReaderMutexLock reader_lock{&primary_hosts_lock_};
-    auto it = primary_hosts_.find(host_name);
-    return it != primary_hosts_.end() ? it->second->host_info_ : nullptr;
+    HostShard& shard = hostShard(host_name);
+    absl::ReaderMutexLock reader_lock{&shard.lock_};
+    auto it = shard.hosts_.find(host_name);
+    return it != shard.hosts_.end() ? it->second->host_info_ : nullptr;
   }();
 
   // Only include hosts that have ever resolved to an address.
@@ -135,27 +148,26 @@ void DnsCacheImpl::startCacheLoad(const std::string& host, uint16_t default_port
   // already in the map it's either in the process of being resolved or the resolution is already
   // heading out to the worker threads. Either way the pending resolution will be completed.
 
-  // Functions like this one that modify primary_hosts_ are only called in the main thread so we
-  // know it is safe to use the PrimaryHostInfo pointers outside of the lock.
-  auto* primary_host = [&]() {
-    absl::ReaderMutexLock reader_lock{&primary_hosts_lock_};
-    auto host_it = primary_hosts_.find(host);
-    return host_it != primary_hosts_.end() ? host_it->second.get() : nullptr;
-  }();
+  auto* primary_host = findPrimaryHost(host);
 
   if (primary_host) {
     ENVOY_LOG(debug, "main thread resolve for host '{}' skipped. Entry present", host);
     return;
   }
 
+  if (evict_least_recently_used_hosts_ && num_primary_hosts_ >= max_hosts_) {
+    evictPrimaryHost();
+  }
+
   const auto host_attributes = Http::Utility::parseAuthority(host);
 
   // TODO(mattklein123): Right now, the same host with different ports will become two
   // independent primary hosts with independent DNS resolutions. I'm not sure how much this will
   // matter, but we could consider collapsing these down and sharing the underlying DNS resolution.
   {
-    absl::WriterMutexLock writer_lock{&primary_hosts_lock_};
-    primary_host = primary_hosts_
+    HostShard& shard = hostShard(host);
+    absl::WriterMutexLock writer_lock{&shard.lock_};
+    primary_host = shard.hosts_
                        // try_emplace() is used here for direct argument forwarding.
                        .try_emplace(host, std::make_unique<PrimaryHostInfo>(
                                               *this, std::string(host_attributes.host_),
@@ -164,6 +176,9 @@ void DnsCacheImpl::startCacheLoad(const std::string& host, uint16_t default_port
                                               [this, host]() { onReResolve(host); }))
                        .first->second.get();
   }
+  primary_host->eviction_it_ = eviction_queue_.insert(eviction_queue_.end(), host);
+  primary_host->eviction_check_time_ = primary_host->host_info_->lastUsedTime();
+  ++num_primary_hosts_;
 
   startResolve(host, *primary_host);
 }
@@ -175,14 +190,8 @@ void DnsCacheImpl::onReResolve(const std::string& host) {
   // use-after-free issues
   PrimaryHostInfoPtr host_to_erase;
 
-  // Functions like this one that modify primary_hosts_ are only called in the main thread so we
-  // know it is safe to use the PrimaryHostInfo pointers outside of the lock.
-  auto* primary_host = [&]() {
-    absl::ReaderMutexLock reader_lock{&primary_hosts_lock_};
-    const auto primary_host_it = primary_hosts_.find(host);
-    ASSERT(primary_host_it != primary_hosts_.end());
-    return primary_host_it->second.get();
-  }();
+  auto* primary_host = findPrimaryHost(host);
+  ASSERT(primary_host != nullptr);
 
   const std::chrono::steady_clock::duration now_duration =
       main_thread_dispatcher_.timeSource().monotonicTime().time_since_epoch();
@@ -197,19 +206,69 @@ void DnsCacheImpl::onReResolve(const std::string& host) {
     if (primary_host->host_info_->address()) {
       runRemoveCallbacks(host);
     }
-    {
-      absl::WriterMutexLock writer_lock{&primary_hosts_lock_};
-      auto host_it = primary_hosts_.find(host);
-      ASSERT(host_it != primary_hosts_.end());
-      host_to_erase = std::move(host_it->second);
-      primary_hosts_.erase(host_it);
-    }
+    host_to_erase = removePrimaryHost(host);
     notifyThreads(host);
   } else {
     startResolve(host, *primary_host);
   }
 }
 
+DnsCacheImpl::PrimaryHostInfo* DnsCacheImpl::findPrimaryHost(absl::string_view host) {
+  ASSERT(main_thread_dispatcher_.isThreadSafe());
+  HostShard& shard = hostShard(host);
+  absl::ReaderMutexLock reader_lock{&shard.lock_};
+  auto host_it = shard.hosts_.find(host);
+  return host_it != shard.hosts_.end() ? host_it->second.get() : nullptr;
+}
+
+DnsCacheImpl::PrimaryHostInfoPtr DnsCacheImpl::removePrimaryHost(const std::string& host) {
+  ASSERT(main_thread_dispatcher_.isThreadSafe());
+  PrimaryHostInfoPtr primary_host;
+  {
+    HostShard& shard = hostShard(host);
+    absl::WriterMutexLock writer_lock{&shard.lock_};
+    auto host_it = shard.hosts_.find(host);
+    ASSERT(host_it != shard.hosts_.end());
+    primary_host = std::move(host_it->second);
+    shard.hosts_.erase(host_it);
+  }
+  eviction_queue_.erase(primary_host->eviction_it_);
+  --num_primary_hosts_;
+  return primary_host;
+}
+
+void DnsCacheImpl::evictPrimaryHost() {
+  // Each host is checked at most twice: a host that goes to the back of the queue was checked at
+  // the current time, so it is evicted when it is checked again unless it is used in between.
+  for (size_t checks = 2 * eviction_queue_.size(); checks > 0; --checks) {
+    const std::string host = eviction_queue_.front();
+    auto* primary_host = findPrimaryHost(host);
+    ASSERT(primary_host != nullptr);
+    const auto last_used_time = primary_host->host_info_->lastUsedTime();
+    // Hosts that have not resolved yet have pending loads, which eviction would fail.
+    if (last_used_time > primary_host->eviction_check_time_ ||
+        !primary_host->host_info_->firstResolveComplete()) {
+      primary_host->eviction_check_time_ =
+          main_thread_dispatcher_.timeSource().monotonicTime().time_since_epoch();
+      eviction_queue_.splice(eviction_queue_.end(), eviction_queue_, primary_host->eviction_it_);
+      continue;
+    }
+
+    ENVOY_LOG(debug, "host='{}' evicted", host);
+    stats_.host_evicted_.inc();
+    if (primary_host->active_query_ != nullptr) {
+      primary_host->active_query_->cancel();
+      primary_host->active_query_ = nullptr;
+    }
+    if (primary_host->host_info_->address()) {
+      runRemoveCallbacks(host);
+    }
+    removePrimaryHost(host);
+    notifyThreads(host);
+    return;
+  }
+}
+
 void DnsCacheImpl::startResolve(const std::string& host, PrimaryHostInfo& host_info) {
   ENVOY_LOG(debug, "starting main thread resolve for host='{}' dns='{}' port='{}'", host,
             host_info.host_info_->resolvedHost(), host_info.port_);
@@ -231,14 +290,8 @@ void DnsCacheImpl::finishResolve(const std::string& host,
   ASSERT(main_thread_dispatcher_.isThreadSafe());
   ENVOY_LOG(debug, "main thread resolve complete for host '{}'. {} results", host, response.size());
 
-  // Functions like this one that modify primary_hosts_ are only called in the main thread so we
-  // know it is safe to use the PrimaryHostInfo pointers outside of the lock.
-  auto* primary_host_info = [&]() {
-    absl::ReaderMutexLock reader_lock{&primary_hosts_lock_};
-    const auto primary_host_it = primary_hosts_.find(host);
-    ASSERT(primary_host_it != primary_hosts_.end());
-    return primary_host_it->second.get();
-  }();
+  auto* primary_host_info = findPrimaryHost(host);
+  ASSERT(primary_host_info != nullptr);
 
   const bool first_resolve = !primary_host_info->host_info_->firstResolveComplete();
   primary_host_info->active_query_ = nullptr;
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <list>
+#include <string>
+
 #include "envoy/common/backoff_strategy.h"
 #include "envoy/extensions/common/dynamic_forward_proxy/v3/dns_cache.pb.h"
 #include "envoy/http/filter.h"
@@ -12,6 +17,7 @@
 #include "extensions/common/dynamic_forward_proxy/dns_cache_resource_manager.h"
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -26,6 +32,7 @@ namespace DynamicForwardProxy {
   COUNTER(dns_query_failure)                                                                       \
   COUNTER(dns_query_success)                                                                       \
   COUNTER(host_added)                                                                              \
+  COUNTER(host_evicted)                                                                            \
   COUNTER(host_address_changed)                                                                    \
   COUNTER(host_overflow)                                                                           \
   COUNTER(host_removed)                                                                            \
@@ -41,9 +48,14 @@ struct DnsCacheStats {
 
 class DnsCacheImpl : public DnsCache, Logger::Loggable<Logger::Id::forward_proxy> {
 public:
+  /**
+   * @param shared_resolver the DNS resolution cache of the server, which the cache uses instead of
+   *        a resolver of its own unless the config asks for DNS lookups over TCP. May be nullptr.
+   */
   DnsCacheImpl(Event::Dispatcher& main_thread_dispatcher, ThreadLocal::SlotAllocator& tls,
                Random::RandomGenerator& random, Runtime::Loader& loader, Stats::Scope& root_scope,
-               const envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig& config);
+               const envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig& config,
+               Network::DnsResolverSharedPtr shared_resolver = nullptr);
   ~DnsCacheImpl() override;
   static DnsCacheStats generateDnsCacheStats(Stats::Scope& scope);
 
@@ -137,12 +149,24 @@ private:
     const Event::TimerPtr refresh_timer_;
     const DnsHostInfoImplSharedPtr host_info_;
     Network::ActiveDnsQuery* active_query_{};
+    // The position of the host in eviction_queue_, and the time the eviction last checked whether
+    // the host was used.
+    std::list<std::string>::iterator eviction_it_;
+    std::chrono::steady_clock::duration eviction_check_time_;
   };
 
   // Hold PrimaryHostInfo by shared_ptr to avoid having to hold the map mutex while updating
   // individual entries.
   using PrimaryHostInfoPtr = std::unique_ptr<PrimaryHostInfo>;
 
+  // The primary hosts are sharded by the hash of their name, so that the lookups of the workers
+  // only contend with the updates of the hosts of the same shard.
+  static constexpr uint32_t NumHostShards = 16;
+  struct HostShard {
+    absl::Mutex lock_;
+    absl::flat_hash_map<std::string, PrimaryHostInfoPtr> hosts_ ABSL_GUARDED_BY(lock_);
+  };
+
   struct AddUpdateCallbacksHandleImpl : public AddUpdateCallbacksHandle,
                                         RaiiListElement<AddUpdateCallbacksHandleImpl*> {
     AddUpdateCallbacksHandleImpl(std::list<AddUpdateCallbacksHandleImpl*>& parent,
@@ -154,14 +178,24 @@ private:
 
   void startCacheLoad(const std::string& host, uint16_t default_port);
 
-  void startResolve(const std::string& host, PrimaryHostInfo& host_info)
-      ABSL_LOCKS_EXCLUDED(primary_hosts_lock_);
+  void startResolve(const std::string& host, PrimaryHostInfo& host_info);
   void finishResolve(const std::string& host, Network::DnsResolver::ResolutionStatus status,
                      std::list<Network::DnsResponse>&& response);
   void runAddUpdateCallbacks(const std::string& host, const DnsHostInfoSharedPtr& host_info);
   void runRemoveCallbacks(const std::string& host);
   void notifyThreads(const std::string& host);
   void onReResolve(const std::string& host);
+  HostShard& hostShard(absl::string_view host) {
+    return host_shards_[absl::Hash<absl::string_view>()(host) % NumHostShards];
+  }
+  // Functions like this one that modify the primary hosts are only called in the main thread so we
+  // know it is safe to use the PrimaryHostInfo pointers outside of the lock.
+  PrimaryHostInfo* findPrimaryHost(absl::string_view host);
+  PrimaryHostInfoPtr removePrimaryHost(const std::string& host);
+  // Removes the resolved host that was least recently used, in the order of a second chance
+  // (CLOCK) approximation of LRU: a host that was used since it was last checked goes to the back
+  // of the queue instead.
+  void evictPrimaryHost();
 
   Event::Dispatcher& main_thread_dispatcher_;
   const Network::DnsLookupFamily dns_lookup_family_;
@@ -170,14 +204,16 @@ private:
   Stats::ScopePtr scope_;
   DnsCacheStats stats_;
   std::list<AddUpdateCallbacksHandleImpl*> update_callbacks_;
-  absl::Mutex primary_hosts_lock_;
-  absl::flat_hash_map<std::string, PrimaryHostInfoPtr>
-      primary_hosts_ ABSL_GUARDED_BY(primary_hosts_lock_);
+  // The names of the primary hosts in the order of the eviction. Only used in the main thread.
+  std::list<std::string> eviction_queue_;
+  std::array<HostShard, NumHostShards> host_shards_;
+  std::atomic<uint32_t> num_primary_hosts_{};
   DnsCacheResourceManagerImpl resource_manager_;
   const std::chrono::milliseconds refresh_interval_;
   const BackOffStrategyPtr failure_backoff_strategy_;
   const std::chrono::milliseconds host_ttl_;
   const uint32_t max_hosts_;
+  const bool evict_least_recently_used_hosts_;
 };
 
 } // namespace DynamicForwardProxy
@@ -2,6 +2,7 @@
 
 #include "envoy/extensions/common/dynamic_forward_proxy/v3/dns_cache.pb.h"
 
+#include "common/network/caching_dns_resolver.h"
 #include "common/protobuf/protobuf.h"
 
 #include "extensions/common/dynamic_forward_proxy/dns_cache_impl.h"
@@ -28,7 +29,7 @@ DnsCacheSharedPtr DnsCacheManagerImpl::getCache(
   }
 
   DnsCacheSharedPtr new_cache = std::make_shared<DnsCacheImpl>(
-      main_thread_dispatcher_, tls_, random_, loader_, root_scope_, config);
+      main_thread_dispatcher_, tls_, random_, loader_, root_scope_, config, shared_resolver_);
   caches_.emplace(config.name(), ActiveCache{config, new_cache});
   return new_cache;
 }
@@ -40,9 +41,10 @@ DnsCacheManagerSharedPtr getCacheManager(Singleton::Manager& singleton_manager,
                                          Stats::Scope& root_scope) {
   return singleton_manager.getTyped<DnsCacheManager>(
       SINGLETON_MANAGER_REGISTERED_NAME(dns_cache_manager),
-      [&main_thread_dispatcher, &tls, &random, &loader, &root_scope] {
-        return std::make_shared<DnsCacheManagerImpl>(main_thread_dispatcher, tls, random, loader,
-                                                     root_scope);
+      [&singleton_manager, &main_thread_dispatcher, &tls, &random, &loader, &root_scope] {
+        return std::make_shared<DnsCacheManagerImpl>(
+            main_thread_dispatcher, tls, random, loader, root_scope,
+            Network::CachingDnsResolver::get(singleton_manager));
       });
 }
 
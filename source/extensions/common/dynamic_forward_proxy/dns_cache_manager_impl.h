@@ -15,9 +15,9 @@ class DnsCacheManagerImpl : public DnsCacheManager, public Singleton::Instance {
 public:
   DnsCacheManagerImpl(Event::Dispatcher& main_thread_dispatcher, ThreadLocal::SlotAllocator& tls,
                       Random::RandomGenerator& random, Runtime::Loader& loader,
-                      Stats::Scope& root_scope)
+                      Stats::Scope& root_scope, Network::DnsResolverSharedPtr shared_resolver)
       : main_thread_dispatcher_(main_thread_dispatcher), tls_(tls), random_(random),
-        loader_(loader), root_scope_(root_scope) {}
+        loader_(loader), root_scope_(root_scope), shared_resolver_(std::move(shared_resolver)) {}
 
   // DnsCacheManager
   DnsCacheSharedPtr getCache(
@@ -38,6 +38,8 @@ private:
   Random::RandomGenerator& random_;
   Runtime::Loader& loader_;
   Stats::Scope& root_scope_;
+  // The DNS resolution cache of the server, if it has one.
+  const Network::DnsResolverSharedPtr shared_resolver_;
   absl::flat_hash_map<std::string, ActiveCache> caches_;
 };
 
@@ -0,0 +1,169 @@
+#include "extensions/common/tap/buffered_file_sink.h"
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/lock_guard.h"
+#include "common/common/logger.h"
+#include "common/protobuf/protobuf.h"
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Tap {
+namespace {
+
+uint64_t roundUpToPowerOfTwo(uint32_t size) {
+  uint64_t rounded = 1;
+  while (rounded < size) {
+    rounded <<= 1;
+  }
+  return rounded;
+}
+
+} // namespace
+
+TraceRing::TraceRing(uint32_t size)
+    : mask_(roundUpToPowerOfTwo(size) - 1), cells_(new Cell[mask_ + 1]) {
+  for (uint64_t i = 0; i <= mask_; ++i) {
+    cells_[i].sequence_.store(i, std::memory_order_relaxed);
+    cells_[i].trace_ = nullptr;
+  }
+}
+
+TraceRing::~TraceRing() {
+  while (pop() != nullptr) {
+  }
+}
+
+bool TraceRing::push(TraceWrapperPtr& trace) {
+  uint64_t position = enqueue_position_.load(std::memory_order_relaxed);
+  Cell* cell;
+  while (true) {
+    cell = &cells_[position & mask_];
+    const int64_t difference =
+        static_cast<int64_t>(cell->sequence_.load(std::memory_order_acquire) - position);
+    if (difference == 0) {
+      // The cell is free for this position, which is taken unless another producer took it.
+      if (enqueue_position_.compare_exchange_weak(position, position + 1,
+                                                  std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      // The cell still holds the trace of the previous lap.
+      return false;
+    } else {
+      position = enqueue_position_.load(std::memory_order_relaxed);
+    }
+  }
+  cell->trace_ = trace.release();
+  cell->sequence_.store(position + 1, std::memory_order_release);
+  return true;
+}
+
+TraceWrapperPtr TraceRing::pop() {
+  uint64_t position = dequeue_position_.load(std::memory_order_relaxed);
+  Cell* cell;
+  while (true) {
+    cell = &cells_[position & mask_];
+    const int64_t difference =
+        static_cast<int64_t>(cell->sequence_.load(std::memory_order_acquire) - (position + 1));
+    if (difference == 0) {
+      if (dequeue_position_.compare_exchange_weak(position, position + 1,
+                                                  std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      return nullptr;
+    } else {
+      position = dequeue_position_.load(std::memory_order_relaxed);
+    }
+  }
+  TraceWrapperPtr trace(cell->trace_);
+  // The cell is free again for the producers of the next lap.
+  cell->sequence_.store(position + mask_ + 1, std::memory_order_release);
+  return trace;
+}
+
+BufferedFileSink::BufferedFileSink(const envoy::config::tap::v3::BufferedFileSink& config,
+                                   Thread::ThreadFactory& thread_factory) {
+  // When reading and writing binary files, we need to be sure std::ios_base::binary
+  // is set, otherwise we will not get the expected results on Windows
+  output_file_.open(config.path(), std::ios_base::binary | std::ios_base::trunc);
+  if (!output_file_.is_open()) {
+    throw EnvoyException(fmt::format("cannot open tap file {}", config.path()));
+  }
+  const uint32_t ring_size = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, ring_size, DefaultRingSize);
+  for (auto& ring : rings_) {
+    ring = std::make_unique<TraceRing>(ring_size);
+  }
+  thread_ = thread_factory.createThread([this]() { run(); }, Thread::Options{"tap_sink"});
+}
+
+BufferedFileSink::~BufferedFileSink() {
+  {
+    Thread::LockGuard guard(mutex_);
+    shutdown_ = true;
+  }
+  shutdown_signal_.notifyOne();
+  thread_->join();
+}
+
+TraceRing& BufferedFileSink::threadRing() {
+  static std::atomic<uint32_t> next_ring{0};
+  static thread_local const uint32_t ring = next_ring++ % NumRings;
+  return *rings_[ring];
+}
+
+void BufferedFileSink::BufferedFileSinkHandle::submitTrace(
+    TraceWrapperPtr&& trace, envoy::config::tap::v3::OutputSink::Format format) {
+  ASSERT(format == envoy::config::tap::v3::OutputSink::PROTO_BINARY_LENGTH_DELIMITED);
+  if (!parent_.threadRing().push(trace)) {
+    const uint64_t dropped = ++parent_.dropped_traces_;
+    ENVOY_LOG_EVERY_POW_2_MISC(warn, "tap ring full, {} traces dropped so far", dropped);
+  }
+}
+
+bool BufferedFileSink::drain() {
+  uint64_t written = 0;
+  {
+    Protobuf::io::OstreamOutputStream stream(&output_file_);
+    Protobuf::io::CodedOutputStream coded_stream(&stream);
+    for (auto& ring : rings_) {
+      for (TraceWrapperPtr trace = ring->pop(); trace != nullptr; trace = ring->pop()) {
+        coded_stream.WriteVarint32(trace->ByteSize());
+        trace->SerializeWithCachedSizes(&coded_stream);
+        ++written;
+      }
+    }
+  }
+  if (written == 0) {
+    return false;
+  }
+  output_file_.flush();
+  written_traces_.fetch_add(written, std::memory_order_relaxed);
+  return true;
+}
+
+void BufferedFileSink::run() {
+  while (true) {
+    if (drain()) {
+      continue;
+    }
+    Thread::LockGuard guard(mutex_);
+    if (shutdown_) {
+      break;
+    }
+    shutdown_signal_.waitFor(mutex_, DrainInterval);
+  }
+  // The traces queued before the shutdown are written too.
+  while (drain()) {
+  }
+}
+
+} // namespace Tap
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+
+#include "envoy/config/tap/v3/common.pb.h"
+#include "envoy/data/tap/v3/wrapper.pb.h"
+#include "envoy/thread/thread.h"
+
+#include "common/common/non_copyable.h"
+#include "common/common/thread.h"
+
+#include "extensions/common/tap/tap.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Tap {
+
+/**
+ * A bounded lock-free queue of traces, from the Vyukov bounded MPMC queue: each cell holds a
+ * sequence number telling the producers and the consumers whose turn it is to use the cell.
+ */
+class TraceRing : NonCopyable {
+public:
+  // The size is rounded up to a power of two.
+  explicit TraceRing(uint32_t size);
+  ~TraceRing();
+
+  /**
+   * Queues a trace.
+   * @param trace supplies the trace, which is only moved from if it is queued.
+   * @return whether the trace was queued, false if the ring is full.
+   */
+  bool push(TraceWrapperPtr& trace);
+
+  /**
+   * @return the oldest trace queued, or nullptr if the ring is empty.
+   */
+  TraceWrapperPtr pop();
+
+  uint64_t size() const { return mask_ + 1; }
+
+private:
+  struct Cell {
+    std::atomic<uint64_t> sequence_;
+    envoy::data::tap::v3::TraceWrapper* trace_;
+  };
+
+  const uint64_t mask_;
+  const std::unique_ptr<Cell[]> cells_;
+  alignas(64) std::atomic<uint64_t> enqueue_position_{};
+  alignas(64) std::atomic<uint64_t> dequeue_position_{};
+};
+
+/**
+ * A tap sink writing the traces of all the taps to a single file. The workers only queue their
+ * traces in rings, which a background thread drains into the file as length delimited binary
+ * protos, so that neither serializing the traces nor writing them blocks a worker. The traces
+ * submitted while the ring of their worker is full are dropped.
+ */
+class BufferedFileSink : public Sink, NonCopyable {
+public:
+  static constexpr uint32_t DefaultRingSize = 1024;
+
+  // Throws EnvoyException if the file cannot be opened.
+  BufferedFileSink(const envoy::config::tap::v3::BufferedFileSink& config,
+                   Thread::ThreadFactory& thread_factory);
+  // Writes the traces left in the rings, and joins the background thread.
+  ~BufferedFileSink() override;
+
+  // Sink
+  PerTapSinkHandlePtr createPerTapSinkHandle(uint64_t) override {
+    return std::make_unique<BufferedFileSinkHandle>(*this);
+  }
+
+  /**
+   * @return the number of traces dropped because their ring was full.
+   */
+  uint64_t droppedTraces() const { return dropped_traces_.load(std::memory_order_relaxed); }
+
+  /**
+   * @return the number of traces written to the file.
+   */
+  uint64_t writtenTraces() const { return written_traces_.load(std::memory_order_relaxed); }
+
+private:
+  // The number of rings. The workers are spread over the rings, which tolerate several producers.
+  static constexpr uint32_t NumRings = 8;
+  // How long the background thread sleeps once the rings are empty.
+  static constexpr std::chrono::milliseconds DrainInterval{100};
+
+  struct BufferedFileSinkHandle : public PerTapSinkHandle {
+    BufferedFileSinkHandle(BufferedFileSink& parent) : parent_(parent) {}
+
+    // PerTapSinkHandle
+    void submitTrace(TraceWrapperPtr&& trace,
+                     envoy::config::tap::v3::OutputSink::Format format) override;
+
+    BufferedFileSink& parent_;
+  };
+
+  TraceRing& threadRing();
+  // Writes the traces queued in the rings, returning whether there were any.
+  bool drain();
+  void run();
+
+  std::ofstream output_file_;
+  std::array<std::unique_ptr<TraceRing>, NumRings> rings_;
+  std::atomic<uint64_t> dropped_traces_{};
+  std::atomic<uint64_t> written_traces_{};
+  Thread::MutexBasicLockable mutex_;
+  Thread::CondVar shutdown_signal_;
+  bool shutdown_ ABSL_GUARDED_BY(mutex_){};
+  Thread::ThreadPtr thread_;
+};
+
+} // namespace Tap
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
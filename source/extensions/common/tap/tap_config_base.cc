@@ -10,6 +10,7 @@
 #include "common/protobuf/utility.h"
 
 #include "extensions/common/matcher/matcher.h"
+#include "extensions/common/tap/buffered_file_sink.h"
 
 #include "absl/container/fixed_array.h"
 
@@ -47,7 +48,8 @@ bool Utility::addBufferToProtoBytes(envoy::data::tap::v3::Body& output_body,
 }
 
 TapConfigBaseImpl::TapConfigBaseImpl(const envoy::config::tap::v3::TapConfig& proto_config,
-                                     Common::Tap::Sink* admin_streamer)
+                                     Common::Tap::Sink* admin_streamer,
+                                     Thread::ThreadFactory& thread_factory)
     : max_buffered_rx_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
           proto_config.output_config(), max_buffered_rx_bytes, DefaultMaxBufferedBytes)),
       max_buffered_tx_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
@@ -72,6 +74,16 @@ TapConfigBaseImpl::TapConfigBaseImpl(const envoy::config::tap::v3::TapConfig& pr
         std::make_unique<FilePerTapSink>(proto_config.output_config().sinks()[0].file_per_tap());
     sink_to_use_ = sink_.get();
     break;
+  case envoy::config::tap::v3::OutputSink::OutputSinkTypeCase::kBufferedFile:
+    // The traces of all the taps share the file, so they must be delimited.
+    if (sink_format_ != envoy::config::tap::v3::OutputSink::PROTO_BINARY_LENGTH_DELIMITED) {
+      throw EnvoyException("buffered file output only supports the PROTO_BINARY_LENGTH_DELIMITED "
+                           "format");
+    }
+    sink_ = std::make_unique<BufferedFileSink>(
+        proto_config.output_config().sinks()[0].buffered_file(), thread_factory);
+    sink_to_use_ = sink_.get();
+    break;
   default:
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
@@ -6,6 +6,7 @@
 #include "envoy/config/tap/v3/common.pb.h"
 #include "envoy/data/tap/v3/common.pb.h"
 #include "envoy/data/tap/v3/wrapper.pb.h"
+#include "envoy/thread/thread.h"
 
 #include "extensions/common/matcher/matcher.h"
 #include "extensions/common/tap/tap.h"
@@ -102,7 +103,7 @@ public:
 
 protected:
   TapConfigBaseImpl(const envoy::config::tap::v3::TapConfig& proto_config,
-                    Common::Tap::Sink* admin_streamer);
+                    Common::Tap::Sink* admin_streamer, Thread::ThreadFactory& thread_factory);
 
 private:
   // This is the default setting for both RX/TX max buffered bytes. (This means that per tap, the
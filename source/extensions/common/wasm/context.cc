@@ -759,15 +759,8 @@ WasmResult Context::setHeaderMapPairs(WasmHeaderMapType type, const Pairs& pairs
   if (!map) {
     return WasmResult::BadArgument;
   }
-  std::vector<std::string> keys;
-  map->iterate([&keys](const Http::HeaderEntry& header) -> Http::HeaderMap::Iterate {
-    keys.push_back(std::string(header.key().getStringView()));
-    return Http::HeaderMap::Iterate::Continue;
-  });
-  for (auto& k : keys) {
-    const Http::LowerCaseString lower_key{k};
-    map->remove(lower_key);
-  }
+  // The pairs are in the memory of the VM, so they outlive the headers removed here.
+  map->clear();
   for (auto& p : pairs) {
     const Http::LowerCaseString lower_key{std::string(p.first)};
     map->addCopy(lower_key, std::string(p.second));
@@ -814,6 +807,36 @@ WasmResult Context::getHeaderMapSize(WasmHeaderMapType type, uint32_t* result) {
   return WasmResult::Ok;
 }
 
+WasmResult Context::getHeaderMapValues(WasmHeaderMapType type, const Pairs& keys,
+                                       Pairs* result) {
+  auto map = getConstMap(type);
+  if (!map) {
+    return WasmResult::BadArgument;
+  }
+  result->clear();
+  for (const auto& key : keys) {
+    const auto entry = map->get(Http::LowerCaseString(std::string(key.first)));
+    for (size_t i = 0; i < entry.size(); ++i) {
+      result->emplace_back(entry[i]->key().getStringView(), entry[i]->value().getStringView());
+    }
+  }
+  return WasmResult::Ok;
+}
+
+WasmResult Context::replaceHeaderMapValues(WasmHeaderMapType type, const Pairs& pairs) {
+  auto map = getMap(type);
+  if (!map) {
+    return WasmResult::BadArgument;
+  }
+  for (const auto& p : pairs) {
+    map->setCopy(Http::LowerCaseString(std::string(p.first)), p.second);
+  }
+  if (type == WasmHeaderMapType::RequestHeaders) {
+    decoder_callbacks_->clearRouteCache();
+  }
+  return WasmResult::Ok;
+}
+
 // Buffer
 
 BufferInterface* Context::getBuffer(WasmBufferType type) {
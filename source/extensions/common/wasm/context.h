@@ -244,6 +244,12 @@ public:
 
   WasmResult getHeaderMapSize(WasmHeaderMapType type, uint32_t* size) override;
 
+  // Batched accessors, called by the get_header_map_values and replace_header_map_values foreign
+  // functions.
+  // Sets result to the pairs of the name and each value of the given headers which are present.
+  WasmResult getHeaderMapValues(WasmHeaderMapType type, const Pairs& keys, Pairs* result);
+  WasmResult replaceHeaderMapValues(WasmHeaderMapType type, const Pairs& pairs);
+
   // Buffer
   BufferInterface* getBuffer(WasmBufferType type) override;
   // TODO: use stream_type.
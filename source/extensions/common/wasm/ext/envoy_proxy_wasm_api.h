@@ -128,4 +128,69 @@ inline StatResult parseStatResults(std::string_view data) {
   return results;
 }
 
+// Serializes the arguments of the header map foreign functions: the type of the header map followed
+// by the pairs, serialized like the header maps returned by the host.
+inline std::string
+marshalHeaderMapArguments(WasmHeaderMapType type,
+                          const std::vector<std::pair<std::string_view, std::string_view>>& pairs) {
+  size_t size = (2 + 2 * pairs.size()) * sizeof(uint32_t);
+  for (const auto& p : pairs) {
+    size += p.first.size() + p.second.size() + 2;
+  }
+  std::string result(size, '\0');
+  char* b = result.data();
+  auto put = [&b](uint32_t value) {
+    memcpy(b, &value, sizeof(uint32_t));
+    b += sizeof(uint32_t);
+  };
+  put(static_cast<uint32_t>(type));
+  put(pairs.size());
+  for (const auto& p : pairs) {
+    put(p.first.size());
+    put(p.second.size());
+  }
+  for (const auto& p : pairs) {
+    memcpy(b, p.first.data(), p.first.size());
+    b += p.first.size() + 1;
+    memcpy(b, p.second.data(), p.second.size());
+    b += p.second.size() + 1;
+  }
+  return result;
+}
+
+// Gets the values of several headers of a header map in a single call to the host. On success,
+// values holds the pairs of the name and each value of the headers which are present.
+inline WasmResult getHeaderMapValues(WasmHeaderMapType type,
+                                     const std::vector<std::string_view>& keys,
+                                     WasmDataPtr* values) {
+  std::vector<std::pair<std::string_view, std::string_view>> pairs;
+  pairs.reserve(keys.size());
+  for (const auto key : keys) {
+    pairs.emplace_back(key, std::string_view());
+  }
+  const std::string arguments = marshalHeaderMapArguments(type, pairs);
+  const std::string_view function = "get_header_map_values";
+  char* out = nullptr;
+  size_t out_size = 0;
+  const auto result = proxy_call_foreign_function(function.data(), function.size(),
+                                                  arguments.data(), arguments.size(), &out,
+                                                  &out_size);
+  if (result == WasmResult::Ok) {
+    *values = std::make_unique<WasmData>(out, out_size);
+  }
+  return result;
+}
+
+// Replaces the values of several headers of a header map in a single call to the host.
+inline WasmResult
+replaceHeaderMapValues(WasmHeaderMapType type,
+                       const std::vector<std::pair<std::string_view, std::string_view>>& pairs) {
+  const std::string arguments = marshalHeaderMapArguments(type, pairs);
+  const std::string_view function = "replace_header_map_values";
+  char* out = nullptr;
+  size_t out_size = 0;
+  return proxy_call_foreign_function(function.data(), function.size(), arguments.data(),
+                                     arguments.size(), &out, &out_size);
+}
+
 extern "C" WasmResult envoy_resolve_dns(const char* address, size_t address_size, uint32_t* token);
@@ -61,6 +61,85 @@ RegisterForeignFunction registerUncompressForeignFunction(
       }
     });
 
+namespace {
+
+// Parses the arguments of the header map foreign functions: the type of the header map followed
+// by pairs serialized like the header maps returned by the ABI.
+bool parseHeaderMapArguments(absl::string_view arguments, WasmHeaderMapType* type, Pairs* pairs) {
+  uint32_t value;
+  const auto next = [&arguments, &value]() {
+    if (arguments.size() < sizeof(uint32_t)) {
+      return false;
+    }
+    memcpy(&value, arguments.data(), sizeof(uint32_t));
+    arguments.remove_prefix(sizeof(uint32_t));
+    return true;
+  };
+  if (!next() || value > static_cast<uint32_t>(WasmHeaderMapType::HttpCallResponseTrailers)) {
+    return false;
+  }
+  *type = static_cast<WasmHeaderMapType>(value);
+  if (!next() || value > arguments.size() / (2 * sizeof(uint32_t))) {
+    return false;
+  }
+  std::vector<uint32_t> sizes(2 * value);
+  for (auto& size : sizes) {
+    next();
+    size = value;
+  }
+  pairs->clear();
+  pairs->reserve(sizes.size() / 2);
+  absl::string_view strings[2];
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    // Each string is followed by a null character.
+    if (arguments.size() <= sizes[i]) {
+      return false;
+    }
+    strings[i % 2] = arguments.substr(0, sizes[i]);
+    arguments.remove_prefix(sizes[i] + 1);
+    if (i % 2 == 1) {
+      pairs->emplace_back(strings[0], strings[1]);
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+RegisterForeignFunction registerGetHeaderMapValuesForeignFunction(
+    "get_header_map_values",
+    [](WasmBase&, absl::string_view arguments,
+       const std::function<void*(size_t size)>& alloc_result) -> WasmResult {
+      WasmHeaderMapType type;
+      Pairs keys;
+      if (!parseHeaderMapArguments(arguments, &type, &keys)) {
+        return WasmResult::BadArgument;
+      }
+      Pairs values;
+      auto context = static_cast<Context*>(proxy_wasm::current_context_);
+      auto result = context->getHeaderMapValues(type, keys, &values);
+      if (result != WasmResult::Ok) {
+        return result;
+      }
+      // The values are serialized straight into the memory of the VM.
+      const size_t size = proxy_wasm::exports::pairsSize(values);
+      proxy_wasm::exports::marshalPairs(values, static_cast<char*>(alloc_result(size)));
+      return WasmResult::Ok;
+    });
+
+RegisterForeignFunction registerReplaceHeaderMapValuesForeignFunction(
+    "replace_header_map_values",
+    [](WasmBase&, absl::string_view arguments,
+       const std::function<void*(size_t size)>&) -> WasmResult {
+      WasmHeaderMapType type;
+      Pairs pairs;
+      if (!parseHeaderMapArguments(arguments, &type, &pairs)) {
+        return WasmResult::BadArgument;
+      }
+      auto context = static_cast<Context*>(proxy_wasm::current_context_);
+      return context->replaceHeaderMapValues(type, pairs);
+    });
+
 #if defined(WASM_USE_CEL_PARSER)
 class ExpressionFactory : public Logger::Loggable<Logger::Id::wasm> {
 protected:
@@ -6,6 +6,7 @@
 #include "envoy/event/deferred_deletable.h"
 
 #include "common/common/logger.h"
+#include "common/protobuf/utility.h"
 
 #include "extensions/common/wasm/wasm_extension.h"
 
@@ -61,6 +62,16 @@ std::atomic<int64_t> active_wasms;
 std::mutex code_cache_mutex;
 absl::flat_hash_map<std::string, CodeCacheEntry>* code_cache = nullptr;
 
+struct RetainedVm {
+  WasmHandleSharedPtr wasm;
+  MonotonicTime expiry;
+};
+
+// Base VMs kept alive past their last plugin, by VM key. proxy_wasm::createWasm() reuses a base VM
+// by its key as long as it is alive, so retaining it is enough for it to be reused.
+std::mutex retained_vms_mutex;
+absl::flat_hash_map<std::string, RetainedVm>* retained_vms = nullptr;
+
 // Downcast WasmBase to the actual Wasm.
 inline Wasm* getWasm(WasmHandleSharedPtr& base_wasm_handle) {
   return static_cast<Wasm*>(base_wasm_handle->wasm().get());
@@ -255,6 +266,13 @@ void Wasm::onStatsUpdate(const PluginSharedPtr& plugin, Envoy::Stats::MetricSnap
 }
 
 void clearCodeCacheForTesting() {
+  {
+    std::lock_guard<std::mutex> guard(retained_vms_mutex);
+    if (retained_vms) {
+      delete retained_vms;
+      retained_vms = nullptr;
+    }
+  }
   std::lock_guard<std::mutex> guard(code_cache_mutex);
   if (code_cache) {
     delete code_cache;
@@ -268,6 +286,38 @@ void setTimeOffsetForCodeCacheForTesting(MonotonicTime::duration d) {
   cache_time_offset_for_testing = d;
 }
 
+// Releases the base VMs whose retention period has elapsed and retains the given one for the
+// retention period of its configuration.
+static void retainVm(const std::string& vm_key, const WasmHandleSharedPtr& wasm,
+                     const VmConfig& vm_config, MonotonicTime now) {
+  const auto retention_period =
+      std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(vm_config, vm_retention_period, 0));
+  std::vector<WasmHandleSharedPtr> expired;
+  {
+    std::lock_guard<std::mutex> guard(retained_vms_mutex);
+    if (!retained_vms) {
+      if (retention_period.count() == 0) {
+        return;
+      }
+      retained_vms = new std::remove_reference<decltype(*retained_vms)>::type;
+    }
+    for (auto it = retained_vms->begin(); it != retained_vms->end();) {
+      if (it->second.expiry <= now) {
+        expired.push_back(std::move(it->second.wasm));
+        retained_vms->erase(it++);
+      } else {
+        ++it;
+      }
+    }
+    if (retention_period.count() > 0) {
+      auto& retained = (*retained_vms)[vm_key];
+      retained.wasm = wasm;
+      retained.expiry = now + retention_period;
+    }
+  }
+  // The expired VMs are released once out of the lock.
+}
+
 static proxy_wasm::WasmHandleCloneFactory
 getCloneFactory(WasmExtension* wasm_extension, Event::Dispatcher& dispatcher,
                 CreateContextFn create_root_context_for_testing) {
@@ -409,6 +459,8 @@ static bool createWasmInternal(const VmConfig& vm_config, const PluginSharedPtr&
       cb(nullptr);
       return false;
     }
+    retainVm(vm_key, std::static_pointer_cast<WasmHandle>(wasm), vm_config,
+             dispatcher.timeSource().monotonicTime() + cache_time_offset_for_testing);
     cb(std::static_pointer_cast<WasmHandle>(wasm));
     return true;
   };
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/buffer/buffer.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Brotli {
+namespace Common {
+
+/**
+ * The state of one brotli compression or decompression call, shared between the compressor and
+ * the decompressor: the input being consumed and the chunk the output is written to.
+ */
+struct BrotliContext {
+  BrotliContext(uint32_t chunk_size);
+
+  /**
+   * Moves the chunk to the output buffer once it is full.
+   */
+  void updateOutput(Buffer::Instance& output_buffer);
+
+  /**
+   * Moves whatever the chunk holds to the output buffer.
+   */
+  void finalizeOutput(Buffer::Instance& output_buffer);
+
+  const uint32_t chunk_size_;
+  std::unique_ptr<uint8_t[]> chunk_ptr_;
+  const uint8_t* next_in_{};
+  uint8_t* next_out_;
+  size_t avail_in_{0};
+  size_t avail_out_;
+
+private:
+  void resetOut();
+};
+
+} // namespace Common
+} // namespace Brotli
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,75 @@
+#include "extensions/compression/brotli/compressor/brotli_compressor_impl.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Brotli {
+namespace Compressor {
+
+BrotliCompressorImpl::BrotliCompressorImpl(const uint32_t quality, const uint32_t window_bits,
+                                           const uint32_t input_block_bits,
+                                           const bool disable_literal_context_modeling,
+                                           const EncoderMode mode, const uint32_t chunk_size)
+    : chunk_size_{chunk_size}, state_(BrotliEncoderCreateInstance(nullptr, nullptr, nullptr),
+                                      &BrotliEncoderDestroyInstance) {
+  RELEASE_ASSERT(state_ != nullptr, "unable to create the brotli encoder");
+  RELEASE_ASSERT(quality <= BROTLI_MAX_QUALITY, "");
+  RELEASE_ASSERT(window_bits >= BROTLI_MIN_WINDOW_BITS && window_bits <= BROTLI_MAX_WINDOW_BITS,
+                 "");
+  RELEASE_ASSERT(input_block_bits >= BROTLI_MIN_INPUT_BLOCK_BITS &&
+                     input_block_bits <= BROTLI_MAX_INPUT_BLOCK_BITS,
+                 "");
+  BrotliEncoderSetParameter(state_.get(), BROTLI_PARAM_QUALITY, quality);
+  BrotliEncoderSetParameter(state_.get(), BROTLI_PARAM_LGWIN, window_bits);
+  BrotliEncoderSetParameter(state_.get(), BROTLI_PARAM_LGBLOCK, input_block_bits);
+  BrotliEncoderSetParameter(state_.get(), BROTLI_PARAM_DISABLE_LITERAL_CONTEXT_MODELING,
+                            disable_literal_context_modeling);
+  BrotliEncoderSetParameter(state_.get(), BROTLI_PARAM_MODE, static_cast<uint32_t>(mode));
+}
+
+void BrotliCompressorImpl::compress(Buffer::Instance& buffer,
+                                    Envoy::Compression::Compressor::State state) {
+  Common::BrotliContext ctx(chunk_size_);
+
+  // The compressed output is appended to the buffer while its input slices are drained.
+  for (const Buffer::RawSlice& input_slice : buffer.getRawSlices()) {
+    ctx.avail_in_ = input_slice.len_;
+    ctx.next_in_ = static_cast<uint8_t*>(input_slice.mem_);
+
+    while (ctx.avail_in_ > 0) {
+      process(ctx, buffer, BROTLI_OPERATION_PROCESS);
+    }
+
+    buffer.drain(input_slice.len_);
+  }
+
+  // A flushed stream is complete once the encoder holds no more output, a finished one once the
+  // encoder says so. @see brotli manual.
+  if (state == Envoy::Compression::Compressor::State::Finish) {
+    do {
+      process(ctx, buffer, BROTLI_OPERATION_FINISH);
+    } while (!BrotliEncoderIsFinished(state_.get()));
+  } else {
+    do {
+      process(ctx, buffer, BROTLI_OPERATION_FLUSH);
+    } while (BrotliEncoderHasMoreOutput(state_.get()));
+  }
+
+  ctx.finalizeOutput(buffer);
+}
+
+void BrotliCompressorImpl::process(Common::BrotliContext& ctx, Buffer::Instance& output_buffer,
+                                   const BrotliEncoderOperation op) {
+  const BROTLI_BOOL result = BrotliEncoderCompressStream(
+      state_.get(), op, &ctx.avail_in_, &ctx.next_in_, &ctx.avail_out_, &ctx.next_out_, nullptr);
+  RELEASE_ASSERT(result == BROTLI_TRUE, "unable to compress");
+  ctx.updateOutput(output_buffer);
+}
+
+} // namespace Compressor
+} // namespace Brotli
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/compression/compressor/compressor.h"
+
+#include "common/common/non_copyable.h"
+
+#include "extensions/compression/brotli/common/base.h"
+
+#include "brotli/encode.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Brotli {
+namespace Compressor {
+
+/**
+ * Implementation of compressor's interface.
+ */
+class BrotliCompressorImpl : public Envoy::Compression::Compressor::Compressor, NonCopyable {
+public:
+  /**
+   * Enum values used to tune the encoder for a specific input. @see brotli manual.
+   * Generic: no assumption about the input.
+   * Text: the input is UTF-8 formatted text.
+   * Font: the input is a WOFF 2.0 font.
+   */
+  enum class EncoderMode : uint32_t {
+    Default = BROTLI_MODE_GENERIC,
+    Generic = BROTLI_MODE_GENERIC,
+    Text = BROTLI_MODE_TEXT,
+    Font = BROTLI_MODE_FONT,
+  };
+
+  /**
+   * @param quality sets the compression speed-density trade-off, from 0 to 11.
+   * @param window_bits sets the base two logarithm of the sliding window size, from 10 to 24.
+   * @param input_block_bits sets the base two logarithm of the input block size, from 16 to 24.
+   * @param disable_literal_context_modeling trades compression ratio for decoding speed.
+   * @param mode sets the kind of input the encoder is tuned for.
+   * @param chunk_size amount of memory reserved for the compressor output.
+   */
+  BrotliCompressorImpl(uint32_t quality, uint32_t window_bits, uint32_t input_block_bits,
+                       bool disable_literal_context_modeling, EncoderMode mode,
+                       uint32_t chunk_size);
+
+  // Compression::Compressor::Compressor
+  void compress(Buffer::Instance& buffer, Envoy::Compression::Compressor::State state) override;
+
+private:
+  void process(Common::BrotliContext& ctx, Buffer::Instance& output_buffer,
+               BrotliEncoderOperation op);
+
+  const uint32_t chunk_size_;
+  const std::unique_ptr<BrotliEncoderState, decltype(&BrotliEncoderDestroyInstance)> state_;
+};
+
+} // namespace Compressor
+} // namespace Brotli
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,72 @@
+#include "extensions/compression/brotli/decompressor/brotli_decompressor_impl.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Brotli {
+namespace Decompressor {
+
+BrotliDecompressorImpl::BrotliDecompressorImpl(Stats::Scope& scope,
+                                               const std::string& stats_prefix,
+                                               const uint32_t chunk_size,
+                                               const bool disable_ring_buffer_reallocation)
+    : chunk_size_{chunk_size}, state_(BrotliDecoderCreateInstance(nullptr, nullptr, nullptr),
+                                      &BrotliDecoderDestroyInstance),
+      stats_(generateStats(stats_prefix, scope)) {
+  RELEASE_ASSERT(state_ != nullptr, "unable to create the brotli decoder");
+  BrotliDecoderSetParameter(state_.get(), BROTLI_DECODER_PARAM_DISABLE_RING_BUFFER_REALLOCATION,
+                            disable_ring_buffer_reallocation);
+}
+
+void BrotliDecompressorImpl::decompress(const Buffer::Instance& input_buffer,
+                                        Buffer::Instance& output_buffer) {
+  Common::BrotliContext ctx(chunk_size_);
+
+  for (const Buffer::RawSlice& input_slice : input_buffer.getRawSlices()) {
+    ctx.avail_in_ = input_slice.len_;
+    ctx.next_in_ = static_cast<uint8_t*>(input_slice.mem_);
+
+    while (ctx.avail_in_ > 0) {
+      if (!process(ctx, output_buffer)) {
+        ctx.finalizeOutput(output_buffer);
+        return;
+      }
+    }
+  }
+
+  // Even though the input has been consumed, the decoder may still hold decompressed data that did
+  // not fit in the chunk.
+  bool success;
+  do {
+    success = process(ctx, output_buffer);
+  } while (success && BrotliDecoderHasMoreOutput(state_.get()));
+
+  ctx.finalizeOutput(output_buffer);
+}
+
+bool BrotliDecompressorImpl::process(Common::BrotliContext& ctx, Buffer::Instance& output_buffer) {
+  const BrotliDecoderResult result = BrotliDecoderDecompressStream(
+      state_.get(), &ctx.avail_in_, &ctx.next_in_, &ctx.avail_out_, &ctx.next_out_, nullptr);
+  // Bytes following the end of the stream are as much an error as a corrupted stream, and would
+  // never be consumed otherwise.
+  if (result == BROTLI_DECODER_RESULT_ERROR ||
+      (result == BROTLI_DECODER_RESULT_SUCCESS && ctx.avail_in_ > 0)) {
+    ENVOY_LOG(trace, "brotli decompression error: {}",
+              result == BROTLI_DECODER_RESULT_ERROR
+                  ? BrotliDecoderErrorString(BrotliDecoderGetErrorCode(state_.get()))
+                  : "trailing data");
+    stats_.brotli_error_.inc();
+    return false;
+  }
+
+  ctx.updateOutput(output_buffer);
+  return true;
+}
+
+} // namespace Decompressor
+} // namespace Brotli
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,44 @@
+#include "extensions/compression/zstd/compressor/config.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Compressor {
+
+namespace {
+// Default zstd compression level, the library's own default.
+const uint32_t DefaultCompressionLevel = ZSTD_CLEVEL_DEFAULT;
+
+// Default zstd chunk size.
+const uint32_t DefaultChunkSize = 4096;
+} // namespace
+
+ZstdCompressorFactory::ZstdCompressorFactory(
+    const envoy::extensions::compression::zstd::compressor::v3::Zstd& zstd)
+    : compression_level_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(zstd, compression_level, DefaultCompressionLevel)),
+      enable_checksum_(zstd.enable_checksum()),
+      chunk_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(zstd, chunk_size, DefaultChunkSize)) {}
+
+Envoy::Compression::Compressor::CompressorPtr ZstdCompressorFactory::createCompressor() {
+  return std::make_unique<ZstdCompressorImpl>(compression_level_, enable_checksum_, chunk_size_);
+}
+
+Envoy::Compression::Compressor::CompressorFactoryPtr
+ZstdCompressorLibraryFactory::createCompressorFactoryFromProtoTyped(
+    const envoy::extensions::compression::zstd::compressor::v3::Zstd& proto_config) {
+  return std::make_unique<ZstdCompressorFactory>(proto_config);
+}
+
+/**
+ * Static registration for the zstd compressor library. @see NamedCompressorLibraryConfigFactory.
+ */
+REGISTER_FACTORY(ZstdCompressorLibraryFactory,
+                 Envoy::Compression::Compressor::NamedCompressorLibraryConfigFactory);
+
+} // namespace Compressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
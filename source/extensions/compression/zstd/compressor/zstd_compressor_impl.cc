@@ -0,0 +1,57 @@
+#include "extensions/compression/zstd/compressor/zstd_compressor_impl.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Compressor {
+
+ZstdCompressorImpl::ZstdCompressorImpl(const uint32_t compression_level,
+                                       const bool enable_checksum, const uint32_t chunk_size)
+    : chunk_size_{chunk_size}, chunk_ptr_{std::make_unique<uint8_t[]>(chunk_size)},
+      cctx_(ZSTD_createCCtx(), &ZSTD_freeCCtx) {
+  RELEASE_ASSERT(cctx_ != nullptr, "unable to create the zstd compression context");
+  size_t result = ZSTD_CCtx_setParameter(cctx_.get(), ZSTD_c_compressionLevel, compression_level);
+  RELEASE_ASSERT(!ZSTD_isError(result), ZSTD_getErrorName(result));
+  result = ZSTD_CCtx_setParameter(cctx_.get(), ZSTD_c_checksumFlag, enable_checksum);
+  RELEASE_ASSERT(!ZSTD_isError(result), ZSTD_getErrorName(result));
+}
+
+void ZstdCompressorImpl::compress(Buffer::Instance& buffer,
+                                  Envoy::Compression::Compressor::State state) {
+  // The compressed output is appended to the buffer while its input slices are drained.
+  for (const Buffer::RawSlice& input_slice : buffer.getRawSlices()) {
+    ZSTD_inBuffer input = {input_slice.mem_, input_slice.len_, 0};
+    while (input.pos < input.size) {
+      process(input, buffer, ZSTD_e_continue);
+    }
+
+    buffer.drain(input_slice.len_);
+  }
+
+  // Flushing or ending the frame is done once the compressor has nothing left to write.
+  ZSTD_inBuffer input = {nullptr, 0, 0};
+  const ZSTD_EndDirective mode =
+      state == Envoy::Compression::Compressor::State::Finish ? ZSTD_e_end : ZSTD_e_flush;
+  while (process(input, buffer, mode) != 0) {
+  }
+}
+
+size_t ZstdCompressorImpl::process(ZSTD_inBuffer& input, Buffer::Instance& output_buffer,
+                                   const ZSTD_EndDirective mode) {
+  ZSTD_outBuffer output = {chunk_ptr_.get(), chunk_size_, 0};
+  const size_t remaining = ZSTD_compressStream2(cctx_.get(), &output, &input, mode);
+  RELEASE_ASSERT(!ZSTD_isError(remaining), ZSTD_getErrorName(remaining));
+  if (output.pos > 0) {
+    output_buffer.add(chunk_ptr_.get(), output.pos);
+  }
+  return remaining;
+}
+
+} // namespace Compressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/compression/compressor/compressor.h"
+
+#include "common/common/non_copyable.h"
+
+#include "zstd.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Compressor {
+
+/**
+ * Implementation of compressor's interface.
+ */
+class ZstdCompressorImpl : public Envoy::Compression::Compressor::Compressor, NonCopyable {
+public:
+  /**
+   * @param compression_level sets the compression speed-ratio trade-off, from 1 to 22.
+   * @param enable_checksum writes a checksum of the content at the end of each frame.
+   * @param chunk_size amount of memory reserved for the compressor output.
+   */
+  ZstdCompressorImpl(uint32_t compression_level, bool enable_checksum, uint32_t chunk_size);
+
+  // Compression::Compressor::Compressor
+  void compress(Buffer::Instance& buffer, Envoy::Compression::Compressor::State state) override;
+
+private:
+  /**
+   * Runs the compression once, appending the output it produced to the output buffer.
+   * @return the number of bytes the compressor still has to flush, @see ZSTD_compressStream2.
+   */
+  size_t process(ZSTD_inBuffer& input, Buffer::Instance& output_buffer, ZSTD_EndDirective mode);
+
+  const uint32_t chunk_size_;
+  const std::unique_ptr<uint8_t[]> chunk_ptr_;
+  const std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> cctx_;
+};
+
+} // namespace Compressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
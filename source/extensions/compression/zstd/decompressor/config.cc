@@ -0,0 +1,39 @@
+#include "extensions/compression/zstd/decompressor/config.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Decompressor {
+
+namespace {
+const uint32_t DefaultChunkSize = 4096;
+} // namespace
+
+ZstdDecompressorFactory::ZstdDecompressorFactory(
+    const envoy::extensions::compression::zstd::decompressor::v3::Zstd& zstd, Stats::Scope& scope)
+    : scope_(scope),
+      chunk_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(zstd, chunk_size, DefaultChunkSize)) {}
+
+Envoy::Compression::Decompressor::DecompressorPtr
+ZstdDecompressorFactory::createDecompressor(const std::string& stats_prefix) {
+  return std::make_unique<ZstdDecompressorImpl>(scope_, stats_prefix, chunk_size_);
+}
+
+Envoy::Compression::Decompressor::DecompressorFactoryPtr
+ZstdDecompressorLibraryFactory::createDecompressorFactoryFromProtoTyped(
+    const envoy::extensions::compression::zstd::decompressor::v3::Zstd& proto_config,
+    Server::Configuration::FactoryContext& context) {
+  return std::make_unique<ZstdDecompressorFactory>(proto_config, context.scope());
+}
+
+/**
+ * Static registration for the zstd decompressor. @see NamedDecompressorLibraryConfigFactory.
+ */
+REGISTER_FACTORY(ZstdDecompressorLibraryFactory,
+                 Envoy::Compression::Decompressor::NamedDecompressorLibraryConfigFactory);
+} // namespace Decompressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,54 @@
+#include "extensions/compression/zstd/decompressor/zstd_decompressor_impl.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Decompressor {
+
+ZstdDecompressorImpl::ZstdDecompressorImpl(Stats::Scope& scope, const std::string& stats_prefix,
+                                           const uint32_t chunk_size)
+    : chunk_size_{chunk_size}, chunk_ptr_{std::make_unique<uint8_t[]>(chunk_size)},
+      dctx_(ZSTD_createDCtx(), &ZSTD_freeDCtx), stats_(generateStats(stats_prefix, scope)) {
+  RELEASE_ASSERT(dctx_ != nullptr, "unable to create the zstd decompression context");
+}
+
+void ZstdDecompressorImpl::decompress(const Buffer::Instance& input_buffer,
+                                      Buffer::Instance& output_buffer) {
+  for (const Buffer::RawSlice& input_slice : input_buffer.getRawSlices()) {
+    ZSTD_inBuffer input = {input_slice.mem_, input_slice.len_, 0};
+    // Even though the input has been consumed, the decompressor may still hold decompressed data
+    // that did not fit in the chunk.
+    bool output_full;
+    do {
+      if (!process(input, output_buffer, output_full)) {
+        return;
+      }
+    } while (input.pos < input.size || output_full);
+  }
+}
+
+bool ZstdDecompressorImpl::process(ZSTD_inBuffer& input, Buffer::Instance& output_buffer,
+                                   bool& output_full) {
+  ZSTD_outBuffer output = {chunk_ptr_.get(), chunk_size_, 0};
+  const size_t result = ZSTD_decompressStream(dctx_.get(), &output, &input);
+  if (ZSTD_isError(result)) {
+    ENVOY_LOG(trace, "zstd decompression error: {}", ZSTD_getErrorName(result));
+    stats_.zstd_error_.inc();
+    return false;
+  }
+
+  if (output.pos > 0) {
+    output_buffer.add(chunk_ptr_.get(), output.pos);
+  }
+  output_full = output.pos == output.size;
+  return true;
+}
+
+} // namespace Decompressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/compression/decompressor/decompressor.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/common/logger.h"
+#include "common/common/non_copyable.h"
+
+#include "zstd.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Decompressor {
+
+/**
+ * All zstd decompressor stats. @see stats_macros.h
+ */
+#define ALL_ZSTD_DECOMPRESSOR_STATS(COUNTER) COUNTER(zstd_error)
+
+/**
+ * Struct definition for zstd decompressor stats. @see stats_macros.h
+ */
+struct ZstdDecompressorStats {
+  ALL_ZSTD_DECOMPRESSOR_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * Implementation of decompressor's interface.
+ */
+class ZstdDecompressorImpl : public Envoy::Compression::Decompressor::Decompressor,
+                             public Logger::Loggable<Logger::Id::decompression>,
+                             NonCopyable {
+public:
+  /**
+   * @param chunk_size amount of memory reserved for the decompressor output.
+   */
+  ZstdDecompressorImpl(Stats::Scope& scope, const std::string& stats_prefix, uint32_t chunk_size);
+
+  // Compression::Decompressor::Decompressor
+  void decompress(const Buffer::Instance& input_buffer, Buffer::Instance& output_buffer) override;
+
+private:
+  static ZstdDecompressorStats generateStats(const std::string& prefix, Stats::Scope& scope) {
+    return ZstdDecompressorStats{ALL_ZSTD_DECOMPRESSOR_STATS(POOL_COUNTER_PREFIX(scope, prefix))};
+  }
+
+  /**
+   * Runs the decompression once, appending the output it produced to the output buffer.
+   * @param output_full is set to whether the output filled the chunk, in which case the
+   * decompressor may hold more of it.
+   * @return false if the input is not a valid zstd stream.
+   */
+  bool process(ZSTD_inBuffer& input, Buffer::Instance& output_buffer, bool& output_full);
+
+  const uint32_t chunk_size_;
+  const std::unique_ptr<uint8_t[]> chunk_ptr_;
+  const std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> dctx_;
+  const ZstdDecompressorStats stats_;
+};
+
+} // namespace Decompressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
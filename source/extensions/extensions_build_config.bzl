@@ -4,6 +4,7 @@ EXTENSIONS = {
     # Access loggers
     #
 
+    "envoy.access_loggers.columnar":                    "//source/extensions/access_loggers/columnar:config",
     "envoy.access_loggers.file":                        "//source/extensions/access_loggers/file:config",
     "envoy.access_loggers.http_grpc":                   "//source/extensions/access_loggers/grpc:http_config",
     "envoy.access_loggers.tcp_grpc":                    "//source/extensions/access_loggers/grpc:tcp_config",
@@ -21,8 +22,12 @@ EXTENSIONS = {
     # Compression
     #
 
+    "envoy.compression.brotli.compressor":              "//source/extensions/compression/brotli/compressor:config",
+    "envoy.compression.brotli.decompressor":            "//source/extensions/compression/brotli/decompressor:config",
     "envoy.compression.gzip.compressor":                "//source/extensions/compression/gzip/compressor:config",
     "envoy.compression.gzip.decompressor":              "//source/extensions/compression/gzip/decompressor:config",
+    "envoy.compression.zstd.compressor":                "//source/extensions/compression/zstd/compressor:config",
+    "envoy.compression.zstd.decompressor":              "//source/extensions/compression/zstd/decompressor:config",
 
     #
     # gRPC Credentials Plugins
@@ -36,6 +41,11 @@ EXTENSIONS = {
     #
     "envoy.bootstrap.wasm":                             "//source/extensions/bootstrap/wasm:config",
 
+    #
+    # Socket interfaces
+    #
+    "envoy.extensions.network.socket_interface.io_uring_socket_interface": "//source/extensions/io_socket/io_uring:config",
+
     #
     # Health checkers
     #
@@ -134,11 +144,20 @@ EXTENSIONS = {
     "envoy.filters.udp_listener.dns_filter":            "//source/extensions/filters/udp/dns_filter:config",
     "envoy.filters.udp_listener.udp_proxy":             "//source/extensions/filters/udp/udp_proxy:config",
 
+    #
+    # Private key providers
+    #
+
+    "envoy.tls.key_providers.offload":                  "//source/extensions/private_key_providers/offload:config",
+
     #
     # Resource monitors
     #
 
+    "envoy.resource_monitors.cgroup_memory":            "//source/extensions/resource_monitors/cgroup_memory:config",
+    "envoy.resource_monitors.event_loop_delay":         "//source/extensions/resource_monitors/event_loop_delay:config",
     "envoy.resource_monitors.fixed_heap":               "//source/extensions/resource_monitors/fixed_heap:config",
+    "envoy.resource_monitors.handshake_offload":        "//source/extensions/resource_monitors/handshake_offload:config",
     "envoy.resource_monitors.injected_resource":        "//source/extensions/resource_monitors/injected_resource:config",
 
     #
@@ -200,6 +219,7 @@ EXTENSIONS = {
     # CacheFilter plugins
     #
 
+    "envoy.filters.http.cache.mmap_http_cache":         "//source/extensions/filters/http/cache/mmap_http_cache:mmap_http_cache_lib",
     "envoy.filters.http.cache.simple_http_cache":       "//source/extensions/filters/http/cache/simple_http_cache:simple_http_cache_lib",
 
     #
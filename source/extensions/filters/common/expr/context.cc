@@ -269,15 +269,21 @@ absl::optional<CelValue> FilterStateWrapper::operator[](CelValue key) const {
     return {};
   }
   auto value = key.StringOrDie().value();
+  auto it = values_.find(value);
+  if (it != values_.end()) {
+    return it->second;
+  }
+  absl::optional<CelValue> result;
   if (filter_state_.hasDataWithName(value)) {
     const StreamInfo::FilterState::Object* object = filter_state_.getDataReadOnlyGeneric(value);
     absl::optional<std::string> serialized = object->serializeAsString();
     if (serialized.has_value()) {
       std::string* out = ProtobufWkt::Arena::Create<std::string>(arena_, serialized.value());
-      return CelValue::CreateBytes(out);
+      result = CelValue::CreateBytes(out);
     }
   }
-  return {};
+  values_.emplace(std::string(value), result);
+  return result;
 }
 
 } // namespace Expr
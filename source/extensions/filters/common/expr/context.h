@@ -11,6 +11,8 @@
 #include "eval/public/cel_value_producer.h"
 #include "eval/public/structs/cel_proto_wrapper.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Filters {
@@ -84,6 +86,8 @@ absl::optional<CelValue>
 convertHeaderEntry(Protobuf::Arena& arena,
                    Http::HeaderUtility::GetAllOfHeaderAsStringResult&& result);
 
+// The values of the headers are memoized by name for the lifetime of the wrapper, which is the
+// lifetime of the activation holding it, so the headers must not change in the meantime.
 template <class T> class HeadersWrapper : public google::api::expr::runtime::CelMap {
 public:
   HeadersWrapper(Protobuf::Arena& arena, const T* value) : arena_(arena), value_(value) {}
@@ -96,8 +100,13 @@ public:
       // Reject key if it is an invalid header string
       return {};
     }
-    return convertHeaderEntry(
-        arena_, Http::HeaderUtility::getAllOfHeaderAsString(*value_, Http::LowerCaseString(str)));
+    auto it = values_.find(str);
+    if (it == values_.end()) {
+      auto value = convertHeaderEntry(
+          arena_, Http::HeaderUtility::getAllOfHeaderAsString(*value_, Http::LowerCaseString(str)));
+      it = values_.emplace(std::move(str), value).first;
+    }
+    return it->second;
   }
   int size() const override { return value_ == nullptr ? 0 : value_->size(); }
   bool empty() const override { return value_ == nullptr ? true : value_->empty(); }
@@ -110,6 +119,7 @@ private:
   friend class ResponseWrapper;
   Protobuf::Arena& arena_;
   const T* value_;
+  mutable absl::flat_hash_map<std::string, absl::optional<CelValue>> values_;
 };
 
 // Wrapper for accessing properties from internal data structures.
@@ -124,7 +134,8 @@ public:
     NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
   }
   CelValue Produce(ProtobufWkt::Arena* arena) override {
-    // Producer is unique per evaluation arena since activation is re-created.
+    // Producer is unique per evaluation arena since an activation is only evaluated with the arena
+    // it was created for.
     arena_ = arena;
     return CelValue::CreateMap(this);
   }
@@ -204,6 +215,8 @@ public:
 
 private:
   const StreamInfo::FilterState& filter_state_;
+  // The serialized objects, memoized by name as serializing allocates.
+  mutable absl::flat_hash_map<std::string, absl::optional<CelValue>> values_;
 };
 
 } // namespace Expr
@@ -85,8 +85,26 @@ absl::optional<CelValue> evaluate(const Expression& expr, Protobuf::Arena& arena
 
 bool matches(const Expression& expr, const StreamInfo::StreamInfo& info,
              const Http::RequestHeaderMap& headers) {
-  Protobuf::Arena arena;
-  auto eval_status = Expr::evaluate(expr, arena, info, &headers, nullptr, nullptr);
+  StreamActivation activation(info, &headers, nullptr, nullptr);
+  return activation.matches(expr);
+}
+
+absl::optional<CelValue> StreamActivation::evaluate(const Expression& expr) {
+  if (activation_ == nullptr) {
+    arena_ = std::make_unique<Protobuf::Arena>();
+    activation_ = createActivation(*arena_, info_, request_headers_, response_headers_,
+                                   response_trailers_);
+  }
+  auto eval_status = expr.Evaluate(*activation_, arena_.get());
+  if (!eval_status.ok()) {
+    return {};
+  }
+
+  return eval_status.value();
+}
+
+bool StreamActivation::matches(const Expression& expr) {
+  auto eval_status = evaluate(expr);
   if (!eval_status.has_value()) {
     return false;
   }
@@ -2,6 +2,7 @@
 
 #include "envoy/stream_info/stream_info.h"
 
+#include "common/common/non_copyable.h"
 #include "common/http/headers.h"
 #include "common/protobuf/protobuf.h"
 
@@ -52,6 +53,36 @@ absl::optional<CelValue> evaluate(const Expression& expr, Protobuf::Arena& arena
 bool matches(const Expression& expr, const StreamInfo::StreamInfo& info,
              const Http::RequestHeaderMap& headers);
 
+// An activation shared by the expressions evaluated against the same state of a stream, such as the
+// conditions of the policies matched against a request. The arena and the activation are created
+// by the first evaluation and reused by the next ones, so the attributes are produced and the
+// header values looked up once rather than per expression. The stream must not change while the
+// activation is in use.
+class StreamActivation : NonCopyable {
+public:
+  StreamActivation(const StreamInfo::StreamInfo& info,
+                   const Http::RequestHeaderMap* request_headers,
+                   const Http::ResponseHeaderMap* response_headers,
+                   const Http::ResponseTrailerMap* response_trailers)
+      : info_(info), request_headers_(request_headers), response_headers_(response_headers),
+        response_trailers_(response_trailers) {}
+
+  // Evaluates an expression. The value lives as long as the activation.
+  absl::optional<CelValue> evaluate(const Expression& expr);
+
+  // Evaluates an expression and returns true if the expression evaluates to "true".
+  // Returns false if the expression fails to evaluate.
+  bool matches(const Expression& expr);
+
+private:
+  const StreamInfo::StreamInfo& info_;
+  const Http::RequestHeaderMap* request_headers_;
+  const Http::ResponseHeaderMap* response_headers_;
+  const Http::ResponseTrailerMap* response_trailers_;
+  std::unique_ptr<Protobuf::Arena> arena_;
+  ActivationPtr activation_;
+};
+
 // Thrown when there is an CEL library error.
 class CelException : public EnvoyException {
 public:
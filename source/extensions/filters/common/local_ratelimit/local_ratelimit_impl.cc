@@ -1,5 +1,12 @@
 #include "extensions/filters/common/local_ratelimit/local_ratelimit_impl.h"
 
+#include <algorithm>
+
+#include "common/protobuf/utility.h"
+
+#include "absl/hash/hash.h"
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Filters {
@@ -71,6 +78,163 @@ bool LocalRateLimiterImpl::requestAllowed() const {
   return true;
 }
 
+LocalDescriptorRateLimiter::Entry::Entry(
+    const envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor& config,
+    uint64_t now_ms)
+    : max_tokens_(config.token_bucket().max_tokens()),
+      tokens_per_fill_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.token_bucket(), tokens_per_fill, 1)),
+      fill_interval_ms_(std::max<uint64_t>(
+          DurationUtil::durationToMilliseconds(config.token_bucket().fill_interval()), 1)),
+      bucket_(fullState(now_ms)) {
+  for (const auto& entry : config.entries()) {
+    entries_.emplace_back(entry.key(), entry.value());
+    dynamic_ = dynamic_ || entry.value().empty();
+  }
+}
+
+bool LocalDescriptorRateLimiter::Entry::matches(const RateLimit::Descriptor& descriptor) const {
+  if (descriptor.entries_.size() != entries_.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    if (descriptor.entries_[i].key_ != entries_[i].first ||
+        (!entries_[i].second.empty() && descriptor.entries_[i].value_ != entries_[i].second)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint64_t LocalDescriptorRateLimiter::Entry::fullState(uint64_t now_ms) const {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(now_ms / fill_interval_ms_)) << 32) |
+         max_tokens_;
+}
+
+namespace {
+
+// The tokens of a bucket in the given state once filled by the fill intervals elapsed since.
+uint32_t filledTokens(uint64_t state, uint32_t fills, uint32_t max_tokens,
+                      uint32_t tokens_per_fill) {
+  // The fill counts wrap around, which is harmless as they are compared by their difference.
+  const uint32_t elapsed_fills = fills - static_cast<uint32_t>(state >> 32);
+  return std::min<uint64_t>(max_tokens, (state & 0xffffffff) +
+                                            static_cast<uint64_t>(elapsed_fills) * tokens_per_fill);
+}
+
+} // namespace
+
+bool LocalDescriptorRateLimiter::Entry::full(const BucketState& bucket, uint64_t now_ms) const {
+  return filledTokens(bucket.load(std::memory_order_relaxed),
+                      static_cast<uint32_t>(now_ms / fill_interval_ms_), max_tokens_,
+                      tokens_per_fill_) == max_tokens_;
+}
+
+bool LocalDescriptorRateLimiter::Entry::take(BucketState& bucket, uint64_t now_ms) const {
+  // Relaxed consistency is used for all operations because we don't care about ordering, just the
+  // final atomic correctness.
+  const uint32_t fills = static_cast<uint32_t>(now_ms / fill_interval_ms_);
+  uint64_t expected_state = bucket.load(std::memory_order_relaxed);
+  uint64_t new_state;
+  do {
+    const uint32_t tokens = filledTokens(expected_state, fills, max_tokens_, tokens_per_fill_);
+    if (tokens == 0) {
+      return false;
+    }
+    new_state = (static_cast<uint64_t>(fills) << 32) | (tokens - 1);
+    // Loop while the weak CAS fails trying to take a token.
+  } while (!bucket.compare_exchange_weak(expected_state, new_state, std::memory_order_relaxed));
+  return true;
+}
+
+LocalDescriptorRateLimiter::LocalDescriptorRateLimiter(
+    const Protobuf::RepeatedPtrField<
+        envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors,
+    uint32_t max_buckets, TimeSource& time_source)
+    : time_source_(time_source), max_shard_buckets_(std::max<size_t>(max_buckets / Shards, 1)) {
+  const uint64_t now_ms = nowMs();
+  for (const auto& descriptor : descriptors) {
+    entries_.push_back(std::make_unique<Entry>(descriptor, now_ms));
+    const Entry& entry = *entries_.back();
+    if (entry.dynamic_ &&
+        (min_fill_interval_ms_ == 0 || entry.fill_interval_ms_ < min_fill_interval_ms_)) {
+      min_fill_interval_ms_ = entry.fill_interval_ms_;
+    }
+  }
+}
+
+uint64_t LocalDescriptorRateLimiter::nowMs() const {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             time_source_.monotonicTime().time_since_epoch())
+      .count();
+}
+
+bool LocalDescriptorRateLimiter::requestAllowed(
+    const std::vector<RateLimit::Descriptor>& descriptors) const {
+  const uint64_t now_ms = nowMs();
+  for (const auto& descriptor : descriptors) {
+    for (size_t i = 0; i < entries_.size(); ++i) {
+      const Entry& entry = *entries_[i];
+      if (!entry.matches(descriptor)) {
+        continue;
+      }
+      if (!(entry.dynamic_ ? takeDynamic(entry, i, descriptor, now_ms)
+                           : entry.take(entry.bucket_, now_ms))) {
+        return false;
+      }
+      break;
+    }
+  }
+  return true;
+}
+
+bool LocalDescriptorRateLimiter::takeDynamic(const Entry& entry, size_t index,
+                                             const RateLimit::Descriptor& descriptor,
+                                             uint64_t now_ms) const {
+  // Descriptor values cannot contain a null character, so it separates them unambiguously.
+  std::string key = absl::StrCat(index);
+  for (const auto& descriptor_entry : descriptor.entries_) {
+    absl::StrAppend(&key, absl::string_view("\0", 1), descriptor_entry.value_);
+  }
+  Shard& shard = shards_[absl::Hash<std::string>()(key) % Shards];
+  {
+    absl::ReaderMutexLock lock(&shard.mutex_);
+    auto it = shard.buckets_.find(key);
+    if (it != shard.buckets_.end()) {
+      return entry.take(it->second.state_, now_ms);
+    }
+  }
+
+  absl::MutexLock lock(&shard.mutex_);
+  auto it = shard.buckets_.find(key);
+  if (it == shard.buckets_.end()) {
+    if (shard.buckets_.size() >= max_shard_buckets_ &&
+        now_ms - shard.cleanup_ms_ >= min_fill_interval_ms_) {
+      shard.cleanup_ms_ = now_ms;
+      for (auto bucket = shard.buckets_.begin(); bucket != shard.buckets_.end();) {
+        if (bucket->second.entry_.full(bucket->second.state_, now_ms)) {
+          shard.buckets_.erase(bucket++);
+        } else {
+          ++bucket;
+        }
+      }
+    }
+    if (shard.buckets_.size() >= max_shard_buckets_) {
+      return entry.take(entry.bucket_, now_ms);
+    }
+    it = shard.buckets_.try_emplace(key, entry, entry.fullState(now_ms)).first;
+  }
+  return entry.take(it->second.state_, now_ms);
+}
+
+size_t LocalDescriptorRateLimiter::dynamicBuckets() const {
+  size_t buckets = 0;
+  for (Shard& shard : shards_) {
+    absl::ReaderMutexLock lock(&shard.mutex_);
+    buckets += shard.buckets_.size();
+  }
+  return buckets;
+}
+
 } // namespace LocalRateLimit
 } // namespace Common
 } // namespace Filters
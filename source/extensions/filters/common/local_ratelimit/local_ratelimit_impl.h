@@ -1,11 +1,24 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "envoy/common/time.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/timer.h"
+#include "envoy/extensions/common/ratelimit/v3/ratelimit.pb.h"
+#include "envoy/ratelimit/ratelimit.h"
 
 #include "common/common/thread_synchronizer.h"
+#include "common/protobuf/protobuf.h"
+
+#include "absl/container/node_hash_map.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -34,6 +47,87 @@ private:
   friend class LocalRateLimiterImplTest;
 };
 
+/**
+ * Token buckets of rate limit descriptors, shared by all the workers. A bucket is refilled when it
+ * is used, by the fill intervals elapsed since it was last filled, and a token is taken with a
+ * compare and swap, so that the buckets need neither a timer nor a lock.
+ *
+ * The buckets of the descriptors matching entries with empty values, e.g. one per client address,
+ * live in a bounded table split in shards, each with its own lock which is only held exclusively
+ * to add or drop buckets. A full bucket is the same as a new one, so these are dropped to make
+ * room, and the descriptors which find no room share one bucket per entry.
+ */
+class LocalDescriptorRateLimiter {
+public:
+  LocalDescriptorRateLimiter(
+      const Protobuf::RepeatedPtrField<
+          envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors,
+      uint32_t max_buckets, TimeSource& time_source);
+
+  /**
+   * Takes a token from the bucket of each of the descriptors matching an entry, in order.
+   * @return false as soon as one of these buckets is empty.
+   */
+  bool requestAllowed(const std::vector<RateLimit::Descriptor>& descriptors) const;
+
+  /**
+   * @return the number of buckets of the descriptors matching entries with empty values.
+   */
+  size_t dynamicBuckets() const;
+
+private:
+  // The state of a token bucket: the number of fill intervals elapsed when it was last filled in
+  // the high 32 bits, and its number of tokens in the low 32 bits.
+  using BucketState = std::atomic<uint64_t>;
+
+  struct Entry {
+    Entry(const envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor& config,
+          uint64_t now_ms);
+
+    bool matches(const RateLimit::Descriptor& descriptor) const;
+    uint64_t fullState(uint64_t now_ms) const;
+    bool full(const BucketState& bucket, uint64_t now_ms) const;
+    bool take(BucketState& bucket, uint64_t now_ms) const;
+
+    std::vector<std::pair<std::string, std::string>> entries_;
+    bool dynamic_{};
+    uint32_t max_tokens_;
+    uint32_t tokens_per_fill_;
+    uint64_t fill_interval_ms_;
+    // The bucket of a static entry, or the bucket shared by the dynamic descriptors which find no
+    // room in the table.
+    mutable BucketState bucket_;
+  };
+
+  struct DynamicBucket {
+    DynamicBucket(const Entry& entry, uint64_t state) : entry_(entry), state_(state) {}
+
+    const Entry& entry_;
+    BucketState state_;
+  };
+
+  struct Shard {
+    absl::Mutex mutex_;
+    absl::node_hash_map<std::string, DynamicBucket> buckets_ ABSL_GUARDED_BY(mutex_);
+    // When the full buckets were last dropped.
+    uint64_t cleanup_ms_ ABSL_GUARDED_BY(mutex_){};
+  };
+
+  static constexpr size_t Shards = 16;
+
+  uint64_t nowMs() const;
+  bool takeDynamic(const Entry& entry, size_t index, const RateLimit::Descriptor& descriptor,
+                   uint64_t now_ms) const;
+
+  TimeSource& time_source_;
+  std::vector<std::unique_ptr<Entry>> entries_;
+  const size_t max_shard_buckets_;
+  // The shortest fill interval of the dynamic entries, which bounds how often a full shard is
+  // scanned for full buckets.
+  uint64_t min_fill_interval_ms_{};
+  mutable std::array<Shard, Shards> shards_;
+};
+
 } // namespace LocalRateLimit
 } // namespace Common
 } // namespace Filters
@@ -14,28 +14,65 @@ namespace Filters {
 namespace Common {
 namespace Lua {
 
+namespace {
+
+int appendBytecode(lua_State*, const void* data, size_t size, void* bytecode) {
+  static_cast<std::string*>(bytecode)->append(static_cast<const char*>(data), size);
+  return 0;
+}
+
+} // namespace
+
+LuaThreadRefPtr CoroutinePool::acquire() {
+  if (idle_threads_.empty()) {
+    return std::make_unique<LuaRef<lua_State>>(std::make_pair(lua_newthread(state_), state_),
+                                               false);
+  }
+  LuaThreadRefPtr thread = std::move(idle_threads_.back());
+  idle_threads_.pop_back();
+  return thread;
+}
+
+void CoroutinePool::release(LuaThreadRefPtr&& thread) {
+  if (idle_threads_.size() < MaxIdleThreads) {
+    idle_threads_.push_back(std::move(thread));
+  }
+}
+
 Coroutine::Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state)
-    : coroutine_state_(new_thread_state, false) {}
+    : coroutine_state_(std::make_unique<LuaRef<lua_State>>(new_thread_state, false)) {}
+
+Coroutine::Coroutine(LuaThreadRefPtr&& thread, CoroutinePool& pool)
+    : coroutine_state_(std::move(thread)), pool_(&pool) {}
+
+Coroutine::~Coroutine() {
+  // A thread whose coroutine yielded or failed cannot run another one.
+  if (pool_ != nullptr && (state_ == State::NotStarted || returned_)) {
+    lua_settop(coroutine_state_->get(), 0);
+    pool_->release(std::move(coroutine_state_));
+  }
+}
 
 void Coroutine::start(int function_ref, int num_args, const std::function<void()>& yield_callback) {
   ASSERT(state_ == State::NotStarted);
 
   state_ = State::Yielded;
-  lua_rawgeti(coroutine_state_.get(), LUA_REGISTRYINDEX, function_ref);
-  ASSERT(lua_isfunction(coroutine_state_.get(), -1));
+  lua_rawgeti(coroutine_state_->get(), LUA_REGISTRYINDEX, function_ref);
+  ASSERT(lua_isfunction(coroutine_state_->get(), -1));
 
   // The function needs to come before the arguments but the arguments are already on the stack,
   // so we need to move it into position.
-  lua_insert(coroutine_state_.get(), -(num_args + 1));
+  lua_insert(coroutine_state_->get(), -(num_args + 1));
   resume(num_args, yield_callback);
 }
 
 void Coroutine::resume(int num_args, const std::function<void()>& yield_callback) {
   ASSERT(state_ == State::Yielded);
-  int rc = lua_resume(coroutine_state_.get(), num_args);
+  int rc = lua_resume(coroutine_state_->get(), num_args);
 
   if (0 == rc) {
     state_ = State::Finished;
+    returned_ = true;
     ENVOY_LOG(debug, "coroutine finished");
   } else if (LUA_YIELD == rc) {
     state_ = State::Yielded;
@@ -43,7 +80,7 @@ void Coroutine::resume(int num_args, const std::function<void()>& yield_callback
     yield_callback();
   } else {
     state_ = State::Finished;
-    const char* error = lua_tostring(coroutine_state_.get(), -1);
+    const char* error = lua_tostring(coroutine_state_->get(), -1);
     throw LuaException(error);
   }
 }
@@ -56,12 +93,21 @@ ThreadLocalState::ThreadLocalState(const std::string& code, ThreadLocal::SlotAll
   RELEASE_ASSERT(state.get() != nullptr, "unable to create new Lua state object");
   luaL_openlibs(state.get());
 
-  if (0 != luaL_dostring(state.get(), code.c_str())) {
+  if (0 != luaL_loadstring(state.get(), code.c_str())) {
+    throw LuaException(fmt::format("script load error: {}", lua_tostring(state.get(), -1)));
+  }
+  // The workers load the bytecode of the script rather than parse it again. The bytecode keeps the
+  // debug information, so errors report the same locations.
+  std::string bytecode;
+  lua_dump(state.get(), appendBytecode, &bytecode);
+  if (0 != lua_pcall(state.get(), 0, LUA_MULTRET, 0)) {
     throw LuaException(fmt::format("script load error: {}", lua_tostring(state.get(), -1)));
   }
 
   // Now initialize on all threads.
-  tls_slot_->set([code](Event::Dispatcher&) { return std::make_shared<LuaThreadLocal>(code); });
+  tls_slot_->set([bytecode = std::move(bytecode)](Event::Dispatcher&) {
+    return std::make_shared<LuaThreadLocal>(bytecode);
+  });
 }
 
 int ThreadLocalState::getGlobalRef(uint64_t slot) {
@@ -86,16 +132,17 @@ uint64_t ThreadLocalState::registerGlobal(const std::string& global) {
 }
 
 CoroutinePtr ThreadLocalState::createCoroutine() {
-  lua_State* state = tlsState().get();
-  return std::make_unique<Coroutine>(std::make_pair(lua_newthread(state), state));
+  CoroutinePool& pool = (*tls_slot_)->coroutine_pool_;
+  return std::make_unique<Coroutine>(pool.acquire(), pool);
 }
 
-ThreadLocalState::LuaThreadLocal::LuaThreadLocal(const std::string& code)
-    : state_(luaL_newstate()) {
+ThreadLocalState::LuaThreadLocal::LuaThreadLocal(const std::string& bytecode)
+    : state_(luaL_newstate()), coroutine_pool_(state_.get()) {
 
   RELEASE_ASSERT(state_.get() != nullptr, "unable to create new Lua state object");
   luaL_openlibs(state_.get());
-  int rc = luaL_dostring(state_.get(), code.c_str());
+  int rc = luaL_loadbuffer(state_.get(), bytecode.data(), bytecode.size(), "script") ||
+           lua_pcall(state_.get(), 0, LUA_MULTRET, 0);
   ASSERT(rc == 0);
 }
 
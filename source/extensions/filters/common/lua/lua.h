@@ -316,6 +316,38 @@ public:
   }
 };
 
+using LuaThreadRefPtr = std::unique_ptr<LuaRef<lua_State>>;
+
+/**
+ * The idle threads of a Lua state, kept for the next coroutines so that a coroutine does not
+ * create a new thread, and its stack, unless all the threads are in use. A thread is only reused
+ * once the coroutine running on it has returned, at which point its stack holds nothing.
+ */
+class CoroutinePool {
+public:
+  // The number of idle threads kept per Lua state.
+  static constexpr size_t MaxIdleThreads = 64;
+
+  explicit CoroutinePool(lua_State* state) : state_(state) {}
+
+  /**
+   * @return an idle thread, or a new one if there is none.
+   */
+  LuaThreadRefPtr acquire();
+
+  /**
+   * Keep a thread for reuse, unless enough threads are idle already.
+   * @param thread supplies the thread, whose coroutine has returned.
+   */
+  void release(LuaThreadRefPtr&& thread);
+
+  size_t idleThreads() const { return idle_threads_.size(); }
+
+private:
+  lua_State* state_;
+  std::vector<LuaThreadRefPtr> idle_threads_;
+};
+
 /**
  * This is a wrapper for a Lua coroutine. Lua intermixes coroutine and "thread." Lua does not have
  * real threads, only cooperatively scheduled coroutines.
@@ -325,7 +357,13 @@ public:
   enum class State { NotStarted, Yielded, Finished };
 
   Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state);
-  lua_State* luaState() { return coroutine_state_.get(); }
+  /**
+   * Run on a thread of a pool, returned to the pool on destruction if the coroutine has returned.
+   */
+  Coroutine(LuaThreadRefPtr&& thread, CoroutinePool& pool);
+  ~Coroutine();
+
+  lua_State* luaState() { return coroutine_state_->get(); }
   State state() { return state_; }
 
   /**
@@ -347,8 +385,11 @@ public:
   void resume(int num_args, const std::function<void()>& yield_callback);
 
 private:
-  LuaRef<lua_State> coroutine_state_;
+  LuaThreadRefPtr coroutine_state_;
+  CoroutinePool* pool_{};
   State state_{State::NotStarted};
+  // Whether the coroutine has returned without error, leaving its thread reusable.
+  bool returned_{};
 };
 
 using CoroutinePtr = std::unique_ptr<Coroutine>;
@@ -404,12 +445,19 @@ public:
    */
   void runtimeGC() { lua_gc(tlsState().get(), LUA_GCCOLLECT, 0); }
 
+  /**
+   * Return the number of idle coroutine threads kept for reuse.
+   */
+  size_t idleCoroutines() { return (*tls_slot_)->coroutine_pool_.idleThreads(); }
+
 private:
   struct LuaThreadLocal : public ThreadLocal::ThreadLocalObject {
-    LuaThreadLocal(const std::string& code);
+    LuaThreadLocal(const std::string& bytecode);
 
     CSmartPtr<lua_State, lua_close> state_;
     std::vector<int> global_slots_;
+    // Declared after the state so that the idle threads are released before the state is closed.
+    CoroutinePool coroutine_pool_;
   };
 
   CSmartPtr<lua_State, lua_close>& tlsState() { return (*tls_slot_)->state_; }
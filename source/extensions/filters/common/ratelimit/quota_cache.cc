@@ -0,0 +1,211 @@
+#include "extensions/filters/common/ratelimit/quota_cache.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+#include "common/common/empty_string.h"
+#include "common/tracing/http_tracer_impl.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RateLimit {
+
+QuotaCache::QuotaCache(Grpc::RawAsyncClientPtr&& async_client, Event::Dispatcher& dispatcher,
+                       const Options& options)
+    : async_client_(std::move(async_client)), dispatcher_(dispatcher), options_(options),
+      service_method_(
+          Grpc::VersionedMethods("envoy.service.ratelimit.v3.RateLimitService.ShouldRateLimit",
+                                 "envoy.service.ratelimit.v2.RateLimitService.ShouldRateLimit")
+              .getMethodDescriptorForVersion(options.transport_api_version_)),
+      flush_timer_(dispatcher.createTimer([this]() -> void { flush(); })) {}
+
+QuotaCache::~QuotaCache() {
+  // The hits which are not reported yet are lost with the worker.
+  while (!reports_.empty()) {
+    reports_.front()->request_->cancel();
+    reports_.pop_front();
+  }
+}
+
+std::string QuotaCache::key(const std::string& domain,
+                            const std::vector<Envoy::RateLimit::Descriptor>& descriptors) {
+  // The lengths prefixing the strings make the key unambiguous whatever the strings contain.
+  std::string key = absl::StrCat(domain.size(), ":", domain);
+  for (const Envoy::RateLimit::Descriptor& descriptor : descriptors) {
+    absl::StrAppend(&key, "|", descriptor.entries_.size());
+    for (const Envoy::RateLimit::DescriptorEntry& entry : descriptor.entries_) {
+      absl::StrAppend(&key, ",", entry.key_.size(), ":", entry.key_, entry.value_.size(), ":",
+                      entry.value_);
+    }
+    if (descriptor.limit_.has_value()) {
+      absl::StrAppend(&key, "/", descriptor.limit_.value().requests_per_unit_, "/",
+                      descriptor.limit_.value().unit_);
+    }
+  }
+  return key;
+}
+
+bool QuotaCache::allow(const std::string& key) {
+  const auto it = leases_.find(key);
+  if (it == leases_.end() || it->second.tokens_ == 0 ||
+      it->second.expiry_ <= dispatcher_.timeSource().monotonicTime()) {
+    return false;
+  }
+  --it->second.tokens_;
+  ++it->second.unreported_hits_;
+  return true;
+}
+
+void QuotaCache::lease(const std::string& key, const std::string& domain,
+                       const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                       const DescriptorStatusList& statuses) {
+  auto it = leases_.find(key);
+  if (it == leases_.end()) {
+    it = leases_.emplace(key, Lease()).first;
+    GrpcClientImpl::createRequest(it->second.request_, domain, descriptors);
+  }
+  renew(it->second, statuses);
+  if (!flush_timer_->enabled()) {
+    flush_timer_->enableTimer(options_.report_interval_);
+  }
+}
+
+template <class Statuses> void QuotaCache::renew(Lease& lease, const Statuses& statuses) {
+  // Without the statuses of the descriptors, the quota remaining is unknown.
+  uint32_t tokens = statuses.empty() ? 0 : options_.max_lease_;
+  MonotonicTime expiry = dispatcher_.timeSource().monotonicTime() + options_.report_interval_;
+  for (const auto& status : statuses) {
+    if (status.code() != envoy::service::ratelimit::v3::RateLimitResponse::OK) {
+      tokens = 0;
+      break;
+    }
+    // A descriptor without a limit does not limit the lease.
+    if (!status.has_current_limit()) {
+      continue;
+    }
+    tokens = status.limit_remaining() > options_.min_remaining_
+                 ? std::min(tokens, status.limit_remaining() - options_.min_remaining_)
+                 : 0;
+    if (status.has_duration_until_reset()) {
+      const std::chrono::seconds until_reset(
+          std::max<int64_t>(status.duration_until_reset().seconds(), 0));
+      expiry = std::min(expiry, dispatcher_.timeSource().monotonicTime() + until_reset);
+    }
+  }
+  lease.tokens_ = tokens;
+  lease.expiry_ = expiry;
+}
+
+void QuotaCache::flush() {
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  for (auto it = leases_.begin(); it != leases_.end();) {
+    Lease& lease = it->second;
+    if (lease.unreported_hits_ > 0) {
+      envoy::service::ratelimit::v3::RateLimitRequest request = lease.request_;
+      request.set_hits_addend(lease.unreported_hits_);
+      lease.unreported_hits_ = 0;
+      ENVOY_LOG(debug, "reporting {} hits allowed out of a lease", request.hits_addend());
+
+      Report* report = new Report(*this, it->first);
+      LinkedList::moveIntoList(ReportPtr{report}, reports_);
+      // The report may fail right away, and be removed from the reports before it is sent.
+      Grpc::AsyncRequest* async_request = async_client_->send(
+          service_method_, request, *report, Tracing::NullSpan::instance(),
+          Http::AsyncClient::RequestOptions().setTimeout(options_.timeout_),
+          options_.transport_api_version_);
+      if (async_request != nullptr) {
+        report->request_ = async_request;
+      }
+      ++it;
+    } else if (lease.expiry_ <= now) {
+      leases_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  if (!leases_.empty()) {
+    flush_timer_->enableTimer(options_.report_interval_);
+  }
+}
+
+void QuotaCache::onReport(Report& report,
+                          const envoy::service::ratelimit::v3::RateLimitResponse* response) {
+  const auto it = leases_.find(report.key_);
+  if (it != leases_.end()) {
+    if (response != nullptr &&
+        response->overall_code() == envoy::service::ratelimit::v3::RateLimitResponse::OK) {
+      renew(it->second, response->statuses());
+    } else {
+      // Over the limit, or failing: the requests are checked one by one again.
+      it->second.tokens_ = 0;
+    }
+  }
+  dispatcher_.deferredDelete(report.removeFromList(reports_));
+}
+
+void QuotaCache::Report::onSuccess(
+    std::unique_ptr<envoy::service::ratelimit::v3::RateLimitResponse>&& response, Tracing::Span&) {
+  parent_.onReport(*this, response.get());
+}
+
+void QuotaCache::Report::onFailure(Grpc::Status::GrpcStatus, const std::string&,
+                                   Tracing::Span&) {
+  parent_.onReport(*this, nullptr);
+}
+
+ThreadLocalQuotaCache::ThreadLocalQuotaCache(ThreadLocal::SlotAllocator& tls,
+                                             Grpc::AsyncClientFactoryPtr&& async_client_factory,
+                                             const QuotaCache::Options& options)
+    : tls_(tls.allocateSlot()) {
+  std::shared_ptr<Grpc::AsyncClientFactory> factory = std::move(async_client_factory);
+  tls_->set([factory, options](
+                Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<QuotaCache>(factory->create(), dispatcher, options);
+  });
+}
+
+void QuotaCachingClient::cancel() {
+  ASSERT(callbacks_ != nullptr);
+  client_->cancel();
+  callbacks_ = nullptr;
+}
+
+void QuotaCachingClient::limit(RequestCallbacks& callbacks, const std::string& domain,
+                               const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                               Tracing::Span& parent_span,
+                               const StreamInfo::StreamInfo& stream_info) {
+  ASSERT(callbacks_ == nullptr);
+  key_ = QuotaCache::key(domain, descriptors);
+  if (cache_.allow(key_)) {
+    callbacks.complete(LimitStatus::OK, nullptr, nullptr, nullptr, EMPTY_STRING);
+    return;
+  }
+  callbacks_ = &callbacks;
+  domain_ = domain;
+  descriptors_ = descriptors;
+  client_->limit(*this, domain, descriptors, parent_span, stream_info);
+}
+
+void QuotaCachingClient::complete(LimitStatus status,
+                                  DescriptorStatusListPtr&& descriptor_statuses,
+                                  Http::ResponseHeaderMapPtr&& response_headers_to_add,
+                                  Http::RequestHeaderMapPtr&& request_headers_to_add,
+                                  const std::string& response_body) {
+  if (status == LimitStatus::OK && descriptor_statuses != nullptr) {
+    cache_.lease(key_, domain_, descriptors_, *descriptor_statuses);
+  }
+  RequestCallbacks* callbacks = callbacks_;
+  callbacks_ = nullptr;
+  callbacks->complete(status, std::move(descriptor_statuses), std::move(response_headers_to_add),
+                      std::move(request_headers_to_add), response_body);
+}
+
+} // namespace RateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
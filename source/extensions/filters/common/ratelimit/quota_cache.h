@@ -0,0 +1,186 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/config/core/v3/grpc_service.pb.h"
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/grpc/async_client.h"
+#include "envoy/grpc/async_client_manager.h"
+#include "envoy/ratelimit/ratelimit.h"
+#include "envoy/service/ratelimit/v3/rls.pb.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/common/linked_object.h"
+#include "common/common/logger.h"
+#include "common/grpc/typed_async_client.h"
+
+#include "extensions/filters/common/ratelimit/ratelimit.h"
+#include "extensions/filters/common/ratelimit/ratelimit_impl.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RateLimit {
+
+/**
+ * The leases of quota of a worker. Once the rate limit service allows the descriptors of a request
+ * with some quota remaining for each of them, the following requests with the same descriptors are
+ * allowed locally out of a lease of that quota, until the lease is used up or expires. The hits
+ * allowed locally are reported to the service in batches, with the hits_addend of the reports set
+ * to their number, and the responses to the reports renew the leases.
+ */
+class QuotaCache : public ThreadLocal::ThreadLocalObject,
+                   public Logger::Loggable<Logger::Id::filter> {
+public:
+  struct Options {
+    // The maximum number of requests allowed out of a lease.
+    uint32_t max_lease_;
+    // The quota left to the per request checks of the service.
+    uint32_t min_remaining_;
+    std::chrono::milliseconds report_interval_;
+    absl::optional<std::chrono::milliseconds> timeout_;
+    envoy::config::core::v3::ApiVersion transport_api_version_;
+  };
+
+  QuotaCache(Grpc::RawAsyncClientPtr&& async_client, Event::Dispatcher& dispatcher,
+             const Options& options);
+  ~QuotaCache() override;
+
+  /**
+   * @return the key of the lease of a set of descriptors.
+   */
+  static std::string key(const std::string& domain,
+                         const std::vector<Envoy::RateLimit::Descriptor>& descriptors);
+
+  /**
+   * Takes a hit out of a lease.
+   * @param key supplies the key of the lease.
+   * @return whether the lease allows the hit, false if there is no lease left for the key.
+   */
+  bool allow(const std::string& key);
+
+  /**
+   * Leases the quota remaining after the rate limit service allowed a request.
+   * @param key supplies the key of the lease.
+   * @param domain supplies the domain of the request.
+   * @param descriptors supplies the descriptors of the request.
+   * @param statuses supplies the statuses of the descriptors returned by the service.
+   */
+  void lease(const std::string& key, const std::string& domain,
+             const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+             const DescriptorStatusList& statuses);
+
+  /**
+   * @return the number of leases, used or not.
+   */
+  size_t leases() const { return leases_.size(); }
+
+private:
+  struct Lease {
+    envoy::service::ratelimit::v3::RateLimitRequest request_;
+    uint32_t tokens_{};
+    MonotonicTime expiry_;
+    uint32_t unreported_hits_{};
+  };
+
+  // A report of the hits allowed out of a lease, in flight.
+  class Report : public RateLimitAsyncCallbacks,
+                 public Event::DeferredDeletable,
+                 public LinkedObject<Report> {
+  public:
+    Report(QuotaCache& parent, const std::string& key) : parent_(parent), key_(key) {}
+
+    // Grpc::AsyncRequestCallbacks
+    void onCreateInitialMetadata(Http::RequestHeaderMap&) override {}
+    void onSuccess(std::unique_ptr<envoy::service::ratelimit::v3::RateLimitResponse>&& response,
+                   Tracing::Span& span) override;
+    void onFailure(Grpc::Status::GrpcStatus status, const std::string& message,
+                   Tracing::Span& span) override;
+
+    QuotaCache& parent_;
+    const std::string key_;
+    Grpc::AsyncRequest* request_{};
+  };
+  using ReportPtr = std::unique_ptr<Report>;
+
+  template <class Statuses> void renew(Lease& lease, const Statuses& statuses);
+  void onReport(Report& report, const envoy::service::ratelimit::v3::RateLimitResponse* response);
+  void flush();
+
+  Grpc::AsyncClient<envoy::service::ratelimit::v3::RateLimitRequest,
+                    envoy::service::ratelimit::v3::RateLimitResponse>
+      async_client_;
+  Event::Dispatcher& dispatcher_;
+  const Options options_;
+  const Protobuf::MethodDescriptor& service_method_;
+  const Event::TimerPtr flush_timer_;
+  absl::flat_hash_map<std::string, Lease> leases_;
+  std::list<ReportPtr> reports_;
+};
+
+/**
+ * The quota caches of the workers.
+ */
+class ThreadLocalQuotaCache {
+public:
+  ThreadLocalQuotaCache(ThreadLocal::SlotAllocator& tls,
+                        Grpc::AsyncClientFactoryPtr&& async_client_factory,
+                        const QuotaCache::Options& options);
+
+  /**
+   * @return the quota cache of the current worker.
+   */
+  QuotaCache& get() { return tls_->getTyped<QuotaCache>(); }
+
+private:
+  ThreadLocal::SlotPtr tls_;
+};
+
+using ThreadLocalQuotaCacheSharedPtr = std::shared_ptr<ThreadLocalQuotaCache>;
+
+/**
+ * A client allowing the requests which have a lease in a quota cache, and asking the rate limit
+ * service for the others.
+ */
+class QuotaCachingClient : public Client, public RequestCallbacks {
+public:
+  QuotaCachingClient(ClientPtr&& client, QuotaCache& cache)
+      : client_(std::move(client)), cache_(cache) {}
+
+  // Filters::Common::RateLimit::Client
+  void cancel() override;
+  void limit(RequestCallbacks& callbacks, const std::string& domain,
+             const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+             Tracing::Span& parent_span, const StreamInfo::StreamInfo& stream_info) override;
+
+  // Filters::Common::RateLimit::RequestCallbacks
+  void complete(LimitStatus status, DescriptorStatusListPtr&& descriptor_statuses,
+                Http::ResponseHeaderMapPtr&& response_headers_to_add,
+                Http::RequestHeaderMapPtr&& request_headers_to_add,
+                const std::string& response_body) override;
+
+private:
+  ClientPtr client_;
+  QuotaCache& cache_;
+  RequestCallbacks* callbacks_{};
+  std::string key_;
+  std::string domain_;
+  std::vector<Envoy::RateLimit::Descriptor> descriptors_;
+};
+
+} // namespace RateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
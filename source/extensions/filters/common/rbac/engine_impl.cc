@@ -21,9 +21,17 @@ RoleBasedAccessControlEngineImpl::RoleBasedAccessControlEngineImpl(
     }
   }
 
+  std::map<std::string, const envoy::config::rbac::v3::Policy*> ordered_policies;
   for (const auto& policy : rules.policies()) {
-    policies_.emplace(policy.first, std::make_unique<PolicyMatcher>(policy.second, builder_.get()));
+    ordered_policies.emplace(policy.first, &policy.second);
   }
+  std::vector<const envoy::config::rbac::v3::Policy*> indexed_policies;
+  for (const auto& policy : ordered_policies) {
+    policies_.emplace_back(policy.first,
+                           std::make_unique<PolicyMatcher>(*policy.second, builder_.get()));
+    indexed_policies.push_back(policy.second);
+  }
+  index_ = std::make_unique<PolicyIndex>(indexed_policies);
 }
 
 bool RoleBasedAccessControlEngineImpl::handleAction(const Network::Connection& connection,
@@ -63,19 +71,33 @@ bool RoleBasedAccessControlEngineImpl::handleAction(const Network::Connection& c
 bool RoleBasedAccessControlEngineImpl::checkPolicyMatch(
     const Network::Connection& connection, const StreamInfo::StreamInfo& info,
     const Envoy::Http::RequestHeaderMap& headers, std::string* effective_policy_id) const {
-  bool matched = false;
+  // Both lists of candidates are in policy order, so merging them evaluates the candidates in the
+  // order all the policies would be evaluated in, and the first matching policy is the same.
+  const std::vector<uint32_t> indexed = index_->candidates(connection, headers, info);
+  const std::vector<uint32_t>& unindexed = index_->unindexed();
+  // The conditions of the candidates share the attributes of the request.
+  Expr::StreamActivation activation(info, &headers, nullptr, nullptr);
+  auto indexed_it = indexed.begin();
+  auto unindexed_it = unindexed.begin();
+  while (indexed_it != indexed.end() || unindexed_it != unindexed.end()) {
+    uint32_t position;
+    if (unindexed_it == unindexed.end() ||
+        (indexed_it != indexed.end() && *indexed_it < *unindexed_it)) {
+      position = *indexed_it++;
+    } else {
+      position = *unindexed_it++;
+    }
 
-  for (const auto& policy : policies_) {
-    if (policy.second->matches(connection, headers, info)) {
-      matched = true;
+    const auto& policy = policies_[position];
+    if (policy.second->matches(connection, headers, info, activation)) {
       if (effective_policy_id != nullptr) {
         *effective_policy_id = policy.first;
       }
-      break;
+      return true;
     }
   }
 
-  return matched;
+  return false;
 }
 
 } // namespace RBAC
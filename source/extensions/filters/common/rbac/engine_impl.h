@@ -4,6 +4,7 @@
 
 #include "extensions/filters/common/rbac/engine.h"
 #include "extensions/filters/common/rbac/matchers.h"
+#include "extensions/filters/common/rbac/policy_index.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -46,10 +47,12 @@ private:
   const envoy::config::rbac::v3::RBAC::Action action_;
   const EnforcementMode mode_;
 
-  std::map<std::string, std::unique_ptr<PolicyMatcher>> policies_;
+  // The policies, in the order of their names.
+  std::vector<std::pair<std::string, std::unique_ptr<PolicyMatcher>>> policies_;
 
   Protobuf::Arena constant_arena_;
   Expr::BuilderPtr builder_;
+  std::unique_ptr<PolicyIndex> index_;
 };
 
 } // namespace RBAC
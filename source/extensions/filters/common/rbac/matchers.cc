@@ -195,9 +195,17 @@ bool MetadataMatcher::matches(const Network::Connection&, const Envoy::Http::Req
 bool PolicyMatcher::matches(const Network::Connection& connection,
                             const Envoy::Http::RequestHeaderMap& headers,
                             const StreamInfo::StreamInfo& info) const {
+  Expr::StreamActivation activation(info, &headers, nullptr, nullptr);
+  return matches(connection, headers, info, activation);
+}
+
+bool PolicyMatcher::matches(const Network::Connection& connection,
+                            const Envoy::Http::RequestHeaderMap& headers,
+                            const StreamInfo::StreamInfo& info,
+                            Expr::StreamActivation& activation) const {
   return permissions_.matches(connection, headers, info) &&
          principals_.matches(connection, headers, info) &&
-         (expr_ == nullptr ? true : Expr::matches(*expr_, info, headers));
+         (expr_ == nullptr ? true : activation.matches(*expr_));
 }
 
 bool RequestedServerNameMatcher::matches(const Network::Connection& connection,
@@ -200,6 +200,13 @@ public:
   bool matches(const Network::Connection& connection, const Envoy::Http::RequestHeaderMap& headers,
                const StreamInfo::StreamInfo&) const override;
 
+  /**
+   * Same as above, evaluating the condition with an activation shared by the policies matched
+   * against the same request.
+   */
+  bool matches(const Network::Connection& connection, const Envoy::Http::RequestHeaderMap& headers,
+               const StreamInfo::StreamInfo& info, Expr::StreamActivation& activation) const;
+
 private:
   const OrMatcher permissions_;
   const OrMatcher principals_;
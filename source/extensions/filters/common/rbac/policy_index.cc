@@ -0,0 +1,281 @@
+#include "extensions/filters/common/rbac/policy_index.h"
+
+#include <algorithm>
+
+#include "common/http/header_utility.h"
+#include "common/http/path_utility.h"
+#include "common/network/cidr_range.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RBAC {
+
+namespace {
+
+// The attributes at least one of which a request matching a rule has.
+struct Keys {
+  void merge(Keys&& other) {
+    for (size_t type = 0; type < ips_.size(); ++type) {
+      ips_[type].insert(ips_[type].end(), other.ips_[type].begin(), other.ips_[type].end());
+    }
+    headers_.insert(headers_.end(), other.headers_.begin(), other.headers_.end());
+    paths_.insert(paths_.end(), other.paths_.begin(), other.paths_.end());
+    path_prefixes_.insert(path_prefixes_.end(), other.path_prefixes_.begin(),
+                          other.path_prefixes_.end());
+    principal_names_.insert(principal_names_.end(), other.principal_names_.begin(),
+                            other.principal_names_.end());
+  }
+
+  std::array<std::vector<Network::Address::CidrRange>, 4> ips_;
+  std::vector<std::pair<std::string, std::string>> headers_;
+  std::vector<std::string> paths_;
+  std::vector<std::string> path_prefixes_;
+  std::vector<std::string> principal_names_;
+};
+
+bool addKeys(const envoy::config::rbac::v3::Permission& permission, Keys& keys);
+bool addKeys(const envoy::config::rbac::v3::Principal& principal, Keys& keys);
+
+// A request matching all the rules of a set matches any of them, so the keys of any rule do.
+template <class Rule>
+bool addAnyKeys(const Protobuf::RepeatedPtrField<Rule>& rules, Keys& keys) {
+  for (const auto& rule : rules) {
+    Keys rule_keys;
+    if (addKeys(rule, rule_keys)) {
+      keys.merge(std::move(rule_keys));
+      return true;
+    }
+  }
+  return false;
+}
+
+// A request matching any of the rules of a set needs the keys of all of them.
+template <class Rule>
+bool addAllKeys(const Protobuf::RepeatedPtrField<Rule>& rules, Keys& keys) {
+  Keys rules_keys;
+  for (const auto& rule : rules) {
+    if (!addKeys(rule, rules_keys)) {
+      return false;
+    }
+  }
+  keys.merge(std::move(rules_keys));
+  return true;
+}
+
+bool addIpKey(const envoy::config::core::v3::CidrRange& config, IPMatcher::Type type,
+              Keys& keys) {
+  const auto range = Network::Address::CidrRange::create(config);
+  // An invalid range matches no address, so it needs no key.
+  if (range.isValid()) {
+    keys.ips_[type].push_back(range);
+  }
+  return true;
+}
+
+bool addHeaderKey(const envoy::config::route::v3::HeaderMatcher& header, Keys& keys) {
+  // An empty exact value matches any value of the header.
+  if (header.header_match_specifier_case() !=
+          envoy::config::route::v3::HeaderMatcher::HeaderMatchSpecifierCase::kExactMatch ||
+      header.invert_match() || header.exact_match().empty()) {
+    return false;
+  }
+  keys.headers_.emplace_back(header.name(), header.exact_match());
+  return true;
+}
+
+bool addPathKey(const envoy::type::matcher::v3::PathMatcher& path, Keys& keys) {
+  if (!path.has_path() || path.path().ignore_case()) {
+    return false;
+  }
+  switch (path.path().match_pattern_case()) {
+  case envoy::type::matcher::v3::StringMatcher::MatchPatternCase::kExact:
+    keys.paths_.push_back(path.path().exact());
+    return true;
+  case envoy::type::matcher::v3::StringMatcher::MatchPatternCase::kPrefix:
+    keys.path_prefixes_.push_back(path.path().prefix());
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool addKeys(const envoy::config::rbac::v3::Permission& permission, Keys& keys) {
+  switch (permission.rule_case()) {
+  case envoy::config::rbac::v3::Permission::RuleCase::kAndRules:
+    return addAnyKeys(permission.and_rules().rules(), keys);
+  case envoy::config::rbac::v3::Permission::RuleCase::kOrRules:
+    return addAllKeys(permission.or_rules().rules(), keys);
+  case envoy::config::rbac::v3::Permission::RuleCase::kHeader:
+    return addHeaderKey(permission.header(), keys);
+  case envoy::config::rbac::v3::Permission::RuleCase::kDestinationIp:
+    return addIpKey(permission.destination_ip(), IPMatcher::Type::DownstreamLocal, keys);
+  case envoy::config::rbac::v3::Permission::RuleCase::kUrlPath:
+    return addPathKey(permission.url_path(), keys);
+  default:
+    return false;
+  }
+}
+
+bool addKeys(const envoy::config::rbac::v3::Principal& principal, Keys& keys) {
+  switch (principal.identifier_case()) {
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kAndIds:
+    return addAnyKeys(principal.and_ids().ids(), keys);
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kOrIds:
+    return addAllKeys(principal.or_ids().ids(), keys);
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kAuthenticated: {
+    const auto& authenticated = principal.authenticated();
+    if (!authenticated.has_principal_name() ||
+        authenticated.principal_name().match_pattern_case() !=
+            envoy::type::matcher::v3::StringMatcher::MatchPatternCase::kExact ||
+        authenticated.principal_name().ignore_case()) {
+      return false;
+    }
+    keys.principal_names_.push_back(authenticated.principal_name().exact());
+    return true;
+  }
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kSourceIp:
+    return addIpKey(principal.source_ip(), IPMatcher::Type::ConnectionRemote, keys);
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kDirectRemoteIp:
+    return addIpKey(principal.direct_remote_ip(), IPMatcher::Type::DownstreamDirectRemote, keys);
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kRemoteIp:
+    return addIpKey(principal.remote_ip(), IPMatcher::Type::DownstreamRemote, keys);
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kHeader:
+    return addHeaderKey(principal.header(), keys);
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kUrlPath:
+    return addPathKey(principal.url_path(), keys);
+  default:
+    return false;
+  }
+}
+
+const Network::Address::InstanceConstSharedPtr&
+addressOf(IPMatcher::Type type, const Network::Connection& connection,
+          const StreamInfo::StreamInfo& info) {
+  switch (type) {
+  case IPMatcher::Type::ConnectionRemote:
+    return connection.remoteAddress();
+  case IPMatcher::Type::DownstreamLocal:
+    return info.downstreamLocalAddress();
+  case IPMatcher::Type::DownstreamDirectRemote:
+    return info.downstreamDirectRemoteAddress();
+  case IPMatcher::Type::DownstreamRemote:
+    return info.downstreamRemoteAddress();
+  default:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+}
+
+} // namespace
+
+PolicyIndex::PolicyIndex(const std::vector<const envoy::config::rbac::v3::Policy*>& policies) {
+  std::array<std::vector<std::pair<uint32_t, std::vector<Network::Address::CidrRange>>>, 4>
+      ip_data;
+  absl::flat_hash_map<std::string, PositionMap> headers;
+  for (uint32_t position = 0; position < policies.size(); ++position) {
+    // A policy matches only if both its principals and its permissions do, so the keys of either
+    // are enough.
+    const auto& policy = *policies[position];
+    Keys keys;
+    if (!addAllKeys(policy.principals(), keys) && !addAllKeys(policy.permissions(), keys)) {
+      unindexed_.push_back(position);
+      continue;
+    }
+    for (size_t type = 0; type < keys.ips_.size(); ++type) {
+      if (!keys.ips_[type].empty()) {
+        ip_data[type].emplace_back(position, std::move(keys.ips_[type]));
+      }
+    }
+    for (const auto& header : keys.headers_) {
+      headers[Envoy::Http::LowerCaseString(header.first).get()][header.second].push_back(
+          position);
+    }
+    for (const auto& path : keys.paths_) {
+      paths_[path].push_back(position);
+    }
+    for (const auto& prefix : keys.path_prefixes_) {
+      path_prefixes_[prefix].push_back(position);
+      path_prefix_lengths_.push_back(prefix.size());
+    }
+    for (const auto& name : keys.principal_names_) {
+      principal_names_[name].push_back(position);
+    }
+  }
+
+  for (size_t type = 0; type < ip_data.size(); ++type) {
+    if (!ip_data[type].empty()) {
+      ip_tries_[type] = std::make_unique<Network::LcTrie::LcTrie<uint32_t>>(ip_data[type]);
+    }
+  }
+  for (auto& header : headers) {
+    headers_.emplace_back(Envoy::Http::LowerCaseString(header.first), std::move(header.second));
+  }
+  std::sort(path_prefix_lengths_.begin(), path_prefix_lengths_.end());
+  path_prefix_lengths_.erase(std::unique(path_prefix_lengths_.begin(), path_prefix_lengths_.end()),
+                             path_prefix_lengths_.end());
+}
+
+std::vector<uint32_t> PolicyIndex::candidates(const Network::Connection& connection,
+                                              const Envoy::Http::RequestHeaderMap& headers,
+                                              const StreamInfo::StreamInfo& info) const {
+  Positions positions;
+  for (size_t type = 0; type < ip_tries_.size(); ++type) {
+    if (ip_tries_[type] == nullptr) {
+      continue;
+    }
+    const auto& address = addressOf(static_cast<IPMatcher::Type>(type), connection, info);
+    if (address != nullptr && address->ip() != nullptr) {
+      const Positions ip_positions = ip_tries_[type]->getData(address);
+      positions.insert(positions.end(), ip_positions.begin(), ip_positions.end());
+    }
+  }
+
+  for (const auto& header : headers_) {
+    const auto value = Envoy::Http::HeaderUtility::getAllOfHeaderAsString(headers, header.first);
+    if (value.result().has_value()) {
+      addPositions(header.second, value.result().value(), positions);
+    }
+  }
+
+  if (headers.Path() != nullptr && !(paths_.empty() && path_prefixes_.empty())) {
+    const absl::string_view path =
+        Envoy::Http::PathUtil::removeQueryAndFragment(headers.getPathValue());
+    addPositions(paths_, path, positions);
+    for (const size_t length : path_prefix_lengths_) {
+      if (length > path.size()) {
+        break;
+      }
+      addPositions(path_prefixes_, path.substr(0, length), positions);
+    }
+  }
+
+  const auto& ssl = principal_names_.empty() ? nullptr : connection.ssl();
+  if (ssl != nullptr) {
+    for (const std::string& uri : ssl->uriSanPeerCertificate()) {
+      addPositions(principal_names_, uri, positions);
+    }
+    for (const std::string& dns : ssl->dnsSansPeerCertificate()) {
+      addPositions(principal_names_, dns, positions);
+    }
+    addPositions(principal_names_, ssl->subjectPeerCertificate(), positions);
+  }
+
+  std::sort(positions.begin(), positions.end());
+  positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+  return positions;
+}
+
+void PolicyIndex::addPositions(const PositionMap& map, absl::string_view key,
+                               Positions& positions) {
+  const auto it = map.find(key);
+  if (it != map.end()) {
+    positions.insert(positions.end(), it->second.begin(), it->second.end());
+  }
+}
+
+} // namespace RBAC
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
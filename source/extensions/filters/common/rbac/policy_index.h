@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/config/rbac/v3/rbac.pb.h"
+#include "envoy/http/header_map.h"
+#include "envoy/network/connection.h"
+#include "envoy/stream_info/stream_info.h"
+
+#include "common/common/non_copyable.h"
+#include "common/network/lc_trie.h"
+
+#include "extensions/filters/common/rbac/matchers.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RBAC {
+
+/**
+ * Index of policies by the request attributes they require, so that a request is only matched
+ * against the policies it may match. A policy is indexed when its principals, or else its
+ * permissions, can only match if the request has one of a set of attributes: an IP address within
+ * a CIDR range, an exact header value, an exact path or path prefix, or an exact authenticated
+ * principal name. The other policies are candidates for every request.
+ *
+ * The index only narrows down the candidates: the candidates are still matched against their
+ * policy, so the index does not change which policy matches a request.
+ */
+class PolicyIndex : NonCopyable {
+public:
+  /**
+   * @param policies the policies, in the order they are evaluated in. A policy is identified by
+   *                 its position in this vector.
+   */
+  explicit PolicyIndex(const std::vector<const envoy::config::rbac::v3::Policy*>& policies);
+
+  /**
+   * @return the positions of the indexed policies the request has an attribute of, in increasing
+   *         order.
+   */
+  std::vector<uint32_t> candidates(const Network::Connection& connection,
+                                   const Envoy::Http::RequestHeaderMap& headers,
+                                   const StreamInfo::StreamInfo& info) const;
+
+  /**
+   * @return the positions of the policies which are not indexed, in increasing order.
+   */
+  const std::vector<uint32_t>& unindexed() const { return unindexed_; }
+
+private:
+  using Positions = std::vector<uint32_t>;
+  using PositionMap = absl::flat_hash_map<std::string, Positions>;
+
+  static void addPositions(const PositionMap& map, absl::string_view key, Positions& positions);
+
+  // One trie per IPMatcher::Type, unset when no policy requires an address of the type.
+  std::array<std::unique_ptr<Network::LcTrie::LcTrie<uint32_t>>, 4> ip_tries_;
+  std::vector<std::pair<Envoy::Http::LowerCaseString, PositionMap>> headers_;
+  PositionMap paths_;
+  PositionMap path_prefixes_;
+  // The distinct lengths of the path prefixes, in increasing order.
+  std::vector<size_t> path_prefix_lengths_;
+  PositionMap principal_names_;
+  Positions unindexed_;
+};
+
+} // namespace RBAC
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
@@ -103,16 +103,19 @@ void GradientController::enterMinRTTSamplingWindow() {
 
   // Throw away any latency samples from before the recalculation window as it may not represent
   // the minRTT.
-  hist_clear(latency_sample_hist_.get());
+  clearLatencySamples();
 
   min_rtt_epoch_ = time_source_.monotonicTime();
 }
 
 void GradientController::updateMinRTT() {
-  ASSERT(inMinRTTSamplingWindow());
-
   {
     absl::MutexLock ml(&sample_mutation_mtx_);
+    // The samples of several workers may reach the request count at the same time, in which case
+    // the first one to get here completes the minRTT calculation.
+    if (!inMinRTTSamplingWindow()) {
+      return;
+    }
     min_rtt_ = processLatencySamplesAndClear();
     stats_.min_rtt_msecs_.set(
         std::chrono::duration_cast<std::chrono::milliseconds>(min_rtt_).count());
@@ -140,6 +143,7 @@ void GradientController::resetSampleWindow() {
   // The sampling window must not be reset while sampling for the new minRTT value.
   ASSERT(!inMinRTTSamplingWindow());
 
+  mergeLatencySamples();
   if (hist_sample_count(latency_sample_hist_.get()) == 0) {
     return;
   }
@@ -150,7 +154,37 @@ void GradientController::resetSampleWindow() {
   updateConcurrencyLimit(calculateNewLimit());
 }
 
+uint32_t GradientController::threadShard() {
+  static std::atomic<uint32_t> next_shard{0};
+  static thread_local const uint32_t shard = next_shard++ % NumSampleShards;
+  return shard;
+}
+
+void GradientController::mergeLatencySamples() {
+  for (SampleShard& shard : sample_shards_) {
+    absl::MutexLock ml(&shard.mutex_);
+    const uint64_t count = hist_sample_count(shard.hist_.get());
+    if (count == 0) {
+      continue;
+    }
+    const histogram_t* hist = shard.hist_.get();
+    hist_accumulate(latency_sample_hist_.get(), &hist, 1);
+    hist_clear(shard.hist_.get());
+    sample_count_.fetch_sub(count);
+  }
+}
+
+void GradientController::clearLatencySamples() {
+  for (SampleShard& shard : sample_shards_) {
+    absl::MutexLock ml(&shard.mutex_);
+    sample_count_.fetch_sub(hist_sample_count(shard.hist_.get()));
+    hist_clear(shard.hist_.get());
+  }
+  hist_clear(latency_sample_hist_.get());
+}
+
 std::chrono::microseconds GradientController::processLatencySamplesAndClear() {
+  mergeLatencySamples();
   const std::array<double, 1> quantile{config_.sampleAggregatePercentile()};
   std::array<double, 1> calculated_quantile;
   hist_approx_quantile(latency_sample_hist_.get(), quantile.data(), 1, calculated_quantile.data());
@@ -210,9 +244,10 @@ void GradientController::recordLatencySample(MonotonicTime rq_send_time) {
                                                             rq_send_time);
   uint32_t sample_count;
   {
-    absl::MutexLock ml(&sample_mutation_mtx_);
-    hist_insert(latency_sample_hist_.get(), rq_latency.count(), 1);
-    sample_count = hist_sample_count(latency_sample_hist_.get());
+    SampleShard& shard = sample_shards_[threadShard()];
+    absl::MutexLock ml(&shard.mutex_);
+    hist_insert(shard.hist_.get(), rq_latency.count(), 1);
+    sample_count = ++sample_count_;
   }
 
   if (inMinRTTSamplingWindow() && sample_count >= config_.minRTTAggregateRequestCount()) {
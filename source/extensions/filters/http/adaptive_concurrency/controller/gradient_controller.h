@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <vector>
 
@@ -207,6 +209,10 @@ using GradientControllerConfigSharedPtr = std::shared_ptr<GradientControllerConf
  * prevent the overlap of these windows. It is necessary for a worker thread to know specifically if
  * the controller is inside of a minRTT recalculation window during the recording of a latency
  * sample, so this extra bit of information is stored in inMinRTTSamplingWindow().
+ *
+ * Workers record latency samples in per thread shards, each behind its own mutex, so that they do
+ * not contend on the sample mutation mutex for every request. The shards are merged into a single
+ * histogram, with the sample mutation mutex held, when the samples are processed.
  */
 class GradientController : public ConcurrencyController {
 public:
@@ -224,6 +230,9 @@ private:
   static GradientControllerStats generateStats(Stats::Scope& scope,
                                                const std::string& stats_prefix);
   void updateMinRTT();
+  static uint32_t threadShard();
+  void mergeLatencySamples() ABSL_EXCLUSIVE_LOCKS_REQUIRED(sample_mutation_mtx_);
+  void clearLatencySamples() ABSL_EXCLUSIVE_LOCKS_REQUIRED(sample_mutation_mtx_);
   std::chrono::microseconds processLatencySamplesAndClear()
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(sample_mutation_mtx_);
   uint32_t calculateNewLimit() ABSL_EXCLUSIVE_LOCKS_REQUIRED(sample_mutation_mtx_);
@@ -267,11 +276,26 @@ private:
   // make the forwarding decision without locking.
   std::atomic<uint32_t> concurrency_limit_;
 
-  // Stores all sampled latencies and provides percentile estimations when using the sampled data to
-  // calculate a new concurrency limit.
+  // Stores all sampled latencies merged from the shards and provides percentile estimations when
+  // using the sampled data to calculate a new concurrency limit.
   std::unique_ptr<histogram_t, decltype(&hist_free)>
       latency_sample_hist_ ABSL_GUARDED_BY(sample_mutation_mtx_);
 
+  // The latency samples recorded by the threads of a shard since the shards were last merged. The
+  // shards are on separate cache lines.
+  struct alignas(64) SampleShard {
+    SampleShard() : hist_(hist_fast_alloc(), hist_free) {}
+
+    absl::Mutex mutex_;
+    std::unique_ptr<histogram_t, decltype(&hist_free)> hist_ ABSL_GUARDED_BY(mutex_);
+  };
+  static constexpr uint32_t NumSampleShards = 8;
+  std::array<SampleShard, NumSampleShards> sample_shards_;
+
+  // The number of latency samples in the shards. It is only updated with the mutex of the shard of
+  // the sample held, so that it always matches the content of the shards.
+  std::atomic<uint32_t> sample_count_{0};
+
   // Tracks the number of consecutive times that the concurrency limit is set to the minimum. This
   // is used to determine whether the controller should trigger an additional minRTT measurement
   // after remaining at the minimum limit for too long.
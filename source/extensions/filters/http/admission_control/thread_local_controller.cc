@@ -17,22 +17,22 @@ ThreadLocalControllerImpl::ThreadLocalControllerImpl(TimeSource& time_source,
                                                      std::chrono::seconds sampling_window)
     : time_source_(time_source), sampling_window_(sampling_window) {}
 
-void ThreadLocalControllerImpl::maybeUpdateHistoricalData() {
+void ThreadLocalControllerImpl::maybeUpdateHistoricalData(MonotonicTime now) {
   // Purge stale samples.
-  while (!historical_data_.empty() && ageOfOldestSample() >= sampling_window_) {
+  while (!historical_data_.empty() && ageOfOldestSample(now) >= sampling_window_) {
     removeOldestSample();
   }
 
   // It's possible we purged stale samples from the history and are left with nothing, so it's
   // necessary to add an empty entry. We will also need to roll over into a new entry in the
   // historical data if we've exceeded the time specified by the granularity.
-  if (historical_data_.empty() || ageOfNewestSample() >= defaultHistoryGranularity) {
-    historical_data_.emplace_back(time_source_.monotonicTime(), RequestData());
+  if (historical_data_.empty() || ageOfNewestSample(now) >= defaultHistoryGranularity) {
+    historical_data_.emplace_back(now, RequestData());
   }
 }
 
 void ThreadLocalControllerImpl::recordRequest(bool success) {
-  maybeUpdateHistoricalData();
+  maybeUpdateHistoricalData(time_source_.monotonicTime());
 
   // The back of the deque will be the most recent samples.
   ++historical_data_.back().second.requests;
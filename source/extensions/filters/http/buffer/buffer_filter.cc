@@ -6,10 +6,12 @@
 
 #include "common/common/assert.h"
 #include "common/common/enum_to_int.h"
+#include "common/common/utility.h"
 #include "common/http/codes.h"
 #include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
 #include "common/http/utility.h"
+#include "common/protobuf/utility.h"
 #include "common/runtime/runtime_impl.h"
 
 #include "extensions/filters/http/well_known_names.h"
@@ -19,10 +21,22 @@ namespace Extensions {
 namespace HttpFilters {
 namespace BufferFilter {
 
+namespace {
+
+constexpr uint64_t DefaultSpillMemoryBytes = 1024 * 1024;
+
+} // namespace
+
 BufferFilterSettings::BufferFilterSettings(
     const envoy::extensions::filters::http::buffer::v3::Buffer& proto_config)
     : disabled_(false),
-      max_request_bytes_(static_cast<uint64_t>(proto_config.max_request_bytes().value())) {}
+      max_request_bytes_(static_cast<uint64_t>(proto_config.max_request_bytes().value())) {
+  if (proto_config.has_spill()) {
+    spill_directory_ = proto_config.spill().directory();
+    spill_memory_bytes_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config.spill(), memory_bytes,
+                                                          DefaultSpillMemoryBytes);
+  }
+}
 
 BufferFilterSettings::BufferFilterSettings(
     const envoy::extensions::filters::http::buffer::v3::BufferPerRoute& proto_config)
@@ -30,7 +44,13 @@ BufferFilterSettings::BufferFilterSettings(
       max_request_bytes_(
           proto_config.has_buffer()
               ? static_cast<uint64_t>(proto_config.buffer().max_request_bytes().value())
-              : 0) {}
+              : 0) {
+  if (proto_config.buffer().has_spill()) {
+    spill_directory_ = proto_config.buffer().spill().directory();
+    spill_memory_bytes_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config.buffer().spill(),
+                                                          memory_bytes, DefaultSpillMemoryBytes);
+  }
+}
 
 BufferFilterConfig::BufferFilterConfig(
     const envoy::extensions::filters::http::buffer::v3::Buffer& proto_config)
@@ -83,10 +103,34 @@ Http::FilterDataStatus BufferFilter::decodeData(Buffer::Instance& data, bool end
     return Http::FilterDataStatus::Continue;
   }
 
+  maybeSpill(data);
   // Buffer until the complete request has been processed or the ConnectionManagerImpl sends a 413.
   return Http::FilterDataStatus::StopIterationAndBuffer;
 }
 
+void BufferFilter::maybeSpill(Buffer::Instance& data) {
+  if (!settings_->spillDirectory().has_value() || spill_failed_ ||
+      content_length_ <= settings_->spillMemoryBytes()) {
+    return;
+  }
+  // The file is only created once a body outgrows its share of memory.
+  if (spill_file_ == nullptr) {
+    spill_file_ = Buffer::SpillFile::create(settings_->spillDirectory().value());
+    if (spill_file_ == nullptr) {
+      ENVOY_STREAM_LOG(warn, "cannot create a spill file in {}: {}", *callbacks_,
+                       settings_->spillDirectory().value(), errorDetails(errno));
+      spill_failed_ = true;
+      return;
+    }
+  }
+  // The spilled data is moved along with the buffered body, so that it stays in the file up to
+  // the codec, and in the retries of the router.
+  if (!spill_file_->spill(data)) {
+    ENVOY_STREAM_LOG(warn, "cannot spill the request body: {}", *callbacks_, errorDetails(errno));
+    spill_failed_ = true;
+  }
+}
+
 Http::FilterTrailersStatus BufferFilter::decodeTrailers(Http::RequestTrailerMap&) {
   maybeAddContentLength();
 
@@ -9,6 +9,10 @@
 #include "envoy/http/filter.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/buffer/spill_file.h"
+#include "common/common/logger.h"
+
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -22,10 +26,15 @@ public:
 
   bool disabled() const { return disabled_; }
   uint64_t maxRequestBytes() const { return max_request_bytes_; }
+  // The directory request bodies are spilled to, unset if they are kept in memory.
+  const absl::optional<std::string>& spillDirectory() const { return spill_directory_; }
+  uint64_t spillMemoryBytes() const { return spill_memory_bytes_; }
 
 private:
   bool disabled_;
   uint64_t max_request_bytes_;
+  absl::optional<std::string> spill_directory_;
+  uint64_t spill_memory_bytes_{};
 };
 
 /**
@@ -46,7 +55,7 @@ using BufferFilterConfigSharedPtr = std::shared_ptr<BufferFilterConfig>;
 /**
  * A filter that is capable of buffering an entire request before dispatching it upstream.
  */
-class BufferFilter : public Http::StreamDecoderFilter {
+class BufferFilter : public Http::StreamDecoderFilter, Logger::Loggable<Logger::Id::filter> {
 public:
   BufferFilter(BufferFilterConfigSharedPtr config);
 
@@ -63,6 +72,7 @@ public:
 private:
   void initConfig();
   void maybeAddContentLength();
+  void maybeSpill(Buffer::Instance& data);
 
   BufferFilterConfigSharedPtr config_;
   const BufferFilterSettings* settings_;
@@ -70,6 +80,8 @@ private:
   Http::RequestHeaderMap* request_headers_{};
   uint64_t content_length_{};
   bool config_initialized_{};
+  Buffer::SpillFilePtr spill_file_;
+  bool spill_failed_{};
 };
 
 } // namespace BufferFilter
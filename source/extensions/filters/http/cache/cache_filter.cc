@@ -1,10 +1,13 @@
 #include "extensions/filters/http/cache/cache_filter.h"
 
+#include <tuple>
+
 #include "envoy/http/header_map.h"
 
 #include "common/common/enum_to_int.h"
 #include "common/http/headers.h"
 #include "common/http/utility.h"
+#include "common/protobuf/utility.h"
 
 #include "extensions/filters/http/cache/cacheability_utils.h"
 #include "extensions/filters/http/cache/inline_headers_handles.h"
@@ -26,14 +29,18 @@ inline bool isResponseNotModified(const Http::ResponseHeaderMap& response_header
 
 struct CacheResponseCodeDetailValues {
   const absl::string_view ResponseFromCacheFilter = "cache.response_from_cache_filter";
+  const absl::string_view ResponseFromCoalescedRequest = "cache.response_from_coalesced_request";
 };
 
 using CacheResponseCodeDetails = ConstSingleton<CacheResponseCodeDetailValues>;
 
 CacheFilter::CacheFilter(
     const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config, const std::string&,
-    Stats::Scope&, TimeSource& time_source, HttpCache& http_cache)
-    : time_source_(time_source), cache_(http_cache),
+    Stats::Scope&, TimeSource& time_source, HttpCache& http_cache,
+    RequestCoalescerSharedPtr coalescer)
+    : time_source_(time_source), cache_(http_cache), coalescer_(std::move(coalescer)),
+      fill_wait_timeout_(
+          PROTOBUF_GET_MS_OR_DEFAULT(config.request_coalescing(), wait_timeout, 5000)),
       vary_allow_list_(config.allowed_vary_headers()) {}
 
 void CacheFilter::onDestroy() {
@@ -44,6 +51,7 @@ void CacheFilter::onDestroy() {
   if (insert_) {
     insert_->onDestroy();
   }
+  leaveFill();
 }
 
 Http::FilterHeadersStatus CacheFilter::decodeHeaders(Http::RequestHeaderMap& headers,
@@ -65,6 +73,10 @@ Http::FilterHeadersStatus CacheFilter::decodeHeaders(Http::RequestHeaderMap& hea
 
   LookupRequest lookup_request(headers, time_source_.systemTime(), vary_allow_list_);
   request_allows_inserts_ = !lookup_request.requestCacheControl().no_store_;
+  // Range requests are not coalesced, as the waiters are served whole responses.
+  if (coalescer_ != nullptr && headers.get(Http::Headers::get().Range).empty()) {
+    fill_key_ = lookup_request.key();
+  }
   lookup_ = cache_.makeLookupContext(std::move(lookup_request));
 
   ASSERT(lookup_);
@@ -90,10 +102,13 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
 
   if (filter_state_ == FilterState::ValidatingCachedResponse && isResponseNotModified(headers)) {
     processSuccessfulValidation(headers);
+    fillHeaders(headers, lookup_result_->content_length_ == 0);
     // Stop the encoding stream until the cached response is fetched & added to the encoding stream.
     return Http::FilterHeadersStatus::StopIteration;
   }
 
+  fillHeaders(headers, end_stream);
+
   // Either a cache miss or a cache entry that is no longer valid.
   // Check if the new response can be cached.
   if (request_allows_inserts_ &&
@@ -117,6 +132,7 @@ Http::FilterDataStatus CacheFilter::encodeData(Buffer::Instance& data, bool end_
     // Stop the encoding stream until the cached response is fetched & added to the encoding stream.
     return Http::FilterDataStatus::StopIterationAndBuffer;
   }
+  fillData(data, end_stream);
   if (insert_) {
     ENVOY_STREAM_LOG(debug, "CacheFilter::encodeData inserting body", *encoder_callbacks_);
     // TODO(toddmgreer): Wait for the cache if necessary.
@@ -126,6 +142,22 @@ Http::FilterDataStatus CacheFilter::encodeData(Buffer::Instance& data, bool end_
   return Http::FilterDataStatus::Continue;
 }
 
+Http::FilterTrailersStatus CacheFilter::encodeTrailers(Http::ResponseTrailerMap& trailers) {
+  if (insert_) {
+    if (cache_.cacheInfo().supports_trailers_) {
+      ENVOY_STREAM_LOG(debug, "CacheFilter::encodeTrailers inserting trailers",
+                       *encoder_callbacks_);
+      insert_->insertTrailers(trailers);
+    } else {
+      // The response is incomplete without its trailers, so it is not inserted.
+      insert_->onDestroy();
+      insert_.reset();
+    }
+  }
+  fillTrailers(trailers);
+  return Http::FilterTrailersStatus::Continue;
+}
+
 void CacheFilter::getHeaders(Http::RequestHeaderMap& request_headers) {
   ASSERT(lookup_, "CacheFilter is trying to call getHeaders with no LookupContext");
 
@@ -241,8 +273,14 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
     lookup_result_ = std::make_unique<LookupResult>(std::move(result));
     filter_state_ = FilterState::ValidatingCachedResponse;
     injectValidationHeaders(request_headers);
+    if (waitForFill()) {
+      return;
+    }
     break;
   case CacheEntryStatus::Unusable:
+    if (waitForFill()) {
+      return;
+    }
     break;
   case CacheEntryStatus::NotSatisfiableRange:
     lookup_result_ = std::make_unique<LookupResult>(std::move(result));
@@ -316,9 +354,12 @@ void CacheFilter::onBody(Buffer::InstancePtr&& body) {
 
   const bool end_stream = remaining_ranges_.empty() && !response_has_trailers_;
 
-  filter_state_ == FilterState::DecodeServingFromCache
-      ? decoder_callbacks_->encodeData(*body, end_stream)
-      : encoder_callbacks_->addEncodedData(*body, true);
+  if (filter_state_ == FilterState::DecodeServingFromCache) {
+    decoder_callbacks_->encodeData(*body, end_stream);
+  } else {
+    fillData(*body, end_stream);
+    encoder_callbacks_->addEncodedData(*body, true);
+  }
 
   if (!remaining_ranges_.empty()) {
     getBody();
@@ -339,6 +380,7 @@ void CacheFilter::onTrailers(Http::ResponseTrailerMapPtr&& trailers) {
   if (filter_state_ == FilterState::DecodeServingFromCache) {
     decoder_callbacks_->encodeTrailers(std::move(trailers));
   } else {
+    fillTrailers(*trailers);
     Http::ResponseTrailerMap& response_trailers = encoder_callbacks_->addEncodedTrailers();
     response_trailers = std::move(*trailers);
   }
@@ -482,6 +524,146 @@ void CacheFilter::finalizeEncodingCachedResponse() {
   filter_state_ = FilterState::ResponseServedFromCache;
 }
 
+bool CacheFilter::waitForFill() {
+  if (!fill_key_.has_value()) {
+    return false;
+  }
+  bool filler;
+  std::tie(fill_, filler) = coalescer_->join(fill_key_.value());
+  if (filler) {
+    filling_ = true;
+    return false;
+  }
+
+  ENVOY_STREAM_LOG(debug, "CacheFilter waiting for the response of a coalesced request",
+                   *decoder_callbacks_);
+  // The fill notifies the waiters from the worker of the filler, hence the weak_ptr and the
+  // dispatcher of the filter, like the cache callbacks.
+  CacheFilterWeakPtr self = weak_from_this();
+  fill_waiter_id_ = fill_->addWaiter(decoder_callbacks_->dispatcher(), [self]() {
+    if (CacheFilterSharedPtr cache_filter = self.lock()) {
+      cache_filter->onFillProgress();
+    }
+  });
+  fill_timer_ = decoder_callbacks_->dispatcher().createTimer([this]() {
+    ENVOY_STREAM_LOG(debug, "CacheFilter timed out waiting for the response of a coalesced request",
+                     *decoder_callbacks_);
+    fallBackToUpstream();
+  });
+  fill_timer_->enableTimer(fill_wait_timeout_);
+  // The fill may have progressed before the waiter was added.
+  onFillProgress();
+  return true;
+}
+
+void CacheFilter::onFillProgress() {
+  if (filter_state_ == FilterState::Destroyed || fill_ == nullptr) {
+    return;
+  }
+  RequestCoalescer::Fill::Progress progress = fill_->read(fill_headers_read_, fill_body_read_);
+  if (!fill_headers_read_) {
+    if (progress.aborted_) {
+      ENVOY_STREAM_LOG(debug, "CacheFilter forwarding a request whose coalesced request failed",
+                       *decoder_callbacks_);
+      fallBackToUpstream();
+      return;
+    }
+    if (progress.headers_ == nullptr) {
+      return;
+    }
+    fill_timer_->disableTimer();
+    fill_headers_read_ = true;
+    filter_state_ = FilterState::DecodeServingFromCache;
+    decoder_callbacks_->streamInfo().setResponseFlag(
+        StreamInfo::ResponseFlag::ResponseFromCacheFilter);
+    decoder_callbacks_->streamInfo().setResponseCodeDetails(
+        CacheResponseCodeDetails::get().ResponseFromCoalescedRequest);
+    const bool end_stream = progress.end_stream_ && progress.body_->length() == 0 &&
+                            progress.trailers_ == nullptr;
+    decoder_callbacks_->encodeHeaders(std::move(progress.headers_), end_stream,
+                                      CacheResponseCodeDetails::get().ResponseFromCoalescedRequest);
+    if (end_stream) {
+      leaveFill();
+      filter_state_ = FilterState::ResponseServedFromCache;
+      return;
+    }
+  } else if (progress.aborted_) {
+    // Part of the response was served already, so the request cannot fall back to upstream.
+    leaveFill();
+    decoder_callbacks_->resetStream();
+    return;
+  }
+
+  // The trailers are only set once the response is complete.
+  const bool end_with_trailers = progress.trailers_ != nullptr;
+  if (progress.body_->length() > 0 || (progress.end_stream_ && !end_with_trailers)) {
+    fill_body_read_ += progress.body_->length();
+    decoder_callbacks_->encodeData(*progress.body_, progress.end_stream_ && !end_with_trailers);
+  }
+  if (end_with_trailers) {
+    decoder_callbacks_->encodeTrailers(std::move(progress.trailers_));
+  }
+  if (progress.end_stream_) {
+    leaveFill();
+    filter_state_ = FilterState::ResponseServedFromCache;
+  }
+}
+
+void CacheFilter::fallBackToUpstream() {
+  leaveFill();
+  decoder_callbacks_->continueDecoding();
+}
+
+void CacheFilter::fillHeaders(const Http::ResponseHeaderMap& headers, bool end_stream) {
+  if (!filling_ || fill_ == nullptr) {
+    return;
+  }
+  // Only the responses that could be served from the cache are shared, and a response that varies
+  // on request headers may not apply to the waiters.
+  if (!CacheabilityUtils::isCacheableResponse(headers, vary_allow_list_) ||
+      VaryHeader::hasVary(headers)) {
+    leaveFill();
+    return;
+  }
+  fill_->onHeaders(headers, end_stream);
+  if (end_stream) {
+    leaveFill();
+  }
+}
+
+void CacheFilter::fillData(const Buffer::Instance& data, bool end_stream) {
+  if (!filling_ || fill_ == nullptr) {
+    return;
+  }
+  fill_->onData(data, end_stream);
+  if (end_stream) {
+    leaveFill();
+  }
+}
+
+void CacheFilter::fillTrailers(const Http::ResponseTrailerMap& trailers) {
+  if (!filling_ || fill_ == nullptr) {
+    return;
+  }
+  fill_->onTrailers(trailers);
+  leaveFill();
+}
+
+void CacheFilter::leaveFill() {
+  if (fill_ == nullptr) {
+    return;
+  }
+  if (filling_) {
+    // Aborting a complete fill has no effect.
+    fill_->abort();
+    coalescer_->remove(fill_key_.value(), fill_);
+  } else {
+    fill_->removeWaiter(fill_waiter_id_);
+  }
+  fill_.reset();
+  fill_timer_.reset();
+}
+
 } // namespace Cache
 } // namespace HttpFilters
 } // namespace Extensions
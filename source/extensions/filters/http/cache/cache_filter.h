@@ -1,18 +1,23 @@
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "envoy/event/timer.h"
 #include "envoy/extensions/filters/http/cache/v3alpha/cache.pb.h"
 
 #include "common/common/logger.h"
 
 #include "extensions/filters/http/cache/cache_headers_utils.h"
 #include "extensions/filters/http/cache/http_cache.h"
+#include "extensions/filters/http/cache/request_coalescer.h"
 #include "extensions/filters/http/common/pass_through_filter.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
@@ -27,7 +32,7 @@ class CacheFilter : public Http::PassThroughFilter,
 public:
   CacheFilter(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config,
               const std::string& stats_prefix, Stats::Scope& scope, TimeSource& time_source,
-              HttpCache& http_cache);
+              HttpCache& http_cache, RequestCoalescerSharedPtr coalescer);
   // Http::StreamFilterBase
   void onDestroy() override;
   // Http::StreamDecoderFilter
@@ -37,6 +42,7 @@ public:
   Http::FilterHeadersStatus encodeHeaders(Http::ResponseHeaderMap& headers,
                                           bool end_stream) override;
   Http::FilterDataStatus encodeData(Buffer::Instance& buffer, bool end_stream) override;
+  Http::FilterTrailersStatus encodeTrailers(Http::ResponseTrailerMap& trailers) override;
 
 private:
   // Utility functions; make any necessary checks and call the corresponding lookup_ functions
@@ -75,8 +81,31 @@ private:
   // Updates filter_state_ and continues the encoding stream if necessary.
   void finalizeEncodingCachedResponse();
 
+  // Makes the request wait for the response of a concurrent request for the same key that missed
+  // in the cache, if the request may be coalesced. Returns false if there is none, in which case
+  // the request is forwarded upstream and its response is shared with the later requests.
+  bool waitForFill();
+
+  // Called on the worker of the filter whenever the fill it waits for progresses. Serves the part
+  // of the response that has not been served yet.
+  void onFillProgress();
+
+  // Stops waiting for the fill and forwards the request upstream.
+  void fallBackToUpstream();
+
+  // Shares the response being encoded with the waiters of the fill, if this request fills one.
+  void fillHeaders(const Http::ResponseHeaderMap& headers, bool end_stream);
+  void fillData(const Buffer::Instance& data, bool end_stream);
+  void fillTrailers(const Http::ResponseTrailerMap& trailers);
+
+  // Leaves the fill, aborting it if this request fills it and has not completed it.
+  void leaveFill();
+
   TimeSource& time_source_;
   HttpCache& cache_;
+  // Null unless request coalescing is enabled.
+  const RequestCoalescerSharedPtr coalescer_;
+  const std::chrono::milliseconds fill_wait_timeout_;
   LookupContextPtr lookup_;
   InsertContextPtr insert_;
   LookupResultPtr lookup_result_;
@@ -122,6 +151,19 @@ private:
   };
 
   FilterState filter_state_ = FilterState::Initial;
+
+  // The key of the request, if it may be coalesced.
+  absl::optional<Key> fill_key_;
+  // The fill that the request fills or waits for.
+  RequestCoalescer::FillSharedPtr fill_;
+  // True if the request fills fill_ rather than waiting for it.
+  bool filling_ = false;
+  uint64_t fill_waiter_id_ = 0;
+  // Falls back to upstream if the response of the fill does not start in time.
+  Event::TimerPtr fill_timer_;
+  // How much of the response of the fill has been served.
+  bool fill_headers_read_ = false;
+  uint64_t fill_body_read_ = 0;
 };
 
 using CacheFilterSharedPtr = std::shared_ptr<CacheFilter>;
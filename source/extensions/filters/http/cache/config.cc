@@ -18,11 +18,16 @@ Http::FilterFactoryCb CacheFilterFactory::createFilterFactoryFromProtoTyped(
         fmt::format("Didn't find a registered implementation for type: '{}'", type));
   }
 
-  return [config, stats_prefix, &context,
-          http_cache_factory](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+  HttpCacheSharedPtr http_cache = http_cache_factory->getCache(config, context);
+  // The coalescer is shared by the filters of all the workers.
+  RequestCoalescerSharedPtr coalescer =
+      config.has_request_coalescing() ? std::make_shared<RequestCoalescer>() : nullptr;
+
+  return [config, stats_prefix, &context, http_cache,
+          coalescer](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamFilter(std::make_shared<CacheFilter>(config, stats_prefix, context.scope(),
-                                                            context.timeSource(),
-                                                            http_cache_factory->getCache(config)));
+                                                            context.timeSource(), *http_cache,
+                                                            coalescer));
   };
 }
 
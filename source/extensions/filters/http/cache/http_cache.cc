@@ -7,6 +7,7 @@
 #include "envoy/http/codes.h"
 #include "envoy/http/header_map.h"
 
+#include "common/common/hash.h"
 #include "common/http/header_utility.h"
 #include "common/http/headers.h"
 #include "common/protobuf/utility.h"
@@ -53,6 +54,7 @@ LookupRequest::LookupRequest(const Http::RequestHeaderMap& request_headers, Syst
   key_.set_host(std::string(request_headers.getHostValue()));
   key_.set_path(std::string(request_headers.getPathValue()));
   key_.set_clear_http(forwarded_proto == scheme_values.Http);
+  key_hash_ = localHashKey(key_);
 
   vary_headers_ = vary_allow_list.possibleVariedHeaders(request_headers);
 }
@@ -61,7 +63,22 @@ LookupRequest::LookupRequest(const Http::RequestHeaderMap& request_headers, Syst
 // the same result, or a way must be provided to deal with a complete cache
 // flush. localHashKey however, can be changed at will.
 size_t stableHashKey(const Key& key) { return MessageUtil::hash(key); }
-size_t localHashKey(const Key& key) { return stableHashKey(key); }
+size_t localHashKey(const Key& key) {
+  // Hashes the fields rather than the serialized message, as every lookup hashes its key.
+  uint64_t hash = HashUtil::xxHash64(key.cluster_name());
+  hash = HashUtil::xxHash64(key.host(), hash);
+  hash = HashUtil::xxHash64(key.path(), hash);
+  hash = HashUtil::xxHash64(key.query(), hash);
+  hash = HashUtil::xxHash64(key.clear_http() ? "http" : "https", hash);
+  for (const std::string& field : key.custom_fields()) {
+    hash = HashUtil::xxHash64(field, hash);
+  }
+  for (const int64_t value : key.custom_ints()) {
+    hash = HashUtil::xxHash64(
+        absl::string_view(reinterpret_cast<const char*>(&value), sizeof(value)), hash);
+  }
+  return hash;
+}
 
 void LookupRequest::initializeRequestCacheControl(const Http::RequestHeaderMap& request_headers) {
   const absl::string_view cache_control =
@@ -9,6 +9,7 @@
 #include "envoy/config/typed_config.h"
 #include "envoy/extensions/filters/http/cache/v3alpha/cache.pb.h"
 #include "envoy/http/header_map.h"
+#include "envoy/server/factory_context.h"
 
 #include "common/common/assert.h"
 #include "common/common/logger.h"
@@ -170,6 +171,10 @@ using LookupResultPtr = std::unique_ptr<LookupResult>;
 // TODO(toddmgreer): Ensure that stability guarantees above are accurate.
 size_t stableHashKey(const Key& key);
 
+// Produces a hash of key that is only consistent within the process. It is cheaper to compute than
+// stableHashKey, and is precomputed by LookupRequest.
+size_t localHashKey(const Key& key);
+
 // The metadata associated with a cached response.
 // TODO(yosrym93): This could be changed to a proto if a need arises.
 // If a cache was created with the current interface, then it was changed to a proto, all the cache
@@ -196,6 +201,10 @@ public:
   // taken to ensure that meaningfully distinct responses have distinct keys.
   const Key& key() const { return key_; }
 
+  // The localHashKey of key(), which caches may use to index their entries in memory. Caches that
+  // modify the key have to hash it again.
+  size_t keyHash() const { return key_hash_; }
+
   // WARNING: Incomplete--do not use in production (yet).
   // Returns a LookupResult suitable for sending to the cache filter's
   // LookupHeadersCallback. Specifically,
@@ -217,6 +226,7 @@ private:
                           SystemTime::duration age) const;
 
   Key key_;
+  size_t key_hash_;
   std::vector<RawByteRange> request_range_spec_;
   // Time when this LookupRequest was created (in response to an HTTP request).
   SystemTime timestamp_;
@@ -234,6 +244,8 @@ private:
 struct CacheInfo {
   absl::string_view name_;
   bool supports_range_requests_ = false;
+  // True if the cache stores the trailers of the responses, which are otherwise not inserted.
+  bool supports_trailers_ = false;
 };
 
 using LookupBodyCallback = std::function<void(Buffer::InstancePtr&&)>;
@@ -366,6 +378,7 @@ public:
 
   virtual ~HttpCache() = default;
 };
+using HttpCacheSharedPtr = std::shared_ptr<HttpCache>;
 
 // Factory interface for cache implementations to implement and register.
 class HttpCacheFactory : public Config::TypedFactory {
@@ -373,10 +386,10 @@ public:
   // From UntypedFactory
   std::string category() const override { return "envoy.http.cache"; }
 
-  // Returns an HttpCache that will remain valid indefinitely (at least as long
-  // as the calling CacheFilter).
-  virtual HttpCache&
-  getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config) PURE;
+  // Returns an HttpCache, which the CacheFilters of the configuration share and keep alive.
+  virtual HttpCacheSharedPtr
+  getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config,
+           Server::Configuration::FactoryContext& context) PURE;
   ~HttpCacheFactory() override = default;
 
 private:
@@ -0,0 +1,879 @@
+#include "extensions/filters/http/cache/mmap_http_cache/mmap_http_cache.h"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include "envoy/api/os_sys_calls.h"
+#include "envoy/common/exception.h"
+#include "envoy/registry/registry.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/buffer/buffer_impl.h"
+#include "common/common/cleanup.h"
+#include "common/common/fmt.h"
+#include "common/common/lock_guard.h"
+#include "common/common/process_shared_mutex.h"
+#include "common/common/utility.h"
+#include "common/http/header_map_impl.h"
+#include "common/http/headers.h"
+
+#include "extensions/filters/http/cache/cache_headers_utils.h"
+
+#include "source/extensions/filters/http/cache/mmap_http_cache/config.pb.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+constexpr absl::string_view Name = "envoy.extensions.http.cache.mmap";
+
+constexpr uint64_t Magic = 0x31454843594f564e;
+// Increment this whenever the layout of the file changes, so that the files laid out by other
+// versions are reset rather than misread.
+constexpr uint32_t Version = 2;
+constexpr uint32_t NumStripes = 64;
+// The number of slots of a bucket of the index.
+constexpr uint32_t Ways = 4;
+constexpr uint64_t PageSize = 4096;
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+// Headers and trailers are stored as the sizes and bytes of their keys and values.
+void appendString(std::string& out, absl::string_view value) {
+  const uint32_t size = value.size();
+  out.append(reinterpret_cast<const char*>(&size), sizeof(size));
+  out.append(value.data(), value.size());
+}
+
+bool readString(absl::string_view& in, absl::string_view& value) {
+  uint32_t size;
+  if (in.size() < sizeof(size)) {
+    return false;
+  }
+  memcpy(&size, in.data(), sizeof(size));
+  in.remove_prefix(sizeof(size));
+  if (in.size() < size) {
+    return false;
+  }
+  value = in.substr(0, size);
+  in.remove_prefix(size);
+  return true;
+}
+
+std::string serializeHeaders(const Http::HeaderMap& headers) {
+  std::string out;
+  headers.iterate([&out](const Http::HeaderEntry& header) -> Http::HeaderMap::Iterate {
+    appendString(out, header.key().getStringView());
+    appendString(out, header.value().getStringView());
+    return Http::HeaderMap::Iterate::Continue;
+  });
+  return out;
+}
+
+template <class HeaderMapImplType>
+std::unique_ptr<HeaderMapImplType> parseHeaders(absl::string_view in) {
+  std::unique_ptr<HeaderMapImplType> headers = Http::createHeaderMap<HeaderMapImplType>({});
+  while (!in.empty()) {
+    absl::string_view key;
+    absl::string_view value;
+    if (!readString(in, key) || !readString(in, value)) {
+      return nullptr;
+    }
+    headers->addCopy(Http::LowerCaseString(std::string(key)), value);
+  }
+  return headers;
+}
+
+Key variedKey(const Key& key, const Http::ResponseHeaderMap& response_headers,
+              const Http::RequestHeaderMap& vary_headers) {
+  Key varied_key = key;
+  varied_key.add_custom_fields(
+      VaryHeader::createVaryKey(response_headers.get(Http::Headers::get().Vary), vary_headers));
+  return varied_key;
+}
+
+// Appends the content of an entry to a chain of slabs, which it frees unless it is handed over.
+class EntryWriter {
+public:
+  explicit EntryWriter(MmapHttpCache& cache) : cache_(cache) {}
+  ~EntryWriter() {
+    if (first_ != MmapHttpCache::NoSlab) {
+      cache_.freeSlabs(first_);
+    }
+  }
+
+  // Returns false if the cache has no slab left.
+  bool append(absl::string_view data) {
+    while (!data.empty()) {
+      if (tail_ == MmapHttpCache::NoSlab || offset_ == MmapHttpCache::slabDataSize()) {
+        const MmapHttpCache::SlabIndex slab = cache_.allocateSlab();
+        if (slab == MmapHttpCache::NoSlab) {
+          return false;
+        }
+        if (tail_ == MmapHttpCache::NoSlab) {
+          first_ = slab;
+        } else {
+          cache_.setNextSlab(tail_, slab);
+        }
+        tail_ = slab;
+        offset_ = 0;
+      }
+      const uint64_t length =
+          std::min<uint64_t>(data.size(), MmapHttpCache::slabDataSize() - offset_);
+      memcpy(cache_.slabData(tail_) + offset_, data.data(), length);
+      offset_ += length;
+      data.remove_prefix(length);
+    }
+    return true;
+  }
+
+  MmapHttpCache::SlabIndex first() const { return first_; }
+
+  // Hands the chain over to the caller.
+  MmapHttpCache::SlabIndex release() {
+    const MmapHttpCache::SlabIndex first = first_;
+    first_ = MmapHttpCache::NoSlab;
+    return first;
+  }
+
+private:
+  MmapHttpCache& cache_;
+  MmapHttpCache::SlabIndex first_{MmapHttpCache::NoSlab};
+  MmapHttpCache::SlabIndex tail_{MmapHttpCache::NoSlab};
+  uint64_t offset_{};
+};
+
+class MmapLookupContext : public LookupContext {
+public:
+  MmapLookupContext(MmapHttpCache& cache, LookupRequest&& request)
+      : cache_(cache), request_(std::move(request)) {}
+  ~MmapLookupContext() override {
+    if (entry_ != MmapHttpCache::NoSlab) {
+      cache_.release(entry_);
+    }
+  }
+
+  void getHeaders(LookupHeadersCallback&& cb) override {
+    entry_ = cache_.lookup(request_.key());
+    Http::ResponseHeaderMapPtr response_headers = entryHeaders();
+    if (response_headers != nullptr && VaryHeader::hasVary(*response_headers)) {
+      // The entry of the key only flags that its responses vary, which are the entries of the
+      // varied keys.
+      cache_.release(entry_);
+      entry_ =
+          cache_.lookup(variedKey(request_.key(), *response_headers, request_.getVaryHeaders()));
+      response_headers = entryHeaders();
+    }
+    if (response_headers == nullptr) {
+      cb(LookupResult{});
+      return;
+    }
+    LookupResult result = request_.makeLookupResult(
+        std::move(response_headers), ResponseMetadata{info_.response_time_}, info_.body_size_);
+    result.has_trailers_ = info_.trailers_size_ > 0;
+    cb(std::move(result));
+  }
+
+  void getBody(const AdjustedByteRange& range, LookupBodyCallback&& cb) override {
+    ASSERT(range.end() <= info_.body_size_, "Attempt to read past end of body.");
+    auto body = std::make_unique<Buffer::OwnedImpl>();
+    const uint64_t slab_data_size = MmapHttpCache::slabDataSize();
+    uint64_t offset = info_.key_size_ + info_.headers_size_ + range.begin();
+    uint64_t remaining = range.length();
+    MmapHttpCache::SlabIndex slab = entry_;
+    for (; slab != MmapHttpCache::NoSlab && offset >= slab_data_size; offset -= slab_data_size) {
+      slab = cache_.nextSlab(slab);
+    }
+    while (remaining > 0 && slab != MmapHttpCache::NoSlab) {
+      const uint64_t length = std::min(remaining, slab_data_size - offset);
+      // Each fragment holds a reference on the entry, so that the body stays valid until it has
+      // been sent, even if the entry is replaced or evicted meanwhile.
+      cache_.acquire(entry_);
+      body->addBufferFragment(*new Buffer::BufferFragmentImpl(
+          cache_.slabData(slab) + offset, length,
+          [&cache = cache_, entry = entry_](const void*, size_t,
+                                            const Buffer::BufferFragmentImpl* fragment) {
+            cache.release(entry);
+            delete fragment;
+          }));
+      remaining -= length;
+      offset = 0;
+      slab = cache_.nextSlab(slab);
+    }
+    cb(std::move(body));
+  }
+
+  void getTrailers(LookupTrailersCallback&& cb) override {
+    ASSERT(info_.trailers_size_ > 0, "Attempt to read trailers of an entry without trailers.");
+    // The trailers follow the body.
+    Http::ResponseTrailerMapPtr trailers = parseHeaders<Http::ResponseTrailerMapImpl>(
+        cache_.read(entry_, info_.key_size_ + info_.headers_size_ + info_.body_size_,
+                    info_.trailers_size_));
+    cb(trailers != nullptr ? std::move(trailers)
+                           : Http::createHeaderMap<Http::ResponseTrailerMapImpl>({}));
+  }
+
+  const LookupRequest& request() const { return request_; }
+  MmapHttpCache::SlabIndex entry() const { return entry_; }
+  const MmapHttpCache::EntryInfo& info() const { return info_; }
+  void onDestroy() override {}
+
+private:
+  // Returns the headers of the current entry, or nullptr if there is none.
+  Http::ResponseHeaderMapPtr entryHeaders() {
+    if (entry_ == MmapHttpCache::NoSlab) {
+      return nullptr;
+    }
+    info_ = cache_.entryInfo(entry_);
+    Http::ResponseHeaderMapPtr response_headers = parseHeaders<Http::ResponseHeaderMapImpl>(
+        cache_.read(entry_, info_.key_size_, info_.headers_size_));
+    if (response_headers == nullptr) {
+      cache_.release(entry_);
+      entry_ = MmapHttpCache::NoSlab;
+    }
+    return response_headers;
+  }
+
+  MmapHttpCache& cache_;
+  const LookupRequest request_;
+  MmapHttpCache::SlabIndex entry_{MmapHttpCache::NoSlab};
+  MmapHttpCache::EntryInfo info_{};
+};
+
+class MmapInsertContext : public InsertContext {
+public:
+  MmapInsertContext(LookupContext& lookup_context, MmapHttpCache& cache)
+      : key_(dynamic_cast<MmapLookupContext&>(lookup_context).request().key()),
+        entry_vary_headers_(
+            dynamic_cast<MmapLookupContext&>(lookup_context).request().getVaryHeaders()),
+        cache_(cache), writer_(cache) {}
+
+  void insertHeaders(const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata, bool end_stream) override {
+    ASSERT(!committed_);
+    // The body is written to the slabs as it arrives, after the key and the headers.
+    if (VaryHeader::hasVary(response_headers)) {
+      varied_key_ = variedKey(key_, response_headers, entry_vary_headers_);
+      vary_header_ = std::string(
+          response_headers.get(Http::Headers::get().Vary)[0]->value().getStringView());
+    }
+    const std::string serialized_key =
+        (vary_header_.empty() ? key_ : varied_key_).SerializeAsString();
+    const std::string serialized_headers = serializeHeaders(response_headers);
+    info_.key_size_ = serialized_key.size();
+    info_.headers_size_ = serialized_headers.size();
+    info_.response_time_ = metadata.response_time_;
+    full_ = !writer_.append(serialized_key) || !writer_.append(serialized_headers);
+    if (end_stream) {
+      commit();
+    }
+  }
+
+  void insertBody(const Buffer::Instance& chunk, InsertCallback ready_for_next_chunk,
+                  bool end_stream) override {
+    ASSERT(!committed_);
+    ASSERT(ready_for_next_chunk || end_stream);
+
+    for (const Buffer::RawSlice& slice : chunk.getRawSlices()) {
+      if (full_) {
+        break;
+      }
+      full_ = !writer_.append({static_cast<const char*>(slice.mem_), slice.len_});
+    }
+    info_.body_size_ += chunk.length();
+    if (end_stream) {
+      commit();
+    } else {
+      // A response that does not fit in the cache is not inserted.
+      ready_for_next_chunk(!full_);
+    }
+  }
+
+  void insertTrailers(const Http::ResponseTrailerMap& trailers) override {
+    ASSERT(!committed_);
+    // The trailers are written after the body, and complete the response.
+    const std::string serialized_trailers = serializeHeaders(trailers);
+    info_.trailers_size_ = serialized_trailers.size();
+    if (!full_) {
+      full_ = !writer_.append(serialized_trailers);
+    }
+    commit();
+  }
+
+  void onDestroy() override {}
+
+private:
+  void commit() {
+    committed_ = true;
+    if (full_) {
+      return;
+    }
+    cache_.setEntryInfo(writer_.first(), info_);
+    if (vary_header_.empty()) {
+      cache_.publish(key_, writer_.release(), false);
+      return;
+    }
+    cache_.publish(varied_key_, writer_.release(), false);
+
+    // Add a special entry to flag that this request generates varied responses.
+    Http::ResponseHeaderMapPtr vary_only_map =
+        Http::createHeaderMap<Http::ResponseHeaderMapImpl>({});
+    vary_only_map->setCopy(Http::Headers::get().Vary, vary_header_);
+    const std::string serialized_key = key_.SerializeAsString();
+    const std::string serialized_headers = serializeHeaders(*vary_only_map);
+    EntryWriter writer(cache_);
+    if (writer.append(serialized_key) && writer.append(serialized_headers)) {
+      cache_.setEntryInfo(writer.first(), {static_cast<uint32_t>(serialized_key.size()),
+                                           static_cast<uint32_t>(serialized_headers.size()), 0,
+                                           info_.response_time_, 0});
+      cache_.publish(key_, writer.release(), true);
+    }
+  }
+
+  const Key key_;
+  Key varied_key_;
+  std::string vary_header_;
+  const Http::RequestHeaderMap& entry_vary_headers_;
+  MmapHttpCache& cache_;
+  EntryWriter writer_;
+  MmapHttpCache::EntryInfo info_{};
+  bool full_ = false;
+  bool committed_ = false;
+};
+
+} // namespace
+
+struct MmapHttpCache::FileHeader {
+  uint64_t magic_;
+  uint32_t version_;
+  uint32_t num_buckets_;
+  uint32_t num_slabs_;
+  // The free slabs are the chain starting at free_head_, and the slabs that were never used, from
+  // num_used_ on.
+  uint32_t free_head_;
+  uint32_t num_free_;
+  uint32_t num_used_;
+  uint64_t size_;
+  uint64_t index_offset_;
+  uint64_t slabs_offset_;
+  // Stamps the uses of the entries, for eviction.
+  std::atomic<uint64_t> clock_;
+  std::atomic<uint32_t> eviction_hand_;
+  pthread_mutex_t free_lock_;
+  pthread_mutex_t stripes_[NumStripes];
+};
+
+struct MmapHttpCache::IndexSlot {
+  uint64_t hash_;
+  uint64_t last_used_;
+  SlabIndex entry_;
+};
+
+struct MmapHttpCache::SlabHeader {
+  SlabIndex next_;
+  // The fields below are only used in the first slab of an entry.
+  std::atomic<uint32_t> refs_;
+  uint32_t key_size_;
+  uint32_t headers_size_;
+  uint64_t body_size_;
+  int64_t response_time_ns_;
+  uint32_t trailers_size_;
+};
+
+MmapHttpCache::MmapHttpCache(const std::string& path, uint64_t size_bytes) : size_(size_bytes) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+  if (fd_ == -1) {
+    throw EnvoyException(
+        fmt::format("cannot open cache file {}: {}", path, errorDetails(errno)));
+  }
+  Cleanup cleanup([this, &os_sys_calls]() {
+    if (base_ != nullptr) {
+      munmap(base_, size_);
+    }
+    os_sys_calls.close(fd_);
+  });
+
+  // The first process to open the file holds it exclusively while it checks it, the others then
+  // share it.
+  const bool first = ::flock(fd_, LOCK_EX | LOCK_NB) == 0;
+  if (first) {
+    const Api::SysCallIntResult result = os_sys_calls.ftruncate(fd_, size_bytes);
+    if (result.rc_ == -1) {
+      throw EnvoyException(fmt::format("cannot resize cache file {} to {} bytes: {}", path,
+                                       size_bytes, errorDetails(result.errno_)));
+    }
+  } else {
+    RELEASE_ASSERT(::flock(fd_, LOCK_SH) == 0, "");
+    struct stat file_stat;
+    RELEASE_ASSERT(::fstat(fd_, &file_stat) == 0, "");
+    if (static_cast<uint64_t>(file_stat.st_size) != size_bytes) {
+      throw EnvoyException(fmt::format("cache file {} is shared with a size of {} bytes, not {}",
+                                       path, file_stat.st_size, size_bytes));
+    }
+  }
+
+  const Api::SysCallPtrResult result =
+      os_sys_calls.mmap(nullptr, size_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (result.rc_ == MAP_FAILED) {
+    throw EnvoyException(
+        fmt::format("cannot map cache file {}: {}", path, errorDetails(result.errno_)));
+  }
+  base_ = static_cast<uint8_t*>(result.rc_);
+  header_ = reinterpret_cast<FileHeader*>(base_);
+
+  const bool valid = header_->magic_ == Magic && header_->version_ == Version &&
+                     header_->size_ == size_bytes;
+  if (first) {
+    if (valid) {
+      recover();
+    } else {
+      initialize(size_bytes);
+    }
+    RELEASE_ASSERT(::flock(fd_, LOCK_SH) == 0, "");
+  } else if (!valid) {
+    throw EnvoyException(fmt::format("cache file {} was laid out by another version", path));
+  }
+  index_ = reinterpret_cast<IndexSlot*>(base_ + header_->index_offset_);
+  slabs_ = base_ + header_->slabs_offset_;
+  cleanup.cancel();
+}
+
+MmapHttpCache::~MmapHttpCache() {
+  munmap(base_, size_);
+  Api::OsSysCallsSingleton::get().close(fd_);
+}
+
+void MmapHttpCache::initialize(uint64_t size_bytes) {
+  // The magic is written last, so that a file whose initialization was interrupted is initialized
+  // again.
+  header_->magic_ = 0;
+  header_->version_ = Version;
+  header_->size_ = size_bytes;
+  header_->index_offset_ = alignUp(sizeof(FileHeader), alignof(IndexSlot));
+
+  // The index has two slots for each slab.
+  const uint64_t bytes_per_slab = SlabSize + 2 * sizeof(IndexSlot);
+  const uint64_t overhead = header_->index_offset_ + PageSize;
+  uint64_t num_slabs = std::min<uint64_t>(
+      size_bytes > overhead ? (size_bytes - overhead) / bytes_per_slab : 0, NoSlab - 1);
+  uint64_t num_buckets = 0;
+  for (; num_slabs > 0; --num_slabs) {
+    num_buckets = std::max<uint64_t>(1, 2 * num_slabs / Ways);
+    header_->slabs_offset_ =
+        alignUp(header_->index_offset_ + num_buckets * Ways * sizeof(IndexSlot), PageSize);
+    if (header_->slabs_offset_ + num_slabs * SlabSize <= size_bytes) {
+      break;
+    }
+  }
+  if (num_slabs == 0) {
+    throw EnvoyException(fmt::format("cache size of {} bytes is too small", size_bytes));
+  }
+  header_->num_buckets_ = num_buckets;
+  header_->num_slabs_ = num_slabs;
+  header_->free_head_ = NoSlab;
+  header_->num_free_ = 0;
+  header_->num_used_ = 0;
+  header_->clock_ = 0;
+  header_->eviction_hand_ = 0;
+  Thread::ProcessSharedMutex::initialize(header_->free_lock_);
+  for (pthread_mutex_t& stripe : header_->stripes_) {
+    Thread::ProcessSharedMutex::initialize(stripe);
+  }
+
+  index_ = reinterpret_cast<IndexSlot*>(base_ + header_->index_offset_);
+  for (uint64_t i = 0; i < num_buckets * Ways; ++i) {
+    index_[i] = {0, 0, NoSlab};
+  }
+  header_->magic_ = Magic;
+}
+
+void MmapHttpCache::recover() {
+  // No other process has the file open, so the mutexes may be left locked by a process that died.
+  Thread::ProcessSharedMutex::initialize(header_->free_lock_);
+  for (pthread_mutex_t& stripe : header_->stripes_) {
+    Thread::ProcessSharedMutex::initialize(stripe);
+  }
+  index_ = reinterpret_cast<IndexSlot*>(base_ + header_->index_offset_);
+  slabs_ = base_ + header_->slabs_offset_;
+
+  // The slabs of the entries of the index are kept, with the reference of the index only, and the
+  // other ones are free. Entries whose chains are broken are dropped.
+  const uint32_t num_used = header_->num_used_;
+  std::vector<uint32_t> owners(num_used, 0);
+  for (uint64_t i = 0; i < static_cast<uint64_t>(header_->num_buckets_) * Ways; ++i) {
+    IndexSlot& slot = index_[i];
+    if (slot.entry_ == NoSlab) {
+      continue;
+    }
+    const uint32_t owner = i + 1;
+    bool valid = true;
+    std::vector<SlabIndex> chain;
+    for (SlabIndex slab = slot.entry_; slab != NoSlab; slab = slabHeader(slab).next_) {
+      if (slab >= num_used || owners[slab] != 0) {
+        valid = false;
+        break;
+      }
+      owners[slab] = owner;
+      chain.push_back(slab);
+    }
+    if (!valid) {
+      for (const SlabIndex slab : chain) {
+        owners[slab] = 0;
+      }
+      slot.entry_ = NoSlab;
+      continue;
+    }
+    slabHeader(slot.entry_).refs_ = 1;
+  }
+
+  header_->free_head_ = NoSlab;
+  header_->num_free_ = 0;
+  for (SlabIndex slab = 0; slab < num_used; ++slab) {
+    if (owners[slab] == 0) {
+      slabHeader(slab).next_ = header_->free_head_;
+      header_->free_head_ = slab;
+      ++header_->num_free_;
+    }
+  }
+}
+
+LookupContextPtr MmapHttpCache::makeLookupContext(LookupRequest&& request) {
+  return std::make_unique<MmapLookupContext>(*this, std::move(request));
+}
+
+InsertContextPtr MmapHttpCache::makeInsertContext(LookupContextPtr&& lookup_context) {
+  ASSERT(lookup_context != nullptr);
+  return std::make_unique<MmapInsertContext>(*lookup_context, *this);
+}
+
+void MmapHttpCache::updateHeaders(const LookupContext& lookup_context,
+                                  const Http::ResponseHeaderMap& response_headers,
+                                  const ResponseMetadata& metadata) {
+  const auto& mmap_lookup_context = dynamic_cast<const MmapLookupContext&>(lookup_context);
+  const SlabIndex entry = mmap_lookup_context.entry();
+  if (entry == NoSlab) {
+    return;
+  }
+  // The headers sit between the key and the body, so the entry is written again with the new
+  // headers, and the key, the body and the trailers of the looked up entry. The lookup holds a
+  // reference on that entry, which keeps it valid meanwhile.
+  const EntryInfo& info = mmap_lookup_context.info();
+  const std::string serialized_key = read(entry, 0, info.key_size_);
+  Key key;
+  if (!key.ParseFromString(serialized_key)) {
+    return;
+  }
+  const std::string serialized_headers = serializeHeaders(response_headers);
+  EntryWriter writer(*this);
+  if (!writer.append(serialized_key) || !writer.append(serialized_headers)) {
+    return;
+  }
+  uint64_t offset = info.key_size_ + info.headers_size_;
+  uint64_t remaining = info.body_size_ + info.trailers_size_;
+  SlabIndex slab = entry;
+  for (; slab != NoSlab && offset >= slabDataSize(); offset -= slabDataSize()) {
+    slab = nextSlab(slab);
+  }
+  while (remaining > 0 && slab != NoSlab) {
+    const uint64_t length = std::min(remaining, slabDataSize() - offset);
+    if (!writer.append({reinterpret_cast<const char*>(slabData(slab)) + offset, length})) {
+      return;
+    }
+    remaining -= length;
+    offset = 0;
+    slab = nextSlab(slab);
+  }
+  setEntryInfo(writer.first(), {info.key_size_, static_cast<uint32_t>(serialized_headers.size()),
+                                info.body_size_, metadata.response_time_, info.trailers_size_});
+  replace(key, entry, writer.release());
+}
+
+CacheInfo MmapHttpCache::cacheInfo() const {
+  CacheInfo cache_info;
+  cache_info.name_ = Name;
+  cache_info.supports_trailers_ = true;
+  return cache_info;
+}
+
+MmapHttpCache::SlabIndex MmapHttpCache::lookup(const Key& key) {
+  const uint64_t hash = stableHashKey(key);
+  const std::string serialized_key = key.SerializeAsString();
+  const uint32_t bucket_index = hash % header_->num_buckets_;
+  Thread::ProcessSharedMutex stripe(header_->stripes_[bucket_index % NumStripes]);
+  Thread::LockGuard lock(stripe);
+  IndexSlot* slots = bucket(bucket_index);
+  for (uint32_t i = 0; i < Ways; ++i) {
+    IndexSlot& slot = slots[i];
+    if (slot.entry_ != NoSlab && slot.hash_ == hash && keyMatches(slot.entry_, serialized_key)) {
+      slot.last_used_ = header_->clock_.fetch_add(1, std::memory_order_relaxed);
+      acquire(slot.entry_);
+      return slot.entry_;
+    }
+  }
+  return NoSlab;
+}
+
+void MmapHttpCache::acquire(SlabIndex entry) {
+  slabHeader(entry).refs_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MmapHttpCache::release(SlabIndex entry) {
+  if (slabHeader(entry).refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    freeSlabs(entry);
+  }
+}
+
+void MmapHttpCache::publish(const Key& key, SlabIndex entry, bool only_if_absent) {
+  const uint64_t hash = stableHashKey(key);
+  const std::string serialized_key = key.SerializeAsString();
+  const uint32_t bucket_index = hash % header_->num_buckets_;
+  slabHeader(entry).refs_.store(1, std::memory_order_release);
+  SlabIndex replaced = NoSlab;
+  {
+    Thread::ProcessSharedMutex stripe(header_->stripes_[bucket_index % NumStripes]);
+    Thread::LockGuard lock(stripe);
+    IndexSlot* slots = bucket(bucket_index);
+    IndexSlot* victim = nullptr;
+    for (uint32_t i = 0; i < Ways; ++i) {
+      IndexSlot& slot = slots[i];
+      if (slot.entry_ != NoSlab && slot.hash_ == hash && keyMatches(slot.entry_, serialized_key)) {
+        victim = &slot;
+        break;
+      }
+    }
+    if (victim != nullptr && only_if_absent) {
+      replaced = entry;
+    } else {
+      if (victim == nullptr) {
+        // A free slot is taken, or else the least recently used entry of the bucket makes room.
+        for (uint32_t i = 0; i < Ways; ++i) {
+          if (slots[i].entry_ == NoSlab) {
+            victim = &slots[i];
+            break;
+          }
+          if (victim == nullptr || slots[i].last_used_ < victim->last_used_) {
+            victim = &slots[i];
+          }
+        }
+      }
+      replaced = victim->entry_;
+      victim->hash_ = hash;
+      victim->last_used_ = header_->clock_.fetch_add(1, std::memory_order_relaxed);
+      victim->entry_ = entry;
+    }
+  }
+  if (replaced != NoSlab) {
+    release(replaced);
+  }
+}
+
+void MmapHttpCache::replace(const Key& key, SlabIndex expected, SlabIndex entry) {
+  const uint64_t hash = stableHashKey(key);
+  const uint32_t bucket_index = hash % header_->num_buckets_;
+  slabHeader(entry).refs_.store(1, std::memory_order_release);
+  SlabIndex replaced = entry;
+  {
+    Thread::ProcessSharedMutex stripe(header_->stripes_[bucket_index % NumStripes]);
+    Thread::LockGuard lock(stripe);
+    IndexSlot* slots = bucket(bucket_index);
+    for (uint32_t i = 0; i < Ways; ++i) {
+      // The expected entry is pinned by the caller, so its slab is not reused by another entry.
+      IndexSlot& slot = slots[i];
+      if (slot.entry_ == expected && slot.hash_ == hash) {
+        replaced = expected;
+        slot.last_used_ = header_->clock_.fetch_add(1, std::memory_order_relaxed);
+        slot.entry_ = entry;
+        break;
+      }
+    }
+  }
+  release(replaced);
+}
+
+MmapHttpCache::SlabIndex MmapHttpCache::allocateSlab() {
+  // Evicting the least recently used entry of each bucket in turn frees slabs unless the entries
+  // are all pinned by readers.
+  for (uint32_t evictions = 0;; ++evictions) {
+    {
+      Thread::ProcessSharedMutex free_lock(header_->free_lock_);
+      Thread::LockGuard lock(free_lock);
+      SlabIndex slab = NoSlab;
+      if (header_->free_head_ != NoSlab) {
+        slab = header_->free_head_;
+        header_->free_head_ = slabHeader(slab).next_;
+        --header_->num_free_;
+      } else if (header_->num_used_ < header_->num_slabs_) {
+        slab = header_->num_used_++;
+      }
+      if (slab != NoSlab) {
+        SlabHeader& slab_header = slabHeader(slab);
+        slab_header.next_ = NoSlab;
+        slab_header.refs_.store(0, std::memory_order_relaxed);
+        return slab;
+      }
+    }
+    if (evictions == header_->num_buckets_) {
+      return NoSlab;
+    }
+    evictOne();
+  }
+}
+
+void MmapHttpCache::evictOne() {
+  const uint32_t bucket_index =
+      header_->eviction_hand_.fetch_add(1, std::memory_order_relaxed) % header_->num_buckets_;
+  SlabIndex evicted = NoSlab;
+  {
+    Thread::ProcessSharedMutex stripe(header_->stripes_[bucket_index % NumStripes]);
+    Thread::LockGuard lock(stripe);
+    IndexSlot* slots = bucket(bucket_index);
+    IndexSlot* victim = nullptr;
+    for (uint32_t i = 0; i < Ways; ++i) {
+      if (slots[i].entry_ != NoSlab &&
+          (victim == nullptr || slots[i].last_used_ < victim->last_used_)) {
+        victim = &slots[i];
+      }
+    }
+    if (victim != nullptr) {
+      evicted = victim->entry_;
+      victim->entry_ = NoSlab;
+    }
+  }
+  if (evicted != NoSlab) {
+    release(evicted);
+  }
+}
+
+void MmapHttpCache::freeSlabs(SlabIndex first) {
+  SlabIndex last = first;
+  uint32_t count = 1;
+  while (slabHeader(last).next_ != NoSlab) {
+    last = slabHeader(last).next_;
+    ++count;
+  }
+  Thread::ProcessSharedMutex free_lock(header_->free_lock_);
+  Thread::LockGuard lock(free_lock);
+  slabHeader(last).next_ = header_->free_head_;
+  header_->free_head_ = first;
+  header_->num_free_ += count;
+}
+
+MmapHttpCache::EntryInfo MmapHttpCache::entryInfo(SlabIndex entry) const {
+  const SlabHeader& slab_header = slabHeader(entry);
+  return {slab_header.key_size_, slab_header.headers_size_, slab_header.body_size_,
+          SystemTime(std::chrono::duration_cast<SystemTime::duration>(
+              std::chrono::nanoseconds(slab_header.response_time_ns_))),
+          slab_header.trailers_size_};
+}
+
+void MmapHttpCache::setEntryInfo(SlabIndex entry, const EntryInfo& info) {
+  SlabHeader& slab_header = slabHeader(entry);
+  slab_header.key_size_ = info.key_size_;
+  slab_header.headers_size_ = info.headers_size_;
+  slab_header.body_size_ = info.body_size_;
+  slab_header.response_time_ns_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                      info.response_time_.time_since_epoch())
+                                      .count();
+  slab_header.trailers_size_ = info.trailers_size_;
+}
+
+std::string MmapHttpCache::read(SlabIndex entry, uint64_t offset, uint64_t size) const {
+  std::string out;
+  out.reserve(size);
+  SlabIndex slab = entry;
+  for (; slab != NoSlab && offset >= slabDataSize(); offset -= slabDataSize()) {
+    slab = nextSlab(slab);
+  }
+  while (size > 0 && slab != NoSlab) {
+    const uint64_t length = std::min(size, slabDataSize() - offset);
+    out.append(reinterpret_cast<const char*>(slabData(slab)) + offset, length);
+    size -= length;
+    offset = 0;
+    slab = nextSlab(slab);
+  }
+  return out;
+}
+
+MmapHttpCache::SlabIndex MmapHttpCache::nextSlab(SlabIndex slab) const {
+  return slabHeader(slab).next_;
+}
+
+void MmapHttpCache::setNextSlab(SlabIndex slab, SlabIndex next) { slabHeader(slab).next_ = next; }
+
+uint8_t* MmapHttpCache::slabData(SlabIndex slab) const {
+  return slabs_ + slab * SlabSize + sizeof(SlabHeader);
+}
+
+uint64_t MmapHttpCache::slabDataSize() { return SlabSize - sizeof(SlabHeader); }
+
+uint32_t MmapHttpCache::numSlabs() const { return header_->num_slabs_; }
+
+uint32_t MmapHttpCache::numFreeSlabs() const {
+  Thread::ProcessSharedMutex free_lock(header_->free_lock_);
+  Thread::LockGuard lock(free_lock);
+  return header_->num_free_ + header_->num_slabs_ - header_->num_used_;
+}
+
+bool MmapHttpCache::keyMatches(SlabIndex entry, absl::string_view serialized_key) const {
+  return slabHeader(entry).key_size_ == serialized_key.size() &&
+         read(entry, 0, serialized_key.size()) == serialized_key;
+}
+
+MmapHttpCache::IndexSlot* MmapHttpCache::bucket(uint32_t bucket_index) const {
+  return index_ + static_cast<uint64_t>(bucket_index) * Ways;
+}
+
+MmapHttpCache::SlabHeader& MmapHttpCache::slabHeader(SlabIndex slab) const {
+  return *reinterpret_cast<SlabHeader*>(slabs_ + static_cast<uint64_t>(slab) * SlabSize);
+}
+
+class MmapHttpCacheFactory : public HttpCacheFactory {
+public:
+  // From UntypedFactory
+  std::string name() const override { return std::string(Name); }
+  // From TypedFactory
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<envoy::source::extensions::filters::http::cache::MmapHttpCacheConfig>();
+  }
+  // From HttpCacheFactory
+  HttpCacheSharedPtr
+  getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config,
+           Server::Configuration::FactoryContext&) override {
+    envoy::source::extensions::filters::http::cache::MmapHttpCacheConfig mmap_config;
+    MessageUtil::unpackTo(config.typed_config(), mmap_config);
+    absl::MutexLock lock(&mutex_);
+    std::shared_ptr<MmapHttpCache>& cache = caches_[mmap_config.path()];
+    if (cache == nullptr) {
+      cache = std::make_shared<MmapHttpCache>(mmap_config.path(), mmap_config.size_bytes());
+    }
+    return cache;
+  }
+
+private:
+  absl::Mutex mutex_;
+  // The caches by path, which live as long as the process as the filters share them.
+  absl::flat_hash_map<std::string, std::shared_ptr<MmapHttpCache>> caches_ ABSL_GUARDED_BY(mutex_);
+};
+
+static Registry::RegisterFactory<MmapHttpCacheFactory, HttpCacheFactory> register_;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
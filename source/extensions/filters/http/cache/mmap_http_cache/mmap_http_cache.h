@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "common/common/non_copyable.h"
+
+#include "extensions/filters/http/cache/http_cache.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * Cache backend storing the responses in a memory-mapped file. Every process that opens the same
+ * file shares its content, so that the cached responses survive hot restarts, and the file may be
+ * larger than memory, the kernel paging it in and out as needed.
+ *
+ * The file holds a header, an index and fixed size slabs. The index is a set-associative hash
+ * table of the stable hashes of the keys, whose buckets are guarded by a stripe of process shared
+ * mutexes. An entry is a chain of slabs holding its key, its headers, its body and its trailers,
+ * and the body is read in place as buffer fragments. The first slab of an entry counts the
+ * references to the entry, one for the index and one for each reader, and the slabs of an entry
+ * that is replaced or evicted are only reused once the last reader has released them. When no slab
+ * is free, the least recently used entry of the next bucket in turn is evicted. Updating the
+ * headers of an entry writes a new entry in its place.
+ *
+ * The first process to open the file checks it, resets it if it was laid out by another version
+ * and rebuilds the free slabs, so that the slabs left pinned or half written by a process that
+ * died are reclaimed.
+ */
+class MmapHttpCache : public HttpCache, NonCopyable {
+public:
+  using SlabIndex = uint32_t;
+  static constexpr SlabIndex NoSlab = UINT32_MAX;
+  static constexpr uint64_t SlabSize = 16 * 1024;
+
+  /**
+   * Opens or creates the file of the cache.
+   * @param path supplies the path of the file.
+   * @param size_bytes supplies the size of the file.
+   * @throw EnvoyException if the file cannot be opened or has another size.
+   */
+  MmapHttpCache(const std::string& path, uint64_t size_bytes);
+  ~MmapHttpCache() override;
+
+  // HttpCache
+  LookupContextPtr makeLookupContext(LookupRequest&& request) override;
+  InsertContextPtr makeInsertContext(LookupContextPtr&& lookup_context) override;
+  void updateHeaders(const LookupContext& lookup_context,
+                     const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata) override;
+  CacheInfo cacheInfo() const override;
+
+  /**
+   * @return the first slab of the entry of a key with a reference taken on it, or NoSlab.
+   */
+  SlabIndex lookup(const Key& key);
+
+  /**
+   * Takes a reference on an entry.
+   */
+  void acquire(SlabIndex entry);
+
+  /**
+   * Releases a reference on an entry, freeing its slabs with the last one.
+   */
+  void release(SlabIndex entry);
+
+  /**
+   * Makes an entry, whose slabs the caller owns, the entry of a key, replacing the previous one.
+   * @param key supplies the key of the entry.
+   * @param entry supplies the first slab of the entry.
+   * @param only_if_absent supplies whether to free the entry instead of replacing another one.
+   */
+  void publish(const Key& key, SlabIndex entry, bool only_if_absent);
+
+  /**
+   * Makes an entry, whose slabs the caller owns, the entry of a key in place of another entry,
+   * or frees it if the key has another entry by now.
+   * @param key supplies the key of the entries.
+   * @param expected supplies the first slab of the entry to replace, which the caller pins.
+   * @param entry supplies the first slab of the entry.
+   */
+  void replace(const Key& key, SlabIndex expected, SlabIndex entry);
+
+  /**
+   * @return a slab taken off the free slabs, evicting entries if there is none, or NoSlab if the
+   *         entries that could be evicted are all pinned.
+   */
+  SlabIndex allocateSlab();
+
+  /**
+   * Frees a chain of slabs that is not in the index.
+   */
+  void freeSlabs(SlabIndex first);
+
+  struct EntryInfo {
+    uint32_t key_size_;
+    uint32_t headers_size_;
+    uint64_t body_size_;
+    SystemTime response_time_;
+    uint32_t trailers_size_;
+  };
+
+  EntryInfo entryInfo(SlabIndex entry) const;
+  void setEntryInfo(SlabIndex entry, const EntryInfo& info);
+
+  /**
+   * Copies bytes of the content of an entry, which spans its chain of slabs.
+   */
+  std::string read(SlabIndex entry, uint64_t offset, uint64_t size) const;
+
+  /**
+   * @return the next slab of a chain, or NoSlab.
+   */
+  SlabIndex nextSlab(SlabIndex slab) const;
+  void setNextSlab(SlabIndex slab, SlabIndex next);
+
+  /**
+   * @return the bytes of a slab available for the content of an entry.
+   */
+  uint8_t* slabData(SlabIndex slab) const;
+  static uint64_t slabDataSize();
+
+  uint32_t numSlabs() const;
+  uint32_t numFreeSlabs() const;
+
+private:
+  struct FileHeader;
+  struct IndexSlot;
+  struct SlabHeader;
+
+  void initialize(uint64_t size_bytes);
+  void recover();
+  void evictOne();
+  bool keyMatches(SlabIndex entry, absl::string_view serialized_key) const;
+  IndexSlot* bucket(uint32_t bucket_index) const;
+  SlabHeader& slabHeader(SlabIndex slab) const;
+
+  int fd_{-1};
+  uint8_t* base_{};
+  uint64_t size_{};
+  FileHeader* header_{};
+  IndexSlot* index_{};
+  uint8_t* slabs_{};
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,108 @@
+#include "extensions/filters/http/cache/request_coalescer.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/http/header_map_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+void RequestCoalescer::Fill::onHeaders(const Http::ResponseHeaderMap& headers, bool end_stream) {
+  absl::MutexLock lock(&mutex_);
+  ASSERT(headers_ == nullptr && !aborted_);
+  headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(headers);
+  complete_ = end_stream;
+  notifyWaiters();
+}
+
+void RequestCoalescer::Fill::onData(const Buffer::Instance& data, bool end_stream) {
+  absl::MutexLock lock(&mutex_);
+  ASSERT(headers_ != nullptr && !complete_ && !aborted_);
+  const uint64_t size = body_.size();
+  body_.resize(size + data.length());
+  data.copyOut(0, data.length(), &body_[size]);
+  complete_ = end_stream;
+  notifyWaiters();
+}
+
+void RequestCoalescer::Fill::onTrailers(const Http::ResponseTrailerMap& trailers) {
+  absl::MutexLock lock(&mutex_);
+  ASSERT(headers_ != nullptr && !complete_ && !aborted_);
+  trailers_ = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(trailers);
+  complete_ = true;
+  notifyWaiters();
+}
+
+void RequestCoalescer::Fill::abort() {
+  absl::MutexLock lock(&mutex_);
+  if (complete_ || aborted_) {
+    return;
+  }
+  aborted_ = true;
+  notifyWaiters();
+}
+
+uint64_t RequestCoalescer::Fill::addWaiter(Event::Dispatcher& dispatcher,
+                                           std::function<void()> cb) {
+  absl::MutexLock lock(&mutex_);
+  const uint64_t id = next_waiter_id_++;
+  waiters_.emplace(id, Waiter{dispatcher, std::move(cb)});
+  return id;
+}
+
+void RequestCoalescer::Fill::removeWaiter(uint64_t id) {
+  absl::MutexLock lock(&mutex_);
+  waiters_.erase(id);
+}
+
+RequestCoalescer::Fill::Progress RequestCoalescer::Fill::read(bool headers_read,
+                                                              uint64_t offset) const {
+  absl::MutexLock lock(&mutex_);
+  Progress progress;
+  progress.aborted_ = aborted_;
+  if (headers_ == nullptr) {
+    return progress;
+  }
+  if (!headers_read) {
+    progress.headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*headers_);
+  }
+  ASSERT(offset <= body_.size());
+  progress.body_ =
+      std::make_unique<Buffer::OwnedImpl>(body_.data() + offset, body_.size() - offset);
+  if (trailers_ != nullptr) {
+    progress.trailers_ = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*trailers_);
+  }
+  progress.end_stream_ = complete_;
+  return progress;
+}
+
+void RequestCoalescer::Fill::notifyWaiters() {
+  // The waiters read the fill on their own worker.
+  for (const auto& waiter : waiters_) {
+    waiter.second.dispatcher_.post(waiter.second.cb_);
+  }
+}
+
+std::pair<RequestCoalescer::FillSharedPtr, bool> RequestCoalescer::join(const Key& key) {
+  absl::MutexLock lock(&mutex_);
+  FillSharedPtr& fill = fills_[key];
+  if (fill != nullptr) {
+    return {fill, false};
+  }
+  fill = std::make_shared<Fill>();
+  return {fill, true};
+}
+
+void RequestCoalescer::remove(const Key& key, const FillSharedPtr& fill) {
+  absl::MutexLock lock(&mutex_);
+  auto it = fills_.find(key);
+  if (it != fills_.end() && it->second == fill) {
+    fills_.erase(it);
+  }
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/header_map.h"
+
+#include "common/common/non_copyable.h"
+#include "common/protobuf/utility.h"
+
+#include "source/extensions/filters/http/cache/key.pb.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * Coalesces the concurrent requests that miss in the cache for the same key, across the workers.
+ * The first request to miss is the filler of a fill: it is forwarded upstream and feeds its
+ * response to the fill as it encodes it. The later requests are waiters of the fill: rather than
+ * being forwarded upstream too, they are notified on their own dispatcher whenever the fill
+ * progresses, and read the part of the response they have not sent yet.
+ */
+class RequestCoalescer : NonCopyable {
+public:
+  class Fill : NonCopyable {
+  public:
+    // The part of the response that a waiter has not read yet.
+    struct Progress {
+      // The headers, if they had not been read and the fill has received them.
+      Http::ResponseHeaderMapPtr headers_;
+      // The body received after the offset read from, once the fill has received the headers, or
+      // nullptr.
+      Buffer::InstancePtr body_;
+      // The trailers, once the fill has received them, or nullptr.
+      Http::ResponseTrailerMapPtr trailers_;
+      // Whether the response is complete, the body or else the trailers being its last part.
+      bool end_stream_ = false;
+      // Whether the filler ended the fill without a complete response.
+      bool aborted_ = false;
+    };
+
+    /**
+     * Called by the filler with the headers of the response.
+     */
+    void onHeaders(const Http::ResponseHeaderMap& headers, bool end_stream);
+
+    /**
+     * Called by the filler with the body of the response.
+     */
+    void onData(const Buffer::Instance& data, bool end_stream);
+
+    /**
+     * Called by the filler with the trailers of the response, which complete it.
+     */
+    void onTrailers(const Http::ResponseTrailerMap& trailers);
+
+    /**
+     * Called by the filler when the response cannot be shared or will not complete.
+     */
+    void abort();
+
+    /**
+     * Adds a waiter to the fill.
+     * @param dispatcher supplies the dispatcher on which the waiter is notified.
+     * @param cb supplies the callback notifying the waiter that the fill has progressed.
+     * @return the id of the waiter.
+     */
+    uint64_t addWaiter(Event::Dispatcher& dispatcher, std::function<void()> cb);
+
+    /**
+     * Removes a waiter, which is not notified anymore.
+     */
+    void removeWaiter(uint64_t id);
+
+    /**
+     * @param headers_read supplies whether the waiter has read the headers.
+     * @param offset supplies how many bytes of the body the waiter has read.
+     * @return the part of the response that the waiter has not read.
+     */
+    Progress read(bool headers_read, uint64_t offset) const;
+
+  private:
+    struct Waiter {
+      Event::Dispatcher& dispatcher_;
+      std::function<void()> cb_;
+    };
+
+    void notifyWaiters() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+    mutable absl::Mutex mutex_;
+    Http::ResponseHeaderMapPtr headers_ ABSL_GUARDED_BY(mutex_);
+    std::string body_ ABSL_GUARDED_BY(mutex_);
+    Http::ResponseTrailerMapPtr trailers_ ABSL_GUARDED_BY(mutex_);
+    bool complete_ ABSL_GUARDED_BY(mutex_) = false;
+    bool aborted_ ABSL_GUARDED_BY(mutex_) = false;
+    absl::flat_hash_map<uint64_t, Waiter> waiters_ ABSL_GUARDED_BY(mutex_);
+    uint64_t next_waiter_id_ ABSL_GUARDED_BY(mutex_) = 0;
+  };
+  using FillSharedPtr = std::shared_ptr<Fill>;
+
+  /**
+   * Joins the fill of a key, starting one if there is none.
+   * @return the fill, and whether the caller started it and is its filler rather than a waiter.
+   */
+  std::pair<FillSharedPtr, bool> join(const Key& key);
+
+  /**
+   * Removes the fill of a key once its filler is done with it, so that the next requests for the
+   * key look up the cache again.
+   */
+  void remove(const Key& key, const FillSharedPtr& fill);
+
+private:
+  absl::Mutex mutex_;
+  absl::flat_hash_map<Key, FillSharedPtr, MessageUtil, MessageUtil> fills_ ABSL_GUARDED_BY(mutex_);
+};
+
+using RequestCoalescerSharedPtr = std::shared_ptr<RequestCoalescer>;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
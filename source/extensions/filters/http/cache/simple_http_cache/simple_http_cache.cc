@@ -1,12 +1,20 @@
 #include "extensions/filters/http/cache/simple_http_cache/simple_http_cache.h"
 
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
 #include "envoy/registry/registry.h"
+#include "envoy/singleton/manager.h"
 
 #include "common/buffer/buffer_impl.h"
 #include "common/http/header_map_impl.h"
+#include "common/protobuf/utility.h"
 
 #include "source/extensions/filters/http/cache/simple_http_cache/config.pb.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
@@ -49,6 +57,7 @@ class SimpleInsertContext : public InsertContext {
 public:
   SimpleInsertContext(LookupContext& lookup_context, SimpleHttpCache& cache)
       : key_(dynamic_cast<SimpleLookupContext&>(lookup_context).request().key()),
+        key_hash_(dynamic_cast<SimpleLookupContext&>(lookup_context).request().keyHash()),
         entry_vary_headers_(
             dynamic_cast<SimpleLookupContext&>(lookup_context).request().getVaryHeaders()),
         cache_(cache) {}
@@ -85,15 +94,12 @@ public:
 private:
   void commit() {
     committed_ = true;
-    if (VaryHeader::hasVary(*response_headers_)) {
-      cache_.varyInsert(key_, std::move(response_headers_), std::move(metadata_), body_.toString(),
-                        entry_vary_headers_);
-    } else {
-      cache_.insert(key_, std::move(response_headers_), std::move(metadata_), body_.toString());
-    }
+    cache_.insert(key_, key_hash_, std::move(response_headers_), std::move(metadata_),
+                  body_.toString(), entry_vary_headers_);
   }
 
   Key key_;
+  const size_t key_hash_;
   Http::ResponseHeaderMapPtr response_headers_;
   ResponseMetadata metadata_;
   const Http::RequestHeaderMap& entry_vary_headers_;
@@ -101,8 +107,40 @@ private:
   Buffer::OwnedImpl body_;
   bool committed_ = false;
 };
+
+// The share of the memory budget that the protected segment may take.
+constexpr uint64_t ProtectedSharePercent = 80;
+
+bool keysEqual(const Key& lhs, const Key& rhs) {
+  return lhs.cluster_name() == rhs.cluster_name() && lhs.host() == rhs.host() &&
+         lhs.path() == rhs.path() && lhs.query() == rhs.query() &&
+         lhs.clear_http() == rhs.clear_http() &&
+         std::equal(lhs.custom_fields().begin(), lhs.custom_fields().end(),
+                    rhs.custom_fields().begin(), rhs.custom_fields().end()) &&
+         std::equal(lhs.custom_ints().begin(), lhs.custom_ints().end(), rhs.custom_ints().begin(),
+                    rhs.custom_ints().end());
+}
+
+std::string joinVaryHeaders(const Http::HeaderMap::GetResult& vary_header) {
+  std::string joined;
+  for (size_t i = 0; i < vary_header.size(); i++) {
+    absl::StrAppend(&joined, i == 0 ? "" : ",", vary_header[i]->value().getStringView());
+  }
+  return joined;
+}
+
 } // namespace
 
+bool SimpleHttpCache::HashedKeyEqual::operator()(const HashedKey& lhs,
+                                                 const HashedKey& rhs) const {
+  return lhs.hash_ == rhs.hash_ && keysEqual(*lhs.key_, *rhs.key_);
+}
+
+SimpleHttpCache::SimpleHttpCache(uint64_t max_size_bytes, Stats::Scope& scope)
+    : max_size_bytes_(max_size_bytes),
+      stats_({ALL_SIMPLE_HTTP_CACHE_STATS(POOL_COUNTER_PREFIX(scope, "simple_http_cache."),
+                                          POOL_GAUGE_PREFIX(scope, "simple_http_cache."))}) {}
+
 LookupContextPtr SimpleHttpCache::makeLookupContext(LookupRequest&& request) {
   return std::make_unique<SimpleLookupContext>(*this, std::move(request));
 }
@@ -115,82 +153,148 @@ void SimpleHttpCache::updateHeaders(const LookupContext&, const Http::ResponseHe
 }
 
 SimpleHttpCache::Entry SimpleHttpCache::lookup(const LookupRequest& request) {
-  absl::ReaderMutexLock lock(&mutex_);
-  auto iter = map_.find(request.key());
+  // Hits reorder the segments, hence the exclusive lock.
+  absl::MutexLock lock(&mutex_);
+  auto iter = map_.find(HashedKey{&request.key(), request.keyHash()});
   if (iter == map_.end()) {
+    stats_.misses_.inc();
     return Entry{};
   }
-  ASSERT(iter->second.response_headers_);
-
-  if (VaryHeader::hasVary(*iter->second.response_headers_)) {
-    return varyLookup(request, iter->second.response_headers_);
-  } else {
-    return SimpleHttpCache::Entry{
-        Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*iter->second.response_headers_),
-        iter->second.metadata_, iter->second.body_};
+  const KeyEntries& key_entries = *iter->second;
+  const std::string vary_key =
+      key_entries.vary_headers_ == nullptr
+          ? ""
+          : VaryHeader::createVaryKey(key_entries.vary_headers_->get(Http::Headers::get().Vary),
+                                      request.getVaryHeaders());
+  auto variant = key_entries.variants_.find(vary_key);
+  if (variant == key_entries.variants_.end()) {
+    stats_.misses_.inc();
+    return Entry{};
   }
+  stats_.hits_.inc();
+  const EntryList::iterator stored = variant->second;
+  touch(stored);
+  const Entry& entry = stored->entry_;
+  return Entry{Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*entry.response_headers_),
+               entry.metadata_, entry.body_};
 }
 
-void SimpleHttpCache::insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
-                             ResponseMetadata&& metadata, std::string&& body) {
-  absl::WriterMutexLock lock(&mutex_);
-  map_[key] =
-      SimpleHttpCache::Entry{std::move(response_headers), std::move(metadata), std::move(body)};
-}
-
-SimpleHttpCache::Entry
-SimpleHttpCache::varyLookup(const LookupRequest& request,
-                            const Http::ResponseHeaderMapPtr& response_headers) {
-  // This method should be called from lookup, which holds the mutex for reading.
-  mutex_.AssertReaderHeld();
-
+void SimpleHttpCache::insert(const Key& key, size_t key_hash,
+                             Http::ResponseHeaderMapPtr&& response_headers,
+                             ResponseMetadata&& metadata, std::string&& body,
+                             const Http::RequestHeaderMap& request_vary_headers) {
   const auto vary_header = response_headers->get(Http::Headers::get().Vary);
-  ASSERT(!vary_header.empty());
-
-  Key varied_request_key = request.key();
-  const std::string vary_key = VaryHeader::createVaryKey(vary_header, request.getVaryHeaders());
-  varied_request_key.add_custom_fields(vary_key);
+  const std::string vary = joinVaryHeaders(vary_header);
+  std::string vary_key =
+      vary_header.empty() ? "" : VaryHeader::createVaryKey(vary_header, request_vary_headers);
+  const uint64_t size =
+      key.ByteSizeLong() + vary_key.size() + response_headers->byteSize() + body.size();
+  if (max_size_bytes_ != 0 && size > max_size_bytes_) {
+    return;
+  }
 
-  auto iter = map_.find(varied_request_key);
+  absl::MutexLock lock(&mutex_);
+  auto iter = map_.find(HashedKey{&key, key_hash});
+  if (iter != map_.end()) {
+    KeyEntries& key_entries = *iter->second;
+    const std::string previous_vary =
+        key_entries.vary_headers_ == nullptr
+            ? ""
+            : joinVaryHeaders(key_entries.vary_headers_->get(Http::Headers::get().Vary));
+    if (previous_vary != vary) {
+      // The previous responses varied on other headers, so they would not be looked up anymore.
+      // Removing the last of them removes the key.
+      std::vector<EntryList::iterator> variants;
+      for (const auto& variant : key_entries.variants_) {
+        variants.push_back(variant.second);
+      }
+      for (const EntryList::iterator& variant : variants) {
+        remove(variant);
+      }
+      iter = map_.end();
+    } else {
+      auto variant = key_entries.variants_.find(vary_key);
+      if (variant != key_entries.variants_.end()) {
+        // Replacing the only response of the key removes the key.
+        const bool last = key_entries.variants_.size() == 1;
+        remove(variant->second);
+        if (last) {
+          iter = map_.end();
+        }
+      }
+    }
+  }
   if (iter == map_.end()) {
-    return SimpleHttpCache::Entry{};
+    auto key_entries = std::make_unique<KeyEntries>();
+    key_entries->key_ = key;
+    key_entries->key_hash_ = key_hash;
+    if (!vary_header.empty()) {
+      key_entries->vary_headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>({});
+      for (const Http::HeaderEntry* entry : vary_header) {
+        key_entries->vary_headers_->addCopy(Http::Headers::get().Vary,
+                                            entry->value().getStringView());
+      }
+    }
+    const HashedKey hashed_key{&key_entries->key_, key_hash};
+    iter = map_.emplace(hashed_key, std::move(key_entries)).first;
   }
-  ASSERT(iter->second.response_headers_);
 
-  return SimpleHttpCache::Entry{
-      Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*iter->second.response_headers_),
-      iter->second.metadata_, iter->second.body_};
+  KeyEntries& key_entries = *iter->second;
+  probation_.push_front(StoredEntry{
+      &key_entries, vary_key,
+      Entry{std::move(response_headers), std::move(metadata), std::move(body)}, size, false});
+  key_entries.variants_.emplace(std::move(vary_key), probation_.begin());
+  bytes_stored_ += size;
+  stats_.inserts_.inc();
+  stats_.entries_.inc();
+  stats_.bytes_stored_.add(size);
+  evict();
 }
 
-void SimpleHttpCache::varyInsert(const Key& request_key,
-                                 Http::ResponseHeaderMapPtr&& response_headers,
-                                 ResponseMetadata&& metadata, std::string&& body,
-                                 const Http::RequestHeaderMap& request_vary_headers) {
-  absl::WriterMutexLock lock(&mutex_);
-
-  const auto vary_header = response_headers->get(Http::Headers::get().Vary);
-  ASSERT(!vary_header.empty());
+void SimpleHttpCache::touch(EntryList::iterator entry) {
+  if (entry->protected_) {
+    protected_.splice(protected_.begin(), protected_, entry);
+    return;
+  }
+  entry->protected_ = true;
+  protected_bytes_ += entry->size_;
+  protected_.splice(protected_.begin(), probation_, entry);
+  if (max_size_bytes_ == 0) {
+    return;
+  }
+  while (protected_bytes_ > max_size_bytes_ * ProtectedSharePercent / 100 &&
+         protected_.size() > 1) {
+    const EntryList::iterator demoted = std::prev(protected_.end());
+    demoted->protected_ = false;
+    protected_bytes_ -= demoted->size_;
+    probation_.splice(probation_.begin(), protected_, demoted);
+  }
+}
 
-  // Insert the varied response.
-  Key varied_request_key = request_key;
-  const std::string vary_key = VaryHeader::createVaryKey(vary_header, request_vary_headers);
-  varied_request_key.add_custom_fields(vary_key);
-  map_[varied_request_key] =
-      SimpleHttpCache::Entry{std::move(response_headers), std::move(metadata), std::move(body)};
+void SimpleHttpCache::remove(EntryList::iterator entry) {
+  KeyEntries& key_entries = *entry->key_entries_;
+  key_entries.variants_.erase(entry->vary_key_);
+  bytes_stored_ -= entry->size_;
+  stats_.entries_.dec();
+  stats_.bytes_stored_.sub(entry->size_);
+  if (entry->protected_) {
+    protected_bytes_ -= entry->size_;
+    protected_.erase(entry);
+  } else {
+    probation_.erase(entry);
+  }
+  if (key_entries.variants_.empty()) {
+    map_.erase(map_.find(HashedKey{&key_entries.key_, key_entries.key_hash_}));
+  }
+}
 
-  // Add a special entry to flag that this request generates varied responses.
-  auto iter = map_.find(request_key);
-  if (iter == map_.end()) {
-    Http::ResponseHeaderMapPtr vary_only_map =
-        Http::createHeaderMap<Http::ResponseHeaderMapImpl>({});
-    // TODO(mattklein123): Support multiple vary headers and/or just make the vary header inline.
-    vary_only_map->setCopy(Http::Headers::get().Vary, vary_header[0]->value().getStringView());
-    // TODO(cbdm): In a cache that evicts entries, we could maintain a list of the "varykey"s that
-    // we have inserted as the body for this first lookup. This way, we would know which keys we
-    // have inserted for that resource. For the first entry simply use vary_key as the entry_list,
-    // for future entries append vary_key to existing list.
-    std::string entry_list;
-    map_[request_key] = SimpleHttpCache::Entry{std::move(vary_only_map), {}, std::move(entry_list)};
+void SimpleHttpCache::evict() {
+  while (max_size_bytes_ != 0 && bytes_stored_ > max_size_bytes_) {
+    // The response just inserted, at the front of the probationary segment, is evicted last.
+    EntryList& segment = probation_.size() > 1 || protected_.empty() ? probation_ : protected_;
+    ASSERT(!segment.empty());
+    remove(std::prev(segment.end()));
+    stats_.evictions_.inc();
   }
 }
 
@@ -201,6 +305,9 @@ InsertContextPtr SimpleHttpCache::makeInsertContext(LookupContextPtr&& lookup_co
 
 constexpr absl::string_view Name = "envoy.extensions.http.cache.simple";
 
+// Singleton registration via macro defined in envoy/singleton/manager.h
+SINGLETON_MANAGER_REGISTRATION(simple_http_cache_singleton);
+
 CacheInfo SimpleHttpCache::cacheInfo() const {
   CacheInfo cache_info;
   cache_info.name_ = Name;
@@ -217,13 +324,16 @@ public:
         envoy::source::extensions::filters::http::cache::SimpleHttpCacheConfig>();
   }
   // From HttpCacheFactory
-  HttpCache&
-  getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig&) override {
-    return cache_;
+  HttpCacheSharedPtr
+  getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config,
+           Server::Configuration::FactoryContext& context) override {
+    envoy::source::extensions::filters::http::cache::SimpleHttpCacheConfig simple_config;
+    MessageUtil::unpackTo(config.typed_config(), simple_config);
+    return context.singletonManager().getTyped<SimpleHttpCache>(
+        SINGLETON_MANAGER_REGISTERED_NAME(simple_http_cache_singleton), [&simple_config, &context] {
+          return std::make_shared<SimpleHttpCache>(simple_config.max_size_bytes(), context.scope());
+        });
   }
-
-private:
-  SimpleHttpCache cache_;
 };
 
 static Registry::RegisterFactory<SimpleHttpCacheFactory, HttpCacheFactory> register_;
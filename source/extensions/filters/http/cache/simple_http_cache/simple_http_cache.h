@@ -1,6 +1,12 @@
 #pragma once
 
-#include "common/protobuf/utility.h"
+#include <list>
+#include <memory>
+#include <string>
+
+#include "envoy/singleton/instance.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 
 #include "extensions/filters/http/cache/http_cache.h"
 
@@ -13,20 +19,45 @@ namespace Extensions {
 namespace HttpFilters {
 namespace Cache {
 
-// Example cache backend that never evicts. Not suitable for production use.
-class SimpleHttpCache : public HttpCache {
-private:
+/**
+ * All SimpleHttpCache stats. @see stats_macros.h
+ */
+#define ALL_SIMPLE_HTTP_CACHE_STATS(COUNTER, GAUGE)                                                \
+  COUNTER(evictions)                                                                               \
+  COUNTER(hits)                                                                                    \
+  COUNTER(inserts)                                                                                 \
+  COUNTER(misses)                                                                                  \
+  GAUGE(bytes_stored, NeverImport)                                                                 \
+  GAUGE(entries, NeverImport)
+
+/**
+ * Struct definition for all SimpleHttpCache stats. @see stats_macros.h
+ */
+struct SimpleHttpCacheStats {
+  ALL_SIMPLE_HTTP_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+// Example in-memory cache backend. Not suitable for production use.
+//
+// Once the responses exceed the memory budget, they are evicted in segmented LRU order: a response
+// enters the probationary segment, and moves to the protected segment when it is hit, so that the
+// responses that are requested once do not evict the popular ones. The responses of a key are
+// indexed by the hash that LookupRequest precomputes, and its variants by their vary key, so that
+// a lookup costs the same whatever the number of variants.
+class SimpleHttpCache : public HttpCache, public Singleton::Instance {
+public:
   struct Entry {
     Http::ResponseHeaderMapPtr response_headers_;
     ResponseMetadata metadata_;
     std::string body_;
   };
 
-  // Looks for a response that has been varied. Only called from lookup.
-  Entry varyLookup(const LookupRequest& request,
-                   const Http::ResponseHeaderMapPtr& response_headers);
+  /**
+   * @param max_size_bytes supplies the memory budget of the responses, unbounded if 0.
+   * @param scope supplies the scope of the stats, which are prefixed with "simple_http_cache.".
+   */
+  SimpleHttpCache(uint64_t max_size_bytes, Stats::Scope& scope);
 
-public:
   // HttpCache
   LookupContextPtr makeLookupContext(LookupRequest&& request) override;
   InsertContextPtr makeInsertContext(LookupContextPtr&& lookup_context) override;
@@ -35,17 +66,64 @@ public:
                      const ResponseMetadata& metadata) override;
   CacheInfo cacheInfo() const override;
 
+  // Returns a copy of the response to the request, or an empty entry.
   Entry lookup(const LookupRequest& request);
-  void insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
-              ResponseMetadata&& metadata, std::string&& body);
 
-  // Inserts a response that has been varied on certain headers.
-  void varyInsert(const Key& request_key, Http::ResponseHeaderMapPtr&& response_headers,
-                  ResponseMetadata&& metadata, std::string&& body,
-                  const Http::RequestHeaderMap& request_vary_headers);
+  // Inserts a response, varied on request_vary_headers if it has a vary header.
+  void insert(const Key& key, size_t key_hash, Http::ResponseHeaderMapPtr&& response_headers,
+              ResponseMetadata&& metadata, std::string&& body,
+              const Http::RequestHeaderMap& request_vary_headers);
+
+private:
+  struct KeyEntries;
+
+  // A cached response, in the list of its segment.
+  struct StoredEntry {
+    KeyEntries* key_entries_;
+    std::string vary_key_;
+    Entry entry_;
+    uint64_t size_;
+    bool protected_;
+  };
+  using EntryList = std::list<StoredEntry>;
+
+  // The responses cached for a key.
+  struct KeyEntries {
+    Key key_;
+    size_t key_hash_;
+    // The vary header of the responses, or nullptr if they do not vary.
+    Http::ResponseHeaderMapPtr vary_headers_;
+    // The responses by vary key, which is empty if they do not vary.
+    absl::flat_hash_map<std::string, EntryList::iterator> variants_;
+  };
+
+  // Indexes the keys by the hash of the LookupRequest, without copying the key of the lookups.
+  struct HashedKey {
+    const Key* key_;
+    size_t hash_;
+  };
+  struct HashedKeyHash {
+    size_t operator()(const HashedKey& key) const { return key.hash_; }
+  };
+  struct HashedKeyEqual {
+    bool operator()(const HashedKey& lhs, const HashedKey& rhs) const;
+  };
+
+  // Moves a response to the front of the protected segment, demoting the least recently used
+  // protected responses to the probationary segment as needed.
+  void touch(EntryList::iterator entry) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void remove(EntryList::iterator entry) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void evict() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  const uint64_t max_size_bytes_;
+  SimpleHttpCacheStats stats_;
   absl::Mutex mutex_;
-  absl::flat_hash_map<Key, Entry, MessageUtil, MessageUtil> map_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<HashedKey, std::unique_ptr<KeyEntries>, HashedKeyHash, HashedKeyEqual>
+      map_ ABSL_GUARDED_BY(mutex_);
+  EntryList probation_ ABSL_GUARDED_BY(mutex_);
+  EntryList protected_ ABSL_GUARDED_BY(mutex_);
+  uint64_t bytes_stored_ ABSL_GUARDED_BY(mutex_){};
+  uint64_t protected_bytes_ ABSL_GUARDED_BY(mutex_){};
 };
 
 } // namespace Cache
@@ -0,0 +1,35 @@
+#include "extensions/filters/http/common/compressor/compressed_response_cache.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Common {
+namespace Compressors {
+
+CompressedResponseCache::CompressedResponseCache(uint64_t max_size_bytes, uint32_t max_body_bytes,
+                                                 bool key_by_content_hash)
+    : max_body_bytes_(max_body_bytes), key_by_content_hash_(key_by_content_hash),
+      bodies_(max_size_bytes) {}
+
+CompressedResponseCache::Body CompressedResponseCache::lookup(const std::string& key) {
+  absl::MutexLock lock(&mutex_);
+  const Body* body = bodies_.find(key);
+  return body != nullptr ? *body : nullptr;
+}
+
+void CompressedResponseCache::insert(const std::string& key, std::string&& body) {
+  const uint64_t cost = key.size() + body.size();
+  absl::MutexLock lock(&mutex_);
+  bodies_.insert(key, std::make_shared<const std::string>(std::move(body)), cost);
+}
+
+uint64_t CompressedResponseCache::sizeBytes() const {
+  absl::MutexLock lock(&mutex_);
+  return bodies_.cost();
+}
+
+} // namespace Compressors
+} // namespace Common
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "common/common/lru_cache.h"
+#include "common/common/non_copyable.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Common {
+namespace Compressors {
+
+/**
+ * Cache of compressed response bodies, shared by the workers running the filters of a compressor
+ * filter config, so that a body compressed once is served again without compressing it. The
+ * bodies are evicted in least recently used order once their total size, keys included, exceeds
+ * the size of the cache.
+ */
+class CompressedResponseCache : NonCopyable {
+public:
+  using Body = std::shared_ptr<const std::string>;
+
+  /**
+   * @param max_size_bytes supplies the maximum total size of the cached bodies and their keys.
+   * @param max_body_bytes supplies the maximum size of an uncompressed body to cache.
+   * @param key_by_content_hash supplies whether the responses without an entity tag are cached,
+   *        keyed by a hash of their body.
+   */
+  CompressedResponseCache(uint64_t max_size_bytes, uint32_t max_body_bytes,
+                          bool key_by_content_hash);
+
+  /**
+   * @return the compressed body cached for a key, or nullptr.
+   */
+  Body lookup(const std::string& key);
+
+  /**
+   * Caches the compressed body of a key, replacing the body it had. Does nothing if the body does
+   * not fit in the cache.
+   */
+  void insert(const std::string& key, std::string&& body);
+
+  /**
+   * @return the total size of the cached bodies and their keys.
+   */
+  uint64_t sizeBytes() const;
+
+  uint32_t maxBodyBytes() const { return max_body_bytes_; }
+  bool keyByContentHash() const { return key_by_content_hash_; }
+
+private:
+  const uint32_t max_body_bytes_;
+  const bool key_by_content_hash_;
+
+  mutable absl::Mutex mutex_;
+  // The cost of a body is its size and the size of its key.
+  LruCache<std::string, Body> bodies_ ABSL_GUARDED_BY(mutex_);
+};
+
+using CompressedResponseCacheSharedPtr = std::shared_ptr<CompressedResponseCache>;
+
+} // namespace Compressors
+} // namespace Common
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,40 @@
+#include "extensions/filters/http/common/compressor/compression_offload_pool.h"
+
+#include "common/common/lock_guard.h"
+#include "common/common/macros.h"
+#include "common/common/thread.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Common {
+namespace Compressors {
+namespace {
+
+struct ProcessPool {
+  Thread::MutexBasicLockable mutex_;
+  std::weak_ptr<CompressionOffloadPool> pool_ ABSL_GUARDED_BY(mutex_);
+};
+
+ProcessPool& processPool() { MUTABLE_CONSTRUCT_ON_FIRST_USE(ProcessPool); }
+
+} // namespace
+
+CompressionOffloadPoolSharedPtr
+CompressionOffloadPool::getOrCreate(Thread::ThreadFactory& thread_factory, uint32_t thread_count,
+                                    uint32_t max_queue_size) {
+  ProcessPool& process_pool = processPool();
+  Thread::LockGuard guard(process_pool.mutex_);
+  CompressionOffloadPoolSharedPtr pool = process_pool.pool_.lock();
+  if (pool == nullptr) {
+    pool = std::make_shared<CompressionOffloadPool>(thread_factory, thread_count, max_queue_size);
+    process_pool.pool_ = pool;
+  }
+  return pool;
+}
+
+} // namespace Compressors
+} // namespace Common
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
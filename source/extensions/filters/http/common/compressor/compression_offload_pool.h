@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/thread/thread.h"
+
+#include "common/common/bounded_thread_pool.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Common {
+namespace Compressors {
+
+/**
+ * The threads that compress the large chunks of the response bodies for the compressor filters.
+ * The pool of the process is created by the first filter configuration that offloads compression
+ * and destroyed with the last one.
+ */
+class CompressionOffloadPool : public BoundedThreadPool {
+public:
+  CompressionOffloadPool(Thread::ThreadFactory& thread_factory, uint32_t thread_count,
+                         uint32_t max_queue_size)
+      : BoundedThreadPool(thread_factory, "compression", thread_count, max_queue_size) {}
+
+  /**
+   * @return the pool of the process, creating it if there is none.
+   */
+  static std::shared_ptr<CompressionOffloadPool>
+  getOrCreate(Thread::ThreadFactory& thread_factory, uint32_t thread_count,
+              uint32_t max_queue_size);
+};
+
+using CompressionOffloadPoolSharedPtr = std::shared_ptr<CompressionOffloadPool>;
+
+} // namespace Compressors
+} // namespace Common
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -1,7 +1,9 @@
 #include "extensions/filters/http/common/compressor/compressor.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/common/hash.h"
 #include "common/http/header_map_impl.h"
+#include "common/protobuf/utility.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -28,6 +30,15 @@ Http::RegisterCustomInlineHeader<Http::CustomInlineHeaderRegistry::Type::Respons
 // Default minimum length of an upstream response that allows compression.
 const uint64_t DefaultMinimumContentLength = 30;
 
+// Default size of the compressed response cache.
+const uint64_t DefaultCompressedResponseCacheSize = 16 * 1024 * 1024;
+
+// Default maximum size of an uncompressed body to cache compressed.
+const uint32_t DefaultCompressedResponseCacheMaxBody = 1024 * 1024;
+
+// Default minimum size of a chunk of a response body to compress on the compression offload pool.
+const uint32_t DefaultCompressionOffloadMinChunk = 64 * 1024;
+
 // Default content types will be used if any is provided by the user.
 const std::vector<std::string>& defaultContentEncoding() {
   CONSTRUCT_ON_FIRST_USE(
@@ -109,7 +120,26 @@ CompressorFilterConfig::ResponseDirectionConfig::ResponseDirectionConfig(
           proto_config.has_response_direction_config()
               ? proto_config.response_direction_config().remove_accept_encoding_header()
               : proto_config.remove_accept_encoding_header()),
-      response_stats_{generateResponseStats(stats_prefix, scope)} {}
+      response_stats_{generateResponseStats(stats_prefix, scope)},
+      compressed_response_cache_(makeCompressedResponseCache(proto_config)),
+      compression_offload_min_chunk_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          proto_config.response_direction_config().compression_offload(), min_chunk_bytes,
+          DefaultCompressionOffloadMinChunk)) {}
+
+CompressedResponseCacheSharedPtr
+CompressorFilterConfig::ResponseDirectionConfig::makeCompressedResponseCache(
+    const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config) {
+  if (!proto_config.response_direction_config().has_compressed_response_cache()) {
+    return nullptr;
+  }
+  const auto& cache_config = proto_config.response_direction_config().compressed_response_cache();
+  return std::make_shared<CompressedResponseCache>(
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(cache_config, max_size_bytes,
+                                      DefaultCompressedResponseCacheSize),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(cache_config, max_body_bytes,
+                                      DefaultCompressedResponseCacheMaxBody),
+      cache_config.key_by_content_hash());
+}
 
 const envoy::extensions::filters::http::compressor::v3::Compressor::CommonDirectionConfig
 CompressorFilterConfig::ResponseDirectionConfig::commonConfig(
@@ -154,6 +184,9 @@ Http::FilterHeadersStatus CompressorFilter::decodeHeaders(Http::RequestHeaderMap
   if (response_config.compressionEnabled() && response_config.removeAcceptEncodingHeader()) {
     headers.removeInline(accept_encoding_handle.handle());
   }
+  if (response_config.compressedResponseCache() != nullptr) {
+    request_host_path_ = absl::StrCat(headers.getHostValue(), headers.getPathValue());
+  }
 
   const auto& request_config = config_->requestDirectionConfig();
   if (!end_stream && request_config.compressionEnabled() &&
@@ -227,12 +260,20 @@ Http::FilterHeadersStatus CompressorFilter::encodeHeaders(Http::ResponseHeaderMa
                               !headers.getInline(response_content_encoding_handle.handle());
   if (!end_stream && isEnabledAndContentLengthBigEnough && isAcceptEncodingAllowed(headers) &&
       isCompressible && isTransferEncodingAllowed(headers)) {
+    if (config.compressedResponseCache() != nullptr) {
+      lookUpCompressedResponseCache(*config.compressedResponseCache(), headers);
+    }
     sanitizeEtagHeader(headers);
     headers.removeContentLength();
     headers.setInline(response_content_encoding_handle.handle(), config_->contentEncoding());
     config.stats().compressed_.inc();
-    // Finally instantiate the compressor.
-    response_compressor_ = config_->makeCompressor();
+    if (cached_body_ != nullptr) {
+      // The body is replaced with the cached one, whose length is known.
+      headers.setContentLength(cached_body_->size());
+    } else if (hashed_body_ == nullptr) {
+      // Finally instantiate the compressor.
+      response_compressor_ = config_->makeCompressor();
+    }
   } else {
     config.stats().not_compressed_.inc();
   }
@@ -248,26 +289,246 @@ Http::FilterHeadersStatus CompressorFilter::encodeHeaders(Http::ResponseHeaderMa
 }
 
 Http::FilterDataStatus CompressorFilter::encodeData(Buffer::Instance& data, bool end_stream) {
-  if (response_compressor_ != nullptr) {
+  if (cached_body_ != nullptr) {
+    data.drain(data.length());
+    if (!end_stream) {
+      return Http::FilterDataStatus::StopIterationNoBuffer;
+    }
+    data.add(*cached_body_);
+  } else if (hashed_body_ != nullptr) {
+    hashed_body_->move(data);
+    if (!end_stream) {
+      return Http::FilterDataStatus::StopIterationNoBuffer;
+    }
+    compressHashedBody(data);
+  } else if (offload_in_flight_) {
+    // The data waits for the chunk on the compression offload pool, to keep the body in order.
+    offload_queue_.move(data);
+    offload_queue_end_stream_ = end_stream;
+    updateOffloadWatermarks();
+    return Http::FilterDataStatus::StopIterationNoBuffer;
+  } else if (response_compressor_ != nullptr) {
+    const CompressionOffloadPoolSharedPtr pool = config_->compressionOffloadPool();
+    if (pool != nullptr &&
+        data.length() >= config_->responseDirectionConfig().compressionOffloadMinChunkBytes() &&
+        offloadCompression(*pool, data, end_stream)) {
+      return Http::FilterDataStatus::StopIterationNoBuffer;
+    }
+    const uint64_t uncompressed_bytes = data.length();
     compressAndUpdateStats(response_compressor_, config_->responseDirectionConfig().stats(), data,
                            end_stream);
+    fillCompressedResponseCache(uncompressed_bytes, data, end_stream);
   }
   return Http::FilterDataStatus::Continue;
 }
 
 Http::FilterTrailersStatus CompressorFilter::encodeTrailers(Http::ResponseTrailerMap&) {
-  if (response_compressor_ != nullptr) {
+  if (offload_in_flight_) {
+    // The trailers resume once the compression of the body is finished.
+    offload_trailers_pending_ = true;
+    return Http::FilterTrailersStatus::StopIteration;
+  }
+  if (cached_body_ != nullptr) {
+    Buffer::OwnedImpl body(*cached_body_);
+    encoder_callbacks_->addEncodedData(body, true);
+  } else if (hashed_body_ != nullptr) {
+    Buffer::OwnedImpl body;
+    compressHashedBody(body);
+    encoder_callbacks_->addEncodedData(body, true);
+  } else if (response_compressor_ != nullptr) {
     Buffer::OwnedImpl empty_buffer;
     // The presence of trailers means the stream is ended, but encodeData()
     // is never called with end_stream=true, thus let the compression library know
     // that the stream is ended.
     compressAndUpdateStats(response_compressor_, config_->responseDirectionConfig().stats(),
                            empty_buffer, true);
+    fillCompressedResponseCache(0, empty_buffer, true);
     encoder_callbacks_->addEncodedData(empty_buffer, true);
   }
   return Http::FilterTrailersStatus::Continue;
 }
 
+void CompressorFilter::onDestroy() { *alive_ = false; }
+
+// Hands the data to the compression offload pool together with the compressor, which is used by a
+// single thread at a time. Returns false, leaving the data and the compressor in place, if the
+// queue of the pool is full.
+bool CompressorFilter::offloadCompression(CompressionOffloadPool& pool, Buffer::Instance& data,
+                                          bool end_stream) {
+  auto chunk = std::make_shared<OffloadedChunk>();
+  chunk->compressor_ = std::move(response_compressor_);
+  chunk->uncompressed_bytes_ = data.length();
+  chunk->data_.move(data);
+  chunk->end_stream_ = end_stream;
+
+  Event::Dispatcher& dispatcher = encoder_callbacks_->dispatcher();
+  std::shared_ptr<bool> alive = alive_;
+  const bool posted = pool.post([this, chunk, alive, &dispatcher]() {
+    chunk->compressor_->compress(chunk->data_,
+                                 chunk->end_stream_
+                                     ? Envoy::Compression::Compressor::State::Finish
+                                     : Envoy::Compression::Compressor::State::Flush);
+    dispatcher.post([this, chunk, alive]() {
+      if (*alive) {
+        onOffloadedCompressionDone(*chunk);
+      }
+    });
+  });
+
+  const ResponseCompressorStats& stats = config_->responseDirectionConfig().responseStats();
+  if (!posted) {
+    stats.compression_offload_queue_full_.inc();
+    response_compressor_ = std::move(chunk->compressor_);
+    data.move(chunk->data_);
+    return false;
+  }
+  stats.compression_offloaded_.inc();
+  offload_in_flight_ = true;
+  offload_in_flight_bytes_ = chunk->uncompressed_bytes_;
+  updateOffloadWatermarks();
+  return true;
+}
+
+// Passes the compressed chunk on down the filter chain, then compresses the data received in the
+// meantime and resumes the trailers waiting for the body, if any.
+void CompressorFilter::onOffloadedCompressionDone(OffloadedChunk& chunk) {
+  const CompressorStats& stats = config_->responseDirectionConfig().stats();
+  offload_in_flight_ = false;
+  offload_in_flight_bytes_ = 0;
+  response_compressor_ = std::move(chunk.compressor_);
+  stats.total_uncompressed_bytes_.add(chunk.uncompressed_bytes_);
+  stats.total_compressed_bytes_.add(chunk.data_.length());
+  fillCompressedResponseCache(chunk.uncompressed_bytes_, chunk.data_, chunk.end_stream_);
+  encoder_callbacks_->injectEncodedDataToFilterChain(chunk.data_, chunk.end_stream_);
+  if (chunk.end_stream_) {
+    return;
+  }
+
+  if (offload_queue_.length() > 0 || offload_queue_end_stream_) {
+    Buffer::OwnedImpl data;
+    data.move(offload_queue_);
+    const bool end_stream = offload_queue_end_stream_;
+    offload_queue_end_stream_ = false;
+    const CompressionOffloadPoolSharedPtr pool = config_->compressionOffloadPool();
+    if (data.length() < config_->responseDirectionConfig().compressionOffloadMinChunkBytes() ||
+        !offloadCompression(*pool, data, end_stream)) {
+      const uint64_t uncompressed_bytes = data.length();
+      compressAndUpdateStats(response_compressor_, stats, data, end_stream);
+      fillCompressedResponseCache(uncompressed_bytes, data, end_stream);
+      encoder_callbacks_->injectEncodedDataToFilterChain(data, end_stream);
+      if (end_stream) {
+        return;
+      }
+    }
+  }
+
+  updateOffloadWatermarks();
+  if (!offload_in_flight_ && offload_trailers_pending_) {
+    offload_trailers_pending_ = false;
+    Buffer::OwnedImpl empty_buffer;
+    compressAndUpdateStats(response_compressor_, stats, empty_buffer, true);
+    fillCompressedResponseCache(0, empty_buffer, true);
+    encoder_callbacks_->injectEncodedDataToFilterChain(empty_buffer, false);
+    encoder_callbacks_->continueEncoding();
+  }
+}
+
+// Holds the upstream back while the data waiting for the compression offload pool exceeds the
+// buffer limit of the stream, as it would if the data were buffered by the filter manager.
+void CompressorFilter::updateOffloadWatermarks() {
+  const uint32_t limit = encoder_callbacks_->encoderBufferLimit();
+  if (limit == 0) {
+    return;
+  }
+  const uint64_t pending = offload_in_flight_bytes_ + offload_queue_.length();
+  if (!offload_above_high_watermark_ && pending > limit) {
+    offload_above_high_watermark_ = true;
+    encoder_callbacks_->onEncoderFilterAboveWriteBufferHighWatermark();
+  } else if (offload_above_high_watermark_ && pending < limit / 2) {
+    offload_above_high_watermark_ = false;
+    encoder_callbacks_->onEncoderFilterBelowWriteBufferLowWatermark();
+  }
+}
+
+// Looks up the response in the compressed response cache by its entity tag, or, if it has none
+// and its body is small enough, prepares to buffer its body and look it up by its hash once it is
+// complete. Entity tags identify the representations of a resource only, hence the host and the
+// path of the request in the key.
+void CompressorFilter::lookUpCompressedResponseCache(CompressedResponseCache& cache,
+                                                     const Http::ResponseHeaderMap& headers) {
+  const ResponseCompressorStats& stats = config_->responseDirectionConfig().responseStats();
+  const Http::HeaderEntry* etag = headers.getInline(etag_handle.handle());
+  if (etag != nullptr) {
+    cache_key_ = absl::StrCat("etag\n", request_host_path_, "\n", etag->value().getStringView());
+    cached_body_ = cache.lookup(cache_key_);
+    if (cached_body_ != nullptr) {
+      stats.compressed_response_cache_hit_.inc();
+    } else {
+      stats.compressed_response_cache_miss_.inc();
+      cache_fill_ = std::make_unique<std::string>();
+    }
+    return;
+  }
+
+  const Http::HeaderEntry* content_length = headers.ContentLength();
+  uint64_t length;
+  if (cache.keyByContentHash() && content_length != nullptr &&
+      absl::SimpleAtoi(content_length->value().getStringView(), &length) &&
+      length <= cache.maxBodyBytes()) {
+    hashed_body_ = std::make_unique<Buffer::OwnedImpl>();
+  }
+}
+
+void CompressorFilter::fillCompressedResponseCache(uint64_t uncompressed_bytes,
+                                                   const Buffer::Instance& compressed,
+                                                   bool end_stream) {
+  if (cache_fill_ == nullptr) {
+    return;
+  }
+  const CompressedResponseCacheSharedPtr& cache =
+      config_->responseDirectionConfig().compressedResponseCache();
+  cache_fill_uncompressed_bytes_ += uncompressed_bytes;
+  if (cache_fill_uncompressed_bytes_ > cache->maxBodyBytes()) {
+    cache_fill_.reset();
+    return;
+  }
+
+  const uint64_t size = cache_fill_->size();
+  cache_fill_->resize(size + compressed.length());
+  compressed.copyOut(0, compressed.length(), &(*cache_fill_)[size]);
+  if (end_stream) {
+    cache->insert(cache_key_, std::move(*cache_fill_));
+    cache_fill_.reset();
+  }
+}
+
+// Serves the buffered body from the compressed response cache, or compresses it and caches it.
+void CompressorFilter::compressHashedBody(Buffer::Instance& data) {
+  const CompressedResponseCacheSharedPtr& cache =
+      config_->responseDirectionConfig().compressedResponseCache();
+  const ResponseCompressorStats& stats = config_->responseDirectionConfig().responseStats();
+  const uint64_t length = hashed_body_->length();
+  const absl::string_view body(
+      static_cast<const char*>(hashed_body_->linearize(static_cast<uint32_t>(length))), length);
+  // Two hashes with different seeds make serving a body for another one of the same length
+  // unlikely enough.
+  cache_key_ = absl::StrCat("hash\n", length, "\n", HashUtil::xxHash64(body), "\n",
+                            HashUtil::xxHash64(body, 1));
+  cached_body_ = cache->lookup(cache_key_);
+  if (cached_body_ != nullptr) {
+    stats.compressed_response_cache_hit_.inc();
+    data.add(*cached_body_);
+  } else {
+    stats.compressed_response_cache_miss_.inc();
+    data.move(*hashed_body_);
+    response_compressor_ = config_->makeCompressor();
+    compressAndUpdateStats(response_compressor_, config_->responseDirectionConfig().stats(), data,
+                           true);
+    cache->insert(cache_key_, data.toString());
+  }
+  hashed_body_.reset();
+}
+
 bool CompressorFilter::hasCacheControlNoTransform(Http::ResponseHeaderMap& headers) const {
   const Http::HeaderEntry* cache_control = headers.getInline(cache_control_handle.handle());
   if (cache_control) {
@@ -373,14 +634,25 @@ CompressorFilter::chooseEncoding(const Http::ResponseHeaderMap& headers) const {
   }
 
   // Find intersection of encodings accepted by the user agent and provided
-  // by the allowed compressors and choose the one with the highest q-value.
+  // by the allowed compressors and choose the one with the highest q-value. Among the compressors
+  // accepted with the same q-value, the one registered first in the filter chain is preferred, so
+  // that the order of the filters ranks the configured encodings, e.g. "br" before "gzip" for
+  // "Accept-Encoding: gzip, br".
   EncPair choice{Http::CustomHeaders::get().AcceptEncodingValues.Identity, static_cast<float>(0)};
+  auto choice_compressor = allowed_compressors.end();
   for (const auto& pair : pairs) {
-    if ((pair.second > choice.second) &&
-        (allowed_compressors.count(std::string(pair.first)) ||
+    const auto compressor = allowed_compressors.find(std::string(pair.first));
+    if (pair.second > choice.second &&
+        (compressor != allowed_compressors.end() ||
          pair.first == Http::CustomHeaders::get().AcceptEncodingValues.Identity ||
          pair.first == Http::CustomHeaders::get().AcceptEncodingValues.Wildcard)) {
       choice = pair;
+      choice_compressor = compressor;
+    } else if (pair.second == choice.second && compressor != allowed_compressors.end() &&
+               choice_compressor != allowed_compressors.end() &&
+               compressor->second < choice_compressor->second) {
+      choice = pair;
+      choice_compressor = compressor;
     }
   }
 
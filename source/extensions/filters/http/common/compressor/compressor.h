@@ -6,9 +6,12 @@
 #include "envoy/stats/stats_macros.h"
 #include "envoy/stream_info/filter_state.h"
 
+#include "common/buffer/buffer_impl.h"
 #include "common/protobuf/protobuf.h"
 #include "common/runtime/runtime_protos.h"
 
+#include "extensions/filters/http/common/compressor/compressed_response_cache.h"
+#include "extensions/filters/http/common/compressor/compression_offload_pool.h"
 #include "extensions/filters/http/common/pass_through_filter.h"
 
 namespace Envoy {
@@ -41,6 +44,14 @@ namespace Compressors {
  *
  * "header_gzip" is specific to the gzip filter and is deprecated since it duplicates
  * "header_compressor_used".
+ *
+ * "compressed_response_cache_hit" and "compressed_response_cache_miss" count the responses to
+ * compress that were looked up in the compressed response cache. The bodies served from the cache
+ * are not counted in "total_uncompressed_bytes" and "total_compressed_bytes".
+ *
+ * "compression_offloaded" is a number of chunks of the response bodies compressed on the
+ * compression offload pool, and "compression_offload_queue_full" a number of the chunks compressed
+ * on the worker because the queue of the pool was full.
  */
 #define RESPONSE_COMPRESSOR_STATS(COUNTER)                                                         \
   COUNTER(no_accept_header)                                                                        \
@@ -50,7 +61,11 @@ namespace Compressors {
   COUNTER(header_compressor_overshadowed)                                                          \
   COUNTER(header_wildcard)                                                                         \
   COUNTER(header_not_valid)                                                                        \
-  COUNTER(not_compressed_etag)
+  COUNTER(not_compressed_etag)                                                                     \
+  COUNTER(compressed_response_cache_hit)                                                           \
+  COUNTER(compressed_response_cache_miss)                                                          \
+  COUNTER(compression_offloaded)                                                                   \
+  COUNTER(compression_offload_queue_full)
 
 /**
  * Struct definitions for compressor stats. @see stats_macros.h
@@ -123,6 +138,14 @@ public:
     const ResponseCompressorStats& responseStats() const { return response_stats_; }
     bool disableOnEtagHeader() const { return disable_on_etag_header_; }
     bool removeAcceptEncodingHeader() const { return remove_accept_encoding_header_; }
+    // The compressed response cache, or nullptr if the responses are not cached.
+    const CompressedResponseCacheSharedPtr& compressedResponseCache() const {
+      return compressed_response_cache_;
+    }
+    // The minimum size of a chunk of a response body to compress on the compression offload pool.
+    uint32_t compressionOffloadMinChunkBytes() const {
+      return compression_offload_min_chunk_bytes_;
+    }
 
   private:
     static ResponseCompressorStats generateResponseStats(const std::string& prefix,
@@ -135,15 +158,23 @@ public:
     static const envoy::extensions::filters::http::compressor::v3::Compressor::CommonDirectionConfig
     commonConfig(const envoy::extensions::filters::http::compressor::v3::Compressor&);
 
+    static CompressedResponseCacheSharedPtr makeCompressedResponseCache(
+        const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config);
+
     const bool disable_on_etag_header_;
     const bool remove_accept_encoding_header_;
     const ResponseCompressorStats response_stats_;
+    const CompressedResponseCacheSharedPtr compressed_response_cache_;
+    const uint32_t compression_offload_min_chunk_bytes_;
   };
 
   CompressorFilterConfig() = delete;
   virtual ~CompressorFilterConfig() = default;
 
   virtual Envoy::Compression::Compressor::CompressorPtr makeCompressor() PURE;
+  // The pool compressing the large chunks of the response bodies, or nullptr if they are
+  // compressed on the workers.
+  virtual CompressionOffloadPoolSharedPtr compressionOffloadPool() { return nullptr; }
 
   const std::string contentEncoding() const { return content_encoding_; };
   const RequestDirectionConfig& requestDirectionConfig() { return request_direction_config_; }
@@ -183,6 +214,9 @@ public:
   Http::FilterDataStatus encodeData(Buffer::Instance& buffer, bool end_stream) override;
   Http::FilterTrailersStatus encodeTrailers(Http::ResponseTrailerMap&) override;
 
+  // Http::StreamFilterBase
+  void onDestroy() override;
+
 private:
   bool hasCacheControlNoTransform(Http::ResponseHeaderMap& headers) const;
   bool isAcceptEncodingAllowed(const Http::ResponseHeaderMap& headers) const;
@@ -192,6 +226,26 @@ private:
   void sanitizeEtagHeader(Http::ResponseHeaderMap& headers);
   void insertVaryHeader(Http::ResponseHeaderMap& headers);
 
+  void lookUpCompressedResponseCache(CompressedResponseCache& cache,
+                                     const Http::ResponseHeaderMap& headers);
+  void fillCompressedResponseCache(uint64_t uncompressed_bytes, const Buffer::Instance& compressed,
+                                   bool end_stream);
+  void compressHashedBody(Buffer::Instance& data);
+
+  // A chunk of the response body compressed on the compression offload pool, which owns the
+  // compressor of the response while it is there.
+  struct OffloadedChunk {
+    Envoy::Compression::Compressor::CompressorPtr compressor_;
+    Buffer::OwnedImpl data_;
+    uint64_t uncompressed_bytes_{};
+    bool end_stream_{};
+  };
+  using OffloadedChunkSharedPtr = std::shared_ptr<OffloadedChunk>;
+
+  bool offloadCompression(CompressionOffloadPool& pool, Buffer::Instance& data, bool end_stream);
+  void onOffloadedCompressionDone(OffloadedChunk& chunk);
+  void updateOffloadWatermarks();
+
   class EncodingDecision : public StreamInfo::FilterState::Object {
   public:
     enum class HeaderStat { NotValid, Identity, Wildcard, ValidCompressor };
@@ -212,6 +266,31 @@ private:
   Envoy::Compression::Compressor::CompressorPtr request_compressor_;
   const CompressorFilterConfigSharedPtr config_;
   std::unique_ptr<std::string> accept_encoding_;
+
+  // The host and the path of the request, which key the response in the compressed response cache
+  // together with its entity tag.
+  std::string request_host_path_;
+  // The key of the response in the compressed response cache.
+  std::string cache_key_;
+  // The compressed body found in the cache, which replaces the body of the response.
+  CompressedResponseCache::Body cached_body_;
+  // The compressed body to cache once complete, and the size of the body it compresses.
+  std::unique_ptr<std::string> cache_fill_;
+  uint64_t cache_fill_uncompressed_bytes_{0};
+  // The body of a response without an entity tag, buffered to be keyed by its hash.
+  std::unique_ptr<Buffer::OwnedImpl> hashed_body_;
+
+  // Cleared when the filter is destroyed, for the chunks that complete on the pool after it.
+  std::shared_ptr<bool> alive_{std::make_shared<bool>(true)};
+  // Whether a chunk is being compressed on the compression offload pool, and its size. The data
+  // received meanwhile is queued to be compressed after it, in order.
+  bool offload_in_flight_{false};
+  uint64_t offload_in_flight_bytes_{0};
+  Buffer::OwnedImpl offload_queue_;
+  bool offload_queue_end_stream_{false};
+  bool offload_above_high_watermark_{false};
+  // Whether the trailers wait for the offloaded chunks to be compressed.
+  bool offload_trailers_pending_{false};
 };
 
 } // namespace Compressors
@@ -1,5 +1,7 @@
 #include "extensions/filters/http/compressor/compressor_filter.h"
 
+#include "common/protobuf/utility.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
@@ -8,13 +10,28 @@ namespace Compressor {
 CompressorFilterConfig::CompressorFilterConfig(
     const envoy::extensions::filters::http::compressor::v3::Compressor& generic_compressor,
     const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
-    Compression::Compressor::CompressorFactoryPtr compressor_factory)
+    Compression::Compressor::CompressorFactoryPtr compressor_factory,
+    Thread::ThreadFactory& thread_factory)
     : Common::Compressors::CompressorFilterConfig(
           generic_compressor,
           stats_prefix + "compressor." + generic_compressor.compressor_library().name() + "." +
               compressor_factory->statsPrefix(),
           scope, runtime, compressor_factory->contentEncoding()),
-      compressor_factory_(std::move(compressor_factory)) {}
+      compressor_factory_(std::move(compressor_factory)),
+      compression_offload_pool_(makeCompressionOffloadPool(generic_compressor, thread_factory)) {}
+
+Common::Compressors::CompressionOffloadPoolSharedPtr
+CompressorFilterConfig::makeCompressionOffloadPool(
+    const envoy::extensions::filters::http::compressor::v3::Compressor& generic_compressor,
+    Thread::ThreadFactory& thread_factory) {
+  if (!generic_compressor.response_direction_config().has_compression_offload()) {
+    return nullptr;
+  }
+  const auto& offload_config = generic_compressor.response_direction_config().compression_offload();
+  return Common::Compressors::CompressionOffloadPool::getOrCreate(
+      thread_factory, PROTOBUF_GET_WRAPPED_OR_DEFAULT(offload_config, thread_count, 1),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(offload_config, max_queue_size, 1024));
+}
 
 Envoy::Compression::Compressor::CompressorPtr CompressorFilterConfig::makeCompressor() {
   return compressor_factory_->createCompressor();
@@ -2,6 +2,7 @@
 
 #include "envoy/compression/compressor/factory.h"
 #include "envoy/extensions/filters/http/compressor/v3/compressor.pb.h"
+#include "envoy/thread/thread.h"
 
 #include "extensions/filters/http/common/compressor/compressor.h"
 
@@ -21,12 +22,21 @@ public:
   CompressorFilterConfig(
       const envoy::extensions::filters::http::compressor::v3::Compressor& genereic_compressor,
       const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
-      Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory);
+      Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory,
+      Thread::ThreadFactory& thread_factory);
 
   Envoy::Compression::Compressor::CompressorPtr makeCompressor() override;
+  Common::Compressors::CompressionOffloadPoolSharedPtr compressionOffloadPool() override {
+    return compression_offload_pool_;
+  }
 
 private:
+  static Common::Compressors::CompressionOffloadPoolSharedPtr makeCompressionOffloadPool(
+      const envoy::extensions::filters::http::compressor::v3::Compressor& generic_compressor,
+      Thread::ThreadFactory& thread_factory);
+
   const Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory_;
+  const Common::Compressors::CompressionOffloadPoolSharedPtr compression_offload_pool_;
 };
 
 } // namespace Compressor
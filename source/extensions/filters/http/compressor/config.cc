@@ -35,7 +35,8 @@ Http::FilterFactoryCb CompressorFilterFactory::createFilterFactoryFromProtoTyped
       config_factory->createCompressorFactoryFromProto(*message, context);
   Common::Compressors::CompressorFilterConfigSharedPtr config =
       std::make_shared<CompressorFilterConfig>(proto_config, stats_prefix, context.scope(),
-                                               context.runtime(), std::move(compressor_factory));
+                                               context.runtime(), std::move(compressor_factory),
+                                               context.api().threadFactory());
   return [config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamFilter(std::make_shared<Common::Compressors::CompressorFilter>(config));
   };
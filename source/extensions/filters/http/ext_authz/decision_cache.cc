@@ -0,0 +1,165 @@
+#include "extensions/filters/http/ext_authz/decision_cache.h"
+
+#include "common/http/path_utility.h"
+#include "common/protobuf/utility.h"
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+
+namespace {
+
+constexpr std::chrono::milliseconds DefaultTtl{30000};
+constexpr uint32_t DefaultMaxEntries = 10000;
+
+} // namespace
+
+using Filters::Common::ExtAuthz::CheckStatus;
+using Filters::Common::ExtAuthz::Response;
+using Filters::Common::ExtAuthz::ResponsePtr;
+
+DecisionCache::DecisionCache(
+    const envoy::extensions::filters::http::ext_authz::v3::DecisionCache& config,
+    ThreadLocal::SlotAllocator& tls, TimeSource& time_source)
+    : headers_(config.headers().begin(), config.headers().end()),
+      include_method_(config.include_method()),
+      path_prefix_segments_(config.has_path_prefix_segments()
+                                ? absl::optional<uint32_t>(config.path_prefix_segments().value())
+                                : absl::nullopt),
+      ttl_(PROTOBUF_GET_MS_OR_DEFAULT(config, ttl, DefaultTtl.count())),
+      denied_ttl_(PROTOBUF_GET_OPTIONAL_MS(config, denied_ttl)),
+      ttl_header_(config.ttl_header().empty()
+                      ? absl::nullopt
+                      : absl::optional<Http::LowerCaseString>(config.ttl_header())),
+      ttl_metadata_key_(config.ttl_metadata_key()), time_source_(time_source) {
+  const uint32_t max_entries =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_entries, DefaultMaxEntries);
+  if (config.shared()) {
+    shared_ = std::make_unique<Store>(max_entries);
+  } else {
+    tls_ = tls.allocateSlot();
+    tls_->set([max_entries](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+      return std::make_shared<Store>(max_entries);
+    });
+  }
+}
+
+std::string DecisionCache::key(const Http::RequestHeaderMap& headers) const {
+  std::string key;
+  if (include_method_) {
+    absl::StrAppend(&key, headers.getMethodValue());
+  }
+  key.push_back('\n');
+  if (path_prefix_segments_.has_value()) {
+    absl::string_view path = Http::PathUtil::removeQueryAndFragment(headers.getPathValue());
+    size_t end = 0;
+    for (uint32_t i = 0; i < path_prefix_segments_.value() && end != absl::string_view::npos;
+         ++i) {
+      end = path.find('/', end + 1);
+    }
+    if (path_prefix_segments_.value() > 0 && end != absl::string_view::npos) {
+      path = path.substr(0, end);
+    }
+    absl::StrAppend(&key, path);
+  }
+  // Header values cannot contain a newline, so it separates the attributes unambiguously. The
+  // leading character distinguishes a missing header from an empty one.
+  for (const auto& name : headers_) {
+    const auto entries = headers.get(name);
+    if (entries.empty()) {
+      key.append("\n-");
+      continue;
+    }
+    key.append("\n+");
+    for (size_t i = 0; i < entries.size(); ++i) {
+      absl::StrAppend(&key, i > 0 ? "," : "", entries[i]->value().getStringView());
+    }
+  }
+  return key;
+}
+
+ResponsePtr DecisionCache::lookup(const std::string& key) {
+  CachedResponse cached = store().lookup(key, time_source_.monotonicTime());
+  if (cached == nullptr) {
+    return nullptr;
+  }
+  return std::make_unique<Response>(*cached);
+}
+
+void DecisionCache::insert(const std::string& key, Response& response) {
+  const absl::optional<std::chrono::milliseconds> ttl = takeTtl(response);
+  if (response.status == CheckStatus::Error) {
+    return;
+  }
+  absl::optional<std::chrono::milliseconds> effective_ttl = ttl;
+  if (!effective_ttl.has_value()) {
+    effective_ttl = response.status == CheckStatus::OK ? absl::make_optional(ttl_) : denied_ttl_;
+  }
+  if (!effective_ttl.has_value() || effective_ttl.value().count() == 0) {
+    return;
+  }
+  store().insert(key, std::make_shared<const Response>(response),
+                 time_source_.monotonicTime() + effective_ttl.value());
+}
+
+DecisionCache::Store& DecisionCache::store() {
+  return shared_ != nullptr ? *shared_ : tls_->getTyped<Store>();
+}
+
+absl::optional<std::chrono::milliseconds> DecisionCache::takeTtl(Response& response) const {
+  absl::optional<std::chrono::milliseconds> ttl;
+  if (ttl_header_.has_value()) {
+    for (Http::HeaderVector* headers :
+         {&response.headers_to_set, &response.headers_to_add, &response.headers_to_append}) {
+      for (auto it = headers->begin(); it != headers->end();) {
+        if (it->first != ttl_header_.value()) {
+          ++it;
+          continue;
+        }
+        uint64_t seconds;
+        if (absl::SimpleAtoi(it->second, &seconds)) {
+          ttl = std::chrono::seconds(seconds);
+        }
+        it = headers->erase(it);
+      }
+    }
+  }
+  if (!ttl_metadata_key_.empty()) {
+    const auto& fields = response.dynamic_metadata.fields();
+    const auto it = fields.find(ttl_metadata_key_);
+    if (it != fields.end() && it->second.kind_case() == ProtobufWkt::Value::kNumberValue &&
+        it->second.number_value() >= 0) {
+      ttl = std::chrono::milliseconds(static_cast<uint64_t>(it->second.number_value() * 1000));
+    }
+  }
+  return ttl;
+}
+
+DecisionCache::CachedResponse DecisionCache::Store::lookup(const std::string& key,
+                                                           MonotonicTime now) {
+  absl::MutexLock lock(&mutex_);
+  const Decision* decision = decisions_.find(key);
+  if (decision == nullptr) {
+    return nullptr;
+  }
+  if (decision->expiry_ <= now) {
+    decisions_.erase(key);
+    return nullptr;
+  }
+  return decision->response_;
+}
+
+void DecisionCache::Store::insert(const std::string& key, CachedResponse response,
+                                  MonotonicTime expiry) {
+  absl::MutexLock lock(&mutex_);
+  decisions_.insert(key, {std::move(response), expiry});
+}
+
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/extensions/filters/http/ext_authz/v3/ext_authz.pb.h"
+#include "envoy/http/header_map.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/common/lru_cache.h"
+#include "common/common/non_copyable.h"
+
+#include "extensions/filters/common/ext_authz/ext_authz.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+
+/**
+ * Cache of authorization decisions, keyed by the request attributes selected in the config, so
+ * that requests sharing a key within the TTL of a decision are not sent to the authorization
+ * service again. Decisions are kept per worker unless the cache is configured as shared, and are
+ * evicted in least recently used order once the cache holds its maximum number of entries.
+ */
+class DecisionCache : NonCopyable {
+public:
+  DecisionCache(const envoy::extensions::filters::http::ext_authz::v3::DecisionCache& config,
+                ThreadLocal::SlotAllocator& tls, TimeSource& time_source);
+
+  /**
+   * @return the cache key of a request.
+   */
+  std::string key(const Http::RequestHeaderMap& headers) const;
+
+  /**
+   * @return a copy of the unexpired decision cached for a key, or nullptr.
+   */
+  Filters::Common::ExtAuthz::ResponsePtr lookup(const std::string& key);
+
+  /**
+   * Caches a decision for its TTL, replacing the decision the key had. Errors and decisions with a
+   * zero TTL are not cached. The TTL header, if configured, is removed from the response whether
+   * or not the decision is cached.
+   */
+  void insert(const std::string& key, Filters::Common::ExtAuthz::Response& response);
+
+private:
+  using CachedResponse = std::shared_ptr<const Filters::Common::ExtAuthz::Response>;
+
+  // The decisions of a worker, or of all workers for a shared cache. The mutex is uncontended
+  // when the store is per worker.
+  class Store : public ThreadLocal::ThreadLocalObject {
+  public:
+    explicit Store(uint32_t max_entries) : decisions_(max_entries) {}
+
+    CachedResponse lookup(const std::string& key, MonotonicTime now);
+    void insert(const std::string& key, CachedResponse response, MonotonicTime expiry);
+
+  private:
+    struct Decision {
+      CachedResponse response_;
+      MonotonicTime expiry_;
+    };
+
+    absl::Mutex mutex_;
+    LruCache<std::string, Decision> decisions_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  Store& store();
+  absl::optional<std::chrono::milliseconds>
+  takeTtl(Filters::Common::ExtAuthz::Response& response) const;
+
+  const std::vector<Http::LowerCaseString> headers_;
+  const bool include_method_;
+  const absl::optional<uint32_t> path_prefix_segments_;
+  const std::chrono::milliseconds ttl_;
+  const absl::optional<std::chrono::milliseconds> denied_ttl_;
+  const absl::optional<Http::LowerCaseString> ttl_header_;
+  const std::string ttl_metadata_key_;
+  TimeSource& time_source_;
+  // Exactly one of the slot and the shared store is set.
+  ThreadLocal::SlotPtr tls_;
+  std::unique_ptr<Store> shared_;
+};
+
+using DecisionCacheSharedPtr = std::shared_ptr<DecisionCache>;
+
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -61,6 +61,27 @@ void Filter::initiateCall(const Http::RequestHeaderMap& headers,
     }
   }
 
+  // The decision of a request whose body is sent to the authorization service depends on the body,
+  // which is not part of the cache key.
+  if (config_->decisionCache() != nullptr && !buffer_data_) {
+    decision_cache_key_ = config_->decisionCache()->key(headers);
+    Filters::Common::ExtAuthz::ResponsePtr cached =
+        config_->decisionCache()->lookup(decision_cache_key_.value());
+    if (cached != nullptr) {
+      ENVOY_STREAM_LOG(trace, "ext_authz filter using the cached authorization decision",
+                       *callbacks_);
+      stats_.decision_cache_hit_.inc();
+      decision_cached_ = true;
+      state_ = State::Calling;
+      filter_return_ = FilterReturn::StopDecoding;
+      initiating_call_ = true;
+      onComplete(std::move(cached));
+      initiating_call_ = false;
+      return;
+    }
+    stats_.decision_cache_miss_.inc();
+  }
+
   Filters::Common::ExtAuthz::CheckRequestUtils::createHttpCheck(
       callbacks_, headers, std::move(context_extensions), std::move(metadata_context),
       check_request_, config_->maxRequestBytes(), config_->packAsBytes(),
@@ -168,6 +189,10 @@ void Filter::onComplete(Filters::Common::ExtAuthz::ResponsePtr&& response) {
   using Filters::Common::ExtAuthz::CheckStatus;
   Stats::StatName empty_stat_name;
 
+  if (decision_cache_key_.has_value() && !decision_cached_) {
+    config_->decisionCache()->insert(decision_cache_key_.value(), *response);
+  }
+
   switch (response->status) {
   case CheckStatus::OK: {
     // Any changes to request headers can affect how the request is going to be
@@ -23,6 +23,7 @@
 #include "extensions/filters/common/ext_authz/ext_authz.h"
 #include "extensions/filters/common/ext_authz/ext_authz_grpc_impl.h"
 #include "extensions/filters/common/ext_authz/ext_authz_http_impl.h"
+#include "extensions/filters/http/ext_authz/decision_cache.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -38,7 +39,9 @@ namespace ExtAuthz {
   COUNTER(denied)                                                                                  \
   COUNTER(error)                                                                                   \
   COUNTER(disabled)                                                                                \
-  COUNTER(failure_mode_allowed)
+  COUNTER(failure_mode_allowed)                                                                    \
+  COUNTER(decision_cache_hit)                                                                      \
+  COUNTER(decision_cache_miss)
 
 /**
  * Wrapper struct for ext_authz filter stats. @see stats_macros.h
@@ -54,7 +57,8 @@ class FilterConfig {
 public:
   FilterConfig(const envoy::extensions::filters::http::ext_authz::v3::ExtAuthz& config,
                Stats::Scope& scope, Runtime::Loader& runtime, Http::Context& http_context,
-               const std::string& stats_prefix)
+               const std::string& stats_prefix, ThreadLocal::SlotAllocator& tls,
+               TimeSource& time_source)
       : allow_partial_message_(config.with_request_body().allow_partial_message()),
         failure_mode_allow_(config.failure_mode_allow()),
         clear_route_cache_(config.clear_route_cache()),
@@ -78,6 +82,10 @@ public:
         metadata_context_namespaces_(config.metadata_context_namespaces().begin(),
                                      config.metadata_context_namespaces().end()),
         include_peer_certificate_(config.include_peer_certificate()),
+        decision_cache_(config.has_decision_cache()
+                            ? std::make_shared<DecisionCache>(config.decision_cache(), tls,
+                                                              time_source)
+                            : nullptr),
         stats_(generateStats(stats_prefix, config.stat_prefix(), scope)),
         ext_authz_ok_(pool_.add(createPoolStatName(config.stat_prefix(), "ok"))),
         ext_authz_denied_(pool_.add(createPoolStatName(config.stat_prefix(), "denied"))),
@@ -126,6 +134,11 @@ public:
 
   bool includePeerCertificate() const { return include_peer_certificate_; }
 
+  /**
+   * @return the cache of authorization decisions, or nullptr if decisions are not cached.
+   */
+  const DecisionCacheSharedPtr& decisionCache() const { return decision_cache_; }
+
 private:
   static Http::Code toErrorCode(uint64_t status) {
     const auto code = static_cast<Http::Code>(status);
@@ -172,6 +185,8 @@ private:
 
   const bool include_peer_certificate_;
 
+  const DecisionCacheSharedPtr decision_cache_;
+
   // The stats for the filter.
   ExtAuthzFilterStats stats_;
 
@@ -287,6 +302,10 @@ private:
   bool initiating_call_{};
   bool buffer_data_{};
   bool skip_check_{false};
+  // The decision cache key of the request, set when the decision of the request can be cached.
+  absl::optional<std::string> decision_cache_key_;
+  // Whether the decision of the request was served from the decision cache.
+  bool decision_cached_{};
   envoy::service::auth::v3::CheckRequest check_request_{};
 };
 
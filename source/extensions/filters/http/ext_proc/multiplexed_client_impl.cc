@@ -0,0 +1,169 @@
+#include "extensions/filters/http/ext_proc/multiplexed_client_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExternalProcessing {
+
+using envoy::service::ext_proc::v3alpha::ProcessingRequest;
+using envoy::service::ext_proc::v3alpha::ProcessingResponse;
+
+static constexpr char kExternalMethod[] =
+    "envoy.service.ext_proc.v3alpha.ExternalProcessor.Process";
+
+MultiplexedExternalProcessorClient::MultiplexedExternalProcessorClient(
+    Grpc::AsyncClientManager& client_manager,
+    const envoy::config::core::v3::GrpcService& grpc_service, Stats::Scope& scope,
+    Event::Dispatcher& dispatcher, uint32_t max_streams)
+    : client_(client_manager.factoryForGrpcService(grpc_service, scope, true)->create()),
+      dispatcher_(dispatcher), max_streams_(max_streams) {}
+
+ExternalProcessorStreamPtr
+MultiplexedExternalProcessorClient::start(ExternalProcessorCallbacks& callbacks,
+                                          const std::chrono::milliseconds& timeout) {
+  SharedStream* shared = pickStream();
+  const uint64_t correlation_id = next_correlation_id_++;
+  auto stream = std::make_unique<MultiplexedStream>(correlation_id, callbacks, shared,
+                                                    dispatcher_, timeout);
+  if (shared != nullptr) {
+    shared->add(correlation_id, *stream);
+  }
+  return stream;
+}
+
+MultiplexedExternalProcessorClient::SharedStream* MultiplexedExternalProcessorClient::pickStream() {
+  SharedStream* least_loaded = nullptr;
+  for (const auto& stream : streams_) {
+    if (least_loaded == nullptr || stream->activeRequests() < least_loaded->activeRequests()) {
+      least_loaded = stream.get();
+    }
+  }
+  if (least_loaded != nullptr &&
+      (least_loaded->activeRequests() == 0 || streams_.size() >= max_streams_)) {
+    return least_loaded;
+  }
+
+  auto stream = std::make_unique<SharedStream>(*this);
+  if (!stream->open()) {
+    // Fall back on the streams that are already open, if any.
+    return least_loaded;
+  }
+  streams_.push_back(std::move(stream));
+  return streams_.back().get();
+}
+
+void MultiplexedExternalProcessorClient::removeStream(SharedStream& stream) {
+  for (auto it = streams_.begin(); it != streams_.end(); ++it) {
+    if (it->get() == &stream) {
+      // The stream is still on the stack of its callbacks.
+      dispatcher_.deferredDelete(std::move(*it));
+      streams_.erase(it);
+      return;
+    }
+  }
+}
+
+MultiplexedExternalProcessorClient::MultiplexedStream::MultiplexedStream(
+    uint64_t correlation_id, ExternalProcessorCallbacks& callbacks, SharedStream* shared,
+    Event::Dispatcher& dispatcher, const std::chrono::milliseconds& timeout)
+    : correlation_id_(correlation_id), callbacks_(callbacks), shared_(shared),
+      timer_(dispatcher.createTimer([this]() { onTimeout(); })) {
+  // Without a shared stream the failure to open one is reported from the dispatcher, as the
+  // callbacks do not expect to be called before start() returns.
+  timer_->enableTimer(shared_ != nullptr ? timeout : std::chrono::milliseconds(0));
+}
+
+MultiplexedExternalProcessorClient::MultiplexedStream::~MultiplexedStream() { detach(); }
+
+void MultiplexedExternalProcessorClient::MultiplexedStream::send(ProcessingRequest&& request,
+                                                                 bool) {
+  // The shared stream outlives the requests it carries, so the end of a request does not end it.
+  if (shared_ == nullptr) {
+    return;
+  }
+  request.set_correlation_id(correlation_id_);
+  shared_->send(std::move(request));
+}
+
+void MultiplexedExternalProcessorClient::MultiplexedStream::close() { detach(); }
+
+void MultiplexedExternalProcessorClient::MultiplexedStream::detach() {
+  if (shared_ != nullptr) {
+    shared_->remove(correlation_id_);
+    shared_ = nullptr;
+  }
+  timer_->disableTimer();
+}
+
+void MultiplexedExternalProcessorClient::MultiplexedStream::onTimeout() {
+  if (shared_ == nullptr) {
+    callbacks_.onGrpcError(Grpc::Status::WellKnownGrpcStatus::Unavailable);
+    return;
+  }
+  detach();
+  callbacks_.onGrpcError(Grpc::Status::WellKnownGrpcStatus::DeadlineExceeded);
+}
+
+MultiplexedExternalProcessorClient::SharedStream::~SharedStream() {
+  auto requests = std::move(requests_);
+  requests_.clear();
+  for (auto& request : requests) {
+    request.second->detach();
+  }
+  if (!closed_ && stream_ != nullptr) {
+    stream_.resetStream();
+  }
+}
+
+bool MultiplexedExternalProcessorClient::SharedStream::open() {
+  const auto* descriptor =
+      Protobuf::DescriptorPool::generated_pool()->FindMethodByName(kExternalMethod);
+  stream_ = parent_.client_.start(*descriptor, *this, Http::AsyncClient::StreamOptions());
+  return stream_ != nullptr && !closed_;
+}
+
+void MultiplexedExternalProcessorClient::SharedStream::send(ProcessingRequest&& request) {
+  // Messages sent in the same dispatcher iteration are coalesced in the writes of the connection.
+  stream_.sendMessage(std::move(request), false);
+}
+
+void MultiplexedExternalProcessorClient::SharedStream::add(uint64_t correlation_id,
+                                                           MultiplexedStream& stream) {
+  requests_.emplace(correlation_id, &stream);
+}
+
+void MultiplexedExternalProcessorClient::SharedStream::onReceiveMessage(
+    std::unique_ptr<ProcessingResponse>&& response) {
+  auto it = requests_.find(response->correlation_id());
+  if (it == requests_.end()) {
+    // The request already completed, timed out or was reset.
+    ENVOY_LOG(debug, "ext_proc dropping a response for unknown correlation ID {}",
+              response->correlation_id());
+    return;
+  }
+  it->second->callbacks().onReceiveMessage(std::move(response));
+}
+
+void MultiplexedExternalProcessorClient::SharedStream::onRemoteClose(
+    Grpc::Status::GrpcStatus status, const std::string& message) {
+  ENVOY_LOG(debug, "ext_proc shared stream closed with status {}: {}", status, message);
+  closed_ = true;
+  auto requests = std::move(requests_);
+  requests_.clear();
+  for (auto& request : requests) {
+    request.second->detach();
+  }
+  parent_.removeStream(*this);
+  for (auto& request : requests) {
+    if (status == Grpc::Status::Ok) {
+      request.second->callbacks().onGrpcClose();
+    } else {
+      request.second->callbacks().onGrpcError(status);
+    }
+  }
+}
+
+} // namespace ExternalProcessing
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
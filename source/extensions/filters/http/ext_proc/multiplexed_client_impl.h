@@ -0,0 +1,128 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "envoy/config/core/v3/grpc_service.pb.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/grpc/async_client_manager.h"
+#include "envoy/service/ext_proc/v3alpha/external_processor.pb.h"
+#include "envoy/stats/scope.h"
+
+#include "common/common/logger.h"
+#include "common/grpc/typed_async_client.h"
+
+#include "extensions/filters/http/ext_proc/client.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExternalProcessing {
+
+/**
+ * An ExternalProcessorClient that sends the messages of all the streams it starts on at most
+ * max_streams long-lived gRPC streams, tagging each message with the correlation ID of its stream
+ * and dispatching the responses by the correlation ID they echo. A client is bound to the
+ * dispatcher of a worker and must only be used on that worker.
+ */
+class MultiplexedExternalProcessorClient : public ExternalProcessorClient,
+                                           public Logger::Loggable<Logger::Id::filter> {
+public:
+  MultiplexedExternalProcessorClient(Grpc::AsyncClientManager& client_manager,
+                                     const envoy::config::core::v3::GrpcService& grpc_service,
+                                     Stats::Scope& scope, Event::Dispatcher& dispatcher,
+                                     uint32_t max_streams);
+
+  // ExternalProcessorClient
+  ExternalProcessorStreamPtr start(ExternalProcessorCallbacks& callbacks,
+                                   const std::chrono::milliseconds& timeout) override;
+
+  /**
+   * @return the number of gRPC streams open to the server.
+   */
+  size_t openStreams() const { return streams_.size(); }
+
+private:
+  class SharedStream;
+  using SharedStreamPtr = std::unique_ptr<SharedStream>;
+
+  // The stream of an HTTP request, multiplexed on a shared stream. It is detached from the shared
+  // stream once closed, timed out, or once the shared stream is closed by the server.
+  class MultiplexedStream : public ExternalProcessorStream {
+  public:
+    MultiplexedStream(uint64_t correlation_id, ExternalProcessorCallbacks& callbacks,
+                      SharedStream* shared, Event::Dispatcher& dispatcher,
+                      const std::chrono::milliseconds& timeout);
+    ~MultiplexedStream() override;
+
+    // ExternalProcessorStream
+    void send(envoy::service::ext_proc::v3alpha::ProcessingRequest&& request,
+              bool end_stream) override;
+    void close() override;
+
+    void detach();
+    ExternalProcessorCallbacks& callbacks() { return callbacks_; }
+
+  private:
+    void onTimeout();
+
+    const uint64_t correlation_id_;
+    ExternalProcessorCallbacks& callbacks_;
+    SharedStream* shared_;
+    Event::TimerPtr timer_;
+  };
+
+  // A long-lived gRPC stream carrying the messages of many HTTP requests.
+  class SharedStream
+      : public Grpc::AsyncStreamCallbacks<envoy::service::ext_proc::v3alpha::ProcessingResponse>,
+        public Event::DeferredDeletable {
+  public:
+    explicit SharedStream(MultiplexedExternalProcessorClient& parent) : parent_(parent) {}
+    ~SharedStream() override;
+
+    bool open();
+    void send(envoy::service::ext_proc::v3alpha::ProcessingRequest&& request);
+    void add(uint64_t correlation_id, MultiplexedStream& stream);
+    void remove(uint64_t correlation_id) { requests_.erase(correlation_id); }
+    size_t activeRequests() const { return requests_.size(); }
+
+    // Grpc::AsyncStreamCallbacks
+    void onReceiveMessage(
+        std::unique_ptr<envoy::service::ext_proc::v3alpha::ProcessingResponse>&& response) override;
+
+    // Grpc::RawAsyncStreamCallbacks
+    void onCreateInitialMetadata(Http::RequestHeaderMap&) override {}
+    void onReceiveInitialMetadata(Http::ResponseHeaderMapPtr&&) override {}
+    void onReceiveTrailingMetadata(Http::ResponseTrailerMapPtr&&) override {}
+    void onRemoteClose(Grpc::Status::GrpcStatus status, const std::string& message) override;
+
+  private:
+    MultiplexedExternalProcessorClient& parent_;
+    Grpc::AsyncStream<envoy::service::ext_proc::v3alpha::ProcessingRequest> stream_;
+    bool closed_{};
+    absl::flat_hash_map<uint64_t, MultiplexedStream*> requests_;
+  };
+
+  SharedStream* pickStream();
+  void removeStream(SharedStream& stream);
+
+  Grpc::AsyncClient<envoy::service::ext_proc::v3alpha::ProcessingRequest,
+                    envoy::service::ext_proc::v3alpha::ProcessingResponse>
+      client_;
+  Event::Dispatcher& dispatcher_;
+  const uint32_t max_streams_;
+  std::list<SharedStreamPtr> streams_;
+  // Zero is left for the messages of non multiplexed streams.
+  uint64_t next_correlation_id_{1};
+};
+
+} // namespace ExternalProcessing
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
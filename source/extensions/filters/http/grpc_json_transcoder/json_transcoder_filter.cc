@@ -216,6 +216,7 @@ JsonTranscoderConfig::JsonTranscoderConfig(
 
   match_incoming_request_route_ = proto_config.match_incoming_request_route();
   ignore_unknown_query_parameters_ = proto_config.ignore_unknown_query_parameters();
+  stream_unary_responses_ = proto_config.stream_unary_responses();
 }
 
 void JsonTranscoderConfig::addFileDescriptor(const Protobuf::FileDescriptorProto& file) {
@@ -595,6 +596,12 @@ Http::FilterDataStatus JsonTranscoderFilter::encodeData(Buffer::Instance& data,
   readToBuffer(*transcoder_->ResponseOutput(), data);
 
   if (!method_->descriptor_->server_streaming() && !end_stream) {
+    if (config_.streamUnaryResponses() && (unary_response_streamed_ || data.length() > 0)) {
+      // The headers go along with the first JSON bytes, before the length of the body is known.
+      unary_response_streamed_ = true;
+      response_headers_->removeContentLength();
+      return Http::FilterDataStatus::Continue;
+    }
     // Buffer until the response is complete.
     return Http::FilterDataStatus::StopIterationAndBuffer;
   }
@@ -636,7 +643,7 @@ void JsonTranscoderFilter::doTrailers(Http::ResponseHeaderOrTrailerMap& headers_
   const bool is_trailers_only_response = response_headers_ == &headers_or_trailers;
   const bool is_server_streaming = method_->descriptor_->server_streaming();
 
-  if (is_server_streaming && !is_trailers_only_response) {
+  if ((is_server_streaming || unary_response_streamed_) && !is_trailers_only_response) {
     // Continue if headers were sent already.
     return;
   }
@@ -102,6 +102,12 @@ public:
    */
   bool convertGrpcStatus() const;
 
+  /**
+   * If true, the JSON of unary responses is sent as it is transcoded, ahead of the gRPC trailers,
+   * rather than buffered until the response is complete.
+   */
+  bool streamUnaryResponses() const { return stream_unary_responses_; }
+
 private:
   /**
    * Convert method descriptor to RequestInfo that needed for transcoding library
@@ -128,6 +134,7 @@ private:
   bool match_incoming_request_route_{false};
   bool ignore_unknown_query_parameters_{false};
   bool convert_grpc_status_{false};
+  bool stream_unary_responses_{false};
 };
 
 using JsonTranscoderConfigSharedPtr = std::shared_ptr<JsonTranscoderConfig>;
@@ -196,6 +203,8 @@ private:
   bool error_{false};
   bool has_body_{false};
   bool http_body_response_headers_set_{false};
+  // Whether the headers of a unary response were sent ahead of its trailers.
+  bool unary_response_streamed_{false};
 };
 
 } // namespace GrpcJsonTranscoder
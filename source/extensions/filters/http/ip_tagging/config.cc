@@ -3,6 +3,7 @@
 #include "envoy/extensions/filters/http/ip_tagging/v3/ip_tagging.pb.h"
 #include "envoy/extensions/filters/http/ip_tagging/v3/ip_tagging.pb.validate.h"
 #include "envoy/registry/registry.h"
+#include "envoy/singleton/manager.h"
 
 #include "common/protobuf/utility.h"
 
@@ -13,12 +14,18 @@ namespace Extensions {
 namespace HttpFilters {
 namespace IpTagging {
 
+// Singleton registration via macro defined in envoy/singleton/manager.h
+SINGLETON_MANAGER_REGISTRATION(ip_tag_trie_cache);
+
 Http::FilterFactoryCb IpTaggingFilterFactory::createFilterFactoryFromProtoTyped(
     const envoy::extensions::filters::http::ip_tagging::v3::IPTagging& proto_config,
     const std::string& stat_prefix, Server::Configuration::FactoryContext& context) {
 
-  IpTaggingFilterConfigSharedPtr config(
-      new IpTaggingFilterConfig(proto_config, stat_prefix, context.scope(), context.runtime()));
+  IpTagTrieCacheSharedPtr trie_cache = context.singletonManager().getTyped<IpTagTrieCache>(
+      SINGLETON_MANAGER_REGISTERED_NAME(ip_tag_trie_cache),
+      [] { return std::make_shared<IpTagTrieCache>(); });
+  IpTaggingFilterConfigSharedPtr config(new IpTaggingFilterConfig(
+      proto_config, stat_prefix, context.scope(), context.runtime(), std::move(trie_cache)));
 
   return [config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamDecoderFilter(std::make_shared<IpTaggingFilter>(config));
@@ -5,6 +5,7 @@
 
 #include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
+#include "common/protobuf/utility.h"
 
 #include "absl/strings/str_join.h"
 
@@ -13,27 +14,21 @@ namespace Extensions {
 namespace HttpFilters {
 namespace IpTagging {
 
-IpTaggingFilterConfig::IpTaggingFilterConfig(
-    const envoy::extensions::filters::http::ip_tagging::v3::IPTagging& config,
-    const std::string& stat_prefix, Stats::Scope& scope, Runtime::Loader& runtime)
-    : request_type_(requestTypeEnum(config.request_type())), scope_(scope), runtime_(runtime),
-      stat_name_set_(scope.symbolTable().makeSet("IpTagging")),
-      stats_prefix_(stat_name_set_->add(stat_prefix + "ip_tagging")),
-      no_hit_(stat_name_set_->add("no_hit")), total_(stat_name_set_->add("total")),
-      unknown_tag_(stat_name_set_->add("unknown_tag.hit")) {
-
-  // Once loading IP tags from a file system is supported, the restriction on the size
-  // of the set should be removed and observability into what tags are loaded needs
-  // to be implemented.
-  // TODO(ccaraman): Remove size check once file system support is implemented.
-  // Work is tracked by issue https://github.com/envoyproxy/envoy/issues/2695.
-  if (config.ip_tags().empty()) {
-    throw EnvoyException("HTTP IP Tagging Filter requires ip_tags to be specified.");
+IpTagTrieSharedPtr IpTagTrieCache::getOrCreate(
+    const Protobuf::RepeatedPtrField<
+        envoy::extensions::filters::http::ip_tagging::v3::IPTagging::IPTag>& ip_tags) {
+  const std::size_t key = RepeatedPtrUtil::hash(ip_tags);
+  auto it = tries_.find(key);
+  if (it != tries_.end()) {
+    IpTagTrieSharedPtr trie = it->second.lock();
+    if (trie != nullptr) {
+      return trie;
+    }
   }
 
   std::vector<std::pair<std::string, std::vector<Network::Address::CidrRange>>> tag_data;
-  tag_data.reserve(config.ip_tags().size());
-  for (const auto& ip_tag : config.ip_tags()) {
+  tag_data.reserve(ip_tags.size());
+  for (const auto& ip_tag : ip_tags) {
     std::vector<Network::Address::CidrRange> cidr_set;
     cidr_set.reserve(ip_tag.ip_list().size());
     for (const envoy::config::core::v3::CidrRange& entry : ip_tag.ip_list()) {
@@ -49,10 +44,45 @@ IpTaggingFilterConfig::IpTaggingFilterConfig(
       }
     }
 
-    tag_data.emplace_back(ip_tag.ip_tag_name(), cidr_set);
+    tag_data.emplace_back(ip_tag.ip_tag_name(), std::move(cidr_set));
+  }
+  auto trie = std::make_shared<const IpTagTrie>(tag_data);
+
+  // Drop the tries no config uses anymore, as they are only noticed here.
+  for (it = tries_.begin(); it != tries_.end();) {
+    if (it->second.expired()) {
+      tries_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  tries_[key] = trie;
+  return trie;
+}
+
+IpTaggingFilterConfig::IpTaggingFilterConfig(
+    const envoy::extensions::filters::http::ip_tagging::v3::IPTagging& config,
+    const std::string& stat_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+    IpTagTrieCacheSharedPtr trie_cache)
+    : request_type_(requestTypeEnum(config.request_type())), scope_(scope), runtime_(runtime),
+      stat_name_set_(scope.symbolTable().makeSet("IpTagging")),
+      stats_prefix_(stat_name_set_->add(stat_prefix + "ip_tagging")),
+      no_hit_(stat_name_set_->add("no_hit")), total_(stat_name_set_->add("total")),
+      unknown_tag_(stat_name_set_->add("unknown_tag.hit")), trie_cache_(std::move(trie_cache)) {
+
+  // Once loading IP tags from a file system is supported, the restriction on the size
+  // of the set should be removed and observability into what tags are loaded needs
+  // to be implemented.
+  // TODO(ccaraman): Remove size check once file system support is implemented.
+  // Work is tracked by issue https://github.com/envoyproxy/envoy/issues/2695.
+  if (config.ip_tags().empty()) {
+    throw EnvoyException("HTTP IP Tagging Filter requires ip_tags to be specified.");
+  }
+
+  for (const auto& ip_tag : config.ip_tags()) {
     stat_name_set_->rememberBuiltin(absl::StrCat(ip_tag.ip_tag_name(), ".hit"));
   }
-  trie_ = std::make_unique<Network::LcTrie::LcTrie<std::string>>(tag_data);
+  trie_ = trie_cache_->getOrCreate(config.ip_tags());
 }
 
 void IpTaggingFilterConfig::incCounter(Stats::StatName name) {
@@ -77,7 +107,7 @@ Http::FilterHeadersStatus IpTaggingFilter::decodeHeaders(Http::RequestHeaderMap&
     return Http::FilterHeadersStatus::Continue;
   }
 
-  std::vector<std::string> tags =
+  const std::vector<std::string>& tags =
       config_->trie().getData(callbacks_->streamInfo().downstreamRemoteAddress());
 
   if (!tags.empty()) {
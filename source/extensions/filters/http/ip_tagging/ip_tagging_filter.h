@@ -10,12 +10,16 @@
 #include "envoy/extensions/filters/http/ip_tagging/v3/ip_tagging.pb.h"
 #include "envoy/http/filter.h"
 #include "envoy/runtime/runtime.h"
+#include "envoy/singleton/instance.h"
 #include "envoy/stats/scope.h"
 
 #include "common/network/cidr_range.h"
 #include "common/network/lc_trie.h"
+#include "common/protobuf/protobuf.h"
 #include "common/stats/symbol_table_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
@@ -26,6 +30,31 @@ namespace IpTagging {
  */
 enum class FilterRequestType { INTERNAL, EXTERNAL, BOTH };
 
+using IpTagTrie = Network::LcTrie::LcTrie<std::string>;
+using IpTagTrieSharedPtr = std::shared_ptr<const IpTagTrie>;
+
+/**
+ * The tries of the IP tags, shared by the filter configs with the same tags, so that a large list
+ * of tags is built and held once however many listeners and filter chains use it. A trie is freed
+ * with the last config using it. Only used on the main thread, where the configs are created.
+ */
+class IpTagTrieCache : public Singleton::Instance {
+public:
+  /**
+   * @param ip_tags supplies the tags of the trie.
+   * @return the trie of the tags, built from them if no config uses the same tags.
+   */
+  IpTagTrieSharedPtr getOrCreate(
+      const Protobuf::RepeatedPtrField<
+          envoy::extensions::filters::http::ip_tagging::v3::IPTagging::IPTag>& ip_tags);
+
+private:
+  // Keyed by the hash of the tags.
+  absl::flat_hash_map<std::size_t, std::weak_ptr<const IpTagTrie>> tries_;
+};
+
+using IpTagTrieCacheSharedPtr = std::shared_ptr<IpTagTrieCache>;
+
 /**
  * Configuration for the HTTP IP Tagging filter.
  */
@@ -33,11 +62,11 @@ class IpTaggingFilterConfig {
 public:
   IpTaggingFilterConfig(const envoy::extensions::filters::http::ip_tagging::v3::IPTagging& config,
                         const std::string& stat_prefix, Stats::Scope& scope,
-                        Runtime::Loader& runtime);
+                        Runtime::Loader& runtime, IpTagTrieCacheSharedPtr trie_cache);
 
   Runtime::Loader& runtime() { return runtime_; }
   FilterRequestType requestType() const { return request_type_; }
-  const Network::LcTrie::LcTrie<std::string>& trie() const { return *trie_; }
+  const IpTagTrie& trie() const { return *trie_; }
 
   void incHit(absl::string_view tag) {
     incCounter(stat_name_set_->getBuiltin(absl::StrCat(tag, ".hit"), unknown_tag_));
@@ -70,7 +99,9 @@ private:
   const Stats::StatName no_hit_;
   const Stats::StatName total_;
   const Stats::StatName unknown_tag_;
-  std::unique_ptr<Network::LcTrie::LcTrie<std::string>> trie_;
+  // Held so that the cache outlives the tries it hands out.
+  const IpTagTrieCacheSharedPtr trie_cache_;
+  IpTagTrieSharedPtr trie_;
 };
 
 using IpTaggingFilterConfigSharedPtr = std::shared_ptr<IpTaggingFilterConfig>;
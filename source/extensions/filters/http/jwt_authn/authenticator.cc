@@ -57,6 +57,9 @@ private:
   // Verify with a specific public key.
   void verifyKey();
 
+  // Handle a verified token: forward its payload and remove it if configured.
+  void handleGoodJwt();
+
   // Calls the callback with status.
   void doneWithStatus(const Status& status);
 
@@ -78,8 +81,8 @@ private:
   // The token data
   std::vector<JwtLocationConstPtr> tokens_;
   JwtLocationConstPtr curr_token_;
-  // The JWT object.
-  std::unique_ptr<::google::jwt_verify::Jwt> jwt_;
+  // The JWT object, possibly shared with the cache of verified tokens.
+  JwtConstSharedPtr jwt_;
   // The JWKS data object
   JwksCache::JwksData* jwks_data_{};
 
@@ -139,12 +142,22 @@ void AuthenticatorImpl::startVerify() {
   curr_token_ = std::move(tokens_.back());
   tokens_.pop_back();
 
-  jwt_ = std::make_unique<::google::jwt_verify::Jwt>();
-  ENVOY_LOG(debug, "{}: Parse Jwt {}", name(), curr_token_->token());
-  Status status = jwt_->parseFromString(curr_token_->token());
-  if (status != Status::Ok) {
-    doneWithStatus(status);
-    return;
+  // With a specific provider, a token verified before is not parsed again.
+  bool verified = false;
+  if (provider_) {
+    jwt_ = jwks_cache_.findByProvider(provider_.value())->findVerifiedJwt(curr_token_->token());
+    verified = jwt_ != nullptr;
+  }
+  Status status = Status::Ok;
+  if (!verified) {
+    auto jwt = std::make_unique<::google::jwt_verify::Jwt>();
+    ENVOY_LOG(debug, "{}: Parse Jwt {}", name(), curr_token_->token());
+    status = jwt->parseFromString(curr_token_->token());
+    if (status != Status::Ok) {
+      doneWithStatus(status);
+      return;
+    }
+    jwt_ = std::move(jwt);
   }
 
   ENVOY_LOG(debug, "{}: Verifying JWT token of issuer {}", name(), jwt_->iss_);
@@ -188,6 +201,13 @@ void AuthenticatorImpl::startVerify() {
     return;
   }
 
+  // A token verified before with the current keys is not verified again.
+  if (verified || jwks_data_->findVerifiedJwt(curr_token_->token()) != nullptr) {
+    ENVOY_LOG(debug, "{}: JWT token was verified before", name());
+    handleGoodJwt();
+    return;
+  }
+
   auto jwks_obj = jwks_data_->getJwksObj();
   if (jwks_obj != nullptr && !jwks_data_->isExpired()) {
     // TODO(qiwzhang): It would seem there's a window of error whereby if the JWT issuer
@@ -244,6 +264,11 @@ void AuthenticatorImpl::verifyKey() {
     return;
   }
 
+  jwks_data_->addVerifiedJwt(curr_token_->token(), jwt_);
+  handleGoodJwt();
+}
+
+void AuthenticatorImpl::handleGoodJwt() {
   // Forward the payload
   const auto& provider = jwks_data_->getJwtProvider();
   if (!provider.forward_payload_header().empty()) {
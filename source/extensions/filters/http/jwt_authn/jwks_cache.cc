@@ -26,6 +26,9 @@ namespace {
 // Default cache expiration time in 5 minutes.
 constexpr int PubkeyCacheExpirationSec = 600;
 
+// Default number of verified tokens cached per worker.
+constexpr uint32_t DefaultJwtCacheSize = 100;
+
 class JwksDataImpl : public JwksCache::JwksData, public Logger::Loggable<Logger::Id::jwt> {
 public:
   JwksDataImpl(const JwtProvider& jwt_provider, TimeSource& time_source, Api::Api& api)
@@ -36,6 +39,11 @@ public:
     }
     audiences_ = std::make_unique<::google::jwt_verify::CheckAudience>(audiences);
 
+    if (jwt_provider_.has_jwt_cache_config()) {
+      const uint32_t size = jwt_provider_.jwt_cache_config().jwt_cache_size();
+      jwt_cache_ = std::make_unique<JwtCache>(size > 0 ? size : DefaultJwtCacheSize);
+    }
+
     const auto inline_jwks = Config::DataSource::read(jwt_provider_.local_jwks(), true, api);
     if (!inline_jwks.empty()) {
       auto ptr = setKey(
@@ -63,6 +71,19 @@ public:
     return setKey(std::move(jwks), getRemoteJwksExpirationTime());
   }
 
+  JwtConstSharedPtr findVerifiedJwt(const std::string& token) override {
+    if (jwt_cache_ == nullptr || jwks_obj_ == nullptr || isExpired()) {
+      return nullptr;
+    }
+    return jwt_cache_->lookup(token);
+  }
+
+  void addVerifiedJwt(const std::string& token, JwtConstSharedPtr jwt) override {
+    if (jwt_cache_ != nullptr) {
+      jwt_cache_->insert(token, std::move(jwt));
+    }
+  }
+
 private:
   // Get the expiration time for a remote Jwks
   std::chrono::steady_clock::time_point getRemoteJwksExpirationTime() const {
@@ -78,6 +99,10 @@ private:
 
   const ::google::jwt_verify::Jwks* setKey(::google::jwt_verify::JwksPtr&& jwks,
                                            MonotonicTime expire) {
+    // The tokens were verified with the keys being replaced.
+    if (jwt_cache_ != nullptr) {
+      jwt_cache_->clear();
+    }
     jwks_obj_ = std::move(jwks);
     expiration_time_ = expire;
     return jwks_obj_.get();
@@ -92,6 +117,8 @@ private:
   TimeSource& time_source_;
   // The pubkey expiration time.
   MonotonicTime expiration_time_;
+  // The tokens verified with the Jwks, if cached.
+  JwtCachePtr jwt_cache_;
 };
 
 class JwksCacheImpl : public JwksCache {
@@ -5,6 +5,8 @@
 #include "envoy/common/time.h"
 #include "envoy/extensions/filters/http/jwt_authn/v3/config.pb.h"
 
+#include "extensions/filters/http/jwt_authn/jwt_cache.h"
+
 #include "jwt_verify_lib/jwks.h"
 
 namespace Envoy {
@@ -58,6 +60,13 @@ public:
     // Set a remote Jwks.
     virtual const ::google::jwt_verify::Jwks*
     setRemoteJwks(::google::jwt_verify::JwksPtr&& jwks) PURE;
+
+    // Get the parsed Jwt of a token verified with the current Jwks, or nullptr if the token was
+    // not verified, the Jwks expired or the verified tokens are not cached.
+    virtual JwtConstSharedPtr findVerifiedJwt(const std::string& token) PURE;
+
+    // Add a token verified with the current Jwks, if the verified tokens are cached.
+    virtual void addVerifiedJwt(const std::string& token, JwtConstSharedPtr jwt) PURE;
   };
 
   // Lookup issuer cache map. The cache only stores Jwks specified in the config.
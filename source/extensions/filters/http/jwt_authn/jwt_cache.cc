@@ -0,0 +1,22 @@
+#include "extensions/filters/http/jwt_authn/jwt_cache.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+
+JwtConstSharedPtr JwtCache::lookup(const std::string& token) {
+  const JwtConstSharedPtr* jwt = jwts_.find(token);
+  return jwt != nullptr ? *jwt : nullptr;
+}
+
+void JwtCache::insert(const std::string& token, JwtConstSharedPtr jwt) {
+  jwts_.insert(token, std::move(jwt));
+}
+
+void JwtCache::clear() { jwts_.clear(); }
+
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "common/common/lru_cache.h"
+
+#include "jwt_verify_lib/jwt.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+
+using JwtConstSharedPtr = std::shared_ptr<const ::google::jwt_verify::Jwt>;
+
+/**
+ * Cache of the tokens successfully verified with the JWKS of a provider, holding their parsed
+ * Jwt so that a token verified before is neither parsed nor verified again. It is used by a single
+ * worker, and evicts the least recently used tokens once full.
+ */
+class JwtCache {
+public:
+  explicit JwtCache(uint32_t max_entries) : jwts_(max_entries) {}
+
+  // Get the parsed Jwt of a verified token, or nullptr.
+  JwtConstSharedPtr lookup(const std::string& token);
+
+  // Add the parsed Jwt of a verified token.
+  void insert(const std::string& token, JwtConstSharedPtr jwt);
+
+  // Drop all the tokens, e.g. when the keys they were verified with change.
+  void clear();
+
+  size_t size() const { return jwts_.size(); }
+
+private:
+  LruCache<std::string, JwtConstSharedPtr> jwts_;
+};
+
+using JwtCachePtr = std::unique_ptr<JwtCache>;
+
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
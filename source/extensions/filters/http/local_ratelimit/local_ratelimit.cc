@@ -12,10 +12,16 @@ namespace Extensions {
 namespace HttpFilters {
 namespace LocalRateLimitFilter {
 
+namespace {
+
+constexpr uint32_t DefaultMaxDescriptorBuckets = 10000;
+
+} // namespace
+
 FilterConfig::FilterConfig(
     const envoy::extensions::filters::http::local_ratelimit::v3::LocalRateLimit& config,
-    Event::Dispatcher& dispatcher, Stats::Scope& scope, Runtime::Loader& runtime,
-    const bool per_route)
+    const LocalInfo::LocalInfo& local_info, Event::Dispatcher& dispatcher, Stats::Scope& scope,
+    Runtime::Loader& runtime, const bool per_route)
     : status_(toErrorCode(config.status().code())),
       stats_(generateStats(config.stat_prefix(), scope)),
       rate_limiter_(Filters::Common::LocalRateLimit::LocalRateLimiterImpl(
@@ -23,7 +29,16 @@ FilterConfig::FilterConfig(
               PROTOBUF_GET_MS_OR_DEFAULT(config.token_bucket(), fill_interval, 0)),
           config.token_bucket().max_tokens(),
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.token_bucket(), tokens_per_fill, 1), dispatcher)),
-      runtime_(runtime),
+      has_token_bucket_(config.has_token_bucket()),
+      descriptor_rate_limiter_(
+          config.descriptors().empty()
+              ? nullptr
+              : std::make_unique<Filters::Common::LocalRateLimit::LocalDescriptorRateLimiter>(
+                    config.descriptors(),
+                    PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_descriptor_buckets,
+                                                    DefaultMaxDescriptorBuckets),
+                    dispatcher.timeSource())),
+      stage_(config.stage()), local_info_(local_info), runtime_(runtime),
       filter_enabled_(
           config.has_filter_enabled()
               ? absl::optional<Envoy::Runtime::FractionalPercent>(
@@ -40,13 +55,25 @@ FilterConfig::FilterConfig(
   //       the filter globally but disabled and then applying limits at the virtual host or
   //       route level. At the virtual or route level, it makes no sense to have an no token
   //       bucket so we throw an error. If there's no token bucket configured globally or
-  //       at the vhost/route level, no rate limiting is applied.
-  if (per_route && !config.has_token_bucket()) {
+  //       at the vhost/route level, no rate limiting is applied. Descriptors are enough to rate
+  //       limit a route.
+  if (per_route && !config.has_token_bucket() && config.descriptors().empty()) {
     throw EnvoyException("local rate limit token bucket must be set for per filter configs");
   }
 }
 
-bool FilterConfig::requestAllowed() const { return rate_limiter_.requestAllowed(); }
+bool FilterConfig::requestAllowed(const std::vector<RateLimit::Descriptor>& descriptors) const {
+  if (descriptor_rate_limiter_ != nullptr) {
+    if (!descriptor_rate_limiter_->requestAllowed(descriptors)) {
+      return false;
+    }
+    // Without a token bucket, only the descriptors are rate limited.
+    if (!has_token_bucket_) {
+      return true;
+    }
+  }
+  return rate_limiter_.requestAllowed();
+}
 
 LocalRateLimitStats FilterConfig::generateStats(const std::string& prefix, Stats::Scope& scope) {
   const std::string final_prefix = prefix + ".http_local_rate_limit";
@@ -61,7 +88,7 @@ bool FilterConfig::enforced() const {
   return filter_enforced_.has_value() ? filter_enforced_->enabled() : false;
 }
 
-Http::FilterHeadersStatus Filter::decodeHeaders(Http::RequestHeaderMap&, bool) {
+Http::FilterHeadersStatus Filter::decodeHeaders(Http::RequestHeaderMap& headers, bool) {
   const auto* config = getConfig();
 
   if (!config->enabled()) {
@@ -70,7 +97,12 @@ Http::FilterHeadersStatus Filter::decodeHeaders(Http::RequestHeaderMap&, bool) {
 
   config->stats().enabled_.inc();
 
-  if (config->requestAllowed()) {
+  std::vector<RateLimit::Descriptor> descriptors;
+  if (config->hasDescriptors()) {
+    populateDescriptors(*config, headers, descriptors);
+  }
+
+  if (config->requestAllowed(descriptors)) {
     config->stats().ok_.inc();
     return Http::FilterHeadersStatus::Continue;
   }
@@ -94,6 +126,27 @@ Http::FilterHeadersStatus Filter::decodeHeaders(Http::RequestHeaderMap&, bool) {
   return Http::FilterHeadersStatus::StopIteration;
 }
 
+void Filter::populateDescriptors(const FilterConfig& config, const Http::RequestHeaderMap& headers,
+                                 std::vector<RateLimit::Descriptor>& descriptors) const {
+  const Router::RouteConstSharedPtr route = decoder_callbacks_->route();
+  if (!route || !route->routeEntry()) {
+    return;
+  }
+  const Router::RouteEntry& route_entry = *route->routeEntry();
+  // As by default in the rate limit filter, the rate limits of the virtual host only apply to the
+  // routes which have none.
+  const Router::RateLimitPolicy& rate_limit_policy =
+      route_entry.rateLimitPolicy().empty() ? route_entry.virtualHost().rateLimitPolicy()
+                                            : route_entry.rateLimitPolicy();
+  for (const Router::RateLimitPolicyEntry& rate_limit :
+       rate_limit_policy.getApplicableRateLimit(config.stage())) {
+    rate_limit.populateDescriptors(
+        route_entry, descriptors, config.localInfo().clusterName(), headers,
+        *decoder_callbacks_->streamInfo().downstreamRemoteAddress(),
+        &decoder_callbacks_->streamInfo().dynamicMetadata());
+  }
+}
+
 const FilterConfig* Filter::getConfig() const {
   const auto* config = Http::Utility::resolveMostSpecificPerFilterConfig<FilterConfig>(
       "envoy.filters.http.local_ratelimit", decoder_callbacks_->route());
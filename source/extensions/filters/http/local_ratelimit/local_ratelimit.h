@@ -7,6 +7,8 @@
 
 #include "envoy/extensions/filters/http/local_ratelimit/v3/local_rate_limit.pb.h"
 #include "envoy/http/filter.h"
+#include "envoy/local_info/local_info.h"
+#include "envoy/ratelimit/ratelimit.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
@@ -46,11 +48,14 @@ struct LocalRateLimitStats {
 class FilterConfig : public ::Envoy::Router::RouteSpecificFilterConfig {
 public:
   FilterConfig(const envoy::extensions::filters::http::local_ratelimit::v3::LocalRateLimit& config,
-               Event::Dispatcher& dispatcher, Stats::Scope& scope, Runtime::Loader& runtime,
-               bool per_route = false);
+               const LocalInfo::LocalInfo& local_info, Event::Dispatcher& dispatcher,
+               Stats::Scope& scope, Runtime::Loader& runtime, bool per_route = false);
   ~FilterConfig() override = default;
+  const LocalInfo::LocalInfo& localInfo() const { return local_info_; }
   Runtime::Loader& runtime() { return runtime_; }
-  bool requestAllowed() const;
+  bool requestAllowed(const std::vector<RateLimit::Descriptor>& descriptors) const;
+  bool hasDescriptors() const { return descriptor_rate_limiter_ != nullptr; }
+  uint32_t stage() const { return stage_; }
   bool enabled() const;
   bool enforced() const;
   LocalRateLimitStats& stats() const { return stats_; }
@@ -73,6 +78,11 @@ private:
   const Http::Code status_;
   mutable LocalRateLimitStats stats_;
   Filters::Common::LocalRateLimit::LocalRateLimiterImpl rate_limiter_;
+  const bool has_token_bucket_;
+  std::unique_ptr<Filters::Common::LocalRateLimit::LocalDescriptorRateLimiter>
+      descriptor_rate_limiter_;
+  const uint32_t stage_;
+  const LocalInfo::LocalInfo& local_info_;
   Runtime::Loader& runtime_;
   const absl::optional<Envoy::Runtime::FractionalPercent> filter_enabled_;
   const absl::optional<Envoy::Runtime::FractionalPercent> filter_enforced_;
@@ -97,6 +107,8 @@ private:
   friend class FilterTest;
 
   const FilterConfig* getConfig() const;
+  void populateDescriptors(const FilterConfig& config, const Http::RequestHeaderMap& headers,
+                           std::vector<RateLimit::Descriptor>& descriptors) const;
 
   FilterConfigSharedPtr config_;
 };
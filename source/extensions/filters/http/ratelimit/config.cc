@@ -10,6 +10,7 @@
 #include "common/config/utility.h"
 #include "common/protobuf/utility.h"
 
+#include "extensions/filters/common/ratelimit/quota_cache.h"
 #include "extensions/filters/common/ratelimit/ratelimit_impl.h"
 #include "extensions/filters/http/ratelimit/ratelimit.h"
 
@@ -22,19 +23,39 @@ Http::FilterFactoryCb RateLimitFilterConfig::createFilterFactoryFromProtoTyped(
     const envoy::extensions::filters::http::ratelimit::v3::RateLimit& proto_config,
     const std::string&, Server::Configuration::FactoryContext& context) {
   ASSERT(!proto_config.domain().empty());
-  FilterConfigSharedPtr filter_config(new FilterConfig(proto_config, context.localInfo(),
-                                                       context.scope(), context.runtime(),
-                                                       context.httpContext()));
   const std::chrono::milliseconds timeout =
       std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(proto_config, timeout, 20));
+  const envoy::config::core::v3::ApiVersion transport_api_version =
+      Config::Utility::getAndCheckTransportVersion(proto_config.rate_limit_service());
 
-  return [proto_config, &context, timeout,
+  Filters::Common::RateLimit::ThreadLocalQuotaCacheSharedPtr quota_cache;
+  if (proto_config.has_quota_cache()) {
+    const auto& quota_cache_config = proto_config.quota_cache();
+    const Filters::Common::RateLimit::QuotaCache::Options options{
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(quota_cache_config, max_lease, 100),
+        quota_cache_config.min_remaining(),
+        std::chrono::milliseconds(
+            PROTOBUF_GET_MS_OR_DEFAULT(quota_cache_config, report_interval, 1000)),
+        timeout, transport_api_version};
+    quota_cache = std::make_shared<Filters::Common::RateLimit::ThreadLocalQuotaCache>(
+        context.threadLocal(),
+        context.clusterManager().grpcAsyncClientManager().factoryForGrpcService(
+            proto_config.rate_limit_service().grpc_service(), context.scope(), true),
+        options);
+  }
+  FilterConfigSharedPtr filter_config(
+      new FilterConfig(proto_config, context.localInfo(), context.scope(), context.runtime(),
+                       context.httpContext(), std::move(quota_cache)));
+
+  return [proto_config, &context, timeout, transport_api_version,
           filter_config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
-    callbacks.addStreamFilter(std::make_shared<Filter>(
-        filter_config,
-        Filters::Common::RateLimit::rateLimitClient(
-            context, proto_config.rate_limit_service().grpc_service(), timeout,
-            Config::Utility::getAndCheckTransportVersion(proto_config.rate_limit_service()))));
+    Filters::Common::RateLimit::ClientPtr client = Filters::Common::RateLimit::rateLimitClient(
+        context, proto_config.rate_limit_service().grpc_service(), timeout, transport_api_version);
+    if (filter_config->quotaCache() != nullptr) {
+      client = std::make_unique<Filters::Common::RateLimit::QuotaCachingClient>(
+          std::move(client), filter_config->quotaCache()->get());
+    }
+    callbacks.addStreamFilter(std::make_shared<Filter>(filter_config, std::move(client)));
   };
 }
 
@@ -17,6 +17,7 @@
 #include "common/common/assert.h"
 #include "common/http/header_map_impl.h"
 
+#include "extensions/filters/common/ratelimit/quota_cache.h"
 #include "extensions/filters/common/ratelimit/ratelimit.h"
 #include "extensions/filters/common/ratelimit/stat_names.h"
 
@@ -42,7 +43,8 @@ class FilterConfig {
 public:
   FilterConfig(const envoy::extensions::filters::http::ratelimit::v3::RateLimit& config,
                const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
-               Runtime::Loader& runtime, Http::Context& http_context)
+               Runtime::Loader& runtime, Http::Context& http_context,
+               Filters::Common::RateLimit::ThreadLocalQuotaCacheSharedPtr quota_cache = nullptr)
       : domain_(config.domain()), stage_(static_cast<uint64_t>(config.stage())),
         request_type_(config.request_type().empty() ? stringToType("both")
                                                     : stringToType(config.request_type())),
@@ -56,7 +58,8 @@ public:
             config.rate_limited_as_resource_exhausted()
                 ? absl::make_optional(Grpc::Status::WellKnownGrpcStatus::ResourceExhausted)
                 : absl::nullopt),
-        http_context_(http_context), stat_names_(scope.symbolTable()) {}
+        http_context_(http_context), stat_names_(scope.symbolTable()),
+        quota_cache_(std::move(quota_cache)) {}
   const std::string& domain() const { return domain_; }
   const LocalInfo::LocalInfo& localInfo() const { return local_info_; }
   uint64_t stage() const { return stage_; }
@@ -71,6 +74,8 @@ public:
   }
   Http::Context& httpContext() { return http_context_; }
   Filters::Common::RateLimit::StatNames& statNames() { return stat_names_; }
+  // The quota caches of the workers, null unless the quota is cached.
+  Filters::Common::RateLimit::ThreadLocalQuotaCache* quotaCache() { return quota_cache_.get(); }
 
 private:
   static FilterRequestType stringToType(const std::string& request_type) {
@@ -96,6 +101,7 @@ private:
   const absl::optional<Grpc::Status::GrpcStatus> rate_limited_grpc_status_;
   Http::Context& http_context_;
   Filters::Common::RateLimit::StatNames stat_names_;
+  const Filters::Common::RateLimit::ThreadLocalQuotaCacheSharedPtr quota_cache_;
 };
 
 using FilterConfigSharedPtr = std::shared_ptr<FilterConfig>;
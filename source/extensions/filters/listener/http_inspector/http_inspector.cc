@@ -24,7 +24,6 @@ Config::Config(Stats::Scope& scope)
     : stats_{ALL_HTTP_INSPECTOR_STATS(POOL_COUNTER_PREFIX(scope, "http_inspector."))} {}
 
 const absl::string_view Filter::HTTP2_CONNECTION_PREFACE = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
-thread_local uint8_t Filter::buf_[Config::MAX_INSPECT_SIZE];
 
 Filter::Filter(const ConfigSharedPtr config) : config_(config) {
   http_parser_init(&parser_, HTTP_REQUEST);
@@ -48,7 +47,9 @@ Network::FilterStatus Filter::onAccept(Network::ListenerFilterCallbacks& cb) {
   }
 
   cb_ = &cb;
-  const ParseState parse_state = onRead();
+  // The bytes peeked by the previous listener filters are parsed before the socket is read.
+  const absl::string_view peeked = cb.listenerFilterBuffer().data();
+  const ParseState parse_state = peeked.empty() ? onRead() : onPeeked(peeked);
   switch (parse_state) {
   case ParseState::Error:
     // As per discussion in https://github.com/envoyproxy/envoy/issues/7864
@@ -100,7 +101,8 @@ Network::FilterStatus Filter::onAccept(Network::ListenerFilterCallbacks& cb) {
 }
 
 ParseState Filter::onRead() {
-  auto result = cb_->socket().ioHandle().recv(buf_, Config::MAX_INSPECT_SIZE, MSG_PEEK);
+  Network::ListenerFilterBuffer& buffer = cb_->listenerFilterBuffer();
+  auto result = buffer.peek(Config::MAX_INSPECT_SIZE);
   ENVOY_LOG(trace, "http inspector: recv: {}", result.rc_);
   if (!result.ok()) {
     if (result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
@@ -109,9 +111,11 @@ ParseState Filter::onRead() {
     config_->stats().read_error_.inc();
     return ParseState::Error;
   }
+  return onPeeked(buffer.data());
+}
 
-  const auto parse_state =
-      parseHttpHeader(absl::string_view(reinterpret_cast<const char*>(buf_), result.rc_));
+ParseState Filter::onPeeked(absl::string_view data) {
+  const auto parse_state = parseHttpHeader(data.substr(0, Config::MAX_INSPECT_SIZE));
   switch (parse_state) {
   case ParseState::Continue:
     // do nothing but wait for the next event
@@ -74,6 +74,7 @@ private:
   static const absl::string_view HTTP2_CONNECTION_PREFACE;
 
   ParseState onRead();
+  ParseState onPeeked(absl::string_view data);
   void done(bool success);
   ParseState parseHttpHeader(absl::string_view data);
 
@@ -85,9 +86,6 @@ private:
   absl::string_view protocol_;
   http_parser parser_;
   static http_parser_settings settings_;
-
-  // Use static thread_local to avoid allocating buffer over and over again.
-  static thread_local uint8_t buf_[Config::MAX_INSPECT_SIZE];
 };
 
 } // namespace HttpInspector
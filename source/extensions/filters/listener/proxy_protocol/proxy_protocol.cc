@@ -135,6 +135,9 @@ ReadOrParseState Filter::onReadWorker() {
 
   // Release the file event so that we do not interfere with the connection read events.
   socket.ioHandle().resetFileEvents();
+  // The header has been consumed from the socket, so the bytes the previous filters peeked at are
+  // no longer the ones the next filters are to inspect.
+  cb_->listenerFilterBuffer().clear();
   cb_->continueFilterChain(true);
   return ReadOrParseState::Done;
 }
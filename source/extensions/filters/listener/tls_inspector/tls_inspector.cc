@@ -1,5 +1,6 @@
 #include "extensions/filters/listener/tls_inspector/tls_inspector.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -16,6 +17,7 @@
 #include "extensions/transport_sockets/well_known_names.h"
 
 #include "absl/strings/str_join.h"
+#include "absl/types/optional.h"
 #include "openssl/ssl.h"
 
 namespace Envoy {
@@ -23,64 +25,71 @@ namespace Extensions {
 namespace ListenerFilters {
 namespace TlsInspector {
 
-// Min/max TLS version recognized by the underlying TLS/SSL library.
+// Min/max TLS version recognized by the inspector, as by the underlying TLS/SSL library.
 const unsigned Config::TLS_MIN_SUPPORTED_VERSION = TLS1_VERSION;
 const unsigned Config::TLS_MAX_SUPPORTED_VERSION = TLS1_3_VERSION;
 
+namespace {
+
+// Whether the supported_versions extension of a ClientHello lists a version that the inspector
+// recognizes.
+bool hasSupportedVersion(CBS extension) {
+  CBS versions;
+  if (!CBS_get_u8_length_prefixed(&extension, &versions) || CBS_len(&extension) != 0 ||
+      CBS_len(&versions) == 0) {
+    return false;
+  }
+  uint16_t version;
+  while (CBS_get_u16(&versions, &version)) {
+    if (version >= Config::TLS_MIN_SUPPORTED_VERSION &&
+        version <= Config::TLS_MAX_SUPPORTED_VERSION) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Parses the host name out of the server_name extension of a ClientHello, with the same checks as
+// BoringSSL.
+bool parseServerName(CBS extension, absl::string_view& name) {
+  CBS server_name_list;
+  CBS host_name;
+  uint8_t name_type;
+  if (!CBS_get_u16_length_prefixed(&extension, &server_name_list) ||
+      !CBS_get_u8(&server_name_list, &name_type) ||
+      !CBS_get_u16_length_prefixed(&server_name_list, &host_name) ||
+      CBS_len(&server_name_list) != 0 || CBS_len(&extension) != 0 ||
+      name_type != TLSEXT_NAMETYPE_host_name || CBS_len(&host_name) == 0 ||
+      CBS_len(&host_name) > TLSEXT_MAXLEN_host_name || CBS_contains_zero_byte(&host_name)) {
+    return false;
+  }
+  name = absl::string_view(reinterpret_cast<const char*>(CBS_data(&host_name)),
+                           CBS_len(&host_name));
+  return true;
+}
+
+} // namespace
+
 Config::Config(Stats::Scope& scope, uint32_t max_client_hello_size)
     : stats_{ALL_TLS_INSPECTOR_STATS(POOL_COUNTER_PREFIX(scope, "tls_inspector."))},
-      ssl_ctx_(SSL_CTX_new(TLS_with_buffers_method())),
       max_client_hello_size_(max_client_hello_size) {
 
   if (max_client_hello_size_ > TLS_MAX_CLIENT_HELLO) {
     throw EnvoyException(fmt::format("max_client_hello_size of {} is greater than maximum of {}.",
                                      max_client_hello_size_, size_t(TLS_MAX_CLIENT_HELLO)));
   }
-
-  SSL_CTX_set_min_proto_version(ssl_ctx_.get(), TLS_MIN_SUPPORTED_VERSION);
-  SSL_CTX_set_max_proto_version(ssl_ctx_.get(), TLS_MAX_SUPPORTED_VERSION);
-  SSL_CTX_set_options(ssl_ctx_.get(), SSL_OP_NO_TICKET);
-  SSL_CTX_set_session_cache_mode(ssl_ctx_.get(), SSL_SESS_CACHE_OFF);
-  SSL_CTX_set_select_certificate_cb(
-      ssl_ctx_.get(), [](const SSL_CLIENT_HELLO* client_hello) -> ssl_select_cert_result_t {
-        const uint8_t* data;
-        size_t len;
-        if (SSL_early_callback_ctx_extension_get(
-                client_hello, TLSEXT_TYPE_application_layer_protocol_negotiation, &data, &len)) {
-          Filter* filter = static_cast<Filter*>(SSL_get_app_data(client_hello->ssl));
-          filter->onALPN(data, len);
-        }
-        return ssl_select_cert_success;
-      });
-  SSL_CTX_set_tlsext_servername_callback(
-      ssl_ctx_.get(), [](SSL* ssl, int* out_alert, void*) -> int {
-        Filter* filter = static_cast<Filter*>(SSL_get_app_data(ssl));
-        filter->onServername(
-            absl::NullSafeStringView(SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name)));
-
-        // Return an error to stop the handshake; we have what we wanted already.
-        *out_alert = SSL_AD_USER_CANCELLED;
-        return SSL_TLSEXT_ERR_ALERT_FATAL;
-      });
 }
 
-bssl::UniquePtr<SSL> Config::newSsl() { return bssl::UniquePtr<SSL>{SSL_new(ssl_ctx_.get())}; }
-
-thread_local uint8_t Filter::buf_[Config::TLS_MAX_CLIENT_HELLO];
-
-Filter::Filter(const ConfigSharedPtr config) : config_(config), ssl_(config_->newSsl()) {
-  RELEASE_ASSERT(sizeof(buf_) >= config_->maxClientHelloSize(), "");
-
-  SSL_set_app_data(ssl_.get(), this);
-  SSL_set_accept_state(ssl_.get());
-}
+Filter::Filter(const ConfigSharedPtr config) : config_(config) {}
 
 Network::FilterStatus Filter::onAccept(Network::ListenerFilterCallbacks& cb) {
   ENVOY_LOG(debug, "tls inspector: new connection accepted");
   Network::ConnectionSocket& socket = cb.socket();
   cb_ = &cb;
 
-  ParseState parse_state = onRead();
+  // The bytes peeked by the previous listener filters are parsed before the socket is read.
+  const absl::string_view peeked = cb.listenerFilterBuffer().data();
+  ParseState parse_state = peeked.empty() ? onRead() : onPeeked(peeked);
   switch (parse_state) {
   case ParseState::Error:
     // As per discussion in https://github.com/envoyproxy/envoy/issues/7864
@@ -151,7 +160,6 @@ void Filter::onServername(absl::string_view name) {
   } else {
     config_->stats().sni_not_found_.inc();
   }
-  clienthello_success_ = true;
 }
 
 ParseState Filter::onRead() {
@@ -167,7 +175,8 @@ ParseState Filter::onRead() {
   //
   // TODO(ggreenway): write an integration test to ensure the events work as expected on all
   // platforms.
-  const auto result = cb_->socket().ioHandle().recv(buf_, config_->maxClientHelloSize(), MSG_PEEK);
+  Network::ListenerFilterBuffer& buffer = cb_->listenerFilterBuffer();
+  const auto result = buffer.peek(config_->maxClientHelloSize());
   ENVOY_LOG(trace, "tls inspector: recv: {}", result.rc_);
 
   if (!result.ok()) {
@@ -177,14 +186,17 @@ ParseState Filter::onRead() {
     config_->stats().read_error_.inc();
     return ParseState::Error;
   }
+  return onPeeked(buffer.data());
+}
 
-  // Because we're doing a MSG_PEEK, data we've seen before gets returned every time, so
-  // skip over what we've already processed.
-  if (static_cast<uint64_t>(result.rc_) > read_) {
-    const uint8_t* data = buf_ + read_;
-    const size_t len = result.rc_ - read_;
-    read_ = result.rc_;
-    return parseClientHello(data, len);
+ParseState Filter::onPeeked(absl::string_view data) {
+  // Because we're doing a MSG_PEEK, data we've seen before gets returned every time, so only
+  // parse again once more data has arrived. The previous filters may have peeked more than the
+  // ClientHello is allowed to take.
+  const size_t len = std::min<size_t>(data.size(), config_->maxClientHelloSize());
+  if (len > read_) {
+    read_ = len;
+    return parseClientHello(reinterpret_cast<const uint8_t*>(data.data()), len);
   }
   return ParseState::Continue;
 }
@@ -195,47 +207,148 @@ void Filter::done(bool success) {
   cb_->continueFilterChain(success);
 }
 
-ParseState Filter::parseClientHello(const void* data, size_t len) {
-  // Ownership is passed to ssl_ in SSL_set_bio()
-  bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(data, len));
+ParseState Filter::parseClientHello(const uint8_t* data, size_t len) {
+  CBS records;
+  CBS_init(&records, data, len);
+  // The ClientHello is parsed in place out of its record, and only copied when it spans several
+  // records.
+  CBS message;
+  CBS_init(&message, nullptr, 0);
+  std::vector<uint8_t> fragments;
+  while (true) {
+    CBS header;
+    uint8_t type;
+    uint16_t version;
+    uint16_t record_len;
+    if (!CBS_get_bytes(&records, &header, SSL3_RT_HEADER_LENGTH)) {
+      return waitForClientHello(len - CBS_len(&records) + SSL3_RT_HEADER_LENGTH);
+    }
+    CBS_get_u8(&header, &type);
+    CBS_get_u16(&header, &version);
+    CBS_get_u16(&header, &record_len);
+    if (type != SSL3_RT_HANDSHAKE || (version >> 8) != SSL3_VERSION_MAJOR || record_len == 0 ||
+        record_len > SSL3_RT_MAX_PLAIN_LENGTH) {
+      return tlsNotFound();
+    }
+    CBS fragment;
+    if (!CBS_get_bytes(&records, &fragment, record_len)) {
+      return waitForClientHello(len - CBS_len(&records) + record_len);
+    }
 
-  // Make the mem-BIO return that there is more data
-  // available beyond it's end
-  BIO_set_mem_eof_return(bio.get(), -1);
+    if (CBS_len(&message) == 0) {
+      message = fragment;
+    } else {
+      if (fragments.empty()) {
+        fragments.assign(CBS_data(&message), CBS_data(&message) + CBS_len(&message));
+      }
+      fragments.insert(fragments.end(), CBS_data(&fragment), CBS_data(&fragment) + record_len);
+      CBS_init(&message, fragments.data(), fragments.size());
+    }
 
-  SSL_set_bio(ssl_.get(), bio.get(), bio.get());
-  bio.release();
+    CBS handshake = message;
+    uint8_t message_type;
+    uint32_t message_len;
+    if (!CBS_get_u8(&handshake, &message_type)) {
+      continue;
+    }
+    if (message_type != SSL3_MT_CLIENT_HELLO) {
+      return tlsNotFound();
+    }
+    if (!CBS_get_u24(&handshake, &message_len)) {
+      continue;
+    }
+    CBS client_hello;
+    if (CBS_get_bytes(&handshake, &client_hello, message_len)) {
+      return parseClientHelloMessage(client_hello);
+    }
+    // The rest of the ClientHello is in the next records, so give up early on one too large.
+    const size_t required =
+        len - CBS_len(&records) + SSL3_RT_HEADER_LENGTH + message_len - CBS_len(&handshake);
+    if (required > config_->maxClientHelloSize()) {
+      return waitForClientHello(required);
+    }
+  }
+}
 
-  int ret = SSL_do_handshake(ssl_.get());
+ParseState Filter::parseClientHelloMessage(CBS& client_hello) {
+  uint16_t legacy_version;
+  CBS random;
+  CBS session_id;
+  CBS cipher_suites;
+  CBS compression_methods;
+  CBS extensions;
+  CBS_init(&extensions, nullptr, 0);
+  if (!CBS_get_u16(&client_hello, &legacy_version) ||
+      !CBS_get_bytes(&client_hello, &random, SSL3_RANDOM_SIZE) ||
+      !CBS_get_u8_length_prefixed(&client_hello, &session_id) ||
+      CBS_len(&session_id) > SSL_MAX_SSL_SESSION_ID_LENGTH ||
+      !CBS_get_u16_length_prefixed(&client_hello, &cipher_suites) ||
+      CBS_len(&cipher_suites) < 2 || CBS_len(&cipher_suites) % 2 != 0 ||
+      !CBS_get_u8_length_prefixed(&client_hello, &compression_methods) ||
+      CBS_len(&compression_methods) == 0 ||
+      (CBS_len(&client_hello) != 0 &&
+       (!CBS_get_u16_length_prefixed(&client_hello, &extensions) ||
+        CBS_len(&client_hello) != 0))) {
+    return tlsNotFound();
+  }
 
-  // This should never succeed because an error is always returned from the SNI callback.
-  ASSERT(ret <= 0);
-  switch (SSL_get_error(ssl_.get(), ret)) {
-  case SSL_ERROR_WANT_READ:
-    if (read_ == config_->maxClientHelloSize()) {
-      // We've hit the specified size limit. This is an unreasonably large ClientHello;
-      // indicate failure.
-      config_->stats().client_hello_too_large_.inc();
-      return ParseState::Error;
+  // Versions above TLS 1.2 are only offered by the supported_versions extension.
+  bool version_supported = legacy_version >= Config::TLS_MIN_SUPPORTED_VERSION;
+  absl::optional<CBS> server_name;
+  absl::optional<CBS> alpn;
+  while (CBS_len(&extensions) != 0) {
+    uint16_t extension_type;
+    CBS extension;
+    if (!CBS_get_u16(&extensions, &extension_type) ||
+        !CBS_get_u16_length_prefixed(&extensions, &extension)) {
+      return tlsNotFound();
     }
-    return ParseState::Continue;
-  case SSL_ERROR_SSL:
-    if (clienthello_success_) {
-      config_->stats().tls_found_.inc();
-      if (alpn_found_) {
-        config_->stats().alpn_found_.inc();
-      } else {
-        config_->stats().alpn_not_found_.inc();
-      }
-      cb_->socket().setDetectedTransportProtocol(
-          TransportSockets::TransportProtocolNames::get().Tls);
-    } else {
-      config_->stats().tls_not_found_.inc();
+    switch (extension_type) {
+    case TLSEXT_TYPE_server_name:
+      server_name = extension;
+      break;
+    case TLSEXT_TYPE_application_layer_protocol_negotiation:
+      alpn = extension;
+      break;
+    case TLSEXT_TYPE_supported_versions:
+      version_supported = hasSupportedVersion(extension);
+      break;
+    default:
+      break;
     }
-    return ParseState::Done;
-  default:
+  }
+
+  absl::string_view name;
+  if (!version_supported || (server_name.has_value() && !parseServerName(*server_name, name))) {
+    return tlsNotFound();
+  }
+  if (alpn.has_value()) {
+    onALPN(CBS_data(&alpn.value()), CBS_len(&alpn.value()));
+  }
+  onServername(name);
+
+  config_->stats().tls_found_.inc();
+  if (alpn_found_) {
+    config_->stats().alpn_found_.inc();
+  } else {
+    config_->stats().alpn_not_found_.inc();
+  }
+  cb_->socket().setDetectedTransportProtocol(TransportSockets::TransportProtocolNames::get().Tls);
+  return ParseState::Done;
+}
+
+ParseState Filter::waitForClientHello(size_t required) {
+  if (required > config_->maxClientHelloSize()) {
+    // This is an unreasonably large ClientHello; indicate failure.
+    config_->stats().client_hello_too_large_.inc();
     return ParseState::Error;
   }
+  return ParseState::Continue;
+}
+
+ParseState Filter::tlsNotFound() {
+  config_->stats().tls_not_found_.inc();
+  return ParseState::Done;
 }
 
 } // namespace TlsInspector
@@ -52,7 +52,6 @@ public:
   Config(Stats::Scope& scope, uint32_t max_client_hello_size = TLS_MAX_CLIENT_HELLO);
 
   const TlsInspectorStats& stats() const { return stats_; }
-  bssl::UniquePtr<SSL> newSsl();
   uint32_t maxClientHelloSize() const { return max_client_hello_size_; }
 
   static constexpr size_t TLS_MAX_CLIENT_HELLO = 64 * 1024;
@@ -61,14 +60,15 @@ public:
 
 private:
   TlsInspectorStats stats_;
-  bssl::UniquePtr<SSL_CTX> ssl_ctx_;
   const uint32_t max_client_hello_size_;
 };
 
 using ConfigSharedPtr = std::shared_ptr<Config>;
 
 /**
- * TLS inspector listener filter.
+ * TLS inspector listener filter. The ClientHello is parsed directly out of the bytes peeked from
+ * the socket, once they hold all of its records, rather than by a handshake of a throwaway
+ * BoringSSL connection that is fed the new bytes of every read.
  */
 class Filter : public Network::ListenerFilter, Logger::Loggable<Logger::Id::filter> {
 public:
@@ -78,8 +78,12 @@ public:
   Network::FilterStatus onAccept(Network::ListenerFilterCallbacks& cb) override;
 
 private:
-  ParseState parseClientHello(const void* data, size_t len);
+  ParseState parseClientHello(const uint8_t* data, size_t len);
+  ParseState parseClientHelloMessage(CBS& client_hello);
+  ParseState waitForClientHello(size_t required);
+  ParseState tlsNotFound();
   ParseState onRead();
+  ParseState onPeeked(absl::string_view data);
   void done(bool success);
   void onALPN(const unsigned char* data, unsigned int len);
   void onServername(absl::string_view name);
@@ -87,15 +91,8 @@ private:
   ConfigSharedPtr config_;
   Network::ListenerFilterCallbacks* cb_;
 
-  bssl::UniquePtr<SSL> ssl_;
   uint64_t read_{0};
   bool alpn_found_{false};
-  bool clienthello_success_{false};
-
-  static thread_local uint8_t buf_[Config::TLS_MAX_CLIENT_HELLO];
-
-  // Allows callbacks on the SSL_CTX to set fields in this class.
-  friend class Config;
 };
 
 } // namespace TlsInspector
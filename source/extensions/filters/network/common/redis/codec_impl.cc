@@ -1,6 +1,7 @@
 #include "extensions/filters/network/common/redis/codec_impl.h"
 
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <vector>
@@ -405,19 +406,22 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
 
     case State::Integer: {
       ENVOY_LOG(trace, "parse slice: Integer: {}", buffer[0]);
-      char c = buffer[0];
-      if (buffer[0] == '\r') {
-        state_ = State::IntegerLF;
-      } else {
+      // The digits in the slice are parsed in one go.
+      while (remaining && buffer[0] != '\r') {
+        const char c = buffer[0];
         if (c < '0' || c > '9') {
           throw ProtocolError("invalid integer character");
-        } else {
-          pending_integer_.integer_ = (pending_integer_.integer_ * 10) + (c - '0');
         }
+        pending_integer_.integer_ = (pending_integer_.integer_ * 10) + (c - '0');
+        remaining--;
+        buffer++;
       }
 
-      remaining--;
-      buffer++;
+      if (remaining) {
+        state_ = State::IntegerLF;
+        remaining--;
+        buffer++;
+      }
       break;
     }
 
@@ -514,14 +518,18 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
 
     case State::SimpleString: {
       ENVOY_LOG(trace, "parse slice: SimpleString: {}", buffer[0]);
-      if (buffer[0] == '\r') {
+      // The part of the string in the slice is appended in one go.
+      const char* cr = static_cast<const char*>(memchr(buffer, '\r', remaining));
+      const uint64_t length = cr != nullptr ? cr - buffer : remaining;
+      pending_value_stack_.front().value_->asString().append(buffer, length);
+      remaining -= length;
+      buffer += length;
+
+      if (cr != nullptr) {
         state_ = State::LF;
-      } else {
-        pending_value_stack_.front().value_->asString().push_back(buffer[0]);
+        remaining--;
+        buffer++;
       }
-
-      remaining--;
-      buffer++;
       break;
     }
 
@@ -549,14 +557,43 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
   }
 }
 
+namespace {
+
+// Arrays of bulk strings up to this encoded size are written into a single reservation of the
+// output buffer.
+constexpr uint64_t MaxFlatArraySize = 16384;
+
+uint64_t decimalLength(uint64_t value) {
+  uint64_t length = 1;
+  while (value >= 10) {
+    value /= 10;
+    length++;
+  }
+  return length;
+}
+
+char* encodeLength(char type, uint64_t length, char* current) {
+  *current++ = type;
+  current += StringUtil::itoa(current, 21, length);
+  *current++ = '\r';
+  *current++ = '\n';
+  return current;
+}
+
+} // namespace
+
 void EncoderImpl::encode(const RespValue& value, Buffer::Instance& out) {
   switch (value.type()) {
   case RespType::Array: {
-    encodeArray(value.asArray(), out);
+    if (!encodeFlatArray(value.asArray(), value.asArray().size(), out)) {
+      encodeArray(value.asArray(), out);
+    }
     break;
   }
   case RespType::CompositeArray: {
-    encodeCompositeArray(value.asCompositeArray(), out);
+    if (!encodeFlatArray(value.asCompositeArray(), value.asCompositeArray().size(), out)) {
+      encodeCompositeArray(value.asCompositeArray(), out);
+    }
     break;
   }
   case RespType::SimpleString: {
@@ -581,6 +618,37 @@ void EncoderImpl::encode(const RespValue& value, Buffer::Instance& out) {
   }
 }
 
+template <class Array>
+bool EncoderImpl::encodeFlatArray(const Array& array, uint64_t array_size, Buffer::Instance& out) {
+  // Commands are arrays of bulk strings, which are written at once rather than piece by piece.
+  uint64_t size = 3 + decimalLength(array_size);
+  for (const RespValue& value : array) {
+    if (value.type() != RespType::BulkString) {
+      return false;
+    }
+    size += 5 + decimalLength(value.asString().size()) + value.asString().size();
+    if (size > MaxFlatArraySize) {
+      return false;
+    }
+  }
+
+  Buffer::RawSlice slice;
+  out.reserve(size, &slice, 1);
+  ASSERT(slice.len_ >= size);
+  char* current = encodeLength('*', array_size, static_cast<char*>(slice.mem_));
+  for (const RespValue& value : array) {
+    current = encodeLength('$', value.asString().size(), current);
+    memcpy(current, value.asString().data(), value.asString().size());
+    current += value.asString().size();
+    *current++ = '\r';
+    *current++ = '\n';
+  }
+  ASSERT(current == static_cast<char*>(slice.mem_) + size);
+  slice.len_ = size;
+  out.commit(&slice, 1);
+  return true;
+}
+
 void EncoderImpl::encodeArray(const std::vector<RespValue>& array, Buffer::Instance& out) {
   char buffer[32];
   char* current = buffer;
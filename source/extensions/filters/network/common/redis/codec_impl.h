@@ -85,6 +85,8 @@ public:
   void encode(const RespValue& value, Buffer::Instance& out) override;
 
 private:
+  template <class Array>
+  bool encodeFlatArray(const Array& array, uint64_t array_size, Buffer::Instance& out);
   void encodeArray(const std::vector<RespValue>& array, Buffer::Instance& out);
   void encodeCompositeArray(const RespValue::CompositeArray& array, Buffer::Instance& out);
   void encodeBulkString(const std::string& string, Buffer::Instance& out);
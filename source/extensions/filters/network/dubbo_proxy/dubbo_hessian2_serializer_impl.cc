@@ -3,6 +3,7 @@
 #include "envoy/common/exception.h"
 
 #include "common/common/assert.h"
+#include "common/common/logger.h"
 #include "common/common/macros.h"
 
 #include "extensions/filters/network/dubbo_proxy/hessian_utils.h"
@@ -10,11 +11,109 @@
 #include "extensions/filters/network/dubbo_proxy/serializer.h"
 #include "extensions/filters/network/dubbo_proxy/serializer_impl.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
 namespace DubboProxy {
 
+namespace {
+
+// Counts the arguments of a method from the JVM descriptor of their types, such as
+// "Ljava/lang/String;[II".
+absl::optional<uint32_t> argumentCount(absl::string_view types) {
+  uint32_t count = 0;
+  size_t pos = 0;
+  while (pos < types.size()) {
+    while (pos < types.size() && types[pos] == '[') {
+      ++pos;
+    }
+    if (pos == types.size()) {
+      return absl::nullopt;
+    }
+    if (types[pos] == 'L') {
+      pos = types.find(';', pos);
+      if (pos == absl::string_view::npos) {
+        return absl::nullopt;
+      }
+    } else if (absl::string_view("ZBCDFIJS").find(types[pos]) == absl::string_view::npos) {
+      return absl::nullopt;
+    }
+    ++pos;
+    ++count;
+  }
+  return count;
+}
+
+// Peeks a value of a basic type as a string. The values of the other types are not decoded, and
+// false is returned for them.
+bool peekBasicValue(Buffer::Instance& buffer, std::string& value, size_t* size, uint64_t offset) {
+  const uint8_t code = buffer.peekInt<uint8_t>(offset);
+  if (code <= 0x1f || (code >= 0x30 && code <= 0x33) || code == 'S' || code == 'R') {
+    value = HessianUtils::peekString(buffer, size, offset);
+  } else if ((code >= 0x80 && code <= 0xd7) || code == 'I') {
+    value = absl::StrCat(HessianUtils::peekInt(buffer, size, offset));
+  } else if (code >= 0xd8 || (code >= 0x38 && code <= 0x3f) || code == 0x59 || code == 'L') {
+    value = absl::StrCat(HessianUtils::peekLong(buffer, size, offset));
+  } else if ((code >= 0x5b && code <= 0x5f) || code == 'D') {
+    value = absl::StrCat(HessianUtils::peekDouble(buffer, size, offset));
+  } else if (code == 'T' || code == 'F') {
+    value = HessianUtils::peekBool(buffer, size, offset) ? "true" : "false";
+  } else if (code == 'N') {
+    HessianUtils::peekNull(buffer, size, offset);
+    value.clear();
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Decodes the arguments following the types of the arguments at the offset, and the attachments
+// following them, until a value which is not of a basic type.
+void decodeArgumentsAndAttachments(Buffer::Instance& buffer, uint64_t offset,
+                                   RpcInvocationImpl::ParameterValueMap& parameters,
+                                   Http::HeaderMap& headers) {
+  size_t size;
+  const std::string types = HessianUtils::peekString(buffer, &size, offset);
+  offset += size;
+  const absl::optional<uint32_t> count = argumentCount(types);
+  if (!count.has_value()) {
+    return;
+  }
+
+  std::string value;
+  for (uint32_t index = 0; index < count.value(); ++index) {
+    if (!peekBasicValue(buffer, value, &size, offset)) {
+      return;
+    }
+    parameters.emplace(index, value);
+    offset += size;
+  }
+
+  // The attachments are an untyped map, or a map typed by a string.
+  const uint8_t code = buffer.peekInt<uint8_t>(offset);
+  if (code == 'M' && offset + 1 < buffer.length()) {
+    HessianUtils::peekString(buffer, &size, offset + 1);
+    offset += 1 + size;
+  } else if (code == 'H') {
+    offset += 1;
+  } else {
+    return;
+  }
+  while (buffer.peekInt<uint8_t>(offset) != 'Z') {
+    const std::string key = HessianUtils::peekString(buffer, &size, offset);
+    offset += size;
+    if (!peekBasicValue(buffer, value, &size, offset)) {
+      return;
+    }
+    headers.addCopy(Http::LowerCaseString(key), value);
+    offset += size;
+  }
+}
+
+} // namespace
+
 std::pair<RpcInvocationSharedPtr, bool>
 DubboHessian2SerializerImpl::deserializeRpcInvocation(Buffer::Instance& buffer,
                                                       ContextSharedPtr context) {
@@ -39,6 +138,23 @@ DubboHessian2SerializerImpl::deserializeRpcInvocation(Buffer::Instance& buffer,
   invo->setServiceVersion(service_version);
   invo->setMethodName(method_name);
 
+  // The body is kept as it is in the message origin data to be forwarded, so the rest of it is
+  // decoded from there if a route or a filter needs the parameters or the attachments.
+  invo->setLazyDecoder([context, total_size](RpcInvocationImpl::ParameterValueMap& parameters,
+                                             Http::HeaderMap& headers) {
+    Buffer::Instance& data = context->messageOriginData();
+    if (data.length() < context->messageSize() || context->bodySize() <= total_size) {
+      return;
+    }
+    try {
+      decodeArgumentsAndAttachments(data, context->headerSize() + total_size, parameters,
+                                    headers);
+    } catch (const EnvoyException& e) {
+      ENVOY_LOG_MISC(debug, "dubbo hessian2: failed to decode the invocation arguments: {}",
+                     e.what());
+    }
+  });
+
   return std::pair<RpcInvocationSharedPtr, bool>(invo, true);
 }
 
@@ -5,12 +5,32 @@ namespace Extensions {
 namespace NetworkFilters {
 namespace DubboProxy {
 
+void RpcInvocationImpl::decodeIfNeeded() const {
+  if (lazy_decoder_ == nullptr) {
+    return;
+  }
+
+  const LazyDecoder decoder = std::move(lazy_decoder_);
+  lazy_decoder_ = nullptr;
+  auto parameters = std::make_unique<ParameterValueMap>();
+  auto headers = Http::RequestHeaderMapImpl::create();
+  decoder(*parameters, *headers);
+  if (!parameters->empty()) {
+    parameter_map_ = std::move(parameters);
+  }
+  if (!headers->empty()) {
+    headers_ = std::move(headers);
+  }
+}
+
 void RpcInvocationImpl::addParameterValue(uint32_t index, const std::string& value) {
+  decodeIfNeeded();
   assignParameterIfNeed();
   parameter_map_->emplace(index, value);
 }
 
 const std::string& RpcInvocationImpl::getParameterValue(uint32_t index) const {
+  decodeIfNeeded();
   if (parameter_map_) {
     auto itor = parameter_map_->find(index);
     if (itor != parameter_map_->end()) {
@@ -22,22 +42,26 @@ const std::string& RpcInvocationImpl::getParameterValue(uint32_t index) const {
 }
 
 const RpcInvocationImpl::ParameterValueMap& RpcInvocationImpl::parameters() {
+  decodeIfNeeded();
   ASSERT(hasParameters());
   return *parameter_map_;
 }
 
 const Http::HeaderMap& RpcInvocationImpl::headers() const {
+  decodeIfNeeded();
   ASSERT(hasHeaders());
   return *headers_;
 }
 
 void RpcInvocationImpl::addHeader(const std::string& key, const std::string& value) {
+  decodeIfNeeded();
   assignHeaderIfNeed();
   headers_->addCopy(Http::LowerCaseString(key), value);
 }
 
 void RpcInvocationImpl::addHeaderReference(const Http::LowerCaseString& key,
                                            const std::string& value) {
+  decodeIfNeeded();
   assignHeaderIfNeed();
   headers_->addReference(key, value);
 }
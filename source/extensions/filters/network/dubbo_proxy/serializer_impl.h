@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+
 #include "extensions/filters/network/dubbo_proxy/message_impl.h"
 #include "extensions/filters/network/dubbo_proxy/serializer.h"
 
@@ -14,20 +16,37 @@ public:
   using ParameterValueMap = absl::node_hash_map<uint32_t, std::string>;
   using ParameterValueMapPtr = std::unique_ptr<ParameterValueMap>;
 
+  // Decodes the parameters and the attachments of the invocation into the maps passed to it.
+  using LazyDecoder = std::function<void(ParameterValueMap& parameters, Http::HeaderMap& headers)>;
+
   RpcInvocationImpl() = default;
   ~RpcInvocationImpl() override = default;
 
+  /**
+   * Defers the decoding of the parameters and the attachments until they are first used, since
+   * most invocations are routed by their service and method names only.
+   */
+  void setLazyDecoder(LazyDecoder&& decoder) { lazy_decoder_ = std::move(decoder); }
+
   void addParameterValue(uint32_t index, const std::string& value);
   const ParameterValueMap& parameters();
   const std::string& getParameterValue(uint32_t index) const;
-  bool hasParameters() const { return parameter_map_ != nullptr; }
+  bool hasParameters() const {
+    decodeIfNeeded();
+    return parameter_map_ != nullptr;
+  }
 
   void addHeader(const std::string& key, const std::string& value);
   void addHeaderReference(const Http::LowerCaseString& key, const std::string& value);
   const Http::HeaderMap& headers() const;
-  bool hasHeaders() const { return headers_ != nullptr; }
+  bool hasHeaders() const {
+    decodeIfNeeded();
+    return headers_ != nullptr;
+  }
 
 private:
+  void decodeIfNeeded() const;
+
   inline void assignHeaderIfNeed() {
     if (!headers_) {
       headers_ = Http::RequestHeaderMapImpl::create();
@@ -40,8 +59,9 @@ private:
     }
   }
 
-  ParameterValueMapPtr parameter_map_;
-  Http::HeaderMapPtr headers_; // attachment
+  mutable LazyDecoder lazy_decoder_;
+  mutable ParameterValueMapPtr parameter_map_;
+  mutable Http::HeaderMapPtr headers_; // attachment
 };
 
 class RpcResultImpl : public RpcResult {
@@ -70,14 +70,17 @@ absl::flat_hash_map<int32_t, MonotonicTime>& KafkaMetricsFacadeImpl::getRequestA
 }
 
 KafkaBrokerFilter::KafkaBrokerFilter(Stats::Scope& scope, TimeSource& time_source,
-                                     const std::string& stat_prefix)
-    : KafkaBrokerFilter{
-          std::make_shared<KafkaMetricsFacadeImpl>(scope, time_source, stat_prefix)} {};
+                                     const std::string& stat_prefix, bool skip_request_data)
+    : KafkaBrokerFilter{std::make_shared<KafkaMetricsFacadeImpl>(scope, time_source, stat_prefix),
+                        skip_request_data ? HeaderOnlyRequestParserResolver::getInstance()
+                                          : RequestParserResolver::getDefaultInstance()} {};
 
-KafkaBrokerFilter::KafkaBrokerFilter(const KafkaMetricsFacadeSharedPtr& metrics)
+KafkaBrokerFilter::KafkaBrokerFilter(const KafkaMetricsFacadeSharedPtr& metrics,
+                                     const RequestParserResolver& parser_resolver)
     : metrics_{metrics}, response_decoder_{new ResponseDecoder({metrics})},
-      request_decoder_{
-          new RequestDecoder({std::make_shared<Forwarder>(*response_decoder_), metrics})} {};
+      request_decoder_{new RequestDecoder(
+          InitialParserFactory::getDefaultInstance(), parser_resolver,
+          {std::make_shared<Forwarder>(*response_decoder_), metrics})} {};
 
 KafkaBrokerFilter::KafkaBrokerFilter(KafkaMetricsFacadeSharedPtr metrics,
                                      ResponseDecoderSharedPtr response_decoder,
@@ -139,7 +139,8 @@ public:
    * Creates decoders that eventually update prefixed metrics stored in scope, using time source for
    * duration calculation.
    */
-  KafkaBrokerFilter(Stats::Scope& scope, TimeSource& time_source, const std::string& stat_prefix);
+  KafkaBrokerFilter(Stats::Scope& scope, TimeSource& time_source, const std::string& stat_prefix,
+                    bool skip_request_data = false);
 
   /**
    * Visible for testing.
@@ -163,7 +164,8 @@ private:
    * Helper delegate constructor.
    * Passes metrics facade as argument to decoders.
    */
-  KafkaBrokerFilter(const KafkaMetricsFacadeSharedPtr& metrics);
+  KafkaBrokerFilter(const KafkaMetricsFacadeSharedPtr& metrics,
+                    const RequestParserResolver& parser_resolver);
 
   const KafkaMetricsFacadeSharedPtr metrics_;
   const ResponseDecoderSharedPtr response_decoder_;
@@ -20,6 +20,15 @@ namespace Kafka {
  */
 bool requestUsesTaggedFieldsInHeader(const uint16_t api_key, const uint16_t api_version);
 
+/**
+ * Decides if request with given api key & version is supported, i.e. could be deserialized.
+ * This method gets implemented in generated code through 'kafka_request_resolver_cc.j2'.
+ * @param api_key Kafka request key.
+ * @param api_version Kafka request's version.
+ * @return Whether the request is supported.
+ */
+bool requestSupported(const int16_t api_key, const int16_t api_version);
+
 /**
  * Represents fields that are present in every Kafka request message.
  * @see http://kafka.apache.org/protocol.html#protocol_messages
@@ -167,6 +176,34 @@ private:
   const Data data_;
 };
 
+/**
+ * Request whose data has been skipped instead of being deserialized, as only its header was needed.
+ * Its size is known, but it cannot be encoded, as the data is not kept.
+ */
+class UnparsedRequest : public AbstractRequest {
+public:
+  /**
+   * @param request_header request's header.
+   * @param data_size size of the request data that has been skipped.
+   */
+  UnparsedRequest(const RequestHeader& request_header, const uint32_t data_size)
+      : AbstractRequest{request_header}, data_size_{data_size} {};
+
+  uint32_t computeSize() const override {
+    const EncodingContext context{request_header_.api_version_};
+    return context.computeSize(request_header_) + data_size_;
+  }
+
+  uint32_t encode(Buffer::Instance&) const override {
+    throw EnvoyException("kafka request data has not been parsed, the request cannot be encoded");
+  }
+
+  /**
+   * Size of the request data.
+   */
+  const uint32_t data_size_;
+};
+
 } // namespace Kafka
 } // namespace NetworkFilters
 } // namespace Extensions
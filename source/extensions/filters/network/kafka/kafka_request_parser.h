@@ -72,6 +72,20 @@ public:
   static const RequestParserResolver& getDefaultInstance();
 };
 
+/**
+ * Resolver that does not deserialize the request data: the data of supported requests is skipped,
+ * and the requests are returned with their header only (@see UnparsedRequest).
+ * Used when only the request headers are of interest, so that large requests (e.g. produce
+ * requests with their record batches) are not copied into request objects.
+ */
+class HeaderOnlyRequestParserResolver : public RequestParserResolver {
+public:
+  RequestParserSharedPtr createParser(int16_t api_key, int16_t api_version,
+                                      RequestContextSharedPtr context) const override;
+
+  static const RequestParserResolver& getInstance();
+};
+
 /**
  * Request parser responsible for consuming request length and setting up context with this data.
  * @see http://kafka.apache.org/protocol.html#protocol_common
@@ -176,6 +190,25 @@ public:
   }
 };
 
+/**
+ * Parser that consumes the data of a supported request without deserializing it.
+ * Always returns a parsed message with the request header only, when all the request bytes have
+ * been consumed.
+ */
+class RequestDataSkipParser : public RequestParser {
+public:
+  RequestDataSkipParser(RequestContextSharedPtr context)
+      : context_{context}, data_size_{context->remaining_request_size_} {};
+
+  RequestParseResponse parse(absl::string_view& data) override;
+
+  const RequestContextSharedPtr contextForTest() const { return context_; }
+
+private:
+  const RequestContextSharedPtr context_;
+  const uint32_t data_size_;
+};
+
 /**
  * Request parser uses a single deserializer to construct a request object.
  * This parser is responsible for consuming request-specific data (e.g. topic names) and always
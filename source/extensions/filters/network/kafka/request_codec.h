@@ -55,7 +55,6 @@ public:
                        RequestParserResolver::getDefaultInstance(), callbacks){};
 
   /**
-   * Visible for testing.
    * Allows injecting initial parser factory and parser resolver.
    * @param factory parser factory to be used when new message is to be processed.
    * @param parser_resolver supported parser resolver.
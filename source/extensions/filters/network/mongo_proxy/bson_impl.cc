@@ -576,6 +576,44 @@ const Field* DocumentImpl::find(const std::string& name, Field::Type type) const
   return nullptr;
 }
 
+DocumentSharedPtr LazyDocumentImpl::create(Buffer::Instance& data) {
+  const int32_t message_length = BufferHelper::peekInt32(data);
+  if (message_length < static_cast<int32_t>(sizeof(int32_t) + 1) ||
+      static_cast<uint64_t>(message_length) > data.length()) {
+    throw EnvoyException("invalid BSON message length");
+  }
+
+  std::shared_ptr<LazyDocumentImpl> new_doc{new LazyDocumentImpl()};
+  new_doc->raw_.move(data, message_length);
+  uint8_t last_byte;
+  new_doc->raw_.copyOut(message_length - 1, sizeof(last_byte), &last_byte);
+  if (last_byte != 0) {
+    throw EnvoyException("invalid document");
+  }
+
+  return new_doc;
+}
+
+Document& LazyDocumentImpl::document() const {
+  if (parsed_ == nullptr) {
+    parsed_ = DocumentImpl::create(raw_);
+  }
+
+  return *parsed_;
+}
+
+int32_t LazyDocumentImpl::byteSize() const {
+  return parsed_ != nullptr ? parsed_->byteSize() : static_cast<int32_t>(raw_.length());
+}
+
+void LazyDocumentImpl::encode(Buffer::Instance& output) const {
+  if (parsed_ != nullptr) {
+    parsed_->encode(output);
+  } else {
+    output.add(raw_);
+  }
+}
+
 } // namespace Bson
 } // namespace MongoProxy
 } // namespace NetworkFilters
@@ -7,6 +7,7 @@
 #include "envoy/buffer/buffer.h"
 #include "envoy/common/exception.h"
 
+#include "common/buffer/buffer_impl.h"
 #include "common/common/logger.h"
 #include "common/common/utility.h"
 
@@ -276,6 +277,115 @@ private:
   std::list<FieldPtr> fields_;
 };
 
+/**
+ * Document decoded from a buffer, whose fields are only parsed when they are first accessed. Until
+ * then the document is kept as the raw bytes it was decoded from, which are what it encodes to, so
+ * that the documents that are only passed through or measured are never parsed.
+ */
+class LazyDocumentImpl : public Document, public std::enable_shared_from_this<LazyDocumentImpl> {
+public:
+  /**
+   * Moves a document out of a buffer. Only the length and the terminator of the document are
+   * checked.
+   */
+  static DocumentSharedPtr create(Buffer::Instance& data);
+
+  /**
+   * @return whether the fields of the document have been parsed.
+   */
+  bool parsed() const { return parsed_ != nullptr; }
+
+  // Mongo::Document
+  DocumentSharedPtr addDouble(const std::string& key, double value) override {
+    document().addDouble(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addString(const std::string& key, std::string&& value) override {
+    document().addString(key, std::move(value));
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addSymbol(const std::string& key, std::string&& value) override {
+    document().addSymbol(key, std::move(value));
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addDocument(const std::string& key, DocumentSharedPtr value) override {
+    document().addDocument(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addArray(const std::string& key, DocumentSharedPtr value) override {
+    document().addArray(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addBinary(const std::string& key, std::string&& value) override {
+    document().addBinary(key, std::move(value));
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addObjectId(const std::string& key, Field::ObjectId&& value) override {
+    document().addObjectId(key, std::move(value));
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addBoolean(const std::string& key, bool value) override {
+    document().addBoolean(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addDatetime(const std::string& key, int64_t value) override {
+    document().addDatetime(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addNull(const std::string& key) override {
+    document().addNull(key);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addRegex(const std::string& key, Field::Regex&& value) override {
+    document().addRegex(key, std::move(value));
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addInt32(const std::string& key, int32_t value) override {
+    document().addInt32(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addTimestamp(const std::string& key, int64_t value) override {
+    document().addTimestamp(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addInt64(const std::string& key, int64_t value) override {
+    document().addInt64(key, value);
+    return shared_from_this();
+  }
+
+  bool operator==(const Document& rhs) const override { return document() == rhs; }
+  int32_t byteSize() const override;
+  void encode(Buffer::Instance& output) const override;
+  const Field* find(const std::string& name) const override { return document().find(name); }
+  const Field* find(const std::string& name, Field::Type type) const override {
+    return document().find(name, type);
+  }
+  std::string toString() const override { return document().toString(); }
+  const std::list<FieldPtr>& values() const override { return document().values(); }
+
+private:
+  LazyDocumentImpl() = default;
+
+  // Parses the raw bytes on first use. The parsed document replaces them from then on.
+  Document& document() const;
+
+  mutable Buffer::OwnedImpl raw_;
+  mutable DocumentSharedPtr parsed_;
+};
+
 } // namespace Bson
 } // namespace MongoProxy
 } // namespace NetworkFilters
@@ -38,6 +38,10 @@ MessageImpl::documentListToString(const std::list<Bson::DocumentSharedPtr>& docu
   return out.str();
 }
 
+Bson::DocumentSharedPtr MessageImpl::createDocument(Buffer::Instance& data) const {
+  return lazy_documents_ ? Bson::LazyDocumentImpl::create(data) : Bson::DocumentImpl::create(data);
+}
+
 void GetMoreMessageImpl::fromBuffer(uint32_t, Buffer::Instance& data) {
   ENVOY_LOG(trace, "decoding get more message");
   Bson::BufferHelper::removeInt32(data); // "zero" (unused)
@@ -68,7 +72,7 @@ void InsertMessageImpl::fromBuffer(uint32_t message_length, Buffer::Instance& da
   flags_ = Bson::BufferHelper::removeInt32(data);
   full_collection_name_ = Bson::BufferHelper::removeCString(data);
   while (data.length() - (original_buffer_length - message_length) > 0) {
-    documents_.emplace_back(Bson::DocumentImpl::create(data));
+    documents_.emplace_back(createDocument(data));
   }
 
   ENVOY_LOG(trace, "{}", toString(true));
@@ -142,10 +146,10 @@ void QueryMessageImpl::fromBuffer(uint32_t message_length, Buffer::Instance& dat
   full_collection_name_ = Bson::BufferHelper::removeCString(data);
   number_to_skip_ = Bson::BufferHelper::removeInt32(data);
   number_to_return_ = Bson::BufferHelper::removeInt32(data);
-  query_ = Bson::DocumentImpl::create(data);
+  query_ = createDocument(data);
 
   if (data.length() - (original_buffer_length - message_length) > 0) {
-    return_fields_selector_ = Bson::DocumentImpl::create(data);
+    return_fields_selector_ = createDocument(data);
   }
 
   ENVOY_LOG(trace, "{}", toString(true));
@@ -190,7 +194,7 @@ void ReplyMessageImpl::fromBuffer(uint32_t, Buffer::Instance& data) {
   starting_from_ = Bson::BufferHelper::removeInt32(data);
   number_returned_ = Bson::BufferHelper::removeInt32(data);
   for (int32_t i = 0; i < number_returned_; i++) {
-    documents_.emplace_back(Bson::DocumentImpl::create(data));
+    documents_.emplace_back(createDocument(data));
   }
 
   ENVOY_LOG(trace, "{}", toString(true));
@@ -232,14 +236,14 @@ void CommandMessageImpl::fromBuffer(uint32_t message_length, Buffer::Instance& d
 
   database_ = Bson::BufferHelper::removeCString(data);
   command_name_ = Bson::BufferHelper::removeCString(data);
-  metadata_ = Bson::DocumentImpl::create(data);
-  command_args_ = Bson::DocumentImpl::create(data);
+  metadata_ = createDocument(data);
+  command_args_ = createDocument(data);
 
   // There may be additional docs.
   // message_length is mongo message length. original_data_length contains
   // mongo message and possibly first few bytes of next message.
   while (data.length() - (original_data_length - message_length) > 0) {
-    input_docs_.emplace_back(Bson::DocumentImpl::create(data));
+    input_docs_.emplace_back(createDocument(data));
   }
 
   ENVOY_LOG(trace, "{}", toString(true));
@@ -292,14 +296,14 @@ void CommandReplyMessageImpl::fromBuffer(uint32_t message_length, Buffer::Instan
   const uint64_t original_data_length = data.length();
   ASSERT(data.length() >= message_length); // See comment below about relationship.
 
-  metadata_ = Bson::DocumentImpl::create(data);
-  command_reply_ = Bson::DocumentImpl::create(data);
+  metadata_ = createDocument(data);
+  command_reply_ = createDocument(data);
 
   // There may be additional docs.
   // message_length is mongo message length. original_data_length contains
   // mongo message and possibly first few bytes of next message.
   while (data.length() - (original_data_length - message_length) > 0) {
-    output_docs_.emplace_back(Bson::DocumentImpl::create(data));
+    output_docs_.emplace_back(createDocument(data));
   }
 
   ENVOY_LOG(trace, "{}", toString(true));
@@ -368,6 +372,7 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
   switch (op_code) {
   case Message::OpCode::Reply: {
     std::unique_ptr<ReplyMessageImpl> message(new ReplyMessageImpl(request_id, response_to));
+    message->lazyDocuments(lazy_documents_);
     message->fromBuffer(message_length, data);
     callbacks_.decodeReply(std::move(message));
     break;
@@ -375,6 +380,7 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
 
   case Message::OpCode::Query: {
     std::unique_ptr<QueryMessageImpl> message(new QueryMessageImpl(request_id, response_to));
+    message->lazyDocuments(lazy_documents_);
     message->fromBuffer(message_length, data);
     callbacks_.decodeQuery(std::move(message));
     break;
@@ -389,6 +395,7 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
 
   case Message::OpCode::Insert: {
     std::unique_ptr<InsertMessageImpl> message(new InsertMessageImpl(request_id, response_to));
+    message->lazyDocuments(lazy_documents_);
     message->fromBuffer(message_length, data);
     callbacks_.decodeInsert(std::move(message));
     break;
@@ -404,6 +411,7 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
 
   case Message::OpCode::Command: {
     std::unique_ptr<CommandMessageImpl> message(new CommandMessageImpl(request_id, response_to));
+    message->lazyDocuments(lazy_documents_);
     message->fromBuffer(message_length, data);
     callbacks_.decodeCommand(std::move(message));
     break;
@@ -412,6 +420,7 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
   case Message::OpCode::CommandReply: {
     std::unique_ptr<CommandReplyMessageImpl> message(
         new CommandReplyMessageImpl(request_id, response_to));
+    message->lazyDocuments(lazy_documents_);
     message->fromBuffer(message_length, data);
     callbacks_.decodeCommandReply(std::move(message));
     break;
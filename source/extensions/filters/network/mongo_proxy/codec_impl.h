@@ -21,15 +21,22 @@ public:
 
   virtual void fromBuffer(uint32_t message_length, Buffer::Instance& data) PURE;
 
+  /**
+   * Sets whether fromBuffer() decodes the documents lazily, @see Bson::LazyDocumentImpl.
+   */
+  void lazyDocuments(bool lazy_documents) { lazy_documents_ = lazy_documents; }
+
   // Mongo::Message
   int32_t requestId() const override { return request_id_; }
   int32_t responseTo() const override { return response_to_; }
 
 protected:
   std::string documentListToString(const std::list<Bson::DocumentSharedPtr>& documents) const;
+  Bson::DocumentSharedPtr createDocument(Buffer::Instance& data) const;
 
   const int32_t request_id_;
   const int32_t response_to_;
+  bool lazy_documents_{};
 };
 
 class GetMoreMessageImpl : public MessageImpl,
@@ -251,7 +258,13 @@ private:
 
 class DecoderImpl : public Decoder, Logger::Loggable<Logger::Id::mongo> {
 public:
-  DecoderImpl(DecoderCallbacks& callbacks) : callbacks_(callbacks) {}
+  /**
+   * @param callbacks supplies the callbacks receiving the decoded messages.
+   * @param lazy_documents supplies whether the documents of the messages are parsed only when
+   *        accessed, @see Bson::LazyDocumentImpl.
+   */
+  DecoderImpl(DecoderCallbacks& callbacks, bool lazy_documents = false)
+      : callbacks_(callbacks), lazy_documents_(lazy_documents) {}
 
   // Mongo::Decoder
   void onData(Buffer::Instance& data) override;
@@ -260,6 +273,7 @@ private:
   bool decode(Buffer::Instance& data);
 
   DecoderCallbacks& callbacks_;
+  const bool lazy_documents_;
 };
 
 class EncoderImpl : public Encoder, Logger::Loggable<Logger::Id::mongo> {
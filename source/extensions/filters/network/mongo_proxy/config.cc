@@ -42,11 +42,13 @@ Network::FilterFactoryCb MongoProxyFilterConfigFactory::createFilterFactoryFromP
 
   auto stats = std::make_shared<MongoStats>(context.scope(), stat_prefix, commands);
   const bool emit_dynamic_metadata = proto_config.emit_dynamic_metadata();
-  return [stat_prefix, &context, access_log, fault_config, emit_dynamic_metadata,
-          stats](Network::FilterManager& filter_manager) -> void {
+  const bool lazy_bson_decoding = proto_config.lazy_bson_decoding();
+  return [stat_prefix, &context, access_log, fault_config, emit_dynamic_metadata, stats,
+          lazy_bson_decoding](Network::FilterManager& filter_manager) -> void {
     filter_manager.addFilter(std::make_shared<ProdProxyFilter>(
         stat_prefix, context.scope(), context.runtime(), access_log, fault_config,
-        context.drainDecision(), context.dispatcher().timeSource(), emit_dynamic_metadata, stats));
+        context.drainDecision(), context.dispatcher().timeSource(), emit_dynamic_metadata, stats,
+        lazy_bson_decoding));
   };
 }
 
@@ -110,7 +110,8 @@ public:
               AccessLogSharedPtr access_log,
               const Filters::Common::Fault::FaultDelayConfigSharedPtr& fault_config,
               const Network::DrainDecision& drain_decision, TimeSource& time_system,
-              bool emit_dynamic_metadata, const MongoStatsSharedPtr& stats);
+              bool emit_dynamic_metadata, const MongoStatsSharedPtr& stats,
+              bool lazy_bson_decoding);
   ~ProxyFilter() override;
 
   virtual DecoderPtr createDecoder(DecoderCallbacks& callbacks) PURE;
@@ -198,6 +199,9 @@ private:
   TimeSource& time_source_;
   const bool emit_dynamic_metadata_;
   MongoStatsSharedPtr mongo_stats_;
+
+protected:
+  const bool lazy_bson_decoding_;
 };
 
 class ProdProxyFilter : public ProxyFilter {
@@ -85,7 +85,8 @@ void DecoderImpl::initialize() {
   BE_known_msgs['S'] = MessageProcessor{"ParameterStatus", BODY_FORMAT(String, String), {}};
   BE_known_msgs['1'] = MessageProcessor{"ParseComplete", NO_BODY, {}};
   BE_known_msgs['s'] = MessageProcessor{"PortalSuspend", NO_BODY, {}};
-  BE_known_msgs['Z'] = MessageProcessor{"ReadyForQuery", BODY_FORMAT(Byte1), {}};
+  BE_known_msgs['Z'] = MessageProcessor{
+      "ReadyForQuery", BODY_FORMAT(Byte1), {&DecoderImpl::decodeBackendReadyForQuery}};
   BE_known_msgs['T'] = MessageProcessor{
       "RowDescription",
       BODY_FORMAT(Array<Sequence<String, Int32, Int16, Int32, Int16, Int32, Int16>>),
@@ -364,6 +365,29 @@ void DecoderImpl::decodeBackendErrorResponse() { decodeErrorNotice(BE_errors_);
 // indicating its meaning. It can be warning, notice, info, debug or log.
 void DecoderImpl::decodeBackendNoticeResponse() { decodeErrorNotice(BE_notices_); }
 
+// Method parses Z (ReadyForQuery) message. Its status byte tells whether the session is idle,
+// in a transaction block or in a failed transaction block, including the transactions which
+// are started, ended or failed by statements the CommandComplete keywords do not tell about.
+void DecoderImpl::decodeBackendReadyForQuery() {
+  if (message_.empty()) {
+    return;
+  }
+  switch (message_[0]) {
+  case 'I':
+    session_.setTransactionStatus(PostgresSession::TransactionStatus::Idle);
+    break;
+  case 'T':
+    session_.setTransactionStatus(PostgresSession::TransactionStatus::InTransaction);
+    break;
+  case 'E':
+    session_.setTransactionStatus(PostgresSession::TransactionStatus::Failed);
+    break;
+  default:
+    ENVOY_LOG(debug, "postgres_proxy: unknown transaction status {}", message_[0]);
+    break;
+  }
+}
+
 // Method parses Parse message of the following format:
 // String: The name of the destination prepared statement (an empty string selects the unnamed
 // prepared statement).
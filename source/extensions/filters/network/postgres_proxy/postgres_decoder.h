@@ -127,6 +127,7 @@ protected:
   void decodeBackendStatements();
   void decodeBackendErrorResponse();
   void decodeBackendNoticeResponse();
+  void decodeBackendReadyForQuery();
   void decodeFrontendTerminate();
   void decodeErrorNotice(MsgParserDict& types);
   void onQuery();
@@ -11,11 +11,28 @@ namespace PostgresProxy {
 // Class stores data about the current state of a transaction between postgres client and server.
 class PostgresSession {
 public:
+  // The transaction status reported by the server in its last ReadyForQuery message.
+  enum class TransactionStatus {
+    // Not in a transaction block: the session is between transactions.
+    Idle,
+    // In a transaction block.
+    InTransaction,
+    // In a failed transaction block, whose queries are rejected until it is rolled back.
+    Failed
+  };
+
   bool inTransaction() { return in_transaction_; };
   void setInTransaction(bool in_transaction) { in_transaction_ = in_transaction; };
 
+  TransactionStatus transactionStatus() const { return transaction_status_; }
+  void setTransactionStatus(TransactionStatus status) {
+    transaction_status_ = status;
+    in_transaction_ = status != TransactionStatus::Idle;
+  }
+
 private:
   bool in_transaction_{false};
+  TransactionStatus transaction_status_{TransactionStatus::Idle};
 };
 
 } // namespace PostgresProxy
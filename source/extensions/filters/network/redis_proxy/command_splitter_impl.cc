@@ -137,6 +137,11 @@ void DelayFaultRequest::onDelayResponse() {
 
 void DelayFaultRequest::cancel() { delay_timer_->disableTimer(); }
 
+void CachingRequest::onResponse(Common::Redis::RespValuePtr&& response) {
+  cache_.insert(command_, request_, *response, generation_);
+  callbacks_.onResponse(std::move(response));
+}
+
 SplitRequestPtr SimpleRequest::create(Router& router,
                                       Common::Redis::RespValuePtr&& incoming_request,
                                       SplitCallbacks& callbacks, CommandStats& command_stats,
@@ -431,12 +436,14 @@ void SplitKeysSumResultRequest::onChildResponse(Common::Redis::RespValuePtr&& va
 
 InstanceImpl::InstanceImpl(RouterPtr&& router, Stats::Scope& scope, const std::string& stat_prefix,
                            TimeSource& time_source, bool latency_in_micros,
-                           Common::Redis::FaultManagerPtr&& fault_manager)
+                           Common::Redis::FaultManagerPtr&& fault_manager,
+                           ThreadLocalReadCacheSharedPtr read_cache)
     : router_(std::move(router)), simple_command_handler_(*router_),
       eval_command_handler_(*router_), mget_handler_(*router_), mset_handler_(*router_),
       split_keys_sum_result_handler_(*router_),
       stats_{ALL_COMMAND_SPLITTER_STATS(POOL_COUNTER_PREFIX(scope, stat_prefix + "splitter."))},
-      time_source_(time_source), fault_manager_(std::move(fault_manager)) {
+      time_source_(time_source), fault_manager_(std::move(fault_manager)),
+      read_cache_(std::move(read_cache)) {
   for (const std::string& command : Common::Redis::SupportedCommands::simpleCommands()) {
     addHandler(scope, stat_prefix, command, latency_in_micros, simple_command_handler_);
   }
@@ -526,6 +533,27 @@ SplitRequestPtr InstanceImpl::makeRequest(Common::Redis::RespValuePtr&& request,
   // delay on the result of the wrapped request or fault.
   const bool has_delay_fault =
       fault_ptr != nullptr && fault_ptr->delayMs() > std::chrono::milliseconds(0);
+  // Reads are served from the cache unless a fault is injected into them.
+  std::unique_ptr<CachingRequest> caching_request;
+  if (read_cache_ != nullptr) {
+    ReadCache& read_cache = read_cache_->get();
+    if (read_cache.cacheable(to_lower_string, *request)) {
+      if (fault_ptr == nullptr) {
+        Common::Redis::RespValuePtr response = read_cache.lookup(to_lower_string, *request);
+        if (response != nullptr) {
+          handler->command_stats_.total_.inc();
+          handler->command_stats_.success_.inc();
+          callbacks.onResponse(std::move(response));
+          return nullptr;
+        }
+        caching_request =
+            std::make_unique<CachingRequest>(callbacks, read_cache, to_lower_string, *request);
+      }
+    } else if (Common::Redis::SupportedCommands::writeCommands().contains(to_lower_string)) {
+      read_cache.invalidate(*request);
+    }
+  }
+
   std::unique_ptr<DelayFaultRequest> delay_fault_ptr;
   if (has_delay_fault) {
     delay_fault_ptr = DelayFaultRequest::create(callbacks, handler->command_stats_, time_source_,
@@ -540,6 +568,17 @@ SplitRequestPtr InstanceImpl::makeRequest(Common::Redis::RespValuePtr&& request,
   handler->command_stats_.total_.inc();
 
   SplitRequestPtr request_ptr;
+  if (caching_request != nullptr) {
+    // The caching request takes ownership of the wrapped request, unless it is already complete.
+    request_ptr = handler->handler_.get().startRequest(
+        std::move(request), *caching_request, handler->command_stats_, time_source_, false);
+    if (request_ptr == nullptr) {
+      return nullptr;
+    }
+    caching_request->wrapped_request_ptr_ = std::move(request_ptr);
+    return caching_request;
+  }
+
   if (fault_ptr != nullptr && fault_ptr->faultType() == Common::Redis::FaultType::Error) {
     request_ptr = ErrorFaultRequest::create(has_delay_fault ? *delay_fault_ptr : callbacks,
                                             handler->command_stats_, time_source_, has_delay_fault);
@@ -17,6 +17,7 @@
 #include "extensions/filters/network/common/redis/utility.h"
 #include "extensions/filters/network/redis_proxy/command_splitter.h"
 #include "extensions/filters/network/redis_proxy/conn_pool_impl.h"
+#include "extensions/filters/network/redis_proxy/read_cache.h"
 #include "extensions/filters/network/redis_proxy/router.h"
 
 namespace Envoy {
@@ -167,6 +168,37 @@ private:
   Common::Redis::RespValuePtr response_;
 };
 
+/**
+ * CachingRequest wraps a request for a cacheable read, and caches its response.
+ */
+class CachingRequest : public SplitRequest, public SplitCallbacks {
+public:
+  CachingRequest(SplitCallbacks& callbacks, ReadCache& cache, const std::string& command,
+                 const Common::Redis::RespValue& request)
+      : callbacks_(callbacks), cache_(cache), command_(command), request_(request),
+        generation_(cache.generation()) {}
+
+  // SplitCallbacks
+  bool connectionAllowed() override { return callbacks_.connectionAllowed(); }
+  void onAuth(const std::string& password) override { callbacks_.onAuth(password); }
+  void onAuth(const std::string& username, const std::string& password) override {
+    callbacks_.onAuth(username, password);
+  }
+  void onResponse(Common::Redis::RespValuePtr&& response) override;
+
+  // RedisProxy::CommandSplitter::SplitRequest
+  void cancel() override { wrapped_request_ptr_->cancel(); }
+
+  SplitRequestPtr wrapped_request_ptr_;
+
+private:
+  SplitCallbacks& callbacks_;
+  ReadCache& cache_;
+  const std::string command_;
+  const Common::Redis::RespValue request_;
+  const uint64_t generation_;
+};
+
 /**
  * SimpleRequest hashes the first argument as the key.
  */
@@ -336,7 +368,8 @@ class InstanceImpl : public Instance, Logger::Loggable<Logger::Id::redis> {
 public:
   InstanceImpl(RouterPtr&& router, Stats::Scope& scope, const std::string& stat_prefix,
                TimeSource& time_source, bool latency_in_micros,
-               Common::Redis::FaultManagerPtr&& fault_manager);
+               Common::Redis::FaultManagerPtr&& fault_manager,
+               ThreadLocalReadCacheSharedPtr read_cache = nullptr);
 
   // RedisProxy::CommandSplitter::Instance
   SplitRequestPtr makeRequest(Common::Redis::RespValuePtr&& request, SplitCallbacks& callbacks,
@@ -366,6 +399,7 @@ private:
   InstanceStats stats_;
   TimeSource& time_source_;
   Common::Redis::FaultManagerPtr fault_manager_;
+  ThreadLocalReadCacheSharedPtr read_cache_;
 };
 
 } // namespace CommandSplitter
@@ -90,10 +90,17 @@ Network::FilterFactoryCb RedisProxyFilterConfigFactory::createFilterFactoryFromP
   auto fault_manager = std::make_unique<Common::Redis::FaultManagerImpl>(
       context.api().randomGenerator(), context.runtime(), proto_config.faults());
 
+  ThreadLocalReadCacheSharedPtr read_cache;
+  if (proto_config.has_read_cache()) {
+    read_cache = std::make_shared<ThreadLocalReadCache>(
+        proto_config.read_cache(), context.threadLocal(), context.scope(),
+        filter_config->stat_prefix_);
+  }
+
   std::shared_ptr<CommandSplitter::Instance> splitter =
       std::make_shared<CommandSplitter::InstanceImpl>(
           std::move(router), context.scope(), filter_config->stat_prefix_, context.timeSource(),
-          proto_config.latency_in_micros(), std::move(fault_manager));
+          proto_config.latency_in_micros(), std::move(fault_manager), std::move(read_cache));
   return [splitter, filter_config](Network::FilterManager& filter_manager) -> void {
     Common::Redis::DecoderFactoryImpl factory;
     filter_manager.addReadFilter(std::make_shared<ProxyFilter>(
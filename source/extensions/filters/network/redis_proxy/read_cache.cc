@@ -0,0 +1,220 @@
+#include "extensions/filters/network/redis_proxy/read_cache.h"
+
+#include "envoy/common/exception.h"
+#include "envoy/event/dispatcher.h"
+
+#include "common/common/fmt.h"
+#include "common/common/macros.h"
+#include "common/protobuf/utility.h"
+
+#include "extensions/filters/network/common/redis/supported_commands.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace RedisProxy {
+namespace {
+
+constexpr uint32_t DefaultMaxKeys = 10000;
+
+const absl::flat_hash_set<std::string>& cacheableCommands() {
+  CONSTRUCT_ON_FIRST_USE(absl::flat_hash_set<std::string>, "get", "getrange", "hget", "hgetall",
+                         "hmget", "mget", "strlen");
+}
+
+// The request key of a GET, under which the responses to an MGET are cached too.
+const std::string& getRequestKey() { CONSTRUCT_ON_FIRST_USE(std::string, "get"); }
+
+// The key of the response to a request for a key: the command and the arguments following the
+// key, prefixed with their lengths.
+std::string requestKey(const std::string& command, const Common::Redis::RespValue& request) {
+  std::string request_key = command;
+  const auto& args = request.asArray();
+  for (size_t i = 2; i < args.size(); ++i) {
+    absl::StrAppend(&request_key, "|", args[i].asString().size(), ":", args[i].asString());
+  }
+  return request_key;
+}
+
+} // namespace
+
+ReadCache::Options::Options(
+    const envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::ReadCache& config)
+    : key_prefixes_(config.key_prefixes().begin(), config.key_prefixes().end()),
+      ttl_(PROTOBUF_GET_MS_REQUIRED(config, ttl)),
+      max_keys_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_keys, DefaultMaxKeys)) {
+  for (const std::string& command : config.commands()) {
+    const std::string lower_command = absl::AsciiStrToLower(command);
+    if (!cacheableCommands().contains(lower_command)) {
+      throw EnvoyException(fmt::format("redis read cache: command '{}' cannot be cached", command));
+    }
+    commands_.insert(lower_command);
+  }
+}
+
+bool ReadCache::cachedKey(const std::string& key) const {
+  if (options_.key_prefixes_.empty()) {
+    return true;
+  }
+  for (const std::string& prefix : options_.key_prefixes_) {
+    if (absl::StartsWith(key, prefix)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ReadCache::cacheable(const std::string& command,
+                          const Common::Redis::RespValue& request) const {
+  if (!options_.commands_.contains(command)) {
+    return false;
+  }
+  const auto& args = request.asArray();
+  if (command != Common::Redis::SupportedCommands::mget()) {
+    return cachedKey(args[1].asString());
+  }
+  for (size_t i = 1; i < args.size(); ++i) {
+    if (!cachedKey(args[i].asString())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const Common::Redis::RespValue* ReadCache::find(const std::string& key,
+                                                const std::string& request_key) {
+  const auto key_it = keys_.find(key);
+  if (key_it == keys_.end()) {
+    return nullptr;
+  }
+  KeyEntry& entry = key_it->second;
+  const auto it = entry.responses_.find(request_key);
+  if (it == entry.responses_.end()) {
+    return nullptr;
+  }
+  if (it->second.expiry_ <= time_source_.monotonicTime()) {
+    entry.responses_.erase(it);
+    if (entry.responses_.empty()) {
+      lru_.erase(entry.lru_position_);
+      keys_.erase(key_it);
+    }
+    return nullptr;
+  }
+  lru_.splice(lru_.begin(), lru_, entry.lru_position_);
+  return &it->second.value_;
+}
+
+Common::Redis::RespValuePtr ReadCache::lookup(const std::string& command,
+                                              const Common::Redis::RespValue& request) {
+  const auto& args = request.asArray();
+  Common::Redis::RespValuePtr response;
+  if (command == Common::Redis::SupportedCommands::mget()) {
+    // An MGET is served from the responses to the GETs of its keys, if they are all cached.
+    std::vector<Common::Redis::RespValue> values;
+    values.reserve(args.size() - 1);
+    for (size_t i = 1; i < args.size(); ++i) {
+      const Common::Redis::RespValue* value = find(args[i].asString(), getRequestKey());
+      if (value == nullptr) {
+        stats_.miss_.inc();
+        return nullptr;
+      }
+      values.push_back(*value);
+    }
+    response = std::make_unique<Common::Redis::RespValue>();
+    response->type(Common::Redis::RespType::Array);
+    response->asArray().swap(values);
+  } else {
+    const Common::Redis::RespValue* value = find(args[1].asString(), requestKey(command, request));
+    if (value == nullptr) {
+      stats_.miss_.inc();
+      return nullptr;
+    }
+    response = std::make_unique<Common::Redis::RespValue>(*value);
+  }
+  stats_.hit_.inc();
+  return response;
+}
+
+void ReadCache::store(const std::string& key, std::string&& request_key,
+                      const Common::Redis::RespValue& response) {
+  auto key_it = keys_.find(key);
+  if (key_it == keys_.end()) {
+    if (keys_.size() >= options_.max_keys_) {
+      keys_.erase(lru_.back());
+      lru_.pop_back();
+      stats_.eviction_.inc();
+    }
+    lru_.push_front(key);
+    key_it = keys_.emplace(key, KeyEntry{lru_.begin(), {}}).first;
+  } else {
+    lru_.splice(lru_.begin(), lru_, key_it->second.lru_position_);
+  }
+  key_it->second.responses_[std::move(request_key)] =
+      CachedResponse{response, time_source_.monotonicTime() + options_.ttl_};
+}
+
+void ReadCache::insert(const std::string& command, const Common::Redis::RespValue& request,
+                       const Common::Redis::RespValue& response, uint64_t generation) {
+  // A write sent while the request was in flight may have been applied before or after the read.
+  if (generation != generation_) {
+    return;
+  }
+  const auto& args = request.asArray();
+  if (command != Common::Redis::SupportedCommands::mget()) {
+    if (response.type() != Common::Redis::RespType::Error) {
+      store(args[1].asString(), requestKey(command, request), response);
+    }
+    return;
+  }
+  if (response.type() != Common::Redis::RespType::Array ||
+      response.asArray().size() != args.size() - 1) {
+    return;
+  }
+  for (size_t i = 1; i < args.size(); ++i) {
+    const Common::Redis::RespValue& value = response.asArray()[i - 1];
+    if (value.type() == Common::Redis::RespType::BulkString ||
+        value.type() == Common::Redis::RespType::Null) {
+      store(args[i].asString(), std::string(getRequestKey()), value);
+    }
+  }
+}
+
+void ReadCache::invalidate(const Common::Redis::RespValue& request) {
+  const auto& args = request.asArray();
+  bool cached_key = false;
+  for (size_t i = 1; i < args.size(); ++i) {
+    if (!cachedKey(args[i].asString())) {
+      continue;
+    }
+    cached_key = true;
+    const auto it = keys_.find(args[i].asString());
+    if (it != keys_.end()) {
+      lru_.erase(it->second.lru_position_);
+      keys_.erase(it);
+      stats_.invalidation_.inc();
+    }
+  }
+  if (cached_key) {
+    ++generation_;
+  }
+}
+
+ThreadLocalReadCache::ThreadLocalReadCache(
+    const envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::ReadCache& config,
+    ThreadLocal::SlotAllocator& tls, Stats::Scope& scope, const std::string& stat_prefix)
+    : options_(config),
+      stats_{ALL_READ_CACHE_STATS(POOL_COUNTER_PREFIX(scope, stat_prefix + "read_cache."))},
+      tls_(tls.allocateSlot()) {
+  tls_->set([this](Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<ReadCache>(options_, stats_, dispatcher.timeSource());
+  });
+}
+
+} // namespace RedisProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/extensions/filters/network/redis_proxy/v3/redis_proxy.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "extensions/filters/network/common/redis/codec.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace RedisProxy {
+
+/**
+ * All read cache stats. @see stats_macros.h
+ */
+#define ALL_READ_CACHE_STATS(COUNTER)                                                              \
+  COUNTER(hit)                                                                                     \
+  COUNTER(miss)                                                                                    \
+  COUNTER(eviction)                                                                                \
+  COUNTER(invalidation)
+
+/**
+ * Struct definition for all read cache stats. @see stats_macros.h
+ */
+struct ReadCacheStats {
+  ALL_READ_CACHE_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * The responses to read commands cached by a worker, by key. A response is served until it
+ * expires, or until a write command through the worker names its key.
+ */
+class ReadCache : public ThreadLocal::ThreadLocalObject {
+public:
+  struct Options {
+    // Throws EnvoyException if a command is not cacheable.
+    explicit Options(
+        const envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::ReadCache& config);
+
+    absl::flat_hash_set<std::string> commands_;
+    std::vector<std::string> key_prefixes_;
+    std::chrono::milliseconds ttl_;
+    uint32_t max_keys_;
+  };
+
+  ReadCache(const Options& options, ReadCacheStats& stats, TimeSource& time_source)
+      : options_(options), stats_(stats), time_source_(time_source) {}
+
+  /**
+   * @param command supplies the lowercase command of the request.
+   * @param request supplies the request, an array of bulk strings.
+   * @return whether the response to the request may be cached.
+   */
+  bool cacheable(const std::string& command, const Common::Redis::RespValue& request) const;
+
+  /**
+   * @param command supplies the lowercase command of a cacheable request.
+   * @param request supplies the request.
+   * @return a copy of the cached response to the request, or nullptr if there is none.
+   */
+  Common::Redis::RespValuePtr lookup(const std::string& command,
+                                     const Common::Redis::RespValue& request);
+
+  /**
+   * Caches the response to a request.
+   * @param command supplies the lowercase command of a cacheable request.
+   * @param request supplies the request.
+   * @param response supplies the response. Errors are not cached.
+   * @param generation supplies the generation of the cache when the request was sent. The
+   *        response is not cached if a write may have changed it since.
+   */
+  void insert(const std::string& command, const Common::Redis::RespValue& request,
+              const Common::Redis::RespValue& response, uint64_t generation);
+
+  /**
+   * Drops the responses cached for the keys a write command may change, which are taken to be
+   * all its arguments.
+   * @param request supplies the request of the write command.
+   */
+  void invalidate(const Common::Redis::RespValue& request);
+
+  /**
+   * @return the generation of the cache, which changes with every write to a cached key prefix.
+   */
+  uint64_t generation() const { return generation_; }
+
+  /**
+   * @return the number of keys with cached responses.
+   */
+  size_t size() const { return keys_.size(); }
+
+private:
+  struct CachedResponse {
+    Common::Redis::RespValue value_;
+    MonotonicTime expiry_;
+  };
+
+  struct KeyEntry {
+    std::list<std::string>::iterator lru_position_;
+    // The responses by command and arguments following the key.
+    absl::flat_hash_map<std::string, CachedResponse> responses_;
+  };
+
+  bool cachedKey(const std::string& key) const;
+  const Common::Redis::RespValue* find(const std::string& key, const std::string& request_key);
+  void store(const std::string& key, std::string&& request_key,
+             const Common::Redis::RespValue& response);
+
+  const Options& options_;
+  ReadCacheStats& stats_;
+  TimeSource& time_source_;
+  absl::flat_hash_map<std::string, KeyEntry> keys_;
+  // The keys, most recently used first.
+  std::list<std::string> lru_;
+  uint64_t generation_{};
+};
+
+/**
+ * The read caches of the workers.
+ */
+class ThreadLocalReadCache {
+public:
+  ThreadLocalReadCache(
+      const envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::ReadCache& config,
+      ThreadLocal::SlotAllocator& tls, Stats::Scope& scope, const std::string& stat_prefix);
+
+  /**
+   * @return the read cache of the current worker.
+   */
+  ReadCache& get() { return tls_->getTyped<ReadCache>(); }
+
+private:
+  const ReadCache::Options options_;
+  ReadCacheStats stats_;
+  ThreadLocal::SlotPtr tls_;
+};
+
+using ThreadLocalReadCacheSharedPtr = std::shared_ptr<ThreadLocalReadCache>;
+
+} // namespace RedisProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -228,8 +228,9 @@ FilterStatus ConnectionManager::ResponseDecoder::messageEnd() {
     // because the response struct has no fields and so the first field type is FieldType::Stop.
     // The decoder state machine handles FieldType::Stop by going immediately to structEnd,
     // skipping fieldBegin callback. Therefore if we are still waiting for the first reply field
-    // at end of message then it is a void success.
-    success_ = true;
+    // at end of message then it is a void success. When the body is passed through, no field is
+    // decoded and the decoder tells apart results and exceptions from the first field it peeked.
+    success_ = !metadata_->hasReplyType() || metadata_->replyType() == ReplyType::Success;
     first_reply_field_ = false;
   }
 
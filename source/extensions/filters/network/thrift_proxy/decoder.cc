@@ -20,12 +20,43 @@ DecoderStateMachine::DecoderStatus DecoderStateMachine::passthroughData(Buffer::
     return {ProtocolState::WaitForData};
   }
 
+  if (metadata_->hasMessageType() && metadata_->messageType() == MessageType::Reply) {
+    peekReplyType(buffer);
+  }
+
   Buffer::OwnedImpl body;
   body.move(buffer, body_bytes_);
 
   return {ProtocolState::MessageEnd, handler_.passthroughData(body)};
 }
 
+// The first field of the struct of a reply is field 0 for the result of the call, or the field of
+// one of the exceptions declared by the method. It is read from a copy of the start of the body,
+// which is passed through as is.
+void DecoderStateMachine::peekReplyType(const Buffer::Instance& buffer) {
+  // The longest field header (compact protocol, with a zigzag varint id) and a binary boolean
+  // value fit in 4 bytes.
+  uint8_t bytes[4];
+  const uint32_t size = std::min<uint32_t>(body_bytes_, sizeof(bytes));
+  buffer.copyOut(0, size, bytes);
+  Buffer::OwnedImpl start(bytes, size);
+
+  std::string name;
+  FieldType field_type;
+  int16_t field_id;
+  proto_.readStructBegin(start, name);
+  if (proto_.readFieldBegin(start, name, field_type, field_id)) {
+    metadata_->setReplyType(field_type != FieldType::Stop && field_id != 0 ? ReplyType::Error
+                                                                           : ReplyType::Success);
+    if (field_type == FieldType::Bool) {
+      // The compact protocol keeps the value of a boolean field from its header until it is read.
+      bool value;
+      proto_.readBool(start, value);
+    }
+  }
+  proto_.readStructEnd(start);
+}
+
 // MessageBegin -> StructBegin
 DecoderStateMachine::DecoderStatus DecoderStateMachine::messageBegin(Buffer::Instance& buffer) {
   const auto total = buffer.length();
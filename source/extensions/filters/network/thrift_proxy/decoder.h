@@ -133,6 +133,7 @@ private:
   // These functions map directly to the matching ProtocolState values. Each returns the next state
   // or ProtocolState::WaitForData if more data is required.
   DecoderStatus passthroughData(Buffer::Instance& buffer);
+  void peekReplyType(const Buffer::Instance& buffer);
   DecoderStatus messageBegin(Buffer::Instance& buffer);
   DecoderStatus messageEnd(Buffer::Instance& buffer);
   DecoderStatus structBegin(Buffer::Instance& buffer);
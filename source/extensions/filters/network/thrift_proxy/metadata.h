@@ -51,6 +51,13 @@ public:
   MessageType messageType() const { return msg_type_.value(); }
   void setMessageType(MessageType msg_type) { msg_type_ = msg_type; }
 
+  /**
+   * The reply type is only set for the replies whose body is passed through without being decoded.
+   */
+  bool hasReplyType() const { return reply_type_.has_value(); }
+  ReplyType replyType() const { return reply_type_.value(); }
+  void setReplyType(ReplyType reply_type) { reply_type_ = reply_type; }
+
   /**
    * @return HeaderMap of current headers (never throws)
    */
@@ -104,6 +111,7 @@ private:
   absl::optional<std::string> method_name_{};
   absl::optional<int32_t> seq_id_{};
   absl::optional<MessageType> msg_type_{};
+  absl::optional<ReplyType> reply_type_{};
   Http::HeaderMapPtr headers_{Http::RequestHeaderMapImpl::create()};
   absl::optional<AppExceptionType> app_ex_type_;
   absl::optional<std::string> app_ex_msg_;
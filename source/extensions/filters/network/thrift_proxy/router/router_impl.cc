@@ -262,9 +262,9 @@ FilterStatus Router::messageBegin(MessageMetadataSharedPtr metadata) {
                                         : callbacks_->downstreamProtocolType();
   ASSERT(protocol != ProtocolType::Auto);
 
-  if (callbacks_->downstreamTransportType() == TransportType::Framed &&
-      transport == TransportType::Framed && callbacks_->downstreamProtocolType() == protocol &&
-      protocol != ProtocolType::Twitter) {
+  if ((transport == TransportType::Framed || transport == TransportType::Header) &&
+      callbacks_->downstreamTransportType() == transport &&
+      callbacks_->downstreamProtocolType() == protocol && protocol != ProtocolType::Twitter) {
     passthrough_supported_ = true;
   }
 
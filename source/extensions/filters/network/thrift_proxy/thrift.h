@@ -118,6 +118,14 @@ enum class MessageType {
   LastMessageType = Oneway,
 };
 
+/**
+ * Whether a reply carries the result of the call, or one of the exceptions declared by the method.
+ */
+enum class ReplyType {
+  Success,
+  Error,
+};
+
 /**
  * Thrift protocol struct field types.
  * See https://github.com/apache/thrift/blob/master/lib/cpp/src/thrift/protocol/TProtocol.h
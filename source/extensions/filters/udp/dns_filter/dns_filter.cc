@@ -22,7 +22,8 @@ DnsFilterEnvoyConfig::DnsFilterEnvoyConfig(
     const envoy::extensions::filters::udp::dns_filter::v3alpha::DnsFilterConfig& config)
     : root_scope_(context.scope()), cluster_manager_(context.clusterManager()), api_(context.api()),
       stats_(generateStats(config.stat_prefix(), root_scope_)),
-      resolver_timeout_(DEFAULT_RESOLVER_TIMEOUT), random_(context.api().randomGenerator()) {
+      resolver_timeout_(DEFAULT_RESOLVER_TIMEOUT), random_(context.api().randomGenerator()),
+      max_cached_responses_(config.max_cached_responses()) {
   using envoy::extensions::filters::udp::dns_filter::v3alpha::DnsFilterConfig;
 
   const auto& server_config = config.server_config();
@@ -217,6 +218,9 @@ DnsFilter::DnsFilter(Network::UdpReadFilterCallbacks& callbacks,
       const std::chrono::seconds ttl = getDomainTTL(query->name_);
       message_parser_.storeDnsAnswerRecord(context, *query, ttl, std::move(ip));
     }
+    if (!iplist.empty()) {
+      setCacheExpiry(*context);
+    }
     sendDnsResponse(std::move(context));
   };
 
@@ -229,6 +233,17 @@ void DnsFilter::onData(Network::UdpRecvData& client_request) {
   config_->stats().downstream_rx_bytes_.recordValue(client_request.buffer_->length());
   config_->stats().downstream_rx_queries_.inc();
 
+  // An identical query answered earlier is answered again from its cached response, without being
+  // parsed.
+  std::string cache_key;
+  if (config_->maxCachedResponses() > 0 && client_request.buffer_->length() > sizeof(uint16_t)) {
+    cache_key.resize(client_request.buffer_->length() - sizeof(uint16_t));
+    client_request.buffer_->copyOut(sizeof(uint16_t), cache_key.size(), cache_key.data());
+    if (sendCachedResponse(client_request, cache_key)) {
+      return;
+    }
+  }
+
   // Setup counters for the parser
   DnsParserCounters parser_counters(config_->stats().query_buffer_underflow_,
                                     config_->stats().record_name_overflow_,
@@ -237,6 +252,7 @@ void DnsFilter::onData(Network::UdpRecvData& client_request) {
   // Parse the query, if it fails return an response to the client
   DnsQueryContextPtr query_context =
       message_parser_.createQueryContext(client_request, parser_counters);
+  query_context->cache_key_ = std::move(cache_key);
   incrementQueryTypeCount(query_context->queries_);
   if (!query_context->parse_status_) {
     config_->stats().downstream_rx_invalid_queries_.inc();
@@ -260,13 +276,62 @@ void DnsFilter::sendDnsResponse(DnsQueryContextPtr query_context) {
   // Serializes the generated response to the parsed query from the client. If there is a
   // parsing error or the incoming query is invalid, we will still generate a valid DNS response
   message_parser_.buildResponseBuffer(query_context, response);
+
+  // Responses picking a random subset of their answers are not cached, so that they keep varying.
+  if (query_context->cache_expiry_.has_value() && !query_context->cache_key_.empty() &&
+      query_context->response_header_.answers > 0 &&
+      query_context->answers_.size() <= MAX_RETURNED_RECORDS) {
+    if (response_cache_.size() >= config_->maxCachedResponses() &&
+        !response_cache_.contains(query_context->cache_key_)) {
+      // Make room by evicting an arbitrary response.
+      response_cache_.erase(response_cache_.begin());
+    }
+    response_cache_[std::move(query_context->cache_key_)] = {
+        response.toString(), query_context->queries_.front()->type_,
+        query_context->cache_expiry_.value()};
+  }
+  sendResponseBuffer(*query_context->local_, *query_context->peer_, response);
+}
+
+bool DnsFilter::sendCachedResponse(const Network::UdpRecvData& client_request,
+                                   const std::string& key) {
+  const auto it = response_cache_.find(key);
+  if (it == response_cache_.end()) {
+    return false;
+  }
+  if (it->second.expiry_ <= listener_.dispatcher().timeSource().monotonicTime()) {
+    response_cache_.erase(it);
+    return false;
+  }
+
+  config_->stats().response_cache_hits_.inc();
+  incrementQueryTypeCount(it->second.query_type_);
+  const std::string& cached = it->second.response_;
+  Buffer::OwnedImpl response;
+  response.writeBEInt<uint16_t>(client_request.buffer_->peekBEInt<uint16_t>());
+  response.add(cached.data() + sizeof(uint16_t), cached.size() - sizeof(uint16_t));
+  sendResponseBuffer(*client_request.addresses_.local_, *client_request.addresses_.peer_,
+                     response);
+  return true;
+}
+
+void DnsFilter::sendResponseBuffer(const Network::Address::Instance& local,
+                                   const Network::Address::Instance& peer,
+                                   Buffer::Instance& response) {
   config_->stats().downstream_tx_responses_.inc();
   config_->stats().downstream_tx_bytes_.recordValue(response.length());
-  Network::UdpSendData response_data{query_context->local_->ip(), *(query_context->peer_),
-                                     response};
+  Network::UdpSendData response_data{local.ip(), peer, response};
   listener_.send(response_data);
 }
 
+void DnsFilter::setCacheExpiry(DnsQueryContext& context) {
+  if (context.cache_key_.empty() || context.queries_.size() != 1) {
+    return;
+  }
+  context.cache_expiry_ = listener_.dispatcher().timeSource().monotonicTime() +
+                          getDomainTTL(context.queries_.front()->name_);
+}
+
 DnsLookupResponseCode DnsFilter::getResponseForQuery(DnsQueryContextPtr& context) {
   /* It appears to be a rare case where we would have more than one query in a single request.
    * It is allowed by the protocol but not widely supported:
@@ -288,6 +353,7 @@ DnsLookupResponseCode DnsFilter::getResponseForQuery(DnsQueryContextPtr& context
 
       // Determine whether we an answer this query with the static configuration
       if (resolveViaConfiguredHosts(context, *query)) {
+        setCacheExpiry(*context);
         continue;
       }
     }
@@ -13,6 +13,7 @@
 #include "extensions/filters/udp/dns_filter/dns_filter_resolver.h"
 #include "extensions/filters/udp/dns_filter/dns_parser.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 
 namespace Envoy {
@@ -52,6 +53,7 @@ namespace DnsFilter {
   COUNTER(query_buffer_underflow)                                                                  \
   COUNTER(query_parsing_failure)                                                                   \
   COUNTER(record_name_overflow)                                                                    \
+  COUNTER(response_cache_hits)                                                                     \
   HISTOGRAM(downstream_rx_bytes, Bytes)                                                            \
   HISTOGRAM(downstream_rx_query_latency, Milliseconds)                                             \
   HISTOGRAM(downstream_tx_bytes, Bytes)
@@ -93,6 +95,7 @@ public:
   uint64_t retryCount() const { return retry_count_; }
   Random::RandomGenerator& random() const { return random_; }
   uint64_t maxPendingLookups() const { return max_pending_lookups_; }
+  uint32_t maxCachedResponses() const { return max_cached_responses_; }
 
 private:
   static DnsFilterStats generateStats(const std::string& stat_prefix, Stats::Scope& scope) {
@@ -120,6 +123,7 @@ private:
   std::chrono::milliseconds resolver_timeout_;
   Random::RandomGenerator& random_;
   uint64_t max_pending_lookups_;
+  uint32_t max_cached_responses_;
 };
 
 using DnsFilterEnvoyConfigSharedPtr = std::shared_ptr<const DnsFilterEnvoyConfig>;
@@ -153,6 +157,27 @@ private:
    */
   void sendDnsResponse(DnsQueryContextPtr context);
 
+  /**
+   * Sends the cached response to a query, with the ID of the query.
+   *
+   * @param client_request the query received from the client
+   * @param key the bytes of the query following its ID
+   * @return bool true if a response to the query was cached and sent
+   */
+  bool sendCachedResponse(const Network::UdpRecvData& client_request, const std::string& key);
+
+  /**
+   * Sends a serialized response to a client.
+   */
+  void sendResponseBuffer(const Network::Address::Instance& local,
+                          const Network::Address::Instance& peer, Buffer::Instance& response);
+
+  /**
+   * Marks the response to a query resolved with a single question as cacheable, for the TTL of
+   * its answers.
+   */
+  void setCacheExpiry(DnsQueryContext& context);
+
   /**
    * @brief Encapsulates all of the logic required to find an answer for a DNS query
    *
@@ -367,6 +392,14 @@ private:
   Network::Address::InstanceConstSharedPtr local_;
   Network::Address::InstanceConstSharedPtr peer_;
   DnsFilterResolverCallback resolver_callback_;
+
+  struct CachedResponse {
+    std::string response_;
+    uint16_t query_type_;
+    MonotonicTime expiry_;
+  };
+  // The serialized responses of the worker, keyed by the bytes of their queries following the ID.
+  absl::flat_hash_map<std::string, CachedResponse> response_cache_;
 };
 
 } // namespace DnsFilter
@@ -2,6 +2,7 @@
 
 #include "envoy/buffer/buffer.h"
 #include "envoy/common/platform.h"
+#include "envoy/common/time.h"
 #include "envoy/common/random_generator.h"
 #include "envoy/network/address.h"
 #include "envoy/network/dns.h"
@@ -187,6 +188,11 @@ public:
   DnsAnswerMap answers_;
   DnsAnswerMap additional_;
   bool in_callback_;
+  // The bytes of the query following its ID, which key its response in the response cache. Empty
+  // if responses are not cached.
+  std::string cache_key_;
+  // Set if the response may be cached, to the time it expires from the cache.
+  absl::optional<MonotonicTime> cache_expiry_;
 
   /**
    * @param context the query context for which we are querying the response code
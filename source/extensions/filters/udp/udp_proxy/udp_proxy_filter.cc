@@ -3,6 +3,7 @@
 #include "envoy/network/listener.h"
 
 #include "common/network/socket_option_factory.h"
+#include "common/network/udp_batch_writer.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -67,12 +68,15 @@ UdpProxyFilter::ClusterInfo::ClusterInfo(UdpProxyFilter& filter,
               if (host_sessions_it != host_to_sessions_.end()) {
                 for (const auto& session : host_sessions_it->second) {
                   ASSERT(sessions_.count(session) == 1);
+                  idle_sessions_.erase(session->idle_entry_);
                   sessions_.erase(session);
                 }
                 host_to_sessions_.erase(host_sessions_it);
               }
             }
-          })) {}
+          })),
+      idle_timer_(filter.read_callbacks_->udpListener().dispatcher().createTimer(
+          [this] { onIdleTimer(); })) {}
 
 UdpProxyFilter::ClusterInfo::~ClusterInfo() {
   member_update_cb_handle_->remove();
@@ -136,6 +140,8 @@ UdpProxyFilter::ClusterInfo::createSession(Network::UdpRecvData::LocalPeerAddres
   auto new_session_ptr = new_session.get();
   sessions_.emplace(std::move(new_session));
   host_to_sessions_[host.get()].emplace(new_session_ptr);
+  new_session_ptr->last_use_time_ = filter_.config_->timeSource().monotonicTime();
+  new_session_ptr->idle_entry_ = idle_sessions_.insert(idle_sessions_.end(), new_session_ptr);
   return new_session_ptr;
 }
 
@@ -148,26 +154,67 @@ void UdpProxyFilter::ClusterInfo::removeSession(const ActiveSession* session) {
     host_to_sessions_.erase(host_sessions_it);
   }
 
+  idle_sessions_.erase(session->idle_entry_);
+
   // Now remove it from the primary map.
   ASSERT(sessions_.count(session) == 1);
   sessions_.erase(session);
 }
 
+void UdpProxyFilter::ClusterInfo::touchSession(ActiveSession& session) {
+  session.last_use_time_ = filter_.config_->timeSource().monotonicTime();
+  idle_sessions_.splice(idle_sessions_.end(), idle_sessions_, session.idle_entry_);
+  if (!idle_timer_->enabled()) {
+    idle_timer_->enableTimer(filter_.config_->sessionTimeout());
+  }
+}
+
+void UdpProxyFilter::ClusterInfo::onIdleTimer() {
+  const MonotonicTime now = filter_.config_->timeSource().monotonicTime();
+  const std::chrono::milliseconds session_timeout = filter_.config_->sessionTimeout();
+  while (!idle_sessions_.empty() &&
+         idle_sessions_.front()->last_use_time_ + session_timeout <= now) {
+    const ActiveSession* session = idle_sessions_.front();
+    ENVOY_LOG(debug, "session idle timeout: downstream={} local={}",
+              session->addresses().peer_->asStringView(),
+              session->addresses().local_->asStringView());
+    filter_.config_->stats().idle_timeout_.inc();
+    removeSession(session);
+  }
+  if (!idle_sessions_.empty()) {
+    idle_timer_->enableTimer(std::chrono::ceil<std::chrono::milliseconds>(
+        idle_sessions_.front()->last_use_time_ + session_timeout - now));
+  }
+}
+
 UdpProxyFilter::ActiveSession::ActiveSession(ClusterInfo& cluster,
                                              Network::UdpRecvData::LocalPeerAddresses&& addresses,
                                              const Upstream::HostConstSharedPtr& host)
     : cluster_(cluster), use_original_src_ip_(cluster_.filter_.config_->usingOriginalSrcIp()),
       addresses_(std::move(addresses)), host_(host),
-      idle_timer_(cluster.filter_.read_callbacks_->udpListener().dispatcher().createTimer(
-          [this] { onIdleTimer(); })),
       // NOTE: The socket call can only fail due to memory/fd exhaustion. No local ephemeral port
       //       is bound until the first packet is sent to the upstream host.
       socket_(cluster.filter_.createSocket(host)) {
 
+  Event::Dispatcher& dispatcher = cluster.filter_.read_callbacks_->udpListener().dispatcher();
+  uint32_t file_events = Event::FileReadyType::Read;
+  if (cluster_.filter_.config_->batchUpstreamWrites()) {
+    upstream_writer_ = std::make_unique<Network::UdpBatchWriter>(socket_->ioHandle());
+    upstream_flush_cb_ = dispatcher.createSchedulableCallback([this]() { flushUpstream(); });
+    // Write events tell when a blocked writer can resume sending.
+    file_events |= Event::FileReadyType::Write;
+  }
   socket_->ioHandle().initializeFileEvent(
-      cluster.filter_.read_callbacks_->udpListener().dispatcher(),
-      [this](uint32_t) { onReadReady(); }, Event::PlatformDefaultTriggerType,
-      Event::FileReadyType::Read);
+      dispatcher,
+      [this](uint32_t events) {
+        if (events & Event::FileReadyType::Read) {
+          onReadReady();
+        }
+        if (events & Event::FileReadyType::Write) {
+          onWriteReady();
+        }
+      },
+      Event::PlatformDefaultTriggerType, file_events);
   ENVOY_LOG(debug, "creating new session: downstream={} local={} upstream={}",
             addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
             host->address()->asStringView());
@@ -197,6 +244,9 @@ UdpProxyFilter::ActiveSession::ActiveSession(ClusterInfo& cluster,
 }
 
 UdpProxyFilter::ActiveSession::~ActiveSession() {
+  if (upstream_writer_ != nullptr) {
+    flushUpstream();
+  }
   ENVOY_LOG(debug, "deleting the session: downstream={} local={} upstream={}",
             addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
             host_->address()->asStringView());
@@ -207,15 +257,8 @@ UdpProxyFilter::ActiveSession::~ActiveSession() {
       .dec();
 }
 
-void UdpProxyFilter::ActiveSession::onIdleTimer() {
-  ENVOY_LOG(debug, "session idle timeout: downstream={} local={}", addresses_.peer_->asStringView(),
-            addresses_.local_->asStringView());
-  cluster_.filter_.config_->stats().idle_timeout_.inc();
-  cluster_.removeSession(this);
-}
-
 void UdpProxyFilter::ActiveSession::onReadReady() {
-  idle_timer_->enableTimer(cluster_.filter_.config_->sessionTimeout());
+  cluster_.touchSession(*this);
 
   // TODO(mattklein123): We should not be passing *addresses_.local_ to this function as we are
   //                     not trying to populate the local address for received packets.
@@ -239,7 +282,7 @@ void UdpProxyFilter::ActiveSession::write(const Buffer::Instance& buffer) {
   cluster_.filter_.config_->stats().downstream_sess_rx_bytes_.add(buffer_length);
   cluster_.filter_.config_->stats().downstream_sess_rx_datagrams_.inc();
 
-  idle_timer_->enableTimer(cluster_.filter_.config_->sessionTimeout());
+  cluster_.touchSession(*this);
 
   // NOTE: On the first write, a local ephemeral port is bound, and thus this write can fail due to
   //       port exhaustion.
@@ -248,7 +291,13 @@ void UdpProxyFilter::ActiveSession::write(const Buffer::Instance& buffer) {
   //       use_original_src_ip_ is not set, else use downstream peer IP as local IP.
   const Network::Address::Ip* local_ip = use_original_src_ip_ ? addresses_.peer_->ip() : nullptr;
   Api::IoCallUint64Result rc =
-      Network::Utility::writeToSocket(socket_->ioHandle(), buffer, local_ip, *host_->address());
+      upstream_writer_ != nullptr
+          ? upstream_writer_->writePacket(buffer, local_ip, *host_->address())
+          : Network::Utility::writeToSocket(socket_->ioHandle(), buffer, local_ip,
+                                            *host_->address());
+  if (upstream_writer_ != nullptr && !upstream_flush_cb_->enabled()) {
+    upstream_flush_cb_->scheduleCallbackCurrentIteration();
+  }
   if (!rc.ok()) {
     cluster_.cluster_stats_.sess_tx_errors_.inc();
   } else {
@@ -257,6 +306,19 @@ void UdpProxyFilter::ActiveSession::write(const Buffer::Instance& buffer) {
   }
 }
 
+void UdpProxyFilter::ActiveSession::onWriteReady() {
+  upstream_writer_->setWritable();
+  flushUpstream();
+}
+
+void UdpProxyFilter::ActiveSession::flushUpstream() {
+  const Api::IoCallUint64Result rc = upstream_writer_->flush();
+  // Datagrams that could not be sent because the socket is not writable stay queued until it is.
+  if (!rc.ok() && rc.err_->getErrorCode() != Api::IoError::IoErrorCode::Again) {
+    cluster_.cluster_stats_.sess_tx_errors_.inc();
+  }
+}
+
 void UdpProxyFilter::ActiveSession::processPacket(Network::Address::InstanceConstSharedPtr,
                                                   Network::Address::InstanceConstSharedPtr,
                                                   Buffer::InstancePtr buffer, MonotonicTime) {
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <list>
+
 #include "envoy/event/file_event.h"
+#include "envoy/event/schedulable_cb.h"
 #include "envoy/event/timer.h"
 #include "envoy/extensions/filters/udp/udp_proxy/v3/udp_proxy.pb.h"
 #include "envoy/network/filter.h"
+#include "envoy/network/udp_packet_writer_handler.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/api/os_sys_calls_impl.h"
@@ -69,6 +73,8 @@ public:
       : cluster_manager_(cluster_manager), time_source_(time_source), cluster_(config.cluster()),
         session_timeout_(PROTOBUF_GET_MS_OR_DEFAULT(config, idle_timeout, 60 * 1000)),
         use_original_src_ip_(config.use_original_src_ip()),
+        batch_upstream_writes_(config.batch_upstream_writes() &&
+                               Api::OsSysCallsSingleton::get().supportsMmsg()),
         stats_(generateStats(config.stat_prefix(), root_scope)) {
     if (use_original_src_ip_ && !Api::OsSysCallsSingleton::get().supportsIpTransparent()) {
       ExceptionUtil::throwEnvoyException(
@@ -84,6 +90,7 @@ public:
   Upstream::ClusterManager& clusterManager() const { return cluster_manager_; }
   std::chrono::milliseconds sessionTimeout() const { return session_timeout_; }
   bool usingOriginalSrcIp() const { return use_original_src_ip_; }
+  bool batchUpstreamWrites() const { return batch_upstream_writes_; }
   const Udp::HashPolicy* hashPolicy() const { return hash_policy_.get(); }
   UdpProxyDownstreamStats& stats() const { return stats_; }
   TimeSource& timeSource() const { return time_source_; }
@@ -101,6 +108,7 @@ private:
   const std::string cluster_;
   const std::chrono::milliseconds session_timeout_;
   const bool use_original_src_ip_;
+  const bool batch_upstream_writes_;
   std::unique_ptr<const HashPolicyImpl> hash_policy_;
   mutable UdpProxyDownstreamStats stats_;
 };
@@ -157,8 +165,11 @@ private:
     void write(const Buffer::Instance& buffer);
 
   private:
-    void onIdleTimer();
+    friend class ClusterInfo;
+
     void onReadReady();
+    void onWriteReady();
+    void flushUpstream();
 
     // Network::UdpPacketProcessor
     void processPacket(Network::Address::InstanceConstSharedPtr local_address,
@@ -175,16 +186,18 @@ private:
     const bool use_original_src_ip_;
     const Network::UdpRecvData::LocalPeerAddresses addresses_;
     const Upstream::HostConstSharedPtr host_;
-    // TODO(mattklein123): Consider replacing an idle timer for each session with a last used
-    // time stamp and a periodic scan of all sessions to look for timeouts. This solution is simple,
-    // though it might not perform well for high volume traffic. Note that this is how TCP proxy
-    // idle timeouts work so we should consider unifying the implementation if we move to a time
-    // stamp and scan approach.
-    const Event::TimerPtr idle_timer_;
+    // The idle timeout of the session runs from its last use. Rather than a timer per session, the
+    // cluster keeps its sessions in order of last use and times them out from a single timer.
+    MonotonicTime last_use_time_;
+    std::list<ActiveSession*>::iterator idle_entry_;
     // The socket is used for writing packets to the selected upstream host as well as receiving
     // packets from the upstream host. Note that a a local ephemeral port is bound on the first
     // write to the upstream host.
     const Network::SocketPtr socket_;
+    // Only set if upstream writes are batched. Declared after the socket, whose IO handle the
+    // writer refers to.
+    Network::UdpPacketWriterPtr upstream_writer_;
+    Event::SchedulableCallbackPtr upstream_flush_cb_;
   };
 
   using ActiveSessionPtr = std::unique_ptr<ActiveSession>;
@@ -236,6 +249,8 @@ private:
     ~ClusterInfo();
     void onData(Network::UdpRecvData& data);
     void removeSession(const ActiveSession* session);
+    // Records a use of a session, which restarts its idle timeout.
+    void touchSession(ActiveSession& session);
 
     UdpProxyFilter& filter_;
     Upstream::ThreadLocalCluster& cluster_;
@@ -244,12 +259,17 @@ private:
   private:
     ActiveSession* createSession(Network::UdpRecvData::LocalPeerAddresses&& addresses,
                                  const Upstream::HostConstSharedPtr& host);
+    void onIdleTimer();
     static UdpProxyUpstreamStats generateStats(Stats::Scope& scope) {
       const auto final_prefix = "udp";
       return {ALL_UDP_PROXY_UPSTREAM_STATS(POOL_COUNTER_PREFIX(scope, final_prefix))};
     }
 
     Envoy::Common::CallbackHandle* member_update_cb_handle_;
+    // Armed for the idle timeout of the least recently used session.
+    const Event::TimerPtr idle_timer_;
+    // The sessions in order of last use, the least recently used first.
+    std::list<ActiveSession*> idle_sessions_;
     absl::flat_hash_set<ActiveSessionPtr, HeterogeneousActiveSessionHash,
                         HeterogeneousActiveSessionEqual>
         sessions_;
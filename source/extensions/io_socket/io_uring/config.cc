@@ -0,0 +1,51 @@
+#include "extensions/io_socket/io_uring/config.h"
+
+#include "envoy/extensions/network/socket_interface/v3/io_uring_socket_interface.pb.h"
+#include "envoy/extensions/network/socket_interface/v3/io_uring_socket_interface.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "common/protobuf/utility.h"
+
+#include "extensions/io_socket/io_uring/io_uring.h"
+#include "extensions/io_socket/io_uring/io_uring_socket_handle_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace IoSocket {
+namespace IoUring {
+
+Network::IoHandlePtr IoUringSocketInterface::makeSocket(int socket_fd, bool socket_v6only,
+                                                        absl::optional<int> domain) const {
+  if (!use_io_uring_) {
+    return Network::SocketInterfaceImpl::makeSocket(socket_fd, socket_v6only, domain);
+  }
+  return std::make_unique<IoUringSocketHandleImpl>(io_uring_size_, read_buffer_size_, socket_fd,
+                                                   socket_v6only, domain);
+}
+
+Server::BootstrapExtensionPtr IoUringSocketInterface::createBootstrapExtension(
+    const Protobuf::Message& message, Server::Configuration::ServerFactoryContext& context) {
+  const auto& config = MessageUtil::downcastAndValidate<
+      const envoy::extensions::network::socket_interface::v3::IoUringSocketInterface&>(
+      message, context.messageValidationContext().staticValidationVisitor());
+  io_uring_size_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, io_uring_size, DefaultIoUringSize);
+  read_buffer_size_ =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, read_buffer_size, DefaultReadBufferSize);
+  use_io_uring_ = IoUringImpl::isSupported();
+  if (!use_io_uring_) {
+    ENVOY_LOG_MISC(warn, "io_uring is not supported by the kernel, using the default sockets");
+  }
+  return Network::SocketInterfaceImpl::createBootstrapExtension(message, context);
+}
+
+ProtobufTypes::MessagePtr IoUringSocketInterface::createEmptyConfigProto() {
+  return std::make_unique<
+      envoy::extensions::network::socket_interface::v3::IoUringSocketInterface>();
+}
+
+REGISTER_FACTORY(IoUringSocketInterface, Server::Configuration::BootstrapExtensionFactory);
+
+} // namespace IoUring
+} // namespace IoSocket
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "common/network/socket_interface_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace IoSocket {
+namespace IoUring {
+
+/**
+ * Socket interface whose TCP sockets receive data through a per-dispatcher io_uring. When the
+ * kernel does not support io_uring it hands out the default socket handles.
+ */
+class IoUringSocketInterface : public Network::SocketInterfaceImpl {
+public:
+  // Server::Configuration::BootstrapExtensionFactory
+  Server::BootstrapExtensionPtr
+  createBootstrapExtension(const Protobuf::Message& config,
+                           Server::Configuration::ServerFactoryContext& context) override;
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override;
+  std::string name() const override {
+    return "envoy.extensions.network.socket_interface.io_uring_socket_interface";
+  };
+
+protected:
+  // Network::SocketInterfaceImpl
+  Network::IoHandlePtr makeSocket(int socket_fd, bool socket_v6only,
+                                  absl::optional<int> domain) const override;
+
+private:
+  bool use_io_uring_{false};
+  uint32_t io_uring_size_{DefaultIoUringSize};
+  uint32_t read_buffer_size_{DefaultReadBufferSize};
+
+  static constexpr uint32_t DefaultIoUringSize = 1024;
+  static constexpr uint32_t DefaultReadBufferSize = 16384;
+};
+
+DECLARE_FACTORY(IoUringSocketInterface);
+
+} // namespace IoUring
+} // namespace IoSocket
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,206 @@
+#include "extensions/io_socket/io_uring/io_uring.h"
+
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace IoSocket {
+namespace IoUring {
+
+namespace {
+
+int ioUringSetup(uint32_t entries, struct io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+  return static_cast<int>(
+      syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int fd, uint32_t opcode, const void* arg, uint32_t nr_args) {
+  return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+void* mapRing(int fd, size_t size, off_t offset) {
+  void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+  if (ptr == MAP_FAILED) {
+    throw EnvoyException(fmt::format("unable to map io_uring: {}", errorDetails(errno)));
+  }
+  return ptr;
+}
+
+template <class T> T* ringField(void* ring, uint32_t offset) {
+  return reinterpret_cast<T*>(static_cast<uint8_t*>(ring) + offset);
+}
+
+} // namespace
+
+bool IoUringImpl::isSupported() {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  const int fd = ioUringSetup(2, &params);
+  if (fd < 0) {
+    return false;
+  }
+  ::close(fd);
+  return true;
+}
+
+IoUringImpl::IoUringImpl(uint32_t entries) {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_ = ioUringSetup(entries, &params);
+  if (ring_fd_ < 0) {
+    throw EnvoyException(fmt::format("unable to set up io_uring: {}", errorDetails(errno)));
+  }
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    cq_ring_size_ = sq_ring_size_;
+  }
+  sq_ring_ptr_ = mapRing(ring_fd_, sq_ring_size_, IORING_OFF_SQ_RING);
+  cq_ring_ptr_ = (params.features & IORING_FEAT_SINGLE_MMAP)
+                     ? sq_ring_ptr_
+                     : mapRing(ring_fd_, cq_ring_size_, IORING_OFF_CQ_RING);
+  sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  sqes_ = static_cast<struct io_uring_sqe*>(mapRing(ring_fd_, sqes_size_, IORING_OFF_SQES));
+
+  sq_head_ = ringField<uint32_t>(sq_ring_ptr_, params.sq_off.head);
+  sq_tail_ = ringField<uint32_t>(sq_ring_ptr_, params.sq_off.tail);
+  sq_mask_ = *ringField<uint32_t>(sq_ring_ptr_, params.sq_off.ring_mask);
+  sq_entries_ = *ringField<uint32_t>(sq_ring_ptr_, params.sq_off.ring_entries);
+  cq_head_ = ringField<uint32_t>(cq_ring_ptr_, params.cq_off.head);
+  cq_tail_ = ringField<uint32_t>(cq_ring_ptr_, params.cq_off.tail);
+  cq_mask_ = *ringField<uint32_t>(cq_ring_ptr_, params.cq_off.ring_mask);
+  cqes_ = ringField<struct io_uring_cqe>(cq_ring_ptr_, params.cq_off.cqes);
+
+  // SQEs are always consumed in order, so the indirection array can be set up once as the
+  // identity mapping.
+  uint32_t* sq_array = ringField<uint32_t>(sq_ring_ptr_, params.sq_off.array);
+  for (uint32_t i = 0; i < sq_entries_; i++) {
+    sq_array[i] = i;
+  }
+  sqe_tail_ = submitted_tail_ = *sq_tail_;
+}
+
+IoUringImpl::~IoUringImpl() {
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ptr_ != nullptr && cq_ring_ptr_ != sq_ring_ptr_) {
+    munmap(cq_ring_ptr_, cq_ring_size_);
+  }
+  if (sq_ring_ptr_ != nullptr) {
+    munmap(sq_ring_ptr_, sq_ring_size_);
+  }
+  if (SOCKET_VALID(event_fd_)) {
+    ::close(event_fd_);
+  }
+  if (SOCKET_VALID(ring_fd_)) {
+    ::close(ring_fd_);
+  }
+}
+
+os_fd_t IoUringImpl::registerEventfd() {
+  ASSERT(!SOCKET_VALID(event_fd_));
+  event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  RELEASE_ASSERT(SOCKET_VALID(event_fd_),
+                 fmt::format("unable to create eventfd: {}", errorDetails(errno)));
+  const int rc = ioUringRegister(ring_fd_, IORING_REGISTER_EVENTFD, &event_fd_, 1);
+  RELEASE_ASSERT(rc == 0, fmt::format("unable to register eventfd: {}", errorDetails(errno)));
+  return event_fd_;
+}
+
+struct io_uring_sqe* IoUringImpl::getSqe() {
+  const uint32_t head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  if (sqe_tail_ - head >= sq_entries_) {
+    // The kernel has not consumed enough entries yet; publish what is queued and check again.
+    submit();
+    if (sqe_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+      return nullptr;
+    }
+  }
+  struct io_uring_sqe* sqe = &sqes_[sqe_tail_ & sq_mask_];
+  sqe_tail_++;
+  memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
+
+bool IoUringImpl::prepareReadv(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
+                               void* user_data) {
+  struct io_uring_sqe* sqe = getSqe();
+  if (sqe == nullptr) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_READV;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(iovecs);
+  sqe->len = nr_vecs;
+  sqe->user_data = reinterpret_cast<uint64_t>(user_data);
+  return true;
+}
+
+bool IoUringImpl::prepareCancel(void* target_user_data, void* user_data) {
+  struct io_uring_sqe* sqe = getSqe();
+  if (sqe == nullptr) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->fd = -1;
+  sqe->addr = reinterpret_cast<uint64_t>(target_user_data);
+  sqe->user_data = reinterpret_cast<uint64_t>(user_data);
+  return true;
+}
+
+Api::SysCallIntResult IoUringImpl::submit() {
+  const uint32_t to_submit = sqe_tail_ - submitted_tail_;
+  if (to_submit == 0) {
+    return {0, 0};
+  }
+  __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+  int rc;
+  do {
+    rc = ioUringEnter(ring_fd_, to_submit, 0, 0);
+  } while (rc < 0 && errno == EINTR);
+  if (rc < 0) {
+    // The entries stay published in the ring and will be picked up by the next submit().
+    return {rc, errno};
+  }
+  submitted_tail_ = sqe_tail_;
+  return {rc, 0};
+}
+
+void IoUringImpl::forEveryCompletion(const CompletionCb& completion_cb) {
+  uint32_t head = *cq_head_;
+  const uint32_t tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  while (head != tail) {
+    const struct io_uring_cqe& cqe = cqes_[head & cq_mask_];
+    void* user_data = reinterpret_cast<void*>(cqe.user_data);
+    const int32_t result = cqe.res;
+    head++;
+    // Release the entry before running the callback so that the callback may queue more work.
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    completion_cb(user_data, result);
+  }
+}
+
+} // namespace IoUring
+} // namespace IoSocket
+} // namespace Extensions
+} // namespace Envoy
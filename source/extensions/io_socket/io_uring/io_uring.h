@@ -0,0 +1,116 @@
+#pragma once
+
+#include <sys/uio.h>
+
+#include <cstdint>
+#include <functional>
+
+#include "envoy/api/os_sys_calls_common.h"
+#include "envoy/common/platform.h"
+
+#include "common/common/non_copyable.h"
+
+#include "linux/io_uring.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace IoSocket {
+namespace IoUring {
+
+/**
+ * Callback invoked for every completion reaped from the ring.
+ * @param user_data the value passed when the request was prepared.
+ * @param result the result of the operation: the non-negative return value of the equivalent
+ *        syscall on success, or a negated errno on failure.
+ */
+using CompletionCb = std::function<void(void* user_data, int32_t result)>;
+
+/**
+ * Thin wrapper around a kernel io_uring instance driven directly through the io_uring_setup(2),
+ * io_uring_enter(2) and io_uring_register(2) syscalls. Requests are only queued by the prepare*()
+ * methods; nothing is handed to the kernel until submit() is called, which lets callers batch all
+ * the requests made during one event loop iteration into a single syscall. Not thread safe.
+ */
+class IoUringImpl : NonCopyable {
+public:
+  /**
+   * @return whether io_uring can be used on this host.
+   */
+  static bool isSupported();
+
+  /**
+   * Set up a ring. Throws EnvoyException if the kernel refuses.
+   * @param entries the requested number of submission queue entries.
+   */
+  explicit IoUringImpl(uint32_t entries);
+  ~IoUringImpl();
+
+  /**
+   * Create an eventfd that becomes readable whenever completions are posted to the ring.
+   * @return the eventfd, owned by this ring.
+   */
+  os_fd_t registerEventfd();
+
+  /**
+   * Queue a readv(2) on fd.
+   * @return false if the submission queue is full even after flushing it.
+   */
+  bool prepareReadv(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs, void* user_data);
+
+  /**
+   * Queue cancellation of a previously prepared request.
+   * @param target_user_data the user_data of the request to cancel.
+   * @param user_data the user_data reported in the cancellation's own completion.
+   * @return false if the submission queue is full even after flushing it.
+   */
+  bool prepareCancel(void* target_user_data, void* user_data);
+
+  /**
+   * Hand all queued requests to the kernel.
+   */
+  Api::SysCallIntResult submit();
+
+  /**
+   * @return the number of requests queued but not yet submitted.
+   */
+  uint32_t pendingSubmissions() const { return sqe_tail_ - submitted_tail_; }
+
+  /**
+   * Reap all available completions.
+   */
+  void forEveryCompletion(const CompletionCb& completion_cb);
+
+private:
+  struct io_uring_sqe* getSqe();
+
+  os_fd_t ring_fd_{INVALID_SOCKET};
+  os_fd_t event_fd_{INVALID_SOCKET};
+
+  void* sq_ring_ptr_{nullptr};
+  size_t sq_ring_size_{0};
+  void* cq_ring_ptr_{nullptr};
+  size_t cq_ring_size_{0};
+  struct io_uring_sqe* sqes_{nullptr};
+  size_t sqes_size_{0};
+
+  // Pointers into the shared submission queue ring.
+  uint32_t* sq_head_;
+  uint32_t* sq_tail_;
+  uint32_t sq_mask_;
+  uint32_t sq_entries_;
+
+  // Pointers into the shared completion queue ring.
+  uint32_t* cq_head_;
+  uint32_t* cq_tail_;
+  uint32_t cq_mask_;
+  struct io_uring_cqe* cqes_;
+
+  // Local tail of prepared requests and the portion of it already published to the kernel.
+  uint32_t sqe_tail_{0};
+  uint32_t submitted_tail_{0};
+};
+
+} // namespace IoUring
+} // namespace IoSocket
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,340 @@
+#include "extensions/io_socket/io_uring/io_uring_socket_handle_impl.h"
+
+#include <algorithm>
+
+#include "envoy/api/os_sys_calls.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+#include "common/common/utility.h"
+#include "common/network/io_socket_error_impl.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace IoSocket {
+namespace IoUring {
+
+namespace {
+
+// Workers of the calling thread, indexed by the dispatcher they run on.
+using WorkerMap = absl::flat_hash_map<Event::Dispatcher*, std::weak_ptr<IoUringWorker>>;
+
+WorkerMap& threadWorkers() {
+  static thread_local WorkerMap workers;
+  return workers;
+}
+
+} // namespace
+
+IoUringWorker::IoUringWorker(Event::Dispatcher& dispatcher, uint32_t io_uring_size)
+    : dispatcher_(dispatcher), io_uring_(io_uring_size) {
+  const os_fd_t event_fd = io_uring_.registerEventfd();
+  completion_event_ = dispatcher_.createFileEvent(
+      event_fd,
+      [this, event_fd](uint32_t) {
+        uint64_t value;
+        struct iovec iov = {&value, sizeof(value)};
+        Api::OsSysCallsSingleton::get().readv(event_fd, &iov, 1);
+        onCompletionsReady();
+      },
+      Event::FileTriggerType::Level, Event::FileReadyType::Read);
+  submit_cb_ = dispatcher_.createSchedulableCallback([this]() {
+    const Api::SysCallIntResult result = io_uring_.submit();
+    if (result.rc_ < 0) {
+      // Typically EAGAIN or EBUSY while the kernel is short of resources or the completion queue
+      // is backed up; the queued entries are retried once completions have been reaped.
+      ENVOY_LOG(debug, "io_uring submit failed: {}", errorDetails(result.errno_));
+      submit_cb_->scheduleCallbackNextIteration();
+    }
+  });
+}
+
+IoUringWorker::~IoUringWorker() {
+  auto it = threadWorkers().find(&dispatcher_);
+  if (it != threadWorkers().end() && it->second.expired()) {
+    threadWorkers().erase(it);
+  }
+}
+
+IoUringWorkerSharedPtr IoUringWorker::getOrCreate(Event::Dispatcher& dispatcher,
+                                                  uint32_t io_uring_size) {
+  std::weak_ptr<IoUringWorker>& entry = threadWorkers()[&dispatcher];
+  IoUringWorkerSharedPtr worker = entry.lock();
+  if (worker == nullptr) {
+    worker = std::make_shared<IoUringWorker>(dispatcher, io_uring_size);
+    entry = worker;
+  }
+  return worker;
+}
+
+ReadRequest* IoUringWorker::submitRead(IoUringSocketHandleImpl& handle, os_fd_t fd,
+                                       uint64_t read_size) {
+  auto request = std::make_unique<ReadRequest>();
+  request->handle_ = &handle;
+  request->num_slices_ =
+      request->buffer_.reserve(read_size, request->slices_, ReadRequest::MaxSlices);
+  for (uint64_t i = 0; i < request->num_slices_; i++) {
+    request->iov_[i].iov_base = request->slices_[i].mem_;
+    request->iov_[i].iov_len = request->slices_[i].len_;
+  }
+  if (!io_uring_.prepareReadv(fd, request->iov_, request->num_slices_, request.get())) {
+    return nullptr;
+  }
+  requests_.push_front(std::move(request));
+  requests_.front()->entry_ = requests_.begin();
+  scheduleSubmit();
+  return requests_.front().get();
+}
+
+void IoUringWorker::cancelRead(ReadRequest& request) {
+  request.handle_ = nullptr;
+  // If the cancellation cannot be queued the read simply completes, or fails once the socket is
+  // shut down, and its result is discarded.
+  if (io_uring_.prepareCancel(&request, nullptr)) {
+    scheduleSubmit();
+  }
+}
+
+void IoUringWorker::scheduleSubmit() {
+  if (!submit_cb_->enabled()) {
+    submit_cb_->scheduleCallbackCurrentIteration();
+  }
+}
+
+void IoUringWorker::onCompletionsReady() {
+  // Handles run their callbacks from here and may release the last reference to the worker.
+  IoUringWorkerSharedPtr self = shared_from_this();
+  io_uring_.forEveryCompletion([this](void* user_data, int32_t result) {
+    if (user_data == nullptr) {
+      // Completion of a cancellation.
+      return;
+    }
+    auto* entry = static_cast<ReadRequest*>(user_data);
+    ReadRequestPtr request = std::move(*entry->entry_);
+    requests_.erase(entry->entry_);
+
+    uint64_t remaining = result > 0 ? result : 0;
+    for (uint64_t i = 0; i < request->num_slices_; i++) {
+      request->slices_[i].len_ = std::min<uint64_t>(request->slices_[i].len_, remaining);
+      remaining -= request->slices_[i].len_;
+    }
+    request->buffer_.commit(request->slices_, request->num_slices_);
+    if (request->handle_ != nullptr) {
+      request->handle_->onReadCompleted(request->buffer_, result);
+    }
+  });
+}
+
+IoUringSocketHandleImpl::IoUringSocketHandleImpl(uint32_t io_uring_size, uint32_t read_buffer_size,
+                                                 os_fd_t fd, bool socket_v6only,
+                                                 absl::optional<int> domain,
+                                                 bool is_connected_stream)
+    : IoSocketHandleImpl(fd, socket_v6only, domain), io_uring_size_(io_uring_size),
+      read_buffer_size_(read_buffer_size), is_connected_stream_(is_connected_stream) {}
+
+IoUringSocketHandleImpl::~IoUringSocketHandleImpl() {
+  if (SOCKET_VALID(fd_)) {
+    IoUringSocketHandleImpl::close();
+  }
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::close() {
+  cancelRead();
+  cb_ = nullptr;
+  worker_.reset();
+  return IoSocketHandleImpl::close();
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::readv(uint64_t max_length,
+                                                       Buffer::RawSlice* slices,
+                                                       uint64_t num_slice) {
+  if (!usingIoUring()) {
+    return IoSocketHandleImpl::readv(max_length, slices, num_slice);
+  }
+  uint64_t bytes = 0;
+  for (uint64_t i = 0; i < num_slice && bytes < max_length && read_buffer_.length() > 0; i++) {
+    const uint64_t to_copy =
+        std::min<uint64_t>({slices[i].len_, max_length - bytes, read_buffer_.length()});
+    read_buffer_.copyOut(0, to_copy, slices[i].mem_);
+    read_buffer_.drain(to_copy);
+    bytes += to_copy;
+  }
+  return bufferedReadResult(bytes);
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::read(Buffer::Instance& buffer,
+                                                      uint64_t max_length) {
+  if (!usingIoUring()) {
+    return IoSocketHandleImpl::read(buffer, max_length);
+  }
+  const uint64_t bytes = std::min<uint64_t>(max_length, read_buffer_.length());
+  buffer.move(read_buffer_, bytes);
+  return bufferedReadResult(bytes);
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::recv(void* buffer, size_t length, int flags) {
+  if (!usingIoUring()) {
+    return IoSocketHandleImpl::recv(buffer, length, flags);
+  }
+  const uint64_t bytes = std::min<uint64_t>(length, read_buffer_.length());
+  read_buffer_.copyOut(0, bytes, buffer);
+  if (!(flags & MSG_PEEK)) {
+    read_buffer_.drain(bytes);
+  }
+  return bufferedReadResult(bytes);
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::bufferedReadResult(uint64_t bytes) {
+  maybeSubmitRead();
+  if (bytes > 0 || read_eof_) {
+    return sysCallResultToIoCallResult(Api::SysCallSizeResult{static_cast<ssize_t>(bytes), 0});
+  }
+  if (read_error_ != 0) {
+    return sysCallResultToIoCallResult(Api::SysCallSizeResult{-1, read_error_});
+  }
+  return sysCallResultToIoCallResult(Api::SysCallSizeResult{-1, SOCKET_ERROR_AGAIN});
+}
+
+Network::IoHandlePtr IoUringSocketHandleImpl::accept(struct sockaddr* addr, socklen_t* addrlen) {
+  auto result = Api::OsSysCallsSingleton::get().accept(fd_, addr, addrlen);
+  if (SOCKET_INVALID(result.rc_)) {
+    return nullptr;
+  }
+
+  return std::make_unique<IoUringSocketHandleImpl>(io_uring_size_, read_buffer_size_, result.rc_,
+                                                   socket_v6only_, domain_, true);
+}
+
+bool IoUringSocketHandleImpl::isStreamSocket() {
+  if (is_connected_stream_) {
+    return true;
+  }
+  int type = 0;
+  socklen_t type_len = sizeof(type);
+  const Api::SysCallIntResult result = getOption(SOL_SOCKET, SO_TYPE, &type, &type_len);
+  return result.rc_ == 0 && type == SOCK_STREAM;
+}
+
+void IoUringSocketHandleImpl::initializeFileEvent(Event::Dispatcher& dispatcher,
+                                                  Event::FileReadyCb cb,
+                                                  Event::FileTriggerType trigger,
+                                                  uint32_t events) {
+  // Level-triggered users, which include listeners, expect readiness rather than data and keep
+  // using the event loop directly.
+  if (trigger != Event::FileTriggerType::Edge || !isStreamSocket()) {
+    IoSocketHandleImpl::initializeFileEvent(dispatcher, cb, trigger, events);
+    return;
+  }
+  ASSERT(file_event_ == nullptr, "Attempting to initialize two `file_event_` for the same "
+                                 "file descriptor. This is not allowed.");
+
+  if (worker_ != nullptr && &worker_->dispatcher() != &dispatcher) {
+    cancelRead();
+    worker_.reset();
+  }
+  if (worker_ == nullptr) {
+    worker_ = IoUringWorker::getOrCreate(dispatcher, io_uring_size_);
+  }
+  if (!is_connected_stream_) {
+    // Client sockets get their file event before connect() is called. Reading from them before
+    // the connection is established would fail, so reads wait for the first Write event.
+    sockaddr_storage ss;
+    socklen_t ss_len = sizeof(ss);
+    const Api::SysCallIntResult result = Api::OsSysCallsSingleton::get().getpeername(
+        fd_, reinterpret_cast<sockaddr*>(&ss), &ss_len);
+    connecting_ = result.rc_ != 0 && result.errno_ == ENOTCONN;
+  }
+
+  cb_ = cb;
+  enabled_events_ = events;
+  file_event_ = dispatcher.createFileEvent(
+      fd_, [this](uint32_t events) { onFileEvent(events); }, trigger,
+      events & ~Event::FileReadyType::Read);
+  if (events & Event::FileReadyType::Read) {
+    if (readReady()) {
+      file_event_->activate(Event::FileReadyType::Read);
+    } else {
+      maybeSubmitRead();
+    }
+  }
+}
+
+void IoUringSocketHandleImpl::enableFileEvents(uint32_t events) {
+  if (!usingIoUring()) {
+    IoSocketHandleImpl::enableFileEvents(events);
+    return;
+  }
+  enabled_events_ = events;
+  IoSocketHandleImpl::enableFileEvents(events & ~Event::FileReadyType::Read);
+  if (events & Event::FileReadyType::Read) {
+    if (readReady()) {
+      file_event_->activate(Event::FileReadyType::Read);
+    } else {
+      maybeSubmitRead();
+    }
+  }
+}
+
+void IoUringSocketHandleImpl::resetFileEvents() {
+  // An in-flight read stays queued and its data is buffered for the next file event owner, e.g.
+  // the connection created after listener filters have inspected the socket.
+  file_event_.reset();
+  cb_ = nullptr;
+  enabled_events_ = 0;
+}
+
+void IoUringSocketHandleImpl::onFileEvent(uint32_t events) {
+  if (connecting_ && (events & Event::FileReadyType::Write)) {
+    connecting_ = false;
+    maybeSubmitRead();
+  }
+  cb_(events);
+}
+
+void IoUringSocketHandleImpl::onReadCompleted(Buffer::Instance& data, int32_t result) {
+  read_request_ = nullptr;
+  if (result > 0) {
+    read_buffer_.move(data);
+  } else if (result == 0) {
+    read_eof_ = true;
+  } else if (-result != SOCKET_ERROR_AGAIN) {
+    read_error_ = -result;
+  }
+  // Keep the next read in flight while the consumer handles this one.
+  maybeSubmitRead();
+  if (cb_ != nullptr && (enabled_events_ & Event::FileReadyType::Read) && readReady()) {
+    cb_(Event::FileReadyType::Read);
+  }
+}
+
+void IoUringSocketHandleImpl::cancelRead() {
+  if (read_request_ != nullptr) {
+    worker_->cancelRead(*read_request_);
+    read_request_ = nullptr;
+  }
+}
+
+void IoUringSocketHandleImpl::maybeSubmitRead() {
+  // Data already buffered does not stop the next read, so that peeking consumers such as listener
+  // filters see more data arrive, but the buffer is bounded by the read size.
+  if (!usingIoUring() || connecting_ || read_request_ != nullptr || read_eof_ ||
+      read_error_ != 0 || read_buffer_.length() >= read_buffer_size_ ||
+      !(enabled_events_ & Event::FileReadyType::Read) || !SOCKET_VALID(fd_)) {
+    return;
+  }
+  read_request_ = worker_->submitRead(*this, fd_, read_buffer_size_);
+  if (read_request_ == nullptr) {
+    // The ring is saturated. Fall back to readiness notifications from the event loop for the rest
+    // of this socket's life.
+    ENVOY_LOG(debug, "io_uring submission queue full, falling back to epoll for fd {}", fd_);
+    worker_.reset();
+    IoSocketHandleImpl::enableFileEvents(enabled_events_);
+  }
+}
+
+} // namespace IoUring
+} // namespace IoSocket
+} // namespace Extensions
+} // namespace Envoy
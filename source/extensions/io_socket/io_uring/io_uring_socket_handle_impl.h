@@ -0,0 +1,155 @@
+#pragma once
+
+#include <sys/uio.h>
+
+#include <list>
+#include <memory>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/file_event.h"
+#include "envoy/event/schedulable_cb.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/logger.h"
+#include "common/network/io_socket_handle_impl.h"
+
+#include "extensions/io_socket/io_uring/io_uring.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace IoSocket {
+namespace IoUring {
+
+class IoUringSocketHandleImpl;
+
+/**
+ * An in-flight readv submitted on behalf of a socket handle. The request owns the memory the
+ * kernel reads into so that it remains valid if the handle is closed before the completion
+ * arrives.
+ */
+struct ReadRequest {
+  static constexpr uint64_t MaxSlices = 2;
+
+  // Null once the handle has been closed and the request cancelled.
+  IoUringSocketHandleImpl* handle_;
+  Buffer::OwnedImpl buffer_;
+  Buffer::RawSlice slices_[MaxSlices];
+  struct iovec iov_[MaxSlices];
+  uint64_t num_slices_{0};
+  std::list<std::unique_ptr<ReadRequest>>::iterator entry_;
+};
+using ReadRequestPtr = std::unique_ptr<ReadRequest>;
+
+/**
+ * A ring and its completion eventfd, bound to one dispatcher. All reads submitted during a
+ * dispatcher loop iteration are handed to the kernel with a single io_uring_enter(2) call at the
+ * end of the iteration. Completions are reaped when the eventfd becomes readable and dispatched to
+ * their handles.
+ */
+class IoUringWorker : public std::enable_shared_from_this<IoUringWorker>,
+                      Logger::Loggable<Logger::Id::io> {
+public:
+  IoUringWorker(Event::Dispatcher& dispatcher, uint32_t io_uring_size);
+  ~IoUringWorker();
+
+  /**
+   * @return the worker for the supplied dispatcher, creating it if needed. Workers are shared by
+   *         all handles using the dispatcher and live as long as any of them.
+   */
+  static std::shared_ptr<IoUringWorker> getOrCreate(Event::Dispatcher& dispatcher,
+                                                    uint32_t io_uring_size);
+
+  /**
+   * Queue a read of up to read_size bytes from fd on behalf of handle.
+   * @return the request, owned by the worker until its completion is reaped; nullptr if the
+   *         submission queue is full.
+   */
+  ReadRequest* submitRead(IoUringSocketHandleImpl& handle, os_fd_t fd, uint64_t read_size);
+
+  /**
+   * Detach a request from its handle and ask the kernel to cancel it.
+   */
+  void cancelRead(ReadRequest& request);
+
+  Event::Dispatcher& dispatcher() { return dispatcher_; }
+
+private:
+  void scheduleSubmit();
+  void onCompletionsReady();
+
+  Event::Dispatcher& dispatcher_;
+  // Declared before the ring so that the memory of in-flight reads outlives it.
+  std::list<ReadRequestPtr> requests_;
+  IoUringImpl io_uring_;
+  Event::FileEventPtr completion_event_;
+  Event::SchedulableCallbackPtr submit_cb_;
+};
+using IoUringWorkerSharedPtr = std::shared_ptr<IoUringWorker>;
+
+/**
+ * IoHandle for TCP sockets that receives data through an IoUringWorker. Reads are submitted to
+ * the ring while the Read event is enabled; completed data is buffered in the handle and handed
+ * out by read()/readv()/recv(), and the Read callback fires as each read completes. Sockets that
+ * are not edge-triggered streams (listeners and datagram sockets), and everything on the write
+ * side, use the plain socket syscalls of IoSocketHandleImpl.
+ */
+class IoUringSocketHandleImpl : public Network::IoSocketHandleImpl {
+public:
+  IoUringSocketHandleImpl(uint32_t io_uring_size, uint32_t read_buffer_size,
+                          os_fd_t fd = INVALID_SOCKET, bool socket_v6only = false,
+                          absl::optional<int> domain = absl::nullopt,
+                          bool is_connected_stream = false);
+  ~IoUringSocketHandleImpl() override;
+
+  // Network::IoHandle
+  Api::IoCallUint64Result close() override;
+  Api::IoCallUint64Result readv(uint64_t max_length, Buffer::RawSlice* slices,
+                                uint64_t num_slice) override;
+  Api::IoCallUint64Result read(Buffer::Instance& buffer, uint64_t max_length) override;
+  Api::IoCallUint64Result recv(void* buffer, size_t length, int flags) override;
+  Network::IoHandlePtr accept(struct sockaddr* addr, socklen_t* addrlen) override;
+  void initializeFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                           Event::FileTriggerType trigger, uint32_t events) override;
+  void enableFileEvents(uint32_t events) override;
+  void resetFileEvents() override;
+  // Received data may be held in the handle's read buffer, so the descriptor cannot be spliced.
+  bool supportsSplice() const override { return false; }
+
+  /**
+   * Called by the worker when a read submitted for this handle completes.
+   * @param data the bytes read, moved into the handle's read buffer.
+   * @param result the readv(2) result or a negated errno.
+   */
+  void onReadCompleted(Buffer::Instance& data, int32_t result);
+
+private:
+  bool usingIoUring() const { return worker_ != nullptr; }
+  bool readReady() const { return read_buffer_.length() > 0 || read_eof_ || read_error_ != 0; }
+  bool isStreamSocket();
+  void onFileEvent(uint32_t events);
+  void cancelRead();
+  void maybeSubmitRead();
+  // Returns the result of a read that consumed the given number of buffered bytes. If nothing was
+  // buffered, the stored EOF or error is returned, or EAGAIN and a new read is submitted.
+  Api::IoCallUint64Result bufferedReadResult(uint64_t bytes);
+
+  const uint32_t io_uring_size_;
+  const uint32_t read_buffer_size_;
+  // Known to be a connected TCP socket, e.g. because it was returned by accept().
+  const bool is_connected_stream_;
+  // connect() has not completed yet; reads are held back until the socket becomes writable.
+  bool connecting_{false};
+
+  IoUringWorkerSharedPtr worker_;
+  Event::FileReadyCb cb_;
+  uint32_t enabled_events_{0};
+  ReadRequest* read_request_{nullptr};
+  Buffer::OwnedImpl read_buffer_;
+  bool read_eof_{false};
+  int read_error_{0};
+};
+
+} // namespace IoUring
+} // namespace IoSocket
+} // namespace Extensions
+} // namespace Envoy
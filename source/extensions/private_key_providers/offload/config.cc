@@ -0,0 +1,34 @@
+#include "extensions/private_key_providers/offload/config.h"
+
+#include "envoy/extensions/private_key_providers/offload/v3/offload.pb.h"
+#include "envoy/extensions/private_key_providers/offload/v3/offload.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "common/protobuf/utility.h"
+
+#include "extensions/private_key_providers/offload/offload_private_key_method_provider.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Offload {
+
+Ssl::PrivateKeyMethodProviderSharedPtr
+OffloadPrivateKeyMethodFactory::createPrivateKeyMethodProviderInstance(
+    const envoy::extensions::transport_sockets::tls::v3::PrivateKeyProvider& config,
+    Server::Configuration::TransportSocketFactoryContext& factory_context) {
+  const auto offload_config = MessageUtil::anyConvertAndValidate<
+      envoy::extensions::private_key_providers::offload::v3::OffloadPrivateKeyMethodConfig>(
+      config.typed_config(), factory_context.messageValidationVisitor());
+  return std::make_shared<OffloadPrivateKeyMethodProvider>(offload_config, factory_context);
+}
+
+/**
+ * Static registration for the handshake offload private key provider. @see RegistryFactory.
+ */
+REGISTER_FACTORY(OffloadPrivateKeyMethodFactory, Ssl::PrivateKeyMethodProviderInstanceFactory);
+
+} // namespace Offload
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,44 @@
+#include "extensions/private_key_providers/offload/handshake_offload_pool.h"
+
+#include "common/common/lock_guard.h"
+#include "common/common/macros.h"
+#include "common/common/thread.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Offload {
+namespace {
+
+struct ProcessPool {
+  Thread::MutexBasicLockable mutex_;
+  std::weak_ptr<HandshakeOffloadPool> pool_ ABSL_GUARDED_BY(mutex_);
+};
+
+ProcessPool& processPool() { MUTABLE_CONSTRUCT_ON_FIRST_USE(ProcessPool); }
+
+} // namespace
+
+HandshakeOffloadPoolSharedPtr
+HandshakeOffloadPool::getOrCreate(Thread::ThreadFactory& thread_factory, uint32_t thread_count,
+                                  uint32_t max_queue_size) {
+  ProcessPool& process_pool = processPool();
+  Thread::LockGuard guard(process_pool.mutex_);
+  HandshakeOffloadPoolSharedPtr pool = process_pool.pool_.lock();
+  if (pool == nullptr) {
+    pool = std::make_shared<HandshakeOffloadPool>(thread_factory, thread_count, max_queue_size);
+    process_pool.pool_ = pool;
+  }
+  return pool;
+}
+
+HandshakeOffloadPoolSharedPtr HandshakeOffloadPool::get() {
+  ProcessPool& process_pool = processPool();
+  Thread::LockGuard guard(process_pool.mutex_);
+  return process_pool.pool_.lock();
+}
+
+} // namespace Offload
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/thread/thread.h"
+
+#include "common/common/bounded_thread_pool.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Offload {
+
+/**
+ * The threads that run the private key operations of the handshake offload providers. The pool of
+ * the process is created by the first provider and destroyed with the last one.
+ */
+class HandshakeOffloadPool : public BoundedThreadPool {
+public:
+  HandshakeOffloadPool(Thread::ThreadFactory& thread_factory, uint32_t thread_count,
+                       uint32_t max_queue_size)
+      : BoundedThreadPool(thread_factory, "handshake", thread_count, max_queue_size) {}
+
+  /**
+   * @return the pool of the process, creating it if there is none.
+   */
+  static std::shared_ptr<HandshakeOffloadPool> getOrCreate(Thread::ThreadFactory& thread_factory,
+                                                           uint32_t thread_count,
+                                                           uint32_t max_queue_size);
+
+  /**
+   * @return the pool of the process, or nullptr if no provider uses one.
+   */
+  static std::shared_ptr<HandshakeOffloadPool> get();
+};
+
+using HandshakeOffloadPoolSharedPtr = std::shared_ptr<HandshakeOffloadPool>;
+
+} // namespace Offload
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,145 @@
+#include "extensions/private_key_providers/offload/offload_private_key_method_provider.h"
+
+#include <chrono>
+
+#include "envoy/common/exception.h"
+
+#include "common/config/datasource.h"
+#include "common/protobuf/utility.h"
+
+#include "openssl/ec_key.h"
+#include "openssl/evp.h"
+#include "openssl/pem.h"
+#include "openssl/rsa.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Offload {
+namespace {
+
+using TransportSockets::Tls::PrivateKeyOperation;
+using TransportSockets::Tls::PrivateKeyOperationSharedPtr;
+
+bool sign(EVP_PKEY* pkey, uint16_t signature_algorithm, const std::vector<uint8_t>& in,
+          std::vector<uint8_t>& out) {
+  if (SSL_get_signature_algorithm_key_type(signature_algorithm) != EVP_PKEY_id(pkey)) {
+    return false;
+  }
+  bssl::ScopedEVP_MD_CTX ctx;
+  EVP_PKEY_CTX* pkey_ctx;
+  if (!EVP_DigestSignInit(ctx.get(), &pkey_ctx,
+                          SSL_get_signature_algorithm_digest(signature_algorithm), nullptr,
+                          pkey)) {
+    return false;
+  }
+  if (SSL_is_signature_algorithm_rsa_pss(signature_algorithm) &&
+      (!EVP_PKEY_CTX_set_rsa_padding(pkey_ctx, RSA_PKCS1_PSS_PADDING) ||
+       // The salt is as long as the digest.
+       !EVP_PKEY_CTX_set_rsa_pss_saltlen(pkey_ctx, -1))) {
+    return false;
+  }
+  size_t out_len;
+  if (!EVP_DigestSign(ctx.get(), nullptr, &out_len, in.data(), in.size())) {
+    return false;
+  }
+  out.resize(out_len);
+  if (!EVP_DigestSign(ctx.get(), out.data(), &out_len, in.data(), in.size())) {
+    return false;
+  }
+  out.resize(out_len);
+  return true;
+}
+
+// BoringSSL pads and checks the premaster secret of the RSA key exchange itself.
+bool decrypt(EVP_PKEY* pkey, const std::vector<uint8_t>& in, std::vector<uint8_t>& out) {
+  RSA* rsa = EVP_PKEY_get0_RSA(pkey);
+  if (rsa == nullptr) {
+    return false;
+  }
+  out.resize(RSA_size(rsa));
+  size_t out_len;
+  if (!RSA_decrypt(rsa, &out_len, out.data(), out.size(), in.data(), in.size(), RSA_NO_PADDING)) {
+    return false;
+  }
+  out.resize(out_len);
+  return true;
+}
+
+std::shared_ptr<OffloadBatchProcessor> createProcessor(
+    const envoy::extensions::private_key_providers::offload::v3::OffloadPrivateKeyMethodConfig&
+        config,
+    Server::Configuration::TransportSocketFactoryContext& factory_context) {
+  const std::string pem =
+      Config::DataSource::read(config.private_key(), false, factory_context.api());
+  bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(pem.data(), pem.size()));
+  bssl::UniquePtr<EVP_PKEY> pkey(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
+  if (pkey == nullptr) {
+    throw EnvoyException("Failed to load the private key of the handshake offload provider");
+  }
+  return std::make_shared<OffloadBatchProcessor>(
+      std::move(pkey),
+      HandshakeOffloadPool::getOrCreate(
+          factory_context.api().threadFactory(),
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, thread_count, 1),
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_queue_size, 1024)));
+}
+
+} // namespace
+
+OffloadBatchProcessor::OffloadBatchProcessor(bssl::UniquePtr<EVP_PKEY> pkey,
+                                             HandshakeOffloadPoolSharedPtr pool)
+    : pkey_(pkey.release(), EVP_PKEY_free), pool_(std::move(pool)) {}
+
+void OffloadBatchProcessor::processBatch(const std::vector<PrivateKeyOperationSharedPtr>& batch,
+                                         std::function<void()> done) {
+  // The task does not hold the processor, so that the pool is never destroyed by its own threads.
+  auto task = [pkey = pkey_, batch, done]() {
+    for (const PrivateKeyOperationSharedPtr& operation : batch) {
+      run(pkey.get(), *operation);
+    }
+    done();
+  };
+  if (!pool_->post(task)) {
+    task();
+  }
+}
+
+void OffloadBatchProcessor::run(EVP_PKEY* pkey, PrivateKeyOperation& operation) {
+  operation.succeeded_ =
+      operation.type_ == PrivateKeyOperation::Type::Sign
+          ? sign(pkey, operation.signature_algorithm_, operation.input_, operation.output_)
+          : decrypt(pkey, operation.input_, operation.output_);
+  if (!operation.succeeded_) {
+    operation.output_.clear();
+  }
+}
+
+OffloadPrivateKeyMethodProvider::OffloadPrivateKeyMethodProvider(
+    const envoy::extensions::private_key_providers::offload::v3::OffloadPrivateKeyMethodConfig&
+        config,
+    Server::Configuration::TransportSocketFactoryContext& factory_context)
+    : OffloadPrivateKeyMethodProvider(createProcessor(config, factory_context),
+                                      factory_context.threadLocal()) {}
+
+OffloadPrivateKeyMethodProvider::OffloadPrivateKeyMethodProvider(
+    std::shared_ptr<OffloadBatchProcessor> processor, ThreadLocal::SlotAllocator& tls)
+    : BatchedPrivateKeyMethodProvider(processor, tls, 1, std::chrono::microseconds::zero()),
+      processor_(std::move(processor)) {}
+
+bool OffloadPrivateKeyMethodProvider::checkFips() {
+  EVP_PKEY* pkey = processor_->pkey();
+  switch (EVP_PKEY_id(pkey)) {
+  case EVP_PKEY_RSA:
+    return RSA_check_fips(EVP_PKEY_get0_RSA(pkey));
+  case EVP_PKEY_EC:
+    return EC_KEY_check_fips(EVP_PKEY_get0_EC_KEY(pkey));
+  default:
+    return false;
+  }
+}
+
+} // namespace Offload
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
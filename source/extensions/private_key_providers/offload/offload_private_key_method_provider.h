@@ -0,0 +1,71 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "envoy/extensions/private_key_providers/offload/v3/offload.pb.h"
+#include "envoy/server/transport_socket_config.h"
+
+#include "extensions/private_key_providers/offload/handshake_offload_pool.h"
+#include "extensions/transport_sockets/tls/private_key/batched_private_key_method_provider.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Offload {
+
+/**
+ * Runs the private key operations on the handshake offload pool, or on the worker once the queue
+ * of the pool is full.
+ */
+class OffloadBatchProcessor : public TransportSockets::Tls::PrivateKeyBatchProcessor {
+public:
+  OffloadBatchProcessor(bssl::UniquePtr<EVP_PKEY> pkey, HandshakeOffloadPoolSharedPtr pool);
+
+  // TransportSockets::Tls::PrivateKeyBatchProcessor
+  void processBatch(const std::vector<TransportSockets::Tls::PrivateKeyOperationSharedPtr>& batch,
+                    std::function<void()> done) override;
+
+  /**
+   * Signs or decrypts with the private key, setting the outcome and output of the operation.
+   */
+  static void run(EVP_PKEY* pkey, TransportSockets::Tls::PrivateKeyOperation& operation);
+
+  EVP_PKEY* pkey() const { return pkey_.get(); }
+
+private:
+  // Shared with the queued tasks, which may run after the processor is destroyed.
+  const std::shared_ptr<EVP_PKEY> pkey_;
+  const HandshakeOffloadPoolSharedPtr pool_;
+};
+
+/**
+ * A private key method provider that signs and decrypts on the handshake offload pool, so that
+ * full handshakes do not stall the workers. The operations are handed over to the pool one at a
+ * time, as soon as the handshake starts them.
+ */
+class OffloadPrivateKeyMethodProvider
+    : public TransportSockets::Tls::BatchedPrivateKeyMethodProvider {
+public:
+  OffloadPrivateKeyMethodProvider(
+      const envoy::extensions::private_key_providers::offload::v3::OffloadPrivateKeyMethodConfig&
+          config,
+      Server::Configuration::TransportSocketFactoryContext& factory_context);
+
+  // Ssl::PrivateKeyMethodProvider
+  bool checkFips() override;
+
+private:
+  OffloadPrivateKeyMethodProvider(std::shared_ptr<OffloadBatchProcessor> processor,
+                                  ThreadLocal::SlotAllocator& tls);
+
+  const std::shared_ptr<OffloadBatchProcessor> processor_;
+};
+
+} // namespace Offload
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -68,7 +68,7 @@ ActiveQuicListener::ActiveQuicListener(
   quic_dispatcher_ = std::make_unique<EnvoyQuicDispatcher>(
       crypto_config_.get(), quic_config, &version_manager_, std::move(connection_helper),
       std::move(alarm_factory), quic::kQuicDefaultConnectionIdLength, parent, *config_, stats_,
-      per_worker_stats_, dispatcher, listen_socket_);
+      per_worker_stats_, dispatcher, listen_socket_, worker_index, concurrency);
 
   // Create udp_packet_writer
   Network::UdpPacketWriterPtr udp_packet_writer =
@@ -171,6 +171,9 @@ uint32_t ActiveQuicListener::destination(const Network::UdpRecvData& data) const
   // connection will add its connection ID to the table on the current worker, and so packets should
   // be delivered to the correct worker by the kernel unless the client changes address.
 
+  // Connection IDs chosen by this worker to replace the client's encode the worker index in the
+  // bits read below, see EnvoyQuicDispatcher::GenerateNewServerConnectionId().
+
   // This is a re-implementation of the same algorithm written in BPF in
   // ``ActiveQuicListenerFactory::createActiveUdpListener``
   const uint64_t packet_length = data.buffer_->length();
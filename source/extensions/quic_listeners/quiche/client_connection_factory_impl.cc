@@ -0,0 +1,91 @@
+#include "extensions/quic_listeners/quiche/client_connection_factory_impl.h"
+
+#include "common/network/utility.h"
+
+#include "extensions/quic_listeners/quiche/envoy_quic_proof_verifier.h"
+#include "extensions/quic_listeners/quiche/envoy_quic_session_cache.h"
+#include "extensions/quic_listeners/quiche/quic_transport_socket_factory.h"
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include "quiche/quic/core/quic_utils.h"
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace Envoy {
+namespace Quic {
+
+namespace {
+
+const Ssl::ClientContextConfig&
+clientContextConfig(Network::TransportSocketFactory& transport_socket_factory) {
+  // The cluster only accepts HTTP/3 over the QUIC transport socket.
+  auto* factory = dynamic_cast<QuicClientTransportSocketFactory*>(&transport_socket_factory);
+  ASSERT(factory != nullptr);
+  return factory->clientContextConfig();
+}
+
+quic::QuicServerId serverId(const Ssl::ClientContextConfig& config,
+                            const Network::Address::Instance& server_addr) {
+  const std::string& sni = config.serverNameIndication();
+  return {sni.empty() ? server_addr.ip()->addressAsString() : sni,
+          static_cast<uint16_t>(server_addr.ip()->port()), false};
+}
+
+} // namespace
+
+PersistentQuicInfoImpl::PersistentQuicInfoImpl(
+    Event::Dispatcher& dispatcher, Network::TransportSocketFactory& transport_socket_factory,
+    Stats::Scope& stats_scope, TimeSource& time_source,
+    Network::Address::InstanceConstSharedPtr server_addr, uint32_t buffer_limit,
+    bool allow_early_data)
+    : conn_helper_(dispatcher), alarm_factory_(dispatcher, *conn_helper_.GetClock()),
+      server_id_(serverId(clientContextConfig(transport_socket_factory), *server_addr)),
+      supported_versions_(quic::CurrentSupportedVersions()),
+      crypto_config_(std::make_unique<quic::QuicCryptoClientConfig>(
+          std::make_unique<EnvoyQuicProofVerifier>(
+              stats_scope, clientContextConfig(transport_socket_factory), time_source),
+          std::make_unique<EnvoyQuicSessionCache>(time_source))),
+      buffer_limit_(buffer_limit), allow_early_data_(allow_early_data) {}
+
+Http::PersistentQuicInfoPtr QuicClientConnectionFactoryImpl::createNetworkConnectionInfo(
+    Event::Dispatcher& dispatcher, Network::TransportSocketFactory& transport_socket_factory,
+    Stats::Scope& stats_scope, TimeSource& time_source,
+    Network::Address::InstanceConstSharedPtr server_addr, uint32_t buffer_limit,
+    bool allow_early_data) {
+  return std::make_unique<PersistentQuicInfoImpl>(dispatcher, transport_socket_factory,
+                                                  stats_scope, time_source, server_addr,
+                                                  buffer_limit, allow_early_data);
+}
+
+Network::ClientConnectionPtr QuicClientConnectionFactoryImpl::createQuicNetworkConnection(
+    Http::PersistentQuicInfo& info, Event::Dispatcher& dispatcher,
+    Network::Address::InstanceConstSharedPtr server_addr,
+    Network::Address::InstanceConstSharedPtr local_addr) {
+  auto& quic_info = static_cast<PersistentQuicInfoImpl&>(info);
+  if (local_addr == nullptr) {
+    // The UDP socket of the connection is always bound.
+    local_addr = server_addr->ip()->version() == Network::Address::IpVersion::v4
+                     ? Network::Utility::getIpv4AnyAddress()
+                     : Network::Utility::getIpv6AnyAddress();
+  }
+  auto connection = std::make_unique<EnvoyQuicClientConnection>(
+      quic::QuicUtils::CreateRandomConnectionId(), server_addr, quic_info.conn_helper_,
+      quic_info.alarm_factory_, quic_info.supported_versions_, local_addr, dispatcher, nullptr);
+  auto session = std::make_unique<EnvoyQuicClientSession>(
+      quic_info.quic_config_, quic_info.supported_versions_, std::move(connection),
+      quic_info.server_id_, quic_info.crypto_config_.get(), &quic_info.push_promise_index_,
+      dispatcher, quic_info.buffer_limit_, quic_info.allow_early_data_);
+  session->Initialize();
+  return session;
+}
+
+REGISTER_FACTORY(QuicClientConnectionFactoryImpl, Http::QuicClientConnectionFactory);
+
+} // namespace Quic
+} // namespace Envoy
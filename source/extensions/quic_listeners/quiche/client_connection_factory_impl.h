@@ -0,0 +1,70 @@
+#pragma once
+
+#include "envoy/registry/registry.h"
+
+#include "common/http/http3/quic_client_connection_factory.h"
+#include "common/http/http3/well_known_names.h"
+
+#include "extensions/quic_listeners/quiche/envoy_quic_alarm_factory.h"
+#include "extensions/quic_listeners/quiche/envoy_quic_client_session.h"
+#include "extensions/quic_listeners/quiche/envoy_quic_connection_helper.h"
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include "quiche/quic/core/crypto/quic_crypto_client_config.h"
+#include "quiche/quic/core/http/quic_client_push_promise_index.h"
+#include "quiche/quic/core/quic_config.h"
+#include "quiche/quic/core/quic_server_id.h"
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace Envoy {
+namespace Quic {
+
+// What the QUIC connections to an upstream server share. The crypto config caches the sessions
+// the server sent, so that a new connection resumes one with 0-RTT.
+struct PersistentQuicInfoImpl : public Http::PersistentQuicInfo {
+  PersistentQuicInfoImpl(Event::Dispatcher& dispatcher,
+                         Network::TransportSocketFactory& transport_socket_factory,
+                         Stats::Scope& stats_scope, TimeSource& time_source,
+                         Network::Address::InstanceConstSharedPtr server_addr,
+                         uint32_t buffer_limit, bool allow_early_data);
+
+  EnvoyQuicConnectionHelper conn_helper_;
+  EnvoyQuicAlarmFactory alarm_factory_;
+  quic::QuicServerId server_id_;
+  quic::ParsedQuicVersionVector supported_versions_;
+  std::unique_ptr<quic::QuicCryptoClientConfig> crypto_config_;
+  quic::QuicConfig quic_config_;
+  quic::QuicClientPushPromiseIndex push_promise_index_;
+  const uint32_t buffer_limit_;
+  const bool allow_early_data_;
+};
+
+// A factory to create the upstream QUIC connections as EnvoyQuicClientSession instances.
+class QuicClientConnectionFactoryImpl : public Http::QuicClientConnectionFactory {
+public:
+  // Http::QuicClientConnectionFactory
+  Http::PersistentQuicInfoPtr
+  createNetworkConnectionInfo(Event::Dispatcher& dispatcher,
+                              Network::TransportSocketFactory& transport_socket_factory,
+                              Stats::Scope& stats_scope, TimeSource& time_source,
+                              Network::Address::InstanceConstSharedPtr server_addr,
+                              uint32_t buffer_limit, bool allow_early_data) override;
+  Network::ClientConnectionPtr
+  createQuicNetworkConnection(Http::PersistentQuicInfo& info, Event::Dispatcher& dispatcher,
+                              Network::Address::InstanceConstSharedPtr server_addr,
+                              Network::Address::InstanceConstSharedPtr local_addr) override;
+
+  std::string name() const override { return Http::QuicCodecNames::get().Quiche; }
+};
+
+DECLARE_FACTORY(QuicClientConnectionFactoryImpl);
+
+} // namespace Quic
+} // namespace Envoy
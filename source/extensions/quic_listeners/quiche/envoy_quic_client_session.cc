@@ -10,10 +10,11 @@ EnvoyQuicClientSession::EnvoyQuicClientSession(
     std::unique_ptr<EnvoyQuicClientConnection> connection, const quic::QuicServerId& server_id,
     quic::QuicCryptoClientConfig* crypto_config,
     quic::QuicClientPushPromiseIndex* push_promise_index, Event::Dispatcher& dispatcher,
-    uint32_t send_buffer_limit)
+    uint32_t send_buffer_limit, bool allow_early_data)
     : QuicFilterManagerConnectionImpl(*connection, dispatcher, send_buffer_limit),
       quic::QuicSpdyClientSession(config, supported_versions, connection.release(), server_id,
-                                  crypto_config, push_promise_index) {}
+                                  crypto_config, push_promise_index),
+      allow_early_data_(allow_early_data) {}
 
 EnvoyQuicClientSession::~EnvoyQuicClientSession() {
   ASSERT(!connection()->connected());
@@ -75,9 +76,12 @@ void EnvoyQuicClientSession::OnHttp3GoAway(uint64_t stream_id) {
 
 void EnvoyQuicClientSession::SetDefaultEncryptionLevel(quic::EncryptionLevel level) {
   quic::QuicSpdyClientSession::SetDefaultEncryptionLevel(level);
-  if (level == quic::ENCRYPTION_FORWARD_SECURE) {
-    // This is only reached once, when handshake is done.
-    raiseConnectionEvent(Network::ConnectionEvent::Connected);
+  if ((level == quic::ENCRYPTION_ZERO_RTT && allow_early_data_) ||
+      level == quic::ENCRYPTION_FORWARD_SECURE) {
+    // With a resumed session and early data allowed, the requests go out as early data before the
+    // handshake is done. Should the server reject it, QUICHE retransmits them once the handshake is
+    // done.
+    onConnected();
   }
 }
 
@@ -99,8 +103,13 @@ EnvoyQuicClientSession::CreateIncomingStream(quic::PendingStream* /*pending*/) {
 
 bool EnvoyQuicClientSession::hasDataToWrite() { return HasDataToWrite(); }
 
-void EnvoyQuicClientSession::OnTlsHandshakeComplete() {
-  raiseConnectionEvent(Network::ConnectionEvent::Connected);
+void EnvoyQuicClientSession::OnTlsHandshakeComplete() { onConnected(); }
+
+void EnvoyQuicClientSession::onConnected() {
+  if (!connected_) {
+    connected_ = true;
+    raiseConnectionEvent(Network::ConnectionEvent::Connected);
+  }
 }
 
 } // namespace Quic
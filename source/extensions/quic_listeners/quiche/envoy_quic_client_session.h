@@ -35,7 +35,8 @@ public:
                          const quic::QuicServerId& server_id,
                          quic::QuicCryptoClientConfig* crypto_config,
                          quic::QuicClientPushPromiseIndex* push_promise_index,
-                         Event::Dispatcher& dispatcher, uint32_t send_buffer_limit);
+                         Event::Dispatcher& dispatcher, uint32_t send_buffer_limit,
+                         bool allow_early_data);
 
   ~EnvoyQuicClientSession() override;
 
@@ -75,9 +76,16 @@ protected:
   bool hasDataToWrite() override;
 
 private:
+  void onConnected();
+
   // These callbacks are owned by network filters and quic session should outlive
   // them.
   Http::ConnectionCallbacks* http_connection_callbacks_{nullptr};
+  // Whether Connected is raised once 0-RTT keys are available, so that requests are sent as early
+  // data, rather than once the handshake is complete.
+  const bool allow_early_data_;
+  // Whether Connected was raised.
+  bool connected_{false};
 };
 
 } // namespace Quic
@@ -157,17 +157,10 @@ void EnvoyQuicClientStream::OnBodyAvailable() {
   // TODO(danzh): check Envoy per stream buffer limit.
   // Currently read out all the data.
   while (HasBytesToRead()) {
-    iovec iov;
-    int num_regions = GetReadableRegions(&iov, 1);
+    iovec iovs[MaxReadableRegionsPerCopy];
+    int num_regions = GetReadableRegions(iovs, MaxReadableRegionsPerCopy);
     ASSERT(num_regions > 0);
-    size_t bytes_read = iov.iov_len;
-    Buffer::RawSlice slice;
-    buffer->reserve(bytes_read, &slice, 1);
-    ASSERT(slice.len_ >= bytes_read);
-    slice.len_ = bytes_read;
-    memcpy(slice.mem_, iov.iov_base, iov.iov_len);
-    buffer->commit(&slice, 1);
-    MarkConsumed(bytes_read);
+    MarkConsumed(copyReadableRegions(iovs, num_regions, *buffer));
   }
   ASSERT(buffer->length() == 0 || !end_stream_decoded_);
 
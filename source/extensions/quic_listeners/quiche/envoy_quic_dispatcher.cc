@@ -4,6 +4,7 @@
 
 #include "extensions/quic_listeners/quiche/envoy_quic_server_connection.h"
 #include "extensions/quic_listeners/quiche/envoy_quic_server_session.h"
+#include "extensions/quic_listeners/quiche/envoy_quic_utils.h"
 
 namespace Envoy {
 namespace Quic {
@@ -16,13 +17,13 @@ EnvoyQuicDispatcher::EnvoyQuicDispatcher(
     uint8_t expected_server_connection_id_length, Network::ConnectionHandler& connection_handler,
     Network::ListenerConfig& listener_config, Server::ListenerStats& listener_stats,
     Server::PerHandlerListenerStats& per_worker_stats, Event::Dispatcher& dispatcher,
-    Network::Socket& listen_socket)
+    Network::Socket& listen_socket, uint32_t worker_index, uint32_t concurrency)
     : quic::QuicDispatcher(&quic_config, crypto_config, version_manager, std::move(helper),
                            std::make_unique<EnvoyQuicCryptoServerStreamHelper>(),
                            std::move(alarm_factory), expected_server_connection_id_length),
       connection_handler_(connection_handler), listener_config_(listener_config),
       listener_stats_(listener_stats), per_worker_stats_(per_worker_stats), dispatcher_(dispatcher),
-      listen_socket_(listen_socket) {
+      listen_socket_(listen_socket), worker_index_(worker_index), concurrency_(concurrency) {
   // Set send buffer twice of max flow control window to ensure that stream send
   // buffer always takes all the data.
   // The max amount of data buffered is the per-stream high watermark + the max
@@ -73,5 +74,14 @@ std::unique_ptr<quic::QuicSession> EnvoyQuicDispatcher::CreateQuicSession(
   return quic_session;
 }
 
+quic::QuicConnectionId
+EnvoyQuicDispatcher::GenerateNewServerConnectionId(quic::ParsedQuicVersion version,
+                                                   quic::QuicConnectionId connection_id) const {
+  quic::QuicConnectionId new_connection_id =
+      quic::QuicDispatcher::GenerateNewServerConnectionId(version, connection_id);
+  adjustNewConnectionIdForRouting(new_connection_id, worker_index_, concurrency_);
+  return new_connection_id;
+}
+
 } // namespace Quic
 } // namespace Envoy
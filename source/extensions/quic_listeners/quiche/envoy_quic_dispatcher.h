@@ -52,7 +52,8 @@ public:
                       Network::ListenerConfig& listener_config,
                       Server::ListenerStats& listener_stats,
                       Server::PerHandlerListenerStats& per_worker_stats,
-                      Event::Dispatcher& dispatcher, Network::Socket& listen_socket);
+                      Event::Dispatcher& dispatcher, Network::Socket& listen_socket,
+                      uint32_t worker_index, uint32_t concurrency);
 
   void OnConnectionClosed(quic::QuicConnectionId connection_id, quic::QuicErrorCode error,
                           const std::string& error_details,
@@ -64,6 +65,11 @@ protected:
                     const quic::QuicSocketAddress& self_address,
                     const quic::QuicSocketAddress& peer_address, absl::string_view alpn,
                     const quic::ParsedQuicVersion& version) override;
+  // Encodes the worker index into connection ids replacing the ones chosen by clients, so that
+  // packets of the connection keep being routed to this worker.
+  quic::QuicConnectionId
+  GenerateNewServerConnectionId(quic::ParsedQuicVersion version,
+                                quic::QuicConnectionId connection_id) const override;
 
 private:
   Network::ConnectionHandler& connection_handler_;
@@ -72,6 +78,8 @@ private:
   Server::PerHandlerListenerStats& per_worker_stats_;
   Event::Dispatcher& dispatcher_;
   Network::Socket& listen_socket_;
+  const uint32_t worker_index_;
+  const uint32_t concurrency_;
 };
 
 } // namespace Quic
@@ -0,0 +1,89 @@
+#include "extensions/quic_listeners/quiche/envoy_quic_session_cache.h"
+
+#include <chrono>
+
+namespace Envoy {
+namespace Quic {
+
+void EnvoyQuicSessionCache::Insert(const quic::QuicServerId& server_id,
+                                   bssl::UniquePtr<SSL_SESSION> session,
+                                   const quic::TransportParameters& params,
+                                   const quic::ApplicationState* application_state) {
+  auto it = cache_.find(server_id);
+  if (it == cache_.end()) {
+    if (cache_.size() >= MaxEntries) {
+      cache_.erase(cache_.begin());
+    }
+    it = cache_.emplace(server_id, Entry()).first;
+  }
+  Entry& entry = it->second;
+  const bool same_state =
+      entry.params_ != nullptr && *entry.params_ == params &&
+      (entry.application_state_ == nullptr
+           ? application_state == nullptr
+           : application_state != nullptr && *entry.application_state_ == *application_state);
+  if (!same_state) {
+    // The sessions of the previous connection were negotiated with other parameters.
+    entry = Entry();
+    entry.params_ = std::make_unique<quic::TransportParameters>(params);
+    if (application_state != nullptr) {
+      entry.application_state_ = std::make_unique<quic::ApplicationState>(*application_state);
+    }
+  }
+  entry.pushSession(std::move(session));
+}
+
+std::unique_ptr<quic::QuicResumptionState>
+EnvoyQuicSessionCache::Lookup(const quic::QuicServerId& server_id, const SSL_CTX*) {
+  auto it = cache_.find(server_id);
+  if (it == cache_.end()) {
+    return nullptr;
+  }
+  Entry& entry = it->second;
+  if (!isValid(entry.peekSession())) {
+    cache_.erase(it);
+    return nullptr;
+  }
+  auto state = std::make_unique<quic::QuicResumptionState>();
+  state->tls_session = entry.popSession();
+  state->transport_params = entry.params_.get();
+  state->application_state = entry.application_state_.get();
+  return state;
+}
+
+void EnvoyQuicSessionCache::ClearEarlyData(const quic::QuicServerId& server_id) {
+  auto it = cache_.find(server_id);
+  if (it == cache_.end()) {
+    return;
+  }
+  for (bssl::UniquePtr<SSL_SESSION>& session : it->second.sessions_) {
+    if (session != nullptr) {
+      session.reset(SSL_SESSION_copy_without_early_data(session.get()));
+    }
+  }
+}
+
+bool EnvoyQuicSessionCache::isValid(SSL_SESSION* session) const {
+  if (session == nullptr) {
+    return false;
+  }
+  const uint64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+                           time_source_.systemTime().time_since_epoch())
+                           .count();
+  const uint64_t time = SSL_SESSION_get_time(session);
+  return time <= now && now < time + SSL_SESSION_get_timeout(session);
+}
+
+void EnvoyQuicSessionCache::Entry::pushSession(bssl::UniquePtr<SSL_SESSION> session) {
+  sessions_[1] = std::move(sessions_[0]);
+  sessions_[0] = std::move(session);
+}
+
+bssl::UniquePtr<SSL_SESSION> EnvoyQuicSessionCache::Entry::popSession() {
+  bssl::UniquePtr<SSL_SESSION> session = std::move(sessions_[0]);
+  sessions_[0] = std::move(sessions_[1]);
+  return session;
+}
+
+} // namespace Quic
+} // namespace Envoy
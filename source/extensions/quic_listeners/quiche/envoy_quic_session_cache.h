@@ -0,0 +1,74 @@
+#pragma once
+
+#include <map>
+#include <memory>
+
+#include "envoy/common/time.h"
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include "quiche/quic/core/crypto/quic_crypto_client_config.h"
+#include "quiche/quic/core/crypto/transport_parameters.h"
+#include "quiche/quic/core/quic_server_id.h"
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Quic {
+
+// A quic::SessionCache implementation which keeps the TLS sessions of the QUIC connections to the
+// upstream servers, with the transport parameters and the application state 0-RTT needs, so that
+// the next connections to a server resume its session with 0-RTT.
+//
+// A session is used once, as TLS 1.3 tickets should be, and is dropped once its ticket expires.
+class EnvoyQuicSessionCache : public quic::SessionCache {
+public:
+  // The number of servers whose sessions are kept. Beyond, the sessions of the server which comes
+  // first are dropped.
+  static constexpr size_t MaxEntries = 1024;
+
+  explicit EnvoyQuicSessionCache(TimeSource& time_source) : time_source_(time_source) {}
+  ~EnvoyQuicSessionCache() override = default;
+
+  // quic::SessionCache
+  void Insert(const quic::QuicServerId& server_id, bssl::UniquePtr<SSL_SESSION> session,
+              const quic::TransportParameters& params,
+              const quic::ApplicationState* application_state) override;
+  std::unique_ptr<quic::QuicResumptionState> Lookup(const quic::QuicServerId& server_id,
+                                                    const SSL_CTX* ctx) override;
+  void ClearEarlyData(const quic::QuicServerId& server_id) override;
+
+  // @return the number of servers which have sessions in the cache.
+  size_t size() const { return cache_.size(); }
+
+private:
+  // The sessions of a server, with the transport parameters and the application state of the
+  // connection they come from. The parameters and the state are only replaced by a session of
+  // another connection which had different ones, as the resumption states returned by Lookup()
+  // point to them.
+  struct Entry {
+    // Keeps the two most recent sessions, as a server usually sends two tickets at once.
+    void pushSession(bssl::UniquePtr<SSL_SESSION> session);
+    bssl::UniquePtr<SSL_SESSION> popSession();
+    SSL_SESSION* peekSession() const { return sessions_[0].get(); }
+
+    bssl::UniquePtr<SSL_SESSION> sessions_[2];
+    std::unique_ptr<quic::TransportParameters> params_;
+    std::unique_ptr<quic::ApplicationState> application_state_;
+  };
+
+  bool isValid(SSL_SESSION* session) const;
+
+  TimeSource& time_source_;
+  std::map<quic::QuicServerId, Entry> cache_;
+};
+
+} // namespace Quic
+} // namespace Envoy
@@ -1,5 +1,8 @@
 #include "extensions/quic_listeners/quiche/envoy_quic_utils.h"
 
+#include <cstring>
+#include <limits>
+
 #include "envoy/common/platform.h"
 #include "envoy/config/core/v3/base.pb.h"
 
@@ -158,6 +161,46 @@ bssl::UniquePtr<X509> parseDERCertificate(const std::string& der_bytes,
   return cert;
 }
 
+void adjustNewConnectionIdForRouting(quic::QuicConnectionId& new_connection_id,
+                                     uint32_t worker_index, uint32_t concurrency) {
+  ASSERT(worker_index < concurrency);
+  uint32_t connection_id_snippet;
+  if (concurrency <= 1 || new_connection_id.length() < sizeof(connection_id_snippet)) {
+    return;
+  }
+  memcpy(&connection_id_snippet, new_connection_id.data(), sizeof(connection_id_snippet));
+  connection_id_snippet = ntohl(connection_id_snippet);
+  // Replace the remainder modulo concurrency with the worker index, stepping down a multiple of
+  // concurrency if that would overflow.
+  uint32_t base = connection_id_snippet - connection_id_snippet % concurrency;
+  if (base > std::numeric_limits<uint32_t>::max() - (concurrency - 1)) {
+    base -= concurrency;
+  }
+  connection_id_snippet = htonl(base + worker_index);
+  memcpy(new_connection_id.mutable_data(), &connection_id_snippet, sizeof(connection_id_snippet));
+}
+
+uint64_t copyReadableRegions(const iovec* regions, int num_regions, Buffer::Instance& buffer) {
+  uint64_t bytes_read = 0;
+  for (int i = 0; i < num_regions; ++i) {
+    bytes_read += regions[i].iov_len;
+  }
+  if (bytes_read == 0) {
+    return 0;
+  }
+  Buffer::RawSlice slice;
+  buffer.reserve(bytes_read, &slice, 1);
+  ASSERT(slice.len_ >= bytes_read);
+  slice.len_ = bytes_read;
+  uint8_t* dest = static_cast<uint8_t*>(slice.mem_);
+  for (int i = 0; i < num_regions; ++i) {
+    memcpy(dest, regions[i].iov_base, regions[i].iov_len);
+    dest += regions[i].iov_len;
+  }
+  buffer.commit(&slice, 1);
+  return bytes_read;
+}
+
 int deduceSignatureAlgorithmFromPublicKey(const EVP_PKEY* public_key, std::string* error_details) {
   int sign_alg = 0;
   const int pkey_id = EVP_PKEY_id(public_key);
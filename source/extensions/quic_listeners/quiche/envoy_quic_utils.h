@@ -1,5 +1,6 @@
 #pragma once
 
+#include "envoy/buffer/buffer.h"
 #include "envoy/common/platform.h"
 #include "envoy/http/codec.h"
 
@@ -14,6 +15,7 @@
 #pragma GCC diagnostic ignored "-Winvalid-offsetof"
 #endif
 
+#include "quiche/quic/core/quic_connection_id.h"
 #include "quiche/quic/core/quic_types.h"
 
 #if defined(__GNUC__)
@@ -89,6 +91,21 @@ createConnectionSocket(Network::Address::InstanceConstSharedPtr& peer_addr,
 // Return nullptr if the bytes passed cannot be passed.
 bssl::UniquePtr<X509> parseDERCertificate(const std::string& der_bytes, std::string* error_details);
 
+// Rewrite the first 4 bytes of a server connection id, which are what the kernel BPF program and
+// ActiveQuicListener::destination() route packets by, so that the packets of the connection are
+// routed to worker worker_index of concurrency workers. Connection ids shorter than 4 bytes are
+// left as they are.
+void adjustNewConnectionIdForRouting(quic::QuicConnectionId& new_connection_id,
+                                     uint32_t worker_index, uint32_t concurrency);
+
+// The number of readable regions of a stream that the streams copy into one reservation.
+constexpr int MaxReadableRegionsPerCopy = 16;
+
+// Copy the readable regions of a stream into a single slice reserved in buffer, so that a body that
+// arrived in many frames or packets is decoded as one slice rather than one slice per region.
+// Return the number of bytes copied, which the caller then marks consumed.
+uint64_t copyReadableRegions(const iovec* regions, int num_regions, Buffer::Instance& buffer);
+
 // Deduce the suitable signature algorithm according to the public key.
 // Return the sign algorithm id works with the public key; If the public key is
 // not supported, return 0 with error_details populated correspondingly.
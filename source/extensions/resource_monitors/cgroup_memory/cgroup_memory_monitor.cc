@@ -0,0 +1,111 @@
+#include "extensions/resource_monitors/cgroup_memory/cgroup_memory_monitor.h"
+
+#include <algorithm>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/fmt.h"
+#include "common/common/utility.h"
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+namespace {
+
+constexpr absl::string_view CgroupV2Path = "/sys/fs/cgroup";
+constexpr absl::string_view CgroupV1Path = "/sys/fs/cgroup/memory";
+
+// cgroup v1 reports a page aligned LONG_MAX as the limit of the cgroups that have none.
+constexpr uint64_t CgroupV1Unlimited = uint64_t(1) << 62;
+
+std::string cgroupPath(const std::string& configured_path, Filesystem::Instance& file_system) {
+  if (!configured_path.empty()) {
+    return configured_path;
+  }
+  return std::string(file_system.fileExists(absl::StrCat(CgroupV2Path, "/memory.current"))
+                         ? CgroupV2Path
+                         : CgroupV1Path);
+}
+
+uint64_t parseBytes(absl::string_view value, absl::string_view file) {
+  uint64_t bytes;
+  if (!absl::SimpleAtoi(StringUtil::trim(value), &bytes)) {
+    throw EnvoyException(fmt::format("failed to parse {}: '{}'", file, value));
+  }
+  return bytes;
+}
+
+} // namespace
+
+CgroupMemoryMonitor::CgroupMemoryMonitor(
+    const envoy::extensions::resource_monitors::cgroup_memory::v3::CgroupMemoryConfig& config,
+    Filesystem::Instance& file_system)
+    : file_system_(file_system), path_(cgroupPath(config.cgroup_path(), file_system)),
+      v2_(file_system.fileExists(absl::StrCat(path_, "/memory.current"))),
+      max_memory_(config.max_memory_bytes()) {}
+
+void CgroupMemoryMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  try {
+    uint64_t limit = limitBytes();
+    if (max_memory_ > 0) {
+      limit = limit > 0 ? std::min(limit, max_memory_) : max_memory_;
+    }
+    if (limit == 0) {
+      throw EnvoyException(
+          fmt::format("cgroup {} has no memory limit and max_memory_bytes is not set", path_));
+    }
+
+    // The inactive page cache is reclaimed by the kernel before it kills a process of the cgroup,
+    // so it does not count towards the pressure.
+    const uint64_t usage = usageBytes();
+    const uint64_t inactive_file = statBytes(v2_ ? "inactive_file" : "total_inactive_file");
+    const uint64_t working_set = usage > inactive_file ? usage - inactive_file : 0;
+
+    Server::ResourceUsage resource_usage;
+    resource_usage.resource_pressure_ = working_set / static_cast<double>(limit);
+    callbacks.onSuccess(resource_usage);
+  } catch (const EnvoyException& error) {
+    callbacks.onFailure(error);
+  }
+}
+
+uint64_t CgroupMemoryMonitor::usageBytes() {
+  const absl::string_view file = v2_ ? "memory.current" : "memory.usage_in_bytes";
+  return parseBytes(readFile(file), file);
+}
+
+uint64_t CgroupMemoryMonitor::limitBytes() {
+  const absl::string_view file = v2_ ? "memory.max" : "memory.limit_in_bytes";
+  const std::string value = readFile(file);
+  if (v2_ && StringUtil::trim(value) == "max") {
+    return 0;
+  }
+  const uint64_t limit = parseBytes(value, file);
+  return !v2_ && limit >= CgroupV1Unlimited ? 0 : limit;
+}
+
+uint64_t CgroupMemoryMonitor::statBytes(absl::string_view name) {
+  const std::string stat = readFile("memory.stat");
+  for (absl::string_view line : absl::StrSplit(stat, '\n', absl::SkipEmpty())) {
+    const std::pair<absl::string_view, absl::string_view> counter =
+        absl::StrSplit(line, absl::MaxSplits(' ', 1));
+    if (counter.first == name) {
+      return parseBytes(counter.second, "memory.stat");
+    }
+  }
+  throw EnvoyException(fmt::format("{} not found in memory.stat", name));
+}
+
+std::string CgroupMemoryMonitor::readFile(absl::string_view name) {
+  return file_system_.fileReadToEnd(absl::StrCat(path_, "/", name));
+}
+
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+
+#include "envoy/extensions/resource_monitors/cgroup_memory/v3/cgroup_memory.pb.h"
+#include "envoy/filesystem/filesystem.h"
+#include "envoy/server/resource_monitor.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+
+/**
+ * Memory monitor of the cgroup of the process, which reports the working set of the cgroup, that
+ * is the memory charged to it less its inactive page cache, as a fraction of its memory limit.
+ */
+class CgroupMemoryMonitor : public Server::ResourceMonitor {
+public:
+  CgroupMemoryMonitor(
+      const envoy::extensions::resource_monitors::cgroup_memory::v3::CgroupMemoryConfig& config,
+      Filesystem::Instance& file_system);
+
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+
+private:
+  // Reads the memory charged to the cgroup.
+  uint64_t usageBytes();
+  // Reads the memory limit of the cgroup, returning 0 if it has none.
+  uint64_t limitBytes();
+  // Reads a counter of memory.stat.
+  uint64_t statBytes(absl::string_view name);
+  std::string readFile(absl::string_view name);
+
+  Filesystem::Instance& file_system_;
+  const std::string path_;
+  // Whether path_ is in a cgroup v2 hierarchy, which names the files of the memory controller
+  // differently than cgroup v1.
+  const bool v2_;
+  const uint64_t max_memory_;
+};
+
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "envoy/extensions/resource_monitors/cgroup_memory/v3/cgroup_memory.pb.h"
+#include "envoy/extensions/resource_monitors/cgroup_memory/v3/cgroup_memory.pb.validate.h"
+#include "envoy/server/resource_monitor_config.h"
+
+#include "extensions/resource_monitors/common/factory_base.h"
+#include "extensions/resource_monitors/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+
+class CgroupMemoryMonitorFactory
+    : public Common::FactoryBase<
+          envoy::extensions::resource_monitors::cgroup_memory::v3::CgroupMemoryConfig> {
+public:
+  CgroupMemoryMonitorFactory() : FactoryBase(ResourceMonitorNames::get().CgroupMemory) {}
+
+private:
+  Server::ResourceMonitorPtr createResourceMonitorFromProtoTyped(
+      const envoy::extensions::resource_monitors::cgroup_memory::v3::CgroupMemoryConfig& config,
+      Server::Configuration::ResourceMonitorFactoryContext& context) override;
+};
+
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
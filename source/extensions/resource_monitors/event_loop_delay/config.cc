@@ -0,0 +1,28 @@
+#include "extensions/resource_monitors/event_loop_delay/config.h"
+
+#include "envoy/extensions/resource_monitors/event_loop_delay/v3/event_loop_delay.pb.h"
+#include "envoy/extensions/resource_monitors/event_loop_delay/v3/event_loop_delay.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "extensions/resource_monitors/event_loop_delay/event_loop_delay_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopDelayMonitor {
+
+Server::ResourceMonitorPtr EventLoopDelayMonitorFactory::createResourceMonitorFromProtoTyped(
+    const envoy::extensions::resource_monitors::event_loop_delay::v3::EventLoopDelayConfig& config,
+    Server::Configuration::ResourceMonitorFactoryContext& context) {
+  return std::make_unique<EventLoopDelayMonitor>(config, context);
+}
+
+/**
+ * Static registration for the event loop delay resource monitor factory. @see RegistryFactory.
+ */
+REGISTER_FACTORY(EventLoopDelayMonitorFactory, Server::Configuration::ResourceMonitorFactory);
+
+} // namespace EventLoopDelayMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
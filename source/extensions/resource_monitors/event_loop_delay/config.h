@@ -0,0 +1,31 @@
+#pragma once
+
+#include "envoy/extensions/resource_monitors/event_loop_delay/v3/event_loop_delay.pb.h"
+#include "envoy/extensions/resource_monitors/event_loop_delay/v3/event_loop_delay.pb.validate.h"
+#include "envoy/server/resource_monitor_config.h"
+
+#include "extensions/resource_monitors/common/factory_base.h"
+#include "extensions/resource_monitors/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopDelayMonitor {
+
+class EventLoopDelayMonitorFactory
+    : public Common::FactoryBase<
+          envoy::extensions::resource_monitors::event_loop_delay::v3::EventLoopDelayConfig> {
+public:
+  EventLoopDelayMonitorFactory() : FactoryBase(ResourceMonitorNames::get().EventLoopDelay) {}
+
+private:
+  Server::ResourceMonitorPtr createResourceMonitorFromProtoTyped(
+      const envoy::extensions::resource_monitors::event_loop_delay::v3::EventLoopDelayConfig&
+          config,
+      Server::Configuration::ResourceMonitorFactoryContext& context) override;
+};
+
+} // namespace EventLoopDelayMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,98 @@
+#include "extensions/resource_monitors/event_loop_delay/event_loop_delay_monitor.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "common/common/lock_guard.h"
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopDelayMonitor {
+namespace {
+
+int64_t nowUs(Event::Dispatcher& dispatcher) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             dispatcher.timeSource().monotonicTime().time_since_epoch())
+      .count();
+}
+
+} // namespace
+
+LoopDelaySampler::LoopDelaySampler(Event::Dispatcher& dispatcher,
+                                   std::chrono::milliseconds interval, LoopDelaySharedPtr delay)
+    : dispatcher_(dispatcher), interval_(interval), delay_(std::move(delay)),
+      timer_(dispatcher.createTimer([this]() { onTimer(); })) {
+  enableTimer();
+}
+
+LoopDelaySampler::~LoopDelaySampler() {
+  // The worker is no longer late once it is gone.
+  delay_->due_us_.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+}
+
+void LoopDelaySampler::enableTimer() {
+  delay_->due_us_.store(
+      nowUs(dispatcher_) + std::chrono::duration_cast<std::chrono::microseconds>(interval_).count(),
+      std::memory_order_relaxed);
+  timer_->enableTimer(interval_);
+}
+
+void LoopDelaySampler::onTimer() {
+  const int64_t delay = nowUs(dispatcher_) - delay_->due_us_.load(std::memory_order_relaxed);
+  int64_t max_delay = delay_->max_delay_us_.load(std::memory_order_relaxed);
+  while (delay > max_delay && !delay_->max_delay_us_.compare_exchange_weak(
+                                  max_delay, delay, std::memory_order_relaxed)) {
+  }
+  enableTimer();
+}
+
+EventLoopDelayMonitor::EventLoopDelayMonitor(
+    const envoy::extensions::resource_monitors::event_loop_delay::v3::EventLoopDelayConfig& config,
+    Server::Configuration::ResourceMonitorFactoryContext& context)
+    : main_dispatcher_(context.dispatcher()),
+      target_delay_(DurationUtil::durationToMilliseconds(config.target_delay())),
+      sample_interval_(PROTOBUF_GET_MS_OR_DEFAULT(config, sample_interval, 100)),
+      loop_delays_(std::make_shared<LoopDelays>()), samplers_(context.threadLocal()) {}
+
+void EventLoopDelayMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  if (!started_) {
+    started_ = true;
+    // The main thread does not serve requests, so it does not sample its delay.
+    samplers_.set([main_dispatcher = &main_dispatcher_, interval = sample_interval_,
+                   loop_delays = loop_delays_](
+                      Event::Dispatcher& dispatcher) -> std::shared_ptr<LoopDelaySampler> {
+      if (&dispatcher == main_dispatcher) {
+        return nullptr;
+      }
+      auto delay = std::make_shared<LoopDelay>();
+      {
+        Thread::LockGuard guard(loop_delays->mutex_);
+        loop_delays->delays_.push_back(delay);
+      }
+      return std::make_shared<LoopDelaySampler>(dispatcher, interval, std::move(delay));
+    });
+  }
+
+  // A worker whose timer is overdue is at least as late as its timer, as it may be stuck in a
+  // callback that keeps it from firing.
+  const int64_t now = nowUs(main_dispatcher_);
+  int64_t max_delay = 0;
+  {
+    Thread::LockGuard guard(loop_delays_->mutex_);
+    for (const LoopDelaySharedPtr& delay : loop_delays_->delays_) {
+      max_delay = std::max({max_delay, delay->max_delay_us_.exchange(0, std::memory_order_relaxed),
+                            now - delay->due_us_.load(std::memory_order_relaxed)});
+    }
+  }
+
+  Server::ResourceUsage usage;
+  usage.resource_pressure_ = max_delay / (target_delay_.count() * 1000.0);
+  callbacks.onSuccess(usage);
+}
+
+} // namespace EventLoopDelayMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
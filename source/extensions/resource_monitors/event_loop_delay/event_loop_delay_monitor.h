@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/extensions/resource_monitors/event_loop_delay/v3/event_loop_delay.pb.h"
+#include "envoy/server/resource_monitor.h"
+#include "envoy/server/resource_monitor_config.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/common/thread.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopDelayMonitor {
+
+/**
+ * The delay of the event loop of a worker, written by the worker and read by the main thread.
+ */
+struct LoopDelay {
+  // When the sampling timer of the worker is due, in microseconds of monotonic time.
+  std::atomic<int64_t> due_us_{};
+  // The largest delay of the sampling timer since the main thread last read it.
+  std::atomic<int64_t> max_delay_us_{};
+};
+
+using LoopDelaySharedPtr = std::shared_ptr<LoopDelay>;
+
+/**
+ * Samples the delay of the event loop of a worker with a timer.
+ */
+class LoopDelaySampler : public ThreadLocal::ThreadLocalObject {
+public:
+  LoopDelaySampler(Event::Dispatcher& dispatcher, std::chrono::milliseconds interval,
+                   LoopDelaySharedPtr delay);
+  ~LoopDelaySampler() override;
+
+private:
+  void enableTimer();
+  void onTimer();
+
+  Event::Dispatcher& dispatcher_;
+  const std::chrono::milliseconds interval_;
+  const LoopDelaySharedPtr delay_;
+  Event::TimerPtr timer_;
+};
+
+/**
+ * Reports the largest delay of the event loops of the workers as a fraction of a target delay.
+ * The samplers are started on the first update, as the workers only register with the thread
+ * local storage after the resource monitors are created.
+ */
+class EventLoopDelayMonitor : public Server::ResourceMonitor {
+public:
+  EventLoopDelayMonitor(
+      const envoy::extensions::resource_monitors::event_loop_delay::v3::EventLoopDelayConfig&
+          config,
+      Server::Configuration::ResourceMonitorFactoryContext& context);
+
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+
+private:
+  // The delays of the workers, which outlive the monitor on the workers.
+  struct LoopDelays {
+    Thread::MutexBasicLockable mutex_;
+    std::vector<LoopDelaySharedPtr> delays_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  Event::Dispatcher& main_dispatcher_;
+  const std::chrono::milliseconds target_delay_;
+  const std::chrono::milliseconds sample_interval_;
+  const std::shared_ptr<LoopDelays> loop_delays_;
+  ThreadLocal::TypedSlot<LoopDelaySampler> samplers_;
+  bool started_{};
+};
+
+} // namespace EventLoopDelayMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,28 @@
+#include "extensions/resource_monitors/handshake_offload/config.h"
+
+#include "envoy/extensions/resource_monitors/handshake_offload/v3/handshake_offload.pb.h"
+#include "envoy/extensions/resource_monitors/handshake_offload/v3/handshake_offload.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "extensions/resource_monitors/handshake_offload/handshake_offload_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace HandshakeOffloadMonitor {
+
+Server::ResourceMonitorPtr HandshakeOffloadMonitorFactory::createResourceMonitorFromProtoTyped(
+    const envoy::extensions::resource_monitors::handshake_offload::v3::HandshakeOffloadConfig&,
+    Server::Configuration::ResourceMonitorFactoryContext&) {
+  return std::make_unique<HandshakeOffloadMonitor>();
+}
+
+/**
+ * Static registration for the handshake offload resource monitor factory. @see RegistryFactory.
+ */
+REGISTER_FACTORY(HandshakeOffloadMonitorFactory, Server::Configuration::ResourceMonitorFactory);
+
+} // namespace HandshakeOffloadMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "envoy/extensions/resource_monitors/handshake_offload/v3/handshake_offload.pb.h"
+#include "envoy/extensions/resource_monitors/handshake_offload/v3/handshake_offload.pb.validate.h"
+#include "envoy/server/resource_monitor_config.h"
+
+#include "extensions/resource_monitors/common/factory_base.h"
+#include "extensions/resource_monitors/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace HandshakeOffloadMonitor {
+
+class HandshakeOffloadMonitorFactory
+    : public Common::FactoryBase<
+          envoy::extensions::resource_monitors::handshake_offload::v3::HandshakeOffloadConfig> {
+public:
+  HandshakeOffloadMonitorFactory() : FactoryBase(ResourceMonitorNames::get().HandshakeOffload) {}
+
+private:
+  Server::ResourceMonitorPtr createResourceMonitorFromProtoTyped(
+      const envoy::extensions::resource_monitors::handshake_offload::v3::HandshakeOffloadConfig&
+          config,
+      Server::Configuration::ResourceMonitorFactoryContext& context) override;
+};
+
+} // namespace HandshakeOffloadMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
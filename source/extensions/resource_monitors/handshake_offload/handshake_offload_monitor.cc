@@ -0,0 +1,20 @@
+#include "extensions/resource_monitors/handshake_offload/handshake_offload_monitor.h"
+
+#include "extensions/private_key_providers/offload/handshake_offload_pool.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace HandshakeOffloadMonitor {
+
+void HandshakeOffloadMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  const auto pool = PrivateKeyMethodProvider::Offload::HandshakeOffloadPool::get();
+  Server::ResourceUsage usage;
+  usage.resource_pressure_ = pool != nullptr ? pool->pressure() : 0;
+  callbacks.onSuccess(usage);
+}
+
+} // namespace HandshakeOffloadMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "envoy/server/resource_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace HandshakeOffloadMonitor {
+
+/**
+ * Reports how full the queue of the handshake offload pool is, so that overload actions, e.g.
+ * stopping accepting connections, can trigger before the handshakes wait too long for a thread.
+ */
+class HandshakeOffloadMonitor : public Server::ResourceMonitor {
+public:
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+};
+
+} // namespace HandshakeOffloadMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -13,6 +13,15 @@ namespace ResourceMonitors {
  */
 class ResourceMonitorNameValues {
 public:
+  // Memory monitor of the cgroup of the process.
+  const std::string CgroupMemory = "envoy.resource_monitors.cgroup_memory";
+
+  // Monitor of the delay of the event loops of the workers.
+  const std::string EventLoopDelay = "envoy.resource_monitors.event_loop_delay";
+
+  // Monitor of the queue of the handshake offload threads.
+  const std::string HandshakeOffload = "envoy.resource_monitors.handshake_offload";
+
   // Heap monitor with statically configured max.
   const std::string FixedHeap = "envoy.resource_monitors.fixed_heap";
 
@@ -21,7 +21,7 @@
 #include "common/network/utility.h"
 #include "common/stats/symbol_table_impl.h"
 
-#include "absl/strings/str_join.h"
+#include "absl/strings/str_cat.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -31,9 +31,20 @@ namespace Statsd {
 
 UdpStatsdSink::WriterImpl::WriterImpl(UdpStatsdSink& parent)
     : parent_(parent), io_handle_(Network::ioHandleForAddr(Network::Socket::Type::Datagram,
-                                                           parent_.server_address_)) {}
+                                                           parent_.server_address_)) {
+  if (io_handle_->supportsMmsg()) {
+    batch_writer_ = std::make_unique<Network::UdpBatchWriter>(*io_handle_);
+  }
+}
 
 void UdpStatsdSink::WriterImpl::write(const std::string& message) {
+  if (batch_writer_ != nullptr) {
+    Buffer::BufferFragmentImpl fragment(message.data(), message.size(), nullptr);
+    Buffer::OwnedImpl data;
+    data.addBufferFragment(fragment);
+    writeBuffer(data);
+    return;
+  }
   // TODO(mattklein123): We can avoid this const_cast pattern by having a constant variant of
   // RawSlice. This can be fixed elsewhere as well.
   Buffer::RawSlice slice{const_cast<char*>(message.c_str()), message.size()};
@@ -41,9 +52,23 @@ void UdpStatsdSink::WriterImpl::write(const std::string& message) {
 }
 
 void UdpStatsdSink::WriterImpl::writeBuffer(Buffer::Instance& data) {
+  if (batch_writer_ != nullptr) {
+    batch_writer_->writePacket(data, nullptr, *parent_.server_address_);
+    return;
+  }
   Network::Utility::writeToSocket(*io_handle_, data, nullptr, *parent_.server_address_);
 }
 
+void UdpStatsdSink::WriterImpl::flush() {
+  if (batch_writer_ == nullptr) {
+    return;
+  }
+  batch_writer_->flush();
+  // Nothing waits for the socket to become writable again. Statsd metrics are lossy, so the
+  // datagrams still queued are retried on the next flush.
+  batch_writer_->setWritable();
+}
+
 UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
                              Network::Address::InstanceConstSharedPtr address, const bool use_tag,
                              const std::string& prefix, absl::optional<uint64_t> buffer_size)
@@ -57,55 +82,63 @@ UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
 
 void UdpStatsdSink::flush(Stats::MetricSnapshot& snapshot) {
   Writer& writer = tls_->getTyped<Writer>();
-  Buffer::OwnedImpl buffer;
+  std::string datagram;
+  datagram.reserve(buffer_size_);
 
   for (const auto& counter : snapshot.counters()) {
     if (counter.counter_.get().used()) {
-      const std::string counter_str =
-          absl::StrCat(prefix_, ".", getName(counter.counter_.get()), ":", counter.delta_, "|c",
-                       buildTagStr(counter.counter_.get().tags()));
-      writeBuffer(buffer, writer, counter_str);
+      appendMetric(datagram, writer, counter.counter_.get(), counter.delta_, "|c");
     }
   }
 
   for (const auto& gauge : snapshot.gauges()) {
     if (gauge.get().used()) {
-      const std::string gauge_str =
-          absl::StrCat(prefix_, ".", getName(gauge.get()), ":", gauge.get().value(), "|g",
-                       buildTagStr(gauge.get().tags()));
-      writeBuffer(buffer, writer, gauge_str);
+      appendMetric(datagram, writer, gauge.get(), gauge.get().value(), "|g");
     }
   }
 
-  flushBuffer(buffer, writer);
+  writeDatagram(datagram, writer);
+  writer.flush();
   // TODO(efimki): Add support of text readouts stats.
 }
 
-void UdpStatsdSink::writeBuffer(Buffer::OwnedImpl& buffer, Writer& writer,
-                                const std::string& statsd_metric) const {
-  if (statsd_metric.length() >= buffer_size_) {
-    // Our statsd_metric is too large to fit into the buffer, skip buffering and write directly
-    writer.write(statsd_metric);
-  } else {
-    if ((buffer.length() + statsd_metric.length() + 1) > buffer_size_) {
-      // If we add the new statsd_metric, we'll overflow our buffer. Flush the buffer to make
-      // room for the new statsd_metric.
-      flushBuffer(buffer, writer);
-    } else if (buffer.length() > 0) {
-      // We have room and have metrics already in the buffer, add a newline to separate
-      // metric entries.
-      buffer.add("\n");
+void UdpStatsdSink::appendMetric(std::string& datagram, Writer& writer,
+                                 const Stats::Metric& metric, uint64_t value,
+                                 absl::string_view stat_type) const {
+  const size_t start = datagram.size();
+  if (start > 0) {
+    // Metrics in the same datagram are separated by newlines.
+    datagram.push_back('\n');
+  }
+  const size_t metric_start = datagram.size();
+  absl::StrAppend(&datagram, prefix_, ".", getName(metric), ":", value, stat_type);
+  appendTags(datagram, metric.tags());
+
+  if (datagram.size() - metric_start >= buffer_size_) {
+    // The metric is too large to share a datagram with others, write it on its own.
+    if (start == 0) {
+      writer.write(datagram);
+      datagram.clear();
+    } else {
+      writer.write(datagram.substr(metric_start));
+      datagram.resize(start);
     }
-    buffer.add(statsd_metric);
+  } else if (datagram.size() > buffer_size_) {
+    // The metric overflows the datagram. Write the datagram without it, and start the next
+    // datagram with it.
+    writeDatagram(absl::string_view(datagram).substr(0, start), writer);
+    datagram.erase(0, metric_start);
   }
 }
 
-void UdpStatsdSink::flushBuffer(Buffer::OwnedImpl& buffer, Writer& writer) const {
-  if (buffer.length() == 0) {
+void UdpStatsdSink::writeDatagram(absl::string_view datagram, Writer& writer) const {
+  if (datagram.empty()) {
     return;
   }
+  Buffer::BufferFragmentImpl fragment(datagram.data(), datagram.size(), nullptr);
+  Buffer::OwnedImpl buffer;
+  buffer.addBufferFragment(fragment);
   writer.writeBuffer(buffer);
-  buffer.drain(buffer.length());
 }
 
 void UdpStatsdSink::onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) {
@@ -115,10 +148,12 @@ void UdpStatsdSink::onHistogramComplete(const Stats::Histogram& histogram, uint6
   // are timers but record in units other than milliseconds, it may make sense to scale the value to
   // milliseconds here and potentially suffix the names accordingly (minus the pre-existing ones for
   // backwards compatibility).
-  const std::string message(absl::StrCat(prefix_, ".", getName(histogram), ":",
-                                         std::chrono::milliseconds(value).count(), "|ms",
-                                         buildTagStr(histogram.tags())));
-  tls_->getTyped<Writer>().write(message);
+  std::string message = absl::StrCat(prefix_, ".", getName(histogram), ":",
+                                     std::chrono::milliseconds(value).count(), "|ms");
+  appendTags(message, histogram.tags());
+  Writer& writer = tls_->getTyped<Writer>();
+  writer.write(message);
+  writer.flush();
 }
 
 const std::string UdpStatsdSink::getName(const Stats::Metric& metric) const {
@@ -129,17 +164,16 @@ const std::string UdpStatsdSink::getName(const Stats::Metric& metric) const {
   }
 }
 
-const std::string UdpStatsdSink::buildTagStr(const std::vector<Stats::Tag>& tags) const {
+void UdpStatsdSink::appendTags(std::string& out, const std::vector<Stats::Tag>& tags) const {
   if (!use_tag_ || tags.empty()) {
-    return "";
+    return;
   }
 
-  std::vector<std::string> tag_strings;
-  tag_strings.reserve(tags.size());
+  absl::string_view separator = "|#";
   for (const Stats::Tag& tag : tags) {
-    tag_strings.emplace_back(tag.name_ + ":" + tag.value_);
+    absl::StrAppend(&out, separator, tag.name_, ":", tag.value_);
+    separator = ",";
   }
-  return "|#" + absl::StrJoin(tag_strings, ",");
 }
 
 TcpStatsdSink::TcpStatsdSink(const LocalInfo::LocalInfo& local_info,
@@ -15,6 +15,7 @@
 #include "common/buffer/buffer_impl.h"
 #include "common/common/macros.h"
 #include "common/network/io_socket_handle_impl.h"
+#include "common/network/udp_batch_writer.h"
 
 #include "absl/types/optional.h"
 
@@ -32,12 +33,14 @@ static const std::string& getDefaultPrefix() { CONSTRUCT_ON_FIRST_USE(std::strin
 class UdpStatsdSink : public Stats::Sink {
 public:
   /**
-   * Base interface for writing UDP datagrams.
+   * Base interface for writing UDP datagrams. A writer may queue the datagrams until flush() is
+   * called.
    */
   class Writer : public ThreadLocal::ThreadLocalObject {
   public:
     virtual void write(const std::string& message) PURE;
     virtual void writeBuffer(Buffer::Instance& data) PURE;
+    virtual void flush() PURE;
   };
 
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, Network::Address::InstanceConstSharedPtr address,
@@ -73,17 +76,24 @@ private:
     // Writer
     void write(const std::string& message) override;
     void writeBuffer(Buffer::Instance& data) override;
+    void flush() override;
 
   private:
     UdpStatsdSink& parent_;
     const Network::IoHandlePtr io_handle_;
+    // Queues the datagrams of a flush to send them with sendmmsg(2). Not set on platforms without
+    // sendmmsg(2), where each datagram is sent as it is written.
+    std::unique_ptr<Network::UdpBatchWriter> batch_writer_;
   };
 
-  void flushBuffer(Buffer::OwnedImpl& buffer, Writer& writer) const;
-  void writeBuffer(Buffer::OwnedImpl& buffer, Writer& writer, const std::string& data) const;
+  // Formats a metric in place at the end of the datagram being filled, and writes the datagram
+  // when the metric does not fit in it.
+  void appendMetric(std::string& datagram, Writer& writer, const Stats::Metric& metric,
+                    uint64_t value, absl::string_view stat_type) const;
+  void writeDatagram(absl::string_view datagram, Writer& writer) const;
 
   const std::string getName(const Stats::Metric& metric) const;
-  const std::string buildTagStr(const std::vector<Stats::Tag>& tags) const;
+  void appendTags(std::string& out, const std::vector<Stats::Tag>& tags) const;
 
   const ThreadLocal::SlotPtr tls_;
   const Network::Address::InstanceConstSharedPtr server_address_;
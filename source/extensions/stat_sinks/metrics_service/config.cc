@@ -40,7 +40,9 @@ MetricsServiceSinkFactory::createStatsSink(const Protobuf::Message& config,
   return std::make_unique<MetricsServiceSink<envoy::service::metrics::v3::StreamMetricsMessage,
                                              envoy::service::metrics::v3::StreamMetricsResponse>>(
       grpc_metrics_streamer,
-      PROTOBUF_GET_WRAPPED_OR_DEFAULT(sink_config, report_counters_as_deltas, false));
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(sink_config, report_counters_as_deltas, false),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(sink_config, max_metrics_per_message, 0),
+      sink_config.report_changed_metrics_only());
 }
 
 ProtobufTypes::MessagePtr MetricsServiceSinkFactory::createEmptyConfigProto() {
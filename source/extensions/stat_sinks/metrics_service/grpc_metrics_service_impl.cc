@@ -1,5 +1,6 @@
 #include "extensions/stat_sinks/metrics_service/grpc_metrics_service_impl.h"
 
+#include <algorithm>
 #include <chrono>
 
 #include "envoy/common/exception.h"
@@ -32,8 +33,8 @@ GrpcMetricsStreamerImpl::GrpcMetricsStreamerImpl(
 
 void GrpcMetricsStreamerImpl::send(MetricsPtr&& metrics) {
   envoy::service::metrics::v3::StreamMetricsMessage message;
-  message.mutable_envoy_metrics()->Reserve(metrics->size());
-  message.mutable_envoy_metrics()->MergeFrom(*metrics);
+  // Swapping takes over the metric families instead of copying them.
+  message.mutable_envoy_metrics()->Swap(metrics.get());
 
   if (stream_ == nullptr) {
     stream_ = client_->start(service_method_, *this, Http::AsyncClient::StreamOptions());
@@ -46,37 +47,62 @@ void GrpcMetricsStreamerImpl::send(MetricsPtr&& metrics) {
   }
 }
 
-MetricsPtr MetricsFlusher::flush(Stats::MetricSnapshot& snapshot) const {
-  auto metrics =
-      std::make_unique<Envoy::Protobuf::RepeatedPtrField<io::prometheus::client::MetricFamily>>();
+void MetricsFlusher::flush(Stats::MetricSnapshot& snapshot, const SendCb& send_cb) const {
+  // A histogram is reported as a summary and a histogram metric family.
+  const size_t num_metric_families =
+      snapshot.counters().size() + snapshot.gauges().size() + 2 * snapshot.histograms().size();
+  const size_t batch_size = max_metrics_per_message_ > 0
+                                ? std::min<size_t>(max_metrics_per_message_, num_metric_families)
+                                : num_metric_families;
+  auto new_batch = [batch_size]() {
+    auto metrics = std::make_unique<
+        Envoy::Protobuf::RepeatedPtrField<io::prometheus::client::MetricFamily>>();
+    // TODO(mrice32): there's probably some more sophisticated preallocation we can do here where
+    // we actually preallocate the submessages and then pass ownership to the proto (rather than
+    // just preallocating the pointer array).
+    metrics->Reserve(batch_size);
+    return metrics;
+  };
+  MetricsPtr metrics = new_batch();
+  bool sent = false;
+  // Makes room in the current batch for the metric families of one metric, which are never split
+  // across batches.
+  auto make_room = [&](int num_families) {
+    if (max_metrics_per_message_ > 0 && !metrics->empty() &&
+        metrics->size() + num_families > static_cast<int>(max_metrics_per_message_)) {
+      send_cb(std::move(metrics));
+      sent = true;
+      metrics = new_batch();
+    }
+  };
 
-  // TODO(mrice32): there's probably some more sophisticated preallocation we can do here where we
-  // actually preallocate the submessages and then pass ownership to the proto (rather than just
-  // preallocating the pointer array).
-  metrics->Reserve(snapshot.counters().size() + snapshot.gauges().size() +
-                   snapshot.histograms().size());
   int64_t snapshot_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                                  snapshot.snapshotTime().time_since_epoch())
                                  .count();
   for (const auto& counter : snapshot.counters()) {
-    if (counter.counter_.get().used()) {
+    if (counter.counter_.get().used() && (!report_changed_metrics_only_ || counter.delta_ > 0)) {
+      make_room(1);
       flushCounter(*metrics->Add(), counter, snapshot_time_ms);
     }
   }
 
   for (const auto& gauge : snapshot.gauges()) {
     if (gauge.get().used()) {
+      make_room(1);
       flushGauge(*metrics->Add(), gauge.get(), snapshot_time_ms);
     }
   }
 
   for (const auto& histogram : snapshot.histograms()) {
     if (histogram.get().used()) {
+      make_room(2);
       flushHistogram(*metrics->Add(), *metrics->Add(), histogram.get(), snapshot_time_ms);
     }
   }
 
-  return metrics;
+  if (!sent || !metrics->empty()) {
+    send_cb(std::move(metrics));
+  }
 }
 
 void MetricsFlusher::flushCounter(io::prometheus::client::MetricFamily& metrics_family,
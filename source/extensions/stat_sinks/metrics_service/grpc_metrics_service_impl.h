@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 
 #include "envoy/grpc/async_client.h"
@@ -82,10 +83,31 @@ using GrpcMetricsStreamerImplPtr = std::unique_ptr<GrpcMetricsStreamerImpl>;
 
 class MetricsFlusher {
 public:
-  explicit MetricsFlusher(const bool report_counters_as_deltas)
-      : report_counters_as_deltas_(report_counters_as_deltas) {}
+  using SendCb = std::function<void(MetricsPtr&&)>;
 
-  MetricsPtr flush(Stats::MetricSnapshot& snapshot) const;
+  /**
+   * @param report_counters_as_deltas whether counters are reported as the delta since the
+   *        previous flush instead of their value.
+   * @param max_metrics_per_message the maximum number of metric families per batch, or 0 to put
+   *        all the metrics of a flush in a single batch.
+   * @param report_changed_metrics_only whether counters that did not change since the previous
+   *        flush are left out.
+   */
+  MetricsFlusher(const bool report_counters_as_deltas, const uint32_t max_metrics_per_message = 0,
+                 const bool report_changed_metrics_only = false)
+      : report_counters_as_deltas_(report_counters_as_deltas),
+        max_metrics_per_message_(max_metrics_per_message),
+        report_changed_metrics_only_(report_changed_metrics_only) {}
+
+  /**
+   * Converts the metrics of a snapshot into batches of metric families.
+   * @param snapshot supplies the metrics to convert.
+   * @param send_cb is called with each batch as soon as it is full, so that a batch can be sent
+   *        before the next one is built. It is called at least once per flush.
+   */
+  void flush(Stats::MetricSnapshot& snapshot, const SendCb& send_cb) const;
+
+  bool reportChangedMetricsOnly() const { return report_changed_metrics_only_; }
 
 private:
   void flushCounter(io::prometheus::client::MetricFamily& metrics_family,
@@ -99,6 +121,8 @@ private:
                       int64_t snapshot_time_ms) const;
 
   const bool report_counters_as_deltas_;
+  const uint32_t max_metrics_per_message_;
+  const bool report_changed_metrics_only_;
 };
 
 /**
@@ -109,13 +133,18 @@ public:
   // MetricsService::Sink
   MetricsServiceSink(
       const GrpcMetricsStreamerSharedPtr<RequestProto, ResponseProto>& grpc_metrics_streamer,
-      const bool report_counters_as_deltas)
-      : flusher_(report_counters_as_deltas), grpc_metrics_streamer_(grpc_metrics_streamer) {}
+      const bool report_counters_as_deltas, const uint32_t max_metrics_per_message = 0,
+      const bool report_changed_metrics_only = false)
+      : flusher_(report_counters_as_deltas, max_metrics_per_message, report_changed_metrics_only),
+        grpc_metrics_streamer_(grpc_metrics_streamer) {}
 
   void flush(Stats::MetricSnapshot& snapshot) override {
-    grpc_metrics_streamer_->send(flusher_.flush(snapshot));
+    flusher_.flush(snapshot, [this](MetricsPtr&& metrics) {
+      grpc_metrics_streamer_->send(std::move(metrics));
+    });
   }
   void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
+  bool flushChangedMetricsOnly() const override { return flusher_.reportChangedMetricsOnly(); }
 
 private:
   const MetricsFlusher flusher_;
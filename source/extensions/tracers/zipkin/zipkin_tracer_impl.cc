@@ -137,9 +137,11 @@ Tracing::SpanPtr Driver::startSpan(const Tracing::Config& config,
 
 ReporterImpl::ReporterImpl(Driver& driver, Event::Dispatcher& dispatcher,
                            const CollectorInfo& collector)
-    : driver_(driver),
-      collector_(collector), span_buffer_{std::make_unique<SpanBuffer>(
-                                 collector.version_, collector.shared_span_context_)},
+    : driver_(driver), collector_(collector),
+      max_pending_reports_(
+          driver_.runtime().snapshot().getInteger("tracing.zipkin.max_pending_reports", 128U)),
+      span_buffer_{
+          std::make_unique<SpanBuffer>(collector.version_, collector.shared_span_context_)},
       collector_cluster_(driver_.clusterManager(), driver_.cluster()) {
   flush_timer_ = dispatcher.createTimer([this]() -> void {
     driver_.tracerStats().timer_flushed_.inc();
@@ -178,6 +180,12 @@ void ReporterImpl::enableTimer() {
 
 void ReporterImpl::flushSpans() {
   if (span_buffer_->pendingSpans()) {
+    if (active_requests_.size() >= max_pending_reports_) {
+      ENVOY_LOG(debug, "{} zipkin reports in flight, dropping spans", active_requests_.size());
+      driver_.tracerStats().spans_dropped_.add(span_buffer_->pendingSpans());
+      span_buffer_->clear();
+      return;
+    }
     driver_.tracerStats().spans_sent_.add(span_buffer_->pendingSpans());
     const std::string request_body = span_buffer_->serialize();
     Http::RequestMessagePtr message = std::make_unique<Http::RequestMessageImpl>();
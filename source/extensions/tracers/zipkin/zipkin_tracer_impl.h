@@ -29,7 +29,8 @@ namespace Zipkin {
   COUNTER(reports_skipped_no_cluster)                                                              \
   COUNTER(reports_sent)                                                                            \
   COUNTER(reports_dropped)                                                                         \
-  COUNTER(reports_failed)
+  COUNTER(reports_failed)                                                                          \
+  COUNTER(spans_dropped)
 
 struct ZipkinTracerStats {
   ZIPKIN_TRACER_STATS(GENERATE_COUNTER_STRUCT)
@@ -183,6 +184,10 @@ struct CollectorInfo {
  * expires, whichever happens first.
  *
  * The default values for the runtime parameters are 5 spans and 5000ms.
+ *
+ * While `tracing.zipkin.max_pending_reports` reports are in flight, read when the reporter is
+ * created and 128 by default, the spans flushed are dropped rather than sent, so that a slow
+ * collector does not pile up requests on the workers.
  */
 class ReporterImpl : Logger::Loggable<Logger::Id::tracing>,
                      public Reporter,
@@ -242,6 +247,7 @@ private:
   Driver& driver_;
   Event::TimerPtr flush_timer_;
   const CollectorInfo collector_;
+  const uint64_t max_pending_reports_;
   SpanBufferPtr span_buffer_;
   Upstream::ClusterUpdateTracker collector_cluster_;
   // Track active HTTP requests to be able to cancel them on destruction.
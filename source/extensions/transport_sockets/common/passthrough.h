@@ -24,6 +24,8 @@ public:
   Ssl::ConnectionInfoConstSharedPtr ssl() const override;
   // startSecureTransport method should not be called for this transport socket.
   bool startSecureTransport() override { return false; }
+  // Wrapping sockets may observe or alter the data, so it always flows through them.
+  bool canSplice() const override { return false; }
 
 protected:
   Network::TransportSocketPtr transport_socket_;
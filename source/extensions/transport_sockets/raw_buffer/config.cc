@@ -2,29 +2,56 @@
 
 #include <iostream>
 
-#include "envoy/config/transport_socket/raw_buffer/v2/raw_buffer.pb.h"
-#include "envoy/config/transport_socket/raw_buffer/v2/raw_buffer.pb.validate.h"
+#include "envoy/common/exception.h"
+#include "envoy/extensions/transport_sockets/raw_buffer/v3/raw_buffer.pb.h"
+#include "envoy/extensions/transport_sockets/raw_buffer/v3/raw_buffer.pb.validate.h"
 
+#include "common/common/fmt.h"
 #include "common/network/raw_buffer_socket.h"
+#include "common/protobuf/utility.h"
 
 namespace Envoy {
 namespace Extensions {
 namespace TransportSockets {
 namespace RawBuffer {
 
+Network::TransportSocketFactoryPtr
+RawBufferSocketFactory::createFactory(const Protobuf::Message& message,
+                                      Server::Configuration::TransportSocketFactoryContext& context) {
+  const auto& config = MessageUtil::downcastAndValidate<
+      const envoy::extensions::transport_sockets::raw_buffer::v3::RawBuffer&>(
+      message, context.messageValidationVisitor());
+  Network::AdaptiveReadConfigSharedPtr adaptive_read;
+  if (config.has_adaptive_read_size()) {
+    const auto& read_size = config.adaptive_read_size();
+    const uint32_t min_read_size = PROTOBUF_GET_WRAPPED_OR_DEFAULT(read_size, min_read_size, 4096);
+    const uint32_t max_read_size =
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(read_size, max_read_size, 16384);
+    if (min_read_size > max_read_size) {
+      throw EnvoyException(fmt::format("raw_buffer: min_read_size {} is larger than max_read_size {}",
+                                       min_read_size, max_read_size));
+    }
+    adaptive_read = std::make_shared<Network::AdaptiveReadConfig>(min_read_size, max_read_size,
+                                                                  context.scope());
+  }
+  return std::make_unique<Network::RawBufferSocketFactory>(
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, zero_copy_send_threshold, 0),
+      std::move(adaptive_read));
+}
+
 Network::TransportSocketFactoryPtr UpstreamRawBufferSocketFactory::createTransportSocketFactory(
-    const Protobuf::Message&, Server::Configuration::TransportSocketFactoryContext&) {
-  return std::make_unique<Network::RawBufferSocketFactory>();
+    const Protobuf::Message& config, Server::Configuration::TransportSocketFactoryContext& context) {
+  return createFactory(config, context);
 }
 
 Network::TransportSocketFactoryPtr DownstreamRawBufferSocketFactory::createTransportSocketFactory(
-    const Protobuf::Message&, Server::Configuration::TransportSocketFactoryContext&,
+    const Protobuf::Message& config, Server::Configuration::TransportSocketFactoryContext& context,
     const std::vector<std::string>&) {
-  return std::make_unique<Network::RawBufferSocketFactory>();
+  return createFactory(config, context);
 }
 
 ProtobufTypes::MessagePtr RawBufferSocketFactory::createEmptyConfigProto() {
-  return std::make_unique<envoy::config::transport_socket::raw_buffer::v2::RawBuffer>();
+  return std::make_unique<envoy::extensions::transport_sockets::raw_buffer::v3::RawBuffer>();
 }
 
 REGISTER_FACTORY(UpstreamRawBufferSocketFactory,
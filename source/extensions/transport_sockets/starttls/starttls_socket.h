@@ -50,6 +50,8 @@ public:
   // Method to enable TLS.
   bool startSecureTransport() override;
 
+  bool canSplice() const override { return active_socket_->canSplice(); }
+
 private:
   // Socket used in all transport socket operations.
   // initially it is set to use raw buffer socket but
@@ -354,7 +354,10 @@ ClientContextConfigImpl::ClientContextConfigImpl(
                         DEFAULT_CIPHER_SUITES, DEFAULT_CURVES, factory_context),
       server_name_indication_(config.sni()), allow_renegotiation_(config.allow_renegotiation()),
       max_session_keys_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_session_keys, 1)),
-      sigalgs_(sigalgs) {
+      max_session_cache_size_(config.has_max_session_cache_size()
+                                  ? absl::make_optional(config.max_session_cache_size().value())
+                                  : absl::nullopt),
+      early_data_enabled_(config.enable_early_data()), sigalgs_(sigalgs) {
   // BoringSSL treats this as a C string, so embedded NULL characters will not
   // be handled correctly.
   if (server_name_indication_.find('\0') != std::string::npos) {
@@ -432,6 +435,17 @@ ServerContextConfigImpl::ServerContextConfigImpl(
     session_timeout_ =
         std::chrono::seconds(DurationUtil::durationToSeconds(config.session_timeout()));
   }
+
+  if (config.has_max_session_cache_size()) {
+    max_session_cache_size_ = config.max_session_cache_size().value();
+  }
+
+  if (config.has_dynamic_record_sizing()) {
+    const auto& sizing = config.dynamic_record_sizing();
+    dynamic_record_sizing_ = DynamicRecordSizing{
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(sizing, initial_record_size, 1300),
+        std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(sizing, idle_timeout, 1000))};
+  }
 }
 
 ServerContextConfigImpl::~ServerContextConfigImpl() {
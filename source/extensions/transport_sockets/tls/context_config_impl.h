@@ -119,6 +119,10 @@ public:
   const std::string& serverNameIndication() const override { return server_name_indication_; }
   bool allowRenegotiation() const override { return allow_renegotiation_; }
   size_t maxSessionKeys() const override { return max_session_keys_; }
+  absl::optional<uint32_t> maxSessionCacheSize() const override {
+    return max_session_cache_size_;
+  }
+  bool earlyDataEnabled() const override { return early_data_enabled_; }
   const std::string& signingAlgorithmsForTest() const override { return sigalgs_; }
 
 private:
@@ -128,6 +132,8 @@ private:
   const std::string server_name_indication_;
   const bool allow_renegotiation_;
   const size_t max_session_keys_;
+  const absl::optional<uint32_t> max_session_cache_size_;
+  const bool early_data_enabled_;
   const std::string sigalgs_;
 };
 
@@ -157,6 +163,12 @@ public:
   bool disableStatelessSessionResumption() const override {
     return disable_stateless_session_resumption_;
   }
+  absl::optional<uint32_t> maxSessionCacheSize() const override {
+    return max_session_cache_size_;
+  }
+  absl::optional<DynamicRecordSizing> dynamicRecordSizing() const override {
+    return dynamic_record_sizing_;
+  }
 
 private:
   static const unsigned DEFAULT_MIN_VERSION;
@@ -180,6 +192,8 @@ private:
 
   absl::optional<std::chrono::seconds> session_timeout_;
   const bool disable_stateless_session_resumption_;
+  absl::optional<uint32_t> max_session_cache_size_;
+  absl::optional<DynamicRecordSizing> dynamic_record_sizing_;
 };
 
 } // namespace Tls
@@ -17,15 +17,18 @@
 #include "common/common/fmt.h"
 #include "common/common/hex.h"
 #include "common/common/utility.h"
+#include "common/memory/accounting.h"
 #include "common/network/address_impl.h"
 #include "common/protobuf/utility.h"
 #include "common/runtime/runtime_features.h"
 #include "common/stats/utility.h"
 
+#include "extensions/transport_sockets/tls/pem_cache.h"
 #include "extensions/transport_sockets/tls/utility.h"
 
-#include "absl/container/node_hash_set.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "openssl/evp.h"
 #include "openssl/hmac.h"
@@ -52,6 +55,25 @@ bool cbsContainsU16(CBS& cbs, uint16_t n) {
   return false;
 }
 
+// Returns the lower case names that a certificate is for: its DNS SANs, or its subject CN if it
+// has no DNS SAN.
+std::vector<std::string> certificateNames(X509& cert) {
+  std::vector<std::string> names = Utility::getSubjectAltNames(cert, GEN_DNS);
+  if (names.empty()) {
+    X509_NAME* subject = X509_get_subject_name(&cert);
+    const int cn_index = X509_NAME_get_index_by_NID(subject, NID_commonName, -1);
+    if (cn_index >= 0) {
+      const ASN1_STRING* cn = X509_NAME_ENTRY_get_data(X509_NAME_get_entry(subject, cn_index));
+      names.emplace_back(reinterpret_cast<const char*>(ASN1_STRING_get0_data(cn)),
+                         ASN1_STRING_length(cn));
+    }
+  }
+  for (std::string& name : names) {
+    absl::AsciiStrToLower(&name);
+  }
+  return names;
+}
+
 } // namespace
 
 int ContextImpl::sslExtendedSocketInfoIndex() {
@@ -147,84 +169,59 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
   }
 #endif
 
+  std::shared_ptr<const PemCache::X509InfoList> trusted_ca;
+  X509_STORE_CTX_verify_cb store_verify_cb = nullptr;
   if (config.certificateValidationContext() != nullptr &&
       !config.certificateValidationContext()->caCert().empty() &&
       !config.capabilities().provides_certificates) {
     ca_file_path_ = config.certificateValidationContext()->caCertPath();
-    bssl::UniquePtr<BIO> bio(
-        BIO_new_mem_buf(const_cast<char*>(config.certificateValidationContext()->caCert().data()),
-                        config.certificateValidationContext()->caCert().size()));
-    RELEASE_ASSERT(bio != nullptr, "");
-    // Based on BoringSSL's X509_load_cert_crl_file().
-    bssl::UniquePtr<STACK_OF(X509_INFO)> list(
-        PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
-    if (list == nullptr) {
-      throw EnvoyException(absl::StrCat("Failed to load trusted CA certificates from ",
-                                        config.certificateValidationContext()->caCertPath()));
-    }
-
-    for (auto& ctx : tls_contexts_) {
-      X509_STORE* store = SSL_CTX_get_cert_store(ctx.ssl_ctx_.get());
-      bool has_crl = false;
-      for (const X509_INFO* item : list.get()) {
+    trusted_ca = PemCache::get().x509InfoList(config.certificateValidationContext()->caCert());
+    if (trusted_ca != nullptr) {
+      for (const X509_INFO* item : trusted_ca->list_.get()) {
         if (item->x509) {
-          X509_STORE_add_cert(store, item->x509);
-          if (ca_cert_ == nullptr) {
-            X509_up_ref(item->x509);
-            ca_cert_.reset(item->x509);
-          }
-        }
-        if (item->crl) {
-          X509_STORE_add_crl(store, item->crl);
-          has_crl = true;
+          X509_up_ref(item->x509);
+          ca_cert_.reset(item->x509);
+          break;
         }
       }
-      if (ca_cert_ == nullptr) {
-        throw EnvoyException(absl::StrCat("Failed to load trusted CA certificates from ",
-                                          config.certificateValidationContext()->caCertPath()));
-      }
-      if (has_crl) {
-        X509_STORE_set_flags(store, X509_V_FLAG_CRL_CHECK | X509_V_FLAG_CRL_CHECK_ALL);
-      }
-      verify_mode = SSL_VERIFY_PEER;
-      verify_trusted_ca_ = true;
-
-      // NOTE: We're using SSL_CTX_set_cert_verify_callback() instead of X509_verify_cert()
-      // directly. However, our new callback is still calling X509_verify_cert() under
-      // the hood. Therefore, to ignore cert expiration, we need to set the callback
-      // for X509_verify_cert to ignore that error.
-      if (config.certificateValidationContext()->allowExpiredCertificate()) {
-        X509_STORE_set_verify_cb(store, ContextImpl::ignoreCertificateExpirationCallback);
-      }
+    }
+    if (ca_cert_ == nullptr) {
+      throw EnvoyException(absl::StrCat("Failed to load trusted CA certificates from ",
+                                        config.certificateValidationContext()->caCertPath()));
+    }
+    verify_mode = SSL_VERIFY_PEER;
+    verify_trusted_ca_ = true;
+
+    // NOTE: We're using SSL_CTX_set_cert_verify_callback() instead of X509_verify_cert()
+    // directly. However, our new callback is still calling X509_verify_cert() under
+    // the hood. Therefore, to ignore cert expiration, we need to set the callback
+    // for X509_verify_cert to ignore that error.
+    if (config.certificateValidationContext()->allowExpiredCertificate()) {
+      store_verify_cb = ContextImpl::ignoreCertificateExpirationCallback;
     }
   }
 
+  std::shared_ptr<const PemCache::X509InfoList> crl;
   if (config.certificateValidationContext() != nullptr &&
       !config.certificateValidationContext()->certificateRevocationList().empty()) {
-    bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(
-        const_cast<char*>(
-            config.certificateValidationContext()->certificateRevocationList().data()),
-        config.certificateValidationContext()->certificateRevocationList().size()));
-    RELEASE_ASSERT(bio != nullptr, "");
-
-    // Based on BoringSSL's X509_load_cert_crl_file().
-    bssl::UniquePtr<STACK_OF(X509_INFO)> list(
-        PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
-    if (list == nullptr) {
+    crl = PemCache::get().x509InfoList(
+        config.certificateValidationContext()->certificateRevocationList());
+    if (crl == nullptr) {
       throw EnvoyException(
           absl::StrCat("Failed to load CRL from ",
                        config.certificateValidationContext()->certificateRevocationListPath()));
     }
+  }
 
+  // The contexts with the same trusted CAs and CRLs share one certificate store, which is only read
+  // once built.
+  if (trusted_ca != nullptr || crl != nullptr) {
+    const auto cert_store =
+        PemCache::get().certStore(std::move(trusted_ca), std::move(crl), store_verify_cb);
+    parsed_pem_.push_back(cert_store);
     for (auto& ctx : tls_contexts_) {
-      X509_STORE* store = SSL_CTX_get_cert_store(ctx.ssl_ctx_.get());
-      for (const X509_INFO* item : list.get()) {
-        if (item->crl) {
-          X509_STORE_add_crl(store, item->crl);
-        }
-      }
-
-      X509_STORE_set_flags(store, X509_V_FLAG_CRL_CHECK | X509_V_FLAG_CRL_CHECK_ALL);
+      X509_STORE_up_ref(cert_store->store_.get());
+      SSL_CTX_set_cert_store(ctx.ssl_ctx_.get(), cert_store->store_.get());
     }
   }
 
@@ -281,19 +278,21 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
     }
   }
 
-  absl::node_hash_set<int> cert_pkey_ids;
   if (!capabilities_.provides_certificates) {
     for (uint32_t i = 0; i < tls_certificates.size(); ++i) {
       auto& ctx = tls_contexts_[i];
       // Load certificate chain.
       const auto& tls_certificate = tls_certificates[i].get();
       ctx.cert_chain_file_path_ = tls_certificate.certificateChainPath();
-      bssl::UniquePtr<BIO> bio(
-          BIO_new_mem_buf(const_cast<char*>(tls_certificate.certificateChain().data()),
-                          tls_certificate.certificateChain().size()));
-      RELEASE_ASSERT(bio != nullptr, "");
-      ctx.cert_chain_.reset(PEM_read_bio_X509_AUX(bio.get(), nullptr, nullptr, nullptr));
-      if (ctx.cert_chain_ == nullptr ||
+      // The certificates are shared with the other contexts using the same chain, and only
+      // referenced by the SSL_CTX.
+      const auto cert_chain = PemCache::get().certificateChain(tls_certificate.certificateChain());
+      if (cert_chain != nullptr) {
+        parsed_pem_.push_back(cert_chain);
+        X509_up_ref(cert_chain->leaf_.get());
+        ctx.cert_chain_.reset(cert_chain->leaf_.get());
+      }
+      if (cert_chain == nullptr ||
           !SSL_CTX_use_certificate(ctx.ssl_ctx_.get(), ctx.cert_chain_.get())) {
         while (uint64_t err = ERR_get_error()) {
           ENVOY_LOG_MISC(debug, "SSL error: {}:{}:{}:{}", err, ERR_lib_error_string(err),
@@ -303,26 +302,11 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
         throw EnvoyException(
             absl::StrCat("Failed to load certificate chain from ", ctx.cert_chain_file_path_));
       }
-      // Read rest of the certificate chain.
-      while (true) {
-        bssl::UniquePtr<X509> cert(PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr));
-        if (cert == nullptr) {
-          break;
-        }
-        if (!SSL_CTX_add_extra_chain_cert(ctx.ssl_ctx_.get(), cert.get())) {
+      for (const auto& cert : cert_chain->intermediates_) {
+        if (!SSL_CTX_add1_chain_cert(ctx.ssl_ctx_.get(), cert.get())) {
           throw EnvoyException(
               absl::StrCat("Failed to load certificate chain from ", ctx.cert_chain_file_path_));
         }
-        // SSL_CTX_add_extra_chain_cert() takes ownership.
-        cert.release();
-      }
-      // Check for EOF.
-      const uint32_t err = ERR_peek_last_error();
-      if (ERR_GET_LIB(err) == ERR_LIB_PEM && ERR_GET_REASON(err) == PEM_R_NO_START_LINE) {
-        ERR_clear_error();
-      } else {
-        throw EnvoyException(
-            absl::StrCat("Failed to load certificate chain from ", ctx.cert_chain_file_path_));
       }
 
       // The must staple extension means the certificate promises to carry
@@ -336,11 +320,6 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
 
       bssl::UniquePtr<EVP_PKEY> public_key(X509_get_pubkey(ctx.cert_chain_.get()));
       const int pkey_id = EVP_PKEY_id(public_key.get());
-      if (!cert_pkey_ids.insert(pkey_id).second) {
-        throw EnvoyException(fmt::format("Failed to load certificate chain from {}, at most one "
-                                         "certificate of a given type may be specified",
-                                         ctx.cert_chain_file_path_));
-      }
       ctx.is_ecdsa_ = pkey_id == EVP_PKEY_EC;
       switch (pkey_id) {
       case EVP_PKEY_EC: {
@@ -409,20 +388,16 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
         SSL_CTX_set_private_key_method(ctx.ssl_ctx_.get(), private_key_method.get());
       } else {
         // Load private key.
-        bio.reset(BIO_new_mem_buf(const_cast<char*>(tls_certificate.privateKey().data()),
-                                  tls_certificate.privateKey().size()));
-        RELEASE_ASSERT(bio != nullptr, "");
-        bssl::UniquePtr<EVP_PKEY> pkey(
-            PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr,
-                                    !tls_certificate.password().empty()
-                                        ? const_cast<char*>(tls_certificate.password().c_str())
-                                        : nullptr));
-
-        if (pkey == nullptr || !SSL_CTX_use_PrivateKey(ctx.ssl_ctx_.get(), pkey.get())) {
+        const auto private_key =
+            PemCache::get().privateKey(tls_certificate.privateKey(), tls_certificate.password());
+        if (private_key == nullptr ||
+            !SSL_CTX_use_PrivateKey(ctx.ssl_ctx_.get(), private_key->pkey_.get())) {
           throw EnvoyException(fmt::format("Failed to load private key from {}, Cause: {}",
                                            tls_certificate.privateKeyPath(),
                                            Utility::getLastCryptoError().value_or("unknown")));
         }
+        parsed_pem_.push_back(private_key);
+        const bssl::UniquePtr<EVP_PKEY>& pkey = private_key->pkey_;
 
 #ifdef BORINGSSL_FIPS
         // Verify that private keys are passing FIPS pairwise consistency tests.
@@ -490,6 +465,12 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
 
   // Versions
   stat_name_set_->rememberBuiltins({"TLSv1", "TLSv1.1", "TLSv1.2", "TLSv1.3"});
+
+  Memory::Accounting::allocate(Memory::Accounting::Account::TlsContexts, sizeof(ContextImpl));
+}
+
+ContextImpl::~ContextImpl() {
+  Memory::Accounting::free(Memory::Accounting::Account::TlsContexts, sizeof(ContextImpl));
 }
 
 int ServerContextImpl::alpnSelectCallback(const unsigned char** out, unsigned char* outlen,
@@ -886,8 +867,7 @@ ClientContextImpl::ClientContextImpl(Stats::Scope& scope,
                                      TimeSource& time_source)
     : ContextImpl(scope, config, time_source),
       server_name_indication_(config.serverNameIndication()),
-      allow_renegotiation_(config.allowRenegotiation()),
-      max_session_keys_(config.maxSessionKeys()) {
+      allow_renegotiation_(config.allowRenegotiation()) {
   // This should be guaranteed during configuration ingestion for client contexts.
   ASSERT(tls_contexts_.size() == 1);
   if (!parsed_alpn_protocols_.empty()) {
@@ -909,7 +889,10 @@ ClientContextImpl::ClientContextImpl(Stats::Scope& scope,
     }
   }
 
-  if (max_session_keys_ > 0) {
+  if (config.maxSessionKeys() > 0) {
+    session_cache_ = std::make_unique<ClientSessionCache>(
+        config.maxSessionCacheSize().value_or(ClientSessionCache::DefaultMaxSize),
+        config.maxSessionKeys());
     SSL_CTX_set_session_cache_mode(tls_contexts_[0].ssl_ctx_.get(), SSL_SESS_CACHE_CLIENT);
     SSL_CTX_sess_set_new_cb(
         tls_contexts_[0].ssl_ctx_.get(), [](SSL* ssl, SSL_SESSION* session) -> int {
@@ -917,9 +900,25 @@ ClientContextImpl::ClientContextImpl(Stats::Scope& scope,
               static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
           ClientContextImpl* client_context_impl = dynamic_cast<ClientContextImpl*>(context_impl);
           RELEASE_ASSERT(client_context_impl != nullptr, ""); // for Coverity
-          return client_context_impl->newSessionKey(session);
+          return client_context_impl->newSessionKey(ssl, session);
         });
   }
+
+  if (config.earlyDataEnabled()) {
+    SSL_CTX_set_early_data_enabled(tls_contexts_[0].ssl_ctx_.get(), 1);
+  }
+}
+
+int ClientContextImpl::sessionKeyIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, []() -> int {
+    int session_key_index =
+        SSL_get_ex_new_index(0, nullptr, nullptr, nullptr,
+                             [](void*, void* ptr, CRYPTO_EX_DATA*, int, long, void*) {
+                               delete static_cast<std::string*>(ptr);
+                             });
+    RELEASE_ASSERT(session_key_index >= 0, "");
+    return session_key_index;
+  }());
 }
 
 bool ContextImpl::parseAndSetAlpn(const std::vector<std::string>& alpn, SSL& ssl) {
@@ -974,48 +973,32 @@ bssl::UniquePtr<SSL> ClientContextImpl::newSsl(const Network::TransportSocketOpt
     SSL_set_renegotiate_mode(ssl_con.get(), ssl_renegotiate_freely);
   }
 
-  if (max_session_keys_ > 0) {
-    if (session_keys_single_use_) {
-      // Stored single-use session keys, use write/write locks.
-      absl::WriterMutexLock l(&session_keys_mu_);
-      if (!session_keys_.empty()) {
-        // Use the most recently stored session key, since it has the highest
-        // probability of still being recognized/accepted by the server.
-        SSL_SESSION* session = session_keys_.front().get();
-        SSL_set_session(ssl_con.get(), session);
-        // Remove single-use session key (TLS 1.3) after first use.
-        if (SSL_SESSION_should_be_single_use(session)) {
-          session_keys_.pop_front();
-        }
-      }
-    } else {
-      // Never stored single-use session keys, use read/write locks.
-      absl::ReaderMutexLock l(&session_keys_mu_);
-      if (!session_keys_.empty()) {
-        // Use the most recently stored session key, since it has the highest
-        // probability of still being recognized/accepted by the server.
-        SSL_SESSION* session = session_keys_.front().get();
-        SSL_set_session(ssl_con.get(), session);
-      }
-    }
-  }
-
   return ssl_con;
 }
 
-int ClientContextImpl::newSessionKey(SSL_SESSION* session) {
-  // In case we ever store single-use session key (TLS 1.3),
-  // we need to switch to using write/write locks.
-  if (SSL_SESSION_should_be_single_use(session)) {
-    session_keys_single_use_ = true;
+void ClientContextImpl::setSession(SSL& ssl, const Network::Address::Instance& address) {
+  if (session_cache_ == nullptr) {
+    return;
+  }
+  // A session is only resumed with the server that issued it, which the SNI alone does not tell
+  // apart when the upstream hosts share a name but not their session ticket keys.
+  const char* server_name = SSL_get_servername(&ssl, TLSEXT_NAMETYPE_host_name);
+  auto key = std::make_unique<std::string>(
+      absl::StrCat(server_name != nullptr ? server_name : "", "|", address.asStringView()));
+  bssl::UniquePtr<SSL_SESSION> session = session_cache_->lookup(*key);
+  if (session != nullptr) {
+    SSL_set_session(&ssl, session.get());
   }
-  absl::WriterMutexLock l(&session_keys_mu_);
-  // Evict oldest entries.
-  while (session_keys_.size() >= max_session_keys_) {
-    session_keys_.pop_back();
+  SSL_set_ex_data(&ssl, sessionKeyIndex(), key.release());
+}
+
+int ClientContextImpl::newSessionKey(SSL* ssl, SSL_SESSION* session) {
+  const auto* key = static_cast<const std::string*>(SSL_get_ex_data(ssl, sessionKeyIndex()));
+  if (key == nullptr) {
+    // The connection has no upstream address to store the session under.
+    return 0;
   }
-  // Add new session key at the front of the queue, so that it's used first.
-  session_keys_.push_front(bssl::UniquePtr<SSL_SESSION>(session));
+  session_cache_->insert(*key, bssl::UniquePtr<SSL_SESSION>(session));
   return 1; // Tell BoringSSL that we took ownership of the session.
 }
 
@@ -1045,6 +1028,16 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
   // is used. We do this early because it can throw an EnvoyException.
   const SessionContextID session_id = generateHashForSessionContextId(server_names);
 
+  if (!config.capabilities().provides_certificates) {
+    indexTlsContexts();
+  }
+  dynamic_record_sizing_ = config.dynamicRecordSizing();
+
+  if (config.maxSessionCacheSize().value_or(0) > 0 &&
+      !config.capabilities().handles_session_resumption) {
+    session_cache_ = std::make_unique<ServerSessionCache>(config.maxSessionCacheSize().value());
+  }
+
   // First, configure the base context for ClientHello interception.
   // TODO(htuch): replace with SSL_IDENTITY when we have this as a means to do multi-cert in
   // BoringSSL.
@@ -1101,6 +1094,31 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
       SSL_CTX_set_timeout(ctx.ssl_ctx_.get(), uint32_t(timeout));
     }
 
+    // All the certificate contexts share the cache, as the context of a connection changes once its
+    // certificate is selected.
+    if (session_cache_ != nullptr) {
+      SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(),
+                                     SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+      SSL_CTX_sess_set_new_cb(ctx.ssl_ctx_.get(), [](SSL* ssl, SSL_SESSION* session) -> int {
+        serverContext(ssl).session_cache_->insert(bssl::UniquePtr<SSL_SESSION>(session));
+        // The cache took the reference to the session.
+        return 1;
+      });
+      SSL_CTX_sess_set_get_cb(
+          ctx.ssl_ctx_.get(),
+          [](SSL* ssl, const uint8_t* id, int id_length, int* out_copy) -> SSL_SESSION* {
+            // The returned reference is handed over to BoringSSL.
+            *out_copy = 0;
+            return serverContext(ssl)
+                .session_cache_
+                ->lookup(absl::string_view(reinterpret_cast<const char*>(id), id_length))
+                .release();
+          });
+    } else if (config.maxSessionCacheSize().has_value() &&
+               !config.capabilities().handles_session_resumption) {
+      SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(), SSL_SESS_CACHE_OFF);
+    }
+
     int rc =
         SSL_CTX_set_session_id_context(ctx.ssl_ctx_.get(), session_id.data(), session_id.size());
     RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
@@ -1125,6 +1143,13 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
   }
 }
 
+ServerContextImpl& ServerContextImpl::serverContext(SSL* ssl) {
+  ContextImpl* context_impl = static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+  ServerContextImpl* server_context_impl = dynamic_cast<ServerContextImpl*>(context_impl);
+  RELEASE_ASSERT(server_context_impl != nullptr, ""); // for Coverity
+  return *server_context_impl;
+}
+
 ServerContextImpl::SessionContextID
 ServerContextImpl::generateHashForSessionContextId(const std::vector<std::string>& server_names) {
   uint8_t hash_buffer[EVP_MAX_MD_SIZE];
@@ -1459,19 +1484,42 @@ ServerContextImpl::selectTlsContext(const SSL_CLIENT_HELLO* ssl_client_hello) {
   // Fallback on first certificate.
   const TlsContext* selected_ctx = &tls_contexts_[0];
   auto ocsp_staple_action = ocspStapleAction(*selected_ctx, client_ocsp_capable);
-  for (const auto& ctx : tls_contexts_) {
-    if (client_ecdsa_capable != ctx.is_ecdsa_) {
-      continue;
+  const auto select = [&](const TlsContext* ctx) {
+    if (ctx == nullptr) {
+      return false;
     }
-
-    auto action = ocspStapleAction(ctx, client_ocsp_capable);
+    const auto action = ocspStapleAction(*ctx, client_ocsp_capable);
     if (action == OcspStapleAction::Fail) {
-      continue;
+      return false;
     }
-
-    selected_ctx = &ctx;
+    selected_ctx = ctx;
     ocsp_staple_action = action;
-    break;
+    return true;
+  };
+
+  // Prefer a certificate for the SNI, exact names before wildcards, and of the key type of the
+  // client before RSA.
+  bool selected = false;
+  const char* server_name = SSL_get_servername(ssl_client_hello->ssl, TLSEXT_NAMETYPE_host_name);
+  if (server_name != nullptr && !contexts_by_name_.empty()) {
+    const std::string name = absl::AsciiStrToLower(server_name);
+    auto it = contexts_by_name_.find(name);
+    if (it == contexts_by_name_.end()) {
+      const size_t dot = name.find('.');
+      if (dot != std::string::npos) {
+        it = contexts_by_name_.find(absl::StrCat("*", absl::string_view(name).substr(dot)));
+      }
+    }
+    if (it != contexts_by_name_.end()) {
+      selected = (client_ecdsa_capable && select(it->second[true])) || select(it->second[false]);
+    }
+  }
+  if (!selected) {
+    for (const TlsContext* ctx : contexts_by_key_type_[client_ecdsa_capable]) {
+      if (select(ctx)) {
+        break;
+      }
+    }
   }
 
   if (client_ocsp_capable) {
@@ -1503,6 +1551,22 @@ ServerContextImpl::selectTlsContext(const SSL_CLIENT_HELLO* ssl_client_hello) {
   return ssl_select_cert_success;
 }
 
+void ServerContextImpl::indexTlsContexts() {
+  for (const TlsContext& ctx : tls_contexts_) {
+    contexts_by_key_type_[ctx.is_ecdsa_].push_back(&ctx);
+    for (const std::string& name : certificateNames(*ctx.cert_chain_)) {
+      const TlsContext*& name_ctx = contexts_by_name_[name][ctx.is_ecdsa_];
+      if (name_ctx != nullptr && name_ctx != &ctx) {
+        throw EnvoyException(fmt::format(
+            "Failed to load certificate chain from {}, at most one certificate of a given type "
+            "may be specified for each DNS SAN entry or subject CN: {}",
+            ctx.cert_chain_file_path_, name));
+      }
+      name_ctx = &ctx;
+    }
+  }
+}
+
 void ServerContextImpl::TlsContext::addClientValidationContext(
     const Envoy::Ssl::CertificateValidationContextConfig& config, bool require_client_cert) {
   bssl::UniquePtr<BIO> bio(
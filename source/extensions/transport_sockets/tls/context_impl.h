@@ -1,11 +1,11 @@
 #pragma once
 
 #include <array>
-#include <deque>
 #include <functional>
 #include <string>
 #include <vector>
 
+#include "envoy/network/address.h"
 #include "envoy/network/transport_socket.h"
 #include "envoy/ssl/context.h"
 #include "envoy/ssl/context_config.h"
@@ -19,8 +19,9 @@
 
 #include "extensions/transport_sockets/tls/context_manager_impl.h"
 #include "extensions/transport_sockets/tls/ocsp/ocsp.h"
+#include "extensions/transport_sockets/tls/session_cache.h"
 
-#include "absl/synchronization/mutex.h"
+#include "absl/container/flat_hash_map.h"
 #include "openssl/ssl.h"
 #include "openssl/x509v3.h"
 
@@ -45,7 +46,11 @@ namespace Tls {
   COUNTER(ocsp_staple_failed)                                                                      \
   COUNTER(ocsp_staple_omitted)                                                                     \
   COUNTER(ocsp_staple_responses)                                                                   \
-  COUNTER(ocsp_staple_requests)
+  COUNTER(ocsp_staple_requests)                                                                    \
+  COUNTER(small_records)                                                                           \
+  COUNTER(record_size_resets)                                                                      \
+  COUNTER(early_data)                                                                              \
+  COUNTER(early_data_rejected)
 
 /**
  * Wrapper struct for SSL stats. @see stats_macros.h
@@ -56,6 +61,8 @@ struct SslStats {
 
 class ContextImpl : public virtual Envoy::Ssl::Context {
 public:
+  ~ContextImpl() override;
+
   virtual bssl::UniquePtr<SSL> newSsl(const Network::TransportSocketOptions* options);
 
   /**
@@ -93,6 +100,22 @@ public:
 
   SslStats& stats() { return stats_; }
 
+  /**
+   * @return how the records written on the connections are sized, if they are sized dynamically.
+   */
+  const absl::optional<Ssl::ServerContextConfig::DynamicRecordSizing>&
+  dynamicRecordSizing() const {
+    return dynamic_record_sizing_;
+  }
+
+  /**
+   * Sets the session that a new client connection resumes, if any. Only client contexts resume
+   * sessions.
+   * @param ssl supplies the connection, before its handshake starts.
+   * @param address supplies the address of the upstream server of the connection.
+   */
+  virtual void setSession(SSL&, const Network::Address::Instance&) {}
+
   /**
    * The global SSL-library index used for storing a pointer to the SslExtendedSocketInfo
    * class in the SSL instance, for retrieval in callbacks.
@@ -220,6 +243,11 @@ protected:
   const Stats::StatName ssl_curves_;
   const Stats::StatName ssl_sigalgs_;
   const Ssl::HandshakerCapabilities capabilities_;
+  // Keeps the objects parsed out of the PEM data of the config shared with the other contexts while
+  // this one uses them. @see PemCache
+  std::vector<std::shared_ptr<const void>> parsed_pem_;
+  // Only set for the server contexts that size their records dynamically.
+  absl::optional<Ssl::ServerContextConfig::DynamicRecordSizing> dynamic_record_sizing_;
 };
 
 using ContextImplSharedPtr = std::shared_ptr<ContextImpl>;
@@ -230,17 +258,19 @@ public:
                     TimeSource& time_source);
 
   bssl::UniquePtr<SSL> newSsl(const Network::TransportSocketOptions* options) override;
+  void setSession(SSL& ssl, const Network::Address::Instance& address) override;
 
 private:
-  int newSessionKey(SSL_SESSION* session);
+  int newSessionKey(SSL* ssl, SSL_SESSION* session);
   uint16_t parseSigningAlgorithmsForTest(const std::string& sigalgs);
+  // The SSL-library index used for storing the key of the upstream server of a connection in the
+  // SSL instance, for storing its new sessions.
+  static int sessionKeyIndex();
 
   const std::string server_name_indication_;
   const bool allow_renegotiation_;
-  const size_t max_session_keys_;
-  absl::Mutex session_keys_mu_;
-  std::deque<bssl::UniquePtr<SSL_SESSION>> session_keys_ ABSL_GUARDED_BY(session_keys_mu_);
-  bool session_keys_single_use_{false};
+  // The sessions by the SNI and address of their upstream server, if sessions are resumed.
+  std::unique_ptr<ClientSessionCache> session_cache_;
 };
 
 enum class OcspStapleAction { Staple, NoStaple, Fail, ClientNotCapable };
@@ -264,11 +294,25 @@ private:
   enum ssl_select_cert_result_t selectTlsContext(const SSL_CLIENT_HELLO* ssl_client_hello);
   OcspStapleAction ocspStapleAction(const ServerContextImpl::TlsContext& ctx,
                                     bool client_ocsp_capable);
+  // Indexes the certificate contexts by the names and key type of their certificate.
+  void indexTlsContexts();
 
   SessionContextID generateHashForSessionContextId(const std::vector<std::string>& server_names);
+  static ServerContextImpl& serverContext(SSL* ssl);
 
   const std::vector<Envoy::Ssl::ServerContextConfig::SessionTicketKey> session_ticket_keys_;
   const Ssl::ServerContextConfig::OcspStaplePolicy ocsp_staple_policy_;
+  // The cache of the sessions resumed by session ID, if it is not left to BoringSSL.
+  std::unique_ptr<ServerSessionCache> session_cache_;
+  // The contexts of a name, indexed by whether their certificate is ECDSA, or nullptr.
+  using KeyTypeContexts = std::array<const TlsContext*, 2>;
+  // The contexts by the lower case DNS SANs of their certificate, or its subject CN if it has no
+  // DNS SAN, wildcards included as is, so that the SNI selects a certificate without scanning
+  // all of them.
+  absl::flat_hash_map<std::string, KeyTypeContexts> contexts_by_name_;
+  // The contexts of each key type, in the configured order, for the clients whose SNI matches no
+  // certificate.
+  std::array<std::vector<const TlsContext*>, 2> contexts_by_key_type_;
 };
 
 } // namespace Tls
@@ -0,0 +1,210 @@
+#include "extensions/transport_sockets/tls/kernel_tls.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+
+#include "absl/container/fixed_array.h"
+
+#include "openssl/err.h"
+#include "openssl/mem.h"
+#include "openssl/nid.h"
+
+#if defined(__linux__)
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+#if defined(__linux__)
+namespace {
+
+// TLS record content types, RFC 5246 section 6.2.1.
+constexpr uint8_t RecordTypeAlert = 21;
+constexpr uint8_t RecordTypeApplicationData = 23;
+// Alert levels and descriptions, RFC 5246 section 7.2.
+constexpr uint8_t AlertLevelWarning = 1;
+constexpr uint8_t AlertDescriptionCloseNotify = 0;
+
+// The implicit part of the AES-GCM nonce, derived from the key block.
+constexpr size_t SaltLength = 4;
+constexpr size_t MaxKeyLength = 32;
+
+void putSequence(uint64_t sequence, unsigned char* out) {
+  for (int i = 7; i >= 0; i--) {
+    out[i] = sequence & 0xff;
+    sequence >>= 8;
+  }
+}
+
+template <class CryptoInfo>
+bool installKeys(Network::IoHandle& io_handle, int direction, uint16_t cipher_type,
+                 const uint8_t* key, const uint8_t* salt, uint64_t sequence) {
+  CryptoInfo info;
+  memset(&info, 0, sizeof(info));
+  info.info.version = TLS_1_2_VERSION;
+  info.info.cipher_type = cipher_type;
+  memcpy(info.key, key, sizeof(info.key));
+  memcpy(info.salt, salt, sizeof(info.salt));
+  // TLS 1.2 AES-GCM uses the record sequence number as the explicit part of the nonce.
+  putSequence(sequence, info.iv);
+  putSequence(sequence, info.rec_seq);
+  const bool installed = io_handle.setOption(SOL_TLS, direction, &info, sizeof(info)).rc_ == 0;
+  OPENSSL_cleanse(&info, sizeof(info));
+  return installed;
+}
+
+} // namespace
+
+KernelTls::OffloadResult KernelTls::enable(SSL* ssl, Network::IoHandle& io_handle) {
+  OffloadResult result;
+  if (SSL_version(ssl) != TLS1_2_VERSION || SSL_in_init(ssl) || SSL_in_false_start(ssl)) {
+    return result;
+  }
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+  const int cipher_nid = cipher != nullptr ? SSL_CIPHER_get_cipher_nid(cipher) : NID_undef;
+  size_t key_length;
+  if (cipher_nid == NID_aes_128_gcm) {
+    key_length = TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+  } else if (cipher_nid == NID_aes_256_gcm) {
+    key_length = TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+  } else {
+    return result;
+  }
+
+  // For AEAD ciphers the key block is client key, server key, client salt, server salt.
+  uint8_t key_block[2 * (MaxKeyLength + SaltLength)];
+  const size_t key_block_length = 2 * (key_length + SaltLength);
+  if (SSL_get_key_block_len(ssl) != key_block_length ||
+      !SSL_generate_key_block(ssl, key_block, key_block_length)) {
+    ERR_clear_error();
+    return result;
+  }
+  const uint8_t* client_key = key_block;
+  const uint8_t* server_key = key_block + key_length;
+  const uint8_t* client_salt = key_block + 2 * key_length;
+  const uint8_t* server_salt = client_salt + SaltLength;
+  const bool is_server = SSL_is_server(ssl);
+
+  const auto install = [&](int direction, bool write) -> bool {
+    const bool own_keys = write == is_server;
+    const uint8_t* key = own_keys ? server_key : client_key;
+    const uint8_t* salt = own_keys ? server_salt : client_salt;
+    const uint64_t sequence = write ? SSL_get_write_sequence(ssl) : SSL_get_read_sequence(ssl);
+    if (key_length == TLS_CIPHER_AES_GCM_128_KEY_SIZE) {
+      return installKeys<tls12_crypto_info_aes_gcm_128>(
+          io_handle, direction, TLS_CIPHER_AES_GCM_128, key, salt, sequence);
+    }
+    return installKeys<tls12_crypto_info_aes_gcm_256>(io_handle, direction, TLS_CIPHER_AES_GCM_256,
+                                                      key, salt, sequence);
+  };
+
+  // The socket keeps behaving like a plain TCP socket until keys are installed, so failing any of
+  // these steps leaves the session to BoringSSL.
+  static constexpr char UlpName[] = "tls";
+  if (io_handle.setOption(IPPROTO_TCP, TCP_ULP, UlpName, sizeof(UlpName)).rc_ == 0 &&
+      install(TLS_TX, true)) {
+    result.tx_ = true;
+    result.rx_ = !SSL_has_pending(ssl) && install(TLS_RX, false);
+  }
+  OPENSSL_cleanse(key_block, sizeof(key_block));
+  return result;
+}
+
+KernelTls::ReadResult KernelTls::read(os_fd_t fd, Buffer::RawSlice* slices,
+                                      uint64_t num_slices) {
+  absl::FixedArray<iovec> iov(num_slices);
+  for (uint64_t i = 0; i < num_slices; i++) {
+    iov[i].iov_base = slices[i].mem_;
+    iov[i].iov_len = slices[i].len_;
+  }
+  char control[CMSG_SPACE(sizeof(uint8_t))];
+  msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = iov.begin();
+  msg.msg_iovlen = num_slices;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  ReadResult result;
+  result.result_ = Api::OsSysCallsSingleton::get().recvmsg(fd, &msg, 0);
+  if (result.result_.rc_ <= 0) {
+    return result;
+  }
+  const cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  if (cmsg == nullptr || cmsg->cmsg_level != SOL_TLS || cmsg->cmsg_type != TLS_GET_RECORD_TYPE) {
+    return result;
+  }
+  const uint8_t record_type = *reinterpret_cast<const uint8_t*>(CMSG_DATA(cmsg));
+  if (record_type == RecordTypeApplicationData) {
+    return result;
+  }
+
+  // A record other than application data is always returned on its own.
+  uint8_t alert[2];
+  uint64_t copied = 0;
+  for (uint64_t i = 0; i < num_slices && copied < sizeof(alert); i++) {
+    const uint64_t to_copy = std::min<uint64_t>(iov[i].iov_len, sizeof(alert) - copied);
+    memcpy(alert + copied, iov[i].iov_base, to_copy);
+    copied += to_copy;
+  }
+  if (record_type == RecordTypeAlert && result.result_.rc_ == sizeof(alert) &&
+      alert[1] == AlertDescriptionCloseNotify) {
+    result.close_notify_ = true;
+  } else {
+    result.unexpected_record_ = true;
+  }
+  result.result_.rc_ = 0;
+  return result;
+}
+
+Api::SysCallSizeResult KernelTls::sendCloseNotify(os_fd_t fd) {
+  uint8_t alert[2] = {AlertLevelWarning, AlertDescriptionCloseNotify};
+  iovec iov;
+  iov.iov_base = alert;
+  iov.iov_len = sizeof(alert);
+  char control[CMSG_SPACE(sizeof(uint8_t))];
+  memset(control, 0, sizeof(control));
+  msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+  *reinterpret_cast<uint8_t*>(CMSG_DATA(cmsg)) = RecordTypeAlert;
+  return Api::OsSysCallsSingleton::get().sendmsg(fd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+}
+
+#else
+
+KernelTls::OffloadResult KernelTls::enable(SSL*, Network::IoHandle&) { return {}; }
+
+KernelTls::ReadResult KernelTls::read(os_fd_t, Buffer::RawSlice*, uint64_t) {
+  NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+}
+
+Api::SysCallSizeResult KernelTls::sendCloseNotify(os_fd_t) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+#endif
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
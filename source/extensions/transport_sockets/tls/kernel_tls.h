@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/api/os_sys_calls_common.h"
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/platform.h"
+#include "envoy/network/io_handle.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Offload of TLS record processing to the kernel (kTLS). Once the keys of an established session
+ * are installed into the socket, the kernel encrypts what is written to it and decrypts what is
+ * read from it, so the connection can be served like a plaintext socket.
+ */
+class KernelTls {
+public:
+  struct OffloadResult {
+    // Records sent on the socket are encrypted by the kernel. BoringSSL must not write anymore.
+    bool tx_{};
+    // Records received on the socket are decrypted by the kernel. BoringSSL must not read anymore.
+    bool rx_{};
+  };
+
+  struct ReadResult {
+    // The number of application data bytes read, or the error.
+    Api::SysCallSizeResult result_;
+    // The peer sent a close_notify alert.
+    bool close_notify_{};
+    // The peer sent a record other than application data or a close_notify alert, which cannot be
+    // handled once the session is offloaded.
+    bool unexpected_record_{};
+  };
+
+  /**
+   * Install the keys of the session established by ssl into the socket of io_handle. Only
+   * TLS 1.2 sessions using AES-GCM are offloaded: the kernel cannot follow the key updates of
+   * TLS 1.3. Receiving is only offloaded if BoringSSL has not buffered any data beyond the
+   * handshake.
+   * @return the directions that were offloaded; nothing is offloaded if the platform, the kernel
+   *         or the session do not support it.
+   */
+  static OffloadResult enable(SSL* ssl, Network::IoHandle& io_handle);
+
+  /**
+   * Read from a socket whose receive direction is offloaded.
+   * @param fd the socket.
+   * @param slices the memory to read application data into.
+   * @param num_slices the number of slices.
+   */
+  static ReadResult read(os_fd_t fd, Buffer::RawSlice* slices, uint64_t num_slices);
+
+  /**
+   * Send a close_notify alert on a socket whose send direction is offloaded.
+   */
+  static Api::SysCallSizeResult sendCloseNotify(os_fd_t fd);
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
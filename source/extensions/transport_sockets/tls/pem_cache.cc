@@ -0,0 +1,190 @@
+#include "extensions/transport_sockets/tls/pem_cache.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+
+#include "openssl/err.h"
+#include "openssl/sha.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+namespace {
+
+std::string cacheKey(absl::string_view kind, absl::string_view pem, absl::string_view password) {
+  SHA256_CTX sha256;
+  SHA256_Init(&sha256);
+  for (const absl::string_view part : {kind, password, pem}) {
+    const uint64_t size = part.size();
+    SHA256_Update(&sha256, &size, sizeof(size));
+    SHA256_Update(&sha256, part.data(), part.size());
+  }
+  std::string digest(SHA256_DIGEST_LENGTH, '\0');
+  SHA256_Final(reinterpret_cast<uint8_t*>(&digest[0]), &sha256);
+  return digest;
+}
+
+bssl::UniquePtr<BIO> pemBio(absl::string_view pem) {
+  bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(pem.data(), pem.size()));
+  RELEASE_ASSERT(bio != nullptr, "");
+  return bio;
+}
+
+} // namespace
+
+PemCache& PemCache::get() { MUTABLE_CONSTRUCT_ON_FIRST_USE(PemCache); }
+
+template <class T>
+std::shared_ptr<const T> PemCache::getOrParse(absl::string_view kind, absl::string_view pem,
+                                              absl::string_view password,
+                                              const std::function<std::unique_ptr<T>()>& parse) {
+  const std::string key = cacheKey(kind, pem, password);
+  absl::MutexLock lock(&mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    std::shared_ptr<const void> entry = it->second.lock();
+    if (entry != nullptr) {
+      return std::static_pointer_cast<const T>(entry);
+    }
+  }
+
+  std::shared_ptr<const T> parsed = parse();
+  if (parsed == nullptr) {
+    return nullptr;
+  }
+  entries_.insert_or_assign(key, parsed);
+  // The expired entries are removed once their number may have doubled, so that adding an entry
+  // takes amortized constant time.
+  if (entries_.size() >= 2 * entries_after_cleanup_) {
+    for (auto entry = entries_.begin(); entry != entries_.end();) {
+      if (entry->second.expired()) {
+        entries_.erase(entry++);
+      } else {
+        ++entry;
+      }
+    }
+    entries_after_cleanup_ = std::max<size_t>(entries_.size(), 16);
+  }
+  return parsed;
+}
+
+std::shared_ptr<const PemCache::CertificateChain>
+PemCache::certificateChain(absl::string_view pem) {
+  return getOrParse<CertificateChain>("certificate_chain", pem, "", [pem]() {
+    bssl::UniquePtr<BIO> bio = pemBio(pem);
+    auto chain = std::make_unique<CertificateChain>();
+    chain->leaf_.reset(PEM_read_bio_X509_AUX(bio.get(), nullptr, nullptr, nullptr));
+    if (chain->leaf_ == nullptr) {
+      return std::unique_ptr<CertificateChain>();
+    }
+    // Read rest of the certificate chain.
+    while (true) {
+      bssl::UniquePtr<X509> cert(PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr));
+      if (cert == nullptr) {
+        break;
+      }
+      chain->intermediates_.push_back(std::move(cert));
+    }
+    // Check for EOF.
+    const uint32_t err = ERR_peek_last_error();
+    if (ERR_GET_LIB(err) != ERR_LIB_PEM || ERR_GET_REASON(err) != PEM_R_NO_START_LINE) {
+      return std::unique_ptr<CertificateChain>();
+    }
+    ERR_clear_error();
+    return chain;
+  });
+}
+
+std::shared_ptr<const PemCache::X509InfoList> PemCache::x509InfoList(absl::string_view pem) {
+  return getOrParse<X509InfoList>("x509_info", pem, "", [pem]() {
+    bssl::UniquePtr<BIO> bio = pemBio(pem);
+    auto list = std::make_unique<X509InfoList>();
+    // Based on BoringSSL's X509_load_cert_crl_file().
+    list->list_.reset(PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
+    if (list->list_ == nullptr) {
+      return std::unique_ptr<X509InfoList>();
+    }
+    return list;
+  });
+}
+
+std::shared_ptr<const PemCache::PrivateKey> PemCache::privateKey(absl::string_view pem,
+                                                                 const std::string& password) {
+  return getOrParse<PrivateKey>("private_key", pem, password, [pem, &password]() {
+    bssl::UniquePtr<BIO> bio = pemBio(pem);
+    auto key = std::make_unique<PrivateKey>();
+    key->pkey_.reset(PEM_read_bio_PrivateKey(
+        bio.get(), nullptr, nullptr,
+        !password.empty() ? const_cast<char*>(password.c_str()) : nullptr));
+    if (key->pkey_ == nullptr) {
+      return std::unique_ptr<PrivateKey>();
+    }
+    return key;
+  });
+}
+
+std::shared_ptr<const PemCache::CertStore>
+PemCache::certStore(std::shared_ptr<const X509InfoList> trusted_ca,
+                    std::shared_ptr<const X509InfoList> crl, X509_STORE_CTX_verify_cb verify_cb) {
+  // The lists are keyed by identity: the cached ones are shared by the users of the same PEM data,
+  // and the store keeps them alive, so that their addresses are not reused while it is cached.
+  const uintptr_t identity[] = {reinterpret_cast<uintptr_t>(trusted_ca.get()),
+                                reinterpret_cast<uintptr_t>(crl.get()),
+                                reinterpret_cast<uintptr_t>(verify_cb)};
+  const absl::string_view key(reinterpret_cast<const char*>(identity), sizeof(identity));
+  return getOrParse<CertStore>("cert_store", key, "", [&trusted_ca, &crl, verify_cb]() {
+    auto cert_store = std::make_unique<CertStore>();
+    cert_store->store_.reset(X509_STORE_new());
+    RELEASE_ASSERT(cert_store->store_ != nullptr, "");
+    X509_STORE* store = cert_store->store_.get();
+    bool has_crl = false;
+    if (trusted_ca != nullptr) {
+      for (const X509_INFO* item : trusted_ca->list_.get()) {
+        if (item->x509 != nullptr) {
+          X509_STORE_add_cert(store, item->x509);
+        }
+        if (item->crl != nullptr) {
+          X509_STORE_add_crl(store, item->crl);
+          has_crl = true;
+        }
+      }
+    }
+    if (crl != nullptr) {
+      for (const X509_INFO* item : crl->list_.get()) {
+        if (item->crl != nullptr) {
+          X509_STORE_add_crl(store, item->crl);
+        }
+      }
+    }
+    if (has_crl || crl != nullptr) {
+      X509_STORE_set_flags(store, X509_V_FLAG_CRL_CHECK | X509_V_FLAG_CRL_CHECK_ALL);
+    }
+    if (verify_cb != nullptr) {
+      X509_STORE_set_verify_cb(store, verify_cb);
+    }
+    cert_store->trusted_ca_ = std::move(trusted_ca);
+    cert_store->crl_ = std::move(crl);
+    return cert_store;
+  });
+}
+
+size_t PemCache::size() {
+  absl::MutexLock lock(&mutex_);
+  size_t size = 0;
+  for (const auto& entry : entries_) {
+    if (!entry.second.expired()) {
+      ++size;
+    }
+  }
+  return size;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/pem.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Shares the objects parsed out of the same PEM data between the TLS contexts of the process, so
+ * that the listeners and clusters using the same certificate chain, private key or trusted CAs
+ * reference one parsed copy of them rather than one each. The parsed objects are never modified,
+ * and the cache only holds them weakly: they are freed with the last context using them. Entries
+ * are keyed by a SHA-256 digest of the PEM data and password, so the cache keeps no copy of the
+ * private keys.
+ *
+ * The certificate stores built from the trusted CAs and CRLs are shared the same way, so that a
+ * context created when a certificate is rotated reuses the store of the context it replaces.
+ */
+class PemCache {
+public:
+  struct CertificateChain {
+    bssl::UniquePtr<X509> leaf_;
+    std::vector<bssl::UniquePtr<X509>> intermediates_;
+  };
+
+  struct X509InfoList {
+    bssl::UniquePtr<STACK_OF(X509_INFO)> list_;
+  };
+
+  struct PrivateKey {
+    bssl::UniquePtr<EVP_PKEY> pkey_;
+  };
+
+  struct CertStore {
+    // Only read once built, which the verifications do concurrently.
+    bssl::UniquePtr<X509_STORE> store_;
+    // The lists the store was built from, kept so that they are not parsed again while in use.
+    std::shared_ptr<const X509InfoList> trusted_ca_;
+    std::shared_ptr<const X509InfoList> crl_;
+  };
+
+  /**
+   * @return PemCache& the cache of the process.
+   */
+  static PemCache& get();
+
+  /**
+   * @return the certificate chain parsed from the PEM data, or nullptr if it does not start with a
+   *         certificate or is followed by anything else than certificates.
+   */
+  std::shared_ptr<const CertificateChain> certificateChain(absl::string_view pem);
+
+  /**
+   * @return the certificates and CRLs parsed from the PEM data, or nullptr if it does not parse.
+   */
+  std::shared_ptr<const X509InfoList> x509InfoList(absl::string_view pem);
+
+  /**
+   * @return the private key parsed from the PEM data, or nullptr if it does not parse or the
+   *         password is wrong.
+   */
+  std::shared_ptr<const PrivateKey> privateKey(absl::string_view pem, const std::string& password);
+
+  /**
+   * @param trusted_ca supplies the trusted CAs and their CRLs, or nullptr.
+   * @param crl supplies more CRLs, or nullptr.
+   * @param verify_cb supplies the verification callback of the store, or nullptr for the default.
+   * @return the certificate store of the trusted CAs and of the CRLs, checking the CRLs of the
+   *         whole chain if there are any.
+   */
+  std::shared_ptr<const CertStore> certStore(std::shared_ptr<const X509InfoList> trusted_ca,
+                                             std::shared_ptr<const X509InfoList> crl,
+                                             X509_STORE_CTX_verify_cb verify_cb);
+
+  /**
+   * @return size_t the number of parsed objects in use.
+   */
+  size_t size();
+
+private:
+  template <class T>
+  std::shared_ptr<const T> getOrParse(absl::string_view kind, absl::string_view pem,
+                                      absl::string_view password,
+                                      const std::function<std::unique_ptr<T>()>& parse);
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::weak_ptr<const void>> entries_ ABSL_GUARDED_BY(mutex_);
+  // The number of entries after expired ones were last removed.
+  size_t entries_after_cleanup_ ABSL_GUARDED_BY(mutex_){};
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
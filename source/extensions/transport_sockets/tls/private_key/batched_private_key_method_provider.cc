@@ -0,0 +1,152 @@
+#include "extensions/transport_sockets/tls/private_key/batched_private_key_method_provider.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+BatchedPrivateKeyMethodProvider::Batcher::Batcher(Event::Dispatcher& dispatcher,
+                                                  PrivateKeyBatchProcessorSharedPtr processor,
+                                                  uint32_t max_batch_size,
+                                                  std::chrono::microseconds max_batch_delay)
+    : dispatcher_(dispatcher), processor_(std::move(processor)), max_batch_size_(max_batch_size),
+      max_batch_delay_(max_batch_delay), timer_(dispatcher.createTimer([this]() { flush(); })) {}
+
+void BatchedPrivateKeyMethodProvider::Batcher::add(PrivateKeyOperationSharedPtr operation) {
+  pending_.push_back(std::move(operation));
+  if (pending_.size() >= max_batch_size_) {
+    flush();
+  } else if (!timer_->enabled()) {
+    timer_->enableHRTimer(max_batch_delay_);
+  }
+}
+
+void BatchedPrivateKeyMethodProvider::Batcher::flush() {
+  timer_->disableTimer();
+  std::vector<PrivateKeyOperationSharedPtr> batch;
+  batch.reserve(pending_.size());
+  // The operations of the connections that have gone away are not processed.
+  for (PrivateKeyOperationSharedPtr& operation : pending_) {
+    if (operation->callbacks_ != nullptr) {
+      batch.push_back(std::move(operation));
+    }
+  }
+  pending_.clear();
+  if (batch.empty()) {
+    return;
+  }
+
+  // The handshakes are resumed on the worker, whichever thread the batch completes on.
+  Event::Dispatcher& dispatcher = dispatcher_;
+  processor_->processBatch(batch, [&dispatcher, batch]() {
+    dispatcher.post([batch]() {
+      for (const PrivateKeyOperationSharedPtr& operation : batch) {
+        operation->completed_ = true;
+        if (operation->callbacks_ != nullptr) {
+          operation->callbacks_->onPrivateKeyMethodComplete();
+        }
+      }
+    });
+  });
+}
+
+BatchedPrivateKeyMethodProvider::BatchedPrivateKeyMethodProvider(
+    PrivateKeyBatchProcessorSharedPtr processor, ThreadLocal::SlotAllocator& tls,
+    uint32_t max_batch_size, std::chrono::microseconds max_batch_delay)
+    : processor_(std::move(processor)), max_batch_size_(std::max<uint32_t>(max_batch_size, 1)),
+      max_batch_delay_(max_batch_delay), batchers_(tls),
+      method_(std::make_shared<SSL_PRIVATE_KEY_METHOD>()) {
+  batchers_.set([](Event::Dispatcher&) { return std::make_shared<ThreadLocalBatcher>(); });
+  method_->sign = [](SSL* ssl, uint8_t*, size_t*, size_t, uint16_t signature_algorithm,
+                     const uint8_t* in, size_t in_len) {
+    return start(ssl, PrivateKeyOperation::Type::Sign, signature_algorithm, in, in_len);
+  };
+  method_->decrypt = [](SSL* ssl, uint8_t*, size_t*, size_t, const uint8_t* in, size_t in_len) {
+    return start(ssl, PrivateKeyOperation::Type::Decrypt, 0, in, in_len);
+  };
+  method_->complete = complete;
+}
+
+void BatchedPrivateKeyMethodProvider::registerPrivateKeyMethod(
+    SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb, Event::Dispatcher& dispatcher) {
+  if (connection(ssl) != nullptr) {
+    throw EnvoyException("The SSL object is already registered with a batched private key method.");
+  }
+  ThreadLocalBatcher& thread_local_batcher = *batchers_;
+  if (thread_local_batcher.batcher_ == nullptr) {
+    thread_local_batcher.batcher_ =
+        std::make_unique<Batcher>(dispatcher, processor_, max_batch_size_, max_batch_delay_);
+  }
+  SSL_set_ex_data(ssl, connectionIndex(), new Connection(cb, *thread_local_batcher.batcher_));
+}
+
+void BatchedPrivateKeyMethodProvider::unregisterPrivateKeyMethod(SSL* ssl) {
+  Connection* connection = BatchedPrivateKeyMethodProvider::connection(ssl);
+  if (connection == nullptr) {
+    return;
+  }
+  if (connection->operation_ != nullptr) {
+    connection->operation_->callbacks_ = nullptr;
+  }
+  SSL_set_ex_data(ssl, connectionIndex(), nullptr);
+  delete connection;
+}
+
+int BatchedPrivateKeyMethodProvider::connectionIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, []() {
+    const int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    RELEASE_ASSERT(index >= 0, "Failed to get SSL user data index.");
+    return index;
+  }());
+}
+
+BatchedPrivateKeyMethodProvider::Connection* BatchedPrivateKeyMethodProvider::connection(SSL* ssl) {
+  return static_cast<Connection*>(SSL_get_ex_data(ssl, connectionIndex()));
+}
+
+ssl_private_key_result_t
+BatchedPrivateKeyMethodProvider::start(SSL* ssl, PrivateKeyOperation::Type type,
+                                       uint16_t signature_algorithm, const uint8_t* in,
+                                       size_t in_len) {
+  Connection* connection = BatchedPrivateKeyMethodProvider::connection(ssl);
+  if (connection == nullptr || connection->operation_ != nullptr) {
+    return ssl_private_key_failure;
+  }
+  auto operation = std::make_shared<PrivateKeyOperation>(type, signature_algorithm, in, in_len);
+  operation->callbacks_ = &connection->callbacks_;
+  connection->operation_ = operation;
+  connection->batcher_.add(std::move(operation));
+  return ssl_private_key_retry;
+}
+
+ssl_private_key_result_t BatchedPrivateKeyMethodProvider::complete(SSL* ssl, uint8_t* out,
+                                                                   size_t* out_len,
+                                                                   size_t max_out) {
+  Connection* connection = BatchedPrivateKeyMethodProvider::connection(ssl);
+  if (connection == nullptr || connection->operation_ == nullptr) {
+    return ssl_private_key_failure;
+  }
+  if (!connection->operation_->completed_) {
+    return ssl_private_key_retry;
+  }
+  const PrivateKeyOperationSharedPtr operation = std::move(connection->operation_);
+  if (!operation->succeeded_ || operation->output_.size() > max_out) {
+    return ssl_private_key_failure;
+  }
+  std::memcpy(out, operation->output_.data(), operation->output_.size());
+  *out_len = operation->output_.size();
+  return ssl_private_key_success;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/ssl/private_key/private_key.h"
+#include "envoy/ssl/private_key/private_key_callbacks.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * A signature or a decryption that a handshake waits for.
+ */
+class PrivateKeyOperation {
+public:
+  enum class Type { Sign, Decrypt };
+
+  PrivateKeyOperation(Type type, uint16_t signature_algorithm, const uint8_t* in, size_t in_len)
+      : type_(type), signature_algorithm_(signature_algorithm), input_(in, in + in_len) {}
+
+  const Type type_;
+  // The TLS signature algorithm of a signature, e.g. SSL_SIGN_RSA_PSS_RSAE_SHA256.
+  const uint16_t signature_algorithm_;
+  const std::vector<uint8_t> input_;
+  // Set by the processor of the batch.
+  bool succeeded_{};
+  std::vector<uint8_t> output_;
+
+private:
+  friend class BatchedPrivateKeyMethodProvider;
+
+  // The connection to resume once the operation completes, or nullptr if it has gone away.
+  Ssl::PrivateKeyConnectionCallbacks* callbacks_{};
+  bool completed_{};
+};
+
+using PrivateKeyOperationSharedPtr = std::shared_ptr<PrivateKeyOperation>;
+
+/**
+ * Runs the private key operations of a batch together, e.g. on a hardware accelerator or with a
+ * multi-buffer implementation of the algorithm.
+ */
+class PrivateKeyBatchProcessor {
+public:
+  virtual ~PrivateKeyBatchProcessor() = default;
+
+  /**
+   * Processes a batch, setting the outcome and output of each of its operations. Called on the
+   * worker thread that started the operations.
+   * @param batch supplies the operations, at least one.
+   * @param done supplies the callback to call once all the operations have completed, from any
+   *        thread and possibly before processBatch() returns.
+   */
+  virtual void processBatch(const std::vector<PrivateKeyOperationSharedPtr>& batch,
+                            std::function<void()> done) PURE;
+};
+
+using PrivateKeyBatchProcessorSharedPtr = std::shared_ptr<PrivateKeyBatchProcessor>;
+
+/**
+ * A private key method provider that accumulates the operations that the handshakes of a worker
+ * start, and hands them over to a processor in batches rather than one at a time. A batch is
+ * processed once it holds max_batch_size operations, or max_batch_delay after its first operation
+ * started. The handshakes resume on their worker once their batch has been processed. Providers
+ * for devices that are faster with many operations at once build on it by implementing a
+ * PrivateKeyBatchProcessor.
+ */
+class BatchedPrivateKeyMethodProvider : public virtual Ssl::PrivateKeyMethodProvider {
+public:
+  BatchedPrivateKeyMethodProvider(PrivateKeyBatchProcessorSharedPtr processor,
+                                  ThreadLocal::SlotAllocator& tls, uint32_t max_batch_size,
+                                  std::chrono::microseconds max_batch_delay);
+
+  // Ssl::PrivateKeyMethodProvider
+  void registerPrivateKeyMethod(SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb,
+                                Event::Dispatcher& dispatcher) override;
+  void unregisterPrivateKeyMethod(SSL* ssl) override;
+  Ssl::BoringSslPrivateKeyMethodSharedPtr getBoringSslPrivateKeyMethod() override {
+    return method_;
+  }
+
+private:
+  // The operations of a worker that wait for their batch to be processed.
+  class Batcher {
+  public:
+    Batcher(Event::Dispatcher& dispatcher, PrivateKeyBatchProcessorSharedPtr processor,
+            uint32_t max_batch_size, std::chrono::microseconds max_batch_delay);
+
+    void add(PrivateKeyOperationSharedPtr operation);
+
+  private:
+    void flush();
+
+    Event::Dispatcher& dispatcher_;
+    const PrivateKeyBatchProcessorSharedPtr processor_;
+    const uint32_t max_batch_size_;
+    const std::chrono::microseconds max_batch_delay_;
+    const Event::TimerPtr timer_;
+    std::vector<PrivateKeyOperationSharedPtr> pending_;
+  };
+
+  // The batcher of a worker is created by its first handshake.
+  struct ThreadLocalBatcher : public ThreadLocal::ThreadLocalObject {
+    std::unique_ptr<Batcher> batcher_;
+  };
+
+  // The state of a registered connection, in the ex_data of its SSL object.
+  struct Connection {
+    Connection(Ssl::PrivateKeyConnectionCallbacks& callbacks, Batcher& batcher)
+        : callbacks_(callbacks), batcher_(batcher) {}
+
+    Ssl::PrivateKeyConnectionCallbacks& callbacks_;
+    Batcher& batcher_;
+    PrivateKeyOperationSharedPtr operation_;
+  };
+
+  static int connectionIndex();
+  static Connection* connection(SSL* ssl);
+  static ssl_private_key_result_t start(SSL* ssl, PrivateKeyOperation::Type type,
+                                        uint16_t signature_algorithm, const uint8_t* in,
+                                        size_t in_len);
+  static ssl_private_key_result_t complete(SSL* ssl, uint8_t* out, size_t* out_len,
+                                           size_t max_out);
+
+  const PrivateKeyBatchProcessorSharedPtr processor_;
+  const uint32_t max_batch_size_;
+  const std::chrono::microseconds max_batch_delay_;
+  ThreadLocal::TypedSlot<ThreadLocalBatcher> batchers_;
+  const Ssl::BoringSslPrivateKeyMethodSharedPtr method_;
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,146 @@
+#include "extensions/transport_sockets/tls/session_cache.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+
+#include "absl/hash/hash.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+ServerSessionCache::ServerSessionCache(uint32_t max_size) {
+  ASSERT(max_size > 0);
+  const uint32_t num_shards = std::min(max_size, MaxShards);
+  shards_.reserve(num_shards);
+  for (uint32_t i = 0; i < num_shards; ++i) {
+    shards_.push_back(std::make_unique<Shard>());
+    shards_.back()->max_size_ = max_size / num_shards + (i < max_size % num_shards ? 1 : 0);
+  }
+}
+
+ServerSessionCache::Shard& ServerSessionCache::shard(absl::string_view id) {
+  return *shards_[absl::Hash<absl::string_view>()(id) % shards_.size()];
+}
+
+void ServerSessionCache::insert(bssl::UniquePtr<SSL_SESSION> session) {
+  unsigned id_length;
+  const uint8_t* id_data = SSL_SESSION_get_id(session.get(), &id_length);
+  const std::string id(reinterpret_cast<const char*>(id_data), id_length);
+  Shard& shard = this->shard(id);
+
+  // The evicted sessions are freed out of the lock.
+  bssl::UniquePtr<SSL_SESSION> evicted;
+  absl::MutexLock lock(&shard.mutex_);
+  auto it = shard.sessions_.find(id);
+  if (it != shard.sessions_.end()) {
+    evicted = std::move(it->second);
+    it->second = std::move(session);
+    return;
+  }
+  if (shard.sessions_.size() >= shard.max_size_) {
+    auto oldest = shard.sessions_.find(shard.ids_.front());
+    ASSERT(oldest != shard.sessions_.end());
+    evicted = std::move(oldest->second);
+    shard.sessions_.erase(oldest);
+    shard.ids_.pop_front();
+  }
+  shard.sessions_.emplace(id, std::move(session));
+  shard.ids_.push_back(id);
+}
+
+bssl::UniquePtr<SSL_SESSION> ServerSessionCache::lookup(absl::string_view id) {
+  Shard& shard = this->shard(id);
+  absl::MutexLock lock(&shard.mutex_);
+  auto it = shard.sessions_.find(id);
+  if (it == shard.sessions_.end()) {
+    return nullptr;
+  }
+  SSL_SESSION_up_ref(it->second.get());
+  return bssl::UniquePtr<SSL_SESSION>(it->second.get());
+}
+
+size_t ServerSessionCache::size() {
+  size_t size = 0;
+  for (const auto& shard : shards_) {
+    absl::MutexLock lock(&shard->mutex_);
+    size += shard->sessions_.size();
+  }
+  return size;
+}
+
+ClientSessionCache::ClientSessionCache(uint32_t max_size, uint32_t max_sessions_per_key)
+    : max_sessions_per_key_(max_sessions_per_key) {
+  ASSERT(max_size > 0 && max_sessions_per_key > 0);
+  const uint32_t num_shards = std::min(max_size, MaxShards);
+  shards_.reserve(num_shards);
+  for (uint32_t i = 0; i < num_shards; ++i) {
+    shards_.push_back(std::make_unique<Shard>());
+    shards_.back()->max_size_ = max_size / num_shards + (i < max_size % num_shards ? 1 : 0);
+  }
+}
+
+ClientSessionCache::Shard& ClientSessionCache::shard(absl::string_view key) {
+  return *shards_[absl::Hash<absl::string_view>()(key) % shards_.size()];
+}
+
+void ClientSessionCache::insert(absl::string_view key, bssl::UniquePtr<SSL_SESSION> session) {
+  Shard& shard = this->shard(key);
+
+  // The evicted sessions are freed out of the lock.
+  std::deque<bssl::UniquePtr<SSL_SESSION>> evicted;
+  absl::MutexLock lock(&shard.mutex_);
+  auto it = shard.sessions_.find(key);
+  if (it == shard.sessions_.end()) {
+    if (shard.sessions_.size() >= shard.max_size_) {
+      auto oldest = shard.sessions_.find(shard.keys_.front());
+      ASSERT(oldest != shard.sessions_.end());
+      evicted = std::move(oldest->second);
+      shard.sessions_.erase(oldest);
+      shard.keys_.pop_front();
+    }
+    it = shard.sessions_.emplace(std::string(key), std::deque<bssl::UniquePtr<SSL_SESSION>>())
+             .first;
+    shard.keys_.emplace_back(key);
+  }
+  auto& sessions = it->second;
+  while (sessions.size() >= max_sessions_per_key_) {
+    evicted.push_back(std::move(sessions.back()));
+    sessions.pop_back();
+  }
+  sessions.push_front(std::move(session));
+}
+
+bssl::UniquePtr<SSL_SESSION> ClientSessionCache::lookup(absl::string_view key) {
+  Shard& shard = this->shard(key);
+  absl::MutexLock lock(&shard.mutex_);
+  auto it = shard.sessions_.find(key);
+  if (it == shard.sessions_.end() || it->second.empty()) {
+    return nullptr;
+  }
+  // The most recent session has the best chance to still be accepted by the server. A server
+  // whose sessions have all been used keeps its place, as it is about to store new ones.
+  if (SSL_SESSION_should_be_single_use(it->second.front().get())) {
+    bssl::UniquePtr<SSL_SESSION> session = std::move(it->second.front());
+    it->second.pop_front();
+    return session;
+  }
+  SSL_SESSION_up_ref(it->second.front().get());
+  return bssl::UniquePtr<SSL_SESSION>(it->second.front().get());
+}
+
+size_t ClientSessionCache::size() {
+  size_t size = 0;
+  for (const auto& shard : shards_) {
+    absl::MutexLock lock(&shard->mutex_);
+    size += shard->sessions_.size();
+  }
+  return size;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Caches the sessions of a server context that clients resume by session ID. The context is
+ * shared by all the workers, and BoringSSL's own cache serializes them on a single lock for every
+ * handshake that stores or looks up a session. This cache is instead split into shards, picked by
+ * the session ID, each with its own lock and holding an even part of the sessions. When a shard is
+ * full, its oldest session is evicted. Whether a session has expired is checked by BoringSSL once
+ * it is looked up.
+ */
+class ServerSessionCache {
+public:
+  static constexpr uint32_t MaxShards = 16;
+
+  explicit ServerSessionCache(uint32_t max_size);
+
+  /**
+   * Stores a session, replacing any session with the same ID.
+   */
+  void insert(bssl::UniquePtr<SSL_SESSION> session);
+
+  /**
+   * @return a reference to the session with the ID, or nullptr if it is not cached.
+   */
+  bssl::UniquePtr<SSL_SESSION> lookup(absl::string_view id);
+
+  /**
+   * @return size_t the number of cached sessions.
+   */
+  size_t size();
+
+private:
+  struct Shard {
+    absl::Mutex mutex_;
+    absl::flat_hash_map<std::string, bssl::UniquePtr<SSL_SESSION>>
+        sessions_ ABSL_GUARDED_BY(mutex_);
+    // The IDs of sessions_, oldest first.
+    std::deque<std::string> ids_ ABSL_GUARDED_BY(mutex_);
+    uint32_t max_size_{};
+  };
+
+  Shard& shard(absl::string_view id);
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+/**
+ * Caches the sessions of a client context for each upstream server, identified by a key such as
+ * its SNI and address, so that the connections of every worker and connection pool to a server
+ * resume the sessions that any of them stored. Like ServerSessionCache, the cache is split into
+ * shards, picked by the key, each with its own lock. A server keeps its most recent sessions, and
+ * when a shard holds too many servers, the server that was added to it first is evicted.
+ */
+class ClientSessionCache {
+public:
+  static constexpr uint32_t MaxShards = 16;
+  // The number of servers whose sessions are cached unless configured otherwise.
+  static constexpr uint32_t DefaultMaxSize = 1024;
+
+  ClientSessionCache(uint32_t max_size, uint32_t max_sessions_per_key);
+
+  /**
+   * Stores a session of a server, evicting its oldest session if it has too many.
+   */
+  void insert(absl::string_view key, bssl::UniquePtr<SSL_SESSION> session);
+
+  /**
+   * @return a reference to the most recent session of a server, or nullptr if it has none. A
+   *         single use session, such as a TLS 1.3 one, is removed from the cache.
+   */
+  bssl::UniquePtr<SSL_SESSION> lookup(absl::string_view key);
+
+  /**
+   * @return size_t the number of servers with cached sessions.
+   */
+  size_t size();
+
+private:
+  struct Shard {
+    absl::Mutex mutex_;
+    // The sessions of each server, most recent first.
+    absl::flat_hash_map<std::string, std::deque<bssl::UniquePtr<SSL_SESSION>>>
+        sessions_ ABSL_GUARDED_BY(mutex_);
+    // The keys of sessions_, in the order they were added.
+    std::deque<std::string> keys_ ABSL_GUARDED_BY(mutex_);
+    uint32_t max_size_{};
+  };
+
+  Shard& shard(absl::string_view key);
+
+  const uint32_t max_sessions_per_key_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -1,14 +1,17 @@
 #include "extensions/transport_sockets/tls/ssl_socket.h"
 
+#include "envoy/event/file_event.h"
 #include "envoy/stats/scope.h"
 
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/common/hex.h"
+#include "common/common/stage_trace.h"
 #include "common/http/headers.h"
 #include "common/runtime/runtime_features.h"
 
 #include "extensions/transport_sockets/tls/io_handle_bio.h"
+#include "extensions/transport_sockets/tls/kernel_tls.h"
 #include "extensions/transport_sockets/tls/ssl_handshaker.h"
 #include "extensions/transport_sockets/tls/utility.h"
 
@@ -27,6 +30,9 @@ namespace {
 
 constexpr absl::string_view NotReadyReason{"TLS error: Secret is not supplied by SDS"};
 
+// The maximum size of the plaintext of a TLS record.
+constexpr uint64_t MaxRecordSize = 16384;
+
 // This SslSocket will be used when SSL secret is not fetched from SDS server.
 class NotReadySslSocket : public Network::TransportSocket {
 public:
@@ -43,6 +49,7 @@ public:
   void onConnected() override {}
   Ssl::ConnectionInfoConstSharedPtr ssl() const override { return nullptr; }
   bool startSecureTransport() override { return false; }
+  bool canSplice() const override { return false; }
 };
 } // namespace
 
@@ -51,6 +58,9 @@ SslSocket::SslSocket(Envoy::Ssl::ContextSharedPtr ctx, InitialState state,
                      Ssl::HandshakerFactoryCb handshaker_factory_cb)
     : transport_socket_options_(transport_socket_options),
       ctx_(std::dynamic_pointer_cast<ContextImpl>(ctx)),
+      max_record_size_(ctx_->dynamicRecordSizing().has_value()
+                           ? ctx_->dynamicRecordSizing()->initial_record_size_
+                           : MaxRecordSize),
       info_(std::dynamic_pointer_cast<SslHandshakerImpl>(
           handshaker_factory_cb(ctx_->newSsl(transport_socket_options_.get()),
                                 ctx_->sslExtendedSocketInfoIndex(), this))) {
@@ -81,6 +91,10 @@ void SslSocket::setTransportSocketCallbacks(Network::TransportSocketCallbacks& c
     bio = BIO_new_socket(callbacks_->ioHandle().fdDoNotUse(), 0);
   }
   SSL_set_bio(rawSsl(), bio, bio);
+
+  if (!SSL_is_server(rawSsl())) {
+    ctx_->setSession(*rawSsl(), *callbacks_->connection().remoteAddress());
+  }
 }
 
 SslSocket::ReadResult SslSocket::sslReadIntoSlice(Buffer::RawSlice& slice) {
@@ -117,7 +131,11 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
       return {action, 0, false};
     }
   }
+  if (kernel_tls_rx_) {
+    return kernelTlsRead(read_buffer);
+  }
 
+  const bool in_early_data = SSL_in_early_data(rawSsl());
   bool keep_reading = true;
   bool end_stream = false;
   PostIoAction action = PostIoAction::KeepOpen;
@@ -157,6 +175,10 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
           drainErrorQueue();
           action = PostIoAction::Close;
           break;
+        case SSL_ERROR_EARLY_DATA_REJECTED:
+          onEarlyDataRejected();
+          action = PostIoAction::Close;
+          break;
         }
 
         break;
@@ -172,11 +194,79 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
     }
   }
 
+  if (in_early_data && bytes_to_retry_ > 0 && !SSL_in_early_data(rawSsl())) {
+    // A write waits for the handshake to complete once the server's early data limit is reached.
+    callbacks_->ioHandle().activateFileEvents(Event::FileReadyType::Write);
+  }
+
   ENVOY_CONN_LOG(trace, "ssl read {} bytes", callbacks_->connection(), bytes_read);
 
   return {action, bytes_read, end_stream};
 }
 
+Network::IoResult SslSocket::kernelTlsRead(Buffer::Instance& read_buffer) {
+  PostIoAction action = PostIoAction::KeepOpen;
+  uint64_t bytes_read = 0;
+  bool end_stream = false;
+  while (true) {
+    Buffer::RawSlice slices[2];
+    const uint64_t num_slices = read_buffer.reserve(16384, slices, 2);
+    const KernelTls::ReadResult result =
+        KernelTls::read(callbacks_->ioHandle().fdDoNotUse(), slices, num_slices);
+    ENVOY_CONN_LOG(trace, "kernel tls read returns: {}", callbacks_->connection(),
+                   result.result_.rc_);
+    if (result.result_.rc_ < 0) {
+      if (result.result_.errno_ != SOCKET_ERROR_AGAIN) {
+        action = PostIoAction::Close;
+      }
+      break;
+    }
+    if (result.unexpected_record_) {
+      ENVOY_CONN_LOG(debug, "unexpected TLS record with kernel tls", callbacks_->connection());
+      ctx_->stats().connection_error_.inc();
+      action = PostIoAction::Close;
+      break;
+    }
+    if (result.result_.rc_ == 0) {
+      // Either a close_notify alert or the underlying socket was closed.
+      end_stream = true;
+      break;
+    }
+
+    uint64_t remaining = result.result_.rc_;
+    uint64_t slices_to_commit = 0;
+    for (; slices_to_commit < num_slices && remaining > 0; slices_to_commit++) {
+      slices[slices_to_commit].len_ = std::min<uint64_t>(slices[slices_to_commit].len_, remaining);
+      remaining -= slices[slices_to_commit].len_;
+    }
+    read_buffer.commit(slices, slices_to_commit);
+    bytes_read += result.result_.rc_;
+    if (callbacks_->shouldDrainReadBuffer()) {
+      callbacks_->setTransportSocketIsReadable();
+      break;
+    }
+  }
+
+  ENVOY_CONN_LOG(trace, "kernel tls read {} bytes", callbacks_->connection(), bytes_read);
+
+  return {action, bytes_read, end_stream};
+}
+
+void SslSocket::maybeEnableKernelTls() {
+  if (!Runtime::runtimeFeatureEnabled("envoy.reloadable_features.tls_kernel_offload")) {
+    return;
+  }
+  const KernelTls::OffloadResult result = KernelTls::enable(rawSsl(), callbacks_->ioHandle());
+  if (!result.tx_) {
+    return;
+  }
+  ENVOY_CONN_LOG(debug, "TLS records offloaded to the kernel (receive: {})",
+                 callbacks_->connection(), result.rx_);
+  kernel_tls_tx_socket_ = std::make_unique<Network::RawBufferSocket>();
+  kernel_tls_tx_socket_->setTransportSocketCallbacks(*callbacks_);
+  kernel_tls_rx_ = result.rx_;
+}
+
 void SslSocket::onPrivateKeyMethodComplete() {
   ASSERT(isThreadSafe());
   ASSERT(info_->state() == Ssl::SocketState::HandshakeInProgress);
@@ -192,12 +282,29 @@ void SslSocket::onPrivateKeyMethodComplete() {
 Network::Connection& SslSocket::connection() const { return callbacks_->connection(); }
 
 void SslSocket::onSuccess(SSL* ssl) {
+  if (SSL_in_early_data(ssl)) {
+    // The handshake completes on a later read, once the server has answered the early data.
+    ENVOY_CONN_LOG(debug, "TLS handshake resumes a session with early data",
+                   callbacks_->connection());
+    ctx_->stats().early_data_.inc();
+  }
   ctx_->logHandshake(ssl);
+  STAGE_TRACE(StageTrace::Stage::TlsHandshake, callbacks_->connection().id(), 0);
+  maybeEnableKernelTls();
   callbacks_->raiseEvent(Network::ConnectionEvent::Connected);
 }
 
 void SslSocket::onFailure() { drainErrorQueue(); }
 
+void SslSocket::onEarlyDataRejected() {
+  // The server has not processed the early data, which is not sent again as the upper layers
+  // may have acted on the connection being established already.
+  ERR_clear_error();
+  ENVOY_CONN_LOG(debug, "TLS early data rejected", callbacks_->connection());
+  ctx_->stats().early_data_rejected_.inc();
+  failure_reason_ = "TLS error: early data rejected";
+}
+
 PostIoAction SslSocket::doHandshake() { return info_->doHandshake(); }
 
 void SslSocket::drainErrorQueue() {
@@ -236,13 +343,34 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
       return {action, 0, false};
     }
   }
+  if (kernel_tls_tx_socket_ != nullptr) {
+    // The close_notify alert is sent once everything else has been written.
+    Network::IoResult result = kernel_tls_tx_socket_->doWrite(write_buffer, false);
+    if (result.action_ == PostIoAction::KeepOpen && write_buffer.length() == 0 && end_stream) {
+      shutdownSsl();
+    }
+    return result;
+  }
+
+  const auto& record_sizing = ctx_->dynamicRecordSizing();
+  if (record_sizing.has_value() && write_buffer.length() > 0) {
+    // The congestion window of an idle connection may have shrunk, so the records start small
+    // again.
+    const MonotonicTime now = callbacks_->connection().dispatcher().timeSource().monotonicTime();
+    if (max_record_size_ > record_sizing->initial_record_size_ &&
+        now - last_write_time_ >= record_sizing->idle_timeout_) {
+      max_record_size_ = record_sizing->initial_record_size_;
+      ctx_->stats().record_size_resets_.inc();
+    }
+    last_write_time_ = now;
+  }
 
   uint64_t bytes_to_write;
   if (bytes_to_retry_) {
     bytes_to_write = bytes_to_retry_;
     bytes_to_retry_ = 0;
   } else {
-    bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+    bytes_to_write = std::min(write_buffer.length(), max_record_size_);
   }
 
   uint64_t total_bytes_written = 0;
@@ -260,7 +388,14 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
       ASSERT(rc == static_cast<int>(bytes_to_write));
       total_bytes_written += rc;
       write_buffer.drain(rc);
-      bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+      if (max_record_size_ < MaxRecordSize) {
+        // Each record can be one initial record size longer than the previous one, so that the
+        // records grow with the congestion window.
+        ctx_->stats().small_records_.inc();
+        max_record_size_ =
+            std::min(max_record_size_ + record_sizing->initial_record_size_, MaxRecordSize);
+      }
+      bytes_to_write = std::min(write_buffer.length(), max_record_size_);
     } else {
       int err = SSL_get_error(rawSsl(), rc);
       switch (err) {
@@ -268,10 +403,20 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
         bytes_to_retry_ = bytes_to_write;
         break;
       case SSL_ERROR_WANT_READ:
-      // Renegotiation has started. We don't handle renegotiation so just fall through.
+        if (SSL_in_early_data(rawSsl())) {
+          // The server's early data limit is reached, so the write is retried once a read has
+          // completed the handshake.
+          bytes_to_retry_ = bytes_to_write;
+          break;
+        }
+        // Renegotiation has started. We don't handle renegotiation so just fall through.
+        FALLTHRU;
       default:
         drainErrorQueue();
         return {PostIoAction::Close, total_bytes_written, false};
+      case SSL_ERROR_EARLY_DATA_REJECTED:
+        onEarlyDataRejected();
+        return {PostIoAction::Close, total_bytes_written, false};
       }
 
       break;
@@ -293,6 +438,15 @@ void SslSocket::shutdownSsl() {
   ASSERT(info_->state() != Ssl::SocketState::PreHandshake);
   if (info_->state() != Ssl::SocketState::ShutdownSent &&
       callbacks_->connection().state() != Network::Connection::State::Closed) {
+    if (kernel_tls_tx_socket_ != nullptr) {
+      // BoringSSL no longer knows the state of the send direction, so the alert is sent through
+      // the kernel.
+      const Api::SysCallSizeResult result =
+          KernelTls::sendCloseNotify(callbacks_->ioHandle().fdDoNotUse());
+      ENVOY_CONN_LOG(debug, "kernel tls shutdown: rc={}", callbacks_->connection(), result.rc_);
+      info_->setState(Ssl::SocketState::ShutdownSent);
+      return;
+    }
     int rc = SSL_shutdown(rawSsl());
     if constexpr (Event::PlatformDefaultTriggerType == Event::FileTriggerType::EmulatedEdge) {
       // Windows operate under `EmulatedEdge`. These are level events that are artificially
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <string>
 
+#include "envoy/common/time.h"
 #include "envoy/network/connection.h"
 #include "envoy/network/transport_socket.h"
 #include "envoy/secret/secret_callbacks.h"
@@ -14,6 +15,7 @@
 #include "envoy/stats/stats_macros.h"
 
 #include "common/common/logger.h"
+#include "common/network/raw_buffer_socket.h"
 
 #include "extensions/transport_sockets/tls/context_impl.h"
 #include "extensions/transport_sockets/tls/ssl_handshaker.h"
@@ -63,6 +65,7 @@ public:
   void onConnected() override;
   Ssl::ConnectionInfoConstSharedPtr ssl() const override;
   bool startSecureTransport() override { return false; }
+  bool canSplice() const override { return false; }
   // Ssl::PrivateKeyConnectionCallbacks
   void onPrivateKeyMethodComplete() override;
   // Ssl::HandshakeCallbacks
@@ -80,9 +83,12 @@ private:
     absl::optional<int> error_;
   };
   ReadResult sslReadIntoSlice(Buffer::RawSlice& slice);
+  Network::IoResult kernelTlsRead(Buffer::Instance& read_buffer);
+  void maybeEnableKernelTls();
 
   Network::PostIoAction doHandshake();
   void drainErrorQueue();
+  void onEarlyDataRejected();
   void shutdownSsl();
   void shutdownBasic();
   bool isThreadSafe() const {
@@ -93,7 +99,16 @@ private:
   Network::TransportSocketCallbacks* callbacks_{};
   ContextImplSharedPtr ctx_;
   uint64_t bytes_to_retry_{};
+  // The maximum size of the next record, which only grows up to 16KiB while the records are sized
+  // dynamically.
+  uint64_t max_record_size_;
+  MonotonicTime last_write_time_;
   std::string failure_reason_;
+  // Set once records sent on the socket are encrypted by the kernel. Writes then go through a raw
+  // buffer socket and BoringSSL is never asked to write again.
+  std::unique_ptr<Network::RawBufferSocket> kernel_tls_tx_socket_;
+  // Records received on the socket are decrypted by the kernel.
+  bool kernel_tls_rx_{false};
 
   SslHandshakerImplSharedPtr info_;
 };
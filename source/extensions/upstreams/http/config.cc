@@ -45,6 +45,7 @@ ProtocolOptionsConfigImpl::ProtocolOptionsConfigImpl(
     const envoy::extensions::upstreams::http::v3::HttpProtocolOptions& options)
     : http1_settings_(Envoy::Http::Utility::parseHttp1Settings(getHttpOptions(options))),
       http2_options_(Http2::Utility::initializeAndValidateOptions(getHttp2Options(options))),
+      http3_options_(options.explicit_http_config().http3_protocol_options()),
       common_http_protocol_options_(options.common_http_protocol_options()),
       upstream_http_protocol_options_(
           options.has_upstream_http_protocol_options()
@@ -55,6 +56,10 @@ ProtocolOptionsConfigImpl::ProtocolOptionsConfigImpl(
       options.explicit_http_config().has_http2_protocol_options()) {
     use_http2_ = true;
   }
+  if (options.has_explicit_http_config() &&
+      options.explicit_http_config().has_http3_protocol_options()) {
+    use_http3_ = true;
+  }
   if (options.has_use_downstream_protocol_config()) {
     if (options.use_downstream_protocol_config().has_http2_protocol_options()) {
       use_http2_ = true;
@@ -174,6 +174,11 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server)
            MAKE_ADMIN_HANDLER(stats_handler_.handlerContention), false, false},
           {"/cpuprofiler", "enable/disable the CPU profiler",
            MAKE_ADMIN_HANDLER(profiling_handler_.handlerCpuProfiler), false, true},
+          {"/cpuprofiler/sampling", "enable/disable the continuous sampling CPU profiler",
+           MAKE_ADMIN_HANDLER(profiling_handler_.handlerSamplingProfiler), false, true},
+          {"/cpuprofiler/samples",
+           "print the stacks sampled by the sampling CPU profiler (collapsed or pprof)",
+           MAKE_ADMIN_HANDLER(profiling_handler_.handlerSamplingProfile), false, false},
           {"/heapprofiler", "enable/disable the heap profiler",
            MAKE_ADMIN_HANDLER(profiling_handler_.handlerHeapProfiler), false, true},
           {"/healthcheck/fail", "cause the server to fail health checks",
@@ -194,6 +199,11 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server)
            MAKE_ADMIN_HANDLER(stats_handler_.handlerResetCounters), false, true},
           {"/drain_listeners", "drain listeners",
            MAKE_ADMIN_HANDLER(listeners_handler_.handlerDrainListeners), false, true},
+          {"/stage_trace", "enable/disable or clear the tracing of the stages of the requests",
+           MAKE_ADMIN_HANDLER(profiling_handler_.handlerStageTrace), false, true},
+          {"/stage_trace/dump",
+           "print the stages of the requests traced, in the Chrome trace event format",
+           MAKE_ADMIN_HANDLER(profiling_handler_.handlerStageTraceDump), false, false},
           {"/server_info", "print server version/status information",
            MAKE_ADMIN_HANDLER(server_info_handler_.handlerServerInfo), false, false},
           {"/ready", "print server state, return 200 if LIVE, otherwise return 503",
@@ -408,6 +418,7 @@ Http::Code AdminImpl::request(absl::string_view path_and_query, absl::string_vie
   Buffer::OwnedImpl response;
 
   Http::Code code = runCallback(path_and_query, response_headers, response, filter);
+  filter.drainRemainingResponse(response);
   Utility::populateFallbackResponseHeaders(code, response_headers);
   body = response.toString();
   return code;
@@ -401,6 +401,8 @@ private:
       return empty_network_filter_factory_;
     }
 
+    const Network::OnDemandFilterChain* onDemandFilterChain() const override { return nullptr; }
+
   private:
     const Network::RawBufferSocketFactory transport_socket_factory_;
     const std::vector<Network::FilterFactoryCb> empty_network_filter_factory_;
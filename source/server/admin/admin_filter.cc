@@ -38,6 +38,13 @@ Http::FilterTrailersStatus AdminFilter::decodeTrailers(Http::RequestTrailerMap&)
 }
 
 void AdminFilter::onDestroy() {
+  if (next_chunk_cb_ != nullptr) {
+    if (next_chunk_ != nullptr) {
+      decoder_callbacks_->removeDownstreamWatermarkCallbacks(*this);
+    }
+    next_chunk_cb_->cancel();
+  }
+  next_chunk_ = nullptr;
   for (const auto& callback : on_destroy_callbacks_) {
     callback();
   }
@@ -70,13 +77,60 @@ void AdminFilter::onComplete() {
   RELEASE_ASSERT(request_headers_, "");
   Http::Code code = admin_server_callback_func_(path, *header_map, response, *this);
   Utility::populateFallbackResponseHeaders(code, *header_map);
-  decoder_callbacks_->encodeHeaders(std::move(header_map),
-                                    end_stream_on_complete_ && response.length() == 0,
+  const bool end_stream = end_stream_on_complete_ && next_chunk_ == nullptr;
+  decoder_callbacks_->encodeHeaders(std::move(header_map), end_stream && response.length() == 0,
                                     StreamInfo::ResponseCodeDetails::get().AdminFilterResponse);
 
   if (response.length() > 0) {
-    decoder_callbacks_->encodeData(response, end_stream_on_complete_);
+    decoder_callbacks_->encodeData(response, end_stream);
+  }
+
+  // Encoding may have reset the stream, which clears next_chunk_ in onDestroy().
+  if (next_chunk_ != nullptr) {
+    // The chunks are encoded in later event loop iterations, so that a large response does not
+    // block the main thread, and only while the downstream connection drains them.
+    next_chunk_cb_ =
+        decoder_callbacks_->dispatcher().createSchedulableCallback([this]() { encodeNextChunk(); });
+    decoder_callbacks_->addDownstreamWatermarkCallbacks(*this);
+    if (high_watermark_count_ == 0) {
+      next_chunk_cb_->scheduleCallbackNextIteration();
+    }
+  }
+}
+
+void AdminFilter::encodeNextChunk() {
+  Buffer::OwnedImpl chunk;
+  if (next_chunk_(chunk)) {
+    decoder_callbacks_->encodeData(chunk, false);
+    if (next_chunk_ != nullptr && high_watermark_count_ == 0) {
+      next_chunk_cb_->scheduleCallbackNextIteration();
+    }
+    return;
+  }
+  decoder_callbacks_->removeDownstreamWatermarkCallbacks(*this);
+  next_chunk_ = nullptr;
+  decoder_callbacks_->encodeData(chunk, end_stream_on_complete_);
+}
+
+void AdminFilter::onAboveWriteBufferHighWatermark() {
+  ++high_watermark_count_;
+  next_chunk_cb_->cancel();
+}
+
+void AdminFilter::onBelowWriteBufferLowWatermark() {
+  ASSERT(high_watermark_count_ > 0);
+  if (--high_watermark_count_ == 0) {
+    next_chunk_cb_->scheduleCallbackNextIteration();
+  }
+}
+
+void AdminFilter::drainRemainingResponse(Buffer::Instance& response) {
+  if (next_chunk_ == nullptr) {
+    return;
+  }
+  while (next_chunk_(response)) {
   }
+  next_chunk_ = nullptr;
 }
 
 } // namespace Server
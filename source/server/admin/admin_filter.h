@@ -23,6 +23,7 @@ namespace Server {
  */
 class AdminFilter : public Http::PassThroughFilter,
                     public AdminStream,
+                    public Http::DownstreamWatermarkCallbacks,
                     Logger::Loggable<Logger::Id::admin> {
 public:
   using AdminServerCallbackFunction = std::function<Http::Code(
@@ -52,16 +53,39 @@ public:
   Http::Http1StreamEncoderOptionsOptRef http1StreamEncoderOptions() override {
     return encoder_callbacks_->http1StreamEncoderOptions();
   }
+  void streamRemainingResponse(std::function<bool(Buffer::Instance&)> next_chunk) override {
+    next_chunk_ = std::move(next_chunk);
+  }
+
+  // Http::DownstreamWatermarkCallbacks
+  void onAboveWriteBufferHighWatermark() override;
+  void onBelowWriteBufferLowWatermark() override;
+
+  /**
+   * Appends the chunks of a streamed response to the response filled in by the handler, for
+   * requests that do not come from a downstream connection. @see AdminImpl::request()
+   * @param response the response filled in by the handler.
+   */
+  void drainRemainingResponse(Buffer::Instance& response);
 
 private:
   /**
    * Called when an admin request has been completely received.
    */
   void onComplete();
+  /**
+   * Encodes the next chunk of a streamed response, and schedules the one after it unless the
+   * downstream connection is above its high watermark.
+   */
+  void encodeNextChunk();
+
   AdminServerCallbackFunction admin_server_callback_func_;
   Http::RequestHeaderMap* request_headers_{};
   std::list<std::function<void()>> on_destroy_callbacks_;
   bool end_stream_on_complete_ = true;
+  std::function<bool(Buffer::Instance&)> next_chunk_;
+  Event::SchedulableCallbackPtr next_chunk_cb_;
+  uint32_t high_watermark_count_{};
 };
 
 } // namespace Server
@@ -152,7 +152,7 @@ void ClustersHandler::writeClustersAsJson(Buffer::Instance& response) {
         for (const auto& [gauge_name, gauge] : host->gauges()) {
           auto& metric = *host_status.add_stats();
           metric.set_name(std::string(gauge_name));
-          metric.set_value(gauge.get().value());
+          metric.set_value(gauge);
           metric.set_type(envoy::admin::v3::SimpleMetric::GAUGE);
         }
 
@@ -211,7 +211,7 @@ void ClustersHandler::writeClustersAsText(Buffer::Instance& response) {
         }
 
         for (const auto& [gauge_name, gauge] : host->gauges()) {
-          all_stats[gauge_name] = gauge.get().value();
+          all_stats[gauge_name] = gauge;
         }
 
         for (const auto& [stat_name, stat] : all_stats) {
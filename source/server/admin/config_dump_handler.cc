@@ -2,13 +2,17 @@
 
 #include "envoy/config/core/v3/health_check.pb.h"
 #include "envoy/config/endpoint/v3/endpoint.pb.h"
+#include "envoy/type/matcher/v3/regex.pb.h"
 
+#include "common/common/regex.h"
 #include "common/http/headers.h"
 #include "common/http/utility.h"
 #include "common/network/utility.h"
 
 #include "server/admin/utils.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -97,6 +101,87 @@ void trimResourceMessage(const Protobuf::FieldMask& field_mask, Protobuf::Messag
   ProtobufUtil::FieldMaskUtil::TrimMessage(outer_field_mask, &message);
 }
 
+// Returns the name of a config dump resource. The name is a field of the resource, as for a
+// DynamicListener, or else a field of the config packed in its Any field, as for a StaticCluster.
+// The ClusterLoadAssignment of an EndpointConfig is named by its cluster_name.
+std::string resourceName(const Protobuf::Message& message) {
+  const Protobuf::Descriptor* descriptor = message.GetDescriptor();
+  const Protobuf::Reflection* reflection = message.GetReflection();
+  for (const char* name : {"name", "cluster_name"}) {
+    const Protobuf::FieldDescriptor* field = descriptor->FindFieldByName(name);
+    if (field != nullptr && !field->is_repeated() &&
+        field->cpp_type() == Protobuf::FieldDescriptor::CPPTYPE_STRING) {
+      return reflection->GetString(message, field);
+    }
+  }
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const Protobuf::FieldDescriptor* field = descriptor->field(i);
+    if (field->is_repeated() || field->message_type() == nullptr ||
+        field->message_type()->full_name() != "google.protobuf.Any" ||
+        !reflection->HasField(message, field)) {
+      continue;
+    }
+    ProtobufWkt::Any any_message;
+    any_message.MergeFrom(reflection->GetMessage(message, field));
+    const absl::string_view inner_type_name =
+        TypeUtil::typeUrlToDescriptorFullName(any_message.type_url());
+    const Protobuf::Descriptor* inner_descriptor =
+        Protobuf::DescriptorPool::generated_pool()->FindMessageTypeByName(
+            static_cast<std::string>(inner_type_name));
+    if (inner_descriptor == nullptr) {
+      continue;
+    }
+    Protobuf::DynamicMessageFactory dmf;
+    std::unique_ptr<Protobuf::Message> inner_message(dmf.GetPrototype(inner_descriptor)->New());
+    if (any_message.UnpackTo(inner_message.get())) {
+      return resourceName(*inner_message);
+    }
+  }
+  return "";
+}
+
+bool resourceNameMatches(const Regex::CompiledMatcher* name_matcher,
+                         const Protobuf::Message& message) {
+  return name_matcher == nullptr || name_matcher->match(resourceName(message));
+}
+
+// Removes the resources whose name does not match the regex from the repeated fields of a top
+// level config dump, keeping the order of the others.
+void filterResourcesByName(const Regex::CompiledMatcher& name_matcher, Protobuf::Message& message) {
+  const Protobuf::Descriptor* descriptor = message.GetDescriptor();
+  const Protobuf::Reflection* reflection = message.GetReflection();
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const Protobuf::FieldDescriptor* field = descriptor->field(i);
+    if (!field->is_repeated() || field->message_type() == nullptr) {
+      continue;
+    }
+    const int size = reflection->FieldSize(message, field);
+    int kept = 0;
+    for (int j = 0; j < size; ++j) {
+      if (name_matcher.match(resourceName(reflection->GetRepeatedMessage(message, field, j)))) {
+        if (kept != j) {
+          reflection->SwapElements(&message, field, kept, j);
+        }
+        ++kept;
+      }
+    }
+    for (int j = kept; j < size; ++j) {
+      reflection->RemoveLast(&message, field);
+    }
+  }
+}
+
+// Appends a config to a dump being rendered, indented as an element of the configs array.
+void renderConfig(const ProtobufWkt::Any& config, Buffer::Instance& response) {
+  const std::string json = MessageUtil::getJsonStringFromMessage(config, true); // pretty-print
+  bool first = true;
+  for (absl::string_view line : absl::StrSplit(json, '\n', absl::SkipEmpty())) {
+    response.add(first ? "  " : "\n  ");
+    response.add(line.data(), line.size());
+    first = false;
+  }
+}
+
 // Helper method to get the resource parameter.
 absl::optional<std::string> resourceParam(const Http::Utility::QueryParams& params) {
   return Utility::queryParam(params, "resource");
@@ -107,6 +192,25 @@ absl::optional<std::string> maskParam(const Http::Utility::QueryParams& params)
   return Utility::queryParam(params, "mask");
 }
 
+// Helper method to get the name_regex parameter. A name matches if the regex matches anywhere in
+// it, so the regex is wrapped to match the whole name with RE2.
+bool nameRegexParam(const Http::Utility::QueryParams& params, Buffer::Instance& response,
+                    Regex::CompiledMatcherPtr& name_matcher) {
+  const auto pattern = Utility::queryParam(params, "name_regex");
+  if (pattern.has_value()) {
+    envoy::type::matcher::v3::RegexMatcher matcher;
+    matcher.mutable_google_re2();
+    matcher.set_regex(absl::StrCat("(?s:.*)(?:", pattern.value(), ")(?s:.*)"));
+    try {
+      name_matcher = Regex::Utility::parseRegex(matcher);
+    } catch (EnvoyException& error) {
+      response.add(fmt::format("Invalid regex: \"{}\"\n", error.what()));
+      return false;
+    }
+  }
+  return true;
+}
+
 // Helper method to get the eds parameter.
 bool shouldIncludeEdsInDump(const Http::Utility::QueryParams& params) {
   return Utility::queryParam(params, "include_eds") != absl::nullopt;
@@ -114,38 +218,77 @@ bool shouldIncludeEdsInDump(const Http::Utility::QueryParams& params) {
 
 } // namespace
 
+ConfigDumpRenderer::ConfigDumpRenderer(envoy::admin::v3::ConfigDump&& dump)
+    : dump_(std::move(dump)) {}
+
+bool ConfigDumpRenderer::nextChunk(Buffer::Instance& response) {
+  if (dump_.configs().empty()) {
+    response.add(MessageUtil::getJsonStringFromMessage(dump_, true)); // pretty-print
+    return false;
+  }
+  // Each config is serialized on its own, and its JSON spliced in between the lines that the
+  // serialization of the whole dump would have around it.
+  const uint64_t start = response.length();
+  if (next_config_ == 0) {
+    response.add("{\n \"configs\": [\n");
+  }
+  while (next_config_ < dump_.configs_size() && response.length() - start < ChunkSize) {
+    if (next_config_ > 0) {
+      response.add(",\n");
+    }
+    renderConfig(dump_.configs(next_config_++), response);
+  }
+  if (next_config_ < dump_.configs_size()) {
+    return true;
+  }
+  response.add("\n ]\n}\n");
+  return false;
+}
+
 ConfigDumpHandler::ConfigDumpHandler(ConfigTracker& config_tracker, Server::Instance& server)
     : HandlerContextBase(server), config_tracker_(config_tracker) {}
 
 Http::Code ConfigDumpHandler::handlerConfigDump(absl::string_view url,
                                                 Http::ResponseHeaderMap& response_headers,
-                                                Buffer::Instance& response, AdminStream&) const {
+                                                Buffer::Instance& response,
+                                                AdminStream& admin_stream) const {
   Http::Utility::QueryParams query_params = Http::Utility::parseAndDecodeQueryString(url);
   const auto resource = resourceParam(query_params);
   const auto mask = maskParam(query_params);
   const bool include_eds = shouldIncludeEdsInDump(query_params);
+  Regex::CompiledMatcherPtr name_matcher;
+  if (!nameRegexParam(query_params, response, name_matcher)) {
+    return Http::Code::BadRequest;
+  }
 
   envoy::admin::v3::ConfigDump dump;
 
   if (resource.has_value()) {
-    auto err = addResourceToDump(dump, mask, resource.value(), include_eds);
+    auto err = addResourceToDump(dump, mask, name_matcher.get(), resource.value(), include_eds);
     if (err.has_value()) {
       response.add(err.value().second);
       return err.value().first;
     }
   } else {
-    addAllConfigToDump(dump, mask, include_eds);
+    addAllConfigToDump(dump, mask, name_matcher.get(), include_eds);
   }
   MessageUtil::redact(dump);
 
   response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
-  response.add(MessageUtil::getJsonStringFromMessage(dump, true)); // pretty-print
+  // The JSON of large dumps is streamed a chunk of configs at a time rather than built in one
+  // string.
+  auto renderer = std::make_shared<ConfigDumpRenderer>(std::move(dump));
+  if (renderer->nextChunk(response)) {
+    admin_stream.streamRemainingResponse(
+        [renderer](Buffer::Instance& chunk) { return renderer->nextChunk(chunk); });
+  }
   return Http::Code::OK;
 }
 
 absl::optional<std::pair<Http::Code, std::string>>
 ConfigDumpHandler::addResourceToDump(envoy::admin::v3::ConfigDump& dump,
                                      const absl::optional<std::string>& mask,
+                                     const Regex::CompiledMatcher* name_matcher,
                                      const std::string& resource, bool include_eds) const {
   Envoy::Server::ConfigTracker::CbsMap callbacks_map = config_tracker_.getCallbacksMap();
   if (include_eds) {
@@ -174,6 +317,9 @@ ConfigDumpHandler::addResourceToDump(envoy::admin::v3::ConfigDump& dump,
 
     auto repeated = reflection->GetRepeatedPtrField<Protobuf::Message>(*message, field_descriptor);
     for (Protobuf::Message& msg : repeated) {
+      if (!resourceNameMatches(name_matcher, msg)) {
+        continue;
+      }
       if (mask.has_value()) {
         Protobuf::FieldMask field_mask;
         ProtobufUtil::FieldMaskUtil::FromString(mask.value(), &field_mask);
@@ -194,6 +340,7 @@ ConfigDumpHandler::addResourceToDump(envoy::admin::v3::ConfigDump& dump,
 
 void ConfigDumpHandler::addAllConfigToDump(envoy::admin::v3::ConfigDump& dump,
                                            const absl::optional<std::string>& mask,
+                                           const Regex::CompiledMatcher* name_matcher,
                                            bool include_eds) const {
   Envoy::Server::ConfigTracker::CbsMap callbacks_map = config_tracker_.getCallbacksMap();
   if (include_eds) {
@@ -209,6 +356,9 @@ void ConfigDumpHandler::addAllConfigToDump(envoy::admin::v3::ConfigDump& dump,
     ProtobufTypes::MessagePtr message = callback();
     ASSERT(message);
 
+    if (name_matcher != nullptr) {
+      filterResourcesByName(*name_matcher, *message);
+    }
     if (mask.has_value()) {
       Protobuf::FieldMask field_mask;
       ProtobufUtil::FieldMaskUtil::FromString(mask.value(), &field_mask);
@@ -3,6 +3,7 @@
 
 #include "envoy/admin/v3/config_dump.pb.h"
 #include "envoy/buffer/buffer.h"
+#include "envoy/common/regex.h"
 #include "envoy/config/endpoint/v3/endpoint_components.pb.h"
 #include "envoy/http/codes.h"
 #include "envoy/http/header_map.h"
@@ -17,6 +18,29 @@
 namespace Envoy {
 namespace Server {
 
+/**
+ * Renders a config dump as pretty-printed JSON one config at a time, so that the dump of a large
+ * configuration is streamed rather than serialized into one string. The output is the same as the
+ * serialization of the whole dump.
+ */
+class ConfigDumpRenderer {
+public:
+  // The size above which a chunk ends at the end of the current config.
+  static constexpr uint64_t ChunkSize = 64 * 1024;
+
+  explicit ConfigDumpRenderer(envoy::admin::v3::ConfigDump&& dump);
+
+  /**
+   * Appends the next chunk of the dump to the response.
+   * @return whether there are more chunks.
+   */
+  bool nextChunk(Buffer::Instance& response);
+
+private:
+  const envoy::admin::v3::ConfigDump dump_;
+  int next_config_{};
+};
+
 class ConfigDumpHandler : public HandlerContextBase {
 
 public:
@@ -24,11 +48,12 @@ public:
 
   Http::Code handlerConfigDump(absl::string_view path_and_query,
                                Http::ResponseHeaderMap& response_headers,
-                               Buffer::Instance& response, AdminStream&) const;
+                               Buffer::Instance& response, AdminStream& admin_stream) const;
 
 private:
   void addAllConfigToDump(envoy::admin::v3::ConfigDump& dump,
-                          const absl::optional<std::string>& mask, bool include_eds) const;
+                          const absl::optional<std::string>& mask,
+                          const Regex::CompiledMatcher* name_matcher, bool include_eds) const;
   /**
    * Add the config matching the passed resource to the passed config dump.
    * @return absl::nullopt on success, else the Http::Code and an error message that should be added
@@ -36,7 +61,8 @@ private:
    */
   absl::optional<std::pair<Http::Code, std::string>>
   addResourceToDump(envoy::admin::v3::ConfigDump& dump, const absl::optional<std::string>& mask,
-                    const std::string& resource, bool include_eds) const;
+                    const Regex::CompiledMatcher* name_matcher, const std::string& resource,
+                    bool include_eds) const;
 
   /**
    * Helper methods to add endpoints config
@@ -1,9 +1,13 @@
 #include "server/admin/profiling_handler.h"
 
+#include "common/common/stage_trace.h"
 #include "common/profiler/profiler.h"
+#include "common/profiler/sampling_profiler.h"
 
 #include "server/admin/utils.h"
 
+#include "absl/strings/numbers.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -20,6 +24,11 @@ Http::Code ProfilingHandler::handlerCpuProfiler(absl::string_view url, Http::Res
 
   bool enable = query_params.begin()->second == "y";
   if (enable && !Profiler::Cpu::profilerEnabled()) {
+    // Both profilers sample on SIGPROF.
+    if (Profiler::SamplingProfiler::running()) {
+      response.add("the sampling CPU profiler is running");
+      return Http::Code::BadRequest;
+    }
     if (!Profiler::Cpu::startProfiler(profile_path_)) {
       response.add("failure to start the profiler");
       return Http::Code::InternalServerError;
@@ -80,5 +89,96 @@ Http::Code ProfilingHandler::handlerHeapProfiler(absl::string_view url, Http::Re
   return res;
 }
 
+Http::Code ProfilingHandler::handlerSamplingProfiler(absl::string_view url,
+                                                     Http::ResponseHeaderMap&,
+                                                     Buffer::Instance& response, AdminStream&) {
+  Http::Utility::QueryParams query_params = Http::Utility::parseAndDecodeQueryString(url);
+  const auto enable = query_params.find("enable");
+  const auto frequency_param = query_params.find("frequency");
+  uint32_t frequency = Profiler::SamplingProfiler::DefaultFrequency;
+  if (enable == query_params.end() || (enable->second != "y" && enable->second != "n") ||
+      query_params.size() != (frequency_param == query_params.end() ? 1 : 2) ||
+      (frequency_param != query_params.end() &&
+       (!absl::SimpleAtoi(frequency_param->second, &frequency) || frequency == 0 ||
+        frequency > Profiler::SamplingProfiler::MaxFrequency))) {
+    response.add(fmt::format("?enable=<y|n>&frequency=<1-{}>\n",
+                             Profiler::SamplingProfiler::MaxFrequency));
+    return Http::Code::BadRequest;
+  }
+
+  if (enable->second == "y" && !Profiler::SamplingProfiler::running()) {
+    if (Profiler::Cpu::profilerEnabled()) {
+      response.add("the CPU profiler is running");
+      return Http::Code::BadRequest;
+    }
+    if (!Profiler::SamplingProfiler::start(frequency)) {
+      response.add("failure to start the sampling profiler");
+      return Http::Code::InternalServerError;
+    }
+  } else if (enable->second == "n") {
+    Profiler::SamplingProfiler::stop();
+  }
+
+  response.add("OK\n");
+  return Http::Code::OK;
+}
+
+Http::Code ProfilingHandler::handlerSamplingProfile(absl::string_view url,
+                                                    Http::ResponseHeaderMap& response_headers,
+                                                    Buffer::Instance& response, AdminStream&) {
+  Http::Utility::QueryParams query_params = Http::Utility::parseAndDecodeQueryString(url);
+  const std::string format =
+      query_params.count("format") != 0 ? query_params["format"] : "collapsed";
+  uint32_t seconds = 0;
+  if ((format != "collapsed" && format != "pprof") ||
+      (query_params.count("seconds") != 0 &&
+       !absl::SimpleAtoi(query_params["seconds"], &seconds))) {
+    response.add("?format=<collapsed|pprof>&seconds=<window>&thread=<name>\n");
+    return Http::Code::BadRequest;
+  }
+
+  const std::vector<Profiler::SamplingProfiler::Stack> stacks =
+      Profiler::SamplingProfiler::stacks(std::chrono::seconds(seconds), query_params["thread"]);
+  if (format == "pprof") {
+    response_headers.setContentType("application/octet-stream");
+    response.add(
+        Profiler::SamplingProfiler::pprof(stacks, Profiler::SamplingProfiler::frequency()));
+  } else {
+    response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Text);
+    response.add(Profiler::SamplingProfiler::collapsed(stacks));
+  }
+  return Http::Code::OK;
+}
+
+Http::Code ProfilingHandler::handlerStageTrace(absl::string_view url, Http::ResponseHeaderMap&,
+                                               Buffer::Instance& response, AdminStream&) {
+  Http::Utility::QueryParams query_params = Http::Utility::parseAndDecodeQueryString(url);
+  const auto enable = query_params.find("enable");
+  const bool clear = query_params.count("clear") != 0;
+  const size_t known_params = (enable != query_params.end() ? 1 : 0) + (clear ? 1 : 0);
+  if (known_params == 0 || query_params.size() != known_params ||
+      (enable != query_params.end() && enable->second != "y" && enable->second != "n")) {
+    response.add("?enable=<y|n>&clear\n");
+    return Http::Code::BadRequest;
+  }
+
+  if (clear) {
+    StageTrace::clear();
+  }
+  if (enable != query_params.end()) {
+    StageTrace::setEnabled(enable->second == "y");
+  }
+  response.add("OK\n");
+  return Http::Code::OK;
+}
+
+Http::Code ProfilingHandler::handlerStageTraceDump(absl::string_view,
+                                                   Http::ResponseHeaderMap& response_headers,
+                                                   Buffer::Instance& response, AdminStream&) {
+  response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
+  response.add(StageTrace::chromeTrace());
+  return Http::Code::OK;
+}
+
 } // namespace Server
 } // namespace Envoy
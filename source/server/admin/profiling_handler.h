@@ -23,6 +23,22 @@ public:
                                  Http::ResponseHeaderMap& response_headers,
                                  Buffer::Instance& response, AdminStream&);
 
+  Http::Code handlerSamplingProfiler(absl::string_view path_and_query,
+                                     Http::ResponseHeaderMap& response_headers,
+                                     Buffer::Instance& response, AdminStream&);
+
+  Http::Code handlerSamplingProfile(absl::string_view path_and_query,
+                                    Http::ResponseHeaderMap& response_headers,
+                                    Buffer::Instance& response, AdminStream&);
+
+  Http::Code handlerStageTrace(absl::string_view path_and_query,
+                               Http::ResponseHeaderMap& response_headers,
+                               Buffer::Instance& response, AdminStream&);
+
+  Http::Code handlerStageTraceDump(absl::string_view path_and_query,
+                                   Http::ResponseHeaderMap& response_headers,
+                                   Buffer::Instance& response, AdminStream&);
+
 private:
   const std::string profile_path_;
 };
@@ -48,88 +48,6 @@ struct MetricLessThan {
   }
 };
 
-/**
- * Processes a stat type (counter, gauge, histogram) by generating all output lines, sorting
- * them by tag-extracted metric name, and then outputting them in the correct sorted order into
- * response.
- *
- * @param response The buffer to put the output into.
- * @param used_only Whether to only output stats that are used.
- * @param regex A filter on which stats to output.
- * @param metrics The metrics to output stats for. This must contain all stats of the given type
- *        to be included in the same output.
- * @param generate_output A function which returns the output text for this metric.
- * @param type The name of the prometheus metric type for used in TYPE annotations.
- */
-template <class StatType>
-uint64_t outputStatType(
-    Buffer::Instance& response, const bool used_only, const absl::optional<std::regex>& regex,
-    const std::vector<Stats::RefcountPtr<StatType>>& metrics,
-    const std::function<std::string(
-        const StatType& metric, const std::string& prefixed_tag_extracted_name)>& generate_output,
-    absl::string_view type) {
-
-  /*
-   * From
-   * https:*github.com/prometheus/docs/blob/master/content/docs/instrumenting/exposition_formats.md#grouping-and-sorting:
-   *
-   * All lines for a given metric must be provided as one single group, with the optional HELP and
-   * TYPE lines first (in no particular order). Beyond that, reproducible sorting in repeated
-   * expositions is preferred but not required, i.e. do not sort if the computational cost is
-   * prohibitive.
-   */
-
-  // This is an unsorted collection of dumb-pointers (no need to increment then decrement every
-  // refcount; ownership is held throughout by `metrics`). It is unsorted for efficiency, but will
-  // be sorted before producing the final output to satisfy the "preferred" ordering from the
-  // prometheus spec: metrics will be sorted by their tags' textual representation, which will be
-  // consistent across calls.
-  using StatTypeUnsortedCollection = std::vector<const StatType*>;
-
-  // Return early to avoid crashing when getting the symbol table from the first metric.
-  if (metrics.empty()) {
-    return 0;
-  }
-
-  // There should only be one symbol table for all of the stats in the admin
-  // interface. If this assumption changes, the name comparisons in this function
-  // will have to change to compare to convert all StatNames to strings before
-  // comparison.
-  const Stats::SymbolTable& global_symbol_table = metrics.front()->constSymbolTable();
-
-  // Sorted collection of metrics sorted by their tagExtractedName, to satisfy the requirements
-  // of the exposition format.
-  std::map<Stats::StatName, StatTypeUnsortedCollection, Stats::StatNameLessThan> groups(
-      global_symbol_table);
-
-  for (const auto& metric : metrics) {
-    ASSERT(&global_symbol_table == &metric->constSymbolTable());
-
-    if (!shouldShowMetric(*metric, used_only, regex)) {
-      continue;
-    }
-
-    groups[metric->tagExtractedStatName()].push_back(metric.get());
-  }
-
-  for (auto& group : groups) {
-    const std::string prefixed_tag_extracted_name =
-        PrometheusStatsFormatter::metricName(global_symbol_table.toString(group.first));
-    response.add(fmt::format("# TYPE {0} {1}\n", prefixed_tag_extracted_name, type));
-
-    // Sort before producing the final output to satisfy the "preferred" ordering from the
-    // prometheus spec: metrics will be sorted by their tags' textual representation, which will
-    // be consistent across calls.
-    std::sort(group.second.begin(), group.second.end(), MetricLessThan());
-
-    for (const auto& metric : group.second) {
-      response.add(generate_output(*metric, prefixed_tag_extracted_name));
-    }
-    response.add("\n");
-  }
-  return groups.size();
-}
-
 /*
  * Return the prometheus output for a numeric Stat (Counter or Gauge).
  */
@@ -182,6 +100,135 @@ absl::flat_hash_set<std::string>& prometheusNamespaces() {
 
 } // namespace
 
+/**
+ * Renders the metrics of a stat type (counter, gauge, histogram), grouped and sorted by
+ * tag-extracted metric name.
+ */
+template <class StatType> class PrometheusStatsRenderer::StatTypeRenderer {
+public:
+  using GenerateOutputFn = std::function<std::string(
+      const StatType& metric, const std::string& prefixed_tag_extracted_name)>;
+
+  /**
+   * @param metrics The metrics to output stats for. This must contain all stats of the given type
+   *        to be included in the same output.
+   * @param used_only Whether to only output stats that are used.
+   * @param regex A filter on which stats to output.
+   * @param generate_output A function which returns the output text for this metric.
+   * @param type The name of the prometheus metric type for used in TYPE annotations.
+   */
+  StatTypeRenderer(std::vector<Stats::RefcountPtr<StatType>>&& metrics, const bool used_only,
+                   const absl::optional<std::regex>& regex, GenerateOutputFn generate_output,
+                   absl::string_view type)
+      : metrics_(std::move(metrics)), generate_output_(generate_output), type_(type) {
+    // Return early to avoid crashing when getting the symbol table from the first metric.
+    if (metrics_.empty()) {
+      return;
+    }
+
+    // There should only be one symbol table for all of the stats in the admin
+    // interface. If this assumption changes, the name comparisons in this function
+    // will have to change to compare to convert all StatNames to strings before
+    // comparison.
+    symbol_table_ = &metrics_.front()->constSymbolTable();
+
+    // Sorted collection of metrics sorted by their tagExtractedName, to satisfy the requirements
+    // of the exposition format.
+    groups_ = std::make_unique<GroupMap>(*symbol_table_);
+    for (const auto& metric : metrics_) {
+      ASSERT(symbol_table_ == &metric->constSymbolTable());
+
+      if (!shouldShowMetric(*metric, used_only, regex)) {
+        continue;
+      }
+
+      (*groups_)[metric->tagExtractedStatName()].push_back(metric.get());
+    }
+    next_group_ = groups_->begin();
+  }
+
+  /**
+   * Outputs the groups of metrics that were not output yet into the response, until the response
+   * is longer than a chunk.
+   * @return whether all the groups were output.
+   */
+  bool render(Buffer::Instance& response) {
+    /*
+     * From
+     * https:*github.com/prometheus/docs/blob/master/content/docs/instrumenting/exposition_formats.md#grouping-and-sorting:
+     *
+     * All lines for a given metric must be provided as one single group, with the optional HELP
+     * and TYPE lines first (in no particular order). Beyond that, reproducible sorting in repeated
+     * expositions is preferred but not required, i.e. do not sort if the computational cost is
+     * prohibitive.
+     */
+    if (groups_ == nullptr) {
+      return true;
+    }
+    for (; next_group_ != groups_->end(); ++next_group_) {
+      if (response.length() >= ChunkSize) {
+        return false;
+      }
+      StatTypeUnsortedCollection& group = next_group_->second;
+      const std::string prefixed_tag_extracted_name =
+          PrometheusStatsFormatter::metricName(symbol_table_->toString(next_group_->first));
+      response.add(fmt::format("# TYPE {0} {1}\n", prefixed_tag_extracted_name, type_));
+
+      // Sort before producing the final output to satisfy the "preferred" ordering from the
+      // prometheus spec: metrics will be sorted by their tags' textual representation, which will
+      // be consistent across calls.
+      std::sort(group.begin(), group.end(), MetricLessThan());
+
+      for (const auto& metric : group) {
+        response.add(generate_output_(*metric, prefixed_tag_extracted_name));
+      }
+      response.add("\n");
+    }
+    return true;
+  }
+
+  uint64_t numGroups() const { return groups_ == nullptr ? 0 : groups_->size(); }
+
+private:
+  // This is an unsorted collection of dumb-pointers (no need to increment then decrement every
+  // refcount; ownership is held throughout by `metrics_`). It is unsorted for efficiency, but will
+  // be sorted before producing the final output to satisfy the "preferred" ordering from the
+  // prometheus spec: metrics will be sorted by their tags' textual representation, which will be
+  // consistent across calls.
+  using StatTypeUnsortedCollection = std::vector<const StatType*>;
+  using GroupMap = std::map<Stats::StatName, StatTypeUnsortedCollection, Stats::StatNameLessThan>;
+
+  const std::vector<Stats::RefcountPtr<StatType>> metrics_;
+  const GenerateOutputFn generate_output_;
+  const absl::string_view type_;
+  const Stats::SymbolTable* symbol_table_{};
+  std::unique_ptr<GroupMap> groups_;
+  typename GroupMap::iterator next_group_;
+};
+
+PrometheusStatsRenderer::PrometheusStatsRenderer(
+    std::vector<Stats::CounterSharedPtr>&& counters, std::vector<Stats::GaugeSharedPtr>&& gauges,
+    std::vector<Stats::ParentHistogramSharedPtr>&& histograms, const bool used_only,
+    const absl::optional<std::regex>& regex)
+    : counters_(std::make_unique<StatTypeRenderer<Stats::Counter>>(
+          std::move(counters), used_only, regex, generateNumericOutput<Stats::Counter>,
+          "counter")),
+      gauges_(std::make_unique<StatTypeRenderer<Stats::Gauge>>(
+          std::move(gauges), used_only, regex, generateNumericOutput<Stats::Gauge>, "gauge")),
+      histograms_(std::make_unique<StatTypeRenderer<Stats::ParentHistogram>>(
+          std::move(histograms), used_only, regex, generateHistogramOutput, "histogram")) {}
+
+PrometheusStatsRenderer::~PrometheusStatsRenderer() = default;
+
+bool PrometheusStatsRenderer::nextChunk(Buffer::Instance& response) {
+  return !(counters_->render(response) && gauges_->render(response) &&
+           histograms_->render(response));
+}
+
+uint64_t PrometheusStatsRenderer::metricNameCount() const {
+  return counters_->numGroups() + gauges_->numGroups() + histograms_->numGroups();
+}
+
 std::string PrometheusStatsFormatter::formattedTags(const std::vector<Stats::Tag>& tags) {
   std::vector<std::string> buf;
   buf.reserve(tags.size());
@@ -214,17 +261,13 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
     const std::vector<Stats::ParentHistogramSharedPtr>& histograms, Buffer::Instance& response,
     const bool used_only, const absl::optional<std::regex>& regex) {
 
-  uint64_t metric_name_count = 0;
-  metric_name_count += outputStatType<Stats::Counter>(
-      response, used_only, regex, counters, generateNumericOutput<Stats::Counter>, "counter");
-
-  metric_name_count += outputStatType<Stats::Gauge>(response, used_only, regex, gauges,
-                                                    generateNumericOutput<Stats::Gauge>, "gauge");
-
-  metric_name_count += outputStatType<Stats::ParentHistogram>(
-      response, used_only, regex, histograms, generateHistogramOutput, "histogram");
-
-  return metric_name_count;
+  PrometheusStatsRenderer renderer(std::vector<Stats::CounterSharedPtr>(counters),
+                                   std::vector<Stats::GaugeSharedPtr>(gauges),
+                                   std::vector<Stats::ParentHistogramSharedPtr>(histograms),
+                                   used_only, regex);
+  while (renderer.nextChunk(response)) {
+  }
+  return renderer.metricNameCount();
 }
 
 bool PrometheusStatsFormatter::registerPrometheusNamespace(absl::string_view prometheus_namespace) {
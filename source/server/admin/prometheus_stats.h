@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <regex>
 #include <string>
 
@@ -55,5 +56,40 @@ public:
   static bool unregisterPrometheusNamespace(absl::string_view prometheus_namespace);
 };
 
+/**
+ * Renders counters, gauges and histograms in the Prometheus exposition format one chunk at a time,
+ * so that the exposition of a large store can be streamed. The metrics are grouped and sorted when
+ * the renderer is created, and the output of each group is only generated for the chunk it is in.
+ */
+class PrometheusStatsRenderer {
+public:
+  // The size above which a chunk ends at the end of the current metric group.
+  static constexpr uint64_t ChunkSize = 64 * 1024;
+
+  PrometheusStatsRenderer(std::vector<Stats::CounterSharedPtr>&& counters,
+                          std::vector<Stats::GaugeSharedPtr>&& gauges,
+                          std::vector<Stats::ParentHistogramSharedPtr>&& histograms,
+                          const bool used_only, const absl::optional<std::regex>& regex);
+  ~PrometheusStatsRenderer();
+
+  /**
+   * Appends the next chunk of the exposition to the response.
+   * @return whether there are more chunks.
+   */
+  bool nextChunk(Buffer::Instance& response);
+
+  /**
+   * @return uint64_t total number of metric types in the exposition.
+   */
+  uint64_t metricNameCount() const;
+
+private:
+  template <class StatType> class StatTypeRenderer;
+
+  const std::unique_ptr<StatTypeRenderer<Stats::Counter>> counters_;
+  const std::unique_ptr<StatTypeRenderer<Stats::Gauge>> gauges_;
+  const std::unique_ptr<StatTypeRenderer<Stats::ParentHistogram>> histograms_;
+};
+
 } // namespace Server
 } // namespace Envoy
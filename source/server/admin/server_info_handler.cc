@@ -2,6 +2,7 @@
 
 #include "envoy/admin/v3/memory.pb.h"
 
+#include "common/memory/accounting.h"
 #include "common/memory/stats.h"
 #include "common/version/version.h"
 
@@ -52,6 +53,14 @@ Http::Code ServerInfoHandler::handlerMemory(absl::string_view,
   memory.set_pageheap_unmapped(Memory::Stats::totalPageHeapUnmapped());
   memory.set_pageheap_free(Memory::Stats::totalPageHeapFree());
   memory.set_total_physical_bytes(Memory::Stats::totalPhysicalBytes());
+  for (uint32_t i = 0; i < Memory::Accounting::NumAccounts; ++i) {
+    const auto account = static_cast<Memory::Accounting::Account>(i);
+    const Memory::Accounting::Usage usage = Memory::Accounting::usage(account);
+    envoy::admin::v3::MemoryAccount& memory_account =
+        (*memory.mutable_accounts())[std::string(Memory::Accounting::accountName(account))];
+    memory_account.set_bytes(usage.bytes_);
+    memory_account.set_objects(usage.objects_);
+  }
   response.add(MessageUtil::getJsonStringFromMessage(memory, true, true)); // pretty-print
   return Http::Code::OK;
 }
@@ -84,14 +84,19 @@ Http::Code StatsHandler::handlerStats(absl::string_view url,
     return Http::Code::BadRequest;
   }
 
+  // The store only visits the stats that may match a filter anchored at the start of the names,
+  // e.g. the stats of a cluster, and leaves out the unused stats before their names are built.
+  const Stats::SelectedStats selected =
+      server_.stats().selectStats(Utility::filterPrefix(params), used_only);
+
   std::map<std::string, uint64_t> all_stats;
-  for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
+  for (const Stats::CounterSharedPtr& counter : selected.counters_) {
     if (shouldShowMetric(*counter, used_only, regex)) {
       all_stats.emplace(counter->name(), counter->value());
     }
   }
 
-  for (const Stats::GaugeSharedPtr& gauge : server_.stats().gauges()) {
+  for (const Stats::GaugeSharedPtr& gauge : selected.gauges_) {
     if (shouldShowMetric(*gauge, used_only, regex)) {
       ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
       all_stats.emplace(gauge->name(), gauge->value());
@@ -99,7 +104,7 @@ Http::Code StatsHandler::handlerStats(absl::string_view url,
   }
 
   std::map<std::string, std::string> text_readouts;
-  for (const auto& text_readout : server_.stats().textReadouts()) {
+  for (const auto& text_readout : selected.text_readouts_) {
     if (shouldShowMetric(*text_readout, used_only, regex)) {
       text_readouts.emplace(text_readout->name(), text_readout->value());
     }
@@ -141,7 +146,8 @@ Http::Code StatsHandler::handlerStats(absl::string_view url,
 
 Http::Code StatsHandler::handlerPrometheusStats(absl::string_view path_and_query,
                                                 Http::ResponseHeaderMap&,
-                                                Buffer::Instance& response, AdminStream&) {
+                                                Buffer::Instance& response,
+                                                AdminStream& admin_stream) {
   const Http::Utility::QueryParams params =
       Http::Utility::parseAndDecodeQueryString(path_and_query);
   const bool used_only = params.find("usedonly") != params.end();
@@ -149,9 +155,14 @@ Http::Code StatsHandler::handlerPrometheusStats(absl::string_view path_and_query
   if (!Utility::filterParam(params, response, regex)) {
     return Http::Code::BadRequest;
   }
-  PrometheusStatsFormatter::statsAsPrometheus(server_.stats().counters(), server_.stats().gauges(),
-                                              server_.stats().histograms(), response, used_only,
-                                              regex);
+  // The exposition of large stores is streamed in chunks rather than built in one buffer.
+  auto renderer = std::make_shared<PrometheusStatsRenderer>(
+      server_.stats().counters(), server_.stats().gauges(), server_.stats().histograms(),
+      used_only, regex);
+  if (renderer->nextChunk(response)) {
+    admin_stream.streamRemainingResponse(
+        [renderer](Buffer::Instance& chunk) { return renderer->nextChunk(chunk); });
+  }
   return Http::Code::OK;
 }
 
@@ -1,8 +1,12 @@
 #include "server/admin/utils.h"
 
+#include "common/common/empty_string.h"
 #include "common/common/enum_to_int.h"
 #include "common/http/headers.h"
 
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+
 namespace Envoy {
 namespace Server {
 namespace Utility {
@@ -56,6 +60,37 @@ bool filterParam(Http::Utility::QueryParams params, Buffer::Instance& response,
   return true;
 }
 
+// Helper method to get a literal prefix of all the names that the filter parameter matches, when
+// the filter is anchored at the start of the name, e.g. "cluster.foo." for "^cluster\.foo\.".
+std::string filterPrefix(const Http::Utility::QueryParams& params) {
+  auto p = params.find("filter");
+  if (p == params.end()) {
+    return EMPTY_STRING;
+  }
+  const std::string& pattern = p->second;
+  if (!absl::StartsWith(pattern, "^") || pattern.find('|') != std::string::npos) {
+    return EMPTY_STRING;
+  }
+  std::string prefix;
+  for (size_t i = 1; i < pattern.size(); ++i) {
+    char c = pattern[i];
+    if (c == '*' || c == '?' || c == '{') {
+      // The previous character may not occur.
+      if (!prefix.empty()) {
+        prefix.pop_back();
+      }
+      break;
+    }
+    if (c == '\\' && i + 1 < pattern.size() && absl::ascii_ispunct(pattern[i + 1])) {
+      c = pattern[++i];
+    } else if (!absl::ascii_isalnum(c) && c != '_' && c != '-') {
+      break;
+    }
+    prefix.push_back(c);
+  }
+  return prefix;
+}
+
 // Helper method to get the format parameter.
 absl::optional<std::string> formatParam(const Http::Utility::QueryParams& params) {
   return queryParam(params, "format");
@@ -42,6 +42,10 @@ public:
   // Network::DrainDecision
   // TODO(junr03): hook up draining to listener state management.
   bool drainClose() const override { return false; }
+  Network::DrainCloseHandlePtr addOnDrainCloseCb(Event::Dispatcher&,
+                                                 Network::DrainCloseCb) const override {
+    return nullptr;
+  }
 
 protected:
   ApiListenerImplBase(const envoy::config::listener::v3::Listener& config,
@@ -143,6 +147,7 @@ protected:
       absl::string_view transportFailureReason() const override { return EMPTY_STRING; }
       bool startSecureTransport() override { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
       absl::optional<std::chrono::milliseconds> lastRoundTripTime() const override { return {}; };
+      bool enableSplicing(Network::Connection&) override { return false; }
 
       SyntheticReadCallbacks& parent_;
       StreamInfo::StreamInfoImpl stream_info_;
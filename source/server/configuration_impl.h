@@ -151,6 +151,7 @@ public:
   std::chrono::milliseconds killTimeout() const override { return kill_timeout_; }
   std::chrono::milliseconds multiKillTimeout() const override { return multikill_timeout_; }
   double multiKillThreshold() const override { return multikill_threshold_; }
+  std::chrono::milliseconds stallCaptureTimeout() const override { return stall_capture_timeout_; }
   Protobuf::RepeatedPtrField<envoy::config::bootstrap::v3::Watchdog::WatchdogAction>
   actions() const override {
     return actions_;
@@ -162,6 +163,7 @@ private:
   std::chrono::milliseconds kill_timeout_;
   std::chrono::milliseconds multikill_timeout_;
   double multikill_threshold_;
+  std::chrono::milliseconds stall_capture_timeout_;
   Protobuf::RepeatedPtrField<envoy::config::bootstrap::v3::Watchdog::WatchdogAction> actions_;
 };
 
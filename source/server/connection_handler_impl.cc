@@ -9,6 +9,7 @@
 #include "envoy/stats/scope.h"
 #include "envoy/stats/timespan.h"
 
+#include "common/common/stage_trace.h"
 #include "common/event/deferred_task.h"
 #include "common/network/connection_impl.h"
 #include "common/network/utility.h"
@@ -310,6 +311,14 @@ void ConnectionHandlerImpl::ActiveTcpSocket::unlink() {
   listener_.parent_.dispatcher_.deferredDelete(std::move(removed));
 }
 
+Network::ListenerFilterBuffer& ConnectionHandlerImpl::ActiveTcpSocket::listenerFilterBuffer() {
+  if (listener_filter_buffer_ == nullptr) {
+    listener_filter_buffer_ =
+        std::make_unique<Network::ListenerFilterBufferImpl>(socket_->ioHandle());
+  }
+  return *listener_filter_buffer_;
+}
+
 void ConnectionHandlerImpl::ActiveTcpSocket::continueFilterChain(bool success) {
   if (success) {
     bool no_error = true;
@@ -386,6 +395,7 @@ void ConnectionHandlerImpl::ActiveTcpSocket::newConnection() {
     // Erase accept filter states because accept filters may not get the opportunity to clean up.
     // Particularly the assigned events need to reset before assigning new events in the follow up.
     accept_filters_.clear();
+    listener_filter_buffer_.reset();
     // Create a new connection on this listener.
     listener_.newConnection(std::move(socket_), std::move(stream_info_));
   }
@@ -458,8 +468,24 @@ void ConnectionHandlerImpl::ActiveTcpListener::resumeListening() {
   }
 }
 
+namespace {
+// Structure used to allow the socket of a connection waiting for its filter chain to be captured
+// in a posted lambda.
+struct PendingConnection {
+  Network::ConnectionSocketPtr socket_;
+  std::unique_ptr<StreamInfo::StreamInfo> stream_info_;
+};
+using PendingConnectionSharedPtr = std::shared_ptr<PendingConnection>;
+} // namespace
+
 void ConnectionHandlerImpl::ActiveTcpListener::newConnection(
     Network::ConnectionSocketPtr&& socket, std::unique_ptr<StreamInfo::StreamInfo> stream_info) {
+  newConnection(std::move(socket), std::move(stream_info), false);
+}
+
+void ConnectionHandlerImpl::ActiveTcpListener::newConnection(
+    Network::ConnectionSocketPtr&& socket, std::unique_ptr<StreamInfo::StreamInfo> stream_info,
+    bool waited_for_filter_chain) {
   // Refresh addresses in case they are modified by listener filters, such as proxy protocol or
   // original_dst.
   stream_info->setDownstreamLocalAddress(socket->localAddress());
@@ -477,11 +503,46 @@ void ConnectionHandlerImpl::ActiveTcpListener::newConnection(
     return;
   }
 
+  if (const auto* on_demand = filter_chain->onDemandFilterChain();
+      on_demand != nullptr && !on_demand->built()) {
+    if (waited_for_filter_chain) {
+      ENVOY_LOG(debug, "closing connection: on-demand filter chain failed to build");
+      stats_.on_demand_filter_chain_failure_.inc();
+      emitLogs(*config_, *stream_info);
+      socket->close();
+      decNumConnections();
+      return;
+    }
+    // The connection comes back through the listener, which may have been updated in place or
+    // removed in the meantime.
+    ENVOY_LOG(debug, "waiting for on-demand filter chain to build");
+    auto pending = std::make_shared<PendingConnection>();
+    pending->socket_ = std::move(socket);
+    pending->stream_info_ = std::move(stream_info);
+    on_demand->build(
+        parent_.dispatcher_, [pending, tag = config_->listenerTag(), &parent = parent_]() {
+          auto listener = parent.findActiveListenerByTag(tag);
+          if (!listener.has_value()) {
+            pending->socket_->close();
+            return;
+          }
+          ASSERT(absl::holds_alternative<std::reference_wrapper<ActiveTcpListener>>(
+              listener->get().typed_listener_));
+          auto& tcp_listener =
+              absl::get<std::reference_wrapper<ActiveTcpListener>>(listener->get().typed_listener_)
+                  .get();
+          tcp_listener.newConnection(std::move(pending->socket_), std::move(pending->stream_info_),
+                                     true);
+        });
+    return;
+  }
+
   auto transport_socket = filter_chain->transportSocketFactory().createTransportSocket(nullptr);
   stream_info->setDownstreamSslConnection(transport_socket->ssl());
   auto& active_connections = getOrCreateActiveConnections(*filter_chain);
   auto server_conn_ptr = parent_.dispatcher_.createServerConnection(
       std::move(socket), std::move(transport_socket), *stream_info);
+  STAGE_TRACE(StageTrace::Stage::Accept, server_conn_ptr->id(), 0);
   if (const auto timeout = filter_chain->transportSocketConnectTimeout();
       timeout != std::chrono::milliseconds::zero()) {
     server_conn_ptr->setTransportSocketConnectTimeout(timeout);
@@ -742,6 +803,10 @@ void ActiveRawUdpListener::onWriteReady(const Network::Socket&) {
 
   // Clear write_blocked_ status for udpPacketWriter
   udp_packet_writer_->setWritable();
+  // Send what a batching writer still holds from when it was blocked.
+  if (udp_packet_writer_->isBatchMode()) {
+    udp_packet_writer_->flush();
+  }
 }
 
 void ActiveRawUdpListener::onReceiveError(Api::IoError::IoErrorCode error_code) {
@@ -19,6 +19,7 @@
 
 #include "common/common/linked_object.h"
 #include "common/common/non_copyable.h"
+#include "common/network/listener_filter_buffer_impl.h"
 #include "common/stream_info/stream_info_impl.h"
 
 #include "spdlog/spdlog.h"
@@ -34,6 +35,7 @@ namespace Server {
   COUNTER(downstream_global_cx_overflow)                                                           \
   COUNTER(downstream_pre_cx_timeout)                                                               \
   COUNTER(no_filter_chain_match)                                                                   \
+  COUNTER(on_demand_filter_chain_failure)                                                          \
   GAUGE(downstream_cx_active, Accumulate)                                                          \
   GAUGE(downstream_pre_cx_active, Accumulate)                                                      \
   HISTOGRAM(downstream_cx_length_ms, Milliseconds)
@@ -163,6 +165,14 @@ private:
     void newConnection(Network::ConnectionSocketPtr&& socket,
                        std::unique_ptr<StreamInfo::StreamInfo> stream_info);
 
+    /**
+     * Create a new connection from a socket, which may have waited for its on-demand filter chain
+     * to build, in which case the connection is closed if the filter chain is still not built.
+     */
+    void newConnection(Network::ConnectionSocketPtr&& socket,
+                       std::unique_ptr<StreamInfo::StreamInfo> stream_info,
+                       bool waited_for_filter_chain);
+
     /**
      * Return the active connections container attached with the given filter chain.
      */
@@ -316,6 +326,7 @@ private:
     // Network::ListenerFilterCallbacks
     Network::ConnectionSocket& socket() override { return *socket_.get(); }
     Event::Dispatcher& dispatcher() override { return listener_.parent_.dispatcher_; }
+    Network::ListenerFilterBuffer& listenerFilterBuffer() override;
     void continueFilterChain(bool success) override;
     void setDynamicMetadata(const std::string& name, const ProtobufWkt::Struct& value) override;
     envoy::config::core::v3::Metadata& dynamicMetadata() override {
@@ -327,6 +338,8 @@ private:
 
     ActiveTcpListener& listener_;
     Network::ConnectionSocketPtr socket_;
+    // The bytes peeked by the listener filters, created by the first filter that peeks.
+    std::unique_ptr<Network::ListenerFilterBufferImpl> listener_filter_buffer_;
     const bool hand_off_restored_destination_connections_;
     std::list<ListenerFilterWrapperPtr> accept_filters_;
     std::list<ListenerFilterWrapperPtr>::iterator iter_;
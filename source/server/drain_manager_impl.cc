@@ -1,17 +1,92 @@
 #include "server/drain_manager_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <list>
 
 #include "envoy/config/listener/v3/listener.pb.h"
 #include "envoy/event/timer.h"
 
 #include "common/common/assert.h"
+#include "common/common/lock_guard.h"
 
 namespace Envoy {
 namespace Server {
 
+/**
+ * The connections of a worker registered for paced draining. Once created, it is only accessed on
+ * the thread of the worker, and it outlives the drain manager until the posted drain steps and the
+ * registrations are gone.
+ */
+class DrainManagerImpl::PacedDrainConnections {
+public:
+  struct Connection {
+    Network::DrainCloseCb cb_;
+    bool drained_{};
+  };
+  using ConnectionList = std::list<Connection>;
+
+  ConnectionList::iterator add(Network::DrainCloseCb&& cb) {
+    ++pending_;
+    return connections_.insert(connections_.end(), Connection{std::move(cb)});
+  }
+
+  void remove(ConnectionList::iterator it) {
+    if (!it->drained_) {
+      --pending_;
+    }
+    connections_.erase(it);
+  }
+
+  /**
+   * Drains the share of the connections left which drains them all in the steps left, the idle
+   * ones first.
+   * @param steps_left supplies the number of steps left in the drain period, including this one.
+   * @param max_drains supplies the most connections to drain in the step, or 0 for no limit.
+   */
+  void drainStep(uint64_t steps_left, uint64_t max_drains) {
+    ASSERT(steps_left > 0);
+    uint64_t count = (pending_ + steps_left - 1) / steps_left;
+    if (max_drains > 0) {
+      count = std::min(count, max_drains);
+    }
+    count -= drain(count, true);
+    drain(count, false);
+  }
+
+private:
+  // The busy connections ahead of the idle ones are scanned again at each step, which is cheap
+  // next to the draining of a connection.
+  uint64_t drain(uint64_t count, bool idle_only) {
+    uint64_t drained = 0;
+    for (auto it = connections_.begin(); it != connections_.end() && drained < count; ++it) {
+      if (!it->drained_ && it->cb_(idle_only)) {
+        it->drained_ = true;
+        --pending_;
+        ++drained;
+      }
+    }
+    return drained;
+  }
+
+  ConnectionList connections_;
+  // The connections not drained yet.
+  uint64_t pending_{};
+};
+
+class DrainManagerImpl::PacedDrainHandle : public Network::DrainCloseHandle {
+public:
+  PacedDrainHandle(PacedDrainConnectionsSharedPtr connections, Network::DrainCloseCb&& cb)
+      : connections_(std::move(connections)), it_(connections_->add(std::move(cb))) {}
+  ~PacedDrainHandle() override { connections_->remove(it_); }
+
+private:
+  const PacedDrainConnectionsSharedPtr connections_;
+  const PacedDrainConnections::ConnectionList::iterator it_;
+};
+
 DrainManagerImpl::DrainManagerImpl(Instance& server,
                                    envoy::config::listener::v3::Listener::DrainType drain_type)
     : server_(server), drain_type_(drain_type) {}
@@ -35,7 +110,6 @@ bool DrainManagerImpl::drainClose() const {
   if (server_.options().drainStrategy() == Server::DrainStrategy::Immediate) {
     return true;
   }
-  ASSERT(server_.options().drainStrategy() == Server::DrainStrategy::Gradual);
 
   // P(return true) = elapsed time / drain timeout
   // If the drain deadline is exceeded, skip the probability calculation.
@@ -44,6 +118,12 @@ bool DrainManagerImpl::drainClose() const {
     return true;
   }
 
+  // The paced drain tells the connections when to drain instead.
+  if (server_.options().drainStrategy() == Server::DrainStrategy::Paced) {
+    return false;
+  }
+  ASSERT(server_.options().drainStrategy() == Server::DrainStrategy::Gradual);
+
   const auto remaining_time =
       std::chrono::duration_cast<std::chrono::seconds>(drain_deadline_ - current_time);
   ASSERT(server_.options().drainTime() >= remaining_time);
@@ -52,6 +132,24 @@ bool DrainManagerImpl::drainClose() const {
          (server_.api().randomGenerator().random() % server_.options().drainTime().count());
 }
 
+Network::DrainCloseHandlePtr
+DrainManagerImpl::addOnDrainCloseCb(Event::Dispatcher& dispatcher, Network::DrainCloseCb cb) const {
+  if (server_.options().drainStrategy() != Server::DrainStrategy::Paced) {
+    return nullptr;
+  }
+
+  PacedDrainConnectionsSharedPtr connections;
+  {
+    Thread::LockGuard guard(paced_mutex_);
+    PacedDrainConnectionsSharedPtr& worker_connections = paced_connections_[&dispatcher];
+    if (worker_connections == nullptr) {
+      worker_connections = std::make_shared<PacedDrainConnections>();
+    }
+    connections = worker_connections;
+  }
+  return std::make_unique<PacedDrainHandle>(std::move(connections), std::move(cb));
+}
+
 void DrainManagerImpl::startDrainSequence(std::function<void()> drain_complete_cb) {
   ASSERT(drain_complete_cb);
   ASSERT(!draining_);
@@ -61,6 +159,35 @@ void DrainManagerImpl::startDrainSequence(std::function<void()> drain_complete_c
   const std::chrono::seconds drain_delay(server_.options().drainTime());
   drain_tick_timer_->enableTimer(drain_delay);
   drain_deadline_ = server_.dispatcher().timeSource().monotonicTime() + drain_delay;
+
+  if (server_.options().drainStrategy() == Server::DrainStrategy::Paced) {
+    paced_drain_timer_ = server_.dispatcher().createTimer([this]() -> void { onPacedDrainStep(); });
+    onPacedDrainStep();
+  }
+}
+
+void DrainManagerImpl::onPacedDrainStep() {
+  // Past the deadline, drainClose() drains the connections left.
+  const MonotonicTime current_time = server_.dispatcher().timeSource().monotonicTime();
+  if (current_time >= drain_deadline_) {
+    return;
+  }
+
+  const uint64_t steps_left = std::max<uint64_t>(
+      1, std::chrono::duration_cast<std::chrono::seconds>(drain_deadline_ - current_time) /
+             PacedDrainInterval);
+  const uint64_t max_drains =
+      server_.runtime().snapshot().getInteger("server.paced_drain_max_closes_per_second", 0) *
+      PacedDrainInterval.count();
+  {
+    Thread::LockGuard guard(paced_mutex_);
+    for (const auto& [dispatcher, connections] : paced_connections_) {
+      dispatcher->post([connections = connections, steps_left, max_drains]() -> void {
+        connections->drainStep(steps_left, max_drains);
+      });
+    }
+  }
+  paced_drain_timer_->enableTimer(PacedDrainInterval);
 }
 
 void DrainManagerImpl::startParentShutdownSequence() {
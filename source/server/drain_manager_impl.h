@@ -1,6 +1,8 @@
 #pragma once
 
+#include <chrono>
 #include <functional>
+#include <memory>
 
 #include "envoy/common/time.h"
 #include "envoy/config/listener/v3/listener.pb.h"
@@ -9,6 +11,9 @@
 #include "envoy/server/instance.h"
 
 #include "common/common/logger.h"
+#include "common/common/thread.h"
+
+#include "absl/container/flat_hash_map.h"
 
 namespace Envoy {
 namespace Server {
@@ -18,6 +23,11 @@ namespace Server {
  * 1) Terminates the parent process after 15 minutes.
  * 2) Drains the parent process over a period of 10 minutes where drain close becomes more
  *    likely each second that passes.
+ * With the paced drain strategy, the connections which register with addOnDrainCloseCb() are
+ * instead told to drain every second, on their worker, a share of the connections left so that
+ * they are all drained by the end of the drain period, the idle ones first. The runtime key
+ * server.paced_drain_max_closes_per_second caps the connections drained per second on a worker,
+ * to stay within the handshake budget of the reconnecting clients.
  */
 class DrainManagerImpl : Logger::Loggable<Logger::Id::main>, public DrainManager {
 public:
@@ -25,13 +35,24 @@ public:
 
   // Network::DrainDecision
   bool drainClose() const override;
+  Network::DrainCloseHandlePtr addOnDrainCloseCb(Event::Dispatcher& dispatcher,
+                                                 Network::DrainCloseCb cb) const override;
 
   // Server::DrainManager
   void startDrainSequence(std::function<void()> drain_complete_cb) override;
   bool draining() const override { return draining_; }
   void startParentShutdownSequence() override;
 
+  // The interval between two steps of a paced drain.
+  static constexpr std::chrono::seconds PacedDrainInterval{1};
+
 private:
+  class PacedDrainConnections;
+  class PacedDrainHandle;
+  using PacedDrainConnectionsSharedPtr = std::shared_ptr<PacedDrainConnections>;
+
+  void onPacedDrainStep();
+
   Instance& server_;
   const envoy::config::listener::v3::Listener::DrainType drain_type_;
 
@@ -40,6 +61,12 @@ private:
   MonotonicTime drain_deadline_;
 
   Event::TimerPtr parent_shutdown_timer_;
+
+  // The connections registered for paced draining, by the dispatcher of their worker.
+  mutable Thread::MutexBasicLockable paced_mutex_;
+  mutable absl::flat_hash_map<Event::Dispatcher*, PacedDrainConnectionsSharedPtr>
+      paced_connections_ ABSL_GUARDED_BY(paced_mutex_);
+  Event::TimerPtr paced_drain_timer_;
 };
 
 } // namespace Server
@@ -36,6 +36,12 @@ bool PerFilterChainFactoryContextImpl::drainClose() const {
   return is_draining_.load() || parent_context_.drainDecision().drainClose();
 }
 
+Network::DrainCloseHandlePtr
+PerFilterChainFactoryContextImpl::addOnDrainCloseCb(Event::Dispatcher& dispatcher,
+                                                    Network::DrainCloseCb cb) const {
+  return parent_context_.drainDecision().addOnDrainCloseCb(dispatcher, std::move(cb));
+}
+
 Network::DrainDecision& PerFilterChainFactoryContextImpl::drainDecision() { return *this; }
 
 Init::Manager& PerFilterChainFactoryContextImpl::initManager() { return init_manager_; }
@@ -155,6 +161,7 @@ void FilterChainManagerImpl::addFilterChains(
                       MessageUtil>
       filter_chains;
   uint32_t new_filter_chain_size = 0;
+  uint32_t new_on_demand_filter_chain_size = 0;
   for (const auto& filter_chain : filter_chain_span) {
     const auto& filter_chain_match = filter_chain->filter_chain_match();
     if (!filter_chain_match.address_suffix().empty() || filter_chain_match.has_suffix_len()) {
@@ -201,9 +208,16 @@ void FilterChainManagerImpl::addFilterChains(
     // ListenerImpl maintains the dependencies of FilterChainFactoryContext
     auto filter_chain_impl = findExistingFilterChain(*filter_chain);
     if (filter_chain_impl == nullptr) {
-      filter_chain_impl =
-          filter_chain_factory_builder.buildFilterChain(*filter_chain, context_creator);
-      ++new_filter_chain_size;
+      if (filter_chain->has_on_demand_configuration() &&
+          on_demand_filter_chain_builder_ != nullptr) {
+        filter_chain_impl = std::make_shared<OnDemandFilterChainImpl>(
+            *filter_chain, parent_context_, on_demand_filter_chain_builder_);
+        ++new_on_demand_filter_chain_size;
+      } else {
+        filter_chain_impl =
+            filter_chain_factory_builder.buildFilterChain(*filter_chain, context_creator);
+        ++new_filter_chain_size;
+      }
     }
 
     addFilterChainForDestinationPorts(
@@ -218,8 +232,10 @@ void FilterChainManagerImpl::addFilterChains(
   convertIPsToTries();
   copyOrRebuildDefaultFilterChain(default_filter_chain, filter_chain_factory_builder,
                                   context_creator);
-  ENVOY_LOG(debug, "new fc_contexts has {} filter chains, including {} newly built",
-            fc_contexts_.size(), new_filter_chain_size);
+  ENVOY_LOG(debug,
+            "new fc_contexts has {} filter chains, including {} newly built and {} to build on "
+            "demand",
+            fc_contexts_.size(), new_filter_chain_size, new_on_demand_filter_chain_size);
 }
 
 void FilterChainManagerImpl::copyOrRebuildDefaultFilterChain(
@@ -667,6 +683,109 @@ Configuration::FilterChainFactoryContextPtr FilterChainManagerImpl::createFilter
   return std::make_unique<PerFilterChainFactoryContextImpl>(parent_context_, init_manager_);
 }
 
+OnDemandFilterChainImpl::OnDemandFilterChainImpl(
+    const envoy::config::listener::v3::FilterChain& filter_chain,
+    Configuration::FactoryContext& parent_context, OnDemandFilterChainBuilder builder)
+    : state_(std::make_shared<BuildState>(filter_chain, parent_context, std::move(builder))) {}
+
+void OnDemandFilterChainImpl::build(Event::Dispatcher& dispatcher,
+                                    std::function<void()> cb) const {
+  state_->parent_context_.dispatcher().post(
+      [weak_state = std::weak_ptr<BuildState>(state_), &dispatcher, cb]() {
+        if (auto state = weak_state.lock(); state != nullptr) {
+          state->addWaiter(dispatcher, cb);
+        } else {
+          // The listeners that shared the filter chain are gone, let the connection find out.
+          dispatcher.post(cb);
+        }
+      });
+}
+
+OnDemandFilterChainImpl::BuildState::BuildState(
+    const envoy::config::listener::v3::FilterChain& filter_chain,
+    Configuration::FactoryContext& parent_context, OnDemandFilterChainBuilder builder)
+    : parent_context_(parent_context), config_(filter_chain), builder_(std::move(builder)),
+      rebuild_timeout_(PROTOBUF_GET_MS_OR_DEFAULT(filter_chain.on_demand_configuration(),
+                                                  rebuild_timeout, 15000)) {}
+
+void OnDemandFilterChainImpl::BuildState::addWaiter(Event::Dispatcher& dispatcher,
+                                                    std::function<void()> cb) {
+  if (built_filter_chain_.load(std::memory_order_acquire) != nullptr) {
+    dispatcher.post(std::move(cb));
+    return;
+  }
+  waiters_.emplace_back(&dispatcher, std::move(cb));
+  if (init_manager_ == nullptr) {
+    startBuild();
+  }
+}
+
+void OnDemandFilterChainImpl::BuildState::startDraining() {
+  draining_ = true;
+  if (auto* filter_chain = built_filter_chain_.load(std::memory_order_acquire);
+      filter_chain != nullptr) {
+    filter_chain->startDraining();
+  }
+}
+
+Configuration::FilterChainFactoryContextPtr
+OnDemandFilterChainImpl::BuildState::createFilterChainFactoryContext(
+    const ::envoy::config::listener::v3::FilterChain* const) {
+  return std::make_unique<PerFilterChainFactoryContextImpl>(parent_context_, *init_manager_);
+}
+
+void OnDemandFilterChainImpl::BuildState::startBuild() {
+  ENVOY_LOG(debug, "building on-demand filter chain '{}'", config_.name());
+  init_manager_ = std::make_unique<Init::ManagerImpl>(
+      fmt::format("on-demand filter chain '{}'", config_.name()));
+  try {
+    filter_chain_ = builder_(config_, *this, *init_manager_);
+  } catch (const EnvoyException& e) {
+    ENVOY_LOG(warn, "error building on-demand filter chain '{}': {}", config_.name(), e.what());
+    finishBuild(false);
+    return;
+  }
+
+  if (rebuild_timeout_ != std::chrono::milliseconds::zero()) {
+    if (rebuild_timer_ == nullptr) {
+      rebuild_timer_ = parent_context_.dispatcher().createTimer([this]() {
+        ENVOY_LOG(warn, "timed out initializing on-demand filter chain '{}'", config_.name());
+        finishBuild(false);
+      });
+    }
+    rebuild_timer_->enableTimer(rebuild_timeout_);
+  }
+  // The filter chain is ready once its dependencies, such as its route configurations and secrets,
+  // are. The watcher may be called right away, and the init manager is kept for the filter chain
+  // factory contexts.
+  init_watcher_ =
+      std::make_unique<Init::WatcherImpl>(config_.name(), [this]() { finishBuild(true); });
+  init_manager_->initialize(*init_watcher_);
+}
+
+void OnDemandFilterChainImpl::BuildState::finishBuild(bool success) {
+  if (rebuild_timer_ != nullptr) {
+    rebuild_timer_->disableTimer();
+  }
+  if (success) {
+    ENVOY_LOG(debug, "built on-demand filter chain '{}'", config_.name());
+    if (draining_) {
+      filter_chain_->startDraining();
+    }
+    built_filter_chain_.store(filter_chain_.get(), std::memory_order_release);
+  } else {
+    // The next connection to match the filter chain builds it again.
+    filter_chain_.reset();
+    init_watcher_.reset();
+    init_manager_.reset();
+  }
+  // The connections that waited for the filter chain close if it is not built.
+  for (auto& waiter : waiters_) {
+    waiter.first->post(std::move(waiter.second));
+  }
+  waiters_.clear();
+}
+
 FactoryContextImpl::FactoryContextImpl(Server::Instance& server,
                                        const envoy::config::listener::v3::Listener& config,
                                        Network::DrainDecision& drain_decision,
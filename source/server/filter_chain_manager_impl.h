@@ -1,10 +1,15 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include "envoy/config/listener/v3/listener_components.pb.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
 #include "envoy/network/drain_decision.h"
 #include "envoy/server/filter_config.h"
 #include "envoy/server/instance.h"
@@ -13,6 +18,7 @@
 
 #include "common/common/logger.h"
 #include "common/init/manager_impl.h"
+#include "common/init/watcher_impl.h"
 #include "common/network/cidr_range.h"
 #include "common/network/lc_trie.h"
 
@@ -47,6 +53,8 @@ public:
 
   // DrainDecision
   bool drainClose() const override;
+  Network::DrainCloseHandlePtr addOnDrainCloseCb(Event::Dispatcher& dispatcher,
+                                                 Network::DrainCloseCb cb) const override;
 
   // Configuration::FactoryContext
   AccessLog::AccessLogManager& accessLogManager() override;
@@ -104,6 +112,7 @@ public:
   const std::vector<Network::FilterFactoryCb>& networkFilterFactories() const override {
     return filters_factory_;
   }
+  const Network::OnDemandFilterChain* onDemandFilterChain() const override { return nullptr; }
   void startDraining() override { factory_context_->startDraining(); }
 
   void setFilterChainFactoryContext(
@@ -119,6 +128,93 @@ private:
   const std::chrono::milliseconds transport_socket_connect_timeout_;
 };
 
+/**
+ * Builds an on-demand filter chain on the main thread, with the given factory context creator and
+ * init manager. Since an in-place listener update shares the on-demand filter chains with the new
+ * listener, it must only capture what the listeners updated in place share.
+ */
+using OnDemandFilterChainBuilder = std::function<Network::DrainableFilterChainSharedPtr(
+    const envoy::config::listener::v3::FilterChain& filter_chain,
+    FilterChainFactoryContextCreator& context_creator, Init::Manager& init_manager)>;
+
+/**
+ * Takes the place of a filter chain configured with an on_demand_configuration in the filter chain
+ * tables, and forwards to the filter chain once built. The filter chain is built the first time a
+ * connection matches it, and initialized with its own init manager, which the connections wait
+ * for. It is then kept as long as the placeholder, which is shared across in-place updates.
+ */
+class OnDemandFilterChainImpl : public Network::DrainableFilterChain,
+                                public Network::OnDemandFilterChain {
+public:
+  OnDemandFilterChainImpl(const envoy::config::listener::v3::FilterChain& filter_chain,
+                          Configuration::FactoryContext& parent_context,
+                          OnDemandFilterChainBuilder builder);
+
+  // Network::FilterChain
+  const Network::TransportSocketFactory& transportSocketFactory() const override {
+    return builtFilterChain().transportSocketFactory();
+  }
+  std::chrono::milliseconds transportSocketConnectTimeout() const override {
+    return builtFilterChain().transportSocketConnectTimeout();
+  }
+  const std::vector<Network::FilterFactoryCb>& networkFilterFactories() const override {
+    return builtFilterChain().networkFilterFactories();
+  }
+  const Network::OnDemandFilterChain* onDemandFilterChain() const override { return this; }
+
+  // Network::DrainableFilterChain
+  void startDraining() override { state_->startDraining(); }
+
+  // Network::OnDemandFilterChain
+  bool built() const override {
+    return state_->built_filter_chain_.load(std::memory_order_acquire) != nullptr;
+  }
+  void build(Event::Dispatcher& dispatcher, std::function<void()> cb) const override;
+
+private:
+  // The state of the build, which is only touched on the main thread but for the built filter
+  // chain. The callbacks posted to the main thread hold it weakly.
+  class BuildState : public FilterChainFactoryContextCreator, Logger::Loggable<Logger::Id::config> {
+  public:
+    BuildState(const envoy::config::listener::v3::FilterChain& filter_chain,
+               Configuration::FactoryContext& parent_context, OnDemandFilterChainBuilder builder);
+
+    void addWaiter(Event::Dispatcher& dispatcher, std::function<void()> cb);
+    void startDraining();
+
+    // FilterChainFactoryContextCreator
+    Configuration::FilterChainFactoryContextPtr createFilterChainFactoryContext(
+        const ::envoy::config::listener::v3::FilterChain* const filter_chain) override;
+
+    Configuration::FactoryContext& parent_context_;
+    // Set once built, and read by the workers.
+    std::atomic<Network::DrainableFilterChain*> built_filter_chain_{};
+
+  private:
+    void startBuild();
+    void finishBuild(bool success);
+
+    const envoy::config::listener::v3::FilterChain config_;
+    const OnDemandFilterChainBuilder builder_;
+    const std::chrono::milliseconds rebuild_timeout_;
+    // Set while the filter chain is being built and once it is built.
+    std::unique_ptr<Init::ManagerImpl> init_manager_;
+    std::unique_ptr<Init::WatcherImpl> init_watcher_;
+    Network::DrainableFilterChainSharedPtr filter_chain_;
+    Event::TimerPtr rebuild_timer_;
+    std::vector<std::pair<Event::Dispatcher*, std::function<void()>>> waiters_;
+    bool draining_{};
+  };
+
+  const Network::DrainableFilterChain& builtFilterChain() const {
+    const auto* filter_chain = state_->built_filter_chain_.load(std::memory_order_acquire);
+    ASSERT(filter_chain != nullptr);
+    return *filter_chain;
+  }
+
+  const std::shared_ptr<BuildState> state_;
+};
+
 /**
  * Implementation of FactoryContext wrapping a Server::Instance and some listener components.
  */
@@ -200,6 +296,12 @@ public:
       FilterChainFactoryBuilder& filter_chain_factory_builder,
       FilterChainFactoryContextCreator& context_creator);
 
+  // Set the builder of the filter chains configured with an on_demand_configuration, before adding
+  // the filter chains. Without it, these filter chains are built with the others.
+  void setOnDemandFilterChainBuilder(OnDemandFilterChainBuilder builder) {
+    on_demand_filter_chain_builder_ = std::move(builder);
+  }
+
   static bool isWildcardServerName(const std::string& name);
 
   // Return the current view of filter chains, keyed by filter chain message. Used by the owning
@@ -342,6 +444,8 @@ private:
   // init manager owned by the corresponding listener. The reference is valid when building the
   // filter chain.
   Init::Manager& init_manager_;
+
+  OnDemandFilterChainBuilder on_demand_filter_chain_builder_;
 };
 } // namespace Server
 } // namespace Envoy
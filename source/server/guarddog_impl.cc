@@ -4,6 +4,7 @@
 
 #include <chrono>
 #include <memory>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -32,12 +33,14 @@ namespace Server {
 
 GuardDogImpl::GuardDogImpl(Stats::Scope& stats_scope, const Server::Configuration::Watchdog& config,
                            Api::Api& api, absl::string_view name,
-                           std::unique_ptr<TestInterlockHook>&& test_interlock)
+                           std::unique_ptr<TestInterlockHook>&& test_interlock,
+                           StallProfiler* stall_profiler)
     : test_interlock_hook_(std::move(test_interlock)), stats_scope_(stats_scope),
       time_source_(api.timeSource()), miss_timeout_(config.missTimeout()),
       megamiss_timeout_(config.megaMissTimeout()), kill_timeout_(config.killTimeout()),
       multi_kill_timeout_(config.multiKillTimeout()),
-      multi_kill_fraction_(config.multiKillThreshold() / 100.0),
+      multi_kill_fraction_(config.multiKillThreshold() / 100.0), stall_profiler_(stall_profiler),
+      stall_capture_timeout_(config.stallCaptureTimeout()),
       loop_interval_([&]() -> std::chrono::milliseconds {
         // The loop interval is simply the minimum of all specified intervals,
         // but we must account for the 0=disabled case. This lambda takes care
@@ -45,6 +48,7 @@ GuardDogImpl::GuardDogImpl(Stats::Scope& stats_scope, const Server::Configuratio
         const auto min_of_nonfatal = std::min(miss_timeout_, megamiss_timeout_);
         return std::min({killEnabled() ? kill_timeout_ : min_of_nonfatal,
                          multikillEnabled() ? multi_kill_timeout_ : min_of_nonfatal,
+                         stallCaptureEnabled() ? stall_capture_timeout_ : min_of_nonfatal,
                          min_of_nonfatal});
       }()),
       watchdog_miss_counter_(stats_scope.counterFromStatName(
@@ -99,6 +103,11 @@ GuardDogImpl::GuardDogImpl(Stats::Scope& stats_scope, const Server::Configuratio
                            Api::Api& api, absl::string_view name)
     : GuardDogImpl(stats_scope, config, api, name, std::make_unique<TestInterlockHook>()) {}
 
+GuardDogImpl::GuardDogImpl(Stats::Scope& stats_scope, const Server::Configuration::Watchdog& config,
+                           Api::Api& api, absl::string_view name, StallProfiler& stall_profiler)
+    : GuardDogImpl(stats_scope, config, api, name, std::make_unique<TestInterlockHook>(),
+                   &stall_profiler) {}
+
 GuardDogImpl::~GuardDogImpl() { stop(); }
 
 void GuardDogImpl::step() {
@@ -114,6 +123,7 @@ void GuardDogImpl::step() {
   const auto now = time_source_.monotonicTime();
   std::vector<std::pair<Thread::ThreadId, MonotonicTime>> miss_threads;
   std::vector<std::pair<Thread::ThreadId, MonotonicTime>> mega_miss_threads;
+  std::vector<std::tuple<Thread::ThreadId, std::string, std::chrono::milliseconds>> stall_threads;
 
   {
     std::vector<std::pair<Thread::ThreadId, MonotonicTime>> multi_kill_threads;
@@ -128,6 +138,7 @@ void GuardDogImpl::step() {
       if (watched_dog->dog_->getTouchedAndReset()) {
         // Watchdog was touched since the guard dog last checked; update last check-in time.
         watched_dog->last_checkin_ = now;
+        watched_dog->stall_captured_ = false;
         continue;
       }
 
@@ -138,6 +149,13 @@ void GuardDogImpl::step() {
         watched_dog->miss_alerted_ = false;
         watched_dog->megamiss_alerted_ = false;
       }
+      if (stallCaptureEnabled() && delta > stall_capture_timeout_ &&
+          !watched_dog->stall_captured_) {
+        watched_dog->stall_captured_ = true;
+        stall_threads.emplace_back(
+            tid, watched_dog->thread_name_,
+            std::chrono::duration_cast<std::chrono::milliseconds>(delta));
+      }
       if (delta > miss_timeout_) {
         if (!watched_dog->miss_alerted_) {
           watchdog_miss_counter_.inc();
@@ -169,6 +187,11 @@ void GuardDogImpl::step() {
     }
   }
 
+  // Capture the stacks out of wd_lock_, as each capture waits for the thread to handle a signal.
+  for (const auto& [tid, thread_name, delta] : stall_threads) {
+    stall_profiler_->recordStall(tid, thread_name, delta);
+  }
+
   // Run megamiss and miss handlers
   if (!mega_miss_threads.empty()) {
     invokeGuardDogActions(WatchDogAction::MEGAMISS, mega_miss_threads, now);
@@ -250,7 +273,7 @@ void GuardDogImpl::invokeGuardDogActions(
 
 GuardDogImpl::WatchedDog::WatchedDog(Stats::Scope& stats_scope, const std::string& thread_name,
                                      const WatchDogImplSharedPtr& watch_dog)
-    : dog_(watch_dog),
+    : dog_(watch_dog), thread_name_(thread_name),
       miss_counter_(stats_scope.counterFromStatName(
           Stats::StatNameManagedStorage(fmt::format("server.{}.watchdog_miss", thread_name),
                                         stats_scope.symbolTable())
@@ -18,6 +18,7 @@
 #include "common/common/thread.h"
 #include "common/event/libevent.h"
 
+#include "server/stall_profiler.h"
 #include "server/watchdog_impl.h"
 
 #include "absl/types/optional.h"
@@ -71,9 +72,16 @@ public:
    */
   GuardDogImpl(Stats::Scope& stats_scope, const Server::Configuration::Watchdog& config,
                Api::Api& api, absl::string_view name,
-               std::unique_ptr<TestInterlockHook>&& test_interlock);
+               std::unique_ptr<TestInterlockHook>&& test_interlock,
+               StallProfiler* stall_profiler = nullptr);
   GuardDogImpl(Stats::Scope& stats_scope, const Server::Configuration::Watchdog& config,
                Api::Api& api, absl::string_view name);
+  /**
+   * @param stall_profiler records the stacks of the threads that are nonresponsive for longer
+   * than the stall capture timeout of the configuration, if any.
+   */
+  GuardDogImpl(Stats::Scope& stats_scope, const Server::Configuration::Watchdog& config,
+               Api::Api& api, absl::string_view name, StallProfiler& stall_profiler);
   ~GuardDogImpl() override;
 
   /**
@@ -104,6 +112,9 @@ private:
   // it is after kill and multikill timeout values are initialized.
   bool killEnabled() const { return kill_timeout_ > std::chrono::milliseconds(0); }
   bool multikillEnabled() const { return multi_kill_timeout_ > std::chrono::milliseconds(0); }
+  bool stallCaptureEnabled() const {
+    return stall_profiler_ != nullptr && stall_capture_timeout_ > std::chrono::milliseconds(0);
+  }
 
   using WatchDogAction = envoy::config::bootstrap::v3::Watchdog::WatchdogAction;
   // Helper function to invoke all the GuardDogActions registered for an Event.
@@ -118,10 +129,13 @@ private:
                const WatchDogImplSharedPtr& watch_dog);
 
     const WatchDogImplSharedPtr dog_;
+    const std::string thread_name_;
     MonotonicTime last_checkin_;
     absl::optional<MonotonicTime> last_alert_time_;
     bool miss_alerted_{};
     bool megamiss_alerted_{};
+    // Whether the stack was captured since the last check-in.
+    bool stall_captured_{};
     Stats::Counter& miss_counter_;
     Stats::Counter& megamiss_counter_;
   };
@@ -135,6 +149,8 @@ private:
   const std::chrono::milliseconds kill_timeout_;
   const std::chrono::milliseconds multi_kill_timeout_;
   const double multi_kill_fraction_;
+  StallProfiler* const stall_profiler_;
+  const std::chrono::milliseconds stall_capture_timeout_;
   const std::chrono::milliseconds loop_interval_;
   Stats::Counter& watchdog_miss_counter_;
   Stats::Counter& watchdog_megamiss_counter_;
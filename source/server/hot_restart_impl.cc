@@ -59,8 +59,8 @@ SharedMemory* attachSharedMemory(uint32_t base_id, uint32_t restart_epoch) {
   if (restart_epoch == 0) {
     shmem->size_ = sizeof(SharedMemory);
     shmem->version_ = HOT_RESTART_VERSION;
-    initializeMutex(shmem->log_lock_);
-    initializeMutex(shmem->access_log_lock_);
+    Thread::ProcessSharedMutex::initialize(shmem->log_lock_);
+    Thread::ProcessSharedMutex::initialize(shmem->access_log_lock_);
   } else {
     RELEASE_ASSERT(shmem->size_ == sizeof(SharedMemory),
                    "Hot restart SharedMemory size mismatch! You must have hot restarted into a "
@@ -82,14 +82,6 @@ SharedMemory* attachSharedMemory(uint32_t base_id, uint32_t restart_epoch) {
   return shmem;
 }
 
-void initializeMutex(pthread_mutex_t& mutex) {
-  pthread_mutexattr_t attribute;
-  pthread_mutexattr_init(&attribute);
-  pthread_mutexattr_setpshared(&attribute, PTHREAD_PROCESS_SHARED);
-  pthread_mutexattr_setrobust(&attribute, PTHREAD_MUTEX_ROBUST);
-  pthread_mutex_init(&mutex, &attribute);
-}
-
 // The base id is automatically scaled by 10 to prevent overlap of domain socket names when
 // multiple Envoys with different base-ids run on a single host. Note that older versions of Envoy
 // performed the multiplication in OptionsImpl which produced incorrect server info output.
@@ -141,6 +133,20 @@ HotRestartImpl::mergeParentStatsIfAny(Stats::StoreRoot& stats_store) {
   return response;
 }
 
+std::vector<envoy::service::discovery::v3::DiscoveryResponse>
+HotRestartImpl::getParentXdsResources() {
+  std::vector<envoy::service::discovery::v3::DiscoveryResponse> responses;
+  std::unique_ptr<envoy::HotRestartMessage> wrapper_msg = as_child_.getParentXdsResources();
+  if (wrapper_msg) {
+    auto* reply = wrapper_msg->mutable_reply()->mutable_xds_resources()->mutable_responses();
+    responses.reserve(reply->size());
+    for (auto& response : *reply) {
+      responses.push_back(std::move(response));
+    }
+  }
+  return responses;
+}
+
 void HotRestartImpl::shutdown() { as_parent_.shutdown(); }
 
 uint32_t HotRestartImpl::baseId() { return base_id_; }
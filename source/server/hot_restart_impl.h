@@ -12,6 +12,7 @@
 #include "envoy/server/hot_restart.h"
 
 #include "common/common/assert.h"
+#include "common/common/process_shared_mutex.h"
 #include "common/stats/allocator_impl.h"
 
 #include "server/hot_restarting_child.h"
@@ -46,52 +47,6 @@ static const uint64_t SHMEM_FLAGS_INITIALIZING = 0x1;
  */
 SharedMemory* attachSharedMemory(uint32_t base_id, uint32_t restart_epoch);
 
-/**
- * Initialize a pthread mutex for process shared locking.
- */
-void initializeMutex(pthread_mutex_t& mutex);
-
-/**
- * Implementation of Thread::BasicLockable that operates on a process shared pthread mutex.
- */
-class ProcessSharedMutex : public Thread::BasicLockable {
-public:
-  ProcessSharedMutex(pthread_mutex_t& mutex) : mutex_(mutex) {}
-
-  void lock() ABSL_EXCLUSIVE_LOCK_FUNCTION() override {
-    // Deal with robust handling here. If the other process dies without unlocking, we are going
-    // to die shortly but try to make sure that we can handle any signals, etc. that happen without
-    // getting into a further messed up state.
-    int rc = pthread_mutex_lock(&mutex_);
-    ASSERT(rc == 0 || rc == EOWNERDEAD);
-    if (rc == EOWNERDEAD) {
-      pthread_mutex_consistent(&mutex_);
-    }
-  }
-
-  bool tryLock() ABSL_EXCLUSIVE_TRYLOCK_FUNCTION(true) override {
-    int rc = pthread_mutex_trylock(&mutex_);
-    if (rc == EBUSY) {
-      return false;
-    }
-
-    ASSERT(rc == 0 || rc == EOWNERDEAD);
-    if (rc == EOWNERDEAD) {
-      pthread_mutex_consistent(&mutex_);
-    }
-
-    return true;
-  }
-
-  void unlock() ABSL_UNLOCK_FUNCTION() override {
-    int rc = pthread_mutex_unlock(&mutex_);
-    ASSERT(rc == 0);
-  }
-
-private:
-  pthread_mutex_t& mutex_;
-};
-
 /**
  * Implementation of HotRestart built for Linux. Most of the "protocol" type logic is split out into
  * HotRestarting{Base,Parent,Child}. This class ties all that to shared memory and version logic.
@@ -108,6 +63,7 @@ public:
   void sendParentAdminShutdownRequest(time_t& original_start_time) override;
   void sendParentTerminateRequest() override;
   ServerStatsFromParent mergeParentStatsIfAny(Stats::StoreRoot& stats_store) override;
+  std::vector<envoy::service::discovery::v3::DiscoveryResponse> getParentXdsResources() override;
   void shutdown() override;
   uint32_t baseId() override;
   std::string version() override;
@@ -128,8 +84,8 @@ private:
   // This pointer is shared memory, and is expected to exist until process end.
   // It will automatically be unmapped when the process terminates.
   SharedMemory* shmem_;
-  ProcessSharedMutex log_lock_;
-  ProcessSharedMutex access_log_lock_;
+  Thread::ProcessSharedMutex log_lock_;
+  Thread::ProcessSharedMutex access_log_lock_;
 };
 
 } // namespace Server
@@ -22,6 +22,9 @@ public:
   void sendParentAdminShutdownRequest(time_t&) override {}
   void sendParentTerminateRequest() override {}
   ServerStatsFromParent mergeParentStatsIfAny(Stats::StoreRoot&) override { return {}; }
+  std::vector<envoy::service::discovery::v3::DiscoveryResponse> getParentXdsResources() override {
+    return {};
+  }
   void shutdown() override {}
   uint32_t baseId() override { return 0; }
   std::string version() override { return "disabled"; }
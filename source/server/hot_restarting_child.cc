@@ -49,6 +49,25 @@ std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentStats() {
   return wrapped_reply;
 }
 
+std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentXdsResources() {
+  if (restart_epoch_ == 0 || parent_terminated_) {
+    return nullptr;
+  }
+
+  HotRestartMessage wrapped_request;
+  wrapped_request.mutable_request()->mutable_xds_resources();
+  sendHotRestartMessage(parent_address_, wrapped_request);
+
+  std::unique_ptr<HotRestartMessage> wrapped_reply = receiveHotRestartMessage(Blocking::Yes);
+  // A parent which does not know the request says so, and the resources are fetched from the
+  // management server instead.
+  if (!replyIsExpectedType(wrapped_reply.get(), HotRestartMessage::Reply::kXdsResources)) {
+    ENVOY_LOG(warn, "Hot restart parent did not hand over its xDS resources.");
+    return nullptr;
+  }
+  return wrapped_reply;
+}
+
 void HotRestartingChild::drainParentListeners() {
   if (restart_epoch_ == 0 || parent_terminated_) {
     return;
@@ -17,6 +17,7 @@ public:
 
   int duplicateParentListenSocket(const std::string& address);
   std::unique_ptr<envoy::HotRestartMessage> getParentStats();
+  std::unique_ptr<envoy::HotRestartMessage> getParentXdsResources();
   void drainParentListeners();
   void sendParentAdminShutdownRequest(time_t& original_start_time);
   void sendParentTerminateRequest();
@@ -1,6 +1,7 @@
 #include "server/hot_restarting_parent.h"
 
 #include "envoy/server/instance.h"
+#include "envoy/upstream/cluster_manager.h"
 
 #include "common/memory/stats.h"
 #include "common/network/utility.h"
@@ -62,6 +63,13 @@ void HotRestartingParent::onSocketEvent() {
       break;
     }
 
+    case HotRestartMessage::Request::kXdsResources: {
+      HotRestartMessage wrapped_reply;
+      internal_->exportXdsResourcesToChild(wrapped_reply.mutable_reply()->mutable_xds_resources());
+      sendHotRestartMessage(child_address_, wrapped_reply);
+      break;
+    }
+
     case HotRestartMessage::Request::kDrainListeners: {
       internal_->drainListeners();
       break;
@@ -125,7 +133,11 @@ HotRestartingParent::Internal::getListenSocketsForChild(const HotRestartMessage:
 // names. The problem can be solved by splitting the export up over many chunks.
 void HotRestartingParent::Internal::exportStatsToChild(HotRestartMessage::Reply::Stats* stats) {
   for (const auto& gauge : server_->stats().gauges()) {
-    if (gauge->used()) {
+    // The changed flags of the gauges are latched on every export, and only the first export
+    // includes the gauges that did not change. Like counter latching, this relies on the parent
+    // having stopped flushing stats to its sinks.
+    const bool changed = gauge->latchChanged();
+    if (gauge->used() && (changed || !exported_all_gauges_)) {
       const std::string name = gauge->name();
       (*stats->mutable_gauges())[name] = gauge->value();
       recordDynamics(stats, name, gauge->statName());
@@ -144,6 +156,7 @@ void HotRestartingParent::Internal::exportStatsToChild(HotRestartMessage::Reply:
       }
     }
   }
+  exported_all_gauges_ = true;
   stats->set_memory_allocated(Memory::Stats::totalCurrentlyAllocated());
   stats->set_num_connections(server_->listenerManager().numConnections());
 }
@@ -174,5 +187,12 @@ void HotRestartingParent::Internal::recordDynamics(HotRestartMessage::Reply::Sta
 
 void HotRestartingParent::Internal::drainListeners() { server_->drainListeners(); }
 
+void HotRestartingParent::Internal::exportXdsResourcesToChild(
+    HotRestartMessage::Reply::XdsResources* xds_resources) {
+  for (auto& response : server_->clusterManager().adsMux()->handoffResponses()) {
+    *xds_resources->add_responses() = std::move(response);
+  }
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -34,9 +34,15 @@ public:
     void recordDynamics(envoy::HotRestartMessage::Reply::Stats* stats, const std::string& name,
                         Stats::StatName stat_name);
     void drainListeners();
+    // 'xds_resources' is a field in the reply protobuf to be sent to the child, which we should
+    // populate.
+    void exportXdsResourcesToChild(envoy::HotRestartMessage::Reply::XdsResources* xds_resources);
 
   private:
     Server::Instance* const server_{};
+    // Whether all the gauges were exported once. Subsequent exports only include the gauges that
+    // changed since, as the child keeps the last value it merged for the others.
+    bool exported_all_gauges_{};
   };
 
 private:
@@ -73,6 +73,12 @@ bool usesProxyProto(const envoy::config::listener::v3::Listener& config) {
       config.filter_chains().empty() ? config.default_filter_chain() : config.filter_chains()[0],
       use_proxy_proto, false);
 }
+
+// The registrations of a connection with the drain managers of the listener and of the server.
+struct DrainCloseHandles : public Network::DrainCloseHandle {
+  Network::DrainCloseHandlePtr listener_;
+  Network::DrainCloseHandlePtr server_;
+};
 } // namespace
 
 ListenSocketFactoryImpl::ListenSocketFactoryImpl(ListenerComponentFactory& factory,
@@ -236,6 +242,17 @@ ListenerFactoryContextBaseImpl::getTransportSocketFactoryContext() const {
 }
 Stats::Scope& ListenerFactoryContextBaseImpl::listenerScope() { return *listener_scope_; }
 Network::DrainDecision& ListenerFactoryContextBaseImpl::drainDecision() { return *this; }
+Network::DrainCloseHandlePtr
+ListenerFactoryContextBaseImpl::addOnDrainCloseCb(Event::Dispatcher& dispatcher,
+                                                  Network::DrainCloseCb cb) const {
+  auto handles = std::make_unique<DrainCloseHandles>();
+  handles->listener_ = drain_manager_->addOnDrainCloseCb(dispatcher, cb);
+  handles->server_ = server_.drainManager().addOnDrainCloseCb(dispatcher, std::move(cb));
+  if (handles->listener_ == nullptr && handles->server_ == nullptr) {
+    return nullptr;
+  }
+  return handles;
+}
 Server::DrainManager& ListenerFactoryContextBaseImpl::drainManager() { return *drain_manager_; }
 
 // Must be overridden
@@ -406,8 +423,10 @@ void ListenerImpl::buildUdpListenerFactory(Network::Socket::Type socket_type,
 void ListenerImpl::buildUdpWriterFactory(Network::Socket::Type socket_type) {
   if (socket_type == Network::Socket::Type::Datagram) {
     auto udp_writer_config = config_.udp_writer_config();
-    if (!Api::OsSysCallsSingleton::get().supportsUdpGso() ||
-        udp_writer_config.typed_config().type_url().empty()) {
+    if (udp_writer_config.typed_config().type_url().empty() ||
+        (!Api::OsSysCallsSingleton::get().supportsUdpGso() &&
+         udp_writer_config.typed_config().type_url() ==
+             "type.googleapis.com/envoy.config.listener.v3.UdpGsoBatchWriterOptions")) {
       const std::string default_type_url =
           "type.googleapis.com/envoy.config.listener.v3.UdpDefaultWriterOptions";
       udp_writer_config.mutable_typed_config()->set_type_url(default_type_url);
@@ -435,6 +454,14 @@ void ListenerImpl::buildListenSocketOptions(Network::Socket::Type socket_type) {
   }
   if (config_.reuse_port()) {
     addListenSocketOptions(Network::SocketOptionFactory::buildReusePortOptions());
+    if (config_.reuse_port_cpu_steering() && socket_type == Network::Socket::Type::Stream) {
+      addListenSocketOptions(Network::SocketOptionFactory::buildReusePortCpuSteeringOptions());
+    }
+  }
+  if (config_.has_busy_poll()) {
+    addListenSocketOptions(Network::SocketOptionFactory::buildBusyPollOptions(
+        Protobuf::util::TimeUtil::DurationToMicroseconds(config_.busy_poll().busy_poll()),
+        config_.busy_poll().prefer_busy_poll()));
   }
   if (!config_.socket_options().empty()) {
     addListenSocketOptions(
@@ -505,6 +532,25 @@ void ListenerImpl::buildFilterChains() {
       validation_visitor_, parent_.server_.api());
   transport_factory_context.setInitManager(*dynamic_init_manager_);
   ListenerFilterChainFactoryBuilder builder(*this, transport_factory_context);
+  if (udp_listener_factory_ == nullptr) {
+    // The filter chains built on demand are shared with the listeners updated in place, hence only
+    // capture what outlives this listener.
+    filter_chain_manager_.setOnDemandFilterChainBuilder(
+        [&server = parent_.server_, &factory = parent_.factory_,
+         context = listener_factory_context_->listener_factory_context_base_](
+            const envoy::config::listener::v3::FilterChain& filter_chain,
+            FilterChainFactoryContextCreator& context_creator, Init::Manager& init_manager) {
+          Server::Configuration::TransportSocketFactoryContextImpl transport_factory_context(
+              server.admin(), server.sslContextManager(), context->listenerScope(),
+              server.clusterManager(), server.localInfo(), server.dispatcher(), server.stats(),
+              server.singletonManager(), server.threadLocal(),
+              context->messageValidationVisitor(), server.api());
+          transport_factory_context.setInitManager(init_manager);
+          ListenerFilterChainFactoryBuilder builder(context->messageValidationVisitor(), factory,
+                                                    transport_factory_context);
+          return builder.buildFilterChain(filter_chain, context_creator);
+        });
+  }
   filter_chain_manager_.addFilterChains(
       config_.filter_chains(),
       config_.has_default_filter_chain() ? &config_.default_filter_chain() : nullptr, builder,
@@ -516,9 +562,14 @@ void ListenerImpl::buildSocketOptions() {
   if (connection_balancer_ == nullptr) {
     // Not in place listener update.
     if (config_.has_connection_balance_config()) {
-      // Currently exact balance is the only supported type and there are no options.
-      ASSERT(config_.connection_balance_config().has_exact_balance());
-      connection_balancer_ = std::make_shared<Network::ExactConnectionBalancerImpl>();
+      // None of the balance types has options.
+      if (config_.connection_balance_config().has_two_choice_balance()) {
+        connection_balancer_ = std::make_shared<Network::TwoChoiceConnectionBalancerImpl>(
+            parent_.server_.api().randomGenerator());
+      } else {
+        ASSERT(config_.connection_balance_config().has_exact_balance());
+        connection_balancer_ = std::make_shared<Network::ExactConnectionBalancerImpl>();
+      }
     } else {
       connection_balancer_ = std::make_shared<Network::NopConnectionBalancerImpl>();
     }
@@ -129,6 +129,8 @@ public:
   bool drainClose() const override {
     return drain_manager_->drainClose() || server_.drainManager().drainClose();
   }
+  Network::DrainCloseHandlePtr addOnDrainCloseCb(Event::Dispatcher& dispatcher,
+                                                 Network::DrainCloseCb cb) const override;
   Server::DrainManager& drainManager();
 
 private:
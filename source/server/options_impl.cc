@@ -113,6 +113,10 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
       "Logger mode: enable file level log control(Fancy Logger)or not", cmd, false);
   TCLAP::ValueArg<std::string> log_path("", "log-path", "Path to logfile", false, "", "string",
                                         cmd);
+  TCLAP::ValueArg<uint32_t> log_async_buffer_size(
+      "", "log-async-buffer-size",
+      "Size in bytes of the buffer of each thread for asynchronous logging, 0 to log synchronously",
+      false, 0, "uint32_t", cmd);
   TCLAP::ValueArg<uint32_t> restart_epoch("", "restart-epoch", "hot restart epoch #", false, 0,
                                           "uint32_t", cmd);
   TCLAP::SwitchArg hot_restart_version_option("", "hot-restart-version",
@@ -131,8 +135,8 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
                                          600, "uint32_t", cmd);
   TCLAP::ValueArg<std::string> drain_strategy(
       "", "drain-strategy",
-      "Hot restart drain sequence behaviour, one of 'gradual' (default) or 'immediate'.", false,
-      "gradual", "string", cmd);
+      "Hot restart drain sequence behaviour, one of 'gradual' (default), 'immediate' or 'paced'.",
+      false, "gradual", "string", cmd);
   TCLAP::ValueArg<uint32_t> parent_shutdown_time_s("", "parent-shutdown-time-s",
                                                    "Hot restart parent shutdown time in seconds",
                                                    false, 900, "uint32_t", cmd);
@@ -251,6 +255,7 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   ignore_unknown_dynamic_fields_ = ignore_unknown_dynamic_fields.getValue();
   admin_address_path_ = admin_address_path.getValue();
   log_path_ = log_path.getValue();
+  log_async_buffer_size_ = log_async_buffer_size.getValue();
   service_cluster_ = service_cluster.getValue();
   service_node_ = service_node.getValue();
   service_zone_ = service_zone.getValue();
@@ -274,6 +279,8 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
     drain_strategy_ = Server::DrainStrategy::Immediate;
   } else if (drain_strategy.getValue() == "gradual") {
     drain_strategy_ = Server::DrainStrategy::Gradual;
+  } else if (drain_strategy.getValue() == "paced") {
+    drain_strategy_ = Server::DrainStrategy::Paced;
   } else {
     throw MalformedArgvException(
         fmt::format("error: unknown drain-strategy '{}'", mode.getValue()));
@@ -366,6 +373,7 @@ Server::CommandLineOptionsPtr OptionsImpl::toCommandLineOptions() const {
   command_line_options->set_log_format_escaped(logFormatEscaped());
   command_line_options->set_enable_fine_grain_logging(enableFineGrainLogging());
   command_line_options->set_log_path(logPath());
+  command_line_options->set_log_async_buffer_size(logAsyncBufferSize());
   command_line_options->set_service_cluster(serviceClusterName());
   command_line_options->set_service_node(serviceNodeName());
   command_line_options->set_service_zone(serviceZone());
@@ -386,9 +394,17 @@ Server::CommandLineOptionsPtr OptionsImpl::toCommandLineOptions() const {
 
   command_line_options->mutable_drain_time()->MergeFrom(
       Protobuf::util::TimeUtil::SecondsToDuration(drainTime().count()));
-  command_line_options->set_drain_strategy(drainStrategy() == Server::DrainStrategy::Immediate
-                                               ? envoy::admin::v3::CommandLineOptions::Immediate
-                                               : envoy::admin::v3::CommandLineOptions::Gradual);
+  switch (drainStrategy()) {
+  case Server::DrainStrategy::Gradual:
+    command_line_options->set_drain_strategy(envoy::admin::v3::CommandLineOptions::Gradual);
+    break;
+  case Server::DrainStrategy::Immediate:
+    command_line_options->set_drain_strategy(envoy::admin::v3::CommandLineOptions::Immediate);
+    break;
+  case Server::DrainStrategy::Paced:
+    command_line_options->set_drain_strategy(envoy::admin::v3::CommandLineOptions::Paced);
+    break;
+  }
   command_line_options->mutable_parent_shutdown_time()->MergeFrom(
       Protobuf::util::TimeUtil::SecondsToDuration(parentShutdownTime().count()));
 
@@ -9,13 +9,17 @@ namespace Configuration {
 class ResourceMonitorFactoryContextImpl : public ResourceMonitorFactoryContext {
 public:
   ResourceMonitorFactoryContextImpl(Event::Dispatcher& dispatcher, Api::Api& api,
+                                    ThreadLocal::SlotAllocator& slot_allocator,
                                     ProtobufMessage::ValidationVisitor& validation_visitor)
-      : dispatcher_(dispatcher), api_(api), validation_visitor_(validation_visitor) {}
+      : dispatcher_(dispatcher), api_(api), slot_allocator_(slot_allocator),
+        validation_visitor_(validation_visitor) {}
 
   Event::Dispatcher& dispatcher() override { return dispatcher_; }
 
   Api::Api& api() override { return api_; }
 
+  ThreadLocal::SlotAllocator& threadLocal() override { return slot_allocator_; }
+
   ProtobufMessage::ValidationVisitor& messageValidationVisitor() override {
     return validation_visitor_;
   }
@@ -23,6 +27,7 @@ public:
 private:
   Event::Dispatcher& dispatcher_;
   Api::Api& api_;
+  ThreadLocal::SlotAllocator& slot_allocator_;
   ProtobufMessage::ValidationVisitor& validation_visitor_;
 };
 
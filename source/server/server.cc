@@ -1,11 +1,15 @@
 #include "server/server.h"
 
+#include <algorithm>
+#include <atomic>
 #include <csignal>
 #include <cstdint>
 #include <ctime>
 #include <functional>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "envoy/admin/v3/config_dump.pb.h"
 #include "envoy/common/exception.h"
@@ -14,6 +18,8 @@
 #include "envoy/config/bootstrap/v2/bootstrap.pb.validate.h"
 #include "envoy/config/bootstrap/v3/bootstrap.pb.h"
 #include "envoy/config/bootstrap/v3/bootstrap.pb.validate.h"
+#include "envoy/config/cluster/v3/cluster.pb.validate.h"
+#include "envoy/config/listener/v3/listener.pb.validate.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/signal.h"
 #include "envoy/event/timer.h"
@@ -33,9 +39,12 @@
 #include "common/config/version_converter.h"
 #include "common/config/xds_resource.h"
 #include "common/http/codes.h"
+#include "common/http/headers.h"
 #include "common/local_info/local_info_impl.h"
+#include "common/memory/accounting.h"
 #include "common/memory/stats.h"
 #include "common/network/address_impl.h"
+#include "common/network/caching_dns_resolver.h"
 #include "common/network/socket_interface.h"
 #include "common/network/socket_interface_impl.h"
 #include "common/network/tcp_listener_impl.h"
@@ -98,6 +107,10 @@ InstanceImpl::InstanceImpl(
             fmt::format("Failed to open log-file '{}'. e.what(): {}", options.logPath(), e.what()));
       }
     }
+    if (options.logAsyncBufferSize() > 0) {
+      async_logger_ = std::make_unique<Logger::AsyncSinkDelegate>(
+          api_->threadFactory(), options.logAsyncBufferSize(), Logger::Registry::getSink());
+    }
 
     restarter_.initialize(*dispatcher_, *this);
     drain_manager_ = component_factory.createDrainManager(*this);
@@ -122,7 +135,9 @@ InstanceImpl::~InstanceImpl() {
   terminate();
 
   // Stop logging to file before all the AccessLogManager and its dependencies are
-  // destructed to avoid crashing at shutdown.
+  // destructed to avoid crashing at shutdown. The async logger writes to the file logger, so that
+  // it is stopped first.
+  async_logger_.reset();
   file_logger_.reset();
 
   // Destruct the ListenerManager explicitly, before InstanceImpl's local init_manager_ is
@@ -152,30 +167,62 @@ void InstanceImpl::failHealthcheck(bool fail) {
   server_stats_->live_.set(live_.load());
 }
 
-MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store, TimeSource& time_source) {
-  snapped_counters_ = store.counters();
-  counters_.reserve(snapped_counters_.size());
-  for (const auto& counter : snapped_counters_) {
-    counters_.push_back({counter->latch(), *counter});
+MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store, TimeSource& time_source,
+                                       bool changed_only) {
+  // In changed_only mode, the metrics are moved out of the vectors of the store, so that the
+  // snapshot only keeps the changed ones alive. Counters are latched whether they changed or not.
+  std::vector<Stats::CounterSharedPtr> counters = store.counters();
+  if (!changed_only) {
+    snapped_counters_.reserve(counters.size());
+    counters_.reserve(counters.size());
+  }
+  for (auto& counter : counters) {
+    const uint64_t delta = counter->latch();
+    if (changed_only && delta == 0) {
+      continue;
+    }
+    counters_.push_back({delta, *counter});
+    snapped_counters_.push_back(std::move(counter));
   }
 
-  snapped_gauges_ = store.gauges();
-  gauges_.reserve(snapped_gauges_.size());
-  for (const auto& gauge : snapped_gauges_) {
+  std::vector<Stats::GaugeSharedPtr> gauges = store.gauges();
+  if (!changed_only) {
+    snapped_gauges_.reserve(gauges.size());
+    gauges_.reserve(gauges.size());
+  }
+  for (auto& gauge : gauges) {
     ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
+    if (changed_only && !gauge->latchChanged()) {
+      continue;
+    }
     gauges_.push_back(*gauge);
+    snapped_gauges_.push_back(std::move(gauge));
   }
 
-  snapped_histograms_ = store.histograms();
-  histograms_.reserve(snapped_histograms_.size());
-  for (const auto& histogram : snapped_histograms_) {
+  std::vector<Stats::ParentHistogramSharedPtr> histograms = store.histograms();
+  if (!changed_only) {
+    snapped_histograms_.reserve(histograms.size());
+    histograms_.reserve(histograms.size());
+  }
+  for (auto& histogram : histograms) {
+    if (changed_only && histogram->intervalStatistics().sampleCount() == 0) {
+      continue;
+    }
     histograms_.push_back(*histogram);
+    snapped_histograms_.push_back(std::move(histogram));
   }
 
-  snapped_text_readouts_ = store.textReadouts();
-  text_readouts_.reserve(snapped_text_readouts_.size());
-  for (const auto& text_readout : snapped_text_readouts_) {
+  std::vector<Stats::TextReadoutSharedPtr> text_readouts = store.textReadouts();
+  if (!changed_only) {
+    snapped_text_readouts_.reserve(text_readouts.size());
+    text_readouts_.reserve(text_readouts.size());
+  }
+  for (auto& text_readout : text_readouts) {
+    if (changed_only && !text_readout->latchChanged()) {
+      continue;
+    }
     text_readouts_.push_back(*text_readout);
+    snapped_text_readouts_.push_back(std::move(text_readout));
   }
 
   snapshot_time_ = time_source.systemTime();
@@ -187,7 +234,13 @@ void InstanceUtil::flushMetricsToSinks(const std::list<Stats::SinkPtr>& sinks, S
   // NOTE: Even if there are no sinks, creating the snapshot has the important property that it
   //       latches all counters on a periodic basis. The hot restart code assumes this is being
   //       done so this should not be removed.
-  MetricSnapshotImpl snapshot(store, time_source);
+  // The snapshot only holds the changed metrics when no sink needs the others. The sinks do not
+  // change at run time, so the changed state of the gauges and text readouts is either latched on
+  // every flush or never.
+  const bool changed_only =
+      std::all_of(sinks.begin(), sinks.end(),
+                  [](const Stats::SinkPtr& sink) { return sink->flushChangedMetricsOnly(); });
+  MetricSnapshotImpl snapshot(store, time_source, changed_only);
   for (const auto& sink : sinks) {
     sink->flush(snapshot);
   }
@@ -218,6 +271,16 @@ void InstanceImpl::updateServerStats() {
                                        parent_stats.parent_memory_allocated_);
   server_stats_->memory_heap_size_.set(Memory::Stats::totalCurrentlyReserved());
   server_stats_->memory_physical_size_.set(Memory::Stats::totalPhysicalBytes());
+  server_stats_->memory_accounted_buffer_slices_.set(
+      Memory::Accounting::usage(Memory::Accounting::Account::BufferSlices).bytes_);
+  server_stats_->memory_accounted_clusters_.set(
+      Memory::Accounting::usage(Memory::Accounting::Account::Clusters).bytes_);
+  server_stats_->memory_accounted_header_maps_.set(
+      Memory::Accounting::usage(Memory::Accounting::Account::HeaderMaps).bytes_);
+  server_stats_->memory_accounted_symbol_table_.set(
+      Memory::Accounting::usage(Memory::Accounting::Account::SymbolTable).bytes_);
+  server_stats_->memory_accounted_tls_contexts_.set(
+      Memory::Accounting::usage(Memory::Accounting::Account::TlsContexts).bytes_);
   server_stats_->parent_connections_.set(parent_stats.parent_connections_);
   server_stats_->total_connections_.set(listener_manager_->numConnections() +
                                         parent_stats.parent_connections_);
@@ -234,6 +297,16 @@ void InstanceImpl::updateServerStats() {
       enumToInt(Utility::serverState(initManager().state(), healthCheckFailed())));
   server_stats_->stats_recent_lookups_.set(
       stats_store_.symbolTable().getRecentLookups([](absl::string_view, uint64_t) {}));
+
+  const Buffer::SliceAllocatorStats slice_allocator_stats = Buffer::SliceAllocator::stats();
+  server_stats_->buffer_slice_pool_hit_.add(slice_allocator_stats.hits_ -
+                                            last_slice_allocator_stats_.hits_);
+  server_stats_->buffer_slice_pool_miss_.add(slice_allocator_stats.misses_ -
+                                             last_slice_allocator_stats_.misses_);
+  server_stats_->buffer_slice_pool_remote_free_.add(slice_allocator_stats.remote_frees_ -
+                                                    last_slice_allocator_stats_.remote_frees_);
+  server_stats_->buffer_slice_pool_retained_bytes_.set(slice_allocator_stats.retained_bytes_);
+  last_slice_allocator_stats_ = slice_allocator_stats;
 }
 
 void InstanceImpl::flushStatsInternal() {
@@ -275,6 +348,73 @@ void loadBootstrap(absl::optional<uint32_t> bootstrap_version,
     throw EnvoyException(fmt::format("Unknown bootstrap version {}.", *bootstrap_version));
   }
 }
+
+// The minimum number of static clusters and listeners that each validation thread validates, as
+// smaller bootstraps are validated faster than threads start.
+constexpr int MinResourcesPerValidationThread = 256;
+
+// Validates the constraints of the static clusters and listeners, which make up most of large
+// bootstraps, on up to max_threads threads. Returns whether they are all valid.
+bool validateStaticResources(
+    const envoy::config::bootstrap::v3::Bootstrap::StaticResources& config,
+    Thread::ThreadFactory& thread_factory, uint32_t max_threads) {
+  const int num_clusters = config.clusters_size();
+  const int num_resources = num_clusters + config.listeners_size();
+  std::atomic<int> next{0};
+  std::atomic<bool> valid{true};
+  auto validate = [&config, num_clusters, num_resources, &next, &valid]() {
+    std::string err;
+    for (int i = next++; i < num_resources && valid.load(std::memory_order_relaxed); i = next++) {
+      if (!(i < num_clusters ? Validate(config.clusters(i), &err)
+                             : Validate(config.listeners(i - num_clusters), &err))) {
+        valid = false;
+      }
+    }
+  };
+
+  const uint32_t num_threads = std::min<uint32_t>(
+      max_threads, std::max(1, num_resources / MinResourcesPerValidationThread));
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 1; i < num_threads; ++i) {
+    threads.push_back(thread_factory.createThread(validate, Thread::Options{"validate"}));
+  }
+  validate();
+  for (const Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  return valid;
+}
+
+// Validates the bootstrap like MessageUtil::validate(), with the static clusters and listeners
+// validated in parallel.
+void validateBootstrap(envoy::config::bootstrap::v3::Bootstrap& bootstrap,
+                       ProtobufMessage::ValidationVisitor& validation_visitor,
+                       Thread::ThreadFactory& thread_factory, uint32_t max_threads) {
+  if (!validation_visitor.skipValidation()) {
+    MessageUtil::checkForUnexpectedFields(bootstrap, validation_visitor);
+  }
+
+  std::string err;
+  auto* static_resources = bootstrap.mutable_static_resources();
+  if (validateStaticResources(*static_resources, thread_factory, max_threads)) {
+    // Validate the rest of the bootstrap without validating the static resources again.
+    Protobuf::RepeatedPtrField<envoy::config::cluster::v3::Cluster> clusters;
+    Protobuf::RepeatedPtrField<envoy::config::listener::v3::Listener> listeners;
+    clusters.Swap(static_resources->mutable_clusters());
+    listeners.Swap(static_resources->mutable_listeners());
+    const bool valid = Validate(bootstrap, &err);
+    clusters.Swap(static_resources->mutable_clusters());
+    listeners.Swap(static_resources->mutable_listeners());
+    if (valid) {
+      return;
+    }
+  }
+  // Validate the whole bootstrap again, so that the error is the same as without the parallel
+  // validation.
+  if (!Validate(bootstrap, &err)) {
+    ProtoExceptionUtil::throwProtoValidationException(err, API_RECOVER_ORIGINAL(bootstrap));
+  }
+}
 } // namespace
 
 void InstanceUtil::loadBootstrapConfig(envoy::config::bootstrap::v3::Bootstrap& bootstrap,
@@ -311,7 +451,8 @@ void InstanceUtil::loadBootstrapConfig(envoy::config::bootstrap::v3::Bootstrap&
   if (config_proto.ByteSize() != 0) {
     bootstrap.MergeFrom(config_proto);
   }
-  MessageUtil::validate(bootstrap, validation_visitor);
+  validateBootstrap(bootstrap, validation_visitor, api.threadFactory(),
+                    std::max(1U, options.concurrency()));
 }
 
 void InstanceImpl::initialize(const Options& options,
@@ -349,6 +490,7 @@ void InstanceImpl::initialize(const Options& options,
   stats_store_.setTagProducer(Config::Utility::createTagProducer(bootstrap_));
   stats_store_.setStatsMatcher(Config::Utility::createStatsMatcher(bootstrap_));
   stats_store_.setHistogramSettings(Config::Utility::createHistogramSettings(bootstrap_));
+  stats_store_.setCounterSharding(bootstrap_.stats_config().shard_counters());
 
   const std::string server_stats_prefix = "server.";
   server_stats_ = std::make_unique<ServerStats>(
@@ -462,6 +604,11 @@ void InstanceImpl::initialize(const Options& options,
   }
 
   // Workers get created first so they register for thread local updates.
+  worker_factory_.setPinWorkerThreads(bootstrap_.pin_worker_threads());
+  if (bootstrap_.has_worker_spin_budget()) {
+    worker_factory_.setWorkerSpinBudget(std::chrono::microseconds(
+        Protobuf::util::TimeUtil::DurationToMicroseconds(bootstrap_.worker_spin_budget())));
+  }
   listener_manager_ = std::make_unique<ListenerManagerImpl>(
       *this, listener_component_factory_, worker_factory_, bootstrap_.enable_dispatcher_stats());
 
@@ -521,6 +668,11 @@ void InstanceImpl::initialize(const Options& options,
 
   const bool use_tcp_for_dns_lookups = bootstrap_.use_tcp_for_dns_lookups();
   dns_resolver_ = dispatcher_->createDnsResolver({}, use_tcp_for_dns_lookups);
+  if (bootstrap_.has_dns_resolution_cache()) {
+    dns_resolver_ =
+        Network::CachingDnsResolver::create(*singleton_manager_, dns_resolver_, time_source_,
+                                            stats_store_, bootstrap_.dns_resolution_cache());
+  }
 
   cluster_manager_factory_ = std::make_unique<Upstream::ProdClusterManagerFactory>(
       *admin_, Runtime::LoaderSingleton::get(), stats_store_, thread_local_, dns_resolver_,
@@ -534,6 +686,18 @@ void InstanceImpl::initialize(const Options& options,
   // cluster_manager_factory_ is available.
   config_.initialize(bootstrap_, *this, *cluster_manager_factory_);
 
+  // The xDS resources of the parent are applied as soon as their types are subscribed to, so that
+  // the clusters and listeners warm without waiting for the management server.
+  if (bootstrap_.dynamic_resources().ads_hot_restart_handoff()) {
+    std::vector<envoy::service::discovery::v3::DiscoveryResponse> responses =
+        restarter_.getParentXdsResources();
+    if (!responses.empty()) {
+      ENVOY_LOG(info, "applying the xDS resources of {} types handed over by the parent",
+                responses.size());
+      clusterManager().adsMux()->applyHandoffResponses(std::move(responses));
+    }
+  }
+
   // Instruct the listener manager to create the LDS provider if needed. This must be done later
   // because various items do not yet exist when the listener manager is created.
   if (bootstrap_.dynamic_resources().has_lds_config() ||
@@ -568,10 +732,22 @@ void InstanceImpl::initialize(const Options& options,
 
   // GuardDog (deadlock detection) object and thread setup before workers are
   // started and before our own run() loop runs.
+  stall_profiler_ = std::make_unique<StallProfiler>(time_source_);
+  admin_->addHandler(
+      "/stalls", "print the stacks of the recent stalls of the watched threads",
+      [this](absl::string_view, Http::ResponseHeaderMap& response_headers,
+             Buffer::Instance& response, AdminStream&) -> Http::Code {
+        response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Text);
+        std::ostringstream stalls;
+        stall_profiler_->dump(stalls);
+        response.add(stalls.str());
+        return Http::Code::OK;
+      },
+      false, false);
   main_thread_guard_dog_ = std::make_unique<Server::GuardDogImpl>(
-      stats_store_, config_.mainThreadWatchdogConfig(), *api_, "main_thread");
+      stats_store_, config_.mainThreadWatchdogConfig(), *api_, "main_thread", *stall_profiler_);
   worker_guard_dog_ = std::make_unique<Server::GuardDogImpl>(
-      stats_store_, config_.workerWatchdogConfig(), *api_, "workers");
+      stats_store_, config_.workerWatchdogConfig(), *api_, "workers", *stall_profiler_);
 }
 
 void InstanceImpl::onClusterManagerPrimaryInitializationComplete() {
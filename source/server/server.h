@@ -24,6 +24,7 @@
 #include "envoy/tracing/http_tracer.h"
 
 #include "common/access_log/access_log_manager_impl.h"
+#include "common/buffer/slice_allocator.h"
 #include "common/common/assert.h"
 #include "common/common/cleanup.h"
 #include "common/common/logger_delegates.h"
@@ -43,6 +44,7 @@
 #include "server/listener_hooks.h"
 #include "server/listener_manager_impl.h"
 #include "server/overload_manager_impl.h"
+#include "server/stall_profiler.h"
 #include "server/worker_impl.h"
 
 #include "absl/container/node_hash_map.h"
@@ -55,16 +57,25 @@ namespace Server {
  * All server wide stats. @see stats_macros.h
  */
 #define ALL_SERVER_STATS(COUNTER, GAUGE, HISTOGRAM)                                                \
+  COUNTER(buffer_slice_pool_hit)                                                                   \
+  COUNTER(buffer_slice_pool_miss)                                                                  \
+  COUNTER(buffer_slice_pool_remote_free)                                                           \
   COUNTER(debug_assertion_failures)                                                                \
   COUNTER(envoy_bug_failures)                                                                      \
   COUNTER(dynamic_unknown_fields)                                                                  \
   COUNTER(static_unknown_fields)                                                                   \
+  GAUGE(buffer_slice_pool_retained_bytes, NeverImport)                                             \
   GAUGE(concurrency, NeverImport)                                                                  \
   GAUGE(days_until_first_cert_expiring, Accumulate)                                                \
   GAUGE(seconds_until_first_ocsp_response_expiring, Accumulate)                                    \
   GAUGE(hot_restart_epoch, NeverImport)                                                            \
   /* hot_restart_generation is an Accumulate gauge; we omit it here for testing dynamics. */       \
   GAUGE(live, NeverImport)                                                                         \
+  GAUGE(memory_accounted_buffer_slices, NeverImport)                                               \
+  GAUGE(memory_accounted_clusters, NeverImport)                                                    \
+  GAUGE(memory_accounted_header_maps, NeverImport)                                                 \
+  GAUGE(memory_accounted_symbol_table, NeverImport)                                                \
+  GAUGE(memory_accounted_tls_contexts, NeverImport)                                                \
   GAUGE(memory_allocated, Accumulate)                                                              \
   GAUGE(memory_heap_size, Accumulate)                                                              \
   GAUGE(memory_physical_size, Accumulate)                                                          \
@@ -321,6 +332,8 @@ private:
   time_t original_start_time_;
   Stats::StoreRoot& stats_store_;
   std::unique_ptr<ServerStats> server_stats_;
+  // Slice pool counters as of the previous updateServerStats(), used to compute counter deltas.
+  Buffer::SliceAllocatorStats last_slice_allocator_stats_;
   Assert::ActionRegistrationPtr assert_action_registration_;
   Assert::ActionRegistrationPtr envoy_bug_action_registration_;
   ThreadLocal::Instance& thread_local_;
@@ -343,10 +356,13 @@ private:
   DrainManagerPtr drain_manager_;
   AccessLog::AccessLogManagerImpl access_log_manager_;
   std::unique_ptr<Upstream::ClusterManagerFactory> cluster_manager_factory_;
+  // Shared by the guard dogs, and outlives them.
+  std::unique_ptr<StallProfiler> stall_profiler_;
   std::unique_ptr<Server::GuardDog> main_thread_guard_dog_;
   std::unique_ptr<Server::GuardDog> worker_guard_dog_;
   bool terminated_;
   std::unique_ptr<Logger::FileSinkDelegate> file_logger_;
+  std::unique_ptr<Logger::AsyncSinkDelegate> async_logger_;
   envoy::config::bootstrap::v3::Bootstrap bootstrap_;
   ConfigTracker::EntryOwnerPtr config_tracker_entry_;
   SystemTime bootstrap_config_update_time_;
@@ -386,7 +402,11 @@ private:
 //                     copying and probably be a cleaner API in general.
 class MetricSnapshotImpl : public Stats::MetricSnapshot {
 public:
-  explicit MetricSnapshotImpl(Stats::Store& store, TimeSource& time_source);
+  /**
+   * @param changed_only whether to only snap the metrics that changed since the previous snapshot
+   *        taken with changed_only set. @see Stats::Sink::flushChangedMetricsOnly()
+   */
+  MetricSnapshotImpl(Stats::Store& store, TimeSource& time_source, bool changed_only = false);
 
   // Stats::MetricSnapshot
   const std::vector<CounterSnapshot>& counters() override { return counters_; }
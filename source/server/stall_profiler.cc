@@ -0,0 +1,147 @@
+#include "server/stall_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <mutex>
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/lock_guard.h"
+#include "common/common/macros.h"
+#include "common/common/utility.h"
+#include "common/profiler/signal_stack_sampler.h"
+
+#include "absl/time/clock.h"
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+constexpr absl::Duration CaptureTimeout = absl::Milliseconds(10);
+constexpr absl::Duration CapturePollInterval = absl::Microseconds(100);
+
+#ifdef __linux__
+using Profiler::SignalStackSampler;
+
+// The SIGURG handler is installed on the first capture, and a single capture is in flight at a
+// time. The state moves from Idle to Requested by the thread that sends the signal, from Requested
+// to Capturing and then Done by the signal handler, and back to Idle by the sending thread, which
+// gives up on a capture by moving it from Requested to Idle.
+enum CaptureState : int { Idle, Requested, Capturing, Done };
+
+std::atomic<int> capture_state{Idle};
+std::atomic<int64_t> capture_tid{};
+void* capture_frames[SignalStackSampler::MaxStackDepth];
+int capture_depth;
+
+Thread::MutexBasicLockable& captureMutex() {
+  MUTABLE_CONSTRUCT_ON_FIRST_USE(Thread::MutexBasicLockable);
+}
+
+// Only calls async-signal-safe functions.
+void captureStackCallback(void* const* frames, int depth) {
+  int expected = Requested;
+  if (syscall(SYS_gettid) == capture_tid.load(std::memory_order_acquire) &&
+      capture_state.compare_exchange_strong(expected, Capturing, std::memory_order_acq_rel)) {
+    std::copy(frames, frames + depth, capture_frames);
+    capture_depth = depth;
+    capture_state.store(Done, std::memory_order_release);
+  }
+}
+
+void installCaptureHandler() {
+  static std::once_flag once;
+  std::call_once(once, []() {
+    RELEASE_ASSERT(SignalStackSampler::install(SIGURG, captureStackCallback),
+                   "failed to install SIGURG handler");
+  });
+}
+
+// Captures the stack of a thread into frames, returning whether it did.
+bool captureStack(const Thread::ThreadId& thread_id, std::vector<void*>& frames) {
+  installCaptureHandler();
+  Thread::LockGuard guard(captureMutex());
+  capture_tid.store(thread_id.getId(), std::memory_order_release);
+  capture_state.store(Requested, std::memory_order_release);
+  if (syscall(SYS_tgkill, getpid(), static_cast<pid_t>(thread_id.getId()), SIGURG) != 0) {
+    capture_state.store(Idle, std::memory_order_release);
+    return false;
+  }
+
+  const absl::Time deadline = absl::Now() + CaptureTimeout;
+  while (true) {
+    const int state = capture_state.load(std::memory_order_acquire);
+    if (state == Done) {
+      break;
+    }
+    // A capture that has started is waited for, as it writes capture_frames.
+    int expected = Requested;
+    if (absl::Now() >= deadline &&
+        capture_state.compare_exchange_strong(expected, Idle, std::memory_order_acq_rel)) {
+      return false;
+    }
+    absl::SleepFor(CapturePollInterval);
+  }
+  frames.assign(capture_frames, capture_frames + capture_depth);
+  capture_state.store(Idle, std::memory_order_release);
+  return true;
+}
+#else
+bool captureStack(const Thread::ThreadId&, std::vector<void*>&) { return false; }
+#endif
+
+} // namespace
+
+StallProfiler::StallProfiler(TimeSource& time_source) : time_source_(time_source) {}
+
+bool StallProfiler::recordStall(const Thread::ThreadId& thread_id, const std::string& thread_name,
+                                std::chrono::milliseconds duration) {
+  std::vector<void*> addresses;
+  if (!captureStack(thread_id, addresses)) {
+    return false;
+  }
+
+  // Symbolize out of the signal handler, as symbolizing may allocate.
+  Stall stall{time_source_.systemTime(), thread_name, duration, {}};
+  stall.frames_.reserve(addresses.size());
+  for (void* address : addresses) {
+    const absl::optional<std::string> symbol = Profiler::SignalStackSampler::symbolize(address);
+    if (symbol.has_value()) {
+      stall.frames_.push_back(fmt::format("{} [{}]", symbol.value(), address));
+    } else {
+      stall.frames_.push_back(fmt::format("[{}]", address));
+    }
+  }
+
+  Thread::LockGuard guard(mutex_);
+  stalls_.push_back(std::move(stall));
+  if (stalls_.size() > MaxStalls) {
+    stalls_.pop_front();
+  }
+  return true;
+}
+
+std::vector<StallProfiler::Stall> StallProfiler::stalls() const {
+  Thread::LockGuard guard(mutex_);
+  return {stalls_.begin(), stalls_.end()};
+}
+
+void StallProfiler::dump(std::ostream& os) const {
+  static const DateFormatter formatter("%Y-%m-%dT%H:%M:%E3SZ");
+  for (const Stall& stall : stalls()) {
+    os << fmt::format("{} thread {} stalled for {}ms\n", formatter.fromTime(stall.time_),
+                      stall.thread_name_, stall.duration_.count());
+    for (size_t i = 0; i < stall.frames_.size(); ++i) {
+      os << fmt::format("  #{} {}\n", i, stall.frames_[i]);
+    }
+  }
+}
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/thread/thread.h"
+
+#include "common/common/non_copyable.h"
+#include "common/common/thread.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * Captures the stack of the threads whose event loop stalls, on behalf of the guard dogs, and
+ * keeps the most recent stalls for the admin /stalls endpoint. The stack is captured by a SIGURG
+ * handler on the stalled thread, which the thread runs even while it is busy in a callback, so
+ * that the stack shows which callback stalls the loop. SIGURG is ignored by default and is only
+ * raised by the kernel for the out-of-band data of the sockets that asked for it with F_SETOWN,
+ * which Envoy never does. Capturing stacks is only supported on Linux.
+ */
+class StallProfiler : NonCopyable {
+public:
+  struct Stall {
+    SystemTime time_;
+    std::string thread_name_;
+    // How long the thread had not checked in with its guard dog when its stack was captured.
+    std::chrono::milliseconds duration_;
+    // The symbolized frames, innermost first.
+    std::vector<std::string> frames_;
+  };
+
+  // The number of stalls kept, the oldest ones being dropped first.
+  static constexpr uint32_t MaxStalls = 16;
+
+  explicit StallProfiler(TimeSource& time_source);
+
+  /**
+   * Captures the stack of a thread and records the stall, blocking the caller until the thread
+   * has captured its stack or for 10ms at most.
+   * @param thread_id supplies the thread to capture the stack of.
+   * @param thread_name supplies the name of the thread to record.
+   * @param duration supplies the time since the thread last checked in.
+   * @return bool whether the stall was recorded.
+   */
+  bool recordStall(const Thread::ThreadId& thread_id, const std::string& thread_name,
+                   std::chrono::milliseconds duration);
+
+  /**
+   * @return the recorded stalls, oldest first.
+   */
+  std::vector<Stall> stalls() const;
+
+  /**
+   * Writes the recorded stalls, oldest first, one frame per line.
+   */
+  void dump(std::ostream& os) const;
+
+private:
+  TimeSource& time_source_;
+  mutable Thread::MutexBasicLockable mutex_;
+  std::deque<Stall> stalls_ ABSL_GUARDED_BY(mutex_);
+};
+
+} // namespace Server
+} // namespace Envoy
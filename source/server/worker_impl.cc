@@ -1,5 +1,10 @@
 #include "server/worker_impl.h"
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include <functional>
 #include <memory>
 
@@ -9,6 +14,8 @@
 #include "envoy/server/configuration.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "common/common/utility.h"
+
 #include "server/connection_handler_impl.h"
 
 namespace Envoy {
@@ -17,9 +24,16 @@ namespace Server {
 WorkerPtr ProdWorkerFactory::createWorker(uint32_t index, OverloadManager& overload_manager,
                                           const std::string& worker_name) {
   Event::DispatcherPtr dispatcher(api_.allocateDispatcher(worker_name));
-  return std::make_unique<WorkerImpl>(tls_, hooks_, std::move(dispatcher),
-                                      std::make_unique<ConnectionHandlerImpl>(*dispatcher, index),
-                                      overload_manager, api_);
+  if (worker_spin_budget_.count() > 0) {
+    dispatcher->setSpinBudget(worker_spin_budget_);
+  }
+  auto worker = std::make_unique<WorkerImpl>(
+      tls_, hooks_, std::move(dispatcher),
+      std::make_unique<ConnectionHandlerImpl>(*dispatcher, index), overload_manager, api_);
+  if (pin_worker_threads_) {
+    worker->pinToCpu(index);
+  }
+  return worker;
 }
 
 WorkerImpl::WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks,
@@ -34,6 +48,12 @@ WorkerImpl::WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks,
   overload_manager.registerForAction(
       OverloadActionNames::get().RejectIncomingConnections, *dispatcher_,
       [this](OverloadActionState state) { rejectIncomingConnectionsCb(state); });
+  // The buffer memory of the streams is only tracked when the streams may be reset for it.
+  if (overload_manager.registerForAction(
+          OverloadActionNames::get().ResetStreams, *dispatcher_,
+          [this](OverloadActionState state) { resetStreamsUsingExcessiveMemoryCb(state); })) {
+    dispatcher_->getWatermarkFactory().trackAccounts();
+  }
 }
 
 void WorkerImpl::addListener(absl::optional<uint64_t> overridden_listener,
@@ -123,7 +143,47 @@ void WorkerImpl::stopListener(Network::ListenerConfig& listener, std::function<v
   });
 }
 
+void WorkerImpl::pinThread() {
+#ifdef __linux__
+  // Pick among the CPUs the process may run on, e.g. as restricted by a cpuset, so that the
+  // workers do not end up on CPUs they are not allowed to use.
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  int rc = pthread_getaffinity_np(pthread_self(), sizeof(allowed), &allowed);
+  const int num_allowed = CPU_COUNT(&allowed);
+  if (rc != 0 || num_allowed == 0) {
+    ENVOY_LOG(warn, "unable to get the CPU affinity of worker {}: {}", dispatcher_->name(),
+              errorDetails(rc));
+    return;
+  }
+  int remaining = cpu_index_.value() % num_allowed;
+  int cpu = 0;
+  for (; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &allowed) && remaining-- == 0) {
+      break;
+    }
+  }
+  cpu_set_t pinned;
+  CPU_ZERO(&pinned);
+  CPU_SET(cpu, &pinned);
+  rc = pthread_setaffinity_np(pthread_self(), sizeof(pinned), &pinned);
+  if (rc != 0) {
+    ENVOY_LOG(warn, "unable to pin worker {} to CPU {}: {}", dispatcher_->name(), cpu,
+              errorDetails(rc));
+    return;
+  }
+  ENVOY_LOG(debug, "pinned worker {} to CPU {}", dispatcher_->name(), cpu);
+#else
+  ENVOY_LOG(warn, "pinning worker threads is not supported on this platform");
+#endif
+}
+
 void WorkerImpl::threadRoutine(GuardDog& guard_dog) {
+  if (cpu_index_.has_value()) {
+    // Pin before the dispatcher runs, so that the memory the worker touches first is allocated
+    // on the NUMA node of its CPU.
+    pinThread();
+  }
   ENVOY_LOG(debug, "worker entering dispatch loop");
   // The watch dog must be created after the dispatcher starts running and has post events flushed,
   // as this is when TLS stat scopes start working.
@@ -155,5 +215,14 @@ void WorkerImpl::rejectIncomingConnectionsCb(OverloadActionState state) {
   handler_->setListenerRejectFraction(static_cast<float>(state.value()));
 }
 
+void WorkerImpl::resetStreamsUsingExcessiveMemoryCb(OverloadActionState state) {
+  if (state.value() == 0) {
+    return;
+  }
+  const uint64_t streams_reset =
+      dispatcher_->getWatermarkFactory().resetAccountsGivenPressure(state.value());
+  ENVOY_LOG(debug, "reset {} streams holding the most buffer memory", streams_reset);
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <memory>
 
@@ -14,6 +15,8 @@
 
 #include "server/listener_hooks.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -26,10 +29,26 @@ public:
   WorkerPtr createWorker(uint32_t index, OverloadManager& overload_manager,
                          const std::string& worker_name) override;
 
+  /**
+   * Pins the worker threads created afterwards to a CPU each, in the order of their index.
+   * @param pin whether to pin the worker threads.
+   */
+  void setPinWorkerThreads(bool pin) { pin_worker_threads_ = pin; }
+
+  /**
+   * Sets the spin budget of the event loops of the worker threads created afterwards.
+   * @param spin_budget supplies the spin budget. @see Event::Dispatcher::setSpinBudget().
+   */
+  void setWorkerSpinBudget(std::chrono::microseconds spin_budget) {
+    worker_spin_budget_ = spin_budget;
+  }
+
 private:
   ThreadLocal::Instance& tls_;
   Api::Api& api_;
   ListenerHooks& hooks_;
+  bool pin_worker_threads_{};
+  std::chrono::microseconds worker_spin_budget_{};
 };
 
 /**
@@ -55,10 +74,19 @@ public:
   void stop() override;
   void stopListener(Network::ListenerConfig& listener, std::function<void()> completion) override;
 
+  /**
+   * Pins the worker thread to the index-th of the CPUs the process may run on, modulo their
+   * number, once it starts. Must be called before start().
+   * @param index the index of the worker.
+   */
+  void pinToCpu(uint32_t index) { cpu_index_ = index; }
+
 private:
   void threadRoutine(GuardDog& guard_dog);
+  void pinThread();
   void stopAcceptingConnectionsCb(OverloadActionState state);
   void rejectIncomingConnectionsCb(OverloadActionState state);
+  void resetStreamsUsingExcessiveMemoryCb(OverloadActionState state);
 
   ThreadLocal::Instance& tls_;
   ListenerHooks& hooks_;
@@ -67,6 +95,7 @@ private:
   Api::Api& api_;
   Thread::ThreadPtr thread_;
   WatchDogSharedPtr watch_dog_;
+  absl::optional<uint32_t> cpu_index_;
 };
 
 } // namespace Server
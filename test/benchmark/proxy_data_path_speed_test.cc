@@ -0,0 +1,379 @@
+// Benchmarks the HTTP request data path end to end: client bytes are decoded by a real
+// ConnectionManagerImpl and HTTP/1 or HTTP/2 server codec, routed by the router filter to a fake
+// upstream, and the response is encoded back to a client codec. The client and the proxy exchange
+// bytes through in-memory buffers standing in for the downstream socket.
+//
+// Besides the request rate, each benchmark reports per request:
+// * wire_bytes: the bytes exchanged with the client through the in-memory socket.
+// * slice_allocs: the buffer slice allocations, served from the slice pool or the heap.
+// * allocs: the heap allocations, when built with --define tcmalloc=gperftools.
+#include <atomic>
+
+#include "envoy/extensions/filters/network/http_connection_manager/v3/http_connection_manager.pb.h"
+#include "envoy/http/codec.h"
+#include "envoy/http/conn_pool.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/buffer/slice_allocator.h"
+#include "common/common/assert.h"
+#include "common/http/header_map_impl.h"
+#include "common/http/http1/codec_impl.h"
+#include "common/http/http2/codec_impl.h"
+#include "common/http/status.h"
+#include "common/http/utility.h"
+#include "common/network/address_impl.h"
+#include "common/stats/isolated_store_impl.h"
+#include "common/stream_info/stream_info_impl.h"
+
+#include "extensions/filters/network/http_connection_manager/config.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/common.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/mocks/upstream/host.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+#ifdef GPERFTOOLS_TCMALLOC
+#include "gperftools/malloc_hook.h"
+#endif
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace {
+
+#ifdef GPERFTOOLS_TCMALLOC
+std::atomic<uint64_t> heap_allocations{0};
+
+void countAllocation(const void*, size_t) {
+  heap_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool installAllocationHook() {
+  static const bool installed = MallocHook::AddNewHook(&countAllocation);
+  return installed;
+}
+#endif
+
+/**
+ * Upstream stream that answers each request with a 200 response carrying a fixed size body, on the
+ * loop iteration after the request completes, as a real upstream connection would.
+ */
+class FakeUpstreamStream : public Http::RequestEncoder,
+                           public Http::Stream,
+                           public Event::DeferredDeletable {
+public:
+  FakeUpstreamStream(Event::Dispatcher& dispatcher, Http::ResponseDecoder& response_decoder,
+                     uint64_t response_body_size)
+      : dispatcher_(dispatcher), response_decoder_(response_decoder),
+        response_body_size_(response_body_size) {}
+
+  // Http::RequestEncoder
+  Http::Status encodeHeaders(const Http::RequestHeaderMap&, bool end_stream) override {
+    if (end_stream) {
+      respond();
+    }
+    return Http::okStatus();
+  }
+  void encodeData(Buffer::Instance& data, bool end_stream) override {
+    data.drain(data.length());
+    if (end_stream) {
+      respond();
+    }
+  }
+  void encodeTrailers(const Http::RequestTrailerMap&) override { respond(); }
+  void encodeMetadata(const Http::MetadataMapVector&) override {}
+  Http::Stream& getStream() override { return *this; }
+  Http::Http1StreamEncoderOptionsOptRef http1StreamEncoderOptions() override {
+    return absl::nullopt;
+  }
+
+  // Http::Stream
+  void addCallbacks(Http::StreamCallbacks&) override {}
+  void removeCallbacks(Http::StreamCallbacks&) override {}
+  void resetStream(Http::StreamResetReason) override { reset_ = true; }
+  void readDisable(bool) override {}
+  uint32_t bufferLimit() override { return 1024 * 1024; }
+  const Network::Address::InstanceConstSharedPtr& connectionLocalAddress() override {
+    return local_address_;
+  }
+  void setFlushTimeout(std::chrono::milliseconds) override {}
+
+private:
+  void respond() {
+    dispatcher_.post([this]() {
+      if (!reset_) {
+        auto headers = Http::ResponseHeaderMapImpl::create();
+        headers->setStatus(200);
+        headers->setContentLength(response_body_size_);
+        if (response_body_size_ == 0) {
+          response_decoder_.decodeHeaders(std::move(headers), true);
+        } else {
+          response_decoder_.decodeHeaders(std::move(headers), false);
+          Buffer::OwnedImpl body(std::string(response_body_size_, 'a'));
+          response_decoder_.decodeData(body, true);
+        }
+      }
+      dispatcher_.deferredDelete(Event::DeferredDeletablePtr{this});
+    });
+  }
+
+  Event::Dispatcher& dispatcher_;
+  Http::ResponseDecoder& response_decoder_;
+  const uint64_t response_body_size_;
+  const Network::Address::InstanceConstSharedPtr local_address_{
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1")};
+  bool reset_{false};
+};
+
+/**
+ * Connection pool for the fake upstream, which has a stream ready for every request.
+ */
+class FakeUpstreamPool : public Http::ConnectionPool::Instance {
+public:
+  FakeUpstreamPool(Event::Dispatcher& dispatcher, uint64_t response_body_size)
+      : dispatcher_(dispatcher), response_body_size_(response_body_size) {}
+
+  // Http::ConnectionPool::Instance
+  void addDrainedCallback(DrainedCb) override {}
+  void drainConnections() override {}
+  bool hasActiveConnections() const override { return false; }
+  Upstream::HostDescriptionConstSharedPtr host() const override { return host_; }
+  bool maybePreconnect(float) override { return false; }
+  Http::ConnectionPool::Cancellable*
+  newStream(Http::ResponseDecoder& response_decoder,
+            Http::ConnectionPool::Callbacks& callbacks) override {
+    // The stream deletes itself once it has responded.
+    auto* stream = new FakeUpstreamStream(dispatcher_, response_decoder, response_body_size_);
+    callbacks.onPoolReady(*stream, host_, stream_info_, Http::Protocol::Http11);
+    return nullptr;
+  }
+
+private:
+  Event::Dispatcher& dispatcher_;
+  const uint64_t response_body_size_;
+  std::shared_ptr<NiceMock<Upstream::MockHostDescription>> host_{
+      std::make_shared<NiceMock<Upstream::MockHostDescription>>()};
+  StreamInfo::StreamInfoImpl stream_info_{dispatcher_.timeSource()};
+};
+
+class ResponseDecoder : public Http::ResponseDecoder {
+public:
+  // Http::StreamDecoder
+  void decodeData(Buffer::Instance& data, bool end_stream) override {
+    data.drain(data.length());
+    complete_ = end_stream;
+  }
+  void decodeMetadata(Http::MetadataMapPtr&&) override {}
+
+  // Http::ResponseDecoder
+  void decode100ContinueHeaders(Http::ResponseHeaderMapPtr&&) override {}
+  void decodeHeaders(Http::ResponseHeaderMapPtr&& headers, bool end_stream) override {
+    RELEASE_ASSERT(Http::Utility::getResponseStatus(*headers) == 200, "unexpected response");
+    complete_ = end_stream;
+  }
+  void decodeTrailers(Http::ResponseTrailerMapPtr&&) override { complete_ = true; }
+
+  bool complete_{false};
+};
+
+/**
+ * A client connected to an HTTP connection manager configured with a single route to the fake
+ * upstream. The request and response bodies are body_size bytes long.
+ */
+class ProxyDataPath {
+public:
+  ProxyDataPath(Http::Protocol protocol, uint64_t body_size)
+      : body_size_(body_size), api_(Api::createApiForTest()),
+        dispatcher_(api_->allocateDispatcher("benchmark")), upstream_(*dispatcher_, body_size) {
+    factory_context_.cluster_manager_.initializeClusters({"fake_cluster"}, {});
+    factory_context_.cluster_manager_.initializeThreadLocalClusters({"fake_cluster"});
+    ON_CALL(factory_context_.cluster_manager_.thread_local_cluster_, httpConnPool(_, _, _))
+        .WillByDefault(Return(&upstream_));
+
+    envoy::extensions::filters::network::http_connection_manager::v3::HttpConnectionManager config;
+    TestUtility::loadFromYaml(R"EOF(
+stat_prefix: benchmark
+route_config:
+  name: local_route
+  virtual_hosts:
+  - name: local_service
+    domains: ["*"]
+    routes:
+    - match: { prefix: "/" }
+      route: { cluster: fake_cluster }
+http_filters:
+- name: envoy.filters.http.router
+)EOF",
+                              config);
+    config.set_codec_type(
+        protocol == Http::Protocol::Http11
+            ? envoy::extensions::filters::network::http_connection_manager::v3::
+                  HttpConnectionManager::HTTP1
+            : envoy::extensions::filters::network::http_connection_manager::v3::
+                  HttpConnectionManager::HTTP2);
+    Extensions::NetworkFilters::HttpConnectionManager::HttpConnectionManagerFilterConfigFactory
+        factory;
+    Network::FilterFactoryCb filter_factory =
+        factory.createFilterFactoryFromProto(config, factory_context_);
+
+    // Network::MockConnection stands in for the proxy's end of the downstream socket, and the
+    // client's end writes straight into the proxy's read buffer.
+    ON_CALL(read_callbacks_.connection_, dispatcher()).WillByDefault(ReturnRef(*dispatcher_));
+    ON_CALL(read_callbacks_.connection_, write(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) {
+          wire_bytes_ += data.length();
+          to_client_.move(data);
+        }));
+    ON_CALL(client_connection_, dispatcher()).WillByDefault(ReturnRef(*dispatcher_));
+    ON_CALL(client_connection_, write(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) {
+          wire_bytes_ += data.length();
+          to_proxy_.move(data);
+        }));
+    ON_CALL(read_callbacks_.connection_, addReadFilter(_))
+        .WillByDefault(Invoke([this](Network::ReadFilterSharedPtr filter) { proxy_ = filter; }));
+    filter_factory(read_callbacks_.connection_);
+    proxy_->initializeReadFilterCallbacks(read_callbacks_);
+    proxy_->onNewConnection();
+
+    if (protocol == Http::Protocol::Http11) {
+      client_ = std::make_unique<Http::Http1::ClientConnectionImpl>(
+          client_connection_, Http::Http1::CodecStats::atomicGet(http1_stats_, client_stats_),
+          client_callbacks_, Http::Http1Settings(), Http::DEFAULT_MAX_HEADERS_COUNT);
+    } else {
+      client_ = std::make_unique<Http::Http2::ClientConnectionImpl>(
+          client_connection_, client_callbacks_,
+          Http::Http2::CodecStats::atomicGet(http2_stats_, client_stats_), random_,
+          ::Envoy::Http2::Utility::initializeAndValidateOptions(
+              envoy::config::core::v3::Http2ProtocolOptions()),
+          Http::DEFAULT_MAX_REQUEST_HEADERS_KB, Http::DEFAULT_MAX_HEADERS_COUNT,
+          Http::Http2::ProdNghttp2SessionFactory::get());
+    }
+
+    request_headers_.setMethod(body_size_ == 0 ? "GET" : "POST");
+    request_headers_.setPath("/");
+    request_headers_.setHost("benchmark");
+    request_headers_.setScheme("http");
+    if (body_size_ > 0) {
+      request_headers_.setContentLength(body_size_);
+    }
+  }
+
+  ~ProxyDataPath() {
+    client_.reset();
+    proxy_.reset();
+    dispatcher_->clearDeferredDeleteList();
+  }
+
+  /**
+   * Send a request and run the proxy until the client has received the whole response.
+   */
+  void request() {
+    ResponseDecoder response;
+    Http::RequestEncoder& encoder = client_->newStream(response);
+    const Http::Status status = encoder.encodeHeaders(request_headers_, body_size_ == 0);
+    RELEASE_ASSERT(status.ok(), "");
+    if (body_size_ > 0) {
+      Buffer::OwnedImpl body(std::string(body_size_, 'a'));
+      encoder.encodeData(body, true);
+    }
+
+    while (!response.complete_) {
+      const bool idle = to_proxy_.length() == 0 && to_client_.length() == 0;
+      if (to_proxy_.length() > 0) {
+        proxy_->onData(to_proxy_, false);
+      }
+      // Runs the fake upstream's responses and the deferred deletion of finished streams.
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+      if (to_client_.length() > 0) {
+        const Http::Status status = client_->dispatch(to_client_);
+        RELEASE_ASSERT(status.ok(), "");
+      }
+      RELEASE_ASSERT(!idle || to_proxy_.length() > 0 || to_client_.length() > 0 ||
+                         response.complete_,
+                     "request did not complete");
+    }
+  }
+
+  uint64_t wireBytes() const { return wire_bytes_; }
+
+private:
+  const uint64_t body_size_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  FakeUpstreamPool upstream_;
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context_;
+  NiceMock<Network::MockReadFilterCallbacks> read_callbacks_;
+  NiceMock<Network::MockConnection> client_connection_;
+  NiceMock<Http::MockConnectionCallbacks> client_callbacks_;
+  NiceMock<Random::MockRandomGenerator> random_;
+  Stats::IsolatedStoreImpl client_stats_;
+  Http::Http1::CodecStats::AtomicPtr http1_stats_;
+  Http::Http2::CodecStats::AtomicPtr http2_stats_;
+  Network::ReadFilterSharedPtr proxy_;
+  Http::ClientConnectionPtr client_;
+  Buffer::OwnedImpl to_proxy_;
+  Buffer::OwnedImpl to_client_;
+  Http::TestRequestHeaderMapImpl request_headers_;
+  uint64_t wire_bytes_{0};
+};
+
+uint64_t sliceAllocations() {
+  const Buffer::SliceAllocatorStats stats = Buffer::SliceAllocator::stats();
+  return stats.hits_ + stats.misses_;
+}
+
+void bmProxyRequest(::benchmark::State& state, Http::Protocol protocol) {
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 1024) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  ProxyDataPath proxy(protocol, state.range(0));
+  // The first request sets up the codecs and per connection state.
+  proxy.request();
+
+#ifdef GPERFTOOLS_TCMALLOC
+  const bool count_allocations = installAllocationHook();
+  const uint64_t start_allocations = heap_allocations.load();
+#endif
+  const uint64_t start_wire_bytes = proxy.wireBytes();
+  const uint64_t start_slice_allocations = sliceAllocations();
+  for (auto _ : state) { // NOLINT
+    proxy.request();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.counters["wire_bytes"] = ::benchmark::Counter(proxy.wireBytes() - start_wire_bytes,
+                                                      ::benchmark::Counter::kAvgIterations);
+  state.counters["slice_allocs"] = ::benchmark::Counter(
+      sliceAllocations() - start_slice_allocations, ::benchmark::Counter::kAvgIterations);
+#ifdef GPERFTOOLS_TCMALLOC
+  if (count_allocations) {
+    state.counters["allocs"] = ::benchmark::Counter(heap_allocations.load() - start_allocations,
+                                                    ::benchmark::Counter::kAvgIterations);
+  }
+#endif
+}
+
+void bmHttp1Request(::benchmark::State& state) {
+  bmProxyRequest(state, Http::Protocol::Http11);
+}
+BENCHMARK(bmHttp1Request)->Arg(0)->Arg(1024)->Arg(64 * 1024);
+
+void bmHttp2Request(::benchmark::State& state) {
+  bmProxyRequest(state, Http::Protocol::Http2);
+}
+BENCHMARK(bmHttp2Request)->Arg(0)->Arg(1024)->Arg(64 * 1024);
+
+} // namespace
+} // namespace Envoy
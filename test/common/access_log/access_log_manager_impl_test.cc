@@ -11,6 +11,8 @@
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -443,6 +445,52 @@ TEST_F(AccessLogManagerImplTest, BigDataChunkShouldBeFlushedWithoutTimer) {
   EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
 }
 
+// The lines written by several threads are all flushed, in the order each thread wrote them.
+TEST_F(AccessLogManagerImplTest, WritesFromManyThreads) {
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog("foo");
+
+  Thread::MutexBasicLockable written_lock;
+  std::string written;
+  EXPECT_CALL(*file_, write_(_))
+      .WillRepeatedly(Invoke([&](absl::string_view data) -> Api::IoCallSizeResult {
+        Thread::LockGuard lock(written_lock);
+        written.append(data.data(), data.size());
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  constexpr int threads = 4;
+  constexpr int lines = 1000;
+  std::vector<Thread::ThreadPtr> writers;
+  for (int i = 0; i < threads; ++i) {
+    writers.push_back(thread_factory_.createThread([&log_file, i]() {
+      for (int j = 0; j < lines; ++j) {
+        log_file->write(absl::StrCat(i, " ", j, "\n"));
+      }
+    }));
+  }
+  for (const Thread::ThreadPtr& writer : writers) {
+    writer->join();
+  }
+  log_file->flush();
+
+  std::vector<int> next_line(threads, 0);
+  {
+    Thread::LockGuard lock(written_lock);
+    for (absl::string_view line : absl::StrSplit(written, '\n', absl::SkipEmpty())) {
+      const std::vector<absl::string_view> fields = absl::StrSplit(line, ' ');
+      ASSERT_EQ(2, fields.size());
+      int thread;
+      int number;
+      ASSERT_TRUE(absl::SimpleAtoi(fields[0], &thread));
+      ASSERT_TRUE(absl::SimpleAtoi(fields[1], &number));
+      EXPECT_EQ(next_line[thread]++, number);
+    }
+  }
+  EXPECT_EQ(std::vector<int>(threads, lines), next_line);
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
 TEST_F(AccessLogManagerImplTest, ReopenAllFiles) {
   EXPECT_CALL(dispatcher_, createTimer_(_)).WillRepeatedly(ReturnNew<NiceMock<Event::MockTimer>>());
 
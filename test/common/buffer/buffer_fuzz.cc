@@ -74,6 +74,11 @@ public:
     drain_tracker();
   }
 
+  void bindAccount(Buffer::BufferMemoryAccountSharedPtr) override {
+    // Not implemented.
+    ASSERT(false);
+  }
+
   void add(const void* data, uint64_t size) override {
     FUZZ_ASSERT(start_ + size_ + size <= data_.size());
     ::memcpy(mutableEnd(), data, size);
@@ -412,6 +417,18 @@ uint32_t bufferAction(Context& ctxt, char insert_value, uint32_t max_alloc, Buff
                 (data.find(action.starts_with()) == 0));
     break;
   }
+  case test::common::buffer::Action::kSearchAnyOf: {
+    const std::string& content = action.search_any_of().content();
+    const uint32_t offset = action.search_any_of().offset();
+    // searchAnyOf() is specific to OwnedImpl, the linear buffers are not checked.
+    const auto* owned_buffer = dynamic_cast<const Buffer::OwnedImpl*>(&target_buffer);
+    if (owned_buffer != nullptr) {
+      const std::string data = target_buffer.toString();
+      FUZZ_ASSERT(owned_buffer->searchAnyOf(content, offset) ==
+                  static_cast<ssize_t>(data.find_first_of(content, offset)));
+    }
+    break;
+  }
   default:
     // Maybe nothing is set?
     break;
@@ -320,6 +320,47 @@ static void bufferSearchPartialMatch(benchmark::State& state) {
 }
 BENCHMARK(bufferSearchPartialMatch)->Arg(1)->Arg(4096)->Arg(16384)->Arg(65536);
 
+// Test buffer search, for the case where the pattern spans many slices.
+static void bufferSearchAcrossSlices(benchmark::State& state) {
+  const std::string Pattern(state.range(1), 'b');
+  // Add the data in slices small enough for the pattern to span several of them, with a
+  // partial match ending each slice but the last.
+  const std::string PartialMatch(Pattern.length() / 2, 'b');
+  const std::string Filler(1024 - PartialMatch.length(), 'a');
+  Buffer::OwnedImpl buffer;
+  while (buffer.length() < static_cast<uint64_t>(state.range(0))) {
+    buffer.appendSliceForTest(Filler + PartialMatch);
+  }
+  buffer.appendSliceForTest(PartialMatch);
+  buffer.appendSliceForTest(Pattern);
+  ssize_t result = 0;
+  for (auto _ : state) {
+    result += buffer.search(Pattern.c_str(), Pattern.length(), 0, 0);
+  }
+  benchmark::DoNotOptimize(result);
+}
+BENCHMARK(bufferSearchAcrossSlices)
+    ->Args({1, 16})
+    ->Args({4096, 16})
+    ->Args({16384, 256})
+    ->Args({65536, 1024});
+
+// Test buffer searchAnyOf for a set of delimiters, which only occur at the end of the buffer.
+static void bufferSearchAnyOf(benchmark::State& state) {
+  const std::string Delimiters("\r\n");
+  std::string data(state.range(0), 'a');
+  data += Delimiters;
+
+  const absl::string_view input(data);
+  Buffer::OwnedImpl buffer(input);
+  ssize_t result = 0;
+  for (auto _ : state) {
+    result += buffer.searchAnyOf(Delimiters, 0);
+  }
+  benchmark::DoNotOptimize(result);
+}
+BENCHMARK(bufferSearchAnyOf)->Arg(1)->Arg(4096)->Arg(16384)->Arg(65536);
+
 // Test buffer startsWith, for the simple case where there is no match for the pattern at the start
 // of the buffer.
 static void bufferStartsWith(benchmark::State& state) {
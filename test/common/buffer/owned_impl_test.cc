@@ -1040,6 +1040,31 @@ TEST_F(OwnedImplTest, SearchWithLengthLimit) {
   EXPECT_EQ(12, buffer.search("ba", 2, 11, 10e6));
 }
 
+TEST_F(OwnedImplTest, SearchAnyOf) {
+  // Populate a buffer with a string split across many small slices, to
+  // exercise edge cases in the searchAnyOf implementation.
+  static const char* Inputs[] = {"ab", "c", "", "\r\n", "d", "e\r", "fg", "\n"};
+  Buffer::OwnedImpl buffer;
+  for (const auto& input : Inputs) {
+    buffer.appendSliceForTest(input);
+  }
+  EXPECT_EQ("abc\r\nde\rfg\n", buffer.toString());
+
+  EXPECT_EQ(-1, buffer.searchAnyOf("", 0));
+  EXPECT_EQ(-1, buffer.searchAnyOf("xyz", 0));
+  EXPECT_EQ(0, buffer.searchAnyOf("a", 0));
+  EXPECT_EQ(2, buffer.searchAnyOf("c", 0));
+  EXPECT_EQ(3, buffer.searchAnyOf("\n\r", 0));
+  EXPECT_EQ(3, buffer.searchAnyOf("\n\r", 3));
+  EXPECT_EQ(4, buffer.searchAnyOf("\n\r", 4));
+  EXPECT_EQ(7, buffer.searchAnyOf("\n\r", 5));
+  EXPECT_EQ(10, buffer.searchAnyOf("\n", 5));
+  EXPECT_EQ(8, buffer.searchAnyOf("gf", 0));
+  EXPECT_EQ(-1, buffer.searchAnyOf("a", 1));
+  EXPECT_EQ(-1, buffer.searchAnyOf("\n", buffer.length()));
+  EXPECT_EQ(-1, buffer.searchAnyOf("\n", buffer.length() + 1));
+}
+
 TEST_F(OwnedImplTest, StartsWith) {
   // Populate a buffer with a string split across many small slices, to
   // exercise edge cases in the startsWith implementation.
@@ -1263,6 +1288,34 @@ TEST_F(OwnedImplTest, FrontSlice) {
   EXPECT_EQ(1, buffer.frontSlice().len_);
 }
 
+TEST_F(OwnedImplTest, SharedChunks) {
+  bool released = false;
+  Buffer::OwnedImpl first;
+  {
+    SharedChunks shared;
+    Buffer::OwnedImpl hello("hello");
+    hello.addDrainTracker([&released]() { released = true; });
+    EXPECT_EQ(0, shared.append(hello));
+    EXPECT_EQ(0, hello.length());
+    Buffer::OwnedImpl world(" world");
+    EXPECT_EQ(1, shared.append(world));
+    EXPECT_EQ(11, shared.length());
+
+    Buffer::OwnedImpl second;
+    shared.addTo(first);
+    shared.addTo(second, 1);
+    EXPECT_EQ("hello world", first.toString());
+    EXPECT_EQ(" world", second.toString());
+    // The buffers reference the same bytes rather than copies of them.
+    EXPECT_EQ(first.getRawSlices()[1].mem_, second.frontSlice().mem_);
+  }
+
+  // The chunks outlive the SharedChunks until they are drained from all the buffers.
+  EXPECT_FALSE(released);
+  first.drain(5);
+  EXPECT_TRUE(released);
+}
+
 } // namespace
 } // namespace Buffer
 } // namespace Envoy
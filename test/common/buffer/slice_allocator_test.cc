@@ -0,0 +1,130 @@
+#include "common/buffer/buffer_impl.h"
+#include "common/buffer/slice_allocator.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+class SliceAllocatorTest : public testing::Test {
+protected:
+  SliceAllocatorTest() { SliceAllocator::releaseFreeStorageForThread(); }
+  ~SliceAllocatorTest() override {
+    SliceAllocator::releaseFreeStorageForThread();
+    SliceAllocator::setMaxRetainedBytesPerThread(SliceAllocator::DefaultMaxRetainedBytesPerThread);
+  }
+};
+
+TEST_F(SliceAllocatorTest, ReusesFreedStorageOfSameSizeClass) {
+  const SliceAllocatorStats before = SliceAllocator::stats();
+  uint8_t* first;
+  {
+    SliceStorage storage(16384);
+    first = storage.get();
+    ASSERT_NE(nullptr, first);
+  }
+  EXPECT_EQ(before.retained_bytes_ + 16384, SliceAllocator::stats().retained_bytes_);
+
+  // A different size class does not reuse the freed block.
+  SliceStorage other(4096);
+  EXPECT_NE(first, other.get());
+
+  SliceStorage reused(16384);
+  EXPECT_EQ(first, reused.get());
+
+  const SliceAllocatorStats after = SliceAllocator::stats();
+  EXPECT_EQ(before.hits_ + 1, after.hits_);
+  EXPECT_EQ(before.misses_ + 2, after.misses_);
+  EXPECT_EQ(before.retained_bytes_, after.retained_bytes_);
+}
+
+TEST_F(SliceAllocatorTest, LargeStorageIsNotPooled) {
+  const SliceAllocatorStats before = SliceAllocator::stats();
+  { SliceStorage storage(SliceAllocator::MaxPooledSize + SliceAllocator::PageSize); }
+  const SliceAllocatorStats after = SliceAllocator::stats();
+  EXPECT_EQ(before.hits_, after.hits_);
+  EXPECT_EQ(before.misses_, after.misses_);
+  EXPECT_EQ(before.retained_bytes_, after.retained_bytes_);
+}
+
+TEST_F(SliceAllocatorTest, ZeroSizedStorageIsNonNull) {
+  SliceStorage storage(0);
+  EXPECT_NE(nullptr, storage.get());
+}
+
+TEST_F(SliceAllocatorTest, RetainedBytesAreCapped) {
+  SliceAllocator::setMaxRetainedBytesPerThread(8192);
+  const SliceAllocatorStats before = SliceAllocator::stats();
+  {
+    SliceStorage a(4096);
+    SliceStorage b(4096);
+    SliceStorage c(4096);
+  }
+  EXPECT_EQ(before.retained_bytes_ + 8192, SliceAllocator::stats().retained_bytes_);
+
+  SliceAllocator::setMaxRetainedBytesPerThread(0);
+  { SliceStorage d(8192); }
+  EXPECT_EQ(before.retained_bytes_ + 8192, SliceAllocator::stats().retained_bytes_);
+}
+
+TEST_F(SliceAllocatorTest, MoveTransfersOwnership) {
+  SliceStorage a(4096);
+  uint8_t* data = a.get();
+  SliceStorage b(std::move(a));
+  EXPECT_EQ(nullptr, a.get()); // NOLINT(bugprone-use-after-move)
+  EXPECT_EQ(data, b.get());
+  a = std::move(b);
+  EXPECT_EQ(data, a.get());
+  a.reset();
+  EXPECT_EQ(nullptr, a.get());
+}
+
+// Storage freed on another thread goes to the owner's remote-free list and is reused by the owner.
+TEST_F(SliceAllocatorTest, RemoteFreeReturnsToOwner) {
+  const SliceAllocatorStats before = SliceAllocator::stats();
+  auto storage = std::make_unique<SliceStorage>(8192);
+  uint8_t* data = storage->get();
+
+  auto thread =
+      Thread::threadFactoryForTest().createThread([&storage]() -> void { storage.reset(); });
+  thread->join();
+
+  EXPECT_EQ(before.remote_frees_ + 1, SliceAllocator::stats().remote_frees_);
+  SliceStorage reused(8192);
+  EXPECT_EQ(data, reused.get());
+}
+
+// Storage that outlives its allocating thread can still be freed.
+TEST_F(SliceAllocatorTest, FreeAfterOwnerThreadExit) {
+  std::unique_ptr<OwnedImpl> buffer;
+  auto thread = Thread::threadFactoryForTest().createThread([&buffer]() -> void {
+    buffer = std::make_unique<OwnedImpl>();
+    buffer->add(std::string(10000, 'a'));
+  });
+  thread->join();
+
+  EXPECT_EQ(10000, buffer->length());
+  buffer.reset();
+}
+
+TEST_F(SliceAllocatorTest, BufferSlicesUsePool) {
+  const SliceAllocatorStats before = SliceAllocator::stats();
+  {
+    OwnedImpl buffer;
+    buffer.add(std::string(100, 'a'));
+  }
+  {
+    OwnedImpl buffer;
+    buffer.add(std::string(100, 'b'));
+    EXPECT_EQ(std::string(100, 'b'), buffer.toString());
+  }
+  const SliceAllocatorStats after = SliceAllocator::stats();
+  EXPECT_EQ(before.hits_ + 1, after.hits_);
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
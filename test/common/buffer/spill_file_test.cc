@@ -0,0 +1,80 @@
+#include <sys/mman.h>
+
+#include <string>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/buffer/buffer_impl.h"
+#include "common/buffer/spill_file.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+std::string pattern(uint64_t length) {
+  std::string data(length, 0);
+  for (uint64_t i = 0; i < length; ++i) {
+    data[i] = static_cast<char>('a' + i % 26);
+  }
+  return data;
+}
+
+// The data spilled is read back from the file, across segments, and outlives the file.
+TEST(SpillFileTest, Spill) {
+  SpillFilePtr file = SpillFile::create(TestEnvironment::temporaryDirectory());
+  ASSERT_NE(nullptr, file);
+
+  const std::string first = pattern(SpillFile::SegmentSize + SpillFile::SegmentSize / 2);
+  OwnedImpl data1;
+  // Several slices.
+  data1.add(first.substr(0, 1000));
+  data1.add(first.substr(1000));
+  EXPECT_TRUE(file->spill(data1));
+  EXPECT_EQ(first, data1.toString());
+
+  const std::string second = pattern(SpillFile::SegmentSize);
+  OwnedImpl data2(second);
+  EXPECT_TRUE(file->spill(data2));
+  EXPECT_EQ(first.size() + second.size(), file->spilledBytes());
+
+  file.reset();
+  EXPECT_EQ(first, data1.toString());
+  data1.drain(first.size());
+  EXPECT_EQ(second, data2.toString());
+
+  OwnedImpl empty;
+  EXPECT_TRUE(SpillFile::create(TestEnvironment::temporaryDirectory())->spill(empty));
+}
+
+TEST(SpillFileTest, MissingDirectory) {
+  EXPECT_EQ(nullptr, SpillFile::create(TestEnvironment::temporaryPath("spill_file_test/missing")));
+}
+
+// Data which cannot be spilled is left in memory.
+TEST(SpillFileTest, MapFailure) {
+  SpillFilePtr file = SpillFile::create(TestEnvironment::temporaryDirectory());
+  ASSERT_NE(nullptr, file);
+
+  NiceMock<Api::MockOsSysCalls> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  EXPECT_CALL(os_sys_calls, mmap(_, _, _, _, _, _))
+      .WillOnce(Return(Api::SysCallPtrResult{MAP_FAILED, ENOMEM}));
+  OwnedImpl data("hello");
+  EXPECT_FALSE(file->spill(data));
+  EXPECT_EQ("hello", data.toString());
+  EXPECT_EQ(0U, file->spilledBytes());
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
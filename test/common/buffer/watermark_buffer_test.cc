@@ -1,4 +1,5 @@
 #include <array>
+#include <vector>
 
 #include "common/api/os_sys_calls_impl.h"
 #include "common/buffer/buffer_impl.h"
@@ -568,6 +569,104 @@ TEST_F(WatermarkBufferTest, MoveWatermarksOverflow) {
   EXPECT_EQ(1, overflow_watermark_buffer1);
 }
 
+class BufferMemoryAccountTest : public testing::Test {
+protected:
+  WatermarkBufferFactory factory_;
+};
+
+// Accounts are only handed out once the factory tracks them.
+TEST_F(BufferMemoryAccountTest, AccountsOnlyWhenTracked) {
+  EXPECT_EQ(nullptr, factory_.createAccount([]() {}));
+  factory_.trackAccounts();
+  EXPECT_NE(nullptr, factory_.createAccount([]() {}));
+}
+
+// The slices of a buffer are charged to its account while they hold storage, including after they
+// moved to another buffer.
+TEST_F(BufferMemoryAccountTest, SlicesChargeTheirAccount) {
+  factory_.trackAccounts();
+  BufferMemoryAccountSharedPtr account = factory_.createAccount([]() {});
+  {
+    OwnedImpl buffer;
+    buffer.bindAccount(account);
+    buffer.add(std::string(10000, 'a'));
+    const uint64_t balance = account->balance();
+    EXPECT_LE(10000, balance);
+
+    OwnedImpl other;
+    other.move(buffer);
+    EXPECT_EQ(balance, account->balance());
+
+    other.drain(other.length());
+    EXPECT_EQ(0, account->balance());
+
+    buffer.add(std::string(100, 'a'));
+    EXPECT_LT(0, account->balance());
+  }
+  EXPECT_EQ(0, account->balance());
+}
+
+TEST_F(BufferMemoryAccountTest, SizeClass) {
+  const uint64_t min = BufferMemoryAccountImpl::MinimumBalanceToTrack;
+  EXPECT_EQ(-1, BufferMemoryAccountImpl::sizeClass(0));
+  EXPECT_EQ(-1, BufferMemoryAccountImpl::sizeClass(min - 1));
+  EXPECT_EQ(0, BufferMemoryAccountImpl::sizeClass(min));
+  EXPECT_EQ(0, BufferMemoryAccountImpl::sizeClass(2 * min - 1));
+  EXPECT_EQ(1, BufferMemoryAccountImpl::sizeClass(2 * min));
+  EXPECT_EQ(2, BufferMemoryAccountImpl::sizeClass(4 * min));
+  EXPECT_EQ(BufferMemoryAccountImpl::NumSizeClasses - 1,
+            BufferMemoryAccountImpl::sizeClass(min << 20));
+}
+
+// The higher the pressure, the more size classes are reset, starting from the largest balances.
+TEST_F(BufferMemoryAccountTest, ResetLargestFirst) {
+  factory_.trackAccounts();
+  const uint64_t min = BufferMemoryAccountImpl::MinimumBalanceToTrack;
+  uint32_t small_resets = 0;
+  uint32_t large_resets = 0;
+  BufferMemoryAccountSharedPtr small = factory_.createAccount([&]() { ++small_resets; });
+  BufferMemoryAccountSharedPtr large = factory_.createAccount([&]() { ++large_resets; });
+  BufferMemoryAccountSharedPtr untracked = factory_.createAccount([]() { FAIL(); });
+  small->charge(min);
+  large->charge(min << 10);
+  untracked->charge(min - 1);
+
+  EXPECT_EQ(1, factory_.resetAccountsGivenPressure(0.1));
+  EXPECT_EQ(0, small_resets);
+  EXPECT_EQ(1, large_resets);
+
+  // A reset stream is not reset again.
+  EXPECT_EQ(1, factory_.resetAccountsGivenPressure(1));
+  EXPECT_EQ(1, small_resets);
+  EXPECT_EQ(1, large_resets);
+  EXPECT_EQ(0, factory_.resetAccountsGivenPressure(1));
+
+  small->credit(min);
+  large->credit(min << 10);
+  untracked->credit(min - 1);
+}
+
+// A stream which went away is no longer reset, and the number of streams reset at once is capped.
+TEST_F(BufferMemoryAccountTest, ClearDownstreamAndCap) {
+  factory_.trackAccounts();
+  const uint64_t min = BufferMemoryAccountImpl::MinimumBalanceToTrack;
+  uint32_t resets = 0;
+  std::vector<BufferMemoryAccountSharedPtr> accounts;
+  for (uint32_t i = 0; i < WatermarkBufferFactory::MaxStreamsResetPerCall + 1; ++i) {
+    accounts.push_back(factory_.createAccount([&]() { ++resets; }));
+    accounts.back()->charge(min);
+  }
+  accounts.back()->clearDownstream();
+
+  EXPECT_EQ(WatermarkBufferFactory::MaxStreamsResetPerCall,
+            factory_.resetAccountsGivenPressure(1));
+  EXPECT_EQ(WatermarkBufferFactory::MaxStreamsResetPerCall, resets);
+  EXPECT_EQ(0, factory_.resetAccountsGivenPressure(1));
+  for (auto& account : accounts) {
+    account->credit(min);
+  }
+}
+
 } // namespace
 } // namespace Buffer
 } // namespace Envoy
@@ -0,0 +1,62 @@
+#include "common/buffer/buffer_impl.h"
+#include "common/buffer/zero_copy_output_stream_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+class ZeroCopyOutputStreamTest : public testing::Test {
+public:
+  Buffer::OwnedImpl buffer_;
+  void* data_;
+  int size_;
+};
+
+// The reservations are sized by the hint, and the bytes written are committed once the stream is
+// destroyed.
+TEST_F(ZeroCopyOutputStreamTest, WriteWithinHint) {
+  {
+    ZeroCopyOutputStreamImpl stream(buffer_, 4);
+    EXPECT_TRUE(stream.Next(&data_, &size_));
+    EXPECT_EQ(4, size_);
+    memcpy(data_, "abcd", 4);
+    EXPECT_EQ(4, stream.ByteCount());
+    EXPECT_EQ(0, buffer_.length());
+  }
+  EXPECT_EQ("abcd", buffer_.toString());
+}
+
+// Writing past the hint takes further reservations of the maximum size, and the bytes backed up
+// are not committed.
+TEST_F(ZeroCopyOutputStreamTest, WritePastHintAndBackUp) {
+  {
+    ZeroCopyOutputStreamImpl stream(buffer_, 2);
+    EXPECT_TRUE(stream.Next(&data_, &size_));
+    EXPECT_EQ(2, size_);
+    memcpy(data_, "ab", 2);
+    EXPECT_TRUE(stream.Next(&data_, &size_));
+    EXPECT_EQ(ZeroCopyOutputStreamImpl::MaxReservationSize, size_);
+    memcpy(data_, "cd", 2);
+    stream.BackUp(size_ - 2);
+    EXPECT_EQ(4, stream.ByteCount());
+  }
+  EXPECT_EQ("abcd", buffer_.toString());
+}
+
+// A large message is written over several slices.
+TEST_F(ZeroCopyOutputStreamTest, LargeWrite) {
+  const std::string data(3 * ZeroCopyOutputStreamImpl::MaxReservationSize, 'a');
+  {
+    ZeroCopyOutputStreamImpl stream(buffer_, data.size());
+    Protobuf::io::CodedOutputStream codec_stream(&stream);
+    codec_stream.WriteRaw(data.data(), data.size());
+  }
+  EXPECT_EQ(data, buffer_.toString());
+  EXPECT_LE(3, buffer_.getRawSlices().size());
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
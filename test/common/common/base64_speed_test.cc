@@ -0,0 +1,68 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <algorithm>
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/base64.h"
+
+#include "benchmark/benchmark.h"
+
+// NOLINT(namespace-envoy)
+
+static std::string binaryInput(size_t size) {
+  std::string input(size, '\0');
+  for (size_t i = 0; i < size; ++i) {
+    input[i] = static_cast<char>(i * 37);
+  }
+  return input;
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_Base64EncodeString(benchmark::State& state) {
+  const std::string input = binaryInput(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Envoy::Base64::encode(input.data(), input.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_Base64EncodeString)->Arg(16)->Arg(1024)->Arg(65536);
+
+// The body of a grpc-web-text response, in 16KiB slices.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_Base64EncodeBuffer(benchmark::State& state) {
+  const std::string input = binaryInput(state.range(0));
+  Envoy::Buffer::OwnedImpl buffer;
+  for (size_t offset = 0; offset < input.size(); offset += 16384) {
+    buffer.appendSliceForTest(input.data() + offset,
+                              std::min<size_t>(16384, input.size() - offset));
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Envoy::Base64::encode(buffer, buffer.length()));
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_Base64EncodeBuffer)->Arg(1024)->Arg(65536);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_Base64Decode(benchmark::State& state) {
+  const std::string input = binaryInput(state.range(0));
+  const std::string encoded = Envoy::Base64::encode(input.data(), input.size());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Envoy::Base64::decode(encoded));
+  }
+  state.SetBytesProcessed(state.iterations() * encoded.size());
+}
+BENCHMARK(BM_Base64Decode)->Arg(16)->Arg(1024)->Arg(65536);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_Base64UrlDecode(benchmark::State& state) {
+  const std::string input = binaryInput(state.range(0));
+  const std::string encoded = Envoy::Base64Url::encode(input.data(), input.size());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Envoy::Base64Url::decode(encoded));
+  }
+  state.SetBytesProcessed(state.iterations() * encoded.size());
+}
+BENCHMARK(BM_Base64UrlDecode)->Arg(16)->Arg(1024);
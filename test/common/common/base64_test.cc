@@ -132,6 +132,48 @@ TEST(Base64Test, BinaryBufferEncode) {
   EXPECT_EQ("AAECAwgKCQCqvN4=", Base64::encode(buffer, 30));
 }
 
+// The inputs long enough for the vector encoding and decoding, split across slices at every
+// offset, have the same encoding as with the scalar encoding of their tails.
+TEST(Base64Test, LongInputs) {
+  EXPECT_EQ(std::string(80, '/'), Base64::encode(std::string(60, '\xff').data(), 60));
+  std::string man;
+  for (int i = 0; i < 40; ++i) {
+    man += "Man";
+  }
+  std::string encoded_man;
+  for (int i = 0; i < 40; ++i) {
+    encoded_man += "TWFu";
+  }
+  EXPECT_EQ(encoded_man, Base64::encode(man.data(), man.size()));
+  EXPECT_EQ(man, Base64::decode(encoded_man));
+
+  std::string input;
+  for (size_t size = 0; size <= 200; ++size) {
+    const std::string encoded = Base64::encode(input.data(), input.size());
+    EXPECT_EQ(input, Base64::decode(encoded));
+    for (size_t split = 0; split <= size; split += 7) {
+      Buffer::OwnedImpl buffer;
+      buffer.appendSliceForTest(input.data(), split);
+      buffer.appendSliceForTest(input.data() + split, size - split);
+      EXPECT_EQ(encoded, Base64::encode(buffer, size));
+    }
+    input.push_back(static_cast<char>(size * 37));
+  }
+}
+
+// An invalid character fails the decoding wherever it is.
+TEST(Base64Test, LongInputDecodeFailure) {
+  const std::string input(150, 'a');
+  const std::string encoded = Base64::encode(input.data(), input.size());
+  for (size_t i = 0; i < encoded.size(); ++i) {
+    for (const char invalid : {'.', '=', '-', '_', '\x80', '\xff'}) {
+      std::string corrupted = encoded;
+      corrupted[i] = invalid;
+      EXPECT_EQ("", Base64::decode(corrupted));
+    }
+  }
+}
+
 TEST(Base64UrlTest, EncodeString) {
   EXPECT_EQ("", Base64Url::encode("", 0));
   EXPECT_EQ("AAA", Base64Url::encode("\0\0", 2));
@@ -172,6 +214,21 @@ TEST(Base64UrlTest, Decode) {
   }
 }
 
+TEST(Base64UrlTest, LongInputs) {
+  EXPECT_EQ(std::string(80, '_'), Base64Url::encode(std::string(60, '\xff').data(), 60));
+  EXPECT_EQ(std::string(60, '\xff'), Base64Url::decode(std::string(80, '_')));
+
+  std::string input;
+  for (size_t size = 1; size <= 200; ++size) {
+    input.push_back(static_cast<char>(size * 37));
+    EXPECT_EQ(input, Base64Url::decode(Base64Url::encode(input.data(), input.size())));
+  }
+
+  std::string corrupted(80, 'A');
+  corrupted[40] = '+';
+  EXPECT_EQ("", Base64Url::decode(corrupted));
+}
+
 TEST(Base64UrlTest, DecodeFailure) {
   EXPECT_EQ("", Base64Url::decode("==Zg"));
   EXPECT_EQ("", Base64Url::decode("=Zm8"));
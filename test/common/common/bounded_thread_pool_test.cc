@@ -0,0 +1,55 @@
+#include <functional>
+
+#include "common/common/bounded_thread_pool.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/synchronization/notification.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+// A task that blocks the thread of the pool that runs it until it is released.
+class BlockingTask {
+public:
+  std::function<void()> task() {
+    return [this]() {
+      started_.Notify();
+      release_.WaitForNotification();
+    };
+  }
+
+  absl::Notification started_;
+  absl::Notification release_;
+};
+
+TEST(BoundedThreadPoolTest, RunTask) {
+  BoundedThreadPool pool(Thread::threadFactoryForTest(), "test", 2, 4);
+  absl::Notification done;
+  EXPECT_TRUE(pool.post([&done]() { done.Notify(); }));
+  done.WaitForNotification();
+}
+
+// Once the queue is full, tasks are refused until a thread frees a spot.
+TEST(BoundedThreadPoolTest, FullQueue) {
+  BoundedThreadPool pool(Thread::threadFactoryForTest(), "test", 1, 2);
+  BlockingTask blocking;
+  EXPECT_TRUE(pool.post(blocking.task()));
+  blocking.started_.WaitForNotification();
+  EXPECT_EQ(0, pool.pressure());
+
+  absl::Notification done;
+  EXPECT_TRUE(pool.post([]() {}));
+  EXPECT_EQ(0.5, pool.pressure());
+  EXPECT_TRUE(pool.post([&done]() { done.Notify(); }));
+  EXPECT_EQ(1, pool.pressure());
+  EXPECT_FALSE(pool.post([]() {}));
+
+  blocking.release_.Notify();
+  done.WaitForNotification();
+  EXPECT_EQ(0, pool.pressure());
+}
+
+} // namespace
+} // namespace Envoy
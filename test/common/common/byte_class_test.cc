@@ -0,0 +1,47 @@
+#include <string>
+
+#include "common/common/byte_class.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+TEST(ByteClassTest, Stops) {
+  const ByteClass byte_class(absl::string_view("\x00\x1f\x7b\xff", 4), "~");
+  EXPECT_TRUE(byte_class.stops('\0'));
+  EXPECT_TRUE(byte_class.stops('\x1f'));
+  EXPECT_FALSE(byte_class.stops(' '));
+  EXPECT_FALSE(byte_class.stops('a'));
+  EXPECT_TRUE(byte_class.stops('{'));
+  EXPECT_FALSE(byte_class.stops('~'));
+  EXPECT_TRUE(byte_class.stops('\xff'));
+}
+
+// Verify that find() returns the first byte in the class at every offset, which covers both the
+// vector scan of long inputs and the scalar scan of short tails.
+TEST(ByteClassTest, Find) {
+  const ByteClass byte_class(absl::string_view("\x00\x1f\x7b\xff", 4), "~");
+  for (size_t size = 0; size <= 40; ++size) {
+    std::string input(size, 'a');
+    const char* end = input.data() + input.size();
+    EXPECT_EQ(end, byte_class.find(input.data(), end));
+    for (size_t i = 0; i < size; ++i) {
+      // Exceptions within the ranges do not end the scan.
+      input[i] = '~';
+      EXPECT_EQ(end, byte_class.find(input.data(), end));
+      input[i] = '\n';
+      EXPECT_EQ(input.data() + i, byte_class.find(input.data(), end));
+      input[i] = '~';
+      if (i + 1 < size) {
+        input[i + 1] = '}';
+        EXPECT_EQ(input.data() + i + 1, byte_class.find(input.data(), end));
+        input[i + 1] = 'a';
+      }
+      input[i] = 'a';
+    }
+  }
+}
+
+} // namespace
+} // namespace Envoy
@@ -1,8 +1,14 @@
 #include <iostream>
+#include <memory>
 #include <string>
 
 #include "common/common/fancy_logger.h"
+#include "common/common/lock_guard.h"
 #include "common/common/logger.h"
+#include "common/common/logger_delegates.h"
+#include "common/common/thread.h"
+
+#include "test/test_common/thread_factory_for_test.h"
 
 #include "benchmark/benchmark.h"
 
@@ -111,6 +117,59 @@ static void envoyLevelSetting(benchmark::State& state) {
   }
 }
 
+/**
+ * Sink delegate which takes a lock for each line, as the stderr and file delegates do, and then
+ * discards it.
+ */
+class LockingNullSinkDelegate : public Logger::SinkDelegate {
+public:
+  explicit LockingNullSinkDelegate(Logger::DelegatingLogSinkSharedPtr log_sink)
+      : SinkDelegate(log_sink) {
+    setDelegate();
+  }
+  ~LockingNullSinkDelegate() override { restoreDelegate(); }
+
+  // Logger::SinkDelegate
+  void log(absl::string_view msg) override {
+    Thread::LockGuard guard(lock_);
+    benchmark::DoNotOptimize(msg.data());
+  }
+  void flush() override {}
+
+private:
+  Thread::MutexBasicLockable lock_;
+};
+
+/**
+ * Benchmark for the contention of ENVOY_LOG between threads, which write their lines to the sink
+ * synchronously, or queue them for an AsyncSinkDelegate when range(0) is set.
+ */
+static void envoyContended(benchmark::State& state) {
+  static std::unique_ptr<LockingNullSinkDelegate> null_sink;
+  static std::unique_ptr<Logger::AsyncSinkDelegate> async_sink;
+  if (state.thread_index == 0) {
+    GET_MISC_LOGGER().set_level(spdlog::level::trace);
+    null_sink = std::make_unique<LockingNullSinkDelegate>(Logger::Registry::getSink());
+    if (state.range(0)) {
+      async_sink = std::make_unique<Logger::AsyncSinkDelegate>(
+          Thread::threadFactoryForTest(), 1 << 20, Logger::Registry::getSink());
+    }
+  }
+  std::string msg(100, '.');
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    ENVOY_LOG_MISC(trace, "Contended: {}", msg);
+  }
+  if (state.thread_index == 0) {
+    if (async_sink != nullptr) {
+      state.counters["dropped"] = async_sink->droppedLines();
+    }
+    async_sink.reset();
+    null_sink.reset();
+    GET_MISC_LOGGER().set_level(spdlog::level::info);
+  }
+}
+
 /**
  * Benchmarks in detail starts.
  */
@@ -133,6 +192,9 @@ BENCHMARK(envoyNormal)->Args({1 << 10, 1})->Threads(20)->MeasureProcessCPUTime()
 BENCHMARK(envoyNormal)->Args({1 << 10, 0})->Threads(200)->MeasureProcessCPUTime();
 BENCHMARK(envoyNormal)->Args({1 << 10, 1})->Threads(200)->MeasureProcessCPUTime();
 
+BENCHMARK(envoyContended)->Arg(0)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(envoyContended)->Arg(1)->ThreadRange(1, 16)->UseRealTime();
+
 BENCHMARK(fancyLevelSetting)->Arg(1 << 10);
 BENCHMARK(envoyLevelSetting)->Arg(1 << 10);
 
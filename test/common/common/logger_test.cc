@@ -1,7 +1,11 @@
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/common/logger.h"
+#include "common/common/logger_delegates.h"
+
+#include "test/test_common/thread_factory_for_test.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -81,5 +85,110 @@ TEST_F(LoggerCustomFlagsTest, LogMessageAsEscaped) {
   expectLogMessage("%_", "\n\nmessage\n\n", "\\n\\nmessage\\n\\n");
 }
 
+// Records the lines and the flushes it is given, without forwarding them.
+class RecordingSinkDelegate : public SinkDelegate {
+public:
+  explicit RecordingSinkDelegate(DelegatingLogSinkSharedPtr log_sink) : SinkDelegate(log_sink) {
+    setDelegate();
+  }
+  ~RecordingSinkDelegate() override { restoreDelegate(); }
+
+  // SinkDelegate
+  void log(absl::string_view msg) override {
+    absl::MutexLock lock(&mutex_);
+    lines_.emplace_back(msg);
+  }
+  void flush() override {
+    absl::MutexLock lock(&mutex_);
+    ++flushes_;
+  }
+
+  std::vector<std::string> lines() {
+    absl::MutexLock lock(&mutex_);
+    return lines_;
+  }
+  uint32_t flushes() {
+    absl::MutexLock lock(&mutex_);
+    return flushes_;
+  }
+
+private:
+  absl::Mutex mutex_;
+  std::vector<std::string> lines_ ABSL_GUARDED_BY(mutex_);
+  uint32_t flushes_ ABSL_GUARDED_BY(mutex_){};
+};
+
+class AsyncSinkDelegateTest : public testing::Test {
+protected:
+  AsyncSinkDelegateTest() : recording_(Registry::getSink()) {}
+
+  RecordingSinkDelegate recording_;
+};
+
+// The lines of each thread are written in order, and flush waits for them.
+TEST_F(AsyncSinkDelegateTest, LinesOfAllThreads) {
+  AsyncSinkDelegate async(Thread::threadFactoryForTest(), 4096, Registry::getSink());
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t t = 0; t < 4; ++t) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([&async, t]() {
+      for (uint32_t i = 0; i < 100; ++i) {
+        async.log(fmt::format("{} {}\n", t, i));
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  async.flush();
+  EXPECT_EQ(1, recording_.flushes());
+
+  std::vector<uint32_t> next(4);
+  for (const std::string& line : recording_.lines()) {
+    uint32_t t;
+    uint32_t i;
+    ASSERT_EQ(2, sscanf(line.c_str(), "%u %u\n", &t, &i));
+    EXPECT_EQ(next[t]++, i);
+  }
+  EXPECT_EQ(std::vector<uint32_t>(4, 100), next);
+  EXPECT_EQ(0, async.droppedLines());
+}
+
+// The lines wrap around the end of the ring buffer.
+TEST_F(AsyncSinkDelegateTest, WrapAround) {
+  AsyncSinkDelegate async(Thread::threadFactoryForTest(), 64, Registry::getSink());
+  std::vector<std::string> expected;
+  for (uint32_t i = 0; i < 20; ++i) {
+    expected.push_back(fmt::format("line {}{}\n", i, std::string(i, '.')));
+    async.log(expected.back());
+    async.flush();
+  }
+  EXPECT_EQ(expected, recording_.lines());
+}
+
+// The lines which do not fit in the ring buffer are counted, and reported.
+TEST_F(AsyncSinkDelegateTest, Dropped) {
+  AsyncSinkDelegate async(Thread::threadFactoryForTest(), 64, Registry::getSink());
+  async.log(std::string(100, 'a'));
+  async.log("fits\n");
+  async.flush();
+  EXPECT_EQ(1, async.droppedLines());
+  EXPECT_THAT(recording_.lines(),
+              testing::ElementsAre("fits\n", testing::HasSubstr("dropped 1 log lines")));
+}
+
+// The lines are written when the delegate is destroyed, and the logging goes back to the
+// previous delegate.
+TEST_F(AsyncSinkDelegateTest, DrainOnDestruction) {
+  {
+    AsyncSinkDelegate async(Thread::threadFactoryForTest(), 4096, Registry::getSink());
+    ENVOY_LOG_MISC(critical, "queued");
+  }
+  ENVOY_LOG_MISC(critical, "direct");
+  const std::vector<std::string> lines = recording_.lines();
+  ASSERT_EQ(2, lines.size());
+  EXPECT_THAT(lines[0], testing::HasSubstr("queued"));
+  EXPECT_THAT(lines[1], testing::HasSubstr("direct"));
+}
+
 } // namespace Logger
 } // namespace Envoy
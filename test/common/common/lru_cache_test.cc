@@ -0,0 +1,90 @@
+#include <memory>
+#include <string>
+
+#include "common/common/lru_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+TEST(LruCacheTest, FindAndInsert) {
+  LruCache<std::string, int> cache(2);
+  EXPECT_EQ(nullptr, cache.find("a"));
+  EXPECT_TRUE(cache.insert("a", 1));
+  ASSERT_NE(nullptr, cache.find("a"));
+  EXPECT_EQ(1, *cache.find("a"));
+
+  // Inserting a key again replaces its value.
+  EXPECT_TRUE(cache.insert("a", 2));
+  EXPECT_EQ(2, *cache.find("a"));
+  EXPECT_EQ(1U, cache.size());
+  EXPECT_EQ(1U, cache.cost());
+
+  // The value may be updated in place.
+  *cache.find("a") = 3;
+  EXPECT_EQ(3, *cache.find("a"));
+}
+
+// Once full, the least recently used entry is evicted, and a lookup marks an entry as used.
+TEST(LruCacheTest, EvictLeastRecentlyUsed) {
+  LruCache<std::string, int> cache(2);
+  cache.insert("a", 1);
+  cache.insert("b", 2);
+  EXPECT_NE(nullptr, cache.find("a"));
+  cache.insert("c", 3);
+  EXPECT_EQ(2U, cache.size());
+  EXPECT_NE(nullptr, cache.find("a"));
+  EXPECT_EQ(nullptr, cache.find("b"));
+  EXPECT_NE(nullptr, cache.find("c"));
+
+  // Replacing an entry uses it too.
+  cache.insert("a", 4);
+  cache.insert("d", 5);
+  EXPECT_NE(nullptr, cache.find("a"));
+  EXPECT_EQ(nullptr, cache.find("c"));
+}
+
+// The entries are evicted until the cost of the new one fits, and an entry that can never fit is
+// not inserted.
+TEST(LruCacheTest, Cost) {
+  LruCache<std::string, std::string> cache(10);
+  EXPECT_TRUE(cache.insert("a", "", 4));
+  EXPECT_TRUE(cache.insert("b", "", 4));
+  EXPECT_EQ(8U, cache.cost());
+  EXPECT_TRUE(cache.insert("c", "", 6));
+  EXPECT_EQ(nullptr, cache.find("a"));
+  EXPECT_EQ(10U, cache.cost());
+  EXPECT_TRUE(cache.insert("d", "", 8));
+  EXPECT_EQ(nullptr, cache.find("b"));
+  EXPECT_EQ(nullptr, cache.find("c"));
+  EXPECT_EQ(8U, cache.cost());
+
+  EXPECT_FALSE(cache.insert("e", "", 11));
+  EXPECT_NE(nullptr, cache.find("d"));
+  EXPECT_EQ(8U, cache.cost());
+
+  // Replacing an entry replaces its cost.
+  EXPECT_TRUE(cache.insert("d", "", 2));
+  EXPECT_EQ(2U, cache.cost());
+}
+
+TEST(LruCacheTest, EraseAndClear) {
+  LruCache<std::string, std::unique_ptr<int>> cache(3);
+  cache.insert("a", std::make_unique<int>(1));
+  cache.insert("b", std::make_unique<int>(2));
+  EXPECT_TRUE(cache.erase("a"));
+  EXPECT_FALSE(cache.erase("a"));
+  EXPECT_EQ(1U, cache.size());
+  EXPECT_EQ(1U, cache.cost());
+
+  cache.clear();
+  EXPECT_EQ(0U, cache.size());
+  EXPECT_EQ(0U, cache.cost());
+  EXPECT_EQ(nullptr, cache.find("b"));
+  cache.insert("c", std::make_unique<int>(3));
+  EXPECT_EQ(3, **cache.find("c"));
+}
+
+} // namespace
+} // namespace Envoy
@@ -0,0 +1,98 @@
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "common/common/mpsc_queue.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+TEST(MpscQueueTest, Fifo) {
+  MpscQueue<int> queue;
+  int value;
+  EXPECT_FALSE(queue.pop(value));
+  queue.push(1);
+  queue.push(2);
+  EXPECT_TRUE(queue.pop(value));
+  EXPECT_EQ(1, value);
+  queue.push(3);
+  EXPECT_TRUE(queue.pop(value));
+  EXPECT_EQ(2, value);
+  EXPECT_TRUE(queue.pop(value));
+  EXPECT_EQ(3, value);
+  EXPECT_FALSE(queue.pop(value));
+}
+
+// The elements left in the queue are destroyed with it.
+TEST(MpscQueueTest, DestroyNonEmpty) {
+  auto counted = std::make_shared<int>(0);
+  {
+    MpscQueue<std::shared_ptr<int>> queue;
+    queue.push(std::shared_ptr<int>(counted));
+    queue.push(std::shared_ptr<int>(counted));
+    EXPECT_EQ(3, counted.use_count());
+  }
+  EXPECT_EQ(1, counted.use_count());
+}
+
+// A value which counts its live instances.
+class Counted {
+public:
+  Counted() { ++live_; }
+  Counted(Counted&&) noexcept { ++live_; }
+  Counted& operator=(Counted&&) noexcept = default;
+  ~Counted() { --live_; }
+
+  static int live_;
+};
+int Counted::live_ = 0;
+
+// The node of the last popped element, which is the stub of the queue afterwards, is freed with
+// the queue.
+TEST(MpscQueueTest, DestroyAfterPop) {
+  {
+    MpscQueue<Counted> queue;
+    queue.push(Counted());
+    queue.push(Counted());
+    Counted value;
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_FALSE(queue.pop(value));
+  }
+  EXPECT_EQ(0, Counted::live_);
+}
+
+// Each producer pushes its elements in order, which the consumer must pop in the same order
+// relative to each other.
+TEST(MpscQueueTest, MultipleProducers) {
+  constexpr int num_producers = 4;
+  constexpr int num_values = 10000;
+  MpscQueue<std::pair<int, int>> queue;
+  std::vector<std::thread> producers;
+  for (int producer = 0; producer < num_producers; ++producer) {
+    producers.emplace_back([&queue, producer]() {
+      for (int i = 0; i < num_values; ++i) {
+        queue.push({producer, i});
+      }
+    });
+  }
+
+  std::vector<int> next(num_producers, 0);
+  int popped = 0;
+  std::pair<int, int> value;
+  while (popped < num_producers * num_values) {
+    if (queue.pop(value)) {
+      EXPECT_EQ(next[value.first]++, value.second);
+      ++popped;
+    }
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  EXPECT_FALSE(queue.pop(value));
+}
+
+} // namespace
+} // namespace Envoy
@@ -0,0 +1,69 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/common/radix_tree.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+// Returns the values of the keys that are prefixes of a string, with the size of their key.
+std::vector<std::pair<std::string, size_t>> prefixes(const RadixTree<std::string>& tree,
+                                                     absl::string_view s) {
+  std::vector<std::pair<std::string, size_t>> values;
+  tree.walk(
+      s.size(), [s](size_t position) { return s[position]; },
+      [&values](const std::string& value, size_t size) {
+        if (!value.empty()) {
+          values.emplace_back(value, size);
+        }
+        return true;
+      });
+  return values;
+}
+
+TEST(RadixTreeTest, FindOrCreate) {
+  RadixTree<std::string> tree;
+  tree.findOrCreate("abc") = "abc";
+  EXPECT_EQ("abc", tree.findOrCreate("abc"));
+  // Splits the edge of "abc".
+  tree.findOrCreate("ab") = "ab";
+  // Branches off from the node of "ab".
+  tree.findOrCreate("abd") = "abd";
+  tree.findOrCreate("") = "root";
+  EXPECT_EQ("ab", tree.findOrCreate("ab"));
+  EXPECT_EQ("abc", tree.findOrCreate("abc"));
+  EXPECT_EQ("abd", tree.findOrCreate("abd"));
+  EXPECT_EQ("root", tree.findOrCreate(""));
+  EXPECT_EQ("", tree.findOrCreate("a"));
+}
+
+TEST(RadixTreeTest, Walk) {
+  RadixTree<std::string> tree;
+  tree.findOrCreate("a") = "a";
+  tree.findOrCreate("abc") = "abc";
+  tree.findOrCreate("abd") = "abd";
+
+  using Values = std::vector<std::pair<std::string, size_t>>;
+  EXPECT_EQ((Values{{"a", 1}, {"abc", 3}}), prefixes(tree, "abcd"));
+  EXPECT_EQ((Values{{"a", 1}, {"abd", 3}}), prefixes(tree, "abd"));
+  EXPECT_EQ((Values{{"a", 1}}), prefixes(tree, "ab"));
+  EXPECT_EQ((Values{{"a", 1}}), prefixes(tree, "abe"));
+  EXPECT_EQ(Values{}, prefixes(tree, "b"));
+  EXPECT_EQ(Values{}, prefixes(tree, ""));
+
+  // The walk stops once the visitor returns false.
+  std::vector<size_t> visited;
+  tree.walk(
+      4, [](size_t position) { return "abcd"[position]; },
+      [&visited](const std::string&, size_t size) {
+        visited.push_back(size);
+        return size < 1;
+      });
+  EXPECT_EQ((std::vector<size_t>{0, 1}), visited);
+}
+
+} // namespace
+} // namespace Envoy
@@ -2,8 +2,12 @@
 // a quiescent system with disabled cstate power management.
 
 #include <regex>
+#include <vector>
+
+#include "envoy/type/matcher/v3/regex.pb.h"
 
 #include "common/common/assert.h"
+#include "common/common/regex.h"
 
 #include "absl/strings/string_view.h"
 #include "benchmark/benchmark.h"
@@ -126,3 +130,77 @@ static void BM_RE2_AltPattern(benchmark::State& state) {
   RELEASE_ASSERT(passes > 0, "");
 }
 BENCHMARK(BM_RE2_AltPattern);
+
+// The patterns of a stats inclusion list, which most of the names do not match.
+static const char* StatPatterns[] = {
+    "cluster\\.[^.]+\\.upstream_rq_[0-9]xx",
+    "cluster\\.[^.]+\\.upstream_cx_active",
+    "http\\.[^.]+\\.downstream_rq_time",
+    "listener\\.[^.]+\\.downstream_cx_total",
+    "vhost\\.[^.]+\\.vcluster\\.[^.]+\\.upstream_rq_.*",
+    "server\\.(uptime|live|state)",
+    "runtime\\..*",
+    "tls_inspector\\..*",
+};
+
+static const char* StatNames[] = {
+    "cluster.service_a.upstream_rq_2xx",
+    "cluster.service_a.upstream_rq_completed",
+    "http.ingress_http.downstream_rq_total",
+    "listener.0.0.0.0_443.ssl.handshake",
+    "vhost.api.vcluster.other.upstream_rq_retry",
+    "server.memory_allocated",
+};
+
+static std::vector<envoy::type::matcher::v3::RegexMatcher> statRegexConfigs() {
+  std::vector<envoy::type::matcher::v3::RegexMatcher> configs;
+  for (const char* pattern : StatPatterns) {
+    configs.emplace_back();
+    configs.back().mutable_google_re2();
+    configs.back().set_regex(pattern);
+  }
+  return configs;
+}
+
+// Each regex of the list scans the names.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_CompiledMatcherList(benchmark::State& state) {
+  std::vector<Envoy::Regex::CompiledMatcherPtr> matchers;
+  for (const auto& config : statRegexConfigs()) {
+    matchers.push_back(Envoy::Regex::Utility::parseRegex(config));
+  }
+  uint32_t passes = 0;
+  for (auto _ : state) { // NOLINT
+    for (const char* stat_name : StatNames) {
+      for (const auto& matcher : matchers) {
+        if (matcher->match(stat_name)) {
+          ++passes;
+          break;
+        }
+      }
+    }
+  }
+  RELEASE_ASSERT(passes > 0, "");
+}
+BENCHMARK(BM_CompiledMatcherList);
+
+// The regexes of the list scan the names at once.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_CompiledMatcherSet(benchmark::State& state) {
+  const auto configs = statRegexConfigs();
+  std::vector<const envoy::type::matcher::v3::RegexMatcher*> pointers;
+  for (const auto& config : configs) {
+    pointers.push_back(&config);
+  }
+  const Envoy::Regex::CompiledMatcherSetPtr set = Envoy::Regex::Utility::parseRegexSet(pointers);
+  uint32_t passes = 0;
+  for (auto _ : state) { // NOLINT
+    for (const char* stat_name : StatNames) {
+      if (set->matchAny(stat_name)) {
+        ++passes;
+      }
+    }
+  }
+  RELEASE_ASSERT(passes > 0, "");
+}
+BENCHMARK(BM_CompiledMatcherSet);
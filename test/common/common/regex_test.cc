@@ -1,3 +1,5 @@
+#include <vector>
+
 #include "envoy/common/exception.h"
 #include "envoy/type/matcher/v3/regex.pb.h"
 
@@ -157,6 +159,42 @@ TEST(Utility, ParseRegex) {
   }
 }
 
+TEST(Utility, ParseRegexSet) {
+  std::vector<envoy::type::matcher::v3::RegexMatcher> configs(3);
+  configs[0].set_regex("/asdf/.*");
+  configs[1].set_regex(".*\\.json");
+  configs[2].set_regex("/asdf/[0-9]+");
+  std::vector<const envoy::type::matcher::v3::RegexMatcher*> matchers;
+  for (auto& config : configs) {
+    config.mutable_google_re2();
+    matchers.push_back(&config);
+  }
+  const auto set = Utility::parseRegexSet(matchers);
+
+  // The regexes match the whole value, as with parseRegex().
+  EXPECT_TRUE(set->matchAny("/asdf/a.json"));
+  EXPECT_EQ((std::vector<uint32_t>{0, 1}), set->matches("/asdf/a.json"));
+  EXPECT_EQ((std::vector<uint32_t>{0, 2}), set->matches("/asdf/123"));
+  EXPECT_EQ((std::vector<uint32_t>{1}), set->matches("/a.json"));
+  EXPECT_FALSE(set->matchAny("/a.json.gz"));
+  EXPECT_TRUE(set->matches("/a.json.gz").empty());
+  EXPECT_FALSE(set->matchAny("x/asdf/"));
+
+  configs[1].set_regex("(+invalid)");
+  EXPECT_THROW_WITH_MESSAGE(Utility::parseRegexSet(matchers), EnvoyException,
+                            "no argument for repetition operator: +");
+
+  // The program size of each regex is checked.
+  {
+    TestScopedRuntime scoped_runtime;
+    Runtime::LoaderSingleton::getExisting()->mergeValues(
+        {{"re2.max_program_size.error_level", "1"}});
+    configs[1].set_regex(".*");
+    EXPECT_THROW_WITH_REGEX(Utility::parseRegexSet(matchers), EnvoyException,
+                            "max program size of 1 set for the error level threshold");
+  }
+}
+
 } // namespace
 } // namespace Regex
 } // namespace Envoy
@@ -0,0 +1,86 @@
+#include <string>
+#include <vector>
+
+#include "common/common/stage_trace.h"
+#include "common/common/thread.h"
+#include "common/json/json_loader.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+class StageTraceTest : public testing::Test {
+protected:
+  StageTraceTest() { StageTrace::clear(); }
+  ~StageTraceTest() override { StageTrace::setEnabled(false); }
+
+  // Returns the instant events of the trace with a name.
+  static std::vector<Json::ObjectSharedPtr> events(absl::string_view name) {
+    std::vector<Json::ObjectSharedPtr> events;
+    for (const auto& event :
+         Json::Factory::loadFromString(StageTrace::chromeTrace())->getObjectArray("traceEvents")) {
+      if (event->getString("ph") == "i" && event->getString("name") == name) {
+        events.push_back(event);
+      }
+    }
+    return events;
+  }
+};
+
+// Nothing is recorded while stage tracing is disabled.
+TEST_F(StageTraceTest, Disabled) {
+  EXPECT_FALSE(StageTrace::enabled());
+  STAGE_TRACE(StageTrace::Stage::Accept, 1, 0);
+  EXPECT_TRUE(events("accept").empty());
+}
+
+// The stages are recorded per thread, with the names of the threads.
+TEST_F(StageTraceTest, RecordPerThread) {
+  StageTrace::setEnabled(true);
+  STAGE_TRACE(StageTrace::Stage::HeadersDecoded, 1, 2);
+  Thread::ThreadPtr thread = Thread::threadFactoryForTest().createThread(
+      []() { STAGE_TRACE(StageTrace::Stage::UpstreamConnected, 1, 2); },
+      Thread::Options{"stage-thread"});
+  thread->join();
+  STAGE_TRACE(StageTrace::Stage::UpstreamFirstByte, 1, 2);
+
+  const auto decoded = events("headers_decoded");
+  ASSERT_EQ(1, decoded.size());
+  EXPECT_EQ(1, decoded[0]->getObject("args")->getInteger("connection"));
+  EXPECT_EQ(2, decoded[0]->getObject("args")->getInteger("stream"));
+  const auto first_byte = events("upstream_first_byte");
+  ASSERT_EQ(1, first_byte.size());
+  EXPECT_EQ(decoded[0]->getInteger("tid"), first_byte[0]->getInteger("tid"));
+  EXPECT_LE(decoded[0]->getDouble("ts"), first_byte[0]->getDouble("ts"));
+
+  // The records of a thread go away with it.
+  EXPECT_TRUE(events("upstream_connected").empty());
+}
+
+// Only the most recent records of a thread are kept, and clearing drops them.
+TEST_F(StageTraceTest, RingAndClear) {
+  StageTrace::setEnabled(true);
+  for (uint32_t i = 0; i < StageTrace::RingCapacity + 10; ++i) {
+    STAGE_TRACE(StageTrace::Stage::RouteSelected, 1, i);
+  }
+  const auto selected = events("route_selected");
+  ASSERT_EQ(StageTrace::RingCapacity, selected.size());
+
+  StageTrace::setEnabled(false);
+  STAGE_TRACE(StageTrace::Stage::RouteSelected, 1, 0);
+  EXPECT_EQ(StageTrace::RingCapacity, events("route_selected").size());
+
+  StageTrace::clear();
+  EXPECT_TRUE(events("route_selected").empty());
+}
+
+TEST(StageTraceNameTest, StageName) {
+  EXPECT_EQ("accept", StageTrace::stageName(StageTrace::Stage::Accept));
+  EXPECT_EQ("tls_handshake", StageTrace::stageName(StageTrace::Stage::TlsHandshake));
+}
+
+} // namespace
+} // namespace Envoy
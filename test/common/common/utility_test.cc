@@ -949,6 +949,47 @@ TEST(TrieLookupTable, LongestPrefix) {
   EXPECT_EQ(nullptr, trie.findLongestPrefix(" "));
 }
 
+TEST(PerfectHashLookupTable, AddItems) {
+  PerfectHashLookupTable<const char*> table;
+  const char* cstr_a = "a";
+  const char* cstr_b = "b";
+  const char* cstr_c = "c";
+
+  table.add("foo", cstr_a);
+  table.add("bar", cstr_b);
+  // Adding an existing key replaces its value.
+  table.add("baro", cstr_a);
+  table.add("baro", cstr_c);
+  table.finalize();
+
+  EXPECT_EQ(cstr_a, table.find("foo"));
+  EXPECT_EQ(cstr_b, table.find("bar"));
+  EXPECT_EQ(cstr_c, table.find("baro"));
+  EXPECT_EQ(nullptr, table.find("ba"));
+  EXPECT_EQ(nullptr, table.find("foobar"));
+  EXPECT_EQ(nullptr, table.find(""));
+}
+
+TEST(PerfectHashLookupTable, Empty) {
+  PerfectHashLookupTable<const char*> table;
+  table.finalize();
+  EXPECT_EQ(nullptr, table.find("foo"));
+  EXPECT_EQ(nullptr, table.find(""));
+}
+
+TEST(PerfectHashLookupTable, ManyKeysWithCommonPrefixes) {
+  PerfectHashLookupTable<uint64_t> table;
+  for (uint64_t i = 1; i <= 500; ++i) {
+    table.add(absl::StrCat("x-envoy-header-", i), i);
+  }
+  table.finalize();
+  for (uint64_t i = 1; i <= 500; ++i) {
+    EXPECT_EQ(i, table.find(absl::StrCat("x-envoy-header-", i)));
+  }
+  EXPECT_EQ(0, table.find("x-envoy-header-0"));
+  EXPECT_EQ(0, table.find("x-envoy-header-501"));
+}
+
 TEST(InlineStorageTest, InlineString) {
   InlineStringPtr hello = InlineString::create("Hello, world!");
   EXPECT_EQ("Hello, world!", hello->toStringView());
@@ -1,4 +1,7 @@
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "envoy/api/v2/discovery.pb.h"
 #include "envoy/config/endpoint/v3/endpoint.pb.h"
@@ -21,6 +24,7 @@
 #include "test/mocks/grpc/mocks.h"
 #include "test/mocks/local_info/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/test_common/environment.h"
 #include "test/test_common/logging.h"
 #include "test/test_common/resources.h"
 #include "test/test_common/simulated_time_system.h"
@@ -551,6 +555,322 @@ TEST_F(GrpcMuxImplTest, WatchDemux) {
   expectSendMessage(type_url, {}, "2");
 }
 
+// The resources that the last accepted update had already are shared rather than decoded again.
+TEST_F(GrpcMuxImplTest, MemoizeResourceDecoding) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.memoize_sotw_resource_decoding", "true"}});
+  setup();
+
+  InSequence s;
+  TestUtility::TestOpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment>
+      resource_decoder("cluster_name");
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  auto foo_sub = grpc_mux_->addWatch(type_url, {}, callbacks_, resource_decoder);
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {}, "", true);
+  grpc_mux_->start();
+
+  // Sends an update of x and y, y having the given endpoint count, and returns their messages.
+  std::vector<const Protobuf::Message*> messages;
+  const auto send = [&](const std::string& version, uint32_t y_endpoints, bool reject) {
+    auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+    response->set_type_url(type_url);
+    response->set_version_info(version);
+    envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+    load_assignment.set_cluster_name("x");
+    response->add_resources()->PackFrom(load_assignment);
+    load_assignment.set_cluster_name("y");
+    for (uint32_t i = 0; i < y_endpoints; ++i) {
+      load_assignment.add_endpoints();
+    }
+    response->add_resources()->PackFrom(load_assignment);
+    messages.clear();
+    EXPECT_CALL(callbacks_, onConfigUpdate(_, version))
+        .WillOnce(Invoke([&messages, reject](const std::vector<DecodedResourceRef>& resources,
+                                             const std::string&) {
+          for (const auto& resource : resources) {
+            messages.push_back(&resource.get().resource());
+          }
+          if (reject) {
+            throw EnvoyException("rejected");
+          }
+        }));
+    if (reject) {
+      EXPECT_CALL(callbacks_, onConfigUpdateFailed(_, _));
+      expectSendMessage(type_url, {}, "1", false, "", Grpc::Status::WellKnownGrpcStatus::Internal,
+                        "rejected");
+    } else {
+      expectSendMessage(type_url, {}, version);
+    }
+    grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
+    EXPECT_EQ(2, messages.size());
+  };
+
+  send("1", 1, false);
+  const std::vector<const Protobuf::Message*> accepted = messages;
+  // x is unchanged and shared, y is decoded again.
+  send("2", 2, true);
+  EXPECT_EQ(accepted[0], messages[0]);
+  EXPECT_NE(accepted[1], messages[1]);
+  // The resources of rejected updates are not memoized.
+  send("3", 2, false);
+  EXPECT_EQ(accepted[0], messages[0]);
+  const Protobuf::Message* y = messages[1];
+  send("4", 2, false);
+  EXPECT_EQ(accepted[0], messages[0]);
+  EXPECT_EQ(y, messages[1]);
+
+  expectSendMessage(type_url, {}, "4");
+}
+
+// The snapshot of a type is applied once it is subscribed to, and accepted responses replace it.
+TEST_F(GrpcMuxImplTest, Snapshots) {
+  const std::string directory = TestEnvironment::temporaryPath("grpc_mux_impl_test_snapshots");
+  TestEnvironment::removePath(directory);
+  TestEnvironment::createPath(directory);
+  Api::ApiPtr api = Api::createApiForTest();
+  ResourceSnapshotStore store(api->fileSystem(), directory);
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  envoy::service::discovery::v3::DiscoveryResponse snapshot;
+  snapshot.set_type_url(type_url);
+  snapshot.set_version_info("1");
+  envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+  load_assignment.set_cluster_name("x");
+  snapshot.add_resources()->PackFrom(load_assignment);
+  store.save(type_url, snapshot);
+
+  setup();
+  auto* apply_snapshots = new Event::MockSchedulableCallback(&dispatcher_);
+  grpc_mux_->enableSnapshots(api->fileSystem(), directory);
+
+  InSequence s;
+  TestUtility::TestOpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment>
+      resource_decoder("cluster_name");
+  EXPECT_CALL(*apply_snapshots, scheduleCallbackCurrentIteration());
+  auto foo_sub = grpc_mux_->addWatch(type_url, {"x"}, callbacks_, resource_decoder);
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {"x"}, "", true);
+  grpc_mux_->start();
+
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, "1"))
+      .WillOnce(Invoke([&load_assignment](const std::vector<DecodedResourceRef>& resources,
+                                          const std::string&) {
+        EXPECT_EQ(1, resources.size());
+        EXPECT_TRUE(TestUtility::protoEqual(resources[0].get().resource(), load_assignment));
+      }));
+  expectSendMessage(type_url, {"x"}, "1");
+  apply_snapshots->invokeCallback();
+
+  auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>(snapshot);
+  response->set_version_info("2");
+  response->set_nonce("nonce");
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, "2"));
+  expectSendMessage(type_url, {"x"}, "2", false, "nonce");
+  grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
+  EXPECT_EQ("2", store.load(type_url)->version_info());
+
+  expectSendMessage(type_url, {}, "2", false, "nonce");
+  foo_sub.reset();
+  TestEnvironment::removePath(directory);
+}
+
+// The snapshot of named watches keeps the resources that a response leaves out.
+TEST_F(GrpcMuxImplTest, SnapshotsMergeResourcesByName) {
+  const std::string directory = TestEnvironment::temporaryPath("grpc_mux_impl_test_snapshots");
+  TestEnvironment::removePath(directory);
+  TestEnvironment::createPath(directory);
+  Api::ApiPtr api = Api::createApiForTest();
+  ResourceSnapshotStore store(api->fileSystem(), directory);
+
+  setup();
+  auto* apply_snapshots = new Event::MockSchedulableCallback(&dispatcher_);
+  grpc_mux_->enableSnapshots(api->fileSystem(), directory);
+
+  InSequence s;
+  TestUtility::TestOpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment>
+      resource_decoder("cluster_name");
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  EXPECT_CALL(*apply_snapshots, scheduleCallbackCurrentIteration()).Times(2);
+  NiceMock<MockSubscriptionCallbacks> foo_callbacks;
+  auto foo_sub = grpc_mux_->addWatch(type_url, {"x"}, foo_callbacks, resource_decoder);
+  NiceMock<MockSubscriptionCallbacks> bar_callbacks;
+  auto bar_sub = grpc_mux_->addWatch(type_url, {"y"}, bar_callbacks, resource_decoder);
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {"y", "x"}, "", true);
+  grpc_mux_->start();
+  // There is no snapshot to apply yet.
+  apply_snapshots->invokeCallback();
+
+  const auto send = [&](const std::string& version, const std::vector<std::string>& clusters) {
+    auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+    response->set_type_url(type_url);
+    response->set_version_info(version);
+    for (const std::string& cluster : clusters) {
+      envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+      load_assignment.set_cluster_name(cluster);
+      response->add_resources()->PackFrom(load_assignment);
+    }
+    expectSendMessage(type_url, {"y", "x"}, version);
+    grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
+  };
+  send("1", {"x", "y"});
+  // The response only carries x, which leaves y current.
+  send("2", {"x"});
+
+  const auto snapshot = store.load(type_url);
+  ASSERT_NE(nullptr, snapshot);
+  EXPECT_EQ("2", snapshot->version_info());
+  std::vector<std::string> clusters;
+  for (const auto& resource : snapshot->resources()) {
+    envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+    resource.UnpackTo(&load_assignment);
+    clusters.push_back(load_assignment.cluster_name());
+  }
+  EXPECT_EQ((std::vector<std::string>{"x", "y"}), clusters);
+
+  expectSendMessage(type_url, {"x"}, "2");
+  expectSendMessage(type_url, {}, "2");
+  bar_sub.reset();
+  foo_sub.reset();
+  TestEnvironment::removePath(directory);
+}
+
+// The last accepted response of each type is kept to be handed over on hot restart.
+TEST_F(GrpcMuxImplTest, HandoffResponses) {
+  setup();
+  grpc_mux_->enableHandoff();
+  EXPECT_TRUE(grpc_mux_->handoffResponses().empty());
+
+  InSequence s;
+  TestUtility::TestOpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment>
+      resource_decoder("cluster_name");
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  auto foo_sub = grpc_mux_->addWatch(type_url, {"x"}, callbacks_, resource_decoder);
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {"x"}, "", true);
+  grpc_mux_->start();
+
+  auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+  response->set_type_url(type_url);
+  response->set_version_info("1");
+  response->set_nonce("nonce");
+  envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+  load_assignment.set_cluster_name("x");
+  response->add_resources()->PackFrom(load_assignment);
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, "1"));
+  expectSendMessage(type_url, {"x"}, "1", false, "nonce");
+  grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
+
+  const std::vector<envoy::service::discovery::v3::DiscoveryResponse> handoff =
+      grpc_mux_->handoffResponses();
+  ASSERT_EQ(1, handoff.size());
+  EXPECT_EQ(type_url, handoff[0].type_url());
+  EXPECT_EQ("1", handoff[0].version_info());
+  EXPECT_TRUE(handoff[0].nonce().empty());
+  ASSERT_EQ(1, handoff[0].resources_size());
+
+  expectSendMessage(type_url, {}, "1", false, "nonce");
+}
+
+// The handoff keeps the resources of named watches that a response leaves out, until they are not
+// watched anymore.
+TEST_F(GrpcMuxImplTest, HandoffResponsesMergeResourcesByName) {
+  setup();
+  grpc_mux_->enableHandoff();
+
+  InSequence s;
+  TestUtility::TestOpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment>
+      resource_decoder("cluster_name");
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  NiceMock<MockSubscriptionCallbacks> foo_callbacks;
+  auto foo_sub = grpc_mux_->addWatch(type_url, {"x"}, foo_callbacks, resource_decoder);
+  NiceMock<MockSubscriptionCallbacks> bar_callbacks;
+  auto bar_sub = grpc_mux_->addWatch(type_url, {"y"}, bar_callbacks, resource_decoder);
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {"y", "x"}, "", true);
+  grpc_mux_->start();
+
+  const auto send = [&](const std::string& version, const std::vector<std::string>& clusters,
+                        const std::vector<std::string>& watched) {
+    auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+    response->set_type_url(type_url);
+    response->set_version_info(version);
+    for (const std::string& cluster : clusters) {
+      envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+      load_assignment.set_cluster_name(cluster);
+      load_assignment.mutable_policy()->mutable_overprovisioning_factor()->set_value(
+          std::stoi(version));
+      response->add_resources()->PackFrom(load_assignment);
+    }
+    expectSendMessage(type_url, watched, version);
+    grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
+  };
+  // Returns the overprovisioning factor of each handed off cluster, i.e. the version it was
+  // updated at.
+  const auto handoff = [&]() {
+    const std::vector<envoy::service::discovery::v3::DiscoveryResponse> responses =
+        grpc_mux_->handoffResponses();
+    EXPECT_EQ(1, responses.size());
+    std::map<std::string, uint32_t> versions;
+    for (const auto& resource : responses[0].resources()) {
+      envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+      resource.UnpackTo(&load_assignment);
+      versions[load_assignment.cluster_name()] =
+          load_assignment.policy().overprovisioning_factor().value();
+    }
+    return versions;
+  };
+
+  send("1", {"x", "y"}, {"y", "x"});
+  EXPECT_EQ((std::map<std::string, uint32_t>{{"x", 1}, {"y", 1}}), handoff());
+  // The response only carries x, which leaves y current.
+  send("2", {"x"}, {"y", "x"});
+  EXPECT_EQ((std::map<std::string, uint32_t>{{"x", 2}, {"y", 1}}), handoff());
+
+  expectSendMessage(type_url, {"x"}, "2");
+  bar_sub.reset();
+  send("3", {"x"}, {"x"});
+  EXPECT_EQ((std::map<std::string, uint32_t>{{"x", 3}}), handoff());
+
+  expectSendMessage(type_url, {}, "3");
+}
+
+// The responses handed over by the parent are applied once their type is subscribed to.
+TEST_F(GrpcMuxImplTest, ApplyHandoffResponses) {
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  std::vector<envoy::service::discovery::v3::DiscoveryResponse> handoff(1);
+  handoff[0].set_type_url(type_url);
+  handoff[0].set_version_info("1");
+  envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+  load_assignment.set_cluster_name("x");
+  handoff[0].add_resources()->PackFrom(load_assignment);
+
+  setup();
+  auto* apply_snapshots = new Event::MockSchedulableCallback(&dispatcher_);
+  grpc_mux_->applyHandoffResponses(std::move(handoff));
+
+  InSequence s;
+  TestUtility::TestOpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment>
+      resource_decoder("cluster_name");
+  EXPECT_CALL(*apply_snapshots, scheduleCallbackCurrentIteration());
+  auto foo_sub = grpc_mux_->addWatch(type_url, {"x"}, callbacks_, resource_decoder);
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {"x"}, "", true);
+  grpc_mux_->start();
+
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, "1"))
+      .WillOnce(Invoke([&load_assignment](const std::vector<DecodedResourceRef>& resources,
+                                          const std::string&) {
+        EXPECT_EQ(1, resources.size());
+        EXPECT_TRUE(TestUtility::protoEqual(resources[0].get().resource(), load_assignment));
+      }));
+  expectSendMessage(type_url, {"x"}, "1");
+  apply_snapshots->invokeCallback();
+
+  expectSendMessage(type_url, {}, "1");
+}
+
 // Validate behavior when we have multiple watchers that send empty updates.
 TEST_F(GrpcMuxImplTest, MultipleWatcherWithEmptyUpdates) {
   setup();
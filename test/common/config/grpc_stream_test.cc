@@ -1,5 +1,6 @@
 #include "envoy/service/discovery/v3/discovery.pb.h"
 
+#include "common/buffer/buffer_impl.h"
 #include "common/config/grpc_stream.h"
 #include "common/protobuf/protobuf.h"
 
@@ -102,13 +103,33 @@ TEST_F(GrpcStreamTest, ReceiveMessage) {
   auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>(response_copy);
   envoy::service::discovery::v3::DiscoveryResponse received_message;
   EXPECT_CALL(callbacks_, onDiscoveryResponse(_, _))
-      .WillOnce([&received_message](
-                    std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& message,
-                    ControlPlaneStats&) { received_message = *message; });
+      .WillOnce([&received_message](const envoy::service::discovery::v3::DiscoveryResponse& message,
+                                    ControlPlaneStats&) { received_message = message; });
   grpc_stream_.onReceiveMessage(std::move(response));
   EXPECT_TRUE(TestUtility::protoEqual(response_copy, received_message));
 }
 
+// Tests that the responses that the gRPC machinery passes as bytes are parsed, onto an arena, and
+// passed up to the GrpcStreamCallbacks, and that malformed ones are rejected.
+TEST_F(GrpcStreamTest, ReceiveMessageRaw) {
+  envoy::service::discovery::v3::DiscoveryResponse response;
+  response.set_type_url("faketypeURL");
+  response.add_resources()->set_value(std::string(1024, 'a'));
+  envoy::service::discovery::v3::DiscoveryResponse received_message;
+  EXPECT_CALL(callbacks_, onDiscoveryResponse(_, _))
+      .WillOnce([&received_message](const envoy::service::discovery::v3::DiscoveryResponse& message,
+                                    ControlPlaneStats&) {
+        EXPECT_NE(nullptr, message.GetArena());
+        received_message = message;
+      });
+  EXPECT_TRUE(grpc_stream_.onReceiveMessageRaw(
+      std::make_unique<Buffer::OwnedImpl>(response.SerializeAsString())));
+  EXPECT_TRUE(TestUtility::protoEqual(response, received_message));
+
+  EXPECT_CALL(callbacks_, onDiscoveryResponse(_, _)).Times(0);
+  EXPECT_FALSE(grpc_stream_.onReceiveMessageRaw(std::make_unique<Buffer::OwnedImpl>("\xff")));
+}
+
 // If the value has only ever been 0, the stat should remain unused, including after an attempt to
 // write a 0 to it.
 TEST_F(GrpcStreamTest, QueueSizeStat) {
@@ -135,7 +135,7 @@ public:
       expectSendMessage(last_cluster_names_, version_, false,
                         Grpc::Status::WellKnownGrpcStatus::Internal, "bad config");
     }
-    mux_->onDiscoveryResponse(std::move(response), control_plane_stats_);
+    mux_->onDiscoveryResponse(*response, control_plane_stats_);
     EXPECT_EQ(control_plane_stats_.identifier_.value(), "ground_control_foo123");
     Mock::VerifyAndClearExpectations(&async_stream_);
   }
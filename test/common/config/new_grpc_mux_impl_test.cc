@@ -93,7 +93,7 @@ TEST_F(NewGrpcMuxImplTest, DiscoveryResponseNonexistentSub) {
     unexpected_response->set_system_version_info("0");
     // empty response should call onConfigUpdate on wildcard watch
     EXPECT_CALL(callbacks_, onConfigUpdate(_, _, "0"));
-    grpc_mux_->onDiscoveryResponse(std::move(unexpected_response), control_plane_stats_);
+    grpc_mux_->onDiscoveryResponse(*unexpected_response, control_plane_stats_);
   }
   {
     auto response = std::make_unique<envoy::service::discovery::v3::DeltaDiscoveryResponse>();
@@ -110,7 +110,7 @@ TEST_F(NewGrpcMuxImplTest, DiscoveryResponseNonexistentSub) {
           EXPECT_TRUE(
               TestUtility::protoEqual(added_resources[0].get().resource(), load_assignment));
         }));
-    grpc_mux_->onDiscoveryResponse(std::move(response), control_plane_stats_);
+    grpc_mux_->onDiscoveryResponse(*response, control_plane_stats_);
   }
 }
 
@@ -139,7 +139,7 @@ TEST_F(NewGrpcMuxImplTest, ConfigUpdateWithAliases) {
   response->mutable_resources()->at(0).add_aliases("prefix/domain1.test");
   response->mutable_resources()->at(0).add_aliases("prefix/domain2.test");
 
-  grpc_mux_->onDiscoveryResponse(std::move(response), control_plane_stats_);
+  grpc_mux_->onDiscoveryResponse(*response, control_plane_stats_);
 
   const auto& subscriptions = grpc_mux_->subscriptions();
   auto sub = subscriptions.find(type_url);
@@ -195,7 +195,7 @@ TEST_F(NewGrpcMuxImplTest, V3ResourceResponseV2ResourceWatch) {
     unexpected_response->set_system_version_info("0");
     unexpected_response->add_resources()->mutable_resource()->PackFrom(cluster);
     EXPECT_CALL(callbacks_, onConfigUpdate(_, _, "0")).Times(0);
-    grpc_mux_->onDiscoveryResponse(std::move(unexpected_response), control_plane_stats_);
+    grpc_mux_->onDiscoveryResponse(*unexpected_response, control_plane_stats_);
   }
   // Cluster is not watched, v2 resource is rejected.
   {
@@ -206,7 +206,7 @@ TEST_F(NewGrpcMuxImplTest, V3ResourceResponseV2ResourceWatch) {
     unexpected_response->set_system_version_info("0");
     unexpected_response->add_resources()->mutable_resource()->PackFrom(cluster);
     EXPECT_CALL(callbacks_, onConfigUpdate(_, _, "0")).Times(0);
-    grpc_mux_->onDiscoveryResponse(std::move(unexpected_response), control_plane_stats_);
+    grpc_mux_->onDiscoveryResponse(*unexpected_response, control_plane_stats_);
   }
   // ClusterLoadAssignment v2 is watched, v3 resource will be accepted.
   {
@@ -225,7 +225,7 @@ TEST_F(NewGrpcMuxImplTest, V3ResourceResponseV2ResourceWatch) {
           EXPECT_TRUE(
               TestUtility::protoEqual(added_resources[0].get().resource(), load_assignment));
         }));
-    grpc_mux_->onDiscoveryResponse(std::move(response), control_plane_stats_);
+    grpc_mux_->onDiscoveryResponse(*response, control_plane_stats_);
   }
 }
 
@@ -263,7 +263,7 @@ TEST_F(NewGrpcMuxImplTest, V2ResourceResponseV3ResourceWatch) {
           EXPECT_TRUE(
               TestUtility::protoEqual(added_resources[0].get().resource(), load_assignment));
         }));
-    grpc_mux_->onDiscoveryResponse(std::move(response), control_plane_stats_);
+    grpc_mux_->onDiscoveryResponse(*response, control_plane_stats_);
   }
 }
 
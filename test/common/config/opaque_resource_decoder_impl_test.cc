@@ -101,6 +101,44 @@ TEST_F(OpaqueResourceDecoderImplTest, Success) {
   EXPECT_EQ("foo", result.second);
 }
 
+// Valid resources of the current version are predecoded, and finished on the main thread.
+TEST_F(OpaqueResourceDecoderImplTest, Predecode) {
+  envoy::config::endpoint::v3::ClusterLoadAssignment cluster_resource;
+  cluster_resource.set_cluster_name("foo");
+  ProtobufWkt::Any opaque_resource;
+  opaque_resource.PackFrom(cluster_resource);
+  const auto predecoded = resource_decoder_.predecodeResource(opaque_resource);
+  ASSERT_NE(nullptr, predecoded);
+  EXPECT_THAT(*predecoded, ProtoEq(cluster_resource));
+  resource_decoder_.finishDecodeResource(*predecoded);
+}
+
+// Invalid resources and resources of other types are left to decodeResource().
+TEST_F(OpaqueResourceDecoderImplTest, PredecodeLeftToDecode) {
+  ProtobufWkt::Any opaque_resource;
+  EXPECT_EQ(nullptr, resource_decoder_.predecodeResource(opaque_resource));
+  opaque_resource.set_type_url("huh");
+  EXPECT_EQ(nullptr, resource_decoder_.predecodeResource(opaque_resource));
+  opaque_resource.PackFrom(envoy::config::endpoint::v3::ClusterLoadAssignment());
+  EXPECT_EQ(nullptr, resource_decoder_.predecodeResource(opaque_resource));
+  opaque_resource.set_type_url("type.googleapis.com/envoy.api.v2.ClusterLoadAssignment");
+  EXPECT_EQ(nullptr, resource_decoder_.predecodeResource(opaque_resource));
+}
+
+// Deprecated fields are checked when finishing the decoding.
+TEST_F(OpaqueResourceDecoderImplTest, PredecodeHiddenEnvoyDeprecatedFields) {
+  envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
+  cluster_load_assignment.set_cluster_name("fare");
+  cluster_load_assignment.mutable_policy()->set_hidden_envoy_deprecated_disable_overprovisioning(
+      true);
+  ProtobufWkt::Any opaque_resource;
+  opaque_resource.PackFrom(cluster_load_assignment);
+  const auto predecoded = resource_decoder_.predecodeResource(opaque_resource);
+  ASSERT_NE(nullptr, predecoded);
+  EXPECT_THROW_WITH_REGEX(resource_decoder_.finishDecodeResource(*predecoded),
+                          ProtoValidationException, "Illegal use of hidden_envoy_deprecated_");
+}
+
 } // namespace
 } // namespace Config
 } // namespace Envoy
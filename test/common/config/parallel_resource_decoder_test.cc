@@ -0,0 +1,73 @@
+#include <list>
+
+#include "envoy/config/endpoint/v3/endpoint.pb.h"
+#include "envoy/config/endpoint/v3/endpoint.pb.validate.h"
+
+#include "common/config/opaque_resource_decoder_impl.h"
+#include "common/config/parallel_resource_decoder.h"
+#include "common/protobuf/message_validator_impl.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Config {
+namespace {
+
+class ParallelResourceDecoderTest : public testing::Test {
+public:
+  void addResources(uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+      envoy::config::endpoint::v3::ClusterLoadAssignment resource;
+      resource.set_cluster_name(absl::StrCat("cluster_", i));
+      resources_.emplace_back().PackFrom(resource);
+    }
+  }
+
+  std::vector<ProtobufTypes::MessagePtr> predecode() {
+    std::vector<const ProtobufWkt::Any*> resources;
+    for (const auto& resource : resources_) {
+      resources.push_back(&resource);
+    }
+    return decoder_.predecode(resource_decoder_, resources);
+  }
+
+  ProtobufMessage::StrictValidationVisitorImpl validation_visitor_;
+  OpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment> resource_decoder_{
+      validation_visitor_, "cluster_name"};
+  ParallelResourceDecoder decoder_{Thread::threadFactoryForTest(), 4};
+  std::list<ProtobufWkt::Any> resources_;
+};
+
+// Updates too small to be worth more threads are left to the main thread.
+TEST_F(ParallelResourceDecoderTest, SmallUpdate) {
+  addResources(2 * ParallelResourceDecoder::MinResourcesPerThread - 1);
+  EXPECT_TRUE(predecode().empty());
+}
+
+// Each resource is predecoded, except the ones left to decodeResource().
+TEST_F(ParallelResourceDecoderTest, LargeUpdate) {
+  addResources(4 * ParallelResourceDecoder::MinResourcesPerThread);
+  auto invalid = std::next(resources_.begin(), 100);
+  invalid->PackFrom(envoy::config::endpoint::v3::ClusterLoadAssignment());
+
+  const auto messages = predecode();
+  ASSERT_EQ(resources_.size(), messages.size());
+  uint32_t i = 0;
+  for (const auto& resource : resources_) {
+    if (i == 100) {
+      EXPECT_EQ(nullptr, messages[i]);
+    } else {
+      ASSERT_NE(nullptr, messages[i]);
+      EXPECT_EQ(absl::StrCat("cluster_", i), resource_decoder_.resourceName(*messages[i]));
+      EXPECT_EQ(resource.value(), messages[i]->SerializeAsString());
+    }
+    ++i;
+  }
+}
+
+} // namespace
+} // namespace Config
+} // namespace Envoy
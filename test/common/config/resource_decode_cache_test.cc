@@ -0,0 +1,71 @@
+#include "envoy/config/endpoint/v3/endpoint.pb.h"
+#include "envoy/service/discovery/v3/discovery.pb.h"
+
+#include "common/config/resource_decode_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Config {
+namespace {
+
+class ResourceDecodeCacheTest : public testing::Test {
+public:
+  ProtobufWkt::Any resource(const std::string& cluster_name) {
+    envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+    load_assignment.set_cluster_name(cluster_name);
+    ProtobufWkt::Any any;
+    any.PackFrom(load_assignment);
+    return any;
+  }
+
+  std::shared_ptr<const Protobuf::Message> message() {
+    return std::make_shared<envoy::config::endpoint::v3::ClusterLoadAssignment>();
+  }
+
+  ResourceDecodeCache cache_;
+};
+
+// Messages are found once the update that inserted them is committed.
+TEST_F(ResourceDecodeCacheTest, Commit) {
+  const auto foo = message();
+  cache_.insert(resource("foo"), foo);
+  EXPECT_EQ(nullptr, cache_.find(resource("foo")));
+  cache_.commit();
+  EXPECT_EQ(foo, cache_.find(resource("foo")));
+  EXPECT_EQ(nullptr, cache_.find(resource("bar")));
+
+  // The messages that the next update neither looks up nor inserts are dropped.
+  cache_.commit();
+  EXPECT_EQ(1, cache_.size());
+  cache_.commit();
+  EXPECT_EQ(0, cache_.size());
+  EXPECT_EQ(nullptr, cache_.find(resource("foo")));
+}
+
+// The messages of aborted updates are dropped, and the ones of the last accepted update are kept.
+TEST_F(ResourceDecodeCacheTest, Abort) {
+  const auto foo = message();
+  cache_.insert(resource("foo"), foo);
+  cache_.commit();
+  cache_.insert(resource("bar"), message());
+  cache_.abort();
+  EXPECT_EQ(nullptr, cache_.find(resource("bar")));
+  EXPECT_EQ(foo, cache_.find(resource("foo")));
+}
+
+// Resources wrapped in a Resource are not memoized.
+TEST_F(ResourceDecodeCacheTest, WrappedResource) {
+  envoy::service::discovery::v3::Resource wrapped;
+  wrapped.set_name("foo");
+  ProtobufWkt::Any any;
+  any.PackFrom(wrapped);
+  cache_.insert(any, message());
+  cache_.commit();
+  EXPECT_EQ(0, cache_.size());
+  EXPECT_EQ(nullptr, cache_.find(any));
+}
+
+} // namespace
+} // namespace Config
+} // namespace Envoy
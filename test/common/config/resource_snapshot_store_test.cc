@@ -0,0 +1,93 @@
+#include "envoy/config/endpoint/v3/endpoint.pb.h"
+#include "envoy/service/discovery/v3/discovery.pb.h"
+
+#include "common/config/resource_snapshot_store.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Config {
+namespace {
+
+class ResourceSnapshotStoreTest : public testing::Test {
+public:
+  ResourceSnapshotStoreTest()
+      : api_(Api::createApiForTest()),
+        directory_(TestEnvironment::temporaryPath("resource_snapshot_store_test")),
+        store_(api_->fileSystem(), directory_) {
+    TestEnvironment::removePath(directory_);
+    TestEnvironment::createPath(directory_);
+    response_.set_version_info("1");
+    response_.set_type_url(type_url_);
+    response_.set_nonce("nonce");
+    response_.mutable_control_plane()->set_identifier("control_plane");
+    envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+    load_assignment.set_cluster_name("x");
+    response_.add_resources()->PackFrom(load_assignment);
+  }
+
+  ~ResourceSnapshotStoreTest() override { TestEnvironment::removePath(directory_); }
+
+  // Rewrites the snapshot of the type with contents modified by a function.
+  void modifySnapshot(std::function<void(std::string&)> modify) {
+    std::string contents = TestEnvironment::readFileToStringForTest(store_.path(type_url_));
+    modify(contents);
+    TestEnvironment::writeStringToFileForTest(store_.path(type_url_), contents, true);
+  }
+
+  const std::string type_url_{"type.googleapis.com/envoy.config.endpoint.v3.ClusterLoadAssignment"};
+  Api::ApiPtr api_;
+  const std::string directory_;
+  ResourceSnapshotStore store_;
+  envoy::service::discovery::v3::DiscoveryResponse response_;
+};
+
+// The resources and version of a response are saved, without its nonce and control plane.
+TEST_F(ResourceSnapshotStoreTest, SaveAndLoad) {
+  EXPECT_EQ(nullptr, store_.load(type_url_));
+  store_.save(type_url_, response_);
+  EXPECT_EQ(directory_ + "/type.googleapis.com_envoy.config.endpoint.v3.ClusterLoadAssignment"
+                         ".snapshot",
+            store_.path(type_url_));
+
+  const auto snapshot = store_.load(type_url_);
+  ASSERT_NE(nullptr, snapshot);
+  response_.clear_nonce();
+  response_.clear_control_plane();
+  EXPECT_TRUE(TestUtility::protoEqual(response_, *snapshot));
+
+  // A later save replaces the snapshot.
+  response_.set_version_info("2");
+  response_.clear_resources();
+  store_.save(type_url_, response_);
+  EXPECT_TRUE(TestUtility::protoEqual(response_, *store_.load(type_url_)));
+}
+
+// Snapshots that fail their checksum are ignored.
+TEST_F(ResourceSnapshotStoreTest, Corrupted) {
+  store_.save(type_url_, response_);
+  modifySnapshot([](std::string& contents) { contents.back() ^= 1; });
+  EXPECT_EQ(nullptr, store_.load(type_url_));
+
+  store_.save(type_url_, response_);
+  modifySnapshot([](std::string& contents) { contents.pop_back(); });
+  EXPECT_EQ(nullptr, store_.load(type_url_));
+
+  modifySnapshot([](std::string& contents) { contents.resize(4); });
+  EXPECT_EQ(nullptr, store_.load(type_url_));
+}
+
+// Snapshots of other versions of the format are ignored.
+TEST_F(ResourceSnapshotStoreTest, OtherFormatVersion) {
+  store_.save(type_url_, response_);
+  modifySnapshot(
+      [](std::string& contents) { contents[4] = ResourceSnapshotStore::FormatVersion + 1; });
+  EXPECT_EQ(nullptr, store_.load(type_url_));
+}
+
+} // namespace
+} // namespace Config
+} // namespace Envoy
@@ -4,6 +4,7 @@
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/upstream/cluster_info.h"
 #include "test/mocks/upstream/host.h"
+#include "test/test_common/test_runtime.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -105,6 +106,29 @@ TEST_F(ConnPoolImplBaseTest, BasicPreconnect) {
   pool_.destructAllConnections();
 }
 
+TEST_F(ConnPoolImplBaseTest, PreconnectStats) {
+  ON_CALL(*cluster_, perUpstreamPreconnectRatio).WillByDefault(Return(1.5));
+
+  // The first connection serves the new stream, the second is created ahead of demand.
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(2);
+  pool_.newStream(context_);
+  CHECK_STATE(0 /*active*/, 1 /*pending*/, 2 /*connecting capacity*/);
+
+  // The preconnected connection connects first and serves the pending stream.
+  EXPECT_CALL(pool_, onPoolReady);
+  clients_[1]->onEvent(Network::ConnectionEvent::Connected);
+  CHECK_STATE(1 /*active*/, 0 /*pending*/, 1 /*connecting capacity*/);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_used_.value());
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_preconnect_unused_.value());
+
+  // A connection preconnected for anticipated load and closed before use is counted as unused.
+  EXPECT_CALL(pool_, instantiateActiveClient);
+  EXPECT_TRUE(pool_.maybePreconnect(3));
+  pool_.destructAllConnections();
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_used_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_unused_.value());
+}
+
 TEST_F(ConnPoolImplBaseTest, PreconnectOnDisconnect) {
   testing::InSequence s;
 
@@ -191,5 +215,90 @@ TEST_F(ConnPoolImplBaseTest, ExplicitPreconnectNotHealthy) {
   EXPECT_FALSE(pool_.maybePreconnect(1));
 }
 
+// Validate that the configured number of idle connections is kept established ahead of demand,
+// that they are replaced once taken or idle for too long, and that a failure to connect stops the
+// replacement until the next stream.
+TEST_F(ConnPoolImplBaseTest, MinIdleConnections) {
+  ON_CALL(*cluster_, perUpstreamMinIdleConnections).WillByDefault(Return(2));
+  ON_CALL(*cluster_, idleTimeout)
+      .WillByDefault(Return(absl::optional<std::chrono::milliseconds>(std::chrono::seconds(10))));
+
+  // The first stream waits for its connection, and the idle connections are created once it is
+  // served.
+  EXPECT_CALL(pool_, instantiateActiveClient);
+  pool_.newStream(context_);
+  EXPECT_CALL(pool_, onPoolReady);
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(2);
+  clients_[0]->onEvent(Network::ConnectionEvent::Connected);
+  CHECK_STATE(1 /*active*/, 0 /*pending*/, 2 /*connecting capacity*/);
+
+  auto* idle_timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+  clients_[1]->onEvent(Network::ConnectionEvent::Connected);
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  clients_[2]->onEvent(Network::ConnectionEvent::Connected);
+
+  // An idle connection which times out is replaced.
+  EXPECT_CALL(pool_, instantiateActiveClient);
+  idle_timer->invokeCallback();
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_idle_timeout_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_unused_.value());
+
+  // A stream takes an idle connection right away, and it is replaced.
+  EXPECT_CALL(pool_, onPoolReady);
+  EXPECT_CALL(pool_, instantiateActiveClient);
+  EXPECT_EQ(nullptr, pool_.newStream(context_));
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_used_.value());
+
+  // A connection which fails to connect is not replaced.
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(0);
+  clients_[3]->close();
+  clients_[4]->close();
+
+  pool_.destructAllConnections();
+}
+
+// Validate that a new connection closes the least recently used idle connections of other pools
+// when the connections of the thread are at the per worker connection budget.
+TEST_F(ConnPoolImplBaseTest, ConnectionBudget) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.upstream.connection_budget_per_worker", "2"}});
+
+  // Two connections of this pool, the first one idle and the second one busy.
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(2);
+  pool_.newStream(context_);
+  pool_.newStream(context_);
+  EXPECT_CALL(pool_, onPoolReady).Times(2);
+  clients_[0]->onEvent(Network::ConnectionEvent::Connected);
+  clients_[1]->onEvent(Network::ConnectionEvent::Connected);
+  static_cast<TestActiveClient*>(clients_[0])->active_streams_ = 0;
+  pool_.onStreamClosed(*clients_[0], false);
+
+  // The connection of another pool closes the idle connection, but not the busy one.
+  Upstream::ClusterConnectivityState other_state;
+  new NiceMock<Event::MockSchedulableCallback>(&dispatcher_);
+  TestConnPoolImplBase other_pool(host_, Upstream::ResourcePriority::High, dispatcher_, nullptr,
+                                  nullptr, other_state);
+  ON_CALL(other_pool, instantiateActiveClient).WillByDefault(Invoke([&]() -> ActiveClientPtr {
+    auto ret = std::make_unique<TestActiveClient>(other_pool, stream_limit_, concurrent_streams_);
+    clients_.push_back(ret.get());
+    ret->real_host_description_ = descr_;
+    return ret;
+  }));
+  EXPECT_CALL(other_pool, instantiateActiveClient);
+  other_pool.newStream(context_);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_idle_evicted_.value());
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_active_.value());
+
+  // Without idle connections to close, the budget is exceeded.
+  EXPECT_CALL(other_pool, instantiateActiveClient);
+  other_pool.newStream(context_);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_idle_evicted_.value());
+  EXPECT_EQ(3U, cluster_->stats_.upstream_cx_active_.value());
+
+  other_pool.destructAllConnections();
+  pool_.destructAllConnections();
+}
+
 } // namespace ConnectionPool
 } // namespace Envoy
@@ -265,6 +265,37 @@ TEST(DeferredDeleteTest, DeferredDelete) {
   dispatcher->clearDeferredDeleteList();
 }
 
+// The deferred deletes of the event loop stop at the budget set by the runtime and resume in the
+// next iterations, while clearDeferredDeleteList() destroys all the objects.
+TEST(DeferredDeleteTest, Budget) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.dispatcher.deferred_delete_max_items", "2"}});
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher(api->allocateDispatcher("test_thread"));
+
+  uint32_t deleted = 0;
+  for (uint32_t i = 0; i < 5; ++i) {
+    dispatcher->deferredDelete(std::make_unique<TestDeferredDeletable>([&]() { ++deleted; }));
+  }
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+  EXPECT_GE(deleted, 2);
+  EXPECT_LT(deleted, 5);
+  for (uint32_t i = 0; i < 5 && deleted < 5; ++i) {
+    dispatcher->run(Dispatcher::RunType::NonBlock);
+  }
+  EXPECT_EQ(5, deleted);
+
+  for (uint32_t i = 0; i < 5; ++i) {
+    dispatcher->deferredDelete(std::make_unique<TestDeferredDeletable>([&]() { ++deleted; }));
+  }
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+  EXPECT_LT(deleted, 10);
+  dispatcher->deferredDelete(std::make_unique<TestDeferredDeletable>([&]() { ++deleted; }));
+  dispatcher->clearDeferredDeleteList();
+  EXPECT_EQ(11, deleted);
+}
+
 TEST(DeferredTaskTest, DeferredTask) {
   InSequence s;
   Api::ApiPtr api = Api::createApiForTest();
@@ -304,6 +335,48 @@ TEST(DeferredDeleteTest, DeferredDeleteAndPostOrdering) {
   dispatcher->run(Dispatcher::RunType::NonBlock);
 }
 
+// With a spin budget, the loop polls for events without blocking while events keep arriving.
+TEST(DispatcherSpinTest, SpinWithinBudget) {
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher(api->allocateDispatcher("test_thread"));
+  Stats::IsolatedStoreImpl store;
+  dispatcher->initializeStats(store, "test.");
+  dispatcher->setSpinBudget(std::chrono::hours(1));
+
+  uint32_t posts = 0;
+  std::function<void()> post_cb = [&]() {
+    if (++posts < 3) {
+      dispatcher->post(post_cb);
+    } else {
+      dispatcher->exit();
+    }
+  };
+  dispatcher->post(post_cb);
+  dispatcher->run(Dispatcher::RunType::Block);
+
+  EXPECT_EQ(3, posts);
+  EXPECT_EQ(0, store.counterFromString("test.dispatcher.busy_poll_blocks").value());
+  const uint64_t spins = store.counterFromString("test.dispatcher.busy_poll_spins").value();
+  const uint64_t spin_hits = store.counterFromString("test.dispatcher.busy_poll_spin_hits").value();
+  EXPECT_GE(spin_hits, 1);
+  EXPECT_LE(spin_hits, spins);
+}
+
+// Once the loop has been idle for the spin budget, it blocks until the next event.
+TEST(DispatcherSpinTest, BlockWhenIdle) {
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher(api->allocateDispatcher("test_thread"));
+  Stats::IsolatedStoreImpl store;
+  dispatcher->initializeStats(store, "test.");
+  dispatcher->setSpinBudget(std::chrono::microseconds(1));
+
+  TimerPtr timer = dispatcher->createTimer([&]() { dispatcher->exit(); });
+  timer->enableTimer(std::chrono::milliseconds(10));
+  dispatcher->run(Dispatcher::RunType::Block);
+
+  EXPECT_GE(store.counterFromString("test.dispatcher.busy_poll_blocks").value(), 1);
+}
+
 class DispatcherImplTest : public testing::Test {
 protected:
   DispatcherImplTest()
@@ -365,6 +438,13 @@ protected:
 // TODO(mergeconflict): We also need integration testing to validate that the expected histograms
 // are written when `enable_dispatcher_stats` is true. See issue #6582.
 TEST_F(DispatcherImplTest, InitializeStats) {
+  EXPECT_CALL(scope_, counter("test.dispatcher.busy_poll_blocks"));
+  EXPECT_CALL(scope_, counter("test.dispatcher.busy_poll_spin_hits"));
+  EXPECT_CALL(scope_, counter("test.dispatcher.busy_poll_spins"));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.deferred_delete_queue_size",
+                                Stats::Histogram::Unit::Unspecified));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.deferred_delete_us",
+                                Stats::Histogram::Unit::Microseconds));
   EXPECT_CALL(scope_,
               histogram("test.dispatcher.loop_duration_us", Stats::Histogram::Unit::Microseconds));
   EXPECT_CALL(scope_,
@@ -449,7 +529,7 @@ TEST_F(DispatcherImplTest, RunPostCallbacksLocking) {
     // Block dispatcher first to ensure that both posted events below are handled
     // by a single call to runPostCallbacks().
     //
-    // This also ensures that the post_lock_ is not held while callbacks are called,
+    // This also ensures that no lock of the dispatcher is held while callbacks are called,
     // or else this would deadlock.
     Thread::LockGuard lock(mu_);
     dispatcher_->post([this]() { Thread::LockGuard lock(mu_); });
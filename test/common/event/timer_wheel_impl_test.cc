@@ -0,0 +1,125 @@
+#include <chrono>
+#include <vector>
+
+#include "common/event/dispatcher_impl.h"
+#include "common/event/timer_wheel_impl.h"
+
+#include "test/mocks/common.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+using testing::MockFunction;
+
+class TimerWheelTest : public testing::Test, public TestUsingSimulatedTime {
+public:
+  TimerWheelTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")),
+        wheel_(*dispatcher_) {}
+
+  void advance(std::chrono::milliseconds duration) {
+    simTime().advanceTimeAndRun(duration, *dispatcher_, Dispatcher::RunType::Block);
+  }
+
+  Api::ApiPtr api_;
+  DispatcherPtr dispatcher_;
+  TimerWheel wheel_;
+};
+
+TEST_F(TimerWheelTest, EnableAndDisable) {
+  MockFunction<void()> callback;
+  auto timer = wheel_.createTimer(callback.AsStdFunction());
+  EXPECT_FALSE(timer->enabled());
+
+  timer->enableTimer(std::chrono::milliseconds(100));
+  EXPECT_TRUE(timer->enabled());
+  timer->disableTimer();
+  EXPECT_FALSE(timer->enabled());
+
+  EXPECT_CALL(callback, Call()).Times(0);
+  advance(std::chrono::milliseconds(200));
+}
+
+TEST_F(TimerWheelTest, NegativeDuration) {
+  MockFunction<void()> callback;
+  auto timer = wheel_.createTimer(callback.AsStdFunction());
+  EXPECT_THROW(timer->enableTimer(std::chrono::milliseconds(-1)), EnvoyException);
+}
+
+// Timers fire at their deadline to the millisecond, whichever level of the wheel they start in.
+TEST_F(TimerWheelTest, FireAtDeadline) {
+  const std::vector<std::chrono::milliseconds> durations{
+      std::chrono::milliseconds(1),       std::chrono::milliseconds(255),
+      std::chrono::milliseconds(256),     std::chrono::milliseconds(1000),
+      std::chrono::milliseconds(65537),   std::chrono::hours(5),
+      std::chrono::hours(24 * 60)};
+  for (const auto duration : durations) {
+    MockFunction<void()> callback;
+    auto timer = wheel_.createTimer(callback.AsStdFunction());
+    timer->enableTimer(duration);
+
+    EXPECT_CALL(callback, Call()).Times(0);
+    advance(duration - std::chrono::milliseconds(1));
+    EXPECT_TRUE(timer->enabled());
+    testing::Mock::VerifyAndClearExpectations(&callback);
+
+    EXPECT_CALL(callback, Call());
+    advance(std::chrono::milliseconds(1));
+    EXPECT_FALSE(timer->enabled());
+  }
+}
+
+// Enabling an enabled timer moves its deadline, earlier or later.
+TEST_F(TimerWheelTest, Reenable) {
+  MockFunction<void()> callback;
+  auto timer = wheel_.createTimer(callback.AsStdFunction());
+  timer->enableTimer(std::chrono::seconds(10));
+  timer->enableTimer(std::chrono::seconds(1));
+
+  EXPECT_CALL(callback, Call());
+  advance(std::chrono::seconds(1));
+
+  timer->enableTimer(std::chrono::seconds(1));
+  timer->enableTimer(std::chrono::seconds(10));
+  EXPECT_CALL(callback, Call()).Times(0);
+  advance(std::chrono::seconds(9));
+  testing::Mock::VerifyAndClearExpectations(&callback);
+  EXPECT_CALL(callback, Call());
+  advance(std::chrono::seconds(1));
+}
+
+// Callbacks may enable and disable the timers of the wheel, including the ones about to fire.
+TEST_F(TimerWheelTest, EnableAndDisableFromCallback) {
+  TimerPtr timer1;
+  TimerPtr timer2;
+  std::vector<int> fired;
+  timer1 = wheel_.createTimer([&]() {
+    fired.push_back(1);
+    timer2->disableTimer();
+    timer1->enableTimer(std::chrono::milliseconds(300));
+  });
+  timer2 = wheel_.createTimer([&]() {
+    fired.push_back(2);
+    timer1->disableTimer();
+    timer2->enableTimer(std::chrono::milliseconds(300));
+  });
+  timer1->enableTimer(std::chrono::milliseconds(500));
+  timer2->enableTimer(std::chrono::milliseconds(500));
+
+  advance(std::chrono::milliseconds(500));
+  ASSERT_EQ(1, fired.size());
+  advance(std::chrono::milliseconds(300));
+  ASSERT_EQ(2, fired.size());
+  EXPECT_EQ(fired[0], fired[1]);
+  timer1.reset();
+  timer2.reset();
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
@@ -1,5 +1,6 @@
 #include "common/formatter/substitution_formatter.h"
 #include "common/network/address_impl.h"
+#include "common/protobuf/utility.h"
 
 #include "test/common/stream_info/test_util.h"
 #include "test/mocks/http/mocks.h"
@@ -163,4 +164,29 @@ static void BM_TypedJsonAccessLogFormatter(benchmark::State& state) {
 }
 BENCHMARK(BM_TypedJsonAccessLogFormatter);
 
+// The JSON access log as it was written before, by serializing the struct of the struct formatter,
+// for comparison with BM_JsonAccessLogFormatter.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_JsonAccessLogFormatterViaStruct(benchmark::State& state) {
+  std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo();
+  std::unique_ptr<Envoy::Formatter::StructFormatter> struct_formatter = makeStructFormatter(false);
+
+  size_t output_bytes = 0;
+  Http::TestRequestHeaderMapImpl request_headers;
+  Http::TestResponseHeaderMapImpl response_headers;
+  Http::TestResponseTrailerMapImpl response_trailers;
+  std::string body;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    output_bytes +=
+        absl::StrCat(MessageUtil::getJsonStringFromMessage(
+                         struct_formatter->format(request_headers, response_headers,
+                                                  response_trailers, *stream_info, body),
+                         false, true),
+                     "\n")
+            .length();
+  }
+  benchmark::DoNotOptimize(output_bytes);
+}
+BENCHMARK(BM_JsonAccessLogFormatterViaStruct);
+
 } // namespace Envoy
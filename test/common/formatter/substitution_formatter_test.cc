@@ -2076,6 +2076,51 @@ TEST(SubstitutionFormatterTest, JsonFormatterTest) {
   EXPECT_TRUE(TestUtility::jsonStringEqual(out_json, expected));
 }
 
+// The JSON written directly is the JSON of the struct of the struct formatter, whatever the
+// options, and escapes the strings.
+TEST(SubstitutionFormatterTest, JsonFormatterMatchesStructFormatter) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{"x-quoted", "\"a\\b\"\tc"}};
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body;
+
+  envoy::config::core::v3::Metadata metadata;
+  populateMetadataTestData(metadata);
+  EXPECT_CALL(Const(stream_info), dynamicMetadata()).WillRepeatedly(ReturnRef(metadata));
+  stream_info.response_code_ = 200;
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    quoted: '%REQ(X-QUOTED)%'
+    missing: '%REQ(X-MISSING)%'
+    code: '%RESPONSE_CODE%'
+    nested:
+      metadata: '%DYNAMIC_METADATA(com.test:test_obj)%'
+      concatenated: '%RESPONSE_CODE% %REQ(X-MISSING)%'
+  )EOF",
+                            key_mapping);
+  for (const bool preserve_types : {false, true}) {
+    for (const bool omit_empty_values : {false, true}) {
+      JsonFormatterImpl formatter(key_mapping, preserve_types, omit_empty_values);
+      StructFormatter struct_formatter(key_mapping, preserve_types, omit_empty_values);
+      const std::string out_json =
+          formatter.format(request_header, response_header, response_trailer, stream_info, body);
+      EXPECT_TRUE(TestUtility::jsonStringEqual(
+          out_json, MessageUtil::getJsonStringFromMessage(
+                        struct_formatter.format(request_header, response_header, response_trailer,
+                                                stream_info, body),
+                        false, true)));
+      EXPECT_EQ('\n', out_json.back());
+    }
+  }
+
+  JsonFormatterImpl formatter(key_mapping, true, true);
+  EXPECT_EQ("{\"code\":200,\"nested\":{\"concatenated\":\"200 \",\"metadata\":"
+            "{\"inner_key\":\"inner_value\"}},\"quoted\":\"\\\"a\\\\b\\\"\\tc\"}\n",
+            formatter.format(request_header, response_header, response_trailer, stream_info, body));
+}
+
 TEST(SubstitutionFormatterTest, CompositeFormatterSuccess) {
   StreamInfo::MockStreamInfo stream_info;
   Http::TestRequestHeaderMapImpl request_header{{"first", "GET"}, {":path", "/"}};
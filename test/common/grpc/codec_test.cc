@@ -88,6 +88,31 @@ TEST(GrpcCodecTest, decodeIncompleteFrame) {
   EXPECT_EQ("hello", decoded_request.name());
 }
 
+// The payloads of the frames are moved out of the input rather than copied.
+TEST(GrpcCodecTest, decodeMovesPayload) {
+  helloworld::HelloRequest request;
+  request.set_name(std::string(20000, 'a'));
+  const std::string payload = request.SerializeAsString();
+
+  Buffer::OwnedImpl buffer;
+  std::array<uint8_t, 5> header;
+  Encoder().newFrame(GRPC_FH_DEFAULT, payload.size(), header);
+  buffer.add(header.data(), 5);
+  Buffer::OwnedImpl payload_buffer(payload);
+  const void* payload_mem = payload_buffer.frontSlice().mem_;
+  buffer.move(payload_buffer);
+
+  std::vector<Frame> frames;
+  Decoder decoder;
+  EXPECT_TRUE(decoder.decode(buffer, frames));
+  EXPECT_EQ(0, buffer.length());
+  ASSERT_EQ(1, frames.size());
+  EXPECT_EQ(payload.size(), frames[0].length_);
+  EXPECT_EQ(payload_mem, frames[0].data_->frontSlice().mem_);
+  EXPECT_EQ(payload, frames[0].data_->toString());
+  EXPECT_EQ(1, decoder.frameCount());
+}
+
 TEST(GrpcCodecTest, decodeInvalidFrame) {
   helloworld::HelloRequest request;
   request.set_name("hello");
@@ -381,5 +381,29 @@ TEST(GrpcContextTest, PrependGrpcFrameHeader) {
   EXPECT_EQ(buffer->toString(), header_string + "test");
 }
 
+// A large message is serialized over several slices, and parses back from them.
+TEST(GrpcContextTest, SerializeLargeMessage) {
+  helloworld::HelloRequest request;
+  request.set_name(std::string(100000, 'a'));
+
+  Buffer::InstancePtr frame = Common::serializeToGrpcFrame(request);
+  EXPECT_EQ(request.ByteSize() + 5, frame->length());
+  EXPECT_LT(1, frame->getRawSlices().size());
+  uint8_t flags;
+  frame->copyOut(0, 1, &flags);
+  EXPECT_EQ(0, flags);
+  frame->drain(5);
+  helloworld::HelloRequest parsed;
+  EXPECT_TRUE(Common::parseBufferInstance(std::move(frame), parsed));
+  EXPECT_EQ(request.name(), parsed.name());
+
+  Buffer::InstancePtr message = Common::serializeMessage(request);
+  EXPECT_EQ(request.ByteSize(), message->length());
+  EXPECT_TRUE(Common::parseBufferInstance(std::move(message), parsed));
+  EXPECT_EQ(request.name(), parsed.name());
+
+  EXPECT_EQ(0, Common::serializeMessage(helloworld::HelloRequest())->length());
+}
+
 } // namespace Grpc
 } // namespace Envoy
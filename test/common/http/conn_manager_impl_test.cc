@@ -1,3 +1,5 @@
+#include "common/buffer/watermark_buffer.h"
+
 #include "test/common/http/conn_manager_impl_test_base.h"
 #include "test/test_common/logging.h"
 #include "test/test_common/test_runtime.h"
@@ -1538,6 +1540,66 @@ TEST_F(HttpConnectionManagerImplTest,
   conn_manager_->onData(fake_input, false);
 }
 
+// A span which is not sampled is finished without being tagged.
+TEST_F(HttpConnectionManagerImplTest, FinishNotSampledSpanWithoutTags) {
+  setup(false, "");
+
+  auto* span = new NiceMock<Tracing::MockSpan>();
+  EXPECT_CALL(*tracer_, startSpan_(_, _, _, _))
+      .WillOnce(
+          Invoke([&](const Tracing::Config&, const HeaderMap&, const StreamInfo::StreamInfo&,
+                     const Tracing::Decision tracing_decision) -> Tracing::Span* {
+            EXPECT_FALSE(tracing_decision.traced);
+            return span;
+          }));
+  EXPECT_CALL(*span, setTag(_, _)).Times(0);
+  EXPECT_CALL(*span, finishSpan());
+  envoy::type::v3::FractionalPercent percent;
+  percent.set_numerator(100);
+  tracing_config_ = std::make_unique<TracingConnectionManagerConfig>(
+      TracingConnectionManagerConfig{Tracing::OperationName::Ingress,
+                                     {{":method", requestHeaderCustomTag(":method")}},
+                                     percent,
+                                     percent,
+                                     percent,
+                                     false,
+                                     256});
+  EXPECT_CALL(
+      runtime_.snapshot_,
+      featureEnabled("tracing.global_enabled", An<const envoy::type::v3::FractionalPercent&>(), _))
+      .WillOnce(Return(false));
+
+  std::shared_ptr<MockStreamDecoderFilter> filter(new NiceMock<MockStreamDecoderFilter>());
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillRepeatedly(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.addStreamDecoderFilter(filter);
+      }));
+
+  // Treat request as internal, otherwise x-request-id header will be overwritten.
+  use_remote_address_ = false;
+  EXPECT_CALL(*codec_, dispatch(_))
+      .WillRepeatedly(Invoke([&](Buffer::Instance& data) -> Http::Status {
+        decoder_ = &conn_manager_->newStream(response_encoder_);
+
+        RequestHeaderMapPtr headers{
+            new TestRequestHeaderMapImpl{{":method", "GET"},
+                                         {":authority", "host"},
+                                         {":path", "/"},
+                                         {"x-request-id", "125a4afb-6f55-a4ba-ad80-413f09f48a28"}}};
+        decoder_->decodeHeaders(std::move(headers), true);
+
+        filter->callbacks_->streamInfo().setResponseCodeDetails("");
+        ResponseHeaderMapPtr response_headers{new TestResponseHeaderMapImpl{{":status", "200"}}};
+        filter->callbacks_->encodeHeaders(std::move(response_headers), true, "details");
+
+        data.drain(4);
+        return Http::okStatus();
+      }));
+
+  Buffer::OwnedImpl fake_input("1234");
+  conn_manager_->onData(fake_input, false);
+}
+
 TEST_F(HttpConnectionManagerImplTest, TestAccessLog) {
   static constexpr char local_address[] = "0.0.0.0";
   static constexpr char xff_address[] = "1.2.3.4";
@@ -2666,6 +2728,34 @@ TEST_F(HttpConnectionManagerImplTest, RequestTimeoutCallbackDisarmsAndReturns408
   EXPECT_EQ("request timeout", response_body);
 }
 
+// A stream whose buffers hold too much memory under memory pressure is reset.
+TEST_F(HttpConnectionManagerImplTest, ResetStreamOnBufferMemoryPressure) {
+  setup(false, "");
+  Buffer::WatermarkBufferFactory buffer_factory;
+  buffer_factory.trackAccounts();
+  Buffer::BufferMemoryAccountSharedPtr account;
+  EXPECT_CALL(filter_callbacks_.connection_.dispatcher_.buffer_factory_, createAccount(_))
+      .WillOnce(Invoke([&](std::function<void()> reset_stream) {
+        account = buffer_factory.createAccount(std::move(reset_stream));
+        return account;
+      }));
+
+  EXPECT_CALL(*codec_, dispatch(_)).WillOnce(Invoke([&](Buffer::Instance&) -> Http::Status {
+    conn_manager_->newStream(response_encoder_);
+    return Http::okStatus();
+  }));
+  Buffer::OwnedImpl fake_input("1234");
+  conn_manager_->onData(fake_input, false);
+  ASSERT_NE(nullptr, account);
+
+  account->charge(Buffer::BufferMemoryAccountImpl::MinimumBalanceToTrack);
+  EXPECT_CALL(response_encoder_.stream_, resetStream(StreamResetReason::LocalReset));
+  EXPECT_EQ(1, buffer_factory.resetAccountsGivenPressure(1));
+  EXPECT_EQ(1U, stats_.named_.downstream_rq_overload_close_.value());
+  EXPECT_EQ(0, buffer_factory.resetAccountsGivenPressure(1));
+  account->credit(Buffer::BufferMemoryAccountImpl::MinimumBalanceToTrack);
+}
+
 TEST_F(HttpConnectionManagerImplTest, RequestTimeoutIsNotDisarmedOnIncompleteRequestWithHeader) {
   request_timeout_ = std::chrono::milliseconds(10);
   setup(false, "");
@@ -309,6 +309,67 @@ TEST_F(HttpConnectionManagerImplTest, IdleTimeout) {
   EXPECT_EQ(1U, stats_.named_.downstream_cx_idle_timeout_.value());
 }
 
+TEST_F(HttpConnectionManagerImplTest, PacedDrainNoCodec) {
+  // Not used in the test.
+  delete codec_;
+
+  Network::DrainCloseCb drain_cb;
+  EXPECT_CALL(drain_close_, addOnDrainCloseCb(_, _))
+      .WillOnce(Invoke([&](Event::Dispatcher&, Network::DrainCloseCb cb) {
+        drain_cb = std::move(cb);
+        return std::make_unique<Network::DrainCloseHandle>();
+      }));
+  setup(false, "");
+
+  EXPECT_CALL(filter_callbacks_.connection_, close(Network::ConnectionCloseType::FlushWrite));
+  EXPECT_TRUE(drain_cb(true));
+  EXPECT_EQ(1U, stats_.named_.downstream_cx_drain_close_.value());
+
+  // A closed connection counts as drained.
+  EXPECT_TRUE(drain_cb(false));
+  EXPECT_EQ(1U, stats_.named_.downstream_cx_drain_close_.value());
+}
+
+// A busy connection is only drained once the idle ones are, by its response closing it.
+TEST_F(HttpConnectionManagerImplTest, PacedDrainActiveRequest) {
+  Network::DrainCloseCb drain_cb;
+  EXPECT_CALL(drain_close_, addOnDrainCloseCb(_, _))
+      .WillOnce(Invoke([&](Event::Dispatcher&, Network::DrainCloseCb cb) {
+        drain_cb = std::move(cb);
+        return std::make_unique<Network::DrainCloseHandle>();
+      }));
+  setup(false, "");
+
+  MockStreamDecoderFilter* filter = new NiceMock<MockStreamDecoderFilter>();
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillOnce(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.addStreamDecoderFilter(StreamDecoderFilterSharedPtr{filter});
+      }));
+  EXPECT_CALL(*filter, decodeHeaders(_, false))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  EXPECT_CALL(*filter, decodeData(_, true))
+      .WillOnce(Return(FilterDataStatus::StopIterationNoBuffer));
+  startRequest(true, "hello");
+
+  EXPECT_FALSE(drain_cb(true));
+  EXPECT_EQ(0U, stats_.named_.downstream_cx_drain_close_.value());
+
+  Event::MockTimer* drain_timer = setUpTimer();
+  EXPECT_CALL(*drain_timer, enableTimer(_, _));
+  EXPECT_CALL(*codec_, shutdownNotice());
+  EXPECT_TRUE(drain_cb(false));
+  EXPECT_EQ(1U, stats_.named_.downstream_cx_drain_close_.value());
+
+  EXPECT_CALL(drain_close_, drainClose()).Times(0);
+  EXPECT_CALL(response_encoder_, encodeHeaders(_, true))
+      .WillOnce(Invoke([](const ResponseHeaderMap& headers, bool) -> void {
+        EXPECT_EQ("close", headers.getConnectionValue());
+      }));
+  ResponseHeaderMapPtr response_headers{new TestResponseHeaderMapImpl{{":status", "200"}}};
+  filter->callbacks_->streamInfo().setResponseCodeDetails("");
+  filter->callbacks_->encodeHeaders(std::move(response_headers), true, "details");
+}
+
 TEST_F(HttpConnectionManagerImplTest, ConnectionDurationResponseFlag) {
   // Not used in the test.
   delete codec_;
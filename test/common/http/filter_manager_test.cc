@@ -15,6 +15,7 @@
 
 #include "gtest/gtest.h"
 
+using testing::AnyNumber;
 using testing::Return;
 
 namespace Envoy {
@@ -22,11 +23,11 @@ namespace Http {
 namespace {
 class FilterManagerTest : public testing::Test {
 public:
-  void initialize() {
+  void initialize(bool use_filter_arena = false) {
     filter_manager_ = std::make_unique<FilterManager>(
         filter_manager_callbacks_, dispatcher_, connection_, 0, true, 10000, filter_factory_,
         local_reply_, protocol_, time_source_, filter_state_,
-        StreamInfo::FilterState::LifeSpan::Connection);
+        StreamInfo::FilterState::LifeSpan::Connection, use_filter_arena);
   }
 
   std::unique_ptr<FilterManager> filter_manager_;
@@ -248,6 +249,60 @@ TEST_F(FilterManagerTest, MatchTreeSkipActionRequestAndResponseHeaders) {
   filter_manager_->decodeData(data, true);
   filter_manager_->destroyFilters();
 }
+
+// Verifies that the filter chain works when its wrappers are allocated from the per-stream arena.
+TEST_F(FilterManagerTest, FilterChainArena) {
+  initialize(true);
+
+  EXPECT_CALL(dispatcher_, setTrackedObject(_)).Times(AnyNumber());
+
+  auto stream_filter = std::make_shared<NiceMock<MockStreamFilter>>();
+  EXPECT_CALL(*stream_filter, decodeHeaders(_, false))
+      .WillOnce(Return(FilterHeadersStatus::Continue));
+  EXPECT_CALL(*stream_filter, decodeData(_, true)).WillOnce(Return(FilterDataStatus::Continue));
+  EXPECT_CALL(*stream_filter, encodeHeaders(_, false))
+      .WillOnce(Return(FilterHeadersStatus::Continue));
+  EXPECT_CALL(*stream_filter, encodeData(_, true)).WillOnce(Return(FilterDataStatus::Continue));
+  EXPECT_CALL(*stream_filter, onDestroy());
+
+  auto decoder_filter = std::make_shared<NiceMock<MockStreamDecoderFilter>>();
+  EXPECT_CALL(*decoder_filter, decodeHeaders(_, false))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  EXPECT_CALL(*decoder_filter, decodeData(_, true))
+      .WillOnce(Invoke([&](auto&, bool) -> FilterDataStatus {
+        ResponseHeaderMapPtr headers{new TestResponseHeaderMapImpl{{":status", "200"}}};
+        decoder_filter->callbacks_->encodeHeaders(std::move(headers), false, "details");
+
+        Buffer::OwnedImpl data("data");
+        decoder_filter->callbacks_->encodeData(data, true);
+        return FilterDataStatus::StopIterationNoBuffer;
+      }));
+  EXPECT_CALL(*decoder_filter, onDestroy());
+
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillOnce(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.addStreamFilter(stream_filter);
+        callbacks.addStreamDecoderFilter(decoder_filter);
+      }));
+
+  RequestHeaderMapPtr headers{
+      new TestRequestHeaderMapImpl{{":authority", "host"}, {":path", "/"}, {":method", "GET"}}};
+  Buffer::OwnedImpl data("data");
+
+  ON_CALL(filter_manager_callbacks_, requestHeaders())
+      .WillByDefault(Return(absl::make_optional(std::ref(*headers))));
+  filter_manager_->createFilterChain();
+
+  EXPECT_CALL(filter_manager_callbacks_, encodeHeaders(_, _));
+  EXPECT_CALL(filter_manager_callbacks_, encodeData(_, true));
+  EXPECT_CALL(filter_manager_callbacks_, endStream());
+
+  filter_manager_->requestHeadersInitialized();
+  filter_manager_->decodeHeaders(*headers, false);
+  filter_manager_->decodeData(data, true);
+  filter_manager_->destroyFilters();
+  filter_manager_.reset();
+}
 } // namespace
 } // namespace Http
 } // namespace Envoy
\ No newline at end of file
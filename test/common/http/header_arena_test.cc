@@ -0,0 +1,112 @@
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "common/http/header_arena.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+TEST(HeaderArenaTest, ReusesDeallocatedMemory) {
+  HeaderArena arena;
+  void* first = arena.allocate(100);
+  void* second = arena.allocate(100);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(first) % alignof(std::max_align_t));
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(second) % alignof(std::max_align_t));
+  EXPECT_EQ(1, arena.blockCount());
+
+  arena.deallocate(first, 100);
+  EXPECT_EQ(first, arena.allocate(100));
+  // Memory is only reused for allocations of the same size.
+  arena.deallocate(second, 100);
+  EXPECT_NE(second, arena.allocate(200));
+  EXPECT_EQ(second, arena.allocate(100));
+}
+
+TEST(HeaderArenaTest, AllocatesBlocksAsNeeded) {
+  HeaderArena arena;
+  for (int i = 0; i < 100; i++) {
+    arena.allocate(512);
+  }
+  EXPECT_LT(1, arena.blockCount());
+  EXPECT_GE(100, arena.blockCount());
+}
+
+TEST(HeaderArenaTest, LargeAllocationsUseTheHeap) {
+  HeaderArena arena;
+  void* memory = arena.allocate(HeaderArena::MaxArenaAllocationSize + 1);
+  EXPECT_EQ(0, arena.blockCount());
+  arena.deallocate(memory, HeaderArena::MaxArenaAllocationSize + 1);
+}
+
+TEST(HeaderArenaAllocatorTest, Containers) {
+  auto arena = std::make_shared<HeaderArena>();
+  std::list<uint64_t, HeaderArenaAllocator<uint64_t>> arena_list{
+      HeaderArenaAllocator<uint64_t>(arena)};
+  std::list<uint64_t, HeaderArenaAllocator<uint64_t>> heap_list;
+  for (uint64_t i = 0; i < 1000; i++) {
+    arena_list.push_back(i);
+    heap_list.push_back(i);
+  }
+  EXPECT_EQ(heap_list, arena_list);
+  EXPECT_LT(0, arena->blockCount());
+  EXPECT_EQ(nullptr, heap_list.get_allocator().arena());
+  EXPECT_NE(arena_list.get_allocator(), heap_list.get_allocator());
+
+  // The list keeps the arena alive.
+  arena.reset();
+  arena_list.clear();
+  arena_list.push_back(1);
+  EXPECT_EQ(1, arena_list.front());
+}
+
+class TestObject : public ArenaAllocated {
+public:
+  TestObject(std::string value, bool throws) : value_(std::move(value)) {
+    if (throws) {
+      throw std::runtime_error("constructor failed");
+    }
+  }
+
+  std::string value_;
+};
+
+TEST(ArenaAllocatedTest, AllocatesFromArena) {
+  auto arena = std::make_shared<HeaderArena>();
+  std::unique_ptr<TestObject> arena_object(new (arena) TestObject("arena", false));
+  std::unique_ptr<TestObject> heap_object(new TestObject("heap", false));
+  std::unique_ptr<TestObject> null_arena_object(new (nullptr) TestObject("null", false));
+  EXPECT_EQ(1, arena->blockCount());
+  EXPECT_EQ("arena", arena_object->value_);
+  EXPECT_EQ("heap", heap_object->value_);
+  EXPECT_EQ("null", null_arena_object->value_);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(arena_object.get()) % alignof(std::max_align_t));
+
+  // The memory of a released object is reused by the next object.
+  TestObject* released = arena_object.get();
+  arena_object.reset();
+  arena_object.reset(new (arena) TestObject("reused", false));
+  EXPECT_EQ(released, arena_object.get());
+
+  // The object keeps the arena alive.
+  arena.reset();
+  EXPECT_EQ("reused", arena_object->value_);
+  arena_object.reset();
+}
+
+TEST(ArenaAllocatedTest, ConstructorThrows) {
+  auto arena = std::make_shared<HeaderArena>();
+  EXPECT_THROW(new (arena) TestObject("arena", true), std::runtime_error);
+  EXPECT_EQ(1, arena.use_count());
+  EXPECT_THROW(new TestObject("heap", true), std::runtime_error);
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
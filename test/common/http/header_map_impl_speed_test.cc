@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <iterator>
+
 #include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
 
@@ -181,6 +184,65 @@ static void headerMapImplRemoveInline(benchmark::State& state) {
 }
 BENCHMARK(headerMapImplRemoveInline)->Arg(0)->Arg(1)->Arg(5)->Arg(10)->Arg(50);
 
+/**
+ * Measure the speed of adding and removing request headers by key name, most of which are inline
+ * headers that HeaderMapImpl resolves through its static lookup table. The numeric Arg passed by
+ * the BENCHMARK(...) macro call below indicates how many of the headers are added.
+ */
+static void headerMapImplAddInlineByName(benchmark::State& state) {
+  const std::pair<LowerCaseString, std::string> headers_to_add[] = {
+      {LowerCaseString(":method"), "GET"},
+      {LowerCaseString(":path"), "/index.html"},
+      {LowerCaseString(":scheme"), "https"},
+      {LowerCaseString(":authority"), "www.example.com"},
+      {LowerCaseString("user-agent"), "curl/7.64.1"},
+      {LowerCaseString("accept-encoding"), "gzip, deflate, br"},
+      {LowerCaseString("content-type"), "text/html; charset=utf-8"},
+      {LowerCaseString("x-forwarded-for"), "192.0.2.1"},
+      {LowerCaseString("x-request-id"), "8dd67cb2-6a56-4cbf-9a33-a2b0d5bd1b0d"},
+      {LowerCaseString("x-custom-header"), "example"},
+  };
+  const size_t num_headers = std::min<size_t>(state.range(0), std::size(headers_to_add));
+  auto headers = Http::RequestHeaderMapImpl::create();
+  for (auto _ : state) { // NOLINT
+    for (size_t i = 0; i < num_headers; i++) {
+      headers->addReference(headers_to_add[i].first, headers_to_add[i].second);
+    }
+    for (size_t i = 0; i < num_headers; i++) {
+      headers->remove(headers_to_add[i].first);
+    }
+  }
+  benchmark::DoNotOptimize(headers->size());
+}
+BENCHMARK(headerMapImplAddInlineByName)->Arg(1)->Arg(5)->Arg(10);
+
+/**
+ * Measure the speed of retrieving inline headers by key name rather than through their
+ * accessors, which resolves each name through the static lookup table. Names that are not inline
+ * headers, including ones sharing a prefix with inline headers, are included to measure misses.
+ */
+static void headerMapImplGetInlineByName(benchmark::State& state) {
+  const LowerCaseString keys[] = {
+      LowerCaseString(":path"),
+      LowerCaseString("content-length"),
+      LowerCaseString("x-envoy-original-path"),
+      LowerCaseString("x-forwarded-proto"),
+      LowerCaseString("x-envoy-not-inline"),
+      LowerCaseString("content-not-inline"),
+  };
+  auto headers = Http::RequestHeaderMapImpl::create();
+  headers->setReferencePath("/");
+  headers->setContentLength(0);
+  size_t successes = 0;
+  for (auto _ : state) { // NOLINT
+    for (const LowerCaseString& key : keys) {
+      successes += !headers->get(key).empty();
+    }
+  }
+  benchmark::DoNotOptimize(successes);
+}
+BENCHMARK(headerMapImplGetInlineByName);
+
 /**
  * Measure the speed of creating a HeaderMapImpl and populating it with a realistic
  * set of response headers.
@@ -420,6 +420,41 @@ TEST_P(HeaderMapImplTest, AllInlineHeaders) {
   }
 }
 
+// Header maps sharing an arena allocate their entries from it, and remain valid after every other
+// reference to the arena is dropped.
+TEST_P(HeaderMapImplTest, ArenaAllocatedHeaders) {
+  auto arena = std::make_shared<HeaderArena>();
+  auto headers = RequestHeaderMapImpl::create(arena);
+  auto trailers = RequestTrailerMapImpl::create(arena);
+  for (int i = 0; i < 100; i++) {
+    headers->addCopy(LowerCaseString(absl::StrCat("header-", i)), absl::StrCat("value-", i));
+  }
+  headers->setHost("host");
+  trailers->addCopy(LowerCaseString("trailer"), "value");
+  EXPECT_EQ(101, headers->size());
+  EXPECT_GT(arena->blockCount(), 0);
+
+  // Entries that are removed are reused by later additions.
+  const size_t block_count = arena->blockCount();
+  for (int i = 0; i < 100; i++) {
+    headers->remove(LowerCaseString(absl::StrCat("header-", i)));
+  }
+  for (int i = 0; i < 100; i++) {
+    headers->addCopy(LowerCaseString(absl::StrCat("other-", i)), "value");
+  }
+  EXPECT_EQ(block_count, arena->blockCount());
+
+  // Copying headers out of the arena allocates the copy from the heap.
+  auto copy = createHeaderMap<RequestHeaderMapImpl>(*headers);
+  arena.reset();
+  trailers.reset();
+  EXPECT_EQ("host", headers->getHostValue());
+  EXPECT_EQ("value", headers->get(LowerCaseString("other-99"))[0]->value().getStringView());
+  headers.reset();
+  EXPECT_EQ(101, copy->size());
+  EXPECT_EQ("host", copy->getHostValue());
+}
+
 TEST_P(HeaderMapImplTest, InlineInsert) {
   TestRequestHeaderMapImpl headers;
   EXPECT_TRUE(headers.empty());
@@ -535,6 +535,122 @@ TEST_F(Http1ServerConnectionImplTest, ChunkedBodyFragmentedBuffer) {
   EXPECT_EQ(0U, buffer.length());
 }
 
+// Verify that the vectorized parser delivers the same headers and body as http_parser when the
+// request arrives one byte per slice, and when it arrives in a single slice.
+TEST_F(Http1ServerConnectionImplTest, ChunkedBodySimdParser) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.http1_use_simd_parser", "true"}});
+  initialize();
+
+  const std::string request = "POST /a/path/longer/than/sixteen/bytes HTTP/1.1\r\n"
+                              "transfer-encoding: chunked\r\n"
+                              "x-a-header-name-longer-than-sixteen: value longer than sixteen\r\n"
+                              "\r\n"
+                              "6;ext=1\r\nHello \r\n"
+                              "5\r\nWorld\r\n"
+                              "0\r\n\r\n";
+  TestRequestHeaderMapImpl expected_headers{
+      {":path", "/a/path/longer/than/sixteen/bytes"},
+      {":method", "POST"},
+      {"transfer-encoding", "chunked"},
+      {"x-a-header-name-longer-than-sixteen", "value longer than sixteen"},
+  };
+  Buffer::OwnedImpl expected_data("Hello World");
+
+  for (const size_t slice_size : {size_t(1), request.size()}) {
+    InSequence sequence;
+
+    MockRequestDecoder decoder;
+    Http::ResponseEncoder* response_encoder = nullptr;
+    EXPECT_CALL(callbacks_, newStream(_, _))
+        .WillOnce(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+          response_encoder = &encoder;
+          return decoder;
+        }));
+    EXPECT_CALL(decoder, decodeHeaders_(HeaderMapEqual(&expected_headers), false));
+    EXPECT_CALL(decoder, decodeData(BufferEqual(&expected_data), false));
+    EXPECT_CALL(decoder, decodeData(_, true));
+
+    Buffer::OwnedImpl buffer = createBufferWithNByteSlices(request, slice_size);
+    auto status = codec_->dispatch(buffer);
+    EXPECT_TRUE(status.ok());
+    EXPECT_EQ(0U, buffer.length());
+    response_encoder->encodeHeaders(TestResponseHeaderMapImpl{{":status", "200"}}, true);
+  }
+}
+
+// Verify that headers and trailers decoded into a per-message arena remain valid after the codec
+// that decoded them is destroyed.
+TEST_F(Http1ServerConnectionImplTest, RequestWithTrailersHeaderArena) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.http_header_map_arena", "true"}});
+  codec_settings_.enable_trailers_ = true;
+  initialize();
+
+  NiceMock<MockRequestDecoder> decoder;
+  EXPECT_CALL(callbacks_, newStream(_, _)).WillOnce(ReturnRef(decoder));
+  RequestHeaderMapPtr headers;
+  RequestTrailerMapPtr trailers;
+  EXPECT_CALL(decoder, decodeHeaders_(_, false))
+      .WillOnce(Invoke([&](RequestHeaderMapPtr& decoded, bool) { headers = std::move(decoded); }));
+  EXPECT_CALL(decoder, decodeTrailers_(_))
+      .WillOnce(Invoke([&](RequestTrailerMapPtr& decoded) { trailers = std::move(decoded); }));
+
+  Buffer::OwnedImpl buffer("POST / HTTP/1.1\r\ntransfer-encoding: chunked\r\nx-foo: bar\r\n\r\n"
+                           "5\r\nhello\r\n0\r\nx-trailer: baz\r\n\r\n");
+  auto status = codec_->dispatch(buffer);
+  EXPECT_TRUE(status.ok());
+  codec_.reset();
+
+  TestRequestHeaderMapImpl expected_headers{
+      {":path", "/"}, {":method", "POST"}, {"transfer-encoding", "chunked"}, {"x-foo", "bar"}};
+  EXPECT_THAT(headers, HeaderMapEqualIgnoreOrder(&expected_headers));
+  TestRequestTrailerMapImpl expected_trailers{{"x-trailer", "baz"}};
+  EXPECT_THAT(trailers, HeaderMapEqualIgnoreOrder(&expected_trailers));
+}
+
+// Verify that the header lines of a request received in one slice are attached to the decoded
+// headers, with the header names lower cased.
+TEST_F(Http1ServerConnectionImplTest, RawHeaderPassthrough) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.http1_raw_header_passthrough", "true"}});
+  initialize();
+
+  NiceMock<MockRequestDecoder> decoder;
+  EXPECT_CALL(callbacks_, newStream(_, _)).WillOnce(ReturnRef(decoder));
+  RequestHeaderMapPtr headers;
+  EXPECT_CALL(decoder, decodeHeaders_(_, true))
+      .WillOnce(Invoke([&](RequestHeaderMapPtr& decoded, bool) { headers = std::move(decoded); }));
+
+  Buffer::OwnedImpl buffer("GET / HTTP/1.1\r\nHost: host\r\nX-Foo:  bar \r\nx-baz: 1\r\n\r\n");
+  auto status = codec_->dispatch(buffer);
+  EXPECT_TRUE(status.ok());
+
+  const RawHeaderBlock* raw_header_block = HeaderMapImpl::rawHeaderBlock(*headers);
+  ASSERT_NE(nullptr, raw_header_block);
+  EXPECT_EQ(3, raw_header_block->size());
+  EXPECT_EQ("host: host\r\nx-foo:  bar \r\nx-baz: 1", raw_header_block->lines(0, 2));
+}
+
+TEST_F(Http1ServerConnectionImplTest, InvalidHeaderNameSimdParser) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.http1_use_simd_parser", "true"}});
+  initialize();
+
+  MockRequestDecoder decoder;
+  EXPECT_CALL(callbacks_, newStream(_, _)).WillOnce(ReturnRef(decoder));
+  EXPECT_CALL(decoder, sendLocalReply(_, Http::Code::BadRequest, _, _, _, _));
+
+  Buffer::OwnedImpl buffer("GET / HTTP/1.1\r\nbad header: value\r\n\r\n");
+  auto status = codec_->dispatch(buffer);
+  EXPECT_TRUE(isCodecProtocolError(status));
+  EXPECT_EQ(status.message(), "http/1.1 protocol error: HPE_INVALID_HEADER_TOKEN");
+}
+
 TEST_F(Http1ServerConnectionImplTest, ChunkedBodyCase) {
   initialize();
 
@@ -1495,6 +1611,40 @@ TEST_F(Http1ServerConnectionImplTest, ChunkedResponse) {
             output);
 }
 
+// Verify that a header block larger than a default buffer slice is still serialized into a single
+// slice of the codec's output buffer.
+TEST_F(Http1ServerConnectionImplTest, LargeResponseHeadersEncodedIntoSingleSlice) {
+  initialize();
+
+  NiceMock<MockRequestDecoder> decoder;
+  Http::ResponseEncoder* response_encoder = nullptr;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .WillOnce(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+        response_encoder = &encoder;
+        return decoder;
+      }));
+
+  Buffer::OwnedImpl buffer("GET / HTTP/1.1\r\n\r\n");
+  auto status = codec_->dispatch(buffer);
+  EXPECT_TRUE(status.ok());
+
+  std::string output;
+  ON_CALL(connection_, write(_, _)).WillByDefault(Invoke([&output](Buffer::Instance& data, bool) {
+    ASSERT_EQ(1, data.getRawSlices().size());
+    output.append(data.toString());
+    data.drain(data.length());
+  }));
+
+  const std::string long_value(32 * 1024, 'a');
+  TestResponseHeaderMapImpl headers{
+      {":status", "200"}, {"x-long", long_value}, {"x-short", "b"}, {"content-length", "0"}};
+  response_encoder->encodeHeaders(headers, false);
+
+  EXPECT_EQ(absl::StrCat("HTTP/1.1 200 OK\r\nx-long: ", long_value,
+                         "\r\nx-short: b\r\ncontent-length: 0\r\n\r\n"),
+            output);
+}
+
 TEST_F(Http1ServerConnectionImplTest, ChunkedResponseWithTrailers) {
   codec_settings_.enable_trailers_ = true;
   initialize();
@@ -1629,6 +1779,108 @@ TEST_F(Http1ServerConnectionImplTest, DoubleRequest) {
   EXPECT_EQ(0U, buffer.length());
 }
 
+// Verify that the output of a response encoded while dispatching is written once the dispatch is
+// over, in a single connection write.
+TEST_F(Http1ServerConnectionImplTest, CoalescedResponseWrites) {
+  codec_settings_.coalesce_response_writes_ = true;
+  initialize();
+
+  NiceMock<MockRequestDecoder> decoder;
+  Http::ResponseEncoder* response_encoder = nullptr;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .WillOnce(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+        response_encoder = &encoder;
+        return decoder;
+      }));
+  EXPECT_CALL(decoder, decodeHeaders_(_, true)).WillOnce(Invoke([&](RequestHeaderMapPtr&, bool) {
+    response_encoder->encodeHeaders(TestResponseHeaderMapImpl{{":status", "200"}}, false);
+    Buffer::OwnedImpl data("Hello World");
+    response_encoder->encodeData(data, true);
+    EXPECT_TRUE(codec_->wantsToWrite());
+  }));
+
+  std::string output;
+  EXPECT_CALL(connection_, write(_, _)).WillOnce(AddBufferToString(&output));
+  Buffer::OwnedImpl buffer("GET / HTTP/1.1\r\n\r\n");
+  auto status = codec_->dispatch(buffer);
+  EXPECT_TRUE(status.ok());
+  EXPECT_FALSE(codec_->wantsToWrite());
+  EXPECT_EQ("HTTP/1.1 200 OK\r\ntransfer-encoding: chunked\r\n\r\nb\r\nHello "
+            "World\r\n0\r\n\r\n",
+            output);
+}
+
+// Verify that the headers of a response are held until its first body data is encoded.
+TEST_F(Http1ServerConnectionImplTest, HeldResponseHeadersWrittenWithBody) {
+  codec_settings_.coalesce_response_writes_ = true;
+  codec_settings_.response_headers_hold_time_ = std::chrono::milliseconds(5);
+  auto* hold_timer = new Event::MockTimer(&connection_.dispatcher_);
+  initialize();
+
+  NiceMock<MockRequestDecoder> decoder;
+  Http::ResponseEncoder* response_encoder = nullptr;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .WillOnce(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+        response_encoder = &encoder;
+        return decoder;
+      }));
+
+  Buffer::OwnedImpl buffer("GET / HTTP/1.1\r\n\r\n");
+  auto status = codec_->dispatch(buffer);
+  EXPECT_TRUE(status.ok());
+
+  std::string output;
+  EXPECT_CALL(connection_, write(_, _)).Times(0);
+  EXPECT_CALL(*hold_timer, enableTimer(std::chrono::milliseconds(5), _));
+  response_encoder->encodeHeaders(TestResponseHeaderMapImpl{{":status", "200"}}, false);
+  EXPECT_TRUE(codec_->wantsToWrite());
+
+  EXPECT_CALL(connection_, write(_, _)).WillOnce(AddBufferToString(&output));
+  Buffer::OwnedImpl data("Hello World");
+  response_encoder->encodeData(data, true);
+  EXPECT_FALSE(hold_timer->enabled());
+  EXPECT_EQ("HTTP/1.1 200 OK\r\ntransfer-encoding: chunked\r\n\r\nb\r\nHello "
+            "World\r\n0\r\n\r\n",
+            output);
+}
+
+// Verify that held headers are written once the hold time is over, and that the headers of 1xx
+// responses are not held.
+TEST_F(Http1ServerConnectionImplTest, HeldResponseHeadersWrittenOnTimeout) {
+  codec_settings_.coalesce_response_writes_ = true;
+  codec_settings_.response_headers_hold_time_ = std::chrono::milliseconds(5);
+  auto* hold_timer = new Event::MockTimer(&connection_.dispatcher_);
+  initialize();
+
+  NiceMock<MockRequestDecoder> decoder;
+  Http::ResponseEncoder* response_encoder = nullptr;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .WillOnce(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+        response_encoder = &encoder;
+        return decoder;
+      }));
+
+  Buffer::OwnedImpl buffer("GET / HTTP/1.1\r\n\r\n");
+  auto status = codec_->dispatch(buffer);
+  EXPECT_TRUE(status.ok());
+
+  std::string output;
+  EXPECT_CALL(connection_, write(_, _)).WillOnce(AddBufferToString(&output));
+  response_encoder->encode100ContinueHeaders(TestResponseHeaderMapImpl{{":status", "100"}});
+  EXPECT_FALSE(hold_timer->enabled());
+  EXPECT_EQ("HTTP/1.1 100 Continue\r\n\r\n", output);
+
+  output.clear();
+  response_encoder->encodeHeaders(TestResponseHeaderMapImpl{{":status", "200"}}, false);
+  EXPECT_TRUE(hold_timer->enabled());
+  EXPECT_EQ("", output);
+
+  EXPECT_CALL(connection_, write(_, _)).WillOnce(AddBufferToString(&output));
+  hold_timer->invokeCallback();
+  EXPECT_EQ("HTTP/1.1 200 OK\r\ntransfer-encoding: chunked\r\n\r\n", output);
+  EXPECT_FALSE(codec_->wantsToWrite());
+}
+
 TEST_F(Http1ServerConnectionImplTest, RequestWithTrailersDropped) { expectTrailersTest(false); }
 
 TEST_F(Http1ServerConnectionImplTest, RequestWithTrailersKept) { expectTrailersTest(true); }
@@ -2009,6 +2261,35 @@ TEST_F(Http1ClientConnectionImplTest, SimpleGet) {
   EXPECT_EQ("GET / HTTP/1.1\r\ncontent-length: 0\r\n\r\n", output);
 }
 
+// Verify that runs of unmodified headers are copied from the header lines they were decoded from,
+// and that added and removed headers are handled.
+TEST_F(Http1ClientConnectionImplTest, RawHeaderPassthrough) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.http1_raw_header_passthrough", "true"}});
+  initialize();
+
+  MockResponseDecoder response_decoder;
+  Http::RequestEncoder& request_encoder = codec_->newStream(response_decoder);
+
+  std::string output;
+  ON_CALL(connection_, write(_, _)).WillByDefault(AddBufferToString(&output));
+
+  auto headers = RequestHeaderMapImpl::create();
+  headers->setMethod("GET");
+  headers->setPath("/");
+  headers->setHost("host");
+  headers->addCopy(LowerCaseString("x-foo"), "bar");
+  headers->addCopy(LowerCaseString("x-added"), "1");
+  headers->addCopy(LowerCaseString("x-baz"), "1");
+  headers->setRawHeaderBlock(
+      RawHeaderBlock::create("Host: host\r\nX-Foo:  bar \r\nX-Removed: 1\r\nx-baz: 1"));
+  EXPECT_TRUE(request_encoder.encodeHeaders(*headers, true).ok());
+  EXPECT_EQ("GET / HTTP/1.1\r\nhost: host\r\nx-foo:  bar \r\nx-added: 1\r\nx-baz: 1\r\n"
+            "content-length: 0\r\n\r\n",
+            output);
+}
+
 TEST_F(Http1ClientConnectionImplTest, SimpleGetWithHeaderCasing) {
   codec_settings_.header_key_format_ = Http1Settings::HeaderKeyFormat::ProperCase;
 
@@ -0,0 +1,249 @@
+#include <string>
+
+#include "common/http/http1/simd_parser_impl.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+// Records the callbacks raised by the parser as a compact transcript. Consecutive spans of the
+// same element are merged so that the transcript does not depend on how the input was split.
+class RecordingCallbacks : public ParserCallbacks {
+public:
+  CallbackResult onMessageBegin() override {
+    append("begin");
+    return CallbackResult::Success;
+  }
+  CallbackResult onUrl(const char* data, size_t length) override {
+    appendSpan("url", data, length);
+    return CallbackResult::Success;
+  }
+  CallbackResult onHeaderField(const char* data, size_t length) override {
+    appendSpan("field", data, length);
+    return CallbackResult::Success;
+  }
+  CallbackResult onHeaderValue(const char* data, size_t length) override {
+    appendSpan("value", data, length);
+    return CallbackResult::Success;
+  }
+  CallbackResult onHeadersComplete() override {
+    append(absl::StrCat("headers:", parser_->methodName(), ",", parser_->statusCode(),
+                        parser_->isHttp11() ? ",1.1" : ",1.0",
+                        parser_->contentLength().has_value()
+                            ? absl::StrCat(",cl=", parser_->contentLength().value())
+                            : "",
+                        parser_->isChunked() ? ",chunked" : ""));
+    return headers_complete_result_;
+  }
+  void bufferBody(const char* data, size_t length) override { appendSpan("body", data, length); }
+  CallbackResult onMessageComplete() override {
+    append("complete");
+    // Like the codec, process one message per dispatch.
+    parser_->pause();
+    return CallbackResult::Success;
+  }
+  void onChunkHeader(bool is_final_chunk) override {
+    append(is_final_chunk ? "last-chunk" : "chunk");
+  }
+
+  std::string transcript() {
+    flush();
+    return transcript_;
+  }
+
+  Parser* parser_{};
+  CallbackResult headers_complete_result_{CallbackResult::Success};
+
+private:
+  void flush() {
+    if (!span_name_.empty()) {
+      absl::StrAppend(&transcript_, transcript_.empty() ? "" : " ", span_name_, "=", span_);
+      span_name_.clear();
+      span_.clear();
+    }
+  }
+  void append(absl::string_view event) {
+    flush();
+    absl::StrAppend(&transcript_, transcript_.empty() ? "" : " ", event);
+  }
+  void appendSpan(absl::string_view name, const char* data, size_t length) {
+    if (span_name_ != name) {
+      flush();
+      span_name_ = std::string(name);
+      span_.clear();
+    }
+    span_.append(data, length);
+  }
+
+  std::string transcript_;
+  std::string span_name_;
+  std::string span_;
+};
+
+class SimdHttpParserImplTest : public testing::Test {
+protected:
+  // Feeds the input to a new parser in pieces of at most slice_size bytes, resuming the parser and
+  // re-dispatching unconsumed data the way the codec does, and returns the transcript.
+  std::string parse(MessageType type, absl::string_view input, size_t slice_size,
+                    bool end_of_input = false,
+                    CallbackResult headers_complete_result = CallbackResult::Success) {
+    RecordingCallbacks callbacks;
+    SimdHttpParserImpl parser(type, &callbacks);
+    callbacks.parser_ = &parser;
+    callbacks.headers_complete_result_ = headers_complete_result;
+
+    std::string pending;
+    for (size_t offset = 0; offset < input.size(); offset += slice_size) {
+      pending.append(std::string(input.substr(offset, slice_size)));
+      parser.resume();
+      while (!pending.empty()) {
+        const size_t consumed = parser.execute(pending.data(), pending.size());
+        pending.erase(0, consumed);
+        if (parser.getStatus() == ParserStatus::Error) {
+          return absl::StrCat(callbacks.transcript(), " error=", parser.errorMessage());
+        }
+        if (parser.getStatus() == ParserStatus::Ok) {
+          EXPECT_TRUE(pending.empty());
+          break;
+        }
+        parser.resume();
+      }
+    }
+    if (end_of_input) {
+      parser.execute(nullptr, 0);
+      if (parser.getStatus() == ParserStatus::Error) {
+        return absl::StrCat(callbacks.transcript(), " error=", parser.errorMessage());
+      }
+    }
+    return callbacks.transcript();
+  }
+
+  // Verifies the transcript is the same however the input is split, which covers both the vector
+  // scan of long runs and the scalar scan of short ones.
+  void expectTranscript(MessageType type, absl::string_view input, absl::string_view expected,
+                        bool end_of_input = false,
+                        CallbackResult headers_complete_result = CallbackResult::Success) {
+    for (const size_t slice_size : {size_t(1), size_t(3), size_t(16), size_t(17), input.size()}) {
+      EXPECT_EQ(expected, parse(type, input, slice_size, end_of_input, headers_complete_result))
+          << "slice size " << slice_size;
+    }
+  }
+};
+
+TEST_F(SimdHttpParserImplTest, Request) {
+  expectTranscript(MessageType::Request,
+                   "GET /a/path/longer/than/sixteen?x=1 HTTP/1.1\r\n"
+                   "Host: example.com\r\n"
+                   "X-Header-Name-Longer-Than-Sixteen: a value longer than sixteen  \r\n"
+                   "Empty:\r\n"
+                   "\r\n",
+                   "begin url=/a/path/longer/than/sixteen?x=1 field=Host value=example.com "
+                   "field=X-Header-Name-Longer-Than-Sixteen value=a value longer than sixteen   "
+                   "field=Empty value= headers:GET,0,1.1 complete");
+}
+
+TEST_F(SimdHttpParserImplTest, PipelinedRequestsWithBody) {
+  expectTranscript(MessageType::Request,
+                   "\r\nPOST / HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello"
+                   "GET / HTTP/1.0\nConnection: keep-alive\n\n",
+                   "begin url=/ field=Content-Length value=5 headers:POST,0,1.1,cl=5 body=hello "
+                   "complete begin url=/ field=Connection value=keep-alive headers:GET,0,1.0 "
+                   "complete");
+}
+
+TEST_F(SimdHttpParserImplTest, ChunkedRequestWithTrailers) {
+  expectTranscript(MessageType::Request,
+                   "POST / HTTP/1.1\r\nTransfer-Encoding: gzip, chunked\r\n\r\n"
+                   "5;ext=1\r\nhello\r\n"
+                   "1A\r\nabcdefghijklmnopqrstuvwxyz\r\n"
+                   "0\r\nTrailer: x\r\n\r\n",
+                   "begin url=/ field=Transfer-Encoding value=gzip, chunked "
+                   "headers:POST,0,1.1,chunked chunk body=hello chunk "
+                   "body=abcdefghijklmnopqrstuvwxyz last-chunk field=Trailer value=x complete");
+}
+
+TEST_F(SimdHttpParserImplTest, TokenCharactersInHeaderName) {
+  expectTranscript(MessageType::Request, "GET / HTTP/1.1\r\nx|~!#$%&'*+-.^_`: a\r\n\r\n",
+                   "begin url=/ field=x|~!#$%&'*+-.^_` value=a headers:GET,0,1.1 complete");
+}
+
+TEST_F(SimdHttpParserImplTest, ConnectionClose) {
+  expectTranscript(MessageType::Request,
+                   "GET / HTTP/1.1\r\nConnection: close\r\n\r\nGET / HTTP/1.1\r\n\r\n",
+                   "begin url=/ field=Connection value=close headers:GET,0,1.1 complete "
+                   "error=HPE_CLOSED_CONNECTION");
+}
+
+TEST_F(SimdHttpParserImplTest, Upgrade) {
+  EXPECT_EQ("begin url=/ field=Connection value=upgrade field=Upgrade value=websocket "
+            "headers:GET,0,1.1 complete",
+            parse(MessageType::Request,
+                  "GET / HTTP/1.1\r\nConnection: upgrade\r\nUpgrade: websocket\r\n\r\n", 1024));
+  // The parser stops at the end of the upgrade request, leaving the payload unconsumed.
+  RecordingCallbacks callbacks;
+  SimdHttpParserImpl parser(MessageType::Request, &callbacks);
+  callbacks.parser_ = &parser;
+  const std::string input = "CONNECT host:443 HTTP/1.1\r\n\r\npayload";
+  EXPECT_EQ(input.size() - 7, parser.execute(input.data(), input.size()));
+}
+
+TEST_F(SimdHttpParserImplTest, InvalidRequests) {
+  expectTranscript(MessageType::Request, "FOO / HTTP/1.1\r\n\r\n",
+                   "begin error=HPE_INVALID_METHOD");
+  expectTranscript(MessageType::Request, "GET /\r\n\r\n", "begin url=/ error=HPE_INVALID_VERSION");
+  expectTranscript(MessageType::Request, "GET / HTTP/1.1\r\nA: b\r\n folded\r\n\r\n",
+                   "begin url=/ field=A value=b error=HPE_INVALID_HEADER_TOKEN");
+  expectTranscript(MessageType::Request, "GET / HTTP/1.1\r\nBad Name: x\r\n\r\n",
+                   "begin url=/ field=Bad error=HPE_INVALID_HEADER_TOKEN");
+  expectTranscript(MessageType::Request, "GET / HTTP/1.1\rA: b\r\n\r\n",
+                   "begin url=/ error=HPE_LF_EXPECTED");
+  expectTranscript(MessageType::Request,
+                   "GET / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 1\r\n\r\n",
+                   "begin url=/ field=Content-Length value=1 field=Content-Length value=1 "
+                   "error=HPE_UNEXPECTED_CONTENT_LENGTH");
+  expectTranscript(MessageType::Request, "GET / HTTP/1.1\r\nContent-Length: 1x\r\n\r\n",
+                   "begin url=/ field=Content-Length value=1x error=HPE_INVALID_CONTENT_LENGTH");
+  expectTranscript(MessageType::Request, "POST / HTTP/1.1\r\nTransfer-Encoding: gzip\r\n\r\n",
+                   "begin url=/ field=Transfer-Encoding value=gzip headers:POST,0,1.1 "
+                   "error=HPE_INVALID_TRANSFER_ENCODING");
+  expectTranscript(MessageType::Request,
+                   "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nz\r\n",
+                   "begin url=/ field=Transfer-Encoding value=chunked headers:POST,0,1.1,chunked "
+                   "error=HPE_INVALID_CHUNK_SIZE");
+}
+
+TEST_F(SimdHttpParserImplTest, Response) {
+  expectTranscript(MessageType::Response, "HTTP/1.1 200 OK\r\nContent-Length: 3\r\n\r\nabc",
+                   "begin field=Content-Length value=3 headers:,200,1.1,cl=3 body=abc complete");
+  expectTranscript(MessageType::Response,
+                   "HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 204 No Content\r\n\r\n",
+                   "begin headers:,100,1.1 complete begin headers:,204,1.1 complete");
+  expectTranscript(MessageType::Response, "HTTP/1.1 2x0 OK\r\n\r\n",
+                   "begin error=HPE_INVALID_STATUS");
+}
+
+TEST_F(SimdHttpParserImplTest, ResponseDelimitedByEndOfInput) {
+  expectTranscript(MessageType::Response, "HTTP/1.1 200 OK\r\n\r\nuntil the connection closes",
+                   "begin headers:,200,1.1 body=until the connection closes complete",
+                   /*end_of_input=*/true);
+  expectTranscript(MessageType::Response, "HTTP/1.1 200 OK\r\nContent-Length: 3\r\n\r\na",
+                   "begin field=Content-Length value=3 headers:,200,1.1,cl=3 body=a "
+                   "error=HPE_INVALID_EOF_STATE",
+                   /*end_of_input=*/true);
+}
+
+TEST_F(SimdHttpParserImplTest, ResponseWithoutBody) {
+  // The codec reports that a response to a HEAD request has no body.
+  expectTranscript(MessageType::Response, "HTTP/1.1 200 OK\r\nContent-Length: 3\r\n\r\n",
+                   "begin field=Content-Length value=3 headers:,200,1.1,cl=3 complete",
+                   /*end_of_input=*/false, CallbackResult::NoBody);
+}
+
+} // namespace
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -331,6 +331,34 @@ protected:
   }
 };
 
+// The names and values of the HPACK static table are referenced rather than copied.
+TEST_P(Http2CodecImplTest, StaticTableHeadersReferenced) {
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  request_headers.addCopy("accept-language", "en");
+  request_headers.addCopy("x-custom", "custom");
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true))
+      .WillOnce(Invoke([](RequestHeaderMapPtr& headers, bool) {
+        const auto language = headers->get(LowerCaseString("accept-language"));
+        ASSERT_EQ(1, language.size());
+        EXPECT_TRUE(language[0]->key().isReference());
+        EXPECT_FALSE(language[0]->value().isReference());
+        EXPECT_EQ("en", language[0]->value().getStringView());
+
+        const auto custom = headers->get(LowerCaseString("x-custom"));
+        ASSERT_EQ(1, custom.size());
+        EXPECT_FALSE(custom[0]->key().isReference());
+        EXPECT_EQ("custom", custom[0]->value().getStringView());
+
+        // ":scheme: http" is a full entry of the static table.
+        EXPECT_TRUE(headers->Scheme()->value().isReference());
+        EXPECT_EQ("http", headers->getSchemeValue());
+      }));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, true).ok());
+}
+
 TEST_P(Http2CodecImplTest, ShutdownNotice) {
   initialize();
   EXPECT_EQ(absl::nullopt, request_encoder_->http1StreamEncoderOptions());
@@ -389,6 +417,48 @@ TEST_P(Http2CodecImplTest, TrailerStatus) {
   EXPECT_EQ(1, client_stats_store_.counter("http2.rx_messaging_error").value());
 };
 
+// Verify that DATA frames end on slice boundaries, so that body slices are moved into the
+// connection's write buffer rather than copied.
+TEST_P(Http2CodecImplTest, DataFramesEndOnSliceBoundaries) {
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, true).ok());
+
+  TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+  EXPECT_CALL(response_decoder_, decodeHeaders_(_, false));
+  response_encoder_->encodeHeaders(response_headers, false);
+
+  // Three 6000 byte slices, two of which fit in a frame of the default 16384 byte maximum size.
+  const std::string slice_data(6000, 'a');
+  std::vector<std::unique_ptr<Buffer::BufferFragmentImpl>> fragments;
+  Buffer::OwnedImpl body;
+  for (int i = 0; i < 3; ++i) {
+    fragments.push_back(std::make_unique<Buffer::BufferFragmentImpl>(
+        slice_data.data(), slice_data.size(), nullptr));
+    body.addBufferFragment(*fragments.back());
+  }
+
+  std::vector<uint64_t> payload_slice_lengths;
+  ON_CALL(server_connection_, write(_, _))
+      .WillByDefault(Invoke([&](Buffer::Instance& data, bool) -> void {
+        for (const Buffer::RawSlice& slice : data.getRawSlices()) {
+          if (slice.mem_ == slice_data.data()) {
+            payload_slice_lengths.push_back(slice.len_);
+          }
+        }
+        auto status = client_wrapper_.dispatch(data, *client_);
+        EXPECT_TRUE(status.ok());
+      }));
+  EXPECT_CALL(response_decoder_, decodeData(_, false)).Times(AtLeast(1));
+  EXPECT_CALL(response_decoder_, decodeData(_, true));
+  response_encoder_->encodeData(body, true);
+
+  EXPECT_EQ(std::vector<uint64_t>({6000, 6000, 6000}), payload_slice_lengths);
+}
+
 // Multiple 100 responses are passed to the response encoder (who is responsible for coalescing).
 TEST_P(Http2CodecImplTest, MultipleContinueHeaders) {
   initialize();
@@ -947,6 +1017,50 @@ TEST_P(Http2CodecImplTest, ConnectionKeepaliveJitter) {
   EXPECT_EQ(max_observed.count(), max_expected.count());
 }
 
+// Validate that the auto-tuned flow-control windows start small, grow with the bytes received while
+// a PING is in flight, and shrink back once a stream backs up.
+TEST_P(Http2CodecImplTest, WindowAutoTuning) {
+  server_http2_options_.mutable_window_auto_tuning();
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers, "POST");
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, false).ok());
+  EXPECT_EQ(NGHTTP2_INITIAL_WINDOW_SIZE,
+            nghttp2_session_get_effective_local_window_size(server_->session()));
+  EXPECT_EQ(NGHTTP2_INITIAL_WINDOW_SIZE,
+            nghttp2_session_get_stream_remote_window_size(client_->session(), 1));
+
+  // Hold the frames of the server, among which its PING, until the client sent most of the window,
+  // as a long round-trip time would.
+  Buffer::OwnedImpl server_frames;
+  ON_CALL(server_connection_, write(_, _))
+      .WillByDefault(Invoke([&](Buffer::Instance& data, bool) { server_frames.move(data); }));
+  EXPECT_CALL(request_decoder_, decodeData(_, false)).Times(AnyNumber());
+  Buffer::OwnedImpl data(std::string(60000, 'a'));
+  request_encoder_->encodeData(data, false);
+  EXPECT_EQ(0, server_stats_store_.counter("http2.window_auto_tuning_grow").value());
+
+  setupDefaultConnectionMocks();
+  EXPECT_TRUE(client_wrapper_.dispatch(server_frames, *client_).ok());
+  EXPECT_EQ(1, server_stats_store_.counter("http2.window_auto_tuning_grow").value());
+  EXPECT_EQ(120000, nghttp2_session_get_effective_local_window_size(server_->session()));
+  EXPECT_EQ(120000, nghttp2_session_get_local_settings(server_->session(),
+                                                       NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE));
+
+  // Once the data of the stream is no longer passed on, the windows shrink back.
+  server_->getStream(1)->readDisable(true);
+  Buffer::OwnedImpl more_data(std::string(1000, 'a'));
+  request_encoder_->encodeData(more_data, false);
+  EXPECT_EQ(1, server_stats_store_.counter("http2.window_auto_tuning_shrink").value());
+  EXPECT_EQ(NGHTTP2_INITIAL_WINDOW_SIZE,
+            nghttp2_session_get_effective_local_window_size(server_->session()));
+  EXPECT_EQ(NGHTTP2_INITIAL_WINDOW_SIZE,
+            nghttp2_session_get_local_settings(server_->session(),
+                                               NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE));
+}
+
 class Http2CodecImplDeferredResetTest : public Http2CodecImplTest {};
 
 TEST_P(Http2CodecImplDeferredResetTest, DeferredResetClient) {
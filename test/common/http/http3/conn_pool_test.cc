@@ -0,0 +1,299 @@
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "envoy/extensions/transport_sockets/tls/v3/cert.pb.h"
+
+#include "common/http/http3/conn_pool.h"
+#include "common/http/http3/well_known_names.h"
+#include "common/network/utility.h"
+#include "common/upstream/upstream_impl.h"
+
+#include "extensions/quic_listeners/quiche/client_connection_factory_impl.h"
+#include "extensions/quic_listeners/quiche/quic_transport_socket_factory.h"
+#include "extensions/transport_sockets/tls/context_config_impl.h"
+
+#include "test/common/http/common.h"
+#include "test/common/upstream/utility.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/server/transport_socket_factory_context.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/test_common/registry.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::InSequence;
+using testing::NiceMock;
+using testing::Ref;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Http {
+namespace Http3 {
+namespace {
+
+class MockQuicClientConnectionFactory : public QuicClientConnectionFactory {
+public:
+  PersistentQuicInfoPtr createNetworkConnectionInfo(Event::Dispatcher&,
+                                                    Network::TransportSocketFactory&, Stats::Scope&,
+                                                    TimeSource&,
+                                                    Network::Address::InstanceConstSharedPtr,
+                                                    uint32_t buffer_limit,
+                                                    bool allow_early_data) override {
+    return PersistentQuicInfoPtr{createNetworkConnectionInfo_(buffer_limit, allow_early_data)};
+  }
+  Network::ClientConnectionPtr
+  createQuicNetworkConnection(PersistentQuicInfo& info, Event::Dispatcher&,
+                              Network::Address::InstanceConstSharedPtr server_addr,
+                              Network::Address::InstanceConstSharedPtr) override {
+    return Network::ClientConnectionPtr{createQuicNetworkConnection_(info, server_addr)};
+  }
+  std::string name() const override { return QuicCodecNames::get().Quiche; }
+
+  MOCK_METHOD(PersistentQuicInfo*, createNetworkConnectionInfo_,
+              (uint32_t buffer_limit, bool allow_early_data));
+  MOCK_METHOD(Network::ClientConnection*, createQuicNetworkConnection_,
+              (PersistentQuicInfo & info, Network::Address::InstanceConstSharedPtr server_addr));
+};
+
+class TestConnPoolImpl : public Http3ConnPoolImpl {
+public:
+  TestConnPoolImpl(Event::Dispatcher& dispatcher, Random::RandomGenerator& random_generator,
+                   Upstream::HostConstSharedPtr host, Upstream::ResourcePriority priority,
+                   Upstream::ClusterConnectivityState& state)
+      : Http3ConnPoolImpl(
+            std::move(host), priority, dispatcher, nullptr, nullptr, random_generator, state,
+            [](HttpConnPoolImplBase* pool) {
+              Upstream::Host::CreateConnectionData data =
+                  static_cast<Http3ConnPoolImpl*>(pool)->createConnection();
+              return std::make_unique<ActiveClient>(*pool, data);
+            },
+            [](Upstream::Host::CreateConnectionData&, HttpConnPoolImplBase*) { return nullptr; },
+            std::vector<Protocol>{Protocol::Http3}) {}
+
+  CodecClientPtr createCodecClient(Upstream::Host::CreateConnectionData& data) override {
+    // The test client owns the connection already, so release it to not delete it twice.
+    data.connection_.release();
+    return CodecClientPtr{createCodecClient_(data)};
+  }
+
+  MOCK_METHOD(CodecClient*, createCodecClient_, (Upstream::Host::CreateConnectionData & data));
+};
+
+class Http3ConnPoolImplTest : public Event::TestUsingSimulatedTime, public testing::Test {
+public:
+  struct TestCodecClient {
+    Http::MockClientConnection* codec_;
+    Network::MockClientConnection* connection_;
+    CodecClientForTest* codec_client_;
+    Event::MockTimer* connect_timer_;
+    Event::DispatcherPtr client_dispatcher_;
+  };
+
+  Http3ConnPoolImplTest() : api_(Api::createApiForTest(stats_store_)) {
+    cluster_->resetResourceManager(1024, 1024, 1024, 1, 1);
+    ON_CALL(*cluster_, perConnectionBufferLimitBytes()).WillByDefault(Return(4096));
+  }
+
+  ~Http3ConnPoolImplTest() override {
+    EXPECT_EQ("", TestUtility::nonZeroedGauges(cluster_->stats_store_.gauges()));
+  }
+
+  void createPool() {
+    quic_info_ = new PersistentQuicInfo();
+    EXPECT_CALL(factory_, createNetworkConnectionInfo_(4096, allow_early_data_))
+        .WillOnce(Return(quic_info_));
+    new NiceMock<Event::MockSchedulableCallback>(&dispatcher_);
+    pool_ = std::make_unique<TestConnPoolImpl>(dispatcher_, random_, host_,
+                                               Upstream::ResourcePriority::Default, state_);
+  }
+
+  // Expects a QUIC connection to be created for a new active client, before its connect timer.
+  void expectClientCreate() {
+    test_clients_.emplace_back();
+    TestCodecClient& test_client = test_clients_.back();
+    test_client.connection_ = new NiceMock<Network::MockClientConnection>();
+    test_client.codec_ = new NiceMock<Http::MockClientConnection>();
+    test_client.client_dispatcher_ = api_->allocateDispatcher("test_thread");
+    auto cluster = std::make_shared<NiceMock<Upstream::MockClusterInfo>>();
+    test_client.codec_client_ = new CodecClientForTest(
+        CodecClient::Type::HTTP3, Network::ClientConnectionPtr{test_client.connection_},
+        test_client.codec_, [this](CodecClient*) -> void { onClientDestroy(); },
+        Upstream::makeTestHost(cluster, "tcp://127.0.0.1:9000", simTime()),
+        *test_client.client_dispatcher_);
+
+    EXPECT_CALL(factory_, createQuicNetworkConnection_(Ref(*quic_info_), host_->address()))
+        .WillOnce(Return(test_client.connection_));
+    test_client.connect_timer_ = new NiceMock<Event::MockTimer>(&dispatcher_);
+    EXPECT_CALL(*pool_, createCodecClient_(_)).WillOnce(Return(test_client.codec_client_));
+  }
+
+  void expectStreamReady(size_t index, ConnPoolCallbacks& callbacks,
+                         NiceMock<MockRequestEncoder>& encoder) {
+    EXPECT_CALL(*test_clients_[index].codec_, newStream(_)).WillOnce(ReturnRef(encoder));
+    EXPECT_CALL(callbacks.pool_ready_, ready());
+  }
+
+  void closeAllClients() {
+    for (auto& test_client : test_clients_) {
+      test_client.connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+    }
+    EXPECT_CALL(*this, onClientDestroy()).Times(test_clients_.size());
+    dispatcher_.clearDeferredDeleteList();
+  }
+
+  MOCK_METHOD(void, onClientDestroy, ());
+
+  Stats::IsolatedStoreImpl stats_store_;
+  Api::ApiPtr api_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  std::shared_ptr<Upstream::MockClusterInfo> cluster_{new NiceMock<Upstream::MockClusterInfo>()};
+  Upstream::HostSharedPtr host_{Upstream::makeTestHost(cluster_, "tcp://127.0.0.1:443", simTime())};
+  NiceMock<Random::MockRandomGenerator> random_;
+  Upstream::ClusterConnectivityState state_;
+  MockQuicClientConnectionFactory factory_;
+  Registry::InjectFactory<QuicClientConnectionFactory> inject_factory_{factory_};
+  bool allow_early_data_{false};
+  PersistentQuicInfo* quic_info_{};
+  std::unique_ptr<TestConnPoolImpl> pool_;
+  std::vector<TestCodecClient> test_clients_;
+};
+
+/**
+ * Verify that the pool creates what its connections share once, with the options of the cluster.
+ */
+TEST_F(Http3ConnPoolImplTest, Host) {
+  createPool();
+  EXPECT_EQ(host_, pool_->host());
+}
+
+/**
+ * Verify that early data is only allowed if the cluster opts in.
+ */
+TEST_F(Http3ConnPoolImplTest, AllowEarlyData) {
+  cluster_->http3_options_.set_allow_early_data(true);
+  allow_early_data_ = true;
+  createPool();
+}
+
+/**
+ * Verify that a request is sent on a QUIC connection created by the factory, once connected.
+ */
+TEST_F(Http3ConnPoolImplTest, RequestAndResponse) {
+  createPool();
+  InSequence s;
+
+  expectClientCreate();
+  MockResponseDecoder decoder;
+  ConnPoolCallbacks callbacks;
+  EXPECT_NE(nullptr, pool_->newStream(decoder, callbacks));
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_http3_total_.value());
+
+  NiceMock<MockRequestEncoder> encoder;
+  expectStreamReady(0, callbacks, encoder);
+  test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  EXPECT_CALL(encoder, encodeHeaders(_, true));
+  EXPECT_TRUE(
+      callbacks.outer_encoder_
+          ->encodeHeaders(TestRequestHeaderMapImpl{{":path", "/"}, {":method", "GET"}}, true)
+          .ok());
+  encoder.stream_.resetStream(StreamResetReason::RemoteReset);
+
+  closeAllClients();
+  EXPECT_EQ(1U, cluster_->stats_.upstream_rq_rx_reset_.value());
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_active_.value());
+}
+
+/**
+ * Verify that the concurrent streams of a connection are limited by the HTTP/3 options of the
+ * cluster.
+ */
+TEST_F(Http3ConnPoolImplTest, MaxConcurrentStreams) {
+  cluster_->http3_options_.mutable_max_concurrent_streams()->set_value(1);
+  createPool();
+  InSequence s;
+
+  expectClientCreate();
+  MockResponseDecoder decoder1;
+  ConnPoolCallbacks callbacks1;
+  EXPECT_NE(nullptr, pool_->newStream(decoder1, callbacks1));
+
+  expectClientCreate();
+  MockResponseDecoder decoder2;
+  ConnPoolCallbacks callbacks2;
+  EXPECT_NE(nullptr, pool_->newStream(decoder2, callbacks2));
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_http3_total_.value());
+
+  NiceMock<MockRequestEncoder> encoder1;
+  expectStreamReady(0, callbacks1, encoder1);
+  test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  NiceMock<MockRequestEncoder> encoder2;
+  expectStreamReady(1, callbacks2, encoder2);
+  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  encoder1.stream_.resetStream(StreamResetReason::RemoteReset);
+  encoder2.stream_.resetStream(StreamResetReason::RemoteReset);
+  closeAllClients();
+}
+
+class QuicClientConnectionFactoryImplTest : public testing::Test {
+public:
+  std::unique_ptr<Quic::PersistentQuicInfoImpl> createInfo(const std::string& sni,
+                                                           bool allow_early_data) {
+    envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext tls_context;
+    tls_context.set_sni(sni);
+    socket_factories_.push_back(std::make_unique<Quic::QuicClientTransportSocketFactory>(
+        std::make_unique<Extensions::TransportSockets::Tls::ClientContextConfigImpl>(
+            tls_context, factory_context_)));
+    PersistentQuicInfoPtr info = factory_.createNetworkConnectionInfo(
+        dispatcher_, *socket_factories_.back(), stats_store_, time_system_, server_addr_, 1024,
+        allow_early_data);
+    return std::unique_ptr<Quic::PersistentQuicInfoImpl>(
+        static_cast<Quic::PersistentQuicInfoImpl*>(info.release()));
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context_;
+  Stats::IsolatedStoreImpl stats_store_;
+  Network::Address::InstanceConstSharedPtr server_addr_{
+      Network::Utility::resolveUrl("udp://127.0.0.1:443")};
+  Quic::QuicClientConnectionFactoryImpl factory_;
+  std::vector<std::unique_ptr<Quic::QuicClientTransportSocketFactory>> socket_factories_;
+};
+
+/**
+ * Verify that the connections to a server share its id, which names the server by its SNI and
+ * falls back to its address.
+ */
+TEST_F(QuicClientConnectionFactoryImplTest, ServerId) {
+  auto info = createInfo("example.com", false);
+  EXPECT_EQ("example.com", info->server_id_.host());
+  EXPECT_EQ(443, info->server_id_.port());
+  EXPECT_EQ(1024U, info->buffer_limit_);
+  EXPECT_FALSE(info->allow_early_data_);
+
+  auto address_info = createInfo("", true);
+  EXPECT_EQ("127.0.0.1", address_info->server_id_.host());
+  EXPECT_TRUE(address_info->allow_early_data_);
+}
+
+/**
+ * Verify that the QUICHE factory is the one the pool looks up.
+ */
+TEST_F(QuicClientConnectionFactoryImplTest, Registered) {
+  EXPECT_NE(nullptr, Registry::FactoryRegistry<QuicClientConnectionFactory>::getFactory(
+                         QuicCodecNames::get().Quiche));
+}
+
+} // namespace
+} // namespace Http3
+} // namespace Http
+} // namespace Envoy
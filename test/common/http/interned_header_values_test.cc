@@ -0,0 +1,56 @@
+#include <string>
+
+#include "common/http/headers.h"
+#include "common/http/interned_header_values.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+TEST(InternedHeaderValuesTest, Find) {
+  const InternedHeaderValues& values = InternedValues::get();
+
+  const std::string json(Headers::get().ContentTypeValues.Json);
+  EXPECT_EQ(json, values.find(json));
+  EXPECT_NE(json.data(), values.find(json).data());
+  EXPECT_EQ(values.find(json).data(), values.find(json).data());
+
+  EXPECT_EQ("0", values.find("0"));
+  EXPECT_EQ("200", values.find("200"));
+  EXPECT_EQ("1023", values.find("1023"));
+  EXPECT_EQ("GET", values.find("GET"));
+  EXPECT_EQ("trailers", values.find("trailers"));
+
+  EXPECT_TRUE(values.find("").empty());
+  EXPECT_TRUE(values.find("1024").empty());
+  EXPECT_TRUE(values.find("get").empty());
+  EXPECT_TRUE(values.find("application/json; charset=UTF-8").empty());
+  EXPECT_TRUE(values.find(std::string(1024, 'a')).empty());
+}
+
+TEST(InternedHeaderValuesTest, SetValue) {
+  const InternedHeaderValues& values = InternedValues::get();
+
+  HeaderString header;
+  values.setValue(header, "200");
+  EXPECT_TRUE(header.isReference());
+  EXPECT_EQ("200", header.getStringView());
+
+  values.setValue(header, "not interned");
+  EXPECT_FALSE(header.isReference());
+  EXPECT_EQ("not interned", header.getStringView());
+
+  // Modifying a header that references an interned value copies it first.
+  values.setValue(header, "text/plain");
+  EXPECT_TRUE(header.isReference());
+  header.append("; charset=UTF-8", 15);
+  EXPECT_FALSE(header.isReference());
+  EXPECT_EQ("text/plain; charset=UTF-8", header.getStringView());
+  EXPECT_EQ("text/plain", values.find("text/plain"));
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
@@ -28,7 +28,13 @@ public:
 
 // Already normalized path don't change.
 TEST_F(PathUtilityTest, AlreadyNormalPaths) {
-  const std::vector<std::string> normal_paths{"/xyz", "/x/y/z"};
+  const std::vector<std::string> normal_paths{"/xyz",
+                                              "/x/y/z",
+                                              "/",
+                                              "/x/y/",
+                                              "/a.b/c.d/e..",
+                                              "/~user/x=1;y,z/[a]:@!$&'()*+",
+                                              "/a/path/longer/than/sixteen/bytes/index.html"};
   for (const auto& path : normal_paths) {
     auto& path_header = pathHeaderEntry(path);
     const auto result = PathUtil::canonicalPath(headers_);
@@ -57,7 +63,9 @@ TEST_F(PathUtilityTest, NormalizeValidPaths) {
       {"/a/..\\c", "/c"},           // "..\\" canonicalization
       {"/%c0%af", "/%c0%af"},       // 2 bytes unicode reserved characters
       {"/%5c%25", "/%5c%25"},       // reserved characters
-      {"/a/b/%2E%2E/c", "/a/c"}     // %2E escape
+      {"/a/b/%2E%2E/c", "/a/c"},    // %2E escape
+      {"/a/b/.", "/a/b/"},          // trailing current dir
+      {"/a/b/..", "/a/"},           // trailing parent dir
   };
 
   for (const auto& path_pair : non_normal_pairs) {
@@ -69,6 +77,23 @@ TEST_F(PathUtilityTest, NormalizeValidPaths) {
   }
 }
 
+// Characters that need normalization are found past the first 16 bytes of the path.
+TEST_F(PathUtilityTest, NormalizeLongPaths) {
+  const std::vector<std::pair<std::string, std::string>> non_normal_pairs{
+      {"/a/path/longer/than/sixteen/../x", "/a/path/longer/than/x"},
+      {"/a/path/longer/than/sixteen/a b", "/a/path/longer/than/sixteen/a%20b"},
+      {"/a/path/longer/than/sixteen/a\\b", "/a/path/longer/than/sixteen/a/b"},
+      {"/a/path/longer/than/sixteen/%7e", "/a/path/longer/than/sixteen/~"},
+  };
+
+  for (const auto& path_pair : non_normal_pairs) {
+    auto& path_header = pathHeaderEntry(path_pair.first);
+    EXPECT_TRUE(PathUtil::canonicalPath(headers_)) << "original path: " << path_pair.first;
+    EXPECT_EQ(path_header.value().getStringView(), path_pair.second)
+        << "original path: " << path_pair.first;
+  }
+}
+
 // Paths that are valid get normalized.
 TEST_F(PathUtilityTest, NormalizeCasePath) {
   const std::vector<std::pair<std::string, std::string>> non_normal_pairs{
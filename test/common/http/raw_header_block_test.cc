@@ -0,0 +1,55 @@
+#include "common/http/raw_header_block.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+TEST(RawHeaderBlockTest, IndexesLines) {
+  auto block = RawHeaderBlock::create("Host: example.com\r\nX-Foo:bar \t\r\nEmpty:\r\nlast:  v");
+  ASSERT_NE(nullptr, block);
+  EXPECT_EQ(4, block->size());
+  EXPECT_EQ(0, block->find("host", "example.com", 0));
+  EXPECT_EQ(1, block->find("x-foo", "bar", 0));
+  EXPECT_EQ(2, block->find("empty", "", 0));
+  EXPECT_EQ(3, block->find("last", "v", 0));
+  EXPECT_EQ("host: example.com\r\nx-foo:bar \t", block->lines(0, 1));
+  EXPECT_EQ("last:  v", block->lines(3, 3));
+  // "x-foo:bar \t" is one byte longer than "x-foo: bar", and "last:  v" than "last: v".
+  EXPECT_EQ(2, block->paddingSize());
+}
+
+TEST(RawHeaderBlockTest, FindMatchesNameAndValue) {
+  auto block = RawHeaderBlock::create("a: 1\r\nb: 2\r\nc: 3\r\nd: 4\r\ne: 5\r\nf: 6");
+  ASSERT_NE(nullptr, block);
+  EXPECT_EQ(block->size(), block->find("a", "2", 0));
+  EXPECT_EQ(block->size(), block->find("A", "1", 0));
+  EXPECT_EQ(block->size(), block->find("a", "1", 1));
+  EXPECT_EQ(2, block->find("c", "3", 1));
+  // Lines beyond MaxLineSearch of the first line are not considered.
+  EXPECT_EQ(block->size(), block->find("f", "6", 0));
+  EXPECT_EQ(5, block->find("f", "6", 2));
+}
+
+TEST(RawHeaderBlockTest, TrailingLineTerminator) {
+  auto block = RawHeaderBlock::create("a: 1\r\nb:\r\n");
+  ASSERT_NE(nullptr, block);
+  EXPECT_EQ(2, block->size());
+  EXPECT_EQ(1, block->find("b", "", 0));
+}
+
+TEST(RawHeaderBlockTest, RejectsLinesThatCannotBeSpliced) {
+  EXPECT_EQ(nullptr, RawHeaderBlock::create(""));
+  EXPECT_EQ(nullptr, RawHeaderBlock::create("a: 1\nb: 2"));
+  EXPECT_EQ(nullptr, RawHeaderBlock::create("a: 1\r\n folded"));
+  EXPECT_EQ(nullptr, RawHeaderBlock::create("a : 1"));
+  EXPECT_EQ(nullptr, RawHeaderBlock::create(": 1"));
+  EXPECT_EQ(nullptr, RawHeaderBlock::create("a 1"));
+  EXPECT_EQ(nullptr, RawHeaderBlock::create("a: 1\r2"));
+  EXPECT_EQ(nullptr, RawHeaderBlock::create("a: 1\r\n\r\nb: 2"));
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
@@ -453,6 +453,27 @@ TEST(HttpUtility, ValidateStreamErrorConfigurationForHttp1) {
       Utility::parseHttp1Settings(http1_options, hcm_value).stream_error_on_invalid_http_message_);
 }
 
+TEST(HttpUtility, ResponseWriteCoalescingConfigurationForHttp1) {
+  envoy::config::core::v3::Http1ProtocolOptions http1_options;
+
+  Http1Settings settings = Utility::parseHttp1Settings(http1_options);
+  EXPECT_FALSE(settings.coalesce_response_writes_);
+
+  http1_options.mutable_response_write_coalescing();
+  settings = Utility::parseHttp1Settings(http1_options);
+  EXPECT_TRUE(settings.coalesce_response_writes_);
+  EXPECT_EQ(64U * 1024, settings.max_coalesced_response_bytes_);
+  EXPECT_EQ(std::chrono::milliseconds(0), settings.response_headers_hold_time_);
+
+  http1_options.mutable_response_write_coalescing()->mutable_max_coalesced_bytes()->set_value(
+      16384);
+  http1_options.mutable_response_write_coalescing()->mutable_headers_hold_time()->set_nanos(
+      2000000);
+  settings = Utility::parseHttp1Settings(http1_options);
+  EXPECT_EQ(16384U, settings.max_coalesced_response_bytes_);
+  EXPECT_EQ(std::chrono::milliseconds(2), settings.response_headers_hold_time_);
+}
+
 TEST(HttpUtility, getLastAddressFromXFF) {
   {
     const std::string first_address = "192.0.2.10";
@@ -121,6 +121,53 @@ TEST_F(LocalReplyTest, TestDefaultTextFormatter) {
   EXPECT_EQ(content_type_, "text/plain");
 }
 
+TEST_F(LocalReplyTest, TestPrerenderedFormats) {
+  // Formats which only depend on the body and the response code are rendered once per body and
+  // response code, others for every reply.
+  const std::string yaml = R"(
+  body_format:
+    json_format:
+      code: "%RESPONSE_CODE%"
+      body: "%LOCAL_REPLY_BODY%"
+  mappers:
+  - filter:
+      header_filter:
+        header:
+          name: ":path"
+          exact_match: "/path"
+    body_format_override:
+      text_format_source:
+        inline_string: "%REQ(:path)% %LOCAL_REPLY_BODY%"
+)";
+  TestUtility::loadFromYaml(yaml, config_);
+  auto local = Factory::create(config_, context_);
+
+  for (int i = 0; i < 2; ++i) {
+    resetData(503);
+    local->rewrite(&request_headers_, response_headers_, stream_info_, code_, body_,
+                   content_type_);
+    EXPECT_TRUE(TestUtility::jsonStringEqual(body_, R"({"code": 503, "body": "Init body text"})"));
+    EXPECT_EQ(content_type_, "application/json");
+
+    resetData(429);
+    local->rewrite(&request_headers_, response_headers_, stream_info_, code_, body_,
+                   content_type_);
+    EXPECT_TRUE(TestUtility::jsonStringEqual(body_, R"({"code": 429, "body": "Init body text"})"));
+
+    resetData(429);
+    body_ = "other body";
+    local->rewrite(&request_headers_, response_headers_, stream_info_, code_, body_,
+                   content_type_);
+    EXPECT_TRUE(TestUtility::jsonStringEqual(body_, R"({"code": 429, "body": "other body"})"));
+  }
+
+  Http::TestRequestHeaderMapImpl request_headers{{":method", "GET"}, {":path", "/path"}};
+  resetData(503);
+  local->rewrite(&request_headers, response_headers_, stream_info_, code_, body_, content_type_);
+  EXPECT_EQ(body_, "/path Init body text");
+  EXPECT_EQ(content_type_, "text/plain");
+}
+
 TEST_F(LocalReplyTest, TestDefaultJsonFormatter) {
   // Default json formatter without any mappers
   const std::string yaml = R"(
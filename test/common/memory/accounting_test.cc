@@ -0,0 +1,107 @@
+#include "common/buffer/buffer_impl.h"
+#include "common/common/thread.h"
+#include "common/http/header_map_impl.h"
+#include "common/memory/accounting.h"
+#include "common/stats/symbol_table_impl.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Memory {
+namespace {
+
+// The accounts are process wide, so that the tests only check what they change.
+TEST(AccountingTest, AllocateResizeFree) {
+  const Accounting::Usage before = Accounting::usage(Accounting::Account::Clusters);
+  Accounting::allocate(Accounting::Account::Clusters, 100);
+  Accounting::resize(Accounting::Account::Clusters, 20);
+  Accounting::Usage usage = Accounting::usage(Accounting::Account::Clusters);
+  EXPECT_EQ(before.bytes_ + 120, usage.bytes_);
+  EXPECT_EQ(before.objects_ + 1, usage.objects_);
+
+  Accounting::free(Accounting::Account::Clusters, 120);
+  usage = Accounting::usage(Accounting::Account::Clusters);
+  EXPECT_EQ(before.bytes_, usage.bytes_);
+  EXPECT_EQ(before.objects_, usage.objects_);
+}
+
+// An object may be freed on another thread than the one which allocated it, and the counts of a
+// thread outlive it.
+TEST(AccountingTest, AcrossThreads) {
+  const Accounting::Usage before = Accounting::usage(Accounting::Account::TlsContexts);
+  Thread::ThreadPtr thread = Thread::threadFactoryForTest().createThread(
+      []() { Accounting::allocate(Accounting::Account::TlsContexts, 64); });
+  thread->join();
+  Accounting::Usage usage = Accounting::usage(Accounting::Account::TlsContexts);
+  EXPECT_EQ(before.bytes_ + 64, usage.bytes_);
+  EXPECT_EQ(before.objects_ + 1, usage.objects_);
+
+  Accounting::free(Accounting::Account::TlsContexts, 64);
+  usage = Accounting::usage(Accounting::Account::TlsContexts);
+  EXPECT_EQ(before.bytes_, usage.bytes_);
+  EXPECT_EQ(before.objects_, usage.objects_);
+}
+
+TEST(AccountingTest, BufferSlices) {
+  const Accounting::Usage before = Accounting::usage(Accounting::Account::BufferSlices);
+  {
+    Buffer::OwnedImpl buffer(std::string(10000, 'a'));
+    const Accounting::Usage usage = Accounting::usage(Accounting::Account::BufferSlices);
+    EXPECT_LE(before.bytes_ + 10000, usage.bytes_);
+    EXPECT_LT(before.objects_, usage.objects_);
+
+    // Moving the slices to another buffer keeps them accounted for once.
+    Buffer::OwnedImpl other;
+    other.move(buffer);
+    EXPECT_EQ(usage.bytes_, Accounting::usage(Accounting::Account::BufferSlices).bytes_);
+  }
+  const Accounting::Usage usage = Accounting::usage(Accounting::Account::BufferSlices);
+  EXPECT_EQ(before.bytes_, usage.bytes_);
+  EXPECT_EQ(before.objects_, usage.objects_);
+}
+
+TEST(AccountingTest, HeaderMaps) {
+  const Accounting::Usage before = Accounting::usage(Accounting::Account::HeaderMaps);
+  {
+    auto headers = Http::RequestHeaderMapImpl::create();
+    headers->addCopy(Http::LowerCaseString("foo"), "bar");
+    Accounting::Usage usage = Accounting::usage(Accounting::Account::HeaderMaps);
+    EXPECT_EQ(before.bytes_ + headers->byteSize(), usage.bytes_);
+    EXPECT_EQ(before.objects_ + 1, usage.objects_);
+
+    headers->setCopy(Http::LowerCaseString("foo"), "barbaz");
+    EXPECT_EQ(before.bytes_ + headers->byteSize(),
+              Accounting::usage(Accounting::Account::HeaderMaps).bytes_);
+
+    headers->clear();
+    EXPECT_EQ(before.bytes_, Accounting::usage(Accounting::Account::HeaderMaps).bytes_);
+  }
+  const Accounting::Usage usage = Accounting::usage(Accounting::Account::HeaderMaps);
+  EXPECT_EQ(before.bytes_, usage.bytes_);
+  EXPECT_EQ(before.objects_, usage.objects_);
+}
+
+TEST(AccountingTest, SymbolTable) {
+  const Accounting::Usage before = Accounting::usage(Accounting::Account::SymbolTable);
+  {
+    Stats::SymbolTableImpl symbol_table;
+    Stats::StatNameManagedStorage name("account.test", symbol_table);
+    Accounting::Usage usage = Accounting::usage(Accounting::Account::SymbolTable);
+    EXPECT_EQ(before.bytes_ + 11, usage.bytes_);
+    EXPECT_EQ(before.objects_ + 2, usage.objects_);
+  }
+  const Accounting::Usage usage = Accounting::usage(Accounting::Account::SymbolTable);
+  EXPECT_EQ(before.bytes_, usage.bytes_);
+  EXPECT_EQ(before.objects_, usage.objects_);
+}
+
+TEST(AccountingTest, AccountName) {
+  EXPECT_EQ("buffer_slices", Accounting::accountName(Accounting::Account::BufferSlices));
+  EXPECT_EQ("tls_contexts", Accounting::accountName(Accounting::Account::TlsContexts));
+}
+
+} // namespace
+} // namespace Memory
+} // namespace Envoy
@@ -83,6 +83,33 @@ TEST_F(HeapShrinkerTest, ShrinkWhenTriggered) {
   EXPECT_EQ(2, shrink_count.value());
 }
 
+TEST_F(HeapShrinkerTest, ShrinkInProportionWhenScaled) {
+  Server::OverloadActionCb action_cb;
+  EXPECT_CALL(overload_manager_, registerForAction(_, _, _))
+      .WillOnce(Invoke([&](const std::string&, Event::Dispatcher&, Server::OverloadActionCb cb) {
+        action_cb = cb;
+        return true;
+      }));
+
+  HeapShrinker h(dispatcher_, overload_manager_, stats_);
+
+  auto data = std::make_unique<char[]>(5000000);
+  data.reset();
+  const uint64_t free_before_shrink = Stats::totalPageHeapFree();
+
+  Envoy::Stats::Counter& shrink_count =
+      stats_.counter("overload.envoy.overload_actions.shrink_heap.shrink_count");
+  action_cb(Server::OverloadActionState(UnitFloat(0.5)));
+  step();
+  EXPECT_EQ(1, shrink_count.value());
+  // Part of the free pages may be kept by the page heap.
+  EXPECT_LE(Stats::totalPageHeapFree(), free_before_shrink);
+
+  action_cb(Server::OverloadActionState::inactive());
+  step();
+  EXPECT_EQ(1, shrink_count.value());
+}
+
 } // namespace
 } // namespace Memory
 } // namespace Envoy
@@ -1,3 +1,5 @@
+#include <vector>
+
 #include "common/common/fmt.h"
 #include "common/network/address_impl.h"
 
@@ -33,6 +35,56 @@ static void Ipv6InstanceCreate(benchmark::State& state) {
 }
 BENCHMARK(Ipv6InstanceCreate);
 
+// The creation of an address and the formatting of its name, which is what each accepted
+// connection paid before the names were formatted lazily.
+static void Ipv4InstanceCreateAndFormat(benchmark::State& state) {
+  sockaddr_in addr;
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(443);
+  static constexpr uint32_t Addr = 0xc00002ff; // From the RFC 5737 example range.
+  addr.sin_addr.s_addr = htonl(Addr);
+  for (auto _ : state) {
+    Ipv4Instance address(&addr);
+    benchmark::DoNotOptimize(address.asString().size());
+  }
+}
+BENCHMARK(Ipv4InstanceCreateAndFormat);
+
+// The lookup of the accepted connections from a set of peers, whose size is the argument, without
+// and with an address cache.
+static std::vector<sockaddr_storage> peerSockAddrs(uint32_t num_peers) {
+  std::vector<sockaddr_storage> peers(num_peers);
+  for (uint32_t i = 0; i < num_peers; i++) {
+    auto& sin = reinterpret_cast<sockaddr_in&>(peers[i]);
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(443);
+    sin.sin_addr.s_addr = htonl(0xc6336400 + i); // From the RFC 5737 example ranges.
+  }
+  return peers;
+}
+
+static void addressFromSockAddrPeers(benchmark::State& state) {
+  const std::vector<sockaddr_storage> peers = peerSockAddrs(state.range(0));
+  size_t i = 0;
+  for (auto _ : state) {
+    InstanceConstSharedPtr address =
+        addressFromSockAddr(peers[i++ % peers.size()], sizeof(sockaddr_in));
+    benchmark::DoNotOptimize(address.get());
+  }
+}
+BENCHMARK(addressFromSockAddrPeers)->Arg(16)->Arg(256);
+
+static void instanceCachePeers(benchmark::State& state) {
+  const std::vector<sockaddr_storage> peers = peerSockAddrs(state.range(0));
+  InstanceCache cache(1024);
+  size_t i = 0;
+  for (auto _ : state) {
+    InstanceConstSharedPtr address = cache.get(peers[i++ % peers.size()], sizeof(sockaddr_in));
+    benchmark::DoNotOptimize(address.get());
+  }
+}
+BENCHMARK(instanceCachePeers)->Arg(16)->Arg(256);
+
 } // namespace Address
 } // namespace Network
 } // namespace Envoy
@@ -525,6 +525,75 @@ TEST(AddressFromSockAddrDeathTest, Pipe) {
 #endif
 }
 
+TEST(InstanceCacheTest, IPv4) {
+  InstanceCache cache(4);
+  sockaddr_storage ss{};
+  auto& sin = reinterpret_cast<sockaddr_in&>(ss);
+  sin.sin_family = AF_INET;
+  EXPECT_EQ(1, inet_pton(AF_INET, "1.2.3.4", &sin.sin_addr));
+  sin.sin_port = htons(6502);
+
+  const InstanceConstSharedPtr address = cache.get(ss, sizeof(sockaddr_in));
+  EXPECT_EQ("1.2.3.4:6502", address->asString());
+  EXPECT_EQ(address, cache.get(ss, sizeof(sockaddr_in)));
+  // The length is ignored when 0, as with addressFromSockAddr().
+  EXPECT_EQ(address, cache.get(ss, 0));
+
+  sin.sin_port = htons(6503);
+  const InstanceConstSharedPtr other_port = cache.get(ss, sizeof(sockaddr_in));
+  EXPECT_NE(address, other_port);
+  EXPECT_EQ("1.2.3.4:6503", other_port->asString());
+}
+
+TEST(InstanceCacheTest, IPv6) {
+  InstanceCache cache(4);
+  sockaddr_storage ss{};
+  auto& sin6 = reinterpret_cast<sockaddr_in6&>(ss);
+  sin6.sin6_family = AF_INET6;
+  EXPECT_EQ(1, inet_pton(AF_INET6, "::ffff:192.0.2.128", &sin6.sin6_addr));
+  sin6.sin6_port = htons(32000);
+
+  // The IPv4-mapped address made with v6only false is an IPv4 address, and is cached apart from
+  // the IPv6 address made with v6only true.
+  const InstanceConstSharedPtr v4_address = cache.get(ss, sizeof(sockaddr_in6), false);
+  EXPECT_EQ("192.0.2.128:32000", v4_address->asString());
+  const InstanceConstSharedPtr v6_address = cache.get(ss, sizeof(sockaddr_in6), true);
+  EXPECT_EQ("[::ffff:192.0.2.128]:32000", v6_address->asString());
+  EXPECT_EQ(v4_address, cache.get(ss, sizeof(sockaddr_in6), false));
+  EXPECT_EQ(v6_address, cache.get(ss, sizeof(sockaddr_in6), true));
+}
+
+TEST(InstanceCacheTest, Pipe) {
+  InstanceCache cache(4);
+  sockaddr_storage ss{};
+  auto& sun = reinterpret_cast<sockaddr_un&>(ss);
+  sun.sun_family = AF_UNIX;
+  StringUtil::strlcpy(sun.sun_path, "/some/path", sizeof sun.sun_path);
+  const socklen_t ss_len = offsetof(struct sockaddr_un, sun_path) + 1 + strlen(sun.sun_path);
+
+  // The pipe addresses are not cached.
+  const InstanceConstSharedPtr address = cache.get(ss, ss_len);
+  EXPECT_EQ("/some/path", address->asString());
+  EXPECT_NE(address, cache.get(ss, ss_len));
+}
+
+// A miss replaces the address of the slot, so that the cache never grows.
+TEST(InstanceCacheTest, Replace) {
+  InstanceCache cache(1);
+  sockaddr_storage ss{};
+  auto& sin = reinterpret_cast<sockaddr_in&>(ss);
+  sin.sin_family = AF_INET;
+  EXPECT_EQ(1, inet_pton(AF_INET, "1.2.3.4", &sin.sin_addr));
+
+  const InstanceConstSharedPtr first = cache.get(ss, sizeof(sockaddr_in));
+  sin.sin_port = htons(1);
+  const InstanceConstSharedPtr second = cache.get(ss, sizeof(sockaddr_in));
+  EXPECT_EQ(second, cache.get(ss, sizeof(sockaddr_in)));
+  sin.sin_port = 0;
+  EXPECT_NE(first, cache.get(ss, sizeof(sockaddr_in)));
+  EXPECT_EQ(1, first.use_count());
+}
+
 // Test comparisons between all the different (known) test classes.
 struct TestCase {
   enum InstanceType { Ipv4, Ipv6, Pipe, Internal };
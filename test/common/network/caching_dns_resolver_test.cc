@@ -0,0 +1,226 @@
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+
+#include "common/network/caching_dns_resolver.h"
+#include "common/singleton/manager_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::DoAll;
+using testing::Return;
+using testing::SaveArg;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class CachingDnsResolverTest : public testing::Test {
+public:
+  CachingDnsResolverTest() {
+    config_.mutable_max_ttl()->set_seconds(60);
+    config_.mutable_negative_ttl()->set_seconds(5);
+    config_.mutable_max_stale()->set_seconds(30);
+    resolver_ = std::make_unique<CachingDnsResolver>(underlying_, time_system_, store_, config_);
+  }
+
+  void expectResolve(const std::string& dns_name) {
+    EXPECT_CALL(*underlying_, resolve(dns_name, DnsLookupFamily::V4Only, _))
+        .WillOnce(DoAll(SaveArg<2>(&underlying_callback_), Return(&underlying_->active_query_)));
+  }
+
+  ActiveDnsQuery* resolve(const std::string& dns_name) {
+    return resolver_->resolve(dns_name, DnsLookupFamily::V4Only,
+                              [this](DnsResolver::ResolutionStatus status,
+                                     std::list<DnsResponse>&& response) {
+                                statuses_.push_back(status);
+                                responses_.push_back(std::move(response));
+                              });
+  }
+
+  uint64_t counter(const std::string& name) {
+    return TestUtility::findCounter(store_, "dns_cache." + name)->value();
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl store_;
+  envoy::config::bootstrap::v3::Bootstrap::DnsResolutionCache config_;
+  std::shared_ptr<MockDnsResolver> underlying_{std::make_shared<MockDnsResolver>()};
+  std::unique_ptr<CachingDnsResolver> resolver_;
+  DnsResolver::ResolveCb underlying_callback_;
+  std::vector<DnsResolver::ResolutionStatus> statuses_;
+  std::vector<std::list<DnsResponse>> responses_;
+};
+
+// Validate that concurrent resolutions of a name share a query, and that the resolution is cached
+// for the lowest TTL of its records.
+TEST_F(CachingDnsResolverTest, SharedQueryAndTtl) {
+  expectResolve("foo.com");
+  EXPECT_NE(nullptr, resolve("foo.com"));
+  EXPECT_NE(nullptr, resolve("foo.com"));
+  EXPECT_EQ(2, counter("cache_miss"));
+
+  underlying_callback_(DnsResolver::ResolutionStatus::Success,
+                       TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(20)));
+  ASSERT_EQ(2, responses_.size());
+  EXPECT_EQ(DnsResolver::ResolutionStatus::Success, statuses_[1]);
+  EXPECT_EQ("10.0.0.1:0", responses_[1].front().address_->asString());
+
+  // Cached resolutions are delivered inline.
+  time_system_.advanceTimeWait(std::chrono::seconds(10));
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(3, responses_.size());
+  EXPECT_EQ(1, counter("cache_hit"));
+
+  time_system_.advanceTimeWait(std::chrono::seconds(10));
+  expectResolve("foo.com");
+  EXPECT_NE(nullptr, resolve("foo.com"));
+  EXPECT_EQ(3, responses_.size());
+}
+
+// Validate that the TTL of a resolution is capped by max_ttl.
+TEST_F(CachingDnsResolverTest, MaxTtl) {
+  expectResolve("foo.com");
+  resolve("foo.com");
+  underlying_callback_(DnsResolver::ResolutionStatus::Success,
+                       TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(3600)));
+
+  time_system_.advanceTimeWait(std::chrono::seconds(59));
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  expectResolve("foo.com");
+  EXPECT_NE(nullptr, resolve("foo.com"));
+}
+
+// Validate that a resolution used in the last tenth of its TTL is refreshed in the background.
+TEST_F(CachingDnsResolverTest, Prefetch) {
+  expectResolve("foo.com");
+  resolve("foo.com");
+  underlying_callback_(DnsResolver::ResolutionStatus::Success,
+                       TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(20)));
+
+  time_system_.advanceTimeWait(std::chrono::seconds(19));
+  expectResolve("foo.com");
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(1, counter("prefetch"));
+  // The query of the prefetch is not started again.
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(3, responses_.size());
+
+  underlying_callback_(DnsResolver::ResolutionStatus::Success,
+                       TestUtility::makeDnsResponse({"10.0.0.2"}, std::chrono::seconds(20)));
+  EXPECT_EQ(3, responses_.size());
+  time_system_.advanceTimeWait(std::chrono::seconds(10));
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ("10.0.0.2:0", responses_.back().front().address_->asString());
+}
+
+// Validate that failed resolutions are cached for negative_ttl.
+TEST_F(CachingDnsResolverTest, NegativeTtl) {
+  expectResolve("foo.com");
+  resolve("foo.com");
+  underlying_callback_(DnsResolver::ResolutionStatus::Failure, {});
+  EXPECT_EQ(DnsResolver::ResolutionStatus::Failure, statuses_.back());
+
+  time_system_.advanceTimeWait(std::chrono::seconds(4));
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(DnsResolver::ResolutionStatus::Failure, statuses_.back());
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  expectResolve("foo.com");
+  EXPECT_NE(nullptr, resolve("foo.com"));
+}
+
+// Validate that a failed resolution within max_stale of the expiry of the last successful one
+// serves it, and is retried after negative_ttl.
+TEST_F(CachingDnsResolverTest, Stale) {
+  expectResolve("foo.com");
+  resolve("foo.com");
+  underlying_callback_(DnsResolver::ResolutionStatus::Success,
+                       TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(20)));
+
+  time_system_.advanceTimeWait(std::chrono::seconds(40));
+  expectResolve("foo.com");
+  resolve("foo.com");
+  underlying_callback_(DnsResolver::ResolutionStatus::Failure, {});
+  EXPECT_EQ(DnsResolver::ResolutionStatus::Success, statuses_.back());
+  EXPECT_EQ("10.0.0.1:0", responses_.back().front().address_->asString());
+  EXPECT_EQ(1, counter("stale_response"));
+
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  time_system_.advanceTimeWait(std::chrono::seconds(5));
+  expectResolve("foo.com");
+  resolve("foo.com");
+  // Past max_stale, the failure is delivered.
+  time_system_.advanceTimeWait(std::chrono::seconds(10));
+  underlying_callback_(DnsResolver::ResolutionStatus::Failure, {});
+  EXPECT_EQ(DnsResolver::ResolutionStatus::Failure, statuses_.back());
+  EXPECT_TRUE(responses_.back().empty());
+}
+
+// Validate that the names and lookup families are cached separately, and that a resolution that
+// completes inline is delivered inline.
+TEST_F(CachingDnsResolverTest, InlineResolution) {
+  EXPECT_CALL(*underlying_, resolve("foo.com", DnsLookupFamily::V4Only, _))
+      .WillOnce([](const std::string&, DnsLookupFamily,
+                   DnsResolver::ResolveCb callback) -> ActiveDnsQuery* {
+        callback(DnsResolver::ResolutionStatus::Success,
+                 TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(20)));
+        return nullptr;
+      });
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(1, responses_.size());
+
+  expectResolve("bar.com");
+  EXPECT_NE(nullptr, resolve("bar.com"));
+  EXPECT_CALL(*underlying_, resolve("foo.com", DnsLookupFamily::Auto, _))
+      .WillOnce(Return(&underlying_->active_query_));
+  EXPECT_NE(nullptr,
+            resolver_->resolve("foo.com", DnsLookupFamily::Auto,
+                               [](DnsResolver::ResolutionStatus, std::list<DnsResponse>&&) {}));
+}
+
+// Validate that a cancelled query is not called back, while the others sharing the resolution
+// are, and that the cache cancels its queries when it is destroyed.
+TEST_F(CachingDnsResolverTest, Cancel) {
+  expectResolve("foo.com");
+  ActiveDnsQuery* query = resolve("foo.com");
+  ASSERT_NE(nullptr, query);
+  resolve("foo.com");
+  query->cancel();
+  underlying_callback_(DnsResolver::ResolutionStatus::Success,
+                       TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(20)));
+  EXPECT_EQ(1, responses_.size());
+
+  expectResolve("bar.com");
+  resolve("bar.com");
+  EXPECT_CALL(underlying_->active_query_, cancel());
+  resolver_.reset();
+}
+
+// Validate that the server's cache is found through the singleton manager while it is held.
+TEST_F(CachingDnsResolverTest, Singleton) {
+  Singleton::ManagerImpl singleton_manager(Thread::threadFactoryForTest());
+  EXPECT_EQ(nullptr, CachingDnsResolver::get(singleton_manager));
+
+  CachingDnsResolverSharedPtr cache =
+      CachingDnsResolver::create(singleton_manager, underlying_, time_system_, store_, config_);
+  EXPECT_EQ(cache, CachingDnsResolver::get(singleton_manager));
+  cache.reset();
+  EXPECT_EQ(nullptr, CachingDnsResolver::get(singleton_manager));
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,70 @@
+#include "common/network/connection_balancer_impl.h"
+
+#include "test/mocks/common.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class TestBalancedConnectionHandler : public BalancedConnectionHandler {
+public:
+  explicit TestBalancedConnectionHandler(uint64_t num_connections)
+      : num_connections_(num_connections) {}
+
+  // Network::BalancedConnectionHandler
+  uint64_t numConnections() const override { return num_connections_; }
+  void incNumConnections() override { ++num_connections_; }
+  void post(Network::ConnectionSocketPtr&&) override {}
+
+  uint64_t num_connections_;
+};
+
+class TwoChoiceConnectionBalancerTest : public testing::Test {
+public:
+  TwoChoiceConnectionBalancerTest() {
+    for (auto* handler : {&handler0_, &handler1_, &handler2_}) {
+      balancer_.registerHandler(*handler);
+    }
+  }
+
+  NiceMock<Random::MockRandomGenerator> random_;
+  TwoChoiceConnectionBalancerImpl balancer_{random_};
+  TestBalancedConnectionHandler handler0_{2};
+  TestBalancedConnectionHandler handler1_{1};
+  TestBalancedConnectionHandler handler2_{2};
+};
+
+// The connection moves to the other handler when it has fewer connections.
+TEST_F(TwoChoiceConnectionBalancerTest, MovesToLessLoadedHandler) {
+  EXPECT_CALL(random_, random()).WillOnce(Return(1));
+  EXPECT_EQ(&handler1_, &balancer_.pickTargetHandler(handler0_));
+  EXPECT_EQ(2, handler0_.num_connections_);
+  EXPECT_EQ(2, handler1_.num_connections_);
+}
+
+// The connection stays on the current handler when the other handler has as many connections.
+TEST_F(TwoChoiceConnectionBalancerTest, StaysOnTie) {
+  EXPECT_CALL(random_, random()).WillOnce(Return(5));
+  EXPECT_EQ(&handler0_, &balancer_.pickTargetHandler(handler0_));
+  EXPECT_EQ(3, handler0_.num_connections_);
+  EXPECT_EQ(2, handler2_.num_connections_);
+}
+
+// Unregistered handlers are no longer picked, and a single handler keeps all the connections.
+TEST_F(TwoChoiceConnectionBalancerTest, Unregister) {
+  balancer_.unregisterHandler(handler1_);
+  balancer_.unregisterHandler(handler2_);
+  EXPECT_CALL(random_, random()).Times(0);
+  EXPECT_EQ(&handler0_, &balancer_.pickTargetHandler(handler0_));
+  EXPECT_EQ(3, handler0_.num_connections_);
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -1851,6 +1851,95 @@ TEST_P(ConnectionImplTest, DelayedCloseTimeoutNullStats) {
   server_connection->close(ConnectionCloseType::NoFlush);
 }
 
+#if defined(__linux__)
+// Data read by a connection that splices with a peer is written to the peer's socket without being
+// delivered to the read filter, in both directions, and is still accounted for.
+TEST_P(ConnectionImplTest, SpliceWithPeer) {
+  setUpBasicConnection();
+  connect();
+  auto client_filter = std::make_shared<NiceMock<MockReadFilter>>();
+  client_connection_->addReadFilter(client_filter);
+
+  // A second connection pair. Its client end is the peer the server connection splices with.
+  ClientConnectionPtr peer = dispatcher_->createClientConnection(
+      socket_->localAddress(), source_address_, Network::Test::createRawBufferSocket(), nullptr);
+  NiceMock<MockConnectionCallbacks> peer_callbacks;
+  peer->addConnectionCallbacks(peer_callbacks);
+  auto peer_filter = std::make_shared<NiceMock<MockReadFilter>>();
+  peer->addReadFilter(peer_filter);
+  StreamInfo::StreamInfoImpl peer_server_stream_info(time_system_);
+  ServerConnectionPtr peer_server;
+  NiceMock<MockConnectionCallbacks> peer_server_callbacks;
+  auto peer_server_filter = std::make_shared<NiceMock<MockReadFilter>>();
+  int expected_callbacks = 2;
+  EXPECT_CALL(listener_callbacks_, onAccept_(_))
+      .WillOnce(Invoke([&](ConnectionSocketPtr& socket) -> void {
+        peer_server = dispatcher_->createServerConnection(
+            std::move(socket), Network::Test::createRawBufferSocket(), peer_server_stream_info);
+        peer_server->addConnectionCallbacks(peer_server_callbacks);
+        peer_server->addReadFilter(peer_server_filter);
+        if (--expected_callbacks == 0) {
+          dispatcher_->exit();
+        }
+      }));
+  EXPECT_CALL(peer_callbacks, onEvent(ConnectionEvent::Connected))
+      .WillOnce(Invoke([&](ConnectionEvent) -> void {
+        if (--expected_callbacks == 0) {
+          dispatcher_->exit();
+        }
+      }));
+  peer->connect();
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  // Data is only spliced past a read filter that has been initialized.
+  EXPECT_TRUE(server_connection_->initializeReadFilters());
+  EXPECT_TRUE(peer->initializeReadFilters());
+  EXPECT_TRUE(server_connection_->enableSplicing(*peer));
+  EXPECT_FALSE(peer->enableSplicing(*server_connection_));
+
+  EXPECT_CALL(*read_filter_, onData(_, _)).Times(0);
+  EXPECT_CALL(*peer_server_filter, onData(BufferStringEqual("hello"), false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> FilterStatus {
+        data.drain(data.length());
+        dispatcher_->exit();
+        return FilterStatus::StopIteration;
+      }));
+  Buffer::OwnedImpl request("hello");
+  client_connection_->write(request, false);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(5, server_connection_->streamInfo().bytesReceived());
+  EXPECT_EQ(5, peer->streamInfo().bytesSent());
+
+  EXPECT_CALL(*peer_filter, onData(_, _)).Times(0);
+  EXPECT_CALL(*client_filter, onData(BufferStringEqual("world"), false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> FilterStatus {
+        data.drain(data.length());
+        dispatcher_->exit();
+        return FilterStatus::StopIteration;
+      }));
+  Buffer::OwnedImpl response("world");
+  peer_server->write(response, false);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(5, peer->streamInfo().bytesReceived());
+  EXPECT_EQ(5, server_connection_->streamInfo().bytesSent());
+
+  // Closing either connection stops splicing in both directions.
+  peer->close(ConnectionCloseType::NoFlush);
+  peer_server->close(ConnectionCloseType::NoFlush);
+  EXPECT_CALL(*read_filter_, onData(BufferStringEqual("again"), false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> FilterStatus {
+        data.drain(data.length());
+        dispatcher_->exit();
+        return FilterStatus::StopIteration;
+      }));
+  Buffer::OwnedImpl again("again");
+  client_connection_->write(again, false);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  disconnect(true);
+}
+#endif
+
 class FakeReadFilter : public Network::ReadFilter {
 public:
   FakeReadFilter() = default;
@@ -1935,6 +2024,13 @@ TEST_F(MockTransportConnectionImplTest, ObjectDestructOrder) {
   file_ready_cb_(Event::FileReadyType::Read);
 }
 
+// Splicing is only possible between two ConnectionImpls whose transport sockets allow it.
+TEST_F(MockTransportConnectionImplTest, EnableSplicingRequiresSpliceableSockets) {
+  NiceMock<MockConnection> mock_peer;
+  EXPECT_FALSE(connection_->enableSplicing(mock_peer));
+  EXPECT_FALSE(connection_->enableSplicing(*connection_));
+}
+
 // Verify that read resumptions requested via setTransportSocketIsReadable() are scheduled once read
 // is re-enabled.
 TEST_F(MockTransportConnectionImplTest, ReadBufferReadyResumeAfterReadDisable) {
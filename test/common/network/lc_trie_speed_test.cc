@@ -1,6 +1,8 @@
 #include "common/network/lc_trie.h"
 #include "common/network/utility.h"
 
+#include <random>
+
 #include "benchmark/benchmark.h"
 
 namespace {
@@ -50,6 +52,25 @@ struct CidrInputs {
       tag_data_minimal_;
 };
 
+// A large list of prefixes spread over a few tags, as from a feed of the address blocks of the
+// cloud providers or of the bad actors, with overlapping /16 to /32 prefixes.
+std::vector<std::pair<std::string, std::vector<Envoy::Network::Address::CidrRange>>>
+largeTagData(size_t num_prefixes) {
+  std::vector<std::pair<std::string, std::vector<Envoy::Network::Address::CidrRange>>> tag_data(
+      8);
+  std::mt19937 random(num_prefixes);
+  for (size_t i = 0; i < tag_data.size(); i++) {
+    tag_data[i].first = fmt::format("tag_{}", i);
+  }
+  for (size_t i = 0; i < num_prefixes; i++) {
+    const uint32_t address = random();
+    tag_data[i % tag_data.size()].second.push_back(Envoy::Network::Address::CidrRange::create(
+        fmt::format("{}.{}.{}.{}/{}", address >> 24, (address >> 16) & 0xff, (address >> 8) & 0xff,
+                    address & 0xff, 16 + random() % 17)));
+  }
+  return tag_data;
+}
+
 } // namespace
 
 namespace Envoy {
@@ -146,4 +167,43 @@ static void lcTrieLookupMinimal(benchmark::State& state) {
 
 BENCHMARK(lcTrieLookupMinimal);
 
+// Measures the build of the trie of a large list of prefixes, whose size is the argument.
+static void lcTrieConstructLarge(benchmark::State& state) {
+  const auto tag_data = largeTagData(state.range(0));
+
+  std::unique_ptr<Envoy::Network::LcTrie::LcTrie<std::string>> trie;
+  for (auto _ : state) {
+    trie = std::make_unique<Envoy::Network::LcTrie::LcTrie<std::string>>(tag_data);
+  }
+  benchmark::DoNotOptimize(trie);
+}
+
+BENCHMARK(lcTrieConstructLarge)
+    ->Arg(1 << 10)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+static void lcTrieLookupLarge(benchmark::State& state) {
+  std::unique_ptr<Envoy::Network::LcTrie::LcTrie<std::string>> lc_trie =
+      std::make_unique<Envoy::Network::LcTrie::LcTrie<std::string>>(largeTagData(state.range(0)));
+  std::vector<Envoy::Network::Address::InstanceConstSharedPtr> addresses;
+  std::mt19937 random;
+  for (size_t i = 0; i < 1024; i++) {
+    const uint32_t address = random();
+    addresses.push_back(Envoy::Network::Utility::parseInternetAddress(
+        fmt::format("{}.{}.{}.{}", address >> 24, (address >> 16) & 0xff, (address >> 8) & 0xff,
+                    address & 0xff)));
+  }
+
+  size_t i = 0;
+  size_t output_tags = 0;
+  for (auto _ : state) {
+    output_tags += lc_trie->getData(addresses[i++ % addresses.size()]).size();
+  }
+  benchmark::DoNotOptimize(output_tags);
+}
+
+BENCHMARK(lcTrieLookupLarge)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
 } // namespace Envoy
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <memory>
 
 #include "common/common/utility.h"
@@ -325,9 +326,9 @@ TEST_F(LcTrieTest, ExclusiveNestedPrefixesWithCatchAll) {
   expectIPAndTags(test_case);
 }
 
-// Ensure the trie will reject inputs that would cause it to exceed the maximum 2^20 nodes
-// when using the default fill factor.
-TEST_F(LcTrieTest, MaximumEntriesExceptionDefault) {
+// Ensure the trie accepts more than the 2^18 entries which used to be the limit with the default
+// fill factor, and that the duplicates collapse into a single leaf.
+TEST_F(LcTrieTest, ManyEntriesDefault) {
   static const size_t num_prefixes = 1 << 19;
   Address::CidrRange address = Address::CidrRange::create("10.0.0.1/8");
   std::vector<Address::CidrRange> prefixes;
@@ -337,16 +338,15 @@ TEST_F(LcTrieTest, MaximumEntriesExceptionDefault) {
   }
   EXPECT_EQ(num_prefixes, prefixes.size());
 
-  std::pair<std::string, std::vector<Address::CidrRange>> ip_tag =
-      std::make_pair("bad_tag", prefixes);
-  std::vector<std::pair<std::string, std::vector<Address::CidrRange>>> ip_tags_input{ip_tag};
-  EXPECT_THROW_WITH_MESSAGE(new LcTrie<std::string>(ip_tags_input), EnvoyException,
-                            "The input vector has '524288' CIDR range entries. "
-                            "LC-Trie can only support '262144' CIDR ranges with "
-                            "the specified fill factor.");
+  std::vector<std::pair<std::string, std::vector<Address::CidrRange>>> ip_tags_input{
+      std::make_pair("tag", prefixes)};
+  LcTrie<std::string> trie(ip_tags_input);
+  EXPECT_EQ(std::vector<std::string>{"tag"},
+            trie.getData(Utility::parseInternetAddress("10.1.2.3")));
+  EXPECT_TRUE(trie.getData(Utility::parseInternetAddress("11.0.0.1")).empty());
 }
 
-// Ensure the trie will reject inputs that would cause it to exceed the maximum 2^20 nodes
+// Ensure the trie will reject inputs that would cause it to exceed the maximum 2^26 nodes
 // when using a fill factor override.
 TEST_F(LcTrieTest, MaximumEntriesExceptionOverride) {
   static const size_t num_prefixes = 8192;
@@ -364,12 +364,52 @@ TEST_F(LcTrieTest, MaximumEntriesExceptionOverride) {
   std::pair<std::string, std::vector<Address::CidrRange>> ip_tag =
       std::make_pair("bad_tag", prefixes);
   std::vector<std::pair<std::string, std::vector<Address::CidrRange>>> ip_tags_input{ip_tag};
-  EXPECT_THROW_WITH_MESSAGE(new LcTrie<std::string>(ip_tags_input, false, 0.01), EnvoyException,
+  EXPECT_THROW_WITH_MESSAGE(new LcTrie<std::string>(ip_tags_input, false, 0.0001), EnvoyException,
                             "The input vector has '8192' CIDR range entries. "
-                            "LC-Trie can only support '5242' CIDR ranges with "
+                            "LC-Trie can only support '3355' CIDR ranges with "
                             "the specified fill factor.");
 }
 
+// Compare the lookups of tries built from random nested and overlapping ranges with a linear scan
+// of the ranges, which is what the trie must return in the non-exclusive mode.
+TEST_F(LcTrieTest, RandomRangesMatchLinearScan) {
+  TestRandomGenerator random;
+  for (uint32_t iteration = 0; iteration < 50; iteration++) {
+    std::vector<std::pair<std::string, std::vector<Address::CidrRange>>> ip_tags_input;
+    std::vector<std::string> addresses;
+    for (uint32_t tag = 0; tag < 4; tag++) {
+      std::vector<Address::CidrRange> ranges;
+      for (uint32_t i = 0; i < 32; i++) {
+        // Mask out bits so that the ranges of the tags often nest.
+        const uint32_t bits = random.random() & 0xff0f00ff;
+        const std::string address = fmt::format("{}.{}.{}.{}", bits >> 24, (bits >> 16) & 0xff,
+                                                (bits >> 8) & 0xff, bits & 0xff);
+        ranges.push_back(Address::CidrRange::create(
+            fmt::format("{}/{}", address, random.random() % 33)));
+        addresses.push_back(address);
+      }
+      ip_tags_input.emplace_back(fmt::format("tag_{}", tag), std::move(ranges));
+    }
+    LcTrie<std::string> trie(ip_tags_input);
+
+    for (const std::string& address : addresses) {
+      const auto instance = Utility::parseInternetAddress(address);
+      std::vector<std::string> expected;
+      for (const auto& ip_tag : ip_tags_input) {
+        for (const Address::CidrRange& range : ip_tag.second) {
+          if (range.isInRange(*instance)) {
+            expected.push_back(ip_tag.first);
+            break;
+          }
+        }
+      }
+      std::vector<std::string> actual = trie.getData(instance);
+      std::sort(actual.begin(), actual.end());
+      EXPECT_EQ(expected, actual) << address;
+    }
+  }
+}
+
 } // namespace LcTrie
 } // namespace Network
 } // namespace Envoy
@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "common/network/io_socket_error_impl.h"
+#include "common/network/listener_filter_buffer_impl.h"
+
+#include "test/mocks/network/io_handle.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::ByMove;
+using testing::Invoke;
+using testing::Return;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class ListenerFilterBufferImplTest : public testing::Test {
+public:
+  void expectPeek(uint64_t max_length, const std::string& data) {
+    EXPECT_CALL(io_handle_, recv(_, max_length, MSG_PEEK))
+        .WillOnce(Invoke([data](void* buffer, size_t length, int) {
+          const size_t copied = std::min(length, data.size());
+          memcpy(buffer, data.data(), copied);
+          return Api::IoCallUint64Result(copied,
+                                         Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
+        }));
+  }
+
+  MockIoHandle io_handle_;
+  ListenerFilterBufferImpl buffer_{io_handle_};
+};
+
+// Every peek returns all the bytes of the socket, within the requested length.
+TEST_F(ListenerFilterBufferImplTest, Peek) {
+  EXPECT_EQ("", buffer_.data());
+
+  expectPeek(4, "abcdef");
+  EXPECT_EQ(4, buffer_.peek(4).rc_);
+  EXPECT_EQ("abcd", buffer_.data());
+
+  // The buffer grows for a larger peek.
+  expectPeek(16, "abcdefgh");
+  EXPECT_EQ(8, buffer_.peek(16).rc_);
+  EXPECT_EQ("abcdefgh", buffer_.data());
+
+  // The buffer is kept for a smaller peek.
+  expectPeek(2, "abcdefgh");
+  EXPECT_EQ(2, buffer_.peek(2).rc_);
+  EXPECT_EQ("ab", buffer_.data());
+}
+
+// The peeked bytes are kept when the socket has no more of them, and dropped by clear().
+TEST_F(ListenerFilterBufferImplTest, FailedPeekAndClear) {
+  expectPeek(8, "abc");
+  buffer_.peek(8);
+
+  EXPECT_CALL(io_handle_, recv(_, 8, MSG_PEEK))
+      .WillOnce(Return(ByMove(Api::IoCallUint64Result(
+          0, Api::IoErrorPtr(IoSocketError::getIoSocketEagainInstance(),
+                             IoSocketError::deleteIoError)))));
+  EXPECT_FALSE(buffer_.peek(8).ok());
+  EXPECT_EQ("abc", buffer_.data());
+
+  buffer_.clear();
+  EXPECT_EQ("", buffer_.data());
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -252,6 +252,51 @@ TEST_P(TcpListenerImplTest, WildcardListenerUseActualDst) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+// With the address cache, the connections accepted by a wildcard listener on the same local
+// address share its address instance.
+TEST_P(TcpListenerImplTest, WildcardListenerAddressCache) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.listener_address_cache", "true"}});
+
+  auto socket =
+      std::make_shared<TcpListenSocket>(Network::Test::getAnyAddress(version_), nullptr, true);
+  Network::MockTcpListenerCallbacks listener_callbacks;
+  Random::MockRandomGenerator random_generator;
+  Network::TestTcpListenerImpl listener(dispatcherImpl(), random_generator, socket,
+                                        listener_callbacks, true);
+
+  auto local_dst_address = Network::Utility::getAddressWithPort(
+      *Network::Test::getCanonicalLoopbackAddress(version_), socket->localAddress()->ip()->port());
+  std::vector<Network::ClientConnectionPtr> client_connections;
+  for (int i = 0; i < 2; i++) {
+    client_connections.emplace_back(dispatcher_->createClientConnection(
+        local_dst_address, Network::Address::InstanceConstSharedPtr(),
+        Network::Test::createRawBufferSocket(), nullptr));
+    client_connections.back()->connect();
+  }
+
+  std::vector<Network::ConnectionSocketPtr> accepted_sockets;
+  EXPECT_CALL(listener_callbacks, onAccept_(_))
+      .Times(2)
+      .WillRepeatedly(Invoke([&](Network::ConnectionSocketPtr& socket) -> void {
+        accepted_sockets.emplace_back(std::move(socket));
+        if (accepted_sockets.size() == 2) {
+          dispatcher_->exit();
+        }
+      }));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  ASSERT_EQ(2, accepted_sockets.size());
+  EXPECT_EQ(*local_dst_address, *accepted_sockets[0]->localAddress());
+  EXPECT_EQ(accepted_sockets[0]->localAddress(), accepted_sockets[1]->localAddress());
+  // The peers differ by their ports.
+  EXPECT_NE(*accepted_sockets[0]->remoteAddress(), *accepted_sockets[1]->remoteAddress());
+  for (const auto& conn : client_connections) {
+    conn->close(ConnectionCloseType::NoFlush);
+  }
+}
+
 // Test for the correct behavior when a listener is configured with an ANY address that allows
 // receiving IPv4 connections on an IPv6 socket. In this case the address instances of both
 // local and remote addresses of the connection should be IPv4 instances, as the connection really
@@ -1,16 +1,263 @@
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/network/io_socket_error_impl.h"
+#include "common/network/io_socket_handle_impl.h"
 #include "common/network/raw_buffer_socket.h"
+#include "common/stats/isolated_store_impl.h"
 
+#include "test/mocks/network/io_handle.h"
+#include "test/mocks/network/mocks.h"
 #include "test/test_common/network_utility.h"
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::_;
+using testing::ByMove;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
 namespace Envoy {
 namespace Network {
+namespace {
 
 TEST(RawBufferSocketFactory, RawBufferSocketFactory) {
   TransportSocketFactoryPtr factory = Envoy::Network::Test::createRawBufferSocketFactory();
   EXPECT_FALSE(factory->usesProxyProtocolOptions());
 }
 
+TEST(ZeroCopySendTrackerTest, ReleasesCompletedSendsInOrder) {
+  ZeroCopySendTracker tracker;
+  tracker.onSend(100, true);
+  tracker.onSend(200, true);
+  EXPECT_EQ(300, tracker.pinnedBytes());
+  EXPECT_TRUE(tracker.hasPendingZeroCopySends());
+  EXPECT_EQ(0, tracker.releaseCompleted());
+
+  // The second send completing first does not release anything.
+  tracker.onCompleted(1, 1);
+  EXPECT_EQ(0, tracker.releaseCompleted());
+  tracker.onCompleted(0, 0);
+  EXPECT_EQ(300, tracker.releaseCompleted());
+  EXPECT_EQ(0, tracker.pinnedBytes());
+  EXPECT_FALSE(tracker.hasPendingZeroCopySends());
+}
+
+TEST(ZeroCopySendTrackerTest, PlainSendsWaitForEarlierZeroCopySends) {
+  ZeroCopySendTracker tracker;
+  tracker.onSend(10, false);
+  EXPECT_EQ(10, tracker.releaseCompleted());
+
+  tracker.onSend(100, true);
+  tracker.onSend(20, false);
+  EXPECT_EQ(0, tracker.releaseCompleted());
+  EXPECT_EQ(120, tracker.pinnedBytes());
+  tracker.onCompleted(0, 0);
+  EXPECT_EQ(120, tracker.releaseCompleted());
+}
+
+TEST(ZeroCopySendTrackerTest, CompletionRange) {
+  ZeroCopySendTracker tracker;
+  for (int i = 0; i < 4; i++) {
+    tracker.onSend(1, true);
+  }
+  tracker.onCompleted(0, 2);
+  EXPECT_EQ(3, tracker.releaseCompleted());
+  EXPECT_TRUE(tracker.hasPendingZeroCopySends());
+  tracker.onCompleted(3, 3);
+  EXPECT_EQ(1, tracker.releaseCompleted());
+}
+
+class AdaptiveReadSizeTest : public testing::Test {
+protected:
+  uint64_t reservationBytes() {
+    return store_
+        .gaugeFromString("raw_buffer.read_reservation_bytes", Stats::Gauge::ImportMode::Accumulate)
+        .value();
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  AdaptiveReadConfigSharedPtr config_{std::make_shared<AdaptiveReadConfig>(1024, 8192, store_)};
+};
+
+TEST_F(AdaptiveReadSizeTest, GrowsOnFullReads) {
+  AdaptiveReadSize read_size(config_);
+  EXPECT_EQ(1024, read_size.readSize());
+  EXPECT_EQ(1024, reservationBytes());
+
+  read_size.onRead(1024);
+  EXPECT_EQ(2048, read_size.readSize());
+  read_size.onRead(2048);
+  read_size.onRead(4096);
+  EXPECT_EQ(8192, read_size.readSize());
+  // Capped at the maximum.
+  read_size.onRead(8192);
+  EXPECT_EQ(8192, read_size.readSize());
+  EXPECT_EQ(8192, reservationBytes());
+}
+
+TEST_F(AdaptiveReadSizeTest, ShrinksAfterSmallReads) {
+  AdaptiveReadSize read_size(config_);
+  read_size.onRead(1024);
+  read_size.onRead(2048);
+  EXPECT_EQ(4096, read_size.readSize());
+
+  for (uint32_t i = 1; i < AdaptiveReadSize::ShrinkAfterSmallReads; i++) {
+    read_size.onRead(100);
+  }
+  // A read that is not small resets the count.
+  read_size.onRead(2000);
+  for (uint32_t i = 1; i < AdaptiveReadSize::ShrinkAfterSmallReads; i++) {
+    read_size.onRead(100);
+  }
+  EXPECT_EQ(4096, read_size.readSize());
+  read_size.onRead(100);
+  EXPECT_EQ(2048, read_size.readSize());
+  EXPECT_EQ(2048, reservationBytes());
+
+  // Never below the minimum.
+  for (uint32_t i = 0; i < 4 * AdaptiveReadSize::ShrinkAfterSmallReads; i++) {
+    read_size.onRead(1);
+  }
+  EXPECT_EQ(1024, read_size.readSize());
+}
+
+TEST_F(AdaptiveReadSizeTest, ReservationsOfAllConnections) {
+  auto first = std::make_unique<AdaptiveReadSize>(config_);
+  AdaptiveReadSize second(config_);
+  second.onRead(1024);
+  EXPECT_EQ(3072, reservationBytes());
+  first.reset();
+  EXPECT_EQ(2048, reservationBytes());
+}
+
+TEST_F(AdaptiveReadSizeTest, SocketReadsUseAdaptiveSize) {
+  RawBufferSocket socket(0, config_);
+  NiceMock<MockTransportSocketCallbacks> callbacks;
+  NiceMock<MockIoHandle> io_handle;
+  ON_CALL(callbacks, ioHandle()).WillByDefault(ReturnRef(io_handle));
+  socket.setTransportSocketCallbacks(callbacks);
+
+  const auto fill = [](Buffer::Instance& buffer, uint64_t max_length) {
+    buffer.add(std::string(max_length, 'a'));
+    return Api::IoCallUint64Result(max_length,
+                                   Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
+  };
+  testing::InSequence s;
+  EXPECT_CALL(io_handle, read(_, 1024)).WillOnce(Invoke(fill));
+  EXPECT_CALL(io_handle, read(_, 2048)).WillOnce(Invoke(fill));
+  EXPECT_CALL(io_handle, read(_, 4096))
+      .WillOnce(Return(ByMove(Api::IoCallUint64Result(
+          0, Api::IoErrorPtr(IoSocketError::getIoSocketEagainInstance(),
+                             IoSocketError::deleteIoError)))));
+  Buffer::OwnedImpl buffer;
+  const IoResult result = socket.doRead(buffer);
+  EXPECT_EQ(PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(3072, result.bytes_processed_);
+  EXPECT_EQ(3072, buffer.length());
+}
+
+#if defined(__linux__) && defined(SO_ZEROCOPY)
+class RawBufferSocketZeroCopyTest : public testing::Test {
+protected:
+  void SetUp() override {
+    const os_fd_t listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(listener, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_len = sizeof(addr);
+    ASSERT_EQ(0, ::bind(listener, reinterpret_cast<sockaddr*>(&addr), addr_len));
+    ASSERT_EQ(0, ::listen(listener, 1));
+    ASSERT_EQ(0, ::getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &addr_len));
+
+    const os_fd_t client = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_EQ(0, ::connect(client, reinterpret_cast<sockaddr*>(&addr), addr_len));
+    peer_ = ::accept(listener, nullptr, nullptr);
+    ASSERT_GE(peer_, 0);
+    ::close(listener);
+
+    const int enable = 1;
+    if (::setsockopt(client, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) != 0) {
+      ::close(client);
+      GTEST_SKIP() << "SO_ZEROCOPY is not supported by the kernel";
+    }
+    io_handle_ = std::make_unique<IoSocketHandleImpl>(client);
+    ON_CALL(callbacks_, ioHandle()).WillByDefault(ReturnRef(*io_handle_));
+  }
+
+  void TearDown() override {
+    if (peer_ >= 0) {
+      ::close(peer_);
+    }
+  }
+
+  std::string readFromPeer(uint64_t length) {
+    std::string data;
+    while (data.size() < length) {
+      char buf[16384];
+      const ssize_t rc = ::recv(peer_, buf, sizeof(buf), 0);
+      if (rc <= 0) {
+        break;
+      }
+      data.append(buf, rc);
+    }
+    return data;
+  }
+
+  NiceMock<MockTransportSocketCallbacks> callbacks_;
+  std::unique_ptr<IoSocketHandleImpl> io_handle_;
+  os_fd_t peer_{-1};
+};
+
+// Zero copy sends keep their bytes in the write buffer until the kernel reports completion.
+TEST_F(RawBufferSocketZeroCopyTest, BytesStayBufferedUntilCompletion) {
+  RawBufferSocket socket(4096);
+  socket.setTransportSocketCallbacks(callbacks_);
+
+  const std::string payload(32768, 'a');
+  Buffer::OwnedImpl buffer(payload);
+  IoResult result = socket.doWrite(buffer, false);
+  EXPECT_EQ(PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(payload.size(), result.bytes_processed_);
+  EXPECT_EQ(payload, readFromPeer(payload.size()));
+
+  // Wait for the completion notification, then let the socket release the bytes.
+  for (int i = 0; i < 100 && buffer.length() > 0; i++) {
+    struct pollfd pfd = {io_handle_->fdDoNotUse(), 0, 0};
+    poll(&pfd, 1, 100);
+    result = socket.doWrite(buffer, false);
+    EXPECT_EQ(PostIoAction::KeepOpen, result.action_);
+    EXPECT_EQ(0, result.bytes_processed_);
+  }
+  EXPECT_EQ(0, buffer.length());
+
+  // Loopback copies the data, which disables zero copy for the rest of the connection.
+  buffer.add("hello");
+  result = socket.doWrite(buffer, false);
+  EXPECT_EQ(5, result.bytes_processed_);
+  EXPECT_EQ(0, buffer.length());
+  EXPECT_EQ("hello", readFromPeer(5));
+}
+
+// Writes below the threshold are not pinned.
+TEST_F(RawBufferSocketZeroCopyTest, SmallWritesAreCopied) {
+  RawBufferSocket socket(65536);
+  socket.setTransportSocketCallbacks(callbacks_);
+
+  Buffer::OwnedImpl buffer(std::string(4096, 'a'));
+  IoResult result = socket.doWrite(buffer, false);
+  EXPECT_EQ(4096, result.bytes_processed_);
+  EXPECT_EQ(0, buffer.length());
+}
+#endif
+
+} // namespace
 } // namespace Network
 } // namespace Envoy
@@ -127,6 +127,23 @@ TEST_F(SocketOptionFactoryTest, TestBuildIpv6TransparentOptions) {
                                             envoy::config::core::v3::SocketOption::STATE_BOUND));
 }
 
+// The steering program is only attached once the socket listens, and its failure to attach never
+// fails the listener.
+TEST_F(SocketOptionFactoryTest, TestBuildReusePortCpuSteeringOptions) {
+  std::shared_ptr<Socket::Options> options =
+      SocketOptionFactory::buildReusePortCpuSteeringOptions();
+  EXPECT_EQ(1, options->size());
+  EXPECT_CALL(socket_mock_, setSocketOption(_, _, _, _)).Times(0);
+  EXPECT_TRUE(Network::Socket::applyOptions(options, socket_mock_,
+                                            envoy::config::core::v3::SocketOption::STATE_PREBIND));
+  EXPECT_TRUE(Network::Socket::applyOptions(options, socket_mock_,
+                                            envoy::config::core::v3::SocketOption::STATE_BOUND));
+  EXPECT_FALSE(options->at(0)
+                   ->getOptionDetails(socket_mock_,
+                                      envoy::config::core::v3::SocketOption::STATE_LISTENING)
+                   .has_value());
+}
+
 TEST_F(SocketOptionFactoryTest, TestBuildLiteralOptions) {
   Protobuf::RepeatedPtrField<envoy::config::core::v3::SocketOption> socket_options_proto;
   Envoy::Protobuf::TextFormat::Parser parser;
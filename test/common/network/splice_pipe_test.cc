@@ -0,0 +1,80 @@
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/network/splice_pipe.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class SplicePipeTest : public testing::Test {
+protected:
+  void SetUp() override {
+    pipe_ = SplicePipe::create();
+    if (pipe_ == nullptr) {
+      GTEST_SKIP() << "splice is not supported on this platform";
+    }
+    ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, source_));
+    ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, destination_));
+    ASSERT_EQ(0, ::fcntl(source_[1], F_SETFL, O_NONBLOCK));
+  }
+
+  void TearDown() override {
+    for (os_fd_t fd : {source_[0], source_[1], destination_[0], destination_[1]}) {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+    }
+  }
+
+  std::string readDestination() {
+    char buf[64];
+    const ssize_t rc = ::read(destination_[1], buf, sizeof(buf));
+    return rc > 0 ? std::string(buf, rc) : "";
+  }
+
+  SplicePipePtr pipe_;
+  os_fd_t source_[2]{-1, -1};
+  os_fd_t destination_[2]{-1, -1};
+};
+
+TEST_F(SplicePipeTest, FillAndDrain) {
+  ASSERT_EQ(5, ::write(source_[0], "hello", 5));
+  Api::SysCallSizeResult result = pipe_->fill(source_[1]);
+  EXPECT_EQ(5, result.rc_);
+  EXPECT_EQ(5, pipe_->length());
+
+  result = pipe_->drain(destination_[0]);
+  EXPECT_EQ(5, result.rc_);
+  EXPECT_EQ(0, pipe_->length());
+  EXPECT_EQ("hello", readDestination());
+
+  // Nothing more to read.
+  result = pipe_->fill(source_[1]);
+  EXPECT_EQ(-1, result.rc_);
+  EXPECT_EQ(SOCKET_ERROR_AGAIN, result.errno_);
+
+  // End of stream.
+  ::close(source_[0]);
+  source_[0] = -1;
+  result = pipe_->fill(source_[1]);
+  EXPECT_EQ(0, result.rc_);
+}
+
+TEST_F(SplicePipeTest, MoveToBuffer) {
+  ASSERT_EQ(11, ::write(source_[0], "hello world", 11));
+  EXPECT_EQ(11, pipe_->fill(source_[1]).rc_);
+
+  Buffer::OwnedImpl buffer("> ");
+  pipe_->moveTo(buffer);
+  EXPECT_EQ(0, pipe_->length());
+  EXPECT_EQ("> hello world", buffer.toString());
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,261 @@
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/buffer/buffer_impl.h"
+#include "common/network/address_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/network/udp_batch_writer.h"
+
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "absl/strings/str_cat.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::Return;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+// Lets tests observe and fail the sendmmsg() calls, which otherwise go to the kernel.
+class OverrideOsSysCallsImpl : public Api::OsSysCallsImpl {
+public:
+  MOCK_METHOD(bool, supportsUdpGso, (), (const));
+  MOCK_METHOD(Api::SysCallIntResult, sendmmsg,
+              (os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen, int flags));
+
+  Api::SysCallIntResult realSendmmsg(os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                     int flags) {
+    return Api::OsSysCallsImpl::sendmmsg(sockfd, msgvec, vlen, flags);
+  }
+};
+
+uint16_t gsoSegmentSize(const msghdr& message) {
+  for (const cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(const_cast<msghdr*>(&message), const_cast<cmsghdr*>(cmsg))) {
+    if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_SEGMENT) {
+      uint16_t segment_size;
+      memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+      return segment_size;
+    }
+  }
+  return 0;
+}
+
+class UdpBatchWriterTest : public testing::Test {
+protected:
+  void SetUp() override {
+    if (!Api::OsSysCallsSingleton::get().supportsMmsg()) {
+      GTEST_SKIP() << "sendmmsg() is not supported";
+    }
+    ON_CALL(os_sys_calls_, supportsUdpGso()).WillByDefault(Return(false));
+    ON_CALL(os_sys_calls_, sendmmsg(_, _, _, _))
+        .WillByDefault(Invoke(&os_sys_calls_, &OverrideOsSysCallsImpl::realSendmmsg));
+
+    client_handle_ = std::make_unique<IoSocketHandleImpl>(createSocket(nullptr));
+    for (auto& server : servers_) {
+      server.fd_ = createSocket(&server.address_);
+    }
+  }
+
+  void TearDown() override {
+    for (auto& server : servers_) {
+      ::close(server.fd_);
+    }
+  }
+
+  os_fd_t createSocket(Address::InstanceConstSharedPtr* address) {
+    const os_fd_t fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    EXPECT_GE(fd, 0);
+    ::fcntl(fd, F_SETFL, O_NONBLOCK);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_len = sizeof(addr);
+    EXPECT_EQ(0, ::bind(fd, reinterpret_cast<sockaddr*>(&addr), addr_len));
+    EXPECT_EQ(0, ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &addr_len));
+    if (address != nullptr) {
+      *address = std::make_shared<Address::Ipv4Instance>(&addr);
+    }
+    return fd;
+  }
+
+  Api::IoCallUint64Result write(UdpBatchWriter& writer, const std::string& data,
+                                uint32_t server = 0) {
+    Buffer::OwnedImpl buffer(data);
+    return writer.writePacket(buffer, nullptr, *servers_[server].address_);
+  }
+
+  // Returns the datagrams available on a server socket.
+  std::vector<std::string> receive(uint32_t server = 0) {
+    std::vector<std::string> datagrams;
+    char buf[65536];
+    ssize_t rc;
+    while ((rc = ::recv(servers_[server].fd_, buf, sizeof(buf), 0)) >= 0) {
+      datagrams.emplace_back(buf, rc);
+    }
+    return datagrams;
+  }
+
+  struct Server {
+    os_fd_t fd_;
+    Address::InstanceConstSharedPtr address_;
+  };
+
+  testing::NiceMock<OverrideOsSysCallsImpl> os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_{&os_sys_calls_};
+  IoHandlePtr client_handle_;
+  Server servers_[2];
+};
+
+// Datagrams are only sent once flushed, all with a single sendmmsg() call.
+TEST_F(UdpBatchWriterTest, FlushSendsQueuedDatagrams) {
+  UdpBatchWriter writer(*client_handle_);
+  EXPECT_TRUE(writer.isBatchMode());
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, _, _)).Times(0);
+  EXPECT_EQ(5, write(writer, "hello").rc_);
+  EXPECT_EQ(2, write(writer, "hi", 1).rc_);
+  EXPECT_EQ(5, write(writer, "world").rc_);
+  EXPECT_EQ(3, writer.queuedPackets());
+  EXPECT_TRUE(receive().empty());
+  testing::Mock::VerifyAndClearExpectations(&os_sys_calls_);
+
+  EXPECT_CALL(os_sys_calls_, sendmmsg(client_handle_->fdDoNotUse(), _, 3, 0))
+      .WillOnce(Invoke(&os_sys_calls_, &OverrideOsSysCallsImpl::realSendmmsg));
+  const Api::IoCallUint64Result result = writer.flush();
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(12, result.rc_);
+  EXPECT_EQ(0, writer.queuedPackets());
+  EXPECT_EQ((std::vector<std::string>{"hello", "world"}), receive(0));
+  EXPECT_EQ((std::vector<std::string>{"hi"}), receive(1));
+
+  // Nothing is left to send.
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, _, _)).Times(0);
+  EXPECT_EQ(0, writer.flush().rc_);
+}
+
+// Runs of equally sized datagrams to the same peer are sent as a single GSO message.
+TEST_F(UdpBatchWriterTest, CoalescesDatagramsWithGso) {
+  EXPECT_CALL(os_sys_calls_, supportsUdpGso()).WillOnce(Return(true));
+  UdpBatchWriter writer(*client_handle_);
+  const std::string full(100, 'a');
+  write(writer, full);
+  write(writer, full);
+  write(writer, "short");
+  // Cannot follow the shorter datagram.
+  write(writer, full);
+  // Different peer.
+  write(writer, full, 1);
+
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 3, 0))
+      .WillOnce(Invoke([](os_fd_t, struct mmsghdr* msgvec, unsigned int vlen,
+                          int) -> Api::SysCallIntResult {
+        EXPECT_EQ(205, msgvec[0].msg_hdr.msg_iov[0].iov_len);
+        EXPECT_EQ(100, gsoSegmentSize(msgvec[0].msg_hdr));
+        EXPECT_EQ(100, msgvec[1].msg_hdr.msg_iov[0].iov_len);
+        EXPECT_EQ(0, gsoSegmentSize(msgvec[1].msg_hdr));
+        EXPECT_EQ(100, msgvec[2].msg_hdr.msg_iov[0].iov_len);
+        EXPECT_EQ(0, gsoSegmentSize(msgvec[2].msg_hdr));
+        for (unsigned int i = 0; i < vlen; i++) {
+          msgvec[i].msg_len = msgvec[i].msg_hdr.msg_iov[0].iov_len;
+        }
+        return {static_cast<int>(vlen), 0};
+      }));
+  const Api::IoCallUint64Result result = writer.flush();
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(405, result.rc_);
+}
+
+// The peer receives the datagrams of a GSO message separately.
+TEST_F(UdpBatchWriterTest, GsoDatagramsReceivedSeparately) {
+  if (!os_sys_calls_.Api::OsSysCallsImpl::supportsUdpGso()) {
+    return;
+  }
+  EXPECT_CALL(os_sys_calls_, supportsUdpGso()).WillOnce(Return(true));
+  UdpBatchWriter writer(*client_handle_);
+  write(writer, "aaaa");
+  write(writer, "bbbb");
+  write(writer, "cc");
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 1, 0))
+      .WillOnce(Invoke(&os_sys_calls_, &OverrideOsSysCallsImpl::realSendmmsg));
+  EXPECT_EQ(10, writer.flush().rc_);
+  EXPECT_EQ((std::vector<std::string>{"aaaa", "bbbb", "cc"}), receive());
+}
+
+// Datagrams that could not be sent while the socket was not writable are kept until it is.
+TEST_F(UdpBatchWriterTest, WriteBlocked) {
+  UdpBatchWriter writer(*client_handle_);
+  write(writer, "one");
+  write(writer, "two");
+  write(writer, "three");
+
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 3, 0))
+      .WillOnce(Invoke([this](os_fd_t fd, struct mmsghdr* msgvec, unsigned int,
+                              int flags) -> Api::SysCallIntResult {
+        return os_sys_calls_.realSendmmsg(fd, msgvec, 1, flags);
+      }));
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 2, 0))
+      .WillOnce(Return(Api::SysCallIntResult{-1, SOCKET_ERROR_AGAIN}));
+  Api::IoCallUint64Result result = writer.flush();
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+  EXPECT_TRUE(writer.isWriteBlocked());
+  EXPECT_EQ(2, writer.queuedPackets());
+  EXPECT_EQ((std::vector<std::string>{"one"}), receive());
+
+  // Writes are refused while blocked.
+  result = write(writer, "four");
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+  EXPECT_EQ(2, writer.queuedPackets());
+
+  writer.setWritable();
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 2, 0))
+      .WillOnce(Invoke(&os_sys_calls_, &OverrideOsSysCallsImpl::realSendmmsg));
+  result = writer.flush();
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(8, result.rc_);
+  EXPECT_EQ((std::vector<std::string>{"two", "three"}), receive());
+}
+
+// A datagram that cannot be sent is dropped without holding back the others.
+TEST_F(UdpBatchWriterTest, SendError) {
+  UdpBatchWriter writer(*client_handle_);
+  write(writer, "one");
+  write(writer, "two");
+
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 2, 0))
+      .WillOnce(Return(Api::SysCallIntResult{-1, ECONNREFUSED}));
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 1, 0))
+      .WillOnce(Invoke(&os_sys_calls_, &OverrideOsSysCallsImpl::realSendmmsg));
+  const Api::IoCallUint64Result result = writer.flush();
+  EXPECT_FALSE(result.ok());
+  EXPECT_EQ(3, result.rc_);
+  EXPECT_FALSE(writer.isWriteBlocked());
+  EXPECT_EQ(0, writer.queuedPackets());
+  EXPECT_EQ((std::vector<std::string>{"two"}), receive());
+}
+
+// The writer flushes by itself once its queue is full.
+TEST_F(UdpBatchWriterTest, FlushesWhenFull) {
+  UdpBatchWriter writer(*client_handle_);
+  for (uint32_t i = 0; i < UdpBatchWriter::MaxBatchPackets; i++) {
+    write(writer, absl::StrCat(i));
+  }
+  EXPECT_EQ(UdpBatchWriter::MaxBatchPackets, writer.queuedPackets());
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, UdpBatchWriter::MaxBatchPackets, 0));
+  write(writer, "last");
+  EXPECT_EQ(1, writer.queuedPackets());
+  EXPECT_EQ(UdpBatchWriter::MaxBatchPackets, receive().size());
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
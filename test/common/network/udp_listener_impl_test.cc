@@ -10,6 +10,7 @@
 #include "common/network/address_impl.h"
 #include "common/network/socket_option_factory.h"
 #include "common/network/socket_option_impl.h"
+#include "common/network/udp_batch_writer.h"
 #include "common/network/udp_listener_impl.h"
 #include "common/network/udp_packet_writer_handler_impl.h"
 #include "common/network/utility.h"
@@ -369,6 +370,36 @@ TEST_P(UdpListenerImplTest, SendData) {
   EXPECT_EQ(0, flush_result.rc_);
 }
 
+/**
+ * Tests that datagrams sent through a batching writer are flushed at the end of the dispatcher
+ * loop iteration.
+ */
+TEST_P(UdpListenerImplTest, SendDataBatched) {
+  if (!Api::OsSysCallsSingleton::get().supportsMmsg()) {
+    return;
+  }
+  UdpBatchWriter batch_writer(server_socket_->ioHandle());
+  ON_CALL(listener_callbacks_, udpPacketWriter()).WillByDefault(ReturnRef(batch_writer));
+  Address::InstanceConstSharedPtr send_from_addr = getNonDefaultSourceAddress();
+  for (absl::string_view payload : {"hello", "world"}) {
+    Buffer::OwnedImpl buffer(payload);
+    UdpSendData send_data{send_from_addr->ip(), *client_.localAddress(), buffer};
+    auto send_result = listener_->send(send_data);
+    EXPECT_TRUE(send_result.ok()) << "send() failed : " << send_result.err_->getErrorDetails();
+    EXPECT_EQ(0, buffer.length());
+  }
+  EXPECT_EQ(2, batch_writer.queuedPackets());
+
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(0, batch_writer.queuedPackets());
+  for (absl::string_view payload : {"hello", "world"}) {
+    UdpRecvData data;
+    client_.recv(data);
+    EXPECT_EQ(send_from_addr->asString(), data.addresses_.peer_->asString());
+    EXPECT_EQ(payload, data.buffer_->toString());
+  }
+}
+
 /**
  * The send fails because the server_socket is created with bind=false.
  */
@@ -512,6 +543,8 @@ TEST_P(UdpListenerImplTest, UdpGroBasic) {
       }))
       .WillRepeatedly(Return(Api::SysCallSizeResult{-1, EAGAIN}));
 
+  // The packets are handed out without copying them out of the memory of the read.
+  const void* read_memory = nullptr;
   EXPECT_CALL(listener_callbacks_, onReadReady());
   EXPECT_CALL(listener_callbacks_, onData(_))
       .WillOnce(Invoke([&](const UdpRecvData& data) -> void {
@@ -519,12 +552,18 @@ TEST_P(UdpListenerImplTest, UdpGroBasic) {
 
         const std::string data_str = data.buffer_->toString();
         EXPECT_EQ(data_str, client_data[num_packets_received_by_listener_ - 1]);
+        ASSERT_EQ(1, data.buffer_->getRawSlices().size());
+        read_memory = data.buffer_->getRawSlices()[0].mem_;
       }))
       .WillRepeatedly(Invoke([&](const UdpRecvData& data) -> void {
         validateRecvCallbackParams(data, client_data.size());
 
         const std::string data_str = data.buffer_->toString();
         EXPECT_EQ(data_str, client_data[num_packets_received_by_listener_ - 1]);
+        ASSERT_EQ(1, data.buffer_->getRawSlices().size());
+        EXPECT_EQ(static_cast<const uint8_t*>(read_memory) +
+                      8 * (num_packets_received_by_listener_ - 1),
+                  data.buffer_->getRawSlices()[0].mem_);
       }));
 
   EXPECT_CALL(listener_callbacks_, onWriteReady(_)).WillOnce(Invoke([&](const Socket& socket) {
@@ -0,0 +1,132 @@
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+
+#include "common/common/thread.h"
+#include "common/profiler/sampling_profiler.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/time/clock.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::HasSubstr;
+
+namespace Envoy {
+namespace Profiler {
+namespace {
+
+class SamplingProfilerTest : public testing::Test {
+protected:
+  ~SamplingProfilerTest() override { SamplingProfiler::stop(); }
+
+  // Uses CPU on a thread with a name, for the profiler to sample it.
+  void burnCpu(const std::string& name, absl::Duration duration) {
+    std::atomic<uint64_t> sum{};
+    Thread::ThreadPtr thread = Thread::threadFactoryForTest().createThread(
+        [&]() {
+          const absl::Time deadline = absl::Now() + duration;
+          while (absl::Now() < deadline) {
+            for (uint64_t i = 0; i < 10000; ++i) {
+              sum.fetch_add(i, std::memory_order_relaxed);
+            }
+          }
+        },
+        Thread::Options{name});
+    thread->join();
+  }
+};
+
+#ifdef __linux__
+// The stacks of the threads using CPU are sampled, attributed to the threads and rendered.
+TEST_F(SamplingProfilerTest, SampleThreads) {
+  EXPECT_FALSE(SamplingProfiler::start(0));
+  EXPECT_FALSE(SamplingProfiler::start(SamplingProfiler::MaxFrequency + 1));
+  ASSERT_TRUE(SamplingProfiler::start(SamplingProfiler::MaxFrequency));
+  EXPECT_TRUE(SamplingProfiler::running());
+  EXPECT_FALSE(SamplingProfiler::start(SamplingProfiler::MaxFrequency));
+  EXPECT_EQ(SamplingProfiler::MaxFrequency, SamplingProfiler::frequency());
+
+  burnCpu("burner", absl::Milliseconds(500));
+  SamplingProfiler::stop();
+  EXPECT_FALSE(SamplingProfiler::running());
+
+  // The samples are kept once sampling stops, along with the names of the threads, which exited
+  // since.
+  const auto stacks = SamplingProfiler::stacks(std::chrono::milliseconds(0), "");
+  ASSERT_FALSE(stacks.empty());
+  uint64_t samples = 0;
+  for (const auto& stack : stacks) {
+    EXPECT_FALSE(stack.frames_.empty());
+    EXPECT_LE(stack.frames_.size(), SamplingProfiler::MaxStackDepth);
+    samples += stack.count_;
+  }
+  EXPECT_LE(samples, SamplingProfiler::Capacity);
+
+  const auto thread_stacks = SamplingProfiler::stacks(std::chrono::milliseconds(0), "burner");
+  ASSERT_FALSE(thread_stacks.empty());
+  for (const auto& stack : thread_stacks) {
+    EXPECT_EQ("burner", stack.thread_name_);
+  }
+  EXPECT_TRUE(SamplingProfiler::stacks(std::chrono::milliseconds(0), "no-such-thread").empty());
+
+  const std::string collapsed = SamplingProfiler::collapsed(stacks);
+  EXPECT_THAT(collapsed, HasSubstr(";"));
+  EXPECT_EQ('\n', collapsed.back());
+
+  const std::string pprof = SamplingProfiler::pprof(stacks, SamplingProfiler::frequency());
+  uintptr_t header[5];
+  ASSERT_GT(pprof.size(), sizeof(header));
+  memcpy(header, pprof.data(), sizeof(header));
+  EXPECT_EQ(0, header[0]);
+  EXPECT_EQ(3, header[1]);
+  EXPECT_EQ(0, header[2]);
+  EXPECT_EQ(1000, header[3]);
+  EXPECT_THAT(pprof, HasSubstr("[stack]"));
+}
+
+// Only the samples of the window are aggregated.
+TEST_F(SamplingProfilerTest, Window) {
+  ASSERT_TRUE(SamplingProfiler::start(SamplingProfiler::MaxFrequency));
+  burnCpu("burner", absl::Milliseconds(200));
+  SamplingProfiler::stop();
+  ASSERT_FALSE(SamplingProfiler::stacks(std::chrono::milliseconds(0), "").empty());
+
+  absl::SleepFor(absl::Milliseconds(20));
+  EXPECT_TRUE(SamplingProfiler::stacks(std::chrono::milliseconds(10), "").empty());
+}
+#else
+TEST_F(SamplingProfilerTest, Unsupported) {
+  EXPECT_FALSE(SamplingProfiler::start(SamplingProfiler::DefaultFrequency));
+  EXPECT_FALSE(SamplingProfiler::running());
+  EXPECT_TRUE(SamplingProfiler::stacks(std::chrono::milliseconds(0), "").empty());
+}
+#endif
+
+// The collapsed stacks list the frames outermost first, after the thread name.
+TEST_F(SamplingProfilerTest, Collapsed) {
+  void* inner = reinterpret_cast<void*>(0x10);
+  void* outer = reinterpret_cast<void*>(0x20);
+  EXPECT_EQ("worker;[0x20];[0x10] 3\n",
+            SamplingProfiler::collapsed({{"worker", {inner, outer}, 3}}));
+}
+
+// The legacy CPU profile lists the count, depth and frames of each stack after the header, and
+// ends with the memory mappings after the trailer.
+TEST_F(SamplingProfilerTest, Pprof) {
+  void* frame = reinterpret_cast<void*>(0x10);
+  const std::string pprof = SamplingProfiler::pprof({{"worker", {frame}, 3}}, 100);
+  uintptr_t words[11];
+  ASSERT_GE(pprof.size(), sizeof(words));
+  memcpy(words, pprof.data(), sizeof(words));
+  const uintptr_t expected[11] = {0, 3, 0, 10000, 0, 3, 1, 0x10, 0, 1, 0};
+  for (size_t i = 0; i < 11; ++i) {
+    EXPECT_EQ(expected[i], words[i]) << i;
+  }
+}
+
+} // namespace
+} // namespace Profiler
+} // namespace Envoy
@@ -0,0 +1,42 @@
+#include <atomic>
+#include <csignal>
+
+#include "common/profiler/signal_stack_sampler.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Profiler {
+namespace {
+
+std::atomic<int> captured_depth{-1};
+std::atomic<void*> captured_frame{};
+
+void captureCallback(void* const* frames, int depth) {
+  captured_depth.store(depth);
+  captured_frame.store(depth > 0 ? frames[0] : nullptr);
+}
+
+#ifdef __linux__
+// The stack of the thread that the signal interrupts is handed over to the callback of the signal.
+TEST(SignalStackSamplerTest, CaptureOnSignal) {
+  ASSERT_TRUE(SignalStackSampler::install(SIGUSR2, captureCallback));
+  raise(SIGUSR2);
+  EXPECT_GT(captured_depth.load(), 0);
+  EXPECT_LE(captured_depth.load(), SignalStackSampler::MaxStackDepth);
+  EXPECT_NE(nullptr, captured_frame.load());
+  signal(SIGUSR2, SIG_DFL);
+}
+#else
+TEST(SignalStackSamplerTest, Unsupported) {
+  EXPECT_FALSE(SignalStackSampler::install(SIGTERM, captureCallback));
+}
+#endif
+
+TEST(SignalStackSamplerTest, SymbolizeUnknownFrame) {
+  EXPECT_EQ(absl::nullopt, SignalStackSampler::symbolize(nullptr));
+}
+
+} // namespace
+} // namespace Profiler
+} // namespace Envoy
@@ -0,0 +1,123 @@
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "envoy/config/route/v3/route_components.pb.h"
+
+#include "common/router/adaptive_hedge.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+TEST(AdaptiveHedgeImplTest, Buckets) {
+  for (uint64_t response_time_ms : {0, 1, 3, 4, 7, 8, 9, 10, 100, 1000, 65535, 1000000}) {
+    const uint32_t bucket = AdaptiveHedgeImpl::bucket(response_time_ms);
+    EXPECT_LE(response_time_ms, AdaptiveHedgeImpl::bucketUpperBound(bucket));
+    // The bucket bounds are within a quarter of the response times they count.
+    EXPECT_LE(AdaptiveHedgeImpl::bucketUpperBound(bucket), response_time_ms * 5 / 4 + 1);
+    if (bucket > 0) {
+      EXPECT_GT(response_time_ms, AdaptiveHedgeImpl::bucketUpperBound(bucket - 1));
+    }
+  }
+  EXPECT_EQ(AdaptiveHedgeImpl::NumBuckets - 1, AdaptiveHedgeImpl::bucket(UINT64_MAX));
+}
+
+TEST(AdaptiveHedgeImplTest, Percentile) {
+  AdaptiveHedgeImpl adaptive_hedge({});
+  EXPECT_EQ(absl::nullopt, adaptive_hedge.onRequest());
+
+  // 95% of the responses take 10ms.
+  for (uint32_t i = 1; i < AdaptiveHedgeImpl::SampleWindow; ++i) {
+    adaptive_hedge.onResponse(std::chrono::milliseconds(i % 20 == 0 ? 1000 : 10));
+    EXPECT_EQ(absl::nullopt, adaptive_hedge.onRequest());
+  }
+  adaptive_hedge.onResponse(std::chrono::milliseconds(10));
+  EXPECT_EQ(std::chrono::milliseconds(11), adaptive_hedge.onRequest());
+
+  // The estimate follows the response times of the latest window.
+  envoy::config::route::v3::HedgePolicy::AdaptiveHedge config;
+  config.mutable_percentile()->set_value(50);
+  AdaptiveHedgeImpl median(config);
+  for (uint32_t i = 0; i < AdaptiveHedgeImpl::SampleWindow; ++i) {
+    median.onResponse(std::chrono::milliseconds(i < 600 ? 2 : 100));
+  }
+  EXPECT_EQ(std::chrono::milliseconds(2), median.onRequest());
+  for (uint32_t i = 0; i < AdaptiveHedgeImpl::SampleWindow; ++i) {
+    median.onResponse(std::chrono::milliseconds(i < 600 ? 100 : 2));
+  }
+  EXPECT_EQ(std::chrono::milliseconds(111), median.onRequest());
+}
+
+// Response times of 0ms do not hedge requests immediately.
+TEST(AdaptiveHedgeImplTest, MinimumDelay) {
+  AdaptiveHedgeImpl adaptive_hedge({});
+  for (uint32_t i = 0; i < AdaptiveHedgeImpl::SampleWindow; ++i) {
+    adaptive_hedge.onResponse(std::chrono::milliseconds(0));
+  }
+  EXPECT_EQ(std::chrono::milliseconds(1), adaptive_hedge.onRequest());
+}
+
+TEST(AdaptiveHedgeImplTest, HedgeBudget) {
+  envoy::config::route::v3::HedgePolicy::AdaptiveHedge config;
+  config.mutable_hedge_budget()->set_value(20);
+  AdaptiveHedgeImpl adaptive_hedge(config);
+  EXPECT_FALSE(adaptive_hedge.tryHedge());
+
+  for (uint32_t i = 0; i < 10; ++i) {
+    adaptive_hedge.onRequest();
+  }
+  EXPECT_TRUE(adaptive_hedge.tryHedge());
+  EXPECT_TRUE(adaptive_hedge.tryHedge());
+  EXPECT_FALSE(adaptive_hedge.tryHedge());
+
+  // The budget covers the requests of the previous window too.
+  for (uint32_t i = 0; i < AdaptiveHedgeImpl::SampleWindow; ++i) {
+    adaptive_hedge.onResponse(std::chrono::milliseconds(10));
+  }
+  EXPECT_FALSE(adaptive_hedge.tryHedge());
+  for (uint32_t i = 0; i < 5; ++i) {
+    adaptive_hedge.onRequest();
+  }
+  EXPECT_TRUE(adaptive_hedge.tryHedge());
+  EXPECT_FALSE(adaptive_hedge.tryHedge());
+}
+
+// The budget holds while the workers count requests and hedges concurrently.
+TEST(AdaptiveHedgeImplTest, ConcurrentHedgeBudget) {
+  envoy::config::route::v3::HedgePolicy::AdaptiveHedge config;
+  config.mutable_hedge_budget()->set_value(10);
+  AdaptiveHedgeImpl adaptive_hedge(config);
+
+  constexpr uint32_t NumThreads = 4;
+  constexpr uint32_t NumRequests = 100;
+  std::atomic<uint32_t> hedges{0};
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < NumThreads; ++i) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([&]() {
+      for (uint32_t j = 0; j < NumRequests; ++j) {
+        adaptive_hedge.onRequest();
+        if (adaptive_hedge.tryHedge()) {
+          ++hedges;
+        }
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  EXPECT_LE(hedges, NumThreads * NumRequests / 10);
+  // Once the workers are done, the rest of the budget can be taken, and no more.
+  while (adaptive_hedge.tryHedge()) {
+    ++hedges;
+  }
+  EXPECT_EQ(NumThreads * NumRequests / 10, hedges);
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
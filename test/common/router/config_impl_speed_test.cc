@@ -40,7 +40,8 @@ static Http::TestRequestHeaderMapImpl genRequestHeaders(int route_num) {
  * Generates the route config for the type of matcher being tested.
  */
 static RouteConfiguration genRouteConfig(benchmark::State& state,
-                                         RouteMatch::PathSpecifierCase match_type) {
+                                         RouteMatch::PathSpecifierCase match_type,
+                                         bool header_match = false) {
   // Create the base route config.
   RouteConfiguration route_config;
   VirtualHost* v_host = route_config.add_virtual_hosts();
@@ -60,7 +61,7 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
       break;
     }
     case RouteMatch::PathSpecifierCase::kPath: {
-      match->set_prefix(absl::StrCat("/shelves/shelf_", i, "/route_", i));
+      match->set_path(absl::StrCat("/shelves/shelf_", i, "/route_", i));
       break;
     }
     case RouteMatch::PathSpecifierCase::kSafeRegex: {
@@ -72,6 +73,17 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
     default:
       NOT_REACHED_GCOVR_EXCL_LINE;
     }
+
+    if (header_match) {
+      // A route for the same path that requires a header the request does not have.
+      Route* header_route = v_host->add_routes();
+      *header_route = *route;
+      auto* header = header_route->mutable_match()->add_headers();
+      header->set_name("x-canary");
+      header->set_exact_match("true");
+      header_route->mutable_direct_response()->set_status(503);
+      route->Swap(header_route);
+    }
   }
 
   return route_config;
@@ -79,14 +91,16 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
 
 /**
  * Measure the speed of doing a route match against a route table of varying sizes.
- * Why? Currently, route matching is linear in first-to-win ordering.
+ * Why? Route matching is first-to-win. Regex routes are evaluated linearly, while the prefix and
+ * path routes of virtual hosts with many routes are looked up in a path index.
  *
  * We construct the first `n - 1` items in the route table so they are not
  * matched by the incoming request. Only the last route will be matched.
  * We then time how long it takes for the request to be matched against the
  * last route.
  */
-static void bmRouteTableSize(benchmark::State& state, RouteMatch::PathSpecifierCase match_type) {
+static void bmRouteTableSize(benchmark::State& state, RouteMatch::PathSpecifierCase match_type,
+                             bool header_match = false) {
   // Setup router for benchmarking.
   TestScopedRuntime scoped_runtime;
   Runtime::LoaderSingleton::getExisting()->mergeValues(
@@ -97,7 +111,7 @@ static void bmRouteTableSize(benchmark::State& state, RouteMatch::PathSpecifierC
   ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
 
   // Create router config.
-  ConfigImpl config(genRouteConfig(state, match_type), factory_context,
+  ConfigImpl config(genRouteConfig(state, match_type, header_match), factory_context,
                     ProtobufMessage::getNullValidationVisitor(), true);
 
   for (auto _ : state) { // NOLINT
@@ -118,6 +132,14 @@ static void bmRouteTableSizeWithPathPrefixMatch(benchmark::State& state) {
   bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kPrefix);
 }
 
+/**
+ * Benchmark a route table with the path prefix matchers above, each preceded by a route with the
+ * same prefix and a header matcher that the request does not match.
+ */
+static void bmRouteTableSizeWithPathPrefixAndHeaderMatch(benchmark::State& state) {
+  bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kPrefix, true);
+}
+
 /**
  * Benchmark a route table with exact path matchers in the form of:
  * - /shelves/shelf_1/route_1
@@ -141,6 +163,7 @@ static void bmRouteTableSizeWithRegexMatch(benchmark::State& state) {
 }
 
 BENCHMARK(bmRouteTableSizeWithPathPrefixMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
+BENCHMARK(bmRouteTableSizeWithPathPrefixAndHeaderMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithExactPathMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithRegexMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 
@@ -33,6 +33,7 @@
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -1264,6 +1265,238 @@ virtual_hosts:
             config.route(genHeaders("example.com", "/", "GET"), 0)->routeEntry()->clusterName());
 }
 
+// Virtual hosts with many prefix and path routes index them by path. Route selection must still
+// return the first matching route.
+TEST_F(RouteMatcherTest, PathRouteIndex) {
+  std::string yaml = R"EOF(
+virtual_hosts:
+  - name: indexed
+    domains: ["*"]
+    routes:
+      - match:
+          prefix: "/api/v1/"
+          headers:
+            - name: x-canary
+              exact_match: "true"
+        route: { cluster: "canary" }
+      - match: { safe_regex: { google_re2: {}, regex: "^/api/v1/regex$" } }
+        route: { cluster: "regex" }
+      - match: { prefix: "/API/v2/", case_sensitive: false }
+        route: { cluster: "v2" }
+      - match: { path: "/exact" }
+        route: { cluster: "exact" }
+)EOF";
+  for (int i = 0; i < 16; ++i) {
+    absl::StrAppend(&yaml, "      - match: { prefix: \"/filler_", i, "/\" }\n",
+                    "        route: { cluster: \"filler\" }\n");
+  }
+  absl::StrAppend(&yaml, R"EOF(
+      - match: { prefix: "/api/v1/" }
+        route: { cluster: "v1" }
+      - match: { prefix: "/" }
+        route: { cluster: "default" }
+)EOF");
+
+  factory_context_.cluster_manager_.initializeClusters(
+      {"canary", "regex", "v2", "exact", "filler", "v1", "default"}, {});
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true);
+
+  auto cluster_name = [&config](const std::string& path, bool canary = false) {
+    Http::TestRequestHeaderMapImpl headers = genHeaders("www.lyft.com", path, "GET");
+    if (canary) {
+      headers.addCopy("x-canary", "true");
+    }
+    return config.route(headers, 0)->routeEntry()->clusterName();
+  };
+  EXPECT_EQ("canary", cluster_name("/api/v1/foo", true));
+  EXPECT_EQ("v1", cluster_name("/api/v1/foo"));
+  EXPECT_EQ("regex", cluster_name("/api/v1/regex"));
+  EXPECT_EQ("v2", cluster_name("/api/V2/foo"));
+  EXPECT_EQ("exact", cluster_name("/exact?query"));
+  EXPECT_EQ("default", cluster_name("/exact/more"));
+  EXPECT_EQ("default", cluster_name("/API/V1/foo"));
+  EXPECT_EQ("filler", cluster_name("/filler_3/foo"));
+  EXPECT_EQ("default", cluster_name("/filler_3"));
+}
+
+// Safe regex routes are matched together by the path index.
+TEST_F(RouteMatcherTest, RegexRouteIndex) {
+  std::string yaml = R"EOF(
+virtual_hosts:
+  - name: indexed
+    domains: ["*"]
+    routes:
+      - match:
+          safe_regex: { google_re2: {}, regex: "/users/[0-9]+" }
+          headers:
+            - name: x-canary
+              exact_match: "true"
+        route: { cluster: "canary" }
+      - match: { safe_regex: { google_re2: {}, regex: "/users/[0-9]+" } }
+        route: { cluster: "users" }
+)EOF";
+  for (int i = 0; i < 16; ++i) {
+    absl::StrAppend(&yaml, "      - match: { safe_regex: { google_re2: {}, regex: \"/filler_", i,
+                    "/[a-z]+\" } }\n", "        route: { cluster: \"filler\" }\n");
+  }
+  absl::StrAppend(&yaml, R"EOF(
+      - match: { safe_regex: { google_re2: {}, regex: "/users/.*" } }
+        route: { cluster: "other_users" }
+      - match: { prefix: "/" }
+        route: { cluster: "default" }
+)EOF");
+
+  factory_context_.cluster_manager_.initializeClusters(
+      {"canary", "users", "filler", "other_users", "default"}, {});
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true);
+
+  auto cluster_name = [&config](const std::string& path, bool canary = false) {
+    Http::TestRequestHeaderMapImpl headers = genHeaders("www.lyft.com", path, "GET");
+    if (canary) {
+      headers.addCopy("x-canary", "true");
+    }
+    return config.route(headers, 0)->routeEntry()->clusterName();
+  };
+  EXPECT_EQ("canary", cluster_name("/users/123", true));
+  EXPECT_EQ("users", cluster_name("/users/123?query"));
+  EXPECT_EQ("other_users", cluster_name("/users/abc", true));
+  EXPECT_EQ("default", cluster_name("/Users/123"));
+  EXPECT_EQ("filler", cluster_name("/filler_15/foo"));
+  EXPECT_EQ("default", cluster_name("/filler_15/foo/bar"));
+}
+
+// Routes are cached for virtual hosts whose routes only match by path and method.
+TEST_F(RouteMatcherTest, RouteCache) {
+  const std::string yaml = R"EOF(
+name: foo
+route_cache_max_entries: 16
+virtual_hosts:
+  - name: cached
+    domains: ["cached.lyft.com"]
+    routes:
+      - match:
+          prefix: "/"
+          headers:
+            - name: ":method"
+              exact_match: "POST"
+        route: { cluster: "post" }
+      - match: { path: "/exact" }
+        route: { cluster: "exact" }
+  - name: uncached
+    domains: ["*"]
+    routes:
+      - match:
+          prefix: "/"
+          headers:
+            - name: x-canary
+              exact_match: "true"
+        route: { cluster: "canary" }
+      - match: { prefix: "/" }
+        route: { cluster: "default" }
+)EOF";
+
+  factory_context_.cluster_manager_.initializeClusters({"post", "exact", "canary", "default"},
+                                                       {});
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true);
+
+  auto cluster_name = [&config](Http::TestRequestHeaderMapImpl&& headers) -> std::string {
+    RouteConstSharedPtr route = config.route(headers, 0);
+    return route == nullptr ? "" : route->routeEntry()->clusterName();
+  };
+  auto counter = [this](const std::string& name) {
+    return factory_context_.scope_.counterFromString("route_config.foo.route_cache." + name)
+        .value();
+  };
+
+  EXPECT_EQ("exact", cluster_name(genHeaders("cached.lyft.com", "/exact", "GET")));
+  EXPECT_EQ("exact", cluster_name(genHeaders("cached.lyft.com", "/exact?query", "GET")));
+  EXPECT_EQ("post", cluster_name(genHeaders("cached.lyft.com", "/exact", "POST")));
+  EXPECT_EQ("", cluster_name(genHeaders("cached.lyft.com", "/other", "GET")));
+  EXPECT_EQ("", cluster_name(genHeaders("cached.lyft.com", "/other", "GET")));
+  EXPECT_EQ(2, counter("hit"));
+  EXPECT_EQ(3, counter("miss"));
+
+  // Requests without x-forwarded-proto are not routed, and not looked up.
+  EXPECT_EQ("", cluster_name(genHeaders("cached.lyft.com", "/exact", "GET", "")));
+  EXPECT_EQ(2, counter("hit"));
+  EXPECT_EQ(3, counter("miss"));
+
+  Http::TestRequestHeaderMapImpl canary_headers = genHeaders("www.lyft.com", "/", "GET");
+  canary_headers.addCopy("x-canary", "true");
+  EXPECT_EQ("default", cluster_name(genHeaders("www.lyft.com", "/", "GET")));
+  EXPECT_EQ("canary", cluster_name(std::move(canary_headers)));
+  EXPECT_EQ("default", cluster_name(genHeaders("www.lyft.com", "/", "GET")));
+  EXPECT_EQ(2, counter("hit"));
+  EXPECT_EQ(6, counter("miss"));
+}
+
+// Later versions of a route configuration share the virtual hosts that did not change.
+TEST_F(RouteMatcherTest, ReuseVirtualHosts) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.rds_reuse_virtual_hosts", "true"}});
+
+  auto yaml = [](const std::string& cluster) {
+    return R"EOF(
+name: foo
+virtual_hosts:
+  - name: unchanged
+    domains: ["unchanged.lyft.com"]
+    routes:
+      - match: { prefix: "/" }
+        route: { cluster: "unchanged" }
+  - name: changed
+    domains: ["changed.lyft.com"]
+    routes:
+      - match: { prefix: "/" }
+        route: { cluster: ")EOF" +
+           cluster + "\" }\n";
+  };
+
+  factory_context_.cluster_manager_.initializeClusters({"unchanged", "v1", "v2"}, {});
+  auto route_entry = [](const ConfigImpl& config, const std::string& host) {
+    return config.route(genHeaders(host, "/", "GET"), 0)->routeEntry();
+  };
+
+  auto config_v1 = std::make_unique<ConfigImpl>(
+      parseRouteConfigurationFromYaml(yaml("v1")), factory_context_,
+      ProtobufMessage::getNullValidationVisitor(), false);
+  auto config_v2 = std::make_unique<ConfigImpl>(
+      parseRouteConfigurationFromYaml(yaml("v2")), factory_context_,
+      ProtobufMessage::getNullValidationVisitor(), false, config_v1.get());
+  EXPECT_EQ(route_entry(*config_v1, "unchanged.lyft.com"),
+            route_entry(*config_v2, "unchanged.lyft.com"));
+  EXPECT_NE(route_entry(*config_v1, "changed.lyft.com"),
+            route_entry(*config_v2, "changed.lyft.com"));
+  EXPECT_EQ("v2", route_entry(*config_v2, "changed.lyft.com")->clusterName());
+
+  // Reused virtual hosts outlive the configuration that built them.
+  const RouteEntry* unchanged = route_entry(*config_v1, "unchanged.lyft.com");
+  config_v1.reset();
+  EXPECT_EQ(unchanged, route_entry(*config_v2, "unchanged.lyft.com"));
+  EXPECT_EQ("foo", unchanged->virtualHost().routeConfig().name());
+
+  // Virtual hosts are rebuilt when the settings of the route configuration change.
+  envoy::config::route::v3::RouteConfiguration route_config_v3 =
+      parseRouteConfigurationFromYaml(yaml("v2"));
+  route_config_v3.add_internal_only_headers("x-internal");
+  ConfigImpl config_v3(route_config_v3, factory_context_,
+                       ProtobufMessage::getNullValidationVisitor(), false, config_v2.get());
+  EXPECT_NE(unchanged, route_entry(config_v3, "unchanged.lyft.com"));
+  EXPECT_EQ(1, route_entry(config_v3, "unchanged.lyft.com")
+                   ->virtualHost()
+                   .routeConfig()
+                   .internalOnlyHeaders()
+                   .size());
+
+  // Virtual hosts are rebuilt when clusters are validated.
+  route_config_v3.mutable_validate_clusters()->set_value(true);
+  ConfigImpl config_v4(route_config_v3, factory_context_,
+                       ProtobufMessage::getNullValidationVisitor(), false, &config_v3);
+  EXPECT_NE(route_entry(config_v3, "unchanged.lyft.com"),
+            route_entry(config_v4, "unchanged.lyft.com"));
+}
+
 // When deprecating regex: this test can be removed.
 TEST_F(RouteMatcherTest, DEPRECATED_FEATURE_TEST(TestRoutesWithInvalidRegexLegacy)) {
   TestDeprecatedV2Api _deprecated_v2_api;
@@ -7580,6 +7813,9 @@ public:
           "route");
     check(vhost.perFilterConfigTyped<DerivedFilterConfig>(factory_.name()), expected_vhost,
           "virtual host");
+    check(dynamic_cast<const DerivedFilterConfig*>(
+              route->mostSpecificPerFilterConfig(factory_.name())),
+          expected_entry, "most specific");
   }
 
   void check(const DerivedFilterConfig* cfg, uint32_t expected_seconds, std::string source) {
@@ -7860,6 +8096,63 @@ virtual_hosts:
   checkEach(yaml, 1213, 1213, 1415);
 }
 
+TEST_F(PerFilterConfigsTest, MostSpecificConfig) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: bar
+    domains: ["*"]
+    routes:
+      - match: { prefix: "/weighted" }
+        route:
+          weighted_clusters:
+            clusters:
+              - name: baz
+                weight: 100
+                typed_per_filter_config:
+                  test.filter:
+                    "@type": type.googleapis.com/google.protobuf.Timestamp
+                    value:
+                      seconds: 1
+        typed_per_filter_config:
+          test.filter:
+            "@type": type.googleapis.com/google.protobuf.Timestamp
+            value:
+              seconds: 2
+      - match: { prefix: "/route" }
+        route: { cluster: baz }
+        typed_per_filter_config:
+          test.filter:
+            "@type": type.googleapis.com/google.protobuf.Timestamp
+            value:
+              seconds: 2
+      - match: { prefix: "/vhost" }
+        route: { cluster: baz }
+      - match: { prefix: "/direct" }
+        direct_response: { status: 200 }
+    typed_per_filter_config:
+      test.filter:
+        "@type": type.googleapis.com/google.protobuf.Timestamp
+        value:
+          seconds: 3
+)EOF";
+
+  factory_context_.cluster_manager_.initializeClusters({"baz"}, {});
+  const TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true);
+  auto most_specific = [&config, this](const std::string& path) {
+    return dynamic_cast<const DerivedFilterConfig*>(
+        config.route(genHeaders("www.foo.com", path, "GET"), 0)
+            ->mostSpecificPerFilterConfig(factory_.name()));
+  };
+
+  check(most_specific("/weighted"), 1, "weighted cluster");
+  check(most_specific("/route"), 2, "route");
+  check(most_specific("/vhost"), 3, "virtual host");
+  // Direct responses have no route entry to resolve the config of the virtual host through.
+  EXPECT_EQ(nullptr, most_specific("/direct"));
+  EXPECT_EQ(nullptr, config.route(genHeaders("www.foo.com", "/route", "GET"), 0)
+                         ->mostSpecificPerFilterConfig(default_factory_.name()));
+}
+
 class RouteMatchOverrideTest : public testing::Test, public ConfigImplTestBase {};
 
 TEST_F(RouteMatchOverrideTest, VerifyAllMatchableRoutes) {
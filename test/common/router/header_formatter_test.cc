@@ -759,6 +759,25 @@ TEST_F(StreamInfoHeaderFormatterTest, WrongFormatOnUpstreamMetadataVariable) {
       "does not match actual type 'Object'.");
 }
 
+TEST(HeaderFormatterTest, ConstantValue) {
+  PlainHeaderFormatter plain("value", false);
+  ASSERT_NE(nullptr, plain.constantValue());
+  EXPECT_EQ("value", *plain.constantValue());
+  EXPECT_EQ(nullptr, StreamInfoHeaderFormatter("PROTOCOL", false).constantValue());
+
+  std::vector<HeaderFormatterPtr> formatters;
+  formatters.emplace_back(std::make_unique<PlainHeaderFormatter>("prefix-", false));
+  formatters.emplace_back(std::make_unique<StreamInfoHeaderFormatter>("PROTOCOL", false));
+  formatters.emplace_back(std::make_unique<PlainHeaderFormatter>("-suffix", false));
+  CompoundHeaderFormatter compound(std::move(formatters), false);
+  EXPECT_EQ(nullptr, compound.constantValue());
+
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+  absl::optional<Envoy::Http::Protocol> protocol = Envoy::Http::Protocol::Http11;
+  ON_CALL(stream_info, protocol()).WillByDefault(ReturnPointee(&protocol));
+  EXPECT_EQ("prefix-HTTP/1.1-suffix", compound.format(stream_info));
+}
+
 TEST(HeaderParserTest, TestParseInternal) {
   struct TestCase {
     std::string input_;
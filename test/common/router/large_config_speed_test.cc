@@ -0,0 +1,277 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/route/v3/route.pb.h"
+#include "envoy/config/route/v3/scoped_route.pb.h"
+#include "envoy/extensions/filters/network/http_connection_manager/v3/http_connection_manager.pb.h"
+
+#include "common/common/assert.h"
+#include "common/memory/stats.h"
+#include "common/router/config_impl.h"
+#include "common/router/scoped_config_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/server/instance.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/test_runtime.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "gmock/gmock.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+using envoy::config::route::v3::Route;
+using envoy::config::route::v3::RouteConfiguration;
+using envoy::config::route::v3::ScopedRouteConfiguration;
+using envoy::config::route::v3::VirtualHost;
+using envoy::extensions::filters::network::http_connection_manager::v3::ScopedRoutes;
+using testing::NiceMock;
+using testing::ReturnRef;
+
+// Benchmarks of route configurations shaped like the large ones of multi-tenant deployments, as
+// opposed to config_impl_speed_test.cc, which varies one kind of route of a single virtual host.
+
+/**
+ * Adds routes of the shapes that services commonly use:
+ * - mostly prefix routes in the form of /shelves/shelf_x/,
+ * - one in four routes a regex in the form of the OpenAPI template /shelves/{shelf}/route_x,
+ * - one in eight routes preceded by a route for the same path that requires a header the requests
+ *   of the benchmarks do not have.
+ * A request for /shelves/shelf_x/route_x is routed by route x.
+ */
+void addRoutes(VirtualHost& virtual_host, uint32_t num_routes) {
+  for (uint32_t i = 0; i < num_routes; ++i) {
+    Route route;
+    route.mutable_direct_response()->set_status(200);
+    if (i % 4 == 3) {
+      auto* regex = route.mutable_match()->mutable_safe_regex();
+      regex->mutable_google_re2();
+      regex->set_regex(absl::StrCat("/shelves/[^/]+/route_", i));
+    } else {
+      route.mutable_match()->set_prefix(absl::StrCat("/shelves/shelf_", i, "/"));
+    }
+
+    if (i % 8 == 0) {
+      Route* header_route = virtual_host.add_routes();
+      *header_route = route;
+      auto* header = header_route->mutable_match()->add_headers();
+      header->set_name("x-canary");
+      header->set_exact_match("true");
+      header_route->mutable_direct_response()->set_status(503);
+    }
+    *virtual_host.add_routes() = route;
+  }
+}
+
+/**
+ * Generates a route configuration with virtual hosts for tenants. One in four virtual hosts
+ * matches the subdomains of its tenant with a suffix wildcard, and one in four matches all the
+ * domains of its tenant with a prefix wildcard. @see tenantHost()
+ */
+RouteConfiguration genRouteConfig(uint32_t num_virtual_hosts, uint32_t routes_per_virtual_host) {
+  RouteConfiguration route_config;
+  route_config.set_name("large");
+  for (uint32_t i = 0; i < num_virtual_hosts; ++i) {
+    VirtualHost* virtual_host = route_config.add_virtual_hosts();
+    virtual_host->set_name(absl::StrCat("tenant_", i));
+    switch (i % 4) {
+    case 1:
+      virtual_host->add_domains(absl::StrCat("*.tenant_", i, ".example.com"));
+      break;
+    case 2:
+      virtual_host->add_domains(absl::StrCat("tenant_", i, ".*"));
+      break;
+    default:
+      virtual_host->add_domains(absl::StrCat("tenant_", i, ".example.com"));
+      break;
+    }
+    addRoutes(*virtual_host, routes_per_virtual_host);
+  }
+  return route_config;
+}
+
+/**
+ * @return a host that the virtual host of a tenant matches.
+ */
+std::string tenantHost(uint32_t tenant) {
+  switch (tenant % 4) {
+  case 1:
+    return absl::StrCat("api.tenant_", tenant, ".example.com");
+  case 2:
+    return absl::StrCat("tenant_", tenant, ".internal");
+  default:
+    return absl::StrCat("tenant_", tenant, ".example.com");
+  }
+}
+
+Http::TestRequestHeaderMapImpl genRequestHeaders(const std::string& host, const std::string& path) {
+  return Http::TestRequestHeaderMapImpl{
+      {":authority", host}, {":method", "GET"}, {":path", path}, {"x-forwarded-proto", "http"}};
+}
+
+std::string routePath(uint32_t route) {
+  return absl::StrCat("/shelves/shelf_", route, "/route_", route);
+}
+
+class LargeConfigBenchmark {
+public:
+  LargeConfigBenchmark() : api_(Api::createApiForTest()) {
+    ON_CALL(factory_context_, api()).WillByDefault(ReturnRef(*api_));
+  }
+
+  std::unique_ptr<ConfigImpl> buildConfig(const RouteConfiguration& route_config) {
+    return std::make_unique<ConfigImpl>(route_config, factory_context_,
+                                        ProtobufMessage::getNullValidationVisitor(), false);
+  }
+
+  // Routes the requests in turn, and checks that all of them are routed.
+  void route(benchmark::State& state, const Config& config,
+             const std::vector<Http::TestRequestHeaderMapImpl>& requests) {
+    for (const auto& headers : requests) {
+      RELEASE_ASSERT(config.route(headers, stream_info_, 0) != nullptr, "request not routed");
+    }
+    size_t request = 0;
+    for (auto _ : state) { // NOLINT
+      benchmark::DoNotOptimize(config.route(requests[request], stream_info_, 0));
+      request = (request + 1) % requests.size();
+    }
+  }
+
+  TestScopedRuntime scoped_runtime_;
+  Api::ApiPtr api_;
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context_;
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info_;
+};
+
+/**
+ * Measures the selection of a virtual host among range(0) exact, suffix wildcard and prefix
+ * wildcard virtual hosts, each with a few routes.
+ */
+void bmVirtualHostSelection(benchmark::State& state) {
+  const uint32_t num_virtual_hosts = state.range(0);
+  if (benchmark::skipExpensiveBenchmarks() && num_virtual_hosts > 1024) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  LargeConfigBenchmark bench;
+  auto config = bench.buildConfig(genRouteConfig(num_virtual_hosts, 4));
+  std::vector<Http::TestRequestHeaderMapImpl> requests;
+  // The last virtual host of each kind.
+  for (uint32_t tenant = num_virtual_hosts - 4; tenant < num_virtual_hosts - 1; ++tenant) {
+    requests.push_back(genRequestHeaders(tenantHost(tenant), routePath(1)));
+  }
+  bench.route(state, *config, requests);
+}
+
+/**
+ * Measures route selection in a single virtual host with range(0) routes of mixed shapes.
+ */
+void bmRouteSelection(benchmark::State& state) {
+  const uint32_t num_routes = state.range(0);
+  LargeConfigBenchmark bench;
+  auto config = bench.buildConfig(genRouteConfig(1, num_routes));
+  std::vector<Http::TestRequestHeaderMapImpl> requests;
+  // A regex route and a prefix route at the end and in the middle of the virtual host.
+  for (uint32_t route : {num_routes - 1, num_routes - 2, num_routes / 2 - 1, num_routes / 2}) {
+    requests.push_back(genRequestHeaders(tenantHost(0), routePath(route)));
+  }
+  bench.route(state, *config, requests);
+}
+
+/**
+ * Measures the time to build a route configuration with range(0) virtual hosts of range(1) routes
+ * each, and the memory it takes if the allocator reports it.
+ */
+void bmConfigBuild(benchmark::State& state) {
+  const uint32_t num_virtual_hosts = state.range(0);
+  const uint32_t routes_per_virtual_host = state.range(1);
+  if (benchmark::skipExpensiveBenchmarks() && num_virtual_hosts * routes_per_virtual_host > 4096) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  LargeConfigBenchmark bench;
+  const RouteConfiguration route_config =
+      genRouteConfig(num_virtual_hosts, routes_per_virtual_host);
+  for (auto _ : state) { // NOLINT
+    state.PauseTiming();
+    const size_t start_memory = Memory::Stats::totalCurrentlyAllocated();
+    state.ResumeTiming();
+    auto config = bench.buildConfig(route_config);
+    state.PauseTiming();
+    const size_t end_memory = Memory::Stats::totalCurrentlyAllocated();
+    state.counters["memory"] = end_memory - start_memory;
+    state.counters["memory_per_route"] =
+        (end_memory - start_memory) / (num_virtual_hosts * routes_per_virtual_host);
+    config.reset();
+    state.ResumeTiming();
+  }
+}
+
+/**
+ * Measures the selection of the scope of a request among range(0) scopes keyed by a tenant header,
+ * and of its route in the route configuration of the scope.
+ */
+void bmScopedRouteSelection(benchmark::State& state) {
+  const uint32_t num_scopes = state.range(0);
+  if (benchmark::skipExpensiveBenchmarks() && num_scopes > 1024) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  LargeConfigBenchmark bench;
+  ScopedRoutes::ScopeKeyBuilder key_builder;
+  key_builder.add_fragments()->mutable_header_value_extractor()->set_name("x-tenant");
+  ScopedConfigImpl scoped_config(std::move(key_builder));
+
+  // The scopes share one route configuration, so that the benchmark measures the lookup of the
+  // scope rather than the build of the route configurations.
+  ConfigConstSharedPtr route_config = bench.buildConfig(genRouteConfig(1, 16));
+  std::vector<ScopedRouteInfoConstSharedPtr> scopes;
+  for (uint32_t i = 0; i < num_scopes; ++i) {
+    ScopedRouteConfiguration scope;
+    scope.set_name(absl::StrCat("scope_", i));
+    scope.set_route_configuration_name("large");
+    scope.mutable_key()->add_fragments()->set_string_key(absl::StrCat("tenant_", i));
+    ConfigConstSharedPtr scope_route_config = route_config;
+    scopes.push_back(
+        std::make_shared<ScopedRouteInfo>(std::move(scope), std::move(scope_route_config)));
+  }
+  scoped_config.addOrUpdateRoutingScopes(scopes);
+
+  std::vector<Http::TestRequestHeaderMapImpl> requests;
+  for (uint32_t tenant : {num_scopes - 1, num_scopes / 2}) {
+    requests.push_back(genRequestHeaders(tenantHost(0), routePath(15)));
+    requests.back().addCopy("x-tenant", absl::StrCat("tenant_", tenant));
+  }
+  for (const auto& headers : requests) {
+    RELEASE_ASSERT(scoped_config.getRouteConfig(headers) != nullptr, "request not scoped");
+  }
+
+  size_t request = 0;
+  for (auto _ : state) { // NOLINT
+    const auto& headers = requests[request];
+    benchmark::DoNotOptimize(
+        scoped_config.getRouteConfig(headers)->route(headers, bench.stream_info_, 0));
+    request = (request + 1) % requests.size();
+  }
+}
+
+BENCHMARK(bmVirtualHostSelection)->RangeMultiplier(4)->Range(16, 16 << 10);
+BENCHMARK(bmRouteSelection)->RangeMultiplier(4)->Range(16, 8 << 10);
+BENCHMARK(bmConfigBuild)
+    ->Args({100, 10})
+    ->Args({1000, 10})
+    ->Args({10000, 4})
+    ->Args({1, 5000})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(bmScopedRouteSelection)->RangeMultiplier(4)->Range(16, 16 << 10);
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,108 @@
+#include "common/router/path_route_index.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+PathRouteIndex::Routes find(const PathRouteIndex& index, absl::string_view path) {
+  PathRouteIndex::Routes routes;
+  index.find(path, routes);
+  return routes;
+}
+
+TEST(PathRouteIndexTest, Prefixes) {
+  PathRouteIndex index;
+  index.addPrefix("/api/v1/", 3);
+  index.addPrefix("/api/", 1);
+  index.addPrefix("/", 5);
+  index.addPrefix("/api/v2/", 0);
+  index.addPrefix("", 4);
+  index.addPrefix("/api/v1/", 2);
+
+  EXPECT_THAT(find(index, "/api/v1/foo"), ElementsAre(1, 2, 3, 4, 5));
+  EXPECT_THAT(find(index, "/api/v2/foo"), ElementsAre(0, 1, 4, 5));
+  EXPECT_THAT(find(index, "/api/v3/foo"), ElementsAre(1, 4, 5));
+  EXPECT_THAT(find(index, "/api"), ElementsAre(4, 5));
+  EXPECT_THAT(find(index, "other"), ElementsAre(4));
+  EXPECT_THAT(find(index, ""), ElementsAre(4));
+}
+
+TEST(PathRouteIndexTest, Paths) {
+  PathRouteIndex index;
+  index.addPath("/foo/bar", 0);
+  index.addPath("/foo", 1);
+  index.addPath("/foo/baz", 2);
+  index.addPrefix("/foo/", 3);
+
+  EXPECT_THAT(find(index, "/foo"), ElementsAre(1));
+  EXPECT_THAT(find(index, "/foo/bar"), ElementsAre(0, 3));
+  EXPECT_THAT(find(index, "/foo/baz"), ElementsAre(2, 3));
+  EXPECT_THAT(find(index, "/foo/ba"), ElementsAre(3));
+  EXPECT_THAT(find(index, "/fo"), IsEmpty());
+  EXPECT_THAT(find(index, "/foo/bar/"), ElementsAre(3));
+}
+
+TEST(PathRouteIndexTest, IgnoresCase) {
+  PathRouteIndex index;
+  index.addPrefix("/API/", 0);
+  index.addPath("/Foo", 1);
+
+  EXPECT_THAT(find(index, "/api/v1"), ElementsAre(0));
+  EXPECT_THAT(find(index, "/Api/v1"), ElementsAre(0));
+  EXPECT_THAT(find(index, "/FOO"), ElementsAre(1));
+  EXPECT_THAT(find(index, "/foo"), ElementsAre(1));
+}
+
+TEST(PathRouteIndexTest, Regexes) {
+  PathRouteIndex index;
+  EXPECT_TRUE(index.addRegex("/foo/[0-9]+", 1));
+  EXPECT_TRUE(index.addRegex("/foo/.*", 3));
+  EXPECT_TRUE(index.addRegex("/Bar", 0));
+  index.addPrefix("/foo/", 2);
+  index.compile();
+
+  EXPECT_THAT(find(index, "/foo/12"), ElementsAre(1, 2, 3));
+  EXPECT_THAT(find(index, "/foo/bar"), ElementsAre(2, 3));
+  // Regular expressions match the whole path, and are case sensitive.
+  EXPECT_THAT(find(index, "/x/foo/12"), IsEmpty());
+  EXPECT_THAT(find(index, "/Bar"), ElementsAre(0));
+  EXPECT_THAT(find(index, "/Bar/"), IsEmpty());
+  EXPECT_THAT(find(index, "/bar"), IsEmpty());
+}
+
+TEST(PathRouteIndexTest, InvalidRegex) {
+  PathRouteIndex index;
+  EXPECT_FALSE(index.addRegex("/foo/(", 0));
+  EXPECT_TRUE(index.addRegex("/foo/.*", 1));
+  index.compile();
+
+  EXPECT_THAT(find(index, "/foo/("), ElementsAre(1));
+}
+
+TEST(PathRouteIndexTest, UncompiledRegexes) {
+  PathRouteIndex index;
+  EXPECT_TRUE(index.addRegex("/foo", 0));
+  EXPECT_TRUE(index.addRegex("/bar", 1));
+
+  EXPECT_THAT(find(index, "/baz"), ElementsAre(0, 1));
+}
+
+TEST(PathRouteIndexTest, AppendsToRoutes) {
+  PathRouteIndex index;
+  index.addPrefix("/", 1);
+  index.addPrefix("/a", 0);
+
+  PathRouteIndex::Routes routes{7};
+  index.find("/a", routes);
+  EXPECT_THAT(routes, ElementsAre(7, 0, 1));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
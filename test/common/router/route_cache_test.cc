@@ -0,0 +1,85 @@
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "common/router/route_cache.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/router/mocks.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+class RouteCacheTest : public testing::Test {
+protected:
+  uint64_t counter(const std::string& name) {
+    return store_.counterFromString("route_cache." + name).value();
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  const RouteConstSharedPtr route_a_{std::make_shared<testing::NiceMock<MockRoute>>()};
+  const RouteConstSharedPtr route_b_{std::make_shared<testing::NiceMock<MockRoute>>()};
+};
+
+TEST_F(RouteCacheTest, Key) {
+  EXPECT_EQ("host\nGET\n/path", RouteCache::key("host", "GET", "/path"));
+  EXPECT_NE(RouteCache::key("host", "GET", "/path"), RouteCache::key("host", "GE", "T/path"));
+}
+
+TEST_F(RouteCacheTest, HitAndMiss) {
+  RouteCache cache(2, store_, "route_cache");
+  RouteConstSharedPtr route;
+  EXPECT_FALSE(cache.lookup("a", route));
+  EXPECT_EQ(nullptr, route);
+
+  cache.insert("a", route_a_);
+  // Decisions that no route matches are cached too.
+  cache.insert("b", nullptr);
+  EXPECT_TRUE(cache.lookup("a", route));
+  EXPECT_EQ(route_a_, route);
+  EXPECT_TRUE(cache.lookup("b", route));
+  EXPECT_EQ(nullptr, route);
+
+  // The first decision for a key is kept.
+  cache.insert("a", route_b_);
+  EXPECT_TRUE(cache.lookup("a", route));
+  EXPECT_EQ(route_a_, route);
+
+  EXPECT_EQ(3, counter("hit"));
+  EXPECT_EQ(1, counter("miss"));
+}
+
+TEST_F(RouteCacheTest, EvictsLeastRecentlyUsed) {
+  RouteCache cache(2, store_, "route_cache");
+  RouteConstSharedPtr route;
+  cache.insert("a", route_a_);
+  cache.insert("b", route_b_);
+  EXPECT_TRUE(cache.lookup("a", route));
+
+  cache.insert("c", route_b_);
+  EXPECT_TRUE(cache.lookup("a", route));
+  EXPECT_FALSE(cache.lookup("b", route));
+  EXPECT_TRUE(cache.lookup("c", route));
+}
+
+// Threads use their own shard, so decisions made on one worker are not seen by another.
+TEST_F(RouteCacheTest, ThreadShards) {
+  RouteCache cache(2, store_, "route_cache");
+  cache.insert("a", route_a_);
+
+  std::thread thread([&cache]() {
+    RouteConstSharedPtr route;
+    EXPECT_FALSE(cache.lookup("a", route));
+  });
+  thread.join();
+
+  RouteConstSharedPtr route;
+  EXPECT_TRUE(cache.lookup("a", route));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
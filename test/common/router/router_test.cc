@@ -2573,6 +2573,49 @@ TEST_F(RouterTest, HedgedPerTryTimeoutFirstRequestSucceeds) {
   // TODO: Verify hedge stats here once they are implemented.
 }
 
+// Adaptive hedging arms a soft per try timeout at the estimated percentile of the route, and does
+// not hedge once the hedge budget is used up.
+TEST_F(RouterTest, AdaptiveHedgeBudgetExhausted) {
+  NiceMock<MockAdaptiveHedge> adaptive_hedge;
+  callbacks_.route_->route_entry_.hedge_policy_.adaptive_hedge_ = &adaptive_hedge;
+  EXPECT_CALL(adaptive_hedge, onRequest())
+      .WillOnce(Return(absl::optional<std::chrono::milliseconds>(10)));
+
+  NiceMock<Http::MockRequestEncoder> encoder1;
+  Http::ResponseDecoder* response_decoder1 = nullptr;
+  EXPECT_CALL(cm_.thread_local_cluster_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke(
+          [&](Http::ResponseDecoder& decoder,
+              Http::ConnectionPool::Callbacks& callbacks) -> Http::ConnectionPool::Cancellable* {
+            response_decoder1 = &decoder;
+            EXPECT_CALL(*router_.retry_state_, onHostAttempted(_));
+            callbacks.onPoolReady(encoder1, cm_.thread_local_cluster_.conn_pool_.host_,
+                                  upstream_stream_info_, Http::Protocol::Http10);
+            return nullptr;
+          }));
+  per_try_timeout_ = new Event::MockTimer(&callbacks_.dispatcher_);
+  EXPECT_CALL(*per_try_timeout_, enableTimer(std::chrono::milliseconds(10), _));
+  EXPECT_CALL(*per_try_timeout_, disableTimer());
+  expectResponseTimerCreate();
+
+  Http::TestRequestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+
+  // The request is neither reset nor hedged.
+  EXPECT_CALL(adaptive_hedge, tryHedge()).WillOnce(Return(false));
+  EXPECT_CALL(*router_.retry_state_, shouldHedgeRetryPerTryTimeout(_)).Times(0);
+  EXPECT_CALL(encoder1.stream_, resetStream(_)).Times(0);
+  per_try_timeout_->invokeCallback();
+
+  Http::ResponseHeaderMapPtr response_headers(
+      new Http::TestResponseHeaderMapImpl{{":status", "200"}});
+  EXPECT_CALL(adaptive_hedge, onResponse(_));
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, true));
+  response_decoder1->decodeHeaders(std::move(response_headers), true);
+  EXPECT_TRUE(verifyHostUpstreamStats(1, 0));
+}
+
 // Tests that an upstream request is reset even if it can't be retried as long as there is
 // another in-flight request we're waiting on.
 // Sequence:
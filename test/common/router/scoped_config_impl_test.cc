@@ -350,6 +350,46 @@ TEST(ScopeKeyBuilderImplTest, Parse) {
   EXPECT_EQ(key, nullptr);
 }
 
+// The hash of the scope key is computed without building the key, and matches the key's hash.
+TEST(ScopeKeyBuilderImplTest, ComputeScopeKeyHash) {
+  std::string yaml_plain = R"EOF(
+  fragments:
+  - header_value_extractor:
+      name: 'foo_header'
+      element_separator: ','
+      element:
+        key: 'bar'
+        separator: '='
+  - header_value_extractor:
+      name: 'bar_header'
+      element_separator: ';'
+      index: 2
+)EOF";
+
+  ScopedRoutes::ScopeKeyBuilder config;
+  TestUtility::loadFromYaml(yaml_plain, config);
+  ScopeKeyBuilderImpl key_builder(std::move(config));
+
+  for (const auto& headers : std::vector<TestRequestHeaderMapImpl>{
+           {{"foo_header", "a=b,bar=bar_value,e=f"}, {"bar_header", "a=b;bar=bar_value;index2"}},
+           {{"foo_header", "a=b,bar,e=f"}, {"bar_header", "a=b;bar=bar_value;"}},
+           {{"foo_header", "a=b,meh,e=f"}, {"bar_header", "a=b;bar=bar_value;"}},
+           {{"foo_header", "a=b,bar=bar_value,e=f"}, {"bar_header", "a=b;bar=bar_value"}},
+           {{"foo_header", ""}, {"bar_header", "a=b;bar=bar_value;index2"}},
+       }) {
+    const ScopeKeyPtr key = key_builder.computeScopeKey(headers);
+    const absl::optional<uint64_t> hash = key_builder.computeScopeKeyHash(headers);
+    ASSERT_EQ(key != nullptr, hash.has_value());
+    if (key != nullptr) {
+      EXPECT_EQ(key->hash(), hash.value());
+    }
+  }
+  EXPECT_EQ(makeKey({"bar_value", "index2"}).hash(),
+            key_builder.computeScopeKeyHash(
+                TestRequestHeaderMapImpl{{"foo_header", "a=b,bar=bar_value,e=f"},
+                                         {"bar_header", "a=b;bar=bar_value;index2"}}));
+}
+
 class ScopedRouteInfoTest : public testing::Test {
 public:
   void SetUp() override {
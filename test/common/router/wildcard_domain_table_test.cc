@@ -0,0 +1,54 @@
+#include <string>
+
+#include "common/router/wildcard_domain_table.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+using Table = WildcardDomainTable<const char*>;
+
+std::string find(const Table& table, absl::string_view host) {
+  const char* const* value = table.find(host);
+  return value == nullptr ? "" : *value;
+}
+
+TEST(WildcardDomainTableTest, Suffixes) {
+  Table table(Table::Type::Suffix);
+  EXPECT_TRUE(table.empty());
+  EXPECT_TRUE(table.add(".baz.com", "*.baz.com"));
+  EXPECT_TRUE(table.add("-bar.baz.com", "*-bar.baz.com"));
+  EXPECT_TRUE(table.add("com", "*com"));
+  EXPECT_FALSE(table.add(".baz.com", "duplicate"));
+  EXPECT_FALSE(table.empty());
+
+  EXPECT_EQ("*-bar.baz.com", find(table, "foo-bar.baz.com"));
+  EXPECT_EQ("*.baz.com", find(table, "foo.baz.com"));
+  EXPECT_EQ("*.baz.com", find(table, "foo.bar.baz.com"));
+  EXPECT_EQ("*com", find(table, "bar.com"));
+  // Wildcards match at least one byte.
+  EXPECT_EQ("*com", find(table, ".baz.com"));
+  EXPECT_EQ("*.baz.com", find(table, "-bar.baz.com"));
+  EXPECT_EQ("", find(table, "com"));
+  EXPECT_EQ("", find(table, "foo.org"));
+  EXPECT_EQ("", find(table, ""));
+}
+
+TEST(WildcardDomainTableTest, Prefixes) {
+  Table table(Table::Type::Prefix);
+  EXPECT_TRUE(table.add("foo.", "foo.*"));
+  EXPECT_TRUE(table.add("foo.bar.", "foo.bar.*"));
+  EXPECT_FALSE(table.add("foo.", "duplicate"));
+
+  EXPECT_EQ("foo.bar.*", find(table, "foo.bar.com"));
+  EXPECT_EQ("foo.*", find(table, "foo.baz.com"));
+  EXPECT_EQ("foo.*", find(table, "foo.bar."));
+  EXPECT_EQ("", find(table, "foo."));
+  EXPECT_EQ("", find(table, "bar.foo.com"));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -293,6 +293,27 @@ TEST_F(DiskLoaderImplTest, GetLayers) {
   EXPECT_EQ(2, store_.counter("runtime.load_success").value());
 }
 
+// Snapshots share the layers that did not change, and a merge into the admin layer does not
+// change the admin layer of the snapshots that are still in use.
+TEST_F(DiskLoaderImplTest, SnapshotsShareUnchangedLayers) {
+  base_ = TestUtility::parseYaml<ProtobufWkt::Struct>(R"EOF(
+    foo: whatevs
+  )EOF");
+  setup();
+  run("test/common/runtime/test_data/current", "envoy_override");
+  const SnapshotConstSharedPtr old_snapshot = loader_->threadsafeSnapshot();
+
+  loader_->mergeValues({{"foo", "bar"}});
+  const auto& old_layers = old_snapshot->getLayers();
+  const auto& new_layers = loader_->snapshot().getLayers();
+  ASSERT_EQ(4, new_layers.size());
+  EXPECT_EQ(old_layers[0], new_layers[0]);
+  EXPECT_NE(old_layers[3], new_layers[3]);
+  EXPECT_TRUE(old_layers[3]->values().empty());
+  EXPECT_EQ("whatevs", old_snapshot->get("foo").value().get());
+  EXPECT_EQ("bar", loader_->snapshot().get("foo").value().get());
+}
+
 TEST_F(DiskLoaderImplTest, BadDirectory) {
   setup();
   run("/baddir", "/baddir");
@@ -1152,7 +1173,14 @@ TEST_F(RtdsLoaderImplTest, MultipleRtdsLayers) {
     layer:
       baz: saz
   )EOF");
+  const auto old_layers = loader_->snapshot().getLayers();
   doOnConfigUpdateVerifyNoThrow(runtime, 1);
+  // Only the layer of another_resource is built again.
+  const auto& new_layers = loader_->snapshot().getLayers();
+  ASSERT_EQ(3, new_layers.size());
+  EXPECT_EQ(old_layers[0], new_layers[0]);
+  EXPECT_EQ(old_layers[1], new_layers[1]);
+  EXPECT_NE(old_layers[2], new_layers[2]);
 
   // Unlike in OnConfigUpdateSuccess, foo latches onto bar as the some_resource
   // layer still applies.
@@ -1,4 +1,5 @@
 #include <string>
+#include <vector>
 
 #include "common/stats/allocator_impl.h"
 
@@ -72,6 +73,71 @@ TEST_F(AllocatorImplTest, GaugesWithSameName) {
   EXPECT_EQ(0, g2->value());
 }
 
+// Gauges and text readouts report whether they changed since the previous latch.
+TEST_F(AllocatorImplTest, LatchChanged) {
+  GaugeSharedPtr gauge =
+      alloc_.makeGauge(makeStat("gauge.name"), StatName(), {}, Gauge::ImportMode::Accumulate);
+  EXPECT_FALSE(gauge->latchChanged());
+  gauge->set(5);
+  EXPECT_TRUE(gauge->latchChanged());
+  EXPECT_FALSE(gauge->latchChanged());
+  gauge->sub(5);
+  EXPECT_TRUE(gauge->latchChanged());
+  gauge->setParentValue(1);
+  EXPECT_TRUE(gauge->latchChanged());
+  EXPECT_FALSE(gauge->latchChanged());
+
+  TextReadoutSharedPtr text_readout =
+      alloc_.makeTextReadout(makeStat("text_readout.name"), StatName(), {});
+  EXPECT_FALSE(text_readout->latchChanged());
+  text_readout->set("value");
+  EXPECT_TRUE(text_readout->latchChanged());
+  EXPECT_FALSE(text_readout->latchChanged());
+}
+
+// Sharded counters sum the increments of all the threads, and latch the increments since the last
+// latch like unsharded counters.
+TEST_F(AllocatorImplTest, ShardedCounter) {
+  alloc_.setCounterSharding(true);
+  CounterSharedPtr counter = alloc_.makeCounter(makeStat("counter.name"), StatName(), {});
+  alloc_.setCounterSharding(false);
+  EXPECT_FALSE(counter->used());
+  EXPECT_EQ(0, counter->latch());
+
+  const uint32_t num_threads = 12;
+  const uint32_t iters = 10000;
+  std::vector<Thread::ThreadPtr> threads;
+  absl::Notification go;
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([&]() {
+      go.WaitForNotification();
+      for (uint32_t i = 0; i < iters; ++i) {
+        counter->inc();
+      }
+    }));
+  }
+  go.Notify();
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads[i]->join();
+  }
+  EXPECT_TRUE(counter->used());
+  EXPECT_EQ(num_threads * iters, counter->value());
+  EXPECT_EQ(num_threads * iters, counter->latch());
+
+  counter->add(5);
+  EXPECT_EQ(num_threads * iters + 5, counter->value());
+  EXPECT_EQ(5, counter->latch());
+  EXPECT_EQ(0, counter->latch());
+
+  counter->reset();
+  EXPECT_EQ(0, counter->value());
+  counter->inc();
+  EXPECT_EQ(1, counter->latch());
+
+  // Counters made after sharding is disabled are not sharded, but share the sharded ones by name.
+  EXPECT_EQ(counter, alloc_.makeCounter(makeStat("counter.name"), StatName(), {}));
+}
+
 // Test for a race-condition where we may decrement the ref-count of a stat to
 // zero at the same time as we are allocating another instance of that
 // stat. This test reproduces that race organically by having a 12 threads each
@@ -1,3 +1,4 @@
+#include "envoy/common/exception.h"
 #include "envoy/config/metrics/v3/stats.pb.h"
 #include "envoy/type/matcher/v3/string.pb.h"
 
@@ -18,6 +19,11 @@ protected:
   envoy::type::matcher::v3::StringMatcher* exclusionList() {
     return stats_config_.mutable_stats_matcher()->mutable_exclusion_list()->add_patterns();
   }
+  static void setSafeRegex(envoy::type::matcher::v3::StringMatcher* matcher,
+                           const std::string& regex) {
+    matcher->mutable_safe_regex()->mutable_google_re2();
+    matcher->mutable_safe_regex()->set_regex(regex);
+  }
   void rejectAll(const bool should_reject) {
     stats_config_.mutable_stats_matcher()->set_reject_all(should_reject);
   }
@@ -256,6 +262,34 @@ TEST_F(StatsMatcherTest, CheckMultipleExcludeRegex) {
   EXPECT_FALSE(stats_matcher_impl_->rejectsAll());
 }
 
+TEST_F(StatsMatcherTest, CheckMultipleIncludeSafeRegex) {
+  setSafeRegex(inclusionList(), ".*envoy.*");
+  setSafeRegex(inclusionList(), ".*absl.*");
+  initMatcher();
+  expectAccepted({"envoy.matchers.requests", "stats.absl.2xx", "absl.envoy.matchers"});
+  expectDenied({"Abseil", "EnvoyProxy"});
+  EXPECT_FALSE(stats_matcher_impl_->acceptsAll());
+  EXPECT_FALSE(stats_matcher_impl_->rejectsAll());
+}
+
+TEST_F(StatsMatcherTest, CheckMultipleExcludeSafeRegex) {
+  setSafeRegex(exclusionList(), ".*envoy.*");
+  setSafeRegex(exclusionList(), ".*absl.*");
+  initMatcher();
+  expectAccepted({"Abseil", "EnvoyProxy"});
+  expectDenied({"envoy.matchers.requests", "stats.absl.2xx", "absl.envoy.matchers"});
+  EXPECT_FALSE(stats_matcher_impl_->acceptsAll());
+  EXPECT_FALSE(stats_matcher_impl_->rejectsAll());
+}
+
+TEST_F(StatsMatcherTest, CheckSafeRegexIgnoreCase) {
+  auto* matcher = inclusionList();
+  setSafeRegex(matcher, ".*envoy.*");
+  matcher->set_ignore_case(true);
+  EXPECT_THROW_WITH_MESSAGE(initMatcher(), EnvoyException,
+                            "ignore_case has no effect for safe_regex.");
+}
+
 // Multiple prefix/suffix/regex matchers.
 //
 // Matchers are "any_of", so strings matching any of the rules are expected to pass or fail,
@@ -272,6 +306,17 @@ TEST_F(StatsMatcherTest, CheckMultipleAssortedInclusionMatchers) {
   EXPECT_FALSE(stats_matcher_impl_->rejectsAll());
 }
 
+TEST_F(StatsMatcherTest, CheckMultipleAssortedSafeRegexInclusionMatchers) {
+  setSafeRegex(inclusionList(), ".*envoy.*");
+  inclusionList()->set_suffix("requests");
+  setSafeRegex(inclusionList(), "regex(_[0-9]+)?");
+  initMatcher();
+  expectAccepted({"envoy.matchers.requests", "requests.for.envoy", "regex", "regex_12"});
+  expectDenied({"requestsEnvoy", "EnvoyProxy", "foo", "regex_etc"});
+  EXPECT_FALSE(stats_matcher_impl_->acceptsAll());
+  EXPECT_FALSE(stats_matcher_impl_->rejectsAll());
+}
+
 TEST_F(StatsMatcherTest, CheckMultipleAssortedExclusionMatchers) {
   exclusionList()->set_hidden_envoy_deprecated_regex(".*envoy.*");
   exclusionList()->set_suffix("requests");
@@ -12,6 +12,7 @@
 #include "test/common/stats/make_elements_helper.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "benchmark/benchmark.h"
 
@@ -61,6 +62,55 @@ static void bmCreateRace(benchmark::State& state) {
 }
 BENCHMARK(bmCreateRace)->Unit(::benchmark::kMillisecond);
 
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmToStringRace(benchmark::State& state) {
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Envoy::Thread::ThreadFactory& thread_factory = Envoy::Thread::threadFactoryForTest();
+
+    // Make 16 threads, each of which will decode and copy an existing stat name, while another
+    // thread encodes new names, so that readers contend with each other and with a writer.
+    constexpr int num_threads = 16;
+    std::vector<Envoy::Thread::ThreadPtr> threads;
+    threads.reserve(num_threads + 1);
+    Envoy::ConditionalInitializer access;
+    absl::BlockingCounter accesses(num_threads + 1);
+    Envoy::Stats::SymbolTableImpl table;
+    Envoy::Stats::StatNameStorage initial("here.is.a.stat.name", table);
+    const Envoy::Stats::StatName stat_name = initial.statName();
+
+    for (int i = 0; i < num_threads; ++i) {
+      threads.push_back(thread_factory.createThread([&access, &accesses, &table, stat_name]() {
+        access.wait();
+        for (int count = 0; count < 1000; ++count) {
+          benchmark::DoNotOptimize(table.toString(stat_name));
+          Envoy::Stats::StatNameStorage copy(stat_name, table);
+          copy.free(table);
+        }
+        accesses.DecrementCount();
+      }));
+    }
+    threads.push_back(thread_factory.createThread([&access, &accesses, &table]() {
+      access.wait();
+      for (int count = 0; count < 1000; ++count) {
+        Envoy::Stats::StatNameStorage name(absl::StrCat("new.stat.name_", count), table);
+        name.free(table);
+      }
+      accesses.DecrementCount();
+    }));
+
+    access.setReady();
+    accesses.Wait();
+
+    for (auto& thread : threads) {
+      thread->join();
+    }
+
+    initial.free(table);
+  }
+}
+BENCHMARK(bmToStringRace)->Unit(::benchmark::kMillisecond);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void bmJoinStatNames(benchmark::State& state) {
   Envoy::Stats::SymbolTableImpl symbol_table;
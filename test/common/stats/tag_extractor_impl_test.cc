@@ -79,6 +79,54 @@ TEST(TagExtractorTest, BadRegex) {
                           EnvoyException, "Invalid regex '\\+invalid':");
 }
 
+TEST(TagExtractorTest, Tokens) {
+  TagExtractorTokensImpl tag_extractor("cluster_name", "cluster.$.**");
+  EXPECT_EQ("cluster_name", tag_extractor.name());
+  EXPECT_EQ("cluster", tag_extractor.prefixToken());
+  std::string name = "cluster.test_cluster.upstream_cx_total";
+  TagVector tags;
+  IntervalSetImpl<size_t> remove_characters;
+  ASSERT_TRUE(tag_extractor.extractTag(name, tags, remove_characters));
+  std::string tag_extracted_name = StringUtil::removeCharacters(name, remove_characters);
+  EXPECT_EQ("cluster.upstream_cx_total", tag_extracted_name);
+  ASSERT_EQ(1, tags.size());
+  EXPECT_EQ("test_cluster", tags.at(0).value_);
+  EXPECT_EQ("cluster_name", tags.at(0).name_);
+
+  // '**' matches at least one token.
+  EXPECT_FALSE(tag_extractor.extractTag("cluster.test_cluster", tags, remove_characters));
+  EXPECT_FALSE(tag_extractor.extractTag("listener.test_cluster.foo", tags, remove_characters));
+  EXPECT_EQ(1, tags.size());
+}
+
+// The dot before the value is removed when the value is the last token.
+TEST(TagExtractorTest, TokensValueLast) {
+  TagExtractorTokensImpl tag_extractor("response_code", "*.upstream_rq.$");
+  EXPECT_EQ("", tag_extractor.prefixToken());
+  std::string name = "foo.upstream_rq.200";
+  TagVector tags;
+  IntervalSetImpl<size_t> remove_characters;
+  ASSERT_TRUE(tag_extractor.extractTag(name, tags, remove_characters));
+  EXPECT_EQ("foo.upstream_rq", StringUtil::removeCharacters(name, remove_characters));
+  ASSERT_EQ(1, tags.size());
+  EXPECT_EQ("200", tags.at(0).value_);
+
+  // Without '**', the number of tokens must match.
+  EXPECT_FALSE(tag_extractor.extractTag("foo.upstream_rq.200.x", tags, remove_characters));
+  EXPECT_FALSE(tag_extractor.extractTag("foo.upstream_cx.200", tags, remove_characters));
+}
+
+TEST(TagExtractorTest, BadTokens) {
+  EXPECT_THROW_WITH_MESSAGE(TagExtractorTokensImpl("name", "a.$.$"), EnvoyException,
+                            "More than one '$' in tag pattern 'a.$.$'");
+  EXPECT_THROW_WITH_MESSAGE(TagExtractorTokensImpl("name", "a.**.$"), EnvoyException,
+                            "'**' is not the last token of tag pattern 'a.**.$'");
+  EXPECT_THROW_WITH_MESSAGE(TagExtractorTokensImpl("name", "a.b"), EnvoyException,
+                            "No '$' in tag pattern 'a.b'");
+  EXPECT_THROW_WITH_MESSAGE(TagExtractorTokensImpl("name", "$"), EnvoyException,
+                            "No token besides '$' in tag pattern '$'");
+}
+
 class DefaultTagRegexTester {
 public:
   DefaultTagRegexTester() : tag_extractors_(envoy::config::metrics::v3::StatsConfig()) {}
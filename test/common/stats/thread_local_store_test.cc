@@ -29,6 +29,7 @@
 #include "gtest/gtest.h"
 
 using testing::_;
+using testing::ElementsAre;
 using testing::HasSubstr;
 using testing::InSequence;
 using testing::NiceMock;
@@ -609,6 +610,64 @@ TEST_F(StatsThreadLocalStoreTest, OverlappingScopes) {
   tls_.shutdownThread();
 }
 
+// Validate that selectStats() finds the stats with a name prefix in the scopes of that prefix, in
+// the scopes of shorter prefixes and in the default scope.
+TEST_F(StatsThreadLocalStoreTest, SelectStats) {
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+
+  ScopePtr foo = store_->createScope("cluster.foo.");
+  ScopePtr foo_overlap = store_->createScope("cluster.foo.");
+  ScopePtr foo_bar = store_->createScope("cluster.foo.bar.");
+  ScopePtr foo2 = store_->createScope("cluster.foo2.");
+  ScopePtr cluster = store_->createScope("cluster.");
+  foo->counterFromString("c1").inc();
+  foo_overlap->counterFromString("c1").inc();
+  foo->counterFromString("unused");
+  foo_bar->gaugeFromString("g1", Gauge::ImportMode::Accumulate).set(1);
+  foo2->counterFromString("c1").inc();
+  cluster->counterFromString("foo.c2").inc();
+  cluster->counterFromString("foo2.c2").inc();
+  store_->counterFromString("cluster.foo.c3").inc();
+  store_->textReadoutFromString("cluster.foo.t1").set("hello");
+  store_->counterFromString("server.c4").inc();
+
+  const auto names = [](const auto& stats) {
+    std::vector<std::string> names;
+    for (const auto& stat : stats) {
+      names.push_back(stat->name());
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+  };
+
+  SelectedStats selected = store_->selectStats("cluster.foo.", false);
+  EXPECT_THAT(names(selected.counters_),
+              ElementsAre("cluster.foo.c1", "cluster.foo.c2", "cluster.foo.c3",
+                          "cluster.foo.unused"));
+  EXPECT_THAT(names(selected.gauges_), ElementsAre("cluster.foo.bar.g1"));
+  EXPECT_THAT(names(selected.text_readouts_), ElementsAre("cluster.foo.t1"));
+
+  selected = store_->selectStats("cluster.foo.", true);
+  EXPECT_THAT(names(selected.counters_),
+              ElementsAre("cluster.foo.c1", "cluster.foo.c2", "cluster.foo.c3"));
+
+  selected = store_->selectStats("cluster.foo", true);
+  EXPECT_THAT(names(selected.counters_),
+              ElementsAre("cluster.foo.c1", "cluster.foo.c2", "cluster.foo.c3", "cluster.foo2.c1",
+                          "cluster.foo2.c2"));
+
+  selected = store_->selectStats("", true);
+  EXPECT_EQ(store_->counters().size() - 1, selected.counters_.size());
+
+  // The stats of a deleted scope are no longer selected through it.
+  foo2.reset();
+  selected = store_->selectStats("cluster.foo2", true);
+  EXPECT_THAT(names(selected.counters_), ElementsAre("cluster.foo2.c2"));
+
+  store_->shutdownThreading();
+  tls_.shutdownThread();
+}
+
 TEST_F(StatsThreadLocalStoreTest, TextReadoutAllLengths) {
   store_->initializeThreading(main_thread_dispatcher_, tls_);
 
@@ -1704,6 +1763,27 @@ TEST_F(HistogramThreadTest, MakeHistogramsAndRecordValues) {
               HasSubstr(absl::StrCat(" B25(0,0) B50(", NumThreads, ",", NumThreads, ") ")));
 }
 
+// The threads merge the histograms in batches, so more histograms than a batch are all merged.
+TEST_F(HistogramThreadTest, MergeHistogramsInParallel) {
+  constexpr uint32_t NumHistograms = 1000;
+  foreachThread([this]() {
+    for (uint32_t i = 0; i < NumHistograms; ++i) {
+      store_->histogramFromString(absl::StrCat("my_hist_", i), Stats::Histogram::Unit::Unspecified)
+          .recordValue(42);
+    }
+  });
+
+  mergeHistograms();
+
+  auto histograms = store_->histograms();
+  ASSERT_EQ(NumHistograms, histograms.size());
+  for (const ParentHistogramSharedPtr& hist : histograms) {
+    EXPECT_TRUE(hist->used());
+    EXPECT_THAT(hist->bucketSummary(),
+                HasSubstr(absl::StrCat(" B25(0,0) B50(", NumThreads, ",", NumThreads, ") ")));
+  }
+}
+
 TEST_F(HistogramThreadTest, ScopeOverlap) {
   // Creating two scopes with the same name gets you two distinct scope objects.
   ScopePtr scope1 = store_->createScope("scope.");
@@ -280,6 +280,38 @@ TEST_F(StreamInfoImplTest, Details) {
   EXPECT_EQ(stream_info.responseCodeDetails().value(), "two_words");
 }
 
+// The filter state is created on first use, and then shares the data of the parent filter state.
+TEST_F(StreamInfoImplTest, FilterStateWithParent) {
+  FilterStateSharedPtr parent =
+      std::make_shared<FilterStateImpl>(FilterState::LifeSpan::Connection);
+  parent->setData("parent", std::make_unique<TestIntAccessor>(1),
+                  FilterState::StateType::ReadOnly, FilterState::LifeSpan::Connection);
+  StreamInfoImpl stream_info(Http::Protocol::Http2, test_time_.timeSystem(), parent,
+                             FilterState::LifeSpan::FilterChain);
+
+  const FilterStateSharedPtr& filter_state = stream_info.filterState();
+  EXPECT_EQ(filter_state, stream_info.filterState());
+  EXPECT_EQ(1, filter_state->getDataReadOnly<TestIntAccessor>("parent").access());
+
+  filter_state->setData("request", std::make_unique<TestIntAccessor>(2),
+                        FilterState::StateType::Mutable, FilterState::LifeSpan::Request);
+  EXPECT_EQ(2, filter_state->getDataReadOnly<TestIntAccessor>("request").access());
+  EXPECT_FALSE(parent->hasDataWithName("request"));
+}
+
+TEST_F(StreamInfoImplTest, RareFieldsDefaults) {
+  StreamInfoImpl stream_info(test_time_.timeSystem());
+  const StreamInfoImpl& const_stream_info = stream_info;
+  EXPECT_FALSE(const_stream_info.connectionTerminationDetails().has_value());
+  EXPECT_EQ("", const_stream_info.upstreamTransportFailureReason());
+  EXPECT_EQ(0, const_stream_info.dynamicMetadata().filter_metadata_size());
+
+  stream_info.setConnectionTerminationDetails("details");
+  stream_info.setUpstreamTransportFailureReason("reason");
+  EXPECT_EQ("details", const_stream_info.connectionTerminationDetails().value());
+  EXPECT_EQ("reason", const_stream_info.upstreamTransportFailureReason());
+}
+
 } // namespace
 } // namespace StreamInfo
 } // namespace Envoy
@@ -49,6 +49,7 @@ using ::testing::DoAll;
 using ::testing::Invoke;
 using ::testing::InvokeWithoutArgs;
 using ::testing::NiceMock;
+using ::testing::Ref;
 using ::testing::Return;
 using ::testing::ReturnPointee;
 using ::testing::ReturnRef;
@@ -1036,6 +1037,34 @@ TEST_F(TcpProxyTest, HalfCloseProxy) {
   upstream_callbacks_->onEvent(Network::ConnectionEvent::RemoteClose);
 }
 
+// Splicing is not attempted unless the runtime feature is enabled.
+TEST_F(TcpProxyTest, SpliceDisabledByDefault) {
+  setup(1);
+
+  EXPECT_CALL(filter_callbacks_.connection_, enableSplicing(_)).Times(0);
+  raiseEventUpstreamConnected(0);
+}
+
+// Once the upstream is connected the connections are asked to splice with each other. Data that
+// still reaches the filter is proxied as usual.
+TEST_F(TcpProxyTest, SpliceWithUpstream) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.tcp_proxy_splice", "true"}});
+  setup(1);
+
+  EXPECT_CALL(filter_callbacks_.connection_, enableSplicing(Ref(*upstream_connections_.at(0))))
+      .WillOnce(Return(true));
+  raiseEventUpstreamConnected(0);
+
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_CALL(*upstream_connections_.at(0), write(BufferEqual(&buffer), false));
+  filter_->onData(buffer, false);
+
+  EXPECT_CALL(filter_callbacks_.connection_, close(_));
+  upstream_callbacks_->onEvent(Network::ConnectionEvent::RemoteClose);
+}
+
 // Test with an explicitly configured upstream.
 TEST_F(TcpProxyTest, ExplicitFactory) {
   // Explicitly configure an HTTP upstream, to test factory creation.
@@ -11,6 +11,7 @@ using testing::_;
 using testing::InSequence;
 using testing::Ref;
 using testing::ReturnPointee;
+using testing::SaveArg;
 
 namespace Envoy {
 namespace ThreadLocal {
@@ -263,6 +264,57 @@ TEST_F(ThreadLocalInstanceImplTest, RunOnAllThreads) {
   tls_.shutdownThread();
 }
 
+// Validate that the updates of a batch are posted to the workers in one callback when the outermost
+// batch ends, and that a set() replaces the queued set() of the slot.
+TEST_F(ThreadLocalInstanceImplTest, Batch) {
+  TypedSlot<StringSlotObject> slot(tls_);
+  std::vector<std::string> created_strs;
+  std::vector<std::string> updated_strs;
+  auto set_str = [&slot, &created_strs](const std::string& str) {
+    slot.set([str, &created_strs](Event::Dispatcher&) -> std::shared_ptr<StringSlotObject> {
+      created_strs.push_back(str);
+      auto s = std::make_shared<StringSlotObject>();
+      s->str_ = str;
+      return s;
+    });
+  };
+  auto record_str = [&updated_strs](OptRef<StringSlotObject> s) {
+    updated_strs.push_back(s->str_);
+  };
+
+  Event::PostCb batch_cb;
+  EXPECT_CALL(thread_dispatcher_, post(_)).WillOnce(SaveArg<0>(&batch_cb));
+  {
+    ScopedBatch batch = tls_.startBatch();
+    {
+      ScopedBatch nested_batch = tls_.startBatch();
+      set_str("a");
+      set_str("b");
+      // The main thread is updated immediately.
+      EXPECT_EQ("b", slot->str_);
+    }
+    slot.runOnAllThreads(record_str);
+    set_str("c");
+    set_str("d");
+    EXPECT_EQ("d", slot->str_);
+  }
+  EXPECT_EQ(std::vector<std::string>({"a", "b", "c", "d"}), created_strs);
+  EXPECT_EQ(std::vector<std::string>({"b"}), updated_strs);
+
+  // The worker skips the set() of "a" and "c", which are replaced before anything else is queued
+  // for the slot. Both threads share the thread local data in this test.
+  ASSERT_NE(nullptr, batch_cb);
+  created_strs.clear();
+  updated_strs.clear();
+  batch_cb();
+  EXPECT_EQ(std::vector<std::string>({"b", "d"}), created_strs);
+  EXPECT_EQ(std::vector<std::string>({"b"}), updated_strs);
+  EXPECT_EQ("d", slot->str_);
+
+  tls_.shutdownGlobalThreading();
+  tls_.shutdownThread();
+}
+
 // Validate ThreadLocal::InstanceImpl's dispatcher() behavior.
 TEST(ThreadLocalInstanceImplDispatcherTest, Dispatcher) {
   InstanceImpl tls;
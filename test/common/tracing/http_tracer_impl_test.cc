@@ -795,6 +795,21 @@ TEST_F(HttpTracerImplTest, BasicFunctionalityNodeSet) {
   tracer_->startSpan(config_, request_headers_, stream_info_, {Reason::Sampling, true});
 }
 
+// The driver still starts a span for a request which is not sampled, to propagate the decision, but
+// the span is not tagged.
+TEST_F(HttpTracerImplTest, NotSampledSpanNotTagged) {
+  EXPECT_CALL(local_info_, nodeName()).Times(0);
+  EXPECT_CALL(local_info_, zoneName()).Times(0);
+
+  NiceMock<MockSpan>* span = new NiceMock<MockSpan>();
+  EXPECT_CALL(*driver_, startSpan_(_, _, _, _, _)).WillOnce(Return(span));
+  EXPECT_CALL(*span, setTag(_, _)).Times(0);
+
+  SpanPtr active_span = tracer_->startSpan(config_, request_headers_, stream_info_,
+                                           {Reason::NotTraceableRequestId, false});
+  EXPECT_EQ(span, active_span.get());
+}
+
 } // namespace
 } // namespace Tracing
 } // namespace Envoy
@@ -13,6 +13,7 @@
 
 #include "test/common/upstream/utility.h"
 #include "test/mocks/protobuf/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/mocks/upstream/cluster_priority_set.h"
 #include "test/test_common/printers.h"
@@ -37,7 +38,7 @@ class CdsApiImplTest : public testing::Test {
 protected:
   void setup() {
     envoy::config::core::v3::ConfigSource cds_config;
-    cds_ = CdsApiImpl::create(cds_config, cm_, store_, validation_visitor_);
+    cds_ = CdsApiImpl::create(cds_config, cm_, tls_, store_, validation_visitor_);
     cds_->setInitializedCb([this]() -> void { initialized_.ready(); });
 
     EXPECT_CALL(*cm_.subscription_factory_.subscription_, start(_, _));
@@ -68,6 +69,7 @@ protected:
   }
 
   NiceMock<MockClusterManager> cm_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
   Upstream::MockClusterMockPrioritySet mock_cluster_;
   Stats::IsolatedStoreImpl store_;
   CdsApiPtr cds_;
@@ -1439,6 +1439,59 @@ TEST_F(ClusterManagerImplTest, ModifyWarmingCluster) {
   EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster2.get()));
 }
 
+// Verify that the clusters added after initialization beyond max_concurrent_warming_clusters wait
+// for the warming clusters to complete, and that a removed waiting cluster is skipped.
+TEST_F(ClusterManagerImplTest, MaxConcurrentWarmingClusters) {
+  const std::string yaml = R"EOF(
+cluster_manager:
+  max_concurrent_warming_clusters: 1
+static_resources:
+  clusters: []
+  )EOF";
+  create(parseBootstrapFromV3Yaml(yaml));
+
+  ReadyWatcher initialized;
+  EXPECT_CALL(initialized, ready());
+  cluster_manager_->setInitializedCb([&]() -> void { initialized.ready(); });
+
+  std::shared_ptr<MockClusterMockPrioritySet> cluster1 =
+      std::make_shared<NiceMock<MockClusterMockPrioritySet>>();
+  cluster1->info_->name_ = "cluster1";
+  std::shared_ptr<MockClusterMockPrioritySet> cluster2 =
+      std::make_shared<NiceMock<MockClusterMockPrioritySet>>();
+  cluster2->info_->name_ = "cluster2";
+  std::shared_ptr<MockClusterMockPrioritySet> cluster3 =
+      std::make_shared<NiceMock<MockClusterMockPrioritySet>>();
+  cluster3->info_->name_ = "cluster3";
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster1, nullptr)))
+      .WillOnce(Return(std::make_pair(cluster2, nullptr)))
+      .WillOnce(Return(std::make_pair(cluster3, nullptr)));
+
+  EXPECT_CALL(*cluster1, initialize(_));
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("cluster1"), ""));
+  EXPECT_CALL(*cluster2, initialize(_)).Times(0);
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("cluster2"), ""));
+  EXPECT_CALL(*cluster3, initialize(_)).Times(0);
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("cluster3"), ""));
+  checkStats(3 /*added*/, 0 /*modified*/, 0 /*removed*/, 0 /*active*/, 3 /*warming*/);
+
+  // cluster2 is removed while it waits, so cluster3 warms once cluster1 is warm.
+  EXPECT_TRUE(cluster_manager_->removeCluster("cluster2"));
+  EXPECT_CALL(*cluster3, initialize(_));
+  cluster1->initialize_callback_();
+  checkStats(3 /*added*/, 0 /*modified*/, 1 /*removed*/, 1 /*active*/, 1 /*warming*/);
+  EXPECT_NE(nullptr, cluster_manager_->getThreadLocalCluster("cluster1"));
+  EXPECT_EQ(nullptr, cluster_manager_->getThreadLocalCluster("cluster3"));
+
+  cluster3->initialize_callback_();
+  checkStats(3 /*added*/, 0 /*modified*/, 1 /*removed*/, 2 /*active*/, 0 /*warming*/);
+  EXPECT_NE(nullptr, cluster_manager_->getThreadLocalCluster("cluster3"));
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster3.get()));
+}
+
 // Verify that shutting down the cluster manager destroys warming clusters.
 TEST_F(ClusterManagerImplTest, ShutdownWithWarming) {
   create(defaultConfig());
@@ -1638,6 +1691,66 @@ TEST_F(ClusterManagerImplTest, HostsPostedToTlsCluster) {
   EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
 }
 
+// Verifies that lazy TLS clusters are instantiated with the current hosts on first use, and
+// released when they are idle.
+TEST_F(ClusterManagerImplTest, LazyThreadLocalClusters) {
+  const std::string json = fmt::sprintf(
+      "{\"cluster_manager\":{\"lazy_thread_local_clusters\":{\"idle_timeout\":\"10s\"}},"
+      "\"static_resources\":{%s}}",
+      clustersJson({defaultStaticClusterJson("fake_cluster")}));
+  std::shared_ptr<MockClusterRealPrioritySet> cluster1(new NiceMock<MockClusterRealPrioritySet>());
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster1, nullptr)));
+  ON_CALL(*cluster1, initializePhase()).WillByDefault(Return(Cluster::InitializePhase::Primary));
+  EXPECT_CALL(*cluster1, initialize(_));
+
+  Event::MockTimer* idle_timer = new NiceMock<Event::MockTimer>(&factory_.tls_.dispatcher_);
+  create(parseBootstrapFromV3Json(json));
+  MockClusterUpdateCallbacks callbacks;
+  ClusterUpdateCallbacksHandlePtr cb =
+      cluster_manager_->addThreadLocalClusterUpdateCallbacks(callbacks);
+
+  // The TLS cluster is not instantiated when the cluster is added.
+  EXPECT_CALL(callbacks, onClusterAddOrUpdate(_)).Times(0);
+  cluster1->initialize_callback_();
+  HostSharedPtr host1 = makeTestHost(cluster1->info_, "tcp://127.0.0.1:80", time_system_);
+  cluster1->priority_set_.updateHosts(
+      0,
+      HostSetImpl::partitionHosts(std::make_shared<HostVector>(HostVector{host1}),
+                                  HostsPerLocalityImpl::empty()),
+      nullptr, {host1}, {}, 100);
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(&callbacks));
+
+  // The first lookup instantiates it with the hosts of the cluster.
+  EXPECT_CALL(callbacks, onClusterAddOrUpdate(_));
+  auto* tls_cluster = cluster_manager_->getThreadLocalCluster("fake_cluster");
+  ASSERT_NE(nullptr, tls_cluster);
+  EXPECT_EQ(1, tls_cluster->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(&callbacks));
+
+  // It is released after an idle check period without lookups.
+  EXPECT_CALL(callbacks, onClusterRemoval(_)).Times(0);
+  idle_timer->invokeCallback();
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(&callbacks));
+  EXPECT_CALL(callbacks, onClusterRemoval("fake_cluster"));
+  idle_timer->invokeCallback();
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(&callbacks));
+
+  // The updates of a released cluster are kept for its next instantiation.
+  HostSharedPtr host2 = makeTestHost(cluster1->info_, "tcp://127.0.0.1:81", time_system_);
+  cluster1->priority_set_.updateHosts(
+      0,
+      HostSetImpl::partitionHosts(std::make_shared<HostVector>(HostVector{host1, host2}),
+                                  HostsPerLocalityImpl::empty()),
+      nullptr, {host2}, {}, 100);
+  EXPECT_CALL(callbacks, onClusterAddOrUpdate(_));
+  tls_cluster = cluster_manager_->getThreadLocalCluster("fake_cluster");
+  ASSERT_NE(nullptr, tls_cluster);
+  EXPECT_EQ(2, tls_cluster->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+
+  factory_.tls_.shutdownThread();
+}
+
 // Test that we close all HTTP connection pool connections when there is a host health failure.
 TEST_F(ClusterManagerImplTest, CloseHttpConnectionsOnHealthFailure) {
   const std::string json = fmt::sprintf("{\"static_resources\":{%s}}",
@@ -3315,6 +3428,43 @@ TEST_F(ClusterManagerInitHelperTest, AddSecondaryAfterSecondaryInit) {
   cluster2.cluster_.initialize_callback_();
 }
 
+// Verify that no more than max_concurrent_secondary_init secondary clusters initialize at the same
+// time, and that the waiting ones initialize as the others complete.
+TEST_F(ClusterManagerInitHelperTest, MaxConcurrentSecondaryInit) {
+  ClusterManagerInitHelper init_helper{
+      cm_, [this](ClusterManagerCluster& cluster) { onClusterInit(cluster); }, 1};
+  InSequence s;
+
+  ReadyWatcher cm_initialized;
+  init_helper.setInitializedCb([&]() -> void { cm_initialized.ready(); });
+
+  NiceMock<MockClusterManagerCluster> cluster1;
+  cluster1.cluster_.info_->name_ = "cluster1";
+  ON_CALL(cluster1.cluster_, initializePhase())
+      .WillByDefault(Return(Cluster::InitializePhase::Secondary));
+  init_helper.addCluster(cluster1);
+
+  NiceMock<MockClusterManagerCluster> cluster2;
+  cluster2.cluster_.info_->name_ = "cluster2";
+  ON_CALL(cluster2.cluster_, initializePhase())
+      .WillByDefault(Return(Cluster::InitializePhase::Secondary));
+  init_helper.addCluster(cluster2);
+
+  init_helper.onStaticLoadComplete();
+
+  EXPECT_CALL(cluster1.cluster_, initialize(_));
+  EXPECT_CALL(cluster2.cluster_, initialize(_)).Times(0);
+  init_helper.startInitializingSecondaryClusters();
+
+  EXPECT_CALL(*this, onClusterInit(Ref(cluster1)));
+  EXPECT_CALL(cluster2.cluster_, initialize(_));
+  cluster1.cluster_.initialize_callback_();
+
+  EXPECT_CALL(*this, onClusterInit(Ref(cluster2)));
+  EXPECT_CALL(cm_initialized, ready());
+  cluster2.cluster_.initialize_callback_();
+}
+
 // Tests the scenario encountered in Issue 903: The cluster was removed from
 // the secondary init list while traversing the list.
 TEST_F(ClusterManagerInitHelperTest, RemoveClusterWithinInitLoop) {
@@ -27,7 +27,7 @@ public:
 };
 
 TEST_F(ClusterUpdateTrackerTest, ClusterDoesNotExistAtConstructionTime) {
-  EXPECT_CALL(cm_, getThreadLocalCluster(cluster_name_)).WillOnce(Return(nullptr));
+  EXPECT_CALL(cm_, getThreadLocalCluster(cluster_name_)).WillRepeatedly(Return(nullptr));
 
   ClusterUpdateTracker cluster_tracker(cm_, cluster_name_);
 
@@ -43,8 +43,21 @@ TEST_F(ClusterUpdateTrackerTest, ClusterDoesExistAtConstructionTime) {
   EXPECT_EQ(cluster_tracker.threadLocalCluster()->get().info(), expected_.cluster_.info_);
 }
 
+// Validate that the cluster is looked up again while it is missing, as a lazy cluster is only
+// instantiated by a lookup.
+TEST_F(ClusterUpdateTrackerTest, ClusterLookedUpWhileMissing) {
+  EXPECT_CALL(cm_, getThreadLocalCluster(cluster_name_))
+      .WillOnce(Return(nullptr))
+      .WillOnce(Return(&expected_));
+
+  ClusterUpdateTracker cluster_tracker(cm_, cluster_name_);
+
+  ASSERT_TRUE(cluster_tracker.threadLocalCluster().has_value());
+  EXPECT_EQ(cluster_tracker.threadLocalCluster()->get().info(), expected_.cluster_.info_);
+}
+
 TEST_F(ClusterUpdateTrackerTest, ShouldProperlyHandleUpdateCallbacks) {
-  EXPECT_CALL(cm_, getThreadLocalCluster(cluster_name_)).WillOnce(Return(nullptr));
+  EXPECT_CALL(cm_, getThreadLocalCluster(cluster_name_)).WillRepeatedly(Return(nullptr));
 
   ClusterUpdateTracker cluster_tracker(cm_, cluster_name_);
 
@@ -29,6 +29,7 @@
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
+#include "absl/types/optional.h"
 #include "benchmark/benchmark.h"
 
 using ::benchmark::State;
@@ -94,7 +95,16 @@ public:
   void priorityAndLocalityWeightedHelper(bool ignore_unknown_dynamic_fields, size_t num_hosts,
                                          bool healthy) {
     state_.PauseTiming();
+    auto response = buildResponse(ignore_unknown_dynamic_fields, num_hosts, healthy);
+    state_.ResumeTiming();
+    update(std::move(response), num_hosts);
+  }
 
+  // Builds a response with num_hosts endpoints in a single locality. If flipped_host is set, that
+  // endpoint alone has the opposite health status.
+  std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>
+  buildResponse(bool ignore_unknown_dynamic_fields, size_t num_hosts, bool healthy,
+                absl::optional<size_t> flipped_host = absl::nullopt) {
     envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
     cluster_load_assignment.set_cluster_name("fare");
 
@@ -110,7 +120,7 @@ public:
     uint32_t port = 1000;
     for (size_t i = 0; i < num_hosts; ++i) {
       auto* lb_endpoint = endpoints->add_lb_endpoints();
-      if (healthy) {
+      if (healthy != (flipped_host == i)) {
         lb_endpoint->set_health_status(envoy::config::core::v3::HEALTHY);
       } else {
         lb_endpoint->set_health_status(envoy::config::core::v3::UNHEALTHY);
@@ -135,7 +145,11 @@ public:
                      "");
       resource->set_type_url("type.googleapis.com/envoy.api.v2.ClusterLoadAssignment");
     }
-    state_.ResumeTiming();
+    return response;
+  }
+
+  void update(std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& response,
+              size_t num_hosts) {
     grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
     ASSERT(cluster_->prioritySet().hostSetsPerPriority()[1]->hostsPerLocality().get()[0].size() ==
            num_hosts);
@@ -221,3 +235,28 @@ static void healthOnlyUpdate(State& state) {
 }
 
 BENCHMARK(healthOnlyUpdate)->Range(1, 100000)->Unit(benchmark::kMillisecond);
+
+// Measures an update that changes the health of a single host of a large cluster.
+static void singleHostUpdate(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  uint32_t endpoints = skipExpensiveBenchmarks() ? 1 : state.range(0);
+  std::unique_ptr<Envoy::Upstream::EdsSpeedTest> speed_test;
+  for (auto _ : state) {
+    // The cluster is set up, and torn down, without timing.
+    state.PauseTiming();
+    speed_test.reset();
+    speed_test = std::make_unique<Envoy::Upstream::EdsSpeedTest>(state, false);
+    speed_test->update(speed_test->buildResponse(true, endpoints, true), endpoints);
+    auto response = speed_test->buildResponse(true, endpoints, true, endpoints / 2);
+    state.ResumeTiming();
+
+    speed_test->update(std::move(response), endpoints);
+  }
+  state.PauseTiming();
+  speed_test.reset();
+  state.ResumeTiming();
+}
+
+BENCHMARK(singleHostUpdate)->Range(1, 100000)->Unit(benchmark::kMillisecond);
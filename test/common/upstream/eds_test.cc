@@ -527,6 +527,74 @@ TEST_F(EdsTest, EndpointHealthStatus) {
   EXPECT_EQ(rebuild_container + 1, stats_.counter("cluster.name.update_no_rebuild").value());
 }
 
+// Validate that an update of one endpoint is applied while the other endpoints keep their hosts.
+TEST_F(EdsTest, EndpointUpdatedAmongUnchangedEndpoints) {
+  envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
+  cluster_load_assignment.set_cluster_name("fare");
+  auto* endpoints = cluster_load_assignment.add_endpoints();
+  for (uint32_t port : {80, 81, 82}) {
+    auto* lb_endpoint = endpoints->add_lb_endpoints();
+    auto* socket_address =
+        lb_endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address();
+    socket_address->set_address("1.2.3.4");
+    socket_address->set_port_value(port);
+    lb_endpoint->mutable_load_balancing_weight()->set_value(1);
+  }
+  initialize();
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  const HostVector hosts = cluster_->prioritySet().hostSetsPerPriority()[0]->hosts();
+  ASSERT_EQ(3, hosts.size());
+
+  endpoints->mutable_lb_endpoints(1)->set_health_status(envoy::config::core::v3::UNHEALTHY);
+  endpoints->mutable_lb_endpoints(2)->mutable_load_balancing_weight()->set_value(5);
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(0UL, stats_.counter("cluster.name.update_no_rebuild").value());
+  EXPECT_EQ(hosts, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts());
+  EXPECT_FALSE(hosts[0]->healthFlagGet(Host::HealthFlag::FAILED_EDS_HEALTH));
+  EXPECT_TRUE(hosts[1]->healthFlagGet(Host::HealthFlag::FAILED_EDS_HEALTH));
+  EXPECT_EQ(1, hosts[0]->weight());
+  EXPECT_EQ(5, hosts[2]->weight());
+  EXPECT_EQ(2, cluster_->prioritySet().hostSetsPerPriority()[0]->healthyHosts().size());
+
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(1UL, stats_.counter("cluster.name.update_no_rebuild").value());
+  EXPECT_EQ(hosts, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts());
+}
+
+// Validate that endpoints listing the same address are not confused with each other across
+// updates.
+TEST_F(EdsTest, DuplicateEndpointAddressAcrossPriorities) {
+  envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
+  cluster_load_assignment.set_cluster_name("fare");
+  auto add_endpoint = [&cluster_load_assignment](int priority, int weight) {
+    auto* endpoints = cluster_load_assignment.add_endpoints();
+    endpoints->set_priority(priority);
+    auto* lb_endpoint = endpoints->add_lb_endpoints();
+    auto* socket_address =
+        lb_endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address();
+    socket_address->set_address("1.2.3.4");
+    socket_address->set_port_value(80);
+    lb_endpoint->mutable_load_balancing_weight()->set_value(weight);
+  };
+  add_endpoint(0, 1);
+  add_endpoint(1, 2);
+  initialize();
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  ASSERT_EQ(1, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_EQ(1, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts()[0]->weight());
+  EXPECT_EQ(0, cluster_->prioritySet().hostSetsPerPriority()[1]->hosts().size());
+
+  // The host of the remaining endpoint reflects its own configuration.
+  cluster_load_assignment.clear_endpoints();
+  add_endpoint(1, 2);
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(0, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  const auto& hosts = cluster_->prioritySet().hostSetsPerPriority()[1]->hosts();
+  ASSERT_EQ(1, hosts.size());
+  EXPECT_EQ(1, hosts[0]->priority());
+  EXPECT_EQ(2, hosts[0]->weight());
+}
+
 // Validate that onConfigUpdate() updates the hostname.
 TEST_F(EdsTest, Hostname) {
   envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
@@ -3296,6 +3296,64 @@ TEST_F(TcpHealthCheckerImplTest, Timeout) {
             cluster_->prioritySet().getMockHostSet(0)->hosts_[0]->health());
 }
 
+// Validate that the health checkers of clusters that share a registry check a shared endpoint once,
+// and that the checks move to another cluster when the host of the checking one is removed.
+TEST_F(TcpHealthCheckerImplTest, SharedSessions) {
+  InSequence s;
+
+  const std::string yaml = R"EOF(
+    timeout: 1s
+    interval: 1s
+    unhealthy_threshold: 1
+    healthy_threshold: 2
+    share_sessions_across_clusters: true
+    tcp_health_check: {}
+    )EOF";
+  auto session_registry = std::make_shared<HealthCheckSessionRegistry>();
+  allocHealthChecker(yaml);
+  health_checker_->setSessionRegistry(session_registry);
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:80", simTime())};
+  expectSessionCreate();
+  expectClientCreate();
+  EXPECT_CALL(*timeout_timer_, enableTimer(_, _));
+  health_checker_->start();
+
+  // The session of the host of the other cluster does not connect to the endpoint.
+  auto other_cluster = std::make_shared<NiceMock<MockClusterMockPrioritySet>>();
+  auto other_health_checker = std::make_shared<TcpHealthCheckerImpl>(
+      *other_cluster, parseHealthCheckFromV3Yaml(yaml), dispatcher_, runtime_, random_, nullptr);
+  other_health_checker->setSessionRegistry(session_registry);
+  other_cluster->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(other_cluster->info_, "tcp://127.0.0.1:80", simTime())};
+  auto* other_interval_timer = new Event::MockTimer(&dispatcher_);
+  auto* other_timeout_timer = new Event::MockTimer(&dispatcher_);
+  EXPECT_CALL(*other_interval_timer, enableTimer(_, _)).Times(0);
+  EXPECT_CALL(*other_timeout_timer, enableTimer(_, _)).Times(0);
+  other_health_checker->start();
+
+  // The result of a check applies to the hosts of both clusters.
+  EXPECT_CALL(*connection_, close(_));
+  EXPECT_CALL(event_logger_, logEjectUnhealthy(_, _, _));
+  EXPECT_CALL(event_logger_, logUnhealthy(_, _, _, true));
+  EXPECT_CALL(*timeout_timer_, disableTimer());
+  EXPECT_CALL(*interval_timer_, enableTimer(_, _));
+  timeout_timer_->invokeCallback();
+  EXPECT_EQ(Host::Health::Unhealthy,
+            cluster_->prioritySet().getMockHostSet(0)->hosts_[0]->health());
+  EXPECT_EQ(Host::Health::Unhealthy,
+            other_cluster->prioritySet().getMockHostSet(0)->hosts_[0]->health());
+  EXPECT_EQ(1UL, cluster_->info_->stats_store_.counter("health_check.attempt").value());
+  EXPECT_EQ(0UL, other_cluster->info_->stats_store_.counter("health_check.attempt").value());
+  EXPECT_EQ(1UL, other_cluster->info_->stats_store_.counter("health_check.failure").value());
+
+  // Once the host of the first cluster is removed, the other cluster checks the endpoint.
+  EXPECT_CALL(*other_interval_timer, enableTimer(_, _));
+  HostVector removed{cluster_->prioritySet().getMockHostSet(0)->hosts_.back()};
+  cluster_->prioritySet().getMockHostSet(0)->hosts_.clear();
+  cluster_->prioritySet().getMockHostSet(0)->runCallbacks({}, removed);
+}
+
 TEST_F(TcpHealthCheckerImplTest, DoubleTimeout) {
   InSequence s;
 
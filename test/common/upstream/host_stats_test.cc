@@ -1,3 +1,5 @@
+#include <thread>
+
 #include "envoy/upstream/host_description.h"
 
 #include "gtest/gtest.h"
@@ -21,8 +23,7 @@ TEST(HostStatsTest, CountersSortedByName) {
 // Verify that gauges are sorted by name.
 TEST(HostStatsTest, GaugesSortedByName) {
   HostStats host_stats;
-  std::vector<std::pair<absl::string_view, Stats::PrimitiveGaugeReference>> gauges =
-      host_stats.gauges();
+  std::vector<std::pair<absl::string_view, uint64_t>> gauges = host_stats.gauges();
   EXPECT_FALSE(gauges.empty());
 
   for (size_t i = 1; i < gauges.size(); ++i) {
@@ -30,6 +31,32 @@ TEST(HostStatsTest, GaugesSortedByName) {
   }
 }
 
+// Verify that the active requests of all the threads are summed, while the local value only
+// counts those of the calling thread.
+TEST(HostStatsTest, ShardedActiveRequests) {
+  HostStats host_stats;
+  host_stats.rq_active_.inc();
+  std::thread worker([&host_stats]() {
+    host_stats.rq_active_.add(3);
+    host_stats.rq_active_.dec();
+    EXPECT_EQ(2, host_stats.rq_active_.localValue());
+  });
+  worker.join();
+  EXPECT_EQ(1, host_stats.rq_active_.localValue());
+  EXPECT_EQ(3, host_stats.rq_active_.value());
+
+  // A request may complete on a different thread than the one it started on.
+  host_stats.rq_active_.sub(2);
+  EXPECT_EQ(0, host_stats.rq_active_.localValue());
+  EXPECT_EQ(1, host_stats.rq_active_.value());
+  EXPECT_EQ(std::make_pair(absl::string_view("rq_active"), uint64_t(1)),
+            host_stats.gauges().back());
+
+  host_stats.rq_active_.set(5);
+  EXPECT_EQ(5, host_stats.rq_active_.localValue());
+  EXPECT_EQ(5, host_stats.rq_active_.value());
+}
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
@@ -15,6 +15,7 @@
 #include "test/common/upstream/utility.h"
 #include "test/mocks/upstream/cluster_info.h"
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/test_runtime.h"
 
 #include "benchmark/benchmark.h"
 
@@ -97,6 +98,17 @@ public:
                                                    runtime_, random_, common_config_, lr_lb_config);
   }
 
+  // Weighted hosts, whose weights are not scaled by their active requests.
+  LeastRequestTester(uint64_t num_hosts, uint32_t weighted_subset_percent, uint32_t weight)
+      : BaseTester(num_hosts, weighted_subset_percent, weight) {
+    envoy::config::cluster::v3::Cluster::LeastRequestLbConfig lr_lb_config;
+    lr_lb_config.mutable_active_request_bias()->set_default_value(0.0);
+    lr_lb_config.mutable_active_request_bias()->set_runtime_key("ar_bias");
+    lb_ =
+        std::make_unique<LeastRequestLoadBalancer>(priority_set_, &local_priority_set_, stats_,
+                                                   runtime_, random_, common_config_, lr_lb_config);
+  }
+
   std::unique_ptr<LeastRequestLoadBalancer> lb_;
 };
 
@@ -147,6 +159,61 @@ BENCHMARK(benchmarkRoundRobinLoadBalancerBuild)
     ->Args({50000, 100, 50})
     ->Unit(::benchmark::kMillisecond);
 
+/**
+ * Measures the picks of weighted round robin from range(0) hosts, range(1) percent of them with
+ * weight range(2), with the EDF scheduler or, if range(3) is set, the stride scheduler.
+ */
+void benchmarkRoundRobinLoadBalancerChooseHost(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t weighted_subset_percent = state.range(1);
+  const uint64_t weight = state.range(2);
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.weighted_lb_stride_scheduler",
+        state.range(3) ? "true" : "false"}});
+
+  RoundRobinTester tester(num_hosts, weighted_subset_percent, weight);
+  tester.initialize();
+  // The first pick builds the schedulers.
+  tester.lb_->chooseHost(nullptr);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    ::benchmark::DoNotOptimize(tester.lb_->chooseHost(nullptr));
+  }
+}
+BENCHMARK(benchmarkRoundRobinLoadBalancerChooseHost)
+    ->Args({100, 50, 4, 0})
+    ->Args({100, 50, 4, 1})
+    ->Args({10000, 50, 4, 0})
+    ->Args({10000, 50, 4, 1})
+    ->Args({10000, 10, 50, 0})
+    ->Args({10000, 10, 50, 1});
+
+/**
+ * Measures the picks of weighted least request from range(0) hosts, range(1) percent of them with
+ * weight range(2), with an active request bias of 0 and the EDF scheduler or, if range(3) is set,
+ * the stride scheduler.
+ */
+void benchmarkLeastRequestLoadBalancerWeightedChooseHost(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t weighted_subset_percent = state.range(1);
+  const uint64_t weight = state.range(2);
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.weighted_lb_stride_scheduler",
+        state.range(3) ? "true" : "false"}});
+
+  LeastRequestTester tester(num_hosts, weighted_subset_percent, weight);
+  tester.lb_->chooseHost(nullptr);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    ::benchmark::DoNotOptimize(tester.lb_->chooseHost(nullptr));
+  }
+}
+BENCHMARK(benchmarkLeastRequestLoadBalancerWeightedChooseHost)
+    ->Args({100, 50, 4, 0})
+    ->Args({100, 50, 4, 1})
+    ->Args({10000, 50, 4, 0})
+    ->Args({10000, 50, 4, 1});
+
 class RingHashTester : public BaseTester {
 public:
   RingHashTester(uint64_t num_hosts, uint64_t min_ring_size) : BaseTester(num_hosts) {
@@ -162,8 +229,11 @@ public:
 
 class MaglevTester : public BaseTester {
 public:
-  MaglevTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0)
+  MaglevTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0,
+               uint64_t table_size = MaglevTable::DefaultTableSize)
       : BaseTester(num_hosts, weighted_subset_percent, weight) {
+    config_ = envoy::config::cluster::v3::Cluster::MaglevLbConfig();
+    config_.value().mutable_table_size()->set_value(table_size);
     maglev_lb_ = std::make_unique<MaglevLoadBalancer>(priority_set_, stats_, stats_store_, runtime_,
                                                       random_, config_, common_config_);
   }
@@ -209,7 +279,7 @@ void benchmarkMaglevLoadBalancerBuildTable(::benchmark::State& state) {
   for (auto _ : state) { // NOLINT: Silences warning about dead store
     state.PauseTiming();
     const uint64_t num_hosts = state.range(0);
-    MaglevTester tester(num_hosts);
+    MaglevTester tester(num_hosts, 0, 0, state.range(1));
 
     const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
 
@@ -224,9 +294,11 @@ void benchmarkMaglevLoadBalancerBuildTable(::benchmark::State& state) {
   }
 }
 BENCHMARK(benchmarkMaglevLoadBalancerBuildTable)
-    ->Arg(100)
-    ->Arg(200)
-    ->Arg(500)
+    ->Args({100, MaglevTable::DefaultTableSize})
+    ->Args({200, MaglevTable::DefaultTableSize})
+    ->Args({500, MaglevTable::DefaultTableSize})
+    ->Args({5000, MaglevTable::DefaultTableSize})
+    ->Args({5000, 655373})
     ->Unit(::benchmark::kMillisecond);
 
 class TestLoadBalancerContext : public LoadBalancerContextBase {
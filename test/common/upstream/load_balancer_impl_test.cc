@@ -1,6 +1,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -967,6 +968,25 @@ TEST_P(RoundRobinLoadBalancerTest, WeightedSeed) {
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
 }
 
+// Validate that the stride scheduler picks weighted hosts in the order of the EDF scheduler.
+TEST_P(RoundRobinLoadBalancerTest, WeightedStrideScheduler) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.weighted_lb_stride_scheduler", "true"}});
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 2)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  init(false);
+  peekThenPick({1, 0, 1});
+  peekThenPick({1, 0, 1});
+  // Add a host, it should participate in next round of scheduling.
+  hostSet().healthy_hosts_.push_back(makeTestHost(info_, "tcp://127.0.0.1:82", simTime(), 3));
+  hostSet().hosts_.push_back(hostSet().healthy_hosts_.back());
+  hostSet().runCallbacks({hostSet().healthy_hosts_.back()}, {});
+  peekThenPick({2, 1, 2, 0, 1, 2});
+  peekThenPick({2, 1, 2, 0, 1, 2});
+}
+
 TEST_P(RoundRobinLoadBalancerTest, MaxUnhealthyPanic) {
   hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
                               makeTestHost(info_, "tcp://127.0.0.1:81", simTime())};
@@ -1250,6 +1270,62 @@ TEST_P(RoundRobinLoadBalancerTest, ZoneAwareRoutingSmallZone) {
   EXPECT_EQ(1U, stats_.lb_zone_routing_cross_zone_.value());
 }
 
+// Validate that cross zone requests go to the localities with residual capacity, which are not
+// necessarily the ones next to the local locality.
+TEST_P(RoundRobinLoadBalancerTest, ZoneAwareRoutingResidualCapacitySearch) {
+  if (&hostSet() == &failover_host_set_) { // P = 1 does not support zone-aware routing.
+    return;
+  }
+  HostVectorSharedPtr upstream_hosts(
+      new HostVector({makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:81", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:82", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:83", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:84", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:85", simTime())}));
+  HostVectorSharedPtr local_hosts(
+      new HostVector({makeTestHost(info_, "tcp://127.0.0.1:0", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:1", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:2", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:3", simTime())}));
+
+  // Only the last locality has more upstream than local hosts.
+  HostsPerLocalitySharedPtr upstream_hosts_per_locality =
+      makeHostsPerLocality({{makeTestHost(info_, "tcp://127.0.0.1:80", simTime())},
+                            {makeTestHost(info_, "tcp://127.0.0.1:81", simTime())},
+                            {makeTestHost(info_, "tcp://127.0.0.1:82", simTime())},
+                            {makeTestHost(info_, "tcp://127.0.0.1:83", simTime()),
+                             makeTestHost(info_, "tcp://127.0.0.1:84", simTime()),
+                             makeTestHost(info_, "tcp://127.0.0.1:85", simTime())}});
+  HostsPerLocalitySharedPtr local_hosts_per_locality =
+      makeHostsPerLocality({{makeTestHost(info_, "tcp://127.0.0.1:0", simTime())},
+                            {makeTestHost(info_, "tcp://127.0.0.1:1", simTime())},
+                            {makeTestHost(info_, "tcp://127.0.0.1:2", simTime())},
+                            {makeTestHost(info_, "tcp://127.0.0.1:3", simTime())}});
+
+  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.healthy_panic_threshold", 50))
+      .WillRepeatedly(Return(50));
+  EXPECT_CALL(runtime_.snapshot_, featureEnabled("upstream.zone_routing.enabled", 100))
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.zone_routing.min_cluster_size", 6))
+      .WillRepeatedly(Return(6));
+
+  hostSet().healthy_hosts_ = *upstream_hosts;
+  hostSet().hosts_ = *upstream_hosts;
+  hostSet().healthy_hosts_per_locality_ = upstream_hosts_per_locality;
+  init(true);
+  updateHosts(local_hosts, local_hosts_per_locality);
+
+  for (uint64_t threshold : {1, 2499}) {
+    EXPECT_CALL(random_, random())
+        .WillOnce(Return(0))
+        .WillOnce(Return(9999))
+        .WillOnce(Return(threshold));
+    EXPECT_EQ(hostSet().healthy_hosts_per_locality_->get()[3][0], lb_->chooseHost(nullptr));
+  }
+  EXPECT_EQ(2U, stats_.lb_zone_routing_cross_zone_.value());
+}
+
 TEST_P(RoundRobinLoadBalancerTest, LowPrecisionForDistribution) {
   if (&hostSet() == &failover_host_set_) { // P = 1 does not support zone-aware routing.
     return;
@@ -1624,15 +1700,15 @@ TEST_P(LeastRequestLoadBalancerTest, WeightImbalanceWithInvalidActiveRequestBias
 
   hostSet().hosts_ = hostSet().healthy_hosts_;
 
-  // Trigger callbacks. The added/removed lists are not relevant.
-  EXPECT_LOG_CONTAINS(
-      "warn", "upstream: invalid active request bias supplied (runtime key ar_bias), using 1.0",
-      hostSet().runCallbacks({}, {}));
+  hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
 
   EXPECT_CALL(random_, random()).WillRepeatedly(Return(0));
 
-  // We should see 2:1 ratio for hosts[1] to hosts[0].
-  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_2.chooseHost(nullptr));
+  // We should see 2:1 ratio for hosts[1] to hosts[0]. The schedulers are refreshed on the first
+  // pick after the update.
+  EXPECT_LOG_CONTAINS(
+      "warn", "upstream: invalid active request bias supplied (runtime key ar_bias), using 1.0",
+      EXPECT_EQ(hostSet().healthy_hosts_[1], lb_2.chooseHost(nullptr)));
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_2.chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_2.chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_2.chooseHost(nullptr));
@@ -1691,6 +1767,102 @@ TEST_P(LeastRequestLoadBalancerTest, WeightImbalanceWithCustomActiveRequestBias)
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_2.chooseHost(nullptr));
 }
 
+// Validate that the stride scheduler is only used when the host weights do not depend on their
+// active requests.
+TEST_P(LeastRequestLoadBalancerTest, WeightImbalanceStrideScheduler) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.weighted_lb_stride_scheduler", "true"}});
+  envoy::config::cluster::v3::Cluster::LeastRequestLbConfig lr_lb_config;
+  lr_lb_config.mutable_active_request_bias()->set_runtime_key("ar_bias");
+  lr_lb_config.mutable_active_request_bias()->set_default_value(1.0);
+  LeastRequestLoadBalancer lb_2{priority_set_, nullptr,        stats_,      runtime_,
+                                random_,       common_config_, lr_lb_config};
+
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 2)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  // With an active request bias of 0, we should see 2:1 ratio for hosts[1] to hosts[0],
+  // regardless of the active request count.
+  EXPECT_CALL(runtime_.snapshot_, getDouble("ar_bias", 1.0)).WillRepeatedly(Return(0.0));
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(1);
+  for (uint32_t i = 0; i < 2; ++i) {
+    EXPECT_EQ(hostSet().healthy_hosts_[1], lb_2.chooseHost(nullptr));
+    EXPECT_EQ(hostSet().healthy_hosts_[0], lb_2.chooseHost(nullptr));
+    EXPECT_EQ(hostSet().healthy_hosts_[1], lb_2.chooseHost(nullptr));
+  }
+
+  // With an active request bias of 1, bringing hosts[1] to an active request should yield a 1:1
+  // ratio.
+  EXPECT_CALL(runtime_.snapshot_, getDouble("ar_bias", 1.0)).WillRepeatedly(Return(1.0));
+  hostSet().runCallbacks({}, {});
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_2.chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_2.chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_2.chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_2.chooseHost(nullptr));
+}
+
+// Validate that with worker local active requests the hosts are compared by the active requests
+// that the worker sent to them.
+TEST_P(LeastRequestLoadBalancerTest, WorkerLocalActiveRequests) {
+  envoy::config::cluster::v3::Cluster::LeastRequestLbConfig lr_lb_config;
+  lr_lb_config.set_worker_local_active_requests(true);
+  LeastRequestLoadBalancer lb_2{priority_set_, nullptr,        stats_,      runtime_,
+                                random_,       common_config_, lr_lb_config};
+
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime())};
+  stats_.max_host_weight_.set(1UL);
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  // Another worker sent 3 requests to hosts[0], and this worker sent 1 request to hosts[1].
+  std::thread worker([this]() { hostSet().healthy_hosts_[0]->stats().rq_active_.add(3); });
+  worker.join();
+  hostSet().healthy_hosts_[1]->stats().rq_active_.inc();
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_2.chooseHost(nullptr));
+}
+
+// Validate that with peak EWMA the hosts are compared by their response times times their active
+// requests.
+TEST_P(LeastRequestLoadBalancerTest, PeakEwma) {
+  envoy::config::cluster::v3::Cluster::LeastRequestLbConfig lr_lb_config;
+  lr_lb_config.mutable_peak_ewma_decay_time()->set_seconds(10);
+  info_->lb_type_ = LoadBalancerType::LeastRequest;
+  info_->lb_least_request_config_ = lr_lb_config;
+  LeastRequestLoadBalancer lb_2{priority_set_, nullptr,        stats_,      runtime_,
+                                random_,       common_config_, lr_lb_config};
+
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime())};
+  stats_.max_host_weight_.set(1UL);
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  hostSet().healthy_hosts_[0]->responseTimeMonitor().putResponseTime(
+      std::chrono::milliseconds(99));
+  hostSet().healthy_hosts_[1]->responseTimeMonitor().putResponseTime(
+      std::chrono::milliseconds(9));
+  hostSet().healthy_hosts_[1]->stats().rq_active_.inc();
+
+  // The costs are 100 * 1 and 10 * 2.
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_2.chooseHost(nullptr));
+
+  // The costs are 100 * 1 and 10 * 11.
+  hostSet().healthy_hosts_[1]->stats().rq_active_.add(9);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_2.chooseHost(nullptr));
+}
+
 TEST_P(LeastRequestLoadBalancerTest, WeightImbalanceCallbacks) {
   hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
                               makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 2)};
@@ -1714,6 +1886,36 @@ TEST_P(LeastRequestLoadBalancerTest, WeightImbalanceCallbacks) {
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
 }
 
+// The schedulers are refreshed once on the first pick after any number of membership updates.
+TEST_P(LeastRequestLoadBalancerTest, RefreshOnPick) {
+  envoy::config::cluster::v3::Cluster::LeastRequestLbConfig lr_lb_config;
+  lr_lb_config.mutable_active_request_bias()->set_runtime_key("ar_bias");
+  lr_lb_config.mutable_active_request_bias()->set_default_value(1.0);
+  LeastRequestLoadBalancer lb_2{priority_set_, nullptr,        stats_,      runtime_,
+                                random_,       common_config_, lr_lb_config};
+
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 2)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+
+  EXPECT_CALL(runtime_.snapshot_, getDouble("ar_bias", 1.0)).Times(0);
+  hostSet().runCallbacks({}, {});
+  hostSet().runCallbacks({}, {});
+  testing::Mock::VerifyAndClearExpectations(&runtime_.snapshot_);
+
+  EXPECT_CALL(random_, random()).WillRepeatedly(Return(0));
+  EXPECT_CALL(runtime_.snapshot_, getDouble("ar_bias", 1.0)).WillOnce(Return(1.0));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_2.chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_2.chooseHost(nullptr));
+
+  // The schedulers of an update do not hold on to the removed hosts until the next pick.
+  HostSharedPtr removed_host = hostSet().hosts_[1];
+  hostSet().hosts_.erase(hostSet().hosts_.begin() + 1);
+  hostSet().healthy_hosts_.erase(hostSet().healthy_hosts_.begin() + 1);
+  hostSet().runCallbacks({}, {removed_host});
+  EXPECT_EQ(1, removed_host.use_count());
+}
+
 INSTANTIATE_TEST_SUITE_P(PrimaryOrFailover, LeastRequestLoadBalancerTest,
                          ::testing::Values(true, false));
 
@@ -1773,6 +1975,8 @@ TEST(LoadBalancerSubsetInfoImplTest, DefaultConfigIsDiabled) {
               envoy::config::cluster::v3::Cluster::LbSubsetConfig::NO_FALLBACK);
   EXPECT_EQ(subset_info.defaultSubset().fields_size(), 0);
   EXPECT_EQ(subset_info.subsetSelectors().size(), 0);
+  EXPECT_FALSE(subset_info.lazySubsets());
+  EXPECT_EQ(0, subset_info.lazySubsetIdleRequests());
 }
 
 TEST(LoadBalancerSubsetInfoImplTest, SubsetConfig) {
@@ -1789,6 +1993,8 @@ TEST(LoadBalancerSubsetInfoImplTest, SubsetConfig) {
   subset_selector2->add_keys("selector_key2");
   subset_selector2->set_fallback_policy(
       envoy::config::cluster::v3::Cluster::LbSubsetConfig::LbSubsetSelector::ANY_ENDPOINT);
+  subset_config.set_lazy_subsets(true);
+  subset_config.set_lazy_subset_idle_requests(100);
 
   auto subset_info = LoadBalancerSubsetInfoImpl(subset_config);
 
@@ -1807,6 +2013,8 @@ TEST(LoadBalancerSubsetInfoImplTest, SubsetConfig) {
             std::set<std::string>({"selector_key2"}));
   EXPECT_EQ(subset_info.subsetSelectors()[1]->fallbackPolicy(),
             envoy::config::cluster::v3::Cluster::LbSubsetConfig::LbSubsetSelector::ANY_ENDPOINT);
+  EXPECT_TRUE(subset_info.lazySubsets());
+  EXPECT_EQ(100, subset_info.lazySubsetIdleRequests());
 }
 
 TEST(LoadBalancerSubsetInfoImplTest, KeysSubsetFallbackValid) {
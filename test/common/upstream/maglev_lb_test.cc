@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 #include "envoy/config/cluster/v3/cluster.pb.h"
 
@@ -436,6 +438,30 @@ TEST_F(MaglevLoadBalancerTest, LocalityWeightedLopsided) {
   EXPECT_EQ(MaglevTable::DefaultTableSize - 1023, counts[0]);
 }
 
+// With 65535 hosts or more the table entries no longer fit in 16 bits. Expect that the hosts are
+// chosen as their table entries.
+TEST_F(MaglevLoadBalancerTest, ManyHosts) {
+  const uint32_t num_hosts = 65535;
+  const uint64_t table_size = 131071;
+  for (uint32_t i = 0; i < num_hosts; ++i) {
+    host_set_.hosts_.push_back(
+        makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", i), simTime()));
+  }
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  init(table_size);
+  EXPECT_EQ(2, lb_->stats().min_entries_per_host_.value());
+  EXPECT_EQ(3, lb_->stats().max_entries_per_host_.value());
+
+  LoadBalancerPtr lb = lb_->factory()->create();
+  std::vector<bool> chosen(num_hosts);
+  for (uint32_t i = 0; i < table_size; ++i) {
+    TestLoadBalancerContext context(i);
+    chosen[lb->chooseHost(&context)->address()->ip()->port()] = true;
+  }
+  EXPECT_EQ(num_hosts, std::count(chosen.begin(), chosen.end(), true));
+}
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
@@ -418,6 +418,94 @@ TEST_F(OriginalDstClusterTest, Membership2) {
   EXPECT_EQ(0UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
 }
 
+// Validate that the hosts created before the main thread adds them are added in one batch, and
+// that a worker reuses the hosts it created until then.
+TEST_F(OriginalDstClusterTest, BatchedHostAdditions) {
+  std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 1.250s
+    type: ORIGINAL_DST
+    lb_policy: CLUSTER_PROVIDED
+  )EOF";
+
+  EXPECT_CALL(initialized_, ready());
+  EXPECT_CALL(*cleanup_timer_, enableTimer(_, _));
+  setupFromYaml(yaml);
+
+  NiceMock<Network::MockConnection> connection1;
+  TestLoadBalancerContext lb_context1(&connection1);
+  connection1.local_address_ = std::make_shared<Network::Address::Ipv4Instance>("10.10.11.11");
+  EXPECT_CALL(connection1, localAddressRestored()).WillRepeatedly(Return(true));
+
+  NiceMock<Network::MockConnection> connection2;
+  TestLoadBalancerContext lb_context2(&connection2);
+  connection2.local_address_ = std::make_shared<Network::Address::Ipv4Instance>("10.10.11.12");
+  EXPECT_CALL(connection2, localAddressRestored()).WillRepeatedly(Return(true));
+
+  // The load balancers of three workers.
+  OriginalDstCluster::LoadBalancer lb1(cluster_);
+  OriginalDstCluster::LoadBalancer lb2(cluster_);
+  OriginalDstCluster::LoadBalancer lb3(cluster_);
+  Event::PostCb post_cb;
+  EXPECT_CALL(dispatcher_, post(_)).WillOnce(SaveArg<0>(&post_cb));
+  HostConstSharedPtr host1 = lb1.chooseHost(&lb_context1);
+  HostConstSharedPtr host2 = lb2.chooseHost(&lb_context2);
+  ASSERT_NE(host1, nullptr);
+  ASSERT_NE(host2, nullptr);
+  EXPECT_EQ(host1, lb1.chooseHost(&lb_context1));
+  // The second worker creates its own host for the first destination, which is not added.
+  HostConstSharedPtr duplicate_host = lb2.chooseHost(&lb_context1);
+  EXPECT_NE(host1, duplicate_host);
+
+  EXPECT_CALL(membership_updated_, ready());
+  post_cb();
+  ASSERT_EQ(2UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_EQ(host1, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts()[0]);
+  EXPECT_EQ(host2, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts()[1]);
+
+  // A load balancer created before the hosts were added finds them.
+  EXPECT_EQ(host1, lb3.chooseHost(&lb_context1));
+  EXPECT_EQ(host2, lb3.chooseHost(&lb_context2));
+}
+
+TEST_F(OriginalDstClusterTest, ShardedHostMap) {
+  std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 1.250s
+    type: ORIGINAL_DST
+    lb_policy: CLUSTER_PROVIDED
+  )EOF";
+
+  EXPECT_CALL(initialized_, ready());
+  EXPECT_CALL(*cleanup_timer_, enableTimer(_, _));
+  setupFromYaml(yaml);
+
+  HostSharedPtr host1 = makeTestHost(cluster_->info(), "tcp://10.0.0.1:80", simTime());
+  HostSharedPtr host2 = makeTestHost(cluster_->info(), "tcp://10.0.0.2:80", simTime());
+  ShardedHostMap host_map;
+  EXPECT_TRUE(host_map.empty());
+  EXPECT_TRUE(host_map.add(host1));
+  EXPECT_FALSE(host_map.add(makeTestHost(cluster_->info(), "tcp://10.0.0.1:80", simTime())));
+  EXPECT_EQ(1UL, host_map.size());
+
+  // Changes to a copy do not change the original.
+  ShardedHostMap copy(host_map);
+  EXPECT_TRUE(copy.add(host2));
+  copy.remove("10.0.0.1:80");
+  EXPECT_EQ(nullptr, copy.find("10.0.0.1:80"));
+  EXPECT_EQ(host2, copy.find("10.0.0.2:80"));
+  EXPECT_EQ(1UL, copy.size());
+  EXPECT_EQ(host1, host_map.find("10.0.0.1:80"));
+  EXPECT_EQ(nullptr, host_map.find("10.0.0.2:80"));
+  EXPECT_EQ(1UL, host_map.size());
+
+  std::vector<std::string> addresses;
+  copy.iterate([&](const std::string& address, const HostSharedPtr&) {
+    addresses.push_back(address);
+  });
+  EXPECT_EQ(std::vector<std::string>({"10.0.0.2:80"}), addresses);
+}
+
 TEST_F(OriginalDstClusterTest, Connection) {
   std::string yaml = R"EOF(
     name: name
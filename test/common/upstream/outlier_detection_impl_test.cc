@@ -2,6 +2,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "envoy/common/time.h"
@@ -1986,6 +1987,38 @@ TEST(OutlierUtility, SRThreshold) {
   EXPECT_EQ(52.0, success_rate_nums.ejection_threshold_);   // ejection threshold
 }
 
+// Validate that the requests counted by different threads are summed when the window is rotated.
+TEST(SuccessRateAccumulatorTest, Threads) {
+  SuccessRateAccumulator accumulator;
+  EXPECT_EQ(absl::nullopt, accumulator.getSuccessRateAndVolume());
+
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < SuccessRateAccumulator::NumShards + 2; ++i) {
+    threads.emplace_back([&accumulator]() {
+      for (uint32_t request = 0; request < 100; ++request) {
+        accumulator.incTotalReqCounter();
+        if (request % 4 != 0) {
+          accumulator.incSuccessReqCounter();
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // The requests are only reported once the window is rotated.
+  EXPECT_EQ(absl::nullopt, accumulator.getSuccessRateAndVolume());
+
+  accumulator.updateCurrentWriter();
+  auto success_rate_and_volume = accumulator.getSuccessRateAndVolume();
+  ASSERT_TRUE(success_rate_and_volume.has_value());
+  EXPECT_EQ(75.0, success_rate_and_volume->first);
+  EXPECT_EQ(100 * (SuccessRateAccumulator::NumShards + 2), success_rate_and_volume->second);
+
+  accumulator.updateCurrentWriter();
+  EXPECT_EQ(absl::nullopt, accumulator.getSuccessRateAndVolume());
+}
+
 } // namespace
 } // namespace Outlier
 } // namespace Upstream
@@ -0,0 +1,57 @@
+#include <chrono>
+#include <cmath>
+
+#include "common/upstream/peak_ewma.h"
+
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class PeakEwmaResponseTimeMonitorTest : public testing::Test {
+public:
+  Event::SimulatedTimeSystem time_system_;
+  PeakEwmaResponseTimeMonitor monitor_{time_system_, std::chrono::seconds(10)};
+};
+
+TEST_F(PeakEwmaResponseTimeMonitorTest, Empty) { EXPECT_EQ(0, monitor_.peakEwma()); }
+
+// Validate that response times above the average replace it, and that the weight of the average
+// decays with the time since its last update.
+TEST_F(PeakEwmaResponseTimeMonitorTest, Decay) {
+  monitor_.putResponseTime(std::chrono::milliseconds(100));
+  EXPECT_DOUBLE_EQ(100, monitor_.peakEwma());
+
+  time_system_.advanceTimeWait(std::chrono::seconds(10));
+  EXPECT_DOUBLE_EQ(100 * std::exp(-1), monitor_.peakEwma());
+  monitor_.putResponseTime(std::chrono::milliseconds(10));
+  EXPECT_DOUBLE_EQ(100 * std::exp(-1) + 10 * (1 - std::exp(-1)), monitor_.peakEwma());
+
+  // Updates without elapsed time keep the average.
+  monitor_.putResponseTime(std::chrono::milliseconds(10));
+  EXPECT_DOUBLE_EQ(100 * std::exp(-1) + 10 * (1 - std::exp(-1)), monitor_.peakEwma());
+
+  monitor_.putResponseTime(std::chrono::milliseconds(200));
+  EXPECT_DOUBLE_EQ(200, monitor_.peakEwma());
+}
+
+// Validate that each thread keeps its own average.
+TEST_F(PeakEwmaResponseTimeMonitorTest, PerThread) {
+  monitor_.putResponseTime(std::chrono::milliseconds(100));
+  double thread_ewma = -1;
+  auto thread = Thread::threadFactoryForTest().createThread([&]() {
+    thread_ewma = monitor_.peakEwma();
+    monitor_.putResponseTime(std::chrono::milliseconds(5));
+  });
+  thread->join();
+  EXPECT_EQ(0, thread_ewma);
+  EXPECT_DOUBLE_EQ(100, monitor_.peakEwma());
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
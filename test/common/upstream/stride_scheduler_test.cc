@@ -0,0 +1,94 @@
+#include <memory>
+#include <vector>
+
+#include "common/upstream/stride_scheduler.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+std::vector<std::shared_ptr<uint32_t>> makeEntries(uint32_t num_entries) {
+  std::vector<std::shared_ptr<uint32_t>> entries;
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    entries.push_back(std::make_shared<uint32_t>(i));
+  }
+  return entries;
+}
+
+TEST(StrideSchedulerTest, Empty) {
+  EXPECT_EQ(nullptr, StrideScheduler<uint32_t>::create({}, {}, 1024));
+}
+
+// Validate that a period is too long for the maximum size.
+TEST(StrideSchedulerTest, MaxSize) {
+  EXPECT_EQ(nullptr, StrideScheduler<uint32_t>::create(makeEntries(2), {3, 5}, 7));
+  EXPECT_NE(nullptr, StrideScheduler<uint32_t>::create(makeEntries(2), {3, 5}, 8));
+}
+
+// Validate that a common divisor of the weights shortens the period.
+TEST(StrideSchedulerTest, CommonDivisor) {
+  auto sched = StrideScheduler<uint32_t>::create(makeEntries(3), {20, 40, 60}, 6);
+  ASSERT_NE(nullptr, sched);
+  EXPECT_EQ(6, sched->size());
+}
+
+// Validate the order of the picks, which interleaves the entries like EdfScheduler.
+TEST(StrideSchedulerTest, Order) {
+  auto sched = StrideScheduler<uint32_t>::create(makeEntries(2), {1, 2}, 1024);
+  ASSERT_NE(nullptr, sched);
+  for (uint32_t rounds = 0; rounds < 2; ++rounds) {
+    for (uint32_t i : {1, 0, 1}) {
+      EXPECT_EQ(i, *sched->pick());
+    }
+  }
+}
+
+// Validate we get weighted RR behavior when weights are distinct.
+TEST(StrideSchedulerTest, Weighted) {
+  constexpr uint32_t num_entries = 128;
+  std::vector<uint32_t> weights;
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    weights.push_back(i + 1);
+  }
+  auto sched = StrideScheduler<uint32_t>::create(makeEntries(num_entries), weights, 1 << 16);
+  ASSERT_NE(nullptr, sched);
+  EXPECT_EQ((num_entries * (1 + num_entries)) / 2, sched->size());
+
+  for (uint32_t rounds = 0; rounds < 2; ++rounds) {
+    uint32_t pick_count[num_entries] = {};
+    for (uint32_t i = 0; i < sched->size(); ++i) {
+      ++pick_count[*sched->pick()];
+    }
+    for (uint32_t i = 0; i < num_entries; ++i) {
+      EXPECT_EQ(i + 1, pick_count[i]);
+    }
+  }
+}
+
+// Validate that peeks return the subsequent picks, and that advance() skips picks.
+TEST(StrideSchedulerTest, PeekAndAdvance) {
+  auto sched = StrideScheduler<uint32_t>::create(makeEntries(3), {1, 2, 3}, 1024);
+  ASSERT_NE(nullptr, sched);
+  std::vector<uint32_t> picks;
+  for (uint32_t i = 0; i < 2 * sched->size(); ++i) {
+    picks.push_back(*sched->pick());
+  }
+
+  for (uint32_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(picks[i], *sched->peekAgain());
+  }
+  EXPECT_EQ(picks[0], *sched->pick());
+  EXPECT_EQ(picks[3], *sched->peekAgain());
+  for (uint32_t i = 1; i < 5; ++i) {
+    EXPECT_EQ(picks[i], *sched->pick());
+  }
+
+  sched->advance(sched->size() + 2);
+  EXPECT_EQ(picks[7], *sched->pick());
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
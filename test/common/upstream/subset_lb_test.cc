@@ -718,6 +718,62 @@ TEST_P(SubsetLoadBalancerTest, BalancesSubsetAfterUpdate) {
   EXPECT_EQ(3U, stats_.lb_subsets_created_.value());
 }
 
+// Validate that lazy subsets are created for the first request routed to them, and destroyed when
+// idle.
+TEST_P(SubsetLoadBalancerTest, LazySubsets) {
+  EXPECT_CALL(subset_info_, fallbackPolicy())
+      .WillRepeatedly(Return(envoy::config::cluster::v3::Cluster::LbSubsetConfig::NO_FALLBACK));
+
+  std::vector<SubsetSelectorPtr> subset_selectors = {makeSelector(
+      {"version"},
+      envoy::config::cluster::v3::Cluster::LbSubsetConfig::LbSubsetSelector::NOT_DEFINED)};
+  EXPECT_CALL(subset_info_, subsetSelectors()).WillRepeatedly(ReturnRef(subset_selectors));
+  EXPECT_CALL(subset_info_, lazySubsets()).WillRepeatedly(Return(true));
+  EXPECT_CALL(subset_info_, lazySubsetIdleRequests()).WillRepeatedly(Return(4));
+
+  init({
+      {"tcp://127.0.0.1:80", {{"version", "1.0"}}},
+      {"tcp://127.0.0.1:81", {{"version", "1.1"}}},
+  });
+  EXPECT_EQ(0U, stats_.lb_subsets_created_.value());
+
+  TestLoadBalancerContext context_10({{"version", "1.0"}});
+  TestLoadBalancerContext context_11({{"version", "1.1"}});
+  TestLoadBalancerContext context_12({{"version", "1.2"}});
+
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10));
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context_12));
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context_11));
+  EXPECT_EQ(2U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(2U, stats_.lb_subsets_created_.value());
+
+  // Both subsets received one of the last 4 requests.
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10));
+  EXPECT_EQ(2U, stats_.lb_subsets_active_.value());
+
+  // The 1.1 subset received none of the last 4 requests.
+  for (uint32_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10));
+  }
+  EXPECT_EQ(1U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(1U, stats_.lb_subsets_removed_.value());
+
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context_11));
+  EXPECT_EQ(2U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(3U, stats_.lb_subsets_created_.value());
+
+  // The hosts of a subset are tracked before it is created, and it is purged when it has no hosts.
+  HostSharedPtr host_12 = makeHost("tcp://127.0.0.1:82", {{"version", "1.2"}});
+  modifyHosts({host_12}, {host_set_.hosts_[1]});
+  EXPECT_EQ(1U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(3U, stats_.lb_subsets_created_.value());
+  EXPECT_EQ(2U, stats_.lb_subsets_removed_.value());
+  EXPECT_EQ(host_12, lb_->chooseHost(&context_12));
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context_11));
+  EXPECT_EQ(2U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(4U, stats_.lb_subsets_created_.value());
+}
+
 TEST_P(SubsetLoadBalancerTest, ListAsAnyEnabled) {
   EXPECT_CALL(subset_info_, fallbackPolicy())
       .WillRepeatedly(Return(envoy::config::cluster::v3::Cluster::LbSubsetConfig::NO_FALLBACK));
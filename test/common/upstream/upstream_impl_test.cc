@@ -2503,6 +2503,12 @@ TEST_F(ClusterInfoImplTest, TestTrackRemainingResourcesGauges) {
 
   auto cluster = makeCluster(yaml);
 
+  // The circuit breaker stats are only instantiated with the resource managers.
+  EXPECT_FALSE(
+      stats_.findGaugeByString("cluster.name.circuit_breakers.high.remaining_retries").has_value());
+  cluster->info()->resourceManager(ResourcePriority::Default);
+  cluster->info()->resourceManager(ResourcePriority::High);
+
   // The value of a remaining resource gauge will always be 0 for the default
   // priority circuit breaker since track_remaining is false
   Stats::Gauge& default_remaining_retries =
@@ -2525,6 +2531,46 @@ TEST_F(ClusterInfoImplTest, TestTrackRemainingResourcesGauges) {
   EXPECT_EQ(4U, high_remaining_retries.value());
 }
 
+// The load report stats are instantiated on first use, and then kept.
+TEST_F(ClusterInfoImplTest, LoadReportStats) {
+  const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: ROUND_ROBIN
+  )EOF";
+
+  auto cluster = makeCluster(yaml);
+  ClusterLoadReportStats& load_report_stats = cluster->info()->loadReportStats();
+  load_report_stats.upstream_rq_dropped_.inc();
+  EXPECT_EQ(&load_report_stats, &cluster->info()->loadReportStats());
+  EXPECT_EQ(1U, cluster->info()->loadReportStats().upstream_rq_dropped_.latch());
+}
+
+// Validate that clusters with identical protocol options config share their protocol options.
+TEST_F(ClusterInfoImplTest, SharedProtocolOptions) {
+  const std::string yaml_template = R"EOF(
+    name: {}
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: ROUND_ROBIN
+    http2_protocol_options:
+      hpack_table_size: {}
+  )EOF";
+
+  auto cluster1 = makeCluster(fmt::format(yaml_template, "name1", 0));
+  auto cluster2 = makeCluster(fmt::format(yaml_template, "name2", 0));
+  auto cluster3 = makeCluster(fmt::format(yaml_template, "name3", 1024));
+  EXPECT_EQ(&cluster1->info()->http2Options(), &cluster2->info()->http2Options());
+  EXPECT_NE(&cluster1->info()->http2Options(), &cluster3->info()->http2Options());
+  EXPECT_EQ(1024U, cluster3->info()->http2Options().hpack_table_size().value());
+
+  // The options of removed clusters are built again.
+  cluster3.reset();
+  auto cluster4 = makeCluster(fmt::format(yaml_template, "name4", 1024));
+  EXPECT_EQ(1024U, cluster4->info()->http2Options().hpack_table_size().value());
+}
+
 TEST_F(ClusterInfoImplTest, Timeouts) {
   const std::string yaml = R"EOF(
     name: name
@@ -2616,6 +2662,25 @@ TEST_F(ClusterInfoImplTest, Timeouts) {
   }
 }
 
+// HTTP/3 is only spoken over the QUIC transport socket.
+TEST_F(ClusterInfoImplTest, Http3RequiresQuicTransportSocket) {
+  const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: ROUND_ROBIN
+    typed_extension_protocol_options:
+      envoy.extensions.upstreams.http.v3.HttpProtocolOptions:
+        "@type": type.googleapis.com/envoy.extensions.upstreams.http.v3.HttpProtocolOptions
+        explicit_http_config:
+          http3_protocol_options: {}
+  )EOF";
+
+  EXPECT_THROW_WITH_REGEX(makeCluster(yaml), EnvoyException,
+                          "HTTP/3 configured for cluster name which has a non-QUIC transport "
+                          "socket.*");
+}
+
 TEST_F(ClusterInfoImplTest, TestTrackTimeoutBudgetsNotSetInConfig) {
   // Check that without the flag specified, the histogram is null.
   const std::string yaml_disabled = R"EOF(
@@ -0,0 +1,204 @@
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/access_loggers/columnar/v3/columnar.pb.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/network/address_impl.h"
+
+#include "extensions/access_loggers/columnar/columnar_access_log_impl.h"
+#include "extensions/access_loggers/columnar/config.h"
+
+#include "test/mocks/access_log/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Columnar {
+namespace {
+
+// A decoded batch: the int64 columns are decoded to strings, and the rows without a value to "-".
+struct DecodedBatch {
+  uint32_t rows_{};
+  std::vector<std::string> names_;
+  std::vector<std::vector<std::string>> columns_;
+};
+
+DecodedBatch decode(Buffer::Instance& data) {
+  DecodedBatch batch;
+  EXPECT_EQ("EALB", data.toString().substr(0, 4));
+  data.drain(4);
+  batch.rows_ = data.drainLEInt<uint32_t>();
+  const uint32_t columns = data.drainLEInt<uint32_t>();
+  for (uint32_t i = 0; i < columns; ++i) {
+    const uint16_t name_length = data.drainLEInt<uint16_t>();
+    batch.names_.push_back(data.toString().substr(0, name_length));
+    data.drain(name_length);
+    std::vector<std::string> values;
+    if (data.drainLEInt<uint8_t>() == 0) {
+      std::vector<uint8_t> validity((batch.rows_ + 7) / 8);
+      data.copyOut(0, validity.size(), validity.data());
+      data.drain(validity.size());
+      for (uint32_t row = 0; row < batch.rows_; ++row) {
+        const int64_t value = data.drainLEInt<int64_t>();
+        values.push_back((validity[row / 8] >> (row % 8)) & 1 ? std::to_string(value) : "-");
+      }
+    } else {
+      std::vector<std::string> entries(data.drainLEInt<uint32_t>());
+      for (std::string& entry : entries) {
+        const uint32_t length = data.drainLEInt<uint32_t>();
+        entry = data.toString().substr(0, length);
+        data.drain(length);
+      }
+      for (uint32_t row = 0; row < batch.rows_; ++row) {
+        const uint32_t index = data.drainLEInt<uint32_t>();
+        values.push_back(index == RecordBatch::NoValue ? "-" : entries.at(index));
+      }
+    }
+    batch.columns_.push_back(values);
+  }
+  EXPECT_EQ(0, data.length());
+  return batch;
+}
+
+ColumnConfigsConstSharedPtr columnConfigs(const std::string& yaml) {
+  ColumnarAccessLogConfig config;
+  TestUtility::loadFromYaml(yaml, config);
+  auto configs = std::make_shared<ColumnConfigs>();
+  for (const auto& column : config.columns()) {
+    configs->emplace_back(column);
+  }
+  return configs;
+}
+
+// The values of the columns of the rows of a batch are encoded column by column, with the strings
+// of each column stored once.
+TEST(RecordBatchTest, Encode) {
+  RecordBatch batch(columnConfigs(R"EOF(
+    path: /dev/null
+    columns:
+    - name: code
+      field: RESPONSE_CODE
+    - name: received
+      field: BYTES_RECEIVED
+    - name: client
+      request_header: x-client
+    - name: protocol
+      field: PROTOCOL
+  )EOF"));
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestResponseHeaderMapImpl response_headers;
+
+  stream_info.response_code_ = 200;
+  stream_info.bytes_received_ = 10;
+  stream_info.protocol_ = Http::Protocol::Http2;
+  batch.addRow(Http::TestRequestHeaderMapImpl{{"x-client", "a"}}, response_headers, stream_info);
+  stream_info.response_code_ = absl::nullopt;
+  stream_info.protocol_ = absl::nullopt;
+  batch.addRow(Http::TestRequestHeaderMapImpl{{"x-client", "b"}}, response_headers, stream_info);
+  stream_info.response_code_ = 503;
+  batch.addRow(Http::TestRequestHeaderMapImpl{{"x-client", "a"}}, response_headers, stream_info);
+  batch.addRow(Http::TestRequestHeaderMapImpl{}, response_headers, stream_info);
+  EXPECT_EQ(4, batch.rows());
+
+  Buffer::OwnedImpl output;
+  batch.encode(output);
+  EXPECT_EQ(0, batch.rows());
+  // The strings "a" and "b" of the client column are stored once each.
+  EXPECT_EQ(4 + 4 + 4 + (2 + 4 + 1 + 1 + 4 * 8) + (2 + 8 + 1 + 1 + 4 * 8) +
+                (2 + 6 + 1 + 4 + 2 * (4 + 1) + 4 * 4) + (2 + 8 + 1 + 4 + 4 + 6 + 4 * 4),
+            output.length());
+  const DecodedBatch decoded = decode(output);
+  EXPECT_EQ(4, decoded.rows_);
+  EXPECT_EQ((std::vector<std::string>{"code", "received", "client", "protocol"}), decoded.names_);
+  EXPECT_EQ((std::vector<std::string>{"200", "-", "503", "503"}), decoded.columns_[0]);
+  EXPECT_EQ((std::vector<std::string>{"10", "10", "10", "10"}), decoded.columns_[1]);
+  EXPECT_EQ((std::vector<std::string>{"a", "b", "a", "-"}), decoded.columns_[2]);
+  EXPECT_EQ((std::vector<std::string>{"HTTP/2", "-", "-", "-"}), decoded.columns_[3]);
+
+  // The next batch starts empty.
+  batch.addRow(Http::TestRequestHeaderMapImpl{{"x-client", "c"}}, response_headers, stream_info);
+  batch.encode(output);
+  EXPECT_EQ((std::vector<std::string>{"c"}), decode(output).columns_[2]);
+}
+
+class ColumnarAccessLogTest : public testing::Test {
+public:
+  ColumnarAccessLogTest() {
+    ColumnarAccessLogConfig config;
+    TestUtility::loadFromYaml(R"EOF(
+      path: /var/log/envoy/access.bin
+      columns:
+      - name: address
+        field: DOWNSTREAM_REMOTE_ADDRESS
+      max_batch_rows: 2
+      batch_flush_interval: 5s
+    )EOF",
+                              config);
+    flush_timer_ = new NiceMock<Event::MockTimer>(&tls_.dispatcher_);
+    EXPECT_CALL(*flush_timer_, enableTimer(std::chrono::milliseconds(5000), _));
+    EXPECT_CALL(log_manager_, createAccessLog("/var/log/envoy/access.bin"))
+        .WillOnce(Return(file_));
+    ON_CALL(*file_, write(_)).WillByDefault(Invoke([this](absl::string_view data) {
+      Buffer::OwnedImpl buffer(data);
+      batches_.push_back(decode(buffer));
+    }));
+    log_ = std::make_unique<ColumnarAccessLog>(config, nullptr, log_manager_, tls_);
+    stream_info_.downstream_remote_address_ =
+        std::make_shared<Network::Address::Ipv4Instance>("10.0.0.1", 443);
+  }
+
+  void log() { log_->log(nullptr, nullptr, nullptr, stream_info_); }
+
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  NiceMock<Event::MockTimer>* flush_timer_;
+  NiceMock<AccessLog::MockAccessLogManager> log_manager_;
+  std::shared_ptr<NiceMock<AccessLog::MockAccessLogFile>> file_{
+      std::make_shared<NiceMock<AccessLog::MockAccessLogFile>>()};
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+  std::unique_ptr<ColumnarAccessLog> log_;
+  std::vector<DecodedBatch> batches_;
+};
+
+// A batch is written once full, or on the flush timer.
+TEST_F(ColumnarAccessLogTest, WritesFullAndTimedBatches) {
+  log();
+  EXPECT_TRUE(batches_.empty());
+  log();
+  ASSERT_EQ(1, batches_.size());
+  EXPECT_EQ((std::vector<std::string>{"10.0.0.1:443", "10.0.0.1:443"}), batches_[0].columns_[0]);
+
+  // The timer writes the batches which are not full, and nothing when they are empty.
+  log();
+  EXPECT_CALL(*flush_timer_, enableTimer(std::chrono::milliseconds(5000), _)).Times(2);
+  flush_timer_->invokeCallback();
+  flush_timer_->invokeCallback();
+  ASSERT_EQ(2, batches_.size());
+  EXPECT_EQ(1, batches_[1].rows_);
+}
+
+TEST(ColumnarAccessLogFactoryTest, ValidateFail) {
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  EXPECT_THROW(ColumnarAccessLogFactory().createAccessLogInstance(ColumnarAccessLogConfig(),
+                                                                  nullptr, context),
+               ProtoValidationException);
+}
+
+} // namespace
+} // namespace Columnar
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -202,6 +202,56 @@ TEST_F(GrpcAccessLoggerImplTest, WatermarksOverrun) {
       TestUtility::findCounter(stats_store_, "access_logs.grpc_access_log.logs_dropped")->value());
 }
 
+// TCP logs are bounded by the buffer size too.
+TEST_F(GrpcAccessLoggerImplTest, TcpWatermarksOverrun) {
+  InSequence s;
+  initLogger(FlushInterval, 1);
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  EXPECT_CALL(local_info_, node());
+  expectStreamStart(stream, &callbacks);
+
+  envoy::data::accesslog::v3::TCPAccessLogEntry entry;
+  entry.mutable_common_properties()->set_upstream_cluster("cluster");
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  logger_->log(envoy::data::accesslog::v3::TCPAccessLogEntry(entry));
+
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  EXPECT_CALL(stream, sendMessageRaw_(_, _)).Times(0);
+  logger_->log(envoy::data::accesslog::v3::TCPAccessLogEntry(entry));
+  EXPECT_EQ(
+      1,
+      TestUtility::findCounter(stats_store_, "access_logs.grpc_access_log.logs_written")->value());
+  EXPECT_EQ(
+      1,
+      TestUtility::findCounter(stats_store_, "access_logs.grpc_access_log.logs_dropped")->value());
+
+  // The buffered log is sent with the next one, and the entries of the next batch are written
+  // over the cleared ones.
+  expectStreamMessage(stream, R"EOF(
+identifier:
+  node:
+    id: node_name
+    cluster: cluster_name
+    locality:
+      zone: zone_name
+  log_name: test_log_name
+tcp_logs:
+  log_entry:
+  - common_properties:
+      upstream_cluster: cluster
+)EOF");
+  expectStreamMessage(stream, R"EOF(
+tcp_logs:
+  log_entry:
+  - common_properties:
+      upstream_cluster: other
+)EOF");
+  entry.mutable_common_properties()->set_upstream_cluster("other");
+  logger_->log(envoy::data::accesslog::v3::TCPAccessLogEntry(entry));
+}
+
 // Test legacy behavior of unbounded access logs.
 TEST_F(GrpcAccessLoggerImplTest, WatermarksLegacy) {
   TestScopedRuntime scoped_runtime;
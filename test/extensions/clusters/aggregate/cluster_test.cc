@@ -323,6 +323,31 @@ TEST_F(AggregateClusterTest, ClusterInPanicTest) {
   }
 }
 
+// The updates of a priority which stays non-empty are applied in place, and the others relinearize
+// the priorities.
+TEST_F(AggregateClusterTest, PriorityUpdates) {
+  initialize(default_yaml_config_);
+  Upstream::HostSharedPtr host =
+      Upstream::makeTestHost(primary_info_, "tcp://127.0.0.1:80", simTime());
+  EXPECT_CALL(random_, random()).WillRepeatedly(Return(0));
+
+  // The linearized priorities are [P1, S0, S1], with all the load on P1.
+  setupPrimary(0, 0, 0, 0);
+  setupPrimary(1, 3, 0, 0);
+  EXPECT_CALL(primary_load_balancer_, chooseHost(_)).WillOnce(Return(host));
+  EXPECT_EQ(host, lb_->chooseHost(nullptr));
+
+  // P1 is unhealthy, so that the load spills over to S0.
+  setupPrimary(1, 0, 0, 3);
+  EXPECT_CALL(secondary_load_balancer_, chooseHost(_)).WillOnce(Return(host));
+  EXPECT_EQ(host, lb_->chooseHost(nullptr));
+
+  // The linearized priorities are [P0, P1, S0, S1] again.
+  setupPrimary(0, 1, 0, 0);
+  EXPECT_CALL(primary_load_balancer_, chooseHost(_)).WillOnce(Return(host));
+  EXPECT_EQ(host, lb_->chooseHost(nullptr));
+}
+
 TEST_F(AggregateClusterTest, LBContextTest) {
   AggregateLoadBalancerContext context(nullptr,
                                        Upstream::LoadBalancerBase::HostAvailability::Healthy, 0);
@@ -347,6 +347,56 @@ TEST_F(RedisClusterLoadBalancerTest, ClusterSlotUpdate) {
   validateAssignment(hosts, updated_assignments);
 }
 
+// Slot ranges moving between primaries, and primaries leaving and joining, are applied over the
+// slot array of the previous update.
+TEST_F(RedisClusterLoadBalancerTest, ClusterSlotDeltaUpdate) {
+  Upstream::HostVector hosts{Upstream::makeTestHost(info_, "tcp://127.0.0.1:90", simTime()),
+                             Upstream::makeTestHost(info_, "tcp://127.0.0.1:91", simTime()),
+                             Upstream::makeTestHost(info_, "tcp://127.0.0.1:92", simTime()),
+                             Upstream::makeTestHost(info_, "tcp://127.0.0.1:93", simTime())};
+  Upstream::HostMap all_hosts = generateHostMap(hosts);
+  init();
+  EXPECT_EQ(true, factory_->onClusterSlotUpdate(
+                      std::make_unique<std::vector<ClusterSlot>>(std::vector<ClusterSlot>{
+                          ClusterSlot(0, 1000, hosts[0]->address()),
+                          ClusterSlot(1001, 2000, hosts[1]->address()),
+                          ClusterSlot(2001, 16383, hosts[2]->address()),
+                      }),
+                      all_hosts));
+  validateAssignment(hosts, {{100, 0}, {1100, 1}, {1600, 1}, {2100, 2}});
+
+  // Part of the range of the second primary moves to the third.
+  EXPECT_EQ(true, factory_->onClusterSlotUpdate(
+                      std::make_unique<std::vector<ClusterSlot>>(std::vector<ClusterSlot>{
+                          ClusterSlot(0, 1000, hosts[0]->address()),
+                          ClusterSlot(1001, 1500, hosts[1]->address()),
+                          ClusterSlot(1501, 2000, hosts[2]->address()),
+                          ClusterSlot(2001, 16383, hosts[2]->address()),
+                      }),
+                      all_hosts));
+  validateAssignment(hosts, {{100, 0}, {1100, 1}, {1600, 2}, {2100, 2}});
+
+  // The first primary leaves, and a new one takes its range.
+  EXPECT_EQ(true, factory_->onClusterSlotUpdate(
+                      std::make_unique<std::vector<ClusterSlot>>(std::vector<ClusterSlot>{
+                          ClusterSlot(0, 1000, hosts[3]->address()),
+                          ClusterSlot(1001, 1500, hosts[1]->address()),
+                          ClusterSlot(1501, 2000, hosts[2]->address()),
+                          ClusterSlot(2001, 16383, hosts[2]->address()),
+                      }),
+                      all_hosts));
+  validateAssignment(hosts, {{100, 3}, {1100, 1}, {1600, 2}, {2100, 2}});
+
+  // Fewer primaries than before: the shards are renumbered.
+  EXPECT_EQ(true, factory_->onClusterSlotUpdate(
+                      std::make_unique<std::vector<ClusterSlot>>(std::vector<ClusterSlot>{
+                          ClusterSlot(0, 2000, hosts[2]->address()),
+                          ClusterSlot(2001, 16383, hosts[3]->address()),
+                      }),
+                      all_hosts));
+  validateAssignment(hosts, {{100, 2}, {1100, 2}, {1600, 2}, {2100, 3}, {16383, 3}});
+}
+
 TEST_F(RedisClusterLoadBalancerTest, ClusterSlotNoUpdate) {
   Upstream::HostVector hosts{Upstream::makeTestHost(info_, "tcp://127.0.0.1:90", simTime()),
                              Upstream::makeTestHost(info_, "tcp://127.0.0.1:91", simTime()),
@@ -777,6 +777,41 @@ TEST_F(RedisClusterTest, RedisResolveFailure) {
   EXPECT_EQ(2U, cluster_->info()->stats().update_failure_.value());
 }
 
+// The refreshes triggered while a discovery is in flight are coalesced into a single discovery
+// right after it.
+TEST_F(RedisClusterTest, RefreshCoalescedWhileInFlight) {
+  setupFromV3Yaml(BasicConfig);
+  const std::list<std::string> resolved_addresses{"127.0.0.1", "127.0.0.2"};
+  expectResolveDiscovery(Network::DnsLookupFamily::V4Only, "foo.bar.com", resolved_addresses);
+  expectRedisResolve(true);
+
+  EXPECT_CALL(membership_updated_, ready());
+  EXPECT_CALL(initialized_, ready());
+  cluster_->initialize([&]() -> void { initialized_.ready(); });
+  EXPECT_CALL(*cluster_callback_, onClusterSlotUpdate(_, _));
+  expectClusterSlotResponse(singleSlotPrimaryReplica("127.0.0.1", "127.0.0.2", 22120));
+
+  expectRedisResolve();
+  resolve_timer_->invokeCallback();
+  EXPECT_CALL(*resolve_timer_, enableTimer(_, _)).Times(0);
+  cluster_->redis_discovery_session_.triggerRefresh();
+  cluster_->redis_discovery_session_.triggerRefresh();
+
+  EXPECT_CALL(*cluster_callback_, onClusterSlotUpdate(_, _)).WillOnce(Return(false));
+  EXPECT_CALL(*resolve_timer_, enableTimer(std::chrono::milliseconds(0), _));
+  pool_callbacks_->onResponse(singleSlotPrimaryReplica("127.0.0.1", "127.0.0.2", 22120));
+
+  // Once the follow-up discovery is done, discoveries are back to the refresh rate.
+  expectRedisResolve();
+  resolve_timer_->invokeCallback();
+  EXPECT_CALL(*cluster_callback_, onClusterSlotUpdate(_, _)).WillOnce(Return(false));
+  EXPECT_CALL(*resolve_timer_, enableTimer(std::chrono::milliseconds(4000), _));
+  pool_callbacks_->onResponse(singleSlotPrimaryReplica("127.0.0.1", "127.0.0.2", 22120));
+
+  EXPECT_CALL(*resolve_timer_, enableTimer(std::chrono::milliseconds(0), _));
+  cluster_->redis_discovery_session_.triggerRefresh();
+}
+
 TEST_F(RedisClusterTest, FactoryInitNotRedisClusterTypeFailure) {
   const std::string basic_yaml_hosts = R"EOF(
   name: name
@@ -659,6 +659,49 @@ TEST_F(DnsCacheImplTest, MaxHostOverflow) {
   EXPECT_EQ(1, TestUtility::findCounter(store_, "dns_cache.foo.host_overflow")->value());
 }
 
+// A full cache that evicts hosts makes room for a new host by evicting the host that was least
+// recently used.
+TEST_F(DnsCacheImplTest, EvictLeastRecentlyUsedHosts) {
+  config_.mutable_max_hosts()->set_value(2);
+  config_.set_evict_least_recently_used_hosts(true);
+  initialize();
+
+  MockLoadDnsCacheEntryCallbacks callbacks;
+  Network::DnsResolver::ResolveCb resolve_cb;
+  std::vector<DnsCache::LoadDnsCacheEntryHandlePtr> handles;
+  for (const std::string host : {"foo.com", "bar.com"}) {
+    Event::MockTimer* resolve_timer = new Event::MockTimer(&dispatcher_);
+    EXPECT_CALL(*resolver_, resolve(host, _, _))
+        .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+    auto result = dns_cache_->loadDnsCacheEntry(host, 80, callbacks);
+    EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading, result.status_);
+    handles.push_back(std::move(result.handle_));
+
+    EXPECT_CALL(update_callbacks_, onDnsHostAddOrUpdate(host, _));
+    EXPECT_CALL(callbacks, onLoadDnsCacheComplete());
+    EXPECT_CALL(*resolve_timer, enableTimer(std::chrono::milliseconds(60000), _));
+    resolve_cb(Network::DnsResolver::ResolutionStatus::Success,
+               TestUtility::makeDnsResponse({"10.0.0.1"}));
+  }
+
+  // foo.com was added first, but bar.com was used least recently.
+  simTime().advanceTimeWait(std::chrono::seconds(1));
+  dns_cache_->getHost("foo.com").value()->touch();
+
+  new Event::MockTimer(&dispatcher_);
+  EXPECT_CALL(update_callbacks_, onDnsHostRemove("bar.com"));
+  EXPECT_CALL(*resolver_, resolve("baz.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  auto result = dns_cache_->loadDnsCacheEntry("baz.com", 80, callbacks);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading, result.status_);
+  EXPECT_EQ(1, TestUtility::findCounter(store_, "dns_cache.foo.host_evicted")->value());
+  EXPECT_EQ(0, TestUtility::findCounter(store_, "dns_cache.foo.host_overflow")->value());
+  EXPECT_TRUE(dns_cache_->getHost("foo.com").has_value());
+  EXPECT_FALSE(dns_cache_->getHost("bar.com").has_value());
+  checkStats(3 /* attempt */, 2 /* success */, 0 /* failure */, 2 /* address changed */,
+             3 /* added */, 1 /* removed */, 2 /* num hosts */);
+}
+
 TEST_F(DnsCacheImplTest, CircuitBreakersNotInvoked) {
   initialize();
 
@@ -720,7 +763,7 @@ TEST(DnsCacheManagerImplTest, LoadViaConfig) {
   NiceMock<Random::MockRandomGenerator> random;
   NiceMock<Runtime::MockLoader> loader;
   Stats::IsolatedStoreImpl store;
-  DnsCacheManagerImpl cache_manager(dispatcher, tls, random, loader, store);
+  DnsCacheManagerImpl cache_manager(dispatcher, tls, random, loader, store, nullptr);
 
   envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig config1;
   config1.set_name("foo");
@@ -0,0 +1,125 @@
+#include <string>
+#include <vector>
+
+#include "envoy/config/tap/v3/common.pb.h"
+#include "envoy/data/tap/v3/wrapper.pb.h"
+
+#include "common/protobuf/protobuf.h"
+
+#include "extensions/common/tap/buffered_file_sink.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Tap {
+namespace {
+
+TraceWrapperPtr makeTrace(const std::string& body) {
+  TraceWrapperPtr trace = makeTraceWrapper();
+  trace->mutable_http_streamed_trace_segment()->mutable_request_body_chunk()->set_as_bytes(body);
+  return trace;
+}
+
+TEST(TraceRingTest, PushPop) {
+  TraceRing ring(3);
+  EXPECT_EQ(4U, ring.size());
+  EXPECT_EQ(nullptr, ring.pop());
+
+  // The ring wraps around.
+  for (int lap = 0; lap < 2; ++lap) {
+    for (int i = 0; i < 4; ++i) {
+      TraceWrapperPtr trace = makeTrace(std::to_string(i));
+      EXPECT_TRUE(ring.push(trace));
+      EXPECT_EQ(nullptr, trace);
+    }
+    TraceWrapperPtr trace = makeTrace("full");
+    EXPECT_FALSE(ring.push(trace));
+    EXPECT_NE(nullptr, trace);
+
+    for (int i = 0; i < 4; ++i) {
+      TraceWrapperPtr popped = ring.pop();
+      ASSERT_NE(nullptr, popped);
+      EXPECT_EQ(std::to_string(i),
+                popped->http_streamed_trace_segment().request_body_chunk().as_bytes());
+    }
+    EXPECT_EQ(nullptr, ring.pop());
+  }
+
+  // The traces left in the ring are freed with it.
+  TraceWrapperPtr trace = makeTrace("left");
+  EXPECT_TRUE(ring.push(trace));
+}
+
+TEST(TraceRingTest, ConcurrentProducers) {
+  constexpr int NumThreads = 4;
+  constexpr int NumTraces = 1000;
+  TraceRing ring(NumThreads * NumTraces);
+  std::vector<Thread::ThreadPtr> threads;
+  for (int i = 0; i < NumThreads; ++i) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([&ring]() {
+      for (int j = 0; j < NumTraces; ++j) {
+        TraceWrapperPtr trace = makeTrace("");
+        EXPECT_TRUE(ring.push(trace));
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  int popped = 0;
+  while (ring.pop() != nullptr) {
+    ++popped;
+  }
+  EXPECT_EQ(NumThreads * NumTraces, popped);
+}
+
+// The traces of all the taps are written to the file, length delimited.
+TEST(BufferedFileSinkTest, WriteTraces) {
+  envoy::config::tap::v3::BufferedFileSink config;
+  config.set_path(TestEnvironment::temporaryPath("buffered_file_sink_test.pb_length_delimited"));
+  {
+    BufferedFileSink sink(config, Thread::threadFactoryForTest());
+    PerTapSinkHandlePtr handle1 = sink.createPerTapSinkHandle(1);
+    PerTapSinkHandlePtr handle2 = sink.createPerTapSinkHandle(2);
+    handle1->submitTrace(makeTrace("a"),
+                         envoy::config::tap::v3::OutputSink::PROTO_BINARY_LENGTH_DELIMITED);
+    handle2->submitTrace(makeTrace("b"),
+                         envoy::config::tap::v3::OutputSink::PROTO_BINARY_LENGTH_DELIMITED);
+    handle1->submitTrace(makeTrace("c"),
+                         envoy::config::tap::v3::OutputSink::PROTO_BINARY_LENGTH_DELIMITED);
+    // The traces queued are written before the sink is destroyed.
+  }
+
+  const std::string output = TestEnvironment::readFileToStringForTest(config.path());
+  Protobuf::io::ArrayInputStream stream(output.data(), output.size());
+  Protobuf::io::CodedInputStream coded_stream(&stream);
+  std::vector<std::string> bodies;
+  uint32_t length;
+  while (coded_stream.ReadVarint32(&length)) {
+    const auto limit = coded_stream.PushLimit(length);
+    envoy::data::tap::v3::TraceWrapper trace;
+    ASSERT_TRUE(trace.ParseFromCodedStream(&coded_stream));
+    coded_stream.PopLimit(limit);
+    bodies.push_back(trace.http_streamed_trace_segment().request_body_chunk().as_bytes());
+  }
+  EXPECT_EQ((std::vector<std::string>{"a", "b", "c"}), bodies);
+}
+
+TEST(BufferedFileSinkTest, BadPath) {
+  envoy::config::tap::v3::BufferedFileSink config;
+  config.set_path(TestEnvironment::temporaryPath("buffered_file_sink_test/missing/output"));
+  EXPECT_THROW_WITH_REGEX(BufferedFileSink(config, Thread::threadFactoryForTest()),
+                          EnvoyException, "cannot open tap file");
+}
+
+} // namespace
+} // namespace Tap
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
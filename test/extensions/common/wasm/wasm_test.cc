@@ -715,6 +715,62 @@ TEST_P(WasmCommonTest, VmCache) {
   proxy_wasm::clearWasmCachesForTesting();
 }
 
+// A base VM retained past its last plugin is reused until its retention period elapses.
+TEST_P(WasmCommonTest, VmRetention) {
+  Stats::IsolatedStoreImpl stats_store;
+  Api::ApiPtr api = Api::createApiForTest(stats_store);
+  NiceMock<Upstream::MockClusterManager> cluster_manager;
+  NiceMock<Init::MockManager> init_manager;
+  NiceMock<Server::MockServerLifecycleNotifier> lifecycle_notifier;
+  Event::DispatcherPtr dispatcher(api->allocateDispatcher("wasm_test"));
+  Config::DataSource::RemoteAsyncDataProviderPtr remote_data_provider;
+  auto scope = Stats::ScopeSharedPtr(stats_store.createScope("wasm."));
+  NiceMock<LocalInfo::MockLocalInfo> local_info;
+  auto plugin = std::make_shared<Extensions::Common::Wasm::Plugin>(
+      "", "", "", GetParam(), "", false, envoy::config::core::v3::TrafficDirection::UNSPECIFIED,
+      local_info, nullptr);
+
+  VmConfig vm_config;
+  vm_config.set_runtime(absl::StrCat("envoy.wasm.runtime.", GetParam()));
+  vm_config.mutable_vm_retention_period()->set_seconds(60);
+  std::string code;
+  if (GetParam() != "null") {
+    code = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+        absl::StrCat("{{ test_rundir }}/test/extensions/common/wasm/test_data/test_cpp.wasm")));
+  } else {
+    // The name of the Null VM plugin.
+    code = "CommonWasmTestCpp";
+  }
+  EXPECT_FALSE(code.empty());
+  vm_config.mutable_code()->mutable_local()->set_inline_bytes(code);
+  auto create = [&](const VmConfig& config) {
+    WasmHandleSharedPtr wasm_handle;
+    EXPECT_TRUE(createWasm(config, plugin, scope, cluster_manager, init_manager, *dispatcher,
+                           *api, lifecycle_notifier, remote_data_provider,
+                           [&wasm_handle](const WasmHandleSharedPtr& w) { wasm_handle = w; }));
+    EXPECT_NE(wasm_handle, nullptr);
+    return wasm_handle;
+  };
+
+  std::weak_ptr<WasmHandle> retained = create(vm_config);
+  EXPECT_FALSE(retained.expired());
+  EXPECT_EQ(retained.lock(), create(vm_config));
+
+  // Creating any VM once the retention period has elapsed releases the retained one.
+  setTimeOffsetForCodeCacheForTesting(std::chrono::seconds(61));
+  VmConfig other_vm_config = vm_config;
+  other_vm_config.set_vm_id("other");
+  other_vm_config.clear_vm_retention_period();
+  create(other_vm_config);
+  EXPECT_TRUE(retained.expired());
+
+  setTimeOffsetForCodeCacheForTesting(std::chrono::seconds(0));
+  clearCodeCacheForTesting();
+  dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+  dispatcher->clearDeferredDeleteList();
+  proxy_wasm::clearWasmCachesForTesting();
+}
+
 TEST_P(WasmCommonTest, RemoteCode) {
   if (GetParam() == "null") {
     return;
@@ -0,0 +1,90 @@
+#include "common/buffer/buffer_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/compression/brotli/compressor/brotli_compressor_impl.h"
+#include "extensions/compression/brotli/compressor/config.h"
+#include "extensions/compression/brotli/decompressor/brotli_decompressor_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Brotli {
+namespace Compressor {
+namespace {
+
+class BrotliCompressorImplTest : public testing::Test {
+protected:
+  // Decompresses the compressed buffer and checks it against the original text.
+  void expectDecompressesTo(const Buffer::Instance& compressed, const std::string& original_text) {
+    Stats::IsolatedStoreImpl stats_store;
+    Decompressor::BrotliDecompressorImpl decompressor{stats_store, "test.", 4096, false};
+    Buffer::OwnedImpl decompressed;
+    decompressor.decompress(compressed, decompressed);
+    EXPECT_EQ(original_text, decompressed.toString());
+    EXPECT_EQ(0, stats_store.counterFromString("test.brotli_error").value());
+  }
+
+  static constexpr uint32_t default_input_size{796};
+};
+
+// Exercises compression of several flushed chunks, each of them decompressible as soon as it is
+// flushed, with a chunk size smaller than the output.
+TEST_F(BrotliCompressorImplTest, CompressFlushAndFinish) {
+  BrotliCompressorImpl compressor{3, 18, 24, false, BrotliCompressorImpl::EncoderMode::Default,
+                                  4096};
+  Buffer::OwnedImpl accumulation_buffer;
+  std::string original_text;
+  for (uint64_t i = 0; i < 20; ++i) {
+    Buffer::OwnedImpl buffer;
+    TestUtility::feedBufferWithRandomCharacters(buffer, default_input_size * i, i);
+    original_text.append(buffer.toString());
+    compressor.compress(buffer, Envoy::Compression::Compressor::State::Flush);
+    accumulation_buffer.add(buffer);
+    expectDecompressesTo(accumulation_buffer, original_text);
+  }
+
+  Buffer::OwnedImpl buffer;
+  compressor.compress(buffer, Envoy::Compression::Compressor::State::Finish);
+  EXPECT_GT(buffer.length(), 0);
+  accumulation_buffer.add(buffer);
+  expectDecompressesTo(accumulation_buffer, original_text);
+}
+
+// Exercises compression with every encoder mode and the literal context modeling disabled.
+TEST_F(BrotliCompressorImplTest, CompressWithUncommonParams) {
+  for (const auto mode :
+       {BrotliCompressorImpl::EncoderMode::Generic, BrotliCompressorImpl::EncoderMode::Text,
+        BrotliCompressorImpl::EncoderMode::Font}) {
+    BrotliCompressorImpl compressor{11, 10, 16, true, mode, 4096};
+    Buffer::OwnedImpl buffer;
+    TestUtility::feedBufferWithRandomCharacters(buffer, 100 * default_input_size);
+    const std::string original_text = buffer.toString();
+    compressor.compress(buffer, Envoy::Compression::Compressor::State::Finish);
+    expectDecompressesTo(buffer, original_text);
+  }
+}
+
+TEST_F(BrotliCompressorImplTest, CreateCompressorFromConfig) {
+  envoy::extensions::compression::brotli::compressor::v3::Brotli config;
+  config.mutable_quality()->set_value(5);
+  config.set_encoder_mode(envoy::extensions::compression::brotli::compressor::v3::Brotli::TEXT);
+  BrotliCompressorFactory factory{config};
+  EXPECT_EQ("brotli.", factory.statsPrefix());
+  EXPECT_EQ("br", factory.contentEncoding());
+
+  Envoy::Compression::Compressor::CompressorPtr compressor = factory.createCompressor();
+  Buffer::OwnedImpl buffer{"hello hello hello hello"};
+  compressor->compress(buffer, Envoy::Compression::Compressor::State::Finish);
+  expectDecompressesTo(buffer, "hello hello hello hello");
+}
+
+} // namespace
+} // namespace Compressor
+} // namespace Brotli
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,120 @@
+#include "common/buffer/buffer_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/compression/brotli/compressor/brotli_compressor_impl.h"
+#include "extensions/compression/brotli/decompressor/brotli_decompressor_impl.h"
+#include "extensions/compression/brotli/decompressor/config.h"
+
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Brotli {
+namespace Decompressor {
+namespace {
+
+using testing::NiceMock;
+
+class BrotliDecompressorImplTest : public testing::Test {
+protected:
+  // Compresses random text with a single call, returning the compressed data.
+  Buffer::OwnedImpl compress(const std::string& text) {
+    Compressor::BrotliCompressorImpl compressor{
+        3, 18, 24, false, Compressor::BrotliCompressorImpl::EncoderMode::Default, 4096};
+    Buffer::OwnedImpl buffer{text};
+    compressor.compress(buffer, Envoy::Compression::Compressor::State::Finish);
+    return buffer;
+  }
+
+  std::string randomText(uint64_t size) {
+    Buffer::OwnedImpl buffer;
+    TestUtility::feedBufferWithRandomCharacters(buffer, size);
+    return buffer.toString();
+  }
+
+  Stats::IsolatedStoreImpl stats_store_;
+};
+
+// Decompresses a stream fed in several parts, with output larger than the chunk size.
+TEST_F(BrotliDecompressorImplTest, DecompressInParts) {
+  const std::string original_text = randomText(64 * 1024);
+  Buffer::OwnedImpl compressed = compress(original_text);
+
+  BrotliDecompressorImpl decompressor{stats_store_, "test.", 4096, false};
+  Buffer::OwnedImpl decompressed;
+  while (compressed.length() > 0) {
+    Buffer::OwnedImpl part;
+    part.move(compressed, std::min<uint64_t>(compressed.length(), 100));
+    decompressor.decompress(part, decompressed);
+  }
+
+  EXPECT_EQ(original_text, decompressed.toString());
+  EXPECT_EQ(0, stats_store_.counterFromString("test.brotli_error").value());
+}
+
+// Decompresses a stream with the ring buffer reallocation disabled.
+TEST_F(BrotliDecompressorImplTest, DecompressWithoutRingBufferReallocation) {
+  const std::string original_text = randomText(8 * 1024);
+  Buffer::OwnedImpl compressed = compress(original_text);
+
+  BrotliDecompressorImpl decompressor{stats_store_, "test.", 4096, true};
+  Buffer::OwnedImpl decompressed;
+  decompressor.decompress(compressed, decompressed);
+
+  EXPECT_EQ(original_text, decompressed.toString());
+}
+
+TEST_F(BrotliDecompressorImplTest, CorruptedInput) {
+  Buffer::OwnedImpl compressed = compress(randomText(8 * 1024));
+  // A window size encoded as 0x11 is invalid in a stream without large windows.
+  Buffer::OwnedImpl corrupted;
+  corrupted.add("\x11");
+  corrupted.move(compressed);
+
+  BrotliDecompressorImpl decompressor{stats_store_, "test.", 4096, false};
+  Buffer::OwnedImpl decompressed;
+  decompressor.decompress(corrupted, decompressed);
+
+  EXPECT_EQ(1, stats_store_.counterFromString("test.brotli_error").value());
+}
+
+TEST_F(BrotliDecompressorImplTest, TrailingData) {
+  const std::string original_text = randomText(1024);
+  Buffer::OwnedImpl compressed = compress(original_text);
+  compressed.add("trailing");
+
+  BrotliDecompressorImpl decompressor{stats_store_, "test.", 4096, false};
+  Buffer::OwnedImpl decompressed;
+  decompressor.decompress(compressed, decompressed);
+
+  EXPECT_EQ(original_text, decompressed.toString());
+  EXPECT_EQ(1, stats_store_.counterFromString("test.brotli_error").value());
+}
+
+TEST_F(BrotliDecompressorImplTest, CreateDecompressorFromConfig) {
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  envoy::extensions::compression::brotli::decompressor::v3::Brotli config;
+  config.mutable_chunk_size()->set_value(8192);
+  BrotliDecompressorLibraryFactory library_factory;
+  Envoy::Compression::Decompressor::DecompressorFactoryPtr factory =
+      library_factory.createDecompressorFactoryFromProto(config, context);
+  EXPECT_EQ("brotli.", factory->statsPrefix());
+  EXPECT_EQ("br", factory->contentEncoding());
+
+  const std::string original_text = randomText(1024);
+  Buffer::OwnedImpl compressed = compress(original_text);
+  Buffer::OwnedImpl decompressed;
+  factory->createDecompressor("test.")->decompress(compressed, decompressed);
+  EXPECT_EQ(original_text, decompressed.toString());
+}
+
+} // namespace
+} // namespace Decompressor
+} // namespace Brotli
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
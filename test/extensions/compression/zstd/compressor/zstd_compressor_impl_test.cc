@@ -0,0 +1,85 @@
+#include "common/buffer/buffer_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/compression/zstd/compressor/config.h"
+#include "extensions/compression/zstd/compressor/zstd_compressor_impl.h"
+#include "extensions/compression/zstd/decompressor/zstd_decompressor_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Compressor {
+namespace {
+
+class ZstdCompressorImplTest : public testing::Test {
+protected:
+  // Decompresses the compressed buffer and checks it against the original text.
+  void expectDecompressesTo(const Buffer::Instance& compressed, const std::string& original_text) {
+    Stats::IsolatedStoreImpl stats_store;
+    Decompressor::ZstdDecompressorImpl decompressor{stats_store, "test.", 4096};
+    Buffer::OwnedImpl decompressed;
+    decompressor.decompress(compressed, decompressed);
+    EXPECT_EQ(original_text, decompressed.toString());
+    EXPECT_EQ(0, stats_store.counterFromString("test.zstd_error").value());
+  }
+
+  static constexpr uint32_t default_input_size{796};
+};
+
+// Exercises compression of several flushed chunks, each of them decompressible as soon as it is
+// flushed, with a chunk size smaller than the output.
+TEST_F(ZstdCompressorImplTest, CompressFlushAndFinish) {
+  ZstdCompressorImpl compressor{3, false, 4096};
+  Buffer::OwnedImpl accumulation_buffer;
+  std::string original_text;
+  for (uint64_t i = 0; i < 20; ++i) {
+    Buffer::OwnedImpl buffer;
+    TestUtility::feedBufferWithRandomCharacters(buffer, default_input_size * i, i);
+    original_text.append(buffer.toString());
+    compressor.compress(buffer, Envoy::Compression::Compressor::State::Flush);
+    accumulation_buffer.add(buffer);
+    expectDecompressesTo(accumulation_buffer, original_text);
+  }
+
+  Buffer::OwnedImpl buffer;
+  compressor.compress(buffer, Envoy::Compression::Compressor::State::Finish);
+  EXPECT_GT(buffer.length(), 0);
+  accumulation_buffer.add(buffer);
+  expectDecompressesTo(accumulation_buffer, original_text);
+}
+
+// Exercises compression at the highest level with the checksum enabled.
+TEST_F(ZstdCompressorImplTest, CompressWithUncommonParams) {
+  ZstdCompressorImpl compressor{22, true, 4096};
+  Buffer::OwnedImpl buffer;
+  TestUtility::feedBufferWithRandomCharacters(buffer, 100 * default_input_size);
+  const std::string original_text = buffer.toString();
+  compressor.compress(buffer, Envoy::Compression::Compressor::State::Finish);
+  expectDecompressesTo(buffer, original_text);
+}
+
+TEST_F(ZstdCompressorImplTest, CreateCompressorFromConfig) {
+  envoy::extensions::compression::zstd::compressor::v3::Zstd config;
+  config.mutable_compression_level()->set_value(9);
+  config.set_enable_checksum(true);
+  ZstdCompressorFactory factory{config};
+  EXPECT_EQ("zstd.", factory.statsPrefix());
+  EXPECT_EQ("zstd", factory.contentEncoding());
+
+  Envoy::Compression::Compressor::CompressorPtr compressor = factory.createCompressor();
+  Buffer::OwnedImpl buffer{"hello hello hello hello"};
+  compressor->compress(buffer, Envoy::Compression::Compressor::State::Finish);
+  expectDecompressesTo(buffer, "hello hello hello hello");
+}
+
+} // namespace
+} // namespace Compressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
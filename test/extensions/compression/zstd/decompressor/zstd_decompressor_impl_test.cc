@@ -0,0 +1,106 @@
+#include "common/buffer/buffer_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/compression/zstd/compressor/zstd_compressor_impl.h"
+#include "extensions/compression/zstd/decompressor/config.h"
+#include "extensions/compression/zstd/decompressor/zstd_decompressor_impl.h"
+
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Decompressor {
+namespace {
+
+using testing::NiceMock;
+
+class ZstdDecompressorImplTest : public testing::Test {
+protected:
+  // Compresses random text with a single call, returning the compressed data.
+  Buffer::OwnedImpl compress(const std::string& text) {
+    Compressor::ZstdCompressorImpl compressor{3, true, 4096};
+    Buffer::OwnedImpl buffer{text};
+    compressor.compress(buffer, Envoy::Compression::Compressor::State::Finish);
+    return buffer;
+  }
+
+  std::string randomText(uint64_t size) {
+    Buffer::OwnedImpl buffer;
+    TestUtility::feedBufferWithRandomCharacters(buffer, size);
+    return buffer.toString();
+  }
+
+  Stats::IsolatedStoreImpl stats_store_;
+};
+
+// Decompresses a stream fed in several parts, with output larger than the chunk size.
+TEST_F(ZstdDecompressorImplTest, DecompressInParts) {
+  const std::string original_text = randomText(64 * 1024);
+  Buffer::OwnedImpl compressed = compress(original_text);
+
+  ZstdDecompressorImpl decompressor{stats_store_, "test.", 4096};
+  Buffer::OwnedImpl decompressed;
+  while (compressed.length() > 0) {
+    Buffer::OwnedImpl part;
+    part.move(compressed, std::min<uint64_t>(compressed.length(), 100));
+    decompressor.decompress(part, decompressed);
+  }
+
+  EXPECT_EQ(original_text, decompressed.toString());
+  EXPECT_EQ(0, stats_store_.counterFromString("test.zstd_error").value());
+}
+
+// Decompresses a single part whose output is many times the chunk size.
+TEST_F(ZstdDecompressorImplTest, DecompressLargeOutput) {
+  const std::string original_text(1024 * 1024, 'a');
+  Buffer::OwnedImpl compressed = compress(original_text);
+
+  ZstdDecompressorImpl decompressor{stats_store_, "test.", 4096};
+  Buffer::OwnedImpl decompressed;
+  decompressor.decompress(compressed, decompressed);
+
+  EXPECT_EQ(original_text, decompressed.toString());
+}
+
+TEST_F(ZstdDecompressorImplTest, CorruptedInput) {
+  Buffer::OwnedImpl compressed = compress(randomText(8 * 1024));
+  // The stream no longer starts with the magic number of a zstd frame.
+  Buffer::OwnedImpl corrupted;
+  corrupted.add("garbage");
+  corrupted.move(compressed);
+
+  ZstdDecompressorImpl decompressor{stats_store_, "test.", 4096};
+  Buffer::OwnedImpl decompressed;
+  decompressor.decompress(corrupted, decompressed);
+
+  EXPECT_EQ(1, stats_store_.counterFromString("test.zstd_error").value());
+}
+
+TEST_F(ZstdDecompressorImplTest, CreateDecompressorFromConfig) {
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  envoy::extensions::compression::zstd::decompressor::v3::Zstd config;
+  config.mutable_chunk_size()->set_value(8192);
+  ZstdDecompressorLibraryFactory library_factory;
+  Envoy::Compression::Decompressor::DecompressorFactoryPtr factory =
+      library_factory.createDecompressorFactoryFromProto(config, context);
+  EXPECT_EQ("zstd.", factory->statsPrefix());
+  EXPECT_EQ("zstd", factory->contentEncoding());
+
+  const std::string original_text = randomText(1024);
+  Buffer::OwnedImpl compressed = compress(original_text);
+  Buffer::OwnedImpl decompressed;
+  factory->createDecompressor("test.")->decompress(compressed, decompressed);
+  EXPECT_EQ(original_text, decompressed.toString());
+}
+
+} // namespace
+} // namespace Decompressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
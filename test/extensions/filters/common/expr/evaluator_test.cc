@@ -0,0 +1,71 @@
+#include "extensions/filters/common/expr/evaluator.h"
+
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace Expr {
+namespace {
+
+google::api::expr::v1alpha1::Expr headerEquals(const std::string& name, const std::string& value) {
+  const std::string yaml = fmt::format(R"EOF(
+call_expr:
+  function: _==_
+  args:
+  - call_expr:
+      function: _[_]
+      args:
+      - select_expr:
+          operand:
+            ident_expr:
+              name: request
+          field: headers
+      - const_expr:
+          string_value: {}
+  - const_expr:
+      string_value: {}
+)EOF",
+                                       name, value);
+  return TestUtility::parseYaml<google::api::expr::v1alpha1::Expr>(yaml);
+}
+
+// The expressions evaluated with a stream activation share the attributes of the stream, which are
+// produced by the first evaluation.
+TEST(StreamActivation, SharesAttributes) {
+  BuilderPtr builder = createBuilder(nullptr);
+  const auto foo_bar_expr = headerEquals("foo", "bar");
+  const auto foo_baz_expr = headerEquals("foo", "baz");
+  const auto other_expr = headerEquals("other", "value");
+  ExpressionPtr foo_bar = createExpression(*builder, foo_bar_expr);
+  ExpressionPtr foo_baz = createExpression(*builder, foo_baz_expr);
+  ExpressionPtr other = createExpression(*builder, other_expr);
+
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  Http::TestRequestHeaderMapImpl headers{{"foo", "bar"}, {"other", "value"}};
+  StreamActivation activation(info, &headers, nullptr, nullptr);
+  EXPECT_TRUE(activation.matches(*foo_bar));
+  EXPECT_FALSE(activation.matches(*foo_baz));
+  EXPECT_TRUE(activation.matches(*other));
+  ASSERT_TRUE(activation.evaluate(*foo_bar).has_value());
+  EXPECT_TRUE(activation.evaluate(*foo_bar).value().BoolOrDie());
+
+  // Header values are memoized, so a new activation is needed once the headers change.
+  headers.setCopy(Http::LowerCaseString("foo"), "baz");
+  EXPECT_TRUE(activation.matches(*foo_bar));
+  StreamActivation new_activation(info, &headers, nullptr, nullptr);
+  EXPECT_FALSE(new_activation.matches(*foo_bar));
+  EXPECT_TRUE(new_activation.matches(*foo_baz));
+  EXPECT_TRUE(matches(*foo_baz, info, headers));
+}
+
+} // namespace
+} // namespace Expr
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
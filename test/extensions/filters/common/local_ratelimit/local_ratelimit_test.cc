@@ -1,6 +1,10 @@
+#include "envoy/extensions/filters/http/local_ratelimit/v3/local_rate_limit.pb.h"
+
 #include "extensions/filters/common/local_ratelimit/local_ratelimit_impl.h"
 
 #include "test/mocks/event/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -163,6 +167,91 @@ TEST_F(LocalRateLimiterImplTest, TokenBucketMaxTokensGreaterThanTokensPerFill) {
   EXPECT_FALSE(rate_limiter_->requestAllowed());
 }
 
+class LocalDescriptorRateLimiterTest : public testing::Test {
+public:
+  void initialize(const std::string& yaml, uint32_t max_buckets = 10000) {
+    envoy::extensions::filters::http::local_ratelimit::v3::LocalRateLimit config;
+    TestUtility::loadFromYaml(yaml, config);
+    rate_limiter_ = std::make_unique<LocalDescriptorRateLimiter>(config.descriptors(), max_buckets,
+                                                                 time_system_);
+  }
+
+  bool requestAllowed(const std::string& client, const std::string& path = "/") {
+    return rate_limiter_->requestAllowed(
+        {{{{"client", client}}}, {{{"path", path}}}, {{{"unknown", "value"}}}});
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  std::unique_ptr<LocalDescriptorRateLimiter> rate_limiter_;
+};
+
+static const std::string descriptors_yaml = R"EOF(
+stat_prefix: test
+descriptors:
+- entries:
+  - key: client
+  token_bucket:
+    max_tokens: 2
+    tokens_per_fill: 1
+    fill_interval: 1s
+- entries:
+  - key: path
+    value: /slow
+  token_bucket:
+    max_tokens: 1
+    fill_interval: 10s
+)EOF";
+
+// Each value of a dynamic entry gets its own bucket, refilled by the intervals elapsed when used.
+TEST_F(LocalDescriptorRateLimiterTest, DynamicBuckets) {
+  initialize(descriptors_yaml);
+  EXPECT_TRUE(requestAllowed("a"));
+  EXPECT_TRUE(requestAllowed("a"));
+  EXPECT_FALSE(requestAllowed("a"));
+  EXPECT_TRUE(requestAllowed("b"));
+  EXPECT_EQ(2U, rate_limiter_->dynamicBuckets());
+
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_TRUE(requestAllowed("a"));
+  EXPECT_FALSE(requestAllowed("a"));
+
+  // The bucket is not filled beyond its maximum.
+  time_system_.advanceTimeWait(std::chrono::seconds(10));
+  EXPECT_TRUE(requestAllowed("a"));
+  EXPECT_TRUE(requestAllowed("a"));
+  EXPECT_FALSE(requestAllowed("a"));
+}
+
+// A static entry has a single bucket, and any empty bucket rate limits the request.
+TEST_F(LocalDescriptorRateLimiterTest, StaticBucket) {
+  initialize(descriptors_yaml);
+  EXPECT_TRUE(requestAllowed("a", "/slow"));
+  EXPECT_FALSE(requestAllowed("b", "/slow"));
+  EXPECT_TRUE(requestAllowed("b", "/fast"));
+  EXPECT_TRUE(rate_limiter_->requestAllowed({}));
+}
+
+// Once the table is full, full buckets are dropped, and the descriptors finding no room share a
+// bucket.
+TEST_F(LocalDescriptorRateLimiterTest, MaxBuckets) {
+  // A bucket per shard.
+  initialize(descriptors_yaml, 16);
+  uint32_t allowed = 0;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    allowed += requestAllowed(absl::StrCat("client", i));
+  }
+  EXPECT_EQ(16U, rate_limiter_->dynamicBuckets());
+  // The first client of each shard got a bucket, and the others shared the two tokens of the
+  // shared bucket.
+  EXPECT_EQ(18U, allowed);
+
+  // Once refilled, the buckets are dropped to make room for new descriptors.
+  time_system_.advanceTimeWait(std::chrono::seconds(2));
+  EXPECT_TRUE(requestAllowed("new"));
+  EXPECT_TRUE(requestAllowed("new"));
+  EXPECT_FALSE(requestAllowed("new"));
+}
+
 } // Namespace LocalRateLimit
 } // namespace Common
 } // namespace Filters
@@ -159,6 +159,61 @@ TEST_F(LuaTest, MarkDead) {
   lua_gc(cr1->luaState(), LUA_GCCOLLECT, 0);
 }
 
+// The threads of returned coroutines are reused, those of yielded or failed ones are not.
+TEST_F(LuaTest, CoroutineReuse) {
+  const std::string SCRIPT{R"EOF(
+    function callMe(object)
+      object:testCall()
+    end
+
+    function yieldMe()
+      coroutine.yield()
+    end
+
+    function failMe()
+      error("failed")
+    end
+  )EOF"};
+
+  setup(SCRIPT);
+  EXPECT_NE(LUA_REFNIL, state_->getGlobalRef(state_->registerGlobal("callMe")));
+  EXPECT_NE(LUA_REFNIL, state_->getGlobalRef(state_->registerGlobal("yieldMe")));
+  EXPECT_NE(LUA_REFNIL, state_->getGlobalRef(state_->registerGlobal("failMe")));
+
+  lua_State* thread;
+  {
+    CoroutinePtr cr(state_->createCoroutine());
+    thread = cr->luaState();
+    TestObject* object = TestObject::create(cr->luaState()).first;
+    EXPECT_CALL(*object, doTestCall(_));
+    cr->start(state_->getGlobalRef(0), 1, yield_callback_);
+    EXPECT_EQ(cr->state(), Coroutine::State::Finished);
+    EXPECT_CALL(*object, onDestroy());
+  }
+  EXPECT_EQ(1U, state_->idleCoroutines());
+  // The idle thread holds no reference to the object.
+  lua_gc(thread, LUA_GCCOLLECT, 0);
+
+  // The reused thread starts with an empty stack.
+  {
+    CoroutinePtr cr(state_->createCoroutine());
+    EXPECT_EQ(thread, cr->luaState());
+    EXPECT_EQ(0, lua_gettop(cr->luaState()));
+    EXPECT_EQ(0U, state_->idleCoroutines());
+    EXPECT_CALL(on_yield_, ready());
+    cr->start(state_->getGlobalRef(1), 0, yield_callback_);
+    EXPECT_EQ(cr->state(), Coroutine::State::Yielded);
+  }
+  EXPECT_EQ(0U, state_->idleCoroutines());
+
+  {
+    CoroutinePtr cr(state_->createCoroutine());
+    EXPECT_NE(thread, cr->luaState());
+    EXPECT_THROW(cr->start(state_->getGlobalRef(2), 0, yield_callback_), LuaException);
+  }
+  EXPECT_EQ(0U, state_->idleCoroutines());
+}
+
 class ThreadSafeTest : public testing::Test {
 public:
   ThreadSafeTest()
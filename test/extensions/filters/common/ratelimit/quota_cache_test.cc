@@ -0,0 +1,191 @@
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "envoy/service/ratelimit/v3/rls.pb.h"
+
+#include "common/grpc/common.h"
+#include "common/tracing/http_tracer_impl.h"
+
+#include "extensions/filters/common/ratelimit/quota_cache.h"
+
+#include "test/extensions/filters/common/ratelimit/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/grpc/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::WithArg;
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RateLimit {
+namespace {
+
+class MockRequestCallbacks : public RequestCallbacks {
+public:
+  void complete(LimitStatus status, DescriptorStatusListPtr&&, Http::ResponseHeaderMapPtr&&,
+                Http::RequestHeaderMapPtr&&, const std::string&) override {
+    complete_(status);
+  }
+
+  MOCK_METHOD(void, complete_, (LimitStatus status));
+};
+
+class QuotaCacheTest : public testing::Test {
+public:
+  QuotaCacheTest()
+      : async_client_(new Grpc::MockAsyncClient()),
+        flush_timer_(new NiceMock<Event::MockTimer>(&dispatcher_)),
+        cache_(Grpc::RawAsyncClientPtr{async_client_}, dispatcher_,
+               {10, 5, std::chrono::milliseconds(1000), absl::nullopt,
+                envoy::config::core::v3::ApiVersion::AUTO}) {}
+
+  // Asks the caching client, which calls the rate limit service unless a lease allows the request.
+  void limit(LimitStatus status) {
+    EXPECT_CALL(request_callbacks_, complete_(status));
+    QuotaCachingClient client(ClientPtr{inner_client_ = new NiceMock<MockClient>()}, cache_);
+    ON_CALL(*inner_client_, limit(_, _, _, _, _))
+        .WillByDefault(WithArg<0>(Invoke([this](RequestCallbacks& callbacks) {
+          callbacks.complete(service_status_, std::make_unique<DescriptorStatusList>(statuses_),
+                             nullptr, nullptr, "");
+          ++service_calls_;
+        })));
+    client.limit(request_callbacks_, "domain", descriptors_, Tracing::NullSpan::instance(),
+                 stream_info_);
+  }
+
+  void setRemaining(uint32_t remaining) {
+    statuses_.resize(1);
+    statuses_[0].set_code(envoy::service::ratelimit::v3::RateLimitResponse::OK);
+    statuses_[0].mutable_current_limit()->set_requests_per_unit(100);
+    statuses_[0].set_limit_remaining(remaining);
+  }
+
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  Grpc::MockAsyncClient* async_client_;
+  NiceMock<Event::MockTimer>* flush_timer_;
+  QuotaCache cache_;
+  NiceMock<MockClient>* inner_client_{};
+  MockRequestCallbacks request_callbacks_;
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+  const std::vector<Envoy::RateLimit::Descriptor> descriptors_{{{{"client", "a"}}}};
+  LimitStatus service_status_{LimitStatus::OK};
+  DescriptorStatusList statuses_;
+  uint32_t service_calls_{};
+};
+
+// The requests following a request allowed by the service are allowed out of the lease of a share
+// of the remaining quota, and the requests checked again once it is used up.
+TEST_F(QuotaCacheTest, LeaseOfRemainingQuota) {
+  // The lease is capped by the quota remaining above min_remaining.
+  setRemaining(8);
+  limit(LimitStatus::OK);
+  EXPECT_EQ(1U, service_calls_);
+  EXPECT_TRUE(flush_timer_->enabled_);
+  for (int i = 0; i < 3; ++i) {
+    limit(LimitStatus::OK);
+  }
+  EXPECT_EQ(1U, service_calls_);
+
+  // Near the limit, every request is checked.
+  setRemaining(5);
+  limit(LimitStatus::OK);
+  limit(LimitStatus::OK);
+  EXPECT_EQ(3U, service_calls_);
+
+  service_status_ = LimitStatus::OverLimit;
+  limit(LimitStatus::OverLimit);
+  EXPECT_EQ(4U, service_calls_);
+}
+
+// Descriptors whose status the service does not return have no lease.
+TEST_F(QuotaCacheTest, NoStatuses) {
+  limit(LimitStatus::OK);
+  limit(LimitStatus::OK);
+  EXPECT_EQ(2U, service_calls_);
+}
+
+// The hits allowed out of a lease are reported in a batch, and the response renews the lease.
+TEST_F(QuotaCacheTest, ReportRenewsLease) {
+  setRemaining(100);
+  limit(LimitStatus::OK);
+  limit(LimitStatus::OK);
+  limit(LimitStatus::OK);
+  EXPECT_EQ(1U, service_calls_);
+
+  Grpc::MockAsyncRequest async_request;
+  Grpc::RawAsyncRequestCallbacks* report_callbacks{};
+  EXPECT_CALL(*async_client_, sendRaw(_, "ShouldRateLimit", _, _, _, _))
+      .WillOnce(Invoke([&](absl::string_view, absl::string_view, Buffer::InstancePtr&& request,
+                           Grpc::RawAsyncRequestCallbacks& callbacks, Tracing::Span&,
+                           const Http::AsyncClient::RequestOptions&) -> Grpc::AsyncRequest* {
+        envoy::service::ratelimit::v3::RateLimitRequest message;
+        EXPECT_TRUE(message.ParseFromString(request->toString()));
+        EXPECT_EQ("domain", message.domain());
+        EXPECT_EQ(2U, message.hits_addend());
+        report_callbacks = &callbacks;
+        return &async_request;
+      }));
+  flush_timer_->invokeCallback();
+  ASSERT_NE(nullptr, report_callbacks);
+
+  // The lease is down to what the report leaves.
+  envoy::service::ratelimit::v3::RateLimitResponse response;
+  response.set_overall_code(envoy::service::ratelimit::v3::RateLimitResponse::OK);
+  auto* status = response.add_statuses();
+  status->set_code(envoy::service::ratelimit::v3::RateLimitResponse::OK);
+  status->mutable_current_limit()->set_requests_per_unit(100);
+  status->set_limit_remaining(6);
+  EXPECT_CALL(dispatcher_, deferredDelete_(_));
+  report_callbacks->onSuccessRaw(Grpc::Common::serializeMessage(response),
+                                 Tracing::NullSpan::instance());
+  limit(LimitStatus::OK);
+  EXPECT_EQ(1U, service_calls_);
+  limit(LimitStatus::OK);
+  EXPECT_EQ(2U, service_calls_);
+}
+
+// A failed report ends the lease, until the service allows a request again.
+TEST_F(QuotaCacheTest, FailedReportEndsLease) {
+  setRemaining(100);
+  limit(LimitStatus::OK);
+  limit(LimitStatus::OK);
+
+  EXPECT_CALL(dispatcher_, deferredDelete_(_));
+  EXPECT_CALL(*async_client_, sendRaw(_, _, _, _, _, _))
+      .WillOnce(Invoke([](absl::string_view, absl::string_view, Buffer::InstancePtr&&,
+                          Grpc::RawAsyncRequestCallbacks& callbacks, Tracing::Span& span,
+                          const Http::AsyncClient::RequestOptions&) -> Grpc::AsyncRequest* {
+        callbacks.onFailure(Grpc::Status::WellKnownGrpcStatus::Unavailable, "", span);
+        return nullptr;
+      }));
+  flush_timer_->invokeCallback();
+  limit(LimitStatus::OK);
+  EXPECT_EQ(2U, service_calls_);
+  EXPECT_EQ(1U, cache_.leases());
+}
+
+// The keys of distinct sets of descriptors differ.
+TEST(QuotaCacheKeyTest, Key) {
+  const std::string key = QuotaCache::key("domain", {{{{"a", "b"}}}});
+  EXPECT_EQ(key, QuotaCache::key("domain", {{{{"a", "b"}}}}));
+  EXPECT_NE(key, QuotaCache::key("domain", {{{{"ab", ""}}}}));
+  EXPECT_NE(key, QuotaCache::key("other", {{{{"a", "b"}}}}));
+  EXPECT_NE(QuotaCache::key("domain", {{{{"a", "b"}, {"c", "d"}}}}),
+            QuotaCache::key("domain", {{{{"a", "b"}}}, {{{"c", "d"}}}}));
+}
+
+} // namespace
+} // namespace RateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
@@ -453,6 +453,41 @@ TEST(RoleBasedAccessControlEngineImpl, LogIfMatched) {
   checkEngine(engine, true, RBAC::LogResult::No, info, conn, headers);
 }
 
+// Indexed and unindexed policies are evaluated in the order of their names.
+TEST(RoleBasedAccessControlEngineImpl, IndexedPoliciesKeepOrder) {
+  envoy::config::rbac::v3::Policy header_policy;
+  auto* header = header_policy.add_permissions()->mutable_header();
+  header->set_name("x-tenant");
+  header->set_exact_match("foo");
+  header_policy.add_principals()->set_any(true);
+
+  envoy::config::rbac::v3::Policy any_policy;
+  any_policy.add_permissions()->set_any(true);
+  any_policy.add_principals()->set_any(true);
+
+  envoy::config::rbac::v3::RBAC rbac;
+  rbac.set_action(envoy::config::rbac::v3::RBAC::ALLOW);
+  (*rbac.mutable_policies())["a"] = header_policy;
+  (*rbac.mutable_policies())["b"] = any_policy;
+  (*rbac.mutable_policies())["c"] = header_policy;
+  RBAC::RoleBasedAccessControlEngineImpl engine(rbac);
+
+  Envoy::Network::MockConnection conn;
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  std::string effective_policy_id;
+  Envoy::Http::TestRequestHeaderMapImpl headers{{"x-tenant", "foo"}};
+  EXPECT_TRUE(engine.handleAction(conn, headers, info, &effective_policy_id));
+  EXPECT_EQ("a", effective_policy_id);
+
+  headers = Envoy::Http::TestRequestHeaderMapImpl{{"x-tenant", "bar"}};
+  EXPECT_TRUE(engine.handleAction(conn, headers, info, &effective_policy_id));
+  EXPECT_EQ("b", effective_policy_id);
+
+  (*rbac.mutable_policies())["b"] = header_policy;
+  RBAC::RoleBasedAccessControlEngineImpl indexed_engine(rbac);
+  EXPECT_FALSE(indexed_engine.handleAction(conn, headers, info, nullptr));
+}
+
 } // namespace
 } // namespace RBAC
 } // namespace Common
@@ -0,0 +1,140 @@
+#include "envoy/config/rbac/v3/rbac.pb.h"
+
+#include "common/network/utility.h"
+
+#include "extensions/filters/common/rbac/policy_index.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/ssl/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::Const;
+using testing::ElementsAre;
+using testing::IsEmpty;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RBAC {
+namespace {
+
+class PolicyIndexTest : public testing::Test {
+protected:
+  void addPolicy(const std::string& yaml) {
+    policies_.emplace_back(std::make_unique<envoy::config::rbac::v3::Policy>());
+    TestUtility::loadFromYaml(yaml, *policies_.back());
+  }
+
+  std::unique_ptr<PolicyIndex> createIndex() {
+    std::vector<const envoy::config::rbac::v3::Policy*> policies;
+    for (const auto& policy : policies_) {
+      policies.push_back(policy.get());
+    }
+    return std::make_unique<PolicyIndex>(policies);
+  }
+
+  std::vector<std::unique_ptr<envoy::config::rbac::v3::Policy>> policies_;
+  NiceMock<Network::MockConnection> connection_;
+  NiceMock<StreamInfo::MockStreamInfo> info_;
+};
+
+TEST_F(PolicyIndexTest, IndexesRequiredAttributes) {
+  // 0: a source IP range.
+  addPolicy(R"EOF(
+permissions: [{any: true}]
+principals: [{source_ip: {address_prefix: 10.0.0.0, prefix_len: 8}}]
+)EOF");
+  // 1: an exact header value, taken from the permissions as the principals match anything.
+  addPolicy(R"EOF(
+permissions: [{header: {name: x-Tenant, exact_match: foo}}]
+principals: [{any: true}]
+)EOF");
+  // 2: any of a path prefix and an exact path.
+  addPolicy(R"EOF(
+permissions:
+- or_rules:
+    rules:
+    - url_path: {path: {prefix: /admin}}
+    - url_path: {path: {exact: /health}}
+principals: [{any: true}]
+)EOF");
+  // 3: nothing required.
+  addPolicy(R"EOF(
+permissions: [{any: true}]
+principals: [{any: true}]
+)EOF");
+  // 4: an authenticated principal name, required by one of the rules of a conjunction.
+  addPolicy(R"EOF(
+permissions: [{any: true}]
+principals:
+- and_ids:
+    ids:
+    - any: true
+    - authenticated: {principal_name: {exact: "spiffe://a"}}
+)EOF");
+  // 5: a regex is not indexed, nor is a disjunction with a rule which is not.
+  addPolicy(R"EOF(
+permissions: [{header: {name: x-tenant, safe_regex_match: {google_re2: {}, regex: "f.*"}}}]
+principals:
+- or_ids:
+    ids:
+    - remote_ip: {address_prefix: 10.0.0.0, prefix_len: 8}
+    - not_id: {any: true}
+)EOF");
+  auto index = createIndex();
+  EXPECT_THAT(index->unindexed(), ElementsAre(3, 5));
+
+  connection_.remote_address_ = Network::Utility::parseInternetAddress("10.1.2.3", 1234, false);
+  auto ssl = std::make_shared<Ssl::MockConnectionInfo>();
+  const std::vector<std::string> uri_sans{"spiffe://a"};
+  const std::vector<std::string> dns_sans;
+  const std::string subject = "subject";
+  EXPECT_CALL(*ssl, uriSanPeerCertificate()).WillRepeatedly(Return(uri_sans));
+  EXPECT_CALL(*ssl, dnsSansPeerCertificate()).WillRepeatedly(Return(dns_sans));
+  EXPECT_CALL(*ssl, subjectPeerCertificate()).WillRepeatedly(ReturnRef(subject));
+  EXPECT_CALL(Const(connection_), ssl()).WillRepeatedly(Return(ssl));
+  Envoy::Http::TestRequestHeaderMapImpl headers{{":path", "/admin/users?id=1"},
+                                                {"x-tenant", "foo"}};
+  EXPECT_THAT(index->candidates(connection_, headers, info_), ElementsAre(0, 1, 2, 4));
+
+  headers = Envoy::Http::TestRequestHeaderMapImpl{{":path", "/health"}, {"x-tenant", "bar"}};
+  EXPECT_THAT(index->candidates(connection_, headers, info_), ElementsAre(0, 2, 4));
+
+  connection_.remote_address_ = Network::Utility::parseInternetAddress("192.168.0.1", 1234, false);
+  EXPECT_CALL(Const(connection_), ssl()).WillRepeatedly(Return(nullptr));
+  headers = Envoy::Http::TestRequestHeaderMapImpl{{":path", "/healthz"}, {"x-tenant", "foo,bar"}};
+  EXPECT_THAT(index->candidates(connection_, headers, info_), IsEmpty());
+}
+
+// A policy needs either its principals or its permissions, so either can index it.
+TEST_F(PolicyIndexTest, IndexesPrincipalsOrPermissions) {
+  addPolicy(R"EOF(
+permissions: [{destination_ip: {address_prefix: 192.168.0.0, prefix_len: 16}}]
+principals: [{remote_ip: {address_prefix: 10.0.0.0, prefix_len: 8}}]
+)EOF");
+  auto index = createIndex();
+  EXPECT_THAT(index->unindexed(), IsEmpty());
+
+  Envoy::Http::TestRequestHeaderMapImpl headers;
+  info_.downstream_remote_address_ =
+      Network::Utility::parseInternetAddress("10.0.0.1", 1234, false);
+  EXPECT_THAT(index->candidates(connection_, headers, info_), ElementsAre(0));
+  info_.downstream_remote_address_ =
+      Network::Utility::parseInternetAddress("11.0.0.1", 1234, false);
+  EXPECT_THAT(index->candidates(connection_, headers, info_), IsEmpty());
+}
+
+} // namespace
+} // namespace RBAC
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
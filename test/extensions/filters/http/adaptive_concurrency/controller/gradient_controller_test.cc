@@ -15,6 +15,7 @@
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -349,6 +350,50 @@ min_rtt_calc_params:
   verifyMinRTTValue(std::chrono::milliseconds(13));
 }
 
+// Verify that the latency samples recorded by several threads are merged for the minRTT
+// calculation.
+TEST_F(GradientControllerTest, MinRTTSamplesFromThreads) {
+  const std::string yaml = R"EOF(
+sample_aggregate_percentile:
+  value: 50
+concurrency_limit_params:
+  concurrency_update_interval: 0.1s
+min_rtt_calc_params:
+  jitter:
+    value: 0.0
+  interval: 30s
+  request_count: 41
+  min_concurrency: 50
+  buffer:
+    value: 0.0
+)EOF";
+
+  auto controller = makeController(yaml);
+  const auto min_rtt = std::chrono::milliseconds(13);
+  for (int i = 0; i < 41; ++i) {
+    tryForward(controller, true);
+  }
+
+  // The threads stop short of the request count, so that the minRTT calculation, which arms the
+  // timers of the dispatcher, completes on this thread.
+  std::vector<Thread::ThreadPtr> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([&]() {
+      for (int j = 0; j < 10; ++j) {
+        sampleLatency(controller, min_rtt);
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  verifyMinRTTActive();
+
+  sampleLatency(controller, min_rtt);
+  verifyMinRTTInactive();
+  verifyMinRTTValue(min_rtt);
+}
+
 TEST_F(GradientControllerTest, CancelLatencySample) {
   const std::string yaml = R"EOF(
 sample_aggregate_percentile:
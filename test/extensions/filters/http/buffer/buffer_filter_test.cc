@@ -12,6 +12,7 @@
 
 #include "test/mocks/buffer/mocks.h"
 #include "test/mocks/http/mocks.h"
+#include "test/test_common/environment.h"
 #include "test/test_common/printers.h"
 #include "test/test_common/test_runtime.h"
 
@@ -180,6 +181,58 @@ TEST_F(BufferFilterTest, RouteDisabledConfigOverride) {
   EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(data1, true));
 }
 
+#ifndef WIN32
+// The data beyond the memory bytes is spilled to a file, and read back from it unchanged.
+TEST_F(BufferFilterTest, SpillConfig) {
+  envoy::extensions::filters::http::buffer::v3::BufferPerRoute route_cfg;
+  auto* buf = route_cfg.mutable_buffer();
+  buf->mutable_max_request_bytes()->set_value(1024);
+  buf->mutable_spill()->set_directory(TestEnvironment::temporaryDirectory());
+  buf->mutable_spill()->mutable_memory_bytes()->set_value(5);
+  BufferFilterSettings route_settings(route_cfg);
+  routeLocalConfig(&route_settings, nullptr);
+
+  Http::TestRequestHeaderMapImpl headers;
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration, filter_.decodeHeaders(headers, false));
+
+  Buffer::OwnedImpl data1("hello");
+  const void* memory1 = data1.frontSlice().mem_;
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_.decodeData(data1, false));
+  EXPECT_EQ(memory1, data1.frontSlice().mem_);
+
+  Buffer::OwnedImpl data2(" world");
+  const void* memory2 = data2.frontSlice().mem_;
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_.decodeData(data2, false));
+  EXPECT_NE(memory2, data2.frontSlice().mem_);
+  EXPECT_EQ(" world", data2.toString());
+
+  Http::TestRequestTrailerMapImpl trailers;
+  EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_.decodeTrailers(trailers));
+  EXPECT_EQ(headers.getContentLengthValue(), "11");
+  filter_.onDestroy();
+}
+#endif
+
+// The data is kept in memory when it cannot be spilled.
+TEST_F(BufferFilterTest, SpillDirectoryMissing) {
+  envoy::extensions::filters::http::buffer::v3::BufferPerRoute route_cfg;
+  auto* buf = route_cfg.mutable_buffer();
+  buf->mutable_max_request_bytes()->set_value(1024);
+  buf->mutable_spill()->set_directory(TestEnvironment::temporaryPath("buffer_filter_test/missing"));
+  buf->mutable_spill()->mutable_memory_bytes()->set_value(0);
+  BufferFilterSettings route_settings(route_cfg);
+  routeLocalConfig(&route_settings, nullptr);
+
+  Http::TestRequestHeaderMapImpl headers;
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration, filter_.decodeHeaders(headers, false));
+
+  Buffer::OwnedImpl data("hello");
+  const void* memory = data.frontSlice().mem_;
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_.decodeData(data, false));
+  EXPECT_EQ(memory, data.frontSlice().mem_);
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(data, true));
+}
+
 } // namespace BufferFilter
 } // namespace HttpFilters
 } // namespace Extensions
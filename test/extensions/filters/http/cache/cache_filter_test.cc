@@ -22,9 +22,9 @@ class CacheFilterTest : public ::testing::Test {
 protected:
   // The filter has to be created as a shared_ptr to enable shared_from_this() which is used in the
   // cache callbacks.
-  CacheFilterSharedPtr makeFilter(HttpCache& cache) {
+  CacheFilterSharedPtr makeFilter(HttpCache& cache, RequestCoalescerSharedPtr coalescer = nullptr) {
     auto filter = std::make_shared<CacheFilter>(config_, /*stats_prefix=*/"", context_.scope(),
-                                                context_.timeSource(), cache);
+                                                context_.timeSource(), cache, coalescer);
     filter->setDecoderFilterCallbacks(decoder_callbacks_);
     filter->setEncoderFilterCallbacks(encoder_callbacks_);
     return filter;
@@ -116,9 +116,9 @@ protected:
 
   void waitBeforeSecondRequest() { time_source_.advanceTimeWait(delay_); }
 
-  SimpleHttpCache simple_cache_;
   envoy::extensions::filters::http::cache::v3alpha::CacheConfig config_;
   NiceMock<Server::Configuration::MockFactoryContext> context_;
+  SimpleHttpCache simple_cache_{/*max_size_bytes=*/0, context_.scope()};
   Event::SimulatedTimeSystem time_source_;
   DateFormatter formatter_{"%a, %d %b %Y %H:%M:%S GMT"};
   Http::TestRequestHeaderMapImpl request_headers_{
@@ -245,6 +245,35 @@ TEST_F(CacheFilterTest, CacheHitWithBody) {
   }
 }
 
+// A response with trailers is not inserted in a cache which does not store trailers.
+TEST_F(CacheFilterTest, TrailersNotSupportedByCache) {
+  request_headers_.setHost("TrailersNotSupportedByCache");
+  const std::string body = "abc";
+
+  {
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+
+    testDecodeRequestMiss(filter);
+
+    Buffer::OwnedImpl buffer(body);
+    response_headers_.setContentLength(body.size());
+    Http::TestResponseTrailerMapImpl response_trailers{{"grpc-status", "0"}};
+    EXPECT_EQ(filter->encodeHeaders(response_headers_, false), Http::FilterHeadersStatus::Continue);
+    EXPECT_EQ(filter->encodeData(buffer, false), Http::FilterDataStatus::Continue);
+    EXPECT_EQ(filter->encodeTrailers(response_trailers), Http::FilterTrailersStatus::Continue);
+
+    filter->onDestroy();
+  }
+  waitBeforeSecondRequest();
+  {
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+
+    testDecodeRequestMiss(filter);
+
+    filter->onDestroy();
+  }
+}
+
 TEST_F(CacheFilterTest, SuccessfulValidation) {
   request_headers_.setHost("SuccessfulValidation");
   const std::string body = "abc";
@@ -608,6 +637,144 @@ TEST_F(CacheFilterTest, FilterDeletedBeforePostedCallbackExecuted) {
   }
 }
 
+TEST_F(CacheFilterTest, CoalescedCacheMiss) {
+  request_headers_.setHost("CoalescedCacheMiss");
+  config_.mutable_request_coalescing();
+  auto coalescer = std::make_shared<RequestCoalescer>();
+  const std::string body = "abc";
+
+  // Request 1 misses and is forwarded upstream.
+  CacheFilterSharedPtr filler = makeFilter(simple_cache_, coalescer);
+  testDecodeRequestMiss(filler);
+
+  // Request 2 misses while request 1 is in progress, so it waits for its response.
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> waiter_callbacks;
+  ON_CALL(waiter_callbacks, dispatcher()).WillByDefault(::testing::ReturnRef(*dispatcher_));
+  auto waiter = std::make_shared<CacheFilter>(config_, /*stats_prefix=*/"", context_.scope(),
+                                              context_.timeSource(), simple_cache_, coalescer);
+  waiter->setDecoderFilterCallbacks(waiter_callbacks);
+  EXPECT_CALL(waiter_callbacks, continueDecoding).Times(0);
+  EXPECT_EQ(waiter->decodeHeaders(request_headers_, true),
+            Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  // Request 2 is served the response of request 1 as it is encoded.
+  EXPECT_CALL(waiter_callbacks, encodeHeaders_(IsSupersetOfHeaders(response_headers_), false));
+  EXPECT_CALL(waiter_callbacks,
+              encodeData(testing::Property(&Buffer::Instance::toString, testing::Eq(body)), true));
+  response_headers_.setContentLength(body.size());
+  EXPECT_EQ(filler->encodeHeaders(response_headers_, false), Http::FilterHeadersStatus::Continue);
+  Buffer::OwnedImpl buffer(body);
+  EXPECT_EQ(filler->encodeData(buffer, true), Http::FilterDataStatus::Continue);
+  filler->onDestroy();
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&waiter_callbacks);
+  waiter->onDestroy();
+
+  // The fill is over, so the next request looks up the cache again and hits.
+  waitBeforeSecondRequest();
+  CacheFilterSharedPtr filter = makeFilter(simple_cache_, coalescer);
+  testDecodeRequestHitWithBody(filter, body);
+  filter->onDestroy();
+}
+
+TEST_F(CacheFilterTest, CoalescedCacheMissWithTrailers) {
+  request_headers_.setHost("CoalescedCacheMissWithTrailers");
+  config_.mutable_request_coalescing();
+  auto coalescer = std::make_shared<RequestCoalescer>();
+  const std::string body = "abc";
+
+  CacheFilterSharedPtr filler = makeFilter(simple_cache_, coalescer);
+  testDecodeRequestMiss(filler);
+
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> waiter_callbacks;
+  ON_CALL(waiter_callbacks, dispatcher()).WillByDefault(::testing::ReturnRef(*dispatcher_));
+  auto waiter = std::make_shared<CacheFilter>(config_, /*stats_prefix=*/"", context_.scope(),
+                                              context_.timeSource(), simple_cache_, coalescer);
+  waiter->setDecoderFilterCallbacks(waiter_callbacks);
+  EXPECT_EQ(waiter->decodeHeaders(request_headers_, true),
+            Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  // Request 2 is served the whole response of request 1, trailers included, instead of being
+  // reset when request 1 receives its trailers.
+  EXPECT_CALL(waiter_callbacks, encodeHeaders_(IsSupersetOfHeaders(response_headers_), false));
+  EXPECT_CALL(waiter_callbacks,
+              encodeData(testing::Property(&Buffer::Instance::toString, testing::Eq(body)), false));
+  EXPECT_CALL(waiter_callbacks, encodeTrailers_(testing::Property(
+                                    &Http::ResponseTrailerMap::getGrpcStatusValue, "0")));
+  EXPECT_CALL(waiter_callbacks, resetStream).Times(0);
+  EXPECT_CALL(waiter_callbacks, continueDecoding).Times(0);
+  EXPECT_EQ(filler->encodeHeaders(response_headers_, false), Http::FilterHeadersStatus::Continue);
+  Buffer::OwnedImpl buffer(body);
+  EXPECT_EQ(filler->encodeData(buffer, false), Http::FilterDataStatus::Continue);
+  Http::TestResponseTrailerMapImpl trailers{{"grpc-status", "0"}};
+  EXPECT_EQ(filler->encodeTrailers(trailers), Http::FilterTrailersStatus::Continue);
+  filler->onDestroy();
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&waiter_callbacks);
+  waiter->onDestroy();
+}
+
+TEST_F(CacheFilterTest, CoalescedRequestTimesOut) {
+  request_headers_.setHost("CoalescedRequestTimesOut");
+  config_.mutable_request_coalescing()->mutable_wait_timeout()->set_seconds(1);
+  auto coalescer = std::make_shared<RequestCoalescer>();
+
+  CacheFilterSharedPtr filler = makeFilter(simple_cache_, coalescer);
+  testDecodeRequestMiss(filler);
+
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> waiter_callbacks;
+  ON_CALL(waiter_callbacks, dispatcher()).WillByDefault(::testing::ReturnRef(*dispatcher_));
+  auto waiter = std::make_shared<CacheFilter>(config_, /*stats_prefix=*/"", context_.scope(),
+                                              context_.timeSource(), simple_cache_, coalescer);
+  waiter->setDecoderFilterCallbacks(waiter_callbacks);
+  EXPECT_EQ(waiter->decodeHeaders(request_headers_, true),
+            Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  // Request 2 stops waiting and is forwarded upstream once the timeout expires.
+  EXPECT_CALL(waiter_callbacks, continueDecoding);
+  time_source_.advanceTimeWait(std::chrono::seconds(1));
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  ::testing::Mock::VerifyAndClearExpectations(&waiter_callbacks);
+
+  // The response of request 1 is not served to request 2 anymore.
+  EXPECT_CALL(waiter_callbacks, encodeHeaders_).Times(0);
+  EXPECT_EQ(filler->encodeHeaders(response_headers_, true), Http::FilterHeadersStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  filler->onDestroy();
+  waiter->onDestroy();
+}
+
+TEST_F(CacheFilterTest, CoalescedRequestFallsBackOnUncacheableResponse) {
+  request_headers_.setHost("CoalescedRequestFallsBackOnUncacheableResponse");
+  config_.mutable_request_coalescing();
+  auto coalescer = std::make_shared<RequestCoalescer>();
+
+  CacheFilterSharedPtr filler = makeFilter(simple_cache_, coalescer);
+  testDecodeRequestMiss(filler);
+
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> waiter_callbacks;
+  ON_CALL(waiter_callbacks, dispatcher()).WillByDefault(::testing::ReturnRef(*dispatcher_));
+  auto waiter = std::make_shared<CacheFilter>(config_, /*stats_prefix=*/"", context_.scope(),
+                                              context_.timeSource(), simple_cache_, coalescer);
+  waiter->setDecoderFilterCallbacks(waiter_callbacks);
+  EXPECT_EQ(waiter->decodeHeaders(request_headers_, true),
+            Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  // A response that cannot be cached is not shared, so request 2 is forwarded upstream.
+  EXPECT_CALL(waiter_callbacks, encodeHeaders_).Times(0);
+  EXPECT_CALL(waiter_callbacks, continueDecoding);
+  response_headers_.setCopy(Http::Headers::get().CacheControl, "no-store");
+  EXPECT_EQ(filler->encodeHeaders(response_headers_, true), Http::FilterHeadersStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&waiter_callbacks);
+  filler->onDestroy();
+  waiter->onDestroy();
+}
+
 // A new type alias for a different type of tests that use the exact same class
 using ValidationHeadersTest = CacheFilterTest;
 
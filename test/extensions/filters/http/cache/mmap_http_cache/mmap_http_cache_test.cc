@@ -0,0 +1,362 @@
+#include <unistd.h>
+
+#include "envoy/http/header_map.h"
+#include "envoy/registry/registry.h"
+
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/filters/http/cache/cache_headers_utils.h"
+#include "extensions/filters/http/cache/mmap_http_cache/mmap_http_cache.h"
+
+#include "source/extensions/filters/http/cache/mmap_http_cache/config.pb.h"
+
+#include "test/extensions/filters/http/cache/common.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+constexpr uint64_t CacheSize = 1024 * 1024;
+
+envoy::extensions::filters::http::cache::v3alpha::CacheConfig getConfig() {
+  // Allows 'accept' to be varied in the tests.
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
+  const auto& add_accept = config.mutable_allowed_vary_headers()->Add();
+  add_accept->set_exact("accept");
+  return config;
+}
+
+class MmapHttpCacheTest : public testing::Test {
+protected:
+  MmapHttpCacheTest()
+      : path_(TestEnvironment::temporaryPath(
+            testing::UnitTest::GetInstance()->current_test_info()->name())),
+        vary_allow_list_(getConfig().allowed_vary_headers()) {
+    ::unlink(path_.c_str());
+    cache_ = std::make_unique<MmapHttpCache>(path_, CacheSize);
+    request_headers_.setMethod("GET");
+    request_headers_.setHost("example.com");
+    request_headers_.setForwardedProto("https");
+    request_headers_.setCopy(Http::CustomHeaders::get().CacheControl, "max-age=3600");
+  }
+
+  ~MmapHttpCacheTest() override {
+    cache_.reset();
+    ::unlink(path_.c_str());
+  }
+
+  // Performs a cache lookup.
+  LookupContextPtr lookup(absl::string_view request_path, MmapHttpCache* cache = nullptr) {
+    LookupRequest request = makeLookupRequest(request_path);
+    LookupContextPtr context =
+        (cache ? cache : cache_.get())->makeLookupContext(std::move(request));
+    context->getHeaders([this](LookupResult&& result) { lookup_result_ = std::move(result); });
+    return context;
+  }
+
+  // Inserts a value into the cache.
+  void insert(LookupContextPtr lookup, const Http::TestResponseHeaderMapImpl& response_headers,
+              const absl::string_view response_body) {
+    InsertContextPtr inserter = cache_->makeInsertContext(move(lookup));
+    const ResponseMetadata metadata = {current_time_};
+    inserter->insertHeaders(response_headers, metadata, false);
+    inserter->insertBody(Buffer::OwnedImpl(response_body), nullptr, true);
+  }
+
+  void insert(absl::string_view request_path, absl::string_view response_body) {
+    insert(lookup(request_path), response_headers_, response_body);
+  }
+
+  Buffer::InstancePtr getBodyBuffer(LookupContext& context, uint64_t start, uint64_t end) {
+    AdjustedByteRange range(start, end);
+    Buffer::InstancePtr body;
+    context.getBody(range, [&body](Buffer::InstancePtr&& data) { body = std::move(data); });
+    EXPECT_NE(body, nullptr);
+    return body;
+  }
+
+  std::string getBody(LookupContext& context, uint64_t start, uint64_t end) {
+    Buffer::InstancePtr body = getBodyBuffer(context, start, end);
+    return body ? body->toString() : "";
+  }
+
+  LookupRequest makeLookupRequest(absl::string_view request_path) {
+    request_headers_.setPath(request_path);
+    return LookupRequest(request_headers_, current_time_, vary_allow_list_);
+  }
+
+  AssertionResult expectLookupSuccessWithBody(LookupContext* lookup_context,
+                                              absl::string_view body) {
+    if (lookup_result_.cache_entry_status_ != CacheEntryStatus::Ok) {
+      return AssertionFailure() << "Expected: lookup_result_.cache_entry_status == "
+                                   "CacheEntryStatus::Ok\n  Actual: "
+                                << lookup_result_.cache_entry_status_;
+    }
+    if (!lookup_result_.headers_) {
+      return AssertionFailure() << "Expected nonnull lookup_result_.headers";
+    }
+    if (lookup_result_.content_length_ != body.size()) {
+      return AssertionFailure() << "Expected content length " << body.size()
+                                << "\n  Actual: " << lookup_result_.content_length_;
+    }
+    const std::string actual_body = getBody(*lookup_context, 0, body.size());
+    if (body != actual_body) {
+      return AssertionFailure() << "Expected body == " << body << "\n  Actual:  " << actual_body;
+    }
+    return AssertionSuccess();
+  }
+
+  const std::string path_;
+  std::unique_ptr<MmapHttpCache> cache_;
+  LookupResult lookup_result_;
+  Http::TestRequestHeaderMapImpl request_headers_;
+  Event::SimulatedTimeSystem time_source_;
+  SystemTime current_time_ = time_source_.systemTime();
+  DateFormatter formatter_{"%a, %d %b %Y %H:%M:%S GMT"};
+  Http::TestResponseHeaderMapImpl response_headers_{{"date", formatter_.fromTime(current_time_)},
+                                                    {"cache-control", "public,max-age=3600"}};
+  VaryHeader vary_allow_list_;
+};
+
+// Simple flow of putting in an item, getting it, replacing it.
+TEST_F(MmapHttpCacheTest, PutGet) {
+  const std::string RequestPath1("Name");
+  LookupContextPtr name_lookup_context = lookup(RequestPath1);
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+
+  const std::string Body1("Value");
+  insert(move(name_lookup_context), response_headers_, Body1);
+  name_lookup_context = lookup(RequestPath1);
+  EXPECT_TRUE(expectLookupSuccessWithBody(name_lookup_context.get(), Body1));
+
+  const std::string& RequestPath2("Another Name");
+  LookupContextPtr another_name_lookup_context = lookup(RequestPath2);
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+
+  const std::string NewBody1("NewValue");
+  insert(move(name_lookup_context), response_headers_, NewBody1);
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup(RequestPath1).get(), NewBody1));
+}
+
+TEST_F(MmapHttpCacheTest, Miss) {
+  LookupContextPtr name_lookup_context = lookup("Name");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+}
+
+TEST_F(MmapHttpCacheTest, StreamingPut) {
+  InsertContextPtr inserter = cache_->makeInsertContext(lookup("request_path"));
+  const ResponseMetadata metadata = {current_time_};
+  inserter->insertHeaders(response_headers_, metadata, false);
+  inserter->insertBody(
+      Buffer::OwnedImpl("Hello, "), [](bool ready) { EXPECT_TRUE(ready); }, false);
+  inserter->insertBody(Buffer::OwnedImpl("World!"), nullptr, true);
+  LookupContextPtr name_lookup_context = lookup("request_path");
+  EXPECT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+  EXPECT_NE(nullptr, lookup_result_.headers_);
+  ASSERT_EQ(13, lookup_result_.content_length_);
+  EXPECT_EQ("Hello, World!", getBody(*name_lookup_context, 0, 13));
+}
+
+// A body spanning several slabs is read in place, in ranges.
+TEST_F(MmapHttpCacheTest, LargeBody) {
+  std::string body;
+  for (uint32_t i = 0; body.size() < 3 * MmapHttpCache::SlabSize; ++i) {
+    body += std::to_string(i);
+  }
+  insert("large", body);
+  LookupContextPtr context = lookup("large");
+  EXPECT_TRUE(expectLookupSuccessWithBody(context.get(), body));
+
+  const uint64_t start = MmapHttpCache::SlabSize - 10;
+  const uint64_t end = 2 * MmapHttpCache::SlabSize + 10;
+  Buffer::InstancePtr range = getBodyBuffer(*context, start, end);
+  EXPECT_EQ(body.substr(start, end - start), range->toString());
+  EXPECT_LT(1, range->getRawSlices().size());
+}
+
+// The body read from an entry stays valid after the entry is replaced, and its slabs are freed
+// once it is released.
+TEST_F(MmapHttpCacheTest, BodyOutlivesEntry) {
+  const uint32_t num_free_slabs = cache_->numFreeSlabs();
+  insert("name", "first");
+  LookupContextPtr context = lookup("name");
+  Buffer::InstancePtr body = getBodyBuffer(*context, 0, 5);
+  context.reset();
+
+  insert("name", "second");
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("name").get(), "second"));
+  EXPECT_EQ("first", body->toString());
+  EXPECT_EQ(num_free_slabs - 2, cache_->numFreeSlabs());
+  body.reset();
+  EXPECT_EQ(num_free_slabs - 1, cache_->numFreeSlabs());
+}
+
+// Inserting more than the cache holds evicts entries.
+TEST_F(MmapHttpCacheTest, Eviction) {
+  const std::string body(MmapHttpCache::SlabSize, 'a');
+  const uint32_t num_entries = 2 * cache_->numSlabs();
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    insert(absl::StrCat("name", i), body);
+  }
+  EXPECT_TRUE(
+      expectLookupSuccessWithBody(lookup(absl::StrCat("name", num_entries - 1)).get(), body));
+  lookup("name0");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+}
+
+// A response larger than the cache is not inserted.
+TEST_F(MmapHttpCacheTest, TooLarge) {
+  const std::string chunk(MmapHttpCache::SlabSize, 'a');
+  InsertContextPtr inserter = cache_->makeInsertContext(lookup("large"));
+  inserter->insertHeaders(response_headers_, {current_time_}, false);
+  bool ready = true;
+  while (ready) {
+    inserter->insertBody(
+        Buffer::OwnedImpl(chunk),
+        [&ready](bool ready_for_next_chunk) { ready = ready_for_next_chunk; }, false);
+  }
+  inserter.reset();
+  EXPECT_EQ(cache_->numSlabs(), cache_->numFreeSlabs());
+  lookup("large");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+}
+
+// The caches opening the same file share its entries.
+TEST_F(MmapHttpCacheTest, Shared) {
+  MmapHttpCache other(path_, CacheSize);
+  insert("name", "value");
+  LookupContextPtr context = lookup("name", &other);
+  EXPECT_TRUE(expectLookupSuccessWithBody(context.get(), "value"));
+  EXPECT_THROW(MmapHttpCache(path_, 2 * CacheSize), EnvoyException);
+}
+
+// The entries survive the cache being closed and opened again, and the slabs that were pinned
+// when the cache was closed are freed.
+TEST_F(MmapHttpCacheTest, Reopen) {
+  insert("name", "value");
+  insert("other", "other value");
+  // Simulates a process that dies holding a reference on the entry that is then replaced.
+  ASSERT_NE(MmapHttpCache::NoSlab, cache_->lookup(makeLookupRequest("name").key()));
+  insert("name", "new value");
+  const uint32_t num_free_slabs = cache_->numFreeSlabs();
+
+  cache_.reset();
+  cache_ = std::make_unique<MmapHttpCache>(path_, CacheSize);
+  EXPECT_EQ(num_free_slabs + 1, cache_->numFreeSlabs());
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("name").get(), "new value"));
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("other").get(), "other value"));
+}
+
+// The trailers of a response are stored after its body.
+TEST_F(MmapHttpCacheTest, Trailers) {
+  InsertContextPtr inserter = cache_->makeInsertContext(lookup("request_path"));
+  inserter->insertHeaders(response_headers_, {current_time_}, false);
+  inserter->insertBody(
+      Buffer::OwnedImpl("body"), [](bool ready) { EXPECT_TRUE(ready); }, false);
+  inserter->insertTrailers(Http::TestResponseTrailerMapImpl{{"grpc-status", "0"}});
+
+  LookupContextPtr context = lookup("request_path");
+  EXPECT_TRUE(expectLookupSuccessWithBody(context.get(), "body"));
+  ASSERT_TRUE(lookup_result_.has_trailers_);
+  Http::ResponseTrailerMapPtr trailers;
+  context->getTrailers(
+      [&trailers](Http::ResponseTrailerMapPtr&& result) { trailers = std::move(result); });
+  ASSERT_NE(nullptr, trailers);
+  EXPECT_EQ("0", trailers->getGrpcStatusValue());
+
+  lookup("other_path");
+  EXPECT_FALSE(lookup_result_.has_trailers_);
+}
+
+// Updating the headers of an entry keeps its body and its trailers, and leaves the entry alone if
+// it was replaced since the lookup.
+TEST_F(MmapHttpCacheTest, UpdateHeaders) {
+  InsertContextPtr inserter = cache_->makeInsertContext(lookup("name"));
+  inserter->insertHeaders(response_headers_, {current_time_}, false);
+  inserter->insertBody(
+      Buffer::OwnedImpl("value"), [](bool ready) { EXPECT_TRUE(ready); }, false);
+  inserter->insertTrailers(Http::TestResponseTrailerMapImpl{{"grpc-status", "0"}});
+  const uint32_t num_free_slabs = cache_->numFreeSlabs();
+
+  Http::TestResponseHeaderMapImpl updated_headers = response_headers_;
+  updated_headers.setCopy(Http::CustomHeaders::get().Etag, "\"v2\"");
+  cache_->updateHeaders(*lookup("name"), updated_headers, {current_time_});
+  EXPECT_EQ(num_free_slabs, cache_->numFreeSlabs());
+
+  LookupContextPtr context = lookup("name");
+  EXPECT_TRUE(expectLookupSuccessWithBody(context.get(), "value"));
+  const auto etag = lookup_result_.headers_->get(Http::CustomHeaders::get().Etag);
+  ASSERT_EQ(1U, etag.size());
+  EXPECT_EQ("\"v2\"", etag[0]->value().getStringView());
+  EXPECT_TRUE(lookup_result_.has_trailers_);
+
+  // The entry is replaced after the lookup, whose update is then dropped.
+  insert("name", "new value");
+  updated_headers.setCopy(Http::CustomHeaders::get().Etag, "\"v3\"");
+  cache_->updateHeaders(*context, updated_headers, {current_time_});
+  context = lookup("name");
+  EXPECT_TRUE(expectLookupSuccessWithBody(context.get(), "new value"));
+  EXPECT_TRUE(lookup_result_.headers_->get(Http::CustomHeaders::get().Etag).empty());
+}
+
+TEST_F(MmapHttpCacheTest, VaryResponses) {
+  // Responses will vary on accept.
+  const std::string RequestPath("some-resource");
+  Http::TestResponseHeaderMapImpl response_headers{{"date", formatter_.fromTime(current_time_)},
+                                                   {"cache-control", "public,max-age=3600"},
+                                                   {"vary", "accept"}};
+
+  // First request.
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "image/*");
+  LookupContextPtr first_value_vary = lookup(RequestPath);
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+  const std::string Body1("accept is image/*");
+  insert(move(first_value_vary), response_headers, Body1);
+  first_value_vary = lookup(RequestPath);
+  EXPECT_TRUE(expectLookupSuccessWithBody(first_value_vary.get(), Body1));
+
+  // Second request with a different value for the varied header.
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "text/html");
+  LookupContextPtr second_value_vary = lookup(RequestPath);
+  // Should miss because we don't have this version of the response saved yet.
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+  // Add second version and make sure we receive the correct one..
+  const std::string Body2("accept is text/html");
+  insert(move(second_value_vary), response_headers, Body2);
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup(RequestPath).get(), Body2));
+
+  // Looks up first version again to be sure it wasn't replaced with the second one.
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "image/*");
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup(RequestPath).get(), Body1));
+}
+
+TEST(Registration, GetFactory) {
+  const std::string path = TestEnvironment::temporaryPath("mmap_http_cache_registration");
+  ::unlink(path.c_str());
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.source.extensions.filters.http.cache.MmapHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  envoy::source::extensions::filters::http::cache::MmapHttpCacheConfig mmap_config;
+  mmap_config.set_path(path);
+  mmap_config.set_size_bytes(CacheSize);
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
+  config.mutable_typed_config()->PackFrom(mmap_config);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  HttpCacheSharedPtr cache = factory->getCache(config, context);
+  EXPECT_EQ(cache->cacheInfo().name_, "envoy.extensions.http.cache.mmap");
+  EXPECT_EQ(cache, factory->getCache(config, context));
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
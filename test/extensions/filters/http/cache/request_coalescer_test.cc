@@ -0,0 +1,128 @@
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/filters/http/cache/request_coalescer.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+using testing::_;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+Key makeKey(const std::string& path) {
+  Key key;
+  key.set_host("example.com");
+  key.set_path(path);
+  return key;
+}
+
+TEST(RequestCoalescerTest, JoinStartsOneFillPerKey) {
+  RequestCoalescer coalescer;
+  const auto first = coalescer.join(makeKey("/a"));
+  EXPECT_TRUE(first.second);
+  const auto second = coalescer.join(makeKey("/a"));
+  EXPECT_FALSE(second.second);
+  EXPECT_EQ(first.first, second.first);
+  EXPECT_TRUE(coalescer.join(makeKey("/b")).second);
+
+  // Removing the fill of a key lets the next request start another one.
+  coalescer.remove(makeKey("/a"), first.first);
+  const auto third = coalescer.join(makeKey("/a"));
+  EXPECT_TRUE(third.second);
+  EXPECT_NE(first.first, third.first);
+
+  // A stale fill does not remove the current one.
+  coalescer.remove(makeKey("/a"), first.first);
+  EXPECT_FALSE(coalescer.join(makeKey("/a")).second);
+}
+
+TEST(RequestCoalescerTest, WaitersReadTheResponseAsItProgresses) {
+  RequestCoalescer::Fill fill;
+  Event::MockDispatcher dispatcher;
+  int notifications = 0;
+  EXPECT_CALL(dispatcher, post(_)).WillRepeatedly([](std::function<void()> cb) { cb(); });
+  const uint64_t id = fill.addWaiter(dispatcher, [&notifications]() { notifications++; });
+
+  RequestCoalescer::Fill::Progress progress = fill.read(false, 0);
+  EXPECT_EQ(progress.headers_, nullptr);
+  EXPECT_EQ(progress.body_, nullptr);
+  EXPECT_FALSE(progress.end_stream_);
+
+  fill.onHeaders(Http::TestResponseHeaderMapImpl{{":status", "200"}}, false);
+  EXPECT_EQ(notifications, 1);
+  fill.onData(Buffer::OwnedImpl("abc"), false);
+  EXPECT_EQ(notifications, 2);
+
+  progress = fill.read(false, 0);
+  ASSERT_NE(progress.headers_, nullptr);
+  EXPECT_EQ(progress.headers_->getStatusValue(), "200");
+  EXPECT_EQ(progress.body_->toString(), "abc");
+  EXPECT_FALSE(progress.end_stream_);
+
+  fill.onData(Buffer::OwnedImpl("de"), true);
+  EXPECT_EQ(notifications, 3);
+  progress = fill.read(true, 3);
+  EXPECT_EQ(progress.headers_, nullptr);
+  EXPECT_EQ(progress.body_->toString(), "de");
+  EXPECT_TRUE(progress.end_stream_);
+
+  // Aborting a complete fill has no effect.
+  fill.abort();
+  EXPECT_EQ(notifications, 3);
+  EXPECT_FALSE(fill.read(true, 5).aborted_);
+  fill.removeWaiter(id);
+}
+
+TEST(RequestCoalescerTest, TrailersCompleteTheFill) {
+  RequestCoalescer::Fill fill;
+  Event::MockDispatcher dispatcher;
+  int notifications = 0;
+  EXPECT_CALL(dispatcher, post(_)).WillRepeatedly([](std::function<void()> cb) { cb(); });
+  const uint64_t id = fill.addWaiter(dispatcher, [&notifications]() { notifications++; });
+
+  fill.onHeaders(Http::TestResponseHeaderMapImpl{{":status", "200"}}, false);
+  fill.onData(Buffer::OwnedImpl("abc"), false);
+  RequestCoalescer::Fill::Progress progress = fill.read(false, 0);
+  EXPECT_EQ(progress.trailers_, nullptr);
+  EXPECT_FALSE(progress.end_stream_);
+
+  fill.onTrailers(Http::TestResponseTrailerMapImpl{{"grpc-status", "0"}});
+  EXPECT_EQ(notifications, 3);
+  progress = fill.read(true, 3);
+  EXPECT_EQ(progress.body_->toString(), "");
+  ASSERT_NE(progress.trailers_, nullptr);
+  EXPECT_EQ(progress.trailers_->getGrpcStatusValue(), "0");
+  EXPECT_TRUE(progress.end_stream_);
+
+  // The trailers complete the fill, so aborting it has no effect.
+  fill.abort();
+  EXPECT_EQ(notifications, 3);
+  EXPECT_FALSE(fill.read(true, 3).aborted_);
+  fill.removeWaiter(id);
+}
+
+TEST(RequestCoalescerTest, AbortNotifiesTheWaiters) {
+  RequestCoalescer::Fill fill;
+  Event::MockDispatcher dispatcher;
+  int notifications = 0;
+  EXPECT_CALL(dispatcher, post(_)).WillRepeatedly([](std::function<void()> cb) { cb(); });
+  const uint64_t removed = fill.addWaiter(dispatcher, []() { FAIL(); });
+  fill.addWaiter(dispatcher, [&notifications]() { notifications++; });
+  fill.removeWaiter(removed);
+
+  fill.abort();
+  EXPECT_EQ(notifications, 1);
+  EXPECT_TRUE(fill.read(false, 0).aborted_);
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -2,11 +2,13 @@
 #include "envoy/registry/registry.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/stats/isolated_store_impl.h"
 
 #include "extensions/filters/http/cache/cache_headers_utils.h"
 #include "extensions/filters/http/cache/simple_http_cache/simple_http_cache.h"
 
 #include "test/extensions/filters/http/cache/common.h"
+#include "test/mocks/server/factory_context.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
@@ -97,7 +99,16 @@ protected:
     return AssertionSuccess();
   }
 
-  SimpleHttpCache cache_;
+  uint64_t gauge(const std::string& name) {
+    return stats_store_.gauge("simple_http_cache." + name, Stats::Gauge::ImportMode::NeverImport)
+        .value();
+  }
+  uint64_t counter(const std::string& name) {
+    return stats_store_.counter("simple_http_cache." + name).value();
+  }
+
+  Stats::IsolatedStoreImpl stats_store_;
+  SimpleHttpCache cache_{/*max_size_bytes=*/0, stats_store_};
   LookupResult lookup_result_;
   Http::TestRequestHeaderMapImpl request_headers_;
   Event::SimulatedTimeSystem time_source_;
@@ -224,7 +235,11 @@ TEST(Registration, GetFactory) {
   ASSERT_NE(factory, nullptr);
   envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
   config.mutable_typed_config()->PackFrom(*factory->createEmptyConfigProto());
-  EXPECT_EQ(factory->getCache(config).cacheInfo().name_, "envoy.extensions.http.cache.simple");
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  HttpCacheSharedPtr cache = factory->getCache(config, context);
+  EXPECT_EQ(cache->cacheInfo().name_, "envoy.extensions.http.cache.simple");
+  // The filters of a server share the cache.
+  EXPECT_EQ(cache, factory->getCache(config, context));
 }
 
 TEST_F(SimpleHttpCacheTest, VaryResponses) {
@@ -257,6 +272,101 @@ TEST_F(SimpleHttpCacheTest, VaryResponses) {
   EXPECT_TRUE(expectLookupSuccessWithBody(first_value_vary.get(), Body1));
 }
 
+TEST_F(SimpleHttpCacheTest, VaryChange) {
+  const std::string RequestPath("some-resource");
+  Http::TestResponseHeaderMapImpl response_headers{{"date", formatter_.fromTime(current_time_)},
+                                                   {"cache-control", "public,max-age=3600"},
+                                                   {"vary", "accept"}};
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "image/*");
+  insert(RequestPath, response_headers, "varied");
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup(RequestPath).get(), "varied"));
+
+  // A response that does not vary replaces the variants.
+  response_headers.remove(Http::LowerCaseString("vary"));
+  insert(RequestPath, response_headers, "not varied");
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "text/html");
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup(RequestPath).get(), "not varied"));
+  EXPECT_EQ(gauge("entries"), 1);
+}
+
+TEST_F(SimpleHttpCacheTest, Stats) {
+  const std::string Body("Value");
+  Http::TestResponseHeaderMapImpl response_headers{{"date", formatter_.fromTime(current_time_)},
+                                                   {"cache-control", "public,max-age=3600"}};
+  insert("name", response_headers, Body);
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("name").get(), Body));
+  EXPECT_EQ(counter("misses"), 1);
+  EXPECT_EQ(counter("hits"), 1);
+  EXPECT_EQ(counter("inserts"), 1);
+  EXPECT_EQ(gauge("entries"), 1);
+  EXPECT_GT(gauge("bytes_stored"), Body.size());
+
+  // Replacing a response does not add an entry.
+  insert("name", response_headers, Body);
+  EXPECT_EQ(gauge("entries"), 1);
+  EXPECT_EQ(counter("evictions"), 0);
+}
+
+class BoundedSimpleHttpCacheTest : public SimpleHttpCacheTest {
+protected:
+  // Room for two of the responses.
+  BoundedSimpleHttpCacheTest() : bounded_cache_(2500, stats_store_) {}
+
+  void insertResponse(absl::string_view request_path) {
+    InsertContextPtr inserter = bounded_cache_.makeInsertContext(lookupResponse(request_path));
+    inserter->insertHeaders(response_headers_, ResponseMetadata{current_time_}, false);
+    inserter->insertBody(Buffer::OwnedImpl(body_), nullptr, true);
+  }
+
+  LookupContextPtr lookupResponse(absl::string_view request_path) {
+    LookupContextPtr context = bounded_cache_.makeLookupContext(makeLookupRequest(request_path));
+    context->getHeaders([this](LookupResult&& result) { lookup_result_ = std::move(result); });
+    return context;
+  }
+
+  bool cached(absl::string_view request_path) {
+    lookupResponse(request_path);
+    return lookup_result_.cache_entry_status_ == CacheEntryStatus::Ok;
+  }
+
+  const std::string body_ = std::string(1000, 'a');
+  Http::TestResponseHeaderMapImpl response_headers_{{"date", formatter_.fromTime(current_time_)},
+                                                    {"cache-control", "public,max-age=3600"}};
+  SimpleHttpCache bounded_cache_;
+};
+
+TEST_F(BoundedSimpleHttpCacheTest, EvictsLeastRecentlyUsed) {
+  insertResponse("a");
+  insertResponse("b");
+  EXPECT_EQ(counter("evictions"), 0);
+  insertResponse("c");
+  EXPECT_EQ(counter("evictions"), 1);
+  EXPECT_FALSE(cached("a"));
+  EXPECT_TRUE(cached("b"));
+  EXPECT_TRUE(cached("c"));
+  EXPECT_EQ(gauge("entries"), 2);
+  EXPECT_LE(gauge("bytes_stored"), 2500);
+}
+
+TEST_F(BoundedSimpleHttpCacheTest, HitsProtectResponses) {
+  insertResponse("a");
+  insertResponse("b");
+  // The hit moves a to the protected segment, so b, which was inserted later, is evicted first.
+  EXPECT_TRUE(cached("a"));
+  insertResponse("c");
+  EXPECT_TRUE(cached("a"));
+  EXPECT_FALSE(cached("b"));
+  EXPECT_TRUE(cached("c"));
+}
+
+TEST_F(BoundedSimpleHttpCacheTest, TooLargeResponseIsNotCached) {
+  InsertContextPtr inserter = bounded_cache_.makeInsertContext(lookupResponse("large"));
+  inserter->insertHeaders(response_headers_, ResponseMetadata{current_time_}, false);
+  inserter->insertBody(Buffer::OwnedImpl(std::string(3000, 'a')), nullptr, true);
+  EXPECT_FALSE(cached("large"));
+  EXPECT_EQ(counter("inserts"), 0);
+}
+
 } // namespace
 } // namespace Cache
 } // namespace HttpFilters
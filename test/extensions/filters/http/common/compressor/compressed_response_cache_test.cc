@@ -0,0 +1,67 @@
+#include "extensions/filters/http/common/compressor/compressed_response_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Common {
+namespace Compressors {
+namespace {
+
+TEST(CompressedResponseCacheTest, LookupInsertedBody) {
+  CompressedResponseCache cache(1024, 512, false);
+  EXPECT_EQ(nullptr, cache.lookup("key"));
+
+  cache.insert("key", "body");
+  CompressedResponseCache::Body body = cache.lookup("key");
+  ASSERT_NE(nullptr, body);
+  EXPECT_EQ("body", *body);
+  EXPECT_EQ(7, cache.sizeBytes());
+  EXPECT_EQ(512, cache.maxBodyBytes());
+  EXPECT_FALSE(cache.keyByContentHash());
+}
+
+TEST(CompressedResponseCacheTest, ReplaceBody) {
+  CompressedResponseCache cache(1024, 512, true);
+  cache.insert("key", "body");
+  CompressedResponseCache::Body old_body = cache.lookup("key");
+  cache.insert("key", "new body");
+
+  EXPECT_EQ("new body", *cache.lookup("key"));
+  // A body looked up before being replaced stays valid.
+  EXPECT_EQ("body", *old_body);
+  EXPECT_EQ(11, cache.sizeBytes());
+}
+
+TEST(CompressedResponseCacheTest, EvictLeastRecentlyUsed) {
+  CompressedResponseCache cache(30, 512, false);
+  cache.insert("a", std::string(9, 'a'));
+  cache.insert("b", std::string(9, 'b'));
+  cache.insert("c", std::string(9, 'c'));
+  EXPECT_EQ(30, cache.sizeBytes());
+
+  // Using "a" makes "b" the least recently used.
+  EXPECT_NE(nullptr, cache.lookup("a"));
+  cache.insert("d", std::string(9, 'd'));
+  EXPECT_EQ(nullptr, cache.lookup("b"));
+  EXPECT_NE(nullptr, cache.lookup("a"));
+  EXPECT_NE(nullptr, cache.lookup("c"));
+  EXPECT_NE(nullptr, cache.lookup("d"));
+  EXPECT_EQ(30, cache.sizeBytes());
+}
+
+TEST(CompressedResponseCacheTest, SkipBodyLargerThanCache) {
+  CompressedResponseCache cache(30, 512, false);
+  cache.insert("a", std::string(9, 'a'));
+  cache.insert("b", std::string(30, 'b'));
+  EXPECT_EQ(nullptr, cache.lookup("b"));
+  EXPECT_NE(nullptr, cache.lookup("a"));
+}
+
+} // namespace
+} // namespace Compressors
+} // namespace Common
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -1,6 +1,8 @@
 #include "envoy/extensions/filters/http/compressor/v3/compressor.pb.h"
 
+#include "extensions/compression/brotli/compressor/brotli_compressor_impl.h"
 #include "extensions/compression/gzip/compressor/zlib_compressor_impl.h"
+#include "extensions/compression/zstd/compressor/zstd_compressor_impl.h"
 #include "extensions/filters/http/common/compressor/compressor.h"
 
 #include "test/mocks/http/mocks.h"
@@ -18,30 +20,23 @@ namespace HttpFilters {
 namespace Common {
 namespace Compressors {
 
+using MakeCompressorFn = std::function<Envoy::Compression::Compressor::CompressorPtr()>;
+
 class MockCompressorFilterConfig : public CompressorFilterConfig {
 public:
   MockCompressorFilterConfig(
       const envoy::extensions::filters::http::compressor::v3::Compressor& compressor,
       const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
-      const std::string& compressor_name,
-      Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionLevel level,
-      Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionStrategy strategy,
-      int64_t window_bits, uint64_t memory_level)
-      : CompressorFilterConfig(compressor, stats_prefix + compressor_name + ".", scope, runtime,
-                               compressor_name),
-        level_(level), strategy_(strategy), window_bits_(window_bits), memory_level_(memory_level) {
-  }
+      const std::string& content_encoding, MakeCompressorFn make_compressor)
+      : CompressorFilterConfig(compressor, stats_prefix + content_encoding + ".", scope, runtime,
+                               content_encoding),
+        make_compressor_(std::move(make_compressor)) {}
 
   Envoy::Compression::Compressor::CompressorPtr makeCompressor() override {
-    auto compressor = std::make_unique<Compression::Gzip::Compressor::ZlibCompressorImpl>();
-    compressor->init(level_, strategy_, window_bits_, memory_level_);
-    return compressor;
+    return make_compressor_();
   }
 
-  const Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionLevel level_;
-  const Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionStrategy strategy_;
-  const int64_t window_bits_;
-  const uint64_t memory_level_;
+  const MakeCompressorFn make_compressor_;
 };
 
 using CompressionParams =
@@ -49,6 +44,30 @@ using CompressionParams =
                Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionStrategy, int64_t,
                uint64_t>;
 
+MakeCompressorFn gzipCompressor(const CompressionParams& params) {
+  return [params]() {
+    auto compressor = std::make_unique<Compression::Gzip::Compressor::ZlibCompressorImpl>();
+    compressor->init(std::get<0>(params), std::get<1>(params), std::get<2>(params),
+                     std::get<3>(params));
+    return compressor;
+  };
+}
+
+MakeCompressorFn brotliCompressor(uint32_t quality) {
+  return [quality]() {
+    return std::make_unique<Compression::Brotli::Compressor::BrotliCompressorImpl>(
+        quality, 18, 24, false,
+        Compression::Brotli::Compressor::BrotliCompressorImpl::EncoderMode::Default, 4096);
+  };
+}
+
+MakeCompressorFn zstdCompressor(uint32_t compression_level) {
+  return [compression_level]() {
+    return std::make_unique<Compression::Zstd::Compressor::ZstdCompressorImpl>(compression_level,
+                                                                               false, 4096);
+  };
+}
+
 static constexpr uint64_t TestDataSize = 122880;
 
 Buffer::OwnedImpl generateTestData() {
@@ -88,7 +107,8 @@ struct Result {
   uint64_t total_compressed_bytes = 0;
 };
 
-static Result compressWith(std::vector<Buffer::OwnedImpl>&& chunks, CompressionParams params,
+static Result compressWith(std::vector<Buffer::OwnedImpl>&& chunks,
+                           const std::string& content_encoding, MakeCompressorFn make_compressor,
                            NiceMock<Http::MockStreamDecoderFilterCallbacks>& decoder_callbacks,
                            benchmark::State& state) {
   auto start = std::chrono::high_resolution_clock::now();
@@ -96,12 +116,8 @@ static Result compressWith(std::vector<Buffer::OwnedImpl>&& chunks, CompressionP
   testing::NiceMock<Runtime::MockLoader> runtime;
   envoy::extensions::filters::http::compressor::v3::Compressor compressor;
 
-  const auto level = std::get<0>(params);
-  const auto strategy = std::get<1>(params);
-  const auto window_bits = std::get<2>(params);
-  const auto memory_level = std::get<3>(params);
   CompressorFilterConfigSharedPtr config = std::make_shared<MockCompressorFilterConfig>(
-      compressor, "test.", stats, runtime, "gzip", level, strategy, window_bits, memory_level);
+      compressor, "test.", stats, runtime, content_encoding, std::move(make_compressor));
 
   ON_CALL(runtime.snapshot_, featureEnabled("test.filter_enabled", 100))
       .WillByDefault(Return(true));
@@ -109,7 +125,8 @@ static Result compressWith(std::vector<Buffer::OwnedImpl>&& chunks, CompressionP
   auto filter = std::make_unique<CompressorFilter>(config);
   filter->setDecoderFilterCallbacks(decoder_callbacks);
 
-  Http::TestRequestHeaderMapImpl headers = {{":method", "get"}, {"accept-encoding", "gzip"}};
+  Http::TestRequestHeaderMapImpl headers = {{":method", "get"},
+                                            {"accept-encoding", content_encoding}};
   filter->decodeHeaders(headers, false);
 
   Http::TestResponseHeaderMapImpl response_headers = {
@@ -133,12 +150,13 @@ static Result compressWith(std::vector<Buffer::OwnedImpl>&& chunks, CompressionP
     ++idx;
   }
 
+  const std::string stats_prefix = "test." + content_encoding + ".";
   EXPECT_EQ(res.total_uncompressed_bytes,
-            stats.counterFromString("test.gzip.total_uncompressed_bytes").value());
+            stats.counterFromString(stats_prefix + "total_uncompressed_bytes").value());
   EXPECT_EQ(res.total_compressed_bytes,
-            stats.counterFromString("test.gzip.total_compressed_bytes").value());
+            stats.counterFromString(stats_prefix + "total_compressed_bytes").value());
 
-  EXPECT_EQ(1U, stats.counterFromString("test.gzip.compressed").value());
+  EXPECT_EQ(1U, stats.counterFromString(stats_prefix + "compressed").value());
   auto end = std::chrono::high_resolution_clock::now();
   const auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
   state.SetIterationTime(elapsed.count());
@@ -233,7 +251,7 @@ static void compressFull(benchmark::State& state) {
 
   for (auto _ : state) {
     std::vector<Buffer::OwnedImpl> chunks = generateChunks(1, 122880);
-    compressWith(std::move(chunks), params, decoder_callbacks, state);
+    compressWith(std::move(chunks), "gzip", gzipCompressor(params), decoder_callbacks, state);
   }
 }
 BENCHMARK(compressFull)->DenseRange(0, 8, 1)->UseManualTime()->Unit(benchmark::kMillisecond);
@@ -245,7 +263,7 @@ static void compressChunks16384(benchmark::State& state) {
 
   for (auto _ : state) {
     std::vector<Buffer::OwnedImpl> chunks = generateChunks(7, 16384);
-    compressWith(std::move(chunks), params, decoder_callbacks, state);
+    compressWith(std::move(chunks), "gzip", gzipCompressor(params), decoder_callbacks, state);
   }
 }
 BENCHMARK(compressChunks16384)->DenseRange(0, 8, 1)->UseManualTime()->Unit(benchmark::kMillisecond);
@@ -257,7 +275,7 @@ static void compressChunks8192(benchmark::State& state) {
 
   for (auto _ : state) {
     std::vector<Buffer::OwnedImpl> chunks = generateChunks(15, 8192);
-    compressWith(std::move(chunks), params, decoder_callbacks, state);
+    compressWith(std::move(chunks), "gzip", gzipCompressor(params), decoder_callbacks, state);
   }
 }
 BENCHMARK(compressChunks8192)->DenseRange(0, 8, 1)->UseManualTime()->Unit(benchmark::kMillisecond);
@@ -269,7 +287,7 @@ static void compressChunks4096(benchmark::State& state) {
 
   for (auto _ : state) {
     std::vector<Buffer::OwnedImpl> chunks = generateChunks(30, 4096);
-    compressWith(std::move(chunks), params, decoder_callbacks, state);
+    compressWith(std::move(chunks), "gzip", gzipCompressor(params), decoder_callbacks, state);
   }
 }
 BENCHMARK(compressChunks4096)->DenseRange(0, 8, 1)->UseManualTime()->Unit(benchmark::kMillisecond);
@@ -281,11 +299,66 @@ static void compressChunks1024(benchmark::State& state) {
 
   for (auto _ : state) {
     std::vector<Buffer::OwnedImpl> chunks = generateChunks(120, 1024);
-    compressWith(std::move(chunks), params, decoder_callbacks, state);
+    compressWith(std::move(chunks), "gzip", gzipCompressor(params), decoder_callbacks, state);
   }
 }
 BENCHMARK(compressChunks1024)->DenseRange(0, 8, 1)->UseManualTime()->Unit(benchmark::kMillisecond);
 
+// Brotli qualities and zstd levels from the fastest to the densest, to be compared with the gzip
+// levels above on the same data.
+static std::vector<uint32_t> brotli_qualities = {1, 3, 5, 7, 9, 11};
+static std::vector<uint32_t> zstd_levels = {1, 3, 6, 9, 15, 19};
+
+static void compressFullBrotli(benchmark::State& state) {
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  const uint32_t quality = brotli_qualities[state.range(0)];
+
+  for (auto _ : state) {
+    std::vector<Buffer::OwnedImpl> chunks = generateChunks(1, 122880);
+    compressWith(std::move(chunks), "br", brotliCompressor(quality), decoder_callbacks, state);
+  }
+}
+BENCHMARK(compressFullBrotli)->DenseRange(0, 5, 1)->UseManualTime()->Unit(benchmark::kMillisecond);
+
+static void compressChunks4096Brotli(benchmark::State& state) {
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  const uint32_t quality = brotli_qualities[state.range(0)];
+
+  for (auto _ : state) {
+    std::vector<Buffer::OwnedImpl> chunks = generateChunks(30, 4096);
+    compressWith(std::move(chunks), "br", brotliCompressor(quality), decoder_callbacks, state);
+  }
+}
+BENCHMARK(compressChunks4096Brotli)
+    ->DenseRange(0, 5, 1)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+static void compressFullZstd(benchmark::State& state) {
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  const uint32_t level = zstd_levels[state.range(0)];
+
+  for (auto _ : state) {
+    std::vector<Buffer::OwnedImpl> chunks = generateChunks(1, 122880);
+    compressWith(std::move(chunks), "zstd", zstdCompressor(level), decoder_callbacks, state);
+  }
+}
+BENCHMARK(compressFullZstd)->DenseRange(0, 5, 1)->UseManualTime()->Unit(benchmark::kMillisecond);
+
+static void compressChunks4096Zstd(benchmark::State& state) {
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  const uint32_t level = zstd_levels[state.range(0)];
+
+  for (auto _ : state) {
+    std::vector<Buffer::OwnedImpl> chunks = generateChunks(30, 4096);
+    compressWith(std::move(chunks), "zstd", zstdCompressor(level), decoder_callbacks, state);
+  }
+}
+BENCHMARK(compressChunks4096Zstd)
+    ->DenseRange(0, 5, 1)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
 } // namespace Compressors
 } // namespace Common
 } // namespace HttpFilters
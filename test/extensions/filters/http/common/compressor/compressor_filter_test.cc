@@ -11,8 +11,10 @@
 #include "test/mocks/protobuf/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
+#include "absl/synchronization/notification.h"
 #include "gtest/gtest.h"
 
 namespace Envoy {
@@ -39,10 +41,18 @@ public:
     return compressor;
   }
 
+  CompressionOffloadPoolSharedPtr compressionOffloadPool() override {
+    return compression_offload_pool_;
+  }
+
   void setExpectedCompressCalls(uint32_t calls) { expected_compress_calls_ = calls; }
+  void setCompressionOffloadPool(CompressionOffloadPoolSharedPtr pool) {
+    compression_offload_pool_ = std::move(pool);
+  }
 
 private:
   uint32_t expected_compress_calls_{1};
+  CompressionOffloadPoolSharedPtr compression_offload_pool_;
 };
 
 class CompressorFilterTest : public testing::Test {
@@ -165,8 +175,79 @@ public:
     }
   }
 
+  // Runs a response to a GET of https://host/app.js through a new filter sharing the config of the
+  // test, feeding its body in two parts, and returns the body that the filter encoded.
+  std::string encodeResponseThroughNewFilter(Http::TestResponseHeaderMapImpl& headers,
+                                             const std::string& body) {
+    NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+    NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks;
+    CompressorFilter filter(config_);
+    filter.setDecoderFilterCallbacks(decoder_callbacks);
+    filter.setEncoderFilterCallbacks(encoder_callbacks);
+    Http::TestRequestHeaderMapImpl request_headers = {{":method", "get"},
+                                                      {":authority", "host"},
+                                                      {":path", "/app.js"},
+                                                      {"accept-encoding", "test"}};
+    filter.decodeHeaders(request_headers, true);
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter.encodeHeaders(headers, false));
+
+    std::string encoded;
+    Buffer::OwnedImpl first_part(body.substr(0, body.size() / 2));
+    filter.encodeData(first_part, false);
+    encoded.append(first_part.toString());
+    Buffer::OwnedImpl second_part(body.substr(body.size() / 2));
+    EXPECT_EQ(Http::FilterDataStatus::Continue, filter.encodeData(second_part, true));
+    encoded.append(second_part.toString());
+    return encoded;
+  }
+
+  // Sets up a filter compressing the chunks of 1024 bytes and more on a pool of the given number of
+  // threads, and runs the headers of a response to compress through it.
+  void setUpOffloadedResponse(uint32_t thread_count, uint32_t max_queue_size,
+                              uint32_t compress_calls) {
+    setUpFilter(R"EOF(
+{
+  "response_direction_config": {
+    "compression_offload": {
+      "min_chunk_bytes": 1024
+    }
+  },
+  "compressor_library": {
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  }
+}
+)EOF");
+    config_->setExpectedCompressCalls(compress_calls);
+    config_->setCompressionOffloadPool(std::make_shared<CompressionOffloadPool>(
+        Thread::threadFactoryForTest(), thread_count, max_queue_size));
+    Http::TestRequestHeaderMapImpl request_headers = {{":method", "get"},
+                                                      {"accept-encoding", "test"}};
+    filter_->decodeHeaders(request_headers, true);
+    Http::TestResponseHeaderMapImpl headers = {{":status", "200"}, {"content-length", "4096"}};
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  }
+
+  // Captures the completion that the pool posts to the worker once a chunk is compressed.
+  void expectOffloadedChunk() {
+    EXPECT_CALL(encoder_callbacks_.dispatcher_, post(_))
+        .WillOnce(Invoke([this](Event::PostCb callback) {
+          offloaded_chunk_done_ = std::move(callback);
+          offloaded_chunk_compressed_.Notify();
+        }));
+  }
+
+  // Waits for the chunk on the pool and runs its completion as the worker would.
+  void completeOffloadedChunk() {
+    offloaded_chunk_compressed_.WaitForNotification();
+    offloaded_chunk_done_();
+  }
+
   std::shared_ptr<TestCompressorFilterConfig> config_;
   std::unique_ptr<CompressorFilter> filter_;
+  absl::Notification offloaded_chunk_compressed_;
+  Event::PostCb offloaded_chunk_done_;
   Buffer::OwnedImpl data_;
   std::string expected_str_;
   std::string response_stats_prefix_{};
@@ -352,6 +433,173 @@ TEST_F(CompressorFilterTest, RemoveAcceptEncodingHeader) {
   }
 }
 
+// Verifies that a response with an entity tag is compressed once and then served from the
+// compressed response cache, whatever the body sent by the upstream.
+TEST_F(CompressorFilterTest, CompressedResponseCacheByEtag) {
+  setUpFilter(R"EOF(
+{
+  "response_direction_config": {
+    "compressed_response_cache": {}
+  },
+  "compressor_library": {
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  }
+}
+)EOF");
+  // The mock compressor leaves the data as is, which makes the cached body the original one.
+  config_->setExpectedCompressCalls(2);
+  Http::TestResponseHeaderMapImpl headers = {
+      {":status", "200"}, {"content-length", "256"}, {"etag", "\"abc\""}};
+  EXPECT_EQ(std::string(256, 'a'), encodeResponseThroughNewFilter(headers, std::string(256, 'a')));
+  EXPECT_EQ("", headers.get_("content-length"));
+  EXPECT_EQ(1, stats_.counter("test.test.compressed_response_cache_miss").value());
+  EXPECT_EQ(256 + std::string("etag\nhost/app.js\n\"abc\"").size(),
+            config_->responseDirectionConfig().compressedResponseCache()->sizeBytes());
+
+  Http::TestResponseHeaderMapImpl cached_headers = {
+      {":status", "200"}, {"content-length", "256"}, {"etag", "\"abc\""}};
+  EXPECT_EQ(std::string(256, 'a'),
+            encodeResponseThroughNewFilter(cached_headers, std::string(256, 'b')));
+  EXPECT_EQ("256", cached_headers.get_("content-length"));
+  EXPECT_EQ("test", cached_headers.get_("content-encoding"));
+  EXPECT_EQ(1, stats_.counter("test.test.compressed_response_cache_hit").value());
+  EXPECT_EQ(256, stats_.counter("test.test.response.total_uncompressed_bytes").value());
+
+  // Another entity tag misses.
+  Http::TestResponseHeaderMapImpl other_headers = {
+      {":status", "200"}, {"content-length", "256"}, {"etag", "\"def\""}};
+  EXPECT_EQ(std::string(256, 'c'),
+            encodeResponseThroughNewFilter(other_headers, std::string(256, 'c')));
+  EXPECT_EQ(2, stats_.counter("test.test.compressed_response_cache_miss").value());
+}
+
+// Verifies that a large chunk is compressed on the compression offload pool, and that the data
+// received meanwhile follows it in order and is compressed on the worker.
+TEST_F(CompressorFilterTest, CompressionOffloadKeepsOrder) {
+  setUpOffloadedResponse(1, 16, 2);
+  expectOffloadedChunk();
+  Buffer::OwnedImpl large(std::string(2048, 'a'));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter_->encodeData(large, false));
+  EXPECT_EQ(0, large.length());
+  Buffer::OwnedImpl small(std::string(16, 'b'));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter_->encodeData(small, true));
+
+  std::string encoded;
+  {
+    testing::InSequence s;
+    EXPECT_CALL(encoder_callbacks_, injectEncodedDataToFilterChain(_, false))
+        .WillOnce(Invoke([&](Buffer::Instance& data, bool) { encoded.append(data.toString()); }));
+    EXPECT_CALL(encoder_callbacks_, injectEncodedDataToFilterChain(_, true))
+        .WillOnce(Invoke([&](Buffer::Instance& data, bool) { encoded.append(data.toString()); }));
+  }
+  completeOffloadedChunk();
+  EXPECT_EQ(std::string(2048, 'a') + std::string(16, 'b'), encoded);
+  EXPECT_EQ(1, stats_.counter("test.test.compression_offloaded").value());
+  EXPECT_EQ(2048 + 16, stats_.counter("test.test.response.total_uncompressed_bytes").value());
+}
+
+// Verifies that the trailers wait for the chunk on the compression offload pool and that the
+// upstream is held back while the chunk exceeds the buffer limit of the stream.
+TEST_F(CompressorFilterTest, CompressionOffloadWithTrailersAndWatermarks) {
+  setUpOffloadedResponse(1, 16, 2);
+  ON_CALL(encoder_callbacks_, encoderBufferLimit()).WillByDefault(Return(1024));
+  expectOffloadedChunk();
+  EXPECT_CALL(encoder_callbacks_, onEncoderFilterAboveWriteBufferHighWatermark());
+  Buffer::OwnedImpl large(std::string(2048, 'a'));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter_->encodeData(large, false));
+  Http::TestResponseTrailerMapImpl trailers;
+  EXPECT_EQ(Http::FilterTrailersStatus::StopIteration, filter_->encodeTrailers(trailers));
+
+  {
+    testing::InSequence s;
+    EXPECT_CALL(encoder_callbacks_, injectEncodedDataToFilterChain(_, false)).Times(2);
+    EXPECT_CALL(encoder_callbacks_, onEncoderFilterBelowWriteBufferLowWatermark());
+    EXPECT_CALL(encoder_callbacks_, continueEncoding());
+  }
+  completeOffloadedChunk();
+}
+
+// Verifies that a chunk is compressed on the worker when the queue of the pool is full.
+TEST_F(CompressorFilterTest, CompressionOffloadQueueFull) {
+  setUpOffloadedResponse(0, 0, 1);
+  populateBuffer(2048);
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data_, true));
+  EXPECT_EQ(expected_str_, data_.toString());
+  EXPECT_EQ(1, stats_.counter("test.test.compression_offload_queue_full").value());
+  EXPECT_EQ(0, stats_.counter("test.test.compression_offloaded").value());
+}
+
+// Verifies that a chunk compressed after the stream is destroyed is dropped.
+TEST_F(CompressorFilterTest, CompressionOffloadAfterDestroy) {
+  setUpOffloadedResponse(1, 16, 1);
+  expectOffloadedChunk();
+  Buffer::OwnedImpl large(std::string(2048, 'a'));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter_->encodeData(large, true));
+  filter_->onDestroy();
+  EXPECT_CALL(encoder_callbacks_, injectEncodedDataToFilterChain(_, _)).Times(0);
+  completeOffloadedChunk();
+}
+
+// Verifies that a body larger than max_body_bytes is not cached.
+TEST_F(CompressorFilterTest, CompressedResponseCacheSkipsLargeBodies) {
+  setUpFilter(R"EOF(
+{
+  "response_direction_config": {
+    "compressed_response_cache": {
+      "max_body_bytes": 100
+    }
+  },
+  "compressor_library": {
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  }
+}
+)EOF");
+  config_->setExpectedCompressCalls(2);
+  Http::TestResponseHeaderMapImpl headers = {
+      {":status", "200"}, {"content-length", "256"}, {"etag", "\"abc\""}};
+  encodeResponseThroughNewFilter(headers, std::string(256, 'a'));
+  EXPECT_EQ(0, config_->responseDirectionConfig().compressedResponseCache()->sizeBytes());
+}
+
+// Verifies that a response without an entity tag is buffered and keyed by the hash of its body
+// when key_by_content_hash is set.
+TEST_F(CompressorFilterTest, CompressedResponseCacheByContentHash) {
+  setUpFilter(R"EOF(
+{
+  "response_direction_config": {
+    "compressed_response_cache": {
+      "key_by_content_hash": true
+    }
+  },
+  "compressor_library": {
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  }
+}
+)EOF");
+  // The buffered body is compressed at once.
+  config_->setExpectedCompressCalls(1);
+  Http::TestResponseHeaderMapImpl headers = {{":status", "200"}, {"content-length", "256"}};
+  EXPECT_EQ(std::string(256, 'a'), encodeResponseThroughNewFilter(headers, std::string(256, 'a')));
+  EXPECT_EQ(1, stats_.counter("test.test.compressed_response_cache_miss").value());
+
+  Http::TestResponseHeaderMapImpl cached_headers = {{":status", "200"}, {"content-length", "256"}};
+  EXPECT_EQ(std::string(256, 'a'),
+            encodeResponseThroughNewFilter(cached_headers, std::string(256, 'a')));
+  EXPECT_EQ(1, stats_.counter("test.test.compressed_response_cache_hit").value());
+
+  // Another body misses.
+  Http::TestResponseHeaderMapImpl other_headers = {{":status", "200"}, {"content-length", "256"}};
+  EXPECT_EQ(std::string(256, 'b'),
+            encodeResponseThroughNewFilter(other_headers, std::string(256, 'b')));
+  EXPECT_EQ(2, stats_.counter("test.test.compressed_response_cache_miss").value());
+}
+
 class IsAcceptEncodingAllowedTest
     : public CompressorFilterTest,
       public testing::WithParamInterface<std::tuple<std::string, bool, int, int, int, int>> {};
@@ -749,6 +997,26 @@ TEST_F(MultipleFiltersTest, UseFirstRegisteredFilterWhenWildcard) {
   EXPECT_EQ(1, stats2_.counter("test2.test2.header_wildcard").value());
 }
 
+TEST_F(MultipleFiltersTest, PreferFirstRegisteredFilterOnEqualQValues) {
+  // Test that the filter registered first wins over the order of the accepted encodings.
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  filter1_->setDecoderFilterCallbacks(decoder_callbacks);
+  filter2_->setDecoderFilterCallbacks(decoder_callbacks);
+
+  Http::TestRequestHeaderMapImpl req_headers{{":method", "get"},
+                                             {"accept-encoding", "test2, test1"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter1_->decodeHeaders(req_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter2_->decodeHeaders(req_headers, false));
+  Http::TestResponseHeaderMapImpl headers1{{":method", "get"}, {"content-length", "256"}};
+  Http::TestResponseHeaderMapImpl headers2{{":method", "get"}, {"content-length", "256"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter1_->encodeHeaders(headers1, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter2_->encodeHeaders(headers2, false));
+  EXPECT_EQ(1, stats1_.counter("test1.test1.compressed").value());
+  EXPECT_EQ(1, stats1_.counter("test1.test1.header_compressor_used").value());
+  EXPECT_EQ(0, stats2_.counter("test2.test2.compressed").value());
+  EXPECT_EQ(1, stats2_.counter("test2.test2.header_compressor_overshadowed").value());
+}
+
 TEST(LegacyTest, GzipStats) {
   // check if the legacy "header_gzip" counter is incremented for gzip compression filter
   Stats::TestUtil::TestStore stats;
@@ -0,0 +1,516 @@
+// Benchmarks of the cost each HTTP filter adds to a request, and of the iteration of the
+// FilterManager over the filter chain. A stream drives a FilterManager through a chain of real
+// filters, built by their config factories from mock factory contexts, and a terminal filter which
+// answers in place of the router and the upstream. Comparing a chain to the chain of pass-through
+// filters of the same length gives the cost of its filters.
+//
+// Besides the time, the benchmarks report the time spent decoding the request and encoding the
+// response, the bytes held by a stream once its response is sent and, when the kernel lets the
+// process use the hardware counters, the cache misses per request.
+//
+// The runtime, the connection and a few other services of the filters are mocks, so that the
+// filters which call them carry the overhead of a mock call.
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <chrono>
+
+#include "envoy/config/route/v3/route.pb.h"
+#include "envoy/extensions/filters/http/ext_authz/v3/ext_authz.pb.h"
+#include "envoy/extensions/filters/http/jwt_authn/v3/config.pb.h"
+#include "envoy/server/filter_config.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/config/utility.h"
+#include "common/event/real_time_system.h"
+#include "common/http/filter_manager.h"
+#include "common/http/header_map_impl.h"
+#include "common/local_reply/local_reply.h"
+#include "common/memory/stats.h"
+#include "common/protobuf/message_validator_impl.h"
+#include "common/router/config_impl.h"
+#include "common/stream_info/filter_state_impl.h"
+#include "common/tracing/http_tracer_impl.h"
+
+#include "extensions/filters/http/common/pass_through_filter.h"
+#include "extensions/filters/http/ext_authz/ext_authz.h"
+
+#include "test/extensions/filters/http/jwt_authn/test_common.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Common {
+namespace {
+
+enum class FilterKind { PassThrough, Cors, Fault, Rbac, JwtAuthn, ExtAuthz, Lua, All };
+
+const std::string RouteConfigYaml = R"EOF(
+virtual_hosts:
+- name: backend
+  domains: ["*"]
+  cors:
+    allow_origin_string_match:
+    - exact: https://example.com
+    allow_methods: GET, POST
+  routes:
+  - match: { prefix: "/" }
+    route: { cluster: backend }
+)EOF";
+
+// Faults which are never injected, so that the filter only decides not to inject them.
+const std::string FaultYaml = R"EOF(
+delay:
+  fixed_delay: 1s
+  percentage: { numerator: 0 }
+abort:
+  http_status: 503
+  percentage: { numerator: 0 }
+)EOF";
+
+const std::string RbacYaml = R"EOF(
+rules:
+  action: ALLOW
+  policies:
+    any:
+      permissions: [{ any: true }]
+      principals: [{ any: true }]
+)EOF";
+
+const std::string JwtAuthnYaml = R"EOF(
+providers:
+  example_provider:
+    issuer: https://example.com
+    audiences: [example_service]
+    forward: true
+rules:
+- match: { prefix: "/" }
+  requires: { provider_name: example_provider }
+)EOF";
+
+const std::string LuaYaml = R"EOF(
+inline_code: |
+  function envoy_on_request(request_handle)
+    request_handle:headers():add("x-lua-request", "1")
+  end
+  function envoy_on_response(response_handle)
+    response_handle:headers():add("x-lua-response", "1")
+  end
+)EOF";
+
+// An ext_authz client which allows every request, within the check call.
+class AllowClient : public Filters::Common::ExtAuthz::Client {
+public:
+  // Filters::Common::ExtAuthz::Client
+  void cancel() override {}
+  void check(Filters::Common::ExtAuthz::RequestCallbacks& callbacks,
+             const envoy::service::auth::v3::CheckRequest&, Tracing::Span&,
+             const StreamInfo::StreamInfo&) override {
+    auto response = std::make_unique<Filters::Common::ExtAuthz::Response>();
+    response->status = Filters::Common::ExtAuthz::CheckStatus::OK;
+    callbacks.onComplete(std::move(response));
+  }
+};
+
+// Answers the request once it is decoded, with a response body of the size of the request body.
+class TerminalFilter : public Http::PassThroughDecoderFilter {
+public:
+  // Http::StreamDecoderFilter
+  Http::FilterHeadersStatus decodeHeaders(Http::RequestHeaderMap&, bool end_stream) override {
+    decoded_ = end_stream;
+    return Http::FilterHeadersStatus::StopIteration;
+  }
+  Http::FilterDataStatus decodeData(Buffer::Instance& data, bool end_stream) override {
+    body_size_ += data.length();
+    decoded_ = end_stream;
+    return Http::FilterDataStatus::StopIterationNoBuffer;
+  }
+
+  void respond() {
+    ASSERT(decoded_);
+    decoder_callbacks_->encodeHeaders(
+        Http::createHeaderMap<Http::ResponseHeaderMapImpl>({{Http::Headers::get().Status, "200"}}),
+        body_size_ == 0, "benchmark");
+    if (body_size_ > 0) {
+      Buffer::OwnedImpl body(std::string(body_size_, 'a'));
+      decoder_callbacks_->encodeData(body, true);
+    }
+  }
+
+private:
+  uint64_t body_size_{};
+  bool decoded_{};
+};
+
+// The filters of the streams, and what the streams share as the streams of a connection do.
+class FilterChain : public Http::FilterChainFactory {
+public:
+  FilterChain(FilterKind kind, uint32_t num_filters)
+      : local_reply_(LocalReply::Factory::createDefault()),
+        connection_filter_state_(std::make_shared<StreamInfo::FilterStateImpl>(
+            StreamInfo::FilterState::LifeSpan::Connection)) {
+    envoy::config::route::v3::RouteConfiguration route_config;
+    TestUtility::loadFromYaml(RouteConfigYaml, route_config);
+    route_config_ = std::make_unique<Router::ConfigImpl>(
+        route_config, server_context_, ProtobufMessage::getStrictValidationVisitor(), false);
+
+    for (uint32_t i = 0; i < num_filters; ++i) {
+      if (kind == FilterKind::All) {
+        for (const FilterKind one : {FilterKind::Cors, FilterKind::Fault, FilterKind::Rbac,
+                                     FilterKind::JwtAuthn, FilterKind::ExtAuthz, FilterKind::Lua}) {
+          addFilter(one);
+        }
+      } else {
+        addFilter(kind);
+      }
+    }
+  }
+
+  // Http::FilterChainFactory
+  void createFilterChain(Http::FilterChainFactoryCallbacks& callbacks) override {
+    for (const Http::FilterFactoryCb& factory : factories_) {
+      factory(callbacks);
+    }
+    terminal_filter_ = std::make_shared<TerminalFilter>();
+    callbacks.addStreamDecoderFilter(terminal_filter_);
+  }
+  bool createUpgradeFilterChain(absl::string_view, const UpgradeMap*,
+                                Http::FilterChainFactoryCallbacks&) override {
+    return false;
+  }
+
+  Event::Dispatcher& dispatcher() { return dispatcher_; }
+  const Network::Connection& connection() const { return connection_; }
+  const LocalReply::LocalReply& localReply() const { return *local_reply_; }
+  TimeSource& timeSource() { return time_system_; }
+  const StreamInfo::FilterStateSharedPtr& connectionFilterState() const {
+    return connection_filter_state_;
+  }
+  const Router::ConfigImpl& routeConfig() const { return *route_config_; }
+  // The terminal filter of the last filter chain created.
+  TerminalFilter& terminalFilter() { return *terminal_filter_; }
+
+private:
+  void addFilter(FilterKind kind) {
+    switch (kind) {
+    case FilterKind::PassThrough:
+      factories_.push_back([](Http::FilterChainFactoryCallbacks& callbacks) {
+        callbacks.addStreamFilter(std::make_shared<Http::PassThroughFilter>());
+      });
+      return;
+    case FilterKind::Cors:
+      addConfiguredFilter("envoy.filters.http.cors", "{}");
+      return;
+    case FilterKind::Fault:
+      addConfiguredFilter("envoy.filters.http.fault", FaultYaml);
+      return;
+    case FilterKind::Rbac:
+      addConfiguredFilter("envoy.filters.http.rbac", RbacYaml);
+      return;
+    case FilterKind::JwtAuthn: {
+      envoy::extensions::filters::http::jwt_authn::v3::JwtAuthentication config;
+      TestUtility::loadFromYaml(JwtAuthnYaml, config);
+      (*config.mutable_providers())["example_provider"].mutable_local_jwks()->set_inline_string(
+          JwtAuthn::PublicKey);
+      addConfiguredFilter("envoy.filters.http.jwt_authn", config);
+      return;
+    }
+    case FilterKind::ExtAuthz: {
+      auto config = std::make_shared<ExtAuthz::FilterConfig>(
+          envoy::extensions::filters::http::ext_authz::v3::ExtAuthz(), context_.scope(),
+          context_.runtime(), context_.httpContext(), "benchmark.", context_.threadLocal(),
+          context_.timeSource());
+      factories_.push_back([config](Http::FilterChainFactoryCallbacks& callbacks) {
+        callbacks.addStreamFilter(
+            std::make_shared<ExtAuthz::Filter>(config, std::make_unique<AllowClient>()));
+      });
+      return;
+    }
+    case FilterKind::Lua:
+      addConfiguredFilter("envoy.filters.http.lua", LuaYaml);
+      return;
+    case FilterKind::All:
+      break;
+    }
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+
+  void addConfiguredFilter(const std::string& name, const std::string& yaml) {
+    ProtobufTypes::MessagePtr config = filterConfigFactory(name).createEmptyConfigProto();
+    TestUtility::loadFromYaml(yaml, *config);
+    addConfiguredFilter(name, *config);
+  }
+
+  void addConfiguredFilter(const std::string& name, const Protobuf::Message& config) {
+    factories_.push_back(filterConfigFactory(name).createFilterFactoryFromProto(
+        config, "benchmark.", context_));
+  }
+
+  static Server::Configuration::NamedHttpFilterConfigFactory&
+  filterConfigFactory(const std::string& name) {
+    return Config::Utility::getAndCheckFactoryByName<
+        Server::Configuration::NamedHttpFilterConfigFactory>(name);
+  }
+
+  NiceMock<Server::Configuration::MockFactoryContext> context_;
+  NiceMock<Server::Configuration::MockServerFactoryContext> server_context_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Network::MockConnection> connection_;
+  Event::RealTimeSystem time_system_;
+  const LocalReply::LocalReplyPtr local_reply_;
+  const StreamInfo::FilterStateSharedPtr connection_filter_state_;
+  std::unique_ptr<Router::ConfigImpl> route_config_;
+  std::vector<Http::FilterFactoryCb> factories_;
+  std::shared_ptr<TerminalFilter> terminal_filter_;
+};
+
+// A stream of the filter chain, which stands for the stream of the connection manager.
+class Stream : public Http::FilterManagerCallbacks, public ScopeTrackedObject {
+public:
+  Stream(FilterChain& chain, uint64_t body_size)
+      : chain_(chain), body_size_(body_size),
+        filter_manager_(*this, chain.dispatcher(), chain.connection(), 0, true, 1024 * 1024, chain,
+                        chain.localReply(), Http::Protocol::Http2, chain.timeSource(),
+                        chain.connectionFilterState(),
+                        StreamInfo::FilterState::LifeSpan::Connection) {}
+  ~Stream() override {
+    filter_manager_.onStreamComplete();
+    filter_manager_.destroyFilters();
+  }
+
+  void decode() {
+    request_headers_ = Http::createHeaderMap<Http::RequestHeaderMapImpl>(
+        {{Http::Headers::get().Method, body_size_ == 0 ? "GET" : "POST"},
+         {Http::Headers::get().Path, "/api"},
+         {Http::Headers::get().Host, "example.com"},
+         {Http::Headers::get().Scheme, "https"},
+         {Http::CustomHeaders::get().Origin, "https://example.com"},
+         {Http::CustomHeaders::get().Authorization, absl::StrCat("Bearer ", JwtAuthn::GoodToken)},
+         {Http::Headers::get().UserAgent, "benchmark"}});
+    filter_manager_.createFilterChain();
+    filter_manager_.requestHeadersInitialized();
+    filter_manager_.decodeHeaders(*request_headers_, body_size_ == 0);
+    if (body_size_ > 0) {
+      Buffer::OwnedImpl body(std::string(body_size_, 'a'));
+      filter_manager_.decodeData(body, true);
+    }
+  }
+
+  void encode() { chain_.terminalFilter().respond(); }
+
+  // Http::FilterManagerCallbacks
+  void encodeHeaders(Http::ResponseHeaderMap&, bool) override {}
+  void encode100ContinueHeaders(Http::ResponseHeaderMap&) override {}
+  void encodeData(Buffer::Instance& data, bool) override { data.drain(data.length()); }
+  void encodeTrailers(Http::ResponseTrailerMap&) override {}
+  void encodeMetadata(Http::MetadataMapVector&) override {}
+  void setRequestTrailers(Http::RequestTrailerMapPtr&& request_trailers) override {
+    request_trailers_ = std::move(request_trailers);
+  }
+  void setContinueHeaders(Http::ResponseHeaderMapPtr&& continue_headers) override {
+    continue_headers_ = std::move(continue_headers);
+  }
+  void setResponseHeaders(Http::ResponseHeaderMapPtr&& response_headers) override {
+    response_headers_ = std::move(response_headers);
+  }
+  void setResponseTrailers(Http::ResponseTrailerMapPtr&& response_trailers) override {
+    response_trailers_ = std::move(response_trailers);
+  }
+  void chargeStats(const Http::ResponseHeaderMap&) override {}
+  Http::RequestHeaderMapOptRef requestHeaders() override {
+    return request_headers_ ? absl::make_optional(std::ref(*request_headers_)) : absl::nullopt;
+  }
+  Http::RequestTrailerMapOptRef requestTrailers() override {
+    return request_trailers_ ? absl::make_optional(std::ref(*request_trailers_)) : absl::nullopt;
+  }
+  Http::ResponseHeaderMapOptRef continueHeaders() override {
+    return continue_headers_ ? absl::make_optional(std::ref(*continue_headers_)) : absl::nullopt;
+  }
+  Http::ResponseHeaderMapOptRef responseHeaders() override {
+    return response_headers_ ? absl::make_optional(std::ref(*response_headers_)) : absl::nullopt;
+  }
+  Http::ResponseTrailerMapOptRef responseTrailers() override {
+    return response_trailers_ ? absl::make_optional(std::ref(*response_trailers_))
+                              : absl::nullopt;
+  }
+  void endStream() override {}
+  void onDecoderFilterBelowWriteBufferLowWatermark() override {}
+  void onDecoderFilterAboveWriteBufferHighWatermark() override {}
+  void upgradeFilterChainCreated() override {}
+  void disarmRequestTimeout() override {}
+  void resetIdleTimer() override {}
+  void recreateStream(StreamInfo::FilterStateSharedPtr) override {}
+  void resetStream() override {}
+  const Router::RouteEntry::UpgradeMap* upgradeMap() override { return nullptr; }
+  Upstream::ClusterInfoConstSharedPtr clusterInfo() override { return nullptr; }
+  Router::RouteConstSharedPtr route(const Router::RouteCallback&) override {
+    if (!cached_route_.has_value()) {
+      cached_route_ =
+          chain_.routeConfig().route(*request_headers_, filter_manager_.streamInfo(), 0);
+    }
+    return cached_route_.value();
+  }
+  void clearRouteCache() override { cached_route_.reset(); }
+  absl::optional<Router::ConfigConstSharedPtr> routeConfig() override { return absl::nullopt; }
+  void requestRouteConfigUpdate(Http::RouteConfigUpdatedCallbackSharedPtr) override {}
+  Tracing::Span& activeSpan() override { return Tracing::NullSpan::instance(); }
+  void onResponseDataTooLarge() override {}
+  void onRequestDataTooLarge() override {}
+  Http::Http1StreamEncoderOptionsOptRef http1StreamEncoderOptions() override {
+    return absl::nullopt;
+  }
+  void onLocalReply(Http::Code) override {}
+  Tracing::Config& tracingConfig() override { return tracing_config_; }
+  const ScopeTrackedObject& scope() override { return *this; }
+
+  // ScopeTrackedObject
+  void dumpState(std::ostream&, int) const override {}
+
+private:
+  FilterChain& chain_;
+  const uint64_t body_size_;
+  Http::FilterManager filter_manager_;
+  Http::RequestHeaderMapPtr request_headers_;
+  Http::RequestTrailerMapPtr request_trailers_;
+  Http::ResponseHeaderMapPtr continue_headers_;
+  Http::ResponseHeaderMapPtr response_headers_;
+  Http::ResponseTrailerMapPtr response_trailers_;
+  absl::optional<Router::RouteConstSharedPtr> cached_route_;
+  Tracing::EgressConfigImpl tracing_config_;
+};
+
+// Counts the cache misses of the calling thread in user space, when the kernel lets the process use
+// the hardware counters, which it often does not in containers.
+class CacheMissCounter {
+public:
+  CacheMissCounter() {
+#ifdef __linux__
+    perf_event_attr attr{};
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd_ = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+  }
+  ~CacheMissCounter() {
+#ifdef __linux__
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+#endif
+  }
+
+  bool enabled() const { return fd_ >= 0; }
+
+  void start() {
+#ifdef __linux__
+    if (enabled()) {
+      ::ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+      ::ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  // @return the cache misses since the counter started.
+  uint64_t stop() {
+    uint64_t count = 0;
+#ifdef __linux__
+    if (enabled()) {
+      ::ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+      if (::read(fd_, &count, sizeof(count)) != sizeof(count)) {
+        count = 0;
+      }
+    }
+#endif
+    return count;
+  }
+
+private:
+  int fd_{-1};
+};
+
+// The arguments are the kind of the filters, the number of filters of the kind, all the kinds for
+// FilterKind::All, and the size of the request and of the response bodies, 0 for headers only.
+static void filterChain(benchmark::State& state) {
+  FilterChain chain(static_cast<FilterKind>(state.range(0)), state.range(1));
+  const uint64_t body_size = state.range(2);
+
+  std::chrono::nanoseconds decode_time{};
+  std::chrono::nanoseconds encode_time{};
+  CacheMissCounter cache_misses;
+  cache_misses.start();
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Stream stream(chain, body_size);
+    const auto start = std::chrono::steady_clock::now();
+    stream.decode();
+    const auto decoded = std::chrono::steady_clock::now();
+    stream.encode();
+    decode_time += decoded - start;
+    encode_time += std::chrono::steady_clock::now() - decoded;
+  }
+  const uint64_t misses = cache_misses.stop();
+
+  // The bytes held by a stream once its response is sent, which is the memory of the stream while
+  // its filters are alive. Reports 0 bytes when the allocator does not provide the allocated size.
+  const uint64_t allocated_before = Memory::Stats::totalCurrentlyAllocated();
+  uint64_t bytes_per_stream = 0;
+  {
+    Stream stream(chain, body_size);
+    stream.decode();
+    stream.encode();
+    const uint64_t allocated_after = Memory::Stats::totalCurrentlyAllocated();
+    bytes_per_stream = allocated_after > allocated_before ? allocated_after - allocated_before : 0;
+  }
+
+  state.counters["decode_ns"] =
+      benchmark::Counter(decode_time.count(), benchmark::Counter::kAvgIterations);
+  state.counters["encode_ns"] =
+      benchmark::Counter(encode_time.count(), benchmark::Counter::kAvgIterations);
+  state.counters["bytes_per_stream"] = bytes_per_stream;
+  if (cache_misses.enabled()) {
+    state.counters["cache_misses"] =
+        benchmark::Counter(misses, benchmark::Counter::kAvgIterations);
+  }
+}
+
+static void filterChainArgs(benchmark::internal::Benchmark* b) {
+  for (const int64_t body_size : {0, 4096}) {
+    // The cost of the iteration over the filters.
+    for (const int64_t num_filters : {0, 1, 5, 10}) {
+      b->Args({static_cast<int64_t>(FilterKind::PassThrough), num_filters, body_size});
+    }
+    // The cost of each filter, against a single pass-through filter.
+    for (const FilterKind kind : {FilterKind::Cors, FilterKind::Fault, FilterKind::Rbac,
+                                  FilterKind::JwtAuthn, FilterKind::ExtAuthz, FilterKind::Lua}) {
+      b->Args({static_cast<int64_t>(kind), 1, body_size});
+    }
+    // The cost of a chain of all the filters, against 6 pass-through filters.
+    b->Args({static_cast<int64_t>(FilterKind::PassThrough), 6, body_size});
+    b->Args({static_cast<int64_t>(FilterKind::All), 1, body_size});
+  }
+}
+
+BENCHMARK(filterChain)->Apply(filterChainArgs)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace Common
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -3,6 +3,7 @@
 #include "test/mocks/compression/compressor/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/test_common/thread_factory_for_test.h"
 
 #include "gtest/gtest.h"
 
@@ -23,8 +24,25 @@ TEST(CompressorFilterConfigTests, MakeCompressorTest) {
   EXPECT_CALL(*compressor_factory, statsPrefix());
   EXPECT_CALL(*compressor_factory, contentEncoding());
   CompressorFilterConfig config(compressor_cfg, "test.compressor.", stats, runtime,
-                                std::move(compressor_factory));
+                                std::move(compressor_factory), Thread::threadFactoryForTest());
   Envoy::Compression::Compressor::CompressorPtr compressor = config.makeCompressor();
+  EXPECT_EQ(nullptr, config.compressionOffloadPool());
+}
+
+TEST(CompressorFilterConfigTests, CompressionOffloadPoolTest) {
+  envoy::extensions::filters::http::compressor::v3::Compressor compressor_cfg;
+  compressor_cfg.mutable_response_direction_config()->mutable_compression_offload();
+  NiceMock<Runtime::MockLoader> runtime;
+  Stats::TestUtil::TestStore stats;
+  CompressorFilterConfig config1(compressor_cfg, "test1.compressor.", stats, runtime,
+                                 std::make_unique<Compression::Compressor::MockCompressorFactory>(),
+                                 Thread::threadFactoryForTest());
+  CompressorFilterConfig config2(compressor_cfg, "test2.compressor.", stats, runtime,
+                                 std::make_unique<Compression::Compressor::MockCompressorFactory>(),
+                                 Thread::threadFactoryForTest());
+  // The configurations share the pool of the process.
+  ASSERT_NE(nullptr, config1.compressionOffloadPool());
+  EXPECT_EQ(config1.compressionOffloadPool(), config2.compressionOffloadPool());
 }
 
 } // namespace
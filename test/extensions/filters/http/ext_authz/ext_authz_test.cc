@@ -25,9 +25,11 @@
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/router/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/mocks/tracing/mocks.h"
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -59,7 +61,8 @@ public:
       TestUtility::loadFromYaml(yaml, proto_config);
     }
     config_.reset(
-        new FilterConfig(proto_config, stats_store_, runtime_, http_context_, "ext_authz_prefix"));
+        new FilterConfig(proto_config, stats_store_, runtime_, http_context_, "ext_authz_prefix",
+                         tls_, time_system_));
     client_ = new Filters::Common::ExtAuthz::MockClient();
     filter_ = std::make_unique<Filter>(config_, Filters::Common::ExtAuthz::ClientPtr{client_});
     filter_->setDecoderFilterCallbacks(filter_callbacks_);
@@ -73,6 +76,8 @@ public:
   }
 
   NiceMock<Stats::MockIsolatedStatsStore> stats_store_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Event::SimulatedTimeSystem time_system_;
   FilterConfigSharedPtr config_;
   Filters::Common::ExtAuthz::MockClient* client_;
   std::unique_ptr<Filter> filter_;
@@ -647,6 +652,158 @@ TEST_F(HttpFilterTest, HeaderOnlyRequest) {
   // decodeData() and decodeTrailers() will not be called since request is header only.
 }
 
+// Verifies that an allowed decision is served from the decision cache until the TTL returned by
+// the authorization service expires, and that the TTL header is not added to the request.
+TEST_F(HttpFilterTest, DecisionCacheServesAllowedDecision) {
+  initialize(R"EOF(
+  transport_api_version: V3
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_authz_server"
+  decision_cache:
+    headers: ["x-user"]
+    include_method: true
+    ttl_header: "x-authz-ttl"
+  )EOF");
+
+  request_headers_ = Http::TestRequestHeaderMapImpl{
+      {":method", "GET"}, {":path", "/"}, {":host", "host"}, {"x-user", "alice"}};
+  const auto expect_check = [this]() {
+    prepareCheck();
+    EXPECT_CALL(*client_, check(_, _, _, _))
+        .WillOnce(
+            WithArgs<0>(Invoke([&](Filters::Common::ExtAuthz::RequestCallbacks& callbacks) -> void {
+              request_callbacks_ = &callbacks;
+            })));
+  };
+  const auto recreate_filter = [this]() {
+    client_ = new Filters::Common::ExtAuthz::MockClient();
+    filter_ = std::make_unique<Filter>(config_, Filters::Common::ExtAuthz::ClientPtr{client_});
+    filter_->setDecoderFilterCallbacks(filter_callbacks_);
+  };
+
+  expect_check();
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            filter_->decodeHeaders(request_headers_, true));
+  Filters::Common::ExtAuthz::Response response{};
+  response.status = Filters::Common::ExtAuthz::CheckStatus::OK;
+  response.headers_to_set = {{Http::LowerCaseString{"x-authz-ttl"}, "60"},
+                             {Http::LowerCaseString{"x-authz-user"}, "alice"}};
+  EXPECT_CALL(filter_callbacks_, continueDecoding());
+  request_callbacks_->onComplete(std::make_unique<Filters::Common::ExtAuthz::Response>(response));
+  EXPECT_FALSE(request_headers_.has("x-authz-ttl"));
+  EXPECT_EQ("alice", request_headers_.get_("x-authz-user"));
+
+  // The same method and user are served from the cache.
+  recreate_filter();
+  request_headers_.remove(Http::LowerCaseString{"x-authz-user"});
+  EXPECT_CALL(*client_, check(_, _, _, _)).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, true));
+  EXPECT_EQ("alice", request_headers_.get_("x-authz-user"));
+  EXPECT_EQ(1U, config_->stats().decision_cache_hit_.value());
+  EXPECT_EQ(1U, config_->stats().decision_cache_miss_.value());
+  EXPECT_EQ(2U, config_->stats().ok_.value());
+
+  // Another user is not.
+  recreate_filter();
+  request_headers_.setCopy(Http::LowerCaseString{"x-user"}, "bob");
+  expect_check();
+  EXPECT_CALL(*client_, cancel());
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            filter_->decodeHeaders(request_headers_, true));
+  EXPECT_EQ(2U, config_->stats().decision_cache_miss_.value());
+  filter_->onDestroy();
+
+  // Nor is the first user once the TTL expired.
+  time_system_.advanceTimeWait(std::chrono::seconds(61));
+  recreate_filter();
+  request_headers_.setCopy(Http::LowerCaseString{"x-user"}, "alice");
+  expect_check();
+  EXPECT_CALL(*client_, cancel());
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            filter_->decodeHeaders(request_headers_, true));
+  EXPECT_EQ(3U, config_->stats().decision_cache_miss_.value());
+  filter_->onDestroy();
+}
+
+// Verifies that denied decisions are cached for the configured denied TTL and that errors are
+// never cached.
+TEST_F(HttpFilterTest, DecisionCacheDeniedAndError) {
+  initialize(R"EOF(
+  transport_api_version: V3
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_authz_server"
+  decision_cache:
+    path_prefix_segments: 1
+    denied_ttl: 10s
+  )EOF");
+
+  const auto check_with = [this](Filters::Common::ExtAuthz::CheckStatus status) {
+    client_ = new Filters::Common::ExtAuthz::MockClient();
+    filter_ = std::make_unique<Filter>(config_, Filters::Common::ExtAuthz::ClientPtr{client_});
+    filter_->setDecoderFilterCallbacks(filter_callbacks_);
+    prepareCheck();
+    EXPECT_CALL(*client_, check(_, _, _, _))
+        .WillOnce(
+            WithArgs<0>(Invoke([&](Filters::Common::ExtAuthz::RequestCallbacks& callbacks) -> void {
+              Filters::Common::ExtAuthz::Response response{};
+              response.status = status;
+              response.status_code = Http::Code::Forbidden;
+              callbacks.onComplete(
+                  std::make_unique<Filters::Common::ExtAuthz::Response>(response));
+            })));
+    EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+              filter_->decodeHeaders(request_headers_, true));
+  };
+
+  request_headers_ = Http::TestRequestHeaderMapImpl{
+      {":method", "GET"}, {":path", "/admin/users?id=1"}, {":host", "host"}};
+  check_with(Filters::Common::ExtAuthz::CheckStatus::Error);
+  check_with(Filters::Common::ExtAuthz::CheckStatus::Denied);
+  EXPECT_EQ(0U, config_->stats().decision_cache_hit_.value());
+
+  // A path sharing the first segment is denied from the cache.
+  client_ = new Filters::Common::ExtAuthz::MockClient();
+  filter_ = std::make_unique<Filter>(config_, Filters::Common::ExtAuthz::ClientPtr{client_});
+  filter_->setDecoderFilterCallbacks(filter_callbacks_);
+  request_headers_.setPath("/admin/groups");
+  EXPECT_CALL(*client_, check(_, _, _, _)).Times(0);
+  EXPECT_CALL(filter_callbacks_, encodeHeaders_(_, true))
+      .WillOnce(Invoke([&](const Http::ResponseHeaderMap& headers, bool) -> void {
+        EXPECT_EQ(headers.getStatusValue(), std::to_string(enumToInt(Http::Code::Forbidden)));
+      }));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            filter_->decodeHeaders(request_headers_, true));
+  EXPECT_EQ(1U, config_->stats().decision_cache_hit_.value());
+  EXPECT_EQ(2U, config_->stats().denied_.value());
+}
+
+// Verifies that the decision cache key only includes the configured request attributes.
+TEST(DecisionCacheTest, Key) {
+  NiceMock<ThreadLocal::MockInstance> tls;
+  Event::SimulatedTimeSystem time_system;
+  envoy::extensions::filters::http::ext_authz::v3::DecisionCache config;
+  TestUtility::loadFromYaml(R"EOF(
+  headers: ["x-tenant"]
+  path_prefix_segments: 2
+  )EOF",
+                            config);
+  DecisionCache cache(config, tls, time_system);
+
+  const std::string key = cache.key(Http::TestRequestHeaderMapImpl{
+      {":method", "GET"}, {":path", "/api/v1/users/42?x=1"}, {"x-tenant", "a"}});
+  EXPECT_EQ(key, cache.key(Http::TestRequestHeaderMapImpl{
+                     {":method", "POST"}, {":path", "/api/v1/groups"}, {"x-tenant", "a"}}));
+  EXPECT_NE(key, cache.key(Http::TestRequestHeaderMapImpl{
+                     {":method", "GET"}, {":path", "/api/v2/users/42"}, {"x-tenant", "a"}}));
+  EXPECT_NE(key, cache.key(Http::TestRequestHeaderMapImpl{
+                     {":method", "GET"}, {":path", "/api/v1/users/42"}, {"x-tenant", "b"}}));
+  EXPECT_NE(
+      cache.key(Http::TestRequestHeaderMapImpl{{":path", "/api/v1"}, {"x-tenant", ""}}),
+      cache.key(Http::TestRequestHeaderMapImpl{{":path", "/api/v1"}}));
+}
+
 // Checks that filter does not buffer data on upgrade WebSocket request.
 TEST_F(HttpFilterTest, UpgradeWebsocketRequest) {
   InSequence s;
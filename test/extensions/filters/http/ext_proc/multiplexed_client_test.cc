@@ -0,0 +1,198 @@
+#include "envoy/config/core/v3/grpc_service.pb.h"
+
+#include "common/grpc/common.h"
+
+#include "extensions/filters/http/ext_proc/multiplexed_client_impl.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/grpc/mocks.h"
+#include "test/mocks/stats/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using envoy::service::ext_proc::v3alpha::ProcessingRequest;
+using envoy::service::ext_proc::v3alpha::ProcessingResponse;
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Unused;
+
+using namespace std::chrono_literals;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExternalProcessing {
+namespace {
+
+class TestCallbacks : public ExternalProcessorCallbacks {
+public:
+  // ExternalProcessorCallbacks
+  void onReceiveMessage(std::unique_ptr<ProcessingResponse>&& response) override {
+    ++responses_;
+    last_response_ = std::move(response);
+  }
+  void onGrpcError(Grpc::Status::GrpcStatus status) override { grpc_status_ = status; }
+  void onGrpcClose() override { grpc_closed_ = true; }
+
+  uint32_t responses_{};
+  std::unique_ptr<ProcessingResponse> last_response_;
+  Grpc::Status::GrpcStatus grpc_status_ = Grpc::Status::WellKnownGrpcStatus::Ok;
+  bool grpc_closed_ = false;
+};
+
+class ExtProcMultiplexedClientTest : public testing::Test {
+protected:
+  void initialize(uint32_t max_streams) {
+    envoy::config::core::v3::GrpcService service;
+    service.mutable_envoy_grpc()->set_cluster_name("test");
+
+    EXPECT_CALL(client_manager_, factoryForGrpcService(_, _, _))
+        .WillOnce(Invoke(this, &ExtProcMultiplexedClientTest::doFactory));
+    client_ = std::make_unique<MultiplexedExternalProcessorClient>(client_manager_, service,
+                                                                   stats_store_, dispatcher_,
+                                                                   max_streams);
+  }
+
+  Grpc::AsyncClientFactoryPtr doFactory(Unused, Unused, Unused) {
+    auto factory = std::make_unique<Grpc::MockAsyncClientFactory>();
+    EXPECT_CALL(*factory, create()).WillOnce(Invoke([this]() -> Grpc::RawAsyncClientPtr {
+      auto async_client = std::make_unique<Grpc::MockAsyncClient>();
+      EXPECT_CALL(*async_client,
+                  startRaw("envoy.service.ext_proc.v3alpha.ExternalProcessor", "Process", _, _))
+          .WillRepeatedly(Invoke(this, &ExtProcMultiplexedClientTest::doStartRaw));
+      return async_client;
+    }));
+    return factory;
+  }
+
+  Grpc::RawAsyncStream* doStartRaw(Unused, Unused, Grpc::RawAsyncStreamCallbacks& callbacks,
+                                   const Http::AsyncClient::StreamOptions& options) {
+    // The shared streams outlive the requests, so they have no timeout.
+    EXPECT_FALSE(options.timeout.has_value());
+    stream_callbacks_.push_back(&callbacks);
+    return &streams_[stream_callbacks_.size() - 1];
+  }
+
+  void respond(size_t stream, uint64_t correlation_id) {
+    ProcessingResponse response;
+    response.set_correlation_id(correlation_id);
+    response.mutable_request_headers();
+    EXPECT_TRUE(stream_callbacks_[stream]->onReceiveMessageRaw(
+        Grpc::Common::serializeMessage(response)));
+  }
+
+  Grpc::MockAsyncClientManager client_manager_;
+  NiceMock<Grpc::MockAsyncStream> streams_[3];
+  std::vector<Grpc::RawAsyncStreamCallbacks*> stream_callbacks_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Stats::MockStore> stats_store_;
+  // Destroyed first, as it resets the streams it still has open.
+  std::unique_ptr<MultiplexedExternalProcessorClient> client_;
+};
+
+// Requests share a stream, and the responses are dispatched by their correlation ID.
+TEST_F(ExtProcMultiplexedClientTest, SharesStreamAndDispatchesResponses) {
+  initialize(1);
+  TestCallbacks callbacks_1;
+  TestCallbacks callbacks_2;
+  auto stream_1 = client_->start(callbacks_1, 200ms);
+  auto stream_2 = client_->start(callbacks_2, 200ms);
+  EXPECT_EQ(1U, client_->openStreams());
+  ASSERT_EQ(1U, stream_callbacks_.size());
+
+  // The end of a request does not end the shared stream.
+  EXPECT_CALL(streams_[0], sendMessageRaw_(_, false)).Times(2);
+  ProcessingRequest request;
+  request.mutable_request_headers();
+  stream_1->send(ProcessingRequest(request), true);
+  stream_2->send(ProcessingRequest(request), false);
+
+  respond(0, 2);
+  EXPECT_EQ(0U, callbacks_1.responses_);
+  EXPECT_EQ(1U, callbacks_2.responses_);
+  EXPECT_EQ(2U, callbacks_2.last_response_->correlation_id());
+
+  // Responses of closed or unknown requests are dropped.
+  stream_2->close();
+  respond(0, 2);
+  respond(0, 42);
+  EXPECT_EQ(1U, callbacks_2.responses_);
+  respond(0, 1);
+  EXPECT_EQ(1U, callbacks_1.responses_);
+
+  EXPECT_CALL(streams_[0], closeStream()).Times(0);
+  stream_1->close();
+  EXPECT_EQ(1U, client_->openStreams());
+  EXPECT_CALL(streams_[0], resetStream());
+  client_.reset();
+}
+
+// A stream is opened per request up to the maximum number of streams, after which requests go to
+// the stream carrying the fewest requests.
+TEST_F(ExtProcMultiplexedClientTest, OpensStreamsUpToMaxStreams) {
+  initialize(2);
+  TestCallbacks callbacks;
+  auto stream_1 = client_->start(callbacks, 200ms);
+  auto stream_2 = client_->start(callbacks, 200ms);
+  auto stream_3 = client_->start(callbacks, 200ms);
+  EXPECT_EQ(2U, client_->openStreams());
+  EXPECT_EQ(2U, stream_callbacks_.size());
+
+  // The second stream now carries the fewest requests.
+  stream_1->close();
+  stream_2->close();
+  EXPECT_CALL(streams_[1], sendMessageRaw_(_, false));
+  auto stream_4 = client_->start(callbacks, 200ms);
+  stream_4->send(ProcessingRequest(), false);
+  EXPECT_EQ(2U, stream_callbacks_.size());
+}
+
+// The requests of a stream closed by the server fail, and the next request opens a new stream.
+TEST_F(ExtProcMultiplexedClientTest, RemoteCloseFailsRequests) {
+  initialize(1);
+  TestCallbacks callbacks_1;
+  TestCallbacks callbacks_2;
+  auto stream_1 = client_->start(callbacks_1, 200ms);
+  auto stream_2 = client_->start(callbacks_2, 200ms);
+
+  EXPECT_CALL(dispatcher_, deferredDelete_(_));
+  stream_callbacks_[0]->onRemoteClose(Grpc::Status::WellKnownGrpcStatus::Unavailable, "");
+  EXPECT_EQ(Grpc::Status::WellKnownGrpcStatus::Unavailable, callbacks_1.grpc_status_);
+  EXPECT_EQ(Grpc::Status::WellKnownGrpcStatus::Unavailable, callbacks_2.grpc_status_);
+  EXPECT_EQ(0U, client_->openStreams());
+
+  // Messages of failed requests are not sent anywhere.
+  stream_1->send(ProcessingRequest(), false);
+
+  TestCallbacks callbacks_3;
+  auto stream_3 = client_->start(callbacks_3, 200ms);
+  EXPECT_EQ(2U, stream_callbacks_.size());
+  EXPECT_EQ(1U, client_->openStreams());
+}
+
+// A request failing to get a response in time fails on its own.
+TEST_F(ExtProcMultiplexedClientTest, RequestTimeout) {
+  initialize(1);
+  TestCallbacks callbacks_1;
+  TestCallbacks callbacks_2;
+  auto* timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+  auto stream_1 = client_->start(callbacks_1, 200ms);
+  auto stream_2 = client_->start(callbacks_2, 200ms);
+  EXPECT_TRUE(timer->enabled_);
+
+  timer->invokeCallback();
+  EXPECT_EQ(Grpc::Status::WellKnownGrpcStatus::DeadlineExceeded, callbacks_1.grpc_status_);
+  EXPECT_EQ(Grpc::Status::WellKnownGrpcStatus::Ok, callbacks_2.grpc_status_);
+  respond(0, 1);
+  EXPECT_EQ(0U, callbacks_1.responses_);
+  EXPECT_EQ(1U, client_->openStreams());
+}
+
+} // namespace
+} // namespace ExternalProcessing
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
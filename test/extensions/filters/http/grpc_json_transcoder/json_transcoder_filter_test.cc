@@ -637,6 +637,70 @@ TEST_F(GrpcJsonTranscoderFilterSkipRecalculatingTest, TranscodingUnaryPostSkipRe
   EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(request_data, true));
 }
 
+class GrpcJsonTranscoderFilterStreamUnaryTest : public GrpcJsonTranscoderFilterTest {
+public:
+  GrpcJsonTranscoderFilterStreamUnaryTest() : GrpcJsonTranscoderFilterTest(makeProtoConfig()) {}
+
+private:
+  const envoy::extensions::filters::http::grpc_json_transcoder::v3::GrpcJsonTranscoder
+  makeProtoConfig() {
+    auto proto_config = bookstoreProtoConfig();
+    proto_config.set_stream_unary_responses(true);
+    return proto_config;
+  }
+};
+
+TEST_F(GrpcJsonTranscoderFilterStreamUnaryTest, TranscodingUnaryPostStreamed) {
+  Http::TestRequestHeaderMapImpl request_headers{
+      {"content-type", "application/json"}, {":method", "POST"}, {":path", "/shelf"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers, false));
+  Buffer::OwnedImpl request_data{"{\"theme\": \"Children\"}"};
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(request_data, true));
+
+  Http::TestResponseHeaderMapImpl response_headers{
+      {"content-type", "application/grpc"}, {":status", "200"}, {"content-length", "42"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.encodeHeaders(response_headers, false));
+
+  bookstore::Shelf response;
+  response.set_id(20);
+  response.set_theme("Children");
+  auto response_data = Grpc::Common::serializeToGrpcFrame(response);
+
+  // The response is buffered until the message is complete, then sent along with the headers.
+  Buffer::OwnedImpl first_part;
+  first_part.move(*response_data, 8);
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_.encodeData(first_part, false));
+  EXPECT_EQ(0, first_part.length());
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.encodeData(*response_data, false));
+  EXPECT_EQ("{\"id\":\"20\",\"theme\":\"Children\"}", response_data->toString());
+  EXPECT_EQ("", response_headers.get_("content-length"));
+
+  // The trailers leave the headers already sent alone.
+  Http::TestResponseTrailerMapImpl response_trailers{{"grpc-status", "0"}};
+  EXPECT_CALL(encoder_callbacks_, addEncodedData(_, _)).Times(0);
+  EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_.encodeTrailers(response_trailers));
+  EXPECT_EQ("200", response_headers.get_(":status"));
+  EXPECT_EQ("", response_headers.get_("content-length"));
+}
+
+TEST_F(GrpcJsonTranscoderFilterStreamUnaryTest, TranscodingUnaryErrorNotStreamed) {
+  Http::TestRequestHeaderMapImpl request_headers{
+      {"content-type", "application/json"}, {":method", "POST"}, {":path", "/shelf"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers, false));
+  Buffer::OwnedImpl request_data{"{\"theme\": \"Children\"}"};
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(request_data, true));
+
+  // A response without a message still gets the HTTP status of its gRPC status.
+  Http::TestResponseHeaderMapImpl response_headers{{"content-type", "application/grpc"},
+                                                   {":status", "200"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.encodeHeaders(response_headers, false));
+  Http::TestResponseTrailerMapImpl response_trailers{{"grpc-status", "5"}};
+  EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_.encodeTrailers(response_trailers));
+  EXPECT_EQ("404", response_headers.get_(":status"));
+}
+
 TEST_F(GrpcJsonTranscoderFilterTest, TranscodingUnaryError) {
   Http::TestRequestHeaderMapImpl request_headers{
       {"content-type", "application/json"}, {":method", "POST"}, {":path", "/shelf"}};
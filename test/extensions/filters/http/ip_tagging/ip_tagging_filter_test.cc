@@ -44,7 +44,8 @@ ip_tags:
   void initializeFilter(const std::string& yaml) {
     envoy::extensions::filters::http::ip_tagging::v3::IPTagging config;
     TestUtility::loadFromYaml(yaml, config);
-    config_ = std::make_shared<IpTaggingFilterConfig>(config, "prefix.", stats_, runtime_);
+    config_ = std::make_shared<IpTaggingFilterConfig>(config, "prefix.", stats_, runtime_,
+                                                      trie_cache_);
     filter_ = std::make_unique<IpTaggingFilter>(config_);
     filter_->setDecoderFilterCallbacks(filter_callbacks_);
   }
@@ -52,6 +53,7 @@ ip_tags:
   ~IpTaggingFilterTest() override { filter_->onDestroy(); }
 
   NiceMock<Stats::MockStore> stats_;
+  IpTagTrieCacheSharedPtr trie_cache_{std::make_shared<IpTagTrieCache>()};
   IpTaggingFilterConfigSharedPtr config_;
   std::unique_ptr<IpTaggingFilter> filter_;
   NiceMock<Http::MockStreamDecoderFilterCallbacks> filter_callbacks_;
@@ -287,6 +289,29 @@ TEST_F(IpTaggingFilterTest, ClearRouteCache) {
   EXPECT_FALSE(request_headers.has(Http::Headers::get().EnvoyIpTags));
 }
 
+// The configs with the same tags share their trie.
+TEST_F(IpTaggingFilterTest, SharedTrie) {
+  initializeFilter(internal_request_yaml);
+  envoy::extensions::filters::http::ip_tagging::v3::IPTagging config;
+  TestUtility::loadFromYaml(internal_request_yaml, config);
+  config.set_request_type(envoy::extensions::filters::http::ip_tagging::v3::IPTagging::BOTH);
+  auto other_config =
+      std::make_shared<IpTaggingFilterConfig>(config, "other.", stats_, runtime_, trie_cache_);
+  EXPECT_EQ(&config_->trie(), &other_config->trie());
+
+  config.mutable_ip_tags(0)->set_ip_tag_name("other_request");
+  auto different_config =
+      std::make_shared<IpTaggingFilterConfig>(config, "other.", stats_, runtime_, trie_cache_);
+  EXPECT_NE(&config_->trie(), &different_config->trie());
+
+  const Network::Address::InstanceConstSharedPtr remote_address =
+      Network::Utility::parseInternetAddress("1.2.3.5");
+  EXPECT_EQ(std::vector<std::string>{"other_request"},
+            different_config->trie().getData(remote_address));
+  EXPECT_EQ(std::vector<std::string>{"internal_request"},
+            other_config->trie().getData(remote_address));
+}
+
 // Test that the deprecated extension name still functions.
 TEST(IpTaggingFilterConfigTest, DEPRECATED_FEATURE_TEST(DeprecatedExtensionFilterName)) {
   const std::string deprecated_name = "envoy.ip_tagging";
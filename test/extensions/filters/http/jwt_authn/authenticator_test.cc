@@ -517,6 +517,39 @@ TEST_F(AuthenticatorTest, TestCustomCheckAudience) {
   expectVerifyStatus(Status::JwtAudienceNotAllowed, headers2);
 }
 
+// This test verifies that verified tokens are cached, and that a cached token is still checked
+// against the audiences of the requirement and dropped when the JWKS changes.
+TEST_F(AuthenticatorTest, TestVerifiedJwtCache) {
+  (*proto_config_.mutable_providers())[std::string(ProviderName)].mutable_jwt_cache_config();
+  createAuthenticator();
+  EXPECT_CALL(*raw_fetcher_, fetch(_, _, _))
+      .WillOnce(Invoke([this](const envoy::config::core::v3::HttpUri&, Tracing::Span&,
+                              JwksFetcher::JwksReceiver& receiver) {
+        receiver.onJwksSuccess(std::move(jwks_));
+      }));
+
+  auto* jwks_data = filter_config_->getCache().getJwksCache().findByProvider(ProviderName);
+  for (int i = 0; i < 2; i++) {
+    Http::TestRequestHeaderMapImpl headers{{"Authorization", "Bearer " + std::string(GoodToken)}};
+    expectVerifyStatus(Status::Ok, headers);
+    EXPECT_EQ(headers.get_("sec-istio-auth-userinfo"), ExpectedPayloadValue);
+    EXPECT_FALSE(headers.has(Http::CustomHeaders::get().Authorization));
+    EXPECT_NE(jwks_data->findVerifiedJwt(GoodToken), nullptr);
+  }
+
+  auto check_audience = std::make_unique<::google::jwt_verify::CheckAudience>(
+      std::vector<std::string>{"invalid_service"});
+  auth_ = Authenticator::create(
+      check_audience.get(), absl::make_optional<std::string>(ProviderName), false, false,
+      filter_config_->getCache().getJwksCache(), filter_config_->cm(),
+      [](Upstream::ClusterManager&) { return nullptr; }, filter_config_->timeSource());
+  Http::TestRequestHeaderMapImpl headers{{"Authorization", "Bearer " + std::string(GoodToken)}};
+  expectVerifyStatus(Status::JwtAudienceNotAllowed, headers);
+
+  jwks_data->setRemoteJwks(Jwks::createFrom(PublicKey, Jwks::JWKS));
+  EXPECT_EQ(jwks_data->findVerifiedJwt(GoodToken), nullptr);
+}
+
 // This test verifies that when invalid JWKS is fetched, an JWKS error status is returned.
 TEST_F(AuthenticatorTest, TestInvalidPubkeyKey) {
   EXPECT_CALL(*raw_fetcher_, fetch(_, _, _))
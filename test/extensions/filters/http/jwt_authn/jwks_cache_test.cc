@@ -144,6 +144,43 @@ TEST_F(JwksCacheTest, TestFindByProvider) {
   EXPECT_TRUE(cache_->findByProvider("other-provider") == nullptr);
 }
 
+// Test the cache of verified tokens: its size bound and its invalidation with the Jwks.
+TEST_F(JwksCacheTest, TestVerifiedJwtCache) {
+  auto jwt = std::make_shared<const ::google::jwt_verify::Jwt>();
+
+  // Without a cache config, verified tokens are not cached.
+  auto jwks = cache_->findByProvider(ProviderName);
+  jwks->setRemoteJwks(
+      google::jwt_verify::Jwks::createFrom(PublicKey, google::jwt_verify::Jwks::JWKS));
+  jwks->addVerifiedJwt("token1", jwt);
+  EXPECT_EQ(jwks->findVerifiedJwt("token1"), nullptr);
+
+  auto& provider0 = (*config_.mutable_providers())[std::string(ProviderName)];
+  provider0.mutable_jwt_cache_config()->set_jwt_cache_size(1);
+  provider0.mutable_remote_jwks()->mutable_cache_duration()->set_seconds(1);
+  cache_ = JwksCache::create(config_, time_system_, *api_);
+  jwks = cache_->findByProvider(ProviderName);
+
+  // Verified tokens are not found without a valid Jwks.
+  jwks->addVerifiedJwt("token1", jwt);
+  EXPECT_EQ(jwks->findVerifiedJwt("token1"), nullptr);
+
+  jwks->setRemoteJwks(std::move(jwks_));
+  jwks->addVerifiedJwt("token1", jwt);
+  EXPECT_EQ(jwks->findVerifiedJwt("token1"), jwt);
+  jwks->addVerifiedJwt("token2", jwt);
+  EXPECT_EQ(jwks->findVerifiedJwt("token1"), nullptr);
+  EXPECT_EQ(jwks->findVerifiedJwt("token2"), jwt);
+
+  time_system_.advanceTimeWait(std::chrono::seconds(2));
+  EXPECT_EQ(jwks->findVerifiedJwt("token2"), nullptr);
+
+  // Setting a new Jwks drops the tokens verified with the previous one.
+  jwks->setRemoteJwks(
+      google::jwt_verify::Jwks::createFrom(PublicKey, google::jwt_verify::Jwks::JWKS));
+  EXPECT_EQ(jwks->findVerifiedJwt("token2"), nullptr);
+}
+
 } // namespace
 } // namespace JwtAuthn
 } // namespace HttpFilters
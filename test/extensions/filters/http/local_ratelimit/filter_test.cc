@@ -3,6 +3,8 @@
 #include "extensions/filters/http/local_ratelimit/local_ratelimit.h"
 
 #include "test/mocks/http/mocks.h"
+#include "test/mocks/local_info/mocks.h"
+#include "test/mocks/router/mocks.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -53,7 +55,7 @@ public:
 
     envoy::extensions::filters::http::local_ratelimit::v3::LocalRateLimit config;
     TestUtility::loadFromYaml(yaml, config);
-    config_ = std::make_shared<FilterConfig>(config, dispatcher_, stats_, runtime_);
+    config_ = std::make_shared<FilterConfig>(config, local_info_, dispatcher_, stats_, runtime_);
     filter_ = std::make_shared<Filter>(config_);
     filter_->setDecoderFilterCallbacks(decoder_callbacks_);
   }
@@ -68,6 +70,7 @@ public:
   Stats::IsolatedStoreImpl stats_;
   testing::NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
   NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<LocalInfo::MockLocalInfo> local_info_;
   NiceMock<Runtime::MockLoader> runtime_;
   std::shared_ptr<FilterConfig> config_;
   std::shared_ptr<Filter> filter_;
@@ -140,6 +143,53 @@ TEST_F(FilterTest, RequestRateLimitedButNotEnforced) {
   EXPECT_EQ(1U, findCounter("test.http_local_rate_limit.rate_limited"));
 }
 
+static const std::string descriptors_config_yaml = R"(
+stat_prefix: test
+filter_enabled:
+  runtime_key: test_enabled
+  default_value:
+    numerator: 100
+    denominator: HUNDRED
+filter_enforced:
+  runtime_key: test_enforced
+  default_value:
+    numerator: 100
+    denominator: HUNDRED
+descriptors:
+- entries:
+  - key: client_id
+  token_bucket:
+    max_tokens: 1
+    tokens_per_fill: 1
+    fill_interval: 1000s
+  )";
+
+// Without a token bucket, only the descriptors generated by the rate limit actions of the route
+// are rate limited, each value of the client ID with its own bucket.
+TEST_F(FilterTest, RequestRateLimitedByDescriptor) {
+  setup(descriptors_config_yaml);
+  NiceMock<Router::MockRateLimitPolicyEntry> rate_limit;
+  auto& rate_limit_policy = decoder_callbacks_.route_->route_entry_.rate_limit_policy_;
+  ON_CALL(rate_limit_policy, empty()).WillByDefault(testing::Return(false));
+  rate_limit_policy.rate_limit_policy_entry_.emplace_back(rate_limit);
+  std::string client_id;
+  ON_CALL(rate_limit, populateDescriptors(_, _, _, _, _, _))
+      .WillByDefault(testing::WithArg<1>(
+          Invoke([&client_id](std::vector<RateLimit::Descriptor>& descriptors) {
+            descriptors.push_back({{{"client_id", client_id}}});
+          })));
+  EXPECT_CALL(decoder_callbacks_, sendLocalReply(Http::Code::TooManyRequests, _, _, _, _));
+
+  auto headers = Http::TestRequestHeaderMapImpl();
+  client_id = "a";
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration, filter_->decodeHeaders(headers, false));
+  client_id = "b";
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, false));
+  EXPECT_EQ(2U, findCounter("test.http_local_rate_limit.ok"));
+  EXPECT_EQ(1U, findCounter("test.http_local_rate_limit.rate_limited"));
+}
+
 } // namespace LocalRateLimitFilter
 } // namespace HttpFilters
 } // namespace Extensions
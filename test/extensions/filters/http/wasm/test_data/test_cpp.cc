@@ -129,6 +129,27 @@ FilterHeadersStatus TestContext::onRequestHeaders(uint32_t, bool) {
     } else {
       return FilterHeadersStatus::Continue;
     }
+  } else if (test == "batched_headers") {
+    if (replaceHeaderMapValues(WasmHeaderMapType::RequestHeaders,
+                               {{"server", "envoy-wasm"}, {"newheader", "newheadervalue"}}) !=
+        WasmResult::Ok) {
+      logWarn("unexpected failure of replaceHeaderMapValues");
+    }
+    WasmDataPtr values;
+    if (getHeaderMapValues(WasmHeaderMapType::RequestHeaders, {":path", "cookie", "missing"},
+                           &values) != WasmResult::Ok) {
+      logWarn("unexpected failure of getHeaderMapValues");
+      return FilterHeadersStatus::Continue;
+    }
+    for (const auto& value : values->pairs()) {
+      logInfo(std::string("header ") + std::string(value.first) + " " +
+              std::string(value.second));
+    }
+    if (getHeaderMapValues(WasmHeaderMapType::ResponseHeaders, {"server"}, &values) !=
+        WasmResult::BadArgument) {
+      logWarn("unexpected success of getHeaderMapValues");
+    }
+    return FilterHeadersStatus::Continue;
   } else if (test == "metadata") {
     std::string value;
     if (!getValue({"node", "metadata", "wasm_node_get_key"}, &value)) {
@@ -7,6 +7,7 @@
 #include "test/mocks/router/mocks.h"
 #include "test/test_common/wasm_base.h"
 
+using testing::_;
 using testing::Eq;
 using testing::InSequence;
 using testing::Invoke;
@@ -135,6 +136,32 @@ TEST_P(WasmHttpFilterTest, HeadersOnlyRequestHeadersOnly) {
   filter().onDestroy();
 }
 
+// Headers are read and replaced in batches by the get_header_map_values and
+// replace_header_map_values foreign functions.
+TEST_P(WasmHttpFilterTest, BatchedHeaders) {
+  if (std::get<1>(GetParam()) == "rust") {
+    // The foreign functions are only wrapped by the C++ SDK extensions.
+    return;
+  }
+  setupTest("", "batched_headers");
+  setupFilter();
+  EXPECT_CALL(filter(), log_(spdlog::level::info, Eq(absl::string_view("header :path /"))));
+  EXPECT_CALL(filter(), log_(spdlog::level::info, Eq(absl::string_view("header cookie a=b"))));
+  EXPECT_CALL(filter(), log_(spdlog::level::info, Eq(absl::string_view("header cookie c=d"))));
+  EXPECT_CALL(filter(), log_(spdlog::level::warn, _)).Times(0);
+
+  Http::MockStreamDecoderFilterCallbacks decoder_callbacks;
+  filter().setDecoderFilterCallbacks(decoder_callbacks);
+  EXPECT_CALL(decoder_callbacks, clearRouteCache());
+
+  Http::TestRequestHeaderMapImpl request_headers{
+      {":path", "/"}, {"server", "envoy"}, {"cookie", "a=b"}, {"cookie", "c=d"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter().decodeHeaders(request_headers, true));
+  EXPECT_THAT(request_headers.get_("newheader"), Eq("newheadervalue"));
+  EXPECT_THAT(request_headers.get_("server"), Eq("envoy-wasm"));
+  filter().onDestroy();
+}
+
 TEST_P(WasmHttpFilterTest, AllHeadersAndTrailers) {
   setupTest("", "headers");
   setupFilter();
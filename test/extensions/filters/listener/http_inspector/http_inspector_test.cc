@@ -117,6 +117,26 @@ TEST_F(HttpInspectorTest, InlineReadInspectHttp10) {
   EXPECT_EQ(1, cfg_->stats().http10_found_.value());
 }
 
+// The bytes peeked by a previous listener filter are inspected without reading the socket again.
+TEST_F(HttpInspectorTest, PeekedByPreviousFilter) {
+  init(/*include_inline_recv=*/false);
+  const absl::string_view header = "GET /anything HTTP/1.1\r\nhost: google.com\r\n\r\n";
+  EXPECT_CALL(os_sys_calls_, recv(42, _, _, MSG_PEEK))
+      .WillOnce(
+          Invoke([&header](os_fd_t, void* buffer, size_t length, int) -> Api::SysCallSizeResult {
+            ASSERT(length >= header.size());
+            memcpy(buffer, header.data(), header.size());
+            return Api::SysCallSizeResult{ssize_t(header.size()), 0};
+          }));
+  cb_.listenerFilterBuffer().peek(1024);
+
+  const std::vector<absl::string_view> alpn_protos{Http::Utility::AlpnNames::get().Http11};
+  EXPECT_CALL(dispatcher_, createFileEvent_(_, _, _, _)).Times(0);
+  EXPECT_CALL(socket_, setRequestedApplicationProtocols(alpn_protos));
+  EXPECT_EQ(Network::FilterStatus::Continue, filter_->onAccept(cb_));
+  EXPECT_EQ(1, cfg_->stats().http11_found_.value());
+}
+
 TEST_F(HttpInspectorTest, InlineReadParseError) {
   init(/*include_inline_recv=*/false);
   const absl::string_view header =
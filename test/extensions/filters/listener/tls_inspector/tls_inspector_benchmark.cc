@@ -1,3 +1,4 @@
+#include <string>
 #include <vector>
 
 #include "common/api/os_sys_calls_impl.h"
@@ -13,6 +14,7 @@
 #include "test/mocks/stats/mocks.h"
 #include "test/test_common/threadsafe_singleton_injector.h"
 
+#include "absl/strings/str_cat.h"
 #include "benchmark/benchmark.h"
 #include "gtest/gtest.h"
 #include "openssl/ssl.h"
@@ -56,17 +58,23 @@ public:
   Event::FileReadyCb file_event_callback_;
 };
 
+// Returns the ClientHello chunk_size more bytes at a time, from its start as with MSG_PEEK.
 class FastMockOsSysCalls : public Api::MockOsSysCalls {
 public:
-  FastMockOsSysCalls(const std::vector<uint8_t>& client_hello) : client_hello_(client_hello) {}
+  FastMockOsSysCalls(const std::vector<uint8_t>& client_hello, size_t chunk_size = 0)
+      : client_hello_(client_hello),
+        chunk_size_(chunk_size > 0 ? chunk_size : client_hello_.size()) {}
 
   Api::SysCallSizeResult recv(os_fd_t, void* buffer, size_t length, int) override {
     RELEASE_ASSERT(length >= client_hello_.size(), "");
-    memcpy(buffer, client_hello_.data(), client_hello_.size());
-    return Api::SysCallSizeResult{ssize_t(client_hello_.size()), 0};
+    received_ = std::min(received_ + chunk_size_, client_hello_.size());
+    memcpy(buffer, client_hello_.data(), received_);
+    return Api::SysCallSizeResult{ssize_t(received_), 0};
   }
 
   const std::vector<uint8_t> client_hello_;
+  const size_t chunk_size_;
+  size_t received_{};
 };
 
 static void BM_TlsInspector(benchmark::State& state) {
@@ -82,6 +90,7 @@ static void BM_TlsInspector(benchmark::State& state) {
   FastMockListenerFilterCallbacks cb(socket, dispatcher);
 
   for (auto _ : state) {
+    os_sys_calls.received_ = 0;
     Filter filter(cfg);
     filter.onAccept(cb);
     RELEASE_ASSERT(dispatcher.file_event_callback_ == nullptr, "");
@@ -99,6 +108,51 @@ static void BM_TlsInspector(benchmark::State& state) {
 
 BENCHMARK(BM_TlsInspector)->Unit(benchmark::kMicrosecond);
 
+// A ClientHello with a long list of ALPN protocols, about the size of one with post-quantum key
+// shares, that arrives state.range(0) bytes at a time, so that the filter peeks and parses it
+// once per chunk.
+static void BM_TlsInspectorLargeClientHello(benchmark::State& state) {
+  std::string alpn;
+  for (int i = 0; i < 100; ++i) {
+    const std::string protocol = absl::StrCat("protocol-", i);
+    alpn.push_back(protocol.size());
+    alpn.append(protocol);
+  }
+  const std::vector<uint8_t> client_hello = Tls::Test::generateClientHello(
+      Config::TLS_MIN_SUPPORTED_VERSION, Config::TLS_MAX_SUPPORTED_VERSION, "example.com", alpn);
+  NiceMock<FastMockOsSysCalls> os_sys_calls(client_hello, state.range(0));
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls{&os_sys_calls};
+  NiceMock<Stats::MockStore> store;
+  ConfigSharedPtr cfg(std::make_shared<Config>(store));
+  Network::IoHandlePtr io_handle = std::make_unique<Network::IoSocketHandleImpl>();
+  Network::ConnectionSocketImpl socket(std::move(io_handle), nullptr, nullptr);
+  NiceMock<FastMockDispatcher> dispatcher;
+  FastMockListenerFilterCallbacks cb(socket, dispatcher);
+
+  for (auto _ : state) {
+    os_sys_calls.received_ = 0;
+    dispatcher.file_event_callback_ = nullptr;
+    Filter filter(cfg);
+    filter.onAccept(cb);
+    while (socket.detectedTransportProtocol().empty()) {
+      RELEASE_ASSERT(dispatcher.file_event_callback_ != nullptr, "");
+      dispatcher.file_event_callback_(Event::FileReadyType::Read);
+    }
+    RELEASE_ASSERT(socket.requestedServerName() == "example.com", "");
+    RELEASE_ASSERT(socket.requestedApplicationProtocols().size() == 100, "");
+    socket.setDetectedTransportProtocol("");
+    socket.setRequestedServerName("");
+    socket.setRequestedApplicationProtocols({});
+  }
+  state.counters["client_hello_size"] = client_hello.size();
+}
+
+BENCHMARK(BM_TlsInspectorLargeClientHello)
+    ->Unit(benchmark::kMicrosecond)
+    ->Arg(0)
+    ->Arg(1460)
+    ->Arg(100);
+
 } // namespace TlsInspector
 } // namespace ListenerFilters
 } // namespace Extensions
@@ -125,6 +125,32 @@ TEST_P(TlsInspectorTest, SniRegistered) {
   EXPECT_EQ(1, cfg_->stats().alpn_not_found_.value());
 }
 
+// Test that the ClientHello peeked by a previous listener filter is parsed without reading the
+// socket again.
+TEST_P(TlsInspectorTest, PeekedByPreviousFilter) {
+  filter_ = std::make_unique<Filter>(cfg_);
+  EXPECT_CALL(cb_, socket()).WillRepeatedly(ReturnRef(socket_));
+  EXPECT_CALL(socket_, ioHandle()).WillRepeatedly(ReturnRef(*io_handle_));
+  const std::string servername("example.com");
+  std::vector<uint8_t> client_hello = Tls::Test::generateClientHello(
+      std::get<0>(GetParam()), std::get<1>(GetParam()), servername, "");
+  EXPECT_CALL(os_sys_calls_, recv(42, _, _, MSG_PEEK))
+      .WillOnce(Invoke(
+          [&client_hello](os_fd_t, void* buffer, size_t length, int) -> Api::SysCallSizeResult {
+            ASSERT(length >= client_hello.size());
+            memcpy(buffer, client_hello.data(), client_hello.size());
+            return Api::SysCallSizeResult{ssize_t(client_hello.size()), 0};
+          }));
+  cb_.listenerFilterBuffer().peek(Config::TLS_MAX_CLIENT_HELLO);
+
+  EXPECT_CALL(dispatcher_, createFileEvent_(_, _, _, _)).Times(0);
+  EXPECT_CALL(socket_, setRequestedServerName(Eq(servername)));
+  EXPECT_CALL(socket_, setDetectedTransportProtocol(absl::string_view("tls")));
+  EXPECT_EQ(Network::FilterStatus::Continue, filter_->onAccept(cb_));
+  EXPECT_EQ(1, cfg_->stats().tls_found_.value());
+  EXPECT_EQ(1, cfg_->stats().sni_found_.value());
+}
+
 // Test that a ClientHello with an ALPN value causes the correct name notification.
 TEST_P(TlsInspectorTest, AlpnRegistered) {
   init();
@@ -188,6 +214,68 @@ TEST_P(TlsInspectorTest, MultipleReads) {
   EXPECT_EQ(1, cfg_->stats().alpn_found_.value());
 }
 
+// Test with the ClientHello split across two TLS records.
+TEST_P(TlsInspectorTest, MultipleRecords) {
+  init();
+  const std::string servername("example.com");
+  std::vector<uint8_t> client_hello = Tls::Test::generateClientHello(
+      std::get<0>(GetParam()), std::get<1>(GetParam()), servername, "\x02h2");
+  // Move the second half of the handshake message of the record into a record of its own.
+  const size_t first_len = (client_hello.size() - 5) / 2;
+  std::vector<uint8_t> records(client_hello.begin(), client_hello.begin() + 5 + first_len);
+  records[3] = first_len >> 8;
+  records[4] = first_len & 0xff;
+  const size_t second_len = client_hello.size() - 5 - first_len;
+  records.insert(records.end(), {client_hello[0], client_hello[1], client_hello[2],
+                                 static_cast<uint8_t>(second_len >> 8),
+                                 static_cast<uint8_t>(second_len & 0xff)});
+  records.insert(records.end(), client_hello.begin() + 5 + first_len, client_hello.end());
+
+  EXPECT_CALL(os_sys_calls_, recv(42, _, _, MSG_PEEK))
+      .WillOnce(
+          Invoke([&records](os_fd_t, void* buffer, size_t length, int) -> Api::SysCallSizeResult {
+            ASSERT(length >= records.size());
+            memcpy(buffer, records.data(), records.size() - 1);
+            return Api::SysCallSizeResult{ssize_t(records.size() - 1), 0};
+          }))
+      .WillOnce(
+          Invoke([&records](os_fd_t, void* buffer, size_t length, int) -> Api::SysCallSizeResult {
+            ASSERT(length >= records.size());
+            memcpy(buffer, records.data(), records.size());
+            return Api::SysCallSizeResult{ssize_t(records.size()), 0};
+          }));
+  EXPECT_CALL(socket_, setRequestedServerName(Eq(servername)));
+  EXPECT_CALL(socket_, setRequestedApplicationProtocols(_));
+  EXPECT_CALL(socket_, setDetectedTransportProtocol(absl::string_view("tls")));
+  EXPECT_CALL(cb_, continueFilterChain(true));
+  file_event_callback_(Event::FileReadyType::Read);
+  file_event_callback_(Event::FileReadyType::Read);
+  EXPECT_EQ(1, cfg_->stats().tls_found_.value());
+  EXPECT_EQ(1, cfg_->stats().sni_found_.value());
+  EXPECT_EQ(1, cfg_->stats().alpn_found_.value());
+}
+
+// Test that a TLS handshake record that does not start with a ClientHello is not TLS.
+TEST_P(TlsInspectorTest, NotClientHello) {
+  init();
+  std::vector<uint8_t> client_hello = Tls::Test::generateClientHello(
+      std::get<0>(GetParam()), std::get<1>(GetParam()), "example.com", "");
+  // Turn the handshake message into a ServerHello.
+  client_hello[5] = SSL3_MT_SERVER_HELLO;
+  EXPECT_CALL(os_sys_calls_, recv(42, _, _, MSG_PEEK))
+      .WillOnce(Invoke(
+          [&client_hello](os_fd_t, void* buffer, size_t length, int) -> Api::SysCallSizeResult {
+            ASSERT(length >= client_hello.size());
+            memcpy(buffer, client_hello.data(), client_hello.size());
+            return Api::SysCallSizeResult{ssize_t(client_hello.size()), 0};
+          }));
+  EXPECT_CALL(socket_, setRequestedServerName(_)).Times(0);
+  EXPECT_CALL(socket_, setDetectedTransportProtocol(_)).Times(0);
+  EXPECT_CALL(cb_, continueFilterChain(true));
+  file_event_callback_(Event::FileReadyType::Read);
+  EXPECT_EQ(1, cfg_->stats().tls_not_found_.value());
+}
+
 // Test that the filter correctly handles a ClientHello with no extensions present.
 TEST_P(TlsInspectorTest, NoExtensions) {
   init();
@@ -9,6 +9,7 @@
 #include "test/test_common/printers.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "gtest/gtest.h"
 
 using testing::ContainerEq;
@@ -397,6 +398,39 @@ TEST_F(RedisEncoderDecoderImplTest, NestedArray) {
   EXPECT_EQ(value, *decoded_values_[0]);
 }
 
+// Arrays too large to be written at once are written piece by piece.
+TEST_F(RedisEncoderDecoderImplTest, LargeArray) {
+  std::vector<RespValue> values(3);
+  values[0].type(RespType::BulkString);
+  values[0].asString() = "set";
+  values[1].type(RespType::BulkString);
+  values[1].asString() = "foo";
+  values[2].type(RespType::BulkString);
+  values[2].asString() = std::string(20000, 'v');
+
+  RespValue value;
+  value.type(RespType::Array);
+  value.asArray().swap(values);
+  encoder_.encode(value, buffer_);
+  EXPECT_EQ(absl::StrCat("*3\r\n$3\r\nset\r\n$3\r\nfoo\r\n$20000\r\n", std::string(20000, 'v'),
+                         "\r\n"),
+            buffer_.toString());
+  decoder_.decode(buffer_);
+  EXPECT_EQ(value, *decoded_values_[0]);
+}
+
+// Integers and simple strings split across slices are decoded whole.
+TEST_F(RedisEncoderDecoderImplTest, SplitAcrossSlices) {
+  for (const char* part : {":12", "34\r", "\n+OK a", "nd more\r\n"}) {
+    Buffer::OwnedImpl temp_buffer(part);
+    decoder_.decode(temp_buffer);
+  }
+
+  ASSERT_EQ(2UL, decoded_values_.size());
+  EXPECT_EQ(1234, decoded_values_[0]->asInteger());
+  EXPECT_EQ("OK and more", decoded_values_[1]->asString());
+}
+
 TEST_F(RedisEncoderDecoderImplTest, NullArray) {
   buffer_.add("*-1\r\n");
   decoder_.decode(buffer_);
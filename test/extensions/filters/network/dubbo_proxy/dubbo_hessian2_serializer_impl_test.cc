@@ -60,6 +60,63 @@ TEST(HessianProtocolTest, deserializeRpcInvocation) {
   }
 }
 
+// The arguments and the attachments are decoded from the message origin data once they are used.
+TEST(HessianProtocolTest, deserializeRpcInvocationLazily) {
+  DubboHessian2SerializerImpl serializer;
+
+  {
+    Buffer::OwnedImpl buffer;
+    buffer.add(std::string({
+        0x05, '2', '.', '0', '.', '2', // Dubbo version
+        0x04, 't', 'e', 's', 't',      // Service name
+        0x05, '0', '.', '0', '.', '0', // Service version
+        0x04, 't', 'e', 's', 't',      // method name
+    }));
+    buffer.add(std::string("\x13Ljava/lang/String;I")); // Parameter types
+    buffer.add(std::string({
+        0x03, 'f', 'o', 'o', '\x91',                          // Arguments
+        'H', 0x05, 'g', 'r', 'o', 'u', 'p', 0x03, 'd', 'e', 'v', // Attachments
+        'Z',
+    }));
+    std::shared_ptr<ContextImpl> context = std::make_shared<ContextImpl>();
+    context->setBodySize(buffer.length());
+    auto result = serializer.deserializeRpcInvocation(buffer, context);
+    EXPECT_TRUE(result.second);
+    context->messageOriginData().move(buffer);
+
+    const auto& invo = dynamic_cast<const RpcInvocationImpl&>(*result.first);
+    EXPECT_EQ("foo", invo.getParameterValue(0));
+    EXPECT_EQ("1", invo.getParameterValue(1));
+    ASSERT_TRUE(invo.hasHeaders());
+    const auto group = invo.headers().get(Http::LowerCaseString("group"));
+    ASSERT_EQ(1, group.size());
+    EXPECT_EQ("dev", group[0]->value().getStringView());
+    EXPECT_EQ(context->bodySize(), context->messageOriginData().length());
+  }
+
+  // Nothing is decoded past an argument of a type which is not basic.
+  {
+    Buffer::OwnedImpl buffer;
+    buffer.add(std::string({
+        0x05, '2', '.', '0', '.', '2', // Dubbo version
+        0x04, 't', 'e', 's', 't',      // Service name
+        0x05, '0', '.', '0', '.', '0', // Service version
+        0x04, 't', 'e', 's', 't',      // method name
+        0x02, '[', 'I',                // Parameter types
+        'V', '\x91', '\x92',            // Arguments
+        'H', 0x01, 'a', 0x01, 'b', 'Z', // Attachments
+    }));
+    std::shared_ptr<ContextImpl> context = std::make_shared<ContextImpl>();
+    context->setBodySize(buffer.length());
+    auto result = serializer.deserializeRpcInvocation(buffer, context);
+    context->messageOriginData().move(buffer);
+
+    const auto& invo = dynamic_cast<const RpcInvocationImpl&>(*result.first);
+    EXPECT_FALSE(invo.hasParameters());
+    EXPECT_FALSE(invo.hasHeaders());
+  }
+}
+
 TEST(HessianProtocolTest, deserializeRpcResult) {
   DubboHessian2SerializerImpl serializer;
   std::shared_ptr<ContextImpl> context = std::make_shared<ContextImpl>();
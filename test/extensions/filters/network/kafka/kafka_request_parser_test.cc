@@ -192,6 +192,49 @@ TEST_F(KafkaRequestParserTest, SentinelParserShouldConsumeDataUntilEndOfRequest)
   assertStringViewIncrement(data, orig_data, request_len);
 }
 
+TEST_F(KafkaRequestParserTest, RequestDataSkipParserShouldConsumeDataUntilEndOfRequest) {
+  // given
+  const uint32_t request_len = 1000;
+  const RequestHeader header = {0, 0, 10, "client-id"};
+  RequestContextSharedPtr context{new RequestContext{request_len, header}};
+  RequestDataSkipParser testee{context};
+
+  const absl::string_view orig_data = putGarbageIntoBuffer(request_len * 2);
+  absl::string_view data = orig_data;
+
+  // when
+  const RequestParseResponse result = testee.parse(data);
+
+  // then
+  ASSERT_EQ(result.hasData(), true);
+  ASSERT_EQ(result.next_parser_, nullptr);
+  ASSERT_EQ(result.failure_data_, nullptr);
+  const auto request = std::dynamic_pointer_cast<UnparsedRequest>(result.message_);
+  ASSERT_NE(request, nullptr);
+  ASSERT_EQ(request->request_header_, header);
+  ASSERT_EQ(request->data_size_, request_len);
+  Buffer::OwnedImpl buffer;
+  EXPECT_THROW(request->encode(buffer), EnvoyException);
+
+  ASSERT_EQ(testee.contextForTest()->remaining_request_size_, 0);
+
+  assertStringViewIncrement(data, orig_data, request_len);
+}
+
+TEST_F(KafkaRequestParserTest, HeaderOnlyRequestParserResolverShouldSkipSupportedRequests) {
+  // given
+  const RequestParserResolver& testee = HeaderOnlyRequestParserResolver::getInstance();
+  RequestContextSharedPtr context{new RequestContext()};
+
+  // when
+  const RequestParserSharedPtr supported = testee.createParser(0, 0, context);
+  const RequestParserSharedPtr unknown = testee.createParser(100, 0, context);
+
+  // then
+  ASSERT_NE(std::dynamic_pointer_cast<RequestDataSkipParser>(supported), nullptr);
+  ASSERT_NE(std::dynamic_pointer_cast<SentinelParser>(unknown), nullptr);
+}
+
 } // namespace KafkaRequestParserTest
 } // namespace Kafka
 } // namespace NetworkFilters
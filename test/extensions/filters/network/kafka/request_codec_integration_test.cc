@@ -58,6 +58,39 @@ TEST_F(RequestCodecIntegrationTest, ShouldProduceAbortedMessageOnUnknownData) {
   }
 }
 
+TEST_F(RequestCodecIntegrationTest, ShouldSkipDataOfSupportedRequestsWithHeaderOnlyResolver) {
+  // given
+  // Data of a produce request is not deserialized, so it does not need to be valid.
+  const RequestHeader supported_header = {0, 0, 0, "client-id"};
+  const auto supported = Request<std::vector<unsigned char>>{supported_header,
+                                                             std::vector<unsigned char>(1024)};
+  putMessageIntoBuffer(supported);
+  const RequestHeader unknown_header = {100, 0, 1, "client-id"};
+  putMessageIntoBuffer(
+      Request<std::vector<unsigned char>>{unknown_header, std::vector<unsigned char>(1024)});
+
+  const auto request_callback = std::make_shared<RequestCapturingCallback>();
+  RequestDecoder testee{InitialParserFactory::getDefaultInstance(),
+                        HeaderOnlyRequestParserResolver::getInstance(),
+                        {request_callback}};
+
+  // when
+  testee.onData(buffer_);
+
+  // then
+  const std::vector<AbstractRequestSharedPtr>& requests = request_callback->getCapturedMessages();
+  ASSERT_EQ(requests.size(), 1);
+  const auto request = std::dynamic_pointer_cast<UnparsedRequest>(requests[0]);
+  ASSERT_NE(request, nullptr);
+  ASSERT_EQ(request->request_header_, supported_header);
+  ASSERT_EQ(request->computeSize(), supported.computeSize());
+
+  const std::vector<RequestParseFailureSharedPtr>& parse_failures =
+      request_callback->getParseFailures();
+  ASSERT_EQ(parse_failures.size(), 1);
+  ASSERT_EQ(parse_failures[0]->request_header_, unknown_header);
+}
+
 } // namespace RequestCodecIntegrationTest
 } // namespace Kafka
 } // namespace NetworkFilters
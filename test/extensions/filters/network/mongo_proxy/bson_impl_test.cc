@@ -52,6 +52,63 @@ TEST(BsonImplTest, InvalodDocumentTermination) {
   EXPECT_THROW(DocumentImpl::create(buffer), EnvoyException);
 }
 
+TEST(BsonImplTest, LazyDocument) {
+  DocumentSharedPtr doc = DocumentImpl::create()
+                              ->addString("hello", "world")
+                              ->addDocument("document", DocumentImpl::create()->addInt32("a", 1));
+  Buffer::OwnedImpl buffer;
+  doc->encode(buffer);
+  const std::string encoded = buffer.toString();
+  buffer.add("next");
+
+  DocumentSharedPtr lazy_doc = LazyDocumentImpl::create(buffer);
+  const LazyDocumentImpl& lazy = dynamic_cast<const LazyDocumentImpl&>(*lazy_doc);
+  EXPECT_EQ("next", buffer.toString());
+
+  // The document is measured and encoded without being parsed.
+  EXPECT_EQ(doc->byteSize(), lazy_doc->byteSize());
+  Buffer::OwnedImpl output;
+  lazy_doc->encode(output);
+  EXPECT_EQ(encoded, output.toString());
+  EXPECT_FALSE(lazy.parsed());
+
+  EXPECT_EQ("world", lazy_doc->find("hello")->asString());
+  EXPECT_TRUE(lazy.parsed());
+  EXPECT_TRUE(*lazy_doc == *doc);
+  EXPECT_EQ(doc->toString(), lazy_doc->toString());
+
+  lazy_doc->addInt64("int64", 2);
+  doc->addInt64("int64", 2);
+  EXPECT_EQ(doc->byteSize(), lazy_doc->byteSize());
+  output.drain(output.length());
+  lazy_doc->encode(output);
+  buffer.drain(buffer.length());
+  doc->encode(buffer);
+  EXPECT_EQ(buffer.toString(), output.toString());
+}
+
+TEST(BsonImplTest, LazyInvalidMessageLength) {
+  {
+    Buffer::OwnedImpl buffer;
+    BufferHelper::writeInt32(buffer, 100);
+    EXPECT_THROW(LazyDocumentImpl::create(buffer), EnvoyException);
+  }
+
+  {
+    Buffer::OwnedImpl buffer;
+    BufferHelper::writeInt32(buffer, 4);
+    EXPECT_THROW(LazyDocumentImpl::create(buffer), EnvoyException);
+  }
+}
+
+TEST(BsonImplTest, LazyInvalidDocumentTermination) {
+  Buffer::OwnedImpl buffer;
+  BufferHelper::writeInt32(buffer, 5);
+  uint8_t invalid_document_end = 0x1;
+  buffer.add(&invalid_document_end, sizeof(invalid_document_end));
+  EXPECT_THROW(LazyDocumentImpl::create(buffer), EnvoyException);
+}
+
 TEST(BufferHelperTest, InvalidSize) {
   {
     Buffer::OwnedImpl buffer;
@@ -11,7 +11,9 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::_;
 using testing::Eq;
+using testing::Invoke;
 using testing::NiceMock;
 using testing::Pointee;
 
@@ -166,6 +168,46 @@ TEST_F(MongoCodecImplTest, Reply) {
   decoder_.onData(output_);
 }
 
+// With lazy documents, the documents of a reply are decoded without being parsed.
+TEST_F(MongoCodecImplTest, LazyReply) {
+  ReplyMessageImpl reply(2, 2);
+  reply.numberReturned(2);
+  reply.documents().push_back(Bson::DocumentImpl::create()->addString("hello", "world"));
+  reply.documents().push_back(Bson::DocumentImpl::create()->addInt32("a", 1));
+
+  encoder_.encodeReply(reply);
+  DecoderImpl decoder{callbacks_, true};
+  EXPECT_CALL(callbacks_, decodeReply_(_)).WillOnce(Invoke([&](ReplyMessagePtr& message) {
+    ASSERT_EQ(2U, message->documents().size());
+    int32_t byte_size = 0;
+    for (const Bson::DocumentSharedPtr& document : message->documents()) {
+      byte_size += document->byteSize();
+      EXPECT_FALSE(dynamic_cast<const Bson::LazyDocumentImpl&>(*document).parsed());
+    }
+    EXPECT_EQ(reply.documents().front()->byteSize() + reply.documents().back()->byteSize(),
+              byte_size);
+    EXPECT_EQ(reply, *message);
+  }));
+  decoder.onData(output_);
+  EXPECT_EQ(0U, output_.length());
+}
+
+// With lazy documents, the fields of a query are parsed when accessed.
+TEST_F(MongoCodecImplTest, LazyQuery) {
+  QueryMessageImpl query(1, 1);
+  query.fullCollectionName("test");
+  query.query(Bson::DocumentImpl::create()->addString("string", "string"));
+  query.returnFieldsSelector(Bson::DocumentImpl::create()->addDouble("double", -2.3));
+
+  encoder_.encodeQuery(query);
+  DecoderImpl decoder{callbacks_, true};
+  EXPECT_CALL(callbacks_, decodeQuery_(_)).WillOnce(Invoke([&](QueryMessagePtr& message) {
+    EXPECT_EQ("string", message->query()->find("string")->asString());
+    EXPECT_EQ(query, *message);
+  }));
+  decoder.onData(output_);
+}
+
 TEST_F(MongoCodecImplTest, GetMoreEqual) {
   {
     GetMoreMessageImpl g1(0, 0);
@@ -400,6 +400,31 @@ TEST_F(PostgresProxyDecoderTest, Backend) {
   data_.drain(data_.length());
 }
 
+// Test that the status of ReadyForQuery messages sets the transaction status of the session,
+// including for the transactions the CommandComplete keywords do not tell about.
+TEST_F(PostgresProxyDecoderTest, ReadyForQuery) {
+  createPostgresMsg(data_, "Z", "T");
+  decoder_->onData(data_, false);
+  ASSERT_EQ(PostgresSession::TransactionStatus::InTransaction,
+            decoder_->getSession().transactionStatus());
+  ASSERT_TRUE(decoder_->getSession().inTransaction());
+
+  createPostgresMsg(data_, "Z", "E");
+  decoder_->onData(data_, false);
+  ASSERT_EQ(PostgresSession::TransactionStatus::Failed, decoder_->getSession().transactionStatus());
+  ASSERT_TRUE(decoder_->getSession().inTransaction());
+
+  // Unknown statuses are ignored.
+  createPostgresMsg(data_, "Z", "?");
+  decoder_->onData(data_, false);
+  ASSERT_EQ(PostgresSession::TransactionStatus::Failed, decoder_->getSession().transactionStatus());
+
+  createPostgresMsg(data_, "Z", "I");
+  decoder_->onData(data_, false);
+  ASSERT_EQ(PostgresSession::TransactionStatus::Idle, decoder_->getSession().transactionStatus());
+  ASSERT_FALSE(decoder_->getSession().inTransaction());
+}
+
 // Test checks deep inspection of the R message.
 // During login/authentication phase client and server exchange
 // multiple R messages. Only payload with length is 8 and
@@ -513,6 +538,7 @@ INSTANTIATE_TEST_SUITE_P(FrontendEncryptedMessagesTests, PostgresProxyFrontendEn
 class FakeBuffer : public Buffer::Instance {
 public:
   MOCK_METHOD(void, addDrainTracker, (std::function<void()>), (override));
+  MOCK_METHOD(void, bindAccount, (Buffer::BufferMemoryAccountSharedPtr), (override));
   MOCK_METHOD(void, add, (const void*, uint64_t), (override));
   MOCK_METHOD(void, addBufferFragment, (Buffer::BufferFragment&), (override));
   MOCK_METHOD(void, add, (absl::string_view), (override));
@@ -5,10 +5,12 @@
 #include <string>
 #include <vector>
 
+#include "common/buffer/buffer_impl.h"
 #include "common/common/fmt.h"
 #include "common/stats/isolated_store_impl.h"
 
 #include "extensions/filters/network/common/redis/client_impl.h"
+#include "extensions/filters/network/common/redis/codec_impl.h"
 #include "extensions/filters/network/common/redis/supported_commands.h"
 #include "extensions/filters/network/redis_proxy/command_splitter_impl.h"
 #include "extensions/filters/network/redis_proxy/router_impl.h"
@@ -83,6 +85,47 @@ public:
       single_mset.asArray()[2].asString() = request->asArray()[i + 1].asString();
     }
   }
+
+  Common::Redis::RespValueSharedPtr makeSharedMget(uint64_t batch_size, uint64_t key_size) {
+    Common::Redis::RespValueSharedPtr request{new Common::Redis::RespValue()};
+    std::vector<Common::Redis::RespValue> values(batch_size + 1);
+    values[0].type(Common::Redis::RespType::BulkString);
+    values[0].asString() = "mget";
+    for (uint64_t i = 1; i < batch_size + 1; i++) {
+      values[i].type(Common::Redis::RespType::BulkString);
+      values[i].asString() = std::string(key_size, 'k');
+    }
+    request->type(Common::Redis::RespType::Array);
+    request->asArray().swap(values);
+    return request;
+  }
+
+  // Encodes an MGET, as sent by a client.
+  std::string makeEncodedMget(uint64_t batch_size, uint64_t key_size) {
+    Buffer::OwnedImpl buffer;
+    encoder_.encode(*makeSharedMget(batch_size, key_size), buffer);
+    return buffer.toString();
+  }
+
+  // Splits an MGET into GETs, and encodes them for the upstreams.
+  void splitAndEncode(Common::Redis::RespValueSharedPtr& request) {
+    Buffer::OwnedImpl buffer;
+    for (uint64_t i = 1; i < request->asArray().size(); i++) {
+      Common::Redis::RespValue single_get(request, Common::Redis::Utility::GetRequest::instance(),
+                                          i, i);
+      encoder_.encode(single_get, buffer);
+    }
+    benchmark::DoNotOptimize(buffer.length());
+  }
+
+  Common::Redis::EncoderImpl encoder_;
+};
+
+class LastValueDecoderCallbacks : public Common::Redis::DecoderCallbacks {
+public:
+  void onRespValue(Common::Redis::RespValuePtr&& value) override { last_value_ = std::move(value); }
+
+  Common::Redis::RespValuePtr last_value_;
 };
 } // namespace RedisProxy
 } // namespace NetworkFilters
@@ -130,3 +173,25 @@ static void BM_Split_CreateVariant(benchmark::State& state) {
   state.counters["use_count"] = request.use_count();
 }
 BENCHMARK(BM_Split_CreateVariant)->Ranges({{1, 100}, {64, 8 << 14}});
+
+static void BM_Decode_Mget(benchmark::State& state) {
+  Envoy::Extensions::NetworkFilters::RedisProxy::CommandSplitSpeedTest context;
+  const std::string encoded = context.makeEncodedMget(state.range(0), state.range(1));
+  Envoy::Extensions::NetworkFilters::RedisProxy::LastValueDecoderCallbacks callbacks;
+  Envoy::Extensions::NetworkFilters::Common::Redis::DecoderImpl decoder(callbacks);
+  for (auto _ : state) {
+    Envoy::Buffer::OwnedImpl buffer(encoded);
+    decoder.decode(buffer);
+  }
+}
+BENCHMARK(BM_Decode_Mget)->Ranges({{1, 100}, {8, 64}});
+
+static void BM_Split_EncodeMget(benchmark::State& state) {
+  Envoy::Extensions::NetworkFilters::RedisProxy::CommandSplitSpeedTest context;
+  Envoy::Extensions::NetworkFilters::Common::Redis::RespValueSharedPtr request =
+      context.makeSharedMget(state.range(0), state.range(1));
+  for (auto _ : state) {
+    context.splitAndEncode(request);
+  }
+}
+BENCHMARK(BM_Split_EncodeMget)->Ranges({{1, 100}, {8, 64}});
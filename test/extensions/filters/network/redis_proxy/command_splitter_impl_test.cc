@@ -9,12 +9,14 @@
 #include "extensions/filters/network/common/redis/fault_impl.h"
 #include "extensions/filters/network/common/redis/supported_commands.h"
 #include "extensions/filters/network/redis_proxy/command_splitter_impl.h"
+#include "extensions/filters/network/redis_proxy/read_cache.h"
 
 #include "test/extensions/filters/network/common/redis/mocks.h"
 #include "test/extensions/filters/network/redis_proxy/mocks.h"
 #include "test/mocks/common.h"
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/simulated_time_system.h"
 
 using testing::_;
@@ -1156,6 +1158,67 @@ INSTANTIATE_TEST_SUITE_P(RedisSingleServerRequestWithDelayFaultTest,
                          RedisSingleServerRequestWithDelayFaultTest,
                          testing::ValuesIn(Common::Redis::SupportedCommands::simpleCommands()));
 
+class RedisReadCacheTest : public RedisSingleServerRequestTest {
+public:
+  static envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::ReadCache
+  readCacheConfig() {
+    envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::ReadCache config;
+    config.add_commands("get");
+    config.mutable_ttl()->set_seconds(1);
+    return config;
+  }
+
+  void makeCachedRequest(const std::string& hash_key, Common::Redis::RespValuePtr&& request) {
+    EXPECT_CALL(callbacks_, connectionAllowed()).WillOnce(Return(true));
+    EXPECT_CALL(*conn_pool_, makeRequest_(hash_key, RespVariantEq(*request), _))
+        .WillOnce(DoAll(WithArg<2>(SaveArgAddress(&pool_callbacks_)), Return(&pool_request_)));
+    handle_ = cached_splitter_.makeRequest(std::move(request), callbacks_, dispatcher_);
+  }
+
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  InstanceImpl cached_splitter_{
+      std::make_unique<NiceMock<MockRouter>>(route_),
+      store_,
+      "redis.foo.",
+      time_system_,
+      false,
+      std::make_unique<NiceMock<MockFaultManager>>(),
+      std::make_shared<ThreadLocalReadCache>(readCacheConfig(), tls_, store_, "redis.foo.")};
+};
+
+// A GET is served from the response to the previous GET of its key, until a SET of the key.
+TEST_F(RedisReadCacheTest, GetServedFromCache) {
+  InSequence s;
+
+  Common::Redis::RespValuePtr request{new Common::Redis::RespValue()};
+  makeBulkStringArray(*request, {"get", "hello"});
+  makeCachedRequest("hello", std::move(request));
+  EXPECT_NE(nullptr, handle_);
+  Common::Redis::RespValue response;
+  response.type(Common::Redis::RespType::BulkString);
+  response.asString() = "world";
+  EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&response)));
+  pool_callbacks_->onResponse(std::make_unique<Common::Redis::RespValue>(response));
+
+  request = std::make_unique<Common::Redis::RespValue>();
+  makeBulkStringArray(*request, {"get", "hello"});
+  EXPECT_CALL(callbacks_, connectionAllowed()).WillOnce(Return(true));
+  EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&response)));
+  EXPECT_EQ(nullptr, cached_splitter_.makeRequest(std::move(request), callbacks_, dispatcher_));
+  EXPECT_EQ(1UL, store_.counter("redis.foo.read_cache.hit").value());
+  EXPECT_EQ(2UL, store_.counter("redis.foo.command.get.success").value());
+
+  request = std::make_unique<Common::Redis::RespValue>();
+  makeBulkStringArray(*request, {"set", "hello", "there"});
+  makeCachedRequest("hello", std::move(request));
+  EXPECT_EQ(1UL, store_.counter("redis.foo.read_cache.invalidation").value());
+
+  request = std::make_unique<Common::Redis::RespValue>();
+  makeBulkStringArray(*request, {"get", "hello"});
+  makeCachedRequest("hello", std::move(request));
+  EXPECT_EQ(2UL, store_.counter("redis.foo.read_cache.miss").value());
+};
+
 } // namespace CommandSplitter
 } // namespace RedisProxy
 } // namespace NetworkFilters
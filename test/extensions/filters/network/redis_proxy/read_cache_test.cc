@@ -0,0 +1,206 @@
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/filters/network/redis_proxy/v3/redis_proxy.pb.h"
+
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/network/redis_proxy/read_cache.h"
+
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace RedisProxy {
+namespace {
+
+Common::Redis::RespValue bulkString(const std::string& string) {
+  Common::Redis::RespValue value;
+  value.type(Common::Redis::RespType::BulkString);
+  value.asString() = string;
+  return value;
+}
+
+Common::Redis::RespValue bulkStringArray(const std::vector<std::string>& strings) {
+  std::vector<Common::Redis::RespValue> values;
+  for (const std::string& string : strings) {
+    values.push_back(bulkString(string));
+  }
+  Common::Redis::RespValue value;
+  value.type(Common::Redis::RespType::Array);
+  value.asArray().swap(values);
+  return value;
+}
+
+class ReadCacheTest : public testing::Test {
+public:
+  ReadCacheTest() : ReadCacheTest(R"EOF(
+    commands: [ "get", "hget", "mget" ]
+    ttl: 1s
+    max_keys: 2
+  )EOF") {}
+
+  explicit ReadCacheTest(const std::string& yaml)
+      : options_(parseConfig(yaml)),
+        stats_{ALL_READ_CACHE_STATS(POOL_COUNTER_PREFIX(store_, "read_cache."))},
+        cache_(options_, stats_, time_system_) {}
+
+  static envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::ReadCache
+  parseConfig(const std::string& yaml) {
+    envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::ReadCache config;
+    TestUtility::loadFromYaml(yaml, config);
+    return config;
+  }
+
+  // Caches the response to a request, as the response to a request sent now would be.
+  void insert(const std::vector<std::string>& request, const Common::Redis::RespValue& response) {
+    cache_.insert(request[0], bulkStringArray(request), response, cache_.generation());
+  }
+
+  Common::Redis::RespValuePtr lookup(const std::vector<std::string>& request) {
+    return cache_.lookup(request[0], bulkStringArray(request));
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl store_;
+  const ReadCache::Options options_;
+  ReadCacheStats stats_;
+  ReadCache cache_;
+};
+
+TEST_F(ReadCacheTest, Cacheable) {
+  EXPECT_TRUE(cache_.cacheable("get", bulkStringArray({"get", "foo"})));
+  EXPECT_TRUE(cache_.cacheable("mget", bulkStringArray({"mget", "foo", "bar"})));
+  EXPECT_FALSE(cache_.cacheable("strlen", bulkStringArray({"strlen", "foo"})));
+  EXPECT_FALSE(cache_.cacheable("set", bulkStringArray({"set", "foo", "bar"})));
+}
+
+// A response is served until it expires.
+TEST_F(ReadCacheTest, HitUntilExpiry) {
+  EXPECT_EQ(nullptr, lookup({"get", "foo"}));
+  insert({"get", "foo"}, bulkString("bar"));
+
+  time_system_.setMonotonicTime(std::chrono::milliseconds(999));
+  Common::Redis::RespValuePtr response = lookup({"get", "foo"});
+  ASSERT_NE(nullptr, response);
+  EXPECT_EQ(bulkString("bar"), *response);
+
+  time_system_.setMonotonicTime(std::chrono::milliseconds(1000));
+  EXPECT_EQ(nullptr, lookup({"get", "foo"}));
+  EXPECT_EQ(0U, cache_.size());
+  EXPECT_EQ(1U, stats_.hit_.value());
+  EXPECT_EQ(2U, stats_.miss_.value());
+}
+
+// The responses to the requests for a key are told apart by their command and arguments.
+TEST_F(ReadCacheTest, ResponsesByRequest) {
+  insert({"hget", "foo", "a"}, bulkString("1"));
+  insert({"hget", "foo", "b"}, bulkString("2"));
+  EXPECT_EQ(bulkString("1"), *lookup({"hget", "foo", "a"}));
+  EXPECT_EQ(bulkString("2"), *lookup({"hget", "foo", "b"}));
+  EXPECT_EQ(nullptr, lookup({"get", "foo"}));
+  EXPECT_EQ(1U, cache_.size());
+}
+
+// Errors are not cached.
+TEST_F(ReadCacheTest, Error) {
+  Common::Redis::RespValue error;
+  error.type(Common::Redis::RespType::Error);
+  error.asString() = "ERR";
+  insert({"get", "foo"}, error);
+  EXPECT_EQ(nullptr, lookup({"get", "foo"}));
+}
+
+// The values returned by an MGET are cached as the responses to the GETs of its keys, and an
+// MGET is served from them.
+TEST_F(ReadCacheTest, Mget) {
+  Common::Redis::RespValue null;
+  Common::Redis::RespValue values;
+  values.type(Common::Redis::RespType::Array);
+  values.asArray() = {bulkString("1"), null};
+  insert({"mget", "foo", "bar"}, values);
+
+  EXPECT_EQ(bulkString("1"), *lookup({"get", "foo"}));
+  EXPECT_EQ(null, *lookup({"get", "bar"}));
+  EXPECT_EQ(values, *lookup({"mget", "foo", "bar"}));
+  EXPECT_EQ(nullptr, lookup({"mget", "foo", "baz"}));
+
+  // A response with a value per key only is cached.
+  values.asArray().pop_back();
+  insert({"mget", "baz", "qux"}, values);
+  EXPECT_EQ(nullptr, lookup({"get", "baz"}));
+}
+
+// A write drops the responses cached for its keys, and the responses to the reads in flight.
+TEST_F(ReadCacheTest, Invalidate) {
+  insert({"get", "foo"}, bulkString("1"));
+  insert({"get", "bar"}, bulkString("2"));
+  const uint64_t generation = cache_.generation();
+
+  cache_.invalidate(bulkStringArray({"set", "foo", "3"}));
+  EXPECT_EQ(nullptr, lookup({"get", "foo"}));
+  EXPECT_NE(nullptr, lookup({"get", "bar"}));
+  EXPECT_EQ(1U, stats_.invalidation_.value());
+
+  cache_.insert("get", bulkStringArray({"get", "foo"}), bulkString("1"), generation);
+  EXPECT_EQ(nullptr, lookup({"get", "foo"}));
+}
+
+// The least recently used key is evicted once max_keys keys are cached.
+TEST_F(ReadCacheTest, Eviction) {
+  insert({"get", "foo"}, bulkString("1"));
+  insert({"get", "bar"}, bulkString("2"));
+  EXPECT_NE(nullptr, lookup({"get", "foo"}));
+  insert({"get", "baz"}, bulkString("3"));
+
+  EXPECT_EQ(2U, cache_.size());
+  EXPECT_EQ(1U, stats_.eviction_.value());
+  EXPECT_NE(nullptr, lookup({"get", "foo"}));
+  EXPECT_EQ(nullptr, lookup({"get", "bar"}));
+  EXPECT_NE(nullptr, lookup({"get", "baz"}));
+}
+
+class ReadCacheKeyPrefixTest : public ReadCacheTest {
+public:
+  ReadCacheKeyPrefixTest() : ReadCacheTest(R"EOF(
+    commands: [ "GET", "mget" ]
+    key_prefixes: [ "user:" ]
+    ttl: 1s
+  )EOF") {}
+};
+
+// Only the keys with one of the prefixes are cached, and only the writes to them invalidate the
+// reads in flight.
+TEST_F(ReadCacheKeyPrefixTest, KeyPrefixes) {
+  EXPECT_TRUE(cache_.cacheable("get", bulkStringArray({"get", "user:1"})));
+  EXPECT_FALSE(cache_.cacheable("get", bulkStringArray({"get", "session:1"})));
+  EXPECT_FALSE(cache_.cacheable("mget", bulkStringArray({"mget", "user:1", "session:1"})));
+
+  const uint64_t generation = cache_.generation();
+  cache_.invalidate(bulkStringArray({"set", "session:1", "a"}));
+  EXPECT_EQ(generation, cache_.generation());
+  cache_.invalidate(bulkStringArray({"set", "user:1", "a"}));
+  EXPECT_NE(generation, cache_.generation());
+}
+
+TEST(ReadCacheOptionsTest, CommandNotCacheable) {
+  envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::ReadCache config;
+  TestUtility::loadFromYaml(R"EOF(
+    commands: [ "get", "incr" ]
+    ttl: 1s
+  )EOF",
+                            config);
+  EXPECT_THROW_WITH_MESSAGE(ReadCache::Options{config}, EnvoyException,
+                            "redis read cache: command 'incr' cannot be cached");
+}
+
+} // namespace
+} // namespace RedisProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -582,6 +582,47 @@ TEST_F(DnsFilterTest, RepeatedTypeAQuerySuccess) {
   EXPECT_EQ(loopCount, config_->stats().a_record_queries_.value());
 }
 
+// A repeated query is answered from the cached response, with the ID of the query.
+TEST_F(DnsFilterTest, CachedLocalResponse) {
+  setup(absl::StrCat("max_cached_responses: 1", forward_query_off_config));
+
+  const std::string domain("www.foo3.com");
+  sendQueryFromClient("10.0.0.1:1000", Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A,
+                                                                  DNS_RECORD_CLASS_IN, 1));
+  EXPECT_EQ(0, config_->stats().response_cache_hits_.value());
+
+  sendQueryFromClient("10.0.0.1:1000", Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A,
+                                                                  DNS_RECORD_CLASS_IN, 2));
+  query_ctx_ = response_parser_->createQueryContext(udp_response_, counters_);
+  EXPECT_TRUE(query_ctx_->parse_status_);
+  EXPECT_EQ(2, query_ctx_->header_.id);
+  EXPECT_EQ(DNS_RESPONSE_CODE_NO_ERROR, query_ctx_->getQueryResponseCode());
+  ASSERT_EQ(1, query_ctx_->answers_.size());
+  Utils::verifyAddress({"10.0.3.1"}, query_ctx_->answers_.find(domain)->second);
+
+  EXPECT_EQ(1, config_->stats().response_cache_hits_.value());
+  EXPECT_EQ(2, config_->stats().downstream_tx_responses_.value());
+  EXPECT_EQ(2, config_->stats().a_record_queries_.value());
+  EXPECT_EQ(1, config_->stats().local_a_record_answers_.value());
+
+  // Caching the response for another query evicts the first one.
+  sendQueryFromClient("10.0.0.1:1000", Utils::buildQueryForDomain("www.foo1.com",
+                                                                  DNS_RECORD_TYPE_A,
+                                                                  DNS_RECORD_CLASS_IN, 3));
+  sendQueryFromClient("10.0.0.1:1000", Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A,
+                                                                  DNS_RECORD_CLASS_IN, 4));
+  EXPECT_EQ(1, config_->stats().response_cache_hits_.value());
+  EXPECT_EQ(4, config_->stats().local_a_record_answers_.value());
+
+  // Negative responses are not cached.
+  const std::string unknown_query =
+      Utils::buildQueryForDomain("www.foo2.com", DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN, 5);
+  sendQueryFromClient("10.0.0.1:1000", unknown_query);
+  sendQueryFromClient("10.0.0.1:1000", unknown_query);
+  EXPECT_EQ(1, config_->stats().response_cache_hits_.value());
+  EXPECT_EQ(2, config_->stats().unanswered_queries_.value());
+}
+
 TEST_F(DnsFilterTest, LocalTypeAQueryFail) {
   InSequence s;
 
@@ -687,6 +728,34 @@ TEST_F(DnsFilterTest, ExternalResolutionReturnSingleAddress) {
   EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
 }
 
+// An externally resolved response is cached for the TTL of its domain.
+TEST_F(DnsFilterTest, CachedExternalResponseExpires) {
+  setup(absl::StrCat("max_cached_responses: 10", forward_query_on_config));
+
+  const std::string domain("www.foobaz.com");
+  const std::string query =
+      Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN);
+  Network::DnsResolver::ResolveCb resolve_cb;
+  EXPECT_CALL(*resolver_, resolve(domain, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  resolve_cb(Network::DnsResolver::ResolutionStatus::Success,
+             TestUtility::makeDnsResponse({"130.207.244.251"}));
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
+
+  simTime().advanceTimeWait(std::chrono::seconds(299));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  EXPECT_EQ(1, config_->stats().response_cache_hits_.value());
+  query_ctx_ = response_parser_->createQueryContext(udp_response_, counters_);
+  ASSERT_EQ(1, query_ctx_->answers_.size());
+  Utils::verifyAddress({"130.207.244.251"}, query_ctx_->answers_.find(domain)->second);
+
+  simTime().advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_CALL(*resolver_, resolve(domain, _, _)).WillOnce(Return(&resolver_->active_query_));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  EXPECT_EQ(1, config_->stats().response_cache_hits_.value());
+}
+
 TEST_F(DnsFilterTest, ExternalResolutionIpv6SingleAddress) {
   InSequence s;
 
@@ -2,6 +2,7 @@
 #include "envoy/extensions/filters/udp/udp_proxy/v3/udp_proxy.pb.validate.h"
 
 #include "common/common/hash.h"
+#include "common/network/address_impl.h"
 #include "common/network/socket_impl.h"
 #include "common/network/socket_option_impl.h"
 
@@ -14,6 +15,7 @@
 #include "test/mocks/upstream/cluster_update_callbacks_handle.h"
 #include "test/mocks/upstream/host.h"
 #include "test/mocks/upstream/thread_local_cluster.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/threadsafe_singleton_injector.h"
 
 #include "gmock/gmock.h"
@@ -73,7 +75,6 @@ public:
 
     void expectWriteToUpstream(const std::string& data, int sys_errno = 0,
                                const Network::Address::Ip* local_ip = nullptr) {
-      EXPECT_CALL(*idle_timer_, enableTimer(parent_.config_->sessionTimeout(), nullptr));
       EXPECT_CALL(*socket_->io_handle_, sendmsg(_, 1, 0, _, _))
           .WillOnce(Invoke(
               [this, data, local_ip, sys_errno](
@@ -100,8 +101,6 @@ public:
 
     void recvDataFromUpstream(const std::string& data, int recv_sys_errno = 0,
                               int send_sys_errno = 0) {
-      EXPECT_CALL(*idle_timer_, enableTimer(parent_.config_->sessionTimeout(), nullptr));
-
       EXPECT_CALL(*socket_->io_handle_, supportsUdpGro());
       EXPECT_CALL(*socket_->io_handle_, supportsMmsg());
       // Return the datagram.
@@ -148,7 +147,6 @@ public:
 
     UdpProxyFilterTest& parent_;
     const Network::Address::InstanceConstSharedPtr upstream_address_;
-    Event::MockTimer* idle_timer_{};
     NiceMock<Network::MockSocket>* socket_;
     std::map<int, std::map<int, int>> sock_opts_;
     Event::FileReadyCb file_event_cb_;
@@ -184,9 +182,16 @@ public:
       cluster_manager_.initializeThreadLocalClusters({"fake_cluster"});
     }
     EXPECT_CALL(cluster_manager_, getThreadLocalCluster("fake_cluster"));
+    if (has_cluster) {
+      expectIdleTimerCreate();
+    }
     filter_ = std::make_unique<TestUdpProxyFilter>(callbacks_, config_);
   }
 
+  void expectIdleTimerCreate() {
+    idle_timer_ = new NiceMock<Event::MockTimer>(&callbacks_.udp_listener_.dispatcher_);
+  }
+
   void recvDataFromDownstream(const std::string& peer_address, const std::string& local_address,
                               const std::string& buffer) {
     Network::UdpRecvData data;
@@ -197,15 +202,14 @@ public:
     filter_->onData(data);
   }
 
-  void expectSessionCreate(const Network::Address::InstanceConstSharedPtr& address) {
+  void expectSessionCreate(const Network::Address::InstanceConstSharedPtr& address,
+                           uint32_t file_events = Event::FileReadyType::Read) {
     test_sessions_.emplace_back(*this, address);
     TestSession& new_session = test_sessions_.back();
-    new_session.idle_timer_ = new Event::MockTimer(&callbacks_.udp_listener_.dispatcher_);
     EXPECT_CALL(*filter_, createSocket(_))
         .WillOnce(Return(ByMove(Network::SocketPtr{test_sessions_.back().socket_})));
-    EXPECT_CALL(
-        *new_session.socket_->io_handle_,
-        createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+    EXPECT_CALL(*new_session.socket_->io_handle_,
+                createFileEvent_(_, _, Event::PlatformDefaultTriggerType, file_events))
         .WillOnce(SaveArg<1>(&new_session.file_event_cb_));
     // Internal Buffer is Empty, flush will be a no-op
     ON_CALL(callbacks_.udp_listener_, flush())
@@ -271,15 +275,16 @@ use_original_src_ip: true
     return true;
   }
 
+  Event::SimulatedTimeSystem time_system_;
   Api::MockOsSysCalls os_sys_calls_;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_;
   Upstream::MockClusterManager cluster_manager_;
-  NiceMock<MockTimeSystem> time_system_;
   Stats::IsolatedStoreImpl stats_store_;
   UdpProxyFilterConfigSharedPtr config_;
   Network::MockUdpReadFilterCallbacks callbacks_;
   Upstream::ClusterUpdateCallbacks* cluster_update_callbacks_{};
   std::unique_ptr<TestUdpProxyFilter> filter_;
+  NiceMock<Event::MockTimer>* idle_timer_{};
   std::vector<TestSession> test_sessions_;
   const Network::Address::InstanceConstSharedPtr upstream_address_;
   const Network::Address::InstanceConstSharedPtr peer_address_;
@@ -376,9 +381,11 @@ cluster: fake_cluster
   EXPECT_EQ(1, config_->stats().downstream_sess_total_.value());
   EXPECT_EQ(1, config_->stats().downstream_sess_active_.value());
 
-  test_sessions_[0].idle_timer_->invokeCallback();
+  time_system_.advanceTimeWait(config_->sessionTimeout());
+  idle_timer_->invokeCallback();
   EXPECT_EQ(1, config_->stats().downstream_sess_total_.value());
   EXPECT_EQ(0, config_->stats().downstream_sess_active_.value());
+  EXPECT_EQ(1, config_->stats().idle_timeout_.value());
 
   expectSessionCreate(upstream_address_);
   test_sessions_[1].expectWriteToUpstream("hello");
@@ -387,6 +394,49 @@ cluster: fake_cluster
   EXPECT_EQ(1, config_->stats().downstream_sess_active_.value());
 }
 
+// The sessions time out in order of last use, from a single timer re-armed for the next expiry.
+TEST_F(UdpProxyFilterTest, IdleTimeoutInOrderOfLastUse) {
+  InSequence s;
+
+  setup(R"EOF(
+stat_prefix: foo
+cluster: fake_cluster
+  )EOF");
+
+  expectSessionCreate(upstream_address_);
+  test_sessions_[0].expectWriteToUpstream("hello");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  EXPECT_TRUE(idle_timer_->enabled());
+
+  time_system_.advanceTimeWait(std::chrono::seconds(20));
+  expectSessionCreate(upstream_address_);
+  test_sessions_[1].expectWriteToUpstream("hello");
+  recvDataFromDownstream("10.0.0.3:1000", "10.0.0.2:80", "hello");
+  EXPECT_EQ(2, config_->stats().downstream_sess_active_.value());
+
+  // The 1st session is used again, so the 2nd one is now the least recently used.
+  time_system_.advanceTimeWait(std::chrono::seconds(20));
+  test_sessions_[0].recvDataFromUpstream("world");
+
+  time_system_.advanceTimeWait(std::chrono::seconds(20));
+  EXPECT_CALL(*idle_timer_, enableTimer(std::chrono::milliseconds(20000), nullptr));
+  idle_timer_->invokeCallback();
+  EXPECT_EQ(2, config_->stats().downstream_sess_active_.value());
+  EXPECT_EQ(0, config_->stats().idle_timeout_.value());
+
+  time_system_.advanceTimeWait(std::chrono::seconds(20));
+  EXPECT_CALL(*idle_timer_, enableTimer(std::chrono::milliseconds(20000), nullptr));
+  idle_timer_->invokeCallback();
+  EXPECT_EQ(1, config_->stats().downstream_sess_active_.value());
+  EXPECT_EQ(1, config_->stats().idle_timeout_.value());
+
+  time_system_.advanceTimeWait(std::chrono::seconds(20));
+  idle_timer_->invokeCallback();
+  EXPECT_EQ(0, config_->stats().downstream_sess_active_.value());
+  EXPECT_EQ(2, config_->stats().idle_timeout_.value());
+  EXPECT_FALSE(idle_timer_->enabled());
+}
+
 // Verify downstream send and receive error handling.
 TEST_F(UdpProxyFilterTest, SendReceiveErrorHandling) {
   InSequence s;
@@ -432,6 +482,63 @@ cluster: fake_cluster
                    ->value());
 }
 
+// Datagrams forwarded upstream are queued and sent together at the end of the loop iteration.
+TEST_F(UdpProxyFilterTest, BatchUpstreamWrites) {
+  EXPECT_CALL(os_sys_calls_, supportsMmsg()).WillRepeatedly(Return(true));
+  EXPECT_CALL(os_sys_calls_, supportsUdpGso()).WillRepeatedly(Return(false));
+  setup(R"EOF(
+stat_prefix: foo
+cluster: fake_cluster
+batch_upstream_writes: true
+  )EOF");
+
+  expectSessionCreate(upstream_address_,
+                      Event::FileReadyType::Read | Event::FileReadyType::Write);
+  auto* flush_cb = new NiceMock<Event::MockSchedulableCallback>(
+      &callbacks_.udp_listener_.dispatcher_);
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration());
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_, sendmsg(_, _, _, _, _)).Times(0);
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello2");
+  checkTransferStats(11 /*rx_bytes*/, 2 /*rx_datagrams*/, 0 /*tx_bytes*/, 0 /*tx_datagrams*/);
+
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_, fdDoNotUse()).WillRepeatedly(Return(42));
+  EXPECT_CALL(os_sys_calls_, sendmmsg(42, _, 2, 0))
+      .WillOnce(Invoke([this](os_fd_t, struct mmsghdr* msgvec, unsigned int vlen,
+                              int) -> Api::SysCallIntResult {
+        const std::vector<std::string> expected{"hello", "hello2"};
+        for (unsigned int i = 0; i < vlen; i++) {
+          const iovec& iov = msgvec[i].msg_hdr.msg_iov[0];
+          EXPECT_EQ(expected[i],
+                    absl::string_view(static_cast<const char*>(iov.iov_base), iov.iov_len));
+          EXPECT_EQ(*upstream_address_,
+                    *Network::Address::addressFromSockAddr(
+                        *static_cast<const sockaddr_storage*>(msgvec[i].msg_hdr.msg_name),
+                        msgvec[i].msg_hdr.msg_namelen));
+          msgvec[i].msg_len = iov.iov_len;
+        }
+        return {static_cast<int>(vlen), 0};
+      }));
+  flush_cb->invokeCallback();
+  EXPECT_EQ(11, cluster_manager_.thread_local_cluster_.cluster_.info_->stats_
+                    .upstream_cx_tx_bytes_total_.value());
+  EXPECT_EQ(2, TestUtility::findCounter(
+                   cluster_manager_.thread_local_cluster_.cluster_.info_->stats_store_,
+                   "udp.sess_tx_datagrams")
+                   ->value());
+
+  // A failed flush counts as a send error.
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration());
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello3");
+  EXPECT_CALL(os_sys_calls_, sendmmsg(42, _, 1, 0))
+      .WillOnce(Return(Api::SysCallIntResult{-1, SOCKET_ERROR_MSG_SIZE}));
+  flush_cb->invokeCallback();
+  EXPECT_EQ(1, TestUtility::findCounter(
+                   cluster_manager_.thread_local_cluster_.cluster_.info_->stats_store_,
+                   "udp.sess_tx_errors")
+                   ->value());
+}
+
 // No upstream host handling.
 TEST_F(UdpProxyFilterTest, NoUpstreamHost) {
   InSequence s;
@@ -486,6 +593,7 @@ cluster: fake_cluster
   EXPECT_EQ(0, config_->stats().downstream_sess_active_.value());
 
   // Now add the cluster we care about.
+  expectIdleTimerCreate();
   cluster_update_callbacks_->onClusterAddOrUpdate(cluster_manager_.thread_local_cluster_);
   expectSessionCreate(upstream_address_);
   test_sessions_[0].expectWriteToUpstream("hello");
@@ -529,7 +637,8 @@ cluster: fake_cluster
   EXPECT_EQ(1, config_->stats().downstream_sess_active_.value());
 
   // Timing out the 1st session should allow us to create another.
-  test_sessions_[0].idle_timer_->invokeCallback();
+  time_system_.advanceTimeWait(config_->sessionTimeout());
+  idle_timer_->invokeCallback();
   EXPECT_EQ(1, config_->stats().downstream_sess_total_.value());
   EXPECT_EQ(0, config_->stats().downstream_sess_active_.value());
   expectSessionCreate(upstream_address_);
@@ -0,0 +1,155 @@
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "extensions/io_socket/io_uring/io_uring.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace IoSocket {
+namespace IoUring {
+namespace {
+
+class IoUringImplTest : public testing::Test {
+protected:
+  void SetUp() override {
+    if (!IoUringImpl::isSupported()) {
+      GTEST_SKIP() << "io_uring is not supported by the kernel";
+    }
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds_));
+    io_uring_ = std::make_unique<IoUringImpl>(8);
+    event_fd_ = io_uring_->registerEventfd();
+  }
+
+  void TearDown() override {
+    if (io_uring_ != nullptr) {
+      ::close(fds_[0]);
+      ::close(fds_[1]);
+    }
+  }
+
+  // Waits for the ring's eventfd and collects the completions that are ready.
+  std::vector<std::pair<void*, int32_t>> waitForCompletions() {
+    struct pollfd pfd = {event_fd_, POLLIN, 0};
+    EXPECT_EQ(1, poll(&pfd, 1, 5000));
+    uint64_t value;
+    EXPECT_EQ(sizeof(value), ::read(event_fd_, &value, sizeof(value)));
+    std::vector<std::pair<void*, int32_t>> completions;
+    io_uring_->forEveryCompletion(
+        [&completions](void* user_data, int32_t result) {
+          completions.emplace_back(user_data, result);
+        });
+    return completions;
+  }
+
+  int fds_[2];
+  std::unique_ptr<IoUringImpl> io_uring_;
+  os_fd_t event_fd_;
+};
+
+TEST_F(IoUringImplTest, Readv) {
+  char buf[16] = {};
+  struct iovec iov = {buf, sizeof(buf)};
+  int tag;
+  ASSERT_TRUE(io_uring_->prepareReadv(fds_[0], &iov, 1, &tag));
+  EXPECT_EQ(1, io_uring_->pendingSubmissions());
+  EXPECT_EQ(1, io_uring_->submit().rc_);
+  EXPECT_EQ(0, io_uring_->pendingSubmissions());
+
+  ASSERT_EQ(5, ::write(fds_[1], "hello", 5));
+  auto completions = waitForCompletions();
+  ASSERT_EQ(1, completions.size());
+  EXPECT_EQ(&tag, completions[0].first);
+  EXPECT_EQ(5, completions[0].second);
+  EXPECT_EQ("hello", std::string(buf, 5));
+}
+
+TEST_F(IoUringImplTest, Eof) {
+  char buf[16];
+  struct iovec iov = {buf, sizeof(buf)};
+  ASSERT_TRUE(io_uring_->prepareReadv(fds_[0], &iov, 1, nullptr));
+  io_uring_->submit();
+  ::shutdown(fds_[1], SHUT_WR);
+  auto completions = waitForCompletions();
+  ASSERT_EQ(1, completions.size());
+  EXPECT_EQ(0, completions[0].second);
+}
+
+// All prepared entries are handed to the kernel by a single submit().
+TEST_F(IoUringImplTest, BatchedSubmit) {
+  int other_fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, other_fds));
+  char buf1[4], buf2[4];
+  struct iovec iov1 = {buf1, sizeof(buf1)};
+  struct iovec iov2 = {buf2, sizeof(buf2)};
+  int tag1, tag2;
+  ASSERT_TRUE(io_uring_->prepareReadv(fds_[0], &iov1, 1, &tag1));
+  ASSERT_TRUE(io_uring_->prepareReadv(other_fds[0], &iov2, 1, &tag2));
+  EXPECT_EQ(2, io_uring_->pendingSubmissions());
+  EXPECT_EQ(2, io_uring_->submit().rc_);
+
+  ASSERT_EQ(4, ::write(fds_[1], "abcd", 4));
+  ASSERT_EQ(4, ::write(other_fds[1], "efgh", 4));
+  std::vector<std::pair<void*, int32_t>> completions;
+  while (completions.size() < 2) {
+    auto ready = waitForCompletions();
+    completions.insert(completions.end(), ready.begin(), ready.end());
+  }
+  for (const auto& completion : completions) {
+    EXPECT_TRUE(completion.first == &tag1 || completion.first == &tag2);
+    EXPECT_EQ(4, completion.second);
+  }
+  EXPECT_EQ("abcd", std::string(buf1, 4));
+  EXPECT_EQ("efgh", std::string(buf2, 4));
+  ::close(other_fds[0]);
+  ::close(other_fds[1]);
+}
+
+TEST_F(IoUringImplTest, Cancel) {
+  char buf[16];
+  struct iovec iov = {buf, sizeof(buf)};
+  int read_tag, cancel_tag;
+  ASSERT_TRUE(io_uring_->prepareReadv(fds_[0], &iov, 1, &read_tag));
+  io_uring_->submit();
+  ASSERT_TRUE(io_uring_->prepareCancel(&read_tag, &cancel_tag));
+  io_uring_->submit();
+
+  std::vector<std::pair<void*, int32_t>> completions;
+  while (completions.size() < 2) {
+    auto ready = waitForCompletions();
+    completions.insert(completions.end(), ready.begin(), ready.end());
+  }
+  for (const auto& completion : completions) {
+    if (completion.first == &read_tag) {
+      EXPECT_EQ(-ECANCELED, completion.second);
+    } else {
+      EXPECT_EQ(&cancel_tag, completion.first);
+      EXPECT_EQ(0, completion.second);
+    }
+  }
+}
+
+// Preparing more entries than the ring holds flushes the queue instead of failing.
+TEST_F(IoUringImplTest, FullQueueIsFlushed) {
+  std::vector<char> buf(4);
+  struct iovec iov = {buf.data(), buf.size()};
+  for (int i = 0; i < 12; i++) {
+    ASSERT_TRUE(io_uring_->prepareCancel(&iov, nullptr));
+  }
+  io_uring_->submit();
+  uint32_t completed = 0;
+  while (completed < 12) {
+    completed += waitForCompletions().size();
+  }
+}
+
+} // namespace
+} // namespace IoUring
+} // namespace IoSocket
+} // namespace Extensions
+} // namespace Envoy
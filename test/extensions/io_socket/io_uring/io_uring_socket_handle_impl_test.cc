@@ -0,0 +1,165 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "envoy/event/file_event.h"
+
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/io_socket/io_uring/io_uring.h"
+#include "extensions/io_socket/io_uring/io_uring_socket_handle_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace IoSocket {
+namespace IoUring {
+namespace {
+
+class IoUringSocketHandleImplTest : public testing::Test {
+protected:
+  void SetUp() override {
+    if (!IoUringImpl::isSupported()) {
+      GTEST_SKIP() << "io_uring is not supported by the kernel";
+    }
+    api_ = Api::createApiForTest();
+    dispatcher_ = api_->allocateDispatcher("test_thread");
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds));
+    handle_ = std::make_unique<IoUringSocketHandleImpl>(8, 1024, fds[0], false, absl::nullopt,
+                                                        true);
+    peer_fd_ = fds[1];
+  }
+
+  void TearDown() override {
+    if (handle_ != nullptr) {
+      handle_.reset();
+      ::close(peer_fd_);
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+
+  void initializeEdgeRead() {
+    handle_->initializeFileEvent(
+        *dispatcher_,
+        [this](uint32_t events) {
+          events_ |= events;
+          dispatcher_->exit();
+        },
+        Event::FileTriggerType::Edge, Event::FileReadyType::Read);
+  }
+
+  void writeToPeer(absl::string_view data) {
+    ASSERT_EQ(static_cast<ssize_t>(data.size()), ::write(peer_fd_, data.data(), data.size()));
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  std::unique_ptr<IoUringSocketHandleImpl> handle_;
+  os_fd_t peer_fd_;
+  uint32_t events_{0};
+};
+
+TEST_F(IoUringSocketHandleImplTest, ReadCompletesThroughRing) {
+  initializeEdgeRead();
+  writeToPeer("hello");
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_TRUE(events_ == Event::FileReadyType::Read);
+
+  Buffer::OwnedImpl buffer;
+  auto result = handle_->read(buffer, 1024);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(5, result.rc_);
+  EXPECT_EQ("hello", buffer.toString());
+
+  result = handle_->read(buffer, 1024);
+  EXPECT_FALSE(result.ok());
+  EXPECT_TRUE(result.wouldBlock());
+
+  // The next read is already submitted.
+  events_ = 0;
+  writeToPeer("world");
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_TRUE(events_ == Event::FileReadyType::Read);
+  Buffer::RawSlice slice;
+  char data[3];
+  slice.mem_ = data;
+  slice.len_ = sizeof(data);
+  result = handle_->readv(sizeof(data), &slice, 1);
+  EXPECT_EQ(3, result.rc_);
+  EXPECT_EQ("wor", absl::string_view(data, 3));
+  result = handle_->readv(sizeof(data), &slice, 1);
+  EXPECT_EQ(2, result.rc_);
+  EXPECT_EQ("ld", absl::string_view(data, 2));
+}
+
+TEST_F(IoUringSocketHandleImplTest, PeekDoesNotConsume) {
+  initializeEdgeRead();
+  writeToPeer("hello");
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  char data[16];
+  auto result = handle_->recv(data, sizeof(data), MSG_PEEK);
+  EXPECT_EQ(5, result.rc_);
+  result = handle_->recv(data, sizeof(data), 0);
+  EXPECT_EQ(5, result.rc_);
+  EXPECT_EQ("hello", absl::string_view(data, 5));
+  EXPECT_TRUE(handle_->recv(data, sizeof(data), 0).wouldBlock());
+}
+
+TEST_F(IoUringSocketHandleImplTest, Eof) {
+  initializeEdgeRead();
+  ::shutdown(peer_fd_, SHUT_WR);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_TRUE(events_ == Event::FileReadyType::Read);
+
+  Buffer::OwnedImpl buffer;
+  auto result = handle_->read(buffer, 1024);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(0, result.rc_);
+}
+
+// Data that completes while reads are disabled is delivered once they are enabled again.
+TEST_F(IoUringSocketHandleImplTest, DataBufferedAcrossResetFileEvents) {
+  initializeEdgeRead();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  handle_->resetFileEvents();
+  writeToPeer("hello");
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(0, events_);
+
+  initializeEdgeRead();
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_TRUE(events_ == Event::FileReadyType::Read);
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(5, handle_->read(buffer, 1024).rc_);
+}
+
+// Closing with a read in flight cancels it.
+TEST_F(IoUringSocketHandleImplTest, CloseWithReadInFlight) {
+  initializeEdgeRead();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  handle_->close();
+  // The peer may already see the socket as closed.
+  const ssize_t rc = ::write(peer_fd_, "hello", 5);
+  UNREFERENCED_PARAMETER(rc);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(0, events_);
+}
+
+// Level-triggered users read directly from the socket.
+TEST_F(IoUringSocketHandleImplTest, LevelTriggeredUsesSocket) {
+  handle_->initializeFileEvent(
+      *dispatcher_, [](uint32_t) {}, Event::FileTriggerType::Level, Event::FileReadyType::Read);
+  writeToPeer("hello");
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(5, handle_->read(buffer, 1024).rc_);
+}
+
+} // namespace
+} // namespace IoUring
+} // namespace IoSocket
+} // namespace Extensions
+} // namespace Envoy
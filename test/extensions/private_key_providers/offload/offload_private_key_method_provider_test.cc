@@ -0,0 +1,210 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/private_key_providers/offload/v3/offload.pb.h"
+#include "envoy/extensions/transport_sockets/tls/v3/cert.pb.h"
+#include "envoy/registry/registry.h"
+#include "envoy/ssl/private_key/private_key_config.h"
+
+#include "extensions/private_key_providers/offload/config.h"
+#include "extensions/private_key_providers/offload/handshake_offload_pool.h"
+#include "extensions/private_key_providers/offload/offload_private_key_method_provider.h"
+
+#include "test/mocks/server/transport_socket_factory_context.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
+
+#include "absl/synchronization/notification.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/evp.h"
+#include "openssl/pem.h"
+#include "openssl/rsa.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Offload {
+namespace {
+
+using TransportSockets::Tls::PrivateKeyOperation;
+using TransportSockets::Tls::PrivateKeyOperationSharedPtr;
+
+std::string readKey(const std::string& name) {
+  return TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + name));
+}
+
+bssl::UniquePtr<EVP_PKEY> loadKey(const std::string& name) {
+  const std::string pem = readKey(name);
+  bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(pem.data(), pem.size()));
+  return bssl::UniquePtr<EVP_PKEY>(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
+}
+
+// A task that blocks the thread of the pool that runs it until it is released.
+class BlockingTask {
+public:
+  std::function<void()> task() {
+    return [this]() {
+      started_.Notify();
+      release_.WaitForNotification();
+    };
+  }
+
+  absl::Notification started_;
+  absl::Notification release_;
+};
+
+// The providers share the pool of the process, which goes away with the last of them.
+TEST(HandshakeOffloadPoolTest, ProcessPool) {
+  EXPECT_EQ(nullptr, HandshakeOffloadPool::get());
+  HandshakeOffloadPoolSharedPtr pool1 =
+      HandshakeOffloadPool::getOrCreate(Thread::threadFactoryForTest(), 1, 4);
+  HandshakeOffloadPoolSharedPtr pool2 =
+      HandshakeOffloadPool::getOrCreate(Thread::threadFactoryForTest(), 2, 8);
+  EXPECT_EQ(pool1, pool2);
+  EXPECT_EQ(pool1, HandshakeOffloadPool::get());
+  pool1.reset();
+  pool2.reset();
+  EXPECT_EQ(nullptr, HandshakeOffloadPool::get());
+}
+
+TEST(OffloadBatchProcessorTest, SignRsaPss) {
+  bssl::UniquePtr<EVP_PKEY> pkey = loadKey("unittest_key.pem");
+  ASSERT_NE(nullptr, pkey);
+  const std::string message = "message";
+  PrivateKeyOperation operation(PrivateKeyOperation::Type::Sign, SSL_SIGN_RSA_PSS_RSAE_SHA256,
+                                reinterpret_cast<const uint8_t*>(message.data()), message.size());
+  OffloadBatchProcessor::run(pkey.get(), operation);
+  ASSERT_TRUE(operation.succeeded_);
+
+  bssl::ScopedEVP_MD_CTX ctx;
+  EVP_PKEY_CTX* pkey_ctx;
+  ASSERT_TRUE(EVP_DigestVerifyInit(ctx.get(), &pkey_ctx, EVP_sha256(), nullptr, pkey.get()));
+  ASSERT_TRUE(EVP_PKEY_CTX_set_rsa_padding(pkey_ctx, RSA_PKCS1_PSS_PADDING));
+  ASSERT_TRUE(EVP_PKEY_CTX_set_rsa_pss_saltlen(pkey_ctx, -1));
+  EXPECT_TRUE(EVP_DigestVerify(ctx.get(), operation.output_.data(), operation.output_.size(),
+                               reinterpret_cast<const uint8_t*>(message.data()),
+                               message.size()));
+}
+
+// A signature algorithm of another type of key fails rather than signing with the wrong one.
+TEST(OffloadBatchProcessorTest, SignWrongKeyType) {
+  bssl::UniquePtr<EVP_PKEY> pkey = loadKey("selfsigned_ecdsa_p256_key.pem");
+  ASSERT_NE(nullptr, pkey);
+  const std::string message = "message";
+  PrivateKeyOperation operation(PrivateKeyOperation::Type::Sign, SSL_SIGN_RSA_PSS_RSAE_SHA256,
+                                reinterpret_cast<const uint8_t*>(message.data()), message.size());
+  OffloadBatchProcessor::run(pkey.get(), operation);
+  EXPECT_FALSE(operation.succeeded_);
+  EXPECT_TRUE(operation.output_.empty());
+
+  PrivateKeyOperation decrypt(PrivateKeyOperation::Type::Decrypt, 0,
+                              reinterpret_cast<const uint8_t*>(message.data()), message.size());
+  OffloadBatchProcessor::run(pkey.get(), decrypt);
+  EXPECT_FALSE(decrypt.succeeded_);
+}
+
+TEST(OffloadBatchProcessorTest, Decrypt) {
+  bssl::UniquePtr<EVP_PKEY> pkey = loadKey("unittest_key.pem");
+  ASSERT_NE(nullptr, pkey);
+  RSA* rsa = EVP_PKEY_get0_RSA(pkey.get());
+  // Without padding, the plaintext is as long as the modulus and smaller than it.
+  std::vector<uint8_t> plaintext(RSA_size(rsa), 0x5a);
+  plaintext[0] = 0;
+  std::vector<uint8_t> ciphertext(RSA_size(rsa));
+  size_t ciphertext_len;
+  ASSERT_TRUE(RSA_encrypt(rsa, &ciphertext_len, ciphertext.data(), ciphertext.size(),
+                          plaintext.data(), plaintext.size(), RSA_NO_PADDING));
+
+  PrivateKeyOperation operation(PrivateKeyOperation::Type::Decrypt, 0, ciphertext.data(),
+                                ciphertext_len);
+  OffloadBatchProcessor::run(pkey.get(), operation);
+  ASSERT_TRUE(operation.succeeded_);
+  EXPECT_EQ(plaintext, operation.output_);
+}
+
+// The batch runs on a thread of the pool, which calls done once it has run.
+TEST(OffloadBatchProcessorTest, ProcessBatchOnPool) {
+  auto pool = std::make_shared<HandshakeOffloadPool>(Thread::threadFactoryForTest(), 1, 4);
+  OffloadBatchProcessor processor(loadKey("unittest_key.pem"), pool);
+  const std::string message = "message";
+  auto operation = std::make_shared<PrivateKeyOperation>(
+      PrivateKeyOperation::Type::Sign, SSL_SIGN_RSA_PKCS1_SHA256,
+      reinterpret_cast<const uint8_t*>(message.data()), message.size());
+
+  absl::Notification done;
+  Thread::ThreadId done_thread_id;
+  processor.processBatch({operation}, [&]() {
+    done_thread_id = Thread::threadFactoryForTest().currentThreadId();
+    done.Notify();
+  });
+  done.WaitForNotification();
+  EXPECT_TRUE(operation->succeeded_);
+  EXPECT_NE(Thread::threadFactoryForTest().currentThreadId(), done_thread_id);
+}
+
+// Once the queue of the pool is full, the batch runs on the calling thread.
+TEST(OffloadBatchProcessorTest, ProcessBatchInline) {
+  auto pool = std::make_shared<HandshakeOffloadPool>(Thread::threadFactoryForTest(), 1, 1);
+  BlockingTask blocking;
+  ASSERT_TRUE(pool->post(blocking.task()));
+  blocking.started_.WaitForNotification();
+  ASSERT_TRUE(pool->post([]() {}));
+
+  OffloadBatchProcessor processor(loadKey("unittest_key.pem"), pool);
+  const std::string message = "message";
+  auto operation = std::make_shared<PrivateKeyOperation>(
+      PrivateKeyOperation::Type::Sign, SSL_SIGN_RSA_PKCS1_SHA256,
+      reinterpret_cast<const uint8_t*>(message.data()), message.size());
+  bool done = false;
+  processor.processBatch({operation}, [&done]() { done = true; });
+  EXPECT_TRUE(done);
+  EXPECT_TRUE(operation->succeeded_);
+  blocking.release_.Notify();
+}
+
+class OffloadPrivateKeyMethodFactoryTest : public testing::Test {
+public:
+  Ssl::PrivateKeyMethodProviderSharedPtr createProvider(const std::string& key) {
+    envoy::extensions::private_key_providers::offload::v3::OffloadPrivateKeyMethodConfig config;
+    config.mutable_private_key()->set_inline_string(key);
+    config.mutable_thread_count()->set_value(2);
+    envoy::extensions::transport_sockets::tls::v3::PrivateKeyProvider provider_config;
+    provider_config.set_provider_name("envoy.tls.key_providers.offload");
+    provider_config.mutable_typed_config()->PackFrom(config);
+
+    auto* factory =
+        Registry::FactoryRegistry<Ssl::PrivateKeyMethodProviderInstanceFactory>::getFactory(
+            "envoy.tls.key_providers.offload");
+    EXPECT_NE(nullptr, factory);
+    return factory->createPrivateKeyMethodProviderInstance(provider_config, factory_context_);
+  }
+
+  testing::NiceMock<ThreadLocal::MockInstance> tls_;
+  testing::NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context_;
+};
+
+TEST_F(OffloadPrivateKeyMethodFactoryTest, CreateProvider) {
+  EXPECT_CALL(factory_context_, threadLocal()).WillOnce(testing::ReturnRef(tls_));
+  Ssl::PrivateKeyMethodProviderSharedPtr provider = createProvider(readKey("unittest_key.pem"));
+  ASSERT_NE(nullptr, provider);
+  EXPECT_NE(nullptr, provider->getBoringSslPrivateKeyMethod());
+  EXPECT_NE(nullptr, HandshakeOffloadPool::get());
+  provider.reset();
+  EXPECT_EQ(nullptr, HandshakeOffloadPool::get());
+}
+
+TEST_F(OffloadPrivateKeyMethodFactoryTest, InvalidKey) {
+  EXPECT_THROW_WITH_MESSAGE(createProvider("not a key"), EnvoyException,
+                            "Failed to load the private key of the handshake offload provider");
+}
+
+} // namespace
+} // namespace Offload
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
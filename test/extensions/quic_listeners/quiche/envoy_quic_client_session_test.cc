@@ -80,9 +80,11 @@ public:
                              const quic::QuicServerId& server_id,
                              quic::QuicCryptoClientConfig* crypto_config,
                              quic::QuicClientPushPromiseIndex* push_promise_index,
-                             Event::Dispatcher& dispatcher, uint32_t send_buffer_limit)
+                             Event::Dispatcher& dispatcher, uint32_t send_buffer_limit,
+                             bool allow_early_data)
       : EnvoyQuicClientSession(config, supported_versions, std::move(connection), server_id,
-                               crypto_config, push_promise_index, dispatcher, send_buffer_limit) {}
+                               crypto_config, push_promise_index, dispatcher, send_buffer_limit,
+                               allow_early_data) {}
 
   std::unique_ptr<quic::QuicCryptoClientStreamBase> CreateQuicCryptoStream() override {
     return std::make_unique<TestQuicCryptoClientStream>(
@@ -113,7 +115,7 @@ public:
                             std::unique_ptr<TestEnvoyQuicClientConnection>(quic_connection_),
                             quic::QuicServerId("example.com", 443, false), &crypto_config_, nullptr,
                             *dispatcher_,
-                            /*send_buffer_limit*/ 1024 * 1024),
+                            /*send_buffer_limit*/ 1024 * 1024, /*allow_early_data*/ false),
         http_connection_(envoy_quic_session_, http_connection_callbacks_) {
     EXPECT_EQ(time_system_.systemTime(), envoy_quic_session_.streamInfo().startTime());
     EXPECT_EQ(EMPTY_STRING, envoy_quic_session_.nextProtocol());
@@ -251,5 +253,18 @@ TEST_P(EnvoyQuicClientSessionTest, ConnectionCloseWithActiveStream) {
   EXPECT_TRUE(stream.write_side_closed() && stream.reading_stopped());
 }
 
+TEST_P(EnvoyQuicClientSessionTest, ConnectedOnceHandshakeIsComplete) {
+  // Early data isn't allowed, so the 0-RTT keys of a resumed session don't make the connection
+  // usable yet.
+  auto encrypter = std::make_unique<quic::NullEncrypter>(quic::Perspective::IS_CLIENT);
+  quic_connection_->SetEncrypter(quic::ENCRYPTION_ZERO_RTT, std::move(encrypter));
+  EXPECT_CALL(network_connection_callbacks_, onEvent(Network::ConnectionEvent::Connected)).Times(0);
+  envoy_quic_session_.SetDefaultEncryptionLevel(quic::ENCRYPTION_ZERO_RTT);
+  testing::Mock::VerifyAndClearExpectations(&network_connection_callbacks_);
+
+  EXPECT_CALL(network_connection_callbacks_, onEvent(Network::ConnectionEvent::Connected));
+  envoy_quic_session_.SetDefaultEncryptionLevel(quic::ENCRYPTION_FORWARD_SECURE);
+}
+
 } // namespace Quic
 } // namespace Envoy
@@ -0,0 +1,110 @@
+#include <chrono>
+#include <memory>
+
+#include "extensions/quic_listeners/quiche/envoy_quic_session_cache.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Quic {
+
+class EnvoyQuicSessionCacheTest : public testing::Test {
+public:
+  EnvoyQuicSessionCacheTest()
+      : ssl_ctx_(SSL_CTX_new(TLS_method())), cache_(time_system_),
+        server_id_("www.example.org", 443, false) {
+    params_.initial_max_data.set_value(10);
+  }
+
+  bssl::UniquePtr<SSL_SESSION> makeSession(uint32_t timeout = 3600) {
+    bssl::UniquePtr<SSL_SESSION> session(SSL_SESSION_new(ssl_ctx_.get()));
+    const uint64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+                             time_system_.systemTime().time_since_epoch())
+                             .count();
+    SSL_SESSION_set_time(session.get(), now);
+    SSL_SESSION_set_timeout(session.get(), timeout);
+    return session;
+  }
+
+protected:
+  Event::SimulatedTimeSystem time_system_;
+  bssl::UniquePtr<SSL_CTX> ssl_ctx_;
+  EnvoyQuicSessionCache cache_;
+  quic::QuicServerId server_id_;
+  quic::TransportParameters params_;
+};
+
+TEST_F(EnvoyQuicSessionCacheTest, LookupMiss) {
+  EXPECT_EQ(nullptr, cache_.Lookup(server_id_, ssl_ctx_.get()));
+}
+
+// Sessions are used once, the most recent first, and share the state of their connection.
+TEST_F(EnvoyQuicSessionCacheTest, SingleUse) {
+  bssl::UniquePtr<SSL_SESSION> session1 = makeSession();
+  SSL_SESSION* raw_session1 = session1.get();
+  bssl::UniquePtr<SSL_SESSION> session2 = makeSession();
+  SSL_SESSION* raw_session2 = session2.get();
+  quic::ApplicationState state{1, 2, 3};
+  cache_.Insert(server_id_, std::move(session1), params_, &state);
+  cache_.Insert(server_id_, std::move(session2), params_, &state);
+  EXPECT_EQ(1, cache_.size());
+
+  std::unique_ptr<quic::QuicResumptionState> resumption = cache_.Lookup(server_id_, nullptr);
+  ASSERT_NE(nullptr, resumption);
+  EXPECT_EQ(raw_session2, resumption->tls_session.get());
+  EXPECT_EQ(params_, *resumption->transport_params);
+  EXPECT_EQ(state, *resumption->application_state);
+
+  resumption = cache_.Lookup(server_id_, nullptr);
+  ASSERT_NE(nullptr, resumption);
+  EXPECT_EQ(raw_session1, resumption->tls_session.get());
+
+  EXPECT_EQ(nullptr, cache_.Lookup(server_id_, nullptr));
+}
+
+// A session of a connection with other transport parameters replaces the previous ones.
+TEST_F(EnvoyQuicSessionCacheTest, NewParameters) {
+  cache_.Insert(server_id_, makeSession(), params_, nullptr);
+  quic::TransportParameters params;
+  params.initial_max_data.set_value(20);
+  bssl::UniquePtr<SSL_SESSION> session = makeSession();
+  SSL_SESSION* raw_session = session.get();
+  cache_.Insert(server_id_, std::move(session), params, nullptr);
+
+  std::unique_ptr<quic::QuicResumptionState> resumption = cache_.Lookup(server_id_, nullptr);
+  ASSERT_NE(nullptr, resumption);
+  EXPECT_EQ(raw_session, resumption->tls_session.get());
+  EXPECT_EQ(params, *resumption->transport_params);
+  EXPECT_EQ(nullptr, resumption->application_state);
+  EXPECT_EQ(nullptr, cache_.Lookup(server_id_, nullptr));
+}
+
+TEST_F(EnvoyQuicSessionCacheTest, Expiry) {
+  cache_.Insert(server_id_, makeSession(10), params_, nullptr);
+  time_system_.advanceTimeWait(std::chrono::seconds(11));
+  EXPECT_EQ(nullptr, cache_.Lookup(server_id_, nullptr));
+  EXPECT_EQ(0, cache_.size());
+}
+
+TEST_F(EnvoyQuicSessionCacheTest, ClearEarlyData) {
+  cache_.Insert(server_id_, makeSession(), params_, nullptr);
+  cache_.ClearEarlyData(server_id_);
+  cache_.ClearEarlyData(quic::QuicServerId("www.example.com", 443, false));
+
+  std::unique_ptr<quic::QuicResumptionState> resumption = cache_.Lookup(server_id_, nullptr);
+  ASSERT_NE(nullptr, resumption);
+  EXPECT_FALSE(SSL_SESSION_early_data_capable(resumption->tls_session.get()));
+}
+
+TEST_F(EnvoyQuicSessionCacheTest, MaxEntries) {
+  for (uint16_t port = 0; port <= EnvoyQuicSessionCache::MaxEntries; ++port) {
+    cache_.Insert(quic::QuicServerId("www.example.org", port, false), makeSession(), params_,
+                  nullptr);
+  }
+  EXPECT_EQ(EnvoyQuicSessionCache::MaxEntries, cache_.size());
+}
+
+} // namespace Quic
+} // namespace Envoy
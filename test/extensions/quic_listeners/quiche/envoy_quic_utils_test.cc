@@ -12,6 +12,8 @@
 #pragma GCC diagnostic pop
 #endif
 
+#include "common/buffer/buffer_impl.h"
+
 #include "test/mocks/api/mocks.h"
 #include "test/test_common/threadsafe_singleton_injector.h"
 
@@ -61,5 +63,46 @@ TEST(EnvoyQuicUtilsTest, HeadersConversion) {
   EXPECT_EQ(*envoy_headers, *envoy_headers2);
 }
 
+TEST(EnvoyQuicUtilsTest, AdjustNewConnectionIdForRouting) {
+  for (const uint64_t id : {uint64_t(0), uint64_t(12345), uint64_t(0xfffffffe12345678),
+                            uint64_t(0xffffffffffffffff)}) {
+    for (const uint32_t concurrency : {1u, 3u, 8u}) {
+      for (uint32_t worker_index = 0; worker_index < concurrency; ++worker_index) {
+        quic::QuicConnectionId connection_id = quic::test::TestConnectionId(id);
+        adjustNewConnectionIdForRouting(connection_id, worker_index, concurrency);
+        ASSERT_EQ(8, connection_id.length());
+        uint32_t connection_id_snippet;
+        memcpy(&connection_id_snippet, connection_id.data(), sizeof(connection_id_snippet));
+        EXPECT_EQ(worker_index, ntohl(connection_id_snippet) % concurrency);
+        // The rest of the connection id is unchanged.
+        EXPECT_EQ(0, memcmp(connection_id.data() + 4,
+                            quic::test::TestConnectionId(id).data() + 4, 4));
+      }
+    }
+  }
+
+  // Connection ids shorter than the routed bytes are left as they are.
+  char data[] = {1, 2};
+  quic::QuicConnectionId short_connection_id(data, sizeof(data));
+  adjustNewConnectionIdForRouting(short_connection_id, 1, 2);
+  EXPECT_EQ(quic::QuicConnectionId(data, sizeof(data)), short_connection_id);
+}
+
+TEST(EnvoyQuicUtilsTest, CopyReadableRegions) {
+  std::string first("aaa");
+  std::string second("bbbbb");
+  std::string third("c");
+  iovec regions[] = {{&first[0], first.size()}, {&second[0], second.size()}, {&third[0], 0}};
+
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(8, copyReadableRegions(regions, 3, buffer));
+  EXPECT_EQ("aaabbbbb", buffer.toString());
+  // The regions are copied into a single slice.
+  EXPECT_EQ(1, buffer.getRawSlices().size());
+
+  EXPECT_EQ(0, copyReadableRegions(regions + 2, 1, buffer));
+  EXPECT_EQ("aaabbbbb", buffer.toString());
+}
+
 } // namespace Quic
 } // namespace Envoy
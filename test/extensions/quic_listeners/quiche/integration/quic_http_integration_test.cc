@@ -133,7 +133,7 @@ public:
     quic_connection_ = connection.get();
     auto session = std::make_unique<EnvoyQuicClientSession>(
         quic_config_, supported_versions_, std::move(connection), server_id_, crypto_config_.get(),
-        &push_promise_index_, *dispatcher_, 0);
+        &push_promise_index_, *dispatcher_, 0, /*allow_early_data=*/false);
     session->Initialize();
     return session;
   }
@@ -0,0 +1,125 @@
+#include "envoy/extensions/resource_monitors/cgroup_memory/v3/cgroup_memory.pb.h"
+
+#include "extensions/resource_monitors/cgroup_memory/cgroup_memory_monitor.h"
+
+#include "test/mocks/filesystem/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+using testing::Throw;
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+namespace {
+
+class MockedCallbacks : public Server::ResourceMonitor::Callbacks {
+public:
+  MOCK_METHOD(void, onSuccess, (const Server::ResourceUsage&));
+  MOCK_METHOD(void, onFailure, (const EnvoyException&));
+};
+
+class CgroupMemoryMonitorTest : public testing::Test {
+protected:
+  std::unique_ptr<CgroupMemoryMonitor> createMonitor(bool v2) {
+    EXPECT_CALL(file_system_, fileExists("/cgroup/memory.current")).WillRepeatedly(Return(v2));
+    config_.set_cgroup_path("/cgroup");
+    return std::make_unique<CgroupMemoryMonitor>(config_, file_system_);
+  }
+
+  void setFile(const std::string& name, const std::string& contents) {
+    EXPECT_CALL(file_system_, fileReadToEnd("/cgroup/" + name)).WillRepeatedly(Return(contents));
+  }
+
+  envoy::extensions::resource_monitors::cgroup_memory::v3::CgroupMemoryConfig config_;
+  NiceMock<Filesystem::MockInstance> file_system_;
+  MockedCallbacks cb_;
+};
+
+// The pressure of a cgroup v2 excludes its inactive page cache.
+TEST_F(CgroupMemoryMonitorTest, CgroupV2) {
+  auto monitor = createMonitor(true);
+  setFile("memory.current", "800\n");
+  setFile("memory.max", "1000\n");
+  setFile("memory.stat", "anon 500\nfile 300\nactive_file 100\ninactive_file 200\n");
+  EXPECT_CALL(cb_, onSuccess(Server::ResourceUsage{0.6}));
+  monitor->updateResourceUsage(cb_);
+}
+
+TEST_F(CgroupMemoryMonitorTest, CgroupV1) {
+  auto monitor = createMonitor(false);
+  setFile("memory.usage_in_bytes", "800\n");
+  setFile("memory.limit_in_bytes", "1000\n");
+  setFile("memory.stat", "cache 300\ninactive_file 50\ntotal_inactive_file 200\n");
+  EXPECT_CALL(cb_, onSuccess(Server::ResourceUsage{0.6}));
+  monitor->updateResourceUsage(cb_);
+}
+
+// max_memory_bytes only applies when it is lower than the limit of the cgroup.
+TEST_F(CgroupMemoryMonitorTest, MaxMemory) {
+  config_.set_max_memory_bytes(500);
+  auto monitor = createMonitor(true);
+  setFile("memory.current", "400\n");
+  setFile("memory.max", "1000\n");
+  setFile("memory.stat", "inactive_file 100\n");
+  EXPECT_CALL(cb_, onSuccess(Server::ResourceUsage{0.6}));
+  monitor->updateResourceUsage(cb_);
+
+  setFile("memory.max", "250\n");
+  EXPECT_CALL(cb_, onSuccess(Server::ResourceUsage{1.2}));
+  monitor->updateResourceUsage(cb_);
+}
+
+TEST_F(CgroupMemoryMonitorTest, UnlimitedCgroup) {
+  auto monitor = createMonitor(false);
+  setFile("memory.usage_in_bytes", "400\n");
+  setFile("memory.limit_in_bytes", "9223372036854771712\n");
+  setFile("memory.stat", "total_inactive_file 100\n");
+  EXPECT_CALL(cb_, onFailure(_));
+  monitor->updateResourceUsage(cb_);
+
+  config_.set_max_memory_bytes(600);
+  monitor = createMonitor(false);
+  EXPECT_CALL(cb_, onSuccess(Server::ResourceUsage{0.5}));
+  monitor->updateResourceUsage(cb_);
+}
+
+TEST_F(CgroupMemoryMonitorTest, UnlimitedCgroupV2) {
+  config_.set_max_memory_bytes(600);
+  auto monitor = createMonitor(true);
+  setFile("memory.current", "400\n");
+  setFile("memory.max", "max\n");
+  setFile("memory.stat", "inactive_file 500\n");
+  EXPECT_CALL(cb_, onSuccess(Server::ResourceUsage{0}));
+  monitor->updateResourceUsage(cb_);
+}
+
+TEST_F(CgroupMemoryMonitorTest, ReportsErrors) {
+  auto monitor = createMonitor(true);
+  setFile("memory.max", "1000\n");
+  setFile("memory.stat", "inactive_file 100\n");
+  EXPECT_CALL(file_system_, fileReadToEnd("/cgroup/memory.current"))
+      .WillOnce(Throw(EnvoyException("unable to read file")));
+  EXPECT_CALL(cb_, onFailure(_));
+  monitor->updateResourceUsage(cb_);
+
+  setFile("memory.current", "not a number\n");
+  EXPECT_CALL(cb_, onFailure(_));
+  monitor->updateResourceUsage(cb_);
+
+  setFile("memory.current", "400\n");
+  setFile("memory.stat", "anon 400\n");
+  EXPECT_CALL(cb_, onFailure(_));
+  monitor->updateResourceUsage(cb_);
+}
+
+} // namespace
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
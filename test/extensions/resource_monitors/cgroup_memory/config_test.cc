@@ -0,0 +1,42 @@
+#include "envoy/extensions/resource_monitors/cgroup_memory/v3/cgroup_memory.pb.h"
+#include "envoy/extensions/resource_monitors/cgroup_memory/v3/cgroup_memory.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "server/resource_monitor_config_impl.h"
+
+#include "extensions/resource_monitors/cgroup_memory/config.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+namespace {
+
+TEST(CgroupMemoryMonitorFactoryTest, CreateMonitor) {
+  auto factory =
+      Registry::FactoryRegistry<Server::Configuration::ResourceMonitorFactory>::getFactory(
+          "envoy.resource_monitors.cgroup_memory");
+  EXPECT_NE(factory, nullptr);
+
+  envoy::extensions::resource_monitors::cgroup_memory::v3::CgroupMemoryConfig config;
+  config.set_max_memory_bytes(1024 * 1024 * 1024);
+  Event::MockDispatcher dispatcher;
+  Api::ApiPtr api = Api::createApiForTest();
+  testing::NiceMock<ThreadLocal::MockInstance> tls;
+  Server::Configuration::ResourceMonitorFactoryContextImpl context(
+      dispatcher, *api, tls, ProtobufMessage::getStrictValidationVisitor());
+  auto monitor = factory->createResourceMonitor(config, context);
+  EXPECT_NE(monitor, nullptr);
+}
+
+} // namespace
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
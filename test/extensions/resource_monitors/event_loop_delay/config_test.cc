@@ -0,0 +1,42 @@
+#include "envoy/extensions/resource_monitors/event_loop_delay/v3/event_loop_delay.pb.h"
+#include "envoy/extensions/resource_monitors/event_loop_delay/v3/event_loop_delay.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "server/resource_monitor_config_impl.h"
+
+#include "extensions/resource_monitors/event_loop_delay/config.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopDelayMonitor {
+namespace {
+
+TEST(EventLoopDelayMonitorFactoryTest, CreateMonitor) {
+  auto factory =
+      Registry::FactoryRegistry<Server::Configuration::ResourceMonitorFactory>::getFactory(
+          "envoy.resource_monitors.event_loop_delay");
+  EXPECT_NE(factory, nullptr);
+
+  envoy::extensions::resource_monitors::event_loop_delay::v3::EventLoopDelayConfig config;
+  config.mutable_target_delay()->set_seconds(1);
+  Event::MockDispatcher dispatcher;
+  Api::ApiPtr api = Api::createApiForTest();
+  testing::NiceMock<ThreadLocal::MockInstance> tls;
+  Server::Configuration::ResourceMonitorFactoryContextImpl context(
+      dispatcher, *api, tls, ProtobufMessage::getStrictValidationVisitor());
+  auto monitor = factory->createResourceMonitor(config, context);
+  EXPECT_NE(monitor, nullptr);
+}
+
+} // namespace
+} // namespace EventLoopDelayMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,93 @@
+#include "envoy/extensions/resource_monitors/event_loop_delay/v3/event_loop_delay.pb.h"
+
+#include "server/resource_monitor_config_impl.h"
+
+#include "extensions/resource_monitors/event_loop_delay/event_loop_delay_monitor.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopDelayMonitor {
+namespace {
+
+class MockedCallbacks : public Server::ResourceMonitor::Callbacks {
+public:
+  MOCK_METHOD(void, onSuccess, (const Server::ResourceUsage&));
+  MOCK_METHOD(void, onFailure, (const EnvoyException&));
+};
+
+class EventLoopDelayMonitorTest : public testing::Test, public Event::TestUsingSimulatedTime {
+protected:
+  EventLoopDelayMonitorTest() : api_(Api::createApiForTest()) {
+    config_.mutable_target_delay()->set_nanos(50000000);
+    config_.mutable_sample_interval()->set_nanos(100000000);
+  }
+
+  // The dispatcher of the thread local storage stands for the one of a worker.
+  std::unique_ptr<EventLoopDelayMonitor> createMonitor(Event::Dispatcher& main_dispatcher) {
+    Server::Configuration::ResourceMonitorFactoryContextImpl context(
+        main_dispatcher, *api_, tls_, ProtobufMessage::getStrictValidationVisitor());
+    return std::make_unique<EventLoopDelayMonitor>(config_, context);
+  }
+
+  envoy::extensions::resource_monitors::event_loop_delay::v3::EventLoopDelayConfig config_;
+  Api::ApiPtr api_;
+  NiceMock<Event::MockDispatcher> main_dispatcher_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  MockedCallbacks cb_;
+};
+
+TEST_F(EventLoopDelayMonitorTest, ReportsDelay) {
+  auto* timer = new NiceMock<Event::MockTimer>(&tls_.dispatcher_);
+  auto monitor = createMonitor(main_dispatcher_);
+
+  // The samplers start on the first update.
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(100), _));
+  EXPECT_CALL(cb_, onSuccess(Server::ResourceUsage{0}));
+  monitor->updateResourceUsage(cb_);
+
+  // The timer fires 25ms late.
+  simTime().advanceTimeWait(std::chrono::milliseconds(125));
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(100), _));
+  timer->invokeCallback();
+  EXPECT_CALL(cb_, onSuccess(Server::ResourceUsage{0.5}));
+  monitor->updateResourceUsage(cb_);
+
+  // The delay is reset once reported.
+  EXPECT_CALL(cb_, onSuccess(Server::ResourceUsage{0}));
+  monitor->updateResourceUsage(cb_);
+
+  // A worker that is stuck is as late as its timer is overdue.
+  simTime().advanceTimeWait(std::chrono::milliseconds(200));
+  EXPECT_CALL(cb_, onSuccess(Server::ResourceUsage{2}));
+  monitor->updateResourceUsage(cb_);
+}
+
+// The main thread does not sample its delay.
+TEST_F(EventLoopDelayMonitorTest, SkipsMainThread) {
+  auto monitor = createMonitor(tls_.dispatcher_);
+  EXPECT_CALL(tls_.dispatcher_, createTimer_(_)).Times(0);
+  EXPECT_CALL(cb_, onSuccess(Server::ResourceUsage{0}));
+  monitor->updateResourceUsage(cb_);
+
+  simTime().advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_CALL(cb_, onSuccess(Server::ResourceUsage{0}));
+  monitor->updateResourceUsage(cb_);
+}
+
+} // namespace
+} // namespace EventLoopDelayMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,39 @@
+#include "envoy/extensions/resource_monitors/handshake_offload/v3/handshake_offload.pb.h"
+#include "envoy/registry/registry.h"
+
+#include "server/resource_monitor_config_impl.h"
+
+#include "extensions/resource_monitors/handshake_offload/config.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace HandshakeOffloadMonitor {
+namespace {
+
+TEST(HandshakeOffloadMonitorFactoryTest, CreateMonitor) {
+  auto factory =
+      Registry::FactoryRegistry<Server::Configuration::ResourceMonitorFactory>::getFactory(
+          "envoy.resource_monitors.handshake_offload");
+  EXPECT_NE(factory, nullptr);
+
+  envoy::extensions::resource_monitors::handshake_offload::v3::HandshakeOffloadConfig config;
+  Event::MockDispatcher dispatcher;
+  Api::ApiPtr api = Api::createApiForTest();
+  testing::NiceMock<ThreadLocal::MockInstance> tls;
+  Server::Configuration::ResourceMonitorFactoryContextImpl context(
+      dispatcher, *api, tls, ProtobufMessage::getStrictValidationVisitor());
+  auto monitor = factory->createResourceMonitor(config, context);
+  EXPECT_NE(monitor, nullptr);
+}
+
+} // namespace
+} // namespace HandshakeOffloadMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,58 @@
+#include "extensions/private_key_providers/offload/handshake_offload_pool.h"
+#include "extensions/resource_monitors/handshake_offload/handshake_offload_monitor.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/synchronization/notification.h"
+#include "absl/types/optional.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace HandshakeOffloadMonitor {
+namespace {
+
+using PrivateKeyMethodProvider::Offload::HandshakeOffloadPool;
+
+class ResourcePressure : public Server::ResourceMonitor::Callbacks {
+public:
+  void onSuccess(const Server::ResourceUsage& usage) override {
+    pressure_ = usage.resource_pressure_;
+  }
+
+  void onFailure(const EnvoyException&) override {}
+
+  absl::optional<double> pressure_;
+};
+
+TEST(HandshakeOffloadMonitorTest, NoPool) {
+  HandshakeOffloadMonitor monitor;
+  ResourcePressure resource;
+  monitor.updateResourceUsage(resource);
+  EXPECT_EQ(0, resource.pressure_);
+}
+
+TEST(HandshakeOffloadMonitorTest, QueuedTasks) {
+  auto pool = HandshakeOffloadPool::getOrCreate(Thread::threadFactoryForTest(), 1, 4);
+  absl::Notification started;
+  absl::Notification release;
+  ASSERT_TRUE(pool->post([&]() {
+    started.Notify();
+    release.WaitForNotification();
+  }));
+  started.WaitForNotification();
+  ASSERT_TRUE(pool->post([]() {}));
+
+  HandshakeOffloadMonitor monitor;
+  ResourcePressure resource;
+  monitor.updateResourceUsage(resource);
+  EXPECT_EQ(0.25, resource.pressure_);
+  release.Notify();
+}
+
+} // namespace
+} // namespace HandshakeOffloadMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
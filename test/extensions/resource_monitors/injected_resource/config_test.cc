@@ -29,8 +29,9 @@ TEST(InjectedResourceMonitorFactoryTest, CreateMonitor) {
   config.set_filename(TestEnvironment::temporaryPath("injected_resource"));
   Api::ApiPtr api = Api::createApiForTest();
   Event::DispatcherPtr dispatcher(api->allocateDispatcher("test_thread"));
+  testing::NiceMock<ThreadLocal::MockInstance> tls;
   Server::Configuration::ResourceMonitorFactoryContextImpl context(
-      *dispatcher, *api, ProtobufMessage::getStrictValidationVisitor());
+      *dispatcher, *api, tls, ProtobufMessage::getStrictValidationVisitor());
   Server::ResourceMonitorPtr monitor = factory->createResourceMonitor(config, context);
   EXPECT_NE(monitor, nullptr);
 }
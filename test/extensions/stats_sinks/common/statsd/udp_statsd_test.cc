@@ -33,6 +33,7 @@ class MockWriter : public UdpStatsdSink::Writer {
 public:
   MOCK_METHOD(void, write, (const std::string& message));
   MOCK_METHOD(void, writeBuffer, (Buffer::Instance & buffer));
+  MOCK_METHOD(void, flush, ());
 
   void delegateBufferFake() {
     ON_CALL(*this, writeBuffer).WillByDefault([this](Buffer::Instance& buffer) {
@@ -256,6 +257,7 @@ TEST(UdpStatsdSinkTest, CheckBufferedWritesWithinBufferSize) {
 
   // Expect both metrics to be present in single write
   EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), writeBuffer(_));
+  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr), flush());
   sink.flush(snapshot);
   EXPECT_EQ(writer_ptr->buffer_writes.size(), 1);
   EXPECT_EQ(writer_ptr->buffer_writes.at(0), "envoy.test_counter:1|c\nenvoy.test_gauge:1|g");
@@ -263,6 +265,42 @@ TEST(UdpStatsdSinkTest, CheckBufferedWritesWithinBufferSize) {
   tls_.shutdownThread();
 }
 
+// A metric too large for the buffer is written on its own, without flushing the buffered metrics.
+TEST(UdpStatsdSinkTest, CheckMetricLargerThanBufferAfterBufferedMetric) {
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
+  writer_ptr->delegateBufferFake();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  uint64_t buffer_size = 48;
+  UdpStatsdSink sink(tls_, writer_ptr, false, getDefaultPrefix(), buffer_size);
+
+  NiceMock<Stats::MockCounter> counter_1;
+  counter_1.name_ = "test_counter_1";
+  counter_1.used_ = true;
+  counter_1.latch_ = 1;
+  snapshot.counters_.push_back({1, counter_1});
+
+  NiceMock<Stats::MockCounter> counter_2;
+  counter_2.name_ = "test_counter_with_a_name_longer_than_the_buffer";
+  counter_2.used_ = true;
+  counter_2.latch_ = 1;
+  snapshot.counters_.push_back({1, counter_2});
+
+  NiceMock<Stats::MockGauge> gauge;
+  gauge.name_ = "test_gauge";
+  gauge.value_ = 1;
+  gauge.used_ = true;
+  snapshot.gauges_.push_back(gauge);
+
+  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr),
+              write("envoy.test_counter_with_a_name_longer_than_the_buffer:1|c"));
+  sink.flush(snapshot);
+  ASSERT_EQ(writer_ptr->buffer_writes.size(), 1);
+  EXPECT_EQ(writer_ptr->buffer_writes.at(0), "envoy.test_counter_1:1|c\nenvoy.test_gauge:1|g");
+
+  tls_.shutdownThread();
+}
+
 TEST(UdpStatsdSinkTest, CheckBufferedWritesExceedingBufferSize) {
   NiceMock<Stats::MockMetricSnapshot> snapshot;
   auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
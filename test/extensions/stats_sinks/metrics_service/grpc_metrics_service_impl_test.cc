@@ -9,6 +9,8 @@
 #include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/simulated_time_system.h"
 
+#include "absl/strings/str_cat.h"
+
 using namespace std::chrono_literals;
 using testing::_;
 using testing::InSequence;
@@ -202,6 +204,71 @@ TEST_F(MetricsServiceSinkTest, ReportCountersAsDeltas) {
   sink.flush(snapshot_);
 }
 
+// Test that the metrics of a flush are split into batches, without splitting histograms.
+TEST_F(MetricsServiceSinkTest, MaxMetricsPerMessage) {
+  MetricsServiceSink<envoy::service::metrics::v3::StreamMetricsMessage,
+                     envoy::service::metrics::v3::StreamMetricsResponse>
+      sink(streamer_, false, 2);
+  EXPECT_FALSE(sink.flushChangedMetricsOnly());
+
+  std::vector<std::unique_ptr<NiceMock<Stats::MockCounter>>> counters;
+  for (uint32_t i = 0; i < 3; ++i) {
+    counters.push_back(std::make_unique<NiceMock<Stats::MockCounter>>());
+    counters.back()->name_ = absl::StrCat("test_counter_", i);
+    counters.back()->used_ = true;
+    snapshot_.counters_.push_back({1, *counters.back()});
+  }
+
+  auto histogram = std::make_shared<NiceMock<Stats::MockParentHistogram>>();
+  histogram->name_ = "test_histogram";
+  histogram->used_ = true;
+  snapshot_.histograms_.push_back(*histogram);
+
+  std::vector<std::vector<std::string>> batches;
+  EXPECT_CALL(*streamer_, send(_)).Times(3).WillRepeatedly(Invoke([&batches](MetricsPtr&& metrics) {
+    std::vector<std::string> names;
+    for (const auto& metric_family : *metrics) {
+      names.push_back(metric_family.name());
+    }
+    batches.push_back(names);
+  }));
+  sink.flush(snapshot_);
+  EXPECT_EQ((std::vector<std::vector<std::string>>{{"test_counter_0", "test_counter_1"},
+                                                   {"test_counter_2"},
+                                                   {"test_histogram", "test_histogram"}}),
+            batches);
+}
+
+// Test that counters that did not change are left out when configured to do so.
+TEST_F(MetricsServiceSinkTest, ReportChangedMetricsOnly) {
+  MetricsServiceSink<envoy::service::metrics::v3::StreamMetricsMessage,
+                     envoy::service::metrics::v3::StreamMetricsResponse>
+      sink(streamer_, true, 0, true);
+  EXPECT_TRUE(sink.flushChangedMetricsOnly());
+
+  auto changed = std::make_shared<NiceMock<Stats::MockCounter>>();
+  changed->name_ = "changed_counter";
+  changed->used_ = true;
+  snapshot_.counters_.push_back({1, *changed});
+  auto unchanged = std::make_shared<NiceMock<Stats::MockCounter>>();
+  unchanged->name_ = "unchanged_counter";
+  unchanged->used_ = true;
+  snapshot_.counters_.push_back({0, *unchanged});
+
+  EXPECT_CALL(*streamer_, send(_)).WillOnce(Invoke([](MetricsPtr&& metrics) {
+    ASSERT_EQ(1, metrics->size());
+    EXPECT_EQ("changed_counter", (*metrics)[0].name());
+  }));
+  sink.flush(snapshot_);
+
+  // A flush without any change still sends a message.
+  snapshot_.counters_.clear();
+  EXPECT_CALL(*streamer_, send(_)).WillOnce(Invoke([](MetricsPtr&& metrics) {
+    EXPECT_EQ(0, metrics->size());
+  }));
+  sink.flush(snapshot_);
+}
+
 } // namespace
 } // namespace MetricsService
 } // namespace StatSinks
@@ -272,6 +272,49 @@ TEST_F(ZipkinDriverTest, FlushOneSpanReportFailure) {
   EXPECT_EQ(0U, stats_.counter("tracing.zipkin.reports_failed").value());
 }
 
+// The spans flushed while max_pending_reports reports are in flight are dropped.
+TEST_F(ZipkinDriverTest, DropSpansWhileReportsPending) {
+  ON_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.max_pending_reports", 128U))
+      .WillByDefault(Return(1U));
+  setupValidDriver("HTTP_JSON");
+  EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.min_flush_spans", 5))
+      .WillRepeatedly(Return(1));
+  EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.request_timeout", 5000U))
+      .WillRepeatedly(Return(5000U));
+
+  Http::MockAsyncClientRequest request(&cm_.thread_local_cluster_.async_client_);
+  Http::AsyncClient::Callbacks* callback;
+  EXPECT_CALL(cm_.thread_local_cluster_.async_client_, send_(_, _, _))
+      .Times(2)
+      .WillRepeatedly(Invoke([&](Http::RequestMessagePtr&, Http::AsyncClient::Callbacks& callbacks,
+                                 const Http::AsyncClient::RequestOptions&) {
+        callback = &callbacks;
+        return &request;
+      }));
+
+  for (int i = 0; i < 2; ++i) {
+    driver_
+        ->startSpan(config_, request_headers_, operation_name_, start_time_,
+                    {Tracing::Reason::Sampling, true})
+        ->finishSpan();
+  }
+  EXPECT_EQ(1U, stats_.counter("tracing.zipkin.spans_sent").value());
+  EXPECT_EQ(1U, stats_.counter("tracing.zipkin.spans_dropped").value());
+
+  // Once the report completes, the spans are sent again.
+  callback->onSuccess(request,
+                      Http::ResponseMessagePtr(new Http::ResponseMessageImpl(
+                          Http::ResponseHeaderMapPtr{
+                              new Http::TestResponseHeaderMapImpl{{":status", "202"}}})));
+  driver_
+      ->startSpan(config_, request_headers_, operation_name_, start_time_,
+                  {Tracing::Reason::Sampling, true})
+      ->finishSpan();
+  EXPECT_EQ(2U, stats_.counter("tracing.zipkin.spans_sent").value());
+  EXPECT_EQ(1U, stats_.counter("tracing.zipkin.spans_dropped").value());
+  callback->onFailure(request, Http::AsyncClient::FailureReason::Reset);
+}
+
 TEST_F(ZipkinDriverTest, SkipReportIfCollectorClusterHasBeenRemoved) {
   Upstream::ClusterUpdateCallbacks* cluster_update_callbacks;
   EXPECT_CALL(cm_, addThreadLocalClusterUpdateCallbacks_(_))
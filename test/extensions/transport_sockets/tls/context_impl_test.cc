@@ -561,7 +561,7 @@ TEST_F(SslContextImplTest, TestNoCert) {
   EXPECT_TRUE(context->getCertChainInformation().empty());
 }
 
-// Multiple RSA certificates are rejected.
+// Multiple RSA certificates for the same name are rejected.
 TEST_F(SslContextImplTest, AtMostOneRsaCert) {
   envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext tls_context;
   const std::string tls_context_yaml = R"EOF(
@@ -583,7 +583,7 @@ TEST_F(SslContextImplTest, AtMostOneRsaCert) {
       "at most one certificate of a given type may be specified");
 }
 
-// Multiple ECDSA certificates are rejected.
+// Multiple ECDSA certificates for the same name are rejected.
 TEST_F(SslContextImplTest, AtMostOneEcdsaCert) {
   envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext tls_context;
   const std::string tls_context_yaml = R"EOF(
@@ -605,6 +605,28 @@ TEST_F(SslContextImplTest, AtMostOneEcdsaCert) {
       "at most one certificate of a given type may be specified");
 }
 
+// Multiple certificates of the same type are accepted for different names.
+TEST_F(SslContextImplTest, MultipleRsaCertsForDifferentNames) {
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext tls_context;
+  const std::string tls_context_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+    - certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_key.pem"
+    - certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_multiple_dns_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_multiple_dns_key.pem"
+  )EOF";
+  TestUtility::loadFromYaml(TestEnvironment::substitute(tls_context_yaml), tls_context);
+  ServerContextConfigImpl server_context_config(tls_context, factory_context_);
+  Envoy::Ssl::ServerContextSharedPtr server_ctx(
+      manager_.createSslServerContext(store_, server_context_config, {}, nullptr));
+  EXPECT_EQ(2, server_ctx->getCertChainInformation().size());
+}
+
 // Certificates with no subject CN and no SANs are rejected.
 TEST_F(SslContextImplTest, MustHaveSubjectOrSAN) {
   envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext tls_context;
@@ -1160,6 +1182,30 @@ TEST_F(SslServerContextImplTicketTest, StatelessSessionResumptionEnabledWhenKeyI
   EXPECT_FALSE(server_context_config.disableStatelessSessionResumption());
 }
 
+TEST_F(SslServerContextImplTicketTest, MaxSessionCacheSize) {
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext tls_context;
+  const std::string tls_context_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_key.pem"
+  )EOF";
+  TestUtility::loadFromYaml(TestEnvironment::substitute(tls_context_yaml), tls_context);
+  {
+    ServerContextConfigImpl server_context_config(tls_context, factory_context_);
+    EXPECT_FALSE(server_context_config.maxSessionCacheSize().has_value());
+  }
+
+  for (const uint32_t max_size : {0, 1, 100}) {
+    tls_context.mutable_max_session_cache_size()->set_value(max_size);
+    ServerContextConfigImpl server_context_config(tls_context, factory_context_);
+    EXPECT_EQ(max_size, server_context_config.maxSessionCacheSize());
+    EXPECT_NO_THROW(loadConfig(server_context_config));
+  }
+}
+
 class ClientContextConfigImplTest : public SslCertsTest {};
 
 // Validate that empty SNI (according to C string rules) fails config validation.
@@ -1177,6 +1223,20 @@ TEST_F(ClientContextConfigImplTest, EmptyServerNameIndication) {
       "SNI names containing NULL-byte are not allowed");
 }
 
+// The size of the session cache is only set if it is configured, as on the server.
+TEST_F(ClientContextConfigImplTest, MaxSessionCacheSize) {
+  envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext tls_context;
+  NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context;
+  {
+    ClientContextConfigImpl client_context_config(tls_context, factory_context);
+    EXPECT_FALSE(client_context_config.maxSessionCacheSize().has_value());
+  }
+
+  tls_context.mutable_max_session_cache_size()->set_value(16);
+  ClientContextConfigImpl client_context_config(tls_context, factory_context);
+  EXPECT_EQ(16, client_context_config.maxSessionCacheSize());
+}
+
 // Validate that values other than a hex-encoded SHA-256 fail config validation.
 TEST_F(ClientContextConfigImplTest, InvalidCertificateHash) {
   envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext tls_context;
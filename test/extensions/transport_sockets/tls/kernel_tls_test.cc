@@ -0,0 +1,176 @@
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+
+#include "extensions/transport_sockets/tls/kernel_tls.h"
+
+#include "test/test_common/environment.h"
+
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+// Handshakes a TLS session between two ends of a loopback TCP connection, the server end of which
+// is then offloaded to the kernel.
+class KernelTlsTest : public testing::Test {
+protected:
+  void SetUp() override {
+    os_fd_t listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(listener, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_len = sizeof(addr);
+    ASSERT_EQ(0, ::bind(listener, reinterpret_cast<sockaddr*>(&addr), addr_len));
+    ASSERT_EQ(0, ::listen(listener, 1));
+    ASSERT_EQ(0, ::getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &addr_len));
+    client_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_EQ(0, ::connect(client_fd_, reinterpret_cast<sockaddr*>(&addr), addr_len));
+    const os_fd_t server_fd = ::accept(listener, nullptr, nullptr);
+    ASSERT_GE(server_fd, 0);
+    ::close(listener);
+    ::fcntl(client_fd_, F_SETFL, O_NONBLOCK);
+    ::fcntl(server_fd, F_SETFL, O_NONBLOCK);
+    server_handle_ = std::make_unique<Network::IoSocketHandleImpl>(server_fd);
+
+    server_ctx_.reset(SSL_CTX_new(TLS_method()));
+    ASSERT_EQ(1, SSL_CTX_use_certificate_chain_file(
+                     server_ctx_.get(),
+                     TestEnvironment::substitute("{{ test_rundir }}/test/extensions/"
+                                                 "transport_sockets/tls/test_data/unittest_cert.pem")
+                         .c_str()));
+    ASSERT_EQ(1, SSL_CTX_use_PrivateKey_file(
+                     server_ctx_.get(),
+                     TestEnvironment::substitute("{{ test_rundir }}/test/extensions/"
+                                                 "transport_sockets/tls/test_data/unittest_key.pem")
+                         .c_str(),
+                     SSL_FILETYPE_PEM));
+    client_ctx_.reset(SSL_CTX_new(TLS_method()));
+  }
+
+  void TearDown() override { ::close(client_fd_); }
+
+  void handshake(uint16_t max_version, const char* ciphers) {
+    ASSERT_EQ(1, SSL_CTX_set_max_proto_version(client_ctx_.get(), max_version));
+    ASSERT_EQ(1, SSL_CTX_set_strict_cipher_list(client_ctx_.get(), ciphers));
+    server_ssl_.reset(SSL_new(server_ctx_.get()));
+    client_ssl_.reset(SSL_new(client_ctx_.get()));
+    SSL_set_fd(server_ssl_.get(), server_handle_->fdDoNotUse());
+    SSL_set_fd(client_ssl_.get(), client_fd_);
+    SSL_set_accept_state(server_ssl_.get());
+    SSL_set_connect_state(client_ssl_.get());
+    int server_rc = 0;
+    int client_rc = 0;
+    while (server_rc != 1 || client_rc != 1) {
+      if (server_rc != 1) {
+        server_rc = SSL_do_handshake(server_ssl_.get());
+        ASSERT_TRUE(server_rc == 1 ||
+                    SSL_get_error(server_ssl_.get(), server_rc) == SSL_ERROR_WANT_READ);
+      }
+      if (client_rc != 1) {
+        client_rc = SSL_do_handshake(client_ssl_.get());
+        ASSERT_TRUE(client_rc == 1 ||
+                    SSL_get_error(client_ssl_.get(), client_rc) == SSL_ERROR_WANT_READ);
+      }
+    }
+  }
+
+  std::string clientRead() {
+    char buf[1024];
+    int rc;
+    do {
+      rc = SSL_read(client_ssl_.get(), buf, sizeof(buf));
+    } while (rc < 0 && SSL_get_error(client_ssl_.get(), rc) == SSL_ERROR_WANT_READ);
+    return rc > 0 ? std::string(buf, rc) : "";
+  }
+
+  KernelTls::ReadResult serverRead(Buffer::Instance& buffer) {
+    Buffer::RawSlice slice;
+    buffer.reserve(1024, &slice, 1);
+    KernelTls::ReadResult result;
+    do {
+      result = KernelTls::read(server_handle_->fdDoNotUse(), &slice, 1);
+    } while (result.result_.rc_ < 0 && result.result_.errno_ == SOCKET_ERROR_AGAIN);
+    if (result.result_.rc_ > 0) {
+      slice.len_ = result.result_.rc_;
+      buffer.commit(&slice, 1);
+    }
+    return result;
+  }
+
+  os_fd_t client_fd_;
+  Network::IoHandlePtr server_handle_;
+  bssl::UniquePtr<SSL_CTX> server_ctx_;
+  bssl::UniquePtr<SSL_CTX> client_ctx_;
+  bssl::UniquePtr<SSL> server_ssl_;
+  bssl::UniquePtr<SSL> client_ssl_;
+};
+
+TEST_F(KernelTlsTest, Tls12AesGcm) {
+  handshake(TLS1_2_VERSION, "ECDHE-RSA-AES128-GCM-SHA256");
+  const KernelTls::OffloadResult offload = KernelTls::enable(server_ssl_.get(), *server_handle_);
+  if (!offload.tx_) {
+    // The kernel of the test host does not support TLS offload.
+    return;
+  }
+
+  // Plaintext written to the socket reaches the peer encrypted.
+  Buffer::OwnedImpl data("hello");
+  ASSERT_TRUE(server_handle_->write(data).ok());
+  EXPECT_EQ("hello", clientRead());
+
+  if (offload.rx_) {
+    ASSERT_EQ(5, SSL_write(client_ssl_.get(), "world", 5));
+    Buffer::OwnedImpl received;
+    const KernelTls::ReadResult result = serverRead(received);
+    EXPECT_EQ(5, result.result_.rc_);
+    EXPECT_FALSE(result.close_notify_);
+    EXPECT_EQ("world", received.toString());
+  }
+
+  ASSERT_EQ(2, KernelTls::sendCloseNotify(server_handle_->fdDoNotUse()).rc_);
+  char buf[16];
+  int rc;
+  do {
+    rc = SSL_read(client_ssl_.get(), buf, sizeof(buf));
+  } while (rc < 0 && SSL_get_error(client_ssl_.get(), rc) == SSL_ERROR_WANT_READ);
+  EXPECT_EQ(SSL_ERROR_ZERO_RETURN, SSL_get_error(client_ssl_.get(), rc));
+
+  if (offload.rx_) {
+    SSL_shutdown(client_ssl_.get());
+    Buffer::OwnedImpl received;
+    const KernelTls::ReadResult result = serverRead(received);
+    EXPECT_EQ(0, result.result_.rc_);
+    EXPECT_TRUE(result.close_notify_);
+    EXPECT_FALSE(result.unexpected_record_);
+  }
+}
+
+TEST_F(KernelTlsTest, Tls13NotOffloaded) {
+  handshake(TLS1_3_VERSION, "ECDHE-RSA-AES128-GCM-SHA256");
+  ASSERT_EQ(TLS1_3_VERSION, SSL_version(server_ssl_.get()));
+  const KernelTls::OffloadResult offload = KernelTls::enable(server_ssl_.get(), *server_handle_);
+  EXPECT_FALSE(offload.tx_);
+  EXPECT_FALSE(offload.rx_);
+}
+
+TEST_F(KernelTlsTest, CipherNotSupported) {
+  handshake(TLS1_2_VERSION, "ECDHE-RSA-CHACHA20-POLY1305");
+  const KernelTls::OffloadResult offload = KernelTls::enable(server_ssl_.get(), *server_handle_);
+  EXPECT_FALSE(offload.tx_);
+  EXPECT_FALSE(offload.rx_);
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
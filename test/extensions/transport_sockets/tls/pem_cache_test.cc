@@ -0,0 +1,100 @@
+#include <string>
+
+#include "extensions/transport_sockets/tls/pem_cache.h"
+
+#include "test/test_common/environment.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+std::string readTestData(const std::string& name) {
+  return TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + name));
+}
+
+// The objects parsed from the same PEM data are shared while in use, and freed with their last
+// user.
+TEST(PemCacheTest, SharesParsedObjects) {
+  PemCache& cache = PemCache::get();
+  const size_t size = cache.size();
+  const std::string pem = readTestData("no_san_chain.pem");
+  {
+    const auto chain1 = cache.certificateChain(pem);
+    ASSERT_NE(nullptr, chain1);
+    EXPECT_EQ(1, chain1->intermediates_.size());
+    const auto chain2 = cache.certificateChain(std::string(pem));
+    EXPECT_EQ(chain1, chain2);
+
+    const auto list1 = cache.x509InfoList(readTestData("ca_cert.pem"));
+    ASSERT_NE(nullptr, list1);
+    EXPECT_EQ(list1, cache.x509InfoList(readTestData("ca_cert.pem")));
+    // The same data parsed as another kind of object is another entry.
+    EXPECT_NE(nullptr, cache.x509InfoList(pem));
+    EXPECT_EQ(size + 2, cache.size());
+  }
+  EXPECT_EQ(size, cache.size());
+}
+
+// A private key is shared by the users of the same key data and password only.
+TEST(PemCacheTest, PrivateKeyPassword) {
+  PemCache& cache = PemCache::get();
+  const std::string pem = readTestData("password_protected_key.pem");
+  const std::string password = readTestData("password_protected_password.txt");
+  const auto key = cache.privateKey(pem, password);
+  ASSERT_NE(nullptr, key);
+  EXPECT_EQ(key, cache.privateKey(pem, password));
+  EXPECT_EQ(nullptr, cache.privateKey(pem, "wrong"));
+  EXPECT_EQ(nullptr, cache.privateKey(pem, ""));
+}
+
+int testVerifyCallback(int ok, X509_STORE_CTX*) { return ok; }
+
+// The certificate store of the same trusted CAs, CRLs and verification callback is shared.
+TEST(PemCacheTest, SharesCertStores) {
+  PemCache& cache = PemCache::get();
+  const size_t size = cache.size();
+  {
+    const auto ca = cache.x509InfoList(readTestData("ca_cert.pem"));
+    const auto crl = cache.x509InfoList(readTestData("ca_cert.crl"));
+    ASSERT_NE(nullptr, ca);
+    ASSERT_NE(nullptr, crl);
+
+    const auto store = cache.certStore(ca, nullptr, nullptr);
+    ASSERT_NE(nullptr, store);
+    EXPECT_EQ(store, cache.certStore(cache.x509InfoList(readTestData("ca_cert.pem")), nullptr,
+                                     nullptr));
+    EXPECT_EQ(0, X509_VERIFY_PARAM_get_flags(X509_STORE_get0_param(store->store_.get())) &
+                     X509_V_FLAG_CRL_CHECK);
+
+    const auto store_with_crl = cache.certStore(ca, crl, nullptr);
+    EXPECT_NE(store, store_with_crl);
+    EXPECT_NE(0, X509_VERIFY_PARAM_get_flags(X509_STORE_get0_param(store_with_crl->store_.get())) &
+                     X509_V_FLAG_CRL_CHECK);
+    EXPECT_NE(store, cache.certStore(ca, nullptr, testVerifyCallback));
+    EXPECT_EQ(size + 4, cache.size());
+  }
+  EXPECT_EQ(size, cache.size());
+}
+
+// Data that does not parse is not cached.
+TEST(PemCacheTest, InvalidData) {
+  PemCache& cache = PemCache::get();
+  const size_t size = cache.size();
+  EXPECT_EQ(nullptr, cache.certificateChain("not a certificate"));
+  EXPECT_EQ(nullptr, cache.certificateChain(readTestData("no_san_chain.pem") +
+                                            "-----BEGIN CERTIFICATE-----\nbad\n"
+                                            "-----END CERTIFICATE-----\n"));
+  EXPECT_EQ(nullptr, cache.privateKey("not a key", ""));
+  EXPECT_EQ(size, cache.size());
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
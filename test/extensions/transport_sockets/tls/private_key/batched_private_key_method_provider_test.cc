@@ -0,0 +1,188 @@
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "envoy/ssl/private_key/private_key_callbacks.h"
+
+#include "extensions/transport_sockets/tls/private_key/batched_private_key_method_provider.h"
+
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+using testing::NiceMock;
+
+class MockPrivateKeyConnectionCallbacks : public Ssl::PrivateKeyConnectionCallbacks {
+public:
+  MOCK_METHOD(void, onPrivateKeyMethodComplete, ());
+};
+
+// Keeps the batches it is handed, to complete them on demand.
+class TestBatchProcessor : public PrivateKeyBatchProcessor {
+public:
+  // PrivateKeyBatchProcessor
+  void processBatch(const std::vector<PrivateKeyOperationSharedPtr>& batch,
+                    std::function<void()> done) override {
+    batches_.push_back(batch);
+    done_.push_back(std::move(done));
+  }
+
+  std::vector<std::vector<PrivateKeyOperationSharedPtr>> batches_;
+  std::vector<std::function<void()>> done_;
+};
+
+class BatchedPrivateKeyMethodProviderTest : public testing::Test, public TestUsingSimulatedTime {
+public:
+  BatchedPrivateKeyMethodProviderTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")),
+        processor_(std::make_shared<TestBatchProcessor>()) {}
+
+  void createProvider(uint32_t max_batch_size, std::chrono::microseconds max_batch_delay) {
+    provider_ = std::make_unique<BatchedPrivateKeyMethodProvider>(processor_, tls_, max_batch_size,
+                                                                  max_batch_delay);
+    method_ = provider_->getBoringSslPrivateKeyMethod();
+  }
+
+  SSL* addConnection() {
+    ssls_.emplace_back(SSL_new(ssl_ctx_.get()));
+    callbacks_.push_back(std::make_unique<MockPrivateKeyConnectionCallbacks>());
+    provider_->registerPrivateKeyMethod(ssls_.back().get(), *callbacks_.back(), *dispatcher_);
+    return ssls_.back().get();
+  }
+
+  ssl_private_key_result_t sign(SSL* ssl) {
+    const uint8_t in[] = {1, 2, 3};
+    size_t out_len;
+    return method_->sign(ssl, nullptr, &out_len, 0, SSL_SIGN_RSA_PSS_RSAE_SHA256, in, sizeof(in));
+  }
+
+  ssl_private_key_result_t complete(SSL* ssl, std::vector<uint8_t>& out) {
+    out.resize(16);
+    size_t out_len = 0;
+    const ssl_private_key_result_t result =
+        method_->complete(ssl, out.data(), &out_len, out.size());
+    out.resize(out_len);
+    return result;
+  }
+
+  void run() { dispatcher_->run(Event::Dispatcher::RunType::NonBlock); }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  std::shared_ptr<TestBatchProcessor> processor_;
+  std::unique_ptr<BatchedPrivateKeyMethodProvider> provider_;
+  Ssl::BoringSslPrivateKeyMethodSharedPtr method_;
+  bssl::UniquePtr<SSL_CTX> ssl_ctx_{SSL_CTX_new(TLS_method())};
+  std::vector<bssl::UniquePtr<SSL>> ssls_;
+  std::vector<std::unique_ptr<MockPrivateKeyConnectionCallbacks>> callbacks_;
+};
+
+// A batch is processed once it holds max_batch_size operations, and the handshakes resume on the
+// worker once it completes.
+TEST_F(BatchedPrivateKeyMethodProviderTest, ProcessFullBatch) {
+  createProvider(3, std::chrono::seconds(1));
+  std::vector<SSL*> ssls;
+  for (int i = 0; i < 3; ++i) {
+    ssls.push_back(addConnection());
+    EXPECT_EQ(0, processor_->batches_.size());
+    EXPECT_EQ(ssl_private_key_retry, sign(ssls.back()));
+  }
+  ASSERT_EQ(1, processor_->batches_.size());
+  ASSERT_EQ(3, processor_->batches_[0].size());
+  EXPECT_EQ(PrivateKeyOperation::Type::Sign, processor_->batches_[0][0]->type_);
+  EXPECT_EQ(SSL_SIGN_RSA_PSS_RSAE_SHA256, processor_->batches_[0][0]->signature_algorithm_);
+  EXPECT_EQ((std::vector<uint8_t>{1, 2, 3}), processor_->batches_[0][0]->input_);
+
+  std::vector<uint8_t> out;
+  EXPECT_EQ(ssl_private_key_retry, complete(ssls[0], out));
+
+  for (uint8_t i = 0; i < 3; ++i) {
+    processor_->batches_[0][i]->succeeded_ = true;
+    processor_->batches_[0][i]->output_ = {i};
+  }
+  processor_->done_[0]();
+  for (auto& callbacks : callbacks_) {
+    EXPECT_CALL(*callbacks, onPrivateKeyMethodComplete());
+  }
+  run();
+
+  for (uint8_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(ssl_private_key_success, complete(ssls[i], out));
+    EXPECT_EQ(std::vector<uint8_t>{i}, out);
+  }
+  for (SSL* ssl : ssls) {
+    provider_->unregisterPrivateKeyMethod(ssl);
+  }
+}
+
+// A batch that is not full is processed max_batch_delay after its first operation started.
+TEST_F(BatchedPrivateKeyMethodProviderTest, ProcessAfterDelay) {
+  createProvider(10, std::chrono::microseconds(100));
+  SSL* ssl = addConnection();
+  const uint8_t in[] = {4, 5};
+  size_t out_len;
+  EXPECT_EQ(ssl_private_key_retry, method_->decrypt(ssl, nullptr, &out_len, 0, in, sizeof(in)));
+  // A connection has one operation in flight at most.
+  EXPECT_EQ(ssl_private_key_failure, sign(ssl));
+  run();
+  EXPECT_EQ(0, processor_->batches_.size());
+
+  simTime().advanceTimeAndRun(std::chrono::microseconds(100), *dispatcher_,
+                              Event::Dispatcher::RunType::NonBlock);
+  ASSERT_EQ(1, processor_->batches_.size());
+  ASSERT_EQ(1, processor_->batches_[0].size());
+  EXPECT_EQ(PrivateKeyOperation::Type::Decrypt, processor_->batches_[0][0]->type_);
+
+  // The operation failed.
+  EXPECT_CALL(*callbacks_[0], onPrivateKeyMethodComplete());
+  processor_->done_[0]();
+  run();
+  std::vector<uint8_t> out;
+  EXPECT_EQ(ssl_private_key_failure, complete(ssl, out));
+  provider_->unregisterPrivateKeyMethod(ssl);
+}
+
+// The operations of the connections that have gone away are not processed, and do not resume them.
+TEST_F(BatchedPrivateKeyMethodProviderTest, UnregisteredConnections) {
+  createProvider(2, std::chrono::seconds(1));
+  SSL* ssl1 = addConnection();
+  SSL* ssl2 = addConnection();
+  SSL* ssl3 = addConnection();
+  EXPECT_EQ(ssl_private_key_retry, sign(ssl1));
+  provider_->unregisterPrivateKeyMethod(ssl1);
+  EXPECT_EQ(ssl_private_key_failure, sign(ssl1));
+  EXPECT_EQ(ssl_private_key_retry, sign(ssl2));
+  EXPECT_EQ(ssl_private_key_retry, sign(ssl3));
+  ASSERT_EQ(1, processor_->batches_.size());
+  EXPECT_EQ(1, processor_->batches_[0].size());
+
+  simTime().advanceTimeAndRun(std::chrono::seconds(1), *dispatcher_,
+                              Event::Dispatcher::RunType::NonBlock);
+  ASSERT_EQ(2, processor_->batches_.size());
+  EXPECT_EQ(1, processor_->batches_[1].size());
+
+  provider_->unregisterPrivateKeyMethod(ssl2);
+  EXPECT_CALL(*callbacks_[1], onPrivateKeyMethodComplete()).Times(0);
+  EXPECT_CALL(*callbacks_[2], onPrivateKeyMethodComplete());
+  processor_->done_[0]();
+  processor_->done_[1]();
+  run();
+  provider_->unregisterPrivateKeyMethod(ssl3);
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
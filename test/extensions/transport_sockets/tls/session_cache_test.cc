@@ -0,0 +1,136 @@
+#include <string>
+
+#include "extensions/transport_sockets/tls/session_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+class ServerSessionCacheTest : public testing::Test {
+protected:
+  bssl::UniquePtr<SSL_SESSION> session(const std::string& id) {
+    bssl::UniquePtr<SSL_SESSION> session(SSL_SESSION_new(ctx_.get()));
+    EXPECT_EQ(1, SSL_SESSION_set1_id(session.get(), reinterpret_cast<const uint8_t*>(id.data()),
+                                     id.size()));
+    return session;
+  }
+
+  bssl::UniquePtr<SSL_CTX> ctx_{SSL_CTX_new(TLS_method())};
+};
+
+// Sessions are found by their ID, and the cache keeps a reference to them.
+TEST_F(ServerSessionCacheTest, InsertAndLookup) {
+  ServerSessionCache cache(100);
+  auto session1 = session("id1");
+  SSL_SESSION* session1_ptr = session1.get();
+  cache.insert(std::move(session1));
+  cache.insert(session("id2"));
+  EXPECT_EQ(2, cache.size());
+
+  auto found = cache.lookup("id1");
+  EXPECT_EQ(session1_ptr, found.get());
+  found.reset();
+  EXPECT_EQ(session1_ptr, cache.lookup("id1").get());
+  EXPECT_EQ(nullptr, cache.lookup("id3"));
+
+  // A session with the same ID replaces the cached one.
+  auto session1_new = session("id1");
+  SSL_SESSION* session1_new_ptr = session1_new.get();
+  cache.insert(std::move(session1_new));
+  EXPECT_EQ(2, cache.size());
+  EXPECT_EQ(session1_new_ptr, cache.lookup("id1").get());
+}
+
+// The cache never holds more than its maximum size, evicting the oldest sessions of a shard first.
+TEST_F(ServerSessionCacheTest, Eviction) {
+  ServerSessionCache cache(2 * ServerSessionCache::MaxShards);
+  for (int i = 0; i < 1000; ++i) {
+    cache.insert(session(std::to_string(i)));
+    EXPECT_LE(cache.size(), 2 * ServerSessionCache::MaxShards);
+  }
+  EXPECT_EQ(2 * ServerSessionCache::MaxShards, cache.size());
+  EXPECT_NE(nullptr, cache.lookup("999"));
+  EXPECT_EQ(nullptr, cache.lookup("0"));
+}
+
+// A cache smaller than the number of shards still holds as many sessions as its size.
+TEST_F(ServerSessionCacheTest, SmallerThanShards) {
+  ServerSessionCache cache(1);
+  cache.insert(session("id1"));
+  EXPECT_NE(nullptr, cache.lookup("id1"));
+  cache.insert(session("id2"));
+  EXPECT_EQ(1, cache.size());
+  EXPECT_EQ(nullptr, cache.lookup("id1"));
+  EXPECT_NE(nullptr, cache.lookup("id2"));
+}
+
+class ClientSessionCacheTest : public testing::Test {
+protected:
+  bssl::UniquePtr<SSL_SESSION> session(uint16_t version = TLS1_2_VERSION) {
+    bssl::UniquePtr<SSL_SESSION> session(SSL_SESSION_new(ctx_.get()));
+    EXPECT_EQ(1, SSL_SESSION_set_protocol_version(session.get(), version));
+    return session;
+  }
+
+  bssl::UniquePtr<SSL_CTX> ctx_{SSL_CTX_new(TLS_method())};
+};
+
+// The most recent session of a server is resumed, and the sessions of the other servers are not.
+TEST_F(ClientSessionCacheTest, InsertAndLookup) {
+  ClientSessionCache cache(100, 2);
+  auto session1 = session();
+  SSL_SESSION* session1_ptr = session1.get();
+  auto session2 = session();
+  SSL_SESSION* session2_ptr = session2.get();
+  cache.insert("a|10.0.0.1:443", std::move(session1));
+  EXPECT_EQ(session1_ptr, cache.lookup("a|10.0.0.1:443").get());
+  cache.insert("a|10.0.0.1:443", std::move(session2));
+  EXPECT_EQ(1, cache.size());
+  EXPECT_EQ(session2_ptr, cache.lookup("a|10.0.0.1:443").get());
+  EXPECT_EQ(session2_ptr, cache.lookup("a|10.0.0.1:443").get());
+  EXPECT_EQ(nullptr, cache.lookup("a|10.0.0.2:443"));
+  EXPECT_EQ(nullptr, cache.lookup("b|10.0.0.1:443"));
+
+  // A server keeps its two most recent sessions.
+  cache.insert("a|10.0.0.1:443", session());
+  cache.insert("a|10.0.0.1:443", session());
+  EXPECT_NE(session2_ptr, cache.lookup("a|10.0.0.1:443").get());
+}
+
+// A single use session is only resumed once, after which the previous sessions are resumed.
+TEST_F(ClientSessionCacheTest, SingleUse) {
+  ClientSessionCache cache(100, 2);
+  auto session1 = session(TLS1_3_VERSION);
+  SSL_SESSION* session1_ptr = session1.get();
+  auto session2 = session(TLS1_3_VERSION);
+  SSL_SESSION* session2_ptr = session2.get();
+  cache.insert("a|10.0.0.1:443", std::move(session1));
+  cache.insert("a|10.0.0.1:443", std::move(session2));
+  EXPECT_EQ(session2_ptr, cache.lookup("a|10.0.0.1:443").get());
+  EXPECT_EQ(session1_ptr, cache.lookup("a|10.0.0.1:443").get());
+  EXPECT_EQ(nullptr, cache.lookup("a|10.0.0.1:443"));
+  EXPECT_EQ(1, cache.size());
+}
+
+// The cache never holds more servers than its maximum size, evicting the servers that were added
+// to a shard first.
+TEST_F(ClientSessionCacheTest, Eviction) {
+  ClientSessionCache cache(2 * ClientSessionCache::MaxShards, 1);
+  for (int i = 0; i < 1000; ++i) {
+    cache.insert(std::to_string(i), session());
+    EXPECT_LE(cache.size(), 2 * ClientSessionCache::MaxShards);
+  }
+  EXPECT_EQ(2 * ClientSessionCache::MaxShards, cache.size());
+  EXPECT_NE(nullptr, cache.lookup("999"));
+  EXPECT_EQ(nullptr, cache.lookup("0"));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -2,11 +2,20 @@
 #include <memory>
 #include <string>
 
+#if defined(__linux__)
+#include <netinet/tcp.h>
+
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#endif
+
 #include "envoy/config/listener/v3/listener.pb.h"
 #include "envoy/config/listener/v3/listener_components.pb.h"
 #include "envoy/extensions/transport_sockets/tls/v3/cert.pb.h"
 #include "envoy/network/transport_socket.h"
 
+#include "common/api/os_sys_calls_impl.h"
 #include "common/buffer/buffer_impl.h"
 #include "common/common/empty_string.h"
 #include "common/event/dispatcher_impl.h"
@@ -31,7 +40,9 @@
 #include "test/extensions/transport_sockets/tls/test_data/san_dns3_cert_info.h"
 #include "test/extensions/transport_sockets/tls/test_data/san_dns4_cert_info.h"
 #include "test/extensions/transport_sockets/tls/test_data/san_dns_cert_info.h"
+#include "test/extensions/transport_sockets/tls/test_data/san_multiple_dns_cert_info.h"
 #include "test/extensions/transport_sockets/tls/test_data/san_uri_cert_info.h"
+#include "test/extensions/transport_sockets/tls/test_data/selfsigned_cert_info.h"
 #include "test/extensions/transport_sockets/tls/test_data/selfsigned_ecdsa_p256_cert_info.h"
 #include "test/extensions/transport_sockets/tls/test_private_key_method_provider.h"
 #include "test/mocks/buffer/mocks.h"
@@ -47,6 +58,7 @@
 #include "test/test_common/network_utility.h"
 #include "test/test_common/registry.h"
 #include "test/test_common/test_runtime.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
 #include "absl/strings/str_replace.h"
@@ -1154,6 +1166,42 @@ TEST_P(SslSocketTest, MultiCertPreferEcdsa) {
   testUtil(test_options);
 }
 
+// The certificate whose DNS SANs match the SNI is selected among certificates of the same type,
+// exact names before wildcards, falling back on the first certificate.
+TEST_P(SslSocketTest, MultiCertSelectBySni) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+    - certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_key.pem"
+    - certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_multiple_dns_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_multiple_dns_key.pem"
+)EOF";
+
+  const std::vector<std::pair<std::string, std::string>> cases{
+      {"server2.example.com", TEST_SAN_MULTIPLE_DNS_CERT_256_HASH},
+      {"Server1.Example.com", TEST_SELFSIGNED_CERT_256_HASH},
+      {"other.example.com", TEST_SAN_MULTIPLE_DNS_CERT_256_HASH},
+      {"example.org", TEST_SELFSIGNED_CERT_256_HASH},
+  };
+  for (const auto& [sni, cert_hash] : cases) {
+    const std::string client_ctx_yaml = absl::StrCat(R"EOF(
+    sni: )EOF",
+                                                     sni, R"EOF(
+    common_tls_context:
+      validation_context:
+        verify_certificate_hash: )EOF",
+                                                     cert_hash);
+
+    TestUtilOptions test_options(client_ctx_yaml, server_ctx_yaml, true, GetParam());
+    testUtil(test_options);
+  }
+}
+
 TEST_P(SslSocketTest, GetUriWithLocalUriSan) {
   const std::string client_ctx_yaml = R"EOF(
   common_tls_context:
@@ -3802,6 +3850,33 @@ TEST_P(SslSocketTest, ClientSessionResumptionEnabledTls13) {
   testClientSessionResumption(server_ctx_yaml, client_ctx_yaml, true, GetParam());
 }
 
+// Sessions are still resumed with early data enabled, when the server does not accept early data.
+TEST_P(SslSocketTest, ClientSessionResumptionEarlyDataNotAccepted) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_3
+      tls_maximum_protocol_version: TLSv1_3
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_key.pem"
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_3
+      tls_maximum_protocol_version: TLSv1_3
+  max_session_keys: 2
+  max_session_cache_size: 1
+  enable_early_data: true
+)EOF";
+
+  testClientSessionResumption(server_ctx_yaml, client_ctx_yaml, true, GetParam());
+}
+
 TEST_P(SslSocketTest, SslError) {
   const std::string server_ctx_yaml = R"EOF(
   common_tls_context:
@@ -4970,7 +5045,7 @@ protected:
   std::shared_ptr<Network::TcpListenSocket> socket_;
   Network::MockTcpListenerCallbacks listener_callbacks_;
   Network::MockConnectionHandler connection_handler_;
-  const std::string server_ctx_yaml_ = R"EOF(
+  std::string server_ctx_yaml_ = R"EOF(
   common_tls_context:
     tls_certificates:
       certificate_chain:
@@ -5029,6 +5104,49 @@ TEST_P(SslReadBufferLimitTest, WritesSmallerThanBufferLimit) { singleWriteTest(5
 
 TEST_P(SslReadBufferLimitTest, WritesLargerThanBufferLimit) { singleWriteTest(1024, 5 * 1024); }
 
+// The first records the server writes are small and each one grows by the initial record size,
+// and they start small again once the connection has been idle.
+TEST_P(SslReadBufferLimitTest, DynamicRecordSizing) {
+  server_ctx_yaml_ += R"EOF(
+  dynamic_record_sizing:
+    initial_record_size: 1300
+    idle_timeout: 1s
+)EOF";
+  initialize();
+
+  EXPECT_CALL(listener_callbacks_, onAccept_(_))
+      .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket) -> void {
+        server_connection_ = dispatcher_->createServerConnection(
+            std::move(socket), server_ssl_socket_factory_->createTransportSocket(nullptr),
+            stream_info_);
+        server_connection_->addConnectionCallbacks(server_callbacks_);
+      }));
+  EXPECT_CALL(client_callbacks_, onEvent(Network::ConnectionEvent::Connected))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void { dispatcher_->exit(); }));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  // 64KiB take ten records of 1300, 2600, ..., 13000 bytes, the last one partly filled.
+  Buffer::OwnedImpl data(std::string(64 * 1024, 'a'));
+  server_connection_->write(data, false);
+  while (server_stats_store_.counter("ssl.small_records").value() < 10) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  EXPECT_EQ(0UL, server_stats_store_.counter("ssl.record_size_resets").value());
+
+  // After an idle second, 2600 bytes take two records of 1300 bytes.
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  Buffer::OwnedImpl more_data(std::string(2600, 'a'));
+  server_connection_->write(more_data, false);
+  EXPECT_CALL(client_callbacks_, onEvent(Network::ConnectionEvent::RemoteClose))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void { dispatcher_->exit(); }));
+  server_connection_->close(Network::ConnectionCloseType::FlushWrite);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  EXPECT_EQ(12UL, server_stats_store_.counter("ssl.small_records").value());
+  EXPECT_EQ(1UL, server_stats_store_.counter("ssl.record_size_resets").value());
+  EXPECT_EQ(0UL, server_stats_store_.counter("ssl.connection_error").value());
+}
+
 TEST_P(SslReadBufferLimitTest, TestBind) {
   std::string address_string = TestUtility::getIpv4Loopback();
   if (GetParam() == Network::Address::IpVersion::v4) {
@@ -5972,6 +6090,214 @@ TEST_P(SslSocketTest, TestConnectionFailsOnMultipleCertificatesNonePassOcspPolic
   testUtil(test_options.setExpectedServerStats("ssl.ocsp_staple_failed").enableOcspStapling());
 }
 
+#if defined(__linux__)
+// Intercepts the attach of the tls upper layer protocol, which is how sockets are offloaded to the
+// kernel.
+class KernelTlsOsSysCallsImpl : public Api::OsSysCallsImpl {
+public:
+  MOCK_METHOD(Api::SysCallIntResult, setsockopt,
+              (os_fd_t sockfd, int level, int optname, const void* optval, socklen_t optlen),
+              (override));
+};
+
+class SslSocketKernelTlsTest : public SslSocketTest {
+protected:
+  // Whether the tls upper layer protocol can be attached to TCP sockets of the test host.
+  static bool kernelTlsSupported() {
+    os_fd_t listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_len = sizeof(addr);
+    ::bind(listener, reinterpret_cast<sockaddr*>(&addr), addr_len);
+    ::listen(listener, 1);
+    ::getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &addr_len);
+    os_fd_t client = ::socket(AF_INET, SOCK_STREAM, 0);
+    bool supported = false;
+    if (::connect(client, reinterpret_cast<sockaddr*>(&addr), addr_len) == 0) {
+      static constexpr char UlpName[] = "tls";
+      supported = ::setsockopt(client, IPPROTO_TCP, TCP_ULP, UlpName, sizeof(UlpName)) == 0;
+    }
+    ::close(client);
+    ::close(listener);
+    return supported;
+  }
+
+  // Whether the records of the socket are handled by the kernel.
+  static bool kernelTlsEnabled(os_fd_t fd) {
+    char name[16]{};
+    socklen_t name_len = sizeof(name);
+    return ::getsockopt(fd, IPPROTO_TCP, TCP_ULP, name, &name_len) == 0 &&
+           absl::string_view(name) == "tls";
+  }
+
+  /**
+   * Exchanges data in both directions with kernel TLS offload enabled, then closes the connection
+   * with close_notify alerts.
+   * @return whether the records of the server connection were handled by the kernel.
+   */
+  bool testKernelTlsOffload(const std::string& client_ctx_yaml) {
+    const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_key.pem"
+)EOF";
+
+    TestScopedRuntime scoped_runtime;
+    Runtime::LoaderSingleton::getExisting()->mergeValues(
+        {{"envoy.reloadable_features.tls_kernel_offload", "true"}});
+
+    envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext server_tls_context;
+    TestUtility::loadFromYaml(TestEnvironment::substitute(server_ctx_yaml), server_tls_context);
+    auto server_cfg =
+        std::make_unique<ServerContextConfigImpl>(server_tls_context, factory_context_);
+    ContextManagerImpl manager(time_system_);
+    Stats::TestUtil::TestStore server_stats_store;
+    ServerSslSocketFactory server_ssl_socket_factory(
+        std::move(server_cfg), manager, server_stats_store, std::vector<std::string>{});
+
+    auto socket = std::make_shared<Network::TcpListenSocket>(
+        Network::Test::getCanonicalLoopbackAddress(GetParam()), nullptr, true);
+    Network::MockTcpListenerCallbacks listener_callbacks;
+    Network::ListenerPtr listener =
+        dispatcher_->createListener(socket, listener_callbacks, true, ENVOY_TCP_BACKLOG_SIZE);
+    std::shared_ptr<Network::MockReadFilter> server_read_filter(new Network::MockReadFilter());
+    std::shared_ptr<Network::MockReadFilter> client_read_filter(new Network::MockReadFilter());
+
+    envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext tls_context;
+    TestUtility::loadFromYaml(TestEnvironment::substitute(client_ctx_yaml), tls_context);
+    auto client_cfg = std::make_unique<ClientContextConfigImpl>(tls_context, factory_context_);
+    Stats::TestUtil::TestStore client_stats_store;
+    ClientSslSocketFactory client_ssl_socket_factory(std::move(client_cfg), manager,
+                                                     client_stats_store);
+    Network::ClientConnectionPtr client_connection = dispatcher_->createClientConnection(
+        socket->localAddress(), Network::Address::InstanceConstSharedPtr(),
+        client_ssl_socket_factory.createTransportSocket(nullptr), nullptr);
+    Network::MockConnectionCallbacks client_connection_callbacks;
+    client_connection->enableHalfClose(true);
+    client_connection->addReadFilter(client_read_filter);
+    client_connection->addConnectionCallbacks(client_connection_callbacks);
+    client_connection->connect();
+
+    Network::ConnectionPtr server_connection;
+    Network::MockConnectionCallbacks server_connection_callbacks;
+    os_fd_t server_fd = INVALID_SOCKET;
+    bool offloaded = false;
+    EXPECT_CALL(listener_callbacks, onAccept_(_))
+        .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket) -> void {
+          server_fd = socket->ioHandle().fdDoNotUse();
+          server_connection = dispatcher_->createServerConnection(
+              std::move(socket), server_ssl_socket_factory.createTransportSocket(nullptr),
+              stream_info_);
+          server_connection->enableHalfClose(true);
+          server_connection->addReadFilter(server_read_filter);
+          server_connection->addConnectionCallbacks(server_connection_callbacks);
+        }));
+    EXPECT_CALL(*server_read_filter, onNewConnection())
+        .WillOnce(Return(Network::FilterStatus::Continue));
+    EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::Connected))
+        .WillOnce(Invoke([&](Network::ConnectionEvent) -> void {
+          // The session is offloaded before the connection is reported as connected.
+          offloaded = kernelTlsEnabled(server_fd);
+        }));
+
+    EXPECT_CALL(*client_read_filter, onNewConnection())
+        .WillOnce(Return(Network::FilterStatus::Continue));
+    EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::Connected))
+        .WillOnce(Invoke([&](Network::ConnectionEvent) -> void {
+          Buffer::OwnedImpl data("hello");
+          client_connection->write(data, false);
+        }));
+    EXPECT_CALL(*server_read_filter, onData(BufferStringEqual("hello"), false))
+        .WillOnce(Invoke([&](Buffer::Instance& read_buffer, bool) -> Network::FilterStatus {
+          read_buffer.drain(read_buffer.length());
+          Buffer::OwnedImpl data("world");
+          server_connection->write(data, true);
+          return Network::FilterStatus::StopIteration;
+        }));
+    // The end of the stream is the close_notify alert of the server.
+    EXPECT_CALL(*client_read_filter, onData(BufferStringEqual("world"), true))
+        .WillOnce(Invoke([&](Buffer::Instance& read_buffer, bool) -> Network::FilterStatus {
+          read_buffer.drain(read_buffer.length());
+          client_connection->close(Network::ConnectionCloseType::NoFlush);
+          return Network::FilterStatus::StopIteration;
+        }));
+    EXPECT_CALL(*server_read_filter, onData(_, true));
+
+    EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::LocalClose));
+    EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::RemoteClose))
+        .WillOnce(Invoke([&](Network::ConnectionEvent) -> void {
+          server_connection->close(Network::ConnectionCloseType::NoFlush);
+          dispatcher_->exit();
+        }));
+
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+    EXPECT_EQ(0UL, server_stats_store.counter("ssl.connection_error").value());
+    EXPECT_EQ(0UL, client_stats_store.counter("ssl.connection_error").value());
+    return offloaded;
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(IpVersions, SslSocketKernelTlsTest,
+                         testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
+                         TestUtility::ipTestParamsToString);
+
+// TLS 1.2 sessions using AES-GCM are offloaded where the kernel supports it.
+TEST_P(SslSocketKernelTlsTest, Offloaded) {
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+      cipher_suites:
+      - ECDHE-RSA-AES128-GCM-SHA256
+)EOF";
+
+  EXPECT_EQ(kernelTlsSupported(), testKernelTlsOffload(client_ctx_yaml));
+}
+
+// Sessions using a cipher the kernel cannot handle stay with BoringSSL.
+TEST_P(SslSocketKernelTlsTest, CipherNotSupported) {
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+      cipher_suites:
+      - ECDHE-RSA-CHACHA20-POLY1305
+)EOF";
+
+  EXPECT_FALSE(testKernelTlsOffload(client_ctx_yaml));
+}
+
+// Sessions stay with BoringSSL if the tls upper layer protocol cannot be attached to the socket.
+TEST_P(SslSocketKernelTlsTest, UlpNotAvailable) {
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+      cipher_suites:
+      - ECDHE-RSA-AES128-GCM-SHA256
+)EOF";
+
+  NiceMock<KernelTlsOsSysCallsImpl> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  ON_CALL(os_sys_calls, setsockopt(_, _, _, _, _))
+      .WillByDefault(Invoke([&](os_fd_t sockfd, int level, int optname, const void* optval,
+                                socklen_t optlen) -> Api::SysCallIntResult {
+        return os_sys_calls.Api::OsSysCallsImpl::setsockopt(sockfd, level, optname, optval,
+                                                            optlen);
+      }));
+  // Both the client and the server try to offload the session.
+  EXPECT_CALL(os_sys_calls, setsockopt(_, IPPROTO_TCP, TCP_ULP, _, _))
+      .Times(2)
+      .WillRepeatedly(Return(Api::SysCallIntResult{-1, ENOENT}));
+
+  EXPECT_FALSE(testKernelTlsOffload(client_ctx_yaml));
+}
+#endif
+
 } // namespace Tls
 } // namespace TransportSockets
 } // namespace Extensions
@@ -0,0 +1,320 @@
+// Benchmarks of the TLS handshakes, request/response round trips and memory of SslSocket, which
+// give a baseline to evaluate the TLS features against. The client and the server SslSocket are
+// connected over a socket pair and driven directly, without dispatcher or connection.
+
+#include "envoy/extensions/transport_sockets/tls/v3/cert.pb.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/memory/stats.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/transport_sockets/tls/context_config_impl.h"
+#include "extensions/transport_sockets/tls/context_manager_impl.h"
+#include "extensions/transport_sockets/tls/ssl_socket.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/local_info/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/server/transport_socket_factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/test_time.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "tools/cpp/runfiles/runfiles.h"
+
+using testing::Invoke;
+using testing::NiceMock;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions::TransportSockets::Tls {
+
+enum class KeyType { Rsa, Ecdsa };
+
+struct ContextOptions {
+  KeyType key_type_{KeyType::Rsa};
+  // TLSv1_2 or TLSv1_3.
+  std::string tls_version_{"TLSv1_3"};
+  bool resumption_{};
+  bool client_cert_{};
+};
+
+static std::string testDataPath(absl::string_view file) {
+  return absl::StrCat("{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/", file);
+}
+
+static std::string serverContextYaml(const ContextOptions& options) {
+  const std::string name = options.key_type_ == KeyType::Rsa ? "san_dns" : "selfsigned_ecdsa_p256";
+  std::string yaml = fmt::format(R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: {0}
+      tls_maximum_protocol_version: {0}
+    tls_certificates:
+      certificate_chain:
+        filename: "{1}"
+      private_key:
+        filename: "{2}"
+)EOF",
+                                 options.tls_version_, testDataPath(name + "_cert.pem"),
+                                 testDataPath(name + "_key.pem"));
+  if (options.client_cert_) {
+    absl::StrAppend(&yaml, fmt::format(R"EOF(
+    validation_context:
+      trusted_ca:
+        filename: "{}"
+  require_client_certificate: true
+)EOF",
+                                       testDataPath("ca_cert.pem")));
+  }
+  return yaml;
+}
+
+static std::string clientContextYaml(const ContextOptions& options) {
+  // Clients only resume the sessions they cache.
+  std::string yaml = fmt::format(R"EOF(
+  max_session_keys: {0}
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: {1}
+      tls_maximum_protocol_version: {1}
+)EOF",
+                                 options.resumption_ ? 1 : 0, options.tls_version_);
+  if (options.client_cert_) {
+    absl::StrAppend(&yaml, fmt::format(R"EOF(
+    tls_certificates:
+      certificate_chain:
+        filename: "{}"
+      private_key:
+        filename: "{}"
+)EOF",
+                                       testDataPath("san_uri_cert.pem"),
+                                       testDataPath("san_uri_key.pem")));
+  }
+  return yaml;
+}
+
+// The client and server transport socket factories that the connections of a benchmark share, as
+// the contexts of a cluster and a listener are shared by their connections.
+class SslSocketFactories {
+public:
+  SslSocketFactories(const ContextOptions& options) {
+    std::string error;
+    runfiles_.reset(
+        bazel::tools::cpp::runfiles::Runfiles::Create("tls_handshake_benchmark", &error));
+    TestEnvironment::setRunfiles(runfiles_.get());
+
+    ON_CALL(factory_context_, api()).WillByDefault(ReturnRef(*api_));
+    ON_CALL(factory_context_, localInfo()).WillByDefault(ReturnRef(local_info_));
+
+    envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext server_tls_context;
+    TestUtility::loadFromYaml(TestEnvironment::substitute(serverContextYaml(options)),
+                              server_tls_context);
+    server_factory_ = std::make_unique<ServerSslSocketFactory>(
+        std::make_unique<ServerContextConfigImpl>(server_tls_context, factory_context_), manager_,
+        server_stats_store_, std::vector<std::string>{});
+
+    envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext client_tls_context;
+    TestUtility::loadFromYaml(TestEnvironment::substitute(clientContextYaml(options)),
+                              client_tls_context);
+    client_factory_ = std::make_unique<ClientSslSocketFactory>(
+        std::make_unique<ClientContextConfigImpl>(client_tls_context, factory_context_), manager_,
+        client_stats_store_);
+  }
+
+  uint64_t sessionsReused() {
+    return TestUtility::findCounter(server_stats_store_, "ssl.session_reused")->value();
+  }
+
+  std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles_;
+  Event::GlobalTimeSystem time_system_;
+  Api::ApiPtr api_{Api::createApiForTest()};
+  NiceMock<LocalInfo::MockLocalInfo> local_info_;
+  NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context_;
+  ContextManagerImpl manager_{time_system_};
+  Stats::IsolatedStoreImpl server_stats_store_;
+  Stats::IsolatedStoreImpl client_stats_store_;
+  std::unique_ptr<ServerSslSocketFactory> server_factory_;
+  std::unique_ptr<ClientSslSocketFactory> client_factory_;
+};
+
+// One end of a connection: an SslSocket on one of the sockets of a socket pair.
+class SslSocketEnd {
+public:
+  SslSocketEnd(os_fd_t fd, Network::TransportSocketPtr&& socket)
+      : io_handle_(fd), socket_(std::move(socket)) {
+    ON_CALL(callbacks_, ioHandle()).WillByDefault(ReturnRef(io_handle_));
+    ON_CALL(callbacks_, raiseEvent(Network::ConnectionEvent::Connected))
+        .WillByDefault(Invoke([this](Network::ConnectionEvent) { connected_ = true; }));
+    socket_->setTransportSocketCallbacks(callbacks_);
+  }
+
+  void write(Buffer::Instance& buffer) {
+    const Network::IoResult result = socket_->doWrite(buffer, false);
+    RELEASE_ASSERT(result.action_ == Network::PostIoAction::KeepOpen, socket_->failureReason());
+  }
+
+  void read(Buffer::Instance& buffer) {
+    const Network::IoResult result = socket_->doRead(buffer);
+    RELEASE_ASSERT(result.action_ == Network::PostIoAction::KeepOpen, socket_->failureReason());
+  }
+
+  Network::IoSocketHandleImpl io_handle_;
+  NiceMock<Network::MockTransportSocketCallbacks> callbacks_;
+  Network::TransportSocketPtr socket_;
+  bool connected_{};
+};
+
+// A client and a server SslSocket connected over a socket pair.
+class SslSocketConnection {
+public:
+  SslSocketConnection(SslSocketFactories& factories) {
+    os_fd_t fds[2];
+    RELEASE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0, "socketpair");
+    client_ = std::make_unique<SslSocketEnd>(
+        fds[0], factories.client_factory_->createTransportSocket(nullptr));
+    server_ = std::make_unique<SslSocketEnd>(
+        fds[1], factories.server_factory_->createTransportSocket(nullptr));
+  }
+
+  void handshake() {
+    Buffer::OwnedImpl buffer;
+    for (int i = 0; i < 10 && !(client_->connected_ && server_->connected_); ++i) {
+      client_->write(buffer);
+      server_->read(buffer);
+    }
+    RELEASE_ASSERT(client_->connected_ && server_->connected_, "handshake completed");
+    // The client reads the session tickets that TLS 1.3 servers send after the handshake.
+    client_->read(buffer);
+    RELEASE_ASSERT(buffer.length() == 0, "no data after the handshake");
+  }
+
+  // Writes all of data on one end, and reads it on the other end.
+  static void transfer(SslSocketEnd& from, SslSocketEnd& to, Buffer::Instance& data,
+                       Buffer::Instance& received) {
+    const uint64_t length = received.length() + data.length();
+    from.write(data);
+    while (received.length() < length) {
+      to.read(received);
+      if (data.length() > 0) {
+        from.write(data);
+      }
+    }
+  }
+
+  std::unique_ptr<SslSocketEnd> client_;
+  std::unique_ptr<SslSocketEnd> server_;
+};
+
+// Full or resumed handshakes, with an RSA 2048 or ECDSA P-256 server certificate, TLS 1.2 or 1.3,
+// and with or without a client certificate. The client does not validate the server certificate.
+static void testHandshake(benchmark::State& state) {
+  ContextOptions options;
+  options.key_type_ = static_cast<KeyType>(state.range(0));
+  options.tls_version_ = state.range(1) == 12 ? "TLSv1_2" : "TLSv1_3";
+  options.resumption_ = state.range(2);
+  options.client_cert_ = state.range(3);
+  SslSocketFactories factories(options);
+  if (options.resumption_) {
+    // The first handshake is a full one, which gets the client a session to resume.
+    SslSocketConnection(factories).handshake();
+  }
+
+  const uint64_t reused_before = factories.sessionsReused();
+  uint64_t handshakes = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    SslSocketConnection connection(factories);
+    connection.handshake();
+    ++handshakes;
+  }
+  state.counters["handshakes"] = benchmark::Counter(handshakes, benchmark::Counter::kIsRate);
+  state.counters["resumed"] =
+      handshakes > 0 ? double(factories.sessionsReused() - reused_before) / handshakes : 0;
+}
+
+static void handshakeParams(benchmark::internal::Benchmark* b) {
+  for (auto key_type : {KeyType::Rsa, KeyType::Ecdsa}) {
+    for (auto tls_version : {12, 13}) {
+      for (auto resumption : {false, true}) {
+        for (auto client_cert : {false, true}) {
+          b->Args({static_cast<int>(key_type), tls_version, resumption, client_cert});
+        }
+      }
+    }
+  }
+}
+
+BENCHMARK(testHandshake)->Unit(::benchmark::kMicrosecond)->Apply(handshakeParams);
+
+// Round trips of a request and a response of the given sizes over a connection, in records of
+// at most 16KiB.
+static void testRequestResponse(benchmark::State& state) {
+  const uint64_t request_size = state.range(0);
+  const uint64_t response_size = state.range(1);
+  SslSocketFactories factories({});
+  SslSocketConnection connection(factories);
+  connection.handshake();
+
+  const std::string request(request_size, 'a');
+  const std::string response(response_size, 'b');
+  uint64_t round_trips = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Buffer::OwnedImpl data(request);
+    Buffer::OwnedImpl received;
+    SslSocketConnection::transfer(*connection.client_, *connection.server_, data, received);
+    data.add(response);
+    received.drain(received.length());
+    SslSocketConnection::transfer(*connection.server_, *connection.client_, data, received);
+    ++round_trips;
+  }
+  state.counters["round_trips"] = benchmark::Counter(round_trips, benchmark::Counter::kIsRate);
+  state.counters["throughput"] = benchmark::Counter(
+      round_trips * (request_size + response_size), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(testRequestResponse)
+    ->Unit(::benchmark::kMicrosecond)
+    ->Args({100, 100})
+    ->Args({1024, 1024})
+    ->Args({1024, 16 * 1024})
+    ->Args({100, 64 * 1024});
+
+// The memory of a connection, its client and server SslSocket included, once its handshake has
+// completed. Reports 0 bytes when the allocator does not provide the allocated size.
+static void testConnectionMemory(benchmark::State& state) {
+  ContextOptions options;
+  options.key_type_ = static_cast<KeyType>(state.range(0));
+  options.tls_version_ = state.range(1) == 12 ? "TLSv1_2" : "TLSv1_3";
+  SslSocketFactories factories(options);
+  const uint64_t num_connections = benchmark::skipExpensiveBenchmarks() ? 10 : 100;
+
+  uint64_t bytes_per_connection = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    std::vector<std::unique_ptr<SslSocketConnection>> connections;
+    connections.reserve(num_connections);
+    const uint64_t allocated_before = Memory::Stats::totalCurrentlyAllocated();
+    for (uint64_t i = 0; i < num_connections; ++i) {
+      connections.push_back(std::make_unique<SslSocketConnection>(factories));
+      connections.back()->handshake();
+    }
+    const uint64_t allocated_after = Memory::Stats::totalCurrentlyAllocated();
+    bytes_per_connection =
+        allocated_after > allocated_before ? (allocated_after - allocated_before) / num_connections
+                                           : 0;
+  }
+  state.counters["bytes_per_connection"] = bytes_per_connection;
+}
+
+BENCHMARK(testConnectionMemory)
+    ->Unit(::benchmark::kMillisecond)
+    ->Args({static_cast<int>(KeyType::Rsa), 12})
+    ->Args({static_cast<int>(KeyType::Rsa), 13})
+    ->Args({static_cast<int>(KeyType::Ecdsa), 13});
+
+} // namespace Extensions::TransportSockets::Tls
+} // namespace Envoy
@@ -70,48 +70,67 @@ static void addFullSlices(Buffer::Instance& output_buffer, int num_slices, bool
   }
 }
 
-static void testThroughput(benchmark::State& state) {
-  std::string error;
-  std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
-      bazel::tools::cpp::runfiles::Runfiles::Create("tls_throughput_benchmark", &error));
-  Envoy::TestEnvironment::setRunfiles(runfiles.get());
-
-  int sockets[2];
-  socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets);
-
-  bssl::UniquePtr<SSL_CTX> server_ctx(SSL_CTX_new(TLS_method()));
-  bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
-  std::string cert_path = TestEnvironment::substitute(
-      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_cert.pem");
-  std::string key_path = TestEnvironment::substitute(
-      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_key.pem");
-  auto err = SSL_CTX_use_certificate_file(server_ctx.get(), cert_path.c_str(), SSL_FILETYPE_PEM);
-  drainErrorQueue();
-  RELEASE_ASSERT(err > 0, "SSL_CTX_use_certificate_file");
-  err = SSL_CTX_use_PrivateKey_file(server_ctx.get(), key_path.c_str(), SSL_FILETYPE_PEM);
-  RELEASE_ASSERT(err > 0, "SSL_CTX_use_PrivateKey_file");
-
-  bssl::UniquePtr<SSL> server_ssl(SSL_new(server_ctx.get()));
-  SSL_set_fd(server_ssl.get(), sockets[0]);
-  SSL_set_accept_state(server_ssl.get());
-
-  bssl::UniquePtr<SSL> client_ssl(SSL_new(client_ctx.get()));
-  SSL_set_fd(client_ssl.get(), sockets[1]);
-  SSL_set_connect_state(client_ssl.get());
-
-  bool handshake_success = false;
-  for (int i = 0; i < 50; i++) {
-    int client_err = SSL_do_handshake(client_ssl.get());
-    int server_err = SSL_do_handshake(server_ssl.get());
-    if (client_err == 1 && server_err == 1) {
-      handshake_success = true;
-      break;
+// A client and a server connected over a socket pair, with their handshake completed.
+class SslPair {
+public:
+  SslPair() {
+    std::string error;
+    runfiles_.reset(
+        bazel::tools::cpp::runfiles::Runfiles::Create("tls_throughput_benchmark", &error));
+    Envoy::TestEnvironment::setRunfiles(runfiles_.get());
+
+    socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets_);
+
+    std::string cert_path = TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_cert.pem");
+    std::string key_path = TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_key.pem");
+    auto err = SSL_CTX_use_certificate_file(server_ctx_.get(), cert_path.c_str(), SSL_FILETYPE_PEM);
+    drainErrorQueue();
+    RELEASE_ASSERT(err > 0, "SSL_CTX_use_certificate_file");
+    err = SSL_CTX_use_PrivateKey_file(server_ctx_.get(), key_path.c_str(), SSL_FILETYPE_PEM);
+    RELEASE_ASSERT(err > 0, "SSL_CTX_use_PrivateKey_file");
+
+    server_ssl_.reset(SSL_new(server_ctx_.get()));
+    SSL_set_fd(server_ssl_.get(), sockets_[0]);
+    SSL_set_accept_state(server_ssl_.get());
+
+    client_ssl_.reset(SSL_new(client_ctx_.get()));
+    SSL_set_fd(client_ssl_.get(), sockets_[1]);
+    SSL_set_connect_state(client_ssl_.get());
+
+    bool handshake_success = false;
+    for (int i = 0; i < 50; i++) {
+      int client_err = SSL_do_handshake(client_ssl_.get());
+      int server_err = SSL_do_handshake(server_ssl_.get());
+      if (client_err == 1 && server_err == 1) {
+        handshake_success = true;
+        break;
+      }
+      handleSslError(client_ssl_.get(), client_err, false);
+      handleSslError(server_ssl_.get(), server_err, true);
     }
-    handleSslError(client_ssl.get(), client_err, false);
-    handleSslError(server_ssl.get(), server_err, true);
+
+    RELEASE_ASSERT(handshake_success, "handshake completed successfully");
   }
 
-  RELEASE_ASSERT(handshake_success, "handshake completed successfully");
+  ~SslPair() {
+    ::close(sockets_[0]);
+    ::close(sockets_[1]);
+  }
+
+  std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles_;
+  int sockets_[2];
+  bssl::UniquePtr<SSL_CTX> server_ctx_{SSL_CTX_new(TLS_method())};
+  bssl::UniquePtr<SSL_CTX> client_ctx_{SSL_CTX_new(TLS_method())};
+  bssl::UniquePtr<SSL> server_ssl_;
+  bssl::UniquePtr<SSL> client_ssl_;
+};
+
+static void testThroughput(benchmark::State& state) {
+  SslPair ssl_pair;
+  SSL* server_ssl = ssl_pair.server_ssl_.get();
+  SSL* client_ssl = ssl_pair.client_ssl_.get();
 
   static uint8_t read_buf[1024 * 1024];
 
@@ -126,7 +145,7 @@ static void testThroughput(benchmark::State& state) {
     state.PauseTiming();
 
     // Empty out the read side to make space for the writes.
-    while (SSL_read(server_ssl.get(), read_buf, sizeof(read_buf)) > 0) {
+    while (SSL_read(server_ssl, read_buf, sizeof(read_buf)) > 0) {
     }
 
     Buffer::OwnedImpl write_buf;
@@ -164,7 +183,7 @@ static void testThroughput(benchmark::State& state) {
         ++num_times_linearize_did_something;
       }
 
-      err = SSL_write(client_ssl.get(), mem, len);
+      const int err = SSL_write(client_ssl, mem, len);
       RELEASE_ASSERT(err == static_cast<int>(len),
                      absl::StrCat("SSL_write got: ", err, " expected: ", len));
       write_buf.drain(len);
@@ -175,9 +194,6 @@ static void testThroughput(benchmark::State& state) {
     state.counters["num_linearized"] = num_times_linearize_did_something;
   }
   state.counters["throughput"] = benchmark::Counter(bytes_written, benchmark::Counter::kIsRate);
-
-  ::close(sockets[0]);
-  ::close(sockets[1]);
 }
 
 static void testParams(benchmark::internal::Benchmark* b) {
@@ -198,5 +214,60 @@ static void testParams(benchmark::internal::Benchmark* b) {
 
 BENCHMARK(testThroughput)->Unit(::benchmark::kMicrosecond)->Apply(testParams);
 
+// Writes a response the way SslSocket::doWrite() does with dynamic record sizing, starting with
+// records of at most initial_record_size bytes, each one initial_record_size bytes longer than
+// the previous one, up to 16KiB. An initial_record_size of 0 writes 16KiB records throughout.
+// Reports the records written and the bytes in them before the first 16KiB record.
+static void testDynamicRecordSizing(benchmark::State& state) {
+  SslPair ssl_pair;
+  SSL* server_ssl = ssl_pair.server_ssl_.get();
+  SSL* client_ssl = ssl_pair.client_ssl_.get();
+
+  static uint8_t read_buf[1024 * 1024];
+
+  const uint64_t initial_record_size = state.range(0);
+  const uint64_t response_size = state.range(1);
+
+  uint64_t bytes_written = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    state.PauseTiming();
+    Buffer::OwnedImpl write_buf;
+    addFullSlices(write_buf, response_size / 16384, false);
+    bytes_written += write_buf.length();
+    state.ResumeTiming();
+
+    uint64_t max_record_size = initial_record_size > 0 ? initial_record_size : 16384;
+    uint32_t num_records = 0;
+    uint64_t small_record_bytes = 0;
+    while (write_buf.length() > 0) {
+      const uint64_t len = std::min(write_buf.length(), max_record_size);
+      const int err = SSL_write(client_ssl, write_buf.linearize(len), len);
+      RELEASE_ASSERT(err == static_cast<int>(len),
+                     absl::StrCat("SSL_write got: ", err, " expected: ", len));
+      write_buf.drain(len);
+      ++num_records;
+      if (max_record_size < 16384) {
+        small_record_bytes += len;
+        max_record_size = std::min<uint64_t>(max_record_size + initial_record_size, 16384);
+      }
+      // Read as the writes go, as the socket pair only buffers a few records.
+      while (SSL_read(server_ssl, read_buf, sizeof(read_buf)) > 0) {
+      }
+    }
+
+    state.counters["records_per_iteration"] = num_records;
+    state.counters["small_record_bytes"] = small_record_bytes;
+  }
+  state.counters["throughput"] = benchmark::Counter(bytes_written, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(testDynamicRecordSizing)
+    ->Unit(::benchmark::kMicrosecond)
+    ->Args({0, 64 * 1024})
+    ->Args({1300, 64 * 1024})
+    ->Args({0, 1024 * 1024})
+    ->Args({1300, 1024 * 1024});
+
 } // namespace Extensions::TransportSockets::Tls
 } // namespace Envoy
@@ -351,6 +351,10 @@ public:
     Thread::LockGuard lock(lock_);
     return store_.textReadouts();
   }
+  SelectedStats selectStats(absl::string_view prefix, bool used_only) const override {
+    Thread::LockGuard lock(lock_);
+    return store_.selectStats(prefix, used_only);
+  }
 
   bool iterate(const IterateFn<Counter>& fn) const override { return store_.iterate(fn); }
   bool iterate(const IterateFn<Gauge>& fn) const override { return store_.iterate(fn); }
@@ -362,6 +366,7 @@ public:
   void setTagProducer(TagProducerPtr&&) override {}
   void setStatsMatcher(StatsMatcherPtr&&) override {}
   void setHistogramSettings(HistogramSettingsConstPtr&&) override {}
+  void setCounterSharding(bool) override {}
   void initializeThreading(Event::Dispatcher&, ThreadLocal::Instance&) override {}
   void shutdownThreading() override {}
   void mergeHistograms(PostMergeCb) override {}
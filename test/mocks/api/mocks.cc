@@ -3,6 +3,8 @@
 #include "common/common/assert.h"
 #include "common/common/lock_guard.h"
 
+#include "test/test_common/thread_factory_for_test.h"
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -16,6 +18,7 @@ MockApi::MockApi() {
   ON_CALL(*this, fileSystem()).WillByDefault(ReturnRef(file_system_));
   ON_CALL(*this, rootScope()).WillByDefault(ReturnRef(stats_store_));
   ON_CALL(*this, randomGenerator()).WillByDefault(ReturnRef(random_));
+  ON_CALL(*this, threadFactory()).WillByDefault(ReturnRef(Thread::threadFactoryForTest()));
 }
 
 MockApi::~MockApi() = default;
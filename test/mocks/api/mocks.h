@@ -74,6 +74,8 @@ public:
   MOCK_METHOD(SysCallIntResult, recvmmsg,
               (os_fd_t socket, struct mmsghdr* msgvec, unsigned int vlen, int flags,
                struct timespec* timeout));
+  MOCK_METHOD(SysCallIntResult, sendmmsg,
+              (os_fd_t socket, struct mmsghdr* msgvec, unsigned int vlen, int flags));
   MOCK_METHOD(SysCallIntResult, ftruncate, (int fd, off_t length));
   MOCK_METHOD(SysCallPtrResult, mmap,
               (void* addr, size_t length, int prot, int flags, int fd, off_t offset));
@@ -97,6 +99,7 @@ public:
   MOCK_METHOD(SysCallBoolResult, socketTcpInfo, (os_fd_t sockfd, EnvoyTcpInfo* tcp_info));
   MOCK_METHOD(bool, supportsMmsg, (), (const));
   MOCK_METHOD(bool, supportsUdpGro, (), (const));
+  MOCK_METHOD(bool, supportsUdpGso, (), (const));
   MOCK_METHOD(bool, supportsIpTransparent, (), (const));
 
   // Map from (sockfd,level,optname) to boolean socket option.
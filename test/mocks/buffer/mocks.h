@@ -84,6 +84,10 @@ public:
   MOCK_METHOD(Buffer::Instance*, create_,
               (std::function<void()> below_low, std::function<void()> above_high,
                std::function<void()> above_overflow));
+  MOCK_METHOD(void, trackAccounts, ());
+  MOCK_METHOD(Buffer::BufferMemoryAccountSharedPtr, createAccount,
+              (std::function<void()> reset_stream));
+  MOCK_METHOD(uint64_t, resetAccountsGivenPressure, (float pressure));
 };
 
 MATCHER_P(BufferEqual, rhs, testing::PrintToString(*rhs)) {
@@ -40,6 +40,8 @@ public:
   ~MockOpaqueResourceDecoder() override;
 
   MOCK_METHOD(ProtobufTypes::MessagePtr, decodeResource, (const ProtobufWkt::Any& resource));
+  MOCK_METHOD(ProtobufTypes::MessagePtr, predecodeResource, (const ProtobufWkt::Any& resource));
+  MOCK_METHOD(void, finishDecodeResource, (const Protobuf::Message& resource));
   MOCK_METHOD(std::string, resourceName, (const Protobuf::Message& resource));
 };
 
@@ -119,6 +121,10 @@ public:
 
   MOCK_METHOD(void, requestOnDemandUpdate,
               (const std::string& type_url, const std::set<std::string>& add_these_names));
+  MOCK_METHOD(std::vector<envoy::service::discovery::v3::DiscoveryResponse>, handoffResponses,
+              ());
+  MOCK_METHOD(void, applyHandoffResponses,
+              (std::vector<envoy::service::discovery::v3::DiscoveryResponse> && responses));
 };
 
 class MockGrpcStreamCallbacks
@@ -130,7 +136,7 @@ public:
   MOCK_METHOD(void, onStreamEstablished, ());
   MOCK_METHOD(void, onEstablishmentFailure, ());
   MOCK_METHOD(void, onDiscoveryResponse,
-              (std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse> && message,
+              (const envoy::service::discovery::v3::DiscoveryResponse& message,
                ControlPlaneStats& control_plane_stats));
   MOCK_METHOD(void, onWriteable, ());
 };
@@ -25,6 +25,10 @@ public:
     impl_.registerWatchdog(watchdog, min_touch_interval);
   }
 
+  void setSpinBudget(std::chrono::microseconds spin_budget) override {
+    impl_.setSpinBudget(spin_budget);
+  }
+
   TimeSource& timeSource() override { return impl_.timeSource(); }
 
   void initializeStats(Stats::Scope& scope, const absl::optional<std::string>& prefix) override {
@@ -87,7 +87,8 @@ public:
   MOCK_METHOD(void, setDelayedCloseTimeout, (std::chrono::milliseconds));                          \
   MOCK_METHOD(absl::string_view, transportFailureReason, (), (const));                             \
   MOCK_METHOD(bool, startSecureTransport, ());                                                     \
-  MOCK_METHOD(absl::optional<std::chrono::milliseconds>, lastRoundTripTime, (), (const))
+  MOCK_METHOD(absl::optional<std::chrono::milliseconds>, lastRoundTripTime, (), (const));          \
+  MOCK_METHOD(bool, enableSplicing, (Network::Connection & peer))
 
 class MockConnection : public Connection, public MockConnectionBase {
 public:
@@ -173,6 +174,7 @@ public:
   MOCK_METHOD(absl::string_view, transportFailureReason, (), (const));
   MOCK_METHOD(bool, startSecureTransport, ());
   MOCK_METHOD(absl::optional<std::chrono::milliseconds>, lastRoundTripTime, (), (const));
+  MOCK_METHOD(bool, enableSplicing, (Network::Connection & peer));
 
   // Network::FilterManagerConnection
   MOCK_METHOD(StreamBuffer, getReadBuffer, ());
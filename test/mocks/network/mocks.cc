@@ -112,6 +112,12 @@ MockListenerFilter::~MockListenerFilter() { destroy_(); }
 
 MockListenerFilterCallbacks::MockListenerFilterCallbacks() {
   ON_CALL(*this, socket()).WillByDefault(ReturnRef(socket_));
+  ON_CALL(*this, listenerFilterBuffer()).WillByDefault(Invoke([this]() -> ListenerFilterBuffer& {
+    if (buffer_ == nullptr) {
+      buffer_ = std::make_unique<ListenerFilterBufferImpl>(socket().ioHandle());
+    }
+    return *buffer_;
+  }));
 }
 MockListenerFilterCallbacks::~MockListenerFilterCallbacks() = default;
 
@@ -120,6 +126,8 @@ MockListenerFilterManager::~MockListenerFilterManager() = default;
 
 MockFilterChain::MockFilterChain() = default;
 MockFilterChain::~MockFilterChain() = default;
+MockOnDemandFilterChain::MockOnDemandFilterChain() = default;
+MockOnDemandFilterChain::~MockOnDemandFilterChain() = default;
 
 MockFilterChainManager::MockFilterChainManager() = default;
 MockFilterChainManager::~MockFilterChainManager() = default;
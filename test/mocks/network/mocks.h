@@ -15,6 +15,7 @@
 #include "envoy/stats/scope.h"
 
 #include "common/network/filter_manager_impl.h"
+#include "common/network/listener_filter_buffer_impl.h"
 #include "common/network/socket_interface.h"
 #include "common/stats/isolated_store_impl.h"
 
@@ -155,6 +156,8 @@ public:
   ~MockDrainDecision() override;
 
   MOCK_METHOD(bool, drainClose, (), (const));
+  MOCK_METHOD(DrainCloseHandlePtr, addOnDrainCloseCb,
+              (Event::Dispatcher & dispatcher, DrainCloseCb cb), (const));
 };
 
 class MockListenerFilter : public ListenerFilter {
@@ -189,9 +192,20 @@ public:
   MOCK_METHOD(const TransportSocketFactory&, transportSocketFactory, (), (const));
   MOCK_METHOD(std::chrono::milliseconds, transportSocketConnectTimeout, (), (const));
   MOCK_METHOD(const std::vector<FilterFactoryCb>&, networkFilterFactories, (), (const));
+  MOCK_METHOD(const OnDemandFilterChain*, onDemandFilterChain, (), (const));
   MOCK_METHOD(void, startDraining, ());
 };
 
+class MockOnDemandFilterChain : public OnDemandFilterChain {
+public:
+  MockOnDemandFilterChain();
+  ~MockOnDemandFilterChain() override;
+
+  // Network::OnDemandFilterChain
+  MOCK_METHOD(bool, built, (), (const));
+  MOCK_METHOD(void, build, (Event::Dispatcher & dispatcher, std::function<void()> cb), (const));
+};
+
 class MockFilterChainManager : public FilterChainManager {
 public:
   MockFilterChainManager();
@@ -319,12 +333,15 @@ public:
 
   MOCK_METHOD(ConnectionSocket&, socket, ());
   MOCK_METHOD(Event::Dispatcher&, dispatcher, ());
+  MOCK_METHOD(ListenerFilterBuffer&, listenerFilterBuffer, ());
   MOCK_METHOD(void, continueFilterChain, (bool));
   MOCK_METHOD(void, setDynamicMetadata, (const std::string&, const ProtobufWkt::Struct&));
   MOCK_METHOD(envoy::config::core::v3::Metadata&, dynamicMetadata, ());
   MOCK_METHOD(const envoy::config::core::v3::Metadata&, dynamicMetadata, (), (const));
 
   NiceMock<MockConnectionSocket> socket_;
+  // Peeks at the io handle of socket(), created on first use.
+  std::unique_ptr<ListenerFilterBufferImpl> buffer_;
 };
 
 class MockListenSocketFactory : public ListenSocketFactory {
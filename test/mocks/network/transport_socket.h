@@ -27,6 +27,7 @@ public:
   MOCK_METHOD(void, onConnected, ());
   MOCK_METHOD(Ssl::ConnectionInfoConstSharedPtr, ssl, (), (const));
   MOCK_METHOD(bool, startSecureTransport, ());
+  MOCK_METHOD(bool, canSplice, (), (const));
 
   TransportSocketCallbacks* callbacks_{};
 };
@@ -7,6 +7,7 @@
 
 using testing::_;
 using testing::DoAll;
+using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
 using testing::ReturnPointee;
@@ -19,6 +20,9 @@ namespace Router {
 MockDirectResponseEntry::MockDirectResponseEntry() = default;
 MockDirectResponseEntry::~MockDirectResponseEntry() = default;
 
+MockAdaptiveHedge::MockAdaptiveHedge() = default;
+MockAdaptiveHedge::~MockAdaptiveHedge() = default;
+
 TestRetryPolicy::TestRetryPolicy() { num_retries_ = 1; }
 
 TestRetryPolicy::~TestRetryPolicy() = default;
@@ -131,6 +135,21 @@ MockRoute::MockRoute() {
   ON_CALL(*this, routeEntry()).WillByDefault(Return(&route_entry_));
   ON_CALL(*this, decorator()).WillByDefault(Return(&decorator_));
   ON_CALL(*this, tracingConfig()).WillByDefault(Return(nullptr));
+  // Resolve the configs that tests set on the route entry, route and virtual host mocks in the
+  // order of the real routes.
+  ON_CALL(*this, mostSpecificPerFilterConfig(_))
+      .WillByDefault(Invoke([this](const std::string& name) -> const RouteSpecificFilterConfig* {
+        const RouteEntry* route_entry = routeEntry();
+        const RouteSpecificFilterConfig* config =
+            route_entry != nullptr ? route_entry->perFilterConfig(name) : nullptr;
+        if (config == nullptr) {
+          config = perFilterConfig(name);
+        }
+        if (config == nullptr && route_entry != nullptr) {
+          config = route_entry->virtualHost().perFilterConfig(name);
+        }
+        return config;
+      }));
 }
 MockRoute::~MockRoute() = default;
 
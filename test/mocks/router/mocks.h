@@ -89,10 +89,23 @@ public:
     return additional_request_chance_;
   }
   bool hedgeOnPerTryTimeout() const override { return hedge_on_per_try_timeout_; }
+  AdaptiveHedge* adaptiveHedge() const override { return adaptive_hedge_; }
 
   uint32_t initial_requests_{};
   envoy::type::v3::FractionalPercent additional_request_chance_{};
   bool hedge_on_per_try_timeout_{};
+  AdaptiveHedge* adaptive_hedge_{};
+};
+
+class MockAdaptiveHedge : public AdaptiveHedge {
+public:
+  MockAdaptiveHedge();
+  ~MockAdaptiveHedge() override;
+
+  // Router::AdaptiveHedge
+  MOCK_METHOD(absl::optional<std::chrono::milliseconds>, onRequest, ());
+  MOCK_METHOD(bool, tryHedge, ());
+  MOCK_METHOD(void, onResponse, (std::chrono::milliseconds response_time));
 };
 
 class TestRetryPolicy : public RetryPolicy {
@@ -268,7 +281,7 @@ public:
   MOCK_METHOD(const std::string&, name, (), (const));
   MOCK_METHOD(const RateLimitPolicy&, rateLimitPolicy, (), (const));
   MOCK_METHOD(const CorsPolicy*, corsPolicy, (), (const));
-  MOCK_METHOD(const Config&, routeConfig, (), (const));
+  MOCK_METHOD(const CommonConfig&, routeConfig, (), (const));
   MOCK_METHOD(const RouteSpecificFilterConfig*, perFilterConfig, (const std::string&), (const));
   MOCK_METHOD(bool, includeAttemptCountInRequest, (), (const));
   MOCK_METHOD(bool, includeAttemptCountInResponse, (), (const));
@@ -443,6 +456,8 @@ public:
   MOCK_METHOD(const Decorator*, decorator, (), (const));
   MOCK_METHOD(const RouteTracing*, tracingConfig, (), (const));
   MOCK_METHOD(const RouteSpecificFilterConfig*, perFilterConfig, (const std::string&), (const));
+  MOCK_METHOD(const RouteSpecificFilterConfig*, mostSpecificPerFilterConfig, (const std::string&),
+              (const));
 
   testing::NiceMock<MockRouteEntry> route_entry_;
   testing::NiceMock<MockDecorator> decorator_;
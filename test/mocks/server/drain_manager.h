@@ -18,6 +18,8 @@ public:
 
   // Server::DrainManager
   MOCK_METHOD(bool, drainClose, (), (const));
+  MOCK_METHOD(Network::DrainCloseHandlePtr, addOnDrainCloseCb,
+              (Event::Dispatcher & dispatcher, Network::DrainCloseCb cb), (const));
   MOCK_METHOD(bool, draining, (), (const));
   MOCK_METHOD(void, startDrainSequence, (std::function<void()> completion));
   MOCK_METHOD(void, startParentShutdownSequence, ());
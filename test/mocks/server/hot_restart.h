@@ -21,6 +21,8 @@ public:
   MOCK_METHOD(void, sendParentAdminShutdownRequest, (time_t & original_start_time));
   MOCK_METHOD(void, sendParentTerminateRequest, ());
   MOCK_METHOD(ServerStatsFromParent, mergeParentStatsIfAny, (Stats::StoreRoot & stats_store));
+  MOCK_METHOD(std::vector<envoy::service::discovery::v3::DiscoveryResponse>,
+              getParentXdsResources, ());
   MOCK_METHOD(void, shutdown, ());
   MOCK_METHOD(uint32_t, baseId, ());
   MOCK_METHOD(std::string, version, ());
@@ -30,6 +30,7 @@ MockWatchdog::MockWatchdog(int miss, int megamiss, int kill, int multikill,
   ON_CALL(*this, killTimeout()).WillByDefault(Return(kill_));
   ON_CALL(*this, multiKillTimeout()).WillByDefault(Return(multikill_));
   ON_CALL(*this, multiKillThreshold()).WillByDefault(Return(multikill_threshold_));
+  ON_CALL(*this, stallCaptureTimeout()).WillByDefault(Return(std::chrono::milliseconds(0)));
   ON_CALL(*this, actions).WillByDefault(Return(actions_));
 }
 
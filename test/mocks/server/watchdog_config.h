@@ -21,6 +21,7 @@ public:
   MOCK_METHOD(std::chrono::milliseconds, killTimeout, (), (const));
   MOCK_METHOD(std::chrono::milliseconds, multiKillTimeout, (), (const));
   MOCK_METHOD(double, multiKillThreshold, (), (const));
+  MOCK_METHOD(std::chrono::milliseconds, stallCaptureTimeout, (), (const));
   MOCK_METHOD(Protobuf::RepeatedPtrField<envoy::config::bootstrap::v3::Watchdog::WatchdogAction>,
               actions, (), (const));
 
@@ -96,6 +96,8 @@ public:
   MOCK_METHOD(const std::string&, serverNameIndication, (), (const));
   MOCK_METHOD(bool, allowRenegotiation, (), (const));
   MOCK_METHOD(size_t, maxSessionKeys, (), (const));
+  MOCK_METHOD(absl::optional<uint32_t>, maxSessionCacheSize, (), (const));
+  MOCK_METHOD(bool, earlyDataEnabled, (), (const));
   MOCK_METHOD(const std::string&, signingAlgorithmsForTest, (), (const));
 };
 
@@ -123,6 +125,8 @@ public:
   MOCK_METHOD(OcspStaplePolicy, ocspStaplePolicy, (), (const));
   MOCK_METHOD(const std::vector<SessionTicketKey>&, sessionTicketKeys, (), (const));
   MOCK_METHOD(bool, disableStatelessSessionResumption, (), (const));
+  MOCK_METHOD(absl::optional<uint32_t>, maxSessionCacheSize, (), (const));
+  MOCK_METHOD(absl::optional<DynamicRecordSizing>, dynamicRecordSizing, (), (const));
 };
 
 class MockTlsCertificateConfig : public TlsCertificateConfig {
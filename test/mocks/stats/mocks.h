@@ -173,6 +173,7 @@ public:
   MOCK_METHOD(uint64_t, value, (), (const));
   MOCK_METHOD(absl::optional<bool>, cachedShouldImport, (), (const));
   MOCK_METHOD(ImportMode, importMode, (), (const));
+  MOCK_METHOD(bool, latchChanged, ());
 
   bool used_;
   uint64_t value_;
@@ -246,6 +247,7 @@ public:
   MOCK_METHOD(void, set, (absl::string_view value), (override));
   MOCK_METHOD(bool, used, (), (const, override));
   MOCK_METHOD(std::string, value, (), (const, override));
+  MOCK_METHOD(bool, latchChanged, (), (override));
 
   bool used_;
   std::string value_;
@@ -25,6 +25,7 @@ public:
   MOCK_METHOD(void, shutdownGlobalThreading, ());
   MOCK_METHOD(void, shutdownThread, ());
   MOCK_METHOD(Event::Dispatcher&, dispatcher, ());
+  MOCK_METHOD(ScopedBatch, startBatch, ());
 
   SlotPtr allocateSlot_() { return SlotPtr{new SlotImpl(*this, current_slot_++)}; }
   void runOnAllThreads1_(Event::PostCb cb) { cb(); }
@@ -77,6 +77,15 @@ public:
   MOCK_METHOD(void, setUnhealthy, ());
 };
 
+class MockResponseTimeMonitor : public ResponseTimeMonitor {
+public:
+  MockResponseTimeMonitor();
+  ~MockResponseTimeMonitor() override;
+
+  MOCK_METHOD(void, putResponseTime, (std::chrono::milliseconds response_time));
+  MOCK_METHOD(double, peakEwma, (), (const));
+};
+
 class MockHostDescription : public HostDescription {
 public:
   MockHostDescription();
@@ -91,6 +100,7 @@ public:
   MOCK_METHOD(const ClusterInfo&, cluster, (), (const));
   MOCK_METHOD(Outlier::DetectorHostMonitor&, outlierDetector, (), (const));
   MOCK_METHOD(HealthCheckHostMonitor&, healthChecker, (), (const));
+  MOCK_METHOD(ResponseTimeMonitor&, responseTimeMonitor, (), (const));
   MOCK_METHOD(const std::string&, hostnameForHealthChecks, (), (const));
   MOCK_METHOD(const std::string&, hostname, (), (const));
   MOCK_METHOD(Network::TransportSocketFactory&, transportSocketFactory, (), (const));
@@ -110,6 +120,7 @@ public:
   Network::Address::InstanceConstSharedPtr address_;
   testing::NiceMock<Outlier::MockDetectorHostMonitor> outlier_detector_;
   testing::NiceMock<MockHealthCheckHostMonitor> health_checker_;
+  testing::NiceMock<MockResponseTimeMonitor> response_time_monitor_;
   Network::TransportSocketFactoryPtr socket_factory_;
   testing::NiceMock<MockClusterInfo> cluster_;
   HostStats stats_;
@@ -169,8 +180,7 @@ public:
               (Event::Dispatcher & dispatcher,
                const Network::ConnectionSocket::OptionsSharedPtr& options),
               (const));
-  MOCK_METHOD((std::vector<std::pair<absl::string_view, Stats::PrimitiveGaugeReference>>), gauges,
-              (), (const));
+  MOCK_METHOD((std::vector<std::pair<absl::string_view, uint64_t>>), gauges, (), (const));
   MOCK_METHOD(HealthCheckHostMonitor&, healthChecker, (), (const));
   MOCK_METHOD(void, healthFlagClear, (HealthFlag flag));
   MOCK_METHOD(bool, healthFlagGet, (HealthFlag flag), (const));
@@ -182,6 +192,7 @@ public:
   MOCK_METHOD(const std::string&, hostname, (), (const));
   MOCK_METHOD(Network::TransportSocketFactory&, transportSocketFactory, (), (const));
   MOCK_METHOD(Outlier::DetectorHostMonitor&, outlierDetector, (), (const));
+  MOCK_METHOD(ResponseTimeMonitor&, responseTimeMonitor, (), (const));
   MOCK_METHOD(void, setHealthChecker_, (HealthCheckHostMonitorPtr & health_checker));
   MOCK_METHOD(void, setOutlierDetector_, (Outlier::DetectorHostMonitorPtr & outlier_detector));
   MOCK_METHOD(HostStats&, stats, (), (const));
@@ -198,6 +209,7 @@ public:
   testing::NiceMock<MockClusterInfo> cluster_;
   Network::TransportSocketFactoryPtr socket_factory_;
   testing::NiceMock<Outlier::MockDetectorHostMonitor> outlier_detector_;
+  testing::NiceMock<MockResponseTimeMonitor> response_time_monitor_;
   HostStats stats_;
   mutable Stats::TestUtil::TestSymbolTable symbol_table_;
   mutable std::unique_ptr<Stats::StatNameManagedStorage> locality_zone_stat_name_;
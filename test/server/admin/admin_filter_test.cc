@@ -1,5 +1,7 @@
 #include "server/admin/admin_filter.h"
 
+#include "test/mocks/buffer/mocks.h"
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/server/instance.h"
 #include "test/test_common/environment.h"
 
@@ -77,5 +79,43 @@ TEST_P(AdminFilterTest, Trailers) {
   EXPECT_EQ(Http::FilterTrailersStatus::StopIteration, filter_.decodeTrailers(request_trailers));
 }
 
+// The rest of a streamed response is encoded one chunk per event loop iteration, while the
+// downstream connection is below its high watermark.
+TEST_P(AdminFilterTest, StreamRemainingResponse) {
+  uint32_t chunks = 0;
+  AdminFilter filter([&chunks](absl::string_view, Http::ResponseHeaderMap&,
+                               Buffer::OwnedImpl& response, AdminFilter& filter) {
+    response.add("first\n");
+    filter.streamRemainingResponse([&chunks](Buffer::Instance& chunk) {
+      chunk.add("chunk\n");
+      return ++chunks < 2;
+    });
+    return Http::Code::OK;
+  });
+  filter.setDecoderFilterCallbacks(callbacks_);
+  auto* next_chunk_cb = new NiceMock<Event::MockSchedulableCallback>(&callbacks_.dispatcher_);
+
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, false));
+  EXPECT_CALL(callbacks_, encodeData(BufferStringEqual("first\n"), false));
+  EXPECT_CALL(callbacks_, addDownstreamWatermarkCallbacks(_));
+  filter.decodeHeaders(request_headers_, true);
+  EXPECT_TRUE(next_chunk_cb->enabled_);
+
+  filter.onAboveWriteBufferHighWatermark();
+  EXPECT_FALSE(next_chunk_cb->enabled_);
+  filter.onBelowWriteBufferLowWatermark();
+  EXPECT_TRUE(next_chunk_cb->enabled_);
+
+  EXPECT_CALL(callbacks_, encodeData(BufferStringEqual("chunk\n"), false));
+  next_chunk_cb->invokeCallback();
+  EXPECT_TRUE(next_chunk_cb->enabled_);
+
+  EXPECT_CALL(callbacks_, removeDownstreamWatermarkCallbacks(_));
+  EXPECT_CALL(callbacks_, encodeData(BufferStringEqual("chunk\n"), true));
+  next_chunk_cb->invokeCallback();
+  EXPECT_FALSE(next_chunk_cb->enabled_);
+  filter.onDestroy();
+}
+
 } // namespace Server
 } // namespace Envoy
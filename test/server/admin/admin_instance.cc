@@ -29,7 +29,10 @@ Http::Code AdminInstanceTest::runCallback(absl::string_view path_and_query,
   request_headers_.setMethod(method);
   admin_filter_.decodeHeaders(request_headers_, false);
 
-  return admin_.runCallback(path_and_query, response_headers, response, admin_filter_);
+  const Http::Code code =
+      admin_.runCallback(path_and_query, response_headers, response, admin_filter_);
+  admin_filter_.drainRemainingResponse(response);
+  return code;
 }
 
 Http::Code AdminInstanceTest::getCallback(absl::string_view path_and_query,
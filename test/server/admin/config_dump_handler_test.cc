@@ -611,5 +611,148 @@ TEST_P(AdminInstanceTest, ConfigDumpResourceNotRepeated) {
             getCallback("/config_dump?resource=version_info", header_map, response));
 }
 
+// Test that the name_regex query parameter filters the resources of every config in the dump.
+TEST_P(AdminInstanceTest, ConfigDumpFiltersByName) {
+  Buffer::OwnedImpl response;
+  Http::TestResponseHeaderMapImpl header_map;
+  auto listeners = admin_.getConfigTracker().add("listeners", [] {
+    auto msg = std::make_unique<envoy::admin::v3::ListenersConfigDump>();
+    auto dyn_listener = msg->add_dynamic_listeners();
+    dyn_listener->set_name("foo");
+    auto stat_listener = msg->add_static_listeners();
+    envoy::config::listener::v3::Listener listener;
+    listener.set_name("bar");
+    stat_listener->mutable_listener()->PackFrom(listener);
+    return msg;
+  });
+  const std::string expected_json = R"EOF({
+ "configs": [
+  {
+   "@type": "type.googleapis.com/envoy.admin.v3.ListenersConfigDump",
+   "static_listeners": [
+    {
+     "listener": {
+      "@type": "type.googleapis.com/envoy.config.listener.v3.Listener",
+      "name": "bar"
+     }
+    }
+   ]
+  }
+ ]
+}
+)EOF";
+  EXPECT_EQ(Http::Code::OK, getCallback("/config_dump?name_regex=^ba", header_map, response));
+  std::string output = response.toString();
+  EXPECT_EQ(expected_json, output);
+}
+
+// Test that a resource matches the name_regex query parameter if the regex matches anywhere in its
+// name.
+TEST_P(AdminInstanceTest, ConfigDumpFiltersByNameAnywhere) {
+  Buffer::OwnedImpl response;
+  Http::TestResponseHeaderMapImpl header_map;
+  auto listeners = admin_.getConfigTracker().add("listeners", [] {
+    auto msg = std::make_unique<envoy::admin::v3::ListenersConfigDump>();
+    msg->add_dynamic_listeners()->set_name("foo");
+    msg->add_dynamic_listeners()->set_name("bar");
+    return msg;
+  });
+  const std::string expected_json = R"EOF({
+ "configs": [
+  {
+   "@type": "type.googleapis.com/envoy.admin.v3.ListenersConfigDump",
+   "dynamic_listeners": [
+    {
+     "name": "foo"
+    }
+   ]
+  }
+ ]
+}
+)EOF";
+  EXPECT_EQ(Http::Code::OK, getCallback("/config_dump?name_regex=o%2B", header_map, response));
+  std::string output = response.toString();
+  EXPECT_EQ(expected_json, output);
+}
+
+// Test that the name_regex query parameter filters the resources matching the resource query
+// parameter, before the mask is applied.
+TEST_P(AdminInstanceTest, ConfigDumpFiltersByResourceAndName) {
+  Buffer::OwnedImpl response;
+  Http::TestResponseHeaderMapImpl header_map;
+  auto clusters = admin_.getConfigTracker().add("clusters", [] {
+    auto msg = testDumpClustersConfig();
+    auto* dyn_cluster =
+        dynamic_cast<envoy::admin::v3::ClustersConfigDump&>(*msg).add_dynamic_active_clusters();
+    envoy::config::cluster::v3::Cluster inner_dyn_cluster;
+    inner_dyn_cluster.set_name("baz");
+    dyn_cluster->mutable_cluster()->PackFrom(inner_dyn_cluster);
+    return msg;
+  });
+  const std::string expected_json = R"EOF({
+ "configs": [
+  {
+   "@type": "type.googleapis.com/envoy.admin.v3.ClustersConfigDump.DynamicCluster",
+   "cluster": {
+    "@type": "type.googleapis.com/envoy.config.cluster.v3.Cluster",
+    "name": "baz"
+   }
+  }
+ ]
+}
+)EOF";
+  EXPECT_EQ(Http::Code::OK,
+            getCallback("/config_dump?resource=dynamic_active_clusters&name_regex=z$&mask=cluster",
+                        header_map, response));
+  std::string output = response.toString();
+  EXPECT_EQ(expected_json, output);
+}
+
+// Test that a 400 Bad Request is returned if the name_regex query parameter is not a valid regex.
+TEST_P(AdminInstanceTest, ConfigDumpInvalidNameRegex) {
+  Buffer::OwnedImpl response;
+  Http::TestResponseHeaderMapImpl header_map;
+  auto clusters = admin_.getConfigTracker().add("clusters", testDumpClustersConfig);
+  EXPECT_EQ(Http::Code::BadRequest,
+            getCallback("/config_dump?name_regex=[", header_map, response));
+  EXPECT_THAT(response.toString(), testing::HasSubstr("Invalid regex"));
+}
+
+// Test that a dump larger than a chunk is streamed, with the same output as if it were serialized
+// at once.
+TEST_P(AdminInstanceTest, ConfigDumpInChunks) {
+  envoy::admin::v3::ConfigDump dump;
+  std::vector<ConfigTracker::EntryOwnerPtr> entries;
+  for (int i = 0; i < 100; ++i) {
+    ProtobufWkt::StringValue value;
+    value.set_value(std::string(2048, 'a' + i % 26));
+    dump.add_configs()->PackFrom(value);
+    entries.push_back(admin_.getConfigTracker().add(fmt::format("config_{:03}", i), [value] {
+      return std::make_unique<ProtobufWkt::StringValue>(value);
+    }));
+  }
+  const std::string expected_json = MessageUtil::getJsonStringFromMessage(dump, true);
+
+  ConfigDumpRenderer renderer{envoy::admin::v3::ConfigDump(dump)};
+  std::string output;
+  uint32_t chunks = 0;
+  bool more = true;
+  while (more) {
+    Buffer::OwnedImpl chunk;
+    more = renderer.nextChunk(chunk);
+    // A chunk ends at the end of the first config that makes it longer than ChunkSize.
+    EXPECT_LT(chunk.length(), ConfigDumpRenderer::ChunkSize + 4096);
+    output += chunk.toString();
+    ++chunks;
+  }
+  EXPECT_GT(chunks, 1);
+  EXPECT_EQ(expected_json, output);
+
+  Buffer::OwnedImpl response;
+  Http::TestResponseHeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::OK, getCallback("/config_dump", header_map, response));
+  EXPECT_EQ(expected_json, response.toString());
+}
+
 } // namespace Server
 } // namespace Envoy
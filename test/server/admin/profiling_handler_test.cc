@@ -1,8 +1,15 @@
+#include "common/common/stage_trace.h"
 #include "common/profiler/profiler.h"
+#include "common/profiler/sampling_profiler.h"
 
 #include "test/server/admin/admin_instance.h"
 #include "test/test_common/logging.h"
 
+#include "gmock/gmock.h"
+
+using testing::HasSubstr;
+using testing::Not;
+
 namespace Envoy {
 namespace Server {
 
@@ -64,6 +71,66 @@ TEST_P(AdminInstanceTest, AdminHeapProfiler) {
   EXPECT_FALSE(Profiler::Heap::isProfilerStarted());
 }
 
+TEST_P(AdminInstanceTest, AdminSamplingProfiler) {
+  Buffer::OwnedImpl data;
+  Http::TestResponseHeaderMapImpl header_map;
+
+  EXPECT_EQ(Http::Code::BadRequest, postCallback("/cpuprofiler/sampling", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest,
+            postCallback("/cpuprofiler/sampling?enable=y&frequency=0", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest,
+            postCallback("/cpuprofiler/sampling?enable=y&frequency=1001", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest,
+            getCallback("/cpuprofiler/samples?format=svg", header_map, data));
+
+#ifdef __linux__
+  EXPECT_EQ(Http::Code::OK,
+            postCallback("/cpuprofiler/sampling?enable=y&frequency=100", header_map, data));
+  EXPECT_TRUE(Profiler::SamplingProfiler::running());
+  // Both profilers cannot run at the same time.
+  EXPECT_EQ(Http::Code::BadRequest, postCallback("/cpuprofiler?enable=y", header_map, data));
+  EXPECT_FALSE(Profiler::Cpu::profilerEnabled());
+#else
+  EXPECT_EQ(Http::Code::InternalServerError,
+            postCallback("/cpuprofiler/sampling?enable=y", header_map, data));
+#endif
+
+  EXPECT_EQ(Http::Code::OK, postCallback("/cpuprofiler/sampling?enable=n", header_map, data));
+  EXPECT_FALSE(Profiler::SamplingProfiler::running());
+
+  EXPECT_EQ(Http::Code::OK,
+            getCallback("/cpuprofiler/samples?format=collapsed&seconds=10", header_map, data));
+  EXPECT_EQ("text/plain", header_map.getContentTypeValue());
+  EXPECT_EQ(Http::Code::OK, getCallback("/cpuprofiler/samples?format=pprof", header_map, data));
+  EXPECT_EQ("application/octet-stream", header_map.getContentTypeValue());
+}
+
+TEST_P(AdminInstanceTest, AdminStageTrace) {
+  Buffer::OwnedImpl data;
+  Http::TestResponseHeaderMapImpl header_map;
+
+  EXPECT_EQ(Http::Code::BadRequest, postCallback("/stage_trace", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest, postCallback("/stage_trace?enable=maybe", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest,
+            postCallback("/stage_trace?enable=y&other=1", header_map, data));
+
+  EXPECT_EQ(Http::Code::OK, postCallback("/stage_trace?enable=y&clear", header_map, data));
+  EXPECT_TRUE(StageTrace::enabled());
+  STAGE_TRACE(StageTrace::Stage::Accept, 7, 0);
+  EXPECT_EQ(Http::Code::OK, postCallback("/stage_trace?enable=n", header_map, data));
+  EXPECT_FALSE(StageTrace::enabled());
+
+  data.drain(data.length());
+  EXPECT_EQ(Http::Code::OK, getCallback("/stage_trace/dump", header_map, data));
+  EXPECT_EQ("application/json", header_map.getContentTypeValue());
+  EXPECT_THAT(data.toString(), HasSubstr(R"("name":"accept")"));
+
+  EXPECT_EQ(Http::Code::OK, postCallback("/stage_trace?clear", header_map, data));
+  data.drain(data.length());
+  EXPECT_EQ(Http::Code::OK, getCallback("/stage_trace/dump", header_map, data));
+  EXPECT_THAT(data.toString(), Not(HasSubstr(R"("name":"accept")")));
+}
+
 TEST_P(AdminInstanceTest, AdminBadProfiler) {
   Buffer::OwnedImpl data;
   AdminImpl admin_bad_profile_path(TestEnvironment::temporaryPath("some/unlikely/bad/path.prof"),
@@ -5,6 +5,8 @@
 #include "test/mocks/stats/mocks.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
+
 using testing::NiceMock;
 using testing::ReturnRef;
 
@@ -701,5 +703,36 @@ envoy_cluster_test_1_upstream_cx_total{a_tag_name="a.tag-value"} 0
   EXPECT_EQ(expected_output, response.toString());
 }
 
+// The renderer splits a large exposition into chunks at metric group boundaries, and the chunks
+// add up to the exposition rendered at once.
+TEST_F(PrometheusStatsFormatterTest, RenderInChunks) {
+  for (uint32_t i = 0; i < 4096; ++i) {
+    addCounter(absl::StrCat("cluster.test_", i, ".upstream_cx_total"), {});
+    addGauge(absl::StrCat("cluster.test_", i, ".upstream_cx_active"), {});
+  }
+
+  Buffer::OwnedImpl expected;
+  const uint64_t size = PrometheusStatsFormatter::statsAsPrometheus(counters_, gauges_, histograms_,
+                                                                    expected, false, absl::nullopt);
+  EXPECT_EQ(8192UL, size);
+
+  PrometheusStatsRenderer renderer(std::move(counters_), std::move(gauges_),
+                                   std::move(histograms_), false, absl::nullopt);
+  EXPECT_EQ(8192UL, renderer.metricNameCount());
+  std::string output;
+  uint32_t chunks = 0;
+  bool more = true;
+  while (more) {
+    Buffer::OwnedImpl chunk;
+    more = renderer.nextChunk(chunk);
+    // A chunk ends at the end of the first group that makes it longer than ChunkSize.
+    EXPECT_LT(chunk.length(), PrometheusStatsRenderer::ChunkSize + 256);
+    output.append(chunk.toString());
+    ++chunks;
+  }
+  EXPECT_GT(chunks, 1);
+  EXPECT_EQ(expected.toString(), output);
+}
+
 } // namespace Server
 } // namespace Envoy
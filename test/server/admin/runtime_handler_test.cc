@@ -26,7 +26,7 @@ TEST_P(AdminInstanceTest, Runtime) {
   ON_CALL(*layer2, name()).WillByDefault(testing::ReturnRefOfCopy(std::string{"layer2"}));
   ON_CALL(*layer2, values()).WillByDefault(testing::ReturnRef(entries2));
 
-  std::vector<Runtime::Snapshot::OverrideLayerConstPtr> layers;
+  std::vector<Runtime::Snapshot::OverrideLayerConstSharedPtr> layers;
   layers.push_back(std::move(layer1));
   layers.push_back(std::move(layer2));
   EXPECT_CALL(snapshot, getLayers()).WillRepeatedly(testing::ReturnRef(layers));
@@ -1,5 +1,7 @@
 #include "envoy/admin/v3/memory.pb.h"
 
+#include "common/memory/accounting.h"
+
 #include "extensions/transport_sockets/tls/context_config_impl.h"
 
 #include "test/server/admin/admin_instance.h"
@@ -59,6 +61,11 @@ TEST_P(AdminInstanceTest, Memory) {
                                   Property(&envoy::admin::v3::Memory::pageheap_unmapped, Ge(0)),
                                   Property(&envoy::admin::v3::Memory::pageheap_free, Ge(0)),
                                   Property(&envoy::admin::v3::Memory::total_thread_cache, Ge(0))));
+
+  // Every account is listed, and the response was buffered into accounted slices.
+  EXPECT_EQ(Memory::Accounting::NumAccounts, output_proto.accounts().size());
+  EXPECT_GT(output_proto.accounts().at("buffer_slices").objects(), 0);
+  EXPECT_EQ(1, output_proto.accounts().count("tls_contexts"));
 }
 
 TEST_P(AdminInstanceTest, GetReadyRequest) {
@@ -3,6 +3,7 @@
 #include "common/stats/thread_local_store.h"
 
 #include "server/admin/stats_handler.h"
+#include "server/admin/utils.h"
 
 #include "test/server/admin/admin_instance.h"
 #include "test/test_common/logging.h"
@@ -540,6 +541,35 @@ TEST_P(AdminInstanceTest, PrometheusStatsInvalidRegex) {
   EXPECT_THAT(data.toString(), EndsWith("\"\n"));
 }
 
+// Validate that a filter anchored at the start of the names only selects the stats with its
+// literal prefix, and that the rest of the filter still applies.
+TEST_P(AdminInstanceTest, StatsFilterPrefix) {
+  server_.stats().counterFromString("cluster.foo.upstream_rq").inc();
+  server_.stats().counterFromString("cluster.foo.upstream_cx").inc();
+  server_.stats().counterFromString("cluster.foo.unused");
+  server_.stats().counterFromString("cluster.foo2.upstream_rq").inc();
+  server_.stats().counterFromString("listener.cluster.foo.upstream_rq").inc();
+
+  Http::TestResponseHeaderMapImpl header_map;
+  Buffer::OwnedImpl data;
+  EXPECT_EQ(Http::Code::OK,
+            getCallback("/stats?usedonly&filter=^cluster%5C.foo%5C.upstream_r", header_map, data));
+  EXPECT_EQ("cluster.foo.upstream_rq: 1\n", data.toString());
+}
+
+TEST(AdminUtilityTest, FilterPrefix) {
+  const auto prefix = [](const std::string& filter) {
+    return Utility::filterPrefix({{"filter", filter}});
+  };
+  EXPECT_EQ("", Utility::filterPrefix({}));
+  EXPECT_EQ("", prefix("cluster\\.foo"));
+  EXPECT_EQ("cluster.foo.", prefix("^cluster\\.foo\\."));
+  EXPECT_EQ("cluster", prefix("^cluster.foo"));
+  EXPECT_EQ("cluster.fo", prefix("^cluster\\.foo?"));
+  EXPECT_EQ("cluster_", prefix("^cluster_+\\w"));
+  EXPECT_EQ("", prefix("^cluster|listener"));
+}
+
 TEST_P(AdminInstanceTest, TracingStatsDisabled) {
   const std::string& name = admin_.tracingStats().service_forced_.name();
   for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
@@ -515,6 +515,63 @@ TEST_F(ConnectionHandlerTest, SetsTransportSocketConnectTimeout) {
   EXPECT_CALL(*listener, onDestroy());
 }
 
+// The connection waits for its on-demand filter chain to build, and matches it again once built.
+TEST_F(ConnectionHandlerTest, WaitForOnDemandFilterChain) {
+  Network::TcpListenerCallbacks* listener_callbacks;
+  auto listener = new NiceMock<Network::MockListener>();
+  TestListener* test_listener =
+      addListener(1, false, false, "test_listener", listener, &listener_callbacks);
+  EXPECT_CALL(*socket_factory_, localAddress()).WillOnce(ReturnRef(local_address_));
+  handler_->addListener(absl::nullopt, *test_listener);
+
+  NiceMock<Network::MockOnDemandFilterChain> on_demand;
+  bool built = false;
+  std::function<void()> build_cb;
+  ON_CALL(*filter_chain_, onDemandFilterChain()).WillByDefault(Return(&on_demand));
+  ON_CALL(on_demand, built()).WillByDefault(ReturnPointee(&built));
+  EXPECT_CALL(manager_, findFilterChain(_)).WillRepeatedly(Return(filter_chain_.get()));
+  EXPECT_CALL(on_demand, build(_, _)).WillOnce(SaveArg<1>(&build_cb));
+  EXPECT_CALL(dispatcher_, createServerConnection_()).Times(0);
+  listener_callbacks->onAccept(std::make_unique<NiceMock<Network::MockConnectionSocket>>());
+  EXPECT_EQ(0UL, handler_->numConnections());
+
+  built = true;
+  auto server_connection = new NiceMock<Network::MockServerConnection>();
+  EXPECT_CALL(dispatcher_, createServerConnection_()).WillOnce(Return(server_connection));
+  build_cb();
+  EXPECT_EQ(1UL, handler_->numConnections());
+
+  EXPECT_CALL(*access_log_, log(_, _, _, _));
+  EXPECT_CALL(*listener, onDestroy());
+}
+
+// The connection is closed if its on-demand filter chain fails to build.
+TEST_F(ConnectionHandlerTest, OnDemandFilterChainFailure) {
+  Network::TcpListenerCallbacks* listener_callbacks;
+  auto listener = new NiceMock<Network::MockListener>();
+  TestListener* test_listener =
+      addListener(1, false, false, "test_listener", listener, &listener_callbacks);
+  EXPECT_CALL(*socket_factory_, localAddress()).WillOnce(ReturnRef(local_address_));
+  handler_->addListener(absl::nullopt, *test_listener);
+
+  NiceMock<Network::MockOnDemandFilterChain> on_demand;
+  std::function<void()> build_cb;
+  ON_CALL(*filter_chain_, onDemandFilterChain()).WillByDefault(Return(&on_demand));
+  EXPECT_CALL(manager_, findFilterChain(_)).WillRepeatedly(Return(filter_chain_.get()));
+  EXPECT_CALL(on_demand, build(_, _)).WillOnce(SaveArg<1>(&build_cb));
+  auto* accepted_socket = new NiceMock<Network::MockConnectionSocket>();
+  listener_callbacks->onAccept(Network::ConnectionSocketPtr{accepted_socket});
+
+  EXPECT_CALL(*accepted_socket, close());
+  EXPECT_CALL(*access_log_, log(_, _, _, _));
+  EXPECT_CALL(dispatcher_, createServerConnection_()).Times(0);
+  build_cb();
+  EXPECT_EQ(1, TestUtility::findCounter(stats_store_, "on_demand_filter_chain_failure")->value());
+  EXPECT_EQ(0UL, handler_->numConnections());
+
+  EXPECT_CALL(*listener, onDestroy());
+}
+
 TEST_F(ConnectionHandlerTest, DestroyCloseConnections) {
   InSequence s;
 
@@ -1213,6 +1270,43 @@ TEST_F(ConnectionHandlerTest, ListenerFilterWorks) {
   EXPECT_CALL(*listener, onDestroy());
 }
 
+// The listener filters of a socket share the bytes peeked from it.
+TEST_F(ConnectionHandlerTest, ListenerFilterBufferShared) {
+  Network::TcpListenerCallbacks* listener_callbacks;
+  auto listener = new NiceMock<Network::MockListener>();
+  TestListener* test_listener =
+      addListener(1, true, false, "test_listener", listener, &listener_callbacks);
+  EXPECT_CALL(*socket_factory_, localAddress()).WillRepeatedly(ReturnRef(local_address_));
+  handler_->addListener(absl::nullopt, *test_listener);
+
+  Network::MockListenerFilter* first_filter = new Network::MockListenerFilter();
+  Network::MockListenerFilter* last_filter = new Network::MockListenerFilter();
+  EXPECT_CALL(factory_, createListenerFilterChain(_))
+      .WillRepeatedly(Invoke([&](Network::ListenerFilterManager& manager) -> bool {
+        manager.addAcceptFilter(listener_filter_matcher_, Network::ListenerFilterPtr{first_filter});
+        manager.addAcceptFilter(listener_filter_matcher_, Network::ListenerFilterPtr{last_filter});
+        return true;
+      }));
+  Network::ListenerFilterBuffer* buffer = nullptr;
+  EXPECT_CALL(*first_filter, onAccept(_))
+      .WillOnce(Invoke([&](Network::ListenerFilterCallbacks& cb) -> Network::FilterStatus {
+        buffer = &cb.listenerFilterBuffer();
+        EXPECT_EQ("", buffer->data());
+        return Network::FilterStatus::Continue;
+      }));
+  EXPECT_CALL(*last_filter, onAccept(_))
+      .WillOnce(Invoke([&](Network::ListenerFilterCallbacks& cb) -> Network::FilterStatus {
+        EXPECT_EQ(buffer, &cb.listenerFilterBuffer());
+        return Network::FilterStatus::Continue;
+      }));
+  EXPECT_CALL(*first_filter, destroy_());
+  EXPECT_CALL(*last_filter, destroy_());
+  EXPECT_CALL(manager_, findFilterChain(_)).WillOnce(Return(nullptr));
+  EXPECT_CALL(*access_log_, log(_, _, _, _));
+  listener_callbacks->onAccept(std::make_unique<NiceMock<Network::MockConnectionSocket>>());
+  EXPECT_CALL(*listener, onDestroy());
+}
+
 // The read_filter should be deleted before the udp_listener is deleted.
 TEST_F(ConnectionHandlerTest, ShutdownUdpListener) {
   InSequence s;
@@ -1,4 +1,6 @@
 #include <chrono>
+#include <string>
+#include <vector>
 
 #include "envoy/config/listener/v3/listener.pb.h"
 
@@ -153,6 +155,94 @@ TEST_P(DrainManagerImplTest, DrainDeadlineProbability) {
 
 INSTANTIATE_TEST_SUITE_P(DrainStrategies, DrainManagerImplTest, testing::Bool());
 
+class PacedDrainManagerImplTest : public DrainManagerImplTest {
+protected:
+  PacedDrainManagerImplTest() {
+    ON_CALL(server_.options_, drainStrategy())
+        .WillByDefault(Return(Server::DrainStrategy::Paced));
+    ON_CALL(server_.options_, drainTime()).WillByDefault(Return(std::chrono::seconds(3)));
+    ON_CALL(server_, healthCheckFailed()).WillByDefault(Return(false));
+  }
+
+  // Registers a connection which records the order of the drains.
+  Network::DrainCloseHandlePtr addConnection(const std::string& name, const bool& idle) {
+    return drain_manager_.addOnDrainCloseCb(server_.dispatcher_,
+                                            [this, name, &idle](bool idle_only) -> bool {
+                                              if (idle_only && !idle) {
+                                                return false;
+                                              }
+                                              drained_.push_back(name);
+                                              return true;
+                                            });
+  }
+
+  DrainManagerImpl drain_manager_{server_, envoy::config::listener::v3::Listener::DEFAULT};
+  std::vector<std::string> drained_;
+};
+
+// The connections are drained over the drain period, the idle ones first.
+TEST_F(PacedDrainManagerImplTest, IdleFirst) {
+  const bool busy = false;
+  const bool idle = true;
+  auto a = addConnection("a", busy);
+  auto b = addConnection("b", idle);
+  auto c = addConnection("c", busy);
+  auto d = addConnection("d", idle);
+  auto e = addConnection("e", idle);
+  // A connection gone before its turn is not drained.
+  e.reset();
+
+  Event::MockTimer* paced_timer = new Event::MockTimer(&server_.dispatcher_);
+  Event::MockTimer* drain_timer = new Event::MockTimer(&server_.dispatcher_);
+  EXPECT_CALL(*drain_timer, enableTimer(std::chrono::milliseconds(3000), _));
+  EXPECT_CALL(*paced_timer, enableTimer(std::chrono::milliseconds(1000), _)).Times(3);
+  drain_manager_.startDrainSequence([] {});
+  EXPECT_EQ(std::vector<std::string>({"b", "d"}), drained_);
+  EXPECT_FALSE(drain_manager_.drainClose());
+
+  simTime().advanceTimeWait(std::chrono::seconds(1));
+  paced_timer->invokeCallback();
+  EXPECT_EQ(std::vector<std::string>({"b", "d", "a"}), drained_);
+
+  simTime().advanceTimeWait(std::chrono::seconds(1));
+  paced_timer->invokeCallback();
+  EXPECT_EQ(std::vector<std::string>({"b", "d", "a", "c"}), drained_);
+  EXPECT_FALSE(drain_manager_.drainClose());
+
+  // Past the deadline drainClose() drains what is left.
+  simTime().advanceTimeWait(std::chrono::seconds(1));
+  paced_timer->invokeCallback();
+  EXPECT_EQ(4, drained_.size());
+  EXPECT_TRUE(drain_manager_.drainClose());
+}
+
+// The runtime caps the connections drained per second on a worker.
+TEST_F(PacedDrainManagerImplTest, MaxClosesPerSecond) {
+  ON_CALL(server_.runtime_loader_.snapshot_,
+          getInteger("server.paced_drain_max_closes_per_second", 0))
+      .WillByDefault(Return(1));
+  const bool idle = true;
+  auto a = addConnection("a", idle);
+  auto b = addConnection("b", idle);
+  auto c = addConnection("c", idle);
+  auto d = addConnection("d", idle);
+
+  Event::MockTimer* paced_timer = new Event::MockTimer(&server_.dispatcher_);
+  new Event::MockTimer(&server_.dispatcher_);
+  drain_manager_.startDrainSequence([] {});
+  EXPECT_EQ(std::vector<std::string>({"a"}), drained_);
+
+  simTime().advanceTimeWait(std::chrono::seconds(1));
+  paced_timer->invokeCallback();
+  EXPECT_EQ(std::vector<std::string>({"a", "b"}), drained_);
+}
+
+TEST_F(DrainManagerImplTest, NotPaced) {
+  DrainManagerImpl drain_manager(server_, envoy::config::listener::v3::Listener::DEFAULT);
+  EXPECT_EQ(nullptr, drain_manager.addOnDrainCloseCb(server_.dispatcher_,
+                                                     [](bool) -> bool { return true; }));
+}
+
 } // namespace
 } // namespace Server
 } // namespace Envoy
@@ -24,6 +24,8 @@
 
 #include "extensions/transport_sockets/tls/ssl_socket.h"
 
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/init/mocks.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/drain_manager.h"
 #include "test/mocks/server/factory_context.h"
@@ -38,6 +40,7 @@
 #include "absl/strings/match.h"
 #include "gtest/gtest.h"
 
+using testing::MockFunction;
 using testing::NiceMock;
 using testing::Return;
 using testing::ReturnRef;
@@ -246,5 +249,93 @@ TEST_F(FilterChainManagerImplTest, CreatedFilterChainFactoryContextHasIndependen
   EXPECT_TRUE(context0->drainDecision().drainClose());
   EXPECT_FALSE(context1->drainDecision().drainClose());
 }
+
+// An on-demand filter chain is built the first time it is asked for, and the connections wait for
+// its dependencies.
+TEST_F(FilterChainManagerImplTest, OnDemandFilterChain) {
+  auto filter_chain = filter_chain_template_;
+  filter_chain.mutable_on_demand_configuration();
+  Init::ExpectableTargetImpl target("route");
+  uint32_t builds = 0;
+  filter_chain_manager_.setOnDemandFilterChainBuilder(
+      [&](const envoy::config::listener::v3::FilterChain&, FilterChainFactoryContextCreator&,
+          Init::Manager& init_manager) {
+        ++builds;
+        init_manager.add(target);
+        return build_out_filter_chain_;
+      });
+  EXPECT_CALL(filter_chain_factory_builder_, buildFilterChain(_, _)).Times(0);
+  addSingleFilterChainHelper(filter_chain);
+  EXPECT_EQ(0, builds);
+
+  const auto* placeholder =
+      findFilterChainHelper(10000, "127.0.0.1", "", "tls", {}, "8.8.8.8", 111);
+  ASSERT_NE(nullptr, placeholder);
+  const auto* on_demand = placeholder->onDemandFilterChain();
+  ASSERT_NE(nullptr, on_demand);
+  EXPECT_FALSE(on_demand->built());
+
+  NiceMock<Event::MockDispatcher> worker_dispatcher;
+  MockFunction<void()> ready;
+  target.expectInitialize();
+  on_demand->build(worker_dispatcher, ready.AsStdFunction());
+  on_demand->build(worker_dispatcher, ready.AsStdFunction());
+  EXPECT_EQ(1, builds);
+  EXPECT_FALSE(on_demand->built());
+
+  EXPECT_CALL(ready, Call()).Times(2);
+  target.ready();
+  EXPECT_TRUE(on_demand->built());
+  EXPECT_CALL(*build_out_filter_chain_, transportSocketConnectTimeout())
+      .WillOnce(Return(std::chrono::milliseconds(5)));
+  EXPECT_EQ(std::chrono::milliseconds(5), placeholder->transportSocketConnectTimeout());
+
+  // The built filter chain is kept.
+  EXPECT_CALL(ready, Call());
+  on_demand->build(worker_dispatcher, ready.AsStdFunction());
+  EXPECT_EQ(1, builds);
+}
+
+// An on-demand filter chain that fails to build, or times out, is built again when asked for.
+TEST_F(FilterChainManagerImplTest, OnDemandFilterChainFailure) {
+  auto filter_chain = filter_chain_template_;
+  filter_chain.mutable_on_demand_configuration()->mutable_rebuild_timeout()->set_seconds(1);
+  Init::ExpectableTargetImpl target("route");
+  uint32_t builds = 0;
+  filter_chain_manager_.setOnDemandFilterChainBuilder(
+      [&](const envoy::config::listener::v3::FilterChain&, FilterChainFactoryContextCreator&,
+          Init::Manager& init_manager) -> Network::DrainableFilterChainSharedPtr {
+        if (++builds == 1) {
+          init_manager.add(target);
+        } else if (builds == 2) {
+          throw EnvoyException("bad filter chain");
+        }
+        return build_out_filter_chain_;
+      });
+  addSingleFilterChainHelper(filter_chain);
+  const auto* on_demand =
+      findFilterChainHelper(10000, "127.0.0.1", "", "tls", {}, "8.8.8.8", 111)
+          ->onDemandFilterChain();
+  ASSERT_NE(nullptr, on_demand);
+
+  auto* rebuild_timer = new NiceMock<Event::MockTimer>(&parent_context_.dispatcher_);
+  NiceMock<Event::MockDispatcher> worker_dispatcher;
+  MockFunction<void()> ready;
+  target.expectInitialize();
+  EXPECT_CALL(*rebuild_timer, enableTimer(std::chrono::milliseconds(1000), _)).Times(2);
+  on_demand->build(worker_dispatcher, ready.AsStdFunction());
+  EXPECT_CALL(ready, Call());
+  rebuild_timer->invokeCallback();
+  EXPECT_FALSE(on_demand->built());
+
+  EXPECT_CALL(ready, Call());
+  on_demand->build(worker_dispatcher, ready.AsStdFunction());
+  EXPECT_FALSE(on_demand->built());
+
+  EXPECT_CALL(ready, Call());
+  on_demand->build(worker_dispatcher, ready.AsStdFunction());
+  EXPECT_TRUE(on_demand->built());
+  EXPECT_EQ(3, builds);
+}
 } // namespace Server
 } // namespace Envoy
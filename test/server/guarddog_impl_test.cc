@@ -32,6 +32,7 @@
 using testing::ElementsAre;
 using testing::InSequence;
 using testing::NiceMock;
+using testing::Return;
 
 namespace Envoy {
 namespace Server {
@@ -405,6 +406,48 @@ TEST_P(GuardDogMissTest, MissCountTest) {
   sometimes_pet_dog = nullptr;
 }
 
+#ifdef __linux__
+TEST_P(GuardDogTestBase, StallCaptureTest) {
+  if (GetParam() == TimeSystemType::Real) {
+    return;
+  }
+
+  NiceMock<Configuration::MockWatchdog> config(DISABLE_MISS, DISABLE_MEGAMISS, DISABLE_KILL,
+                                               DISABLE_MULTIKILL, 0, std::vector<std::string>{});
+  ON_CALL(config, stallCaptureTimeout()).WillByDefault(Return(std::chrono::milliseconds(100)));
+  StallProfiler stall_profiler(*time_system_);
+  guard_dog_ = std::make_unique<GuardDogImpl>(stats_store_, config, *api_, "server",
+                                              std::make_unique<DebugTestInterlock>(),
+                                              &stall_profiler);
+  EXPECT_EQ(std::chrono::milliseconds(100), guard_dog_->loopIntervalForTest());
+  auto unpet_dog = guard_dog_->createWatchDog(api_->threadFactory().currentThreadId(),
+                                              "test_thread", mock_dispatcher_);
+  guard_dog_->forceCheckForTest();
+  time_system_->advanceTimeWait(std::chrono::milliseconds(99));
+  guard_dog_->forceCheckForTest();
+  EXPECT_TRUE(stall_profiler.stalls().empty());
+
+  // The stack of this thread, which waits for the guard dog, is captured once per stall.
+  time_system_->advanceTimeWait(std::chrono::milliseconds(2));
+  guard_dog_->forceCheckForTest();
+  guard_dog_->forceCheckForTest();
+  auto stalls = stall_profiler.stalls();
+  ASSERT_EQ(1, stalls.size());
+  EXPECT_EQ("test_thread", stalls[0].thread_name_);
+  EXPECT_EQ(std::chrono::milliseconds(101), stalls[0].duration_);
+  EXPECT_FALSE(stalls[0].frames_.empty());
+
+  unpet_dog->touch();
+  guard_dog_->forceCheckForTest();
+  time_system_->advanceTimeWait(std::chrono::milliseconds(101));
+  guard_dog_->forceCheckForTest();
+  EXPECT_EQ(2, stall_profiler.stalls().size());
+
+  guard_dog_->stopWatching(unpet_dog);
+  unpet_dog = nullptr;
+}
+#endif
+
 TEST_P(GuardDogTestBase, StartStopTest) {
   NiceMock<Stats::MockStore> stats;
   NiceMock<Configuration::MockWatchdog> config(0, 0, 0, 0, 0, std::vector<std::string>{});
@@ -3,9 +3,11 @@
 #include "server/hot_restarting_child.h"
 #include "server/hot_restarting_parent.h"
 
+#include "test/mocks/config/mocks.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/instance.h"
 #include "test/mocks/server/listener_manager.h"
+#include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
 
@@ -85,7 +87,8 @@ TEST_F(HotRestartingParentTest, ExportStatsToChild) {
     EXPECT_EQ(123, stats.gauges().at("g1"));
     EXPECT_EQ(456, stats.gauges().at("g2"));
   }
-  // When a counter has not changed since its last export, it should not be included in the message.
+  // When a counter or gauge has not changed since its last export, it should not be included in
+  // the message.
   {
     store.counter("c2").add(2);
     store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).add(1);
@@ -94,7 +97,7 @@ TEST_F(HotRestartingParentTest, ExportStatsToChild) {
     hot_restarting_parent_.exportStatsToChild(&stats);
     EXPECT_EQ(stats.counter_deltas().end(), stats.counter_deltas().find("c1"));
     EXPECT_EQ(2, stats.counter_deltas().at("c2")); // 4 is the value, but 2 is the delta
-    EXPECT_EQ(0, stats.gauges().at("g0"));
+    EXPECT_EQ(stats.gauges().end(), stats.gauges().find("g0"));
     EXPECT_EQ(124, stats.gauges().at("g1"));
     EXPECT_EQ(455, stats.gauges().at("g2"));
   }
@@ -111,6 +114,16 @@ TEST_F(HotRestartingParentTest, ExportStatsToChild) {
     EXPECT_EQ(1, stats.counter_deltas().at("used_counter"));
     EXPECT_EQ(stats.gauges().end(), stats.counter_deltas().find("unused_gauge"));
     EXPECT_EQ(1, stats.gauges().at("used_gauge"));
+    EXPECT_EQ(stats.gauges().end(), stats.gauges().find("g1"));
+  }
+
+  // A gauge set to the value it already has is still exported.
+  {
+    store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).set(124);
+    HotRestartMessage::Reply::Stats stats;
+    hot_restarting_parent_.exportStatsToChild(&stats);
+    EXPECT_EQ(124, stats.gauges().at("g1"));
+    EXPECT_EQ(1, stats.gauges().size());
   }
 }
 
@@ -157,6 +170,21 @@ TEST_F(HotRestartingParentTest, DrainListeners) {
   hot_restarting_parent_.drainListeners();
 }
 
+TEST_F(HotRestartingParentTest, ExportXdsResourcesToChild) {
+  envoy::service::discovery::v3::DiscoveryResponse response;
+  response.set_type_url("type.googleapis.com/envoy.config.cluster.v3.Cluster");
+  response.set_version_info("1");
+  auto ads_mux = std::make_shared<NiceMock<Config::MockGrpcMux>>();
+  ON_CALL(server_.cluster_manager_, adsMux()).WillByDefault(Return(ads_mux));
+  EXPECT_CALL(*ads_mux, handoffResponses())
+      .WillOnce(Return(std::vector<envoy::service::discovery::v3::DiscoveryResponse>{response}));
+
+  HotRestartMessage::Reply::XdsResources xds_resources;
+  hot_restarting_parent_.exportXdsResourcesToChild(&xds_resources);
+  ASSERT_EQ(1, xds_resources.responses_size());
+  EXPECT_TRUE(TestUtility::protoEqual(response, xds_resources.responses(0)));
+}
+
 } // namespace
 } // namespace Server
 } // namespace Envoy
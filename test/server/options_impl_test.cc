@@ -92,7 +92,7 @@ TEST_F(OptionsImplTest, All) {
       "--file-flush-interval-msec 9000 "
       "--drain-time-s 60 --log-format [%v] --enable-fine-grain-logging --parent-shutdown-time-s 90 "
       "--log-path "
-      "/foo/bar "
+      "/foo/bar --log-async-buffer-size 65536 "
       "--disable-hot-restart --cpuset-threads --allow-unknown-static-fields "
       "--reject-unknown-dynamic-fields --base-id 5 "
       "--use-dynamic-base-id --base-id-path /foo/baz "
@@ -107,6 +107,7 @@ TEST_F(OptionsImplTest, All) {
   EXPECT_EQ(2, options->componentLogLevels().size());
   EXPECT_EQ("[%v]", options->logFormat());
   EXPECT_EQ("/foo/bar", options->logPath());
+  EXPECT_EQ(65536, options->logAsyncBufferSize());
   EXPECT_EQ(true, options->enableFineGrainLogging());
   EXPECT_EQ("cluster", options->serviceClusterName());
   EXPECT_EQ("node", options->serviceNodeName());
@@ -126,6 +127,11 @@ TEST_F(OptionsImplTest, All) {
 
   options = createOptionsImpl("envoy --mode init_only");
   EXPECT_EQ(Server::Mode::InitOnly, options->mode());
+
+  options = createOptionsImpl("envoy --drain-strategy paced");
+  EXPECT_EQ(Server::DrainStrategy::Paced, options->drainStrategy());
+  EXPECT_EQ(envoy::admin::v3::CommandLineOptions::Paced,
+            options->toCommandLineOptions()->drain_strategy());
 }
 
 // Either variants of allow-unknown-[static-]-fields works.
@@ -171,6 +177,7 @@ TEST_F(OptionsImplTest, SetAll) {
   options->setLogLevel(spdlog::level::trace);
   options->setLogFormat("%L %n %v");
   options->setLogPath("/foo/bar");
+  options->setLogAsyncBufferSize(4096);
   options->setRestartEpoch(44);
   options->setFileFlushIntervalMsec(std::chrono::milliseconds(45));
   options->setMode(Server::Mode::Validate);
@@ -201,6 +208,7 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(spdlog::level::trace, options->logLevel());
   EXPECT_EQ("%L %n %v", options->logFormat());
   EXPECT_EQ("/foo/bar", options->logPath());
+  EXPECT_EQ(4096, options->logAsyncBufferSize());
   EXPECT_EQ(std::chrono::seconds(43), options->parentShutdownTime());
   EXPECT_EQ(44, options->restartEpoch());
   EXPECT_EQ(std::chrono::milliseconds(45), options->fileFlushIntervalMsec());
@@ -234,6 +242,7 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(spdlog::level::to_string_view(options->logLevel()), command_line_options->log_level());
   EXPECT_EQ(options->logFormat(), command_line_options->log_format());
   EXPECT_EQ(options->logPath(), command_line_options->log_path());
+  EXPECT_EQ(options->logAsyncBufferSize(), command_line_options->log_async_buffer_size());
   EXPECT_EQ(options->restartEpoch(), command_line_options->restart_epoch());
   EXPECT_EQ(options->fileFlushIntervalMsec().count() / 1000,
             command_line_options->file_flush_interval().seconds());
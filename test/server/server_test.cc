@@ -100,6 +100,63 @@ TEST(ServerInstanceUtil, flushHelper) {
   InstanceUtil::flushMetricsToSinks(sinks, mock_store, time_system);
 }
 
+class ChangedMetricsOnlySink : public Stats::MockSink {
+public:
+  bool flushChangedMetricsOnly() const override { return true; }
+};
+
+// When all the sinks flush changed metrics only, the snapshot leaves out the unchanged ones.
+TEST(ServerInstanceUtil, FlushChangedMetricsOnly) {
+  Stats::TestUtil::TestStore store;
+  Event::SimulatedTimeSystem time_system;
+  Stats::Counter& c1 = store.counter("c1");
+  Stats::Counter& c2 = store.counter("c2");
+  Stats::Gauge& g1 = store.gauge("g1", Stats::Gauge::ImportMode::Accumulate);
+  Stats::Gauge& g2 = store.gauge("g2", Stats::Gauge::ImportMode::Accumulate);
+  Stats::TextReadout& t1 = store.textReadout("t1");
+  store.textReadout("t2");
+  c1.inc();
+  g1.set(5);
+  g2.set(6);
+  t1.set("changed");
+
+  std::list<Stats::SinkPtr> sinks;
+  auto* sink = new ChangedMetricsOnlySink();
+  sinks.emplace_back(sink);
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    ASSERT_EQ(snapshot.counters().size(), 1);
+    EXPECT_EQ(snapshot.counters()[0].counter_.get().name(), "c1");
+    EXPECT_EQ(snapshot.counters()[0].delta_, 1);
+    EXPECT_EQ(snapshot.gauges().size(), 2);
+    ASSERT_EQ(snapshot.textReadouts().size(), 1);
+    EXPECT_EQ(snapshot.textReadouts()[0].get().name(), "t1");
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store, time_system);
+
+  c2.inc();
+  g1.set(5);
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    ASSERT_EQ(snapshot.counters().size(), 1);
+    EXPECT_EQ(snapshot.counters()[0].counter_.get().name(), "c2");
+    ASSERT_EQ(snapshot.gauges().size(), 1);
+    EXPECT_EQ(snapshot.gauges()[0].get().name(), "g1");
+    EXPECT_TRUE(snapshot.textReadouts().empty());
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store, time_system);
+
+  // A sink that needs all the metrics gets all of them, as do the other sinks.
+  auto* all_metrics_sink = new Stats::MockSink();
+  sinks.emplace_back(all_metrics_sink);
+  for (auto* mock_sink : {static_cast<Stats::MockSink*>(sink), all_metrics_sink}) {
+    EXPECT_CALL(*mock_sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+      EXPECT_EQ(snapshot.counters().size(), 2);
+      EXPECT_EQ(snapshot.gauges().size(), 2);
+      EXPECT_EQ(snapshot.textReadouts().size(), 2);
+    }));
+  }
+  InstanceUtil::flushMetricsToSinks(sinks, store, time_system);
+}
+
 class RunHelperTest : public testing::Test {
 public:
   RunHelperTest() {
@@ -1065,6 +1122,20 @@ TEST_P(ServerInstanceImplTest, BootstrapClusterManagerInitializationFail) {
                             EnvoyException, "cluster manager: duplicate cluster 'service_google'");
 }
 
+// An invalid static cluster among enough of them to be validated in parallel is reported like
+// the bootstrap validation reports it.
+TEST_P(ServerInstanceImplTest, ParallelValidationInvalidCluster) {
+  options_.concurrency_ = 4;
+  auto* static_resources = options_.config_proto_.mutable_static_resources();
+  for (uint32_t i = 0; i < 2048; ++i) {
+    static_resources->add_clusters()->set_name(absl::StrCat("cluster_", i));
+  }
+  static_resources->mutable_clusters(1500)->clear_name();
+  EXPECT_THROW_WITH_REGEX(initialize("test/server/test_data/server/node_bootstrap.yaml"),
+                          EnvoyException,
+                          "ClusterValidationError.Name: \\[\"value length must be at least");
+}
+
 // Regression tests for SdsApi throwing exceptions in initialize().
 TEST_P(ServerInstanceImplTest, BadSdsConfigSource) {
   EXPECT_THROW_WITH_MESSAGE(
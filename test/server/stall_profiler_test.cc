@@ -0,0 +1,79 @@
+#include <chrono>
+#include <sstream>
+
+#include "common/common/thread.h"
+
+#include "server/stall_profiler.h"
+
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/synchronization/notification.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::HasSubstr;
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+class StallProfilerTest : public testing::Test {
+protected:
+  Event::SimulatedTimeSystem time_system_;
+  StallProfiler stall_profiler_{time_system_};
+};
+
+#ifdef __linux__
+// The stack of a thread is captured while it is blocked in another function.
+TEST_F(StallProfilerTest, CaptureOtherThread) {
+  Thread::ThreadId thread_id;
+  absl::Notification started;
+  absl::Notification done;
+  Thread::ThreadPtr thread = Thread::threadFactoryForTest().createThread([&]() {
+    thread_id = Thread::threadFactoryForTest().currentThreadId();
+    started.Notify();
+    done.WaitForNotification();
+  });
+  started.WaitForNotification();
+
+  EXPECT_TRUE(stall_profiler_.recordStall(thread_id, "blocked", std::chrono::milliseconds(250)));
+  done.Notify();
+  thread->join();
+
+  const auto stalls = stall_profiler_.stalls();
+  ASSERT_EQ(1, stalls.size());
+  EXPECT_EQ("blocked", stalls[0].thread_name_);
+  EXPECT_EQ(std::chrono::milliseconds(250), stalls[0].duration_);
+  EXPECT_FALSE(stalls[0].frames_.empty());
+
+  std::ostringstream os;
+  stall_profiler_.dump(os);
+  EXPECT_THAT(os.str(), HasSubstr(" thread blocked stalled for 250ms\n  #0 "));
+}
+
+// Only the most recent stalls are kept.
+TEST_F(StallProfilerTest, MaxStalls) {
+  const Thread::ThreadId thread_id = Thread::threadFactoryForTest().currentThreadId();
+  for (uint32_t i = 0; i <= StallProfiler::MaxStalls; ++i) {
+    EXPECT_TRUE(stall_profiler_.recordStall(thread_id, "self", std::chrono::milliseconds(i)));
+  }
+  const auto stalls = stall_profiler_.stalls();
+  ASSERT_EQ(StallProfiler::MaxStalls, stalls.size());
+  EXPECT_EQ(std::chrono::milliseconds(1), stalls.front().duration_);
+  EXPECT_EQ(std::chrono::milliseconds(StallProfiler::MaxStalls), stalls.back().duration_);
+}
+#endif
+
+// A thread that does not exist is not recorded.
+TEST_F(StallProfilerTest, UnknownThread) {
+  EXPECT_FALSE(stall_profiler_.recordStall(Thread::ThreadId(), "none", std::chrono::seconds(1)));
+  EXPECT_TRUE(stall_profiler_.stalls().empty());
+  std::ostringstream os;
+  stall_profiler_.dump(os);
+  EXPECT_EQ("", os.str());
+}
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
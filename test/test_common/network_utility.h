@@ -152,6 +152,8 @@ public:
     return empty_network_filter_factory_;
   }
 
+  const OnDemandFilterChain* onDemandFilterChain() const override { return nullptr; }
+
 private:
   const TransportSocketFactoryPtr transport_socket_factory_;
   const std::vector<FilterFactoryCb> empty_network_filter_factory_{};
@@ -539,8 +539,7 @@ public:
    * @return bool indicating that passed gauges not matching the omitted regex have a value of 0.
    */
   static bool gaugesZeroed(const std::vector<Stats::GaugeSharedPtr>& gauges);
-  static bool gaugesZeroed(
-      const std::vector<std::pair<absl::string_view, Stats::PrimitiveGaugeReference>>& gauges);
+  static bool gaugesZeroed(const std::vector<std::pair<absl::string_view, uint64_t>>& gauges);
 
   /**
    * Returns the members of gauges that are not zero. Uses the same regex filter as gaugesZeroed().